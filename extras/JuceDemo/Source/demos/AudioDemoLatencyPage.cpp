@@ -200,7 +200,7 @@ private:
     {
         const float minSpikeLevel = 5.0f;
         const double smooth = 0.975;
-        const float* s = buffer.getSampleData (0, 0);
+        const float* s = buffer.getReadPointer (0, 0);
         const int spikeDriftAllowed = 5;
 
         Array <int> spikesFound;
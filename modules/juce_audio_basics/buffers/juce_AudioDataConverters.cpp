@@ -471,6 +471,310 @@ void AudioDataConverters::deinterleaveSamples (const float* const source,
     }
 }
 
+//==============================================================================
+#if JUCE_USE_SSE_INTRINSICS
+
+namespace AudioDataConverterHelpers
+{
+    typedef AudioData::FastConverter FC;
+
+    // Integer samples are handled as left-justified 32-bit values (as returned by
+    // AudioData::Pointer::getAsInt32()), so the same float conversion works for all of them.
+    static const float intToFloatScale = 1.0f / 2147483648.0f;
+
+    inline static __m128i swapBytesIn16BitLanes (const __m128i v) noexcept
+    {
+        return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+    }
+
+    inline static __m128i swapBytesIn32BitLanes (const __m128i v) noexcept
+    {
+        const __m128i halvesSwapped = swapBytesIn16BitLanes (v);
+        return _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (halvesSwapped, _MM_SHUFFLE (2, 3, 0, 1)), _MM_SHUFFLE (2, 3, 0, 1));
+    }
+
+    // Picks the 1st, 3rd, 5th and 7th 32-bit values out of the 8 that start at p.
+    inline static __m128 everyOtherFloat (const char* p) noexcept
+    {
+        return _mm_shuffle_ps (_mm_loadu_ps ((const float*) p), _mm_loadu_ps ((const float*) (p + 16)), _MM_SHUFFLE (2, 0, 2, 0));
+    }
+
+    inline static __m128i everyOtherInt (const char* p) noexcept
+    {
+        return _mm_castps_si128 (everyOtherFloat (p));
+    }
+
+    template <int format>
+    struct IntFormat
+    {
+        static inline int32 read (const char* p) noexcept
+        {
+            switch (format)
+            {
+                case FC::int16LE:   return (int32) (((uint32) ByteOrder::littleEndianShort (p)) << 16);
+                case FC::int16BE:   return (int32) (((uint32) ByteOrder::bigEndianShort (p)) << 16);
+                case FC::int24LE:   return (int32) (((uint32) ByteOrder::littleEndian24Bit (p)) << 8);
+                case FC::int24BE:   return (int32) (((uint32) ByteOrder::bigEndian24Bit (p)) << 8);
+                case FC::int32LE:   return (int32) ByteOrder::littleEndianInt (p);
+                default:            return (int32) ByteOrder::bigEndianInt (p);
+            }
+        }
+
+        // (the value here is already scaled and clipped to the size of the format)
+        static inline void write (char* p, const int value) noexcept
+        {
+            switch (format)
+            {
+                case FC::int16LE:   *(uint16*) p = ByteOrder::swapIfBigEndian ((uint16) value); break;
+                case FC::int16BE:   *(uint16*) p = ByteOrder::swapIfLittleEndian ((uint16) value); break;
+                case FC::int24LE:   ByteOrder::littleEndian24BitToChars (value, p); break;
+                case FC::int24BE:   ByteOrder::bigEndian24BitToChars (value, p); break;
+                case FC::int32LE:   *(uint32*) p = ByteOrder::swapIfBigEndian ((uint32) value); break;
+                default:            *(uint32*) p = ByteOrder::swapIfLittleEndian ((uint32) value); break;
+            }
+        }
+
+        // True if load4() reads a few bytes beyond the last of its four samples, which is
+        // the case for the stereo-interleaved loads that pick every other value out of a vector.
+        static inline bool loadOverreads (const int stride) noexcept
+        {
+            return ((format == FC::int16LE || format == FC::int16BE) && stride == 4)
+                || ((format == FC::int32LE || format == FC::int32BE) && stride == 8);
+        }
+
+        static inline __m128i load4 (const char* p, const int stride) noexcept
+        {
+            if (format == FC::int16LE && stride == 2)  return _mm_unpacklo_epi16 (_mm_setzero_si128(), _mm_loadl_epi64 ((const __m128i*) p));
+            if (format == FC::int16BE && stride == 2)  return _mm_unpacklo_epi16 (_mm_setzero_si128(), swapBytesIn16BitLanes (_mm_loadl_epi64 ((const __m128i*) p)));
+            if (format == FC::int16LE && stride == 4)  return _mm_slli_epi32 (_mm_loadu_si128 ((const __m128i*) p), 16);
+            if (format == FC::int16BE && stride == 4)  return _mm_slli_epi32 (swapBytesIn16BitLanes (_mm_loadu_si128 ((const __m128i*) p)), 16);
+            if (format == FC::int32LE && stride == 4)  return _mm_loadu_si128 ((const __m128i*) p);
+            if (format == FC::int32BE && stride == 4)  return swapBytesIn32BitLanes (_mm_loadu_si128 ((const __m128i*) p));
+            if (format == FC::int32LE && stride == 8)  return everyOtherInt (p);
+            if (format == FC::int32BE && stride == 8)  return swapBytesIn32BitLanes (everyOtherInt (p));
+
+            return _mm_setr_epi32 (read (p), read (p + stride), read (p + stride * 2), read (p + stride * 3));
+        }
+
+        static inline void store4 (char* p, const int stride, const __m128i v) noexcept
+        {
+            if (format == FC::int16LE && stride == 2)  { _mm_storel_epi64 ((__m128i*) p, _mm_packs_epi32 (v, v)); return; }
+            if (format == FC::int16BE && stride == 2)  { _mm_storel_epi64 ((__m128i*) p, swapBytesIn16BitLanes (_mm_packs_epi32 (v, v))); return; }
+            if (format == FC::int32LE && stride == 4)  { _mm_storeu_si128 ((__m128i*) p, v); return; }
+            if (format == FC::int32BE && stride == 4)  { _mm_storeu_si128 ((__m128i*) p, swapBytesIn32BitLanes (v)); return; }
+
+            int values[4];
+            _mm_storeu_si128 ((__m128i*) values, v);
+
+            for (int i = 0; i < 4; ++i)
+                write (p + stride * i, values[i]);
+        }
+    };
+
+    inline static bool floatLoadOverreads (const int stride) noexcept
+    {
+        return stride == 8;
+    }
+
+    inline static __m128 loadFloats (const char* p, const int stride) noexcept
+    {
+        if (stride == 4)
+            return _mm_loadu_ps ((const float*) p);
+
+        if (stride == 8)
+            return everyOtherFloat (p);
+
+        return _mm_setr_ps (*(const float*) p, *(const float*) (p + stride),
+                            *(const float*) (p + stride * 2), *(const float*) (p + stride * 3));
+    }
+
+    inline static void storeFloats (char* p, const int stride, const __m128 v) noexcept
+    {
+        if (stride == 4)
+        {
+            _mm_storeu_ps ((float*) p, v);
+        }
+        else
+        {
+            float values[4];
+            _mm_storeu_ps (values, v);
+
+            for (int i = 0; i < 4; ++i)
+                *(float*) (p + stride * i) = values[i];
+        }
+    }
+
+    // If the vector loads read past their last sample, the final block is left to the
+    // scalar loop so that nothing is read beyond the end of the source data.
+    inline static int numSafeBlocks (const int num, const bool loadOverreads) noexcept
+    {
+        return (loadOverreads ? num - 1 : num) / 4;
+    }
+
+    template <int format>
+    static void convertIntToFloat (char* dest, const int destStride, const char* src, const int srcStride, int num) noexcept
+    {
+        const __m128 scale = _mm_set1_ps (intToFloatScale);
+        const int numBlocks = numSafeBlocks (num, IntFormat<format>::loadOverreads (srcStride));
+
+        for (int i = numBlocks; --i >= 0;)
+        {
+            storeFloats (dest, destStride, _mm_mul_ps (scale, _mm_cvtepi32_ps (IntFormat<format>::load4 (src, srcStride))));
+            dest += destStride * 4;
+            src += srcStride * 4;
+        }
+
+        for (int i = num - numBlocks * 4; --i >= 0;)
+        {
+            *(float*) dest = intToFloatScale * (float) IntFormat<format>::read (src);
+            dest += destStride;
+            src += srcStride;
+        }
+    }
+
+    // Widens any of the integer formats to native-endian, left-justified 32-bit values, which
+    // is what AudioFormatReader::read() produces for fixed-point data.
+    template <int format>
+    static void convertIntToInt32 (char* dest, const int destStride, const char* src, const int srcStride, int num) noexcept
+    {
+        const int numBlocks = numSafeBlocks (num, IntFormat<format>::loadOverreads (srcStride));
+
+        for (int i = numBlocks; --i >= 0;)
+        {
+            IntFormat<FC::int32LE>::store4 (dest, destStride, IntFormat<format>::load4 (src, srcStride));
+            dest += destStride * 4;
+            src += srcStride * 4;
+        }
+
+        for (int i = num - numBlocks * 4; --i >= 0;)
+        {
+            IntFormat<FC::int32LE>::write (dest, IntFormat<format>::read (src));
+            dest += destStride;
+            src += srcStride;
+        }
+    }
+
+    template <int format>
+    static void convertFloatToInt (char* dest, const int destStride, const char* src, const int srcStride, int num) noexcept
+    {
+        // These match the rounding and clipping that the AudioData sample formats use..
+        if (format == FC::int32LE || format == FC::int32BE)
+        {
+            const __m128d maxVal = _mm_set1_pd ((double) 0x7fffffff);
+            const __m128d one = _mm_set1_pd (1.0), minusOne = _mm_set1_pd (-1.0);
+
+            const int numBlocks = numSafeBlocks (num, floatLoadOverreads (srcStride));
+
+            for (int i = numBlocks; --i >= 0;)
+            {
+                const __m128 f = loadFloats (src, srcStride);
+                const __m128d lo = _mm_mul_pd (maxVal, _mm_min_pd (one, _mm_max_pd (minusOne, _mm_cvtps_pd (f))));
+                const __m128d hi = _mm_mul_pd (maxVal, _mm_min_pd (one, _mm_max_pd (minusOne, _mm_cvtps_pd (_mm_movehl_ps (f, f)))));
+
+                IntFormat<format>::store4 (dest, destStride, _mm_unpacklo_epi64 (_mm_cvttpd_epi32 (lo), _mm_cvttpd_epi32 (hi)));
+                dest += destStride * 4;
+                src += srcStride * 4;
+            }
+
+            for (int i = num - numBlocks * 4; --i >= 0;)
+            {
+                IntFormat<format>::write (dest, (int) (0x7fffffff * jlimit (-1.0, 1.0, (double) *(const float*) src)));
+                dest += destStride;
+                src += srcStride;
+            }
+        }
+        else
+        {
+            const int maxValue = (format == FC::int16LE || format == FC::int16BE) ? 0x7fff : 0x7fffff;
+            const __m128 scale = _mm_set1_ps ((float) (maxValue + 1));
+            const __m128 high = _mm_set1_ps ((float) maxValue), low = _mm_set1_ps ((float) -maxValue);
+            const int numBlocks = numSafeBlocks (num, floatLoadOverreads (srcStride));
+
+            for (int i = numBlocks; --i >= 0;)
+            {
+                const __m128 f = _mm_min_ps (high, _mm_max_ps (low, _mm_mul_ps (scale, loadFloats (src, srcStride))));
+                IntFormat<format>::store4 (dest, destStride, _mm_cvtps_epi32 (f));
+                dest += destStride * 4;
+                src += srcStride * 4;
+            }
+
+            for (int i = num - numBlocks * 4; --i >= 0;)
+            {
+                IntFormat<format>::write (dest, jlimit (-maxValue, maxValue, roundToInt (*(const float*) src * (1.0 + maxValue))));
+                dest += destStride;
+                src += srcStride;
+            }
+        }
+    }
+}
+
+#endif
+
+bool JUCE_CALLTYPE AudioData::FastConverter::convert (void* const dest, const Format destFormat, const int destStride,
+                                                      const void* const source, const Format sourceFormat, const int sourceStride,
+                                                      const int numSamples) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    using namespace AudioDataConverterHelpers;
+
+    if (numSamples < 8 || ! SystemStats::hasSSE2())
+        return false;
+
+    char* const d = static_cast <char*> (dest);
+    const char* const s = static_cast <const char*> (source);
+
+    // The samples are read in blocks before being written, which is only safe if the
+    // buffers are separate, or if it's narrowing the data in-place.
+    if (d == s ? (destStride > sourceStride)
+               : (d < s + sourceStride * numSamples && s < d + destStride * numSamples))
+        return false;
+
+    if (destFormat == float32LE)
+    {
+        switch (sourceFormat)
+        {
+            case int16LE:   convertIntToFloat<int16LE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int16BE:   convertIntToFloat<int16BE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int24LE:   convertIntToFloat<int24LE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int24BE:   convertIntToFloat<int24BE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int32LE:   convertIntToFloat<int32LE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int32BE:   convertIntToFloat<int32BE> (d, destStride, s, sourceStride, numSamples); return true;
+            default:        break;
+        }
+    }
+    else if (sourceFormat == float32LE)
+    {
+        switch (destFormat)
+        {
+            case int16LE:   convertFloatToInt<int16LE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int16BE:   convertFloatToInt<int16BE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int24LE:   convertFloatToInt<int24LE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int24BE:   convertFloatToInt<int24BE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int32LE:   convertFloatToInt<int32LE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int32BE:   convertFloatToInt<int32BE> (d, destStride, s, sourceStride, numSamples); return true;
+            default:        break;
+        }
+    }
+    else if (destFormat == int32LE)
+    {
+        switch (sourceFormat)
+        {
+            case int16LE:   convertIntToInt32<int16LE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int16BE:   convertIntToInt32<int16BE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int24LE:   convertIntToInt32<int24LE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int24BE:   convertIntToInt32<int24BE> (d, destStride, s, sourceStride, numSamples); return true;
+            case int32BE:   convertIntToInt32<int32BE> (d, destStride, s, sourceStride, numSamples); return true;
+            default:        break;
+        }
+    }
+   #else
+    (void) dest; (void) destFormat; (void) destStride;
+    (void) source; (void) sourceFormat; (void) sourceStride; (void) numSamples;
+   #endif
+
+    return false;
+}
+
 
 //==============================================================================
 #if JUCE_UNIT_TESTS
@@ -581,8 +885,78 @@ public:
         }
     };
 
+    // Checks that the SIMD conversions give exactly the same results as the per-sample ones
+    template <class IntType, class Endianness>
+    struct FastConversionTest
+    {
+        typedef AudioData::Pointer<IntType, Endianness, AudioData::Interleaved, AudioData::NonConst> IntPointer;
+        typedef AudioData::Pointer<IntType, Endianness, AudioData::Interleaved, AudioData::Const> ConstIntPointer;
+        typedef AudioData::Pointer<AudioData::Float32, AudioData::NativeEndian, AudioData::Interleaved, AudioData::NonConst> FloatPointer;
+        typedef AudioData::Pointer<AudioData::Float32, AudioData::NativeEndian, AudioData::Interleaved, AudioData::Const> ConstFloatPointer;
+
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            const int numSamples = 37;
+
+            for (int numChans = 1; numChans <= 3; ++numChans)
+            {
+                HeapBlock<char> ints (numSamples * numChans * 4, true), expectedInts (numSamples * numChans * 4, true);
+                HeapBlock<float> floats (numSamples * numChans, true), expectedFloats (numSamples * numChans, true);
+
+                {
+                    IntPointer d (ints, numChans);
+
+                    for (int i = 0; i < numSamples; ++i, ++d)
+                        d.setAsInt32 (r.nextInt());
+                }
+
+                FloatPointer (floats, numChans).convertSamples (ConstIntPointer (ints, numChans), numSamples);
+
+                {
+                    ConstIntPointer s (ints, numChans);
+                    FloatPointer d (expectedFloats, numChans);
+
+                    for (int i = 0; i < numSamples; ++i, ++s, ++d)
+                        d.setAsFloat (s.getAsFloat());
+                }
+
+                unitTest.expect (memcmp (floats, expectedFloats, sizeof (float) * numSamples * numChans) == 0);
+
+                for (int i = 0; i < numSamples * numChans; ++i)
+                    floats[i] = r.nextFloat() * 2.2f - 1.1f;
+
+                IntPointer (ints, numChans).convertSamples (ConstFloatPointer (floats, numChans), numSamples);
+
+                {
+                    ConstFloatPointer s (floats, numChans);
+                    IntPointer d (expectedInts, numChans);
+
+                    for (int i = 0; i < numSamples; ++i, ++s, ++d)
+                        d.setAsFloat (s.getAsFloat());
+                }
+
+                ConstIntPointer i1 (ints, numChans), i2 (expectedInts, numChans);
+                bool allSame = true;
+
+                for (int i = 0; i < numSamples; ++i, ++i1, ++i2)
+                    allSame = allSame && i1.getAsInt32() == i2.getAsInt32();
+
+                unitTest.expect (allSame);
+            }
+        }
+    };
+
     void runTest()
     {
+        beginTest ("Fast conversions");
+        Random r;
+        FastConversionTest <AudioData::Int16, AudioData::LittleEndian>::test (*this, r);
+        FastConversionTest <AudioData::Int16, AudioData::BigEndian>::test (*this, r);
+        FastConversionTest <AudioData::Int24, AudioData::LittleEndian>::test (*this, r);
+        FastConversionTest <AudioData::Int24, AudioData::BigEndian>::test (*this, r);
+        FastConversionTest <AudioData::Int32, AudioData::LittleEndian>::test (*this, r);
+        FastConversionTest <AudioData::Int32, AudioData::BigEndian>::test (*this, r);
+
         beginTest ("Round-trip conversion: Int8");
         Test1 <AudioData::Int8>::test (*this);
         beginTest ("Round-trip conversion: Int16");
@@ -598,4 +972,55 @@ public:
 
 static AudioConversionTests audioConversionUnitTests;
 
+//==============================================================================
+class AudioDataConverterBenchmark  : public Benchmark
+{
+public:
+    AudioDataConverterBenchmark (const int bitDepth_)
+        : Benchmark ("AudioDataConverters: 4096 samples to " + String (bitDepth_) + "-bit and back", numSamples),
+          bitDepth (bitDepth_)
+    {
+    }
+
+    void initialise()
+    {
+        floats.allocate (numSamples, true);
+        packed.allocate (numSamples * 4, true);
+
+        for (int i = 0; i < numSamples; ++i)
+            floats[i] = (float) std::sin (i * 0.01) * 0.9f;
+    }
+
+    void runIteration()
+    {
+        if (bitDepth == 16)
+        {
+            AudioDataConverters::convertFloatToInt16LE (floats, packed, numSamples);
+            AudioDataConverters::convertInt16LEToFloat (packed, floats, numSamples);
+        }
+        else
+        {
+            AudioDataConverters::convertFloatToInt24LE (floats, packed, numSamples);
+            AudioDataConverters::convertInt24LEToFloat (packed, floats, numSamples);
+        }
+
+        preventOptimisation (floats);
+    }
+
+    void shutdown()
+    {
+        floats.free();
+        packed.free();
+    }
+
+private:
+    enum { numSamples = 4096 };
+    const int bitDepth;
+    HeapBlock<float> floats;
+    HeapBlock<char> packed;
+};
+
+static AudioDataConverterBenchmark audioDataConverterBenchmark16 (16);
+static AudioDataConverterBenchmark audioDataConverterBenchmark24 (24);
+
 #endif
@@ -206,8 +206,8 @@ public:
         inline void skip (int numSamples) noexcept              { data += numSamples; }
         inline float getAsFloatLE() const noexcept              { return (float) ((1.0 / (1.0 + maxValue)) * (int32) ByteOrder::swapIfBigEndian (*data)); }
         inline float getAsFloatBE() const noexcept              { return (float) ((1.0 / (1.0 + maxValue)) * (int32) ByteOrder::swapIfLittleEndian (*data)); }
-        inline void setAsFloatLE (float newValue) noexcept      { *data = ByteOrder::swapIfBigEndian ((uint32) (maxValue * jlimit (-1.0, 1.0, (double) newValue))); }
-        inline void setAsFloatBE (float newValue) noexcept      { *data = ByteOrder::swapIfLittleEndian ((uint32) (maxValue * jlimit (-1.0, 1.0, (double) newValue))); }
+        inline void setAsFloatLE (float newValue) noexcept      { *data = ByteOrder::swapIfBigEndian ((uint32) (int32) (maxValue * jlimit (-1.0, 1.0, (double) newValue))); }
+        inline void setAsFloatBE (float newValue) noexcept      { *data = ByteOrder::swapIfLittleEndian ((uint32) (int32) (maxValue * jlimit (-1.0, 1.0, (double) newValue))); }
         inline int32 getAsInt32LE() const noexcept              { return (int32) ByteOrder::swapIfBigEndian (*data); }
         inline int32 getAsInt32BE() const noexcept              { return (int32) ByteOrder::swapIfLittleEndian (*data); }
         inline void setAsInt32LE (int32 newValue) noexcept      { *data = ByteOrder::swapIfBigEndian ((uint32) newValue); }
@@ -301,6 +301,42 @@ public:
         static inline void* toVoidPtr (VoidType* v) noexcept { return const_cast <void*> (v); }
         enum { isConst = 1 };
     };
+
+    //==============================================================================
+    /* Provides SIMD versions of the commonest int <-> float conversions (and of widening
+       integer data to 32 bits), which Pointer::convertSamples() will try before falling
+       back to its per-sample loop.
+    */
+    class JUCE_API  FastConverter
+    {
+    public:
+        enum Format
+        {
+            unsupported = 0,
+            int16LE, int16BE,
+            int24LE, int24BE,
+            int32LE, int32BE,
+            float32LE, float32BE
+        };
+
+        template <class SampleFormatType, class EndiannessType>
+        static inline Format getFormat() noexcept
+        {
+            return SampleFormatType::bytesPerSample < 2 ? unsupported
+                     : (Format) (1 + EndiannessType::isBigEndian
+                                   + 2 * (SampleFormatType::bytesPerSample == 2 ? 0
+                                           : (SampleFormatType::bytesPerSample == 3 ? 1
+                                               : (SampleFormatType::isFloat ? 3 : 2))));
+        }
+
+        /** Returns false if this combination of formats, or the way the buffers overlap,
+            isn't something it can handle, in which case nothing will have been written.
+            The strides are the number of bytes between the start of each sample.
+        */
+        static bool JUCE_CALLTYPE convert (void* dest, Format destFormat, int destStride,
+                                           const void* source, Format sourceFormat, int sourceStride,
+                                           int numSamples) noexcept;
+    };
   #endif
 
     //==============================================================================
@@ -442,6 +478,11 @@ public:
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
             {
+                if (FastConverter::convert (dest.data.data, getFastConverterFormat(), getNumBytesBetweenSamples(),
+                                            source.getRawData(), OtherPointerType::getFastConverterFormat(),
+                                            source.getNumBytesBetweenSamples(), numSamples))
+                    return;
+
                 while (--numSamples >= 0)
                 {
                     Endianness::copyFrom (dest.data, source);
@@ -546,6 +587,10 @@ public:
 
         inline void advance() noexcept                          { this->advanceData (data); }
 
+        static FastConverter::Format getFastConverterFormat() noexcept  { return FastConverter::getFormat<SampleFormat, Endianness>(); }
+
+        template <typename, typename, typename, typename> friend class Pointer;
+
         Pointer operator++ (int); // private to force you to use the more efficient pre-increment!
         Pointer operator-- (int);
     };
@@ -23,10 +23,12 @@
   ==============================================================================
 */
 
-AudioSampleBuffer::AudioSampleBuffer (const int numChannels_,
+template <typename SampleType>
+AudioBuffer<SampleType>::AudioBuffer (const int numChannels_,
                                       const int numSamples) noexcept
   : numChannels (numChannels_),
-    size (numSamples)
+    size (numSamples),
+    isClear (false)
 {
     jassert (numSamples >= 0);
     jassert (numChannels_ > 0);
@@ -34,59 +36,107 @@ AudioSampleBuffer::AudioSampleBuffer (const int numChannels_,
     allocateData();
 }
 
-AudioSampleBuffer::AudioSampleBuffer (const AudioSampleBuffer& other) noexcept
+template <typename SampleType>
+AudioBuffer<SampleType>::AudioBuffer (const AudioBuffer& other) noexcept
   : numChannels (other.numChannels),
-    size (other.size)
+    size (other.size),
+    isClear (other.isClear)
 {
     allocateData();
 
-    for (int i = 0; i < numChannels; ++i)
-        FloatVectorOperations::copy (channels[i], other.channels[i], size);
+    if (isClear)
+        allocatedData.clear (allocatedBytes);
+    else
+        for (int i = 0; i < numChannels; ++i)
+            FloatVectorOperations::copy (channels[i], other.channels[i], size);
 }
 
-void AudioSampleBuffer::allocateData()
+template <typename SampleType>
+size_t AudioBuffer<SampleType>::getSamplesPerChannel (const int numSamples) noexcept
 {
-    const size_t channelListSize = sizeof (float*) * (size_t) (numChannels + 1);
-    allocatedBytes = (size_t) numChannels * (size_t) size * sizeof (float) + channelListSize + 32;
-    allocatedData.malloc (allocatedBytes);
-    channels = reinterpret_cast <float**> (allocatedData.getData());
+    // (rounding each channel up to a multiple of the alignment keeps all of them aligned)
+    const size_t samplesPerBlock = channelAlignment / sizeof (SampleType);
+    return ((size_t) numSamples + samplesPerBlock - 1) & ~(samplesPerBlock - 1);
+}
+
+template <typename SampleType>
+SampleType* AudioBuffer<SampleType>::getAlignedData() const noexcept
+{
+    const pointer_sized_int address = reinterpret_cast <pointer_sized_int> (allocatedData.getData());
+    return reinterpret_cast <SampleType*> ((address + (channelAlignment - 1)) & ~(pointer_sized_int) (channelAlignment - 1));
+}
+
+template <typename SampleType>
+void AudioBuffer<SampleType>::allocateChannelList (const int numChans)
+{
+    // (try to avoid doing a malloc here, as that'll blow up things like Pro-Tools)
+    if (numChans < (int) numElementsInArray (preallocatedChannelSpace))
+    {
+        channels = static_cast <SampleType**> (preallocatedChannelSpace);
+    }
+    else
+    {
+        channelListData.malloc ((size_t) numChans + 1);
+        channels = channelListData;
+    }
+}
+
+template <typename SampleType>
+void AudioBuffer<SampleType>::setChannelPointers (const size_t samplesPerChannel) noexcept
+{
+    SampleType* chan = getAlignedData();
 
-    float* chan = (float*) (allocatedData + channelListSize);
     for (int i = 0; i < numChannels; ++i)
     {
         channels[i] = chan;
-        chan += size;
+        chan += samplesPerChannel;
     }
 
     channels [numChannels] = nullptr;
 }
 
-AudioSampleBuffer::AudioSampleBuffer (float* const* dataToReferTo,
+template <typename SampleType>
+void AudioBuffer<SampleType>::allocateData()
+{
+    const size_t samplesPerChannel = getSamplesPerChannel (size);
+    allocatedBytes = (size_t) numChannels * samplesPerChannel * sizeof (SampleType) + channelAlignment;
+    allocatedData.malloc (allocatedBytes);
+
+    allocateChannelList (numChannels);
+    setChannelPointers (samplesPerChannel);
+}
+
+template <typename SampleType>
+AudioBuffer<SampleType>::AudioBuffer (SampleType* const* dataToReferTo,
                                       const int numChannels_,
                                       const int numSamples) noexcept
     : numChannels (numChannels_),
       size (numSamples),
-      allocatedBytes (0)
+      allocatedBytes (0),
+      isClear (false)
 {
     jassert (numChannels_ > 0);
     allocateChannels (dataToReferTo, 0);
 }
 
-AudioSampleBuffer::AudioSampleBuffer (float* const* dataToReferTo,
+template <typename SampleType>
+AudioBuffer<SampleType>::AudioBuffer (SampleType* const* dataToReferTo,
                                       const int numChannels_,
                                       const int startSample,
                                       const int numSamples) noexcept
     : numChannels (numChannels_),
       size (numSamples),
-      allocatedBytes (0)
+      allocatedBytes (0),
+      isClear (false)
 {
     jassert (numChannels_ > 0);
     allocateChannels (dataToReferTo, startSample);
 }
 
-void AudioSampleBuffer::setDataToReferTo (float** dataToReferTo,
-                                          const int newNumChannels,
-                                          const int newNumSamples) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::setDataToReferTo (SampleType** dataToReferTo,
+                                                const int newNumChannels,
+                                                const int newNumSamples) noexcept
 {
     jassert (newNumChannels > 0);
 
@@ -95,22 +145,15 @@ void AudioSampleBuffer::setDataToReferTo (float** dataToReferTo,
 
     numChannels = newNumChannels;
     size = newNumSamples;
+    isClear = false;
 
     allocateChannels (dataToReferTo, 0);
 }
 
-void AudioSampleBuffer::allocateChannels (float* const* const dataToReferTo, int offset)
+template <typename SampleType>
+void AudioBuffer<SampleType>::allocateChannels (SampleType* const* const dataToReferTo, int offset)
 {
-    // (try to avoid doing a malloc here, as that'll blow up things like Pro-Tools)
-    if (numChannels < (int) numElementsInArray (preallocatedChannelSpace))
-    {
-        channels = static_cast <float**> (preallocatedChannelSpace);
-    }
-    else
-    {
-        allocatedData.malloc ((size_t) numChannels + 1, sizeof (float*));
-        channels = reinterpret_cast <float**> (allocatedData.getData());
-    }
+    allocateChannelList (numChannels);
 
     for (int i = 0; i < numChannels; ++i)
     {
@@ -123,190 +166,235 @@ void AudioSampleBuffer::allocateChannels (float* const* const dataToReferTo, int
     channels [numChannels] = nullptr;
 }
 
-AudioSampleBuffer& AudioSampleBuffer::operator= (const AudioSampleBuffer& other) noexcept
+template <typename SampleType>
+AudioBuffer<SampleType>& AudioBuffer<SampleType>::operator= (const AudioBuffer& other) noexcept
 {
     if (this != &other)
     {
         setSize (other.getNumChannels(), other.getNumSamples(), false, false, false);
 
-        for (int i = 0; i < numChannels; ++i)
-            FloatVectorOperations::copy (channels[i], other.channels[i], size);
+        if (other.isClear)
+        {
+            clear();
+        }
+        else
+        {
+            isClear = false;
+
+            for (int i = 0; i < numChannels; ++i)
+                FloatVectorOperations::copy (channels[i], other.channels[i], size);
+        }
     }
 
     return *this;
 }
 
-AudioSampleBuffer::~AudioSampleBuffer() noexcept
+template <typename SampleType>
+AudioBuffer<SampleType>::~AudioBuffer() noexcept
 {
 }
 
-void AudioSampleBuffer::setSize (const int newNumChannels,
-                                 const int newNumSamples,
-                                 const bool keepExistingContent,
-                                 const bool clearExtraSpace,
-                                 const bool avoidReallocating) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::setSize (const int newNumChannels,
+                                       const int newNumSamples,
+                                       const bool keepExistingContent,
+                                       const bool clearExtraSpace,
+                                       const bool avoidReallocating) noexcept
 {
     jassert (newNumChannels > 0);
     jassert (newNumSamples >= 0);
 
     if (newNumSamples != size || newNumChannels != numChannels)
     {
-        const size_t allocatedSamplesPerChannel = (newNumSamples + 3) & ~3;
-        const size_t channelListSize = ((sizeof (float*) * (size_t) (newNumChannels + 1)) + 15) & ~15;
-        const size_t newTotalBytes = ((size_t) newNumChannels * (size_t) allocatedSamplesPerChannel * sizeof (float))
-                                        + channelListSize + 32;
+        const size_t samplesPerChannel = getSamplesPerChannel (newNumSamples);
+        const size_t newTotalBytes = ((size_t) newNumChannels * samplesPerChannel * sizeof (SampleType))
+                                        + channelAlignment;
 
-        if (keepExistingContent)
-        {
-            HeapBlock <char, true> newData;
-            newData.allocate (newTotalBytes, clearExtraSpace);
-
-            const size_t numSamplesToCopy = jmin (newNumSamples, size);
-
-            float** const newChannels = reinterpret_cast <float**> (newData.getData());
-            float* newChan = reinterpret_cast <float*> (newData + channelListSize);
-
-            for (int j = 0; j < newNumChannels; ++j)
-            {
-                newChannels[j] = newChan;
-                newChan += allocatedSamplesPerChannel;
-            }
+        const int numChansToKeep = jmin (numChannels, newNumChannels);
+        const int numSamplesToKeep = jmin (size, newNumSamples);
 
-            const int numChansToCopy = jmin (numChannels, newNumChannels);
-            for (int i = 0; i < numChansToCopy; ++i)
-                FloatVectorOperations::copy (newChannels[i], channels[i], (int) numSamplesToCopy);
+        const bool newSpaceIsClear = keepExistingContent ? (isClear && (clearExtraSpace || (newNumChannels <= numChannels
+                                                                                              && newNumSamples <= size)))
+                                                         : clearExtraSpace;
 
-            allocatedData.swapWith (newData);
-            allocatedBytes = newTotalBytes;
-            channels = newChannels;
-        }
-        else
+        if (avoidReallocating && allocatedBytes >= newTotalBytes)
         {
-            if (avoidReallocating && allocatedBytes >= newTotalBytes)
+            if (keepExistingContent)
             {
+                // Shuffle the channels around inside the existing block. If they're getting
+                // further apart, start with the last one so that nothing gets overwritten
+                // before it's been moved, and vice-versa.
+                SampleType* const data = getAlignedData();
+                const size_t oldSamplesPerChannel = numChannels > 1 ? (size_t) (channels[1] - channels[0])
+                                                                    : getSamplesPerChannel (size);
+                const size_t bytesToMove = (size_t) numSamplesToKeep * sizeof (SampleType);
+
+                if (samplesPerChannel > oldSamplesPerChannel)
+                {
+                    for (int i = numChansToKeep; --i > 0;)
+                        memmove (data + i * samplesPerChannel, data + i * oldSamplesPerChannel, bytesToMove);
+                }
+                else if (samplesPerChannel < oldSamplesPerChannel)
+                {
+                    for (int i = 1; i < numChansToKeep; ++i)
+                        memmove (data + i * samplesPerChannel, data + i * oldSamplesPerChannel, bytesToMove);
+                }
+
                 if (clearExtraSpace)
-                    allocatedData.clear (newTotalBytes);
+                {
+                    for (int i = 0; i < newNumChannels; ++i)
+                    {
+                        const int start = i < numChansToKeep ? numSamplesToKeep : 0;
+                        FloatVectorOperations::clear (data + i * samplesPerChannel + start, newNumSamples - start);
+                    }
+                }
             }
-            else
+            else if (clearExtraSpace)
             {
-                allocatedBytes = newTotalBytes;
-                allocatedData.allocate (newTotalBytes, clearExtraSpace);
-                channels = reinterpret_cast <float**> (allocatedData.getData());
+                allocatedData.clear (allocatedBytes);
             }
+        }
+        else
+        {
+            HeapBlock <char, true> newData;
+            newData.allocate (newTotalBytes, clearExtraSpace);
 
-            float* chan = reinterpret_cast <float*> (allocatedData + channelListSize);
-            for (int i = 0; i < newNumChannels; ++i)
+            if (keepExistingContent)
             {
-                channels[i] = chan;
-                chan += allocatedSamplesPerChannel;
+                const pointer_sized_int address = reinterpret_cast <pointer_sized_int> (newData.getData());
+                SampleType* const newChan = reinterpret_cast <SampleType*> ((address + (channelAlignment - 1))
+                                                                              & ~(pointer_sized_int) (channelAlignment - 1));
+
+                for (int i = 0; i < numChansToKeep; ++i)
+                    FloatVectorOperations::copy (newChan + i * samplesPerChannel, channels[i], numSamplesToKeep);
             }
+
+            allocatedData.swapWith (newData);
+            allocatedBytes = newTotalBytes;
         }
 
-        channels [newNumChannels] = 0;
         size = newNumSamples;
         numChannels = newNumChannels;
+        isClear = newSpaceIsClear;
+
+        allocateChannelList (newNumChannels);
+        setChannelPointers (samplesPerChannel);
     }
 }
 
-void AudioSampleBuffer::clear() noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::clear() noexcept
 {
-    for (int i = 0; i < numChannels; ++i)
-        FloatVectorOperations::clear (channels[i], size);
+    if (! isClear)
+    {
+        for (int i = 0; i < numChannels; ++i)
+            FloatVectorOperations::clear (channels[i], size);
+
+        isClear = true;
+    }
 }
 
-void AudioSampleBuffer::clear (const int startSample,
-                               const int numSamples) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::clear (const int startSample,
+                                     const int numSamples) noexcept
 {
     jassert (startSample >= 0 && startSample + numSamples <= size);
 
-    for (int i = 0; i < numChannels; ++i)
-        FloatVectorOperations::clear (channels[i] + startSample, numSamples);
+    if (! isClear)
+    {
+        for (int i = 0; i < numChannels; ++i)
+            FloatVectorOperations::clear (channels[i] + startSample, numSamples);
+
+        isClear = (startSample == 0 && numSamples == size);
+    }
 }
 
-void AudioSampleBuffer::clear (const int channel,
-                               const int startSample,
-                               const int numSamples) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::clear (const int channel,
+                                     const int startSample,
+                                     const int numSamples) noexcept
 {
     jassert (isPositiveAndBelow (channel, numChannels));
     jassert (startSample >= 0 && startSample + numSamples <= size);
 
-    FloatVectorOperations::clear (channels [channel] + startSample, numSamples);
+    if (! isClear)
+        FloatVectorOperations::clear (channels [channel] + startSample, numSamples);
 }
 
-void AudioSampleBuffer::applyGain (const int channel,
-                                   const int startSample,
-                                   int numSamples,
-                                   const float gain) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::applyGain (const int channel,
+                                         const int startSample,
+                                         int numSamples,
+                                         const SampleType gain) noexcept
 {
     jassert (isPositiveAndBelow (channel, numChannels));
     jassert (startSample >= 0 && startSample + numSamples <= size);
 
-    if (gain != 1.0f)
+    if (gain != (SampleType) 1 && ! isClear)
     {
-        float* const d = channels [channel] + startSample;
+        SampleType* const d = channels [channel] + startSample;
 
-        if (gain == 0.0f)
+        if (gain == 0)
             FloatVectorOperations::clear (d, numSamples);
         else
             FloatVectorOperations::multiply (d, gain, numSamples);
     }
 }
 
-void AudioSampleBuffer::applyGainRamp (const int channel,
-                                       const int startSample,
-                                       int numSamples,
-                                       float startGain,
-                                       float endGain) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::applyGainRamp (const int channel,
+                                             const int startSample,
+                                             int numSamples,
+                                             SampleType startGain,
+                                             SampleType endGain) noexcept
 {
     if (startGain == endGain)
     {
         applyGain (channel, startSample, numSamples, startGain);
     }
-    else
+    else if (! isClear)
     {
         jassert (isPositiveAndBelow (channel, numChannels));
         jassert (startSample >= 0 && startSample + numSamples <= size);
 
-        const float increment = (endGain - startGain) / numSamples;
-        float* d = channels [channel] + startSample;
-
-        while (--numSamples >= 0)
-        {
-            *d++ *= startGain;
-            startGain += increment;
-        }
+        FloatVectorOperations::multiplyWithRamp (channels [channel] + startSample,
+                                                 startGain, endGain, numSamples);
     }
 }
 
-void AudioSampleBuffer::applyGain (const int startSample,
-                                   const int numSamples,
-                                   const float gain) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::applyGain (const int startSample,
+                                         const int numSamples,
+                                         const SampleType gain) noexcept
 {
     for (int i = 0; i < numChannels; ++i)
         applyGain (i, startSample, numSamples, gain);
 }
 
-void AudioSampleBuffer::applyGain (const float gain) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::applyGain (const SampleType gain) noexcept
 {
     applyGain (0, size, gain);
 }
 
-void AudioSampleBuffer::applyGainRamp (const int startSample,
-                                       const int numSamples,
-                                       const float startGain,
-                                       const float endGain) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::applyGainRamp (const int startSample,
+                                             const int numSamples,
+                                             const SampleType startGain,
+                                             const SampleType endGain) noexcept
 {
     for (int i = 0; i < numChannels; ++i)
         applyGainRamp (i, startSample, numSamples, startGain, endGain);
 }
 
-void AudioSampleBuffer::addFrom (const int destChannel,
-                                 const int destStartSample,
-                                 const AudioSampleBuffer& source,
-                                 const int sourceChannel,
-                                 const int sourceStartSample,
-                                 int numSamples,
-                                 const float gain) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::addFrom (const int destChannel,
+                                       const int destStartSample,
+                                       const AudioBuffer& source,
+                                       const int sourceChannel,
+                                       const int sourceStartSample,
+                                       int numSamples,
+                                       const SampleType gain) noexcept
 {
     jassert (&source != this || sourceChannel != destChannel);
     jassert (isPositiveAndBelow (destChannel, numChannels));
@@ -314,45 +402,61 @@ void AudioSampleBuffer::addFrom (const int destChannel,
     jassert (isPositiveAndBelow (sourceChannel, source.numChannels));
     jassert (sourceStartSample >= 0 && sourceStartSample + numSamples <= source.size);
 
-    if (gain != 0.0f && numSamples > 0)
+    if (gain != 0 && numSamples > 0 && ! source.isClear)
     {
-        float* const d = channels [destChannel] + destStartSample;
-        const float* const s  = source.channels [sourceChannel] + sourceStartSample;
+        SampleType* const d = channels [destChannel] + destStartSample;
+        const SampleType* const s  = source.channels [sourceChannel] + sourceStartSample;
 
-        if (gain != 1.0f)
-            FloatVectorOperations::addWithMultiply (d, s, gain, numSamples);
+        if (isClear)
+        {
+            // (adding to silence is just a copy)
+            isClear = false;
+
+            if (gain != (SampleType) 1)
+                FloatVectorOperations::copyWithMultiply (d, s, gain, numSamples);
+            else
+                FloatVectorOperations::copy (d, s, numSamples);
+        }
         else
-            FloatVectorOperations::add (d, s, numSamples);
+        {
+            if (gain != (SampleType) 1)
+                FloatVectorOperations::addWithMultiply (d, s, gain, numSamples);
+            else
+                FloatVectorOperations::add (d, s, numSamples);
+        }
     }
 }
 
-void AudioSampleBuffer::addFrom (const int destChannel,
-                                 const int destStartSample,
-                                 const float* source,
-                                 int numSamples,
-                                 const float gain) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::addFrom (const int destChannel,
+                                       const int destStartSample,
+                                       const SampleType* source,
+                                       int numSamples,
+                                       const SampleType gain) noexcept
 {
     jassert (isPositiveAndBelow (destChannel, numChannels));
     jassert (destStartSample >= 0 && destStartSample + numSamples <= size);
     jassert (source != nullptr);
 
-    if (gain != 0.0f && numSamples > 0)
+    if (gain != 0 && numSamples > 0)
     {
-        float* const d = channels [destChannel] + destStartSample;
+        SampleType* const d = channels [destChannel] + destStartSample;
+        isClear = false;
 
-        if (gain != 1.0f)
+        if (gain != (SampleType) 1)
             FloatVectorOperations::addWithMultiply (d, source, gain, numSamples);
         else
             FloatVectorOperations::add (d, source, numSamples);
     }
 }
 
-void AudioSampleBuffer::addFromWithRamp (const int destChannel,
-                                         const int destStartSample,
-                                         const float* source,
-                                         int numSamples,
-                                         float startGain,
-                                         const float endGain) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::addFromWithRamp (const int destChannel,
+                                               const int destStartSample,
+                                               const SampleType* source,
+                                               int numSamples,
+                                               SampleType startGain,
+                                               const SampleType endGain) noexcept
 {
     jassert (isPositiveAndBelow (destChannel, numChannels));
     jassert (destStartSample >= 0 && destStartSample + numSamples <= size);
@@ -364,26 +468,22 @@ void AudioSampleBuffer::addFromWithRamp (const int destChannel,
     }
     else
     {
-        if (numSamples > 0 && (startGain != 0.0f || endGain != 0.0f))
+        if (numSamples > 0 && (startGain != 0 || endGain != 0))
         {
-            const float increment = (endGain - startGain) / numSamples;
-            float* d = channels [destChannel] + destStartSample;
-
-            while (--numSamples >= 0)
-            {
-                *d++ += startGain * *source++;
-                startGain += increment;
-            }
+            isClear = false;
+            FloatVectorOperations::addWithRamp (channels [destChannel] + destStartSample,
+                                                source, startGain, endGain, numSamples);
         }
     }
 }
 
-void AudioSampleBuffer::copyFrom (const int destChannel,
-                                  const int destStartSample,
-                                  const AudioSampleBuffer& source,
-                                  const int sourceChannel,
-                                  const int sourceStartSample,
-                                  int numSamples) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::copyFrom (const int destChannel,
+                                        const int destStartSample,
+                                        const AudioBuffer& source,
+                                        const int sourceChannel,
+                                        const int sourceStartSample,
+                                        int numSamples) noexcept
 {
     jassert (&source != this || sourceChannel != destChannel);
     jassert (isPositiveAndBelow (destChannel, numChannels));
@@ -393,16 +493,26 @@ void AudioSampleBuffer::copyFrom (const int destChannel,
 
     if (numSamples > 0)
     {
-        FloatVectorOperations::copy (channels [destChannel] + destStartSample,
-                                     source.channels [sourceChannel] + sourceStartSample,
-                                     numSamples);
+        if (source.isClear)
+        {
+            if (! isClear)
+                FloatVectorOperations::clear (channels [destChannel] + destStartSample, numSamples);
+        }
+        else
+        {
+            isClear = false;
+            FloatVectorOperations::copy (channels [destChannel] + destStartSample,
+                                         source.channels [sourceChannel] + sourceStartSample,
+                                         numSamples);
+        }
     }
 }
 
-void AudioSampleBuffer::copyFrom (const int destChannel,
-                                  const int destStartSample,
-                                  const float* source,
-                                  int numSamples) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::copyFrom (const int destChannel,
+                                        const int destStartSample,
+                                        const SampleType* source,
+                                        int numSamples) noexcept
 {
     jassert (isPositiveAndBelow (destChannel, numChannels));
     jassert (destStartSample >= 0 && destStartSample + numSamples <= size);
@@ -410,17 +520,19 @@ void AudioSampleBuffer::copyFrom (const int destChannel,
 
     if (numSamples > 0)
     {
+        isClear = false;
         FloatVectorOperations::copy (channels [destChannel] + destStartSample,
                                      source,
                                      numSamples);
     }
 }
 
-void AudioSampleBuffer::copyFrom (const int destChannel,
-                                  const int destStartSample,
-                                  const float* source,
-                                  int numSamples,
-                                  const float gain) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::copyFrom (const int destChannel,
+                                        const int destStartSample,
+                                        const SampleType* source,
+                                        int numSamples,
+                                        const SampleType gain) noexcept
 {
     jassert (isPositiveAndBelow (destChannel, numChannels));
     jassert (destStartSample >= 0 && destStartSample + numSamples <= size);
@@ -428,28 +540,36 @@ void AudioSampleBuffer::copyFrom (const int destChannel,
 
     if (numSamples > 0)
     {
-        float* d = channels [destChannel] + destStartSample;
+        SampleType* d = channels [destChannel] + destStartSample;
 
-        if (gain != 1.0f)
+        if (gain != (SampleType) 1)
         {
             if (gain == 0)
-                FloatVectorOperations::clear (d, numSamples);
+            {
+                if (! isClear)
+                    FloatVectorOperations::clear (d, numSamples);
+            }
             else
+            {
+                isClear = false;
                 FloatVectorOperations::copyWithMultiply (d, source, gain, numSamples);
+            }
         }
         else
         {
+            isClear = false;
             FloatVectorOperations::copy (d, source, numSamples);
         }
     }
 }
 
-void AudioSampleBuffer::copyFromWithRamp (const int destChannel,
-                                          const int destStartSample,
-                                          const float* source,
-                                          int numSamples,
-                                          float startGain,
-                                          float endGain) noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::copyFromWithRamp (const int destChannel,
+                                                const int destStartSample,
+                                                const SampleType* source,
+                                                int numSamples,
+                                                SampleType startGain,
+                                                SampleType endGain) noexcept
 {
     jassert (isPositiveAndBelow (destChannel, numChannels));
     jassert (destStartSample >= 0 && destStartSample + numSamples <= size);
@@ -461,50 +581,54 @@ void AudioSampleBuffer::copyFromWithRamp (const int destChannel,
     }
     else
     {
-        if (numSamples > 0 && (startGain != 0.0f || endGain != 0.0f))
+        if (numSamples > 0 && (startGain != 0 || endGain != 0))
         {
-            const float increment = (endGain - startGain) / numSamples;
-            float* d = channels [destChannel] + destStartSample;
-
-            while (--numSamples >= 0)
-            {
-                *d++ = startGain * *source++;
-                startGain += increment;
-            }
+            isClear = false;
+            FloatVectorOperations::copyWithRamp (channels [destChannel] + destStartSample,
+                                                 source, startGain, endGain, numSamples);
         }
     }
 }
 
-void AudioSampleBuffer::findMinMax (const int channel,
-                                    const int startSample,
-                                    int numSamples,
-                                    float& minVal,
-                                    float& maxVal) const noexcept
+template <typename SampleType>
+void AudioBuffer<SampleType>::findMinMax (const int channel,
+                                          const int startSample,
+                                          int numSamples,
+                                          SampleType& minVal,
+                                          SampleType& maxVal) const noexcept
 {
     jassert (isPositiveAndBelow (channel, numChannels));
     jassert (startSample >= 0 && startSample + numSamples <= size);
 
+    if (isClear)
+    {
+        minVal = maxVal = 0;
+        return;
+    }
+
     FloatVectorOperations::findMinAndMax (channels [channel] + startSample,
                                           numSamples, minVal, maxVal);
 }
 
-float AudioSampleBuffer::getMagnitude (const int channel,
-                                       const int startSample,
-                                       const int numSamples) const noexcept
+template <typename SampleType>
+SampleType AudioBuffer<SampleType>::getMagnitude (const int channel,
+                                                  const int startSample,
+                                                  const int numSamples) const noexcept
 {
     jassert (isPositiveAndBelow (channel, numChannels));
     jassert (startSample >= 0 && startSample + numSamples <= size);
 
-    float mn, mx;
+    SampleType mn, mx;
     findMinMax (channel, startSample, numSamples, mn, mx);
 
     return jmax (mn, -mn, mx, -mx);
 }
 
-float AudioSampleBuffer::getMagnitude (const int startSample,
-                                       const int numSamples) const noexcept
+template <typename SampleType>
+SampleType AudioBuffer<SampleType>::getMagnitude (const int startSample,
+                                                  const int numSamples) const noexcept
 {
-    float mag = 0.0f;
+    SampleType mag = 0;
 
     for (int i = 0; i < numChannels; ++i)
         mag = jmax (mag, getMagnitude (i, startSample, numSamples));
@@ -512,24 +636,120 @@ float AudioSampleBuffer::getMagnitude (const int startSample,
     return mag;
 }
 
-float AudioSampleBuffer::getRMSLevel (const int channel,
-                                      const int startSample,
-                                      const int numSamples) const noexcept
+template <typename SampleType>
+SampleType AudioBuffer<SampleType>::getRMSLevel (const int channel,
+                                                 const int startSample,
+                                                 const int numSamples) const noexcept
 {
     jassert (isPositiveAndBelow (channel, numChannels));
     jassert (startSample >= 0 && startSample + numSamples <= size);
 
-    if (numSamples <= 0 || channel < 0 || channel >= numChannels)
-        return 0.0f;
+    if (numSamples <= 0 || channel < 0 || channel >= numChannels || isClear)
+        return 0;
 
-    const float* const data = channels [channel] + startSample;
+    const SampleType* const data = channels [channel] + startSample;
     double sum = 0.0;
 
     for (int i = 0; i < numSamples; ++i)
     {
-        const float sample = data [i];
+        const SampleType sample = data [i];
         sum += sample * sample;
     }
 
-    return (float) std::sqrt (sum / numSamples);
+    return (SampleType) std::sqrt (sum / numSamples);
 }
+
+//==============================================================================
+template class AudioBuffer<float>;
+template class AudioBuffer<double>;
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioSampleBufferTests  : public UnitTest
+{
+public:
+    AudioSampleBufferTests() : UnitTest ("AudioSampleBuffer") {}
+
+    static bool isAligned (const void* p) noexcept
+    {
+        return (reinterpret_cast <pointer_sized_int> (p) & 63) == 0;
+    }
+
+    void runTest()
+    {
+        beginTest ("Alignment");
+
+        AudioSampleBuffer buffer (3, 17);
+
+        for (int i = 0; i < buffer.getNumChannels(); ++i)
+            expect (isAligned (buffer.getReadPointer (i)));
+
+        beginTest ("Resizing in place");
+
+        buffer.setSize (3, 100);
+
+        for (int ch = 0; ch < 3; ++ch)
+            for (int i = 0; i < 100; ++i)
+                buffer.getSampleData (ch)[i] = (float) (ch * 1000 + i);
+
+        const float* const originalData = buffer.getReadPointer (0);
+
+        buffer.setSize (2, 60, true, true, true);
+        expect (buffer.getReadPointer (0) == originalData);
+        expectEquals (buffer.getReadPointer (1)[59], 1059.0f);
+
+        buffer.setSize (3, 100, true, true, true);
+        expect (buffer.getReadPointer (0) == originalData);
+
+        for (int ch = 0; ch < 3; ++ch)
+        {
+            expect (isAligned (buffer.getReadPointer (ch)));
+            expectEquals (buffer.getReadPointer (ch)[10], ch < 2 ? (float) (ch * 1000 + 10) : 0.0f);
+            expectEquals (buffer.getReadPointer (ch)[80], 0.0f);
+        }
+
+        beginTest ("Silence flag");
+
+        AudioSampleBuffer source (2, 64), dest (2, 64);
+        source.clear();
+        dest.clear();
+        expect (source.hasBeenCleared() && dest.hasBeenCleared());
+
+        dest.addFrom (0, 0, source, 0, 0, 64);
+        dest.applyGain (0.5f);
+        expect (dest.hasBeenCleared());
+        expectEquals (dest.getMagnitude (0, 64), 0.0f);
+
+        source.getSampleData (1)[3] = 1.0f;
+        expect (! source.hasBeenCleared());
+
+        dest.addFrom (1, 0, source, 1, 0, 64);
+        expect (! dest.hasBeenCleared());
+        expectEquals (dest.getReadPointer (1)[3], 1.0f);
+
+        AudioSampleBuffer copy (dest);
+        expect (! copy.hasBeenCleared());
+        dest.clear();
+        copy = dest;
+        expect (copy.hasBeenCleared() && copy.getMagnitude (0, 64) == 0.0f);
+
+        {
+            // (leaves a dirty block on the heap for the next copy to pick up)
+            AudioSampleBuffer dirty (2, 64);
+            for (int ch = 0; ch < 2; ++ch)
+                FloatVectorOperations::fill (dirty.getSampleData (ch), 123.0f, 64);
+        }
+
+        AudioSampleBuffer copyOfClear (dest);
+        expect (copyOfClear.hasBeenCleared());
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < 64; ++i)
+                expectEquals (copyOfClear.getReadPointer (ch)[i], 0.0f);
+    }
+};
+
+static AudioSampleBufferTests audioSampleBufferTests;
+
+#endif
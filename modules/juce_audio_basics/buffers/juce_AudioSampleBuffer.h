@@ -26,13 +26,26 @@
 #ifndef __JUCE_AUDIOSAMPLEBUFFER_JUCEHEADER__
 #define __JUCE_AUDIOSAMPLEBUFFER_JUCEHEADER__
 
+#include "juce_FloatVectorOperations.h"
 
 //==============================================================================
 /**
-    A multi-channel buffer of 32-bit floating point audio samples.
+    A multi-channel buffer of floating point audio samples.
 
+    The SampleType template parameter is either float or double - AudioSampleBuffer
+    is a typedef for the 32-bit version, which is what most of the library uses.
+
+    When the buffer allocates its own memory, the start of each channel is aligned
+    to a 64-byte boundary, so it's safe to use aligned SIMD loads and stores on it.
+
+    The buffer also keeps track of whether it's known to be silent - see
+    hasBeenCleared() - so that code which processes it can skip the work when
+    there's nothing to do.
+
+    @see AudioSampleBuffer
 */
-class JUCE_API  AudioSampleBuffer
+template <typename SampleType>
+class JUCE_API  AudioBuffer
 {
 public:
     //==============================================================================
@@ -45,8 +58,8 @@ public:
         when the buffer is deleted. If the memory can't be allocated, this will
         throw a std::bad_alloc exception.
     */
-    AudioSampleBuffer (int numChannels,
-                       int numSamples) noexcept;
+    AudioBuffer (int numChannels,
+                 int numSamples) noexcept;
 
     /** Creates a buffer using a pre-allocated block of memory.
 
@@ -63,9 +76,9 @@ public:
         @param numSamples       the number of samples to use - this must correspond to the
                                 size of the arrays passed in
     */
-    AudioSampleBuffer (float* const* dataToReferTo,
-                       int numChannels,
-                       int numSamples) noexcept;
+    AudioBuffer (SampleType* const* dataToReferTo,
+                 int numChannels,
+                 int numSamples) noexcept;
 
     /** Creates a buffer using a pre-allocated block of memory.
 
@@ -83,10 +96,10 @@ public:
         @param numSamples       the number of samples to use - this must correspond to the
                                 size of the arrays passed in
     */
-    AudioSampleBuffer (float* const* dataToReferTo,
-                       int numChannels,
-                       int startSample,
-                       int numSamples) noexcept;
+    AudioBuffer (SampleType* const* dataToReferTo,
+                 int numChannels,
+                 int startSample,
+                 int numSamples) noexcept;
 
     /** Copies another buffer.
 
@@ -94,19 +107,19 @@ public:
         using an external data buffer, in which case boths buffers will just point to the same
         shared block of data.
     */
-    AudioSampleBuffer (const AudioSampleBuffer& other) noexcept;
+    AudioBuffer (const AudioBuffer& other) noexcept;
 
     /** Copies another buffer onto this one.
 
         This buffer's size will be changed to that of the other buffer.
     */
-    AudioSampleBuffer& operator= (const AudioSampleBuffer& other) noexcept;
+    AudioBuffer& operator= (const AudioBuffer& other) noexcept;
 
     /** Destructor.
 
         This will free any memory allocated by the buffer.
     */
-    virtual ~AudioSampleBuffer() noexcept;
+    virtual ~AudioBuffer() noexcept;
 
     //==============================================================================
     /** Returns the number of channels of audio data that this buffer contains.
@@ -126,9 +139,10 @@ public:
         For speed, this doesn't check whether the channel number is out of range,
         so be careful when using it!
     */
-    float* getSampleData (const int channelNumber) const noexcept
+    SampleType* getSampleData (const int channelNumber) noexcept
     {
         jassert (isPositiveAndBelow (channelNumber, numChannels));
+        isClear = false;  // (the caller might write to it, so it can't be assumed to be silent any more)
         return channels [channelNumber];
     }
 
@@ -137,8 +151,31 @@ public:
         For speed, this doesn't check whether the channel and sample number
         are out-of-range, so be careful when using it!
     */
-    float* getSampleData (const int channelNumber,
-                          const int sampleOffset) const noexcept
+    SampleType* getSampleData (const int channelNumber,
+                               const int sampleOffset) noexcept
+    {
+        jassert (isPositiveAndBelow (channelNumber, numChannels));
+        jassert (isPositiveAndBelow (sampleOffset, size));
+        isClear = false;
+        return channels [channelNumber] + sampleOffset;
+    }
+
+    /** Returns a read-only pointer to one of the buffer's channels.
+
+        Unlike getSampleData(), this doesn't reset the hasBeenCleared() flag, so use
+        it when you're only going to read the data.
+    */
+    const SampleType* getReadPointer (const int channelNumber) const noexcept
+    {
+        jassert (isPositiveAndBelow (channelNumber, numChannels));
+        return channels [channelNumber];
+    }
+
+    /** Returns a read-only pointer to a sample in one of the buffer's channels.
+        @see getReadPointer
+    */
+    const SampleType* getReadPointer (const int channelNumber,
+                                      const int sampleOffset) const noexcept
     {
         jassert (isPositiveAndBelow (channelNumber, numChannels));
         jassert (isPositiveAndBelow (sampleOffset, size));
@@ -149,8 +186,35 @@ public:
 
         Don't modify any of the pointers that are returned, and bear in mind that
         these will become invalid if the buffer is resized.
+
+        @see getArrayOfReadPointers
+    */
+    SampleType** getArrayOfChannels() noexcept          { isClear = false; return channels; }
+
+    /** Returns an array of read-only pointers to the channels in the buffer.
+
+        Unlike getArrayOfChannels(), this doesn't reset the hasBeenCleared() flag.
+    */
+    const SampleType** getArrayOfReadPointers() const noexcept     { return (const SampleType**) channels; }
+
+    //==============================================================================
+    /** Returns true if the buffer is known to contain only silence.
+
+        This is set by clear(), and reset by anything that might write non-zero data
+        into the buffer, including getSampleData() and getArrayOfChannels(), since the
+        caller could use the pointers they return to write to it. So if it returns
+        false, the buffer may or may not be silent, but if it returns true, code
+        such as an effect or mixer can safely skip processing it.
+
+        @see setNotClear
+    */
+    bool hasBeenCleared() const noexcept                { return isClear; }
+
+    /** Resets the hasBeenCleared() flag.
+        Call this if you've written to the buffer using pointers that you obtained
+        before it was cleared.
     */
-    float** getArrayOfChannels() const noexcept         { return channels; }
+    void setNotClear() noexcept                         { isClear = false; }
 
     //==============================================================================
     /** Changes the buffer's size or number of channels.
@@ -166,7 +230,9 @@ public:
 
         If avoidReallocating is true, then changing the buffer's size won't reduce the
         amount of memory that is currently allocated (but it will still increase it if
-        the new size is bigger than the amount it currently has). If this is false, then
+        the new size is bigger than the amount it currently has). When the existing
+        block is big enough, this works even if keepExistingContent is true, in which case
+        the channels are moved around within it. If this is false, then
         a new allocation will be done so that the buffer uses takes up the minimum amount
         of memory that it needs.
 
@@ -197,7 +263,7 @@ public:
         @param numSamples       the number of samples to use - this must correspond to the
                                 size of the arrays passed in
     */
-    void setDataToReferTo (float** dataToReferTo,
+    void setDataToReferTo (SampleType** dataToReferTo,
                            int numChannels,
                            int numSamples) noexcept;
 
@@ -230,7 +296,7 @@ public:
     void applyGain (int channel,
                     int startSample,
                     int numSamples,
-                    float gain) noexcept;
+                    SampleType gain) noexcept;
 
     /** Applies a gain multiple to a region of all the channels.
 
@@ -239,10 +305,10 @@ public:
     */
     void applyGain (int startSample,
                     int numSamples,
-                    float gain) noexcept;
+                    SampleType gain) noexcept;
 
     /** Applies a gain multiple to all the audio data. */
-    void applyGain (float gain) noexcept;
+    void applyGain (SampleType gain) noexcept;
 
     /** Applies a range of gains to a region of a channel.
 
@@ -256,8 +322,8 @@ public:
     void applyGainRamp (int channel,
                         int startSample,
                         int numSamples,
-                        float startGain,
-                        float endGain) noexcept;
+                        SampleType startGain,
+                        SampleType endGain) noexcept;
 
     /** Applies a range of gains to a region of all channels.
 
@@ -270,8 +336,8 @@ public:
     */
     void applyGainRamp (int startSample,
                         int numSamples,
-                        float startGain,
-                        float endGain) noexcept;
+                        SampleType startGain,
+                        SampleType endGain) noexcept;
 
     /** Adds samples from another buffer to this one.
 
@@ -288,13 +354,13 @@ public:
     */
     void addFrom (int destChannel,
                   int destStartSample,
-                  const AudioSampleBuffer& source,
+                  const AudioBuffer& source,
                   int sourceChannel,
                   int sourceStartSample,
                   int numSamples,
-                  float gainToApplyToSource = 1.0f) noexcept;
+                  SampleType gainToApplyToSource = (SampleType) 1) noexcept;
 
-    /** Adds samples from an array of floats to one of the channels.
+    /** Adds samples from an array of samples to one of the channels.
 
         @param destChannel          the channel within this buffer to add the samples to
         @param destStartSample      the start sample within this buffer's channel
@@ -307,11 +373,11 @@ public:
     */
     void addFrom (int destChannel,
                   int destStartSample,
-                  const float* source,
+                  const SampleType* source,
                   int numSamples,
-                  float gainToApplyToSource = 1.0f) noexcept;
+                  SampleType gainToApplyToSource = (SampleType) 1) noexcept;
 
-    /** Adds samples from an array of floats, applying a gain ramp to them.
+    /** Adds samples from an array of samples, applying a gain ramp to them.
 
         @param destChannel          the channel within this buffer to add the samples to
         @param destStartSample      the start sample within this buffer's channel
@@ -324,10 +390,10 @@ public:
     */
     void addFromWithRamp (int destChannel,
                           int destStartSample,
-                          const float* source,
+                          const SampleType* source,
                           int numSamples,
-                          float startGain,
-                          float endGain) noexcept;
+                          SampleType startGain,
+                          SampleType endGain) noexcept;
 
     /** Copies samples from another buffer to this one.
 
@@ -342,12 +408,12 @@ public:
     */
     void copyFrom (int destChannel,
                    int destStartSample,
-                   const AudioSampleBuffer& source,
+                   const AudioBuffer& source,
                    int sourceChannel,
                    int sourceStartSample,
                    int numSamples) noexcept;
 
-    /** Copies samples from an array of floats into one of the channels.
+    /** Copies samples from an array of samples into one of the channels.
 
         @param destChannel          the channel within this buffer to copy the samples to
         @param destStartSample      the start sample within this buffer's channel
@@ -358,10 +424,10 @@ public:
     */
     void copyFrom (int destChannel,
                    int destStartSample,
-                   const float* source,
+                   const SampleType* source,
                    int numSamples) noexcept;
 
-    /** Copies samples from an array of floats into one of the channels, applying a gain to it.
+    /** Copies samples from an array of samples into one of the channels, applying a gain to it.
 
         @param destChannel          the channel within this buffer to copy the samples to
         @param destStartSample      the start sample within this buffer's channel
@@ -373,11 +439,11 @@ public:
     */
     void copyFrom (int destChannel,
                    int destStartSample,
-                   const float* source,
+                   const SampleType* source,
                    int numSamples,
-                   float gain) noexcept;
+                   SampleType gain) noexcept;
 
-    /** Copies samples from an array of floats into one of the channels, applying a gain ramp.
+    /** Copies samples from an array of samples into one of the channels, applying a gain ramp.
 
         @param destChannel          the channel within this buffer to copy the samples to
         @param destStartSample      the start sample within this buffer's channel
@@ -392,10 +458,10 @@ public:
     */
     void copyFromWithRamp (int destChannel,
                            int destStartSample,
-                           const float* source,
+                           const SampleType* source,
                            int numSamples,
-                           float startGain,
-                           float endGain) noexcept;
+                           SampleType startGain,
+                           SampleType endGain) noexcept;
 
 
     /** Finds the highest and lowest sample values in a given range.
@@ -409,39 +475,80 @@ public:
     void findMinMax (int channel,
                      int startSample,
                      int numSamples,
-                     float& minVal,
-                     float& maxVal) const noexcept;
+                     SampleType& minVal,
+                     SampleType& maxVal) const noexcept;
 
     /** Finds the highest absolute sample value within a region of a channel.
     */
-    float getMagnitude (int channel,
-                        int startSample,
-                        int numSamples) const noexcept;
+    SampleType getMagnitude (int channel,
+                             int startSample,
+                             int numSamples) const noexcept;
 
     /** Finds the highest absolute sample value within a region on all channels.
     */
-    float getMagnitude (int startSample,
-                        int numSamples) const noexcept;
+    SampleType getMagnitude (int startSample,
+                             int numSamples) const noexcept;
 
     /** Returns the root mean squared level for a region of a channel.
     */
-    float getRMSLevel (int channel,
-                       int startSample,
-                       int numSamples) const noexcept;
+    SampleType getRMSLevel (int channel,
+                            int startSample,
+                            int numSamples) const noexcept;
+
+    //==============================================================================
+    /** Resizes this buffer to match another one, and copies its contents, converting
+        the samples to this buffer's type.
+
+        This lets you copy between float and double buffers - e.g. a double-precision
+        AudioBuffer can be filled from an AudioSampleBuffer and vice versa.
+    */
+    template <typename OtherSampleType>
+    void makeCopyOf (const AudioBuffer<OtherSampleType>& other)
+    {
+        setSize (other.getNumChannels(), other.getNumSamples(), false, false, true);
+
+        if (other.hasBeenCleared())
+        {
+            clear();
+        }
+        else
+        {
+            isClear = false;
+
+            for (int i = 0; i < numChannels; ++i)
+                FloatVectorOperations::copy (channels[i], other.getReadPointer (i), size);
+        }
+    }
 
 private:
     //==============================================================================
+    enum { channelAlignment = 64 };
+
     int numChannels, size;
     size_t allocatedBytes;
-    float** channels;
+    SampleType** channels;
     HeapBlock <char, true> allocatedData;
-    float* preallocatedChannelSpace [32];
+    HeapBlock <SampleType*> channelListData;
+    SampleType* preallocatedChannelSpace [32];
+    bool isClear;
 
     void allocateData();
-    void allocateChannels (float* const* dataToReferTo, int offset);
+    void allocateChannels (SampleType* const* dataToReferTo, int offset);
+    void allocateChannelList (int numChannels);
+    void setChannelPointers (size_t samplesPerChannel) noexcept;
+    SampleType* getAlignedData() const noexcept;
+    static size_t getSamplesPerChannel (int numSamples) noexcept;
 
-    JUCE_LEAK_DETECTOR (AudioSampleBuffer)
+    JUCE_LEAK_DETECTOR (AudioBuffer)
 };
 
+//==============================================================================
+/** A multi-channel buffer of 32-bit floating point audio samples.
+
+    This is the buffer type used throughout the library's audio classes.
+    @see AudioBuffer
+*/
+typedef AudioBuffer<float> AudioSampleBuffer;
+
 
 #endif   // __JUCE_AUDIOSAMPLEBUFFER_JUCEHEADER__
@@ -23,6 +23,7 @@
   ==============================================================================
 */
 
+
 #if JUCE_USE_SSE_INTRINSICS
 
 namespace FloatVectorHelpers
@@ -50,48 +51,102 @@ namespace FloatVectorHelpers
        #endif
     }
 
-    static inline float findMinimumOrMaximum (const float* src, int num, const bool isMinimum) noexcept
+    // loads 4 int16 values, and sign-extends them to 32 bits
+    inline static __m128i loadInt16x4 (const int16* src) noexcept
+    {
+        const __m128i v = _mm_loadl_epi64 ((const __m128i*) src);
+        return _mm_srai_epi32 (_mm_unpacklo_epi16 (v, v), 16);
+    }
+
+    //==============================================================================
+    /* These wrap up the SSE instructions for each sample type, so that the same
+       macros can be used to generate both the float and double versions of the ops.
+    */
+    struct BasicOps32
+    {
+        typedef float Type;
+        typedef __m128 ParallelType;
+        enum { numParallel = 4 };
+
+        static inline ParallelType load1 (Type v) noexcept                              { return _mm_load1_ps (&v); }
+        static inline ParallelType loadA (const Type* v) noexcept                       { return _mm_load_ps (v); }
+        static inline ParallelType loadU (const Type* v) noexcept                       { return _mm_loadu_ps (v); }
+        static inline ParallelType loadRamp (Type v, Type delta) noexcept               { return _mm_setr_ps (v, v + delta, v + delta * 2, v + delta * 3); }
+        static inline void storeA (Type* dest, ParallelType a) noexcept                 { _mm_store_ps (dest, a); }
+        static inline void storeU (Type* dest, ParallelType a) noexcept                 { _mm_storeu_ps (dest, a); }
+
+        static inline ParallelType add (ParallelType a, ParallelType b) noexcept        { return _mm_add_ps (a, b); }
+        static inline ParallelType mul (ParallelType a, ParallelType b) noexcept        { return _mm_mul_ps (a, b); }
+        static inline ParallelType max (ParallelType a, ParallelType b) noexcept        { return _mm_max_ps (a, b); }
+        static inline ParallelType min (ParallelType a, ParallelType b) noexcept        { return _mm_min_ps (a, b); }
+        static inline ParallelType negate (ParallelType a) noexcept                     { return _mm_xor_ps (a, _mm_set1_ps (-0.0f)); }
+        static inline ParallelType abs (ParallelType a) noexcept                        { return _mm_andnot_ps (_mm_set1_ps (-0.0f), a); }
+
+        static inline Type max (ParallelType a) noexcept   { Type v[numParallel]; storeU (v, a); return jmax (v[0], v[1], v[2], v[3]); }
+        static inline Type min (ParallelType a) noexcept   { Type v[numParallel]; storeU (v, a); return jmin (v[0], v[1], v[2], v[3]); }
+    };
+
+    struct BasicOps64
+    {
+        typedef double Type;
+        typedef __m128d ParallelType;
+        enum { numParallel = 2 };
+
+        static inline ParallelType load1 (Type v) noexcept                              { return _mm_load1_pd (&v); }
+        static inline ParallelType loadA (const Type* v) noexcept                       { return _mm_load_pd (v); }
+        static inline ParallelType loadU (const Type* v) noexcept                       { return _mm_loadu_pd (v); }
+        static inline ParallelType loadRamp (Type v, Type delta) noexcept               { return _mm_setr_pd (v, v + delta); }
+        static inline void storeA (Type* dest, ParallelType a) noexcept                 { _mm_store_pd (dest, a); }
+        static inline void storeU (Type* dest, ParallelType a) noexcept                 { _mm_storeu_pd (dest, a); }
+
+        static inline ParallelType add (ParallelType a, ParallelType b) noexcept        { return _mm_add_pd (a, b); }
+        static inline ParallelType mul (ParallelType a, ParallelType b) noexcept        { return _mm_mul_pd (a, b); }
+        static inline ParallelType max (ParallelType a, ParallelType b) noexcept        { return _mm_max_pd (a, b); }
+        static inline ParallelType min (ParallelType a, ParallelType b) noexcept        { return _mm_min_pd (a, b); }
+        static inline ParallelType negate (ParallelType a) noexcept                     { return _mm_xor_pd (a, _mm_set1_pd (-0.0)); }
+        static inline ParallelType abs (ParallelType a) noexcept                        { return _mm_andnot_pd (_mm_set1_pd (-0.0), a); }
+
+        static inline Type max (ParallelType a) noexcept   { Type v[numParallel]; storeU (v, a); return jmax (v[0], v[1]); }
+        static inline Type min (ParallelType a) noexcept   { Type v[numParallel]; storeU (v, a); return jmin (v[0], v[1]); }
+    };
+
+    //==============================================================================
+    template <class Mode>
+    static typename Mode::Type findMinimumOrMaximum (const typename Mode::Type* src, int num, const bool isMinimum) noexcept
     {
-       #if JUCE_USE_SSE_INTRINSICS
-        const int numLongOps = num / 4;
+        typedef typename Mode::ParallelType ParallelType;
+        const int numLongOps = num / Mode::numParallel;
 
         if (numLongOps > 1 && FloatVectorHelpers::isSSE2Available())
         {
-            __m128 val;
+            ParallelType val;
 
             #define JUCE_MINIMUMMAXIMUM_SSE_LOOP(loadOp, minMaxOp) \
                 val = loadOp (src); \
-                src += 4; \
+                src += Mode::numParallel; \
                 for (int i = 1; i < numLongOps; ++i) \
                 { \
-                    const __m128 s = loadOp (src); \
+                    const ParallelType s = loadOp (src); \
                     val = minMaxOp (val, s); \
-                    src += 4; \
+                    src += Mode::numParallel; \
                 }
 
             if (isMinimum)
             {
-                if (FloatVectorHelpers::isAligned (src)) { JUCE_MINIMUMMAXIMUM_SSE_LOOP (_mm_load_ps,  _mm_min_ps) }
-                else                                     { JUCE_MINIMUMMAXIMUM_SSE_LOOP (_mm_loadu_ps, _mm_min_ps) }
+                if (FloatVectorHelpers::isAligned (src)) { JUCE_MINIMUMMAXIMUM_SSE_LOOP (Mode::loadA, Mode::min) }
+                else                                     { JUCE_MINIMUMMAXIMUM_SSE_LOOP (Mode::loadU, Mode::min) }
             }
             else
             {
-                if (FloatVectorHelpers::isAligned (src)) { JUCE_MINIMUMMAXIMUM_SSE_LOOP (_mm_load_ps, _mm_max_ps) }
-                else                                     { JUCE_MINIMUMMAXIMUM_SSE_LOOP (_mm_loadu_ps,_mm_max_ps) }
+                if (FloatVectorHelpers::isAligned (src)) { JUCE_MINIMUMMAXIMUM_SSE_LOOP (Mode::loadA, Mode::max) }
+                else                                     { JUCE_MINIMUMMAXIMUM_SSE_LOOP (Mode::loadU, Mode::max) }
             }
 
-            float localVal;
-
-            {
-                float vals[4];
-                _mm_storeu_ps (vals, val);
-                FloatVectorHelpers::mmEmpty();
-
-                localVal = isMinimum ? jmin (vals[0], vals[1], vals[2], vals[3])
-                                     : jmax (vals[0], vals[1], vals[2], vals[3]);
-            }
+            typename Mode::Type localVal = isMinimum ? Mode::min (val)
+                                                     : Mode::max (val);
+            FloatVectorHelpers::mmEmpty();
 
-            num &= 3;
+            num &= (Mode::numParallel - 1);
 
             for (int i = 0; i < num; ++i)
                 localVal = isMinimum ? jmin (localVal, src[i])
@@ -99,21 +154,72 @@ namespace FloatVectorHelpers
 
             return localVal;
         }
-       #endif
 
         return isMinimum ? juce::findMinimum (src, num)
                          : juce::findMaximum (src, num);
     }
+
+    template <class Mode>
+    static void findMinAndMax (const typename Mode::Type* src, int num,
+                               typename Mode::Type& minResult, typename Mode::Type& maxResult) noexcept
+    {
+        typedef typename Mode::ParallelType ParallelType;
+        const int numLongOps = num / Mode::numParallel;
+
+        if (numLongOps > 1 && FloatVectorHelpers::isSSE2Available())
+        {
+            ParallelType mn, mx;
+
+            #define JUCE_MINMAX_SSE_LOOP(loadOp) \
+                mn = loadOp (src); \
+                mx = mn; \
+                src += Mode::numParallel; \
+                for (int i = 1; i < numLongOps; ++i) \
+                { \
+                    const ParallelType s = loadOp (src); \
+                    mn = Mode::min (mn, s); \
+                    mx = Mode::max (mx, s); \
+                    src += Mode::numParallel; \
+                }
+
+            if (FloatVectorHelpers::isAligned (src)) { JUCE_MINMAX_SSE_LOOP (Mode::loadA) }
+            else                                     { JUCE_MINMAX_SSE_LOOP (Mode::loadU) }
+
+            typename Mode::Type localMin = Mode::min (mn);
+            typename Mode::Type localMax = Mode::max (mx);
+            FloatVectorHelpers::mmEmpty();
+
+            num &= (Mode::numParallel - 1);
+
+            for (int i = 0; i < num; ++i)
+            {
+                const typename Mode::Type s = src[i];
+                localMin = jmin (localMin, s);
+                localMax = jmax (localMax, s);
+            }
+
+            minResult = localMin;
+            maxResult = localMax;
+            return;
+        }
+
+        juce::findMinAndMax (src, num, minResult, maxResult);
+    }
+
+    #undef JUCE_MINIMUMMAXIMUM_SSE_LOOP
+    #undef JUCE_MINMAX_SSE_LOOP
 }
 
+// (each function that uses these macros must declare a typedef called Mode, which
+// picks either FloatVectorHelpers::BasicOps32 or FloatVectorHelpers::BasicOps64)
 #define JUCE_BEGIN_SSE_OP \
     if (FloatVectorHelpers::isSSE2Available()) \
     { \
-        const int numLongOps = num / 4;
+        const int numLongOps = num / Mode::numParallel;
 
 #define JUCE_FINISH_SSE_OP(normalOp) \
         FloatVectorHelpers::mmEmpty(); \
-        num &= 3; \
+        num &= (Mode::numParallel - 1); \
         if (num == 0) return; \
     } \
     for (int i = 0; i < num; ++i) normalOp;
@@ -126,40 +232,450 @@ namespace FloatVectorHelpers
         increment; \
     }
 
-#define JUCE_INCREMENT_SRC_DEST    dest += 4; src += 4;
-#define JUCE_INCREMENT_DEST        dest += 4;
+#define JUCE_INCREMENT_SRC_DEST         dest += Mode::numParallel; src += Mode::numParallel;
+#define JUCE_INCREMENT_SRC1_SRC2_DEST   dest += Mode::numParallel; src1 += Mode::numParallel; src2 += Mode::numParallel;
+#define JUCE_INCREMENT_DEST             dest += Mode::numParallel;
 
 #define JUCE_LOAD_NONE(srcLoad, dstLoad)
-#define JUCE_LOAD_DEST(srcLoad, dstLoad)     const __m128 d = dstLoad (dest);
-#define JUCE_LOAD_SRC(srcLoad, dstLoad)      const __m128 s = srcLoad (src);
-#define JUCE_LOAD_SRC_DEST(srcLoad, dstLoad) const __m128 d = dstLoad (dest); const __m128 s = srcLoad (src);
+#define JUCE_LOAD_DEST(srcLoad, dstLoad)            const Mode::ParallelType d = dstLoad (dest);
+#define JUCE_LOAD_SRC(srcLoad, dstLoad)             const Mode::ParallelType s = srcLoad (src);
+#define JUCE_LOAD_SRC_DEST(srcLoad, dstLoad)        const Mode::ParallelType d = dstLoad (dest); const Mode::ParallelType s = srcLoad (src);
+#define JUCE_LOAD_SRC1_SRC2_DEST(srcLoad, dstLoad)  const Mode::ParallelType d = dstLoad (dest); const Mode::ParallelType s1 = srcLoad (src1); const Mode::ParallelType s2 = srcLoad (src2);
 
 #define JUCE_PERFORM_SSE_OP_DEST(normalOp, sseOp, locals) \
     JUCE_BEGIN_SSE_OP \
-    if (FloatVectorHelpers::isAligned (dest))   JUCE_SSE_LOOP (sseOp, dummy, _mm_load_ps,  _mm_store_ps,  locals, JUCE_INCREMENT_DEST) \
-    else                                        JUCE_SSE_LOOP (sseOp, dummy, _mm_loadu_ps, _mm_storeu_ps, locals, JUCE_INCREMENT_DEST) \
+    if (FloatVectorHelpers::isAligned (dest))   JUCE_SSE_LOOP (sseOp, dummy, Mode::loadA, Mode::storeA, locals, JUCE_INCREMENT_DEST) \
+    else                                        JUCE_SSE_LOOP (sseOp, dummy, Mode::loadU, Mode::storeU, locals, JUCE_INCREMENT_DEST) \
     JUCE_FINISH_SSE_OP (normalOp)
 
 #define JUCE_PERFORM_SSE_OP_SRC_DEST(normalOp, sseOp, locals, increment) \
     JUCE_BEGIN_SSE_OP \
     if (FloatVectorHelpers::isAligned (dest)) \
     { \
-        if (FloatVectorHelpers::isAligned (src)) JUCE_SSE_LOOP (sseOp, _mm_load_ps,  _mm_load_ps, _mm_store_ps, locals, increment) \
-        else                                     JUCE_SSE_LOOP (sseOp, _mm_loadu_ps, _mm_load_ps, _mm_store_ps, locals, increment) \
+        if (FloatVectorHelpers::isAligned (src)) JUCE_SSE_LOOP (sseOp, Mode::loadA, Mode::loadA, Mode::storeA, locals, increment) \
+        else                                     JUCE_SSE_LOOP (sseOp, Mode::loadU, Mode::loadA, Mode::storeA, locals, increment) \
     }\
     else \
     { \
-        if (FloatVectorHelpers::isAligned (src)) JUCE_SSE_LOOP (sseOp, _mm_load_ps,  _mm_loadu_ps, _mm_storeu_ps, locals, increment) \
-        else                                     JUCE_SSE_LOOP (sseOp, _mm_loadu_ps, _mm_loadu_ps, _mm_storeu_ps, locals, increment) \
+        if (FloatVectorHelpers::isAligned (src)) JUCE_SSE_LOOP (sseOp, Mode::loadA, Mode::loadU, Mode::storeU, locals, increment) \
+        else                                     JUCE_SSE_LOOP (sseOp, Mode::loadU, Mode::loadU, Mode::storeU, locals, increment) \
     } \
     JUCE_FINISH_SSE_OP (normalOp)
 
+// (with two sources, only the destination's alignment is checked)
+#define JUCE_PERFORM_SSE_OP_SRC1_SRC2_DEST(normalOp, sseOp, locals) \
+    JUCE_BEGIN_SSE_OP \
+    if (FloatVectorHelpers::isAligned (dest))   JUCE_SSE_LOOP (sseOp, Mode::loadU, Mode::loadA, Mode::storeA, locals, JUCE_INCREMENT_SRC1_SRC2_DEST) \
+    else                                        JUCE_SSE_LOOP (sseOp, Mode::loadU, Mode::loadU, Mode::storeU, locals, JUCE_INCREMENT_SRC1_SRC2_DEST) \
+    JUCE_FINISH_SSE_OP (normalOp)
+
+// (a ramp op keeps a vector of multipliers called g, which moves on by gDelta each time,
+// and then leaves the scalar 'multiplier' at the right place for the remaining samples)
+#define JUCE_PERFORM_SSE_RAMP_OP(normalOp, sseOp, locals, increment) \
+    JUCE_BEGIN_SSE_OP \
+    Mode::ParallelType g = Mode::loadRamp (multiplier, delta); \
+    const Mode::ParallelType gDelta = Mode::load1 (delta * Mode::numParallel); \
+    if (FloatVectorHelpers::isAligned (dest))   JUCE_SSE_LOOP (sseOp, Mode::loadU, Mode::loadA, Mode::storeA, locals, increment g = Mode::add (g, gDelta);) \
+    else                                        JUCE_SSE_LOOP (sseOp, Mode::loadU, Mode::loadU, Mode::storeU, locals, increment g = Mode::add (g, gDelta);) \
+    multiplier += delta * (numLongOps * Mode::numParallel); \
+    JUCE_FINISH_SSE_OP (normalOp)
 
 #else
  #define JUCE_PERFORM_SSE_OP_DEST(normalOp, unused1, unused2)              for (int i = 0; i < num; ++i) normalOp;
  #define JUCE_PERFORM_SSE_OP_SRC_DEST(normalOp, sseOp, locals, increment)  for (int i = 0; i < num; ++i) normalOp;
+ #define JUCE_PERFORM_SSE_OP_SRC1_SRC2_DEST(normalOp, sseOp, locals)       for (int i = 0; i < num; ++i) normalOp;
+ #define JUCE_PERFORM_SSE_RAMP_OP(normalOp, sseOp, locals, increment)      for (int i = 0; i < num; ++i) normalOp;
+#endif
+
+//==============================================================================
+#if JUCE_USE_AVX_INTRINSICS || JUCE_USE_ARM_NEON
+
+#define JUCE_VECTOR_KERNEL_LOOP(numPerOp, vectorOp, normalOp, increment, finishOp) \
+    for (int n = num / numPerOp; --n >= 0;) \
+    { \
+        vectorOp; \
+        increment (numPerOp) \
+    } \
+    finishOp; \
+    num &= (numPerOp - 1); \
+    for (int i = 0; i < num; ++i) normalOp;
+
+#define JUCE_KERNEL_INCREMENT_DEST(n)       dest += n;
+#define JUCE_KERNEL_INCREMENT_SRC_DEST(n)   dest += n; src += n;
+
+#endif
+
+#if JUCE_USE_AVX_INTRINSICS
+
+namespace FloatVectorHelpers
+{
+    static bool avxPresent = false;
+
+    static bool isAVXAvailable() noexcept
+    {
+        if (avxPresent)
+            return true;
+
+        avxPresent = SystemStats::hasAVX();
+        return avxPresent;
+    }
+
+    /* These work on 8 floats at a time, using unaligned loads and stores, which on
+       AVX hardware cost nothing extra when the data does happen to be aligned.
+       Each one clears the upper halves of the ymm registers before returning, to
+       avoid the penalty for mixing AVX and SSE code.
+    */
+    namespace AVX
+    {
+        #define JUCE_AVX_LOOP(avxOp, normalOp, increment) \
+            JUCE_VECTOR_KERNEL_LOOP (8, avxOp, normalOp, increment, _mm256_zeroupper())
+
+        JUCE_AVX_FUNCTION static void fill (float* dest, const float valueToFill, int num) noexcept
+        {
+            const __m256 val = _mm256_set1_ps (valueToFill);
+            JUCE_AVX_LOOP (_mm256_storeu_ps (dest, val), dest[i] = valueToFill, JUCE_KERNEL_INCREMENT_DEST)
+        }
+
+        JUCE_AVX_FUNCTION static void copyWithMultiply (float* dest, const float* src, const float multiplier, int num) noexcept
+        {
+            const __m256 mult = _mm256_set1_ps (multiplier);
+            JUCE_AVX_LOOP (_mm256_storeu_ps (dest, _mm256_mul_ps (mult, _mm256_loadu_ps (src))),
+                           dest[i] = src[i] * multiplier, JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        JUCE_AVX_FUNCTION static void add (float* dest, const float* src, int num) noexcept
+        {
+            JUCE_AVX_LOOP (_mm256_storeu_ps (dest, _mm256_add_ps (_mm256_loadu_ps (dest), _mm256_loadu_ps (src))),
+                           dest[i] += src[i], JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        JUCE_AVX_FUNCTION static void add (float* dest, const float amount, int num) noexcept
+        {
+            const __m256 amountToAdd = _mm256_set1_ps (amount);
+            JUCE_AVX_LOOP (_mm256_storeu_ps (dest, _mm256_add_ps (_mm256_loadu_ps (dest), amountToAdd)),
+                           dest[i] += amount, JUCE_KERNEL_INCREMENT_DEST)
+        }
+
+        JUCE_AVX_FUNCTION static void addWithMultiply (float* dest, const float* src, const float multiplier, int num) noexcept
+        {
+            const __m256 mult = _mm256_set1_ps (multiplier);
+            JUCE_AVX_LOOP (_mm256_storeu_ps (dest, _mm256_add_ps (_mm256_loadu_ps (dest), _mm256_mul_ps (mult, _mm256_loadu_ps (src)))),
+                           dest[i] += src[i] * multiplier, JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        JUCE_AVX_FUNCTION static void multiply (float* dest, const float* src, int num) noexcept
+        {
+            JUCE_AVX_LOOP (_mm256_storeu_ps (dest, _mm256_mul_ps (_mm256_loadu_ps (dest), _mm256_loadu_ps (src))),
+                           dest[i] *= src[i], JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        JUCE_AVX_FUNCTION static void multiply (float* dest, const float multiplier, int num) noexcept
+        {
+            const __m256 mult = _mm256_set1_ps (multiplier);
+            JUCE_AVX_LOOP (_mm256_storeu_ps (dest, _mm256_mul_ps (_mm256_loadu_ps (dest), mult)),
+                           dest[i] *= multiplier, JUCE_KERNEL_INCREMENT_DEST)
+        }
+
+        JUCE_AVX_FUNCTION static void convertFixedToFloat (float* dest, const int* src, const float multiplier, int num) noexcept
+        {
+            const __m256 mult = _mm256_set1_ps (multiplier);
+            JUCE_AVX_LOOP (_mm256_storeu_ps (dest, _mm256_mul_ps (mult, _mm256_cvtepi32_ps (_mm256_loadu_si256 ((const __m256i*) src)))),
+                           dest[i] = src[i] * multiplier, JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        JUCE_AVX_FUNCTION static void findMinAndMax (const float* src, int num, float& minResult, float& maxResult) noexcept
+        {
+            if (num < 16)
+            {
+                juce::findMinAndMax (src, num, minResult, maxResult);
+                return;
+            }
+
+            __m256 mn = _mm256_loadu_ps (src);
+            __m256 mx = mn;
+            src += 8;
+
+            for (int n = num / 8; --n > 0;)
+            {
+                const __m256 s = _mm256_loadu_ps (src);
+                mn = _mm256_min_ps (mn, s);
+                mx = _mm256_max_ps (mx, s);
+                src += 8;
+            }
+
+            float mns[8], mxs[8];
+            _mm256_storeu_ps (mns, mn);
+            _mm256_storeu_ps (mxs, mx);
+            _mm256_zeroupper();
+
+            float localMin = mns[0], localMax = mxs[0];
+
+            for (int i = 1; i < 8; ++i)
+            {
+                localMin = jmin (localMin, mns[i]);
+                localMax = jmax (localMax, mxs[i]);
+            }
+
+            num &= 7;
+
+            for (int i = 0; i < num; ++i)
+            {
+                localMin = jmin (localMin, src[i]);
+                localMax = jmax (localMax, src[i]);
+            }
+
+            minResult = localMin;
+            maxResult = localMax;
+        }
+
+        JUCE_AVX_FUNCTION static float findMinimumOrMaximum (const float* src, int num, const bool isMinimum) noexcept
+        {
+            if (num < 16)
+                return isMinimum ? juce::findMinimum (src, num)
+                                 : juce::findMaximum (src, num);
+
+            __m256 val = _mm256_loadu_ps (src);
+            src += 8;
+
+            for (int n = num / 8; --n > 0;)
+            {
+                const __m256 s = _mm256_loadu_ps (src);
+                val = isMinimum ? _mm256_min_ps (val, s)
+                                : _mm256_max_ps (val, s);
+                src += 8;
+            }
+
+            float vals[8];
+            _mm256_storeu_ps (vals, val);
+            _mm256_zeroupper();
+
+            float localVal = vals[0];
+
+            for (int i = 1; i < 8; ++i)
+                localVal = isMinimum ? jmin (localVal, vals[i])
+                                     : jmax (localVal, vals[i]);
+
+            num &= 7;
+
+            for (int i = 0; i < num; ++i)
+                localVal = isMinimum ? jmin (localVal, src[i])
+                                     : jmax (localVal, src[i]);
+
+            return localVal;
+        }
+
+        static float findMinimum (const float* src, int num) noexcept   { return findMinimumOrMaximum (src, num, true); }
+        static float findMaximum (const float* src, int num) noexcept   { return findMinimumOrMaximum (src, num, false); }
+
+        #undef JUCE_AVX_LOOP
+    }
+}
+
+#define JUCE_PERFORM_AVX_OP(functionCall) \
+    if (FloatVectorHelpers::isAVXAvailable()) \
+        return FloatVectorHelpers::AVX::functionCall;
+
+#else
+ #define JUCE_PERFORM_AVX_OP(functionCall)
+#endif
+
+//==============================================================================
+#if JUCE_USE_ARM_NEON
+
+namespace FloatVectorHelpers
+{
+    /* NEON is part of the baseline for arm64, and for armv7 builds it's enabled by the
+       compiler flags, so unlike the Intel code there's no need for a run-time check.
+    */
+    namespace NEON
+    {
+        #define JUCE_NEON_LOOP(neonOp, normalOp, increment) \
+            JUCE_VECTOR_KERNEL_LOOP (4, neonOp, normalOp, increment, (void) 0)
+
+        static void fill (float* dest, const float valueToFill, int num) noexcept
+        {
+            const float32x4_t val = vdupq_n_f32 (valueToFill);
+            JUCE_NEON_LOOP (vst1q_f32 (dest, val), dest[i] = valueToFill, JUCE_KERNEL_INCREMENT_DEST)
+        }
+
+        static void copyWithMultiply (float* dest, const float* src, const float multiplier, int num) noexcept
+        {
+            JUCE_NEON_LOOP (vst1q_f32 (dest, vmulq_n_f32 (vld1q_f32 (src), multiplier)),
+                            dest[i] = src[i] * multiplier, JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        static void add (float* dest, const float* src, int num) noexcept
+        {
+            JUCE_NEON_LOOP (vst1q_f32 (dest, vaddq_f32 (vld1q_f32 (dest), vld1q_f32 (src))),
+                            dest[i] += src[i], JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        static void add (float* dest, const float amount, int num) noexcept
+        {
+            const float32x4_t amountToAdd = vdupq_n_f32 (amount);
+            JUCE_NEON_LOOP (vst1q_f32 (dest, vaddq_f32 (vld1q_f32 (dest), amountToAdd)),
+                            dest[i] += amount, JUCE_KERNEL_INCREMENT_DEST)
+        }
+
+        static void addWithMultiply (float* dest, const float* src, const float multiplier, int num) noexcept
+        {
+            JUCE_NEON_LOOP (vst1q_f32 (dest, vmlaq_n_f32 (vld1q_f32 (dest), vld1q_f32 (src), multiplier)),
+                            dest[i] += src[i] * multiplier, JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        static void multiply (float* dest, const float* src, int num) noexcept
+        {
+            JUCE_NEON_LOOP (vst1q_f32 (dest, vmulq_f32 (vld1q_f32 (dest), vld1q_f32 (src))),
+                            dest[i] *= src[i], JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        static void multiply (float* dest, const float multiplier, int num) noexcept
+        {
+            JUCE_NEON_LOOP (vst1q_f32 (dest, vmulq_n_f32 (vld1q_f32 (dest), multiplier)),
+                            dest[i] *= multiplier, JUCE_KERNEL_INCREMENT_DEST)
+        }
+
+        static void convertFixedToFloat (float* dest, const int* src, const float multiplier, int num) noexcept
+        {
+            JUCE_NEON_LOOP (vst1q_f32 (dest, vmulq_n_f32 (vcvtq_f32_s32 (vld1q_s32 (src)), multiplier)),
+                            dest[i] = src[i] * multiplier, JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        static void convertFixedToFloat (float* dest, const int16* src, const float multiplier, int num) noexcept
+        {
+            JUCE_NEON_LOOP (vst1q_f32 (dest, vmulq_n_f32 (vcvtq_f32_s32 (vmovl_s16 (vld1_s16 (src))), multiplier)),
+                            dest[i] = src[i] * multiplier, JUCE_KERNEL_INCREMENT_SRC_DEST)
+        }
+
+        static void findMinAndMax (const float* src, int num, float& minResult, float& maxResult) noexcept
+        {
+            if (num < 8)
+            {
+                juce::findMinAndMax (src, num, minResult, maxResult);
+                return;
+            }
+
+            float32x4_t mn = vld1q_f32 (src);
+            float32x4_t mx = mn;
+            src += 4;
+
+            for (int n = num / 4; --n > 0;)
+            {
+                const float32x4_t s = vld1q_f32 (src);
+                mn = vminq_f32 (mn, s);
+                mx = vmaxq_f32 (mx, s);
+                src += 4;
+            }
+
+            float mns[4], mxs[4];
+            vst1q_f32 (mns, mn);
+            vst1q_f32 (mxs, mx);
+
+            float localMin = jmin (mns[0], mns[1], mns[2], mns[3]);
+            float localMax = jmax (mxs[0], mxs[1], mxs[2], mxs[3]);
+
+            num &= 3;
+
+            for (int i = 0; i < num; ++i)
+            {
+                localMin = jmin (localMin, src[i]);
+                localMax = jmax (localMax, src[i]);
+            }
+
+            minResult = localMin;
+            maxResult = localMax;
+        }
+
+        static float findMinimumOrMaximum (const float* src, int num, const bool isMinimum) noexcept
+        {
+            if (num < 8)
+                return isMinimum ? juce::findMinimum (src, num)
+                                 : juce::findMaximum (src, num);
+
+            float32x4_t val = vld1q_f32 (src);
+            src += 4;
+
+            for (int n = num / 4; --n > 0;)
+            {
+                const float32x4_t s = vld1q_f32 (src);
+                val = isMinimum ? vminq_f32 (val, s)
+                                : vmaxq_f32 (val, s);
+                src += 4;
+            }
+
+            float vals[4];
+            vst1q_f32 (vals, val);
+
+            float localVal = isMinimum ? jmin (vals[0], vals[1], vals[2], vals[3])
+                                       : jmax (vals[0], vals[1], vals[2], vals[3]);
+
+            num &= 3;
+
+            for (int i = 0; i < num; ++i)
+                localVal = isMinimum ? jmin (localVal, src[i])
+                                     : jmax (localVal, src[i]);
+
+            return localVal;
+        }
+
+        static float findMinimum (const float* src, int num) noexcept   { return findMinimumOrMaximum (src, num, true); }
+        static float findMaximum (const float* src, int num) noexcept   { return findMinimumOrMaximum (src, num, false); }
+
+        #undef JUCE_NEON_LOOP
+    }
+}
+
+#define JUCE_PERFORM_NEON_OP(functionCall) \
+    return FloatVectorHelpers::NEON::functionCall;
+
+#else
+ #define JUCE_PERFORM_NEON_OP(functionCall)
 #endif
 
+/* Tries the best vector kernel for the current machine, returning from the calling
+   function if one was used. Otherwise the code that follows this provides the SSE
+   or plain C version.
+*/
+#define JUCE_PERFORM_WIDE_VECTOR_OP(functionCall) \
+    JUCE_PERFORM_AVX_OP (functionCall) \
+    JUCE_PERFORM_NEON_OP (functionCall)
+
+//==============================================================================
+namespace FloatVectorHelpers
+{
+    template <typename Type>
+    static void interleave (Type* dest, const Type* const* src, const int numChannels, const int num) noexcept
+    {
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            const Type* s = src [chan];
+            Type* d = dest + chan;
+
+            for (int i = num; --i >= 0;)
+            {
+                *d = *s++;
+                d += numChannels;
+            }
+        }
+    }
+
+    template <typename Type>
+    static void deinterleave (Type* const* dest, const Type* src, const int numChannels, const int num) noexcept
+    {
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            Type* d = dest [chan];
+            const Type* s = src + chan;
+
+            for (int i = num; --i >= 0;)
+            {
+                *d++ = *s;
+                s += numChannels;
+            }
+        }
+    }
+}
+
 void JUCE_CALLTYPE FloatVectorOperations::clear (float* dest, int num) noexcept
 {
    #if JUCE_USE_VDSP_FRAMEWORK
@@ -174,8 +690,11 @@ void JUCE_CALLTYPE FloatVectorOperations::fill (float* dest, float valueToFill,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vfill (&valueToFill, dest, 1, num);
    #else
+    JUCE_PERFORM_WIDE_VECTOR_OP (fill (dest, valueToFill, num))
+
     #if JUCE_USE_SSE_INTRINSICS
-     const __m128 val = _mm_load1_ps (&valueToFill);
+     typedef FloatVectorHelpers::BasicOps32 Mode;
+     const Mode::ParallelType val = Mode::load1 (valueToFill);
     #endif
 
     JUCE_PERFORM_SSE_OP_DEST (dest[i] = valueToFill, val, JUCE_LOAD_NONE)
@@ -192,12 +711,15 @@ void JUCE_CALLTYPE FloatVectorOperations::copyWithMultiply (float* dest, const f
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmul (src, 1, &multiplier, dest, 1, num);
    #else
+    JUCE_PERFORM_WIDE_VECTOR_OP (copyWithMultiply (dest, src, multiplier, num))
+
     #if JUCE_USE_SSE_INTRINSICS
-     const __m128 mult = _mm_load1_ps (&multiplier);
+     typedef FloatVectorHelpers::BasicOps32 Mode;
+     const Mode::ParallelType mult = Mode::load1 (multiplier);
     #endif
 
     JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = src[i] * multiplier,
-                                  _mm_mul_ps (mult, s),
+                                  Mode::mul (mult, s),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
    #endif
 }
@@ -207,41 +729,74 @@ void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, const float* src, in
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vadd (src, 1, dest, 1, dest, 1, num);
    #else
+    JUCE_PERFORM_WIDE_VECTOR_OP (add (dest, src, num))
+
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps32 Mode;
+    #endif
+
     JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] += src[i],
-                                  _mm_add_ps (d, s),
+                                  Mode::add (d, s),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
    #endif
 }
 
 void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, float amount, int num) noexcept
 {
+    JUCE_PERFORM_WIDE_VECTOR_OP (add (dest, amount, num))
+
    #if JUCE_USE_SSE_INTRINSICS
-    const __m128 amountToAdd = _mm_load1_ps (&amount);
+    typedef FloatVectorHelpers::BasicOps32 Mode;
+    const Mode::ParallelType amountToAdd = Mode::load1 (amount);
    #endif
 
     JUCE_PERFORM_SSE_OP_DEST (dest[i] += amount,
-                              _mm_add_ps (d, amountToAdd),
+                              Mode::add (d, amountToAdd),
                               JUCE_LOAD_DEST)
 }
 
 void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const float* src, float multiplier, int num) noexcept
 {
+    JUCE_PERFORM_WIDE_VECTOR_OP (addWithMultiply (dest, src, multiplier, num))
+
    #if JUCE_USE_SSE_INTRINSICS
-    const __m128 mult = _mm_load1_ps (&multiplier);
+    typedef FloatVectorHelpers::BasicOps32 Mode;
+    const Mode::ParallelType mult = Mode::load1 (multiplier);
    #endif
 
     JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] += src[i] * multiplier,
-                                  _mm_add_ps (d, _mm_mul_ps (mult, s)),
+                                  Mode::add (d, Mode::mul (mult, s)),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
 }
 
+void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const float* src1, const float* src2, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vma (src1, 1, src2, 1, dest, 1, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps32 Mode;
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC1_SRC2_DEST (dest[i] += src1[i] * src2[i],
+                                        Mode::add (d, Mode::mul (s1, s2)),
+                                        JUCE_LOAD_SRC1_SRC2_DEST)
+   #endif
+}
+
 void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, const float* src, int num) noexcept
 {
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmul (src, 1, dest, 1, dest, 1, num);
    #else
+    JUCE_PERFORM_WIDE_VECTOR_OP (multiply (dest, src, num))
+
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps32 Mode;
+    #endif
+
     JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] *= src[i],
-                                  _mm_mul_ps (d, s),
+                                  Mode::mul (d, s),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
    #endif
 }
@@ -251,85 +806,254 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, float multiplie
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmul (dest, 1, &multiplier, dest, 1, num);
    #else
+    JUCE_PERFORM_WIDE_VECTOR_OP (multiply (dest, multiplier, num))
+
     #if JUCE_USE_SSE_INTRINSICS
-     const __m128 mult = _mm_load1_ps (&multiplier);
+     typedef FloatVectorHelpers::BasicOps32 Mode;
+     const Mode::ParallelType mult = Mode::load1 (multiplier);
     #endif
 
     JUCE_PERFORM_SSE_OP_DEST (dest[i] *= multiplier,
-                              _mm_mul_ps (d, mult),
+                              Mode::mul (d, mult),
                               JUCE_LOAD_DEST)
    #endif
 }
 
-void JUCE_CALLTYPE FloatVectorOperations::convertFixedToFloat (float* dest, const int* src, float multiplier, int num) noexcept
+void JUCE_CALLTYPE FloatVectorOperations::negate (float* dest, const float* src, int num) noexcept
 {
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vneg ((float*) src, 1, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps32 Mode;
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = -src[i],
+                                  Mode::negate (s),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::abs (float* dest, const float* src, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vabs ((float*) src, 1, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps32 Mode;
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = std::abs (src[i]),
+                                  Mode::abs (s),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::clip (float* dest, const float* src, float low, float high, int num) noexcept
+{
+    jassert (high >= low);
+
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vclip ((float*) src, 1, &low, &high, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps32 Mode;
+     const Mode::ParallelType lo = Mode::load1 (low);
+     const Mode::ParallelType hi = Mode::load1 (high);
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = jlimit (low, high, src[i]),
+                                  Mode::min (Mode::max (s, lo), hi),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::min (float* dest, const float* src, float comp, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps32 Mode;
+    const Mode::ParallelType cmp = Mode::load1 (comp);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = jmin (src[i], comp),
+                                  Mode::min (s, cmp),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::max (float* dest, const float* src, float comp, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps32 Mode;
+    const Mode::ParallelType cmp = Mode::load1 (comp);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = jmax (src[i], comp),
+                                  Mode::max (s, cmp),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::copyWithRamp (float* dest, const float* src, float multiplier, float endMultiplier, int num) noexcept
+{
+    if (num <= 0)
+        return;
+
+    const float delta = (endMultiplier - multiplier) / num;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps32 Mode;
+   #endif
+
+    JUCE_PERFORM_SSE_RAMP_OP ({ dest[i] = src[i] * multiplier; multiplier += delta; },
+                              Mode::mul (s, g),
+                              JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithRamp (float* dest, const float* src, float multiplier, float endMultiplier, int num) noexcept
+{
+    if (num <= 0)
+        return;
+
+    const float delta = (endMultiplier - multiplier) / num;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps32 Mode;
+   #endif
+
+    JUCE_PERFORM_SSE_RAMP_OP ({ dest[i] += src[i] * multiplier; multiplier += delta; },
+                              Mode::add (d, Mode::mul (s, g)),
+                              JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::multiplyWithRamp (float* dest, float multiplier, float endMultiplier, int num) noexcept
+{
+    if (num <= 0)
+        return;
+
+    const float delta = (endMultiplier - multiplier) / num;
+
    #if JUCE_USE_SSE_INTRINSICS
-    const __m128 mult = _mm_load1_ps (&multiplier);
+    typedef FloatVectorHelpers::BasicOps32 Mode;
+   #endif
+
+    JUCE_PERFORM_SSE_RAMP_OP ({ dest[i] *= multiplier; multiplier += delta; },
+                              Mode::mul (d, g),
+                              JUCE_LOAD_DEST, JUCE_INCREMENT_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::convertFixedToFloat (float* dest, const int* src, float multiplier, int num) noexcept
+{
+    JUCE_PERFORM_WIDE_VECTOR_OP (convertFixedToFloat (dest, src, multiplier, num))
+
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps32 Mode;
+    const Mode::ParallelType mult = Mode::load1 (multiplier);
    #endif
 
     JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = src[i] * multiplier,
-                                  _mm_mul_ps (mult, _mm_cvtepi32_ps (_mm_loadu_si128 ((const __m128i*) src))),
+                                  Mode::mul (mult, _mm_cvtepi32_ps (_mm_loadu_si128 ((const __m128i*) src))),
                                   JUCE_LOAD_NONE, JUCE_INCREMENT_SRC_DEST)
 }
 
-void JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const float* src, int num, float& minResult, float& maxResult) noexcept
+void JUCE_CALLTYPE FloatVectorOperations::convertFixedToFloat (float* dest, const int16* src, float multiplier, int num) noexcept
 {
+    // (there's no AVX version of this, as widening the integers needs AVX2)
+    JUCE_PERFORM_NEON_OP (convertFixedToFloat (dest, src, multiplier, num))
+
    #if JUCE_USE_SSE_INTRINSICS
-    const int numLongOps = num / 4;
+    typedef FloatVectorHelpers::BasicOps32 Mode;
+    const Mode::ParallelType mult = Mode::load1 (multiplier);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = src[i] * multiplier,
+                                  Mode::mul (mult, _mm_cvtepi32_ps (FloatVectorHelpers::loadInt16x4 (src))),
+                                  JUCE_LOAD_NONE, JUCE_INCREMENT_SRC_DEST)
+}
 
-    if (numLongOps > 1 && FloatVectorHelpers::isSSE2Available())
+void JUCE_CALLTYPE FloatVectorOperations::interleave (float* dest, const float* const* src, int numChannels, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    if (numChannels == 2 && FloatVectorHelpers::isSSE2Available())
     {
-        __m128 mn, mx;
-
-        #define JUCE_MINMAX_SSE_LOOP(loadOp) \
-            mn = loadOp (src); \
-            mx = mn; \
-            src += 4; \
-            for (int i = 1; i < numLongOps; ++i) \
-            { \
-                const __m128 s = loadOp (src); \
-                mn = _mm_min_ps (mn, s); \
-                mx = _mm_max_ps (mx, s); \
-                src += 4; \
-            }
+        const float* left = src[0];
+        const float* right = src[1];
 
-        if (FloatVectorHelpers::isAligned (src)) { JUCE_MINMAX_SSE_LOOP (_mm_load_ps) }
-        else                                     { JUCE_MINMAX_SSE_LOOP (_mm_loadu_ps) }
+        for (int i = num / 4; --i >= 0;)
+        {
+            const __m128 l = _mm_loadu_ps (left);
+            const __m128 r = _mm_loadu_ps (right);
+            _mm_storeu_ps (dest,     _mm_unpacklo_ps (l, r));
+            _mm_storeu_ps (dest + 4, _mm_unpackhi_ps (l, r));
+            left += 4;
+            right += 4;
+            dest += 8;
+        }
 
-        float localMin, localMax;
+        FloatVectorHelpers::mmEmpty();
 
+        for (int i = 0; i < (num & 3); ++i)
         {
-            float mns[4], mxs[4];
-            _mm_storeu_ps (mns, mn);
-            _mm_storeu_ps (mxs, mx);
-            FloatVectorHelpers::mmEmpty();
+            dest[i * 2]     = left[i];
+            dest[i * 2 + 1] = right[i];
+        }
+
+        return;
+    }
+   #endif
+
+    FloatVectorHelpers::interleave (dest, src, numChannels, num);
+}
 
-            localMin = jmin (mns[0], mns[1], mns[2], mns[3]);
-            localMax = jmax (mxs[0], mxs[1], mxs[2], mxs[3]);
+void JUCE_CALLTYPE FloatVectorOperations::deinterleave (float* const* dest, const float* src, int numChannels, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    if (numChannels == 2 && FloatVectorHelpers::isSSE2Available())
+    {
+        float* left = dest[0];
+        float* right = dest[1];
+
+        for (int i = num / 4; --i >= 0;)
+        {
+            const __m128 a = _mm_loadu_ps (src);
+            const __m128 b = _mm_loadu_ps (src + 4);
+            _mm_storeu_ps (left,  _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+            _mm_storeu_ps (right, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+            left += 4;
+            right += 4;
+            src += 8;
         }
 
-        num &= 3;
+        FloatVectorHelpers::mmEmpty();
 
-        for (int i = 0; i < num; ++i)
+        for (int i = 0; i < (num & 3); ++i)
         {
-            const float s = src[i];
-            localMin = jmin (localMin, s);
-            localMax = jmax (localMax, s);
+            left[i]  = src[i * 2];
+            right[i] = src[i * 2 + 1];
         }
 
-        minResult = localMin;
-        maxResult = localMax;
         return;
     }
    #endif
 
+    FloatVectorHelpers::deinterleave (dest, src, numChannels, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const float* src, int num, float& minResult, float& maxResult) noexcept
+{
+    JUCE_PERFORM_WIDE_VECTOR_OP (findMinAndMax (src, num, minResult, maxResult))
+
+   #if JUCE_USE_SSE_INTRINSICS
+    FloatVectorHelpers::findMinAndMax<FloatVectorHelpers::BasicOps32> (src, num, minResult, maxResult);
+   #else
     juce::findMinAndMax (src, num, minResult, maxResult);
+   #endif
 }
 
 float JUCE_CALLTYPE FloatVectorOperations::findMinimum (const float* src, int num) noexcept
 {
+    JUCE_PERFORM_WIDE_VECTOR_OP (findMinimum (src, num))
+
    #if JUCE_USE_SSE_INTRINSICS
-    return FloatVectorHelpers::findMinimumOrMaximum (src, num, true);
+    return FloatVectorHelpers::findMinimumOrMaximum<FloatVectorHelpers::BasicOps32> (src, num, true);
    #else
     return juce::findMinimum (src, num);
    #endif
@@ -337,9 +1061,635 @@ float JUCE_CALLTYPE FloatVectorOperations::findMinimum (const float* src, int nu
 
 float JUCE_CALLTYPE FloatVectorOperations::findMaximum (const float* src, int num) noexcept
 {
+    JUCE_PERFORM_WIDE_VECTOR_OP (findMaximum (src, num))
+
    #if JUCE_USE_SSE_INTRINSICS
-    return FloatVectorHelpers::findMinimumOrMaximum (src, num, false);
+    return FloatVectorHelpers::findMinimumOrMaximum<FloatVectorHelpers::BasicOps32> (src, num, false);
    #else
     return juce::findMaximum (src, num);
    #endif
 }
+
+//==============================================================================
+void JUCE_CALLTYPE FloatVectorOperations::clear (double* dest, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vclrD (dest, 1, num);
+   #else
+    zeromem (dest, num * sizeof (double));
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::fill (double* dest, double valueToFill, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vfillD (&valueToFill, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps64 Mode;
+     const Mode::ParallelType val = Mode::load1 (valueToFill);
+    #endif
+
+    JUCE_PERFORM_SSE_OP_DEST (dest[i] = valueToFill, val, JUCE_LOAD_NONE)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::copy (double* dest, const double* src, int num) noexcept
+{
+    memcpy (dest, src, num * sizeof (double));
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::copyWithMultiply (double* dest, const double* src, double multiplier, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vsmulD (src, 1, &multiplier, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps64 Mode;
+     const Mode::ParallelType mult = Mode::load1 (multiplier);
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = src[i] * multiplier,
+                                  Mode::mul (mult, s),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::add (double* dest, const double* src, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vaddD (src, 1, dest, 1, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps64 Mode;
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] += src[i],
+                                  Mode::add (d, s),
+                                  JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::add (double* dest, double amount, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps64 Mode;
+    const Mode::ParallelType amountToAdd = Mode::load1 (amount);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_DEST (dest[i] += amount,
+                              Mode::add (d, amountToAdd),
+                              JUCE_LOAD_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (double* dest, const double* src, double multiplier, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps64 Mode;
+    const Mode::ParallelType mult = Mode::load1 (multiplier);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] += src[i] * multiplier,
+                                  Mode::add (d, Mode::mul (mult, s)),
+                                  JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (double* dest, const double* src1, const double* src2, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vmaD (src1, 1, src2, 1, dest, 1, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps64 Mode;
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC1_SRC2_DEST (dest[i] += src1[i] * src2[i],
+                                        Mode::add (d, Mode::mul (s1, s2)),
+                                        JUCE_LOAD_SRC1_SRC2_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::multiply (double* dest, const double* src, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vmulD (src, 1, dest, 1, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps64 Mode;
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] *= src[i],
+                                  Mode::mul (d, s),
+                                  JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::multiply (double* dest, double multiplier, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vsmulD (dest, 1, &multiplier, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps64 Mode;
+     const Mode::ParallelType mult = Mode::load1 (multiplier);
+    #endif
+
+    JUCE_PERFORM_SSE_OP_DEST (dest[i] *= multiplier,
+                              Mode::mul (d, mult),
+                              JUCE_LOAD_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::negate (double* dest, const double* src, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vnegD ((double*) src, 1, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps64 Mode;
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = -src[i],
+                                  Mode::negate (s),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::abs (double* dest, const double* src, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vabsD ((double*) src, 1, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps64 Mode;
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = std::abs (src[i]),
+                                  Mode::abs (s),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::clip (double* dest, const double* src, double low, double high, int num) noexcept
+{
+    jassert (high >= low);
+
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vclipD ((double*) src, 1, &low, &high, dest, 1, num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     typedef FloatVectorHelpers::BasicOps64 Mode;
+     const Mode::ParallelType lo = Mode::load1 (low);
+     const Mode::ParallelType hi = Mode::load1 (high);
+    #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = jlimit (low, high, src[i]),
+                                  Mode::min (Mode::max (s, lo), hi),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::min (double* dest, const double* src, double comp, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps64 Mode;
+    const Mode::ParallelType cmp = Mode::load1 (comp);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = jmin (src[i], comp),
+                                  Mode::min (s, cmp),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::max (double* dest, const double* src, double comp, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps64 Mode;
+    const Mode::ParallelType cmp = Mode::load1 (comp);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = jmax (src[i], comp),
+                                  Mode::max (s, cmp),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::copyWithRamp (double* dest, const double* src, double multiplier, double endMultiplier, int num) noexcept
+{
+    if (num <= 0)
+        return;
+
+    const double delta = (endMultiplier - multiplier) / num;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps64 Mode;
+   #endif
+
+    JUCE_PERFORM_SSE_RAMP_OP ({ dest[i] = src[i] * multiplier; multiplier += delta; },
+                              Mode::mul (s, g),
+                              JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithRamp (double* dest, const double* src, double multiplier, double endMultiplier, int num) noexcept
+{
+    if (num <= 0)
+        return;
+
+    const double delta = (endMultiplier - multiplier) / num;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps64 Mode;
+   #endif
+
+    JUCE_PERFORM_SSE_RAMP_OP ({ dest[i] += src[i] * multiplier; multiplier += delta; },
+                              Mode::add (d, Mode::mul (s, g)),
+                              JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::multiplyWithRamp (double* dest, double multiplier, double endMultiplier, int num) noexcept
+{
+    if (num <= 0)
+        return;
+
+    const double delta = (endMultiplier - multiplier) / num;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef FloatVectorHelpers::BasicOps64 Mode;
+   #endif
+
+    JUCE_PERFORM_SSE_RAMP_OP ({ dest[i] *= multiplier; multiplier += delta; },
+                              Mode::mul (d, g),
+                              JUCE_LOAD_DEST, JUCE_INCREMENT_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::interleave (double* dest, const double* const* src, int numChannels, int num) noexcept
+{
+    FloatVectorHelpers::interleave (dest, src, numChannels, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::deinterleave (double* const* dest, const double* src, int numChannels, int num) noexcept
+{
+    FloatVectorHelpers::deinterleave (dest, src, numChannels, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const double* src, int num, double& minResult, double& maxResult) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    FloatVectorHelpers::findMinAndMax<FloatVectorHelpers::BasicOps64> (src, num, minResult, maxResult);
+   #else
+    juce::findMinAndMax (src, num, minResult, maxResult);
+   #endif
+}
+
+double JUCE_CALLTYPE FloatVectorOperations::findMinimum (const double* src, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    return FloatVectorHelpers::findMinimumOrMaximum<FloatVectorHelpers::BasicOps64> (src, num, true);
+   #else
+    return juce::findMinimum (src, num);
+   #endif
+}
+
+double JUCE_CALLTYPE FloatVectorOperations::findMaximum (const double* src, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    return FloatVectorHelpers::findMinimumOrMaximum<FloatVectorHelpers::BasicOps64> (src, num, false);
+   #else
+    return juce::findMaximum (src, num);
+   #endif
+}
+
+//==============================================================================
+void JUCE_CALLTYPE FloatVectorOperations::copy (double* dest, const float* src, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vspdp (src, 1, dest, 1, (vDSP_Length) num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     for (int n = num / 4; --n >= 0;)
+     {
+         const __m128 s = _mm_loadu_ps (src);
+         _mm_storeu_pd (dest,     _mm_cvtps_pd (s));
+         _mm_storeu_pd (dest + 2, _mm_cvtps_pd (_mm_movehl_ps (s, s)));
+         dest += 4;
+         src += 4;
+     }
+
+     num &= 3;
+    #endif
+
+    for (int i = 0; i < num; ++i)
+        dest[i] = src[i];
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::copy (float* dest, const double* src, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vdpsp (src, 1, dest, 1, (vDSP_Length) num);
+   #else
+    #if JUCE_USE_SSE_INTRINSICS
+     for (int n = num / 4; --n >= 0;)
+     {
+         _mm_storeu_ps (dest, _mm_movelh_ps (_mm_cvtpd_ps (_mm_loadu_pd (src)),
+                                             _mm_cvtpd_ps (_mm_loadu_pd (src + 2))));
+         dest += 4;
+         src += 4;
+     }
+
+     num &= 3;
+    #endif
+
+    for (int i = 0; i < num; ++i)
+        dest[i] = (float) src[i];
+   #endif
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FloatVectorOperationsTests  : public UnitTest
+{
+public:
+    FloatVectorOperationsTests() : UnitTest ("FloatVectorOperations") {}
+
+    void runTest()
+    {
+        beginTest ("Float operations");
+
+        Random r;
+
+        // (these sizes and offsets exercise the vector loops, their remainders and unaligned data)
+        for (int num = 0; num < 70; ++num)
+            for (int offset = 0; offset < 4; ++offset)
+                TestRunner<float>::test (*this, r, num, offset);
+
+        beginTest ("Double operations");
+
+        for (int num = 0; num < 70; ++num)
+            for (int offset = 0; offset < 4; ++offset)
+                TestRunner<double>::test (*this, r, num, offset);
+
+        beginTest ("Fixed to float conversion");
+
+        for (int num = 1; num < 70; ++num)
+        {
+            HeapBlock<int> ints (num + 1);
+            HeapBlock<float> dest (num + 1);
+
+            for (int i = 0; i < num; ++i)
+                ints[i] = r.nextInt (20000) - 10000;
+
+            FloatVectorOperations::convertFixedToFloat (dest + 1, ints + 1, 0.25f, num - 1);
+            for (int i = 1; i < num; ++i)  expect (dest[i] == ints[i] * 0.25f);
+
+            HeapBlock<int16> shorts (num + 1);
+
+            for (int i = 0; i < num; ++i)
+                shorts[i] = (int16) (r.nextInt (65536) - 32768);
+
+            FloatVectorOperations::convertFixedToFloat (dest + 1, shorts + 1, 1.0f / 32768.0f, num - 1);
+            for (int i = 1; i < num; ++i)  expect (dest[i] == shorts[i] * (1.0f / 32768.0f));
+        }
+
+        beginTest ("Interleaving");
+
+        for (int numChannels = 1; numChannels <= 3; ++numChannels)
+            for (int num = 0; num < 20; ++num)
+                TestRunner<float>::testInterleaving (*this, numChannels, num);
+
+        TestRunner<double>::testInterleaving (*this, 2, 13);
+
+        beginTest ("Precision conversion");
+
+        for (int num = 1; num < 70; ++num)
+        {
+            HeapBlock<float> floats (num + 1), roundTrip (num + 1);
+            HeapBlock<double> doubles (num + 1);
+
+            for (int i = 0; i < num; ++i)
+                floats[i] = r.nextFloat() * 2.0f - 1.0f;
+
+            FloatVectorOperations::copy (doubles + 1, floats + 1, num - 1);
+            for (int i = 1; i < num; ++i)  expect (doubles[i] == (double) floats[i]);
+
+            FloatVectorOperations::copy (roundTrip + 1, doubles + 1, num - 1);
+            for (int i = 1; i < num; ++i)  expect (roundTrip[i] == floats[i]);
+        }
+    }
+
+    template <typename Type>
+    struct TestRunner
+    {
+        static void test (UnitTest& u, Random& r, const int num, const int offset)
+        {
+            HeapBlock<Type> srcBlock (num + 8), src2Block (num + 8), destBlock (num + 8), expectedBlock (num + 8);
+
+            Type* const src = srcBlock + offset;
+            Type* const src2 = src2Block + offset;
+            Type* const dest = destBlock + offset;
+            Type* const expected = expectedBlock + offset;
+
+            // small whole numbers and a power-of-two multiplier keep every result exact
+            for (int i = 0; i < num; ++i)
+            {
+                src[i]      = (Type) (r.nextInt (200) - 100);
+                src2[i]     = (Type) (r.nextInt (200) - 100);
+                expected[i] = (Type) (r.nextInt (200) - 100);
+            }
+
+            const Type multiplier = (Type) 0.25;
+
+            FloatVectorOperations::fill (dest, (Type) 3, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == (Type) 3);
+
+            FloatVectorOperations::copy (dest, expected, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == expected[i]);
+
+            FloatVectorOperations::clear (dest, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == 0);
+
+            FloatVectorOperations::copyWithMultiply (dest, src, multiplier, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == src[i] * multiplier);
+
+            copy (dest, expected, num);
+            FloatVectorOperations::add (dest, src, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == expected[i] + src[i]);
+
+            copy (dest, expected, num);
+            FloatVectorOperations::add (dest, (Type) 7, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == expected[i] + (Type) 7);
+
+            copy (dest, expected, num);
+            FloatVectorOperations::addWithMultiply (dest, src, multiplier, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == expected[i] + src[i] * multiplier);
+
+            copy (dest, expected, num);
+            FloatVectorOperations::addWithMultiply (dest, src, src2, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == expected[i] + src[i] * src2[i]);
+
+            copy (dest, expected, num);
+            FloatVectorOperations::multiply (dest, src, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == expected[i] * src[i]);
+
+            copy (dest, expected, num);
+            FloatVectorOperations::multiply (dest, multiplier, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == expected[i] * multiplier);
+
+            FloatVectorOperations::negate (dest, src, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == -src[i]);
+
+            FloatVectorOperations::abs (dest, src, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == std::abs (src[i]));
+
+            FloatVectorOperations::clip (dest, src, (Type) -20, (Type) 30, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == jlimit ((Type) -20, (Type) 30, src[i]));
+
+            FloatVectorOperations::min (dest, src, (Type) 10, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == jmin (src[i], (Type) 10));
+
+            FloatVectorOperations::max (dest, src, (Type) 10, num);
+            for (int i = 0; i < num; ++i)  u.expect (dest[i] == jmax (src[i], (Type) 10));
+
+            // the ramps can't be exact, as the vector and scalar code accumulate the gains differently
+            const Type startGain = (Type) 0.5, endGain = (Type) 2;
+            const Type delta = (endGain - startGain) / jmax (1, num);
+
+            FloatVectorOperations::copyWithRamp (dest, src, startGain, endGain, num);
+            for (int i = 0; i < num; ++i)  u.expect (isClose (dest[i], src[i] * (startGain + delta * i)));
+
+            copy (dest, expected, num);
+            FloatVectorOperations::addWithRamp (dest, src, startGain, endGain, num);
+            for (int i = 0; i < num; ++i)  u.expect (isClose (dest[i], expected[i] + src[i] * (startGain + delta * i)));
+
+            copy (dest, expected, num);
+            FloatVectorOperations::multiplyWithRamp (dest, startGain, endGain, num);
+            for (int i = 0; i < num; ++i)  u.expect (isClose (dest[i], expected[i] * (startGain + delta * i)));
+
+            if (num > 0)
+            {
+                Type mn, mx;
+                FloatVectorOperations::findMinAndMax (src, num, mn, mx);
+                u.expect (mn == juce::findMinimum (src, num));
+                u.expect (mx == juce::findMaximum (src, num));
+
+                u.expect (FloatVectorOperations::findMinimum (src, num) == mn);
+                u.expect (FloatVectorOperations::findMaximum (src, num) == mx);
+            }
+        }
+
+        static void testInterleaving (UnitTest& u, const int numChannels, const int num)
+        {
+            HeapBlock<Type> interleaved (numChannels * num + 1), result (numChannels * num + 1);
+            HeapBlock<Type> channelData (numChannels * num + 1);
+            HeapBlock<Type*> channels (numChannels);
+
+            for (int i = 0; i < numChannels; ++i)
+                channels[i] = channelData + i * num;
+
+            for (int i = 0; i < numChannels * num; ++i)
+                interleaved[i] = (Type) i;
+
+            FloatVectorOperations::deinterleave (channels.getData(), interleaved, numChannels, num);
+
+            for (int chan = 0; chan < numChannels; ++chan)
+                for (int i = 0; i < num; ++i)
+                    u.expect (channels[chan][i] == (Type) (i * numChannels + chan));
+
+            FloatVectorOperations::interleave (result, channels.getData(), numChannels, num);
+
+            for (int i = 0; i < numChannels * num; ++i)
+                u.expect (result[i] == (Type) i);
+        }
+
+        static bool isClose (const Type a, const Type b)
+        {
+            return std::abs (a - b) <= (Type) 1.0e-4 * jmax ((Type) 1, std::abs (b));
+        }
+
+        static void copy (Type* dest, const Type* src, int num)
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i] = src[i];
+        }
+    };
+};
+
+static FloatVectorOperationsTests floatVectorOperationsTests;
+
+//==============================================================================
+class FloatVectorOperationsBenchmark  : public Benchmark
+{
+public:
+    FloatVectorOperationsBenchmark (const int numSamples_)
+        : Benchmark ("FloatVectorOperations: " + String (numSamples_) + "-sample mix", numSamples_),
+          numSamples (numSamples_)
+    {
+    }
+
+    void initialise()
+    {
+        dest.allocate (numSamples, true);
+        src.allocate (numSamples, true);
+        FloatVectorOperations::fill (src, 0.5f, numSamples);
+    }
+
+    void runIteration()
+    {
+        FloatVectorOperations::copyWithMultiply (dest, src, 0.75f, numSamples);
+        FloatVectorOperations::addWithMultiply (dest, src, 0.25f, numSamples);
+        FloatVectorOperations::multiply (dest, src, numSamples);
+        FloatVectorOperations::clip (dest, dest, -0.5f, 0.5f, numSamples);
+
+        preventOptimisation (dest);
+    }
+
+    void shutdown()
+    {
+        dest.free();
+        src.free();
+    }
+
+private:
+    const int numSamples;
+    HeapBlock<float> dest, src;
+};
+
+static FloatVectorOperationsBenchmark floatVectorOperationsBenchmark64 (64);
+static FloatVectorOperationsBenchmark floatVectorOperationsBenchmark512 (512);
+static FloatVectorOperationsBenchmark floatVectorOperationsBenchmark4096 (4096);
+
+class FixedToFloatBenchmark  : public Benchmark
+{
+public:
+    FixedToFloatBenchmark() : Benchmark ("FloatVectorOperations: 4096 int16 samples to float", numSamples) {}
+
+    void initialise()
+    {
+        dest.allocate (numSamples, true);
+        src.allocate (numSamples, true);
+
+        for (int i = 0; i < numSamples; ++i)
+            src[i] = (int16) (i * 17);
+    }
+
+    void runIteration()
+    {
+        FloatVectorOperations::convertFixedToFloat (dest, src, 1.0f / 32768.0f, numSamples);
+        preventOptimisation (dest);
+    }
+
+    void shutdown()
+    {
+        dest.free();
+        src.free();
+    }
+
+private:
+    enum { numSamples = 4096 };
+    HeapBlock<float> dest;
+    HeapBlock<int16> src;
+};
+
+static FixedToFloatBenchmark fixedToFloatBenchmark;
+
+#endif
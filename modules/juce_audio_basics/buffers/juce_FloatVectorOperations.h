@@ -29,7 +29,7 @@
 
 //==============================================================================
 /**
-    A collection of simple vector operations on arrays of floats, accelerated with
+    A collection of simple vector operations on arrays of floats and doubles, accelerated with
     SIMD instructions where possible.
 */
 class JUCE_API  FloatVectorOperations
@@ -39,41 +39,175 @@ public:
     /** Clears a vector of floats. */
     static void JUCE_CALLTYPE clear (float* dest, int numValues) noexcept;
 
+    /** Clears a vector of doubles. */
+    static void JUCE_CALLTYPE clear (double* dest, int numValues) noexcept;
+
     /** Copies a repeated value into a vector of floats. */
     static void JUCE_CALLTYPE fill (float* dest, float valueToFill, int numValues) noexcept;
 
+    /** Copies a repeated value into a vector of doubles. */
+    static void JUCE_CALLTYPE fill (double* dest, double valueToFill, int numValues) noexcept;
+
     /** Copies a vector of floats. */
     static void JUCE_CALLTYPE copy (float* dest, const float* src, int numValues) noexcept;
 
+    /** Copies a vector of doubles. */
+    static void JUCE_CALLTYPE copy (double* dest, const double* src, int numValues) noexcept;
+
+    /** Copies a vector of floats into a vector of doubles. */
+    static void JUCE_CALLTYPE copy (double* dest, const float* src, int numValues) noexcept;
+
+    /** Copies a vector of doubles into a vector of floats, rounding each value to the nearest float. */
+    static void JUCE_CALLTYPE copy (float* dest, const double* src, int numValues) noexcept;
+
     /** Copies a vector of floats, multiplying each value by a given multiplier */
     static void JUCE_CALLTYPE copyWithMultiply (float* dest, const float* src, float multiplier, int numValues) noexcept;
 
+    /** Copies a vector of doubles, multiplying each value by a given multiplier */
+    static void JUCE_CALLTYPE copyWithMultiply (double* dest, const double* src, double multiplier, int numValues) noexcept;
+
     /** Adds the source values to the destination values. */
     static void JUCE_CALLTYPE add (float* dest, const float* src, int numValues) noexcept;
 
+    /** Adds the source values to the destination values. */
+    static void JUCE_CALLTYPE add (double* dest, const double* src, int numValues) noexcept;
+
     /** Adds a fixed value to the destination values. */
     static void JUCE_CALLTYPE add (float* dest, float amount, int numValues) noexcept;
 
+    /** Adds a fixed value to the destination values. */
+    static void JUCE_CALLTYPE add (double* dest, double amount, int numValues) noexcept;
+
     /** Multiplies each source value by the given multiplier, then adds it to the destination value. */
     static void JUCE_CALLTYPE addWithMultiply (float* dest, const float* src, float multiplier, int numValues) noexcept;
 
+    /** Multiplies each source value by the given multiplier, then adds it to the destination value. */
+    static void JUCE_CALLTYPE addWithMultiply (double* dest, const double* src, double multiplier, int numValues) noexcept;
+
+    /** Multiplies each value in src1 by the corresponding value in src2, then adds it to the destination value. */
+    static void JUCE_CALLTYPE addWithMultiply (float* dest, const float* src1, const float* src2, int numValues) noexcept;
+
+    /** Multiplies each value in src1 by the corresponding value in src2, then adds it to the destination value. */
+    static void JUCE_CALLTYPE addWithMultiply (double* dest, const double* src1, const double* src2, int numValues) noexcept;
+
     /** Multiplies the destination values by the source values. */
     static void JUCE_CALLTYPE multiply (float* dest, const float* src, int numValues) noexcept;
 
+    /** Multiplies the destination values by the source values. */
+    static void JUCE_CALLTYPE multiply (double* dest, const double* src, int numValues) noexcept;
+
     /** Multiplies each of the destination values by a fixed multiplier. */
     static void JUCE_CALLTYPE multiply (float* dest, float multiplier, int numValues) noexcept;
 
+    /** Multiplies each of the destination values by a fixed multiplier. */
+    static void JUCE_CALLTYPE multiply (double* dest, double multiplier, int numValues) noexcept;
+
+    /** Copies a vector of floats, negating each value. */
+    static void JUCE_CALLTYPE negate (float* dest, const float* src, int numValues) noexcept;
+
+    /** Copies a vector of doubles, negating each value. */
+    static void JUCE_CALLTYPE negate (double* dest, const double* src, int numValues) noexcept;
+
+    /** Copies a vector of floats, replacing each value with its absolute value. */
+    static void JUCE_CALLTYPE abs (float* dest, const float* src, int numValues) noexcept;
+
+    /** Copies a vector of doubles, replacing each value with its absolute value. */
+    static void JUCE_CALLTYPE abs (double* dest, const double* src, int numValues) noexcept;
+
+    /** Copies a vector of floats, limiting each value to lie within the range low to high. */
+    static void JUCE_CALLTYPE clip (float* dest, const float* src, float low, float high, int numValues) noexcept;
+
+    /** Copies a vector of doubles, limiting each value to lie within the range low to high. */
+    static void JUCE_CALLTYPE clip (double* dest, const double* src, double low, double high, int numValues) noexcept;
+
+    /** Copies a vector of floats, replacing each value with the lesser of it and a fixed value. */
+    static void JUCE_CALLTYPE min (float* dest, const float* src, float comp, int numValues) noexcept;
+
+    /** Copies a vector of doubles, replacing each value with the lesser of it and a fixed value. */
+    static void JUCE_CALLTYPE min (double* dest, const double* src, double comp, int numValues) noexcept;
+
+    /** Copies a vector of floats, replacing each value with the greater of it and a fixed value. */
+    static void JUCE_CALLTYPE max (float* dest, const float* src, float comp, int numValues) noexcept;
+
+    /** Copies a vector of doubles, replacing each value with the greater of it and a fixed value. */
+    static void JUCE_CALLTYPE max (double* dest, const double* src, double comp, int numValues) noexcept;
+
+    //==============================================================================
+    /** Copies a vector of floats, multiplying them by a gain that moves in a straight line
+        from startMultiplier towards endMultiplier.
+
+        The gain changes by (endMultiplier - startMultiplier) / numValues for each value, so
+        the first one is multiplied by startMultiplier, and endMultiplier would be the gain for
+        the value that follows the last one, as it is in AudioSampleBuffer::applyGainRamp().
+    */
+    static void JUCE_CALLTYPE copyWithRamp (float* dest, const float* src, float startMultiplier, float endMultiplier, int numValues) noexcept;
+
+    /** Copies a vector of doubles, multiplying them by a linear ramp.
+        @see copyWithRamp
+    */
+    static void JUCE_CALLTYPE copyWithRamp (double* dest, const double* src, double startMultiplier, double endMultiplier, int numValues) noexcept;
+
+    /** Multiplies the source values by a linear ramp, then adds them to the destination values.
+        @see copyWithRamp
+    */
+    static void JUCE_CALLTYPE addWithRamp (float* dest, const float* src, float startMultiplier, float endMultiplier, int numValues) noexcept;
+
+    /** Multiplies the source values by a linear ramp, then adds them to the destination values.
+        @see copyWithRamp
+    */
+    static void JUCE_CALLTYPE addWithRamp (double* dest, const double* src, double startMultiplier, double endMultiplier, int numValues) noexcept;
+
+    /** Multiplies the destination values by a linear ramp.
+        @see copyWithRamp
+    */
+    static void JUCE_CALLTYPE multiplyWithRamp (float* dest, float startMultiplier, float endMultiplier, int numValues) noexcept;
+
+    /** Multiplies the destination values by a linear ramp.
+        @see copyWithRamp
+    */
+    static void JUCE_CALLTYPE multiplyWithRamp (double* dest, double startMultiplier, double endMultiplier, int numValues) noexcept;
+
+    //==============================================================================
     /** Converts a stream of integers to floats, multiplying each one by the given multiplier. */
     static void JUCE_CALLTYPE convertFixedToFloat (float* dest, const int* src, float multiplier, int numValues) noexcept;
 
+    /** Converts a stream of 16-bit integers to floats, multiplying each one by the given multiplier. */
+    static void JUCE_CALLTYPE convertFixedToFloat (float* dest, const int16* src, float multiplier, int numValues) noexcept;
+
+    /** Interleaves a set of separate channels into a single block of samples.
+        The dest buffer must have space for numChannels * numValues samples.
+    */
+    static void JUCE_CALLTYPE interleave (float* dest, const float* const* src, int numChannels, int numValues) noexcept;
+
+    /** Interleaves a set of separate channels into a single block of samples.
+        The dest buffer must have space for numChannels * numValues samples.
+    */
+    static void JUCE_CALLTYPE interleave (double* dest, const double* const* src, int numChannels, int numValues) noexcept;
+
+    /** Splits a block of interleaved samples into a set of separate channels. */
+    static void JUCE_CALLTYPE deinterleave (float* const* dest, const float* src, int numChannels, int numValues) noexcept;
+
+    /** Splits a block of interleaved samples into a set of separate channels. */
+    static void JUCE_CALLTYPE deinterleave (double* const* dest, const double* src, int numChannels, int numValues) noexcept;
+
+    //==============================================================================
     /** Finds the miniumum and maximum values in the given array. */
     static void JUCE_CALLTYPE findMinAndMax (const float* src, int numValues, float& minResult, float& maxResult) noexcept;
 
+    /** Finds the miniumum and maximum values in the given array. */
+    static void JUCE_CALLTYPE findMinAndMax (const double* src, int numValues, double& minResult, double& maxResult) noexcept;
+
     /** Finds the miniumum value in the given array. */
     static float JUCE_CALLTYPE findMinimum (const float* src, int numValues) noexcept;
 
+    /** Finds the miniumum value in the given array. */
+    static double JUCE_CALLTYPE findMinimum (const double* src, int numValues) noexcept;
+
     /** Finds the maximum value in the given array. */
     static float JUCE_CALLTYPE findMaximum (const float* src, int numValues) noexcept;
+
+    /** Finds the maximum value in the given array. */
+    static double JUCE_CALLTYPE findMaximum (const double* src, int numValues) noexcept;
 };
 
 
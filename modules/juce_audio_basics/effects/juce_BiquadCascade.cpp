@@ -0,0 +1,514 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#if JUCE_INTEL
+ #define JUCE_SNAP_TO_ZERO(n)    if (! (n < -1.0e-8 || n > 1.0e-8)) n = 0;
+#else
+ #define JUCE_SNAP_TO_ZERO(n)
+#endif
+
+namespace BiquadCascadeHelpers
+{
+    // The samples are processed in chunks of this size, which is also the size of the
+    // interleaved scratch buffer that the SIMD code works on.
+    enum { chunkSize = 32 };
+
+    template <class CoefficientsType>
+    static bool isPassThrough (const CoefficientsType& c) noexcept
+    {
+        return c.b0 == 1.0f && c.b1 == 0 && c.b2 == 0 && c.a1 == 0 && c.a2 == 0;
+    }
+}
+
+//==============================================================================
+BiquadCascade::BiquadCascade (const int numChannels_, const int numStages_)
+    : numChannels (0), numStages (0), smoothingLength (0), smoothingRemaining (0)
+{
+    setSize (numChannels_, numStages_);
+}
+
+BiquadCascade::~BiquadCascade()
+{
+}
+
+//==============================================================================
+void BiquadCascade::setSize (const int newNumChannels, const int newNumStages)
+{
+    jassert (newNumChannels >= 0 && newNumStages >= 0);
+
+    const int numGroups = (newNumChannels + 3) / 4;
+
+    HeapBlock<Coefficients> newCurrent ((size_t) newNumStages), newTarget ((size_t) newNumStages),
+                            newIncrement ((size_t) newNumStages, true);
+    HeapBlock<float> newState ((size_t) (numGroups * newNumStages * 8), true);
+    HeapBlock<float*> newChannelPointers ((size_t) newNumChannels, true);
+
+    const SpinLock::ScopedLockType sl (processLock);
+
+    for (int i = 0; i < newNumStages; ++i)
+    {
+        if (i < numStages)
+        {
+            newCurrent[i] = target[i];
+            newTarget[i] = target[i];
+        }
+        else
+        {
+            const Coefficients passThrough = { 1.0f, 0, 0, 0, 0 };
+            newCurrent[i] = passThrough;
+            newTarget[i] = passThrough;
+        }
+    }
+
+    current.swapWith (newCurrent);
+    target.swapWith (newTarget);
+    increment.swapWith (newIncrement);
+    state.swapWith (newState);
+    channelPointers.swapWith (newChannelPointers);
+
+    numChannels = newNumChannels;
+    numStages = newNumStages;
+    smoothingRemaining = 0;
+}
+
+//==============================================================================
+void BiquadCascade::setStage (const int stageIndex, const IIRFilter& filterToCopy) noexcept
+{
+    Coefficients c = { 1.0f, 0, 0, 0, 0 };
+
+    {
+        const SpinLock::ScopedLockType sl (filterToCopy.processLock);
+
+        if (filterToCopy.active)
+        {
+            c.b0 = filterToCopy.coefficients[0];
+            c.b1 = filterToCopy.coefficients[1];
+            c.b2 = filterToCopy.coefficients[2];
+            c.a1 = filterToCopy.coefficients[3];
+            c.a2 = filterToCopy.coefficients[4];
+        }
+    }
+
+    setTarget (stageIndex, c);
+}
+
+void BiquadCascade::setStageCoefficients (const int stageIndex,
+                                          const double b0, const double b1, const double b2,
+                                          const double a0, const double a1, const double a2) noexcept
+{
+    jassert (a0 != 0);
+
+    const double a = 1.0 / a0;
+    const Coefficients c = { (float) (b0 * a), (float) (b1 * a), (float) (b2 * a),
+                             (float) (a1 * a), (float) (a2 * a) };
+
+    setTarget (stageIndex, c);
+}
+
+void BiquadCascade::makeStageInactive (const int stageIndex) noexcept
+{
+    const Coefficients passThrough = { 1.0f, 0, 0, 0, 0 };
+    setTarget (stageIndex, passThrough);
+}
+
+void BiquadCascade::setTarget (const int stageIndex, const Coefficients& c) noexcept
+{
+    const SpinLock::ScopedLockType sl (processLock);
+
+    if (isPositiveAndBelow (stageIndex, numStages))
+    {
+        target [stageIndex] = c;
+
+        if (smoothingLength > 0)
+            smoothingRemaining = smoothingLength;
+        else
+            current [stageIndex] = c;
+    }
+    else
+    {
+        jassertfalse;
+    }
+}
+
+void BiquadCascade::setSmoothingLength (const int numSamples) noexcept
+{
+    const SpinLock::ScopedLockType sl (processLock);
+    smoothingLength = jmax (0, numSamples);
+
+    if (smoothingLength == 0 && smoothingRemaining > 0)
+        advanceSmoothing (smoothingRemaining);
+}
+
+void BiquadCascade::reset() noexcept
+{
+    const SpinLock::ScopedLockType sl (processLock);
+
+    state.clear ((size_t) (((numChannels + 3) / 4) * numStages * 8));
+
+    if (smoothingRemaining > 0)
+        advanceSmoothing (smoothingRemaining);
+}
+
+void BiquadCascade::calculateIncrements() noexcept
+{
+    const float scale = 1.0f / smoothingRemaining;
+
+    for (int i = 0; i < numStages; ++i)
+    {
+        const Coefficients& c = current[i];
+        const Coefficients& t = target[i];
+        Coefficients& inc = increment[i];
+
+        inc.b0 = (t.b0 - c.b0) * scale;
+        inc.b1 = (t.b1 - c.b1) * scale;
+        inc.b2 = (t.b2 - c.b2) * scale;
+        inc.a1 = (t.a1 - c.a1) * scale;
+        inc.a2 = (t.a2 - c.a2) * scale;
+    }
+}
+
+void BiquadCascade::advanceSmoothing (const int numSamples) noexcept
+{
+    const int step = jmin (numSamples, smoothingRemaining);
+    const float proportion = step / (float) smoothingRemaining;
+    smoothingRemaining -= step;
+
+    for (int i = 0; i < numStages; ++i)
+    {
+        Coefficients& c = current[i];
+        const Coefficients& t = target[i];
+
+        if (smoothingRemaining == 0)
+        {
+            c = t;
+        }
+        else
+        {
+            // (interpolating between two stable biquads always gives a stable one, as
+            // the set of stable a1/a2 values is convex)
+            c.b0 += proportion * (t.b0 - c.b0);
+            c.b1 += proportion * (t.b1 - c.b1);
+            c.b2 += proportion * (t.b2 - c.b2);
+            c.a1 += proportion * (t.a1 - c.a1);
+            c.a2 += proportion * (t.a2 - c.a2);
+        }
+    }
+}
+
+//==============================================================================
+void BiquadCascade::processSamples (AudioSampleBuffer& buffer, const int startSample, const int numSamples) noexcept
+{
+    const int numToProcess = jmin (numChannels, buffer.getNumChannels());
+
+    for (int i = 0; i < numToProcess; ++i)
+        channelPointers[i] = buffer.getSampleData (i, startSample);
+
+    processSamples (channelPointers, numToProcess, numSamples);
+}
+
+void BiquadCascade::processSamples (float* const* const channels, int numChannelsToProcess, const int numSamples) noexcept
+{
+    const SpinLock::ScopedLockType sl (processLock);
+
+    jassert (numChannelsToProcess <= numChannels);
+    numChannelsToProcess = jmin (numChannelsToProcess, numChannels);
+
+    for (int start = 0; start < numSamples;)
+    {
+        const bool ramping = smoothingRemaining > 0;
+        int num = jmin ((int) BiquadCascadeHelpers::chunkSize, numSamples - start);
+
+        if (ramping)
+        {
+            num = jmin (num, smoothingRemaining);
+            calculateIncrements();
+        }
+
+        int channel = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        for (; channel + 4 <= numChannelsToProcess; channel += 4)
+        {
+            float* const group[4] = { channels [channel] + start,
+                                      channels [channel + 1] + start,
+                                      channels [channel + 2] + start,
+                                      channels [channel + 3] + start };
+
+            processGroup (group, num, channel / 4, ramping);
+        }
+       #endif
+
+        for (; channel < numChannelsToProcess; ++channel)
+            processLane (channels [channel] + start, num, channel / 4, channel & 3, ramping);
+
+        if (ramping)
+            advanceSmoothing (num);
+
+        start += num;
+    }
+
+    float* const s = state;
+
+    for (int i = ((numChannelsToProcess + 3) / 4) * numStages * 8; --i >= 0;)
+    {
+        JUCE_SNAP_TO_ZERO (s[i]);
+    }
+}
+
+void BiquadCascade::processLane (float* const data, const int num, const int group,
+                                 const int lane, const bool ramping) noexcept
+{
+    float* st = state + group * numStages * 8;
+
+    for (int stage = 0; stage < numStages; ++stage, st += 8)
+    {
+        Coefficients c = current [stage];
+        const Coefficients& inc = increment [stage];
+
+        if ((! ramping) && BiquadCascadeHelpers::isPassThrough (c))
+            continue;
+
+        float v1 = st [lane], v2 = st [lane + 4];
+
+        for (int i = 0; i < num; ++i)
+        {
+            if (ramping)
+            {
+                c.b0 += inc.b0; c.b1 += inc.b1; c.b2 += inc.b2;
+                c.a1 += inc.a1; c.a2 += inc.a2;
+            }
+
+            const float in = data[i];
+            const float out = c.b0 * in + v1;
+            data[i] = out;
+
+            v1 = c.b1 * in - c.a1 * out + v2;
+            v2 = c.b2 * in - c.a2 * out;
+        }
+
+        st [lane] = v1;
+        st [lane + 4] = v2;
+    }
+}
+
+#if JUCE_USE_SSE_INTRINSICS
+void BiquadCascade::processGroup (float* const* const channels, const int num,
+                                  const int group, const bool ramping) noexcept
+{
+    // The four channels are transposed into a buffer of vectors holding one sample from each,
+    // so that every stage can run across the whole chunk with its state kept in registers.
+    __m128 data [BiquadCascadeHelpers::chunkSize];
+    float* const c0 = channels[0];
+    float* const c1 = channels[1];
+    float* const c2 = channels[2];
+    float* const c3 = channels[3];
+
+    int i = 0;
+
+    for (; i + 4 <= num; i += 4)
+    {
+        __m128 r0 = _mm_loadu_ps (c0 + i), r1 = _mm_loadu_ps (c1 + i),
+               r2 = _mm_loadu_ps (c2 + i), r3 = _mm_loadu_ps (c3 + i);
+
+        _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+        data[i] = r0; data[i + 1] = r1; data[i + 2] = r2; data[i + 3] = r3;
+    }
+
+    for (; i < num; ++i)
+        data[i] = _mm_setr_ps (c0[i], c1[i], c2[i], c3[i]);
+
+    float* st = state + group * numStages * 8;
+
+    for (int stage = 0; stage < numStages; ++stage, st += 8)
+    {
+        const Coefficients& c = current [stage];
+        const Coefficients& inc = increment [stage];
+
+        if ((! ramping) && BiquadCascadeHelpers::isPassThrough (c))
+            continue;
+
+        __m128 b0 = _mm_set1_ps (c.b0), b1 = _mm_set1_ps (c.b1), b2 = _mm_set1_ps (c.b2);
+        __m128 a1 = _mm_set1_ps (c.a1), a2 = _mm_set1_ps (c.a2);
+        __m128 v1 = _mm_loadu_ps (st), v2 = _mm_loadu_ps (st + 4);
+
+        if (ramping)
+        {
+            const __m128 db0 = _mm_set1_ps (inc.b0), db1 = _mm_set1_ps (inc.b1), db2 = _mm_set1_ps (inc.b2);
+            const __m128 da1 = _mm_set1_ps (inc.a1), da2 = _mm_set1_ps (inc.a2);
+
+            for (int j = 0; j < num; ++j)
+            {
+                b0 = _mm_add_ps (b0, db0); b1 = _mm_add_ps (b1, db1); b2 = _mm_add_ps (b2, db2);
+                a1 = _mm_add_ps (a1, da1); a2 = _mm_add_ps (a2, da2);
+
+                const __m128 in = data[j];
+                const __m128 out = _mm_add_ps (_mm_mul_ps (b0, in), v1);
+                data[j] = out;
+
+                v1 = _mm_add_ps (_mm_sub_ps (_mm_mul_ps (b1, in), _mm_mul_ps (a1, out)), v2);
+                v2 = _mm_sub_ps (_mm_mul_ps (b2, in), _mm_mul_ps (a2, out));
+            }
+        }
+        else for (int j = 0; j < num; ++j)
+        {
+            const __m128 in = data[j];
+            const __m128 out = _mm_add_ps (_mm_mul_ps (b0, in), v1);
+            data[j] = out;
+
+            v1 = _mm_add_ps (_mm_sub_ps (_mm_mul_ps (b1, in), _mm_mul_ps (a1, out)), v2);
+            v2 = _mm_sub_ps (_mm_mul_ps (b2, in), _mm_mul_ps (a2, out));
+        }
+
+        _mm_storeu_ps (st, v1);
+        _mm_storeu_ps (st + 4, v2);
+    }
+
+    for (i = 0; i + 4 <= num; i += 4)
+    {
+        __m128 r0 = data[i], r1 = data[i + 1], r2 = data[i + 2], r3 = data[i + 3];
+        _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+
+        _mm_storeu_ps (c0 + i, r0);
+        _mm_storeu_ps (c1 + i, r1);
+        _mm_storeu_ps (c2 + i, r2);
+        _mm_storeu_ps (c3 + i, r3);
+    }
+
+    for (; i < num; ++i)
+    {
+        float values[4];
+        _mm_storeu_ps (values, data[i]);
+        c0[i] = values[0]; c1[i] = values[1]; c2[i] = values[2]; c3[i] = values[3];
+    }
+}
+#endif
+
+#undef JUCE_SNAP_TO_ZERO
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class BiquadCascadeTests  : public UnitTest
+{
+public:
+    BiquadCascadeTests() : UnitTest ("BiquadCascade") {}
+
+    void runTest()
+    {
+        beginTest ("Matches IIRFilter");
+
+        Random r;
+        const int numChannels = 7, numSamples = 1000;
+
+        IIRFilter designs[3];
+        designs[0].makeLowPass (44100.0, 5000.0);
+        designs[1].makeBandPass (44100.0, 800.0, 2.0, 3.0f);
+        designs[2].makeHighShelf (44100.0, 8000.0, 0.7, 0.5f);
+
+        BiquadCascade cascade (numChannels, 4);
+        for (int i = 0; i < 3; ++i)
+            cascade.setStage (i, designs[i]);
+
+        OwnedArray<IIRFilter> filters;
+        AudioSampleBuffer buffer (numChannels, numSamples), expected (numChannels, numSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < 3; ++i)
+                filters.add (new IIRFilter (designs[i]));
+
+            for (int i = 0; i < numSamples; ++i)
+                *buffer.getSampleData (ch, i) = r.nextFloat() * 2.0f - 1.0f;
+        }
+
+        expected = buffer;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < 3; ++i)
+                filters [ch * 3 + i]->processSamples (expected.getSampleData (ch), numSamples);
+
+        for (int start = 0, blockSize = 1; start < numSamples; blockSize = (blockSize * 5 + 3) % 97)
+        {
+            const int num = jmin (blockSize, numSamples - start);
+            cascade.processSamples (buffer, start, num);
+            start += num;
+        }
+
+        float maxError = 0;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                maxError = jmax (maxError, std::abs (*buffer.getSampleData (ch, i) - *expected.getSampleData (ch, i)));
+
+        expect (maxError < 1.0e-5f);
+
+        beginTest ("Coefficient smoothing");
+
+        IIRFilter cut, boost;
+        cut.makeLowShelf (44100.0, 500.0, 0.7, 0.5f);
+        boost.makeLowShelf (44100.0, 500.0, 0.7, 2.0f);
+
+        float maxJumpWithSmoothing = 0, maxJumpWithout = 0, finalValue = 0;
+
+        for (int smoothing = 0; smoothing < 2; ++smoothing)
+        {
+            BiquadCascade c (1, 1);
+            c.setStage (0, cut);
+            c.setSmoothingLength (smoothing != 0 ? 4096 : 0);
+
+            HeapBlock<float> dc (8192);
+            for (int i = 0; i < 8192; ++i)
+                dc[i] = 1.0f;
+
+            float* channels[] = { dc.getData() };
+            c.processSamples (channels, 1, 4096);
+            for (int i = 0; i < 8192; ++i)
+                dc[i] = 1.0f;
+
+            c.setStage (0, boost);
+            c.processSamples (channels, 1, 8192);
+
+            float maxJump = 0;
+            for (int i = 1; i < 8192; ++i)
+                maxJump = jmax (maxJump, std::abs (dc[i] - dc[i - 1]));
+
+            (smoothing != 0 ? maxJumpWithSmoothing : maxJumpWithout) = maxJump;
+            finalValue = dc[8191];
+        }
+
+        HeapBlock<float> settled (8192);
+        for (int i = 0; i < 8192; ++i)
+            settled[i] = 1.0f;
+
+        boost.processSamples (settled, 8192);
+
+        expect (maxJumpWithSmoothing < maxJumpWithout * 0.1f);
+        expect (std::abs (finalValue - settled[8191]) < 0.001f);
+    }
+};
+
+static BiquadCascadeTests biquadCascadeTests;
+
+#endif
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_BIQUADCASCADE_JUCEHEADER__
+#define __JUCE_BIQUADCASCADE_JUCEHEADER__
+
+#include "juce_IIRFilter.h"
+
+
+//==============================================================================
+/**
+    A chain of biquad filter stages that's applied to a set of channels at once.
+
+    Each stage works like an IIRFilter, and all the channels share the same
+    coefficients. The channels are processed four at a time in parallel SIMD lanes,
+    so a bus with many channels costs much less than a separate IIRFilter for each
+    of them, and stages can be cascaded to build higher-order filters.
+
+    When a stage's coefficients are changed, the filter can glide from the old values
+    to the new ones over a given number of samples (see setSmoothingLength()), to
+    avoid the zipper noise you'd otherwise hear when a parameter is moved.
+
+    @see IIRFilter, IIRFilterAudioSource
+*/
+class JUCE_API  BiquadCascade
+{
+public:
+    //==============================================================================
+    /** Creates a cascade with the given number of channels and stages.
+        Initially all the stages are inactive, so the filter has no effect.
+    */
+    BiquadCascade (int numChannels = 2, int numStages = 1);
+
+    /** Destructor. */
+    ~BiquadCascade();
+
+    //==============================================================================
+    /** Changes the number of channels and stages.
+
+        Any existing stages keep their coefficients, and new ones are inactive. This
+        resets the processing state, and will allocate memory, so shouldn't be done on
+        the audio thread.
+    */
+    void setSize (int numChannels, int numStages);
+
+    /** Returns the number of channels that this filter can process. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the number of stages in the cascade. */
+    int getNumStages() const noexcept                   { return numStages; }
+
+    //==============================================================================
+    /** Makes one of the stages use the same coefficients as an IIRFilter.
+        If the filter is inactive, the stage will become inactive too.
+    */
+    void setStage (int stageIndex, const IIRFilter& filterToCopy) noexcept;
+
+    /** Sets one of the stages' coefficients directly.
+        These are the usual b0, b1, b2, a0, a1, a2 terms, and will be normalised by a0.
+    */
+    void setStageCoefficients (int stageIndex,
+                               double b0, double b1, double b2,
+                               double a0, double a1, double a2) noexcept;
+
+    /** Makes one of the stages pass its input straight through. */
+    void makeStageInactive (int stageIndex) noexcept;
+
+    /** Sets the number of samples over which coefficient changes are smoothed.
+        A length of 0 (the default) makes changes take effect immediately.
+    */
+    void setSmoothingLength (int numSamples) noexcept;
+
+    /** Returns the current smoothing length. @see setSmoothingLength */
+    int getSmoothingLength() const noexcept             { return smoothingLength; }
+
+    //==============================================================================
+    /** Clears the filter's state, ready to start a new stream of data.
+        This also skips the end of any coefficient change that's still being smoothed.
+    */
+    void reset() noexcept;
+
+    /** Filters a set of channels in-place.
+
+        The number of channels must not be more than getNumChannels(); if there are
+        fewer, the remaining channels' states are left untouched.
+    */
+    void processSamples (float* const* channels, int numChannelsToProcess, int numSamples) noexcept;
+
+    /** Filters a section of an AudioSampleBuffer in-place.
+        Any channels beyond getNumChannels() are left untouched.
+    */
+    void processSamples (AudioSampleBuffer& buffer, int startSample, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    struct Coefficients
+    {
+        float b0, b1, b2, a1, a2;
+    };
+
+    SpinLock processLock;
+    int numChannels, numStages, smoothingLength, smoothingRemaining;
+    HeapBlock<Coefficients> current, target, increment;
+    HeapBlock<float> state;
+    HeapBlock<float*> channelPointers;
+
+    void setTarget (int stageIndex, const Coefficients&) noexcept;
+    void calculateIncrements() noexcept;
+    void advanceSmoothing (int numSamples) noexcept;
+    void processLane (float* data, int numSamples, int group, int lane, bool ramping) noexcept;
+    void processGroup (float* const* channels, int numSamples, int group, bool ramping) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BiquadCascade)
+};
+
+
+#endif   // __JUCE_BIQUADCASCADE_JUCEHEADER__
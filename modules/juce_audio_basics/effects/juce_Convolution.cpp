@@ -0,0 +1,360 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace ConvolutionHelpers
+{
+    // The size of the chunks that the input is copied in, which lets the output overwrite it.
+    enum { chunkSize = 256 };
+
+    static float dotProduct (const float* a, const float* b, int num) noexcept
+    {
+        float total = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        __m128 acc = _mm_setzero_ps();
+
+        for (; num >= 4; num -= 4)
+        {
+            acc = _mm_add_ps (acc, _mm_mul_ps (_mm_loadu_ps (a), _mm_loadu_ps (b)));
+            a += 4;
+            b += 4;
+        }
+
+        acc = _mm_add_ps (acc, _mm_movehl_ps (acc, acc));
+        acc = _mm_add_ss (acc, _mm_shuffle_ps (acc, acc, 1));
+        total = _mm_cvtss_f32 (acc);
+       #endif
+
+        while (--num >= 0)
+            total += *a++ * *b++;
+
+        return total;
+    }
+}
+
+//==============================================================================
+/*  A set of equal-sized partitions of an impulse response, applied with overlap-save
+    FFTs and a frequency-domain delay line. The output comes out one block late.
+*/
+class Convolution::Partitions
+{
+public:
+    Partitions (const float* const impulseResponse, const int length, const int blockSize_)
+        : blockSize (blockSize_),
+          spectrumSize (blockSize_ * 2 + 2),
+          numPartitions ((length + blockSize_ - 1) / blockSize_),
+          fft (getOrder (blockSize_) + 1),
+          spectra ((size_t) (numPartitions * spectrumSize)),
+          delayLine ((size_t) (numPartitions * spectrumSize), true),
+          inputFrame ((size_t) (blockSize_ * 2), true),
+          outputBlock ((size_t) blockSize_, true),
+          accumulator ((size_t) spectrumSize),
+          scratch ((size_t) spectrumSize),
+          position (0), delayLinePosition (0)
+    {
+        for (int i = 0; i < numPartitions; ++i)
+        {
+            const int num = jmin (blockSize, length - i * blockSize);
+
+            zeromem (scratch, sizeof (float) * (size_t) spectrumSize);
+            memcpy (scratch, impulseResponse + i * blockSize, sizeof (float) * (size_t) num);
+            fft.performRealForward (scratch, spectra + i * spectrumSize);
+        }
+    }
+
+    void reset() noexcept
+    {
+        delayLine.clear ((size_t) (numPartitions * spectrumSize));
+        inputFrame.clear ((size_t) (blockSize * 2));
+        outputBlock.clear ((size_t) blockSize);
+        position = 0;
+        delayLinePosition = 0;
+    }
+
+    void process (const float* input, float* output, int numSamples) noexcept
+    {
+        while (numSamples > 0)
+        {
+            const int num = jmin (numSamples, blockSize - position);
+
+            memcpy (inputFrame + blockSize + position, input, sizeof (float) * (size_t) num);
+            FloatVectorOperations::add (output, outputBlock + position, num);
+
+            position += num;
+            input += num;
+            output += num;
+            numSamples -= num;
+
+            if (position == blockSize)
+            {
+                position = 0;
+                processBlock();
+            }
+        }
+    }
+
+private:
+    const int blockSize, spectrumSize, numPartitions;
+    FFT fft;
+    HeapBlock<float> spectra, delayLine, inputFrame, outputBlock, accumulator, scratch;
+    int position, delayLinePosition;
+
+    static int getOrder (const int size) noexcept
+    {
+        int order = 0;
+        while ((1 << order) < size)
+            ++order;
+
+        return order;
+    }
+
+    void processBlock() noexcept
+    {
+        fft.performRealForward (inputFrame, delayLine + delayLinePosition * spectrumSize);
+
+        zeromem (accumulator, sizeof (float) * (size_t) spectrumSize);
+
+        for (int i = 0; i < numPartitions; ++i)
+        {
+            int index = delayLinePosition - i;
+            if (index < 0)
+                index += numPartitions;
+
+            FFT::multiplyAccumulate (accumulator, delayLine + index * spectrumSize,
+                                     spectra + i * spectrumSize, blockSize + 1);
+        }
+
+        fft.performRealInverse (accumulator, scratch);
+
+        // (the first half of the result is the circular wrap-around, and is discarded)
+        memcpy (outputBlock, scratch + blockSize, sizeof (float) * (size_t) blockSize);
+        memcpy (inputFrame, inputFrame + blockSize, sizeof (float) * (size_t) blockSize);
+
+        if (++delayLinePosition >= numPartitions)
+            delayLinePosition = 0;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Partitions)
+};
+
+//==============================================================================
+class Convolution::Engine
+{
+public:
+    Engine (const float* const impulseResponse, const int length,
+            const int blockSize, const int maxPartitionSize)
+        : impulseResponseLength (length),
+          headLength (jmin (blockSize, length)),
+          headReversed ((size_t) headLength),
+          history ((size_t) (headLength * 2), true),
+          inputCopy ((size_t) ConvolutionHelpers::chunkSize),
+          historyPosition (0)
+    {
+        for (int i = 0; i < headLength; ++i)
+            headReversed [headLength - 1 - i] = impulseResponse[i];
+
+        // Each partition starts at an offset equal to its own size, so that its latency
+        // is exactly covered by everything in front of it.
+        for (int offset = blockSize, size = blockSize; offset < length;)
+        {
+            const int num = size < maxPartitionSize ? jmin (size, length - offset)
+                                                    : length - offset;
+
+            partitions.add (new Partitions (impulseResponse + offset, num, size));
+            offset += num;
+
+            if (size < maxPartitionSize)
+                size *= 2;
+        }
+    }
+
+    void reset() noexcept
+    {
+        history.clear ((size_t) (headLength * 2));
+        historyPosition = 0;
+
+        for (int i = partitions.size(); --i >= 0;)
+            partitions.getUnchecked (i)->reset();
+    }
+
+    void process (const float* input, float* output, int numSamples) noexcept
+    {
+        while (numSamples > 0)
+        {
+            const int num = jmin ((int) ConvolutionHelpers::chunkSize, numSamples);
+            memcpy (inputCopy, input, sizeof (float) * (size_t) num);
+
+            for (int i = 0; i < num; ++i)
+            {
+                history [historyPosition] = history [historyPosition + headLength] = inputCopy[i];
+
+                if (++historyPosition >= headLength)
+                    historyPosition = 0;
+
+                output[i] = ConvolutionHelpers::dotProduct (history + historyPosition, headReversed, headLength);
+            }
+
+            for (int i = 0; i < partitions.size(); ++i)
+                partitions.getUnchecked (i)->process (inputCopy, output, num);
+
+            input += num;
+            output += num;
+            numSamples -= num;
+        }
+    }
+
+    const int impulseResponseLength;
+
+private:
+    const int headLength;
+    HeapBlock<float> headReversed, history, inputCopy;
+    int historyPosition;
+    OwnedArray<Partitions> partitions;
+
+    JUCE_DECLARE_NON_COPYABLE (Engine)
+};
+
+//==============================================================================
+Convolution::Convolution()
+{
+}
+
+Convolution::~Convolution()
+{
+}
+
+void Convolution::setImpulseResponse (const float* const impulseResponse, const int numSamples,
+                                      const int blockSize, const int maxPartitionSize)
+{
+    jassert (isPowerOfTwo (blockSize) && isPowerOfTwo (maxPartitionSize));
+    jassert (maxPartitionSize >= blockSize);
+
+    ScopedPointer<Engine> newEngine;
+
+    if (numSamples > 0)
+        newEngine = new Engine (impulseResponse, numSamples, blockSize, jmax (blockSize, maxPartitionSize));
+
+    if (newEngine != nullptr || engine != nullptr)
+    {
+        const SpinLock::ScopedLockType sl (engineLock);
+        engine.swapWith (newEngine);
+    }
+
+    // (the old engine gets deleted here, outside the lock)
+}
+
+int Convolution::getImpulseResponseLength() const noexcept
+{
+    const SpinLock::ScopedLockType sl (engineLock);
+    return engine != nullptr ? engine->impulseResponseLength : 0;
+}
+
+void Convolution::reset() noexcept
+{
+    const SpinLock::ScopedLockType sl (engineLock);
+
+    if (engine != nullptr)
+        engine->reset();
+}
+
+void Convolution::process (const float* const input, float* const output, const int numSamples) noexcept
+{
+    const SpinLock::ScopedLockType sl (engineLock);
+
+    if (engine != nullptr)
+        engine->process (input, output, numSamples);
+    else if (input != output)
+        memcpy (output, input, sizeof (float) * (size_t) numSamples);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ConvolutionTests  : public UnitTest
+{
+public:
+    ConvolutionTests() : UnitTest ("Convolution") {}
+
+    void checkAgainstDirectConvolution (Random& r, const int irLength, const int blockSize, const int maxPartitionSize)
+    {
+        const int numSamples = 12000;
+        HeapBlock<float> ir ((size_t) irLength), input ((size_t) numSamples), output ((size_t) numSamples);
+
+        for (int i = 0; i < irLength; ++i)
+            ir[i] = (r.nextFloat() * 2.0f - 1.0f) * std::exp (-4.0f * i / irLength);
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = input[i] = r.nextFloat() * 2.0f - 1.0f;
+
+        Convolution convolution;
+        convolution.setImpulseResponse (ir, irLength, blockSize, maxPartitionSize);
+        expectEquals (convolution.getImpulseResponseLength(), irLength);
+
+        for (int start = 0, size = 1; start < numSamples; size = (size * 13 + 11) % 1103)
+        {
+            const int num = jmin (size, numSamples - start);
+            convolution.process (output + start, output + start, num);
+            start += num;
+        }
+
+        double maxError = 0;
+
+        for (int i = 0; i < numSamples; i += 7)
+        {
+            double expected = 0;
+
+            for (int j = jmax (0, i - irLength + 1); j <= i; ++j)
+                expected += input[j] * (double) ir[i - j];
+
+            maxError = jmax (maxError, std::abs (expected - output[i]));
+        }
+
+        expect (maxError < 1.0e-3, "max error: " + String (maxError));
+    }
+
+    void runTest()
+    {
+        Random r;
+
+        beginTest ("Non-uniform partitions");
+        checkAgainstDirectConvolution (r, 5000, 16, 256);
+        checkAgainstDirectConvolution (r, 1000, 64, 4096);
+        checkAgainstDirectConvolution (r, 10, 64, 4096);
+
+        beginTest ("Uniform partitions");
+        checkAgainstDirectConvolution (r, 3000, 128, 128);
+
+        beginTest ("Pass-through");
+
+        Convolution convolution;
+        float data[] = { 1.0f, 2.0f, 3.0f }, out[3];
+        convolution.process (data, out, 3);
+        expect (out[0] == 1.0f && out[1] == 2.0f && out[2] == 3.0f);
+    }
+};
+
+static ConvolutionTests convolutionTests;
+
+#endif
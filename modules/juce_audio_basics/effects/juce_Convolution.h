@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_CONVOLUTION_JUCEHEADER__
+#define __JUCE_CONVOLUTION_JUCEHEADER__
+
+#include "juce_FFT.h"
+
+
+//==============================================================================
+/**
+    Convolves a stream of samples with an impulse response, with no added latency.
+
+    The first block of the impulse response is applied directly in the time domain, and
+    the rest is split into partitions that are applied with FFTs. Each partition's size
+    is the same as its position in the impulse response, so its one-block latency is
+    hidden by the partitions in front of it. With the default settings the partitions
+    double in size up to maxPartitionSize, and the rest of the response is covered by
+    partitions of that size. If you make maxPartitionSize the same as the block size,
+    you get a uniformly partitioned convolution.
+
+    Small blocks give a cheap direct part but many FFT partitions; large ones the
+    reverse. Each partition size does its FFT work all at once when its block fills
+    up, so the CPU load is uneven from one call to the next.
+
+    setImpulseResponse() is safe to call from another thread while the audio thread
+    is calling process(). The new response is prepared on the calling thread, and
+    then swapped in.
+
+    The class is mono. For several channels, use several Convolution objects, or a
+    ConvolutionAudioSource.
+
+    @see ConvolutionAudioSource, FFT
+*/
+class JUCE_API  Convolution
+{
+public:
+    //==============================================================================
+    /** Creates a Convolution with no impulse response.
+        Until you give it one, it passes its input through unchanged.
+    */
+    Convolution();
+
+    /** Destructor. */
+    ~Convolution();
+
+    //==============================================================================
+    /** Loads a new impulse response.
+
+        @param impulseResponse      the impulse response samples
+        @param numSamples           the length of the impulse response. If this is 0, the
+                                    object will go back to passing its input through
+        @param blockSize            the length of the directly-applied head of the response,
+                                    and of the smallest FFT partition. Must be a power of 2
+        @param maxPartitionSize     the largest FFT partition size to use. Must be a power of 2,
+                                    and no smaller than blockSize
+    */
+    void setImpulseResponse (const float* impulseResponse, int numSamples,
+                             int blockSize = 64, int maxPartitionSize = 4096);
+
+    /** Returns the length of the current impulse response. */
+    int getImpulseResponseLength() const noexcept;
+
+    /** Clears the object's history, without changing its impulse response. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Convolves a block of samples.
+        The input and output can be the same buffer.
+    */
+    void process (const float* input, float* output, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    class Partitions;
+    class Engine;
+
+    ScopedPointer<Engine> engine;
+    SpinLock engineLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Convolution)
+};
+
+
+#endif   // __JUCE_CONVOLUTION_JUCEHEADER__
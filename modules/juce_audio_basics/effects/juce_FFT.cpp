@@ -0,0 +1,360 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+FFT::FFT (const int order)
+    : size (1 << jmax (1, order)),
+      halfSize (size / 2),
+      twiddles ((size_t) size),
+      bitReversed ((size_t) size)
+{
+    jassert (order >= 1 && order < 31);
+
+    // A single table of the size-N twiddle factors serves both the full-size transforms
+    // and the half-size ones that the real transforms are built on.
+    for (int i = 0; i < halfSize; ++i)
+    {
+        const double angle = -2.0 * double_Pi * i / size;
+        twiddles [i * 2]     = (float) std::cos (angle);
+        twiddles [i * 2 + 1] = (float) std::sin (angle);
+    }
+
+    const int numBits = jmax (1, order);
+
+    for (int i = 0; i < size; ++i)
+    {
+        int reversed = 0;
+
+        for (int bit = 0; bit < numBits; ++bit)
+            if ((i & (1 << bit)) != 0)
+                reversed |= 1 << (numBits - 1 - bit);
+
+        bitReversed[i] = reversed;
+    }
+}
+
+FFT::~FFT() {}
+
+//==============================================================================
+void FFT::perform (float* const data, const int n, const int bitShift, const bool inverse) const noexcept
+{
+    for (int i = 0; i < n; ++i)
+    {
+        const int j = bitReversed[i] >> bitShift;
+
+        if (i < j)
+        {
+            std::swap (data [i * 2],     data [j * 2]);
+            std::swap (data [i * 2 + 1], data [j * 2 + 1]);
+        }
+    }
+
+    if (n < 2)
+        return;
+
+    // the first pass has no twiddles, so is done separately
+    for (int i = 0; i < n * 2; i += 4)
+    {
+        const float r = data [i + 2], im = data [i + 3];
+        data [i + 2] = data [i] - r;
+        data [i + 3] = data [i + 1] - im;
+        data [i] += r;
+        data [i + 1] += im;
+    }
+
+    const float sign = inverse ? -1.0f : 1.0f;
+
+    for (int len = 4; len <= n; len <<= 1)
+    {
+        const int half = len / 2;
+        const int step = (size / len) * 2;
+
+        for (int start = 0; start < n; start += len)
+        {
+            float* a = data + start * 2;
+            float* b = a + half * 2;
+            const float* w = twiddles;
+
+            for (int k = 0; k < half; ++k)
+            {
+                const float wr = w[0], wi = sign * w[1];
+                const float br = b[0] * wr - b[1] * wi;
+                const float bi = b[0] * wi + b[1] * wr;
+
+                b[0] = a[0] - br;
+                b[1] = a[1] - bi;
+                a[0] += br;
+                a[1] += bi;
+
+                a += 2;
+                b += 2;
+                w += step;
+            }
+        }
+    }
+}
+
+void FFT::performComplex (float* const data, const bool inverse) const noexcept
+{
+    perform (data, size, 0, inverse);
+
+    if (inverse)
+    {
+        const float scale = 1.0f / size;
+
+        for (int i = 0; i < size * 2; ++i)
+            data[i] *= scale;
+    }
+}
+
+void FFT::performRealForward (const float* const input, float* const output) const noexcept
+{
+    // The even and odd samples are packed into the real and imaginary parts of a
+    // half-size complex signal, and the two spectra are separated out afterwards.
+    if (input != output)
+        memcpy (output, input, sizeof (float) * (size_t) size);
+
+    perform (output, halfSize, 1, false);
+
+    const float z0r = output[0], z0i = output[1];
+    output[0] = z0r + z0i;
+    output[1] = 0;
+    output [halfSize * 2]     = z0r - z0i;
+    output [halfSize * 2 + 1] = 0;
+
+    for (int k = 1; k <= halfSize / 2; ++k)
+    {
+        float* const zk = output + k * 2;
+        float* const zmk = output + (halfSize - k) * 2;
+
+        const float er = 0.5f * (zk[0] + zmk[0]), ei = 0.5f * (zk[1] - zmk[1]);
+        const float or_ = 0.5f * (zk[1] + zmk[1]), oi = -0.5f * (zk[0] - zmk[0]);
+
+        const float wr = twiddles [k * 2], wi = twiddles [k * 2 + 1];
+        const float tr = wr * or_ - wi * oi;
+        const float ti = wr * oi + wi * or_;
+
+        zk[0]  = er + tr;
+        zk[1]  = ei + ti;
+        zmk[0] = er - tr;
+        zmk[1] = ti - ei;
+    }
+}
+
+void FFT::performRealInverse (const float* const input, float* const output) const noexcept
+{
+    const float x0 = input[0], xm = input [halfSize * 2];
+
+    for (int k = 1; k <= halfSize / 2; ++k)
+    {
+        const float* const xk = input + k * 2;
+        const float* const xmk = input + (halfSize - k) * 2;
+
+        const float er = 0.5f * (xk[0] + xmk[0]), ei = 0.5f * (xk[1] - xmk[1]);
+        const float dr = 0.5f * (xk[0] - xmk[0]), di = 0.5f * (xk[1] + xmk[1]);
+
+        // O = D * conj (W^k)
+        const float wr = twiddles [k * 2], wi = twiddles [k * 2 + 1];
+        const float or_ = dr * wr + di * wi;
+        const float oi = di * wr - dr * wi;
+
+        float* const zk = output + k * 2;
+        float* const zmk = output + (halfSize - k) * 2;
+
+        // Z[k] = E + iO, and Z[M-k] = conj (E - iO)
+        zk[0]  = er - oi;
+        zk[1]  = ei + or_;
+        zmk[0] = er + oi;
+        zmk[1] = or_ - ei;
+    }
+
+    output[0] = 0.5f * (x0 + xm);
+    output[1] = 0.5f * (x0 - xm);
+
+    perform (output, halfSize, 1, true);
+
+    const float scale = 1.0f / halfSize;
+
+    for (int i = 0; i < size; ++i)
+        output[i] *= scale;
+}
+
+//==============================================================================
+void FFT::multiplyAccumulate (float* dest, const float* a, const float* b, int num) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    const __m128 signs = _mm_setr_ps (-1.0f, 1.0f, -1.0f, 1.0f);
+
+    for (; num >= 2; num -= 2)
+    {
+        const __m128 va = _mm_loadu_ps (a);
+        const __m128 vb = _mm_loadu_ps (b);
+
+        const __m128 bReal = _mm_shuffle_ps (vb, vb, _MM_SHUFFLE (2, 2, 0, 0));
+        const __m128 bImag = _mm_shuffle_ps (vb, vb, _MM_SHUFFLE (3, 3, 1, 1));
+        const __m128 aSwapped = _mm_shuffle_ps (va, va, _MM_SHUFFLE (2, 3, 0, 1));
+
+        const __m128 product = _mm_add_ps (_mm_mul_ps (va, bReal),
+                                           _mm_mul_ps (_mm_mul_ps (aSwapped, bImag), signs));
+
+        _mm_storeu_ps (dest, _mm_add_ps (_mm_loadu_ps (dest), product));
+
+        a += 4;
+        b += 4;
+        dest += 4;
+    }
+   #endif
+
+    for (; --num >= 0;)
+    {
+        dest[0] += a[0] * b[0] - a[1] * b[1];
+        dest[1] += a[0] * b[1] + a[1] * b[0];
+
+        a += 2;
+        b += 2;
+        dest += 2;
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FFTTests  : public UnitTest
+{
+public:
+    FFTTests() : UnitTest ("FFT") {}
+
+    static void slowDFT (const float* input, double* output, const int n)
+    {
+        for (int k = 0; k <= n / 2; ++k)
+        {
+            double re = 0, im = 0;
+
+            for (int i = 0; i < n; ++i)
+            {
+                const double angle = -2.0 * double_Pi * k * i / n;
+                re += input[i] * std::cos (angle);
+                im += input[i] * std::sin (angle);
+            }
+
+            output [k * 2] = re;
+            output [k * 2 + 1] = im;
+        }
+    }
+
+    void runTest()
+    {
+        beginTest ("Real transforms");
+
+        Random r;
+
+        for (int order = 1; order <= 10; ++order)
+        {
+            FFT fft (order);
+            const int n = fft.getSize();
+
+            HeapBlock<float> input ((size_t) n), spectrum ((size_t) n + 2), output ((size_t) n);
+            HeapBlock<double> expected ((size_t) n + 2);
+
+            for (int i = 0; i < n; ++i)
+                input[i] = r.nextFloat() * 2.0f - 1.0f;
+
+            fft.performRealForward (input, spectrum);
+            slowDFT (input, expected, n);
+
+            double maxError = 0;
+            for (int i = 0; i < n + 2; ++i)
+                maxError = jmax (maxError, std::abs (spectrum[i] - expected[i]));
+
+            expect (maxError < 1.0e-4 * n);
+
+            fft.performRealInverse (spectrum, output);
+
+            maxError = 0;
+            for (int i = 0; i < n; ++i)
+                maxError = jmax (maxError, (double) std::abs (output[i] - input[i]));
+
+            expect (maxError < 1.0e-5);
+
+            // and in-place..
+            HeapBlock<float> inPlace ((size_t) n + 2);
+            memcpy (inPlace, input, sizeof (float) * (size_t) n);
+            fft.performRealForward (inPlace, inPlace);
+            expect (memcmp (inPlace, spectrum, sizeof (float) * (size_t) (n + 2)) == 0);
+        }
+
+        beginTest ("Complex transforms");
+
+        {
+            FFT fft (6);
+            const int n = fft.getSize();
+            HeapBlock<float> data ((size_t) n * 2), original ((size_t) n * 2);
+
+            for (int i = 0; i < n * 2; ++i)
+                original[i] = data[i] = r.nextFloat() - 0.5f;
+
+            fft.performComplex (data, false);
+
+            // check one bin against the definition..
+            double re = 0, im = 0;
+            for (int i = 0; i < n; ++i)
+            {
+                const double angle = -2.0 * double_Pi * 5 * i / n;
+                re += original [i * 2] * std::cos (angle) - original [i * 2 + 1] * std::sin (angle);
+                im += original [i * 2] * std::sin (angle) + original [i * 2 + 1] * std::cos (angle);
+            }
+
+            expect (std::abs (data[10] - re) < 1.0e-4 && std::abs (data[11] - im) < 1.0e-4);
+
+            fft.performComplex (data, true);
+
+            for (int i = 0; i < n * 2; ++i)
+                expect (std::abs (data[i] - original[i]) < 1.0e-5f);
+        }
+
+        beginTest ("Multiply-accumulate");
+
+        {
+            float a[14], b[14], dest[14];
+            for (int i = 0; i < 14; ++i)
+            {
+                a[i] = r.nextFloat();
+                b[i] = r.nextFloat();
+                dest[i] = 1.0f;
+            }
+
+            FFT::multiplyAccumulate (dest, a, b, 7);
+
+            for (int i = 0; i < 7; ++i)
+            {
+                expect (std::abs (dest [i * 2]     - (1.0f + a[i * 2] * b[i * 2] - a[i * 2 + 1] * b[i * 2 + 1])) < 1.0e-6f);
+                expect (std::abs (dest [i * 2 + 1] - (1.0f + a[i * 2] * b[i * 2 + 1] + a[i * 2 + 1] * b[i * 2])) < 1.0e-6f);
+            }
+        }
+    }
+};
+
+static FFTTests fftTests;
+
+#endif
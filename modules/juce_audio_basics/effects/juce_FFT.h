@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_FFT_JUCEHEADER__
+#define __JUCE_FFT_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    Performs fast fourier transforms of a fixed power-of-two size.
+
+    The complex transforms work in-place on arrays of interleaved real and imaginary
+    floats. The real transforms take N real samples and produce the N / 2 + 1 non-negative
+    frequency bins of their spectrum, as (N + 2) interleaved floats. The real transform
+    is done with a half-size complex transform, so is about twice as fast as doing it the
+    obvious way.
+
+    The forward transforms are unscaled, and the inverse ones are scaled by 1 / N, so that
+    an inverse transform of a forward transform gives back the original data.
+
+    All the tables are computed in the constructor, so the transforms themselves don't
+    allocate any memory, and a const FFT object can be shared between threads.
+*/
+class JUCE_API  FFT
+{
+public:
+    //==============================================================================
+    /** Creates an FFT for a size of (1 << order).
+        The order must be at least 1.
+    */
+    explicit FFT (int order);
+
+    /** Destructor. */
+    ~FFT();
+
+    /** Returns the number of points in the transform. */
+    int getSize() const noexcept                        { return size; }
+
+    //==============================================================================
+    /** Performs an in-place complex transform.
+        The data must contain getSize() complex values, as 2 * getSize() interleaved floats.
+    */
+    void performComplex (float* data, bool inverse) const noexcept;
+
+    /** Transforms getSize() real samples into (getSize() / 2 + 1) complex frequency bins.
+
+        The output must have space for getSize() + 2 floats. It can be the same
+        buffer as the input, as long as it's big enough.
+    */
+    void performRealForward (const float* input, float* output) const noexcept;
+
+    /** Transforms (getSize() / 2 + 1) complex frequency bins back into getSize() real samples.
+
+        This is the reverse of performRealForward(). The input and output can be the
+        same buffer.
+    */
+    void performRealInverse (const float* input, float* output) const noexcept;
+
+    //==============================================================================
+    /** Multiplies two arrays of complex values together, adding the results to a destination.
+        This is the inner loop of a frequency-domain convolution, so is vectorised where possible.
+    */
+    static void multiplyAccumulate (float* dest, const float* a, const float* b, int numComplexValues) noexcept;
+
+private:
+    //==============================================================================
+    const int size, halfSize;
+    HeapBlock<float> twiddles;
+    HeapBlock<int> bitReversed;
+
+    void perform (float* data, int n, int bitShift, bool inverse) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FFT)
+};
+
+
+#endif   // __JUCE_FFT_JUCEHEADER__
@@ -237,3 +237,42 @@ void IIRFilter::setCoefficients (double c1, double c2, double c3,
 }
 
 #undef JUCE_SNAP_TO_ZERO
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class IIRFilterBenchmark  : public Benchmark
+{
+public:
+    IIRFilterBenchmark (const int numSamples_)
+        : Benchmark ("IIRFilter: low-pass, " + String (numSamples_) + " samples", numSamples_),
+          buffer (1, numSamples_)
+    {
+    }
+
+    void initialise()
+    {
+        Random r (1);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            *buffer.getSampleData (0, i) = r.nextFloat() - 0.5f;
+
+        filter.makeLowPass (44100.0, 1000.0);
+    }
+
+    void runIteration()
+    {
+        filter.processSamples (buffer.getSampleData (0), buffer.getNumSamples());
+        preventOptimisation (buffer.getSampleData (0));
+    }
+
+private:
+    IIRFilter filter;
+    AudioSampleBuffer buffer;
+};
+
+static IIRFilterBenchmark iirFilterBenchmark64 (64);
+static IIRFilterBenchmark iirFilterBenchmark512 (512);
+static IIRFilterBenchmark iirFilterBenchmark4096 (4096);
+
+#endif
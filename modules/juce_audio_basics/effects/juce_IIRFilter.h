@@ -140,6 +140,8 @@ protected:
     float coefficients[5];
     float v1, v2;
 
+    friend class BiquadCascade;
+
     // (use the copyCoefficientsFrom() method instead of this operator)
     IIRFilter& operator= (const IIRFilter&);
     JUCE_LEAK_DETECTOR (IIRFilter)
@@ -0,0 +1,553 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace ReverbHelpers
+{
+    // The size of the blocks that the reverb network processes at a time.
+    enum { blockSize = 256 };
+}
+
+//==============================================================================
+void Reverb::setSampleRate (const double sampleRate)
+{
+    jassert (sampleRate > 0);
+
+    static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 }; // (at 44100Hz)
+    static const short allPassTunings[] = { 556, 441, 341, 225 };
+    const int stereoSpread = 23;
+    const int intSampleRate = (int) sampleRate;
+
+    for (int bank = 0; bank < numCombBanks; ++bank)
+    {
+        int leftSizes [CombBank::numLanes], rightSizes [CombBank::numLanes];
+
+        for (int i = 0; i < CombBank::numLanes; ++i)
+        {
+            const int tuning = combTunings [bank * CombBank::numLanes + i];
+            leftSizes[i]  = (intSampleRate * tuning) / 44100;
+            rightSizes[i] = (intSampleRate * (tuning + stereoSpread)) / 44100;
+        }
+
+        combs[0][bank].setSizes (leftSizes);
+        combs[1][bank].setSizes (rightSizes);
+    }
+
+    for (int i = 0; i < numAllPasses; ++i)
+    {
+        allPass[0][i].setSize ((intSampleRate * allPassTunings[i]) / 44100);
+        allPass[1][i].setSize ((intSampleRate * (allPassTunings[i] + stereoSpread)) / 44100);
+    }
+
+    shouldUpdateDamping = true;
+}
+
+void Reverb::reset()
+{
+    for (int j = 0; j < numChannels; ++j)
+    {
+        for (int i = 0; i < numCombBanks; ++i)
+            combs[j][i].clear();
+
+        for (int i = 0; i < numAllPasses; ++i)
+            allPass[j][i].clear();
+    }
+}
+
+//==============================================================================
+void Reverb::processStereo (float* const left, float* const right, const int numSamples) noexcept
+{
+    jassert (left != nullptr && right != nullptr);
+
+    if (shouldUpdateDamping)
+        updateDamping();
+
+    float input [ReverbHelpers::blockSize], outL [ReverbHelpers::blockSize], outR [ReverbHelpers::blockSize];
+
+    for (int start = 0; start < numSamples; start += ReverbHelpers::blockSize)
+    {
+        const int num = jmin ((int) ReverbHelpers::blockSize, numSamples - start);
+        float* const l = left + start;
+        float* const r = right + start;
+
+        for (int i = 0; i < num; ++i)
+            input[i] = (l[i] + r[i]) * gain;
+
+        processNetwork (input, outL, outR, num);
+
+        for (int i = 0; i < num; ++i)
+        {
+            l[i] = outL[i] * wet1 + outR[i] * wet2 + l[i] * dry;
+            r[i] = outR[i] * wet1 + outL[i] * wet2 + r[i] * dry;
+        }
+    }
+}
+
+void Reverb::processMono (float* const samples, const int numSamples) noexcept
+{
+    jassert (samples != nullptr);
+
+    if (shouldUpdateDamping)
+        updateDamping();
+
+    float input [ReverbHelpers::blockSize], output [ReverbHelpers::blockSize];
+
+    for (int start = 0; start < numSamples; start += ReverbHelpers::blockSize)
+    {
+        const int num = jmin ((int) ReverbHelpers::blockSize, numSamples - start);
+        float* const s = samples + start;
+
+        for (int i = 0; i < num; ++i)
+            input[i] = s[i] * gain;
+
+        processNetwork (input, output, nullptr, num);
+
+        for (int i = 0; i < num; ++i)
+            s[i] = output[i] * wet1 + input[i] * dry;
+    }
+}
+
+void Reverb::processMultichannel (float* const* const channels, const int numChannelsToProcess,
+                                  const int startSample, const int numSamples) noexcept
+{
+    jassert (channels != nullptr && numChannelsToProcess > 0);
+
+    if (numChannelsToProcess == 1)
+    {
+        processMono (channels[0] + startSample, numSamples);
+        return;
+    }
+
+    if (numChannelsToProcess == 2)
+    {
+        processStereo (channels[0] + startSample, channels[1] + startSample, numSamples);
+        return;
+    }
+
+    if (shouldUpdateDamping)
+        updateDamping();
+
+    // scale the input so that its level matches that of a stereo pair
+    const float inputGain = gain * 2.0f / numChannelsToProcess;
+    float input [ReverbHelpers::blockSize], outL [ReverbHelpers::blockSize], outR [ReverbHelpers::blockSize];
+
+    for (int start = startSample; start < startSample + numSamples; start += ReverbHelpers::blockSize)
+    {
+        const int num = jmin ((int) ReverbHelpers::blockSize, startSample + numSamples - start);
+
+        for (int i = 0; i < num; ++i)
+            input[i] = 0;
+
+        for (int channel = 0; channel < numChannelsToProcess; ++channel)
+        {
+            const float* const src = channels [channel] + start;
+
+            for (int i = 0; i < num; ++i)
+                input[i] += src[i];
+        }
+
+        for (int i = 0; i < num; ++i)
+            input[i] *= inputGain;
+
+        processNetwork (input, outL, outR, num);
+
+        for (int channel = 0; channel < numChannelsToProcess; ++channel)
+        {
+            float* const dest = channels [channel] + start;
+            const float* const nearSide = (channel & 1) == 0 ? outL : outR;
+            const float* const farSide  = (channel & 1) == 0 ? outR : outL;
+
+            for (int i = 0; i < num; ++i)
+                dest[i] = nearSide[i] * wet1 + farSide[i] * wet2 + dest[i] * dry;
+        }
+    }
+}
+
+void Reverb::processNetwork (const float* const input, float* const outLeft,
+                             float* const outRight, const int numSamples) noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* const output = channel == 0 ? outLeft : outRight;
+
+        if (output == nullptr)
+            continue;
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = 0;
+
+        for (int j = 0; j < numCombBanks; ++j)  // accumulate the comb filters in parallel
+            combs[channel][j].process (input, output, numSamples);
+
+        for (int j = 0; j < numAllPasses; ++j)  // run the allpass filters in series
+            allPass[channel][j].process (output, numSamples);
+    }
+}
+
+//==============================================================================
+void Reverb::updateDamping() noexcept
+{
+    const float roomScaleFactor = 0.28f;
+    const float roomOffset = 0.7f;
+    const float dampScaleFactor = 0.4f;
+
+    shouldUpdateDamping = false;
+
+    if (isFrozen (parameters.freezeMode))
+        setDamping (0.0f, 1.0f);
+    else
+        setDamping (parameters.damping * dampScaleFactor,
+                    parameters.roomSize * roomScaleFactor + roomOffset);
+}
+
+void Reverb::setDamping (const float dampingToUse, const float roomSizeToUse) noexcept
+{
+    for (int j = 0; j < numChannels; ++j)
+        for (int i = numCombBanks; --i >= 0;)
+            combs[j][i].setFeedbackAndDamp (roomSizeToUse, dampingToUse);
+}
+
+//==============================================================================
+Reverb::CombBank::CombBank() noexcept
+    : bufferSize (0), writeIndex (0), feedback (0), damp1 (0), damp2 (1.0f)
+{
+    for (int i = 0; i < numLanes; ++i)
+    {
+        readIndex[i] = 0;
+        last[i] = 0;
+    }
+}
+
+void Reverb::CombBank::setSizes (const int* const sizes)
+{
+    // All four delay lines share one circular buffer, each reading at its own distance
+    // behind the common write position.
+    int maxSize = 1;
+
+    for (int i = 0; i < numLanes; ++i)
+        maxSize = jmax (maxSize, sizes[i]);
+
+    if (maxSize != bufferSize)
+    {
+        buffer.malloc ((size_t) (maxSize * numLanes));
+        bufferSize = maxSize;
+    }
+
+    writeIndex = 0;
+
+    for (int i = 0; i < numLanes; ++i)
+        readIndex[i] = (bufferSize - jmax (1, sizes[i])) % bufferSize;
+
+    clear();
+}
+
+void Reverb::CombBank::clear() noexcept
+{
+    for (int i = 0; i < numLanes; ++i)
+        last[i] = 0;
+
+    buffer.clear ((size_t) (bufferSize * numLanes));
+}
+
+void Reverb::CombBank::setFeedbackAndDamp (const float f, const float d) noexcept
+{
+    damp1 = d;
+    damp2 = 1.0f - d;
+    feedback = f;
+}
+
+void Reverb::CombBank::process (const float* const input, float* const output, const int numSamples) noexcept
+{
+    float* const buf = buffer;
+    int w = writeIndex;
+    int r0 = readIndex[0], r1 = readIndex[1], r2 = readIndex[2], r3 = readIndex[3];
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const __m128 fb = _mm_set1_ps (feedback), d1 = _mm_set1_ps (damp1), d2 = _mm_set1_ps (damp2);
+    __m128 lastValues = _mm_loadu_ps (last);
+   #if JUCE_32BIT
+    const __m128 one = _mm_set1_ps (1.0f);
+   #endif
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const __m128 out = _mm_setr_ps (buf [r0 * 4], buf [r1 * 4 + 1], buf [r2 * 4 + 2], buf [r3 * 4 + 3]);
+
+        lastValues = _mm_add_ps (_mm_mul_ps (out, d2), _mm_mul_ps (lastValues, d1));
+       #if JUCE_32BIT
+        lastValues = _mm_sub_ps (_mm_add_ps (lastValues, one), one);   // (same as JUCE_UNDENORMALISE)
+       #endif
+
+        __m128 temp = _mm_add_ps (_mm_set1_ps (input[i]), _mm_mul_ps (lastValues, fb));
+       #if JUCE_32BIT
+        temp = _mm_sub_ps (_mm_add_ps (temp, one), one);
+       #endif
+
+        _mm_storeu_ps (buf + w * 4, temp);
+
+        __m128 sum = _mm_add_ps (out, _mm_movehl_ps (out, out));
+        sum = _mm_add_ss (sum, _mm_shuffle_ps (sum, sum, 1));
+        output[i] += _mm_cvtss_f32 (sum);
+
+        if (++w  >= bufferSize) w = 0;
+        if (++r0 >= bufferSize) r0 = 0;
+        if (++r1 >= bufferSize) r1 = 0;
+        if (++r2 >= bufferSize) r2 = 0;
+        if (++r3 >= bufferSize) r3 = 0;
+    }
+
+    _mm_storeu_ps (last, lastValues);
+   #else
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float in = input[i];
+        const float outs[] = { buf [r0 * 4], buf [r1 * 4 + 1], buf [r2 * 4 + 2], buf [r3 * 4 + 3] };
+        float* const dest = buf + w * 4;
+
+        for (int j = 0; j < numLanes; ++j)
+        {
+            float l = (outs[j] * damp2) + (last[j] * damp1);
+            JUCE_UNDENORMALISE (l);
+            last[j] = l;
+
+            float temp = in + (l * feedback);
+            JUCE_UNDENORMALISE (temp);
+            dest[j] = temp;
+        }
+
+        output[i] += (outs[0] + outs[2]) + (outs[1] + outs[3]);
+
+        if (++w  >= bufferSize) w = 0;
+        if (++r0 >= bufferSize) r0 = 0;
+        if (++r1 >= bufferSize) r1 = 0;
+        if (++r2 >= bufferSize) r2 = 0;
+        if (++r3 >= bufferSize) r3 = 0;
+    }
+   #endif
+
+    writeIndex = w;
+    readIndex[0] = r0;
+    readIndex[1] = r1;
+    readIndex[2] = r2;
+    readIndex[3] = r3;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ReverbTests  : public UnitTest
+{
+public:
+    ReverbTests() : UnitTest ("Reverb") {}
+
+    // A straightforward per-sample FreeVerb, used to check the block-based version against.
+    struct ReferenceReverb
+    {
+        struct Delay
+        {
+            Delay (int size_) : buffer ((size_t) size_, true), size (size_), index (0), last (0) {}
+
+            float comb (const float input, const float feedback, const float damp)
+            {
+                const float output = buffer [index];
+                last = (output * (1.0f - damp)) + (last * damp);
+                JUCE_UNDENORMALISE (last);
+                float temp = input + (last * feedback);
+                JUCE_UNDENORMALISE (temp);
+                buffer [index] = temp;
+                index = (index + 1) % size;
+                return output;
+            }
+
+            float allPass (const float input)
+            {
+                const float bufferedValue = buffer [index];
+                float temp = input + (bufferedValue * 0.5f);
+                JUCE_UNDENORMALISE (temp);
+                buffer [index] = temp;
+                index = (index + 1) % size;
+                return bufferedValue - input;
+            }
+
+            HeapBlock<float> buffer;
+            int size, index;
+            float last;
+        };
+
+        ReferenceReverb (const Reverb::Parameters& p)
+        {
+            static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 };
+            static const short allPassTunings[] = { 556, 441, 341, 225 };
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int i = 0; i < 8; ++i)
+                    combs[channel].add (new Delay (combTunings[i] + channel * 23));
+
+                for (int i = 0; i < 4; ++i)
+                    allPasses[channel].add (new Delay (allPassTunings[i] + channel * 23));
+            }
+
+            const float wet = p.wetLevel * 3.0f;
+            wet1 = wet * (p.width * 0.5f + 0.5f);
+            wet2 = wet * (1.0f - p.width) * 0.5f;
+            dry = p.dryLevel * 2.0f;
+            feedback = p.roomSize * 0.28f + 0.7f;
+            damp = p.damping * 0.4f;
+        }
+
+        void processStereo (float* left, float* right, int numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float input = (left[i] + right[i]) * 0.015f;
+                float out[2] = { 0, 0 };
+
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    for (int j = 0; j < 8; ++j)
+                        out[channel] += combs[channel][j]->comb (input, feedback, damp);
+
+                    for (int j = 0; j < 4; ++j)
+                        out[channel] = allPasses[channel][j]->allPass (out[channel]);
+                }
+
+                left[i]  = out[0] * wet1 + out[1] * wet2 + left[i]  * dry;
+                right[i] = out[1] * wet1 + out[0] * wet2 + right[i] * dry;
+            }
+        }
+
+        OwnedArray<Delay> combs[2], allPasses[2];
+        float wet1, wet2, dry, feedback, damp;
+    };
+
+    void runTest()
+    {
+        beginTest ("Matches reference");
+
+        Random r;
+        const int numSamples = 20000;
+
+        Reverb::Parameters params;
+        params.roomSize = 0.8f;
+        params.width = 0.6f;
+
+        Reverb reverb;
+        reverb.setParameters (params);
+        reverb.setSampleRate (44100.0);
+        ReferenceReverb reference (params);
+
+        AudioSampleBuffer buffer (2, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float noise = i < 3000 ? r.nextFloat() * 2.0f - 1.0f : 0.0f;
+            *buffer.getSampleData (0, i) = noise;
+            *buffer.getSampleData (1, i) = noise * 0.5f;
+        }
+
+        AudioSampleBuffer expected (buffer), multi (6, numSamples);
+
+        for (int i = 0; i < 6; ++i)
+            multi.copyFrom (i, 0, buffer, i & 1, 0, numSamples);
+
+        reference.processStereo (expected.getSampleData (0), expected.getSampleData (1), numSamples);
+
+        Reverb multiReverb;
+        multiReverb.setParameters (params);
+        multiReverb.setSampleRate (44100.0);
+
+        for (int start = 0, blockSize = 1; start < numSamples; blockSize = (blockSize * 7 + 5) % 1000)
+        {
+            const int num = jmin (blockSize, numSamples - start);
+            reverb.processStereo (buffer.getSampleData (0, start), buffer.getSampleData (1, start), num);
+            multiReverb.processMultichannel (multi.getArrayOfChannels(), 6, start, num);
+            start += num;
+        }
+
+        float maxError = 0;
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                maxError = jmax (maxError, std::abs (*buffer.getSampleData (channel, i) - *expected.getSampleData (channel, i)));
+
+        expect (maxError < 1.0e-4f);
+
+        beginTest ("Multichannel");
+
+        // The channel pairs all carry the same signals, so each one should get the same
+        // result as the stereo version.
+        maxError = 0;
+
+        for (int channel = 0; channel < 6; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                maxError = jmax (maxError, std::abs (*multi.getSampleData (channel, i) - *buffer.getSampleData (channel & 1, i)));
+
+        expect (maxError < 1.0e-4f);
+    }
+};
+
+static ReverbTests reverbTests;
+
+//==============================================================================
+class ReverbBenchmark  : public Benchmark
+{
+public:
+    ReverbBenchmark (const int numChannels_)
+        : Benchmark ("Reverb: " + String (numChannels_ == 1 ? "mono" : "stereo") + ", 512 samples", 512),
+          buffer (numChannels_, 512)
+    {
+    }
+
+    void initialise()
+    {
+        Random r (1);
+
+        for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                *buffer.getSampleData (chan, i) = (r.nextFloat() - 0.5f) * 0.1f;
+
+        reverb.setSampleRate (44100.0);
+        reverb.reset();
+    }
+
+    void runIteration()
+    {
+        if (buffer.getNumChannels() == 1)
+            reverb.processMono (buffer.getSampleData (0), buffer.getNumSamples());
+        else
+            reverb.processStereo (buffer.getSampleData (0), buffer.getSampleData (1), buffer.getNumSamples());
+
+        preventOptimisation (buffer.getSampleData (0));
+    }
+
+private:
+    Reverb reverb;
+    AudioSampleBuffer buffer;
+};
+
+static ReverbBenchmark monoReverbBenchmark (1);
+static ReverbBenchmark stereoReverbBenchmark (2);
+
+#endif
@@ -32,12 +32,15 @@
     Performs a simple reverb effect on a stream of audio data.
 
     This is a simple stereo reverb, based on the technique and tunings used in FreeVerb.
-    Use setSampleRate() to prepare it, and then call processStereo() or processMono() to
-    apply the reverb to your audio data.
+    Use setSampleRate() to prepare it, and then call processStereo(), processMono() or
+    processMultichannel() to apply the reverb to your audio data.
+
+    The audio is processed in blocks, with the comb filters run four at a time in
+    parallel SIMD lanes.
 
     @see ReverbAudioSource
 */
-class Reverb
+class JUCE_API  Reverb
 {
 public:
     //==============================================================================
@@ -95,96 +98,30 @@ public:
     /** Sets the sample rate that will be used for the reverb.
         You must call this before the process methods, in order to tell it the correct sample rate.
     */
-    void setSampleRate (const double sampleRate)
-    {
-        jassert (sampleRate > 0);
-
-        static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 }; // (at 44100Hz)
-        static const short allPassTunings[] = { 556, 441, 341, 225 };
-        const int stereoSpread = 23;
-        const int intSampleRate = (int) sampleRate;
-
-        for (int i = 0; i < numCombs; ++i)
-        {
-            comb[0][i].setSize ((intSampleRate * combTunings[i]) / 44100);
-            comb[1][i].setSize ((intSampleRate * (combTunings[i] + stereoSpread)) / 44100);
-        }
-
-        for (int i = 0; i < numAllPasses; ++i)
-        {
-            allPass[0][i].setSize ((intSampleRate * allPassTunings[i]) / 44100);
-            allPass[1][i].setSize ((intSampleRate * (allPassTunings[i] + stereoSpread)) / 44100);
-        }
-
-        shouldUpdateDamping = true;
-    }
+    void setSampleRate (double sampleRate);
 
     /** Clears the reverb's buffers. */
-    void reset()
-    {
-        for (int j = 0; j < numChannels; ++j)
-        {
-            for (int i = 0; i < numCombs; ++i)
-                comb[j][i].clear();
-
-            for (int i = 0; i < numAllPasses; ++i)
-                allPass[j][i].clear();
-        }
-    }
+    void reset();
 
     //==============================================================================
     /** Applies the reverb to two stereo channels of audio data. */
-    void processStereo (float* const left, float* const right, const int numSamples) noexcept
-    {
-        jassert (left != nullptr && right != nullptr);
-
-        if (shouldUpdateDamping)
-            updateDamping();
-
-        for (int i = 0; i < numSamples; ++i)
-        {
-            const float input = (left[i] + right[i]) * gain;
-            float outL = 0, outR = 0;
-
-            for (int j = 0; j < numCombs; ++j)  // accumulate the comb filters in parallel
-            {
-                outL += comb[0][j].process (input);
-                outR += comb[1][j].process (input);
-            }
-
-            for (int j = 0; j < numAllPasses; ++j)  // run the allpass filters in series
-            {
-                outL = allPass[0][j].process (outL);
-                outR = allPass[1][j].process (outR);
-            }
-
-            left[i]  = outL * wet1 + outR * wet2 + left[i]  * dry;
-            right[i] = outR * wet1 + outL * wet2 + right[i] * dry;
-        }
-    }
+    void processStereo (float* left, float* right, int numSamples) noexcept;
 
     /** Applies the reverb to a single mono channel of audio data. */
-    void processMono (float* const samples, const int numSamples) noexcept
-    {
-        jassert (samples != nullptr);
+    void processMono (float* samples, int numSamples) noexcept;
 
-        if (shouldUpdateDamping)
-            updateDamping();
+    /** Applies the reverb to any number of channels of audio data.
 
-        for (int i = 0; i < numSamples; ++i)
-        {
-            const float input = samples[i] * gain;
-            float output = 0;
+        The channels are all mixed into the reverb's input, and the two outputs of the
+        stereo network are shared between them, so this costs about the same as
+        processStereo() however many channels there are. Even-numbered channels get the
+        left reverb output, and odd-numbered ones get the right, so a 5.1 or 7.1 layout
+        with its channels in the usual left/right pairs gets a stereo image.
 
-            for (int j = 0; j < numCombs; ++j)  // accumulate the comb filters in parallel
-                output += comb[0][j].process (input);
-
-            for (int j = 0; j < numAllPasses; ++j)  // run the allpass filters in series
-                output = allPass[0][j].process (output);
-
-            samples[i] = output * wet1 + input * dry;
-        }
-    }
+        With one or two channels, this does the same as processMono() or processStereo().
+    */
+    void processMultichannel (float* const* channels, int numChannels,
+                              int startSample, int numSamples) noexcept;
 
 private:
     //==============================================================================
@@ -195,78 +132,34 @@ private:
 
     inline static bool isFrozen (const float freezeMode) noexcept  { return freezeMode >= 0.5f; }
 
-    void updateDamping() noexcept
-    {
-        const float roomScaleFactor = 0.28f;
-        const float roomOffset = 0.7f;
-        const float dampScaleFactor = 0.4f;
-
-        shouldUpdateDamping = false;
-
-        if (isFrozen (parameters.freezeMode))
-            setDamping (0.0f, 1.0f);
-        else
-            setDamping (parameters.damping * dampScaleFactor,
-                        parameters.roomSize * roomScaleFactor + roomOffset);
-    }
-
-    void setDamping (const float dampingToUse, const float roomSizeToUse) noexcept
-    {
-        for (int j = 0; j < numChannels; ++j)
-            for (int i = numCombs; --i >= 0;)
-                comb[j][i].setFeedbackAndDamp (roomSizeToUse, dampingToUse);
-    }
+    void updateDamping() noexcept;
+    void setDamping (float dampingToUse, float roomSizeToUse) noexcept;
+    void processNetwork (const float* input, float* outLeft, float* outRight, int numSamples) noexcept;
 
     //==============================================================================
-    class CombFilter
+    /* A set of four comb filters, whose delay lines are interleaved in one buffer so that
+       all four can be run in parallel SIMD lanes.
+    */
+    class CombBank
     {
     public:
-        CombFilter() noexcept  : bufferSize (0), bufferIndex (0) {}
-
-        void setSize (const int size)
-        {
-            if (size != bufferSize)
-            {
-                bufferIndex = 0;
-                buffer.malloc ((size_t) size);
-                bufferSize = size;
-            }
+        CombBank() noexcept;
 
-            clear();
-        }
+        void setSizes (const int* sizes);
+        void clear() noexcept;
+        void setFeedbackAndDamp (float feedback, float damp) noexcept;
 
-        void clear() noexcept
-        {
-            last = 0;
-            buffer.clear ((size_t) bufferSize);
-        }
-
-        void setFeedbackAndDamp (const float f, const float d) noexcept
-        {
-            damp1 = d;
-            damp2 = 1.0f - d;
-            feedback = f;
-        }
+        /** Adds the sum of the four filters' outputs to the output buffer. */
+        void process (const float* input, float* output, int numSamples) noexcept;
 
-        inline float process (const float input) noexcept
-        {
-            const float output = buffer [bufferIndex];
-            last = (output * damp2) + (last * damp1);
-            JUCE_UNDENORMALISE (last);
-
-            float temp = input + (last * feedback);
-            JUCE_UNDENORMALISE (temp);
-            buffer [bufferIndex] = temp;
-            bufferIndex = (bufferIndex + 1) % bufferSize;
-            return output;
-        }
+        enum { numLanes = 4 };
 
     private:
         HeapBlock<float> buffer;
-        int bufferSize, bufferIndex;
-        float feedback, last, damp1, damp2;
+        int bufferSize, writeIndex, readIndex [numLanes];
+        float feedback, damp1, damp2, last [numLanes];
 
-        JUCE_DECLARE_NON_COPYABLE (CombFilter)
+        JUCE_DECLARE_NON_COPYABLE (CombBank)
     };
 
     //==============================================================================
@@ -292,14 +185,26 @@ private:
             buffer.clear ((size_t) bufferSize);
         }
 
-        inline float process (const float input) noexcept
+        void process (float* const samples, const int numSamples) noexcept
         {
-            const float bufferedValue = buffer [bufferIndex];
-            float temp = input + (bufferedValue * 0.5f);
-            JUCE_UNDENORMALISE (temp);
-            buffer [bufferIndex] = temp;
-            bufferIndex = (bufferIndex + 1) % bufferSize;
-            return bufferedValue - input;
+            float* const buf = buffer;
+            int index = bufferIndex;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float input = samples[i];
+                const float bufferedValue = buf [index];
+                float temp = input + (bufferedValue * 0.5f);
+                JUCE_UNDENORMALISE (temp);
+                buf [index] = temp;
+
+                if (++index >= bufferSize)
+                    index = 0;
+
+                samples[i] = bufferedValue - input;
+            }
+
+            bufferIndex = index;
         }
 
     private:
@@ -309,9 +214,10 @@ private:
         JUCE_DECLARE_NON_COPYABLE (AllPassFilter)
     };
 
-    enum { numCombs = 8, numAllPasses = 4, numChannels = 2 };
+    enum { numCombs = 8, numAllPasses = 4, numChannels = 2,
+           numCombBanks = numCombs / CombBank::numLanes };
 
-    CombFilter comb [numChannels][numCombs];
+    CombBank combs [numChannels][numCombBanks];
     AllPassFilter allPass [numChannels][numAllPasses];
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Reverb)
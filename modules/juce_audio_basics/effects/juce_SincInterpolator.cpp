@@ -0,0 +1,386 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace SincHelpers
+{
+    struct QualitySettings
+    {
+        int numTaps, numPhases;
+        double kaiserBeta, bandwidth;
+    };
+
+    static const QualitySettings& getSettings (const SincInterpolator::Quality quality) noexcept
+    {
+        // The bandwidth is the filter's cutoff as a proportion of the input's nyquist frequency,
+        // chosen so that the stop-band of each window roughly begins at nyquist.
+        static const QualitySettings settings[] =
+        {
+            { 16, 64,  5.0, 0.80 },
+            { 32, 128, 7.5, 0.88 },
+            { 64, 256, 9.5, 0.92 }
+        };
+
+        return settings [jlimit (0, numElementsInArray (settings) - 1, (int) quality)];
+    }
+
+    // When down-sampling, the filter is lengthened in proportion to the ratio, up to this limit.
+    const int maxStretch = 16;
+
+    static double getStretchForRatio (const double speedRatio) noexcept
+    {
+        return jlimit (1.0, (double) maxStretch, speedRatio);
+    }
+
+    static double besselI0 (const double x) noexcept
+    {
+        const double halfX = x * 0.5;
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 64; ++k)
+        {
+            const double t = halfX / k;
+            term *= t * t;
+            sum += term;
+
+            if (term < sum * 1.0e-12)
+                break;
+        }
+
+        return sum;
+    }
+
+    // Returns the dot-product of the source with a blend of two rows of the table.
+    // The number of taps is always a multiple of 4.
+    static forcedinline float interpolatedDotProduct (const float* const src, const float* const row0,
+                                                      const float* const row1, const float frac, const int num) noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+
+        for (int i = 0; i < num; i += 4)
+        {
+            const __m128 s = _mm_loadu_ps (src + i);
+            acc0 = _mm_add_ps (acc0, _mm_mul_ps (s, _mm_loadu_ps (row0 + i)));
+            acc1 = _mm_add_ps (acc1, _mm_mul_ps (s, _mm_loadu_ps (row1 + i)));
+        }
+
+        __m128 acc = _mm_add_ps (acc0, _mm_mul_ps (_mm_set1_ps (frac), _mm_sub_ps (acc1, acc0)));
+        acc = _mm_add_ps (acc, _mm_movehl_ps (acc, acc));
+        acc = _mm_add_ss (acc, _mm_shuffle_ps (acc, acc, 1));
+        return _mm_cvtss_f32 (acc);
+       #elif JUCE_USE_ARM_NEON
+        float32x4_t acc0 = vdupq_n_f32 (0);
+        float32x4_t acc1 = vdupq_n_f32 (0);
+
+        for (int i = 0; i < num; i += 4)
+        {
+            const float32x4_t s = vld1q_f32 (src + i);
+            acc0 = vmlaq_f32 (acc0, s, vld1q_f32 (row0 + i));
+            acc1 = vmlaq_f32 (acc1, s, vld1q_f32 (row1 + i));
+        }
+
+        const float32x4_t acc = vmlaq_n_f32 (acc0, vsubq_f32 (acc1, acc0), frac);
+        const float32x2_t sum = vadd_f32 (vget_low_f32 (acc), vget_high_f32 (acc));
+        return vget_lane_f32 (vpadd_f32 (sum, sum), 0);
+       #else
+        float acc0 = 0, acc1 = 0;
+
+        for (int i = 0; i < num; ++i)
+        {
+            acc0 += src[i] * row0[i];
+            acc1 += src[i] * row1[i];
+        }
+
+        return acc0 + frac * (acc1 - acc0);
+       #endif
+    }
+
+    struct WriteOp
+    {
+        forcedinline void operator() (float& dest, const float value) const noexcept   { dest = value; }
+    };
+
+    struct AddOp
+    {
+        AddOp (const float gain_) noexcept : gain (gain_) {}
+        forcedinline void operator() (float& dest, const float value) const noexcept   { dest += gain * value; }
+
+        const float gain;
+    };
+}
+
+//==============================================================================
+SincInterpolator::SincInterpolator (const Quality quality_)
+    : quality (quality_), numTaps (0), numPhases (0), historyPos (0),
+      tableStretch (0), subSamplePos (1.0)
+{
+    buildTable (1.0);
+    reset();
+}
+
+SincInterpolator::~SincInterpolator() {}
+
+void SincInterpolator::setQuality (const Quality newQuality)
+{
+    if (quality != newQuality)
+    {
+        quality = newQuality;
+        buildTable (tableStretch);
+        reset();
+    }
+}
+
+void SincInterpolator::reset() noexcept
+{
+    history.clear ((size_t) (2 * numTaps));
+    historyPos = 0;
+    subSamplePos = 1.0;
+}
+
+void SincInterpolator::prepareForRatio (const double speedRatio)
+{
+    const double stretch = SincHelpers::getStretchForRatio (speedRatio);
+
+    if (std::abs (stretch - tableStretch) > tableStretch * 0.01)
+        buildTable (stretch);
+}
+
+void SincInterpolator::buildTable (const double stretch)
+{
+    const SincHelpers::QualitySettings& settings = SincHelpers::getSettings (quality);
+
+    const int newNumTaps = jmin (settings.numTaps * SincHelpers::maxStretch,
+                                 4 * (int) std::ceil (settings.numTaps * stretch / 4.0));
+
+    if (newNumTaps != numTaps || settings.numPhases != numPhases)
+    {
+        // Keep the most recent input samples, so that a change of ratio doesn't
+        // interrupt the stream more than it has to.
+        HeapBlock<float> newHistory ((size_t) (2 * newNumTaps), true);
+        const int numToKeep = jmin (numTaps, newNumTaps);
+
+        for (int i = 0; i < numToKeep; ++i)
+        {
+            const float sample = history [historyPos + numTaps - numToKeep + i];
+            newHistory [newNumTaps - numToKeep + i] = sample;
+            newHistory [2 * newNumTaps - numToKeep + i] = sample;
+        }
+
+        history.swapWith (newHistory);
+        historyPos = 0;
+
+        numTaps = newNumTaps;
+        numPhases = settings.numPhases;
+        table.malloc ((size_t) ((numPhases + 1) * numTaps));
+    }
+
+    const double cutoff = settings.bandwidth / stretch;
+    const double halfLength = numTaps * 0.5;
+    const double windowScale = 1.0 / SincHelpers::besselI0 (settings.kaiserBeta);
+
+    for (int phase = 0; phase <= numPhases; ++phase)
+    {
+        float* const row = table + phase * numTaps;
+        const double centre = halfLength - 1.0 + phase / (double) numPhases;
+        double total = 0;
+
+        for (int i = 0; i < numTaps; ++i)
+        {
+            const double x = i - centre;
+            const double w = x / halfLength;
+
+            const double window = w > -1.0 && w < 1.0 ? SincHelpers::besselI0 (settings.kaiserBeta * std::sqrt (1.0 - w * w)) * windowScale
+                                                      : 0.0;
+            const double sinc = x == 0 ? 1.0 : std::sin (double_Pi * cutoff * x) / (double_Pi * cutoff * x);
+
+            row[i] = (float) (sinc * window);
+            total += row[i];
+        }
+
+        // normalising each response keeps the DC gain at exactly 1, whatever the offset
+        const float scale = (float) (1.0 / total);
+
+        for (int i = 0; i < numTaps; ++i)
+            row[i] *= scale;
+    }
+
+    tableStretch = stretch;
+}
+
+//==============================================================================
+template <class OutputOp>
+int SincInterpolator::resample (const double speedRatio, const float* in,
+                                float* out, const int numOut, OutputOp op) noexcept
+{
+    jassert (speedRatio > 0);
+    prepareForRatio (speedRatio);
+
+    const float* const originalIn = in;
+    const int n = numTaps;
+    const float phaseScale = (float) numPhases;
+    double pos = subSamplePos;
+
+    for (int i = numOut; --i >= 0;)
+    {
+        while (pos >= 1.0)
+        {
+            history [historyPos] = history [historyPos + n] = *in++;
+
+            if (++historyPos >= n)
+                historyPos = 0;
+
+            pos -= 1.0;
+        }
+
+        const float phase = (float) pos * phaseScale;
+        const int index = jmin (numPhases - 1, (int) phase);
+        const float* const row = table + index * n;
+
+        op (*out++, SincHelpers::interpolatedDotProduct (history + historyPos, row, row + n, phase - index, n));
+        pos += speedRatio;
+    }
+
+    subSamplePos = pos;
+    return (int) (in - originalIn);
+}
+
+int SincInterpolator::process (const double speedRatio, const float* in,
+                               float* out, const int numOut) noexcept
+{
+    return resample (speedRatio, in, out, numOut, SincHelpers::WriteOp());
+}
+
+int SincInterpolator::processAdding (const double speedRatio, const float* in,
+                                     float* out, const int numOut, const float gain) noexcept
+{
+    return resample (speedRatio, in, out, numOut, SincHelpers::AddOp (gain));
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SincInterpolatorTests  : public UnitTest
+{
+public:
+    SincInterpolatorTests() : UnitTest ("SincInterpolator") {}
+
+    // Resamples a sine wave in uneven blocks, and returns the worst difference between the
+    // result and the ideal output, ignoring the start-up transient.
+    static double resampleSine (SincInterpolator& interpolator, const double ratio,
+                                const double cyclesPerInputSample, double& outputLevel)
+    {
+        const int numOut = 4000;
+        const int numIn = (int) std::ceil (numOut * ratio) + 2;
+
+        HeapBlock<float> input ((size_t) numIn), output ((size_t) numOut);
+
+        for (int i = 0; i < numIn; ++i)
+            input[i] = (float) std::sin (2.0 * double_Pi * cyclesPerInputSample * i);
+
+        interpolator.reset();
+        int inPos = 0, outPos = 0;
+
+        for (int blockSize = 1; outPos < numOut; blockSize = (blockSize * 3 + 7) % 229)
+        {
+            const int num = jmin (numOut - outPos, blockSize);
+            inPos += interpolator.process (ratio, input + inPos, output + outPos, num);
+            outPos += num;
+            jassert (inPos <= numIn);
+        }
+
+        const int latency = interpolator.getLatencyInInputSamples();
+        double maxError = 0, sumSquares = 0;
+        int numCompared = 0;
+
+        for (int i = 0; i < numOut; ++i)
+        {
+            const double inputTime = i * ratio - latency;
+
+            if (inputTime > 2 * latency)
+            {
+                const double expected = std::sin (2.0 * double_Pi * cyclesPerInputSample * inputTime);
+                maxError = jmax (maxError, std::abs (output[i] - expected));
+                sumSquares += output[i] * output[i];
+                ++numCompared;
+            }
+        }
+
+        outputLevel = std::sqrt (sumSquares / jmax (1, numCompared));
+        return maxError;
+    }
+
+    void runTest()
+    {
+        beginTest ("Pass-band accuracy");
+
+        const double ratios[] = { 44100.0 / 48000.0, 0.25, 1.0, 48000.0 / 44100.0, 2.0 };
+        double level;
+
+        for (int i = 0; i < numElementsInArray (ratios); ++i)
+        {
+            SincInterpolator high (SincInterpolator::highQuality);
+            expect (resampleSine (high, ratios[i], 1000.0 / 44100.0, level) < 0.0001);
+
+            SincInterpolator low (SincInterpolator::lowQuality);
+            expect (resampleSine (low, ratios[i], 1000.0 / 44100.0, level) < 0.01);
+        }
+
+        beginTest ("Alias rejection");
+
+        // a 15kHz tone at 44.1kHz is above the nyquist of the down-sampled output..
+        SincInterpolator interpolator (SincInterpolator::highQuality);
+        resampleSine (interpolator, 2.0, 15000.0 / 44100.0, level);
+        expect (level < 0.00001);
+
+        interpolator.setQuality (SincInterpolator::mediumQuality);
+        resampleSine (interpolator, 2.0, 15000.0 / 44100.0, level);
+        expect (level < 0.0001);
+
+        beginTest ("Adding");
+
+        HeapBlock<float> input (256), out1 (200), out2 (200);
+
+        for (int i = 0; i < 256; ++i)
+            input[i] = (float) std::sin (i * 0.1);
+
+        SincInterpolator a, b;
+        const int used1 = a.process (1.2, input, out1, 200);
+
+        for (int i = 0; i < 200; ++i)
+            out2[i] = 1.0f;
+
+        const int used2 = b.processAdding (1.2, input, out2, 200, 0.5f);
+        expectEquals (used1, used2);
+        expectEquals (used1, 239);
+
+        for (int i = 0; i < 200; ++i)
+            expect (std::abs (out2[i] - (1.0f + 0.5f * out1[i])) < 1.0e-6f);
+    }
+};
+
+static SincInterpolatorTests sincInterpolatorTests;
+
+#endif
@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SINCINTERPOLATOR_JUCEHEADER__
+#define __JUCE_SINCINTERPOLATOR_JUCEHEADER__
+
+//==============================================================================
+/**
+    Interpolator for high-quality resampling of a stream of floats, using a
+    polyphase windowed-sinc filter.
+
+    This has the same interface as LagrangeInterpolator, but is far better at
+    keeping aliasing and imaging out of the result, at the cost of more CPU and a
+    few dozen samples of latency. It's intended for jobs like sample-rate conversion
+    of files, where the quality of the result matters more than the speed.
+
+    The filter coefficients are precomputed into a table of impulse responses at a
+    set of fractional offsets, and the output samples are calculated by interpolating
+    between the two nearest ones, so the inner loop is a pair of vectorised dot-products.
+    The table is small enough to stay in the cache while a block is being rendered.
+
+    When down-sampling, the filter's cutoff (and its length) are scaled to suit the
+    ratio, which means that the table has to be rebuilt when the ratio changes by
+    more than about 1%. When up-sampling, changing the ratio is free. If you need
+    to sweep the down-sampling ratio continuously in real-time, you'll be better off
+    with LagrangeInterpolator.
+
+    Like LagrangeInterpolator, this is stateful, so when there's a break in the
+    continuity of the input stream you're feeding it, you should call reset() before
+    feeding it any new data, and if you're resampling multiple channels, make sure
+    each one uses its own SincInterpolator object.
+
+    @see LagrangeInterpolator, SincResamplingAudioSource
+*/
+class JUCE_API  SincInterpolator
+{
+public:
+    //==============================================================================
+    /** The available trade-offs between speed and quality. */
+    enum Quality
+    {
+        lowQuality = 0,     /**< 16 taps - about 60dB of alias rejection. */
+        mediumQuality,      /**< 32 taps - about 80dB of alias rejection. */
+        highQuality         /**< 64 taps - about 95dB of alias rejection. */
+    };
+
+    /** Creates an interpolator with a given quality setting. */
+    explicit SincInterpolator (Quality quality = mediumQuality);
+
+    /** Destructor. */
+    ~SincInterpolator();
+
+    //==============================================================================
+    /** Changes the quality setting.
+        This will rebuild the filter table and reset the interpolator's state.
+    */
+    void setQuality (Quality newQuality);
+
+    /** Returns the current quality setting. */
+    Quality getQuality() const noexcept                     { return quality; }
+
+    /** Resets the state of the interpolator.
+        Call this when there's a break in the continuity of the input data stream.
+    */
+    void reset() noexcept;
+
+    /** Builds the filter table for a given ratio in advance.
+
+        The process() methods will do this automatically if they're given a ratio that
+        needs a different table, but as that involves allocating memory, it's a good idea
+        to call this before you start working on the audio thread.
+    */
+    void prepareForRatio (double speedRatio);
+
+    /** Returns the delay that the filter introduces, measured in input samples.
+        This depends on the quality setting and on the last ratio that was used.
+    */
+    int getLatencyInInputSamples() const noexcept           { return numTaps / 2; }
+
+    //==============================================================================
+    /** Resamples a stream of samples.
+
+        @param speedRatio       the number of input samples to use for each output sample
+        @param inputSamples     the source data to read from. This must contain at
+                                least (speedRatio * numOutputSamplesToProduce) samples,
+                                rounded up.
+        @param outputSamples    the buffer to write the results into
+        @param numOutputSamplesToProduce    the number of output samples that should be created
+
+        @returns the actual number of input samples that were used
+    */
+    int process (double speedRatio,
+                 const float* inputSamples,
+                 float* outputSamples,
+                 int numOutputSamplesToProduce) noexcept;
+
+    /** Resamples a stream of samples, adding the results to the output data
+        with a gain.
+
+        @param speedRatio       the number of input samples to use for each output sample
+        @param inputSamples     the source data to read from. This must contain at
+                                least (speedRatio * numOutputSamplesToProduce) samples,
+                                rounded up.
+        @param outputSamples    the buffer to write the results to - the result values will be added
+                                to any pre-existing data in this buffer after being multiplied by
+                                the gain factor
+        @param numOutputSamplesToProduce    the number of output samples that should be created
+        @param gain             a gain factor to multiply the resulting samples by before
+                                adding them to the destination buffer
+
+        @returns the actual number of input samples that were used
+    */
+    int processAdding (double speedRatio,
+                       const float* inputSamples,
+                       float* outputSamples,
+                       int numOutputSamplesToProduce,
+                       float gain) noexcept;
+
+private:
+    //==============================================================================
+    Quality quality;
+    HeapBlock<float> table, history;
+    int numTaps, numPhases, historyPos;
+    double tableStretch, subSamplePos;
+
+    void buildTable (double stretch);
+
+    template <class OutputOp>
+    int resample (double speedRatio, const float* in, float* out, int numOut, OutputOp op) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SincInterpolator)
+};
+
+
+#endif   // __JUCE_SINCINTERPOLATOR_JUCEHEADER__
@@ -49,6 +49,41 @@
  #include <emmintrin.h>
 #endif
 
+#ifndef JUCE_USE_AVX_INTRINSICS
+ #if JUCE_USE_SSE_INTRINSICS && ((JUCE_MSVC && _MSC_FULL_VER >= 160040219) \
+                                  || (JUCE_GCC && ! JUCE_CLANG && (__GNUC__ * 100 + __GNUC_MINOR__) >= 409) \
+                                  || (JUCE_CLANG && ! (JUCE_MAC || JUCE_IOS) && (__clang_major__ * 100 + __clang_minor__) >= 308))
+  #define JUCE_USE_AVX_INTRINSICS 1
+ #endif
+#endif
+
+#if ! JUCE_USE_SSE_INTRINSICS
+ #undef JUCE_USE_AVX_INTRINSICS
+#endif
+
+#if JUCE_USE_AVX_INTRINSICS
+ #include <immintrin.h>
+
+ // The AVX code is compiled for that instruction set on a per-function basis, and is
+ // only called after checking SystemStats::hasAVX(), so the rest of the module can still
+ // be built for plain SSE2 targets.
+ #if JUCE_MSVC
+  #define JUCE_AVX_FUNCTION
+ #else
+  #define JUCE_AVX_FUNCTION __attribute__ ((target ("avx")))
+ #endif
+#endif
+
+#ifndef JUCE_USE_ARM_NEON
+ #if defined (__ARM_NEON__) || defined (__ARM_NEON)
+  #define JUCE_USE_ARM_NEON 1
+ #endif
+#endif
+
+#if JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
 #if JUCE_MAC || JUCE_IOS
  #define JUCE_USE_VDSP_FRAMEWORK 1
  #include <Accelerate/Accelerate.h>
@@ -61,19 +96,28 @@ namespace juce
 #include "buffers/juce_AudioDataConverters.cpp"
 #include "buffers/juce_AudioSampleBuffer.cpp"
 #include "buffers/juce_FloatVectorOperations.cpp"
+#include "effects/juce_BiquadCascade.cpp"
+#include "effects/juce_Convolution.cpp"
+#include "effects/juce_FFT.cpp"
 #include "effects/juce_IIRFilter.cpp"
 #include "effects/juce_LagrangeInterpolator.cpp"
+#include "effects/juce_Reverb.cpp"
+#include "effects/juce_SincInterpolator.cpp"
 #include "midi/juce_MidiBuffer.cpp"
 #include "midi/juce_MidiFile.cpp"
+#include "midi/juce_MidiFileReader.cpp"
+#include "midi/juce_MidiFileWriter.cpp"
 #include "midi/juce_MidiKeyboardState.cpp"
 #include "midi/juce_MidiMessage.cpp"
 #include "midi/juce_MidiMessageSequence.cpp"
 #include "sources/juce_BufferingAudioSource.cpp"
 #include "sources/juce_ChannelRemappingAudioSource.cpp"
+#include "sources/juce_ConvolutionAudioSource.cpp"
 #include "sources/juce_IIRFilterAudioSource.cpp"
 #include "sources/juce_MixerAudioSource.cpp"
 #include "sources/juce_ResamplingAudioSource.cpp"
 #include "sources/juce_ReverbAudioSource.cpp"
+#include "sources/juce_SincResamplingAudioSource.cpp"
 #include "sources/juce_ToneGeneratorAudioSource.cpp"
 #include "synthesisers/juce_Synthesiser.cpp"
 // END_AUTOINCLUDE
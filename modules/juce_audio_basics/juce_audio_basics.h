@@ -42,15 +42,27 @@ namespace juce
 #ifndef __JUCE_FLOATVECTOROPERATIONS_JUCEHEADER__
  #include "buffers/juce_FloatVectorOperations.h"
 #endif
+#ifndef __JUCE_CONVOLUTION_JUCEHEADER__
+ #include "effects/juce_Convolution.h"
+#endif
 #ifndef __JUCE_DECIBELS_JUCEHEADER__
  #include "effects/juce_Decibels.h"
 #endif
+#ifndef __JUCE_BIQUADCASCADE_JUCEHEADER__
+ #include "effects/juce_BiquadCascade.h"
+#endif
+#ifndef __JUCE_FFT_JUCEHEADER__
+ #include "effects/juce_FFT.h"
+#endif
 #ifndef __JUCE_IIRFILTER_JUCEHEADER__
  #include "effects/juce_IIRFilter.h"
 #endif
 #ifndef __JUCE_LAGRANGEINTERPOLATOR_JUCEHEADER__
  #include "effects/juce_LagrangeInterpolator.h"
 #endif
+#ifndef __JUCE_SINCINTERPOLATOR_JUCEHEADER__
+ #include "effects/juce_SincInterpolator.h"
+#endif
 #ifndef __JUCE_REVERB_JUCEHEADER__
  #include "effects/juce_Reverb.h"
 #endif
@@ -60,6 +72,12 @@ namespace juce
 #ifndef __JUCE_MIDIFILE_JUCEHEADER__
  #include "midi/juce_MidiFile.h"
 #endif
+#ifndef __JUCE_MIDIFILEREADER_JUCEHEADER__
+ #include "midi/juce_MidiFileReader.h"
+#endif
+#ifndef __JUCE_MIDIFILEWRITER_JUCEHEADER__
+ #include "midi/juce_MidiFileWriter.h"
+#endif
 #ifndef __JUCE_MIDIKEYBOARDSTATE_JUCEHEADER__
  #include "midi/juce_MidiKeyboardState.h"
 #endif
@@ -72,12 +90,18 @@ namespace juce
 #ifndef __JUCE_AUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_AudioSource.h"
 #endif
+#ifndef __JUCE_AUDIOTHREADHANDOVER_JUCEHEADER__
+ #include "sources/juce_AudioThreadHandover.h"
+#endif
 #ifndef __JUCE_BUFFERINGAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_BufferingAudioSource.h"
 #endif
 #ifndef __JUCE_CHANNELREMAPPINGAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_ChannelRemappingAudioSource.h"
 #endif
+#ifndef __JUCE_CONVOLUTIONAUDIOSOURCE_JUCEHEADER__
+ #include "sources/juce_ConvolutionAudioSource.h"
+#endif
 #ifndef __JUCE_IIRFILTERAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_IIRFilterAudioSource.h"
 #endif
@@ -93,6 +117,9 @@ namespace juce
 #ifndef __JUCE_REVERBAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_ReverbAudioSource.h"
 #endif
+#ifndef __JUCE_SINCRESAMPLINGAUDIOSOURCE_JUCEHEADER__
+ #include "sources/juce_SincResamplingAudioSource.h"
+#endif
 #ifndef __JUCE_TONEGENERATORAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_ToneGeneratorAudioSource.h"
 #endif
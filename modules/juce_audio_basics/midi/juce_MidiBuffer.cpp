@@ -68,30 +68,80 @@ namespace MidiBufferHelpers
 
         return size;
     }
+
+    // Returns the end of the last complete event that fits within the first maxBytes
+    static const uint8* findLastEventEndWithin (const uint8* d, const uint8* const end, const size_t maxBytes) noexcept
+    {
+        const uint8* const limit = d + maxBytes;
+
+        while (d < end)
+        {
+            const uint8* const next = d + getEventTotalSize (d);
+
+            if (next > limit)
+                break;
+
+            d = next;
+        }
+
+        return d;
+    }
 }
 
 //==============================================================================
 MidiBuffer::MidiBuffer() noexcept
-    : bytesUsed (0)
+    : bytesUsed (0),
+      fixedCapacity (false),
+      overflowed (false)
 {
 }
 
 MidiBuffer::MidiBuffer (const MidiMessage& message) noexcept
-    : bytesUsed (0)
+    : bytesUsed (0),
+      fixedCapacity (false),
+      overflowed (false)
 {
     addEvent (message, 0);
 }
 
 MidiBuffer::MidiBuffer (const MidiBuffer& other) noexcept
     : data (other.data),
-      bytesUsed (other.bytesUsed)
+      bytesUsed (other.bytesUsed),
+      fixedCapacity (other.fixedCapacity),
+      overflowed (other.overflowed)
 {
 }
 
 MidiBuffer& MidiBuffer::operator= (const MidiBuffer& other) noexcept
 {
-    bytesUsed = other.bytesUsed;
-    data = other.data;
+    if (this != &other)
+    {
+        // (copy into the existing block rather than replacing it, so that copying
+        // between buffers of the same size never needs to reallocate)
+        size_t numBytes = (size_t) other.bytesUsed;
+        overflowed = other.overflowed;
+
+        if (fixedCapacity)
+        {
+            if (numBytes > data.getSize())
+            {
+                numBytes = (size_t) (MidiBufferHelpers::findLastEventEndWithin (other.getData(),
+                                                                                 other.getData() + other.bytesUsed,
+                                                                                 data.getSize())
+                                       - other.getData());
+                overflowed = true;
+            }
+        }
+        else
+        {
+            data.ensureSize (numBytes);
+        }
+
+        if (numBytes > 0)
+            memcpy (getData(), other.getData(), numBytes);
+
+        bytesUsed = (int) numBytes;
+    }
 
     return *this;
 }
@@ -100,6 +150,8 @@ void MidiBuffer::swapWith (MidiBuffer& other) noexcept
 {
     data.swapWith (other.data);
     std::swap (bytesUsed, other.bytesUsed);
+    std::swap (fixedCapacity, other.fixedCapacity);
+    std::swap (overflowed, other.overflowed);
 }
 
 MidiBuffer::~MidiBuffer()
@@ -114,6 +166,7 @@ inline uint8* MidiBuffer::getData() const noexcept
 void MidiBuffer::clear() noexcept
 {
     bytesUsed = 0;
+    overflowed = false;
 }
 
 void MidiBuffer::clear (const int startSample, const int numSamples)
@@ -132,19 +185,36 @@ void MidiBuffer::clear (const int startSample, const int numSamples)
     }
 }
 
-void MidiBuffer::addEvent (const MidiMessage& m, const int sampleNumber)
+bool MidiBuffer::addEvent (const MidiMessage& m, const int sampleNumber)
 {
-    addEvent (m.getRawData(), m.getRawDataSize(), sampleNumber);
+    return addEvent (m.getRawData(), m.getRawDataSize(), sampleNumber);
 }
 
-void MidiBuffer::addEvent (const void* const newData, const int maxBytes, const int sampleNumber)
+bool MidiBuffer::ensureSpaceFor (const size_t numExtraBytes)
+{
+    const size_t spaceNeeded = (size_t) bytesUsed + numExtraBytes;
+
+    if (spaceNeeded <= data.getSize())
+        return true;
+
+    if (fixedCapacity)
+    {
+        overflowed = true;
+        return false;
+    }
+
+    data.ensureSize ((spaceNeeded + spaceNeeded / 2 + 8) & ~(size_t) 7);
+    return true;
+}
+
+bool MidiBuffer::addEvent (const void* const newData, const int maxBytes, const int sampleNumber)
 {
     const int numBytes = MidiBufferHelpers::findActualEventLength (static_cast <const uint8*> (newData), maxBytes);
 
     if (numBytes > 0)
     {
-        size_t spaceNeeded = (size_t) bytesUsed + (size_t) numBytes + sizeof (int) + sizeof (uint16);
-        data.ensureSize ((spaceNeeded + spaceNeeded / 2 + 8) & ~(size_t) 7);
+        if (! ensureSpaceFor ((size_t) numBytes + sizeof (int) + sizeof (uint16)))
+            return false;
 
         uint8* d = findEventAfter (getData(), sampleNumber);
         const int bytesToMove = bytesUsed - (int) (d - getData());
@@ -161,24 +231,73 @@ void MidiBuffer::addEvent (const void* const newData, const int maxBytes, const
 
         bytesUsed += sizeof (int) + sizeof (uint16) + (size_t) numBytes;
     }
+
+    return true;
 }
 
-void MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
+bool MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
                             const int startSample,
                             const int numSamples,
                             const int sampleDeltaToAdd)
 {
-    Iterator i (otherBuffer);
-    i.setNextSamplePosition (startSample);
+    // You can't add a buffer's events to itself!
+    jassert (&otherBuffer != this);
+
+    if (&otherBuffer == this)
+        return false;
+
+    uint8* const srcStart = otherBuffer.findEventAfter (otherBuffer.getData(), startSample - 1);
+    const uint8* srcEnd = numSamples < 0 ? otherBuffer.getData() + otherBuffer.bytesUsed
+                                         : otherBuffer.findEventAfter (srcStart, startSample + numSamples - 1);
+    bool allAdded = true;
+
+    if (! ensureSpaceFor ((size_t) (srcEnd - srcStart)))
+    {
+        srcEnd = MidiBufferHelpers::findLastEventEndWithin (srcStart, srcEnd, data.getSize() - (size_t) bytesUsed);
+        allAdded = false;
+    }
 
-    const uint8* eventData;
-    int eventSize, position;
+    const int bytesToAdd = (int) (srcEnd - srcStart);
 
-    while (i.getNextEvent (eventData, eventSize, position)
-            && (position < startSample + numSamples || numSamples < 0))
+    if (bytesToAdd > 0)
     {
-        addEvent (eventData, eventSize, position + sampleDeltaToAdd);
+        // Move the existing events up out of the way, then merge both lists forwards into
+        // the start of the block. The write position can never overtake the read position
+        // of the existing events, so this doesn't need any temporary storage.
+        uint8* dest = getData();
+        memmove (dest + bytesToAdd, dest, (size_t) bytesUsed);
+
+        const uint8* existing = dest + bytesToAdd;
+        const uint8* const existingEnd = existing + bytesUsed;
+        const uint8* src = srcStart;
+
+        while (src < srcEnd)
+        {
+            const int time = MidiBufferHelpers::getEventTime (src) + sampleDeltaToAdd;
+
+            const uint8* runEnd = existing;
+            while (runEnd < existingEnd && MidiBufferHelpers::getEventTime (runEnd) <= time)
+                runEnd += MidiBufferHelpers::getEventTotalSize (runEnd);
+
+            if (runEnd > existing)
+            {
+                memmove (dest, existing, (size_t) (runEnd - existing));
+                dest += runEnd - existing;
+                existing = runEnd;
+            }
+
+            const int eventSize = MidiBufferHelpers::getEventTotalSize (src);
+            memcpy (dest, src, (size_t) eventSize);
+            *reinterpret_cast <int*> (dest) = time;
+            dest += eventSize;
+            src += eventSize;
+        }
+
+        // (any remaining existing events are now already in the right place)
+        bytesUsed += bytesToAdd;
     }
+
+    return allAdded;
 }
 
 void MidiBuffer::ensureSize (size_t minimumNumBytes)
@@ -186,6 +305,23 @@ void MidiBuffer::ensureSize (size_t minimumNumBytes)
     data.ensureSize (minimumNumBytes);
 }
 
+void MidiBuffer::setFixedCapacity (const size_t numBytes)
+{
+    fixedCapacity = numBytes > 0;
+
+    if (fixedCapacity)
+    {
+        if ((size_t) bytesUsed > numBytes)
+        {
+            bytesUsed = (int) (MidiBufferHelpers::findLastEventEndWithin (getData(), getData() + bytesUsed, numBytes)
+                                 - getData());
+            overflowed = true;
+        }
+
+        data.setSize (numBytes);
+    }
+}
+
 bool MidiBuffer::isEmpty() const noexcept
 {
     return bytesUsed == 0;
@@ -288,3 +424,113 @@ bool MidiBuffer::Iterator::getNextEvent (MidiMessage& result, int& samplePositio
 
     return true;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class MidiBufferTests  : public UnitTest
+{
+public:
+    MidiBufferTests() : UnitTest ("MidiBuffer") {}
+
+    static void fillRandomly (MidiBuffer& buffer, Random& r, int numEvents)
+    {
+        for (int i = 0; i < numEvents; ++i)
+            buffer.addEvent (MidiMessage::controllerEvent (1 + r.nextInt (16), r.nextInt (128), r.nextInt (128)),
+                             r.nextInt (64));
+    }
+
+    static bool buffersMatch (const MidiBuffer& b1, const MidiBuffer& b2)
+    {
+        MidiBuffer::Iterator i1 (b1), i2 (b2);
+        const uint8 *d1, *d2;
+        int size1, size2, pos1, pos2;
+
+        for (;;)
+        {
+            const bool more1 = i1.getNextEvent (d1, size1, pos1);
+            const bool more2 = i2.getNextEvent (d2, size2, pos2);
+
+            if (more1 != more2)
+                return false;
+
+            if (! more1)
+                return true;
+
+            if (pos1 != pos2 || size1 != size2 || memcmp (d1, d2, (size_t) size1) != 0)
+                return false;
+        }
+    }
+
+    void runTest()
+    {
+        beginTest ("Merging");
+
+        Random r;
+
+        for (int n = 0; n < 50; ++n)
+        {
+            MidiBuffer dest, source;
+            fillRandomly (dest, r, r.nextInt (20));
+            fillRandomly (source, r, r.nextInt (20));
+
+            const int start = r.nextInt (64) - 8;
+            const int num = r.nextInt (80) - 8;
+            const int delta = r.nextInt (32) - 8;
+
+            MidiBuffer expected (dest);
+            MidiBuffer::Iterator i (source);
+            i.setNextSamplePosition (start);
+            const uint8* data;
+            int size, pos;
+
+            while (i.getNextEvent (data, size, pos) && (pos < start + num || num < 0))
+                expected.addEvent (data, size, pos + delta);
+
+            expect (dest.addEvents (source, start, num, delta));
+            expect (buffersMatch (dest, expected));
+        }
+
+        beginTest ("Fixed capacity");
+
+        MidiBuffer source;
+        fillRandomly (source, r, 30);
+
+        MidiBuffer fixed;
+        fixed.setFixedCapacity (90);
+        expect (fixed.isFixedCapacity());
+        expectEquals ((int) fixed.getCapacity(), 90);
+
+        int numAdded = 0;
+        while (fixed.addEvent (MidiMessage::controllerEvent (1, 7, 100), numAdded))
+            ++numAdded;
+
+        expectEquals (numAdded, 10);
+        expect (fixed.hasOverflowed());
+        fixed.clear();
+        expect (! fixed.hasOverflowed());
+
+        expect (! fixed.addEvents (source, 0, -1, 0));
+        expectEquals (fixed.getNumEvents(), 10);
+        expect (fixed.hasOverflowed());
+
+        fixed = source;
+        expectEquals (fixed.getNumEvents(), 10);
+        expectEquals ((int) fixed.getCapacity(), 90);
+
+        MidiBuffer small;
+        fillRandomly (small, r, 5);
+        fixed = small;
+        expect (! fixed.hasOverflowed());
+        expect (buffersMatch (fixed, small));
+        expectEquals ((int) fixed.getCapacity(), 90);
+
+        fixed.setFixedCapacity (0);
+        expect (fixed.addEvents (source, 0, -1, 0));
+        expectEquals (fixed.getNumEvents(), 35);
+    }
+};
+
+static MidiBufferTests midiBufferTests;
+
+#endif
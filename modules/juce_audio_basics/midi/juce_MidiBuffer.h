@@ -63,7 +63,9 @@ public:
     ~MidiBuffer();
 
     //==============================================================================
-    /** Removes all events from the buffer. */
+    /** Removes all events from the buffer.
+        This also resets the flag returned by hasOverflowed().
+    */
     void clear() noexcept;
 
     /** Removes all events between two times from the buffer.
@@ -97,8 +99,12 @@ public:
         already in the buffer, the new event will be placed after the existing ones.
 
         To retrieve events, use a MidiBuffer::Iterator object
+
+        @returns    false if the buffer has a fixed capacity and there wasn't enough
+                    room left in it for the event, in which case it won't have been added
+        @see setFixedCapacity
     */
-    void addEvent (const MidiMessage& midiMessage, int sampleNumber);
+    bool addEvent (const MidiMessage& midiMessage, int sampleNumber);
 
     /** Adds an event to the buffer from raw midi data.
 
@@ -115,13 +121,24 @@ public:
         add an event at all.
 
         To retrieve events, use a MidiBuffer::Iterator object
+
+        @returns    false if the buffer has a fixed capacity and there wasn't enough
+                    room left in it for the event, in which case it won't have been added
+        @see setFixedCapacity
     */
-    void addEvent (const void* rawMidiData,
+    bool addEvent (const void* rawMidiData,
                    int maxBytesOfMidiData,
                    int sampleNumber);
 
     /** Adds some events from another buffer to this one.
 
+        The two sets of events are merged in a single pass, so this is much quicker than
+        adding the events one at a time. If the buffer has a fixed capacity and the new
+        events don't all fit, as many as possible are added (in time order), and the
+        method returns false.
+
+        The buffer you pass in must not be this one.
+
         @param otherBuffer          the buffer containing the events you want to add
         @param startSample          the lowest sample number in the source buffer for which
                                     events should be added. Any source events whose timestamp is
@@ -133,8 +150,10 @@ public:
                                     startSample will be taken.
         @param sampleDeltaToAdd     a value which will be added to the source timestamps of the events
                                     that are added to this buffer
+        @returns                    false if some of the events were dropped because
+                                    the buffer's fixed capacity was exhausted
     */
-    void addEvents (const MidiBuffer& otherBuffer,
+    bool addEvents (const MidiBuffer& otherBuffer,
                     int startSample,
                     int numSamples,
                     int sampleDeltaToAdd);
@@ -165,6 +184,38 @@ public:
     */
     void ensureSize (size_t minimumNumBytes);
 
+    /** Gives the buffer a fixed block of memory that it'll use for all its events.
+
+        After calling this, the buffer will never allocate or free any memory when events
+        are added to it, or when another buffer is copied into it, so it's safe to use on
+        the audio thread. If an event won't fit into the space that's left, it'll be
+        dropped, and hasOverflowed() will return true until the buffer is next cleared.
+
+        The size includes a 6-byte header for each event, so e.g. 3-byte controller
+        messages take up 9 bytes each.
+
+        Calling this with a size of 0 returns the buffer to its normal behaviour, where
+        it grows whenever it needs more space.
+
+        @see hasOverflowed, isFixedCapacity
+    */
+    void setFixedCapacity (size_t numBytes);
+
+    /** Returns true if setFixedCapacity() has been used to stop the buffer from
+        reallocating its storage.
+    */
+    bool isFixedCapacity() const noexcept                       { return fixedCapacity; }
+
+    /** Returns the number of bytes of storage that the buffer currently has allocated. */
+    size_t getCapacity() const noexcept                         { return data.getSize(); }
+
+    /** Returns true if any events have been dropped because a fixed-capacity buffer
+        was full.
+        The flag is reset when clear() is called.
+        @see setFixedCapacity
+    */
+    bool hasOverflowed() const noexcept                         { return overflowed; }
+
     //==============================================================================
     /**
         Used to iterate through the events in a MidiBuffer.
@@ -230,9 +281,11 @@ private:
     friend class MidiBuffer::Iterator;
     MemoryBlock data;
     int bytesUsed;
+    bool fixedCapacity, overflowed;
 
     uint8* getData() const noexcept;
     uint8* findEventAfter (uint8*, int samplePosition) const noexcept;
+    bool ensureSpaceFor (size_t numExtraBytes);
 
     JUCE_LEAK_DETECTOR (MidiBuffer)
 };
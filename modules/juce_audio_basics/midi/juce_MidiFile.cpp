@@ -321,8 +321,11 @@ void MidiFile::readNextTrack (const uint8* data, int size)
     MidiFileHelpers::Sorter sorter;
     result.list.sort (sorter, true);
 
-    addTrack (result);
-    tracks.getLast()->updateMatchedPairs();
+    result.updateMatchedPairs();
+
+    MidiMessageSequence* const newTrack = new MidiMessageSequence();
+    newTrack->swapWith (result);
+    tracks.add (newTrack);
 }
 
 //==============================================================================
@@ -0,0 +1,442 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+class MidiFileReader::TrackReader
+{
+public:
+    TrackReader (const int64 start, const int64 length, const int bufferSize)
+        : chunkStart (start), chunkLength (length),
+          buffer ((size_t) bufferSize), bufferCapacity (bufferSize)
+    {
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        bufferStart = 0;
+        numInBuffer = 0;
+        bufferPos = 0;
+        nextTick = 0;
+        lastStatusByte = 0;
+        finished = false;
+    }
+
+    int64 getNumBytesLeft() const noexcept
+    {
+        return chunkLength - (bufferStart + bufferPos);
+    }
+
+    bool readByte (InputStream& in, uint8& result)
+    {
+        if (bufferPos >= numInBuffer && ! refill (in))
+            return false;
+
+        result = buffer [bufferPos++];
+        return true;
+    }
+
+    bool readBytes (InputStream& in, uint8* dest, int numBytes)
+    {
+        while (numBytes > 0)
+        {
+            if (bufferPos >= numInBuffer && ! refill (in))
+                return false;
+
+            const int num = jmin (numBytes, numInBuffer - bufferPos);
+            memcpy (dest, buffer + bufferPos, (size_t) num);
+            bufferPos += num;
+            dest += num;
+            numBytes -= num;
+        }
+
+        return true;
+    }
+
+    bool readVariableLengthVal (InputStream& in, int& result)
+    {
+        result = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            uint8 byte;
+
+            if (! readByte (in, byte))
+                return false;
+
+            result = (result << 7) | (byte & 0x7f);
+
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    /** Reads the delta-time of the next event, or marks the track as finished. */
+    void prepareNextEvent (InputStream& in)
+    {
+        int delta;
+
+        if (getNumBytesLeft() > 0 && readVariableLengthVal (in, delta))
+            nextTick += delta;
+        else
+            finished = true;
+    }
+
+    const int64 chunkStart, chunkLength;
+    int nextTick;
+    uint8 lastStatusByte;
+    bool finished;
+
+private:
+    HeapBlock<uint8> buffer;
+    const int bufferCapacity;
+    int64 bufferStart;
+    int numInBuffer, bufferPos;
+
+    bool refill (InputStream& in)
+    {
+        bufferStart += numInBuffer;
+        bufferPos = 0;
+        numInBuffer = 0;
+
+        const int64 bytesLeft = chunkLength - bufferStart;
+
+        if (bytesLeft <= 0 || ! in.setPosition (chunkStart + bufferStart))
+            return false;
+
+        numInBuffer = jmax (0, in.read (buffer, (int) jmin ((int64) bufferCapacity, bytesLeft)));
+        return numInBuffer > 0;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (TrackReader)
+};
+
+//==============================================================================
+MidiFileReader::MidiFileReader (InputStream& sourceStream, const int bufferSizePerTrack)
+    : source (sourceStream),
+      eventDataSize (0),
+      bufferSize (jmax (16, bufferSizePerTrack)),
+      timeFormat (0),
+      valid (false)
+{
+    ensureEventDataSize (256);
+    findTracks();
+}
+
+MidiFileReader::~MidiFileReader()
+{
+}
+
+int MidiFileReader::getNumTracks() const noexcept
+{
+    return tracks.size();
+}
+
+void MidiFileReader::findTracks()
+{
+    // (the header is tiny, so it's read into a block and parsed the same way as MidiFile does)
+    const int64 startPos = source.getPosition();
+    uint8 header [64] = { 0 };
+    source.read (header, sizeof (header));
+
+    const uint8* d = header;
+    short fileType, expectedTracks;
+
+    if (! MidiFileHelpers::parseMidiHeader (d, timeFormat, fileType, expectedTracks))
+        return;
+
+    valid = true;
+    int64 pos = startPos + (d - header);
+
+    while (tracks.size() < expectedTracks && source.setPosition (pos))
+    {
+        uint8 chunkHeader [8];
+
+        if (source.read (chunkHeader, 8) != 8)
+            break;
+
+        const int chunkType = (int) ByteOrder::bigEndianInt (chunkHeader);
+        const int chunkSize = (int) ByteOrder::bigEndianInt (chunkHeader + 4);
+
+        if (chunkSize <= 0)
+            break;
+
+        if (chunkType == (int) ByteOrder::bigEndianInt ("MTrk"))
+            tracks.add (new TrackReader (pos + 8, chunkSize, bufferSize));
+
+        pos += chunkSize + 8;
+    }
+
+    reset();
+}
+
+void MidiFileReader::reset()
+{
+    for (int i = 0; i < tracks.size(); ++i)
+    {
+        TrackReader& t = *tracks.getUnchecked(i);
+        t.reset();
+        t.prepareNextEvent (source);
+    }
+}
+
+void MidiFileReader::ensureEventDataSize (const int numBytes)
+{
+    if (numBytes > eventDataSize)
+    {
+        eventDataSize = jmax (numBytes, eventDataSize * 2);
+        eventData.realloc ((size_t) eventDataSize);
+    }
+}
+
+bool MidiFileReader::readEventData (TrackReader& t, int& numBytes)
+{
+    uint8 statusByte;
+
+    if (! t.readByte (source, statusByte))
+        return false;
+
+    int numDataBytesRead = 0;
+
+    if (statusByte < 0x80)
+    {
+        // running status: this byte is actually the first data byte
+        if (t.lastStatusByte < 0x80)
+            return false;
+
+        eventData[1] = statusByte;
+        statusByte = t.lastStatusByte;
+        numDataBytesRead = 1;
+    }
+
+    eventData[0] = statusByte;
+
+    if (statusByte == 0xff)
+    {
+        // meta-event: keep the type and length bytes, as MidiMessage does
+        uint8 type;
+
+        if (! t.readByte (source, type))
+            return false;
+
+        eventData[1] = type;
+        numBytes = 2;
+
+        int length = 0;
+
+        for (;;)
+        {
+            uint8 byte;
+
+            if (numBytes >= 6 || ! t.readByte (source, byte))
+                return false;
+
+            eventData [numBytes++] = byte;
+            length = (length << 7) | (byte & 0x7f);
+
+            if ((byte & 0x80) == 0)
+                break;
+        }
+
+        if (length > t.getNumBytesLeft())
+            return false;
+
+        ensureEventDataSize (numBytes + length);
+
+        if (! t.readBytes (source, eventData + numBytes, length))
+            return false;
+
+        numBytes += length;
+    }
+    else if (statusByte == 0xf0 || statusByte == 0xf7)
+    {
+        // sysex or escaped data: drop the length bytes
+        int length;
+
+        if (! t.readVariableLengthVal (source, length)
+             || length > t.getNumBytesLeft())
+            return false;
+
+        ensureEventDataSize (length + 1);
+
+        if (! t.readBytes (source, eventData + 1, length))
+            return false;
+
+        numBytes = length + 1;
+    }
+    else
+    {
+        numBytes = MidiMessage::getMessageLengthFromFirstByte (statusByte);
+
+        if (! t.readBytes (source, eventData + 1 + numDataBytesRead, numBytes - 1 - numDataBytesRead))
+            return false;
+
+        if (statusByte < 0xf0)
+            t.lastStatusByte = statusByte;
+    }
+
+    return true;
+}
+
+bool MidiFileReader::readNextEvent (const uint8*& midiData, int& numBytes, int& tick, int& trackIndex)
+{
+    for (;;)
+    {
+        TrackReader* next = nullptr;
+
+        for (int i = 0; i < tracks.size(); ++i)
+        {
+            TrackReader* const t = tracks.getUnchecked(i);
+
+            if (! t->finished && (next == nullptr || t->nextTick < next->nextTick))
+            {
+                next = t;
+                trackIndex = i;
+            }
+        }
+
+        if (next == nullptr)
+            return false;
+
+        tick = next->nextTick;
+
+        if (! readEventData (*next, numBytes))
+        {
+            next->finished = true;  // (a truncated or corrupt track)
+            continue;
+        }
+
+        if (eventData[0] == 0xff && numBytes > 1 && eventData[1] == 0x2f)
+        {
+            next->finished = true;
+            continue;
+        }
+
+        next->prepareNextEvent (source);
+        midiData = eventData;
+        return true;
+    }
+}
+
+bool MidiFileReader::readNextEvent (MidiMessage& result, int& trackIndex)
+{
+    const uint8* data;
+    int numBytes, tick;
+
+    if (! readNextEvent (data, numBytes, tick, trackIndex))
+        return false;
+
+    result = MidiMessage (data, numBytes, (double) tick);
+    return true;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class MidiFileReaderTests  : public UnitTest
+{
+public:
+    MidiFileReaderTests() : UnitTest ("MidiFileReader") {}
+
+    void runTest()
+    {
+        beginTest ("Round trip");
+
+        MemoryOutputStream out;
+
+        {
+            MidiFileWriter writer (out, 96);
+
+            writer.startTrack();
+            writer.writeEvent (MidiMessage::tempoMetaEvent (500000), 0);
+            writer.writeEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 0);
+            writer.writeEvent (MidiMessage::noteOn (1, 64, (uint8) 100), 10);   // (running status)
+            writer.writeEvent (MidiMessage::noteOff (1, 60), 50);
+
+            const uint8 sysex[] = { 0xf0, 0x7e, 0x01, 0x02, 0xf7 };
+            writer.startTrack();
+            writer.writeEvent (sysex, sizeof (sysex), 5);
+            writer.writeEvent (MidiMessage::controllerEvent (2, 7, 64), 10);
+            writer.writeEvent (MidiMessage::controllerEvent (2, 7, 32), 20);
+
+            expect (writer.finish());
+            expectEquals (writer.getNumTracks(), 2);
+        }
+
+        MemoryInputStream in (out.getData(), out.getDataSize(), false);
+        MidiFileReader reader (in, 16);
+
+        expect (reader.isValid());
+        expectEquals ((int) reader.getTimeFormat(), 96);
+        expectEquals (reader.getNumTracks(), 2);
+
+        const int expectedTicks[]  = { 0, 0, 5, 10, 10, 20, 50 };
+        const int expectedTracks[] = { 0, 0, 1, 0, 1, 1, 0 };
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            MidiMessage m;
+            int track, numEvents = 0;
+
+            while (reader.readNextEvent (m, track))
+            {
+                if (numEvents < numElementsInArray (expectedTicks))
+                {
+                    expectEquals ((int) m.getTimeStamp(), expectedTicks [numEvents]);
+                    expectEquals (track, expectedTracks [numEvents]);
+                }
+
+                if (numEvents == 2)
+                {
+                    expect (m.isSysEx());
+                    expectEquals (m.getSysExDataSize(), 3);
+                }
+
+                if (numEvents == 3)
+                    expect (m.isNoteOn() && m.getNoteNumber() == 64);
+
+                ++numEvents;
+            }
+
+            expectEquals (numEvents, numElementsInArray (expectedTicks));
+            reader.reset();
+        }
+
+        beginTest ("Matches MidiFile");
+
+        MidiFile file;
+        MemoryInputStream in2 (out.getData(), out.getDataSize(), false);
+        expect (file.readFrom (in2));
+        expectEquals (file.getNumTracks(), 2);
+        expectEquals (file.getTrack (0)->getNumEvents(), 5);   // (including the end-of-track event)
+        expectEquals (file.getTrack (1)->getNumEvents(), 4);
+        expect (file.getTrack (0)->getEventPointer (2)->message.isNoteOn());
+    }
+};
+
+static MidiFileReaderTests midiFileReaderTests;
+
+#endif
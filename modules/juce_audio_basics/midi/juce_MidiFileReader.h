@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_MIDIFILEREADER_JUCEHEADER__
+#define __JUCE_MIDIFILEREADER_JUCEHEADER__
+
+#include "juce_MidiMessage.h"
+
+
+//==============================================================================
+/**
+    Reads the events from a standard midi file stream one at a time.
+
+    Unlike MidiFile::readFrom(), this doesn't load the whole file into memory or
+    build a MidiMessageSequence for each track. It just keeps a small buffer for
+    each track, and merges the tracks as it goes, so that readNextEvent() returns
+    the events from all of them in time order.
+
+    The stream must be seekable (e.g. a FileInputStream or MemoryInputStream),
+    because the tracks are read from different parts of it in turn, and it has to
+    stay valid for as long as the reader is being used.
+
+    e.g. @code
+    FileInputStream in (midiFile);
+    MidiFileReader reader (in);
+
+    const uint8* data;
+    int numBytes, tick, track;
+
+    while (reader.readNextEvent (data, numBytes, tick, track))
+        processEvent (data, numBytes, tick);
+    @endcode
+
+    @see MidiFileWriter, MidiFile
+*/
+class JUCE_API  MidiFileReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader for a midi file stream.
+
+        This parses the file's header and finds the start of each track, but doesn't
+        read any events yet. Use isValid() to check that the header was ok.
+
+        @param sourceStream         the stream to read from - this must remain valid for
+                                    the lifetime of the reader
+        @param bufferSizePerTrack   the number of bytes of each track that are read from
+                                    the stream at a time
+    */
+    MidiFileReader (InputStream& sourceStream, int bufferSizePerTrack = 4096);
+
+    /** Destructor. */
+    ~MidiFileReader();
+
+    //==============================================================================
+    /** Returns true if the stream started with a valid midi file header. */
+    bool isValid() const noexcept                           { return valid; }
+
+    /** Returns the raw time format code from the file's header.
+        @see MidiFile::getTimeFormat
+    */
+    short getTimeFormat() const noexcept                    { return timeFormat; }
+
+    /** Returns the number of tracks that were found in the file. */
+    int getNumTracks() const noexcept;
+
+    //==============================================================================
+    /** Reads the next event from whichever track has the earliest one.
+
+        Events with the same time are returned in track order. Running status is
+        expanded, so the data always begins with a status byte. Sysex messages come
+        back as 0xf0 followed by their data (without the length bytes), and meta-events
+        are returned in the same format that MidiMessage uses. The end-of-track meta
+        events aren't returned.
+
+        @param midiData     on return, this points to the event's data. This is only
+                            valid until the next call to readNextEvent()
+        @param numBytes     on return, the number of bytes of data in the event
+        @param tick         on return, the event's time in midi ticks from the start of
+                            the file
+        @param trackIndex   on return, the index of the track the event came from
+        @returns            false when there are no more events to read
+    */
+    bool readNextEvent (const uint8*& midiData, int& numBytes, int& tick, int& trackIndex);
+
+    /** Reads the next event as a MidiMessage, with its timestamp set to the time in ticks.
+
+        This is easier to use than the other version, but may need to allocate memory
+        for long messages.
+
+        @returns false when there are no more events to read
+        @see readNextEvent
+    */
+    bool readNextEvent (MidiMessage& result, int& trackIndex);
+
+    /** Moves all the tracks back to their start, so the file can be read again. */
+    void reset();
+
+private:
+    //==============================================================================
+    class TrackReader;
+
+    InputStream& source;
+    OwnedArray<TrackReader> tracks;
+    HeapBlock<uint8> eventData;
+    int eventDataSize, bufferSize;
+    short timeFormat;
+    bool valid;
+
+    void findTracks();
+    bool readEventData (TrackReader&, int& numBytes);
+    void ensureEventDataSize (int);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiFileReader)
+};
+
+
+#endif   // __JUCE_MIDIFILEREADER_JUCEHEADER__
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+MidiFileWriter::MidiFileWriter (OutputStream& destStream, const short timeFormat)
+    : out (destStream),
+      headerPosition (destStream.getPosition()),
+      trackLengthPosition (0),
+      numTracks (0),
+      lastTick (0),
+      lastStatusByte (0),
+      isWritingTrack (false),
+      isFinished (false),
+      ok (true)
+{
+    out.writeIntBigEndian ((int) ByteOrder::bigEndianInt ("MThd"));
+    out.writeIntBigEndian (6);
+    out.writeShortBigEndian (1); // type
+    out.writeShortBigEndian (0); // (the number of tracks gets filled in by finish())
+    out.writeShortBigEndian (timeFormat);
+}
+
+MidiFileWriter::~MidiFileWriter()
+{
+    finish();
+}
+
+//==============================================================================
+void MidiFileWriter::startTrack()
+{
+    jassert (! isFinished); // can't add any more tracks once the file's been finished!
+
+    if (isFinished)
+        return;
+
+    endTrack();
+
+    out.writeIntBigEndian ((int) ByteOrder::bigEndianInt ("MTrk"));
+    trackLengthPosition = out.getPosition();
+    out.writeIntBigEndian (0);
+
+    ++numTracks;
+    lastTick = 0;
+    lastStatusByte = 0;
+    isWritingTrack = true;
+}
+
+bool MidiFileWriter::writeEvent (const uint8* data, int dataSize, const int tick)
+{
+    jassert (isWritingTrack); // you need to call startTrack() before adding events
+    jassert (tick >= lastTick); // events have to be written in time order
+
+    if (! isWritingTrack || dataSize <= 0)
+        return false;
+
+    if (dataSize > 1 && data[0] == 0xff && data[1] == 0x2f)
+        return true;  // (endTrack() adds this)
+
+    const int delta = jmax (0, tick - lastTick);
+    MidiFileHelpers::writeVariableLengthInt (out, (uint32) delta);
+    lastTick += delta;
+
+    const uint8 statusByte = data[0];
+
+    if (statusByte == lastStatusByte
+         && (statusByte & 0xf0) != 0xf0
+         && dataSize > 1)
+    {
+        ++data;
+        --dataSize;
+    }
+    else if (statusByte == 0xf0 || statusByte == 0xf7)
+    {
+        out.writeByte ((char) statusByte);
+
+        ++data;
+        --dataSize;
+
+        MidiFileHelpers::writeVariableLengthInt (out, (uint32) dataSize);
+    }
+
+    out.write (data, (size_t) dataSize);
+    lastStatusByte = statusByte;
+    return true;
+}
+
+bool MidiFileWriter::writeEvent (const MidiMessage& message, const int tick)
+{
+    return writeEvent (message.getRawData(), message.getRawDataSize(), tick);
+}
+
+void MidiFileWriter::endTrack()
+{
+    if (isWritingTrack)
+    {
+        isWritingTrack = false;
+
+        out.writeByte (0); // (tick delta)
+        const MidiMessage m (MidiMessage::endOfTrack());
+        out.write (m.getRawData(), (size_t) m.getRawDataSize());
+
+        const int64 trackLength = out.getPosition() - (trackLengthPosition + 4);
+        ok = writeLengthAt (trackLengthPosition, (int) trackLength, false) && ok;
+    }
+}
+
+bool MidiFileWriter::finish()
+{
+    if (! isFinished)
+    {
+        endTrack();
+        isFinished = true;
+
+        ok = writeLengthAt (headerPosition + 10, numTracks, true) && ok;
+        out.flush();
+    }
+
+    return ok;
+}
+
+bool MidiFileWriter::writeLengthAt (const int64 position, const int value, const bool isShort)
+{
+    const int64 endPosition = out.getPosition();
+
+    if (! out.setPosition (position))
+        return false;
+
+    if (isShort)
+        out.writeShortBigEndian ((short) value);
+    else
+        out.writeIntBigEndian (value);
+
+    return out.setPosition (endPosition);
+}
@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_MIDIFILEWRITER_JUCEHEADER__
+#define __JUCE_MIDIFILEWRITER_JUCEHEADER__
+
+#include "juce_MidiMessage.h"
+
+
+//==============================================================================
+/**
+    Writes a standard midi file directly to a stream, one event at a time.
+
+    This avoids having to build a MidiFile full of MidiMessageSequence objects
+    first. Each track is written straight to the stream as its events are added,
+    and its length is filled in when it's finished, so the stream must be able to
+    seek backwards (e.g. a FileOutputStream or MemoryOutputStream).
+
+    e.g. @code
+    MidiFileWriter writer (out, 960);
+
+    writer.startTrack();
+    writer.writeEvent (MidiMessage::noteOn (1, 60, 0.8f), 0);
+    writer.writeEvent (MidiMessage::noteOff (1, 60), 960);
+    writer.endTrack();
+
+    writer.finish();
+    @endcode
+
+    @see MidiFileReader, MidiFile
+*/
+class JUCE_API  MidiFileWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer and writes the file header to the stream.
+
+        @param destStream   the stream to write to - this must remain valid until
+                            finish() has been called, or the writer is deleted
+        @param timeFormat   the raw time format code for the header - see
+                            MidiFile::getTimeFormat()
+    */
+    MidiFileWriter (OutputStream& destStream, short timeFormat);
+
+    /** Destructor.
+        This will call finish() if it hasn't already been called.
+    */
+    ~MidiFileWriter();
+
+    //==============================================================================
+    /** Begins a new track.
+        If a track is already being written, it'll be ended first.
+    */
+    void startTrack();
+
+    /** Writes an event to the current track.
+
+        Events must be written in time order within each track. Running status is
+        used where possible, and sysex messages have their length bytes added. Any
+        end-of-track meta-events are ignored, because endTrack() writes one itself.
+
+        @param midiData     the raw midi data, in the same format that MidiMessage uses
+        @param numBytes     the number of bytes of data
+        @param tick         the event's time, in ticks from the start of the track
+        @returns            false if no track has been started
+    */
+    bool writeEvent (const uint8* midiData, int numBytes, int tick);
+
+    /** Writes an event to the current track, at the given time in ticks.
+        @see writeEvent
+    */
+    bool writeEvent (const MidiMessage& message, int tick);
+
+    /** Finishes the current track, writing its end-of-track event and length. */
+    void endTrack();
+
+    /** Ends any track in progress, fills in the number of tracks in the header, and
+        flushes the stream.
+        No more tracks can be written after this.
+        @returns false if the stream couldn't be rewound to update the header
+    */
+    bool finish();
+
+    /** Returns the number of tracks that have been started so far. */
+    int getNumTracks() const noexcept                       { return numTracks; }
+
+private:
+    //==============================================================================
+    OutputStream& out;
+    int64 headerPosition, trackLengthPosition;
+    int numTracks, lastTick;
+    uint8 lastStatusByte;
+    bool isWritingTrack, isFinished, ok;
+
+    bool writeLengthAt (int64 position, int value, bool isShort);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiFileWriter)
+};
+
+
+#endif   // __JUCE_MIDIFILEWRITER_JUCEHEADER__
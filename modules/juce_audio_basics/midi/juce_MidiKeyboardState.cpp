@@ -23,9 +23,42 @@
   ==============================================================================
 */
 
+namespace MidiKeyboardStateHelpers
+{
+    // sets or clears some bits, returning the previous value
+    static int setBits (Atomic<int>& value, const int bitsToSet) noexcept
+    {
+        for (;;)
+        {
+            const int oldValue = value.get();
+
+            if (value.compareAndSetBool (oldValue | bitsToSet, oldValue))
+                return oldValue;
+        }
+    }
+
+    static int clearBits (Atomic<int>& value, const int bitsToClear) noexcept
+    {
+        for (;;)
+        {
+            const int oldValue = value.get();
+
+            if (value.compareAndSetBool (oldValue & ~bitsToClear, oldValue))
+                return oldValue;
+        }
+    }
+
+    static bool isEarlierThan (const uint32 time1, const uint32 time2) noexcept
+    {
+        return (int) (time1 - time2) < 0;  // (this copes with the counter wrapping around)
+    }
+}
+
+//==============================================================================
 MidiKeyboardState::MidiKeyboardState()
+    : injectedEvents ((size_t) maxInjectedEvents),
+      injectedEventFifo (maxInjectedEvents)
 {
-    zerostruct (noteStates);
 }
 
 MidiKeyboardState::~MidiKeyboardState()
@@ -35,9 +68,13 @@ MidiKeyboardState::~MidiKeyboardState()
 //==============================================================================
 void MidiKeyboardState::reset()
 {
-    const ScopedLock sl (lock);
-    zerostruct (noteStates);
-    eventsToAdd.clear();
+    for (int i = 0; i < 128; ++i)
+        noteStates[i] = 0;
+
+    // (the fifo can only be emptied by the thread that reads from it, so this just
+    // tells processNextMidiBuffer() to throw away whatever has been queued)
+    shouldDiscardInjectedEvents = 1;
+    ++changeCounter;
 }
 
 bool MidiKeyboardState::isNoteOn (const int midiChannel, const int n) const noexcept
@@ -45,13 +82,13 @@ bool MidiKeyboardState::isNoteOn (const int midiChannel, const int n) const noex
     jassert (midiChannel >= 0 && midiChannel <= 16);
 
     return isPositiveAndBelow (n, (int) 128)
-            && (noteStates[n] & (1 << (midiChannel - 1))) != 0;
+            && (noteStates[n].get() & (1 << (midiChannel - 1))) != 0;
 }
 
 bool MidiKeyboardState::isNoteOnForChannels (const int midiChannelMask, const int n) const noexcept
 {
     return isPositiveAndBelow (n, (int) 128)
-            && (noteStates[n] & midiChannelMask) != 0;
+            && (noteStates[n].get() & midiChannelMask) != 0;
 }
 
 void MidiKeyboardState::noteOn (const int midiChannel, const int midiNoteNumber, const float velocity)
@@ -59,14 +96,9 @@ void MidiKeyboardState::noteOn (const int midiChannel, const int midiNoteNumber,
     jassert (midiChannel >= 0 && midiChannel <= 16);
     jassert (isPositiveAndBelow (midiNoteNumber, (int) 128));
 
-    const ScopedLock sl (lock);
-
     if (isPositiveAndBelow (midiNoteNumber, (int) 128))
     {
-        const int timeNow = (int) Time::getMillisecondCounter();
-        eventsToAdd.addEvent (MidiMessage::noteOn (midiChannel, midiNoteNumber, velocity), timeNow);
-        eventsToAdd.clear (0, timeNow - 500);
-
+        injectEvent (MidiMessage::noteOn (midiChannel, midiNoteNumber, velocity));
         noteOnInternal (midiChannel, midiNoteNumber, velocity);
     }
 }
@@ -75,42 +107,51 @@ void MidiKeyboardState::noteOnInternal  (const int midiChannel, const int midiNo
 {
     if (isPositiveAndBelow (midiNoteNumber, (int) 128))
     {
-        noteStates [midiNoteNumber] |= (1 << (midiChannel - 1));
+        MidiKeyboardStateHelpers::setBits (noteStates [midiNoteNumber], 1 << (midiChannel - 1));
+        ++changeCounter;
 
-        for (int i = listeners.size(); --i >= 0;)
-            listeners.getUnchecked(i)->handleNoteOn (this, midiChannel, midiNoteNumber, velocity);
+        if (listeners.size() > 0)
+        {
+            const ScopedLock sl (listenerLock);
+
+            for (int i = listeners.size(); --i >= 0;)
+                listeners.getUnchecked(i)->handleNoteOn (this, midiChannel, midiNoteNumber, velocity);
+        }
     }
 }
 
 void MidiKeyboardState::noteOff (const int midiChannel, const int midiNoteNumber)
 {
-    const ScopedLock sl (lock);
-
     if (isNoteOn (midiChannel, midiNoteNumber))
     {
-        const int timeNow = (int) Time::getMillisecondCounter();
-        eventsToAdd.addEvent (MidiMessage::noteOff (midiChannel, midiNoteNumber), timeNow);
-        eventsToAdd.clear (0, timeNow - 500);
-
+        injectEvent (MidiMessage::noteOff (midiChannel, midiNoteNumber));
         noteOffInternal (midiChannel, midiNoteNumber);
     }
 }
 
 void MidiKeyboardState::noteOffInternal  (const int midiChannel, const int midiNoteNumber)
 {
-    if (isNoteOn (midiChannel, midiNoteNumber))
+    if (isPositiveAndBelow (midiNoteNumber, (int) 128))
     {
-        noteStates [midiNoteNumber] &= ~(1 << (midiChannel - 1));
+        const int bit = 1 << (midiChannel - 1);
+
+        if ((MidiKeyboardStateHelpers::clearBits (noteStates [midiNoteNumber], bit) & bit) != 0)
+        {
+            ++changeCounter;
+
+            if (listeners.size() > 0)
+            {
+                const ScopedLock sl (listenerLock);
 
-        for (int i = listeners.size(); --i >= 0;)
-            listeners.getUnchecked(i)->handleNoteOff (this, midiChannel, midiNoteNumber);
+                for (int i = listeners.size(); --i >= 0;)
+                    listeners.getUnchecked(i)->handleNoteOff (this, midiChannel, midiNoteNumber);
+            }
+        }
     }
 }
 
 void MidiKeyboardState::allNotesOff (const int midiChannel)
 {
-    const ScopedLock sl (lock);
-
     if (midiChannel <= 0)
     {
         for (int i = 1; i <= 16; ++i)
@@ -123,6 +164,27 @@ void MidiKeyboardState::allNotesOff (const int midiChannel)
     }
 }
 
+void MidiKeyboardState::injectEvent (const MidiMessage& message)
+{
+    jassert (message.getRawDataSize() == 3);
+
+    // (several threads might be playing notes, but only processNextMidiBuffer() reads
+    // from the fifo, so the lock is only ever contended by the writers)
+    const SpinLock::ScopedLockType sl (injectedEventWriteLock);
+
+    int start1, size1, start2, size2;
+    injectedEventFifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+    {
+        InjectedEvent& e = injectedEvents [start1];
+        e.time = Time::getMillisecondCounter();
+        memcpy (e.data, message.getRawData(), sizeof (e.data));
+
+        injectedEventFifo.finishedWrite (1);
+    }
+}
+
 void MidiKeyboardState::processNextMidiEvent (const MidiMessage& message)
 {
     if (message.isNoteOn())
@@ -149,36 +211,115 @@ void MidiKeyboardState::processNextMidiBuffer (MidiBuffer& buffer,
     MidiMessage message (0xf4, 0.0);
     int time;
 
-    const ScopedLock sl (lock);
-
     while (i.getNextEvent (message, time))
         processNextMidiEvent (message);
 
-    if (injectIndirectEvents)
+    const int numReady = injectedEventFifo.getNumReady();
+
+    if (numReady > 0)
     {
-        MidiBuffer::Iterator i2 (eventsToAdd);
-        const int firstEventToAdd = eventsToAdd.getFirstEventTime();
-        const double scaleFactor = numSamples / (double) (eventsToAdd.getLastEventTime() + 1 - firstEventToAdd);
+        int start1, size1, start2, size2;
+        injectedEventFifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+        const bool discardEvents = shouldDiscardInjectedEvents.compareAndSetBool (0, 1);
 
-        while (i2.getNextEvent (message, time))
+        if (injectIndirectEvents && ! discardEvents)
         {
-            const int pos = jlimit (0, numSamples - 1, roundToInt ((time - firstEventToAdd) * scaleFactor));
-            buffer.addEvent (message, startSample + pos);
+            // (events that have been waiting for more than half a second are too stale to play)
+            using namespace MidiKeyboardStateHelpers;
+            const uint32 earliestTime = Time::getMillisecondCounter() - 500;
+            bool foundAny = false;
+            uint32 firstEventToAdd = 0, lastEventToAdd = 0;
+
+            for (int j = 0; j < size1 + size2; ++j)
+            {
+                const uint32 t = injectedEvents [j < size1 ? start1 + j : start2 + (j - size1)].time;
+
+                if (! isEarlierThan (t, earliestTime))
+                {
+                    if (! foundAny || isEarlierThan (t, firstEventToAdd))   firstEventToAdd = t;
+                    if (! foundAny || isEarlierThan (lastEventToAdd, t))    lastEventToAdd = t;
+                    foundAny = true;
+                }
+            }
+
+            const double scaleFactor = numSamples / (double) (lastEventToAdd + 1 - firstEventToAdd);
+
+            for (int j = 0; j < size1 + size2; ++j)
+            {
+                const InjectedEvent& e = injectedEvents [j < size1 ? start1 + j : start2 + (j - size1)];
+
+                if (! isEarlierThan (e.time, earliestTime))
+                {
+                    const int pos = jlimit (0, numSamples - 1, roundToInt ((e.time - firstEventToAdd) * scaleFactor));
+                    buffer.addEvent (e.data, 3, startSample + pos);
+                }
+            }
         }
-    }
 
-    eventsToAdd.clear();
+        injectedEventFifo.finishedRead (size1 + size2);
+    }
 }
 
 //==============================================================================
 void MidiKeyboardState::addListener (MidiKeyboardStateListener* const listener)
 {
-    const ScopedLock sl (lock);
+    const ScopedLock sl (listenerLock);
     listeners.addIfNotAlreadyThere (listener);
 }
 
 void MidiKeyboardState::removeListener (MidiKeyboardStateListener* const listener)
 {
-    const ScopedLock sl (lock);
+    const ScopedLock sl (listenerLock);
     listeners.removeFirstMatchingValue (listener);
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class MidiKeyboardStateTests  : public UnitTest
+{
+public:
+    MidiKeyboardStateTests() : UnitTest ("MidiKeyboardState") {}
+
+    void runTest()
+    {
+        beginTest ("Key states");
+
+        MidiKeyboardState state;
+        const int counter = state.getChangeCounter();
+
+        state.noteOn (1, 60, 0.5f);
+        state.noteOn (3, 60, 0.5f);
+        expect (state.isNoteOn (1, 60) && state.isNoteOn (3, 60) && ! state.isNoteOn (2, 60));
+        expect (state.isNoteOnForChannels (0x4, 60) && ! state.isNoteOnForChannels (0x2, 60));
+        expect (state.getChangeCounter() != counter);
+
+        state.noteOff (1, 60);
+        expect (! state.isNoteOn (1, 60) && state.isNoteOn (3, 60));
+
+        beginTest ("Injected events");
+
+        MidiBuffer buffer;
+        buffer.addEvent (MidiMessage::noteOn (2, 40, 0.5f), 10);
+        state.processNextMidiBuffer (buffer, 0, 256, true);
+
+        expect (state.isNoteOn (2, 40));
+        expectEquals (buffer.getNumEvents(), 4);
+
+        MidiBuffer buffer2;
+        state.processNextMidiBuffer (buffer2, 0, 256, true);
+        expect (buffer2.isEmpty());
+
+        state.noteOn (1, 61, 0.5f);
+        state.reset();
+        expect (! state.isNoteOn (1, 61) && ! state.isNoteOn (2, 40));
+
+        state.processNextMidiBuffer (buffer2, 0, 256, true);
+        expect (buffer2.isEmpty());
+    }
+};
+
+static MidiKeyboardStateTests midiKeyboardStateTests;
+
+#endif
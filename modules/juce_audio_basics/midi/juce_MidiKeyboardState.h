@@ -82,6 +82,12 @@ public:
     It also allows key up/down events to be triggered with its noteOn() and noteOff()
     methods, and midi messages for these events will be merged into the
     midi stream that gets processed by processNextMidiBuffer().
+
+    The key states are held in atomic bitmasks, and the events from noteOn() and
+    noteOff() are passed to the audio thread through a lock-free fifo, so
+    processNextMidiBuffer() never has to wait for another thread unless it's making
+    listener callbacks. A UI that just needs to redraw keys can poll getChangeCounter()
+    from a timer instead of registering a listener.
 */
 class JUCE_API  MidiKeyboardState
 {
@@ -192,15 +198,39 @@ public:
     */
     void removeListener (MidiKeyboardStateListener* listener);
 
+    //==============================================================================
+    /** Returns a counter that's incremented every time a key goes up or down.
+
+        This is cheap and lock-free, so a UI can poll it from a timer, and only go on
+        to check the individual keys with isNoteOnForChannels() when it has changed.
+        Any number of changes between two polls will be seen as a single update.
+    */
+    int getChangeCounter() const noexcept                   { return changeCounter.get(); }
+
 private:
     //==============================================================================
-    CriticalSection lock;
-    uint16 noteStates [128];
-    MidiBuffer eventsToAdd;
+    struct InjectedEvent
+    {
+        uint32 time;
+        uint8 data[3];
+    };
+
+    enum { maxInjectedEvents = 512 };
+
+    Atomic<int> noteStates [128];
+    Atomic<int> changeCounter;
+    Atomic<int> shouldDiscardInjectedEvents;
+
+    HeapBlock<InjectedEvent> injectedEvents;
+    AbstractFifo injectedEventFifo;
+    SpinLock injectedEventWriteLock;
+
+    CriticalSection listenerLock;
     Array <MidiKeyboardStateListener*> listeners;
 
     void noteOnInternal (int midiChannel, int midiNoteNumber, float velocity);
     void noteOffInternal (int midiChannel, int midiNoteNumber);
+    void injectEvent (const MidiMessage&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiKeyboardState)
 };
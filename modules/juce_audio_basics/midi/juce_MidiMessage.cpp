@@ -34,6 +34,183 @@ namespace MidiHelpers
     {
         return (uint8) jlimit (0, 127, v);
     }
+
+    //==============================================================================
+    /*  Messages whose data doesn't fit into their preallocated space keep it in one of
+        these blocks, directly after the header. Copies of a message share the same block,
+        and when the last one lets go of it, the block goes onto a free-list for its size
+        rather than back to the system allocator.
+    */
+    struct SharedDataHeader
+    {
+        SharedDataHeader() noexcept  : nextFree (nullptr) {}
+
+        SharedDataHeader* nextFree;
+        Atomic<int> refCount;
+        int sizeClass;
+    };
+
+    class SharedDataPool
+    {
+    public:
+        // (there's deliberately no constructor to initialise the free-lists, as static
+        // MidiMessage objects may already have used the pool before it gets constructed)
+        ~SharedDataPool()
+        {
+            for (int i = 0; i < numSizeClasses; ++i)
+            {
+                while (SharedDataHeader* const h = freeLists[i].head)
+                {
+                    freeLists[i].head = h->nextFree;
+                    deleteBlock (h);
+                }
+            }
+        }
+
+        uint8* allocate (const int numBytes)
+        {
+            const int sizeClass = getSizeClass (numBytes);
+            SharedDataHeader* h = nullptr;
+
+            if (sizeClass >= 0)
+            {
+                FreeList& list = freeLists [sizeClass];
+                const SpinLock::ScopedLockType sl (list.lock);
+
+                if ((h = list.head) != nullptr)
+                {
+                    list.head = h->nextFree;
+                    --list.numFree;
+                }
+            }
+
+            if (h == nullptr)
+                h = createBlock (sizeClass, numBytes);
+
+            h->refCount = 1;
+            return getData (h);
+        }
+
+        static void addReference (const uint8* const data) noexcept
+        {
+            ++(getHeader (data)->refCount);
+        }
+
+        static bool isShared (const uint8* const data) noexcept
+        {
+            return getHeader (data)->refCount.get() > 1;
+        }
+
+        void release (const uint8* const data) noexcept
+        {
+            SharedDataHeader* const h = getHeader (data);
+
+            if (--(h->refCount) == 0)
+            {
+                if (h->sizeClass >= 0)
+                {
+                    FreeList& list = freeLists [h->sizeClass];
+                    const SpinLock::ScopedLockType sl (list.lock);
+
+                    if (list.numFree < jmax ((int) maxFreeBlocksPerSize, list.numReserved))
+                    {
+                        h->nextFree = list.head;
+                        list.head = h;
+                        ++list.numFree;
+                        return;
+                    }
+                }
+
+                deleteBlock (h);
+            }
+        }
+
+        void reserve (const int numBlocks, const int numBytes)
+        {
+            const int sizeClass = getSizeClass (numBytes);
+            jassert (sizeClass >= 0); // only messages up to the largest block size can be pooled
+
+            if (sizeClass >= 0)
+            {
+                FreeList& list = freeLists [sizeClass];
+
+                for (;;)
+                {
+                    {
+                        const SpinLock::ScopedLockType sl (list.lock);
+                        list.numReserved = jmax (list.numReserved, numBlocks);
+
+                        if (list.numFree >= numBlocks)
+                            break;
+                    }
+
+                    SharedDataHeader* const h = createBlock (sizeClass, numBytes);
+
+                    const SpinLock::ScopedLockType sl (list.lock);
+                    h->nextFree = list.head;
+                    list.head = h;
+                    ++list.numFree;
+                }
+            }
+        }
+
+    private:
+        enum
+        {
+            headerSize = 32,
+            smallestBlockSize = 32,
+            numSizeClasses = 6,         // 32 bytes up to 32K, in steps of 4x
+            maxFreeBlocksPerSize = 256
+        };
+
+        struct FreeList
+        {
+            SpinLock lock;
+            SharedDataHeader* head;
+            int numFree, numReserved;
+        };
+
+        FreeList freeLists [numSizeClasses];
+
+        static int getSizeClass (const int numBytes) noexcept
+        {
+            for (int i = 0; i < numSizeClasses; ++i)
+                if (numBytes <= getBlockSize (i))
+                    return i;
+
+            return -1;
+        }
+
+        static int getBlockSize (const int sizeClass) noexcept      { return smallestBlockSize << (2 * sizeClass); }
+
+        static SharedDataHeader* createBlock (const int sizeClass, const int numBytes)
+        {
+            static_jassert (sizeof (SharedDataHeader) <= headerSize);
+
+            uint8* const block = new uint8 [(size_t) (headerSize + (sizeClass >= 0 ? getBlockSize (sizeClass) : numBytes))];
+            SharedDataHeader* const h = new (block) SharedDataHeader();
+            h->sizeClass = sizeClass;
+            return h;
+        }
+
+        static void deleteBlock (SharedDataHeader* const h) noexcept
+        {
+            h->~SharedDataHeader();
+            delete[] reinterpret_cast <uint8*> (h);
+        }
+
+        static uint8* getData (SharedDataHeader* const h) noexcept
+        {
+            return reinterpret_cast <uint8*> (h) + headerSize;
+        }
+
+        static SharedDataHeader* getHeader (const uint8* const data) noexcept
+        {
+            return reinterpret_cast <SharedDataHeader*> (const_cast <uint8*> (data) - headerSize);
+        }
+    };
+
+    static SharedDataPool sharedDataPool;
 }
 
 //==============================================================================
@@ -91,7 +268,48 @@ inline bool MidiMessage::usesAllocatedData() const noexcept
 inline void MidiMessage::freeData() noexcept
 {
     if (usesAllocatedData())
-        delete[] data;
+        MidiHelpers::sharedDataPool.release (data);
+}
+
+inline void MidiMessage::allocateData (const int numBytes)
+{
+    if (numBytes <= (int) sizeof (preallocatedData))
+        setToUseInternalData();
+    else
+        data = MidiHelpers::sharedDataPool.allocate (numBytes);
+}
+
+inline void MidiMessage::shareDataWith (const MidiMessage& other) noexcept
+{
+    if (other.usesAllocatedData())
+    {
+        MidiHelpers::SharedDataPool::addReference (other.data);
+        data = other.data;
+    }
+    else
+    {
+        setToUseInternalData();
+        preallocatedData.asInt32 = other.preallocatedData.asInt32;
+    }
+}
+
+uint8* MidiMessage::getWritableData()
+{
+    if (usesAllocatedData() && MidiHelpers::SharedDataPool::isShared (data))
+    {
+        const uint8* const oldData = data;
+        data = MidiHelpers::sharedDataPool.allocate (size);
+        memcpy (data, oldData, (size_t) size);
+        MidiHelpers::sharedDataPool.release (oldData);
+    }
+
+    return data;
+}
+
+void MidiMessage::preallocateSharedData (const int numMessages, const int maxMessageSize)
+{
+    if (maxMessageSize > (int) sizeof (preallocatedData))
+        MidiHelpers::sharedDataPool.reserve (numMessages, maxMessageSize);
 }
 
 //==============================================================================
@@ -110,11 +328,7 @@ MidiMessage::MidiMessage (const void* const d, const int dataSize, const double
 {
     jassert (dataSize > 0);
 
-    if (dataSize <= 4)
-        setToUseInternalData();
-    else
-        data = new uint8 [dataSize];
-
+    allocateData (dataSize);
     memcpy (data, d, (size_t) dataSize);
 
     // check that the length matches the data..
@@ -161,32 +375,14 @@ MidiMessage::MidiMessage (const MidiMessage& other)
    : timeStamp (other.timeStamp),
      size (other.size)
 {
-    if (other.usesAllocatedData())
-    {
-        data = new uint8 [size];
-        memcpy (data, other.data, (size_t) size);
-    }
-    else
-    {
-        setToUseInternalData();
-        preallocatedData.asInt32 = other.preallocatedData.asInt32;
-    }
+    shareDataWith (other);
 }
 
 MidiMessage::MidiMessage (const MidiMessage& other, const double newTimeStamp)
    : timeStamp (newTimeStamp),
      size (other.size)
 {
-    if (other.usesAllocatedData())
-    {
-        data = new uint8 [size];
-        memcpy (data, other.data, (size_t) size);
-    }
-    else
-    {
-        setToUseInternalData();
-        preallocatedData.asInt32 = other.preallocatedData.asInt32;
-    }
+    shareDataWith (other);
 }
 
 MidiMessage::MidiMessage (const void* src_, int sz, int& numBytesUsed, const uint8 lastStatusByte, double t)
@@ -245,7 +441,7 @@ MidiMessage::MidiMessage (const void* src_, int sz, int& numBytesUsed, const uin
 
             size = 1 + (int) (d - src);
 
-            data = new uint8 [size - numVariableLengthSysexBytes];
+            allocateData (size - numVariableLengthSysexBytes);
             *data = (uint8) byte;
             memcpy (data + 1, src + numVariableLengthSysexBytes, (size_t) (size - numVariableLengthSysexBytes - 1));
         }
@@ -255,7 +451,7 @@ MidiMessage::MidiMessage (const void* src_, int sz, int& numBytesUsed, const uin
             const int bytesLeft = readVariableLengthVal (src + 1, n);
             size = jmin (sz + 1, n + 2 + bytesLeft);
 
-            data = new uint8 [size];
+            allocateData (size);
             *data = (uint8) byte;
             memcpy (data + 1, src, (size_t) size - 1);
         }
@@ -290,18 +486,13 @@ MidiMessage& MidiMessage::operator= (const MidiMessage& other)
         timeStamp = other.timeStamp;
         size = other.size;
 
-        freeData();
+        const uint8* const oldData = data;
+        const bool oldDataWasAllocated = usesAllocatedData();
 
-        if (other.usesAllocatedData())
-        {
-            data = new uint8 [size];
-            memcpy (data, other.data, (size_t) size);
-        }
-        else
-        {
-            setToUseInternalData();
-            preallocatedData.asInt32 = other.preallocatedData.asInt32;
-        }
+        shareDataWith (other);
+
+        if (oldDataWasAllocated)
+            MidiHelpers::sharedDataPool.release (oldData);
     }
 
     return *this;
@@ -374,8 +565,8 @@ void MidiMessage::setChannel (const int channel) noexcept
     jassert (channel > 0 && channel <= 16); // valid channels are numbered 1 to 16
 
     if ((data[0] & 0xf0) != (uint8) 0xf0)
-        data[0] = (uint8) ((data[0] & (uint8) 0xf0)
-                            | (uint8)(channel - 1));
+        getWritableData()[0] = (uint8) ((data[0] & (uint8) 0xf0)
+                                         | (uint8)(channel - 1));
 }
 
 bool MidiMessage::isNoteOn (const bool returnTrueForVelocity0) const noexcept
@@ -404,7 +595,7 @@ int MidiMessage::getNoteNumber() const noexcept
 void MidiMessage::setNoteNumber (const int newNoteNumber) noexcept
 {
     if (isNoteOnOrOff())
-        data[1] = (uint8) (newNoteNumber & 127);
+        getWritableData()[1] = (uint8) (newNoteNumber & 127);
 }
 
 uint8 MidiMessage::getVelocity() const noexcept
@@ -423,13 +614,13 @@ float MidiMessage::getFloatVelocity() const noexcept
 void MidiMessage::setVelocity (const float newVelocity) noexcept
 {
     if (isNoteOnOrOff())
-        data[2] = MidiHelpers::validVelocity (roundToInt (newVelocity * 127.0f));
+        getWritableData()[2] = MidiHelpers::validVelocity (roundToInt (newVelocity * 127.0f));
 }
 
 void MidiMessage::multiplyVelocity (const float scaleFactor) noexcept
 {
     if (isNoteOnOrOff())
-        data[2] = MidiHelpers::validVelocity (roundToInt (scaleFactor * data[2]));
+        getWritableData()[2] = MidiHelpers::validVelocity (roundToInt (scaleFactor * data[2]));
 }
 
 bool MidiMessage::isAftertouch() const noexcept
@@ -622,13 +813,15 @@ bool MidiMessage::isSysEx() const noexcept
 
 MidiMessage MidiMessage::createSysExMessage (const void* sysexData, const int dataSize)
 {
-    HeapBlock<uint8> m ((size_t) dataSize + 2);
+    MidiMessage m;
+    m.size = dataSize + 2;
+    m.allocateData (m.size);
 
-    m[0] = 0xf0;
-    memcpy (m + 1, sysexData, (size_t) dataSize);
-    m[dataSize + 1] = 0xf7;
+    m.data[0] = 0xf0;
+    memcpy (m.data + 1, sysexData, (size_t) dataSize);
+    m.data[dataSize + 1] = 0xf7;
 
-    return MidiMessage (m, dataSize + 2);
+    return m;
 }
 
 const uint8* MidiMessage::getSysExData() const noexcept
@@ -1047,3 +1240,77 @@ String MidiMessage::getControllerName (const int n)
 
     return isPositiveAndBelow (n, (int) 128) ? names[n] : (const char*) nullptr;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class MidiMessageTests  : public UnitTest
+{
+public:
+    MidiMessageTests() : UnitTest ("MidiMessage") {}
+
+    void runTest()
+    {
+        beginTest ("Sysex data sharing");
+
+        uint8 payload [300];
+        for (int i = 0; i < numElementsInArray (payload); ++i)
+            payload[i] = (uint8) (i & 0x7f);
+
+        MidiMessage::preallocateSharedData (8, (int) sizeof (payload) + 2);
+
+        {
+            const MidiMessage m1 (MidiMessage::createSysExMessage (payload, (int) sizeof (payload)));
+            expect (m1.isSysEx());
+            expectEquals (m1.getSysExDataSize(), (int) sizeof (payload));
+            expect (memcmp (m1.getSysExData(), payload, sizeof (payload)) == 0);
+            expectEquals ((int) m1.getRawData() [m1.getRawDataSize() - 1], 0xf7);
+
+            MidiMessage m2 (m1, 1.0);
+            expect (m2.getRawData() == m1.getRawData());
+            expectEquals (m2.getTimeStamp(), 1.0);
+
+            MidiMessage m3 (0x90, 60, 100);
+            m3 = m2;
+            expect (m3.getRawData() == m1.getRawData());
+
+            m3 = MidiMessage::noteOn (1, 60, (uint8) 100);
+            expect (m2.getRawData() == m1.getRawData());
+            expect (m3.isNoteOn());
+        }
+
+        {
+            // a block that's been released should be recycled by the next message of that size
+            const uint8* firstData;
+
+            {
+                const MidiMessage m (MidiMessage::createSysExMessage (payload, 100));
+                firstData = m.getRawData();
+            }
+
+            const MidiMessage m (MidiMessage::createSysExMessage (payload, 100));
+            expect (m.getRawData() == firstData);
+        }
+
+        beginTest ("Modifying shared data");
+
+        {
+            const uint8 longNoteOn[] = { 0x90, 60, 100, 0, 0 };
+            const MidiMessage m1 (longNoteOn, (int) sizeof (longNoteOn));
+            MidiMessage m2 (m1);
+
+            m2.setVelocity (0.5f);
+            m2.setChannel (3);
+
+            expect (m2.getRawData() != m1.getRawData());
+            expectEquals ((int) m1.getVelocity(), 100);
+            expectEquals (m1.getChannel(), 1);
+            expectEquals ((int) m2.getVelocity(), 64);
+            expectEquals (m2.getChannel(), 3);
+        }
+    }
+};
+
+static MidiMessageTests midiMessageTests;
+
+#endif
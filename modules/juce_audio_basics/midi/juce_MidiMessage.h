@@ -849,6 +849,19 @@ public:
     static MidiMessage createSysExMessage (const void* sysexData,
                                            int dataSize);
 
+    /** Fills the pool that holds the data of long messages, such as sysex.
+
+        Messages that are too long to be stored inside the MidiMessage object itself keep
+        their data in reference-counted blocks that are recycled through a shared pool.
+        Copying one of these messages just shares its data, and creating one only uses the
+        system allocator when the pool has no free blocks of the right size.
+
+        Calling this before you start processing lets you make sure that the given number
+        of messages, each up to maxMessageSize bytes long, can then be created on a
+        realtime thread without allocating any memory.
+    */
+    static void preallocateSharedData (int numMessages, int maxMessageSize);
+
 
     //==============================================================================
     /** Reads a midi variable-length integer.
@@ -935,6 +948,9 @@ private:
     void freeData() noexcept;
     void setToUseInternalData() noexcept;
     bool usesAllocatedData() const noexcept;
+    void allocateData (int numBytes);
+    void shareDataWith (const MidiMessage&) noexcept;
+    uint8* getWritableData();
 };
 
 #endif   // __JUCE_MIDIMESSAGE_JUCEHEADER__
@@ -85,19 +85,43 @@ int MidiMessageSequence::getIndexOfMatchingKeyUp (const int index) const
 
 int MidiMessageSequence::getIndexOf (MidiEventHolder* const event) const
 {
+    if (event != nullptr)
+    {
+        // the list is sorted, so look in the run of events that share this one's timestamp
+        // first, and only fall back to a full scan if the order has been disturbed..
+        const double time = event->message.getTimeStamp();
+        const int numEvents = list.size();
+
+        for (int i = getNextIndexAtTime (time); i < numEvents; ++i)
+        {
+            const MidiEventHolder* const meh = list.getUnchecked(i);
+
+            if (meh == event)
+                return i;
+
+            if (meh->message.getTimeStamp() != time)
+                break;
+        }
+    }
+
     return list.indexOf (event);
 }
 
 int MidiMessageSequence::getNextIndexAtTime (const double timeStamp) const
 {
-    const int numEvents = list.size();
+    int start = 0, end = list.size();
+
+    while (start < end)
+    {
+        const int mid = start + (end - start) / 2;
 
-    int i;
-    for (i = 0; i < numEvents; ++i)
-        if (list.getUnchecked(i)->message.getTimeStamp() >= timeStamp)
-            break;
+        if (list.getUnchecked (mid)->message.getTimeStamp() < timeStamp)
+            start = mid + 1;
+        else
+            end = mid;
+    }
 
-    return i;
+    return start;
 }
 
 //==============================================================================
@@ -128,12 +152,27 @@ MidiMessageSequence::MidiEventHolder* MidiMessageSequence::addEvent (const MidiM
     timeAdjustment += newMessage.getTimeStamp();
     newOne->message.setTimeStamp (timeAdjustment);
 
-    int i;
-    for (i = list.size(); --i >= 0;)
-        if (list.getUnchecked(i)->message.getTimeStamp() <= timeAdjustment)
-            break;
+    // events are usually appended in time order, so check the end of the list before
+    // doing a binary search for the position after any events with the same time
+    int start = list.size();
+
+    if (start > 0 && list.getLast()->message.getTimeStamp() > timeAdjustment)
+    {
+        int end = start;
+        start = 0;
+
+        while (start < end)
+        {
+            const int mid = start + (end - start) / 2;
 
-    list.insert (i + 1, newOne);
+            if (list.getUnchecked (mid)->message.getTimeStamp() <= timeAdjustment)
+                start = mid + 1;
+            else
+                end = mid;
+        }
+    }
+
+    list.insert (start, newOne);
     return newOne;
 }
 
@@ -167,6 +206,9 @@ void MidiMessageSequence::addSequence (const MidiMessageSequence& other,
     firstAllowableTime -= timeAdjustment;
     endOfAllowableDestTimes -= timeAdjustment;
 
+    OwnedArray<MidiEventHolder> newEvents;
+    bool newEventsAreSorted = true;
+
     for (int i = 0; i < other.list.size(); ++i)
     {
         const MidiMessage& m = other.list.getUnchecked(i)->message;
@@ -177,11 +219,46 @@ void MidiMessageSequence::addSequence (const MidiMessageSequence& other,
             MidiEventHolder* const newOne = new MidiEventHolder (m);
             newOne->message.setTimeStamp (timeAdjustment + t);
 
-            list.add (newOne);
+            if (newEvents.size() > 0 && newEvents.getLast()->message.getTimeStamp() > newOne->message.getTimeStamp())
+                newEventsAreSorted = false;
+
+            newEvents.add (newOne);
         }
     }
 
-    sort();
+    if (newEvents.size() == 0)
+        return;
+
+    if (! newEventsAreSorted)
+    {
+        list.addArray (newEvents);
+        newEvents.clear (false);
+        sort();
+        return;
+    }
+
+    // Both lists are in order, so merge them in one pass rather than appending and
+    // re-sorting. Existing events go before new ones with the same time, which is
+    // the order that the stable sort would have produced.
+    OwnedArray<MidiEventHolder> merged;
+    merged.ensureStorageAllocated (list.size() + newEvents.size());
+
+    int i = 0, j = 0;
+
+    while (i < list.size() && j < newEvents.size())
+    {
+        if (newEvents.getUnchecked(j)->message.getTimeStamp() < list.getUnchecked(i)->message.getTimeStamp())
+            merged.add (newEvents.getUnchecked (j++));
+        else
+            merged.add (list.getUnchecked (i++));
+    }
+
+    while (i < list.size())         merged.add (list.getUnchecked (i++));
+    while (j < newEvents.size())    merged.add (newEvents.getUnchecked (j++));
+
+    list.clear (false);
+    newEvents.clear (false);
+    list.swapWithArray (merged);
 }
 
 //==============================================================================
@@ -193,41 +270,70 @@ void MidiMessageSequence::sort()
 
 void MidiMessageSequence::updateMatchedPairs()
 {
-    for (int i = 0; i < list.size(); ++i)
+    // Walks the list once, keeping track of the note-on that's still waiting for its
+    // note-off on each channel and note. A second note-on for the same note gets a
+    // note-off inserted just before it, so there's never more than one pending.
+    HeapBlock<MidiEventHolder*> pendingNoteOns ((size_t) (16 * 128), true);
+    OwnedArray<MidiEventHolder> insertedNoteOffs;
+    Array<int> insertionIndexes;
+
+    const int numEvents = list.size();
+
+    for (int i = 0; i < numEvents; ++i)
     {
         MidiEventHolder* const meh = list.getUnchecked(i);
-        const MidiMessage& m1 = meh->message;
+        const MidiMessage& m = meh->message;
 
-        if (m1.isNoteOn())
+        if (m.isNoteOn())
         {
-            meh->noteOffObject = nullptr;
-            const int note = m1.getNoteNumber();
-            const int chan = m1.getChannel();
-            const int len = list.size();
+            const int chan = m.getChannel();
+            const int note = m.getNoteNumber();
+            MidiEventHolder*& pending = pendingNoteOns [(chan - 1) * 128 + note];
 
-            for (int j = i + 1; j < len; ++j)
+            if (pending != nullptr)
             {
-                const MidiMessage& m = list.getUnchecked(j)->message;
+                MidiEventHolder* const newEvent = new MidiEventHolder (MidiMessage::noteOff (chan, note));
+                newEvent->message.setTimeStamp (m.getTimeStamp());
+                pending->noteOffObject = newEvent;
 
-                if (m.getNoteNumber() == note && m.getChannel() == chan)
-                {
-                    if (m.isNoteOff())
-                    {
-                        meh->noteOffObject = list[j];
-                        break;
-                    }
-                    else if (m.isNoteOn())
-                    {
-                        MidiEventHolder* const newEvent = new MidiEventHolder (MidiMessage::noteOff (chan, note));
-                        list.insert (j, newEvent);
-                        newEvent->message.setTimeStamp (m.getTimeStamp());
-                        meh->noteOffObject = newEvent;
-                        break;
-                    }
-                }
+                insertedNoteOffs.add (newEvent);
+                insertionIndexes.add (i);
+            }
+
+            meh->noteOffObject = nullptr;
+            pending = meh;
+        }
+        else if (m.isNoteOff())
+        {
+            MidiEventHolder*& pending = pendingNoteOns [(m.getChannel() - 1) * 128 + m.getNoteNumber()];
+
+            if (pending != nullptr)
+            {
+                pending->noteOffObject = meh;
+                pending = nullptr;
             }
         }
     }
+
+    if (insertedNoteOffs.size() > 0)
+    {
+        OwnedArray<MidiEventHolder> newList;
+        newList.ensureStorageAllocated (numEvents + insertedNoteOffs.size());
+
+        int nextInsertion = 0;
+
+        for (int i = 0; i < numEvents; ++i)
+        {
+            while (nextInsertion < insertionIndexes.size() && insertionIndexes.getUnchecked (nextInsertion) == i)
+                newList.add (insertedNoteOffs.getUnchecked (nextInsertion++));
+
+            newList.add (list.getUnchecked(i));
+        }
+
+        list.clear (false);
+        insertedNoteOffs.clear (false);
+        list.swapWithArray (newList);
+    }
 }
 
 void MidiMessageSequence::addTimeToMessages (const double delta)
@@ -333,3 +439,68 @@ MidiMessageSequence::MidiEventHolder::MidiEventHolder (const MidiMessage& mm)
 MidiMessageSequence::MidiEventHolder::~MidiEventHolder()
 {
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class MidiMessageSequenceTests  : public UnitTest
+{
+public:
+    MidiMessageSequenceTests() : UnitTest ("MidiMessageSequence") {}
+
+    void runTest()
+    {
+        beginTest ("Note pairing");
+
+        MidiMessageSequence seq;
+        seq.addEvent (MidiMessage::noteOn (1, 60, 0.5f), 0.0);
+        seq.addEvent (MidiMessage::noteOn (2, 60, 0.5f), 1.0);
+        seq.addEvent (MidiMessage::noteOff (1, 60), 2.0);
+        seq.addEvent (MidiMessage::noteOn (2, 60, 0.5f), 3.0);   // retrigger without a note-off
+        seq.addEvent (MidiMessage::noteOff (2, 60), 4.0);
+        seq.addEvent (MidiMessage::noteOn (1, 64, 0.5f), 5.0);   // never released
+        seq.updateMatchedPairs();
+
+        expectEquals (seq.getNumEvents(), 7);
+        expectEquals (seq.getIndexOfMatchingKeyUp (0), 2);
+        expectEquals (seq.getIndexOfMatchingKeyUp (1), 3);
+        expect (seq.getEventPointer (3)->message.isNoteOff());
+        expectEquals (seq.getTimeOfMatchingKeyUp (1), 3.0);
+        expectEquals (seq.getIndexOfMatchingKeyUp (4), 5);
+        expect (seq.getEventPointer (6)->noteOffObject == nullptr);
+
+        beginTest ("Time lookups");
+
+        Random r;
+        MidiMessageSequence seq2;
+
+        for (int i = 0; i < 500; ++i)
+            seq2.addEvent (MidiMessage::controllerEvent (1, 7, i & 127), (double) r.nextInt (100));
+
+        for (int i = 1; i < seq2.getNumEvents(); ++i)
+            expect (seq2.getEventTime (i - 1) <= seq2.getEventTime (i));
+
+        for (int t = -1; t <= 101; ++t)
+        {
+            const int index = seq2.getNextIndexAtTime (t);
+            expect (index == seq2.getNumEvents() || seq2.getEventTime (index) >= t);
+            expect (index == 0 || seq2.getEventTime (index - 1) < t);
+        }
+
+        for (int i = 0; i < seq2.getNumEvents(); ++i)
+            expectEquals (seq2.getIndexOf (seq2.getEventPointer (i)), i);
+
+        beginTest ("Merging");
+
+        MidiMessageSequence seq3;
+        seq3.addSequence (seq2, 10.0, 0.0, 60.0);
+        seq3.addSequence (seq2, 0.0, 0.0, 1000.0);
+
+        for (int i = 1; i < seq3.getNumEvents(); ++i)
+            expect (seq3.getEventTime (i - 1) <= seq3.getEventTime (i));
+    }
+};
+
+static MidiMessageSequenceTests midiMessageSequenceTests;
+
+#endif
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_AUDIOTHREADHANDOVER_JUCEHEADER__
+#define __JUCE_AUDIOTHREADHANDOVER_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    Lets another thread wait until the audio thread has finished with something that
+    it may have picked up during its current callback.
+
+    This is for classes that swap the data their audio callback uses with an atomic
+    pointer, instead of holding a lock. Once the new pointer has been published, the old
+    object can't be deleted until the audio thread is known not to be using it, so the
+    callback wraps itself in a ScopedCallback, and the thread that swapped the pointer
+    calls waitForAudioThread() before deleting the old one.
+
+    e.g. @code
+    void MySource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+    {
+        const AudioThreadHandover::ScopedCallback sc (handover);
+        const Settings& settings = *activeSettings.get();
+        ...
+    }
+
+    void MySource::setSettings (const Settings& newSettings)
+    {
+        ScopedPointer<Settings> oldSettings (activeSettings.exchange (new Settings (newSettings)));
+        handover.waitForAudioThread();
+    }
+    @endcode
+
+    Only one thread may be inside a ScopedCallback at a time.
+*/
+class JUCE_API  AudioThreadHandover
+{
+public:
+    //==============================================================================
+    /** Creates a handover for an audio thread that isn't currently in a callback. */
+    AudioThreadHandover() noexcept {}
+
+    //==============================================================================
+    /** Marks the audio thread as being inside its callback for the lifetime of this object. */
+    class JUCE_API  ScopedCallback
+    {
+    public:
+        /** Called on the audio thread at the start of its callback. */
+        explicit ScopedCallback (AudioThreadHandover& handover_) noexcept
+            : handover (handover_)
+        {
+            ++(handover.callbackCounter);
+        }
+
+        /** Called on the audio thread at the end of its callback. */
+        ~ScopedCallback() noexcept
+        {
+            ++(handover.callbackCounter);
+        }
+
+    private:
+        AudioThreadHandover& handover;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedCallback)
+    };
+
+    //==============================================================================
+    /** If the audio thread is currently inside a ScopedCallback, this waits for it to
+        leave. It doesn't wait for any callbacks that start after it's been called, so
+        anything that was published before calling it is safe to delete afterwards.
+    */
+    void waitForAudioThread() const noexcept
+    {
+        // (the counter is odd while the audio thread is inside a callback)
+        const int count = callbackCounter.get();
+
+        if ((count & 1) != 0)
+            while (callbackCounter.get() == count)
+                Thread::yield();
+    }
+
+private:
+    //==============================================================================
+    Atomic<int> callbackCounter;
+
+    JUCE_DECLARE_NON_COPYABLE (AudioThreadHandover)
+};
+
+
+#endif   // __JUCE_AUDIOTHREADHANDOVER_JUCEHEADER__
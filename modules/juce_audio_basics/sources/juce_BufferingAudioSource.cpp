@@ -31,13 +31,19 @@ BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* source_,
     : source (source_, deleteSourceWhenDeleted),
       backgroundThread (backgroundThread_),
       numberOfSamplesToBuffer (jmax (1024, numberOfSamplesToBuffer_)),
+      maxSamplesToBuffer (numberOfSamplesToBuffer),
       numberOfChannels (numberOfChannels_),
-      buffer (numberOfChannels_, 0),
+      buffer (new AudioSampleBuffer (numberOfChannels_, 0)),
       bufferValidStart (0),
       bufferValidEnd (0),
       nextPlayPos (0),
+      sampleRate (0),
+      readLatencyMs (0),
+      underrunsAtLastCheck (0),
       wasSourceLooping (false),
-      isPrepared (false)
+      isPrepared (false),
+      isPlaying (false),
+      hasFilled (false)
 {
     jassert (source_ != nullptr);
 
@@ -56,7 +62,7 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sa
     const int bufferSizeNeeded = jmax (samplesPerBlockExpected * 2, numberOfSamplesToBuffer);
 
     if (sampleRate_ != sampleRate
-         || bufferSizeNeeded != buffer.getNumSamples()
+         || bufferSizeNeeded != buffer->getNumSamples()
          || ! isPrepared)
     {
         backgroundThread.removeTimeSliceClient (this);
@@ -66,16 +72,19 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sa
 
         source->prepareToPlay (samplesPerBlockExpected, sampleRate_);
 
-        buffer.setSize (numberOfChannels, bufferSizeNeeded);
-        buffer.clear();
+        buffer->setSize (numberOfChannels, bufferSizeNeeded);
+        buffer->clear();
 
         bufferValidStart = 0;
         bufferValidEnd = 0;
+        isPlaying = false;
+        hasFilled = false;
+        underrunsAtLastCheck = numUnderruns.get();
 
         backgroundThread.addTimeSliceClient (this);
 
         while (bufferValidEnd - bufferValidStart < jmin (((int) sampleRate_) / 4,
-                                                         buffer.getNumSamples() / 2))
+                                                         buffer->getNumSamples() / 2))
         {
             backgroundThread.moveToFrontOfQueue (this);
             Thread::sleep (5);
@@ -88,7 +97,7 @@ void BufferingAudioSource::releaseResources()
     isPrepared = false;
     backgroundThread.removeTimeSliceClient (this);
 
-    buffer.setSize (numberOfChannels, 0);
+    buffer->setSize (numberOfChannels, 0);
     source->releaseResources();
 }
 
@@ -99,6 +108,11 @@ void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info
     const int validStart = (int) (jlimit (bufferValidStart, bufferValidEnd, nextPlayPos) - nextPlayPos);
     const int validEnd   = (int) (jlimit (bufferValidStart, bufferValidEnd, nextPlayPos + info.numSamples) - nextPlayPos);
 
+    if (validStart == 0 && validEnd == info.numSamples)
+        isPlaying = true;
+    else if (isPlaying)
+        ++numUnderruns;
+
     if (validStart == validEnd)
     {
         // total cache miss
@@ -117,28 +131,28 @@ void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info
         {
             for (int chan = jmin (numberOfChannels, info.buffer->getNumChannels()); --chan >= 0;)
             {
-                jassert (buffer.getNumSamples() > 0);
-                const int startBufferIndex = (int) ((validStart + nextPlayPos) % buffer.getNumSamples());
-                const int endBufferIndex   = (int) ((validEnd + nextPlayPos)   % buffer.getNumSamples());
+                jassert (buffer->getNumSamples() > 0);
+                const int startBufferIndex = (int) ((validStart + nextPlayPos) % buffer->getNumSamples());
+                const int endBufferIndex   = (int) ((validEnd + nextPlayPos)   % buffer->getNumSamples());
 
                 if (startBufferIndex < endBufferIndex)
                 {
                     info.buffer->copyFrom (chan, info.startSample + validStart,
-                                           buffer,
+                                           *buffer,
                                            chan, startBufferIndex,
                                            validEnd - validStart);
                 }
                 else
                 {
-                    const int initialSize = buffer.getNumSamples() - startBufferIndex;
+                    const int initialSize = buffer->getNumSamples() - startBufferIndex;
 
                     info.buffer->copyFrom (chan, info.startSample + validStart,
-                                           buffer,
+                                           *buffer,
                                            chan, startBufferIndex,
                                            initialSize);
 
                     info.buffer->copyFrom (chan, info.startSample + validStart + initialSize,
-                                           buffer,
+                                           *buffer,
                                            chan, 0,
                                            (validEnd - validStart) - initialSize);
                 }
@@ -161,10 +175,22 @@ void BufferingAudioSource::setNextReadPosition (int64 newPosition)
 {
     const ScopedLock sl (bufferStartPosLock);
 
+    if (nextPlayPos != newPosition)
+    {
+        isPlaying = false;
+        hasFilled = false;
+    }
+
     nextPlayPos = newPosition;
     backgroundThread.moveToFrontOfQueue (this);
 }
 
+void BufferingAudioSource::setMaximumBufferSize (const int maxNumSamples)
+{
+    const ScopedLock sl (bufferStartPosLock);
+    maxSamplesToBuffer = maxNumSamples;
+}
+
 bool BufferingAudioSource::readNextBufferChunk()
 {
     int64 newBVS, newBVE, sectionToReadStart, sectionToReadEnd;
@@ -180,7 +206,7 @@ bool BufferingAudioSource::readNextBufferChunk()
         }
 
         newBVS = jmax ((int64) 0, nextPlayPos);
-        newBVE = newBVS + buffer.getNumSamples() - 4;
+        newBVE = newBVS + buffer->getNumSamples() - 4;
         sectionToReadStart = 0;
         sectionToReadEnd = 0;
 
@@ -211,9 +237,9 @@ bool BufferingAudioSource::readNextBufferChunk()
 
     if (sectionToReadStart != sectionToReadEnd)
     {
-        jassert (buffer.getNumSamples() > 0);
-        const int bufferIndexStart = (int) (sectionToReadStart % buffer.getNumSamples());
-        const int bufferIndexEnd   = (int) (sectionToReadEnd   % buffer.getNumSamples());
+        jassert (buffer->getNumSamples() > 0);
+        const int bufferIndexStart = (int) (sectionToReadStart % buffer->getNumSamples());
+        const int bufferIndexEnd   = (int) (sectionToReadEnd   % buffer->getNumSamples());
 
         if (bufferIndexStart < bufferIndexEnd)
         {
@@ -223,7 +249,7 @@ bool BufferingAudioSource::readNextBufferChunk()
         }
         else
         {
-            const int initialSize = buffer.getNumSamples() - bufferIndexStart;
+            const int initialSize = buffer->getNumSamples() - bufferIndexStart;
 
             readBufferSection (sectionToReadStart,
                                initialSize,
@@ -249,14 +275,101 @@ bool BufferingAudioSource::readNextBufferChunk()
 
 void BufferingAudioSource::readBufferSection (const int64 start, const int length, const int bufferOffset)
 {
+    const double startTime = Time::getMillisecondCounterHiRes();
+
     if (source->getNextReadPosition() != start)
         source->setNextReadPosition (start);
 
-    AudioSourceChannelInfo info (&buffer, bufferOffset, length);
+    AudioSourceChannelInfo info (buffer, bufferOffset, length);
     source->getNextAudioBlock (info);
+
+    readLatencyMs = jmax (Time::getMillisecondCounterHiRes() - startTime, readLatencyMs * 0.99);
+}
+
+void BufferingAudioSource::growBufferIfNeeded()
+{
+    int64 validStart, validEnd;
+    int newSize;
+
+    {
+        const ScopedLock sl (bufferStartPosLock);
+
+        const int currentSize = buffer->getNumSamples();
+
+        if (currentSize >= maxSamplesToBuffer || currentSize == 0 || sampleRate <= 0)
+            return;
+
+        const int64 headroom = bufferValidEnd - nextPlayPos;
+
+        if (headroom >= currentSize - currentSize / 4)
+            hasFilled = true;
+
+        // The buffer's too small if the player has run out of data, or if, having filled up,
+        // it's been allowed to drain to less than a quarter full, or to less than a few reads'
+        // worth of the latency that we're seeing from the source.
+        const int latencySamples = (int) (readLatencyMs * sampleRate / 1000.0);
+        const bool hasUnderrun = numUnderruns.get() != underrunsAtLastCheck;
+        underrunsAtLastCheck = numUnderruns.get();
+
+        if (! ((hasUnderrun && isPlaying)
+                || (hasFilled && headroom < jmax (currentSize / 4, latencySamples * 4))))
+            return;
+
+        newSize = jmin (maxSamplesToBuffer, currentSize * 2);
+        validStart = bufferValidStart;
+        validEnd = bufferValidEnd;
+    }
+
+    // This is the only thread that writes to the buffer or changes its valid range, so the
+    // contents can be copied without holding the lock..
+    ScopedPointer<AudioSampleBuffer> newBuffer (new AudioSampleBuffer (numberOfChannels, newSize));
+    newBuffer->clear();
+
+    for (int64 pos = validStart; pos < validEnd;)
+    {
+        const int oldIndex = (int) (pos % buffer->getNumSamples());
+        const int newIndex = (int) (pos % newSize);
+        const int num = (int) jmin (validEnd - pos,
+                                    (int64) (buffer->getNumSamples() - oldIndex),
+                                    (int64) (newSize - newIndex));
+
+        for (int chan = numberOfChannels; --chan >= 0;)
+            newBuffer->copyFrom (chan, newIndex, *buffer, chan, oldIndex, num);
+
+        pos += num;
+    }
+
+    {
+        const ScopedLock sl (bufferStartPosLock);
+        buffer.swapWith (newBuffer);
+        hasFilled = false;
+    }
+
+    // (the old buffer gets deleted here, outside the lock)
+}
+
+int BufferingAudioSource::getMillisecondsToNextSlice (const bool isStillFilling) const
+{
+    const ScopedLock sl (bufferStartPosLock);
+
+    if (sampleRate <= 0)
+        return 100;
+
+    const double headroomMs = (bufferValidEnd - nextPlayPos) * 1000.0 / sampleRate;
+
+    // Ask to be called back sooner the closer we are to running out, so that when the thread
+    // has lots of clients, the one nearest to an underrun always gets served first. While
+    // still filling, the wait stays well under the time it takes to play a chunk, so the
+    // buffer can keep up.
+    if (isStillFilling)
+        return jlimit (0, 20, (int) (headroomMs / 64.0));
+
+    return jlimit (1, 100, (int) (headroomMs / 8.0));
 }
 
 int BufferingAudioSource::useTimeSlice()
 {
-    return readNextBufferChunk() ? 1 : 100;
+    growBufferIfNeeded();
+
+    return getMillisecondsToNextSlice (readNextBufferChunk());
 }
@@ -37,6 +37,13 @@
     a background thread to smooth out playback. You can either create one of these
     directly, or use it indirectly using an AudioTransportSource.
 
+    When lots of these share the same TimeSliceThread, each one asks to be called back
+    sooner the closer it is to running out of data, so the thread always serves the
+    source that's nearest to an underrun first, rather than going round them in turn.
+
+    The buffer can also be allowed to grow (see setMaximumBufferSize()) if the reads
+    aren't keeping up, and getNumUnderruns() lets you keep an eye on how it's coping.
+
     @see PositionableAudioSource, AudioTransportSource
 */
 class JUCE_API  BufferingAudioSource  : public PositionableAudioSource,
@@ -92,19 +99,53 @@ public:
     /** Implements the PositionableAudioSource method. */
     bool isLooping() const                      { return source->isLooping(); }
 
+    //==============================================================================
+    /** Lets the buffer grow if the background thread can't keep it filled.
+
+        If the buffer keeps running low (because the disk is slow, or because the thread
+        has lots of other sources to look after), it'll be doubled in size, up to this
+        many samples. By default this is the size that was passed to the constructor, so
+        the buffer never grows. Growing it happens on the background thread, and the
+        buffer is never made smaller again until prepareToPlay() is called.
+    */
+    void setMaximumBufferSize (int maxNumSamples);
+
+    /** Returns the number of samples that the buffer currently holds. */
+    int getCurrentBufferSize() const noexcept               { return buffer->getNumSamples(); }
+
+    /** Returns the number of blocks that couldn't be completely filled from the buffer.
+
+        Blocks that are played straight after a call to prepareToPlay() or
+        setNextReadPosition(), before the buffer has had a chance to fill, aren't counted.
+    */
+    int getNumUnderruns() const noexcept                    { return numUnderruns.get(); }
+
+    /** Resets the count returned by getNumUnderruns(). */
+    void resetUnderrunCount() noexcept                      { numUnderruns = 0; }
+
+    /** Returns the longest time, in milliseconds, that a recent read from the source
+        has taken. This decays slowly back towards zero while reads are quick.
+    */
+    double getReadLatencyMs() const noexcept                { return readLatencyMs; }
+
 private:
     //==============================================================================
     OptionalScopedPointer<PositionableAudioSource> source;
     TimeSliceThread& backgroundThread;
-    int numberOfSamplesToBuffer, numberOfChannels;
-    AudioSampleBuffer buffer;
+    int numberOfSamplesToBuffer, maxSamplesToBuffer, numberOfChannels;
+    ScopedPointer<AudioSampleBuffer> buffer;
     CriticalSection bufferStartPosLock;
     int64 volatile bufferValidStart, bufferValidEnd, nextPlayPos;
     double volatile sampleRate;
-    bool wasSourceLooping, isPrepared;
+    double volatile readLatencyMs;
+    Atomic<int> numUnderruns;
+    int underrunsAtLastCheck;
+    bool wasSourceLooping, isPrepared, isPlaying, hasFilled;
 
     bool readNextBufferChunk();
     void readBufferSection (int64 start, int length, int bufferOffset);
+    void growBufferIfNeeded();
+    int getMillisecondsToNextSlice (bool isStillFilling) const;
     int useTimeSlice();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferingAudioSource)
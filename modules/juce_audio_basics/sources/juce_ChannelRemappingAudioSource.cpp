@@ -23,56 +23,129 @@
   ==============================================================================
 */
 
+ChannelRemappingAudioSource::Mapping::Mapping()
+    : requiredNumberOfChannels (2),
+      highestChannelUsed (-1)
+{
+}
+
+ChannelRemappingAudioSource::Mapping::Mapping (const Mapping& other)
+    : remappedInputs (other.remappedInputs),
+      remappedOutputs (other.remappedOutputs),
+      requiredNumberOfChannels (other.requiredNumberOfChannels),
+      highestChannelUsed (-1)
+{
+}
+
+void ChannelRemappingAudioSource::Mapping::update()
+{
+    directChannels.clear();
+    channelsLeftInPlace.clear();
+    highestChannelUsed = -1;
+    channelList.calloc ((size_t) jmax (1, requiredNumberOfChannels));
+
+    BigInteger outputsUsed;
+
+    for (int i = 0; i < requiredNumberOfChannels; ++i)
+    {
+        const int in  = jmax (-1, remappedInputs [i]);
+        const int out = jmax (-1, remappedOutputs [i]);
+
+        highestChannelUsed = jmax (highestChannelUsed, in, out);
+
+        // A channel can be rendered straight into the buffer if it's written back to the
+        // channel that it's read from (or has no input), and no other channel has already
+        // claimed that output. Any other channels that read from it get copied out first.
+        if (out >= 0 && ! outputsUsed [out] && (in == out || in < 0))
+        {
+            directChannels.setBit (i);
+
+            if (in == out)
+                channelsLeftInPlace.setBit (out);
+        }
+
+        if (out >= 0)
+            outputsUsed.setBit (out);
+    }
+}
+
+//==============================================================================
 ChannelRemappingAudioSource::ChannelRemappingAudioSource (AudioSource* const source_,
                                                           const bool deleteSourceWhenDeleted)
    : source (source_, deleteSourceWhenDeleted),
-     requiredNumberOfChannels (2),
+     activeMapping (new Mapping()),
      buffer (2, 16)
 {
-    remappedInfo.buffer = &buffer;
-    remappedInfo.startSample = 0;
+    activeMapping.get()->update();
 }
 
-ChannelRemappingAudioSource::~ChannelRemappingAudioSource() {}
+ChannelRemappingAudioSource::~ChannelRemappingAudioSource()
+{
+    delete activeMapping.get();
+}
+
+void ChannelRemappingAudioSource::publish (Mapping* const newMapping)
+{
+    // (must be called with the lock held)
+    newMapping->update();
+
+    ScopedPointer<Mapping> oldMapping (activeMapping.exchange (newMapping));
+
+    // If the audio thread is inside getNextAudioBlock(), it may still be using the old
+    // mapping, so wait for it to leave before deleting it.
+    audioThreadHandover.waitForAudioThread();
+}
 
 //==============================================================================
 void ChannelRemappingAudioSource::setNumberOfChannelsToProduce (const int requiredNumberOfChannels_)
 {
     const ScopedLock sl (lock);
-    requiredNumberOfChannels = requiredNumberOfChannels_;
+
+    Mapping* const m = new Mapping (*activeMapping.get());
+    m->requiredNumberOfChannels = requiredNumberOfChannels_;
+    publish (m);
 }
 
 void ChannelRemappingAudioSource::clearAllMappings()
 {
     const ScopedLock sl (lock);
 
-    remappedInputs.clear();
-    remappedOutputs.clear();
+    Mapping* const m = new Mapping (*activeMapping.get());
+    m->remappedInputs.clear();
+    m->remappedOutputs.clear();
+    publish (m);
 }
 
 void ChannelRemappingAudioSource::setInputChannelMapping (const int destIndex, const int sourceIndex)
 {
     const ScopedLock sl (lock);
 
-    while (remappedInputs.size() < destIndex)
-        remappedInputs.add (-1);
+    Mapping* const m = new Mapping (*activeMapping.get());
+
+    while (m->remappedInputs.size() < destIndex)
+        m->remappedInputs.add (-1);
 
-    remappedInputs.set (destIndex, sourceIndex);
+    m->remappedInputs.set (destIndex, sourceIndex);
+    publish (m);
 }
 
 void ChannelRemappingAudioSource::setOutputChannelMapping (const int sourceIndex, const int destIndex)
 {
     const ScopedLock sl (lock);
 
-    while (remappedOutputs.size() < sourceIndex)
-        remappedOutputs.add (-1);
+    Mapping* const m = new Mapping (*activeMapping.get());
 
-    remappedOutputs.set (sourceIndex, destIndex);
+    while (m->remappedOutputs.size() < sourceIndex)
+        m->remappedOutputs.add (-1);
+
+    m->remappedOutputs.set (sourceIndex, destIndex);
+    publish (m);
 }
 
 int ChannelRemappingAudioSource::getRemappedInputChannel (const int inputChannelIndex) const
 {
     const ScopedLock sl (lock);
+    const Array<int>& remappedInputs = activeMapping.get()->remappedInputs;
 
     if (inputChannelIndex >= 0 && inputChannelIndex < remappedInputs.size())
         return remappedInputs.getUnchecked (inputChannelIndex);
@@ -83,9 +156,10 @@ int ChannelRemappingAudioSource::getRemappedInputChannel (const int inputChannel
 int ChannelRemappingAudioSource::getRemappedOutputChannel (const int outputChannelIndex) const
 {
     const ScopedLock sl (lock);
+    const Array<int>& remappedOutputs = activeMapping.get()->remappedOutputs;
 
     if (outputChannelIndex >= 0 && outputChannelIndex < remappedOutputs.size())
-        return remappedOutputs .getUnchecked (outputChannelIndex);
+        return remappedOutputs.getUnchecked (outputChannelIndex);
 
     return -1;
 }
@@ -93,6 +167,11 @@ int ChannelRemappingAudioSource::getRemappedOutputChannel (const int outputChann
 //==============================================================================
 void ChannelRemappingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
+    {
+        const ScopedLock sl (lock);
+        buffer.setSize (jmax (1, activeMapping.get()->requiredNumberOfChannels), samplesPerBlockExpected);
+    }
+
     source->prepareToPlay (samplesPerBlockExpected, sampleRate);
 }
 
@@ -103,15 +182,74 @@ void ChannelRemappingAudioSource::releaseResources()
 
 void ChannelRemappingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
 {
-    const ScopedLock sl (lock);
+    const AudioThreadHandover::ScopedCallback sc (audioThreadHandover);
+    const Mapping& m = *activeMapping.get();
+
+    AudioSampleBuffer& dest = *bufferToFill.buffer;
+    const int numChans = dest.getNumChannels();
+    const int start = bufferToFill.startSample;
+    const int numSamples = bufferToFill.numSamples;
+
+    if (m.requiredNumberOfChannels <= 0 || m.highestChannelUsed >= numChans)
+    {
+        // (some of the mapped channels don't exist in this buffer)
+        renderWithCopies (m, bufferToFill);
+        return;
+    }
+
+    buffer.setSize (m.requiredNumberOfChannels, numSamples, false, false, true);
+
+    // copy out the inputs of any channels that can't work in-place, before the buffer's
+    // channels get overwritten..
+    for (int i = 0; i < m.requiredNumberOfChannels; ++i)
+    {
+        if (m.directChannels[i])
+        {
+            m.channelList[i] = dest.getSampleData (m.remappedOutputs.getUnchecked (i), start);
+        }
+        else
+        {
+            const int in = m.remappedInputs[i];
+
+            if (in >= 0)
+                buffer.copyFrom (i, 0, dest, in, start, numSamples);
+            else
+                buffer.clear (i, 0, numSamples);
+
+            m.channelList[i] = buffer.getSampleData (i);
+        }
+    }
+
+    for (int i = 0; i < numChans; ++i)
+        if (! m.channelsLeftInPlace[i])
+            dest.clear (i, start, numSamples);
+
+    AudioSampleBuffer remappedBuffer (m.channelList, m.requiredNumberOfChannels, numSamples);
+    AudioSourceChannelInfo remappedInfo;
+    remappedInfo.buffer = &remappedBuffer;
+    remappedInfo.startSample = 0;
+    remappedInfo.numSamples = numSamples;
 
-    buffer.setSize (requiredNumberOfChannels, bufferToFill.numSamples, false, false, true);
+    source->getNextAudioBlock (remappedInfo);
+
+    for (int i = 0; i < m.requiredNumberOfChannels; ++i)
+    {
+        const int out = m.remappedOutputs[i];
+
+        if (out >= 0 && ! m.directChannels[i])
+            dest.addFrom (out, start, buffer, i, 0, numSamples);
+    }
+}
+
+void ChannelRemappingAudioSource::renderWithCopies (const Mapping& m, const AudioSourceChannelInfo& bufferToFill)
+{
+    buffer.setSize (m.requiredNumberOfChannels, bufferToFill.numSamples, false, false, true);
 
     const int numChans = bufferToFill.buffer->getNumChannels();
 
     for (int i = 0; i < buffer.getNumChannels(); ++i)
     {
-        const int remappedChan = getRemappedInputChannel (i);
+        const int remappedChan = m.remappedInputs[i];
 
         if (remappedChan >= 0 && remappedChan < numChans)
         {
@@ -126,15 +264,18 @@ void ChannelRemappingAudioSource::getNextAudioBlock (const AudioSourceChannelInf
         }
     }
 
+    AudioSourceChannelInfo remappedInfo;
+    remappedInfo.buffer = &buffer;
+    remappedInfo.startSample = 0;
     remappedInfo.numSamples = bufferToFill.numSamples;
 
     source->getNextAudioBlock (remappedInfo);
 
     bufferToFill.clearActiveBufferRegion();
 
-    for (int i = 0; i < requiredNumberOfChannels; ++i)
+    for (int i = 0; i < m.requiredNumberOfChannels; ++i)
     {
-        const int remappedChan = getRemappedOutputChannel (i);
+        const int remappedChan = m.remappedOutputs[i];
 
         if (remappedChan >= 0 && remappedChan < numChans)
         {
@@ -152,6 +293,8 @@ XmlElement* ChannelRemappingAudioSource::createXml() const
     String ins, outs;
 
     const ScopedLock sl (lock);
+    const Array<int>& remappedInputs  = activeMapping.get()->remappedInputs;
+    const Array<int>& remappedOutputs = activeMapping.get()->remappedOutputs;
 
     for (int i = 0; i < remappedInputs.size(); ++i)
         ins << remappedInputs.getUnchecked(i) << ' ';
@@ -171,16 +314,135 @@ void ChannelRemappingAudioSource::restoreFromXml (const XmlElement& e)
     {
         const ScopedLock sl (lock);
 
-        clearAllMappings();
+        Mapping* const m = new Mapping (*activeMapping.get());
+        m->remappedInputs.clear();
+        m->remappedOutputs.clear();
 
         StringArray ins, outs;
         ins.addTokens (e.getStringAttribute ("inputs"), false);
         outs.addTokens (e.getStringAttribute ("outputs"), false);
 
         for (int i = 0; i < ins.size(); ++i)
-            remappedInputs.add (ins[i].getIntValue());
+            m->remappedInputs.add (ins[i].getIntValue());
 
         for (int i = 0; i < outs.size(); ++i)
-            remappedOutputs.add (outs[i].getIntValue());
+            m->remappedOutputs.add (outs[i].getIntValue());
+
+        publish (m);
     }
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ChannelRemappingAudioSourceTests  : public UnitTest
+{
+public:
+    ChannelRemappingAudioSourceTests() : UnitTest ("ChannelRemappingAudioSource") {}
+
+    // doubles each channel and adds a different offset to each one
+    struct TestSource  : public AudioSource
+    {
+        void prepareToPlay (int, double) {}
+        void releaseResources() {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info)
+        {
+            for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
+            {
+                float* const d = info.buffer->getSampleData (chan, info.startSample);
+
+                for (int i = 0; i < info.numSamples; ++i)
+                    d[i] = d[i] * 2.0f + (float) (chan + 1);
+            }
+        }
+    };
+
+    void checkMapping (const int* ins, const int* outs, const int numSourceChans)
+    {
+        const int numChans = 3, numSamples = 32, start = 4;
+
+        TestSource testSource;
+        ChannelRemappingAudioSource remapper (&testSource, false);
+        remapper.setNumberOfChannelsToProduce (numSourceChans);
+
+        for (int i = 0; i < numSourceChans; ++i)
+        {
+            remapper.setInputChannelMapping (i, ins[i]);
+            remapper.setOutputChannelMapping (i, outs[i]);
+        }
+
+        remapper.prepareToPlay (numSamples, 44100.0);
+
+        AudioSampleBuffer buffer (numChans, start + numSamples);
+
+        for (int chan = 0; chan < numChans; ++chan)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.getSampleData (chan)[i] = (float) (100 * (chan + 1) + i);
+
+        AudioSampleBuffer expected (buffer);
+
+        for (int chan = 0; chan < numChans; ++chan)
+        {
+            for (int i = start; i < start + numSamples; ++i)
+            {
+                float total = 0;
+
+                for (int src = 0; src < numSourceChans; ++src)
+                    if (outs[src] == chan)
+                        total += (ins[src] >= 0 && ins[src] < numChans ? buffer.getSampleData (ins[src])[i] * 2.0f : 0.0f) + (float) (src + 1);
+
+                expected.getSampleData (chan)[i] = total;
+            }
+        }
+
+        AudioSourceChannelInfo info;
+        info.buffer = &buffer;
+        info.startSample = start;
+        info.numSamples = numSamples;
+        remapper.getNextAudioBlock (info);
+
+        for (int chan = 0; chan < numChans; ++chan)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                expectEquals (buffer.getSampleData (chan)[i], expected.getSampleData (chan)[i]);
+    }
+
+    void runTest()
+    {
+        beginTest ("In-place mappings");
+        {
+            const int straight[] = { 0, 1, 2 };
+            checkMapping (straight, straight, 3);
+
+            const int ins[]  = { 1, 0, 2 };
+            const int outs[] = { 1, 0, 2 };
+            checkMapping (ins, outs, 3);
+        }
+
+        beginTest ("Copied mappings");
+        {
+            const int ins1[]  = { 1, 0 };
+            const int outs1[] = { 0, 1 };
+            checkMapping (ins1, outs1, 2);
+
+            const int ins2[]  = { 0, 0, -1, 2 };
+            const int outs2[] = { 0, 1, 2, 2 };
+            checkMapping (ins2, outs2, 4);
+
+            const int ins3[]  = { 2, 1, 0 };
+            const int outs3[] = { 1, 1, -1 };
+            checkMapping (ins3, outs3, 3);
+        }
+
+        beginTest ("Channels missing from the buffer");
+        {
+            const int ins[]  = { 0, 5 };
+            const int outs[] = { 1, 0 };
+            checkMapping (ins, outs, 2);
+        }
+    }
+};
+
+static ChannelRemappingAudioSourceTests channelRemappingAudioSourceTests;
+
+#endif
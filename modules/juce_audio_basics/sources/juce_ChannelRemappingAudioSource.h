@@ -42,6 +42,15 @@
     create an appropriate mapping, otherwise no channels will be connected and
     it'll produce silence.
 
+    Where one of the source's channels is both read from and written back to the same
+    channel of the buffer, the source is given that channel of the buffer directly, so a
+    mapping that just re-orders channels is rendered in place without copying any audio.
+
+    The audio thread never waits for a lock: changing the mapping builds a new one and
+    publishes it atomically, so the methods that change it may block their caller (but
+    not the audio thread) for up to one callback. Don't call them from inside
+    getNextAudioBlock().
+
     @see AudioSource
 */
 class ChannelRemappingAudioSource  : public AudioSource
@@ -133,14 +142,36 @@ public:
 
 private:
     //==============================================================================
+    struct Mapping
+    {
+        Mapping();
+        Mapping (const Mapping&);
+
+        Array <int> remappedInputs, remappedOutputs;
+        int requiredNumberOfChannels;
+
+        // These are worked out by update(): the source's channels that can use the
+        // buffer's channels directly, the buffer channels that those leave in place,
+        // and the highest channel of the buffer that's used.
+        BigInteger directChannels, channelsLeftInPlace;
+        int highestChannelUsed;
+        HeapBlock <float*> channelList;
+
+        void update();
+
+    private:
+        Mapping& operator= (const Mapping&);
+    };
+
     OptionalScopedPointer<AudioSource> source;
-    Array <int> remappedInputs, remappedOutputs;
-    int requiredNumberOfChannels;
+    Atomic <Mapping*> activeMapping;
+    AudioThreadHandover audioThreadHandover;
+    CriticalSection lock;
 
     AudioSampleBuffer buffer;
-    AudioSourceChannelInfo remappedInfo;
 
-    CriticalSection lock;
+    void publish (Mapping*);
+    void renderWithCopies (const Mapping&, const AudioSourceChannelInfo&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelRemappingAudioSource)
 };
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+ConvolutionAudioSource::ConvolutionAudioSource (AudioSource* const inputSource,
+                                                const bool deleteInputWhenDeleted,
+                                                const int numChannels_)
+    : input (inputSource, deleteInputWhenDeleted),
+      numChannels (numChannels_),
+      bypass (false),
+      impulseResponse (1, 0),
+      impulseResponseSampleRate (0),
+      currentSampleRate (0),
+      blockSize (64),
+      maxPartitionSize (4096)
+{
+    jassert (inputSource != nullptr);
+
+    for (int i = 0; i < numChannels; ++i)
+        convolvers.add (new Convolution());
+}
+
+ConvolutionAudioSource::~ConvolutionAudioSource() {}
+
+//==============================================================================
+void ConvolutionAudioSource::setImpulseResponse (const AudioSampleBuffer& newResponse, const double sampleRate)
+{
+    jassert (sampleRate > 0);
+
+    const ScopedLock sl (impulseResponseLock);
+    impulseResponse = newResponse;
+    impulseResponseSampleRate = sampleRate;
+    updateConvolvers();
+}
+
+void ConvolutionAudioSource::clearImpulseResponse()
+{
+    const ScopedLock sl (impulseResponseLock);
+    impulseResponse.setSize (1, 0);
+    updateConvolvers();
+}
+
+void ConvolutionAudioSource::setPartitionSizes (const int newBlockSize, const int newMaxPartitionSize)
+{
+    const ScopedLock sl (impulseResponseLock);
+    blockSize = newBlockSize;
+    maxPartitionSize = newMaxPartitionSize;
+    updateConvolvers();
+}
+
+void ConvolutionAudioSource::setBypassed (const bool b) noexcept
+{
+    if (bypass != b)
+    {
+        bypass = b;
+
+        for (int i = convolvers.size(); --i >= 0;)
+            convolvers.getUnchecked (i)->reset();
+    }
+}
+
+void ConvolutionAudioSource::updateConvolvers()
+{
+    const int length = impulseResponse.getNumSamples();
+    const double ratio = currentSampleRate > 0 && impulseResponseSampleRate > 0
+                            ? impulseResponseSampleRate / currentSampleRate : 1.0;
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        const float* const source = impulseResponse.getSampleData (jmin (i, impulseResponse.getNumChannels() - 1));
+
+        if (length == 0 || ratio == 1.0)
+        {
+            convolvers.getUnchecked (i)->setImpulseResponse (source, length, blockSize, maxPartitionSize);
+            continue;
+        }
+
+        // Resample the response, skipping the interpolator's latency, and scaling it to keep
+        // the same gain at the new rate.
+        SincInterpolator interpolator (SincInterpolator::highQuality);
+        interpolator.prepareForRatio (ratio);
+
+        const int numToSkip = roundToInt (interpolator.getLatencyInInputSamples() / ratio);
+        const int numOut = (int) std::ceil (length / ratio);
+        const int numIn = (int) std::ceil ((numOut + numToSkip) * ratio) + 1;
+
+        HeapBlock<float> padded ((size_t) numIn, true), resampled ((size_t) (numOut + numToSkip));
+        memcpy (padded, source, sizeof (float) * (size_t) jmin (length, numIn));
+
+        interpolator.process (ratio, padded, resampled, numOut + numToSkip);
+        FloatVectorOperations::multiply (resampled + numToSkip, (float) ratio, numOut);
+
+        convolvers.getUnchecked (i)->setImpulseResponse (resampled + numToSkip, numOut, blockSize, maxPartitionSize);
+    }
+}
+
+//==============================================================================
+void ConvolutionAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    input->prepareToPlay (samplesPerBlockExpected, sampleRate);
+
+    const ScopedLock sl (impulseResponseLock);
+
+    if (sampleRate != currentSampleRate)
+    {
+        currentSampleRate = sampleRate;
+        updateConvolvers();
+    }
+
+    for (int i = convolvers.size(); --i >= 0;)
+        convolvers.getUnchecked (i)->reset();
+}
+
+void ConvolutionAudioSource::releaseResources()
+{
+    input->releaseResources();
+}
+
+void ConvolutionAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
+{
+    input->getNextAudioBlock (bufferToFill);
+
+    if (! bypass)
+    {
+        const int channelsToProcess = jmin (numChannels, bufferToFill.buffer->getNumChannels());
+
+        for (int i = 0; i < channelsToProcess; ++i)
+        {
+            float* const data = bufferToFill.buffer->getSampleData (i, bufferToFill.startSample);
+            convolvers.getUnchecked (i)->process (data, data, bufferToFill.numSamples);
+        }
+    }
+}
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_CONVOLUTIONAUDIOSOURCE_JUCEHEADER__
+#define __JUCE_CONVOLUTIONAUDIOSOURCE_JUCEHEADER__
+
+#include "juce_AudioSource.h"
+#include "../effects/juce_Convolution.h"
+
+
+//==============================================================================
+/**
+    An AudioSource that convolves another AudioSource with an impulse response.
+
+    Each channel of the input is convolved with the corresponding channel of the
+    impulse response. If the response has fewer channels, its last one is used for the
+    others. If the response was recorded at a different sample rate from the one the
+    source is played at, it's resampled when the source is prepared.
+
+    setImpulseResponse() can be called from any thread except the audio thread. The
+    new response is prepared on the calling thread, and then swapped in without
+    interrupting playback. To load a response from an audio file in the background,
+    see the ImpulseResponseLoader class in the juce_audio_formats module.
+
+    @see Convolution, ReverbAudioSource
+*/
+class JUCE_API  ConvolutionAudioSource  : public AudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a ConvolutionAudioSource to process a given input source.
+
+        @param inputSource              the input source to read from - this must not be null
+        @param deleteInputWhenDeleted   if true, the input source will be deleted when
+                                        this object is deleted
+        @param numChannels              the number of channels to process
+    */
+    ConvolutionAudioSource (AudioSource* inputSource,
+                            bool deleteInputWhenDeleted,
+                            int numChannels = 2);
+
+    /** Destructor. */
+    ~ConvolutionAudioSource();
+
+    //==============================================================================
+    /** Sets the impulse response to use.
+
+        @param impulseResponse      the response - its contents are copied
+        @param sampleRate           the sample rate at which the response was recorded
+    */
+    void setImpulseResponse (const AudioSampleBuffer& impulseResponse, double sampleRate);
+
+    /** Removes the impulse response, so the input is passed through unchanged. */
+    void clearImpulseResponse();
+
+    /** Changes the partitioning used for the convolution.
+        @see Convolution::setImpulseResponse
+    */
+    void setPartitionSizes (int blockSize, int maxPartitionSize);
+
+    void setBypassed (bool isBypassed) noexcept;
+    bool isBypassed() const noexcept                            { return bypass; }
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill);
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<AudioSource> input;
+    const int numChannels;
+    OwnedArray<Convolution> convolvers;
+    volatile bool bypass;
+
+    CriticalSection impulseResponseLock;
+    AudioSampleBuffer impulseResponse;
+    double impulseResponseSampleRate, currentSampleRate;
+    int blockSize, maxPartitionSize;
+
+    void updateConvolvers();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConvolutionAudioSource)
+};
+
+
+#endif   // __JUCE_CONVOLUTIONAUDIOSOURCE_JUCEHEADER__
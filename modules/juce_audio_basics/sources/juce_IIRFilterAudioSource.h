@@ -27,12 +27,15 @@
 #define __JUCE_IIRFILTERAUDIOSOURCE_JUCEHEADER__
 
 #include "juce_AudioSource.h"
-#include "../effects/juce_IIRFilter.h"
+#include "../effects/juce_BiquadCascade.h"
 
 
 //==============================================================================
 /**
     An AudioSource that performs an IIR filter on another source.
+
+    All the channels are filtered by a single BiquadCascade, so a source with
+    many channels is processed several channels at a time.
 */
 class JUCE_API  IIRFilterAudioSource  : public AudioSource
 {
@@ -54,6 +57,11 @@ public:
     /** Changes the filter to use the same parameters as the one being passed in. */
     void setFilterParameters (const IIRFilter& newSettings);
 
+    /** Sets the number of samples over which a change of filter parameters is smoothed.
+        @see BiquadCascade::setSmoothingLength
+    */
+    void setSmoothingLength (int numSamples);
+
     //==============================================================================
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
     void releaseResources();
@@ -62,7 +70,7 @@ public:
 private:
     //==============================================================================
     OptionalScopedPointer<AudioSource> input;
-    OwnedArray <IIRFilter> iirFilters;
+    BiquadCascade filter;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IIRFilterAudioSource)
 };
@@ -24,7 +24,8 @@
 */
 
 MixerAudioSource::MixerAudioSource()
-    : tempBuffer (2, 0),
+    : activeInputs (new InputList()),
+      tempBuffer (2, 0),
       currentSampleRate (0.0),
       bufferSizeExpected (0)
 {
@@ -33,18 +34,34 @@ MixerAudioSource::MixerAudioSource()
 MixerAudioSource::~MixerAudioSource()
 {
     removeAllInputs();
+    delete activeInputs.get();
 }
 
 //==============================================================================
+void MixerAudioSource::publish (InputList* const newList)
+{
+    // (must be called with the lock held)
+    ScopedPointer<InputList> oldList (activeInputs.exchange (newList));
+
+    // If the audio thread is inside getNextAudioBlock() now, it may have picked up the old
+    // list, so we have to wait for it to leave before the old list (or any of the sources
+    // that were removed) can be deleted.
+    audioThreadHandover.waitForAudioThread();
+}
+
 void MixerAudioSource::addInputSource (AudioSource* input, const bool deleteWhenRemoved)
 {
-    if (input != nullptr && ! inputs.contains (input))
+    if (input != nullptr)
     {
         double localRate;
         int localBufferSize;
 
         {
             const ScopedLock sl (lock);
+
+            if (activeInputs.get()->inputs.contains (input))
+                return;
+
             localRate = currentSampleRate;
             localBufferSize = bufferSizeExpected;
         }
@@ -54,8 +71,10 @@ void MixerAudioSource::addInputSource (AudioSource* input, const bool deleteWhen
 
         const ScopedLock sl (lock);
 
-        inputsToDelete.setBit (inputs.size(), deleteWhenRemoved);
-        inputs.add (input);
+        InputList* const newList = new InputList (*activeInputs.get());
+        newList->inputsToDelete.setBit (newList->inputs.size(), deleteWhenRemoved);
+        newList->inputs.add (input);
+        publish (newList);
     }
 }
 
@@ -67,16 +86,19 @@ void MixerAudioSource::removeInputSource (AudioSource* const input)
 
         {
             const ScopedLock sl (lock);
-            const int index = inputs.indexOf (input);
+            const int index = activeInputs.get()->inputs.indexOf (input);
 
             if (index < 0)
                 return;
 
-            if (inputsToDelete [index])
+            InputList* const newList = new InputList (*activeInputs.get());
+
+            if (newList->inputsToDelete [index])
                 toDelete = input;
 
-            inputsToDelete.shiftBits (-1, index);
-            inputs.remove (index);
+            newList->inputsToDelete.shiftBits (-1, index);
+            newList->inputs.remove (index);
+            publish (newList);
         }
 
         input->releaseResources();
@@ -89,12 +111,13 @@ void MixerAudioSource::removeAllInputs()
 
     {
         const ScopedLock sl (lock);
+        const InputList& oldList = *activeInputs.get();
 
-        for (int i = inputs.size(); --i >= 0;)
-            if (inputsToDelete[i])
-                toDelete.add (inputs.getUnchecked(i));
+        for (int i = oldList.inputs.size(); --i >= 0;)
+            if (oldList.inputsToDelete[i])
+                toDelete.add (oldList.inputs.getUnchecked(i));
 
-        inputs.clear();
+        publish (new InputList());
     }
 
     for (int i = toDelete.size(); --i >= 0;)
@@ -110,16 +133,20 @@ void MixerAudioSource::prepareToPlay (int samplesPerBlockExpected, double sample
     currentSampleRate = sampleRate;
     bufferSizeExpected = samplesPerBlockExpected;
 
-    for (int i = inputs.size(); --i >= 0;)
-        inputs.getUnchecked(i)->prepareToPlay (samplesPerBlockExpected, sampleRate);
+    const InputList& list = *activeInputs.get();
+
+    for (int i = list.inputs.size(); --i >= 0;)
+        list.inputs.getUnchecked(i)->prepareToPlay (samplesPerBlockExpected, sampleRate);
 }
 
 void MixerAudioSource::releaseResources()
 {
     const ScopedLock sl (lock);
 
-    for (int i = inputs.size(); --i >= 0;)
-        inputs.getUnchecked(i)->releaseResources();
+    const InputList& list = *activeInputs.get();
+
+    for (int i = list.inputs.size(); --i >= 0;)
+        list.inputs.getUnchecked(i)->releaseResources();
 
     tempBuffer.setSize (2, 0);
 
@@ -127,27 +154,83 @@ void MixerAudioSource::releaseResources()
     bufferSizeExpected = 0;
 }
 
+//==============================================================================
+namespace MixerHelpers
+{
+    // The inputs after the first are rendered this many at a time, and then summed into
+    // the destination in a single pass, rather than making a pass over it for each one.
+    enum { inputsPerPass = 4 };
+
+    static void addSources (float* const dest, const float* const* const sources,
+                            const int numSources, const int numSamples) noexcept
+    {
+        switch (numSources)
+        {
+            case 1:
+                FloatVectorOperations::add (dest, sources[0], numSamples);
+                break;
+
+            case 2:
+                for (int i = 0; i < numSamples; ++i)
+                    dest[i] += sources[0][i] + sources[1][i];
+                break;
+
+            case 3:
+                for (int i = 0; i < numSamples; ++i)
+                    dest[i] += sources[0][i] + sources[1][i] + sources[2][i];
+                break;
+
+            default:
+                jassert (numSources == inputsPerPass);
+
+                for (int i = 0; i < numSamples; ++i)
+                    dest[i] += (sources[0][i] + sources[1][i]) + (sources[2][i] + sources[3][i]);
+                break;
+        }
+    }
+}
+
 void MixerAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
-    const ScopedLock sl (lock);
+    const AudioThreadHandover::ScopedCallback sc (audioThreadHandover);
+    const InputList& list = *activeInputs.get();
+
+    const int numInputs = list.inputs.size();
 
-    if (inputs.size() > 0)
+    if (numInputs > 0)
     {
-        inputs.getUnchecked(0)->getNextAudioBlock (info);
+        list.inputs.getUnchecked(0)->getNextAudioBlock (info);
 
-        if (inputs.size() > 1)
+        if (numInputs > 1)
         {
-            tempBuffer.setSize (jmax (1, info.buffer->getNumChannels()),
-                                info.buffer->getNumSamples());
+            const int numChannels = jmax (1, info.buffer->getNumChannels());
+            const int maxPerPass = jmin ((int) MixerHelpers::inputsPerPass, numInputs - 1);
 
-            AudioSourceChannelInfo info2 (&tempBuffer, 0, info.numSamples);
+            tempBuffer.setSize (numChannels * maxPerPass, info.buffer->getNumSamples(), false, false, true);
 
-            for (int i = 1; i < inputs.size(); ++i)
+            for (int first = 1; first < numInputs; first += maxPerPass)
             {
-                inputs.getUnchecked(i)->getNextAudioBlock (info2);
+                const int numThisPass = jmin (maxPerPass, numInputs - first);
+
+                for (int j = 0; j < numThisPass; ++j)
+                {
+                    AudioSampleBuffer slot (tempBuffer.getArrayOfChannels() + j * numChannels,
+                                            numChannels, info.numSamples);
+
+                    AudioSourceChannelInfo info2 (&slot, 0, info.numSamples);
+                    list.inputs.getUnchecked (first + j)->getNextAudioBlock (info2);
+                }
 
                 for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
-                    info.buffer->addFrom (chan, info.startSample, tempBuffer, chan, 0, info.numSamples);
+                {
+                    const float* sources [MixerHelpers::inputsPerPass];
+
+                    for (int j = 0; j < numThisPass; ++j)
+                        sources[j] = tempBuffer.getSampleData (j * numChannels + chan);
+
+                    MixerHelpers::addSources (info.buffer->getSampleData (chan, info.startSample),
+                                              sources, numThisPass, info.numSamples);
+                }
             }
         }
     }
@@ -36,6 +36,13 @@
     Input sources can be added and removed while the mixer is running as long as their
     prepareToPlay() and releaseResources() methods are called before and after adding
     them to the mixer.
+
+    The audio thread never has to wait for a lock: changes to the set of inputs are made
+    by building a new list and publishing it atomically, and the methods that change the
+    inputs wait for any audio callback that might still be using the old list to finish
+    before they delete it. That means addInputSource(), removeInputSource() and
+    removeAllInputs() may block their caller (but not the audio thread) for up to one
+    callback, so don't call them from inside getNextAudioBlock().
 */
 class JUCE_API  MixerAudioSource  : public AudioSource
 {
@@ -90,13 +97,21 @@ public:
 
 private:
     //==============================================================================
-    Array <AudioSource*> inputs;
-    BigInteger inputsToDelete;
+    struct InputList
+    {
+        Array <AudioSource*> inputs;
+        BigInteger inputsToDelete;
+    };
+
+    Atomic <InputList*> activeInputs;
+    AudioThreadHandover audioThreadHandover;
     CriticalSection lock;
     AudioSampleBuffer tempBuffer;
     double currentSampleRate;
     int bufferSizeExpected;
 
+    void publish (InputList*);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixerAudioSource)
 };
 
@@ -252,3 +252,76 @@ void ResamplingAudioSource::applyFilter (float* samples, int num, FilterState& f
         *samples++ = (float) out;
     }
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ResamplingAudioSourceBenchmark  : public Benchmark
+{
+public:
+    ResamplingAudioSourceBenchmark (const int numChannels_)
+        : Benchmark ("ResamplingAudioSource: " + String (numChannels_) + " channels, 512 samples", 512),
+          numChannels (numChannels_),
+          buffer (numChannels_, 512)
+    {
+    }
+
+    // (so that the timings don't include generating the input)
+    struct NoiseSource  : public AudioSource
+    {
+        NoiseSource() : noise (1, 4096)
+        {
+            Random r (1);
+
+            for (int i = 0; i < noise.getNumSamples(); ++i)
+                *noise.getSampleData (0, i) = r.nextFloat() - 0.5f;
+        }
+
+        void prepareToPlay (int, double)    {}
+        void releaseResources()             {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info)
+        {
+            for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
+                info.buffer->copyFrom (chan, info.startSample, noise, 0, 0, jmin (info.numSamples, noise.getNumSamples()));
+        }
+
+        AudioSampleBuffer noise;
+    };
+
+    void initialise()
+    {
+        resampler = new ResamplingAudioSource (&source, false, numChannels);
+        resampler->setResamplingRatio (44100.0 / 48000.0);
+        resampler->prepareToPlay (512, 48000.0);
+    }
+
+    void runIteration()
+    {
+        AudioSourceChannelInfo info;
+        info.buffer = &buffer;
+        info.startSample = 0;
+        info.numSamples = buffer.getNumSamples();
+
+        resampler->getNextAudioBlock (info);
+        preventOptimisation (buffer.getSampleData (0));
+    }
+
+    void shutdown()
+    {
+        resampler->releaseResources();
+        resampler = nullptr;
+    }
+
+private:
+    const int numChannels;
+    NoiseSource source;
+    ScopedPointer<ResamplingAudioSource> resampler;
+    AudioSampleBuffer buffer;
+};
+
+static ResamplingAudioSourceBenchmark resamplingAudioSourceBenchmark1 (1);
+static ResamplingAudioSourceBenchmark resamplingAudioSourceBenchmark2 (2);
+static ResamplingAudioSourceBenchmark resamplingAudioSourceBenchmark8 (8);
+
+#endif
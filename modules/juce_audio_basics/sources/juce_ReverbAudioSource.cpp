@@ -49,9 +49,15 @@ void ReverbAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& bufferT
 
     if (! bypass)
     {
+        const int numChannels = bufferToFill.buffer->getNumChannels();
         float* const firstChannel = bufferToFill.buffer->getSampleData (0, bufferToFill.startSample);
 
-        if (bufferToFill.buffer->getNumChannels() > 1)
+        if (numChannels > 2)
+        {
+            reverb.processMultichannel (bufferToFill.buffer->getArrayOfChannels(), numChannels,
+                                        bufferToFill.startSample, bufferToFill.numSamples);
+        }
+        else if (numChannels > 1)
         {
             reverb.processStereo (firstChannel,
                                   bufferToFill.buffer->getSampleData (1, bufferToFill.startSample),
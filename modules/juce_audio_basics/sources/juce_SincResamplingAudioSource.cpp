@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+SincResamplingAudioSource::SincResamplingAudioSource (AudioSource* const inputSource,
+                                                      const bool deleteInputWhenDeleted,
+                                                      const int numChannels_,
+                                                      const SincInterpolator::Quality quality_)
+    : input (inputSource, deleteInputWhenDeleted),
+      ratio (1.0),
+      numChannels (numChannels_),
+      quality (quality_),
+      buffer (numChannels_, 0),
+      sampsInBuffer (0)
+{
+    jassert (input != nullptr);
+
+    for (int i = 0; i < numChannels; ++i)
+        interpolators.add (new SincInterpolator (quality));
+}
+
+SincResamplingAudioSource::~SincResamplingAudioSource() {}
+
+void SincResamplingAudioSource::setResamplingRatio (const double samplesInPerOutputSample)
+{
+    jassert (samplesInPerOutputSample > 0);
+
+    const SpinLock::ScopedLockType sl (ratioLock);
+    ratio = jmax (0.0, samplesInPerOutputSample);
+}
+
+int SincResamplingAudioSource::getLatencyInInputSamples() const noexcept
+{
+    return interpolators.size() > 0 ? interpolators.getUnchecked (0)->getLatencyInInputSamples() : 0;
+}
+
+void SincResamplingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    const SpinLock::ScopedLockType sl (ratioLock);
+
+    input->prepareToPlay (samplesPerBlockExpected, sampleRate);
+
+    buffer.setSize (numChannels, (int) std::ceil (samplesPerBlockExpected * ratio) + 32);
+    buffer.clear();
+    sampsInBuffer = 0;
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        SincInterpolator* const interpolator = interpolators.getUnchecked (i);
+        interpolator->prepareForRatio (ratio);
+        interpolator->reset();
+    }
+}
+
+void SincResamplingAudioSource::releaseResources()
+{
+    input->releaseResources();
+    buffer.setSize (numChannels, 0);
+}
+
+void SincResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    double localRatio;
+
+    {
+        const SpinLock::ScopedLockType sl (ratioLock);
+        localRatio = ratio;
+    }
+
+    const int sampsNeeded = (int) std::ceil (info.numSamples * localRatio) + 1;
+
+    if (buffer.getNumSamples() < sampsNeeded)
+        buffer.setSize (numChannels, sampsNeeded + 32, true, true);
+
+    if (sampsInBuffer < sampsNeeded)
+    {
+        AudioSourceChannelInfo readInfo (&buffer, sampsInBuffer, sampsNeeded - sampsInBuffer);
+        input->getNextAudioBlock (readInfo);
+        sampsInBuffer = sampsNeeded;
+    }
+
+    const int channelsToProcess = jmin (numChannels, info.buffer->getNumChannels());
+    int samplesUsed = 0;
+
+    for (int i = 0; i < channelsToProcess; ++i)
+    {
+        // all the interpolators see the same ratios, so will always use the same number of samples
+        samplesUsed = interpolators.getUnchecked (i)->process (localRatio, buffer.getSampleData (i),
+                                                               info.buffer->getSampleData (i, info.startSample),
+                                                               info.numSamples);
+    }
+
+    for (int i = channelsToProcess; i < info.buffer->getNumChannels(); ++i)
+        info.buffer->clear (i, info.startSample, info.numSamples);
+
+    jassert (samplesUsed <= sampsInBuffer);
+    sampsInBuffer -= samplesUsed;
+
+    if (samplesUsed > 0)
+        for (int i = 0; i < channelsToProcess; ++i)
+            memmove (buffer.getSampleData (i), buffer.getSampleData (i, samplesUsed), (size_t) sampsInBuffer * sizeof (float));
+}
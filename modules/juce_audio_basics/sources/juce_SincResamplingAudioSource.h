@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SINCRESAMPLINGAUDIOSOURCE_JUCEHEADER__
+#define __JUCE_SINCRESAMPLINGAUDIOSOURCE_JUCEHEADER__
+
+#include "juce_AudioSource.h"
+#include "../effects/juce_SincInterpolator.h"
+
+
+//==============================================================================
+/**
+    A type of AudioSource that takes an input source and changes its sample rate,
+    using a SincInterpolator for each channel.
+
+    This does the same job as ResamplingAudioSource, but with much less aliasing,
+    at the expense of more CPU and some latency (see getLatencyInInputSamples()).
+
+    @see ResamplingAudioSource, SincInterpolator, AudioSource
+*/
+class JUCE_API  SincResamplingAudioSource  : public AudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a SincResamplingAudioSource for a given input source.
+
+        @param inputSource              the input source to read from
+        @param deleteInputWhenDeleted   if true, the input source will be deleted when
+                                        this object is deleted
+        @param numChannels              the number of channels to process
+        @param quality                  the interpolation quality to use
+    */
+    SincResamplingAudioSource (AudioSource* inputSource,
+                               bool deleteInputWhenDeleted,
+                               int numChannels = 2,
+                               SincInterpolator::Quality quality = SincInterpolator::mediumQuality);
+
+    /** Destructor. */
+    ~SincResamplingAudioSource();
+
+    /** Changes the resampling ratio.
+
+        (This value can be changed at any time, even while the source is running, although
+        changing a down-sampling ratio will make the interpolators rebuild their filter tables,
+        which involves allocating memory).
+
+        @param samplesInPerOutputSample     if set to 1.0, the input is passed through; higher
+                                            values will speed it up; lower values will slow it
+                                            down. The ratio must be greater than 0
+    */
+    void setResamplingRatio (double samplesInPerOutputSample);
+
+    /** Returns the current resampling ratio.
+
+        This is the value that was set by setResamplingRatio().
+    */
+    double getResamplingRatio() const noexcept                  { return ratio; }
+
+    /** Returns the delay that the resampling filter introduces, measured in samples
+        of the input source.
+    */
+    int getLatencyInInputSamples() const noexcept;
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill);
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<AudioSource> input;
+    double ratio;
+    SpinLock ratioLock;
+    const int numChannels;
+    const SincInterpolator::Quality quality;
+    AudioSampleBuffer buffer;
+    int sampsInBuffer;
+    OwnedArray<SincInterpolator> interpolators;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SincResamplingAudioSource)
+};
+
+
+#endif   // __JUCE_SINCRESAMPLINGAUDIOSOURCE_JUCEHEADER__
@@ -33,7 +33,9 @@ SynthesiserSound::~SynthesiserSound()
 
 //==============================================================================
 SynthesiserVoice::SynthesiserVoice()
-    : currentSampleRate (44100.0),
+    : owner (nullptr),
+      freeListIndex (-1),
+      currentSampleRate (44100.0),
       currentlyPlayingNote (-1),
       noteOnTime (0),
       keyIsDown (false),
@@ -58,18 +60,115 @@ void SynthesiserVoice::setCurrentPlaybackSampleRate (const double newRate)
 
 void SynthesiserVoice::clearCurrentNote()
 {
+    if (owner != nullptr)
+        owner->voiceStopped (this);
+
     currentlyPlayingNote = -1;
     currentlyPlayingSound = nullptr;
 }
 
+//==============================================================================
+/** Renders a set of voices using the calling thread plus some worker threads.
+
+    Each thread claims voices one at a time from a shared counter, so the threads
+    that finish their voices soonest pick up the rest of the work. The calling
+    thread renders straight into the output buffer, and the workers render into
+    their own scratch buffers, which are summed into the output at the end.
+*/
+class Synthesiser::ParallelRenderer  : private WorkerThreadGroup::Job
+{
+public:
+    ParallelRenderer (const int numThreads)
+        : threads ("Synth rendering thread", numThreads),
+          output (nullptr),
+          voices (nullptr),
+          numVoices (0),
+          startSample (0),
+          numSamples (0),
+          scratchUsed ((size_t) numThreads, true)
+    {
+        for (int i = 0; i < numThreads; ++i)
+            scratchBuffers.add (new AudioSampleBuffer (1, 1));
+    }
+
+    int getNumThreads() const noexcept      { return threads.getNumThreads(); }
+
+    void render (SynthesiserVoice* const* const voices_, const int numVoices_,
+                 AudioSampleBuffer& outputBuffer, const int startSample_, const int numSamples_)
+    {
+        // (this only reallocates if the output has grown since the last block)
+        for (int i = scratchBuffers.size(); --i >= 0;)
+        {
+            scratchBuffers.getUnchecked(i)->setSize (outputBuffer.getNumChannels(), outputBuffer.getNumSamples(),
+                                                     false, false, true);
+            scratchUsed[i] = false;
+        }
+
+        output = &outputBuffer;
+        voices = voices_;
+        numVoices = numVoices_;
+        startSample = startSample_;
+        numSamples = numSamples_;
+        nextIndex = 0;
+
+        threads.run (*this);
+
+        for (int i = scratchBuffers.size(); --i >= 0;)
+            if (scratchUsed[i])
+                for (int chan = outputBuffer.getNumChannels(); --chan >= 0;)
+                    outputBuffer.addFrom (chan, startSample, *scratchBuffers.getUnchecked(i), chan, startSample, numSamples);
+    }
+
+private:
+    //==============================================================================
+    WorkerThreadGroup threads;
+    OwnedArray<AudioSampleBuffer> scratchBuffers;
+    Atomic<int> nextIndex;
+
+    AudioSampleBuffer* output;
+    SynthesiserVoice* const* voices;
+    int numVoices, startSample, numSamples;
+    HeapBlock<bool> scratchUsed;
+
+    // (thread 0 is the caller, which renders straight into the output buffer)
+    void runOnThread (const int thread)
+    {
+        AudioSampleBuffer& buffer = thread > 0 ? *scratchBuffers.getUnchecked (thread - 1) : *output;
+
+        for (;;)
+        {
+            const int voiceIndex = (++nextIndex) - 1;
+
+            if (voiceIndex >= numVoices)
+                break;
+
+            if (thread > 0 && ! scratchUsed [thread - 1])
+            {
+                scratchUsed [thread - 1] = true;
+                buffer.clear (startSample, numSamples);
+            }
+
+            voices [voiceIndex]->renderNextBlock (buffer, startSample, numSamples);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelRenderer)
+};
+
 //==============================================================================
 Synthesiser::Synthesiser()
     : sampleRate (0),
       lastNoteOnCounter (0),
-      shouldStealNotes (true)
+      minimumSubBlockSize (1),
+      shouldStealNotes (true),
+      numFreeVoices (0),
+      numFreeVoicesAllocated (0)
 {
     for (int i = 0; i < numElementsInArray (lastPitchWheelValues); ++i)
         lastPitchWheelValues[i] = 0x2000;
+
+    zerostruct (numVoicesPlayingNote);
+    updateSoundLookupTable();
 }
 
 Synthesiser::~Synthesiser()
@@ -87,17 +186,38 @@ void Synthesiser::clearVoices()
 {
     const ScopedLock sl (lock);
     voices.clear();
+    resetVoiceTracking();
 }
 
 void Synthesiser::addVoice (SynthesiserVoice* const newVoice)
 {
     const ScopedLock sl (lock);
     voices.add (newVoice);
+
+    // (the free list is allocated here so that it never needs to grow during rendering)
+    if (numFreeVoicesAllocated < voices.size())
+    {
+        numFreeVoicesAllocated = voices.size() + 8;
+        freeVoices.realloc ((size_t) numFreeVoicesAllocated);
+        activeVoices.realloc ((size_t) numFreeVoicesAllocated);
+    }
+
+    if (newVoice != nullptr)
+    {
+        newVoice->owner = this;
+
+        if (newVoice->currentlyPlayingNote < 0)
+            addToFreeList (newVoice);
+    }
 }
 
 void Synthesiser::removeVoice (const int index)
 {
     const ScopedLock sl (lock);
+
+    if (SynthesiserVoice* const voice = voices [index])
+        detachVoice (voice);
+
     voices.remove (index);
 }
 
@@ -105,18 +225,63 @@ void Synthesiser::clearSounds()
 {
     const ScopedLock sl (lock);
     sounds.clear();
+    updateSoundLookupTable();
 }
 
 void Synthesiser::addSound (const SynthesiserSound::Ptr& newSound)
 {
     const ScopedLock sl (lock);
     sounds.add (newSound);
+    updateSoundLookupTable();
 }
 
 void Synthesiser::removeSound (const int index)
 {
     const ScopedLock sl (lock);
     sounds.remove (index);
+    updateSoundLookupTable();
+}
+
+void Synthesiser::updateSoundLookupTable()
+{
+    const ScopedLock sl (lock);
+
+    // The table holds, for each channel and note, the sounds that apply to it, in the
+    // same order that noteOn() used to search them in.
+    const int numSounds = sounds.size();
+    HeapBlock<uint16> channelMasks ((size_t) numSounds + 1);
+    BigInteger notes;
+
+    for (int i = 0; i < numSounds; ++i)
+    {
+        SynthesiserSound* const sound = sounds.getUnchecked (i);
+        channelMasks[i] = 0;
+
+        for (int chan = 0; chan < 16; ++chan)
+            if (sound->appliesToChannel (chan + 1))
+                channelMasks[i] |= (uint16) (1 << chan);
+
+        for (int note = 0; note < 128; ++note)
+            if (sound->appliesToNote (note))
+                notes.setBit (i * 128 + note);
+    }
+
+    soundLookupTable.clearQuick();
+    soundLookupTableStarts.malloc (16 * 128 + 1);
+
+    for (int chan = 0; chan < 16; ++chan)
+    {
+        for (int note = 0; note < 128; ++note)
+        {
+            soundLookupTableStarts [chan * 128 + note] = soundLookupTable.size();
+
+            for (int i = numSounds; --i >= 0;)
+                if ((channelMasks[i] & (1 << chan)) != 0 && notes [i * 128 + note])
+                    soundLookupTable.add (sounds.getUnchecked (i));
+        }
+    }
+
+    soundLookupTableStarts [16 * 128] = soundLookupTable.size();
 }
 
 void Synthesiser::setNoteStealingEnabled (const bool shouldStealNotes_)
@@ -124,6 +289,33 @@ void Synthesiser::setNoteStealingEnabled (const bool shouldStealNotes_)
     shouldStealNotes = shouldStealNotes_;
 }
 
+void Synthesiser::setMinimumRenderingSubdivisionSize (const int numSamples) noexcept
+{
+    jassert (numSamples > 0); // it wouldn't make much sense for this to be less than 1!
+    minimumSubBlockSize = jmax (1, numSamples);
+}
+
+void Synthesiser::setNumRenderingThreads (int numThreads)
+{
+    numThreads = jmax (0, numThreads);
+
+    if (numThreads != getNumRenderingThreads())
+    {
+        ScopedPointer<ParallelRenderer> newRenderer;
+
+        if (numThreads > 0)
+            newRenderer = new ParallelRenderer (numThreads);
+
+        const ScopedLock sl (lock);
+        parallelRenderer.swapWith (newRenderer);
+    }
+}
+
+int Synthesiser::getNumRenderingThreads() const noexcept
+{
+    return parallelRenderer != nullptr ? parallelRenderer->getNumThreads() : 0;
+}
+
 //==============================================================================
 void Synthesiser::setCurrentPlaybackSampleRate (const double newRate)
 {
@@ -157,23 +349,53 @@ void Synthesiser::renderNextBlock (AudioSampleBuffer& outputBuffer,
     while (numSamples > 0)
     {
         int midiEventPos;
-        const bool useEvent = midiIterator.getNextEvent (m, midiEventPos)
-                                && midiEventPos < startSample + numSamples;
 
-        const int numThisTime = useEvent ? midiEventPos - startSample
-                                         : numSamples;
+        if (! (midiIterator.getNextEvent (m, midiEventPos)
+                && midiEventPos < startSample + numSamples))
+        {
+            renderVoices (outputBuffer, startSample, numSamples);
+            break;
+        }
 
-        if (numThisTime > 0)
+        // Events that are too close to the start of this sub-block get handled straight
+        // away, rather than splitting the block into tiny pieces..
+        const int samplesToNextEvent = midiEventPos - startSample;
+
+        if (samplesToNextEvent >= minimumSubBlockSize)
         {
-            for (int i = voices.size(); --i >= 0;)
-                voices.getUnchecked (i)->renderNextBlock (outputBuffer, startSample, numThisTime);
+            renderVoices (outputBuffer, startSample, samplesToNextEvent);
+            startSample += samplesToNextEvent;
+            numSamples -= samplesToNextEvent;
         }
 
-        if (useEvent)
-            handleMidiEvent (m);
+        handleMidiEvent (m);
+    }
+}
+
+void Synthesiser::renderVoices (AudioSampleBuffer& outputBuffer, const int startSample, const int numSamples)
+{
+    if (parallelRenderer != nullptr && voices.size() <= numFreeVoicesAllocated)
+    {
+        int numActive = 0;
 
-        startSample += numThisTime;
-        numSamples -= numThisTime;
+        for (int i = voices.size(); --i >= 0;)
+            if (voices.getUnchecked (i)->currentlyPlayingNote >= 0)
+                activeVoices [numActive++] = voices.getUnchecked (i);
+
+        if (numActive > 1)
+        {
+            parallelRenderer->render (activeVoices, numActive, outputBuffer, startSample, numSamples);
+            return;
+        }
+    }
+
+    for (int i = voices.size(); --i >= 0;)
+    {
+        SynthesiserVoice* const voice = voices.getUnchecked (i);
+
+        // (a voice that isn't playing a note is silent, so there's no need to call it)
+        if (voice->currentlyPlayingNote >= 0)
+            voice->renderNextBlock (outputBuffer, startSample, numSamples);
     }
 }
 
@@ -218,28 +440,45 @@ void Synthesiser::noteOn (const int midiChannel,
 {
     const ScopedLock sl (lock);
 
-    for (int i = sounds.size(); --i >= 0;)
+    if (isPositiveAndBelow (midiChannel - 1, 16) && isPositiveAndBelow (midiNoteNumber, 128))
     {
-        SynthesiserSound* const sound = sounds.getUnchecked(i);
+        const int index = (midiChannel - 1) * 128 + midiNoteNumber;
 
-        if (sound->appliesToNote (midiNoteNumber)
-             && sound->appliesToChannel (midiChannel))
+        for (int i = soundLookupTableStarts [index]; i < soundLookupTableStarts [index + 1]; ++i)
+            startNoteForSound (soundLookupTable.getUnchecked (i), midiChannel, midiNoteNumber, velocity);
+    }
+    else
+    {
+        for (int i = sounds.size(); --i >= 0;)
         {
-            // If hitting a note that's still ringing, stop it first (it could be
-            // still playing because of the sustain or sostenuto pedal).
-            for (int j = voices.size(); --j >= 0;)
-            {
-                SynthesiserVoice* const voice = voices.getUnchecked (j);
+            SynthesiserSound* const sound = sounds.getUnchecked(i);
 
-                if (voice->getCurrentlyPlayingNote() == midiNoteNumber
-                     && voice->isPlayingChannel (midiChannel))
-                    stopVoice (voice, true);
-            }
+            if (sound->appliesToNote (midiNoteNumber)
+                 && sound->appliesToChannel (midiChannel))
+                startNoteForSound (sound, midiChannel, midiNoteNumber, velocity);
+        }
+    }
+}
 
-            startVoice (findFreeVoice (sound, shouldStealNotes),
-                        sound, midiChannel, midiNoteNumber, velocity);
+void Synthesiser::startNoteForSound (SynthesiserSound* const sound, const int midiChannel,
+                                     const int midiNoteNumber, const float velocity)
+{
+    // If hitting a note that's still ringing, stop it first (it could be
+    // still playing because of the sustain or sostenuto pedal).
+    if (! isPositiveAndBelow (midiNoteNumber, 128) || numVoicesPlayingNote [midiNoteNumber] > 0)
+    {
+        for (int j = voices.size(); --j >= 0;)
+        {
+            SynthesiserVoice* const voice = voices.getUnchecked (j);
+
+            if (voice->getCurrentlyPlayingNote() == midiNoteNumber
+                 && voice->isPlayingChannel (midiChannel))
+                stopVoice (voice, true);
         }
     }
+
+    startVoice (findFreeVoice (sound, shouldStealNotes),
+                sound, midiChannel, midiNoteNumber, velocity);
 }
 
 void Synthesiser::startVoice (SynthesiserVoice* const voice,
@@ -253,10 +492,21 @@ void Synthesiser::startVoice (SynthesiserVoice* const voice,
         if (voice->currentlyPlayingSound != nullptr)
             voice->stopNote (false);
 
+        voice->owner = this;
+
+        if (voice->currentlyPlayingNote >= 0)
+            voiceStopped (voice);
+
+        removeFromFreeList (voice);
+
         voice->startNote (midiNoteNumber, velocity, sound,
                           lastPitchWheelValues [midiChannel - 1]);
 
         voice->currentlyPlayingNote = midiNoteNumber;
+
+        if (isPositiveAndBelow (midiNoteNumber, 128))
+            ++numVoicesPlayingNote [midiNoteNumber];
+
         voice->noteOnTime = ++lastNoteOnCounter;
         voice->currentlyPlayingSound = sound;
         voice->keyIsDown = true;
@@ -280,6 +530,9 @@ void Synthesiser::noteOff (const int midiChannel,
 {
     const ScopedLock sl (lock);
 
+    if (isPositiveAndBelow (midiNoteNumber, 128) && numVoicesPlayingNote [midiNoteNumber] == 0)
+        return;
+
     for (int i = voices.size(); --i >= 0;)
     {
         SynthesiserVoice* const voice = voices.getUnchecked (i);
@@ -406,6 +659,16 @@ SynthesiserVoice* Synthesiser::findFreeVoice (SynthesiserSound* soundToPlay,
 {
     const ScopedLock sl (lock);
 
+    for (int i = numFreeVoices; --i >= 0;)
+    {
+        SynthesiserVoice* const voice = freeVoices[i];
+        jassert (voice->getCurrentlyPlayingNote() < 0);
+
+        if (voice->canPlaySound (soundToPlay))
+            return voice;
+    }
+
+    // (this catches any voices that were added to the array without using addVoice())
     for (int i = voices.size(); --i >= 0;)
         if (voices.getUnchecked (i)->getCurrentlyPlayingNote() < 0
              && voices.getUnchecked (i)->canPlaySound (soundToPlay))
@@ -431,3 +694,275 @@ SynthesiserVoice* Synthesiser::findFreeVoice (SynthesiserSound* soundToPlay,
 
     return nullptr;
 }
+
+//==============================================================================
+void Synthesiser::voiceStopped (SynthesiserVoice* const voice) noexcept
+{
+    // (this can be called by voices that are being rendered on different threads)
+    const SpinLock::ScopedLockType sl (voiceTrackingLock);
+
+    const int note = voice->currentlyPlayingNote;
+
+    if (note >= 0)
+    {
+        if (isPositiveAndBelow (note, 128))
+        {
+            jassert (numVoicesPlayingNote [note] > 0);
+            --numVoicesPlayingNote [note];
+        }
+
+        addToFreeList (voice);
+    }
+}
+
+void Synthesiser::addToFreeList (SynthesiserVoice* const voice) noexcept
+{
+    if (voice->freeListIndex < 0 && numFreeVoices < numFreeVoicesAllocated)
+    {
+        voice->freeListIndex = numFreeVoices;
+        freeVoices [numFreeVoices++] = voice;
+    }
+}
+
+void Synthesiser::removeFromFreeList (SynthesiserVoice* const voice) noexcept
+{
+    const int index = voice->freeListIndex;
+
+    if (index >= 0)
+    {
+        jassert (freeVoices [index] == voice);
+
+        SynthesiserVoice* const last = freeVoices [--numFreeVoices];
+        freeVoices [index] = last;
+        last->freeListIndex = index;
+        voice->freeListIndex = -1;
+    }
+}
+
+void Synthesiser::detachVoice (SynthesiserVoice* const voice) noexcept
+{
+    if (voice->owner == this)
+    {
+        if (isPositiveAndBelow (voice->currentlyPlayingNote, 128))
+            --numVoicesPlayingNote [voice->currentlyPlayingNote];
+
+        removeFromFreeList (voice);
+        voice->owner = nullptr;
+    }
+}
+
+void Synthesiser::resetVoiceTracking()
+{
+    numFreeVoices = 0;
+    zerostruct (numVoicesPlayingNote);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SynthesiserTests  : public UnitTest
+{
+public:
+    SynthesiserTests() : UnitTest ("Synthesiser") {}
+
+    struct TestSound  : public SynthesiserSound
+    {
+        TestSound (int lowestNote_, int highestNote_, int channel_)
+            : lowestNote (lowestNote_), highestNote (highestNote_), channel (channel_) {}
+
+        bool appliesToNote (const int note)     { return note >= lowestNote && note <= highestNote; }
+        bool appliesToChannel (const int chan)  { return channel <= 0 || chan == channel; }
+
+        int lowestNote, highestNote, channel;
+    };
+
+    struct TestVoice  : public SynthesiserVoice
+    {
+        TestVoice() : numBlocksRendered (0) {}
+
+        bool canPlaySound (SynthesiserSound*)                   { return true; }
+        void startNote (int, float, SynthesiserSound*, int)     {}
+        void stopNote (bool)                                    { clearCurrentNote(); }
+        void pitchWheelMoved (int)                              {}
+        void controllerMoved (int, int)                         {}
+
+        void renderNextBlock (AudioSampleBuffer&, int, int)   { ++numBlocksRendered; }
+
+        int numBlocksRendered;
+    };
+
+    // Adds a ramp that depends on the note, and stops itself after a while
+    struct RampVoice  : public SynthesiserVoice
+    {
+        RampVoice() : level (0), samplesLeft (0) {}
+
+        bool canPlaySound (SynthesiserSound*)                   { return true; }
+        void stopNote (bool)                                    { clearCurrentNote(); }
+        void pitchWheelMoved (int)                              {}
+        void controllerMoved (int, int)                         {}
+
+        void startNote (int note, float, SynthesiserSound*, int)
+        {
+            level = note * 0.001f;
+            samplesLeft = 100 + note * 7;
+        }
+
+        void renderNextBlock (AudioSampleBuffer& buffer, int startSample, int numSamples)
+        {
+            for (int i = startSample; i < startSample + numSamples; ++i)
+            {
+                for (int chan = buffer.getNumChannels(); --chan >= 0;)
+                    *buffer.getSampleData (chan, i) += level * (chan + 1);
+
+                level *= 0.999f;
+
+                if (--samplesLeft <= 0)
+                {
+                    clearCurrentNote();
+                    break;
+                }
+            }
+        }
+
+        float level;
+        int samplesLeft;
+    };
+
+    void renderRamps (AudioSampleBuffer& result, const int numThreads)
+    {
+        Synthesiser synth;
+        synth.setCurrentPlaybackSampleRate (44100.0);
+        synth.setNumRenderingThreads (numThreads);
+        expectEquals (synth.getNumRenderingThreads(), numThreads);
+        synth.setMinimumRenderingSubdivisionSize (32);
+        synth.addSound (new TestSound (0, 127, 0));
+
+        for (int i = 0; i < 24; ++i)
+            synth.addVoice (new RampVoice());
+
+        Random r (1234);
+        result.clear();
+
+        for (int block = 0; block < result.getNumSamples() / 256; ++block)
+        {
+            MidiBuffer midi;
+
+            for (int i = 0; i < 8; ++i)
+                midi.addEvent (MidiMessage::noteOn (1, r.nextInt (128), 1.0f), r.nextInt (256));
+
+            synth.renderNextBlock (result, midi, block * 256, 256);
+        }
+    }
+
+    static int countVoicesPlaying (Synthesiser& synth)
+    {
+        int n = 0;
+
+        for (int i = synth.getNumVoices(); --i >= 0;)
+            if (synth.getVoice (i)->getCurrentlyPlayingNote() >= 0)
+                ++n;
+
+        return n;
+    }
+
+    void runTest()
+    {
+        beginTest ("Voice allocation");
+
+        Synthesiser synth;
+        synth.setCurrentPlaybackSampleRate (44100.0);
+        synth.addSound (new TestSound (36, 59, 1));
+        synth.addSound (new TestSound (60, 96, 0));
+
+        for (int i = 0; i < 8; ++i)
+            synth.addVoice (new TestVoice());
+
+        synth.noteOn (2, 40, 1.0f);
+        expectEquals (countVoicesPlaying (synth), 0);
+        synth.noteOn (1, 40, 1.0f);
+        synth.noteOn (3, 70, 1.0f);
+        expectEquals (countVoicesPlaying (synth), 2);
+
+        synth.noteOff (1, 40, true);
+        expectEquals (countVoicesPlaying (synth), 1);
+
+        for (int i = 0; i < 10; ++i)
+            synth.noteOn (1, 60 + i, 1.0f);
+
+        expectEquals (countVoicesPlaying (synth), 8);
+
+        synth.setNoteStealingEnabled (false);
+        synth.noteOn (1, 90, 1.0f);
+        expectEquals (countVoicesPlaying (synth), 8);
+
+        synth.allNotesOff (0, false);
+        expectEquals (countVoicesPlaying (synth), 0);
+
+        synth.noteOn (1, 50, 1.0f);
+        synth.noteOn (1, 50, 1.0f);
+        expectEquals (countVoicesPlaying (synth), 1);
+
+        synth.removeSound (0);
+        synth.noteOn (1, 41, 1.0f);
+        expectEquals (countVoicesPlaying (synth), 1);
+
+        synth.removeVoice (0);
+        synth.noteOff (1, 50, false);
+        expectEquals (countVoicesPlaying (synth), 0);
+
+        beginTest ("Rendering subdivision");
+
+        MidiBuffer midi;
+
+        for (int i = 0; i < 512; i += 5)
+            midi.addEvent (MidiMessage::controllerEvent (1, 1, i & 127), i);
+
+        midi.addEvent (MidiMessage::noteOn (1, 72, 1.0f), 0);
+
+        AudioSampleBuffer buffer (1, 512);
+
+        for (int subdivision = 1; subdivision <= 64; subdivision *= 4)
+        {
+            synth.allNotesOff (0, false);
+            synth.setMinimumRenderingSubdivisionSize (subdivision);
+            synth.renderNextBlock (buffer, midi, 0, 512);
+
+            TestVoice* playingVoice = nullptr;
+
+            for (int i = synth.getNumVoices(); --i >= 0;)
+                if (synth.getVoice (i)->getCurrentlyPlayingNote() == 72)
+                    playingVoice = static_cast <TestVoice*> (synth.getVoice (i));
+
+            expect (playingVoice != nullptr);
+
+            if (playingVoice != nullptr)
+            {
+                if (subdivision == 1)
+                    expectEquals (playingVoice->numBlocksRendered, 103);
+                else
+                    expect (playingVoice->numBlocksRendered <= 512 / subdivision + 1);
+
+                playingVoice->numBlocksRendered = 0;
+            }
+        }
+
+        beginTest ("Multi-threaded rendering");
+
+        AudioSampleBuffer serial (2, 256 * 40), parallel (2, 256 * 40);
+        renderRamps (serial, 0);
+        renderRamps (parallel, 3);
+
+        bool matches = true;
+
+        for (int chan = 0; chan < 2; ++chan)
+            for (int i = 0; i < serial.getNumSamples(); ++i)
+                matches = matches && std::abs (*serial.getSampleData (chan, i) - *parallel.getSampleData (chan, i)) < 0.0001f;
+
+        expect (serial.getMagnitude (0, serial.getNumSamples()) > 0.1f);
+        expect (matches, "parallel rendering didn't match serial rendering");
+    }
+};
+
+static SynthesiserTests synthesiserTests;
+
+#endif
@@ -29,6 +29,8 @@
 #include "../buffers/juce_AudioSampleBuffer.h"
 #include "../midi/juce_MidiBuffer.h"
 
+class Synthesiser;
+
 
 //==============================================================================
 /**
@@ -58,6 +60,10 @@ public:
 
         The Synthesiser will use this information when deciding which sounds to trigger
         for a given note.
+
+        The synthesiser caches the results of appliesToNote() and appliesToChannel() when
+        the sound is added, so if a sound changes the range that it responds to, you'll need
+        to call Synthesiser::updateSoundLookupTable().
     */
     virtual bool appliesToNote (const int midiNoteNumber) = 0;
 
@@ -224,6 +230,8 @@ private:
     //==============================================================================
     friend class Synthesiser;
 
+    Synthesiser* owner;
+    int freeListIndex;
     double currentSampleRate;
     int currentlyPlayingNote;
     uint32 noteOnTime;
@@ -315,6 +323,15 @@ public:
     /** Removes and deletes one of the sounds. */
     void removeSound (int index);
 
+    /** Rebuilds the table that the synth uses to find the sounds for a note.
+
+        When a sound is added or removed, the synth asks every sound which notes and channels
+        it applies to, so that noteOn() can find matching sounds without having to call their
+        appliesToNote() and appliesToChannel() methods each time. If any of your sounds change
+        the notes or channels they respond to after being added, call this to update the table.
+    */
+    void updateSoundLookupTable();
+
     //==============================================================================
     /** If set to true, then the synth will try to take over an existing voice if
         it runs out and needs to play another note.
@@ -329,6 +346,46 @@ public:
     */
     bool isNoteStealingEnabled() const                              { return shouldStealNotes; }
 
+    //==============================================================================
+    /** Sets the smallest number of samples that renderNextBlock() will render in one go.
+
+        By default, the synth splits its buffer at every midi event, so the voices are
+        called for each sub-range between one event and the next. When there's a lot of
+        midi data and many voices, that can mean a lot of very small blocks.
+
+        If you set this to a value greater than 1, then any events that occur less than
+        this many samples after the start of the current sub-block are handled at the start
+        of that block instead, so the voices always render at least this many samples at
+        a time (except at the end of the buffer). This trades some timing accuracy for
+        much less overhead.
+    */
+    void setMinimumRenderingSubdivisionSize (int numSamples) noexcept;
+
+    /** Returns the value set by setMinimumRenderingSubdivisionSize(). */
+    int getMinimumRenderingSubdivisionSize() const noexcept         { return minimumSubBlockSize; }
+
+    /** Sets the number of extra threads that will be used to render the voices.
+
+        When this is greater than zero, renderNextBlock() shares the voices that are
+        playing between the calling thread and this many worker threads. Each worker
+        renders its voices into its own scratch buffer, which is then added to the output.
+
+        Each voice is only ever rendered by one thread at a time, but different voices can
+        be rendered at the same time, so voices must not modify any state that they share
+        with other voices from inside their renderNextBlock() method. SamplerVoice is safe
+        to use like this.
+
+        The per-sub-block cost of waking the workers means this works best when combined
+        with setMinimumRenderingSubdivisionSize(), and with plenty of voices playing.
+
+        Passing zero (the default) renders all the voices on the calling thread. This
+        should be called from the message thread.
+    */
+    void setNumRenderingThreads (int numThreads);
+
+    /** Returns the number of worker threads that were set with setNumRenderingThreads(). */
+    int getNumRenderingThreads() const noexcept;
+
     //==============================================================================
     /** Triggers a note-on event.
 
@@ -474,13 +531,35 @@ protected:
 
 private:
     //==============================================================================
+    friend class SynthesiserVoice;
+
     double sampleRate;
     uint32 lastNoteOnCounter;
+    int minimumSubBlockSize;
     bool shouldStealNotes;
     BigInteger sustainPedalsDown;
 
+    HeapBlock<SynthesiserVoice*> freeVoices, activeVoices;
+    int numFreeVoices, numFreeVoicesAllocated;
+    SpinLock voiceTrackingLock;
+    int numVoicesPlayingNote [128];
+
+    Array<SynthesiserSound*> soundLookupTable;
+    HeapBlock<int> soundLookupTableStarts;
+
+    class ParallelRenderer;
+    friend class ScopedPointer<ParallelRenderer>;
+    ScopedPointer<ParallelRenderer> parallelRenderer;
+
     void handleMidiEvent (const MidiMessage& m);
     void stopVoice (SynthesiserVoice* voice, bool allowTailOff);
+    void startNoteForSound (SynthesiserSound*, int midiChannel, int midiNoteNumber, float velocity);
+    void renderVoices (AudioSampleBuffer&, int startSample, int numSamples);
+    void voiceStopped (SynthesiserVoice*) noexcept;
+    void addToFreeList (SynthesiserVoice*) noexcept;
+    void removeFromFreeList (SynthesiserVoice*) noexcept;
+    void detachVoice (SynthesiserVoice*) noexcept;
+    void resetVoiceTracking();
 
    #if JUCE_CATCH_DEPRECATED_CODE_MISUSE
     // Note the new parameters for this method.
@@ -0,0 +1,1029 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+/*  One direction of the connection between the master and one of its slaves.
+
+    The producer pushes blocks into a FIFO whenever its device calls back. The consumer
+    pulls them out through a SincInterpolator per channel, and trims the interpolators'
+    ratio to hold the FIFO at a constant level. The level is smoothed to hide the jitter
+    of the two devices' block sizes, and then goes through a critically-damped PI loop,
+    so the ratio settles on the ratio of the two clocks, and the latency stays constant.
+*/
+class AggregateAudioIODevice::Link
+{
+public:
+    Link (const int numChannels_, const int producerBlockSize, const int consumerBlockSize,
+          const double sampleRate_, const SincInterpolator::Quality quality)
+        : numChannels (numChannels_),
+          maxChunk (jmax (1, consumerBlockSize)),
+          targetLevel (producerBlockSize + consumerBlockSize + jmax (producerBlockSize, consumerBlockSize)),
+          fifo (nextPowerOfTwo (4 * targetLevel)),
+          buffer (numChannels_, fifo.getTotalSize()),
+          scratch (numChannels_, (int) std::ceil (maxChunk * (1.0 + maxCorrection)) + 4),
+          scratchChannels (scratch.getArrayOfChannels()),
+          numUsed ((size_t) numChannels_, true),
+          discard ((size_t) maxChunk),
+          sampleRate (sampleRate_),
+          ticksToSamples (sampleRate_ / (double) Time::getHighResolutionTicksPerSecond()),
+          proportionalGain (1.0 / (responseTime * sampleRate_)),
+          consumerIsRunning (false),
+          smoothedLevel (0), integral (0), ratio (1.0),
+          start1 (0), size1 (0), start2 (0), size2 (0), pullSize (0)
+    {
+        jassert (numChannels > 0);
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            SincInterpolator* const interpolator = new SincInterpolator (quality);
+            interpolator->prepareForRatio (1.0 + maxCorrection);
+            interpolators.add (interpolator);
+        }
+    }
+
+    //==============================================================================
+    // These are called by the producer's thread..
+
+    void push (const float** const data, const int numAvailable, const int numSamples) noexcept
+    {
+        int s1, n1, s2, n2;
+        fifo.prepareToWrite (numSamples, s1, n1, s2, n2);
+
+        if (n1 + n2 < numSamples)
+        {
+            // (the consumer has stalled, so this block has to be dropped)
+            if (consumerHasStarted.get() != 0)
+                ++numXRuns;
+
+            return;
+        }
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            const float* const src = i < numAvailable ? data[i] : nullptr;
+
+            if (src != nullptr)
+            {
+                buffer.copyFrom (i, s1, src, n1);
+
+                if (n2 > 0)
+                    buffer.copyFrom (i, s2, src + n1, n2);
+            }
+            else
+            {
+                buffer.clear (i, s1, n1);
+
+                if (n2 > 0)
+                    buffer.clear (i, s2, n2);
+            }
+        }
+
+        fifo.finishedWrite (n1 + n2);
+        lastPushTime = Time::getHighResolutionTicks();
+        lastPushSize = numSamples;
+    }
+
+    //==============================================================================
+    // ..and these are called by the consumer's thread.
+
+    /*  Checks that there's enough data for a block, and works out the ratio to use for it.
+        If this returns true, call pullChannel() for every channel, then finishPull().
+    */
+    bool startPull (const int numSamples) noexcept
+    {
+        jassert (numSamples <= maxChunk);
+        int numReady = fifo.getNumReady();
+
+        if (! consumerIsRunning || numReady > 3 * targetLevel)
+        {
+            if (numReady < targetLevel)
+                return false;
+
+            // Skip anything that built up while we weren't reading, so that the latency
+            // starts off at the target level..
+            if (consumerIsRunning)
+                ++numXRuns;
+
+            fifo.finishedRead (numReady - targetLevel);
+            numReady = targetLevel;
+
+            for (int i = 0; i < numChannels; ++i)
+                interpolators.getUnchecked(i)->reset();
+
+            smoothedLevel = numReady;
+            consumerIsRunning = true;
+            consumerHasStarted = 1;
+        }
+
+        // The FIFO's level jumps each time a block arrives, and sampling that sawtooth at the
+        // consumer's blocks would give a level that wanders as the two devices' phases drift
+        // past each other. Adding on the time since the last block arrived gives a level that
+        // doesn't depend on when it's measured.
+        const double sinceLastPush = (double) (Time::getHighResolutionTicks() - lastPushTime.get()) * ticksToSamples;
+        updateRatio (numReady + jlimit (0.0, (double) lastPushSize.get(), sinceLastPush), numSamples);
+
+        const int numNeeded = (int) std::ceil (ratio * numSamples) + 2;
+
+        if (numReady < numNeeded)
+        {
+            ++numXRuns;
+            consumerIsRunning = false;
+            return false;
+        }
+
+        fifo.prepareToRead (numNeeded, start1, size1, start2, size2);
+        pullSize = numSamples;
+        return true;
+    }
+
+    // (this may be called for different channels on different threads at the same time)
+    void pullChannel (const int channel, float* const dest) noexcept
+    {
+        const float* src = buffer.getReadPointer (channel, start1);
+
+        if (size2 > 0)
+        {
+            float* const joined = scratchChannels [channel];
+            FloatVectorOperations::copy (joined, src, size1);
+            FloatVectorOperations::copy (joined + size1, buffer.getReadPointer (channel, start2), size2);
+            src = joined;
+        }
+
+        numUsed [channel] = interpolators.getUnchecked (channel)->process (ratio, src, dest, pullSize);
+    }
+
+    void finishPull() noexcept
+    {
+        // (all the interpolators have the same state, so they'll all have used the same amount)
+        jassert (numUsed [numChannels - 1] == numUsed [0]);
+        fifo.finishedRead (numUsed [0]);
+        pullSize = 0;
+    }
+
+    void pull (float** const dest, const int numDest, const int numSamples) noexcept
+    {
+        for (int pos = 0; pos < numSamples;)
+        {
+            const int num = jmin (maxChunk, numSamples - pos);
+
+            if (startPull (num))
+            {
+                for (int i = 0; i < numChannels; ++i)
+                    pullChannel (i, (i < numDest && dest[i] != nullptr) ? dest[i] + pos : discard.getData());
+
+                finishPull();
+            }
+            else
+            {
+                for (int i = jmin (numChannels, numDest); --i >= 0;)
+                    if (dest[i] != nullptr)
+                        zeromem (dest[i] + pos, sizeof (float) * (size_t) num);
+            }
+
+            for (int i = numChannels; i < numDest; ++i)
+                if (dest[i] != nullptr)
+                    zeromem (dest[i] + pos, sizeof (float) * (size_t) num);
+
+            pos += num;
+        }
+    }
+
+    bool isPulling() const noexcept             { return pullSize > 0; }
+
+    //==============================================================================
+    double getCorrection() const noexcept       { return reportedCorrection.get() * 1.0e-9; }
+    int getLatency() const noexcept             { return targetLevel + interpolators.getUnchecked(0)->getLatencyInInputSamples(); }
+
+    const int numChannels, maxChunk, targetLevel;
+    Atomic<int> numXRuns;
+
+private:
+    //==============================================================================
+    AbstractFifo fifo;
+    AudioSampleBuffer buffer, scratch;
+    float* const* scratchChannels;
+    OwnedArray<SincInterpolator> interpolators;
+    HeapBlock<int> numUsed;
+    HeapBlock<float> discard;
+
+    const double sampleRate, ticksToSamples, proportionalGain;
+    bool consumerIsRunning;
+    Atomic<int> consumerHasStarted, reportedCorrection, lastPushSize;
+    Atomic<int64> lastPushTime;
+    double smoothedLevel, integral, ratio;
+    int start1, size1, start2, size2, pullSize;
+
+    static const double maxCorrection, responseTime, smoothingTime;
+
+    void updateRatio (const double level, const int numSamples) noexcept
+    {
+        const double blockTime = numSamples / sampleRate;
+        smoothedLevel += (level - smoothedLevel) * (1.0 - std::exp (-blockTime / smoothingTime));
+
+        // With the FIFO's level acting as an integrator, an integral gain of kp^2/4
+        // gives critical damping, so the level settles without overshooting..
+        const double error = smoothedLevel - targetLevel;
+        integral = jlimit (-maxCorrection, maxCorrection,
+                           integral + error * proportionalGain * proportionalGain * 0.25 * numSamples);
+
+        const double correction = jlimit (-maxCorrection, maxCorrection, integral + error * proportionalGain);
+        ratio = 1.0 + correction;
+        reportedCorrection = roundToInt (integral * 1.0e9);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Link)
+};
+
+// (these keep the ratio within the range that the interpolators were prepared for)
+const double AggregateAudioIODevice::Link::maxCorrection = 0.005;
+const double AggregateAudioIODevice::Link::responseTime  = 2.0;
+const double AggregateAudioIODevice::Link::smoothingTime = 0.25;
+
+//==============================================================================
+class AggregateAudioIODevice::MasterCallback  : public AudioIODeviceCallback
+{
+public:
+    MasterCallback (AggregateAudioIODevice& owner_) noexcept  : owner (owner_) {}
+
+    void audioDeviceIOCallback (const float** inputs, int numInputs, float** outputs, int numOutputs, int numSamples)
+    {
+        owner.processMasterBlock (inputs, numInputs, outputs, numOutputs, numSamples);
+    }
+
+    void audioDeviceAboutToStart (AudioIODevice*)   {}
+    void audioDeviceStopped()                       {}
+    void audioDeviceError (const String& message)   { owner.forwardError (message); }
+
+private:
+    AggregateAudioIODevice& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (MasterCallback)
+};
+
+class AggregateAudioIODevice::SlaveCallback  : public AudioIODeviceCallback
+{
+public:
+    SlaveCallback (AggregateAudioIODevice& owner_, const int index_) noexcept  : owner (owner_), index (index_) {}
+
+    void audioDeviceIOCallback (const float** inputs, int numInputs, float** outputs, int numOutputs, int numSamples)
+    {
+        owner.processSlaveBlock (index, inputs, numInputs, outputs, numOutputs, numSamples);
+    }
+
+    void audioDeviceAboutToStart (AudioIODevice*)   {}
+    void audioDeviceStopped()                       {}
+    void audioDeviceError (const String& message)   { owner.forwardError (message); }
+
+private:
+    AggregateAudioIODevice& owner;
+    const int index;
+
+    JUCE_DECLARE_NON_COPYABLE (SlaveCallback)
+};
+
+//==============================================================================
+/*  Shares out the conversion of the slaves' input channels.
+
+    This works like the parallel renderers in Synthesiser and AudioDeviceManager: the
+    master's audio thread and the workers of a WorkerThreadGroup all claim channels from
+    a shared atomic counter until there are none left.
+*/
+class AggregateAudioIODevice::ConversionThreads  : private WorkerThreadGroup::Job
+{
+public:
+    ConversionThreads (AggregateAudioIODevice& owner_, const int numThreads)
+        : owner (owner_),
+          threads ("Juce aggregate device conversion thread", numThreads),
+          numJobs (0)
+    {
+    }
+
+    int getNumThreads() const noexcept      { return threads.getNumThreads(); }
+
+    void runJobs (const int numJobs_)
+    {
+        numJobs = numJobs_;
+        nextJob = 0;
+
+        threads.run (*this);
+    }
+
+private:
+    //==============================================================================
+    AggregateAudioIODevice& owner;
+    WorkerThreadGroup threads;
+    Atomic<int> nextJob;
+    int numJobs;
+
+    void runOnThread (int)
+    {
+        for (;;)
+        {
+            const int job = (++nextJob) - 1;
+
+            if (job >= numJobs)
+                break;
+
+            owner.runConversionJob (job);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ConversionThreads)
+};
+
+//==============================================================================
+AggregateAudioIODevice::AggregateAudioIODevice (const String& deviceName,
+                                                const String& typeName_,
+                                                const Array<AudioIODevice*>& devices_)
+    : AudioIODevice (deviceName, typeName_),
+      resamplingQuality (SincInterpolator::mediumQuality),
+      numConversionThreads (0),
+      callback (nullptr),
+      deviceIsOpen (false),
+      currentSampleRate (0),
+      currentBufferSize (0),
+      maxBlockSize (0),
+      slaveInputs (1, 1),
+      slaveOutputs (1, 1),
+      numJobs (0),
+      numSlaveOutputs (0)
+{
+    jassert (devices_.size() > 0);
+
+    for (int i = 0; i < devices_.size(); ++i)
+    {
+        AudioIODevice* const d = devices_.getUnchecked(i);
+        jassert (d != nullptr && ! d->isOpen());
+
+        devices.add (d);
+        numInputChannels.add (d->getInputChannelNames().size());
+        numOutputChannels.add (d->getOutputChannelNames().size());
+    }
+
+    // Only the sample rates that all the devices can manage are any use..
+    if (AudioIODevice* const master = devices.getFirst())
+    {
+        for (int i = 0; i < master->getNumSampleRates(); ++i)
+        {
+            const double rate = master->getSampleRate (i);
+            bool isCommon = true;
+
+            for (int j = 1; j < devices.size() && isCommon; ++j)
+            {
+                AudioIODevice* const d = devices.getUnchecked(j);
+                isCommon = false;
+
+                for (int k = d->getNumSampleRates(); --k >= 0;)
+                    if (std::abs (d->getSampleRate (k) - rate) < 1.0)
+                        isCommon = true;
+            }
+
+            if (isCommon)
+                sampleRates.add (rate);
+        }
+    }
+
+    masterCallback = new MasterCallback (*this);
+}
+
+AggregateAudioIODevice::~AggregateAudioIODevice()
+{
+    close();
+}
+
+//==============================================================================
+StringArray AggregateAudioIODevice::getOutputChannelNames()
+{
+    StringArray names;
+
+    for (int i = 0; i < devices.size(); ++i)
+    {
+        AudioIODevice* const d = devices.getUnchecked(i);
+        const StringArray deviceChannels (d->getOutputChannelNames());
+
+        for (int j = 0; j < deviceChannels.size(); ++j)
+            names.add (d->getName() + ": " + deviceChannels[j]);
+    }
+
+    return names;
+}
+
+StringArray AggregateAudioIODevice::getInputChannelNames()
+{
+    StringArray names;
+
+    for (int i = 0; i < devices.size(); ++i)
+    {
+        AudioIODevice* const d = devices.getUnchecked(i);
+        const StringArray deviceChannels (d->getInputChannelNames());
+
+        for (int j = 0; j < deviceChannels.size(); ++j)
+            names.add (d->getName() + ": " + deviceChannels[j]);
+    }
+
+    return names;
+}
+
+int AggregateAudioIODevice::getNumSampleRates()                 { return sampleRates.size(); }
+double AggregateAudioIODevice::getSampleRate (int index)        { return sampleRates [index]; }
+int AggregateAudioIODevice::getNumBufferSizesAvailable()        { return devices.getFirst()->getNumBufferSizesAvailable(); }
+int AggregateAudioIODevice::getBufferSizeSamples (int index)    { return devices.getFirst()->getBufferSizeSamples (index); }
+int AggregateAudioIODevice::getDefaultBufferSize()              { return devices.getFirst()->getDefaultBufferSize(); }
+bool AggregateAudioIODevice::isOpen()                           { return deviceIsOpen; }
+bool AggregateAudioIODevice::isPlaying()                        { return callback != nullptr; }
+String AggregateAudioIODevice::getLastError()                   { return lastError; }
+int AggregateAudioIODevice::getCurrentBufferSizeSamples()       { return currentBufferSize; }
+double AggregateAudioIODevice::getCurrentSampleRate()           { return currentSampleRate; }
+int AggregateAudioIODevice::getCurrentBitDepth()                { return devices.getFirst()->getCurrentBitDepth(); }
+
+BigInteger AggregateAudioIODevice::getActiveOutputChannels() const
+{
+    BigInteger channels;
+    int base = 0;
+
+    for (int i = 0; i < devices.size(); ++i)
+    {
+        channels |= devices.getUnchecked(i)->getActiveOutputChannels() << base;
+        base += numOutputChannels.getUnchecked(i);
+    }
+
+    return channels;
+}
+
+BigInteger AggregateAudioIODevice::getActiveInputChannels() const
+{
+    BigInteger channels;
+    int base = 0;
+
+    for (int i = 0; i < devices.size(); ++i)
+    {
+        channels |= devices.getUnchecked(i)->getActiveInputChannels() << base;
+        base += numInputChannels.getUnchecked(i);
+    }
+
+    return channels;
+}
+
+int AggregateAudioIODevice::getOutputLatencyInSamples()
+{
+    int latency = devices.getFirst()->getOutputLatencyInSamples();
+
+    for (int i = 0; i < slaves.size(); ++i)
+        if (const Link* const link = slaves.getUnchecked(i)->output)
+            latency = jmax (latency, link->getLatency() + devices.getUnchecked (i + 1)->getOutputLatencyInSamples());
+
+    return latency;
+}
+
+int AggregateAudioIODevice::getInputLatencyInSamples()
+{
+    int latency = devices.getFirst()->getInputLatencyInSamples();
+
+    for (int i = 0; i < slaves.size(); ++i)
+        if (const Link* const link = slaves.getUnchecked(i)->input)
+            latency = jmax (latency, link->getLatency() + devices.getUnchecked (i + 1)->getInputLatencyInSamples());
+
+    return latency;
+}
+
+int AggregateAudioIODevice::getXRunCount() const noexcept
+{
+    int total = 0;
+
+    for (int i = 0; i < devices.size(); ++i)
+        total += jmax (0, devices.getUnchecked(i)->getXRunCount());
+
+    for (int i = 0; i < slaves.size(); ++i)
+    {
+        const Slave& s = *slaves.getUnchecked(i);
+
+        if (s.input != nullptr)   total += s.input->numXRuns.get();
+        if (s.output != nullptr)  total += s.output->numXRuns.get();
+    }
+
+    return total;
+}
+
+double AggregateAudioIODevice::getDriftCorrection (const int deviceIndex) const noexcept
+{
+    if (const Slave* const s = slaves [deviceIndex - 1])
+    {
+        if (s->input != nullptr)    return s->input->getCorrection();
+        if (s->output != nullptr)   return -s->output->getCorrection();
+    }
+
+    return 0.0;
+}
+
+//==============================================================================
+void AggregateAudioIODevice::setNumConversionThreads (const int numThreads)
+{
+    numConversionThreads = jmax (0, numThreads);
+
+    if (deviceIsOpen)
+    {
+        ScopedPointer<ConversionThreads> newThreads (numConversionThreads > 0 ? new ConversionThreads (*this, numConversionThreads)
+                                                                                : nullptr);
+
+        if (newThreads != nullptr || conversionThreads != nullptr)
+        {
+            const ScopedLock sl (callbackLock);
+            conversionThreads.swapWith (newThreads);
+        }
+    }
+}
+
+void AggregateAudioIODevice::setResamplingQuality (const SincInterpolator::Quality newQuality) noexcept
+{
+    resamplingQuality = newQuality;
+}
+
+//==============================================================================
+String AggregateAudioIODevice::open (const BigInteger& inputChannels, const BigInteger& outputChannels,
+                                     double sampleRate, int bufferSizeSamples)
+{
+    close();
+
+    lastError = openDevices (inputChannels, outputChannels, sampleRate, bufferSizeSamples);
+
+    if (lastError.isNotEmpty())
+    {
+        close();
+        return lastError;
+    }
+
+    // Start the slaves first, so that their inputs are ready by the time the master needs them..
+    for (int i = 0; i < slaves.size(); ++i)
+        devices.getUnchecked (i + 1)->start (slaves.getUnchecked(i)->callback);
+
+    devices.getFirst()->start (masterCallback);
+    return lastError;
+}
+
+String AggregateAudioIODevice::openDevices (const BigInteger& inputChannels, const BigInteger& outputChannels,
+                                            double sampleRate, int bufferSizeSamples)
+{
+    if (sampleRates.size() == 0)
+        return "The devices in this aggregate have no sample rates in common";
+
+    if (! sampleRates.contains (sampleRate))
+    {
+        double nearest = sampleRates.getFirst();
+
+        for (int i = 1; i < sampleRates.size(); ++i)
+            if (std::abs (sampleRates.getUnchecked(i) - sampleRate) < std::abs (nearest - sampleRate))
+                nearest = sampleRates.getUnchecked(i);
+
+        sampleRate = nearest;
+    }
+
+    numActiveInputs.clearQuick();
+    numActiveOutputs.clearQuick();
+
+    int inputBase = 0, outputBase = 0;
+    int totalSlaveInputs = 0, totalSlaveOutputs = 0;
+
+    for (int i = 0; i < devices.size(); ++i)
+    {
+        AudioIODevice* const d = devices.getUnchecked(i);
+        const int numIns = numInputChannels.getUnchecked(i);
+        const int numOuts = numOutputChannels.getUnchecked(i);
+
+        const String error (d->open (inputChannels.getBitRange (inputBase, numIns),
+                                     outputChannels.getBitRange (outputBase, numOuts),
+                                     i == 0 ? sampleRate : currentSampleRate,
+                                     bufferSizeSamples));
+        inputBase += numIns;
+        outputBase += numOuts;
+
+        if (error.isNotEmpty())
+            return d->getName() + ": " + error;
+
+        if (i == 0)
+        {
+            currentSampleRate = d->getCurrentSampleRate();
+            currentBufferSize = d->getCurrentBufferSizeSamples();
+            maxBlockSize = jmax (1, currentBufferSize);
+        }
+        else if (std::abs (d->getCurrentSampleRate() - currentSampleRate) >= 1.0)
+        {
+            return d->getName() + ": couldn't run at the same sample rate as the master device";
+        }
+
+        numActiveInputs.add (d->getActiveInputChannels().countNumberOfSetBits());
+        numActiveOutputs.add (d->getActiveOutputChannels().countNumberOfSetBits());
+
+        if (i > 0)
+        {
+            const int slaveBlockSize = jmax (1, d->getCurrentBufferSizeSamples());
+            Slave* const s = new Slave();
+            slaves.add (s);
+
+            s->callback = new SlaveCallback (*this, i - 1);
+
+            if (numActiveInputs.getLast() > 0)
+                s->input = new Link (numActiveInputs.getLast(), slaveBlockSize, maxBlockSize,
+                                     currentSampleRate, resamplingQuality);
+
+            if (numActiveOutputs.getLast() > 0)
+                s->output = new Link (numActiveOutputs.getLast(), maxBlockSize, slaveBlockSize,
+                                      currentSampleRate, resamplingQuality);
+
+            totalSlaveInputs += numActiveInputs.getLast();
+            totalSlaveOutputs += numActiveOutputs.getLast();
+        }
+    }
+
+    // Each slave input channel is a separate conversion job, numbered in the same order
+    // as they're stored in slaveInputs..
+    numJobs = totalSlaveInputs;
+    jobLinks.calloc ((size_t) jmax (1, numJobs));
+    jobChannels.calloc ((size_t) jmax (1, numJobs));
+
+    for (int i = 0, job = 0; i < slaves.size(); ++i)
+    {
+        if (Link* const link = slaves.getUnchecked(i)->input)
+        {
+            for (int chan = 0; chan < link->numChannels; ++chan)
+            {
+                jobLinks [job] = link;
+                jobChannels [job] = chan;
+                ++job;
+            }
+        }
+    }
+
+    slaveInputs.setSize (totalSlaveInputs + 2, maxBlockSize);
+    slaveOutputs.setSize (jmax (1, totalSlaveOutputs), maxBlockSize);
+    numSlaveOutputs = totalSlaveOutputs;
+    slaveInputs.clear();
+
+    // (the jobs run on several threads, so they get their channels from here rather than
+    // by calling slaveInputs' methods, which would all write to its hasBeenCleared() flag)
+    jobDestinations.calloc ((size_t) jmax (1, numJobs));
+
+    for (int job = 0; job < numJobs; ++job)
+        jobDestinations [job] = slaveInputs.getSampleData (job);
+
+    inputPointers.calloc ((size_t) (numActiveInputs.getFirst() + totalSlaveInputs + 1));
+    outputPointers.calloc ((size_t) (numActiveOutputs.getFirst() + totalSlaveOutputs + 1));
+
+    if (numConversionThreads > 0)
+        conversionThreads = new ConversionThreads (*this, numConversionThreads);
+
+    deviceIsOpen = true;
+    return String::empty;
+}
+
+void AggregateAudioIODevice::close()
+{
+    stop();
+
+    devices.getFirst()->stop();
+
+    for (int i = devices.size(); --i > 0;)
+        devices.getUnchecked(i)->stop();
+
+    for (int i = devices.size(); --i >= 0;)
+        devices.getUnchecked(i)->close();
+
+    conversionThreads = nullptr;
+    slaves.clear();
+    numJobs = 0;
+    numSlaveOutputs = 0;
+    deviceIsOpen = false;
+}
+
+void AggregateAudioIODevice::start (AudioIODeviceCallback* newCallback)
+{
+    if (! deviceIsOpen)
+        newCallback = nullptr;
+
+    if (newCallback != callback)
+    {
+        if (newCallback != nullptr)
+            newCallback->audioDeviceAboutToStart (this);
+
+        AudioIODeviceCallback* oldCallback;
+
+        {
+            const ScopedLock sl (callbackLock);
+            oldCallback = callback;
+            callback = newCallback;
+        }
+
+        if (oldCallback != nullptr)
+            oldCallback->audioDeviceStopped();
+    }
+}
+
+void AggregateAudioIODevice::stop()
+{
+    AudioIODeviceCallback* oldCallback;
+
+    {
+        const ScopedLock sl (callbackLock);
+        oldCallback = callback;
+        callback = nullptr;
+    }
+
+    if (oldCallback != nullptr)
+        oldCallback->audioDeviceStopped();
+}
+
+void AggregateAudioIODevice::forwardError (const String& message)
+{
+    const ScopedLock sl (callbackLock);
+
+    if (callback != nullptr)
+        callback->audioDeviceError (message);
+}
+
+//==============================================================================
+void AggregateAudioIODevice::processMasterBlock (const float** inputs, int numInputs,
+                                                 float** outputs, int numOutputs, int numSamples)
+{
+    const ScopedLock sl (callbackLock);
+
+    const int numMasterIns = numActiveInputs.getFirst();
+    const int numMasterOuts = numActiveOutputs.getFirst();
+
+    // (the last two channels of slaveInputs stand in for any that the master doesn't supply)
+    const float* const silentInput = slaveInputs.getSampleData (numJobs);
+    float* const spareOutput = slaveInputs.getSampleData (numJobs + 1);
+
+    for (int pos = 0; pos < numSamples;)
+    {
+        const int num = jmin (maxBlockSize, numSamples - pos);
+
+        for (int i = 0; i < numMasterIns; ++i)
+            inputPointers[i] = (i < numInputs && inputs[i] != nullptr) ? inputs[i] + pos : silentInput;
+
+        for (int i = 0; i < numMasterOuts; ++i)
+            outputPointers[i] = (i < numOutputs && outputs[i] != nullptr) ? outputs[i] + pos : spareOutput;
+
+        for (int i = numMasterOuts; i < numOutputs; ++i)
+            if (outputs[i] != nullptr)
+                zeromem (outputs[i] + pos, sizeof (float) * (size_t) num);
+
+        processMasterChunk (num);
+        pos += num;
+    }
+}
+
+void AggregateAudioIODevice::processMasterChunk (const int numSamples)
+{
+    convertSlaveInputs (numSamples);
+
+    // The slaves' channels follow the master's in the pointer arrays..
+    int numIns = numActiveInputs.getFirst();
+    int numOuts = numActiveOutputs.getFirst();
+    const int firstSlaveOutput = numOuts;
+
+    for (int i = 0; i < numJobs; ++i)
+        inputPointers [numIns++] = slaveInputs.getSampleData (i);
+
+    for (int i = 0; i < numSlaveOutputs; ++i)
+        outputPointers [numOuts++] = slaveOutputs.getSampleData (i);
+
+    if (callback != nullptr)
+    {
+        callback->audioDeviceIOCallback (inputPointers, numIns, outputPointers, numOuts, numSamples);
+    }
+    else
+    {
+        for (int i = 0; i < numOuts; ++i)
+            zeromem (outputPointers[i], sizeof (float) * (size_t) numSamples);
+    }
+
+    // ..and then the slaves' outputs get sent off to their FIFOs.
+    int outputIndex = firstSlaveOutput;
+
+    for (int i = 0; i < slaves.size(); ++i)
+    {
+        if (Link* const link = slaves.getUnchecked(i)->output)
+        {
+            link->push ((const float**) (outputPointers + outputIndex), link->numChannels, numSamples);
+            outputIndex += link->numChannels;
+        }
+    }
+}
+
+void AggregateAudioIODevice::convertSlaveInputs (const int numSamples)
+{
+    bool anyPulling = false;
+    int channel = 0;
+
+    for (int i = 0; i < slaves.size(); ++i)
+    {
+        if (Link* const link = slaves.getUnchecked(i)->input)
+        {
+            if (link->startPull (numSamples))
+            {
+                anyPulling = true;
+            }
+            else
+            {
+                for (int chan = 0; chan < link->numChannels; ++chan)
+                    slaveInputs.clear (channel + chan, 0, numSamples);
+            }
+
+            channel += link->numChannels;
+        }
+    }
+
+    if (! anyPulling)
+        return;
+
+    if (conversionThreads != nullptr && numJobs > 1)
+    {
+        conversionThreads->runJobs (numJobs);
+    }
+    else
+    {
+        for (int job = 0; job < numJobs; ++job)
+            runConversionJob (job);
+    }
+
+    for (int i = 0; i < slaves.size(); ++i)
+        if (Link* const link = slaves.getUnchecked(i)->input)
+            if (link->isPulling())
+                link->finishPull();
+}
+
+void AggregateAudioIODevice::runConversionJob (const int job) noexcept
+{
+    Link* const link = jobLinks [job];
+
+    if (link->isPulling())
+        link->pullChannel (jobChannels [job], jobDestinations [job]);
+}
+
+void AggregateAudioIODevice::processSlaveBlock (const int slaveIndex,
+                                                const float** inputs, int numInputs,
+                                                float** outputs, int numOutputs, int numSamples)
+{
+    const Slave& s = *slaves.getUnchecked (slaveIndex);
+
+    if (s.input != nullptr)
+        s.input->push (inputs, numInputs, numSamples);
+
+    if (s.output != nullptr)
+    {
+        s.output->pull (outputs, numOutputs, numSamples);
+    }
+    else
+    {
+        for (int i = 0; i < numOutputs; ++i)
+            if (outputs[i] != nullptr)
+                zeromem (outputs[i], sizeof (float) * (size_t) numSamples);
+    }
+}
+
+//==============================================================================
+AggregateAudioIODeviceType::AggregateAudioIODeviceType (const String& typeName_)
+    : AudioIODeviceType (typeName_),
+      numConversionThreads (0)
+{
+}
+
+AggregateAudioIODeviceType::~AggregateAudioIODeviceType()
+{
+}
+
+int AggregateAudioIODeviceType::indexOf (const String& aggregateName) const
+{
+    for (int i = descriptions.size(); --i >= 0;)
+        if (descriptions.getUnchecked(i)->name == aggregateName)
+            return i;
+
+    return -1;
+}
+
+void AggregateAudioIODeviceType::addAggregateDevice (const String& aggregateName,
+                                                     const Array<AudioIODeviceType*>& deviceTypes,
+                                                     const StringArray& deviceNames)
+{
+    jassert (deviceTypes.size() > 0 && deviceTypes.size() == deviceNames.size());
+
+    Description* const d = new Description();
+    d->name = aggregateName;
+    d->types = deviceTypes;
+    d->deviceNames = deviceNames;
+
+    const int existing = indexOf (aggregateName);
+
+    if (existing >= 0)
+        descriptions.set (existing, d);
+    else
+        descriptions.add (d);
+
+    callDeviceChangeListeners();
+}
+
+void AggregateAudioIODeviceType::removeAggregateDevice (const String& aggregateName)
+{
+    const int index = indexOf (aggregateName);
+
+    if (index >= 0)
+    {
+        descriptions.remove (index);
+        callDeviceChangeListeners();
+    }
+}
+
+void AggregateAudioIODeviceType::scanForDevices()
+{
+    Array<AudioIODeviceType*> scanned;
+
+    for (int i = 0; i < descriptions.size(); ++i)
+    {
+        const Array<AudioIODeviceType*>& types = descriptions.getUnchecked(i)->types;
+
+        for (int j = 0; j < types.size(); ++j)
+        {
+            if (! scanned.contains (types.getUnchecked(j)))
+            {
+                scanned.add (types.getUnchecked(j));
+                types.getUnchecked(j)->scanForDevices();
+            }
+        }
+    }
+}
+
+StringArray AggregateAudioIODeviceType::getDeviceNames (bool) const
+{
+    StringArray names;
+
+    for (int i = 0; i < descriptions.size(); ++i)
+        names.add (descriptions.getUnchecked(i)->name);
+
+    return names;
+}
+
+int AggregateAudioIODeviceType::getDefaultDeviceIndex (bool) const
+{
+    return 0;
+}
+
+int AggregateAudioIODeviceType::getIndexOfDevice (AudioIODevice* device, bool) const
+{
+    AggregateAudioIODevice* const d = dynamic_cast <AggregateAudioIODevice*> (device);
+    return d == nullptr ? -1 : indexOf (d->getName());
+}
+
+bool AggregateAudioIODeviceType::hasSeparateInputsAndOutputs() const
+{
+    return false;
+}
+
+AudioIODevice* AggregateAudioIODeviceType::createDevice (const String& outputDeviceName,
+                                                         const String& inputDeviceName)
+{
+    const int index = indexOf (outputDeviceName.isNotEmpty() ? outputDeviceName : inputDeviceName);
+
+    if (index < 0)
+        return nullptr;
+
+    const Description& desc = *descriptions.getUnchecked (index);
+    OwnedArray<AudioIODevice> created;
+
+    for (int i = 0; i < desc.types.size(); ++i)
+    {
+        AudioIODevice* const d = desc.types.getUnchecked(i)->createDevice (desc.deviceNames[i], desc.deviceNames[i]);
+
+        if (d == nullptr)
+            return nullptr;
+
+        created.add (d);
+    }
+
+    Array<AudioIODevice*> devices;
+
+    while (created.size() > 0)
+        devices.add (created.removeAndReturn (0));
+
+    AggregateAudioIODevice* const aggregate = new AggregateAudioIODevice (desc.name, getTypeName(), devices);
+    aggregate->setNumConversionThreads (numConversionThreads);
+    return aggregate;
+}
@@ -0,0 +1,270 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+#ifndef __JUCE_AGGREGATEAUDIOIODEVICE_JUCEHEADER__
+#define __JUCE_AGGREGATEAUDIOIODEVICE_JUCEHEADER__
+
+#include "juce_AudioIODeviceType.h"
+
+
+//==============================================================================
+/**
+    An AudioIODevice that drives a set of other devices as if they were one.
+
+    The first device in the set is the master: its callbacks drive the aggregate's
+    callback, and the aggregate uses its sample rate and buffer size. The others are
+    slaves. Each slave runs on its own thread and its own clock, and is connected to the
+    master by a pair of lock-free FIFOs.
+
+    No two clocks run at exactly the same speed, so the slaves will always drift against
+    the master. To absorb this, each FIFO is read through a SincInterpolator, and the
+    interpolator's ratio is continuously trimmed to hold the FIFO at a constant level.
+    The latency that this adds is the FIFO's target level, which is a little over the
+    sum of the two devices' buffer sizes.
+
+    The aggregate's channels are the master's channels followed by the channels of each
+    slave in turn, and each channel's name begins with the name of its device.
+
+    The slaves' outputs are converted on the slaves' own audio threads. The slaves' inputs
+    are converted on the master's thread, and setNumConversionThreads() lets that work be
+    shared out between a pool of worker threads.
+
+    @see AggregateAudioIODeviceType
+*/
+class JUCE_API  AggregateAudioIODevice  : public AudioIODevice
+{
+public:
+    //==============================================================================
+    /** Creates an aggregate of a set of devices.
+
+        The first device in the array is the master. None of the devices should be
+        open yet, and they must all be able to run at the same sample rate. The aggregate
+        takes ownership of all the devices, and will delete them when it's deleted.
+    */
+    AggregateAudioIODevice (const String& deviceName,
+                            const String& typeName,
+                            const Array<AudioIODevice*>& devices);
+
+    /** Destructor. */
+    ~AggregateAudioIODevice();
+
+    //==============================================================================
+    /** Returns the number of devices in the aggregate. */
+    int getNumDevices() const noexcept                          { return devices.size(); }
+
+    /** Returns one of the devices in the aggregate. Device 0 is the master. */
+    AudioIODevice* getDevice (int index) const noexcept         { return devices [index]; }
+
+    /** Sets the number of extra threads that are used to convert the slaves' inputs.
+
+        With 0 threads (the default), all the conversion is done on the master device's
+        audio thread. This can be changed while the device is running.
+    */
+    void setNumConversionThreads (int numThreads);
+
+    /** Returns the number of threads set with setNumConversionThreads(). */
+    int getNumConversionThreads() const noexcept                { return numConversionThreads; }
+
+    /** Sets the quality of the resampling used between the master and its slaves.
+        This will take effect the next time the device is opened.
+    */
+    void setResamplingQuality (SincInterpolator::Quality newQuality) noexcept;
+
+    /** Returns the correction that is currently being applied to a slave's input, to
+        compensate for its drift.
+
+        This is the amount by which the slave's clock is currently being judged to run
+        faster than the master's, as a proportion of the sample rate (so 0.0001 means
+        100ppm). It's always 0 for device 0, because that's the master.
+    */
+    double getDriftCorrection (int deviceIndex) const noexcept;
+
+    //==============================================================================
+    StringArray getOutputChannelNames();
+    StringArray getInputChannelNames();
+    int getNumSampleRates();
+    double getSampleRate (int index);
+    int getNumBufferSizesAvailable();
+    int getBufferSizeSamples (int index);
+    int getDefaultBufferSize();
+    String open (const BigInteger& inputChannels, const BigInteger& outputChannels,
+                 double sampleRate, int bufferSizeSamples);
+    void close();
+    bool isOpen();
+    void start (AudioIODeviceCallback* callback);
+    void stop();
+    bool isPlaying();
+    String getLastError();
+    int getCurrentBufferSizeSamples();
+    double getCurrentSampleRate();
+    int getCurrentBitDepth();
+    BigInteger getActiveOutputChannels() const;
+    BigInteger getActiveInputChannels() const;
+    int getOutputLatencyInSamples();
+    int getInputLatencyInSamples();
+
+    /** Returns the total of all the devices' xruns, plus the number of times that one
+        of the FIFOs between them has run dry or overflowed.
+    */
+    int getXRunCount() const noexcept;
+
+private:
+    //==============================================================================
+    class Link;
+    class SlaveCallback;
+    class MasterCallback;
+    class ConversionThreads;
+    friend class Link;
+    friend class SlaveCallback;
+    friend class MasterCallback;
+    friend class ConversionThreads;
+    friend class ScopedPointer<ConversionThreads>;
+
+    struct Slave
+    {
+        ScopedPointer<Link> input, output;
+        ScopedPointer<SlaveCallback> callback;
+    };
+
+    OwnedArray<AudioIODevice> devices;
+    OwnedArray<Slave> slaves;
+    ScopedPointer<MasterCallback> masterCallback;
+    ScopedPointer<ConversionThreads> conversionThreads;
+
+    Array<double> sampleRates;
+    Array<int> numInputChannels, numOutputChannels;     // (the number of names of each device's channels)
+    Array<int> numActiveInputs, numActiveOutputs;       // (the number of each device's channels that are open)
+    SincInterpolator::Quality resamplingQuality;
+    int numConversionThreads;
+
+    CriticalSection callbackLock;
+    AudioIODeviceCallback* callback;
+    bool deviceIsOpen;
+    String lastError;
+    double currentSampleRate;
+    int currentBufferSize, maxBlockSize;
+
+    AudioSampleBuffer slaveInputs, slaveOutputs;
+    HeapBlock<const float*> inputPointers;
+    HeapBlock<float*> outputPointers;
+    HeapBlock<Link*> jobLinks;
+    HeapBlock<int> jobChannels;
+    HeapBlock<float*> jobDestinations;
+    int numJobs, numSlaveOutputs;
+
+    void processMasterBlock (const float** inputs, int numInputs, float** outputs, int numOutputs, int numSamples);
+    void processMasterChunk (int numSamples);
+    void processSlaveBlock (int slaveIndex, const float** inputs, int numInputs, float** outputs, int numOutputs, int numSamples);
+    void convertSlaveInputs (int numSamples);
+    void runConversionJob (int job) noexcept;
+    void forwardError (const String& message);
+    String openDevices (const BigInteger& inputChannels, const BigInteger& outputChannels,
+                        double sampleRate, int bufferSizeSamples);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AggregateAudioIODevice)
+};
+
+
+//==============================================================================
+/**
+    An AudioIODeviceType that lists a set of aggregate devices.
+
+    Each aggregate is described by a name and a list of the devices that it's made
+    of, and is created as an AggregateAudioIODevice. The first device in each list is
+    the master. E.g.
+    @code
+    AggregateAudioIODeviceType* aggregates = new AggregateAudioIODeviceType();
+
+    Array<AudioIODeviceType*> types;
+    StringArray names;
+    types.add (alsaType);  names.add ("Interface A");
+    types.add (alsaType);  names.add ("Interface B");
+    aggregates->addAggregateDevice ("A + B", types, names);
+
+    audioDeviceManager.addAudioDeviceType (aggregates);
+    @endcode
+
+    The AudioIODeviceType objects that the devices come from aren't owned by this
+    object, and they must stay alive for as long as it does.
+
+    @see AggregateAudioIODevice
+*/
+class JUCE_API  AggregateAudioIODeviceType  : public AudioIODeviceType
+{
+public:
+    //==============================================================================
+    /** Creates an empty list of aggregates. */
+    explicit AggregateAudioIODeviceType (const String& typeName = "Aggregate");
+
+    /** Destructor. */
+    ~AggregateAudioIODeviceType();
+
+    //==============================================================================
+    /** Adds (or replaces) an aggregate device.
+
+        @param aggregateName    the name that the aggregate will be listed under
+        @param deviceTypes      the types of each of the devices in the aggregate
+        @param deviceNames      the names of each of the devices in the aggregate, as
+                                returned by the corresponding type's getDeviceNames().
+                                The first device is the master.
+    */
+    void addAggregateDevice (const String& aggregateName,
+                             const Array<AudioIODeviceType*>& deviceTypes,
+                             const StringArray& deviceNames);
+
+    /** Removes one of the aggregates. */
+    void removeAggregateDevice (const String& aggregateName);
+
+    /** Sets the number of conversion threads that new devices will be given.
+        @see AggregateAudioIODevice::setNumConversionThreads
+    */
+    void setNumConversionThreads (int numThreads) noexcept      { numConversionThreads = numThreads; }
+
+    //==============================================================================
+    void scanForDevices();
+    StringArray getDeviceNames (bool wantInputNames = false) const;
+    int getDefaultDeviceIndex (bool forInput) const;
+    int getIndexOfDevice (AudioIODevice* device, bool asInput) const;
+    bool hasSeparateInputsAndOutputs() const;
+    AudioIODevice* createDevice (const String& outputDeviceName, const String& inputDeviceName);
+
+private:
+    //==============================================================================
+    struct Description
+    {
+        String name;
+        Array<AudioIODeviceType*> types;
+        StringArray deviceNames;
+    };
+
+    OwnedArray<Description> descriptions;
+    int numConversionThreads;
+
+    int indexOf (const String& aggregateName) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AggregateAudioIODeviceType)
+};
+
+
+#endif   // __JUCE_AGGREGATEAUDIOIODEVICE_JUCEHEADER__
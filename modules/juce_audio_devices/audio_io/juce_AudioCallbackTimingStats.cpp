@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+AudioCallbackTimingStats::AudioCallbackTimingStats() noexcept
+{
+}
+
+void AudioCallbackTimingStats::addCallback (const double millisecondsTaken,
+                                            const double millisecondsAvailable) noexcept
+{
+    const int microseconds = jmax (0, roundToInt (millisecondsTaken * 1000.0));
+
+    ++numCallbacks;
+    totalMicroseconds += (int64) microseconds;
+
+    if (microseconds > worstCaseMicroseconds.get())
+        worstCaseMicroseconds = microseconds;
+
+    int bin = numHistogramBins - 1;
+
+    if (millisecondsAvailable > 0)
+    {
+        if (millisecondsTaken > millisecondsAvailable)
+            ++numDeadlineMisses;
+
+        bin = jmin (bin, (int) (10.0 * millisecondsTaken / millisecondsAvailable));
+    }
+
+    ++(histogram [jmax (0, bin)]);
+}
+
+void AudioCallbackTimingStats::reset() noexcept
+{
+    numCallbacks = 0;
+    numDeadlineMisses = 0;
+    worstCaseMicroseconds = 0;
+    totalMicroseconds = 0;
+
+    for (int i = 0; i < numHistogramBins; ++i)
+        histogram[i] = 0;
+}
+
+double AudioCallbackTimingStats::getAverageMilliseconds() const noexcept
+{
+    const int num = numCallbacks.get();
+    return num > 0 ? totalMicroseconds.get() / (1000.0 * num) : 0.0;
+}
+
+int AudioCallbackTimingStats::getHistogramCount (const int binIndex) const noexcept
+{
+    return isPositiveAndBelow (binIndex, (int) numHistogramBins) ? histogram [binIndex].get() : 0;
+}
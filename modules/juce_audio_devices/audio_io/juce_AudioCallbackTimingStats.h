@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_AUDIOCALLBACKTIMINGSTATS_JUCEHEADER__
+#define __JUCE_AUDIOCALLBACKTIMINGSTATS_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    Collects timing statistics about a stream of audio callbacks.
+
+    Each time a callback finishes, the audio thread calls addCallback() with the
+    time that it took and the time that was available before the device needed the
+    data. From that, the object keeps a count of callbacks and deadline misses, the
+    worst-case and average times, and a histogram of the times taken as a proportion
+    of the deadline.
+
+    Everything's stored in atomics, so all the getter methods can be called from any
+    thread while the audio thread is adding to the stats, without any locking.
+
+    The AudioDeviceManager keeps one of these for its device, and one for each of its
+    registered callbacks - see AudioDeviceManager::getCallbackTimingStats().
+
+    @see AudioDeviceManager
+*/
+class JUCE_API  AudioCallbackTimingStats
+{
+public:
+    //==============================================================================
+    /** Creates an empty set of stats. */
+    AudioCallbackTimingStats() noexcept;
+
+    //==============================================================================
+    enum
+    {
+        /** Each bin holds callbacks that took up to another tenth of the available time,
+            so bin 0 covers 0-10% of the deadline, bin 9 covers 90-100%, and so on. The
+            final bin gathers up every callback that took twice the deadline or more.
+        */
+        numHistogramBins = 21
+    };
+
+    //==============================================================================
+    /** Records a callback.
+
+        This is designed to be called from the audio thread: it doesn't block or allocate.
+
+        @param millisecondsTaken        how long the callback took to run
+        @param millisecondsAvailable    how long it could have taken without the device
+                                        running out of data - normally the duration of the
+                                        block that was being processed
+    */
+    void addCallback (double millisecondsTaken, double millisecondsAvailable) noexcept;
+
+    /** Clears all the stats.
+        If this is called while the audio thread is calling addCallback(), a callback
+        that's in the middle of being added may be only partially included.
+    */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Returns the number of callbacks that have been recorded. */
+    int getNumCallbacks() const noexcept                        { return numCallbacks.get(); }
+
+    /** Returns the number of callbacks that took longer than the time available. */
+    int getNumDeadlineMisses() const noexcept                   { return numDeadlineMisses.get(); }
+
+    /** Returns the longest time that any callback has taken, in milliseconds. */
+    double getWorstCaseMilliseconds() const noexcept            { return worstCaseMicroseconds.get() / 1000.0; }
+
+    /** Returns the average time that the callbacks have taken, in milliseconds. */
+    double getAverageMilliseconds() const noexcept;
+
+    /** Returns the number of callbacks that fell into one of the histogram bins.
+        @see numHistogramBins
+    */
+    int getHistogramCount (int binIndex) const noexcept;
+
+private:
+    //==============================================================================
+    Atomic<int> numCallbacks, numDeadlineMisses, worstCaseMicroseconds;
+    Atomic<int64> totalMicroseconds;
+    Atomic<int> histogram [numHistogramBins];
+
+    JUCE_DECLARE_NON_COPYABLE (AudioCallbackTimingStats)
+};
+
+
+#endif   // __JUCE_AUDIOCALLBACKTIMINGSTATS_JUCEHEADER__
@@ -87,25 +87,216 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CallbackHandler)
 };
 
+//==============================================================================
+/*  Finishes scanning the device types that initialise() skipped, one type per timer
+    callback, so that the message thread stays responsive while slow drivers are probed.
+*/
+class AudioDeviceManager::DeviceScanner  : private Timer
+{
+public:
+    DeviceScanner (AudioDeviceManager& adm)  : owner (adm)
+    {
+        startTimer (50);
+    }
+
+private:
+    void timerCallback()
+    {
+        if (! owner.scanNextDeviceType())
+            stopTimer();
+    }
+
+    AudioDeviceManager& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (DeviceScanner)
+};
+
+//==============================================================================
+namespace AudioDeviceManagerHelpers
+{
+    static void addChannels (float** const dest, const float* const* const source,
+                             const int numChannels, const int numSamples) noexcept
+    {
+        for (int chan = 0; chan < numChannels; ++chan)
+            if (const float* const src = source [chan])
+                if (float* const dst = dest [chan])
+                    FloatVectorOperations::add (dst, src, numSamples);
+    }
+}
+
+//==============================================================================
+/*  Shares the registered callbacks between the audio thread and a set of workers.
+
+    This works like the parallel renderers in Synthesiser and AudioProcessorGraph: every
+    thread in a WorkerThreadGroup claims callbacks from a shared atomic counter until
+    there are none left. The audio thread runs the first callback straight into the
+    device's output, and adds the ones that it claims after that directly onto it. Each
+    worker adds the callbacks it runs into its own accumulator, and the accumulators are
+    summed at the end.
+*/
+class AudioDeviceManager::CallbackRenderer  : private WorkerThreadGroup::Job
+{
+public:
+    CallbackRenderer (AudioDeviceManager& owner_, const int numThreads)
+        : owner (owner_),
+          threads ("Juce audio callback thread", numThreads),
+          callbackList (nullptr),
+          inputChannelData (nullptr),
+          outputChannelData (nullptr),
+          callerTempBuffer (nullptr),
+          numInputChannels (0),
+          numOutputChannels (0),
+          numSamples (0)
+    {
+        for (int i = 0; i < numThreads; ++i)
+            accumulators.add (new Accumulator());
+    }
+
+    int getNumThreads() const noexcept      { return threads.getNumThreads(); }
+
+    void render (const Array <AudioIODeviceCallback*>& list,
+                 const float** const inputChannelData_, const int numInputChannels_,
+                 float** const outputChannelData_, const int numOutputChannels_,
+                 const int numSamples_, AudioSampleBuffer& tempBuffer)
+    {
+        // (this only reallocates if the block size or channel count has grown)
+        for (int i = accumulators.size(); --i >= 0;)
+            accumulators.getUnchecked(i)->prepare (numOutputChannels_, numSamples_);
+
+        tempBuffer.setSize (jmax (1, numOutputChannels_), jmax (1, numSamples_), false, false, true);
+
+        callbackList = &list;
+        inputChannelData = inputChannelData_;
+        numInputChannels = numInputChannels_;
+        outputChannelData = outputChannelData_;
+        numOutputChannels = numOutputChannels_;
+        numSamples = numSamples_;
+        callerTempBuffer = &tempBuffer;
+        nextIndex = 1;
+
+        threads.run (*this);
+
+        for (int i = accumulators.size(); --i >= 0;)
+        {
+            const Accumulator& acc = *accumulators.getUnchecked(i);
+
+            if (acc.hasOutput)
+                AudioDeviceManagerHelpers::addChannels (outputChannelData, acc.sum.getArrayOfReadPointers(),
+                                                        numOutputChannels, numSamples);
+        }
+    }
+
+private:
+    //==============================================================================
+    struct Accumulator
+    {
+        Accumulator() : sum (1, 1), temp (1, 1), hasOutput (false) {}
+
+        void prepare (const int numChannels, const int numSamples)
+        {
+            temp.setSize (jmax (1, numChannels), jmax (1, numSamples), false, false, true);
+            sum.setSize (jmax (1, numChannels), jmax (1, numSamples), false, false, true);
+            hasOutput = false;
+        }
+
+        AudioSampleBuffer sum, temp;
+        bool hasOutput;
+
+        JUCE_DECLARE_NON_COPYABLE (Accumulator)
+    };
+
+    AudioDeviceManager& owner;
+    WorkerThreadGroup threads;
+    OwnedArray<Accumulator> accumulators;
+    Atomic<int> nextIndex;
+
+    const Array <AudioIODeviceCallback*>* callbackList;
+    const float** inputChannelData;
+    float** outputChannelData;
+    AudioSampleBuffer* callerTempBuffer;
+    int numInputChannels, numOutputChannels, numSamples;
+
+    int claimNextCallback() noexcept
+    {
+        const int index = (++nextIndex) - 1;
+        return index < callbackList->size() ? index : -1;
+    }
+
+    void runOnThread (const int thread)
+    {
+        if (thread == 0)
+            renderOnAudioThread();
+        else
+            renderOnWorker (*accumulators.getUnchecked (thread - 1));
+    }
+
+    void renderOnAudioThread()
+    {
+        owner.callAndTime (callbackList->getUnchecked (0), inputChannelData, numInputChannels,
+                           outputChannelData, numOutputChannels, numSamples);
+
+        float** const tempChans = callerTempBuffer->getArrayOfChannels();
+
+        for (int index; (index = claimNextCallback()) >= 0;)
+        {
+            owner.callAndTime (callbackList->getUnchecked (index), inputChannelData, numInputChannels,
+                               tempChans, numOutputChannels, numSamples);
+
+            AudioDeviceManagerHelpers::addChannels (outputChannelData, tempChans, numOutputChannels, numSamples);
+        }
+    }
+
+    void renderOnWorker (Accumulator& acc)
+    {
+        float** const tempChans = acc.temp.getArrayOfChannels();
+        float** const sumChans = acc.sum.getArrayOfChannels();
+
+        for (int index; (index = claimNextCallback()) >= 0;)
+        {
+            owner.callAndTime (callbackList->getUnchecked (index), inputChannelData, numInputChannels,
+                               tempChans, numOutputChannels, numSamples);
+
+            if (acc.hasOutput)
+            {
+                AudioDeviceManagerHelpers::addChannels (sumChans, tempChans, numOutputChannels, numSamples);
+            }
+            else
+            {
+                for (int chan = 0; chan < numOutputChannels; ++chan)
+                    FloatVectorOperations::copy (sumChans [chan], tempChans [chan], numSamples);
+
+                acc.hasOutput = true;
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (CallbackRenderer)
+};
 
 //==============================================================================
 AudioDeviceManager::AudioDeviceManager()
-    : numInputChansNeeded (0),
+    : activeCallbacks (new Array <AudioIODeviceCallback*>()),
+      lockAudioThread (true),
+      numInputChansNeeded (0),
       numOutputChansNeeded (2),
       listNeedsScanning (true),
       useInputNames (false),
       inputLevel (0),
       tempBuffer (2, 2),
       cpuUsageMs (0),
-      timeToCpuScale (0)
+      timeToCpuScale (0),
+      msPerSample (0)
 {
     callbackHandler = new CallbackHandler (*this);
 }
 
 AudioDeviceManager::~AudioDeviceManager()
 {
+    deviceScanner = nullptr;
     currentAudioDevice = nullptr;
     defaultMidiOutput = nullptr;
+    callbackRenderer = nullptr;
+    delete activeCallbacks.get();
 }
 
 
@@ -143,6 +334,9 @@ void AudioDeviceManager::audioDeviceListChanged()
         currentSetup.outputChannels = currentAudioDevice->getActiveOutputChannels();
     }
 
+    if (! listNeedsScanning)
+        updateDeviceListCache();
+
     sendChangeMessage();
 }
 
@@ -155,10 +349,12 @@ static void addIfNotNull (OwnedArray <AudioIODeviceType>& list, AudioIODeviceTyp
 
 void AudioDeviceManager::createAudioDeviceTypes (OwnedArray <AudioIODeviceType>& list)
 {
-    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_WASAPI());
+    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_WASAPI (false));
+    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_WASAPI (true));
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_DirectSound());
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_ASIO());
-    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_CoreAudio());
+    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_CoreAudio (false));
+    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_CoreAudio (true));
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_iOSAudio());
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_ALSA());
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_JACK());
@@ -186,15 +382,21 @@ String AudioDeviceManager::initialise (const int numInputChannelsNeeded,
                                        const String& preferredDefaultDeviceName,
                                        const AudioDeviceSetup* preferredSetupOptions)
 {
-    scanDevicesIfNeeded();
-
     numInputChansNeeded = numInputChannelsNeeded;
     numOutputChansNeeded = numOutputChannelsNeeded;
 
     if (e != nullptr && e->hasTagName ("DEVICESETUP"))
     {
+        // When restoring a saved state, only the type of the saved device gets scanned
+        // here, and the rest are scanned afterwards by the DeviceScanner.
+        createDeviceTypesIfNeeded();
+
         lastExplicitSettings = new XmlElement (*e);
 
+        if (const XmlElement* const cachedList = e->getChildByName ("DEVICELIST"))
+            if (deviceListCache == nullptr)
+                deviceListCache = new XmlElement (*cachedList);
+
         String error;
         AudioDeviceSetup setup;
 
@@ -248,10 +450,15 @@ String AudioDeviceManager::initialise (const int numInputChannelsNeeded,
 
         setDefaultMidiOutput (e->getStringAttribute ("defaultMidiOutput"));
 
+        if (listNeedsScanning && deviceScanner == nullptr)
+            deviceScanner = new DeviceScanner (*this);
+
         return error;
     }
     else
     {
+        scanDevicesIfNeeded();
+
         AudioDeviceSetup setup;
 
         if (preferredSetupOptions != nullptr)
@@ -320,13 +527,97 @@ void AudioDeviceManager::scanDevicesIfNeeded()
         createDeviceTypesIfNeeded();
 
         for (int i = availableDeviceTypes.size(); --i >= 0;)
-            availableDeviceTypes.getUnchecked(i)->scanForDevices();
+            scanDeviceTypeIfNeeded (availableDeviceTypes.getUnchecked(i));
+
+        if (updateDeviceListCache())
+            sendChangeMessage();
     }
 }
 
-AudioIODeviceType* AudioDeviceManager::findType (const String& typeName)
+void AudioDeviceManager::scanDeviceTypeIfNeeded (AudioIODeviceType* const type)
+{
+    if (type != nullptr && ! scannedDeviceTypes.contains (type))
+    {
+        scannedDeviceTypes.add (type);
+        type->scanForDevices();
+    }
+}
+
+bool AudioDeviceManager::scanNextDeviceType()
 {
+    for (int i = availableDeviceTypes.size(); --i >= 0;)
+    {
+        AudioIODeviceType* const type = availableDeviceTypes.getUnchecked(i);
+
+        if (! scannedDeviceTypes.contains (type))
+        {
+            scanDeviceTypeIfNeeded (type);
+            return true;
+        }
+    }
+
     scanDevicesIfNeeded();
+    return false;
+}
+
+bool AudioDeviceManager::updateDeviceListCache()
+{
+    ScopedPointer<XmlElement> newList (new XmlElement ("DEVICELIST"));
+
+    for (int i = 0; i < availableDeviceTypes.size(); ++i)
+    {
+        const AudioIODeviceType* const type = availableDeviceTypes.getUnchecked(i);
+        XmlElement* const typeXml = newList->createNewChildElement ("TYPE");
+        typeXml->setAttribute ("name", type->getTypeName());
+
+        const StringArray outs (type->getDeviceNames (false));
+
+        for (int j = 0; j < outs.size(); ++j)
+            typeXml->createNewChildElement ("OUTPUT")->setAttribute ("name", outs[j]);
+
+        if (type->hasSeparateInputsAndOutputs())
+        {
+            const StringArray ins (type->getDeviceNames (true));
+
+            for (int j = 0; j < ins.size(); ++j)
+                typeXml->createNewChildElement ("INPUT")->setAttribute ("name", ins[j]);
+        }
+    }
+
+    const bool changed = deviceListCache == nullptr || ! newList->isEquivalentTo (deviceListCache, false);
+    deviceListCache = newList;
+
+    if (lastExplicitSettings != nullptr)
+    {
+        lastExplicitSettings->deleteAllChildElementsWithTagName ("DEVICELIST");
+        lastExplicitSettings->addChildElement (new XmlElement (*deviceListCache));
+    }
+
+    return changed;
+}
+
+AudioIODeviceType* AudioDeviceManager::findTypeInDeviceListCache (const String& inputName, const String& outputName)
+{
+    if (deviceListCache != nullptr)
+    {
+        forEachXmlChildElementWithTagName (*deviceListCache, typeXml, "TYPE")
+        {
+            forEachXmlChildElement (*typeXml, deviceXml)
+            {
+                const String& name = deviceXml->getStringAttribute ("name");
+
+                if ((deviceXml->hasTagName ("INPUT") ? inputName : outputName) == name && name.isNotEmpty())
+                    return findType (typeXml->getStringAttribute ("name"));
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+AudioIODeviceType* AudioDeviceManager::findType (const String& typeName)
+{
+    createDeviceTypesIfNeeded();
 
     for (int i = availableDeviceTypes.size(); --i >= 0;)
         if (availableDeviceTypes.getUnchecked(i)->getTypeName() == typeName)
@@ -337,6 +628,10 @@ AudioIODeviceType* AudioDeviceManager::findType (const String& typeName)
 
 AudioIODeviceType* AudioDeviceManager::findType (const String& inputName, const String& outputName)
 {
+    if (listNeedsScanning)
+        if (AudioIODeviceType* const cachedType = findTypeInDeviceListCache (inputName, outputName))
+            return cachedType;
+
     scanDevicesIfNeeded();
 
     for (int i = availableDeviceTypes.size(); --i >= 0;)
@@ -381,6 +676,7 @@ void AudioDeviceManager::setCurrentAudioDeviceType (const String& type,
             }
 
             currentDeviceType = type;
+            scanDeviceTypeIfNeeded (availableDeviceTypes.getUnchecked(i));
 
             AudioDeviceSetup s (*lastDeviceTypeConfigs.getUnchecked(i));
             insertDefaultDeviceNames (s);
@@ -436,7 +732,7 @@ String AudioDeviceManager::setAudioDeviceSetup (const AudioDeviceSetup& newSetup
          || currentAudioDevice == nullptr)
     {
         deleteCurrentDevice();
-        scanDevicesIfNeeded();
+        scanDeviceTypeIfNeeded (type);
 
         if (newOutputDeviceName.isNotEmpty()
              && ! type->getDeviceNames (false).contains (newOutputDeviceName))
@@ -630,6 +926,9 @@ void AudioDeviceManager::updateXml()
 
     if (defaultMidiOutputName.isNotEmpty())
         lastExplicitSettings->setAttribute ("defaultMidiOutput", defaultMidiOutputName);
+
+    if (deviceListCache != nullptr)
+        lastExplicitSettings->addChildElement (new XmlElement (*deviceListCache));
 }
 
 //==============================================================================
@@ -646,6 +945,22 @@ void AudioDeviceManager::addAudioCallback (AudioIODeviceCallback* newCallback)
 
     const ScopedLock sl (audioCallbackLock);
     callbacks.add (newCallback);
+    publishCallbacks();
+
+    if (newCallback != nullptr && findTimingStats (newCallback) == nullptr)
+    {
+        for (int i = 0; i < maxTimedCallbacks; ++i)
+        {
+            TimedCallback& t = timedCallbacks[i];
+
+            if (t.callback.get() == nullptr)
+            {
+                t.stats.reset();
+                t.callback = newCallback;
+                break;
+            }
+        }
+    }
 }
 
 void AudioDeviceManager::removeAudioCallback (AudioIODeviceCallback* callbackToRemove)
@@ -659,6 +974,11 @@ void AudioDeviceManager::removeAudioCallback (AudioIODeviceCallback* callbackToR
 
             needsDeinitialising = needsDeinitialising && callbacks.contains (callbackToRemove);
             callbacks.removeFirstMatchingValue (callbackToRemove);
+            publishCallbacks();
+
+            for (int i = 0; i < maxTimedCallbacks; ++i)
+                if (timedCallbacks[i].callback.get() == callbackToRemove)
+                    timedCallbacks[i].callback = nullptr;
         }
 
         if (needsDeinitialising)
@@ -666,14 +986,69 @@ void AudioDeviceManager::removeAudioCallback (AudioIODeviceCallback* callbackToR
     }
 }
 
+void AudioDeviceManager::publishCallbacks()
+{
+    // (must be called with the lock held)
+    ScopedPointer <Array <AudioIODeviceCallback*> > oldList (activeCallbacks.exchange (new Array <AudioIODeviceCallback*> (callbacks)));
+    audioThreadHandover.waitForAudioThread();
+}
+
+void AudioDeviceManager::setNumCallbackThreads (const int numThreads)
+{
+    ScopedPointer<CallbackRenderer> newRenderer;
+
+    if (numThreads > 0)
+        newRenderer = new CallbackRenderer (*this, numThreads);
+
+    {
+        const ScopedLock sl (audioCallbackLock);
+
+        if (newRenderer != nullptr || callbackRenderer != nullptr)
+            callbackRenderer.swapWith (newRenderer);
+
+        audioThreadHandover.waitForAudioThread();
+    }
+}
+
+int AudioDeviceManager::getNumCallbackThreads() const noexcept
+{
+    return callbackRenderer != nullptr ? callbackRenderer->getNumThreads() : 0;
+}
+
+void AudioDeviceManager::setAudioCallbackLockingEnabled (const bool shouldLockAudioThread) noexcept
+{
+    lockAudioThread = shouldLockAudioThread;
+}
+
 void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelData,
                                                    int numInputChannels,
                                                    float** outputChannelData,
                                                    int numOutputChannels,
                                                    int numSamples)
 {
-    const ScopedLock sl (audioCallbackLock);
+    // (the callback has to be entered inside the lock when it's being used, or a thread that's
+    // holding the lock could end up waiting for a block that can't start)
+    if (lockAudioThread)
+    {
+        const ScopedLock sl (audioCallbackLock);
+        const AudioThreadHandover::ScopedCallback sc (audioThreadHandover);
 
+        processAudioBlock (inputChannelData, numInputChannels, outputChannelData, numOutputChannels, numSamples);
+    }
+    else
+    {
+        const AudioThreadHandover::ScopedCallback sc (audioThreadHandover);
+
+        processAudioBlock (inputChannelData, numInputChannels, outputChannelData, numOutputChannels, numSamples);
+    }
+}
+
+void AudioDeviceManager::processAudioBlock (const float** inputChannelData,
+                                            int numInputChannels,
+                                            float** outputChannelData,
+                                            int numOutputChannels,
+                                            int numSamples)
+{
     if (inputLevelMeasurementEnabledCount.get() > 0 && numInputChannels > 0)
     {
         for (int j = 0; j < numSamples; ++j)
@@ -700,34 +1075,40 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelDat
         inputLevel = 0;
     }
 
-    if (callbacks.size() > 0)
+    const Array <AudioIODeviceCallback*>& list = *activeCallbacks.get();
+
+    if (list.size() > 0)
     {
         const double callbackStartTime = Time::getMillisecondCounterHiRes();
 
-        tempBuffer.setSize (jmax (1, numOutputChannels), jmax (1, numSamples), false, false, true);
-
-        callbacks.getUnchecked(0)->audioDeviceIOCallback (inputChannelData, numInputChannels,
-                                                          outputChannelData, numOutputChannels, numSamples);
+        if (list.size() > 1 && callbackRenderer != nullptr)
+        {
+            callbackRenderer->render (list, inputChannelData, numInputChannels,
+                                      outputChannelData, numOutputChannels, numSamples, tempBuffer);
+        }
+        else
+        {
+            tempBuffer.setSize (jmax (1, numOutputChannels), jmax (1, numSamples), false, false, true);
 
-        float** const tempChans = tempBuffer.getArrayOfChannels();
+            callAndTime (list.getUnchecked(0), inputChannelData, numInputChannels,
+                         outputChannelData, numOutputChannels, numSamples);
 
-        for (int i = callbacks.size(); --i > 0;)
-        {
-            callbacks.getUnchecked(i)->audioDeviceIOCallback (inputChannelData, numInputChannels,
-                                                              tempChans, numOutputChannels, numSamples);
+            float** const tempChans = tempBuffer.getArrayOfChannels();
 
-            for (int chan = 0; chan < numOutputChannels; ++chan)
+            for (int i = list.size(); --i > 0;)
             {
-                if (const float* const src = tempChans [chan])
-                    if (float* const dst = outputChannelData [chan])
-                        for (int j = 0; j < numSamples; ++j)
-                            dst[j] += src[j];
+                callAndTime (list.getUnchecked(i), inputChannelData, numInputChannels,
+                             tempChans, numOutputChannels, numSamples);
+
+                AudioDeviceManagerHelpers::addChannels (outputChannelData, tempChans, numOutputChannels, numSamples);
             }
         }
 
         const double msTaken = Time::getMillisecondCounterHiRes() - callbackStartTime;
         const double filterAmount = 0.2;
         cpuUsageMs += filterAmount * (msTaken - cpuUsageMs);
+
+        deviceTimingStats.addCallback (msTaken, msPerSample * numSamples);
     }
     else
     {
@@ -735,24 +1116,41 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelDat
             zeromem (outputChannelData[i], sizeof (float) * (size_t) numSamples);
     }
 
-    if (testSound != nullptr)
+    // (a finished test sound is left for playTestSound() or stopDevice() to delete, so
+    // that the buffer never gets freed on the audio thread)
+    const AudioSampleBuffer* const sound = testSound;
+
+    if (sound != nullptr && testSoundPosition < sound->getNumSamples())
     {
-        const int numSamps = jmin (numSamples, testSound->getNumSamples() - testSoundPosition);
-        const float* const src = testSound->getSampleData (0, testSoundPosition);
+        const int numSamps = jmin (numSamples, sound->getNumSamples() - testSoundPosition);
+        const float* const src = sound->getReadPointer (0, testSoundPosition);
 
         for (int i = 0; i < numOutputChannels; ++i)
-            for (int j = 0; j < numSamps; ++j)
-                outputChannelData [i][j] += src[j];
+            if (float* const dst = outputChannelData [i])
+                FloatVectorOperations::add (dst, src, numSamps);
 
         testSoundPosition += numSamps;
-        if (testSoundPosition >= testSound->getNumSamples())
-            testSound = nullptr;
     }
 }
 
+void AudioDeviceManager::callAndTime (AudioIODeviceCallback* const callback,
+                                      const float** inputChannelData, int numInputChannels,
+                                      float** outputChannelData, int numOutputChannels, int numSamples)
+{
+    AudioCallbackTimingStats* const stats = findTimingStats (callback);
+    const double callbackStartTime = stats != nullptr ? Time::getMillisecondCounterHiRes() : 0.0;
+
+    callback->audioDeviceIOCallback (inputChannelData, numInputChannels,
+                                     outputChannelData, numOutputChannels, numSamples);
+
+    if (stats != nullptr)
+        stats->addCallback (Time::getMillisecondCounterHiRes() - callbackStartTime, msPerSample * numSamples);
+}
+
 void AudioDeviceManager::audioDeviceAboutToStartInt (AudioIODevice* const device)
 {
     cpuUsageMs = 0;
+    msPerSample = 0;
 
     const double sampleRate = device->getCurrentSampleRate();
     const int blockSize = device->getCurrentBufferSizeSamples();
@@ -761,8 +1159,11 @@ void AudioDeviceManager::audioDeviceAboutToStartInt (AudioIODevice* const device
     {
         const double msPerBlock = 1000.0 * blockSize / sampleRate;
         timeToCpuScale = (msPerBlock > 0.0) ? (1.0 / msPerBlock) : 0.0;
+        msPerSample = 1000.0 / sampleRate;
     }
 
+    resetCallbackTimingStats();
+
     {
         const ScopedLock sl (audioCallbackLock);
         for (int i = callbacks.size(); --i >= 0;)
@@ -776,6 +1177,7 @@ void AudioDeviceManager::audioDeviceStoppedInt()
 {
     cpuUsageMs = 0;
     timeToCpuScale = 0;
+    msPerSample = 0;
     sendChangeMessage();
 
     const ScopedLock sl (audioCallbackLock);
@@ -795,6 +1197,34 @@ double AudioDeviceManager::getCpuUsage() const
     return jlimit (0.0, 1.0, timeToCpuScale * cpuUsageMs);
 }
 
+AudioCallbackTimingStats* AudioDeviceManager::findTimingStats (AudioIODeviceCallback* const callback) const noexcept
+{
+    if (callback != nullptr)
+        for (int i = 0; i < maxTimedCallbacks; ++i)
+            if (timedCallbacks[i].callback.get() == callback)
+                return const_cast <AudioCallbackTimingStats*> (&(timedCallbacks[i].stats));
+
+    return nullptr;
+}
+
+const AudioCallbackTimingStats* AudioDeviceManager::getCallbackTimingStats (AudioIODeviceCallback* const callback) const noexcept
+{
+    return findTimingStats (callback);
+}
+
+void AudioDeviceManager::resetCallbackTimingStats() noexcept
+{
+    deviceTimingStats.reset();
+
+    for (int i = 0; i < maxTimedCallbacks; ++i)
+        timedCallbacks[i].stats.reset();
+}
+
+int AudioDeviceManager::getXRunCount() const noexcept
+{
+    return currentAudioDevice != nullptr ? currentAudioDevice->getXRunCount() : -1;
+}
+
 //==============================================================================
 void AudioDeviceManager::setMidiInputEnabled (const String& name, const bool enabled)
 {
@@ -888,6 +1318,7 @@ void AudioDeviceManager::setDefaultMidiOutput (const String& deviceName)
             const ScopedLock sl (audioCallbackLock);
             oldCallbacks = callbacks;
             callbacks.clear();
+            publishCallbacks();
         }
 
         if (currentAudioDevice != nullptr)
@@ -907,6 +1338,7 @@ void AudioDeviceManager::setDefaultMidiOutput (const String& deviceName)
         {
             const ScopedLock sl (audioCallbackLock);
             callbacks = oldCallbacks;
+            publishCallbacks();
         }
 
         updateXml();
@@ -923,6 +1355,7 @@ void AudioDeviceManager::playTestSound()
         {
             const ScopedLock sl (audioCallbackLock);
             oldSound = testSound;
+            audioThreadHandover.waitForAudioThread();
         }
     }
 
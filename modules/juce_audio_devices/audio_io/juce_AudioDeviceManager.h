@@ -27,6 +27,7 @@
 #define __JUCE_AUDIODEVICEMANAGER_JUCEHEADER__
 
 #include "juce_AudioIODeviceType.h"
+#include "juce_AudioCallbackTimingStats.h"
 #include "../midi_io/juce_MidiInput.h"
 #include "../midi_io/juce_MidiOutput.h"
 
@@ -174,7 +175,10 @@ public:
                                             the number requested)
         @param savedState                   either a previously-saved state that was produced
                                             by createStateXml(), or nullptr if you want the manager
-                                            to choose the best device to open.
+                                            to choose the best device to open. When a saved state
+                                            is used, only the saved device's type is scanned before
+                                            the device is opened, and the other types are scanned
+                                            afterwards on the message thread.
         @param selectDefaultDeviceOnFailure if true, then if the device specified in the XML
                                             fails to open, then a default device will be used
                                             instead. If false, then on failure, no device is
@@ -205,6 +209,10 @@ public:
 
         Note that this can return a null pointer if no settings have been explicitly changed
         (i.e. if the device manager has just been left in its default state).
+
+        Once all the device types have been scanned, the XML also contains the list of
+        devices that were found, which lets initialise() find the type of a saved device
+        without scanning every type first.
     */
     XmlElement* createStateXml() const;
 
@@ -304,6 +312,41 @@ public:
     */
     void removeAudioCallback (AudioIODeviceCallback* callback);
 
+    /** Sets the number of extra threads that will be used to run the audio callbacks.
+
+        When this is greater than zero and more than one callback is registered, the
+        callbacks are shared between the audio thread and this many worker threads, so
+        independent callbacks (e.g. a meter, a monitor mix and the main engine) can run
+        at the same time. Each one renders into its own buffer, and the buffers are summed
+        into the device's output in the same way as when they're called one at a time.
+
+        This means that different callbacks may be running concurrently, so it must only
+        be used if none of your callbacks share any state that they modify.
+
+        Passing zero (the default) runs all the callbacks one after the other on the
+        audio thread. This should be called from the message thread.
+    */
+    void setNumCallbackThreads (int numThreads);
+
+    /** Returns the number of worker threads that were set with setNumCallbackThreads(). */
+    int getNumCallbackThreads() const noexcept;
+
+    /** Chooses whether the audio thread locks the audio callback lock while it's running.
+
+        By default this is enabled, and the lock returned by getAudioCallbackLock() is held
+        while the callbacks are being run, so that other threads can lock it to stop them
+        running. If you disable it, the audio thread never blocks: it picks up the list of
+        callbacks without any locking, and adding or removing a callback will wait for any
+        block that's in progress to finish instead. The lock is then only useful for
+        synchronising with changes to the manager's own state.
+
+        @see getAudioCallbackLock
+    */
+    void setAudioCallbackLockingEnabled (bool shouldLockAudioThread) noexcept;
+
+    /** Returns the value set by setAudioCallbackLockingEnabled(). */
+    bool isAudioCallbackLockingEnabled() const noexcept         { return lockAudioThread; }
+
     //==============================================================================
     /** Returns the average proportion of available CPU being spent inside the audio callbacks.
 
@@ -311,6 +354,46 @@ public:
     */
     double getCpuUsage() const;
 
+    /** Returns timing statistics for the audio callbacks as a whole.
+
+        This covers the time spent calling all the registered callbacks for each block,
+        measured against the duration of the block. The stats are cleared each time
+        the device starts, so they always refer to the current device - use
+        getCurrentAudioDeviceType() to find out what kind of device that is.
+
+        The object can be read from any thread without locking.
+
+        @see getXRunCount, resetCallbackTimingStats
+    */
+    const AudioCallbackTimingStats& getCallbackTimingStats() const noexcept     { return deviceTimingStats; }
+
+    /** Returns timing statistics for one of the registered callbacks.
+
+        Only the first few callbacks that are registered get individually timed (see
+        maxTimedCallbacks), so this returns nullptr if the callback isn't registered or
+        isn't being timed. The object that's returned belongs to the manager and can be
+        read from any thread without locking, but once the callback has been removed, it
+        may get re-used for a different callback.
+    */
+    const AudioCallbackTimingStats* getCallbackTimingStats (AudioIODeviceCallback* callback) const noexcept;
+
+    /** Clears the device and per-callback timing stats. */
+    void resetCallbackTimingStats() noexcept;
+
+    /** Returns the number of buffer under- or overruns reported by the current device.
+
+        This returns -1 if there's no device open, or if the device can't report them.
+
+        @see AudioIODevice::getXRunCount
+    */
+    int getXRunCount() const noexcept;
+
+    enum
+    {
+        /** The number of registered callbacks that can be individually timed. */
+        maxTimedCallbacks = 16
+    };
+
     //==============================================================================
     /** Enables or disables a midi input device.
 
@@ -440,6 +523,9 @@ public:
     /** Returns the a lock that can be used to synchronise access to the audio callback.
         Obviously while this is locked, you're blocking the audio thread from running, so
         it must only be used for very brief periods when absolutely necessary.
+
+        If setAudioCallbackLockingEnabled() has been used to turn off locking, the audio
+        thread doesn't use this lock, so holding it won't stop the callbacks being run.
     */
     CriticalSection& getAudioCallbackLock() noexcept        { return audioCallbackLock; }
 
@@ -457,11 +543,16 @@ private:
     AudioDeviceSetup currentSetup;
     ScopedPointer <AudioIODevice> currentAudioDevice;
     Array <AudioIODeviceCallback*> callbacks;
+    Atomic <Array <AudioIODeviceCallback*>*> activeCallbacks;
+    AudioThreadHandover audioThreadHandover;
+    bool lockAudioThread;
     int numInputChansNeeded, numOutputChansNeeded;
     String currentDeviceType;
     BigInteger inputChannels, outputChannels;
     ScopedPointer <XmlElement> lastExplicitSettings;
     mutable bool listNeedsScanning;
+    Array <AudioIODeviceType*> scannedDeviceTypes;
+    ScopedPointer <XmlElement> deviceListCache;
     bool useInputNames;
     Atomic<int> inputLevelMeasurementEnabledCount;
     double inputLevel;
@@ -477,7 +568,16 @@ private:
     ScopedPointer <MidiOutput> defaultMidiOutput;
     CriticalSection audioCallbackLock, midiCallbackLock;
 
-    double cpuUsageMs, timeToCpuScale;
+    double cpuUsageMs, timeToCpuScale, msPerSample;
+
+    struct TimedCallback
+    {
+        Atomic<AudioIODeviceCallback*> callback;
+        AudioCallbackTimingStats stats;
+    };
+
+    AudioCallbackTimingStats deviceTimingStats;
+    TimedCallback timedCallbacks [maxTimedCallbacks];
 
     //==============================================================================
     class CallbackHandler;
@@ -485,13 +585,29 @@ private:
     friend class ScopedPointer<CallbackHandler>;
     ScopedPointer<CallbackHandler> callbackHandler;
 
+    class CallbackRenderer;
+    friend class CallbackRenderer;
+    friend class ScopedPointer<CallbackRenderer>;
+    ScopedPointer<CallbackRenderer> callbackRenderer;
+
+    class DeviceScanner;
+    friend class DeviceScanner;
+    friend class ScopedPointer<DeviceScanner>;
+    ScopedPointer<DeviceScanner> deviceScanner;
+
     void audioDeviceIOCallbackInt (const float** inputChannelData, int totalNumInputChannels,
                                    float** outputChannelData, int totalNumOutputChannels, int numSamples);
+    void processAudioBlock (const float** inputChannelData, int totalNumInputChannels,
+                            float** outputChannelData, int totalNumOutputChannels, int numSamples);
+    void publishCallbacks();
     void audioDeviceAboutToStartInt (AudioIODevice*);
     void audioDeviceStoppedInt();
     void audioDeviceErrorInt (const String&);
     void handleIncomingMidiMessageInt (MidiInput*, const MidiMessage&);
     void audioDeviceListChanged();
+    AudioCallbackTimingStats* findTimingStats (AudioIODeviceCallback*) const noexcept;
+    void callAndTime (AudioIODeviceCallback*, const float** inputChannelData, int numInputChannels,
+                      float** outputChannelData, int numOutputChannels, int numSamples);
 
     String restartDevice (int blockSizeToUse, double sampleRateToUse,
                           const BigInteger& ins, const BigInteger& outs);
@@ -501,6 +617,9 @@ private:
 
     void createDeviceTypesIfNeeded();
     void scanDevicesIfNeeded();
+    void scanDeviceTypeIfNeeded (AudioIODeviceType*);
+    bool scanNextDeviceType();
+    bool updateDeviceListCache();
     void deleteCurrentDevice();
     double chooseBestSampleRate (double preferred) const;
     int chooseBestBufferSize (int preferred) const;
@@ -508,6 +627,7 @@ private:
 
     AudioIODeviceType* findType (const String& inputName, const String& outputName);
     AudioIODeviceType* findType (const String& typeName);
+    AudioIODeviceType* findTypeInDeviceListCache (const String& inputName, const String& outputName);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioDeviceManager)
 };
@@ -33,6 +33,40 @@ AudioIODevice::~AudioIODevice()
 {
 }
 
+int AudioIODevice::getXRunCount() const noexcept
+{
+    return -1;
+}
+
+AudioIODevice::TransportPosition::TransportPosition() noexcept
+    : timeInSamples (0),
+      isPlaying (false),
+      hasMusicalPosition (false),
+      bar (1),
+      beat (1),
+      tick (0),
+      ticksPerBeat (960.0),
+      beatsPerBar (4.0f),
+      beatType (4.0f),
+      bpm (120.0)
+{
+}
+
+bool AudioIODevice::getTransportPosition (TransportPosition&)
+{
+    return false;
+}
+
+bool AudioIODevice::setTransportPlaying (bool)
+{
+    return false;
+}
+
+bool AudioIODevice::setTransportPosition (int64)
+{
+    return false;
+}
+
 bool AudioIODevice::hasControlPanel() const
 {
     return false;
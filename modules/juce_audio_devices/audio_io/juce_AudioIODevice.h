@@ -303,6 +303,64 @@ public:
     */
     virtual int getInputLatencyInSamples() = 0;
 
+    /** Returns the number of buffer under- or overruns that the device has reported
+        since it was opened.
+
+        This is only supported by some device types - if the device can't tell, it'll
+        return -1.
+    */
+    virtual int getXRunCount() const noexcept;
+
+    //==============================================================================
+    /** Describes the position of a transport that an audio device is synchronised to.
+        @see getTransportPosition
+    */
+    struct JUCE_API  TransportPosition
+    {
+        TransportPosition() noexcept;
+
+        /** The transport's position, in samples. */
+        int64 timeInSamples;
+
+        /** True if the transport is rolling. */
+        bool isPlaying;
+
+        /** True if the musical position fields below are valid. */
+        bool hasMusicalPosition;
+
+        /** The current bar and beat, both counting from 1. */
+        int bar, beat;
+
+        /** The number of ticks through the current beat, out of ticksPerBeat. */
+        int tick;
+        double ticksPerBeat;
+
+        /** The time signature, and the tempo in beats (of beatType) per minute. */
+        float beatsPerBar, beatType;
+        double bpm;
+    };
+
+    /** If the device is synchronised to an external transport (e.g. JACK transport),
+        this fills in its current position and returns true.
+
+        Most device types don't have a transport, and will just return false.
+    */
+    virtual bool getTransportPosition (TransportPosition& result);
+
+    /** Asks the device's transport to start or stop rolling.
+
+        Returns false if the device doesn't have a transport.
+        @see getTransportPosition
+    */
+    virtual bool setTransportPlaying (bool shouldPlay);
+
+    /** Asks the device's transport to move to a new position, in samples.
+
+        Returns false if the device doesn't have a transport.
+        @see getTransportPosition
+    */
+    virtual bool setTransportPosition (int64 newTimeInSamples);
+
 
     //==============================================================================
     /** True if this device can show a pop-up control panel for editing its settings.
@@ -43,7 +43,7 @@ void AudioIODeviceType::callDeviceChangeListeners()
 
 //==============================================================================
 #if ! JUCE_MAC
-AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_CoreAudio()       { return nullptr; }
+AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_CoreAudio (bool)   { return nullptr; }
 #endif
 
 #if ! JUCE_IOS
@@ -51,7 +51,7 @@ AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_iOSAudio()
 #endif
 
 #if ! (JUCE_WINDOWS && JUCE_WASAPI)
-AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_WASAPI()          { return nullptr; }
+AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_WASAPI (bool)      { return nullptr; }
 #endif
 
 #if ! (JUCE_WINDOWS && JUCE_DIRECTSOUND)
@@ -150,12 +150,21 @@ public:
     virtual ~AudioIODeviceType();
 
     //==============================================================================
-    /** Creates a CoreAudio device type if it's available on this platform, or returns null. */
-    static AudioIODeviceType* createAudioIODeviceType_CoreAudio();
+    /** Creates a CoreAudio device type if it's available on this platform, or returns null.
+
+        If exclusiveMode is true, the devices it creates take the hardware in hog mode so that
+        no other process can use it, and offer the whole of its buffer-size range for the
+        lowest latency.
+    */
+    static AudioIODeviceType* createAudioIODeviceType_CoreAudio (bool exclusiveMode = false);
     /** Creates an iOS device type if it's available on this platform, or returns null. */
     static AudioIODeviceType* createAudioIODeviceType_iOSAudio();
-    /** Creates a WASAPI device type if it's available on this platform, or returns null. */
-    static AudioIODeviceType* createAudioIODeviceType_WASAPI();
+    /** Creates a WASAPI device type if it's available on this platform, or returns null.
+
+        If exclusiveMode is true, the devices it creates take exclusive control of the
+        hardware, and are driven directly by its period events for the lowest latency.
+    */
+    static AudioIODeviceType* createAudioIODeviceType_WASAPI (bool exclusiveMode = false);
     /** Creates a DirectSound device type if it's available on this platform, or returns null. */
     static AudioIODeviceType* createAudioIODeviceType_DirectSound();
     /** Creates an ASIO device type if it's available on this platform, or returns null. */
@@ -134,6 +134,8 @@ namespace juce
 {
 
 // START_AUTOINCLUDE audio_io/*.cpp, midi_io/*.cpp, audio_cd/*.cpp, sources/*.cpp
+#include "audio_io/juce_AggregateAudioIODevice.cpp"
+#include "audio_io/juce_AudioCallbackTimingStats.cpp"
 #include "audio_io/juce_AudioDeviceManager.cpp"
 #include "audio_io/juce_AudioIODevice.cpp"
 #include "audio_io/juce_AudioIODeviceType.cpp"
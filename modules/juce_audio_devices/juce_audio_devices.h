@@ -102,6 +102,12 @@ namespace juce
 {
 
 // START_AUTOINCLUDE audio_io, midi_io, sources, audio_cd
+#ifndef __JUCE_AGGREGATEAUDIOIODEVICE_JUCEHEADER__
+ #include "audio_io/juce_AggregateAudioIODevice.h"
+#endif
+#ifndef __JUCE_AUDIOCALLBACKTIMINGSTATS_JUCEHEADER__
+ #include "audio_io/juce_AudioCallbackTimingStats.h"
+#endif
 #ifndef __JUCE_AUDIODEVICEMANAGER_JUCEHEADER__
  #include "audio_io/juce_AudioDeviceManager.h"
 #endif
@@ -60,6 +60,37 @@ public:
     virtual void handleIncomingMidiMessage (MidiInput* source,
                                             const MidiMessage& message) = 0;
 
+    /** Receives a batch of incoming messages.
+
+        When a MidiInput has several messages to deliver at once, it calls this method
+        instead of calling handleIncomingMidiMessage() for each of them. The default
+        implementation just does that anyway, but if you're dealing with a lot of
+        incoming data (e.g. from a network MIDI driver, or a dense stream of controller
+        data), overriding this lets you handle the whole lot in one go, without having
+        to create a MidiMessage object for each event.
+
+        Like handleIncomingMidiMessage(), this is called on a high-priority system thread.
+
+        @param source       the MidiInput object that generated the messages
+        @param messages     the messages, in the order that they arrived. Each event's
+                            position in the buffer is the number of microseconds after
+                            batchTime that it arrived.
+        @param batchTime    the time at which the first event in the batch arrived,
+                            using the same units as the timestamps that are given to
+                            handleIncomingMidiMessage(), i.e. seconds.
+    */
+    virtual void handleIncomingMidiBatch (MidiInput* source,
+                                          const MidiBuffer& messages,
+                                          double batchTime)
+    {
+        MidiBuffer::Iterator i (messages);
+        const uint8* data;
+        int numBytes, position;
+
+        while (i.getNextEvent (data, numBytes, position))
+            handleIncomingMidiMessage (source, MidiMessage (data, numBytes, batchTime + position * 1.0e-6));
+    }
+
     /** Notification sent each time a packet of a multi-packet sysex message arrives.
 
         If a long sysex message is broken up into multiple packets, this callback is made
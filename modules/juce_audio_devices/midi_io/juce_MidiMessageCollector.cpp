@@ -23,10 +23,137 @@
   ==============================================================================
 */
 
+/*  A lock-free FIFO of timestamped messages, for a single sender and a single receiver.
+
+    Each message is stored as its timestamp and size, followed by its data, so sysex
+    messages of any length can be passed through it.
+*/
+class MidiMessageCollector::SourceQueue
+{
+public:
+    SourceQueue()
+        : fifo (queueSize),
+          buffer ((size_t) queueSize)
+    {
+    }
+
+    enum { queueSize = 16384, headerSize = sizeof (double) + sizeof (int) };
+
+    bool push (const MidiMessage& message) noexcept
+    {
+        return push (message.getRawData(), message.getRawDataSize(), message.getTimeStamp());
+    }
+
+    bool push (const uint8* const data, const int numBytes, const double timeStamp) noexcept
+    {
+        const int total = headerSize + numBytes;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (total, start1, size1, start2, size2);
+
+        if (size1 + size2 < total)
+            return false;
+
+        copyIn (start1, size1, start2, 0, &timeStamp, sizeof (timeStamp));
+        copyIn (start1, size1, start2, sizeof (timeStamp), &numBytes, sizeof (numBytes));
+        copyIn (start1, size1, start2, headerSize, data, numBytes);
+
+        fifo.finishedWrite (total);
+        return true;
+    }
+
+    // (peek() finds out about the next message, which must then be removed with read() or skip())
+    bool peek (double& timeStamp, int& numBytes) noexcept
+    {
+        if (fifo.getNumReady() < headerSize)
+            return false;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (headerSize, start1, size1, start2, size2);
+
+        copyOut (start1, size1, start2, 0, &timeStamp, sizeof (timeStamp));
+        copyOut (start1, size1, start2, sizeof (timeStamp), &numBytes, sizeof (numBytes));
+        return true;
+    }
+
+    // returns the number of messages that didn't fit
+    int pushBatch (const MidiBuffer& messages, const double batchTime) noexcept
+    {
+        MidiBuffer::Iterator i (messages);
+        const uint8* data;
+        int numBytes, position, numDropped = 0;
+
+        while (i.getNextEvent (data, numBytes, position))
+            if (! push (data, numBytes, batchTime + position * 1.0e-6))
+                ++numDropped;
+
+        return numDropped;
+    }
+
+    void read (uint8* const dest, const int numBytes) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (headerSize + numBytes, start1, size1, start2, size2);
+
+        copyOut (start1, size1, start2, headerSize, dest, numBytes);
+        fifo.finishedRead (headerSize + numBytes);
+    }
+
+    void clear() noexcept
+    {
+        // (the sender only ever adds whole messages, so this can't leave a partial one behind)
+        fifo.finishedRead (fifo.getNumReady());
+    }
+
+    Atomic<void*> source;
+
+private:
+    AbstractFifo fifo;
+    HeapBlock<uint8> buffer;
+
+    // These copy some bytes to or from a position in a block that the fifo has returned,
+    // which may be split across the end of the buffer..
+    void copyIn (const int start1, const int size1, const int start2,
+                 const int offset, const void* const src, const int num) noexcept
+    {
+        const int numInFirst = jlimit (0, num, size1 - offset);
+
+        if (numInFirst > 0)
+            memcpy (buffer + start1 + offset, src, (size_t) numInFirst);
+
+        if (num > numInFirst)
+            memcpy (buffer + start2 + jmax (0, offset - size1),
+                    static_cast <const uint8*> (src) + numInFirst, (size_t) (num - numInFirst));
+    }
+
+    void copyOut (const int start1, const int size1, const int start2,
+                  const int offset, void* const dest, const int num) const noexcept
+    {
+        const int numInFirst = jlimit (0, num, size1 - offset);
+
+        if (numInFirst > 0)
+            memcpy (dest, buffer + start1 + offset, (size_t) numInFirst);
+
+        if (num > numInFirst)
+            memcpy (static_cast <uint8*> (dest) + numInFirst,
+                    buffer + start2 + jmax (0, offset - size1), (size_t) (num - numInFirst));
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (SourceQueue)
+};
+
+//==============================================================================
 MidiMessageCollector::MidiMessageCollector()
-    : lastCallbackTime (0),
-      sampleRate (44100.0001)
+    : messageData ((size_t) SourceQueue::queueSize),
+      sampleRate (44100.0001),
+      blockStartTime (0),
+      secondsPerSample (1.0 / 44100.0),
+      callbackJitter (0),
+      lastBlockSize (0),
+      maxBlockSize (0)
 {
+    for (int i = 0; i <= maxSources; ++i)
+        queues.add (new SourceQueue());
 }
 
 MidiMessageCollector::~MidiMessageCollector()
@@ -38,13 +165,22 @@ void MidiMessageCollector::reset (const double sampleRate_)
 {
     jassert (sampleRate_ > 0);
 
-    const ScopedLock sl (midiCallbackLock);
     sampleRate = sampleRate_;
-    incomingMessages.clear();
-    lastCallbackTime = Time::getMillisecondCounterHiRes();
+    secondsPerSample = 1.0 / sampleRate;
+    callbackJitter = 0;
+    lastBlockSize = 0;
+    maxBlockSize = 0;
+
+    for (int i = queues.size(); --i >= 0;)
+        queues.getUnchecked(i)->clear();
 }
 
 void MidiMessageCollector::addMessageToQueue (const MidiMessage& message)
+{
+    addMessageFromSource (message, nullptr);
+}
+
+void MidiMessageCollector::addMessageFromSource (const MidiMessage& message, void* const source)
 {
     // you need to call reset() to set the correct sample rate before using this object
     jassert (sampleRate != 44100.0001);
@@ -53,17 +189,71 @@ void MidiMessageCollector::addMessageToQueue (const MidiMessage& message)
     // for details of what the number should be.
     jassert (message.getTimeStamp() != 0);
 
-    const ScopedLock sl (midiCallbackLock);
+    if (SourceQueue* const queue = findQueueFor (source))
+    {
+        if (! queue->push (message))
+            ++numDroppedMessages;
+
+        return;
+    }
+
+    const SpinLock::ScopedLockType sl (sharedQueueLock);
+
+    if (! queues.getUnchecked(0)->push (message))
+        ++numDroppedMessages;
+}
 
-    const int sampleNumber
-        = (int) ((message.getTimeStamp() - 0.001 * lastCallbackTime) * sampleRate);
+MidiMessageCollector::SourceQueue* MidiMessageCollector::findQueueFor (void* const source) noexcept
+{
+    if (source == nullptr)
+        return nullptr;
 
-    incomingMessages.addEvent (message, sampleNumber);
+    // The queues are claimed in order and never given back, so a source will always
+    // find its own queue before it gets to any free ones..
+    for (int i = 1; i < queues.size(); ++i)
+    {
+        SourceQueue* const queue = queues.getUnchecked(i);
+        void* const owner = queue->source.get();
 
-    // if the messages don't get used for over a second, we'd better
-    // get rid of any old ones to avoid the queue getting too big
-    if (sampleNumber > sampleRate)
-        incomingMessages.clear (0, sampleNumber - (int) sampleRate);
+        if (owner == source
+             || (owner == nullptr && queue->source.compareAndSetBool (source, nullptr)))
+            return queue;
+    }
+
+    return nullptr;
+}
+
+void MidiMessageCollector::updateBlockTime (const double now, const int numSamples) noexcept
+{
+    if (lastBlockSize > 0)
+    {
+        const double expectedTime = blockStartTime + lastBlockSize * secondsPerSample;
+        const double error = now - expectedTime;
+
+        // (if the audio has stalled, the model needs to start again from scratch)
+        if (std::abs (error) < 4.0 * lastBlockSize / sampleRate)
+        {
+            // This is a second-order delay-locked loop, with a bandwidth of about 1Hz. It follows
+            // the actual rate of the audio clock, but filters out the jitter in the callbacks.
+            const double omega = 2.0 * double_Pi * lastBlockSize / sampleRate;
+
+            blockStartTime = expectedTime + std::sqrt (2.0) * omega * error;
+            secondsPerSample += omega * omega * error / lastBlockSize;
+
+            // A message can arrive just after a callback that ran early, which would make
+            // it late for the next one, so the worst recent earliness is added to the delay.
+            callbackJitter = jmax (blockStartTime - now, callbackJitter * 0.999);
+            lastBlockSize = numSamples;
+            maxBlockSize = jmax (maxBlockSize, numSamples);
+            return;
+        }
+    }
+
+    blockStartTime = now;
+    secondsPerSample = 1.0 / sampleRate;
+    callbackJitter = 0;
+    lastBlockSize = numSamples;
+    maxBlockSize = jmax (maxBlockSize, numSamples);
 }
 
 void MidiMessageCollector::removeNextBlockOfMessages (MidiBuffer& destBuffer,
@@ -73,82 +263,67 @@ void MidiMessageCollector::removeNextBlockOfMessages (MidiBuffer& destBuffer,
     jassert (sampleRate != 44100.0001);
     jassert (numSamples > 0);
 
-    const double timeNow = Time::getMillisecondCounterHiRes();
-    const double msElapsed = timeNow - lastCallbackTime;
+    updateBlockTime (Time::getMillisecondCounterHiRes() * 0.001, numSamples);
 
-    const ScopedLock sl (midiCallbackLock);
-    lastCallbackTime = timeNow;
+    // Every message is delayed by the length of the longest block (plus the jitter), so
+    // anything that arrived during the last block has a place in this one..
+    const double delayedBlockStart = blockStartTime - maxBlockSize * secondsPerSample - callbackJitter;
+    const double samplesPerSecond = 1.0 / secondsPerSample;
 
-    if (! incomingMessages.isEmpty())
+    for (int i = 0; i < queues.size(); ++i)
     {
-        int numSourceSamples = jmax (1, roundToInt (msElapsed * 0.001 * sampleRate));
-
-        int startSample = 0;
-        int scale = 1 << 16;
+        SourceQueue& queue = *queues.getUnchecked(i);
+        double timeStamp;
+        int numBytes;
 
-        const uint8* midiData;
-        int numBytes, samplePosition;
+        while (queue.peek (timeStamp, numBytes))
+        {
+            const double position = (timeStamp - delayedBlockStart) * samplesPerSecond;
 
-        MidiBuffer::Iterator iter (incomingMessages);
+            // (this message belongs in a later block, unless its timestamp is just wrong)
+            if (position >= numSamples && position < numSamples + sampleRate)
+                break;
 
-        if (numSourceSamples > numSamples)
-        {
-            // if our list of events is longer than the buffer we're being
-            // asked for, scale them down to squeeze them all in..
-            const int maxBlockLengthToUse = numSamples << 5;
-
-            if (numSourceSamples > maxBlockLengthToUse)
-            {
-                startSample = numSourceSamples - maxBlockLengthToUse;
-                numSourceSamples = maxBlockLengthToUse;
-                iter.setNextSamplePosition (startSample);
-            }
-
-            scale = (numSamples << 10) / numSourceSamples;
-
-            while (iter.getNextEvent (midiData, numBytes, samplePosition))
-            {
-                samplePosition = ((samplePosition - startSample) * scale) >> 10;
-
-                destBuffer.addEvent (midiData, numBytes,
-                                     jlimit (0, numSamples - 1, samplePosition));
-            }
+            queue.read (messageData, numBytes);
+            destBuffer.addEvent (messageData, numBytes, jlimit (0, numSamples - 1, (int) position));
         }
-        else
-        {
-            // if our event list is shorter than the number we need, put them
-            // towards the end of the buffer
-            startSample = numSamples - numSourceSamples;
-
-            while (iter.getNextEvent (midiData, numBytes, samplePosition))
-            {
-                destBuffer.addEvent (midiData, numBytes,
-                                     jlimit (0, numSamples - 1, samplePosition + startSample));
-            }
-        }
-
-        incomingMessages.clear();
     }
 }
 
 //==============================================================================
-void MidiMessageCollector::handleNoteOn (MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity)
+void MidiMessageCollector::handleNoteOn (MidiKeyboardState* source, int midiChannel, int midiNoteNumber, float velocity)
 {
     MidiMessage m (MidiMessage::noteOn (midiChannel, midiNoteNumber, velocity));
     m.setTimeStamp (Time::getMillisecondCounterHiRes() * 0.001);
 
-    addMessageToQueue (m);
+    addMessageFromSource (m, source);
 }
 
-void MidiMessageCollector::handleNoteOff (MidiKeyboardState*, int midiChannel, int midiNoteNumber)
+void MidiMessageCollector::handleNoteOff (MidiKeyboardState* source, int midiChannel, int midiNoteNumber)
 {
     MidiMessage m (MidiMessage::noteOff (midiChannel, midiNoteNumber));
     m.setTimeStamp (Time::getMillisecondCounterHiRes() * 0.001);
 
-    addMessageToQueue (m);
+    addMessageFromSource (m, source);
 }
 
-void MidiMessageCollector::handleIncomingMidiMessage (MidiInput*, const MidiMessage& message)
+void MidiMessageCollector::handleIncomingMidiMessage (MidiInput* source, const MidiMessage& message)
 {
-    addMessageToQueue (message);
+    addMessageFromSource (message, source);
+}
+
+void MidiMessageCollector::handleIncomingMidiBatch (MidiInput* source, const MidiBuffer& messages, double batchTime)
+{
+    // you need to call reset() to set the correct sample rate before using this object
+    jassert (sampleRate != 44100.0001);
+
+    if (SourceQueue* const queue = findQueueFor (source))
+    {
+        numDroppedMessages += queue->pushBatch (messages, batchTime);
+    }
+    else
+    {
+        const SpinLock::ScopedLockType sl (sharedQueueLock);
+        numDroppedMessages += queues.getUnchecked(0)->pushBatch (messages, batchTime);
+    }
 }
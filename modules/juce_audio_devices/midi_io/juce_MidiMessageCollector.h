@@ -37,6 +37,19 @@
     The class can also be used as either a MidiKeyboardStateListener or a MidiInputCallback
     so it can easily use a midi input or keyboard component as its source.
 
+    The audio thread never has to wait for a lock while collecting the messages. When
+    it's used as a MidiInputCallback or MidiKeyboardStateListener, each source that calls
+    it gets its own lock-free FIFO (up to a limit of maxSources), so any number of MIDI
+    inputs can be flooding it with messages without holding each other up, or the audio
+    thread. Messages that are added with addMessageToQueue() share a FIFO, so their
+    senders take turns with a spin-lock, but that still doesn't involve the audio thread.
+
+    Each message is placed in the audio block by its timestamp, so that the spacing of
+    the messages is kept, and they all arrive a constant time (of about one block)
+    after they were stamped. To do this, the collector keeps a smoothed model of when
+    each audio block is due, which is driven by the calls to removeNextBlockOfMessages(),
+    so any jitter in the timing of those calls doesn't get passed on to the messages.
+
     @see MidiMessage, MidiInput
 */
 class JUCE_API  MidiMessageCollector    : public MidiKeyboardStateListener,
@@ -54,7 +67,9 @@ public:
     /** Clears any messages from the queue.
 
         You need to call this method before starting to use the collector, so that
-        it knows the correct sample rate to use.
+        it knows the correct sample rate to use. It mustn't be called at the same time
+        as removeNextBlockOfMessages(), so the best place for it is somewhere like
+        your audio callback's audioDeviceAboutToStart() method.
     */
     void reset (double sampleRate);
 
@@ -64,26 +79,35 @@ public:
         of the block returned by the next call to removeNextBlockOfMessages().
 
         This method is fully thread-safe when overlapping calls are made with
-        removeNextBlockOfMessages().
+        removeNextBlockOfMessages(), or with other calls to addMessageToQueue().
     */
     void addMessageToQueue (const MidiMessage& message);
 
     /** Removes all the pending messages from the queue as a buffer.
 
         This will also correct the messages' timestamps to make sure they're in
-        the range 0 to numSamples - 1.
+        the range 0 to numSamples - 1. Any messages which are due after the end of
+        this block are left in the queue for the next one.
 
         This call should be made regularly by something like an audio processing
         callback, because the time that it happens is used in calculating the
         midi event positions.
 
         This method is fully thread-safe when overlapping calls are made with
-        addMessageToQueue().
+        addMessageToQueue(), and it doesn't ever block.
 
         Precondition: numSamples must be greater than 0.
     */
     void removeNextBlockOfMessages (MidiBuffer& destBuffer, int numSamples);
 
+    /** Returns the number of messages that have been thrown away because their
+        FIFO was full, since the collector was created.
+    */
+    int getNumDroppedMessages() const noexcept                  { return numDroppedMessages.get(); }
+
+    /** The number of sources that can have a FIFO to themselves. */
+    enum { maxSources = 8 };
+
 
     //==============================================================================
     /** @internal */
@@ -92,13 +116,23 @@ public:
     void handleNoteOff (MidiKeyboardState* source, int midiChannel, int midiNoteNumber);
     /** @internal */
     void handleIncomingMidiMessage (MidiInput* source, const MidiMessage& message);
+    /** @internal */
+    void handleIncomingMidiBatch (MidiInput* source, const MidiBuffer& messages, double batchTime);
 
 private:
     //==============================================================================
-    double lastCallbackTime;
-    CriticalSection midiCallbackLock;
-    MidiBuffer incomingMessages;
-    double sampleRate;
+    class SourceQueue;
+    OwnedArray<SourceQueue> queues;     // (queue 0 is shared by all the senders without one of their own)
+    SpinLock sharedQueueLock;
+    HeapBlock<uint8> messageData;
+    Atomic<int> numDroppedMessages;
+
+    double sampleRate, blockStartTime, secondsPerSample, callbackJitter;
+    int lastBlockSize, maxBlockSize;
+
+    void addMessageFromSource (const MidiMessage& message, void* source);
+    SourceQueue* findQueueFor (void* source) noexcept;
+    void updateBlockTime (double now, int numSamples) noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiMessageCollector)
 };
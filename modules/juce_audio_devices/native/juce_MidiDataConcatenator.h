@@ -30,6 +30,12 @@
 /**
     Helper class that takes chunks of incoming midi bytes, packages them into
     messages, and dispatches them to a midi callback.
+
+    The messages can either be sent one at a time with pushMidiData(), or collected
+    into batches with addToBatch(), and then sent with flushBatch(). Batches are sent
+    to the callback's handleIncomingMidiBatch() method, and because the events are
+    stored in a MidiBuffer that's kept for re-use, a batch doesn't need any memory
+    allocating for it, even if it contains sysex messages.
 */
 class MidiDataConcatenator
 {
@@ -37,8 +43,9 @@ public:
     //==============================================================================
     MidiDataConcatenator (const int initialBufferSize)
         : pendingData ((size_t) initialBufferSize),
-          pendingDataTime (0), pendingBytes (0), runningStatus (0)
+          pendingDataTime (0), batchTime (0), pendingBytes (0), runningStatus (0)
     {
+        batch.ensureSize ((size_t) initialBufferSize);
     }
 
     void reset()
@@ -46,11 +53,106 @@ public:
         pendingBytes = 0;
         runningStatus = 0;
         pendingDataTime = 0;
+        batch.clear();
     }
 
     template <typename UserDataType, typename CallbackType>
     void pushMidiData (const void* inputData, int numBytes, double time,
                        UserDataType* input, CallbackType& callback)
+    {
+        DirectSink<UserDataType, CallbackType> sink (callback);
+        parse (inputData, numBytes, time, input, sink);
+    }
+
+    /** Parses some data and adds the messages to the current batch.
+        Call flushBatch() afterwards to send them on.
+    */
+    template <typename UserDataType, typename CallbackType>
+    void addToBatch (const void* inputData, int numBytes, double time,
+                     UserDataType* input, CallbackType& callback)
+    {
+        // (if there's a sysex in progress, it'll be the first thing to be finished)
+        if (batch.isEmpty())
+            batchTime = pendingBytes > 0 ? pendingDataTime : time;
+
+        BatchSink<UserDataType, CallbackType> sink (*this, callback);
+        parse (inputData, numBytes, time, input, sink);
+    }
+
+    /** Sends any messages that have been collected by addToBatch(). */
+    template <typename UserDataType, typename CallbackType>
+    void flushBatch (UserDataType* input, CallbackType& callback)
+    {
+        if (! batch.isEmpty())
+        {
+            callback.handleIncomingMidiBatch (input, batch, batchTime);
+            batch.clear();
+        }
+    }
+
+private:
+    //==============================================================================
+    template <typename UserDataType, typename CallbackType>
+    struct DirectSink
+    {
+        DirectSink (CallbackType& callback_) noexcept : callback (callback_) {}
+
+        void add (UserDataType* input, const MidiMessage& m)
+        {
+            callback.handleIncomingMidiMessage (input, m);
+        }
+
+        void addSysex (UserDataType* input, const uint8* data, int size, double time)
+        {
+            callback.handleIncomingMidiMessage (input, MidiMessage (data, size, time));
+        }
+
+        void addPartialSysex (UserDataType* input, const uint8* data, int size, double time)
+        {
+            callback.handlePartialSysexMessage (input, data, size, time);
+        }
+
+        CallbackType& callback;
+    };
+
+    template <typename UserDataType, typename CallbackType>
+    struct BatchSink
+    {
+        BatchSink (MidiDataConcatenator& owner_, CallbackType& callback_) noexcept
+            : owner (owner_), callback (callback_)
+        {
+        }
+
+        void add (UserDataType*, const MidiMessage& m)
+        {
+            owner.batch.addEvent (m, owner.getBatchPosition (m.getTimeStamp()));
+        }
+
+        void addSysex (UserDataType*, const uint8* data, int size, double time)
+        {
+            owner.batch.addEvent (data, size, owner.getBatchPosition (time));
+        }
+
+        void addPartialSysex (UserDataType* input, const uint8* data, int size, double time)
+        {
+            // (anything that arrived before this has to be sent first, to keep them in order)
+            owner.flushBatch (input, callback);
+            callback.handlePartialSysexMessage (input, data, size, time);
+        }
+
+        MidiDataConcatenator& owner;
+        CallbackType& callback;
+    };
+
+    int getBatchPosition (const double time) const noexcept
+    {
+        // a batch's events are positioned in microseconds after the batch's time
+        return jmax (0, roundToInt ((time - batchTime) * 1.0e6));
+    }
+
+    template <typename UserDataType, typename SinkType>
+    void parse (const void* inputData, int numBytes, double time,
+                UserDataType* input, SinkType& sink)
     {
         const uint8* d = static_cast <const uint8*> (inputData);
 
@@ -58,7 +160,7 @@ public:
         {
             if (pendingBytes > 0 || d[0] == 0xf0)
             {
-                processSysex (d, numBytes, time, input, callback);
+                processSysex (d, numBytes, time, input, sink);
                 runningStatus = 0;
             }
             else
@@ -73,7 +175,7 @@ public:
                     if (*d >= 0xf8 && *d <= 0xfe)
                     {
                         const MidiMessage m (*d++, time);
-                        callback.handleIncomingMidiMessage (input, m);
+                        sink.add (input, m);
                         --numBytes;
                     }
                     else
@@ -98,17 +200,16 @@ public:
                         break; // malformed message..
 
                     jassert (used == len);
-                    callback.handleIncomingMidiMessage (input, m);
+                    sink.add (input, m);
                     runningStatus = data[0];
                 }
             }
         }
     }
 
-private:
-    template <typename UserDataType, typename CallbackType>
+    template <typename UserDataType, typename SinkType>
     void processSysex (const uint8*& d, int& numBytes, double time,
-                       UserDataType* input, CallbackType& callback)
+                       UserDataType* input, SinkType& sink)
     {
         if (*d == 0xf0)
         {
@@ -126,7 +227,7 @@ private:
             {
                 if (*d >= 0xfa || *d == 0xf8)
                 {
-                    callback.handleIncomingMidiMessage (input, MidiMessage (*d, time));
+                    sink.add (input, MidiMessage (*d, time));
                     ++d;
                     --numBytes;
                 }
@@ -155,18 +256,19 @@ private:
         {
             if (totalMessage [pendingBytes - 1] == 0xf7)
             {
-                callback.handleIncomingMidiMessage (input, MidiMessage (totalMessage, pendingBytes, pendingDataTime));
+                sink.addSysex (input, totalMessage, pendingBytes, pendingDataTime);
                 pendingBytes = 0;
             }
             else
             {
-                callback.handlePartialSysexMessage (input, totalMessage, pendingBytes, pendingDataTime);
+                sink.addPartialSysex (input, totalMessage, pendingBytes, pendingDataTime);
             }
         }
     }
 
     MemoryBlock pendingData;
-    double pendingDataTime;
+    MidiBuffer batch;
+    double pendingDataTime, batchTime;
     int pendingBytes;
     uint8 runningStatus;
 
@@ -32,7 +32,7 @@ bool isOpenSLAvailable()
 }
 
 const unsigned short openSLRates[]       = { 8000, 16000, 32000, 44100, 48000 };
-const unsigned short openSLBufferSizes[] = { 256, 512, 768, 1024, 1280, 1600 }; // must all be multiples of the block size
+const unsigned short openSLBufferSizes[] = { 256, 512, 768, 1024, 1280, 1600 };
 
 //==============================================================================
 class OpenSLAudioIODevice  : public AudioIODevice,
@@ -45,19 +45,49 @@ public:
           callback (nullptr), sampleRate (0), deviceOpen (false),
           inputBuffer (2, 2), outputBuffer (2, 2)
     {
-        // OpenSL has piss-poor support for determining latency, so the only way I can find to
-        // get a number for this is by asking the AudioTrack/AudioRecord classes..
-        AndroidAudioIODevice javaDevice (String::empty);
-
-        // this is a total guess about how to calculate the latency, but seems to vaguely agree
-        // with the devices I've tested.. YMMV
-        inputLatency  = ((javaDevice.minBufferSizeIn  * 2) / 3);
-        outputLatency = ((javaDevice.minBufferSizeOut * 2) / 3);
-
-        const int longestLatency = jmax (inputLatency, outputLatency);
-        const int totalLatency = inputLatency + outputLatency;
-        inputLatency  = ((longestLatency * inputLatency)  / totalLatency) & ~15;
-        outputLatency = ((longestLatency * outputLatency) / totalLatency) & ~15;
+        /*  Since Android 4.2, the audio system can tell us the rate and block size that its mixer
+            runs at. A player that uses exactly that rate and queues buffers of that size can be put
+            on the mixer's low-latency "fast track" - anything else gets resampled or re-buffered
+            by the system, which can add 100ms or more of latency.
+        */
+        nativeSampleRate = getAudioOutputProperty ("android.media.property.OUTPUT_SAMPLE_RATE");
+        nativeBufferSize = getAudioOutputProperty ("android.media.property.OUTPUT_FRAMES_PER_BUFFER");
+
+        for (int i = 0; i < numElementsInArray (openSLRates); ++i)
+            sampleRates.add ((int) openSLRates[i]);
+
+        if (nativeSampleRate > 0)
+        {
+            sampleRates.addIfNotAlreadyThere (nativeSampleRate);
+            sampleRates.sort();
+        }
+
+        if (nativeBufferSize > 0)
+        {
+            for (int i = 1; nativeBufferSize * i <= 4096; ++i)
+                bufferSizes.add (nativeBufferSize * i);
+
+            inputLatency = outputLatency = 0;
+        }
+        else
+        {
+            for (int i = 0; i < numElementsInArray (openSLBufferSizes); ++i)
+                bufferSizes.add ((int) openSLBufferSizes[i]);
+
+            // OpenSL has piss-poor support for determining latency, so the only way I can find to
+            // get a number for this is by asking the AudioTrack/AudioRecord classes..
+            AndroidAudioIODevice javaDevice (String::empty);
+
+            // this is a total guess about how to calculate the latency, but seems to vaguely agree
+            // with the devices I've tested.. YMMV
+            inputLatency  = ((javaDevice.minBufferSizeIn  * 2) / 3);
+            outputLatency = ((javaDevice.minBufferSizeOut * 2) / 3);
+
+            const int longestLatency = jmax (inputLatency, outputLatency);
+            const int totalLatency = inputLatency + outputLatency;
+            inputLatency  = ((longestLatency * inputLatency)  / totalLatency) & ~15;
+            outputLatency = ((longestLatency * outputLatency) / totalLatency) & ~15;
+        }
     }
 
     ~OpenSLAudioIODevice()
@@ -82,21 +112,30 @@ public:
         return s;
     }
 
-    int getNumSampleRates()                 { return numElementsInArray (openSLRates); }
+    int getNumSampleRates()                 { return sampleRates.size(); }
 
     double getSampleRate (int index)
     {
         jassert (index >= 0 && index < getNumSampleRates());
-        return (int) openSLRates [index];
+        return sampleRates [index];
+    }
+
+    int getDefaultBufferSize()
+    {
+        // (the smallest block that leaves the callback a few milliseconds to do its work in)
+        for (int i = 0; i < bufferSizes.size(); ++i)
+            if (bufferSizes.getUnchecked (i) >= 256)
+                return bufferSizes.getUnchecked (i);
+
+        return 1024;
     }
 
-    int getDefaultBufferSize()              { return 1024; }
-    int getNumBufferSizesAvailable()        { return numElementsInArray (openSLBufferSizes); }
+    int getNumBufferSizesAvailable()        { return bufferSizes.size(); }
 
     int getBufferSizeSamples (int index)
     {
         jassert (index >= 0 && index < getNumBufferSizesAvailable());
-        return (int) openSLBufferSizes [index];
+        return bufferSizes [index];
     }
 
     String open (const BigInteger& inputChannels,
@@ -109,8 +148,15 @@ public:
         lastError = String::empty;
         sampleRate = (int) requestedSampleRate;
 
+        if (sampleRate <= 0)
+            sampleRate = nativeSampleRate > 0 ? nativeSampleRate : 44100;
+
         int preferredBufferSize = (bufferSize <= 0) ? getDefaultBufferSize() : bufferSize;
 
+        // the OpenSL buffers have to be a whole number of the mixer's blocks to get onto the fast track
+        const int blockSize = nativeBufferSize > 0 ? nativeBufferSize : preferredBufferSize;
+        preferredBufferSize = blockSize * jmax (1, (preferredBufferSize + blockSize - 1) / blockSize);
+
         activeOutputChans = outputChannels;
         activeOutputChans.setRange (2, activeOutputChans.getHighestBit(), false);
         numOutputChannels = activeOutputChans.countNumberOfSetBits();
@@ -125,10 +171,20 @@ public:
         outputBuffer.setSize (jmax (1, numOutputChannels), actualBufferSize);
         outputBuffer.clear();
 
-        recorder = engine.createRecorder (numInputChannels,  sampleRate);
-        player   = engine.createPlayer   (numOutputChannels, sampleRate);
+        // Each queue holds two callbacks' worth of audio: one being played or recorded while
+        // the other is being filled or read by our thread.
+        const int numBuffers = jmax (2, (2 * actualBufferSize) / blockSize);
 
-        startThread (8);
+        recorder = engine.createRecorder (numInputChannels,  sampleRate, blockSize, numBuffers);
+        player   = engine.createPlayer   (numOutputChannels, sampleRate, blockSize, numBuffers);
+
+        if (nativeBufferSize > 0)
+        {
+            inputLatency  = recorder != nullptr ? blockSize * numBuffers : 0;
+            outputLatency = player   != nullptr ? blockSize * numBuffers : 0;
+        }
+
+        startRealtimeThread (RealtimeOptions ((1000.0 * actualBufferSize) / sampleRate));
 
         deviceOpen = true;
         return lastError;
@@ -211,6 +267,8 @@ private:
     BigInteger activeOutputChans, activeInputChans;
     int numInputChannels, numOutputChannels;
     AudioSampleBuffer inputBuffer, outputBuffer;
+    int nativeSampleRate, nativeBufferSize;
+    Array<int> sampleRates, bufferSizes;
     struct Player;
     struct Recorder;
 
@@ -222,6 +280,12 @@ private:
         return oldCallback;
     }
 
+    static int getAudioOutputProperty (const char* const propertyName)
+    {
+        return (int) android.activity.callIntMethod (JuceAppActivity.getAudioOutputProperty,
+                                                     javaString (propertyName).get());
+    }
+
     //==================================================================================================
     struct Engine
     {
@@ -256,21 +320,21 @@ private:
             if (engineObject != nullptr)    (*engineObject)->Destroy (engineObject);
         }
 
-        Player* createPlayer (const int numChannels, const int sampleRate)
+        Player* createPlayer (const int numChannels, const int sampleRate, const int blockSize, const int numBuffers)
         {
             if (numChannels <= 0)
                 return nullptr;
 
-            ScopedPointer<Player> player (new Player (numChannels, sampleRate, *this));
+            ScopedPointer<Player> player (new Player (numChannels, sampleRate, blockSize, numBuffers, *this));
             return player->openedOk() ? player.release() : nullptr;
         }
 
-        Recorder* createRecorder (const int numChannels, const int sampleRate)
+        Recorder* createRecorder (const int numChannels, const int sampleRate, const int blockSize, const int numBuffers)
         {
             if (numChannels <= 0)
                 return nullptr;
 
-            ScopedPointer<Recorder> recorder (new Recorder (numChannels, sampleRate, *this));
+            ScopedPointer<Recorder> recorder (new Recorder (numChannels, sampleRate, blockSize, numBuffers, *this));
             return recorder->openedOk() ? recorder.release() : nullptr;
         }
 
@@ -291,8 +355,9 @@ private:
     //==================================================================================================
     struct BufferList
     {
-        BufferList (const int numChannels_)
-            : numChannels (numChannels_), bufferSpace (numChannels_ * numSamples * numBuffers), nextBlock (0)
+        BufferList (const int numChannels_, const int numSamples_, const int numBuffers_)
+            : numChannels (numChannels_), numSamples (numSamples_), numBuffers (numBuffers_),
+              bufferSpace ((size_t) (numChannels_ * numSamples_ * numBuffers_)), nextBlock (0)
         {
         }
 
@@ -322,8 +387,7 @@ private:
 
         int getBufferSizeBytes() const  { return numChannels * numSamples * sizeof (int16); }
 
-        const int numChannels;
-        enum { numSamples = 256, numBuffers = 16 };
+        const int numChannels, numSamples, numBuffers;
 
     private:
         HeapBlock<int16> bufferSpace;
@@ -335,9 +399,9 @@ private:
     //==================================================================================================
     struct Player
     {
-        Player (int numChannels, int sampleRate, Engine& engine)
+        Player (int numChannels, int sampleRate, int blockSize, int numBuffers, Engine& engine)
             : playerObject (nullptr), playerPlay (nullptr), playerBufferQueue (nullptr),
-              bufferList (numChannels)
+              bufferList (numChannels, blockSize, numBuffers)
         {
             jassert (numChannels == 2);
 
@@ -352,7 +416,7 @@ private:
                 SL_BYTEORDER_LITTLEENDIAN
             };
 
-            SLDataLocator_AndroidSimpleBufferQueue bufferQueue = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, bufferList.numBuffers };
+            SLDataLocator_AndroidSimpleBufferQueue bufferQueue = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, (SLuint32) bufferList.numBuffers };
             SLDataSource audioSrc = { &bufferQueue, &pcmFormat };
 
             SLDataLocator_OutputMix outputMix = { SL_DATALOCATOR_OUTPUTMIX, engine.outputMixObject };
@@ -394,7 +458,7 @@ private:
         void writeBuffer (const AudioSampleBuffer& buffer, Thread& thread)
         {
             jassert (buffer.getNumChannels() == bufferList.numChannels);
-            jassert (buffer.getNumSamples() < bufferList.numSamples * bufferList.numBuffers);
+            jassert ((buffer.getNumSamples() % bufferList.numSamples) == 0);
 
             int offset = 0;
             int numSamples = buffer.getNumSamples();
@@ -412,7 +476,7 @@ private:
                     typedef AudioData::Pointer <AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const> SrcSampleType;
 
                     DstSampleType dstData (destBuffer + i, bufferList.numChannels);
-                    SrcSampleType srcData (buffer.getSampleData (i, offset));
+                    SrcSampleType srcData (buffer.getReadPointer (i, offset));
                     dstData.convertSamples (srcData, bufferList.numSamples);
                 }
 
@@ -443,9 +507,9 @@ private:
     //==================================================================================================
     struct Recorder
     {
-        Recorder (int numChannels, int sampleRate, Engine& engine)
+        Recorder (int numChannels, int sampleRate, int blockSize, int numBuffers, Engine& engine)
             : recorderObject (nullptr), recorderRecord (nullptr), recorderBufferQueue (nullptr),
-              bufferList (numChannels)
+              bufferList (numChannels, blockSize, numBuffers)
         {
             jassert (numChannels == 1); // STEREO doesn't always work!!
 
@@ -463,7 +527,7 @@ private:
             SLDataLocator_IODevice ioDevice = { SL_DATALOCATOR_IODEVICE, SL_IODEVICE_AUDIOINPUT, SL_DEFAULTDEVICEID_AUDIOINPUT, nullptr };
             SLDataSource audioSrc = { &ioDevice, nullptr };
 
-            SLDataLocator_AndroidSimpleBufferQueue bufferQueue = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, bufferList.numBuffers };
+            SLDataLocator_AndroidSimpleBufferQueue bufferQueue = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, (SLuint32) bufferList.numBuffers };
             SLDataSink audioSink = { &bufferQueue, &pcmFormat };
 
             const SLInterfaceID interfaceIDs[] = { *engine.SL_IID_ANDROIDSIMPLEBUFFERQUEUE };
@@ -512,7 +576,6 @@ private:
         void readNextBlock (AudioSampleBuffer& buffer, Thread& thread)
         {
             jassert (buffer.getNumChannels() == bufferList.numChannels);
-            jassert (buffer.getNumSamples() < bufferList.numSamples * bufferList.numBuffers);
             jassert ((buffer.getNumSamples() % bufferList.numSamples) == 0);
 
             int offset = 0;
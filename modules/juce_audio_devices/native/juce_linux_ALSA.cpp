@@ -48,6 +48,29 @@ namespace
 
 #define JUCE_ALSA_FAILED(x)  failed (x)
 
+/*  When enabled, devices that support it are driven through snd_pcm_mmap_begin/commit,
+    converting samples directly between the hardware ring buffer and the float buffers
+    instead of going through snd_pcm_readi/writei and an intermediate scratch buffer.
+    Devices that can't be mmapped fall back to the read/write calls automatically.
+*/
+#ifndef JUCE_ALSA_USE_MMAP
+ #define JUCE_ALSA_USE_MMAP 1
+#endif
+
+/*  If this is greater than 0, the audio thread will switch itself to SCHED_FIFO at
+    this priority (1 to 99) when it starts. This needs the process to have the right
+    privileges (e.g. an rtprio entry in limits.conf) - if the call fails, the thread
+    just keeps its normal priority.
+*/
+#ifndef JUCE_ALSA_REALTIME_PRIORITY
+ #define JUCE_ALSA_REALTIME_PRIORITY 0
+#endif
+
+/*  If this is non-zero, it's used as the cpu affinity mask for the audio thread. */
+#ifndef JUCE_ALSA_CPU_AFFINITY_MASK
+ #define JUCE_ALSA_CPU_AFFINITY_MASK 0
+#endif
+
 void getDeviceSampleRates (snd_pcm_t* handle, Array <int>& rates)
 {
     const int ratesToTry[] = { 22050, 32000, 44100, 48000, 88200, 96000, 176400, 192000, 0 };
@@ -141,14 +164,16 @@ static void silentErrorHandler (const char*, int, const char*, int, const char*,
 class ALSADevice
 {
 public:
-    ALSADevice (const String& devID, bool forInput)
+    ALSADevice (const String& devID, bool forInput, Atomic<int>& xrunCounter)
         : handle (0),
           bitDepth (16),
           numChannelsRunning (0),
           latency (0),
           deviceID (devID),
           isInput (forInput),
-          isInterleaved (true)
+          isInterleaved (true),
+          isMMap (false),
+          numXRuns (xrunCounter)
     {
         JUCE_ALSA_LOG ("snd_pcm_open (" << deviceID.toUTF8().getAddress() << ", forInput=" << forInput << ")");
 
@@ -202,6 +227,21 @@ public:
             return false;
         }
 
+        isMMap = false;
+
+       #if JUCE_ALSA_USE_MMAP
+        if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_MMAP_INTERLEAVED) >= 0)
+        {
+            isInterleaved = true;
+            isMMap = true;
+        }
+        else if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_MMAP_NONINTERLEAVED) >= 0)
+        {
+            isInterleaved = false;
+            isMMap = true;
+        }
+        else
+       #endif
         if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_RW_INTERLEAVED) >= 0) // works better for plughw..
             isInterleaved = true;
         else if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_RW_NONINTERLEAVED) >= 0)
@@ -212,6 +252,10 @@ public:
             return false;
         }
 
+        // in mmap mode each channel is addressed separately, so a non-interleaved
+        // area is just a single-channel stream
+        const int numChannelsPerFrame = (isMMap && ! isInterleaved) ? 1 : numChannels;
+
         enum { isFloatBit = 1 << 16, isLittleEndianBit = 1 << 17 };
 
         const int formatsToTry[] = { SND_PCM_FORMAT_FLOAT_LE,   32 | isFloatBit | isLittleEndianBit,
@@ -231,11 +275,11 @@ public:
                 bitDepth = formatsToTry [i + 1] & 255;
                 const bool isFloat = (formatsToTry [i + 1] & isFloatBit) != 0;
                 const bool isLittleEndian = (formatsToTry [i + 1] & isLittleEndianBit) != 0;
-                converter = createConverter (isInput, bitDepth, isFloat, isLittleEndian, numChannels);
+                converter = createConverter (isInput, bitDepth, isFloat, isLittleEndian, numChannelsPerFrame);
 
                 JUCE_ALSA_LOG ("format: bitDepth=" << bitDepth << ", isFloat="
                                 << isFloat << ", isLittleEndian=" << isLittleEndian
-                                << ", numChannels=" << numChannels);
+                                << ", numChannels=" << numChannels << ", mmap=" << (int) isMMap);
                 break;
             }
         }
@@ -303,6 +347,10 @@ public:
     bool writeToOutputDevice (AudioSampleBuffer& outputChannelBuffer, const int numSamples)
     {
         jassert (numChannelsRunning <= outputChannelBuffer.getNumChannels());
+
+        if (isMMap)
+            return transferMMap (outputChannelBuffer, numSamples);
+
         float** const data = outputChannelBuffer.getArrayOfChannels();
         snd_pcm_sframes_t numDone = 0;
 
@@ -323,7 +371,7 @@ public:
             numDone = snd_pcm_writen (handle, (void**) data, numSamples);
         }
 
-        if (numDone < 0 && JUCE_ALSA_FAILED (snd_pcm_recover (handle, numDone, 1 /* silent */)))
+        if (numDone < 0 && ! recoverFromError ((int) numDone))
             return false;
 
         if (numDone < numSamples)
@@ -335,6 +383,10 @@ public:
     bool readFromInputDevice (AudioSampleBuffer& inputChannelBuffer, const int numSamples)
     {
         jassert (numChannelsRunning <= inputChannelBuffer.getNumChannels());
+
+        if (isMMap)
+            return transferMMap (inputChannelBuffer, numSamples);
+
         float** const data = inputChannelBuffer.getArrayOfChannels();
 
         if (isInterleaved)
@@ -344,7 +396,7 @@ public:
 
             snd_pcm_sframes_t num = snd_pcm_readi (handle, scratch.getData(), numSamples);
 
-            if (num < 0 && JUCE_ALSA_FAILED (snd_pcm_recover (handle, num, 1 /* silent */)))
+            if (num < 0 && ! recoverFromError ((int) num))
                 return false;
 
             if (num < numSamples)
@@ -357,7 +409,7 @@ public:
         {
             snd_pcm_sframes_t num = snd_pcm_readn (handle, (void**) data, numSamples);
 
-            if (num < 0 && JUCE_ALSA_FAILED (snd_pcm_recover (handle, num, 1 /* silent */)))
+            if (num < 0 && ! recoverFromError ((int) num))
                 return false;
 
             if (num < numSamples)
@@ -370,6 +422,8 @@ public:
         return true;
     }
 
+    bool isUsingMMap() const noexcept       { return isMMap; }
+
     //==============================================================================
     snd_pcm_t* handle;
     String error;
@@ -379,10 +433,125 @@ private:
     //==============================================================================
     String deviceID;
     const bool isInput;
-    bool isInterleaved;
+    bool isInterleaved, isMMap;
+    Atomic<int>& numXRuns;
     MemoryBlock scratch;
     ScopedPointer<AudioData::Converter> converter;
 
+    //==============================================================================
+    static char* getAreaAddress (const snd_pcm_channel_area_t& area, const snd_pcm_uframes_t frame) noexcept
+    {
+        return static_cast <char*> (area.addr) + ((area.first + frame * area.step) >> 3);
+    }
+
+    bool recoverFromError (const int errorNum)
+    {
+        if (errorNum == -EPIPE)
+            ++numXRuns;
+
+        if (JUCE_ALSA_FAILED (snd_pcm_recover (handle, errorNum, 1 /* silent */)))
+            return false;
+
+        JUCE_ALSA_LOG ("recovered from " << (isInput ? "overrun" : "underrun"));
+        return true;
+    }
+
+    bool transferMMap (AudioSampleBuffer& buffer, const int numSamples)
+    {
+        float** const data = buffer.getArrayOfChannels();
+        int numDone = 0;
+
+        while (numDone < numSamples)
+        {
+            const snd_pcm_sframes_t avail = snd_pcm_avail_update (handle);
+
+            if (avail < 0)
+            {
+                if (! recoverFromError ((int) avail))
+                    return false;
+
+                continue;
+            }
+
+            // a capture stream (or a playback stream whose ring is already full) won't move
+            // until it's explicitly started
+            if (snd_pcm_state (handle) == SND_PCM_STATE_PREPARED && (isInput || avail == 0))
+            {
+                if (JUCE_ALSA_FAILED (snd_pcm_start (handle)))
+                    return false;
+
+                continue;
+            }
+
+            if (avail < numSamples - numDone)
+            {
+                const int err = snd_pcm_wait (handle, 1000);
+
+                if (err < 0)
+                {
+                    if (! recoverFromError (err))
+                        return false;
+
+                    continue;
+                }
+
+                if (err == 0)
+                {
+                    // the device has stalled - drop this block rather than blocking the thread
+                    JUCE_ALSA_LOG ("mmap transfer timed out");
+                    return true;
+                }
+
+                if (avail == 0)
+                    continue;
+            }
+
+            const snd_pcm_channel_area_t* areas = nullptr;
+            snd_pcm_uframes_t offset = 0;
+            snd_pcm_uframes_t frames = (snd_pcm_uframes_t) (numSamples - numDone);
+
+            int err = snd_pcm_mmap_begin (handle, &areas, &offset, &frames);
+
+            if (err < 0)
+            {
+                if (! recoverFromError (err))
+                    return false;
+
+                continue;
+            }
+
+            if (frames == 0)
+                continue;
+
+            for (int i = 0; i < numChannelsRunning; ++i)
+            {
+                if (isInput)
+                    converter->convertSamples (data[i] + numDone, 0, getAreaAddress (areas[i], offset), 0, (int) frames);
+                else
+                    converter->convertSamples (getAreaAddress (areas[i], offset), 0, data[i] + numDone, 0, (int) frames);
+            }
+
+            const snd_pcm_sframes_t numCommitted = snd_pcm_mmap_commit (handle, offset, frames);
+
+            if (numCommitted < 0 || (snd_pcm_uframes_t) numCommitted != frames)
+            {
+                if (! recoverFromError (numCommitted < 0 ? (int) numCommitted : -EPIPE))
+                    return false;
+
+                continue;
+            }
+
+            numDone += (int) frames;
+        }
+
+        // unlike snd_pcm_writei, committing mmapped frames doesn't trigger the start threshold
+        if ((! isInput) && snd_pcm_state (handle) == SND_PCM_STATE_PREPARED
+             && JUCE_ALSA_FAILED (snd_pcm_start (handle)))
+            return false;
+
+        return true;
+    }
+
     //==============================================================================
     template <class SampleType>
     struct ConverterHelper
@@ -475,6 +644,7 @@ public:
         error = String::empty;
         sampleRate = sampleRate_;
         bufferSize = bufferSize_;
+        numXRuns = 0;
 
         inputChannelBuffer.setSize (jmax ((int) minChansIn, inputChannels.getHighestBit()) + 1, bufferSize);
         inputChannelBuffer.clear();
@@ -512,7 +682,7 @@ public:
 
         if (outputChannelDataForCallback.size() > 0 && outputId.isNotEmpty())
         {
-            outputDevice = new ALSADevice (outputId, false);
+            outputDevice = new ALSADevice (outputId, false, numXRuns);
 
             if (outputDevice->error.isNotEmpty())
             {
@@ -537,7 +707,7 @@ public:
 
         if (inputChannelDataForCallback.size() > 0 && inputId.isNotEmpty())
         {
-            inputDevice = new ALSADevice (inputId, true);
+            inputDevice = new ALSADevice (inputId, true, numXRuns);
 
             if (inputDevice->error.isNotEmpty())
             {
@@ -575,6 +745,10 @@ public:
         if (outputDevice != nullptr && JUCE_ALSA_FAILED (snd_pcm_prepare (outputDevice->handle)))
             return;
 
+       #if JUCE_ALSA_CPU_AFFINITY_MASK
+        setAffinityMask ((uint32) JUCE_ALSA_CPU_AFFINITY_MASK);
+       #endif
+
         startThread (9);
 
         int count = 1000;
@@ -631,6 +805,16 @@ public:
 
     void run()
     {
+       #if JUCE_ALSA_REALTIME_PRIORITY > 0
+        struct sched_param param;
+        param.sched_priority = jlimit (sched_get_priority_min (SCHED_FIFO),
+                                       sched_get_priority_max (SCHED_FIFO),
+                                       (int) JUCE_ALSA_REALTIME_PRIORITY);
+
+        if (pthread_setschedparam (pthread_self(), SCHED_FIFO, &param) != 0)
+            JUCE_ALSA_LOG ("couldn't switch the audio thread to SCHED_FIFO");
+       #endif
+
         while (! threadShouldExit())
         {
             if (inputDevice != nullptr && inputDevice->handle)
@@ -678,7 +862,12 @@ public:
                 snd_pcm_sframes_t avail = snd_pcm_avail_update (outputDevice->handle);
 
                 if (avail < 0)
+                {
+                    if (avail == -EPIPE)
+                        ++numXRuns;
+
                     JUCE_ALSA_FAILED (snd_pcm_recover (outputDevice->handle, avail, 0));
+                }
 
                 audioIoInProgress = true;
 
@@ -694,6 +883,8 @@ public:
         audioIoInProgress = false;
     }
 
+    int getXRunCount() const noexcept       { return numXRuns.get(); }
+
     int getBitDepth() const noexcept
     {
         if (outputDevice != nullptr)
@@ -721,6 +912,7 @@ private:
     ScopedPointer<ALSADevice> outputDevice, inputDevice;
     int numCallbacks;
     bool audioIoInProgress;
+    Atomic<int> numXRuns;
 
     CriticalSection callbackLock;
 
@@ -857,6 +1049,7 @@ public:
 
     int getOutputLatencyInSamples()         { return internal.outputLatency; }
     int getInputLatencyInSamples()          { return internal.inputLatency; }
+    int getXRunCount() const noexcept       { return internal.getXRunCount(); }
 
     void start (AudioIODeviceCallback* callback)
     {
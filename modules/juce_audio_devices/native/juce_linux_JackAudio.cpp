@@ -66,10 +66,30 @@ JUCE_DECL_JACK_FUNCTION (int, jack_set_process_callback, (jack_client_t* client,
 JUCE_DECL_JACK_FUNCTION (const char**, jack_get_ports, (jack_client_t* client, const char* port_name_pattern, const char* type_name_pattern, unsigned long flags), (client, port_name_pattern, type_name_pattern, flags));
 JUCE_DECL_JACK_FUNCTION (int, jack_connect, (jack_client_t* client, const char* source_port, const char* destination_port), (client, source_port, destination_port));
 JUCE_DECL_JACK_FUNCTION (const char*, jack_port_name, (const jack_port_t* port), (port));
+JUCE_DECL_JACK_FUNCTION (int, jack_set_xrun_callback, (jack_client_t* client, JackXRunCallback xrun_callback, void* arg), (client, xrun_callback, arg));
 JUCE_DECL_JACK_FUNCTION (void*, jack_set_port_connect_callback, (jack_client_t* client, JackPortConnectCallback connect_callback, void* arg), (client, connect_callback, arg));
 JUCE_DECL_JACK_FUNCTION (jack_port_t* , jack_port_by_id, (jack_client_t* client, jack_port_id_t port_id), (client, port_id));
 JUCE_DECL_JACK_FUNCTION (int, jack_port_connected, (const jack_port_t* port), (port));
 JUCE_DECL_JACK_FUNCTION (int, jack_port_connected_to, (const jack_port_t* port, const char* port_name), (port, port_name));
+JUCE_DECL_JACK_FUNCTION (jack_transport_state_t, jack_transport_query, (const jack_client_t* client, jack_position_t* pos), (client, pos));
+JUCE_DECL_VOID_JACK_FUNCTION (jack_transport_start, (jack_client_t* client), (client));
+JUCE_DECL_VOID_JACK_FUNCTION (jack_transport_stop, (jack_client_t* client), (client));
+JUCE_DECL_JACK_FUNCTION (int, jack_transport_locate, (jack_client_t* client, jack_nframes_t frame), (client, frame));
+
+// jack_port_get_latency_range() replaced jack_port_get_total_latency() in JACK 0.120,
+// so older servers may not have it - this returns false if it's missing.
+static bool juce_getJackLatencyRange (jack_port_t* const port, const jack_latency_callback_mode_t mode,
+                                      jack_latency_range_t& range)
+{
+    typedef void (*fn_type) (jack_port_t*, jack_latency_callback_mode_t, jack_latency_range_t*);
+    static fn_type fn = (fn_type) juce_loadJackFunction ("jack_port_get_latency_range");
+
+    if (fn == nullptr)
+        return false;
+
+    (*fn) (port, mode, &range);
+    return true;
+}
 
 #if JUCE_DEBUG
  #define JACK_LOGGING_ENABLED 1
@@ -241,7 +261,9 @@ public:
 
         juce::jack_set_process_callback (client, processCallback, this);
         juce::jack_set_port_connect_callback (client, portConnectCallback, this);
+        juce::jack_set_xrun_callback (client, xrunCallback, this);
         juce::jack_on_shutdown (client, shutdownCallback, this);
+        numXRuns = 0;
         juce::jack_activate (client);
         deviceIsOpen = true;
 
@@ -283,6 +305,7 @@ public:
             juce::jack_deactivate (client);
             juce::jack_set_process_callback (client, processCallback, nullptr);
             juce::jack_set_port_connect_callback (client, portConnectCallback, nullptr);
+            juce::jack_set_xrun_callback (client, xrunCallback, nullptr);
             juce::jack_on_shutdown (client, shutdownCallback, nullptr);
         }
 
@@ -323,51 +346,96 @@ public:
     BigInteger getActiveOutputChannels() const { return activeOutputChannels; }
     BigInteger getActiveInputChannels()  const { return activeInputChannels;  }
 
-    int getOutputLatencyInSamples()
+    int getOutputLatencyInSamples()         { return getLatency (outputPorts, JackPlaybackLatency); }
+    int getInputLatencyInSamples()          { return getLatency (inputPorts, JackCaptureLatency); }
+
+    int getXRunCount() const noexcept       { return numXRuns.get(); }
+
+    bool getTransportPosition (TransportPosition& result)
     {
-        int latency = 0;
+        if (client == nullptr)
+            return false;
 
-        for (int i = 0; i < outputPorts.size(); i++)
-            latency = jmax (latency, (int) juce::jack_port_get_total_latency (client, (jack_port_t*) outputPorts [i]));
+        jack_position_t pos;
+        zerostruct (pos);
+        const jack_transport_state_t state = juce::jack_transport_query (client, &pos);
 
-        return latency;
+        result.timeInSamples = (int64) pos.frame;
+        result.isPlaying = (state == JackTransportRolling || state == JackTransportLooping);
+        result.hasMusicalPosition = (pos.valid & JackPositionBBT) != 0;
+
+        if (result.hasMusicalPosition)
+        {
+            result.bar  = (int) pos.bar;
+            result.beat = (int) pos.beat;
+            result.tick = (int) pos.tick;
+            result.ticksPerBeat = pos.ticks_per_beat;
+            result.beatsPerBar  = pos.beats_per_bar;
+            result.beatType     = pos.beat_type;
+            result.bpm          = pos.beats_per_minute;
+        }
+
+        return true;
     }
 
-    int getInputLatencyInSamples()
+    bool setTransportPlaying (const bool shouldPlay)
     {
-        int latency = 0;
+        if (client == nullptr)
+            return false;
+
+        if (shouldPlay)
+            juce::jack_transport_start (client);
+        else
+            juce::jack_transport_stop (client);
 
-        for (int i = 0; i < inputPorts.size(); i++)
-            latency = jmax (latency, (int) juce::jack_port_get_total_latency (client, (jack_port_t*) inputPorts [i]));
+        return true;
+    }
 
-        return latency;
+    bool setTransportPosition (const int64 newTimeInSamples)
+    {
+        return client != nullptr
+                && juce::jack_transport_locate (client, (jack_nframes_t) jmax ((int64) 0, newTimeInSamples)) == 0;
     }
 
     String inputId, outputId;
 
 private:
-    void process (const int numSamples)
+    int getLatency (const Array<void*>& ports, const jack_latency_callback_mode_t mode) const
     {
-        int numActiveInChans = 0, numActiveOutChans = 0;
+        int latency = 0;
 
-        for (int i = 0; i < totalNumberOfInputChannels; ++i)
+        for (int i = 0; i < ports.size(); ++i)
         {
-            if (activeInputChannels[i])
-                if (jack_default_audio_sample_t* in
-                        = (jack_default_audio_sample_t*) juce::jack_port_get_buffer ((jack_port_t*) inputPorts.getUnchecked(i), numSamples))
-                    inChans [numActiveInChans++] = (float*) in;
-        }
+            jack_port_t* const port = (jack_port_t*) ports.getUnchecked (i);
+            jack_latency_range_t range;
 
-        for (int i = 0; i < totalNumberOfOutputChannels; ++i)
-        {
-            if (activeOutputChannels[i])
-                if (jack_default_audio_sample_t* out
-                        = (jack_default_audio_sample_t*) juce::jack_port_get_buffer ((jack_port_t*) outputPorts.getUnchecked(i), numSamples))
-                    outChans [numActiveOutChans++] = (float*) out;
+            if (juce_getJackLatencyRange (port, mode, range))
+                latency = jmax (latency, (int) range.max);
+            else
+                latency = jmax (latency, (int) juce::jack_port_get_total_latency (client, port));
         }
 
+        return latency;
+    }
+
+    void process (const int numSamples)
+    {
         const ScopedLock sl (callbackLock);
 
+        // JACK's port buffers are already non-interleaved floats, so they get handed
+        // straight to the callback without any copying.
+        int numActiveInChans = 0, numActiveOutChans = 0;
+
+        for (int i = 0; i < activeInputPorts.size(); ++i)
+            if (jack_default_audio_sample_t* in
+                    = (jack_default_audio_sample_t*) juce::jack_port_get_buffer (activeInputPorts.getUnchecked(i), numSamples))
+                inChans [numActiveInChans++] = (float*) in;
+
+        for (int i = 0; i < activeOutputPorts.size(); ++i)
+            if (jack_default_audio_sample_t* out
+                    = (jack_default_audio_sample_t*) juce::jack_port_get_buffer (activeOutputPorts.getUnchecked(i), numSamples))
+                outChans [numActiveOutChans++] = (float*) out;
+
         if (callback != nullptr)
         {
             if ((numActiveInChans + numActiveOutChans) > 0)
@@ -408,8 +476,25 @@ private:
 
             stop();
 
-            activeOutputChannels = newOutputChannels;
-            activeInputChannels  = newInputChannels;
+            Array<jack_port_t*> newInputPorts, newOutputPorts;
+
+            for (int i = 0; i < inputPorts.size(); ++i)
+                if (newInputChannels[i])
+                    newInputPorts.add ((jack_port_t*) inputPorts.getUnchecked(i));
+
+            for (int i = 0; i < outputPorts.size(); ++i)
+                if (newOutputChannels[i])
+                    newOutputPorts.add ((jack_port_t*) outputPorts.getUnchecked(i));
+
+            {
+                // (the process callback keeps running while the device is stopped, so
+                // the port lists mustn't change underneath it)
+                const ScopedLock sl (callbackLock);
+                activeOutputChannels = newOutputChannels;
+                activeInputChannels  = newInputChannels;
+                activeInputPorts.swapWithArray (newInputPorts);
+                activeOutputPorts.swapWithArray (newOutputPorts);
+            }
 
             if (oldCallback != nullptr)
                 start (oldCallback);
@@ -424,6 +509,14 @@ private:
             device->updateActivePorts();
     }
 
+    static int xrunCallback (void* callbackArgument)
+    {
+        if (JackAudioIODevice* device = static_cast <JackAudioIODevice*> (callbackArgument))
+            ++(device->numXRuns);
+
+        return 0;
+    }
+
     static void threadInitCallback (void* /* callbackArgument */)
     {
         JUCE_JACK_LOG ("JackAudioIODevice::initialise");
@@ -452,12 +545,14 @@ private:
     String lastError;
     AudioIODeviceCallback* callback;
     CriticalSection callbackLock;
+    Atomic<int> numXRuns;
 
     HeapBlock <float*> inChans, outChans;
     int totalNumberOfInputChannels;
     int totalNumberOfOutputChannels;
     Array<void*> inputPorts, outputPorts;
     BigInteger activeInputChannels, activeOutputChannels;
+    Array<jack_port_t*> activeInputPorts, activeOutputPorts;
 };
 
 
@@ -104,7 +104,7 @@ public:
             inputThread->signalThreadShouldExit();
     }
 
-    void handleIncomingMidiMessage (const MidiMessage& message, int port);
+    void handleIncomingMidiBatch (const MidiBuffer& messages, double batchTime, int port);
 
     snd_seq_t* get() const noexcept     { return handle; }
 
@@ -139,6 +139,13 @@ private:
 
                 HeapBlock <uint8> buffer (maxEventSize);
 
+                // All the events that are waiting each time the poll returns are delivered
+                // together, as a batch for each port (this buffer gets re-used for each one).
+                MidiBuffer batch;
+                batch.ensureSize (4096);
+                double batchTime = 0;
+                int batchPort = -1;
+
                 while (! threadShouldExit())
                 {
                     if (poll (pfd, numPfds, 100) > 0) // there was a "500" here which is a bit long when we exit the program and have to wait for a timeout on this poll call
@@ -162,16 +169,27 @@ private:
 
                                 if (numBytes > 0)
                                 {
-                                    const MidiMessage message ((const uint8*) buffer, numBytes,
-                                                               Time::getMillisecondCounter() * 0.001);
+                                    const double time = Time::getMillisecondCounterHiRes() * 0.001;
+                                    const int port = inputEvent->dest.port;
+
+                                    if (port != batchPort)
+                                        flushBatch (batch, batchTime, batchPort);
+
+                                    if (batch.isEmpty())
+                                    {
+                                        batchTime = time;
+                                        batchPort = port;
+                                    }
 
-                                    client.handleIncomingMidiMessage (message, inputEvent->dest.port);
+                                    batch.addEvent (buffer, numBytes, roundToInt ((time - batchTime) * 1.0e6));
                                 }
 
                                 snd_seq_free_event (inputEvent);
                             }
                         }
                         while (snd_seq_event_input_pending (seqHandle, 0) > 0);
+
+                        flushBatch (batch, batchTime, batchPort);
                     }
                 }
 
@@ -181,6 +199,15 @@ private:
 
     private:
         AlsaClient& client;
+
+        void flushBatch (MidiBuffer& batch, const double batchTime, const int port)
+        {
+            if (! batch.isEmpty())
+            {
+                client.handleIncomingMidiBatch (batch, batchTime, port);
+                batch.clear();
+            }
+        }
     };
 
     ScopedPointer<MidiInputThread> inputThread;
@@ -278,9 +305,9 @@ public:
         }
     }
 
-    void handleIncomingMidiMessage (const MidiMessage& message) const
+    void handleIncomingMidiBatch (const MidiBuffer& messages, const double batchTime) const
     {
-        callback->handleIncomingMidiMessage (midiInput, message);
+        callback->handleIncomingMidiBatch (midiInput, messages, batchTime);
     }
 
 private:
@@ -292,12 +319,12 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AlsaPortAndCallback)
 };
 
-void AlsaClient::handleIncomingMidiMessage (const MidiMessage& message, int port)
+void AlsaClient::handleIncomingMidiBatch (const MidiBuffer& messages, const double batchTime, const int port)
 {
     const ScopedLock sl (callbackLock);
 
     if (AlsaPortAndCallback* const cb = activeCallbacks[port])
-        cb->handleIncomingMidiMessage (message);
+        cb->handleIncomingMidiBatch (messages, batchTime);
 }
 
 //==============================================================================
@@ -136,7 +136,7 @@ class CoreAudioInternal  : private Timer
 {
 public:
     //==============================================================================
-    CoreAudioInternal (AudioDeviceID id)
+    CoreAudioInternal (AudioDeviceID id, const bool exclusiveMode)
        : inputLatency (0),
          outputLatency (0),
          callback (nullptr),
@@ -144,6 +144,7 @@ public:
          audioProcID (0),
         #endif
          isSlaveDevice (false),
+         useHogMode (exclusiveMode),
          deviceID (id),
          started (false),
          sampleRate (0),
@@ -151,6 +152,7 @@ public:
          numInputChans (0),
          numOutputChans (0),
          callbacksAllowed (true),
+         lastSampleTime (-1.0),
          numInputChannelInfos (0),
          numOutputChannelInfos (0)
     {
@@ -176,6 +178,7 @@ public:
         AudioObjectRemovePropertyListener (deviceID, &pa, deviceListenerProc, this);
 
         stop (false);
+        releaseHogMode();
     }
 
     void allocateTempBuffers()
@@ -185,6 +188,8 @@ public:
 
         tempInputBuffers.calloc ((size_t) numInputChans + 2);
         tempOutputBuffers.calloc ((size_t) numOutputChans + 2);
+        callbackInputBuffers.calloc ((size_t) numInputChans + 2);
+        callbackOutputBuffers.calloc ((size_t) numOutputChans + 2);
 
         int i, count = 0;
         for (i = 0; i < numInputChans; ++i)
@@ -316,7 +321,20 @@ public:
 
             if (OK (AudioObjectGetPropertyData (deviceID, &pa, 0, 0, &size, ranges)))
             {
-                bufferSizes.add ((int) (ranges[0].mMinimum + 15) & ~15);
+                if (useHogMode)
+                {
+                    // offer the device's real minimum, and the small sizes in finer steps, as
+                    // that's where the lowest latencies are
+                    bufferSizes.add ((int) ranges[0].mMinimum);
+
+                    for (int i = 8; i < 128; i += 8)
+                        if (i >= ranges[0].mMinimum && i <= ranges[0].mMaximum)
+                            bufferSizes.addIfNotAlreadyThere (i);
+                }
+                else
+                {
+                    bufferSizes.add ((int) (ranges[0].mMinimum + 15) & ~15);
+                }
 
                 for (int i = 32; i < 2048; i += 32)
                 {
@@ -332,6 +350,8 @@ public:
 
                 if (bufferSize > 0)
                     bufferSizes.addIfNotAlreadyThere (bufferSize);
+
+                bufferSizes.sort();
             }
         }
 
@@ -519,6 +539,12 @@ public:
         numInputChans = activeInputChans.countNumberOfSetBits();
         numOutputChans = activeOutputChans.countNumberOfSetBits();
 
+        if (useHogMode && ! claimHogMode())
+        {
+            callbacksAllowed = true;
+            return "Couldn't get exclusive access to the device";
+        }
+
         // set sample rate
         AudioObjectPropertyAddress pa;
         pa.mSelector = kAudioDevicePropertyNominalSampleRate;
@@ -601,6 +627,8 @@ public:
         {
             const ScopedLock sl (callbackLock);
             callback = cb;
+            lastSampleTime = -1.0;
+            numXRuns = 0;
         }
 
         return started && (inputDevice == nullptr || inputDevice->start (cb));
@@ -660,10 +688,13 @@ public:
     int getBufferSize() const     { return bufferSize; }
 
     void audioCallback (const AudioBufferList* inInputData,
-                        AudioBufferList* outOutputData)
+                        AudioBufferList* outOutputData,
+                        const AudioTimeStamp* cycleTime)
     {
         const ScopedLock sl (callbackLock);
 
+        checkForDiscontinuity (cycleTime);
+
         if (callback != nullptr)
         {
             if (inputDevice == 0)
@@ -672,12 +703,22 @@ public:
                 {
                     const CallbackDetailsForChannel& info = inputChannelInfo[i];
                     float* dest = tempInputBuffers [i];
-                    const float* src = ((const float*) inInputData->mBuffers[info.streamNum].mData)
-                                        + info.dataOffsetSamples;
+                    callbackInputBuffers[i] = dest;
+
                     const int stride = info.dataStrideSamples;
 
                     if (stride != 0) // if this is zero, info is invalid
                     {
+                        const AudioBuffer& buffer = inInputData->mBuffers[info.streamNum];
+                        const float* src = ((const float*) buffer.mData) + info.dataOffsetSamples;
+
+                        // a non-interleaved stream can be handed to the callback as it is..
+                        if (canUseDeviceBuffer (buffer, stride))
+                        {
+                            callbackInputBuffers[i] = const_cast <float*> (src);
+                            continue;
+                        }
+
                         for (int j = bufferSize; --j >= 0;)
                         {
                             *dest++ = *src;
@@ -689,11 +730,25 @@ public:
 
             if (! isSlaveDevice)
             {
+                for (int i = numOutputChans; --i >= 0;)
+                {
+                    const CallbackDetailsForChannel& info = outputChannelInfo[i];
+                    callbackOutputBuffers[i] = tempOutputBuffers[i];
+
+                    if (info.dataStrideSamples != 0)
+                    {
+                        const AudioBuffer& buffer = outOutputData->mBuffers[info.streamNum];
+
+                        if (canUseDeviceBuffer (buffer, info.dataStrideSamples))
+                            callbackOutputBuffers[i] = ((float*) buffer.mData) + info.dataOffsetSamples;
+                    }
+                }
+
                 if (inputDevice == 0)
                 {
-                    callback->audioDeviceIOCallback (const_cast<const float**> (tempInputBuffers.getData()),
+                    callback->audioDeviceIOCallback (const_cast<const float**> (callbackInputBuffers.getData()),
                                                      numInputChans,
-                                                     tempOutputBuffers,
+                                                     callbackOutputBuffers,
                                                      numOutputChans,
                                                      bufferSize);
                 }
@@ -708,7 +763,7 @@ public:
 
                     callback->audioDeviceIOCallback (const_cast<const float**> (inputDevice->tempInputBuffers.getData()),
                                                      inputDevice->numInputChans,
-                                                     tempOutputBuffers,
+                                                     callbackOutputBuffers,
                                                      numOutputChans,
                                                      bufferSize);
                 }
@@ -721,7 +776,7 @@ public:
                                     + info.dataOffsetSamples;
                     const int stride = info.dataStrideSamples;
 
-                    if (stride != 0) // if this is zero, info is invalid
+                    if (stride != 0 && callbackOutputBuffers[i] == src) // (if the stride is zero, info is invalid)
                     {
                         for (int j = bufferSize; --j >= 0;)
                         {
@@ -753,6 +808,34 @@ public:
         }
     }
 
+    int getXRunCount() const noexcept
+    {
+        return numXRuns.get() + (inputDevice != nullptr ? inputDevice->numXRuns.get() : 0);
+    }
+
+    void releaseHogMode()
+    {
+        if (useHogMode && deviceID != 0)
+        {
+            pid_t owner = getHogModeOwner();
+
+            if (owner == getpid())
+            {
+                owner = -1;
+
+                AudioObjectPropertyAddress pa;
+                pa.mSelector = kAudioDevicePropertyHogMode;
+                pa.mScope = kAudioObjectPropertyScopeGlobal;
+                pa.mElement = kAudioObjectPropertyElementMaster;
+
+                OK (AudioObjectSetPropertyData (deviceID, &pa, 0, 0, sizeof (owner), &owner));
+            }
+        }
+
+        if (inputDevice != nullptr)
+            inputDevice->releaseHogMode();
+    }
+
     // called by callbacks
     void deviceDetailsChanged()
     {
@@ -833,6 +916,7 @@ public:
 
     ScopedPointer<CoreAudioInternal> inputDevice;
     bool isSlaveDevice;
+    const bool useHogMode;
 
 private:
     CriticalSection callbackLock;
@@ -843,6 +927,8 @@ private:
     HeapBlock <float> audioBuffer;
     int numInputChans, numOutputChans;
     bool callbacksAllowed;
+    Float64 lastSampleTime;
+    Atomic<int> numXRuns;
 
     struct CallbackDetailsForChannel
     {
@@ -854,17 +940,75 @@ private:
     int numInputChannelInfos, numOutputChannelInfos;
     HeapBlock <CallbackDetailsForChannel> inputChannelInfo, outputChannelInfo;
     HeapBlock <float*> tempInputBuffers, tempOutputBuffers;
+    HeapBlock <float*> callbackInputBuffers, callbackOutputBuffers;
+
+    bool canUseDeviceBuffer (const AudioBuffer& buffer, const int stride) const noexcept
+    {
+        // A slave device's buffers are only valid during its own IOProc, so it always has to copy
+        return stride == 1 && ! isSlaveDevice
+                && buffer.mDataByteSize >= (UInt32) bufferSize * sizeof (float);
+    }
+
+    // Each IO cycle should start exactly one buffer after the last one - if it doesn't, the
+    // HAL has skipped or repeated some samples, so count it as an xrun
+    void checkForDiscontinuity (const AudioTimeStamp* cycleTime) noexcept
+    {
+        if (cycleTime != nullptr && (cycleTime->mFlags & kAudioTimeStampSampleTimeValid) != 0)
+        {
+            if (lastSampleTime >= 0 && std::abs (cycleTime->mSampleTime - (lastSampleTime + bufferSize)) >= 1.0)
+                ++numXRuns;
+
+            lastSampleTime = cycleTime->mSampleTime;
+        }
+    }
+
+    pid_t getHogModeOwner() const
+    {
+        AudioObjectPropertyAddress pa;
+        pa.mSelector = kAudioDevicePropertyHogMode;
+        pa.mScope = kAudioObjectPropertyScopeGlobal;
+        pa.mElement = kAudioObjectPropertyElementMaster;
+
+        pid_t owner = -1;
+        UInt32 size = sizeof (owner);
+        AudioObjectGetPropertyData (deviceID, &pa, 0, 0, &size, &owner);
+        return owner;
+    }
+
+    bool claimHogMode()
+    {
+        pid_t owner = getHogModeOwner();
+
+        if (owner == getpid())
+            return true;
+
+        if (owner != -1)
+            return false;  // another process already has the device
+
+        // (setting the property toggles it, so this takes ownership for our process)
+        owner = getpid();
+
+        AudioObjectPropertyAddress pa;
+        pa.mSelector = kAudioDevicePropertyHogMode;
+        pa.mScope = kAudioObjectPropertyScopeGlobal;
+        pa.mElement = kAudioObjectPropertyElementMaster;
+
+        return OK (AudioObjectSetPropertyData (deviceID, &pa, 0, 0, sizeof (owner), &owner))
+                 && getHogModeOwner() == getpid();
+    }
 
     //==============================================================================
     static OSStatus audioIOProc (AudioDeviceID /*inDevice*/,
                                  const AudioTimeStamp* /*inNow*/,
                                  const AudioBufferList* inInputData,
-                                 const AudioTimeStamp* /*inInputTime*/,
+                                 const AudioTimeStamp* inInputTime,
                                  AudioBufferList* outOutputData,
-                                 const AudioTimeStamp* /*inOutputTime*/,
+                                 const AudioTimeStamp* inOutputTime,
                                  void* device)
     {
-        static_cast <CoreAudioInternal*> (device)->audioCallback (inInputData, outOutputData);
+        CoreAudioInternal* const intern = static_cast <CoreAudioInternal*> (device);
+        intern->audioCallback (inInputData, outOutputData,
+                               intern->numOutputChans > 0 ? inOutputTime : inInputTime);
         return noErr;
     }
 
@@ -883,6 +1027,10 @@ private:
                 intern->deviceDetailsChanged();
                 break;
 
+            case kAudioDeviceProcessorOverload:
+                ++(intern->numXRuns);
+                break;
+
             case kAudioDevicePropertyBufferSizeRange:
             case kAudioDevicePropertyVolumeScalar:
             case kAudioDevicePropertyMute:
@@ -942,8 +1090,10 @@ public:
                        AudioDeviceID inputDeviceId,
                        const int inputIndex_,
                        AudioDeviceID outputDeviceId,
-                       const int outputIndex_)
-        : AudioIODevice (deviceName, "CoreAudio"),
+                       const int outputIndex_,
+                       const String& typeName,
+                       const bool exclusiveMode)
+        : AudioIODevice (deviceName, typeName),
           inputIndex (inputIndex_),
           outputIndex (outputIndex_),
           isOpen_ (false),
@@ -955,15 +1105,15 @@ public:
         {
             jassert (inputDeviceId != 0);
 
-            device = new CoreAudioInternal (inputDeviceId);
+            device = new CoreAudioInternal (inputDeviceId, exclusiveMode);
         }
         else
         {
-            device = new CoreAudioInternal (outputDeviceId);
+            device = new CoreAudioInternal (outputDeviceId, exclusiveMode);
 
             if (inputDeviceId != 0)
             {
-                CoreAudioInternal* secondDevice = new CoreAudioInternal (inputDeviceId);
+                CoreAudioInternal* secondDevice = new CoreAudioInternal (inputDeviceId, exclusiveMode);
 
                 device->inputDevice = secondDevice;
                 secondDevice->isSlaveDevice = true;
@@ -1050,6 +1200,7 @@ public:
     {
         isOpen_ = false;
         internal->stop (false);
+        internal->releaseHogMode();
     }
 
     BigInteger getActiveOutputChannels() const
@@ -1080,6 +1231,11 @@ public:
         return internal->inputLatency + internal->getBufferSize() * 2;
     }
 
+    int getXRunCount() const noexcept
+    {
+        return internal->getXRunCount();
+    }
+
     void start (AudioIODeviceCallback* callback)
     {
         if (! isStarted)
@@ -1153,8 +1309,9 @@ class CoreAudioIODeviceType  : public AudioIODeviceType
 {
 public:
     //==============================================================================
-    CoreAudioIODeviceType()
-        : AudioIODeviceType ("CoreAudio"),
+    CoreAudioIODeviceType (const bool exclusiveMode)
+        : AudioIODeviceType (exclusiveMode ? "CoreAudio (Exclusive Mode)" : "CoreAudio"),
+          useExclusiveMode (exclusiveMode),
           hasScanned (false)
     {
         AudioObjectPropertyAddress pa;
@@ -1305,7 +1462,9 @@ public:
                                           inputIds [inputIndex],
                                           inputIndex,
                                           outputIds [outputIndex],
-                                          outputIndex);
+                                          outputIndex,
+                                          getTypeName(),
+                                          useExclusiveMode);
 
         return nullptr;
     }
@@ -1315,6 +1474,7 @@ private:
     StringArray inputDeviceNames, outputDeviceNames;
     Array <AudioDeviceID> inputIds, outputIds;
 
+    const bool useExclusiveMode;
     bool hasScanned;
 
     static int getNumChannels (AudioDeviceID deviceID, bool input)
@@ -1363,9 +1523,9 @@ private:
 };
 
 //==============================================================================
-AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_CoreAudio()
+AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_CoreAudio (const bool exclusiveMode)
 {
-    return new CoreAudioIODeviceType();
+    return new CoreAudioIODeviceType (exclusiveMode);
 }
 
 #undef JUCE_COREAUDIOLOG
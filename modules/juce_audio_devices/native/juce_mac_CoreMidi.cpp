@@ -284,11 +284,13 @@ namespace CoreMidiHelpers
 
                 for (unsigned int i = 0; i < pktlist->numPackets; ++i)
                 {
-                    concatenator.pushMidiData (packet->data, (int) packet->length, time,
-                                               input, callback);
+                    concatenator.addToBatch (packet->data, (int) packet->length, time,
+                                             input, callback);
 
                     packet = MIDIPacketNext (packet);
                 }
+
+                concatenator.flushBatch (input, callback);
             }
         }
 
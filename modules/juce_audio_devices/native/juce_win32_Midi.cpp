@@ -58,8 +58,9 @@ public:
     {
         if (bytes[0] >= 0x80 && isStarted)
         {
-            concatenator.pushMidiData (bytes, MidiMessage::getMessageLengthFromFirstByte (bytes[0]),
-                                       convertTimeStamp (timeStamp), input, callback);
+            concatenator.addToBatch (bytes, MidiMessage::getMessageLengthFromFirstByte (bytes[0]),
+                                     convertTimeStamp (timeStamp), input, callback);
+            concatenator.flushBatch (input, callback);
             writeFinishedBlocks();
         }
     }
@@ -68,8 +69,10 @@ public:
     {
         if (isStarted && hdr->dwBytesRecorded > 0)
         {
-            concatenator.pushMidiData (hdr->lpData, (int) hdr->dwBytesRecorded,
-                                       convertTimeStamp (timeStamp), input, callback);
+            // (a sysex buffer can contain any number of messages, which all go in one batch)
+            concatenator.addToBatch (hdr->lpData, (int) hdr->dwBytesRecorded,
+                                     convertTimeStamp (timeStamp), input, callback);
+            concatenator.flushBatch (input, callback);
             writeFinishedBlocks();
         }
     }
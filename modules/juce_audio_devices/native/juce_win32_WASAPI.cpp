@@ -329,6 +329,11 @@ int refTimeToSamples (const REFERENCE_TIME& t, const double sampleRate) noexcept
     return roundToInt (sampleRate * ((double) t) * 0.0000001);
 }
 
+REFERENCE_TIME samplesToRefTime (const int numSamples, const double sampleRate) noexcept
+{
+    return (REFERENCE_TIME) ((numSamples * 10000.0 * 1000.0 / sampleRate) + 0.5);
+}
+
 void copyWavFormat (WAVEFORMATEXTENSIBLE& dest, const WAVEFORMATEX* const src) noexcept
 {
     memcpy (&dest, src, src->wFormatTag == WAVE_FORMAT_EXTENSIBLE ? sizeof (WAVEFORMATEXTENSIBLE)
@@ -401,7 +406,7 @@ public:
 
     bool isOk() const noexcept   { return defaultBufferSize > 0 && defaultSampleRate > 0; }
 
-    bool openClient (const double newSampleRate, const BigInteger& newChannels)
+    bool openClient (const double newSampleRate, const BigInteger& newChannels, const int bufferSizeSamples)
     {
         sampleRate = newSampleRate;
         channels = newChannels;
@@ -414,8 +419,8 @@ public:
         client = createClient();
 
         if (client != nullptr
-             && (tryInitialisingWithFormat (true, 4) || tryInitialisingWithFormat (false, 4)
-                  || tryInitialisingWithFormat (false, 3) || tryInitialisingWithFormat (false, 2)))
+             && (tryInitialisingWithFormat (true, 4, bufferSizeSamples) || tryInitialisingWithFormat (false, 4, bufferSizeSamples)
+                  || tryInitialisingWithFormat (false, 3, bufferSizeSamples) || tryInitialisingWithFormat (false, 2, bufferSizeSamples)))
         {
             sampleRateHasChanged = false;
 
@@ -540,7 +545,7 @@ private:
         return client;
     }
 
-    bool tryInitialisingWithFormat (const bool useFloat, const int bytesPerSampleToTry)
+    bool tryInitialisingWithFormat (const bool useFloat, const int bytesPerSampleToTry, const int bufferSizeSamples)
     {
         WAVEFORMATEXTENSIBLE format;
         zerostruct (format);
@@ -582,13 +587,44 @@ private:
 
         REFERENCE_TIME defaultPeriod = 0, minPeriod = 0;
         if (useExclusiveMode)
+        {
             check (client->GetDevicePeriod (&defaultPeriod, &minPeriod));
 
+            // In exclusive mode the period is the callback size, so ask for the smallest one
+            // that the device allows which will hold the requested buffer size..
+            if (bufferSizeSamples > 0)
+                defaultPeriod = jmax (minPeriod, samplesToRefTime (bufferSizeSamples, format.Format.nSamplesPerSec));
+        }
+
         GUID session;
-        if (hr == S_OK
-             && check (client->Initialize (useExclusiveMode ? AUDCLNT_SHAREMODE_EXCLUSIVE : AUDCLNT_SHAREMODE_SHARED,
-                                           0x40000 /*AUDCLNT_STREAMFLAGS_EVENTCALLBACK*/,
-                                           defaultPeriod, defaultPeriod, (WAVEFORMATEX*) &format, &session)))
+        if (hr == S_OK)
+        {
+            hr = client->Initialize (useExclusiveMode ? AUDCLNT_SHAREMODE_EXCLUSIVE : AUDCLNT_SHAREMODE_SHARED,
+                                     0x40000 /*AUDCLNT_STREAMFLAGS_EVENTCALLBACK*/,
+                                     defaultPeriod, defaultPeriod, (WAVEFORMATEX*) &format, &session);
+
+            if (hr == MAKE_HRESULT (1, 0x889, 0x019) /*AUDCLNT_E_BUFFER_SIZE_NOT_ALIGNED*/)
+            {
+                // ..but if the device needs its buffers to be aligned differently, it tells
+                // us the nearest size that it can do, and the client has to be re-created.
+                UINT32 alignedBufferSize = 0;
+
+                if (check (client->GetBufferSize (&alignedBufferSize)))
+                {
+                    defaultPeriod = samplesToRefTime ((int) alignedBufferSize, format.Format.nSamplesPerSec);
+                    client = createClient();
+
+                    hr = client == nullptr ? E_POINTER
+                                           : client->Initialize (AUDCLNT_SHAREMODE_EXCLUSIVE,
+                                                                 0x40000 /*AUDCLNT_STREAMFLAGS_EVENTCALLBACK*/,
+                                                                 defaultPeriod, defaultPeriod, (WAVEFORMATEX*) &format, &session);
+                }
+            }
+
+            logFailure (hr);
+        }
+
+        if (hr == S_OK)
         {
             actualNumChannels = format.Format.nChannels;
             const bool isFloat = format.Format.wFormatTag == WAVE_FORMAT_EXTENSIBLE && format.SubFormat == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT;
@@ -619,12 +655,12 @@ public:
         close();
     }
 
-    bool open (const double newSampleRate, const BigInteger& newChannels)
+    bool open (const double newSampleRate, const BigInteger& newChannels, const int bufferSizeSamples)
     {
         reservoirSize = 0;
         reservoirCapacity = 16384;
         reservoir.setSize (actualNumChannels * reservoirCapacity * sizeof (float));
-        return openClient (newSampleRate, newChannels)
+        return openClient (newSampleRate, newChannels, bufferSizeSamples)
                 && (numChannels == 0 || check (client->GetService (__uuidof (IAudioCaptureClient),
                                                                    (void**) captureClient.resetAndGetPointerAddress())));
     }
@@ -727,7 +763,8 @@ class WASAPIOutputDevice  : public WASAPIDeviceBase
 {
 public:
     WASAPIOutputDevice (const ComSmartPtr <IMMDevice>& d, const bool exclusiveMode)
-        : WASAPIDeviceBase (d, exclusiveMode)
+        : WASAPIDeviceBase (d, exclusiveMode),
+          hasWrittenFirstPeriod (false)
     {
     }
 
@@ -736,9 +773,11 @@ public:
         close();
     }
 
-    bool open (const double newSampleRate, const BigInteger& newChannels)
+    bool open (const double newSampleRate, const BigInteger& newChannels, const int bufferSizeSamples)
     {
-        return openClient (newSampleRate, newChannels)
+        hasWrittenFirstPeriod = false;
+
+        return openClient (newSampleRate, newChannels, bufferSizeSamples)
             && (numChannels == 0 || check (client->GetService (__uuidof (IAudioRenderClient), (void**) renderClient.resetAndGetPointerAddress())));
     }
 
@@ -768,6 +807,12 @@ public:
         if (numChannels <= 0)
             return;
 
+        if (useExclusiveMode)
+        {
+            copyBuffersExclusive (srcBuffers, numSrcBuffers, bufferSize, thread);
+            return;
+        }
+
         int offset = 0;
 
         while (bufferSize > 0)
@@ -776,8 +821,7 @@ public:
             if (! check (client->GetCurrentPadding (&padding)))
                 return;
 
-            int samplesToDo = useExclusiveMode ? bufferSize
-                                               : jmin ((int) (actualBufferSize - padding), bufferSize);
+            const int samplesToDo = jmin ((int) (actualBufferSize - padding), bufferSize);
 
             if (samplesToDo <= 0)
             {
@@ -806,6 +850,54 @@ public:
     ScopedPointer <AudioData::Converter> converter;
 
 private:
+    bool hasWrittenFirstPeriod;
+
+    /*  In exclusive event-driven mode, the event is signalled each time the device is ready
+        for another whole period, and each write has to be exactly one period long (apart
+        from the first one, which primes the buffer before the stream starts). The callback
+        size is set to match the period when the device is opened, so the samples can go
+        straight from the callback's buffers into the device buffer.
+    */
+    void copyBuffersExclusive (const float** const srcBuffers, const int numSrcBuffers, const int bufferSize, Thread& thread)
+    {
+        jassert (bufferSize == (int) actualBufferSize);
+        const int samplesToDo = jmin (bufferSize, (int) actualBufferSize);
+
+        if (hasWrittenFirstPeriod && ! waitForNextPeriod (thread))
+            return;
+
+        for (;;)
+        {
+            uint8* outputData = nullptr;
+            const HRESULT hr = renderClient->GetBuffer (actualBufferSize, &outputData);
+
+            if (SUCCEEDED (hr))
+            {
+                for (int i = 0; i < numSrcBuffers; ++i)
+                    converter->convertSamples (outputData, channelMaps.getUnchecked(i), srcBuffers[i], 0, samplesToDo);
+
+                renderClient->ReleaseBuffer (actualBufferSize, 0);
+                hasWrittenFirstPeriod = true;
+                return;
+            }
+
+            // (if the device isn't ready for another period yet, wait and try again)
+            if (hr != MAKE_HRESULT (1, 0x889, 0x006) /*AUDCLNT_E_BUFFER_TOO_LARGE*/)
+            {
+                logFailure (hr);
+                return;
+            }
+
+            if (! waitForNextPeriod (thread))
+                return;
+        }
+    }
+
+    bool waitForNextPeriod (Thread& thread) const
+    {
+        return ! (thread.threadShouldExit() || WaitForSingleObject (clientEvent, 1000) == WAIT_TIMEOUT);
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WASAPIOutputDevice)
 };
 
@@ -816,10 +908,11 @@ class WASAPIAudioIODevice  : public AudioIODevice,
 {
 public:
     WASAPIAudioIODevice (const String& deviceName,
+                         const String& typeName_,
                          const String& outputDeviceId_,
                          const String& inputDeviceId_,
                          const bool exclusiveMode)
-        : AudioIODevice (deviceName, "Windows Audio"),
+        : AudioIODevice (deviceName, typeName_),
           Thread ("Juce WASAPI"),
           outputDeviceId (outputDeviceId_),
           inputDeviceId (inputDeviceId_),
@@ -938,19 +1031,28 @@ public:
         lastKnownInputChannels    = inputChannels;
         lastKnownOutputChannels   = outputChannels;
 
-        if (inputDevice != nullptr && ! inputDevice->open (currentSampleRate, inputChannels))
+        if (inputDevice != nullptr && ! inputDevice->open (currentSampleRate, inputChannels, currentBufferSizeSamples))
         {
             lastError = "Couldn't open the input device!";
             return lastError;
         }
 
-        if (outputDevice != nullptr && ! outputDevice->open (currentSampleRate, outputChannels))
+        if (outputDevice != nullptr && ! outputDevice->open (currentSampleRate, outputChannels, currentBufferSizeSamples))
         {
             close();
             lastError = "Couldn't open the output device!";
             return lastError;
         }
 
+        if (useExclusiveMode)
+        {
+            // the device has the final say on the period, and the callbacks have to match it
+            if (outputDevice != nullptr && outputDevice->client != nullptr)
+                currentBufferSizeSamples = (int) outputDevice->actualBufferSize;
+            else if (inputDevice != nullptr && inputDevice->client != nullptr)
+                currentBufferSizeSamples = (int) inputDevice->actualBufferSize;
+        }
+
         if (inputDevice != nullptr)   ResetEvent (inputDevice->clientEvent);
         if (outputDevice != nullptr)  ResetEvent (outputDevice->clientEvent);
 
@@ -1039,25 +1141,51 @@ public:
         }
     }
 
-    void setMMThreadPriority()
+    /*  Registers the calling thread with MMCSS as a "Pro Audio" task for as long as this
+        object exists. (The registration has to be reverted before avrt.dll is unloaded).
+    */
+    class ScopedMMThreadPriority
     {
-        DynamicLibrary dll ("avrt.dll");
-        JUCE_LOAD_WINAPI_FUNCTION (dll, AvSetMmThreadCharacteristicsW, avSetMmThreadCharacteristics, HANDLE, (LPCWSTR, LPDWORD))
-        JUCE_LOAD_WINAPI_FUNCTION (dll, AvSetMmThreadPriority, avSetMmThreadPriority, HANDLE, (HANDLE, AVRT_PRIORITY))
+    public:
+        ScopedMMThreadPriority (const AVRT_PRIORITY priority)
+            : dll ("avrt.dll"), taskHandle (0)
+        {
+            JUCE_LOAD_WINAPI_FUNCTION (dll, AvSetMmThreadCharacteristicsW, avSetMmThreadCharacteristics, HANDLE, (LPCWSTR, LPDWORD))
+            JUCE_LOAD_WINAPI_FUNCTION (dll, AvSetMmThreadPriority, avSetMmThreadPriority, HANDLE, (HANDLE, AVRT_PRIORITY))
+
+            if (avSetMmThreadCharacteristics != 0 && avSetMmThreadPriority != 0)
+            {
+                DWORD dummy = 0;
+                taskHandle = avSetMmThreadCharacteristics (L"Pro Audio", &dummy);
 
-        if (avSetMmThreadCharacteristics != 0 && avSetMmThreadPriority != 0)
+                if (taskHandle != 0)
+                    avSetMmThreadPriority (taskHandle, priority);
+            }
+        }
+
+        ~ScopedMMThreadPriority()
         {
-            DWORD dummy = 0;
-            HANDLE h = avSetMmThreadCharacteristics (L"Pro Audio", &dummy);
+            if (taskHandle != 0)
+            {
+                JUCE_LOAD_WINAPI_FUNCTION (dll, AvRevertMmThreadCharacteristics, avRevertMmThreadCharacteristics, BOOL, (HANDLE))
 
-            if (h != 0)
-                avSetMmThreadPriority (h, AVRT_PRIORITY_NORMAL);
+                if (avRevertMmThreadCharacteristics != 0)
+                    avRevertMmThreadCharacteristics (taskHandle);
+            }
         }
-    }
+
+    private:
+        DynamicLibrary dll;
+        HANDLE taskHandle;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedMMThreadPriority)
+    };
 
     void run()
     {
-        setMMThreadPriority();
+        // (an exclusive-mode stream has no mixer buffering behind it, so it needs more help)
+        const ScopedMMThreadPriority mmThreadPriority (useExclusiveMode ? AVRT_PRIORITY_HIGH
+                                                                        : AVRT_PRIORITY_NORMAL);
 
         const int bufferSize        = currentBufferSizeSamples;
         const int numInputBuffers   = getActiveInputChannels().countNumberOfSetBits();
@@ -1214,9 +1342,10 @@ class WASAPIAudioIODeviceType  : public AudioIODeviceType,
                                  private DeviceChangeDetector
 {
 public:
-    WASAPIAudioIODeviceType()
-        : AudioIODeviceType ("Windows Audio"),
+    WASAPIAudioIODeviceType (const bool exclusiveMode)
+        : AudioIODeviceType (exclusiveMode ? "Windows Audio (Exclusive Mode)" : "Windows Audio"),
           DeviceChangeDetector (L"Windows Audio"),
+          useExclusiveMode (exclusiveMode),
           hasScanned (false)
     {
     }
@@ -1270,7 +1399,6 @@ public:
     {
         jassert (hasScanned); // need to call scanForDevices() before doing this
 
-        const bool useExclusiveMode = false;
         ScopedPointer<WASAPIAudioIODevice> device;
 
         const int outputIndex = outputDeviceNames.indexOf (outputDeviceName);
@@ -1280,6 +1408,7 @@ public:
         {
             device = new WASAPIAudioIODevice (outputDeviceName.isNotEmpty() ? outputDeviceName
                                                                             : inputDeviceName,
+                                              getTypeName(),
                                               outputDeviceIds [outputIndex],
                                               inputDeviceIds [inputIndex],
                                               useExclusiveMode);
@@ -1296,6 +1425,7 @@ public:
     StringArray inputDeviceNames, inputDeviceIds;
 
 private:
+    const bool useExclusiveMode;
     bool hasScanned;
     ComSmartPtr<IMMDeviceEnumerator> enumerator;
 
@@ -1496,10 +1626,10 @@ struct MMDeviceMasterVolume
 }
 
 //==============================================================================
-AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_WASAPI()
+AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_WASAPI (const bool exclusiveMode)
 {
     if (SystemStats::getOperatingSystemType() >= SystemStats::WinVista)
-        return new WasapiClasses::WASAPIAudioIODeviceType();
+        return new WasapiClasses::WASAPIAudioIODeviceType (exclusiveMode);
 
     return nullptr;
 }
@@ -23,20 +23,85 @@
   ==============================================================================
 */
 
+/*  Everything that the audio thread needs in order to play one source. A new chain is
+    built and prepared whenever the source changes, and is then swapped in atomically.
+*/
+class AudioTransportSource::SourceChain
+{
+public:
+    SourceChain (PositionableAudioSource* const source_, const int readAheadBufferSize,
+                 TimeSliceThread* const readAheadThread, const double sourceSampleRate_,
+                 const int maxNumChannels)
+        : source (source_),
+          positionableSource (source_),
+          masterSource (source_),
+          sourceSampleRate (sourceSampleRate_)
+    {
+        if (readAheadBufferSize > 0)
+        {
+            // If you want to use a read-ahead buffer, you must also provide a TimeSliceThread
+            // for it to use!
+            jassert (readAheadThread != nullptr);
+
+            positionableSource = bufferingSource
+                = new BufferingAudioSource (positionableSource, *readAheadThread,
+                                            false, readAheadBufferSize, maxNumChannels);
+        }
+
+        positionableSource->setNextReadPosition (0);
+
+        if (sourceSampleRate > 0)
+            masterSource = resamplerSource
+                = new ResamplingAudioSource (positionableSource, false, maxNumChannels);
+        else
+            masterSource = positionableSource;
+    }
+
+    void prepare (const int blockSize, const double sampleRate)
+    {
+        if (resamplerSource != nullptr && sourceSampleRate > 0 && sampleRate > 0)
+            resamplerSource->setResamplingRatio (sourceSampleRate / sampleRate);
+
+        masterSource->prepareToPlay (blockSize, sampleRate);
+    }
+
+    void release()
+    {
+        masterSource->releaseResources();
+    }
+
+    // The number of output samples per sample of the source.
+    double getRatio (const double sampleRate) const noexcept
+    {
+        return (sampleRate > 0 && sourceSampleRate > 0) ? sampleRate / sourceSampleRate : 1.0;
+    }
+
+    PositionableAudioSource* const source;
+    ScopedPointer<BufferingAudioSource> bufferingSource;
+    ScopedPointer<ResamplingAudioSource> resamplerSource;
+    PositionableAudioSource* positionableSource;
+    AudioSource* masterSource;
+    const double sourceSampleRate;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (SourceChain)
+};
+
+//==============================================================================
 AudioTransportSource::AudioTransportSource()
-    : source (nullptr),
-      resamplerSource (nullptr),
-      bufferingSource (nullptr),
-      positionableSource (nullptr),
-      masterSource (nullptr),
+    : sampleClock (0),
+      readPosition (0),
+      pendingPosition (-1),
+      scheduledStart (-1),
+      scheduledStop (-1),
+      totalLength (0),
       gain (1.0f),
       lastGain (1.0f),
       playing (false),
       stopped (true),
+      looping (false),
       sampleRate (44100.0),
-      sourceSampleRate (0.0),
       blockSize (128),
-      readAheadBufferSize (0),
       isPrepared (false),
       inputStreamEOF (false)
 {
@@ -50,89 +115,71 @@ AudioTransportSource::~AudioTransportSource()
 }
 
 void AudioTransportSource::setSource (PositionableAudioSource* const newSource,
-                                      int readAheadBufferSize_,
+                                      int readAheadBufferSize,
                                       TimeSliceThread* readAheadThread,
                                       double sourceSampleRateToCorrectFor,
                                       int maxNumChannels)
 {
-    if (source == newSource)
-    {
-        if (source == nullptr)
-            return;
+    const ScopedLock sl (sourceLock);
 
-        setSource (nullptr, 0, nullptr); // deselect and reselect to avoid releasing resources wrongly
-    }
+    {
+        const SourceChain* const current = activeChain.get();
 
-    readAheadBufferSize = readAheadBufferSize_;
-    sourceSampleRate = sourceSampleRateToCorrectFor;
+        if ((current != nullptr ? current->source : nullptr) == newSource)
+        {
+            if (newSource == nullptr)
+                return;
 
-    ResamplingAudioSource* newResamplerSource = nullptr;
-    BufferingAudioSource* newBufferingSource = nullptr;
-    PositionableAudioSource* newPositionableSource = nullptr;
-    AudioSource* newMasterSource = nullptr;
+            setSource (nullptr, 0, nullptr); // deselect and reselect to avoid releasing resources wrongly
+        }
+    }
 
-    ScopedPointer <ResamplingAudioSource> oldResamplerSource (resamplerSource);
-    ScopedPointer <BufferingAudioSource> oldBufferingSource (bufferingSource);
-    AudioSource* oldMasterSource = masterSource;
+    ScopedPointer<SourceChain> newChain;
 
     if (newSource != nullptr)
     {
-        newPositionableSource = newSource;
+        newChain = new SourceChain (newSource, readAheadBufferSize, readAheadThread,
+                                    sourceSampleRateToCorrectFor, maxNumChannels);
 
-        if (readAheadBufferSize_ > 0)
-        {
-            // If you want to use a read-ahead buffer, you must also provide a TimeSliceThread
-            // for it to use!
-            jassert (readAheadThread != nullptr);
+        if (isPrepared)
+            newChain->prepare (blockSize, sampleRate);
+    }
 
-            newPositionableSource = newBufferingSource
-                = new BufferingAudioSource (newPositionableSource, *readAheadThread,
-                                            false, readAheadBufferSize_, maxNumChannels);
-        }
+    playing = false;
+    scheduledStart = -1;
+    scheduledStop = -1;
 
-        newPositionableSource->setNextReadPosition (0);
+    ScopedPointer<SourceChain> oldChain (activeChain.exchange (newChain.release()));
+    audioThreadHandover.waitForAudioThread();
 
-        if (sourceSampleRateToCorrectFor > 0)
-            newMasterSource = newResamplerSource
-                = new ResamplingAudioSource (newPositionableSource, false, maxNumChannels);
-        else
-            newMasterSource = newPositionableSource;
+    pendingPosition = -1;
+    readPosition = 0;
+    updateLengthAndLooping (activeChain.get());
 
-        if (isPrepared)
-        {
-            if (newResamplerSource != nullptr && sourceSampleRate > 0 && sampleRate > 0)
-                newResamplerSource->setResamplingRatio (sourceSampleRate / sampleRate);
+    if (oldChain != nullptr)
+        oldChain->release();
+}
 
-            newMasterSource->prepareToPlay (blockSize, sampleRate);
-        }
+void AudioTransportSource::updateLengthAndLooping (const SourceChain* const chain) noexcept
+{
+    if (chain != nullptr)
+    {
+        totalLength = (int64) (chain->positionableSource->getTotalLength() * chain->getRatio (sampleRate));
+        looping = chain->positionableSource->isLooping();
     }
-
+    else
     {
-        const ScopedLock sl (callbackLock);
-
-        source = newSource;
-        resamplerSource = newResamplerSource;
-        bufferingSource = newBufferingSource;
-        masterSource = newMasterSource;
-        positionableSource = newPositionableSource;
-
-        playing = false;
+        totalLength = 0;
+        looping = false;
     }
-
-    if (oldMasterSource != nullptr)
-        oldMasterSource->releaseResources();
 }
 
 void AudioTransportSource::start()
 {
-    if ((! playing) && masterSource != nullptr)
+    if ((! playing) && activeChain.get() != nullptr)
     {
-        {
-            const ScopedLock sl (callbackLock);
-            playing = true;
-            stopped = false;
-            inputStreamEOF = false;
-        }
+        inputStreamEOF = false;
+        playing = true;
 
         sendChangeMessage();
     }
@@ -142,10 +189,7 @@ void AudioTransportSource::stop()
 {
     if (playing)
     {
-        {
-            const ScopedLock sl (callbackLock);
-            playing = false;
-        }
+        playing = false;
 
         int n = 500;
         while (--n >= 0 && ! stopped)
@@ -155,6 +199,16 @@ void AudioTransportSource::stop()
     }
 }
 
+void AudioTransportSource::startAt (const int64 sampleClockTime) noexcept
+{
+    scheduledStart = jmax ((int64) -1, sampleClockTime);
+}
+
+void AudioTransportSource::stopAt (const int64 sampleClockTime) noexcept
+{
+    scheduledStop = jmax ((int64) -1, sampleClockTime);
+}
+
 void AudioTransportSource::setPosition (double newPosition)
 {
     if (sampleRate > 0.0)
@@ -176,47 +230,25 @@ double AudioTransportSource::getLengthInSeconds() const
 
 void AudioTransportSource::setNextReadPosition (int64 newPosition)
 {
-    if (positionableSource != nullptr)
-    {
-        if (sampleRate > 0 && sourceSampleRate > 0)
-            newPosition = (int64) (newPosition * sourceSampleRate / sampleRate);
-
-        positionableSource->setNextReadPosition (newPosition);
-    }
+    if (activeChain.get() != nullptr)
+        pendingPosition = jmax ((int64) 0, newPosition);
 }
 
 int64 AudioTransportSource::getNextReadPosition() const
 {
-    if (positionableSource != nullptr)
-    {
-        const double ratio = (sampleRate > 0 && sourceSampleRate > 0) ? sampleRate / sourceSampleRate : 1.0;
+    const int64 pending = pendingPosition.get();
 
-        return (int64) (positionableSource->getNextReadPosition() * ratio);
-    }
-
-    return 0;
+    return pending >= 0 ? pending : readPosition.get();
 }
 
 int64 AudioTransportSource::getTotalLength() const
 {
-    const ScopedLock sl (callbackLock);
-
-    if (positionableSource != nullptr)
-    {
-        const double ratio = (sampleRate > 0 && sourceSampleRate > 0) ? sampleRate / sourceSampleRate : 1.0;
-
-        return (int64) (positionableSource->getTotalLength() * ratio);
-    }
-
-    return 0;
+    return totalLength.get();
 }
 
 bool AudioTransportSource::isLooping() const
 {
-    const ScopedLock sl (callbackLock);
-
-    return positionableSource != nullptr
-            && positionableSource->isLooping();
+    return looping;
 }
 
 void AudioTransportSource::setGain (const float newGain) noexcept
@@ -226,26 +258,28 @@ void AudioTransportSource::setGain (const float newGain) noexcept
 
 void AudioTransportSource::prepareToPlay (int samplesPerBlockExpected, double newSampleRate)
 {
-    const ScopedLock sl (callbackLock);
+    const ScopedLock sl (sourceLock);
 
     sampleRate = newSampleRate;
     blockSize = samplesPerBlockExpected;
 
-    if (masterSource != nullptr)
-        masterSource->prepareToPlay (samplesPerBlockExpected, sampleRate);
+    SourceChain* const chain = activeChain.get();
 
-    if (resamplerSource != nullptr && sourceSampleRate > 0)
-        resamplerSource->setResamplingRatio (sourceSampleRate / sampleRate);
+    if (chain != nullptr)
+        chain->prepare (samplesPerBlockExpected, sampleRate);
 
+    updateLengthAndLooping (chain);
     isPrepared = true;
 }
 
 void AudioTransportSource::releaseMasterResources()
 {
-    const ScopedLock sl (callbackLock);
+    const ScopedLock sl (sourceLock);
 
-    if (masterSource != nullptr)
-        masterSource->releaseResources();
+    SourceChain* const chain = activeChain.get();
+
+    if (chain != nullptr)
+        chain->release();
 
     isPrepared = false;
 }
@@ -257,15 +291,82 @@ void AudioTransportSource::releaseResources()
 
 void AudioTransportSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
-    const ScopedLock sl (callbackLock);
+    const AudioThreadHandover::ScopedCallback sc (audioThreadHandover);
+
+    SourceChain* const chain = activeChain.get();
 
     inputStreamEOF = false;
 
-    if (masterSource != nullptr && ! stopped)
+    if (chain != nullptr)
     {
-        masterSource->getNextAudioBlock (info);
+        renderBlock (*chain, info);
+    }
+    else
+    {
+        info.clearActiveBufferRegion();
+        stopped = true;
+    }
 
+    lastGain = gain;
+    sampleClock += info.numSamples;
+}
+
+void AudioTransportSource::renderBlock (SourceChain& chain, const AudioSourceChannelInfo& info)
+{
+    const double ratio = chain.getRatio (sampleRate);
+    const int64 seekPosition = pendingPosition.exchange (-1);
+
+    if (seekPosition >= 0)
+        chain.positionableSource->setNextReadPosition ((int64) (seekPosition / ratio));
+
+    const int64 blockStart = sampleClock.get();
+    const int64 blockEnd = blockStart + info.numSamples;
+    const bool wasRunning = ! stopped;
+    bool hardStop = false;
+    int startOffset = 0, endOffset = info.numSamples;
+
+    const int64 startTime = scheduledStart.get();
+
+    if (startTime >= 0 && startTime < blockEnd && scheduledStart.compareAndSetBool (-1, startTime))
+    {
         if (! playing)
+        {
+            if (! wasRunning)
+                startOffset = (int) jmax ((int64) 0, startTime - blockStart);
+
+            playing = true;
+            sendChangeMessage();
+        }
+    }
+
+    const int64 stopTime = scheduledStop.get();
+
+    if (stopTime >= 0 && stopTime < blockEnd && scheduledStop.compareAndSetBool (-1, stopTime))
+    {
+        if (playing || wasRunning)
+        {
+            endOffset = jmax (startOffset, (int) jmax ((int64) 0, stopTime - blockStart));
+            hardStop = true;
+            playing = false;
+            sendChangeMessage();
+        }
+    }
+
+    const bool isRunning = playing;
+
+    if (isRunning || wasRunning || hardStop)
+    {
+        if (startOffset > 0)
+            info.buffer->clear (info.startSample, startOffset);
+
+        if (endOffset > startOffset)
+            chain.masterSource->getNextAudioBlock (AudioSourceChannelInfo (info.buffer, info.startSample + startOffset,
+                                                                           endOffset - startOffset));
+
+        if (endOffset < info.numSamples)
+            info.buffer->clear (info.startSample + endOffset, info.numSamples - endOffset);
+
+        if (! (isRunning || hardStop))
         {
             // just stopped playing, so fade out the last block..
             for (int i = info.buffer->getNumChannels(); --i >= 0;)
@@ -275,15 +376,17 @@ void AudioTransportSource::getNextAudioBlock (const AudioSourceChannelInfo& info
                 info.buffer->clear (info.startSample + 256, info.numSamples - 256);
         }
 
-        if (positionableSource->getNextReadPosition() > positionableSource->getTotalLength() + 1
-             && ! positionableSource->isLooping())
+        updateLengthAndLooping (&chain);
+
+        if (chain.positionableSource->getNextReadPosition() > chain.positionableSource->getTotalLength() + 1
+             && ! chain.positionableSource->isLooping())
         {
             playing = false;
             inputStreamEOF = true;
             sendChangeMessage();
         }
 
-        stopped = ! playing;
+        stopped = ! isRunning || inputStreamEOF;
 
         for (int i = info.buffer->getNumChannels(); --i >= 0;)
         {
@@ -297,5 +400,5 @@ void AudioTransportSource::getNextAudioBlock (const AudioSourceChannelInfo& info
         stopped = true;
     }
 
-    lastGain = gain;
+    readPosition = (int64) (chain.positionableSource->getNextReadPosition() * ratio);
 }
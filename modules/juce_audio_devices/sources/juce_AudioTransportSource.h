@@ -59,6 +59,12 @@ public:
 
         This will stop playback, reset the position to 0 and change to the new reader.
 
+        The new source is wrapped and prepared on the calling thread, and is then handed
+        over to the audio thread atomically, so the audio callback is never blocked while
+        this happens. Once the method returns, the audio thread has finished with the old
+        source, and its resources have been released. This (and prepareToPlay/releaseResources)
+        shouldn't be called by more than one thread at a time, or from the audio callback.
+
         The source passed in will not be deleted by this object, so must be managed by
         the caller.
 
@@ -88,7 +94,8 @@ public:
     /** Changes the current playback position in the source stream.
 
         The next time the getNextAudioBlock() method is called, this
-        is the time from which it'll read data.
+        is the time from which it'll read data. The seek itself is carried out
+        by the audio thread at the start of its next block, so this never blocks.
 
         @see getPosition
     */
@@ -96,7 +103,8 @@ public:
 
     /** Returns the position that the next data block will be read from
 
-        This is a time in seconds.
+        This is a time in seconds. It's safe to call this from any thread, and it
+        doesn't need to take a lock.
     */
     double getCurrentPosition() const;
 
@@ -125,6 +133,41 @@ public:
     /** Returns true if it's currently playing. */
     bool isPlaying() const noexcept     { return playing; }
 
+    //==============================================================================
+    /** Schedules playback to begin at an exact sample.
+
+        The time is measured on the clock returned by getSampleClock(), and when the
+        block that contains it is rendered, the source will start playing from that
+        sample onwards (the part of the block before it is left silent). If the time
+        has already passed when the next block arrives, playback starts at the
+        beginning of that block.
+
+        Only one start can be pending at a time - calling this again replaces it,
+        and a negative value cancels it.
+
+        @see stopAt, getSampleClock
+    */
+    void startAt (int64 sampleClockTime) noexcept;
+
+    /** Schedules playback to stop at an exact sample.
+
+        The time is measured on the clock returned by getSampleClock(). The output
+        is cut off exactly at this sample, without the short fade-out that stop() uses,
+        so it's best to pick a point where the audio is silent or at a zero-crossing.
+        Only one stop can be pending at a time, and a negative value cancels it.
+
+        @see startAt, getSampleClock
+    */
+    void stopAt (int64 sampleClockTime) noexcept;
+
+    /** Returns the total number of samples that this object has rendered.
+
+        This counts every sample that has passed through getNextAudioBlock(), whether
+        or not it was playing, so it keeps moving at the device's rate and can be used
+        as the time-base for startAt() and stopAt().
+    */
+    int64 getSampleClock() const noexcept               { return sampleClock.get(); }
+
     //==============================================================================
     /** Changes the gain to apply to the output.
 
@@ -165,20 +208,23 @@ public:
 
 private:
     //==============================================================================
-    PositionableAudioSource* source;
-    ResamplingAudioSource* resamplerSource;
-    BufferingAudioSource* bufferingSource;
-    PositionableAudioSource* positionableSource;
-    AudioSource* masterSource;
+    class SourceChain;
+    friend class ScopedPointer<SourceChain>;
+
+    Atomic<SourceChain*> activeChain;
+    AudioThreadHandover audioThreadHandover;
+    Atomic<int64> sampleClock, readPosition, pendingPosition, scheduledStart, scheduledStop, totalLength;
 
-    CriticalSection callbackLock;
+    CriticalSection sourceLock;
     float volatile gain, lastGain;
-    bool volatile playing, stopped;
-    double sampleRate, sourceSampleRate;
-    int blockSize, readAheadBufferSize;
+    bool volatile playing, stopped, looping;
+    double sampleRate;
+    int blockSize;
     bool isPrepared, inputStreamEOF;
 
     void releaseMasterResources();
+    void renderBlock (SourceChain&, const AudioSourceChannelInfo&);
+    void updateLengthAndLooping (const SourceChain*) noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioTransportSource)
 };
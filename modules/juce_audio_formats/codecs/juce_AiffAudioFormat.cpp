@@ -493,6 +493,19 @@ public:
     //==============================================================================
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples)
+    {
+        return readSamplesOfType (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    bool readSamplesAsFloat (float** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                             int64 startSampleInFile, int numSamples)
+    {
+        return readSamplesOfType (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    template <typename SampleType>
+    bool readSamplesOfType (SampleType** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                            int64 startSampleInFile, int numSamples)
     {
         clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
                                            startSampleInFile, numSamples, lengthInSamples);
@@ -548,6 +561,22 @@ public:
         }
     }
 
+    template <typename Endianness>
+    static void copySampleData (unsigned int bitsPerSample, const bool usesFloatingPointData,
+                                float* const* destSamples, int startOffsetInDestBuffer, int numDestChannels,
+                                const void* sourceData, int numChannels, int numSamples) noexcept
+    {
+        switch (bitsPerSample)
+        {
+            case 8:     ReadHelper<AudioData::Float32, AudioData::Int8,  Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            case 16:    ReadHelper<AudioData::Float32, AudioData::Int16, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            case 24:    ReadHelper<AudioData::Float32, AudioData::Int24, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            case 32:    if (usesFloatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples);
+                        else                       ReadHelper<AudioData::Float32, AudioData::Int32,   Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            default:    jassertfalse; break;
+        }
+    }
+
     int bytesPerFrame;
     int64 dataChunkStart;
     bool littleEndian;
@@ -753,6 +782,19 @@ public:
 
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples)
+    {
+        return readSamplesOfType (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    bool readSamplesAsFloat (float** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                             int64 startSampleInFile, int numSamples)
+    {
+        return readSamplesOfType (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    template <typename SampleType>
+    bool readSamplesOfType (SampleType** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                            int64 startSampleInFile, int numSamples)
     {
         clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
                                            startSampleInFile, numSamples, lengthInSamples);
@@ -867,6 +909,15 @@ bool AiffAudioFormat::canHandleFile (const File& f)
 }
 #endif
 
+bool AiffAudioFormat::canHandleHeader (const void* headerData, const int numBytes)
+{
+    const char* const d = static_cast <const char*> (headerData);
+
+    return numBytes >= 12
+            && memcmp (d, "FORM", 4) == 0
+            && (memcmp (d + 8, "AIFF", 4) == 0 || memcmp (d + 8, "AIFC", 4) == 0);
+}
+
 AudioFormatReader* AiffAudioFormat::createReaderFor (InputStream* sourceStream, const bool deleteStreamIfOpeningFails)
 {
     ScopedPointer <AiffAudioFormatReader> w (new AiffAudioFormatReader (sourceStream));
@@ -68,6 +68,8 @@ public:
    #endif
 
     //==============================================================================
+    bool canHandleHeader (const void* headerData, int numBytes);
+
     AudioFormatReader* createReaderFor (InputStream* sourceStream,
                                         bool deleteStreamIfOpeningFails);
 
@@ -450,6 +450,197 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CoreAudioReader)
 };
 
+//==============================================================================
+/*  Parses the header of a CAF file containing uncompressed linear PCM, to find out where
+    the sample data is and how it's laid out, so that it can be memory-mapped.
+*/
+class CafPCMHeaderReader : public AudioFormatReader
+{
+public:
+    CafPCMHeaderReader (InputStream* const inp)
+        : AudioFormatReader (inp, TRANS (coreAudioFormatName)),
+          bytesPerFrame (0), dataChunkStart (0), littleEndian (false)
+    {
+        typedef CoreAudioFormatMetatdata Metadata;
+
+        const Metadata::FileHeader header (*input);
+
+        if (header.fileType != Metadata::chunkName ("caff"))
+            return;
+
+        bool foundDescription = false;
+
+        while (! input->isExhausted())
+        {
+            const Metadata::ChunkHeader chunkHeader (*input);
+            const int64 chunkEnd = input->getPosition() + chunkHeader.chunkSize;
+
+            if (chunkHeader.chunkType == Metadata::chunkName ("desc"))
+            {
+                const Metadata::AudioDescriptionChunk desc (*input);
+
+                const bool isFloat = (desc.formatFlags & 1) != 0;
+                littleEndian       = (desc.formatFlags & 2) != 0;
+
+                if (desc.formatID != Metadata::chunkName ("lpcm")
+                     || desc.framesPerPacket != 1
+                     || desc.channelsPerFrame == 0
+                     || desc.bytesPerPacket != desc.channelsPerFrame * (desc.bitsPerChannel / 8)
+                     || (isFloat ? desc.bitsPerChannel != 32
+                                 : (desc.bitsPerChannel != 8 && desc.bitsPerChannel != 16
+                                     && desc.bitsPerChannel != 24 && desc.bitsPerChannel != 32)))
+                    return;
+
+                sampleRate = desc.sampleRate;
+                numChannels = desc.channelsPerFrame;
+                bitsPerSample = desc.bitsPerChannel;
+                usesFloatingPointData = isFloat;
+                bytesPerFrame = (int) desc.bytesPerPacket;
+                foundDescription = true;
+            }
+            else if (chunkHeader.chunkType == Metadata::chunkName ("data"))
+            {
+                if (! foundDescription)
+                    return;
+
+                // the audio data follows a 4-byte edit count, and a size of -1 means
+                // that it runs on to the end of the file
+                dataChunkStart = input->getPosition() + 4;
+
+                const int64 dataSize = chunkHeader.chunkSize < 0 ? input->getTotalLength() - dataChunkStart
+                                                                 : chunkHeader.chunkSize - 4;
+
+                lengthInSamples = jmax ((int64) 0, dataSize) / bytesPerFrame;
+                return;
+            }
+
+            if (chunkHeader.chunkSize < 0 || ! input->setPosition (chunkEnd))
+                break;
+        }
+
+        numChannels = 0; // (no data chunk)
+    }
+
+    bool readSamples (int**, int, int, int64, int)
+    {
+        jassertfalse; // this is only used to find the layout of the file
+        return false;
+    }
+
+    template <typename Endianness>
+    static void copySampleData (unsigned int bitsPerSample, const bool usesFloatingPointData,
+                                int* const* destSamples, int startOffsetInDestBuffer, int numDestChannels,
+                                const void* sourceData, int numChannels, int numSamples) noexcept
+    {
+        switch (bitsPerSample)
+        {
+            case 8:     ReadHelper<AudioData::Int32, AudioData::Int8,  Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            case 16:    ReadHelper<AudioData::Int32, AudioData::Int16, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            case 24:    ReadHelper<AudioData::Int32, AudioData::Int24, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            case 32:    if (usesFloatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples);
+                        else                       ReadHelper<AudioData::Int32,   AudioData::Int32,   Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            default:    jassertfalse; break;
+        }
+    }
+
+    int bytesPerFrame;
+    int64 dataChunkStart;
+    bool littleEndian;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CafPCMHeaderReader)
+};
+
+//==============================================================================
+class MemoryMappedCafReader   : public MemoryMappedAudioFormatReader
+{
+public:
+    MemoryMappedCafReader (const File& file, const CafPCMHeaderReader& reader)
+        : MemoryMappedAudioFormatReader (file, reader, reader.dataChunkStart,
+                                         reader.bytesPerFrame * reader.lengthInSamples, reader.bytesPerFrame),
+          littleEndian (reader.littleEndian)
+    {
+    }
+
+    bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      int64 startSampleInFile, int numSamples)
+    {
+        clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                           startSampleInFile, numSamples, lengthInSamples);
+
+        if (map == nullptr || ! mappedSection.contains (Range<int64> (startSampleInFile, startSampleInFile + numSamples)))
+        {
+            jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
+            return false;
+        }
+
+        if (littleEndian)
+            CafPCMHeaderReader::copySampleData<AudioData::LittleEndian>
+                    (bitsPerSample, usesFloatingPointData, destSamples, startOffsetInDestBuffer,
+                     numDestChannels, sampleToPointer (startSampleInFile), (int) numChannels, numSamples);
+        else
+            CafPCMHeaderReader::copySampleData<AudioData::BigEndian>
+                    (bitsPerSample, usesFloatingPointData, destSamples, startOffsetInDestBuffer,
+                     numDestChannels, sampleToPointer (startSampleInFile), (int) numChannels, numSamples);
+
+        return true;
+    }
+
+    void readMaxLevels (int64 startSampleInFile, int64 numSamples,
+                        float& min0, float& max0, float& min1, float& max1)
+    {
+        if (numSamples <= 0)
+        {
+            min0 = max0 = min1 = max1 = 0;
+            return;
+        }
+
+        if (map == nullptr || ! mappedSection.contains (Range<int64> (startSampleInFile, startSampleInFile + numSamples)))
+        {
+            jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
+
+            min0 = max0 = min1 = max1 = 0;
+            return;
+        }
+
+        switch (bitsPerSample)
+        {
+            case 8:     scanMinAndMax<AudioData::Int8>  (startSampleInFile, numSamples, min0, max0, min1, max1); break;
+            case 16:    scanMinAndMax<AudioData::Int16> (startSampleInFile, numSamples, min0, max0, min1, max1); break;
+            case 24:    scanMinAndMax<AudioData::Int24> (startSampleInFile, numSamples, min0, max0, min1, max1); break;
+            case 32:    if (usesFloatingPointData) scanMinAndMax<AudioData::Float32> (startSampleInFile, numSamples, min0, max0, min1, max1);
+                        else                       scanMinAndMax<AudioData::Int32>   (startSampleInFile, numSamples, min0, max0, min1, max1); break;
+            default:    jassertfalse; break;
+        }
+    }
+
+private:
+    const bool littleEndian;
+
+    template <typename SampleType>
+    void scanMinAndMax (int64 startSampleInFile, int64 numSamples,
+                        float& min0, float& max0, float& min1, float& max1) const noexcept
+    {
+        scanMinAndMax2<SampleType> (0, startSampleInFile, numSamples, min0, max0);
+
+        if (numChannels > 1)
+            scanMinAndMax2<SampleType> (1, startSampleInFile, numSamples, min1, max1);
+        else
+            min1 = max1 = 0;
+    }
+
+    template <typename SampleType>
+    void scanMinAndMax2 (int channel, int64 startSampleInFile, int64 numSamples, float& mn, float& mx) const noexcept
+    {
+        if (littleEndian)
+            scanMinAndMaxInterleaved<SampleType, AudioData::LittleEndian> (channel, startSampleInFile, numSamples, mn, mx);
+        else
+            scanMinAndMaxInterleaved<SampleType, AudioData::BigEndian>    (channel, startSampleInFile, numSamples, mn, mx);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MemoryMappedCafReader)
+};
+
 //==============================================================================
 CoreAudioFormat::CoreAudioFormat()
     : AudioFormat (TRANS (coreAudioFormatName), findFileExtensionsForCoreAudioCodecs())
@@ -465,6 +656,11 @@ bool CoreAudioFormat::canDoStereo()     { return true; }
 bool CoreAudioFormat::canDoMono()       { return true; }
 
 //==============================================================================
+bool CoreAudioFormat::canHandleHeader (const void* headerData, const int numBytes)
+{
+    return numBytes >= 4 && memcmp (headerData, "caff", 4) == 0;
+}
+
 AudioFormatReader* CoreAudioFormat::createReaderFor (InputStream* sourceStream,
                                                      bool deleteStreamIfOpeningFails)
 {
@@ -479,6 +675,19 @@ AudioFormatReader* CoreAudioFormat::createReaderFor (InputStream* sourceStream,
     return nullptr;
 }
 
+MemoryMappedAudioFormatReader* CoreAudioFormat::createMemoryMappedReader (const File& file)
+{
+    if (FileInputStream* fin = file.createInputStream())
+    {
+        CafPCMHeaderReader reader (fin);
+
+        if (reader.numChannels > 0 && reader.lengthInSamples > 0)
+            return new MemoryMappedCafReader (file, reader);
+    }
+
+    return nullptr;
+}
+
 AudioFormatWriter* CoreAudioFormat::createWriterFor (OutputStream* streamToWriteTo,
                                                      double sampleRateToUse,
                                                      unsigned int numberOfChannels,
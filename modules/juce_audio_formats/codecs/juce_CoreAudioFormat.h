@@ -59,9 +59,17 @@ public:
     bool canDoMono();
 
     //==============================================================================
+    bool canHandleHeader (const void* headerData, int numBytes);
+
     AudioFormatReader* createReaderFor (InputStream*,
                                         bool deleteStreamIfOpeningFails);
 
+    /** For CAF files containing uncompressed linear PCM, this will return a reader that
+        maps the file directly. Compressed files (and anything other than CAF) can't be
+        mapped, so for those it returns nullptr, and you'll need to use createReaderFor().
+    */
+    MemoryMappedAudioFormatReader* createMemoryMappedReader (const File&);
+
     AudioFormatWriter* createWriterFor (OutputStream*,
                                         double sampleRateToUse,
                                         unsigned int numberOfChannels,
@@ -322,16 +322,7 @@ public:
         using namespace FlacNamespace;
         encoder = FLAC__stream_encoder_new();
 
-        if (qualityOptionIndex > 0)
-            FLAC__stream_encoder_set_compression_level (encoder, (uint32) jmin (8, qualityOptionIndex));
-
-        FLAC__stream_encoder_set_do_mid_side_stereo (encoder, numChannels == 2);
-        FLAC__stream_encoder_set_loose_mid_side_stereo (encoder, numChannels == 2);
-        FLAC__stream_encoder_set_channels (encoder, numChannels);
-        FLAC__stream_encoder_set_bits_per_sample (encoder, jmin ((unsigned int) 24, bitsPerSample));
-        FLAC__stream_encoder_set_sample_rate (encoder, (unsigned int) sampleRate);
-        FLAC__stream_encoder_set_blocksize (encoder, 0);
-        FLAC__stream_encoder_set_do_escape_coding (encoder, true);
+        setEncoderOptions (encoder, sampleRate, numChannels, bitsPerSample, qualityOptionIndex);
 
         ok = FLAC__stream_encoder_init_stream (encoder,
                                                encodeWriteCallback, encodeSeekCallback,
@@ -394,6 +385,24 @@ public:
         return output->write (data, (size_t) size);
     }
 
+    static void setEncoderOptions (FlacNamespace::FLAC__StreamEncoder* const encoder, const double sampleRate,
+                                   const unsigned int numChannels, const unsigned int bitsPerSample,
+                                   const int qualityOptionIndex)
+    {
+        using namespace FlacNamespace;
+
+        if (qualityOptionIndex > 0)
+            FLAC__stream_encoder_set_compression_level (encoder, (uint32) jmin (8, qualityOptionIndex));
+
+        FLAC__stream_encoder_set_do_mid_side_stereo (encoder, numChannels == 2);
+        FLAC__stream_encoder_set_loose_mid_side_stereo (encoder, numChannels == 2);
+        FLAC__stream_encoder_set_channels (encoder, numChannels);
+        FLAC__stream_encoder_set_bits_per_sample (encoder, jmin ((unsigned int) 24, bitsPerSample));
+        FLAC__stream_encoder_set_sample_rate (encoder, (unsigned int) sampleRate);
+        FLAC__stream_encoder_set_blocksize (encoder, 0);
+        FLAC__stream_encoder_set_do_escape_coding (encoder, true);
+    }
+
     static void packUint32 (FlacNamespace::FLAC__uint32 val, FlacNamespace::FLAC__byte* b, const int bytes)
     {
         b += bytes;
@@ -405,12 +414,9 @@ public:
         }
     }
 
-    void writeMetaData (const FlacNamespace::FLAC__StreamMetadata* metadata)
+    static void packStreamInfo (const FlacNamespace::FLAC__StreamMetadata_StreamInfo& info, unsigned char* const buffer)
     {
         using namespace FlacNamespace;
-        const FLAC__StreamMetadata_StreamInfo& info = metadata->data.stream_info;
-
-        unsigned char buffer [FLAC__STREAM_METADATA_STREAMINFO_LENGTH];
         const unsigned int channelsMinus1 = info.channels - 1;
         const unsigned int bitsMinus1 = info.bits_per_sample - 1;
 
@@ -424,6 +430,14 @@ public:
         buffer[13] = (FLAC__byte) (((bitsMinus1 & 0x0f) << 4) | (unsigned int) ((info.total_samples >> 32) & 0x0f));
         packUint32 ((FLAC__uint32) info.total_samples, buffer + 14, 4);
         memcpy (buffer + 18, info.md5sum, 16);
+    }
+
+    void writeMetaData (const FlacNamespace::FLAC__StreamMetadata* metadata)
+    {
+        using namespace FlacNamespace;
+
+        unsigned char buffer [FLAC__STREAM_METADATA_STREAMINFO_LENGTH];
+        packStreamInfo (metadata->data.stream_info, buffer);
 
         const bool seekOk = output->setPosition (4);
         (void) seekOk;
@@ -480,6 +494,521 @@ private:
 };
 
 
+//==============================================================================
+/*  Splits the incoming audio into chunks of whole frames and encodes each chunk
+    with its own FLAC encoder on a ThreadPool, then writes the chunks out in order.
+
+    Each encoder numbers its frames from zero, so before a chunk is written, its
+    frame headers are rewritten with the frame's position in the whole stream, and
+    their CRCs are recalculated. Because all the frames are the same size (apart from
+    the last one), the result is a normal fixed-blocksize FLAC stream.
+
+    A seek table with a fixed number of points is reserved after the STREAMINFO
+    block, and filled in along with the STREAMINFO when the writer is deleted. The
+    MD5 signature of the audio isn't calculated, and is left as zero, which tells
+    decoders not to check it.
+*/
+class ParallelFlacWriter  : public AudioFormatWriter
+{
+public:
+    //==============================================================================
+    ParallelFlacWriter (OutputStream* const out, double sampleRate_, uint32 numChannels_,
+                        uint32 bitsPerSample_, const int qualityOptionIndex_, ThreadPool& pool_)
+        : AudioFormatWriter (out, TRANS (flacFormatName), sampleRate_, numChannels_, bitsPerSample_),
+          pool (pool_),
+          qualityOptionIndex (qualityOptionIndex_),
+          blockSize (getBlockSizeForQuality (qualityOptionIndex_)),
+          maxJobsInProgress (SystemStats::getNumCpus() + 2),
+          headerPosition (out->getPosition()),
+          numBytesOfFrames (0),
+          numSamplesWritten (0),
+          nextFrameNumber (0),
+          minFrameSize (0),
+          maxFrameSize (0),
+          ok (true)
+    {
+        using namespace FlacNamespace;
+
+        // (the header is written now with space for the seek table and filled in at the end)
+        uint8 header [4 + 4 + FLAC__STREAM_METADATA_STREAMINFO_LENGTH + 4] = { 'f', 'L', 'a', 'C' };
+        header[4] = FLAC__METADATA_TYPE_STREAMINFO;
+        FlacWriter::packUint32 (FLAC__STREAM_METADATA_STREAMINFO_LENGTH, header + 5, 3);
+
+        uint8* const seekTableHeader = header + 8 + FLAC__STREAM_METADATA_STREAMINFO_LENGTH;
+        seekTableHeader[0] = (uint8) (0x80 | FLAC__METADATA_TYPE_SEEKTABLE);  // (this is the last metadata block)
+        FlacWriter::packUint32 (numSeekPoints * seekPointSize, seekTableHeader + 1, 3);
+
+        ok = output->write (header, sizeof (header))
+              && writeSeekTable (Array<FrameInfo>());
+    }
+
+    ~ParallelFlacWriter()
+    {
+        if (currentJob != nullptr && currentJob->numSamples > 0)
+            startJob();
+
+        while (jobsInProgress.size() > 0)
+            writeFirstJob();
+
+        if (ok)
+        {
+            using namespace FlacNamespace;
+
+            FLAC__StreamMetadata_StreamInfo info;
+            zerostruct (info);
+            info.min_blocksize   = (uint32) blockSize;
+            info.max_blocksize   = (uint32) blockSize;
+            info.min_framesize   = (uint32) minFrameSize;
+            info.max_framesize   = (uint32) maxFrameSize;
+            info.sample_rate     = (uint32) sampleRate;
+            info.channels        = numChannels;
+            info.bits_per_sample = jmin ((unsigned int) 24, bitsPerSample);
+            info.total_samples   = (FLAC__uint64) numSamplesWritten;
+
+            uint8 buffer [FLAC__STREAM_METADATA_STREAMINFO_LENGTH];
+            FlacWriter::packStreamInfo (info, buffer);
+
+            const int64 endPosition = output->getPosition();
+            const bool seekOk = output->setPosition (headerPosition + 8);
+            (void) seekOk;
+
+            // if this fails, you've given it an output stream that can't seek! It needs
+            // to be able to seek back to write the header
+            jassert (seekOk);
+
+            output->write (buffer, sizeof (buffer));
+            output->setPosition (headerPosition + 8 + FLAC__STREAM_METADATA_STREAMINFO_LENGTH + 4);
+            writeSeekTable (frames);
+            output->setPosition (endPosition);
+            output->flush();
+        }
+    }
+
+    //==============================================================================
+    bool write (const int** samplesToWrite, int numSamples)
+    {
+        const int bitsToShift = 32 - (int) bitsPerSample;
+        int offset = 0;
+
+        while (ok && numSamples > 0)
+        {
+            if (currentJob == nullptr)
+                currentJob = getFreeJob();
+
+            const int numToCopy = jmin (numSamples, currentJob->getMaxNumSamples() - currentJob->numSamples);
+            bool hitEmptyChannel = false;
+
+            for (unsigned int i = 0; i < numChannels; ++i)
+            {
+                int* const dest = currentJob->getChannel ((int) i) + currentJob->numSamples;
+
+                if (hitEmptyChannel || samplesToWrite[i] == nullptr)
+                {
+                    hitEmptyChannel = true;
+                    zeromem (dest, sizeof (int) * (size_t) numToCopy);
+                }
+                else
+                {
+                    const int* const src = samplesToWrite[i] + offset;
+
+                    for (int j = 0; j < numToCopy; ++j)
+                        dest[j] = (src[j] >> bitsToShift);
+                }
+            }
+
+            currentJob->numSamples += numToCopy;
+            offset += numToCopy;
+            numSamples -= numToCopy;
+
+            if (currentJob->numSamples == currentJob->getMaxNumSamples())
+                startJob();
+        }
+
+        return ok;
+    }
+
+private:
+    //==============================================================================
+    struct FrameInfo
+    {
+        int64 sampleNumber, byteOffset;
+        int numSamples;
+    };
+
+    //==============================================================================
+    class EncoderJob  : public ThreadPoolJob
+    {
+    public:
+        EncoderJob (const ParallelFlacWriter& owner_)
+            : ThreadPoolJob ("FLAC encoder"),
+              owner (owner_),
+              numSamples (0),
+              firstFrameNumber (0),
+              failed (false),
+              encoder (FlacNamespace::FLAC__stream_encoder_new()),
+              maxNumSamples (owner_.blockSize * framesPerJob),
+              buffer (owner_.numChannels * (size_t) maxNumSamples)
+        {
+        }
+
+        ~EncoderJob()
+        {
+            FlacNamespace::FLAC__stream_encoder_delete (encoder);
+        }
+
+        int getMaxNumSamples() const noexcept           { return maxNumSamples; }
+        int* getChannel (const int channel) noexcept    { return buffer + channel * (size_t) maxNumSamples; }
+
+        void reset() noexcept
+        {
+            numSamples = 0;
+            failed = false;
+            encodedFrames.reset();
+            frameSizes.clearQuick();
+        }
+
+        JobStatus runJob()
+        {
+            using namespace FlacNamespace;
+
+            encodedFrames.reset();
+            frameSizes.clearQuick();
+
+            FlacWriter::setEncoderOptions (encoder, owner.sampleRate, owner.numChannels,
+                                           owner.bitsPerSample, owner.qualityOptionIndex);
+            FLAC__stream_encoder_set_blocksize (encoder, (unsigned int) owner.blockSize);
+            FLAC__stream_encoder_set_do_md5 (encoder, false);
+
+            failed = FLAC__stream_encoder_init_stream (encoder, encodeWriteCallback, nullptr, nullptr, nullptr, this)
+                        != FLAC__STREAM_ENCODER_INIT_STATUS_OK;
+
+            if (! failed)
+            {
+                HeapBlock<const FLAC__int32*> channels (owner.numChannels);
+
+                for (unsigned int i = 0; i < owner.numChannels; ++i)
+                    channels[i] = getChannel ((int) i);
+
+                failed = FLAC__stream_encoder_process (encoder, channels, (unsigned int) numSamples) == 0;
+                failed = (FLAC__stream_encoder_finish (encoder) == 0) || failed;
+            }
+
+            return jobHasFinished;
+        }
+
+        const ParallelFlacWriter& owner;
+        int numSamples;
+        int64 firstFrameNumber;
+        bool failed;
+
+        MemoryOutputStream encodedFrames;
+        Array<int> frameSizes;
+
+    private:
+        FlacNamespace::FLAC__StreamEncoder* encoder;
+        const int maxNumSamples;
+        HeapBlock<int> buffer;
+
+        bool addFrame (const uint8* const data, const size_t size)
+        {
+            const int64 frameNumber = firstFrameNumber + frameSizes.size();
+            const int64 startPos = encodedFrames.getPosition();
+
+            if (! renumberFrame (data, size, frameNumber, encodedFrames))
+                return false;
+
+            frameSizes.add ((int) (encodedFrames.getPosition() - startPos));
+            return true;
+        }
+
+        static FlacNamespace::FLAC__StreamEncoderWriteStatus encodeWriteCallback (const FlacNamespace::FLAC__StreamEncoder*,
+                                                                                  const FlacNamespace::FLAC__byte buffer[],
+                                                                                  size_t bytes,
+                                                                                  unsigned int samples,
+                                                                                  unsigned int /*current_frame*/,
+                                                                                  void* client_data)
+        {
+            using namespace FlacNamespace;
+
+            // (the stream marker and metadata come through with no samples - they're written
+            // by the ParallelFlacWriter instead)
+            if (samples == 0 || static_cast <EncoderJob*> (client_data)->addFrame (buffer, bytes))
+                return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+
+            return FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (EncoderJob)
+    };
+
+    //==============================================================================
+    ThreadPool& pool;
+    const int qualityOptionIndex, blockSize, maxJobsInProgress;
+    const int64 headerPosition;
+    int64 numBytesOfFrames, numSamplesWritten, nextFrameNumber;
+    int minFrameSize, maxFrameSize;
+    bool ok;
+
+    ScopedPointer<EncoderJob> currentJob;
+    OwnedArray<EncoderJob> jobsInProgress, freeJobs;
+    Array<FrameInfo> frames;
+
+    enum
+    {
+        framesPerJob = 32,
+        numSeekPoints = 128,
+        seekPointSize = 18
+    };
+
+    static int getBlockSizeForQuality (const int qualityOptionIndex)
+    {
+        using namespace FlacNamespace;
+
+        // (this is the block size that libFLAC would pick for this compression level)
+        FLAC__StreamEncoder* const encoder = FLAC__stream_encoder_new();
+
+        if (qualityOptionIndex > 0)
+            FLAC__stream_encoder_set_compression_level (encoder, (uint32) jmin (8, qualityOptionIndex));
+
+        const int size = FLAC__stream_encoder_get_max_lpc_order (encoder) == 0 ? 1152 : 4096;
+        FLAC__stream_encoder_delete (encoder);
+        return size;
+    }
+
+    EncoderJob* getFreeJob()
+    {
+        if (freeJobs.size() > 0)
+            return freeJobs.removeAndReturn (freeJobs.size() - 1);
+
+        return new EncoderJob (*this);
+    }
+
+    void startJob()
+    {
+        const int numFrames = (currentJob->numSamples + blockSize - 1) / blockSize;
+
+        currentJob->firstFrameNumber = nextFrameNumber;
+        nextFrameNumber += numFrames;
+
+        EncoderJob* const job = currentJob.release();
+        jobsInProgress.add (job);
+        pool.addJob (job, false);
+
+        while (jobsInProgress.size() >= maxJobsInProgress
+                || (jobsInProgress.size() > 0 && ! pool.contains (jobsInProgress.getFirst())))
+            writeFirstJob();
+    }
+
+    void writeFirstJob()
+    {
+        EncoderJob* const job = jobsInProgress.getFirst();
+        pool.waitForJobToFinish (job, -1);
+
+        if (job->failed)
+            ok = false;
+
+        if (ok)
+        {
+            int64 sampleNumber = numSamplesWritten;
+            int64 byteOffset = numBytesOfFrames;
+            int samplesLeft = job->numSamples;
+
+            for (int i = 0; i < job->frameSizes.size(); ++i)
+            {
+                const int frameSize = job->frameSizes.getUnchecked (i);
+                const FrameInfo info = { sampleNumber, byteOffset, jmin (blockSize, samplesLeft) };
+                frames.add (info);
+
+                minFrameSize = (minFrameSize == 0) ? frameSize : jmin (minFrameSize, frameSize);
+                maxFrameSize = jmax (maxFrameSize, frameSize);
+
+                sampleNumber += info.numSamples;
+                byteOffset += frameSize;
+                samplesLeft -= info.numSamples;
+            }
+
+            ok = output->write (job->encodedFrames.getData(), job->encodedFrames.getDataSize());
+            numBytesOfFrames = byteOffset;
+            numSamplesWritten += job->numSamples;
+        }
+
+        job->reset();
+        freeJobs.add (jobsInProgress.removeAndReturn (0));
+    }
+
+    bool writeSeekTable (const Array<FrameInfo>& frameList)
+    {
+        MemoryOutputStream table ((size_t) (numSeekPoints * seekPointSize));
+        int numPointsWritten = 0;
+
+        if (frameList.size() > 0)
+        {
+            int frameIndex = 0, lastFrameIndex = -1;
+
+            // (the points are spread evenly through the stream, each one at the start of
+            // the frame containing its target sample)
+            for (int i = 0; i < numSeekPoints; ++i)
+            {
+                const int64 targetSample = numSamplesWritten * i / numSeekPoints;
+
+                while (frameIndex < frameList.size() - 1
+                        && frameList.getReference (frameIndex + 1).sampleNumber <= targetSample)
+                    ++frameIndex;
+
+                if (frameIndex != lastFrameIndex)
+                {
+                    const FrameInfo& f = frameList.getReference (frameIndex);
+
+                    table.writeInt64BigEndian (f.sampleNumber);
+                    table.writeInt64BigEndian (f.byteOffset);
+                    table.writeShortBigEndian ((short) f.numSamples);
+
+                    lastFrameIndex = frameIndex;
+                    ++numPointsWritten;
+                }
+            }
+        }
+
+        // any unused points are left as placeholders
+        for (int i = numPointsWritten; i < numSeekPoints; ++i)
+        {
+            table.writeInt64BigEndian (-1);
+            table.writeInt64BigEndian (0);
+            table.writeShortBigEndian (0);
+        }
+
+        return output->write (table.getData(), table.getDataSize());
+    }
+
+    //==============================================================================
+    // These rewrite the frame number in a frame's header, which means recalculating
+    // the header's CRC-8 and the whole frame's CRC-16.
+    struct CRCTables
+    {
+        CRCTables() noexcept
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                uint8 c8 = (uint8) i;
+                uint16 c16 = (uint16) (i << 8);
+
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    c8  = (uint8)  ((c8 & 0x80) != 0    ? ((c8 << 1) ^ 0x07)    : (c8 << 1));
+                    c16 = (uint16) ((c16 & 0x8000) != 0 ? ((c16 << 1) ^ 0x8005) : (c16 << 1));
+                }
+
+                crc8[i] = c8;
+                crc16[i] = c16;
+            }
+        }
+
+        uint8 crc8 [256];
+        uint16 crc16 [256];
+    };
+
+    static const CRCTables& getCRCTables() noexcept
+    {
+        static const CRCTables tables;
+        return tables;
+    }
+
+    static uint8 updateCRC8 (uint8 crc, const uint8* data, size_t num) noexcept
+    {
+        const uint8* const table = getCRCTables().crc8;
+
+        while (num-- > 0)
+            crc = table [crc ^ *data++];
+
+        return crc;
+    }
+
+    static uint16 updateCRC16 (uint16 crc, const uint8* data, size_t num) noexcept
+    {
+        const uint16* const table = getCRCTables().crc16;
+
+        while (num-- > 0)
+            crc = (uint16) ((crc << 8) ^ table [(crc >> 8) ^ *data++]);
+
+        return crc;
+    }
+
+    static int getCodedNumberLength (const uint8 firstByte) noexcept
+    {
+        int numLeadingOnes = 0;
+
+        while (numLeadingOnes < 8 && (firstByte & (0x80 >> numLeadingOnes)) != 0)
+            ++numLeadingOnes;
+
+        return numLeadingOnes == 0 ? 1 : numLeadingOnes;
+    }
+
+    static int writeCodedNumber (const int64 value, uint8* const dest) noexcept
+    {
+        if (value < 0x80)
+        {
+            dest[0] = (uint8) value;
+            return 1;
+        }
+
+        int numBytes = 2;
+        while (numBytes < 7 && value >= ((int64) 1 << (5 * numBytes + 1)))
+            ++numBytes;
+
+        dest[0] = (uint8) ((0xff00 >> numBytes) | (int) (value >> (6 * (numBytes - 1))));
+
+        for (int i = 1; i < numBytes; ++i)
+            dest[i] = (uint8) (0x80 | ((value >> (6 * (numBytes - 1 - i))) & 0x3f));
+
+        return numBytes;
+    }
+
+    static bool renumberFrame (const uint8* const frame, const size_t frameSize,
+                               const int64 frameNumber, OutputStream& dest)
+    {
+        if (frameSize < 8)
+            return false;
+
+        const int numberLength = getCodedNumberLength (frame[4]);
+        const int blockSizeCode = frame[2] >> 4;
+        const int sampleRateCode = frame[2] & 0x0f;
+
+        int extraBytes = 0;
+        if (blockSizeCode == 6)             extraBytes += 1;
+        else if (blockSizeCode == 7)        extraBytes += 2;
+        if (sampleRateCode == 12)           extraBytes += 1;
+        else if (sampleRateCode == 13
+                  || sampleRateCode == 14)  extraBytes += 2;
+
+        const size_t oldHeaderSize = (size_t) (4 + numberLength + extraBytes);
+
+        if (oldHeaderSize + 3 > frameSize)
+            return false;
+
+        uint8 header [4 + 7 + 4 + 1];
+        memcpy (header, frame, 4);
+        size_t headerSize = 4 + (size_t) writeCodedNumber (frameNumber, header + 4);
+        memcpy (header + headerSize, frame + 4 + numberLength, (size_t) extraBytes);
+        headerSize += (size_t) extraBytes;
+        header[headerSize] = updateCRC8 (0, header, headerSize);
+        ++headerSize;
+
+        const uint8* const body = frame + oldHeaderSize + 1;
+        const size_t bodySize = frameSize - (oldHeaderSize + 1) - 2;
+
+        const uint16 crc = updateCRC16 (updateCRC16 (0, header, headerSize), body, bodySize);
+
+        if (! (dest.write (header, headerSize) && dest.write (body, bodySize)))
+            return false;
+
+        dest.writeShortBigEndian ((short) crc);
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelFlacWriter)
+};
+
+
 //==============================================================================
 FlacAudioFormat::FlacAudioFormat()
     : AudioFormat (TRANS (flacFormatName), StringArray (flacExtensions))
@@ -509,6 +1038,11 @@ bool FlacAudioFormat::canDoStereo()     { return true; }
 bool FlacAudioFormat::canDoMono()       { return true; }
 bool FlacAudioFormat::isCompressed()    { return true; }
 
+bool FlacAudioFormat::canHandleHeader (const void* headerData, const int numBytes)
+{
+    return numBytes >= 4 && memcmp (headerData, "fLaC", 4) == 0;
+}
+
 AudioFormatReader* FlacAudioFormat::createReaderFor (InputStream* in, const bool deleteStreamIfOpeningFails)
 {
     ScopedPointer<FlacReader> r (new FlacReader (in));
@@ -540,6 +1074,20 @@ AudioFormatWriter* FlacAudioFormat::createWriterFor (OutputStream* out,
     return nullptr;
 }
 
+AudioFormatWriter* FlacAudioFormat::createParallelWriterFor (OutputStream* out,
+                                                             double sampleRate,
+                                                             unsigned int numberOfChannels,
+                                                             int bitsPerSample,
+                                                             int qualityOptionIndex,
+                                                             ThreadPool& threadPool)
+{
+    if (getPossibleBitDepths().contains (bitsPerSample))
+        return new ParallelFlacWriter (out, sampleRate, numberOfChannels,
+                                       (uint32) bitsPerSample, qualityOptionIndex, threadPool);
+
+    return nullptr;
+}
+
 StringArray FlacAudioFormat::getQualityOptions()
 {
     const char* options[] = { "0 (Fastest)", "1", "2", "3", "4", "5 (Default)","6", "7", "8 (Highest quality)", 0 };
@@ -49,6 +49,8 @@ public:
     StringArray getQualityOptions();
 
     //==============================================================================
+    bool canHandleHeader (const void* headerData, int numBytes);
+
     AudioFormatReader* createReaderFor (InputStream* sourceStream,
                                         bool deleteStreamIfOpeningFails);
 
@@ -58,6 +60,27 @@ public:
                                         int bitsPerSample,
                                         const StringPairArray& metadataValues,
                                         int qualityOptionIndex);
+
+    /** Creates a writer that encodes its frames in parallel on a ThreadPool.
+
+        The audio is split into chunks of whole frames, which are encoded independently
+        by the pool's threads and then written to the stream in order, so on a multi-core
+        machine this is much faster than the writer returned by createWriterFor(). The
+        file also gets a seek table.
+
+        The stream must be seekable, because the header is filled in when the writer is
+        deleted. The MD5 signature in the header isn't calculated, and is left empty.
+
+        The pool must stay alive for as long as the writer exists, and it can be shared
+        with other jobs. Returns nullptr if the bit depth isn't supported.
+    */
+    AudioFormatWriter* createParallelWriterFor (OutputStream* streamToWriteTo,
+                                                double sampleRateToUse,
+                                                unsigned int numberOfChannels,
+                                                int bitsPerSample,
+                                                int qualityOptionIndex,
+                                                ThreadPool& threadPool);
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacAudioFormat)
 };
@@ -25,7 +25,8 @@
 
 #if JUCE_USE_LAME_AUDIO_FORMAT
 
-class LAMEEncoderAudioFormat::Writer   : public AudioFormatWriter
+class LAMEEncoderAudioFormat::Writer   : public AudioFormatWriter,
+                                         private Thread
 {
 public:
     Writer (OutputStream* destStream, const String& formatName,
@@ -34,106 +35,130 @@ public:
             unsigned int bitsPerSample, const StringPairArray& metadata)
         : AudioFormatWriter (destStream, formatName, sampleRate,
                              numberOfChannels, bitsPerSample),
-          vbrLevel (vbr), cbrBitrate (cbr),
-          tempWav (".wav")
+          Thread ("LAME encoder output"),
+          vbrLevel (vbr), cbrBitrate (cbr)
     {
-        WavAudioFormat wavFormat;
+        StringArray args;
+        args.add (lameApp.getFullPathName());
 
-        if (FileOutputStream* out = tempWav.getFile().createOutputStream())
+        args.add ("--quiet");
+
+        if (cbrBitrate == 0)
+        {
+            args.add ("-vbr-new");
+            args.add ("-V");
+            args.add (String (vbrLevel));
+        }
+        else
         {
-            writer = wavFormat.createWriterFor (out, sampleRate, numChannels,
-                                                bitsPerSample, metadata, 0);
+            args.add ("--cbr");
+            args.add ("-b");
+            args.add (String (cbrBitrate));
+        }
 
-            args.add (lameApp.getFullPathName());
+        addMetadataArg (args, metadata, "id3title",       "--tt");
+        addMetadataArg (args, metadata, "id3artist",      "--ta");
+        addMetadataArg (args, metadata, "id3album",       "--tl");
+        addMetadataArg (args, metadata, "id3comment",     "--tc");
+        addMetadataArg (args, metadata, "id3date",        "--ty");
+        addMetadataArg (args, metadata, "id3genre",       "--tg");
+        addMetadataArg (args, metadata, "id3trackNumber", "--tn");
+
+        // The audio is piped to the encoder as raw 16-bit little-endian PCM, and the
+        // encoded data is read back from its stdout as it's produced.
+        args.add ("-r");
+        args.add ("-s");
+        args.add (String (sampleRate / 1000.0));
+        args.add ("--bitwidth");
+        args.add ("16");
+        args.add ("--signed");
+        args.add ("--little-endian");
+        args.add ("-m");
+        args.add (numChannels == 1 ? "m" : "j");
+        args.add ("-");
+        args.add ("-");
+
+        if (lame.start (args, ChildProcess::wantStdOut | ChildProcess::wantStdIn))
+            startThread();
+    }
 
-            args.add ("--quiet");
+    ~Writer()
+    {
+        lame.closeProcessInput();
 
-            if (cbrBitrate == 0)
-            {
-                args.add ("-vbr-new");
-                args.add ("-V");
-                args.add (String (vbrLevel));
-            }
-            else
+        if (isThreadRunning())
+        {
+            // the encoder finishes and closes its output once it has seen the end of its input
+            if (! waitForThreadToExit (60000))
             {
-                args.add ("--cbr");
-                args.add ("-b");
-                args.add (String (cbrBitrate));
+                lame.kill();
+                stopThread (5000);
             }
 
-            addMetadataArg (metadata, "id3title",       "--tt");
-            addMetadataArg (metadata, "id3artist",      "--ta");
-            addMetadataArg (metadata, "id3album",       "--tl");
-            addMetadataArg (metadata, "id3comment",     "--tc");
-            addMetadataArg (metadata, "id3date",        "--ty");
-            addMetadataArg (metadata, "id3genre",       "--tg");
-            addMetadataArg (metadata, "id3trackNumber", "--tn");
+            output->flush();
         }
     }
 
-    void addMetadataArg (const StringPairArray& metadata, const char* key, const char* lameFlag)
+    bool write (const int** samplesToWrite, int numSamples)
     {
-        const String value (metadata.getValue (key, String::empty));
+        if (! isThreadRunning())
+            return false;
 
-        if (value.isNotEmpty())
-        {
-            args.add (lameFlag);
-            args.add (value);
-        }
-    }
+        typedef AudioData::Pointer <AudioData::Int16, AudioData::LittleEndian, AudioData::Interleaved,    AudioData::NonConst> DestType;
+        typedef AudioData::Pointer <AudioData::Int32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const>    SourceType;
 
-    ~Writer()
-    {
-        if (writer != nullptr)
+        const size_t bytesNeeded = (size_t) numSamples * numChannels * sizeof (int16);
+
+        if (pcmBlock.getSize() < bytesNeeded)
+            pcmBlock.setSize (bytesNeeded, false);
+
+        bool channelsFinished = false;
+
+        for (int i = 0; i < (int) numChannels; ++i)
         {
-            writer = nullptr;
+            DestType dest (addBytesToPointer (pcmBlock.getData(), i * (int) sizeof (int16)), (int) numChannels);
 
-            if (! convertToMP3())
-                convertToMP3(); // try again
+            channelsFinished = channelsFinished || samplesToWrite[i] == nullptr;
+
+            if (channelsFinished)
+                dest.clearSamples (numSamples);
+            else
+                dest.convertSamples (SourceType (samplesToWrite[i]), numSamples);
         }
-    }
 
-    bool write (const int** samplesToWrite, int numSamples)
-    {
-        return writer != nullptr && writer->write (samplesToWrite, numSamples);
+        return lame.writeProcessInput (pcmBlock.getData(), (int) bytesNeeded) == (int) bytesNeeded;
     }
 
 private:
     int vbrLevel, cbrBitrate;
-    TemporaryFile tempWav;
-    ScopedPointer<AudioFormatWriter> writer;
-    StringArray args;
+    ChildProcess lame;
+    MemoryBlock pcmBlock;
 
-    bool convertToMP3() const
+    static void addMetadataArg (StringArray& args, const StringPairArray& metadata,
+                                const char* key, const char* lameFlag)
     {
-        TemporaryFile tempMP3 (".mp3");
-
-        StringArray args2 (args);
-        args2.add (tempWav.getFile().getFullPathName());
-        args2.add (tempMP3.getFile().getFullPathName());
+        const String value (metadata.getValue (key, String::empty));
 
-        ChildProcess cp;
+        if (value.isNotEmpty())
+        {
+            args.add (lameFlag);
+            args.add (value);
+        }
+    }
 
-        DBG (args2.joinIntoString(" "));
+    void run()
+    {
+        HeapBlock<char> buffer (8192);
 
-        if (cp.start (args2))
+        while (! threadShouldExit())
         {
-            String childOutput (cp.readAllProcessOutput());
-            DBG (childOutput);
+            const int numRead = lame.readProcessOutput (buffer, 8192);
 
-            if (tempMP3.getFile().getSize() > 0)
-            {
-                FileInputStream fis (tempMP3.getFile());
+            if (numRead <= 0)
+                break;
 
-                if (fis.openedOk() && output->writeFromInputStream (fis, -1) > 0)
-                {
-                    output->flush();
-                    return true;
-                }
-            }
+            output->write (buffer, (size_t) numRead);
         }
-
-        return false;
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Writer)
@@ -31,11 +31,14 @@
     encoder to encode a file.
 
     This format can't read mp3s, it just writes them. Internally, the
-    AudioFormatWriter object that is returned writes the incoming audio data
-    to a temporary WAV file, and then when the writer is deleted, it invokes
-    the LAME executable to convert the data to an MP3, whose data is then
-    piped into the original OutputStream that was used when first creating
-    the writer.
+    AudioFormatWriter object that is returned launches the LAME executable
+    as soon as it's created, and pipes the incoming audio data into it as
+    raw PCM. The MP3 data is read back on a background thread and written to
+    the original OutputStream as the encoder produces it, so nothing goes via
+    temporary files, and each writer can encode in parallel with any others.
+
+    The OutputStream is written to from that background thread until the
+    writer is deleted, so you mustn't use it yourself in the meantime.
 
     @see AudioFormat
 */
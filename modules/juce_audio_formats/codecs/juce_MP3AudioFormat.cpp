@@ -1557,6 +1557,11 @@ struct MP3Stream
 
         while (frameIndex >= frameStreamPositions.size() * storedStartPosInterval)
         {
+            // Once the first frame has been found, it's much quicker to hop from one
+            // frame header to the next than to decode all the frames in between..
+            if (frameStreamPositions.size() > 0 && skipFrameHeadersUntil (frameIndex))
+                break;
+
             int dummy = 0;
             const int result = decodeNextBlock (nullptr, nullptr, dummy);
 
@@ -1575,6 +1580,51 @@ struct MP3Stream
         return true;
     }
 
+    void findAllFramePositions()
+    {
+        seek (std::numeric_limits<int>::max() - storedStartPosInterval);
+    }
+
+    void getSeekTable (MemoryBlock& destData)
+    {
+        MemoryOutputStream out (destData, false);
+        out.writeInt (seekTableMagic);
+        out.writeInt64 (stream.getTotalLength());
+        out.writeInt (frameStreamPositions.size());
+
+        for (int i = 0; i < frameStreamPositions.size(); ++i)
+            out.writeInt64 (frameStreamPositions.getUnchecked (i));
+    }
+
+    bool setSeekTable (const MemoryBlock& data)
+    {
+        MemoryInputStream in (data, false);
+
+        if (in.readInt() != seekTableMagic
+             || in.readInt64() != stream.getTotalLength())
+            return false;
+
+        const int numEntries = in.readInt();
+
+        if (numEntries <= 0 || in.getNumBytesRemaining() < numEntries * (int64) sizeof (int64))
+            return false;
+
+        Array<int64> positions;
+        positions.ensureStorageAllocated (numEntries);
+
+        for (int i = 0; i < numEntries; ++i)
+            positions.add (in.readInt64());
+
+        // (if the stream doesn't start in the same place, this table must be for some other file)
+        if (frameStreamPositions.size() == 0 || positions.getFirst() != frameStreamPositions.getFirst())
+            return false;
+
+        if (positions.size() > frameStreamPositions.size())
+            frameStreamPositions.swapWithArray (positions);
+
+        return true;
+    }
+
     MP3Frame frame;
     VBRTagData vbrTagData;
     BufferedInputStream stream;
@@ -1614,7 +1664,7 @@ private:
         zeromem (synthBuffers, sizeof (synthBuffers));
     }
 
-    enum { storedStartPosInterval = 4 };
+    enum { storedStartPosInterval = 4, seekTableMagic = 0x6d703373 };
     Array<int64> frameStreamPositions;
 
     struct SideInfoLayer1
@@ -1737,6 +1787,35 @@ private:
         return offset;
     }
 
+    bool skipFrameHeadersUntil (const int frameIndex)
+    {
+        const int lastKnownPosition = frameStreamPositions.size() - 1;
+        stream.setPosition (frameStreamPositions.getUnchecked (lastKnownPosition));
+        currentFrameIndex = lastKnownPosition * storedStartPosInterval;
+
+        while (frameIndex >= frameStreamPositions.size() * storedStartPosInterval)
+        {
+            // (this records the position of each frame as it's found)
+            const int offset = scanForNextFrameHeader (false);
+
+            if (offset < 0)
+                break;
+
+            stream.skipNextBytes (offset);
+
+            MP3Frame nextFrame;
+            nextFrame.decodeHeader ((uint32) stream.readIntBigEndian());
+
+            if (nextFrame.frameSize <= 0)
+                break; // free-format frames have to be decoded to find their size
+
+            stream.skipNextBytes (nextFrame.frameSize);
+        }
+
+        reset();
+        return frameIndex < frameStreamPositions.size() * storedStartPosInterval;
+    }
+
     void readVBRHeader()
     {
         int64 oldPos = stream.getPosition();
@@ -3026,6 +3105,16 @@ public:
         return true;
     }
 
+    //==============================================================================
+    void buildSeekTable()
+    {
+        stream.findAllFramePositions();
+        currentPosition = -1; // (forces the next read to seek)
+    }
+
+    void getSeekTable (MemoryBlock& destData)           { stream.getSeekTable (destData); }
+    bool setSeekTable (const MemoryBlock& data)         { return stream.setSeekTable (data); }
+
 private:
     MP3Stream stream;
     int64 currentPosition;
@@ -3125,6 +3214,15 @@ bool MP3AudioFormat::canDoMono()                    { return true; }
 bool MP3AudioFormat::isCompressed()                 { return true; }
 StringArray MP3AudioFormat::getQualityOptions()     { return StringArray(); }
 
+bool MP3AudioFormat::canHandleHeader (const void* headerData, const int numBytes)
+{
+    const uint8* const d = static_cast <const uint8*> (headerData);
+
+    // either an ID3v2 tag, or an mpeg frame sync right at the start
+    return numBytes >= 3
+            && (memcmp (d, "ID3", 3) == 0 || (d[0] == 0xff && (d[1] & 0xe0) == 0xe0));
+}
+
 AudioFormatReader* MP3AudioFormat::createReaderFor (InputStream* sourceStream, const bool deleteStreamIfOpeningFails)
 {
     ScopedPointer<MP3Decoder::MP3Reader> r (new MP3Decoder::MP3Reader (sourceStream));
@@ -3138,6 +3236,36 @@ AudioFormatReader* MP3AudioFormat::createReaderFor (InputStream* sourceStream, c
     return nullptr;
 }
 
+bool MP3AudioFormat::buildSeekTable (AudioFormatReader& reader)
+{
+    if (MP3Decoder::MP3Reader* const r = dynamic_cast <MP3Decoder::MP3Reader*> (&reader))
+    {
+        r->buildSeekTable();
+        return true;
+    }
+
+    return false;
+}
+
+bool MP3AudioFormat::getSeekTable (AudioFormatReader& reader, MemoryBlock& destData)
+{
+    if (MP3Decoder::MP3Reader* const r = dynamic_cast <MP3Decoder::MP3Reader*> (&reader))
+    {
+        r->getSeekTable (destData);
+        return true;
+    }
+
+    return false;
+}
+
+bool MP3AudioFormat::setSeekTable (AudioFormatReader& reader, const MemoryBlock& seekTableData)
+{
+    if (MP3Decoder::MP3Reader* const r = dynamic_cast <MP3Decoder::MP3Reader*> (&reader))
+        return r->setSeekTable (seekTableData);
+
+    return false;
+}
+
 AudioFormatWriter* MP3AudioFormat::createWriterFor (OutputStream*, double /*sampleRateToUse*/,
                                                     unsigned int /*numberOfChannels*/, int /*bitsPerSample*/,
                                                     const StringPairArray& /*metadataValues*/, int /*qualityOptionIndex*/)
@@ -55,11 +55,44 @@ public:
     StringArray getQualityOptions();
 
     //==============================================================================
+    bool canHandleHeader (const void* headerData, int numBytes);
+
     AudioFormatReader* createReaderFor (InputStream*, bool deleteStreamIfOpeningFails);
 
     AudioFormatWriter* createWriterFor (OutputStream*, double sampleRateToUse,
                                         unsigned int numberOfChannels, int bitsPerSample,
                                         const StringPairArray& metadataValues, int qualityOptionIndex);
+
+    //==============================================================================
+    /** Finds the positions of all the frames in a file opened by one of these formats.
+
+        A reader only knows where the frames are in the parts of the file that it has
+        already read through, so the first seek past that point has to scan forward to find
+        its target. Calling this does the whole scan in one go (e.g. on a background thread
+        when a file is first opened), so that all later seeks are quick.
+
+        Returns false if the reader wasn't created by an MP3AudioFormat.
+        @see getSeekTable, setSeekTable
+    */
+    static bool buildSeekTable (AudioFormatReader& reader);
+
+    /** Saves the positions of the frames that a reader has found so far.
+
+        The data can be stored (e.g. alongside a thumbnail for the file) and given back to
+        setSeekTable() when the file is opened again, to avoid having to scan it again.
+
+        Returns false if the reader wasn't created by an MP3AudioFormat.
+        @see setSeekTable, buildSeekTable
+    */
+    static bool getSeekTable (AudioFormatReader& reader, MemoryBlock& destData);
+
+    /** Gives a reader a table of frame positions that was saved earlier by getSeekTable().
+
+        Returns false if the reader wasn't created by an MP3AudioFormat, or if the data
+        doesn't seem to belong to the same file.
+        @see getSeekTable, buildSeekTable
+    */
+    static bool setSeekTable (AudioFormatReader& reader, const MemoryBlock& seekTableData);
 };
 
 #endif
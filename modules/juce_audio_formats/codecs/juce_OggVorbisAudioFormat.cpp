@@ -103,14 +103,20 @@ const char* const OggVorbisAudioFormat::id3trackNumber = "id3trackNumber";
 
 
 //==============================================================================
-class OggReader : public AudioFormatReader
+class OggReader : public AudioFormatReader,
+                  private TimeSliceClient
 {
 public:
     OggReader (InputStream* const inp)
         : AudioFormatReader (inp, TRANS (oggFormatName)),
           reservoir (2, 4096),
           reservoirStart (0),
-          samplesInReservoir (0)
+          samplesInReservoir (0),
+          readAheadBuffer (1, 1),
+          readAheadFifo (1),
+          readAheadThread (nullptr),
+          readPosition (0),
+          decodePosition (0)
     {
         using namespace OggVorbisNamespace;
         sampleRate = 0;
@@ -138,12 +144,125 @@ public:
 
     ~OggReader()
     {
+        if (readAheadThread != nullptr)
+            readAheadThread->removeTimeSliceClient (this);
+
         OggVorbisNamespace::ov_clear (&ovFile);
     }
 
+    //==============================================================================
+    /** Makes the reader keep a ring buffer of decoded samples ahead of the read
+        position, which the given thread fills in the background.
+    */
+    void startReadAhead (TimeSliceThread& thread, const int numSamplesToBuffer)
+    {
+        jassert (readAheadThread == nullptr);
+
+        readAheadBuffer.setSize ((int) numChannels, numSamplesToBuffer + 1);
+        readAheadFifo.setTotalSize (numSamplesToBuffer + 1);
+        readPosition = decodePosition = OggVorbisNamespace::ov_pcm_tell (&ovFile);
+
+        readAheadThread = &thread;
+        thread.addTimeSliceClient (this);
+    }
+
     //==============================================================================
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples)
+    {
+        // (the samples are floats, so the decoder can write them straight into these)
+        float* const* const dest = reinterpret_cast <float* const*> (destSamples);
+
+        if (readAheadThread != nullptr)
+            readFromReadAheadBuffer (dest, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+        else
+            readFromDecoder (dest, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+
+        if (numSamples > 0)
+        {
+            for (int i = numDestChannels; --i >= 0;)
+                if (destSamples[i] != nullptr)
+                    zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (int) * (size_t) numSamples);
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    static size_t oggReadCallback (void* ptr, size_t size, size_t nmemb, void* datasource)
+    {
+        return (size_t) (static_cast <InputStream*> (datasource)->read (ptr, (int) (size * nmemb))) / size;
+    }
+
+    static int oggSeekCallback (void* datasource, OggVorbisNamespace::ogg_int64_t offset, int whence)
+    {
+        InputStream* const in = static_cast <InputStream*> (datasource);
+
+        if (whence == SEEK_CUR)
+            offset += in->getPosition();
+        else if (whence == SEEK_END)
+            offset += in->getTotalLength();
+
+        in->setPosition (offset);
+        return 0;
+    }
+
+    static int oggCloseCallback (void*)
+    {
+        return 0;
+    }
+
+    static long oggTellCallback (void* datasource)
+    {
+        return (long) static_cast <InputStream*> (datasource)->getPosition();
+    }
+
+private:
+    OggVorbisNamespace::OggVorbis_File ovFile;
+    OggVorbisNamespace::ov_callbacks callbacks;
+    AudioSampleBuffer reservoir;
+    int reservoirStart, samplesInReservoir;
+
+    // (the decoder and decodePosition are shared with the read-ahead thread, so are
+    // protected by decoderLock - the fifo itself only has one reader and one writer)
+    AudioSampleBuffer readAheadBuffer;
+    AbstractFifo readAheadFifo;
+    TimeSliceThread* readAheadThread;
+    int64 readPosition, decodePosition;
+    CriticalSection decoderLock;
+
+    enum { readAheadChunkSize = 8192 };
+
+    //==============================================================================
+    // Decodes from the decoder's current position straight into the destination
+    // channels, returning the number of samples that were decoded.
+    int decode (float* const* dest, const int numDestChannels, const int startOffsetInDest, const int numSamples)
+    {
+        int bitStream = 0;
+        int offset = 0;
+
+        while (offset < numSamples)
+        {
+            float** dataIn = nullptr;
+
+            const int samps = OggVorbisNamespace::ov_read_float (&ovFile, &dataIn, numSamples - offset, &bitStream);
+            if (samps <= 0)
+                break;
+
+            jassert (samps <= numSamples - offset);
+
+            for (int i = jmin ((int) numChannels, numDestChannels); --i >= 0;)
+                if (dest[i] != nullptr)
+                    memcpy (dest[i] + startOffsetInDest + offset, dataIn[i], sizeof (float) * (size_t) samps);
+
+            offset += samps;
+        }
+
+        return offset;
+    }
+
+    void readFromDecoder (float* const* dest, const int numDestChannels, int& startOffsetInDestBuffer,
+                          int64& startSampleInFile, int& numSamples)
     {
         while (numSamples > 0)
         {
@@ -156,8 +275,8 @@ public:
                 const int numToUse = jmin (numSamples, numAvailable);
 
                 for (int i = jmin (numDestChannels, reservoir.getNumChannels()); --i >= 0;)
-                    if (destSamples[i] != nullptr)
-                        memcpy (destSamples[i] + startOffsetInDestBuffer,
+                    if (dest[i] != nullptr)
+                        memcpy (dest[i] + startOffsetInDestBuffer,
                                 reservoir.getSampleData (i, (int) (startSampleInFile - reservoirStart)),
                                 sizeof (float) * (size_t) numToUse);
 
@@ -169,91 +288,137 @@ public:
                     break;
             }
 
-            if (startSampleInFile < reservoirStart
-                || startSampleInFile + numSamples > reservoirStart + samplesInReservoir)
+            if (startSampleInFile == OggVorbisNamespace::ov_pcm_tell (&ovFile))
             {
-                // buffer miss, so refill the reservoir
-                int bitStream = 0;
+                // the decoder's already at the right place, so there's no need to go
+                // through the reservoir
+                const int numDecoded = decode (dest, numDestChannels, startOffsetInDestBuffer, numSamples);
+
+                if (numDecoded == 0)
+                    break;
 
+                startSampleInFile += numDecoded;
+                numSamples -= numDecoded;
+                startOffsetInDestBuffer += numDecoded;
+            }
+            else if (startSampleInFile < reservoirStart
+                      || startSampleInFile + numSamples > reservoirStart + samplesInReservoir)
+            {
+                // buffer miss, so refill the reservoir
                 reservoirStart = jmax (0, (int) startSampleInFile);
                 samplesInReservoir = reservoir.getNumSamples();
 
                 if (reservoirStart != (int) OggVorbisNamespace::ov_pcm_tell (&ovFile))
                     OggVorbisNamespace::ov_pcm_seek (&ovFile, reservoirStart);
 
-                int offset = 0;
-                int numToRead = samplesInReservoir;
+                if (samplesInReservoir == 0)
+                    break;
 
-                while (numToRead > 0)
-                {
-                    float** dataIn = nullptr;
+                const int numDecoded = decode (reservoir.getArrayOfChannels(), reservoir.getNumChannels(),
+                                               0, samplesInReservoir);
 
-                    const int samps = OggVorbisNamespace::ov_read_float (&ovFile, &dataIn, numToRead, &bitStream);
-                    if (samps <= 0)
-                        break;
+                if (numDecoded < samplesInReservoir)
+                    reservoir.clear (numDecoded, samplesInReservoir - numDecoded);
+            }
+        }
+    }
+
+    void readFromReadAheadBuffer (float* const* dest, const int numDestChannels, int& startOffsetInDestBuffer,
+                                  int64& startSampleInFile, int& numSamples)
+    {
+        while (numSamples > 0)
+        {
+            if (startSampleInFile != readPosition)
+            {
+                const ScopedLock sl (decoderLock);
+
+                readAheadFifo.reset();
+                readPosition = decodePosition = jmax ((int64) 0, startSampleInFile);
+
+                if (decodePosition != OggVorbisNamespace::ov_pcm_tell (&ovFile))
+                    OggVorbisNamespace::ov_pcm_seek (&ovFile, decodePosition);
+
+                readAheadThread->moveToFrontOfQueue (this);
+            }
+
+            const int numReady = jmin (numSamples, readAheadFifo.getNumReady());
 
-                    jassert (samps <= numToRead);
+            if (numReady > 0)
+            {
+                int start1, size1, start2, size2;
+                readAheadFifo.prepareToRead (numReady, start1, size1, start2, size2);
 
-                    for (int i = jmin ((int) numChannels, reservoir.getNumChannels()); --i >= 0;)
+                for (int i = jmin (numDestChannels, readAheadBuffer.getNumChannels()); --i >= 0;)
+                {
+                    if (dest[i] != nullptr)
                     {
-                        memcpy (reservoir.getSampleData (i, offset),
-                                dataIn[i],
-                                sizeof (float) * (size_t) samps);
-                    }
+                        memcpy (dest[i] + startOffsetInDestBuffer, readAheadBuffer.getSampleData (i, start1),
+                                sizeof (float) * (size_t) size1);
 
-                    numToRead -= samps;
-                    offset += samps;
+                        if (size2 > 0)
+                            memcpy (dest[i] + startOffsetInDestBuffer + size1, readAheadBuffer.getSampleData (i, start2),
+                                    sizeof (float) * (size_t) size2);
+                    }
                 }
 
-                if (numToRead > 0)
-                    reservoir.clear (offset, numToRead);
+                readAheadFifo.finishedRead (size1 + size2);
+
+                readPosition += numReady;
+                startSampleInFile += numReady;
+                numSamples -= numReady;
+                startOffsetInDestBuffer += numReady;
             }
-        }
+            else
+            {
+                // the background thread hasn't caught up, so rather than waiting for it,
+                // decode the next block straight into the destination
+                const ScopedLock sl (decoderLock);
 
-        if (numSamples > 0)
-        {
-            for (int i = numDestChannels; --i >= 0;)
-                if (destSamples[i] != nullptr)
-                    zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (int) * (size_t) numSamples);
-        }
+                if (readAheadFifo.getNumReady() > 0)
+                    continue;
 
-        return true;
-    }
+                const int numDecoded = decode (dest, numDestChannels, startOffsetInDestBuffer, numSamples);
 
-    //==============================================================================
-    static size_t oggReadCallback (void* ptr, size_t size, size_t nmemb, void* datasource)
-    {
-        return (size_t) (static_cast <InputStream*> (datasource)->read (ptr, (int) (size * nmemb))) / size;
+                if (numDecoded == 0)
+                    break;
+
+                decodePosition += numDecoded;
+                readPosition += numDecoded;
+                startSampleInFile += numDecoded;
+                numSamples -= numDecoded;
+                startOffsetInDestBuffer += numDecoded;
+            }
+        }
     }
 
-    static int oggSeekCallback (void* datasource, OggVorbisNamespace::ogg_int64_t offset, int whence)
+    int useTimeSlice()
     {
-        InputStream* const in = static_cast <InputStream*> (datasource);
+        const ScopedLock sl (decoderLock);
 
-        if (whence == SEEK_CUR)
-            offset += in->getPosition();
-        else if (whence == SEEK_END)
-            offset += in->getTotalLength();
+        if (decodePosition >= lengthInSamples)
+            return 100;
 
-        in->setPosition (offset);
-        return 0;
-    }
+        const int numToDecode = jmin ((int) readAheadChunkSize, readAheadFifo.getFreeSpace());
 
-    static int oggCloseCallback (void*)
-    {
-        return 0;
-    }
+        if (numToDecode < jmin ((int) readAheadChunkSize, readAheadFifo.getTotalSize() / 4))
+            return 10;
 
-    static long oggTellCallback (void* datasource)
-    {
-        return (long) static_cast <InputStream*> (datasource)->getPosition();
-    }
+        int start1, size1, start2, size2;
+        readAheadFifo.prepareToWrite (numToDecode, start1, size1, start2, size2);
 
-private:
-    OggVorbisNamespace::OggVorbis_File ovFile;
-    OggVorbisNamespace::ov_callbacks callbacks;
-    AudioSampleBuffer reservoir;
-    int reservoirStart, samplesInReservoir;
+        float* const* const channels = readAheadBuffer.getArrayOfChannels();
+        const int numChans = readAheadBuffer.getNumChannels();
+
+        int numDecoded = decode (channels, numChans, start1, size1);
+
+        if (numDecoded == size1 && size2 > 0)
+            numDecoded += decode (channels, numChans, start2, size2);
+
+        readAheadFifo.finishedWrite (numDecoded);
+        decodePosition += numDecoded;
+
+        return numDecoded > 0 ? 0 : 100;
+    }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OggReader)
 };
@@ -454,6 +619,11 @@ bool OggVorbisAudioFormat::canDoStereo()    { return true; }
 bool OggVorbisAudioFormat::canDoMono()      { return true; }
 bool OggVorbisAudioFormat::isCompressed()   { return true; }
 
+bool OggVorbisAudioFormat::canHandleHeader (const void* headerData, const int numBytes)
+{
+    return numBytes >= 4 && memcmp (headerData, "OggS", 4) == 0;
+}
+
 AudioFormatReader* OggVorbisAudioFormat::createReaderFor (InputStream* in, const bool deleteStreamIfOpeningFails)
 {
     ScopedPointer<OggReader> r (new OggReader (in));
@@ -467,6 +637,23 @@ AudioFormatReader* OggVorbisAudioFormat::createReaderFor (InputStream* in, const
     return nullptr;
 }
 
+AudioFormatReader* OggVorbisAudioFormat::createReadAheadReaderFor (InputStream* in, const bool deleteStreamIfOpeningFails,
+                                                                TimeSliceThread& backgroundThread, const int numSamplesToBuffer)
+{
+    ScopedPointer<OggReader> r (new OggReader (in));
+
+    if (r->sampleRate > 0)
+    {
+        r->startReadAhead (backgroundThread, jmax (4096, numSamplesToBuffer));
+        return r.release();
+    }
+
+    if (! deleteStreamIfOpeningFails)
+        r->input = nullptr;
+
+    return nullptr;
+}
+
 AudioFormatWriter* OggVorbisAudioFormat::createWriterFor (OutputStream* out,
                                                           double sampleRate,
                                                           unsigned int numChannels,
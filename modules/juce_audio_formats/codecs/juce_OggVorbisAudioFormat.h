@@ -76,9 +76,28 @@ public:
     static const char* const id3trackNumber;    /**< Metadata key for setting an ID3 track number. */
 
     //==============================================================================
+    bool canHandleHeader (const void* headerData, int numBytes);
+
     AudioFormatReader* createReaderFor (InputStream* sourceStream,
                                         bool deleteStreamIfOpeningFails);
 
+    /** Creates a reader that decodes ahead of the current read position on a background thread.
+
+        The thread keeps a ring buffer of up to numSamplesToBuffer decoded samples filled,
+        so that a sequential read can just copy them out while the next pages are being
+        decoded. If a read gets ahead of the thread, the reader decodes straight into the
+        destination buffer rather than waiting, and reading from a different position
+        discards the buffer and restarts decoding there.
+
+        The thread must outlive the reader, and it can be shared with other clients. It's
+        best suited to batch processing of long files - for random access, the normal
+        createReaderFor() is a better choice.
+    */
+    AudioFormatReader* createReadAheadReaderFor (InputStream* sourceStream,
+                                                 bool deleteStreamIfOpeningFails,
+                                                 TimeSliceThread& backgroundThread,
+                                                 int numSamplesToBuffer);
+
     AudioFormatWriter* createWriterFor (OutputStream* streamToWriteTo,
                                         double sampleRateToUse,
                                         unsigned int numberOfChannels,
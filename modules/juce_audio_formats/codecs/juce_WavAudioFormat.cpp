@@ -560,9 +560,9 @@ public:
 
         const int firstChunkType = input->readInt();
 
-        if (firstChunkType == chunkName ("RF64"))
+        if (firstChunkType == chunkName ("RF64") || firstChunkType == chunkName ("BW64"))
         {
-            input->skipNextBytes (4); // size is -1 for RF64
+            input->skipNextBytes (4); // size is -1 for RF64 and BW64
             isRF64 = true;
         }
         else if (firstChunkType == chunkName ("RIFF"))
@@ -769,6 +769,19 @@ public:
     //==============================================================================
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples)
+    {
+        return readSamplesOfType (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    bool readSamplesAsFloat (float** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                             int64 startSampleInFile, int numSamples)
+    {
+        return readSamplesOfType (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    template <typename SampleType>
+    bool readSamplesOfType (SampleType** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                            int64 startSampleInFile, int numSamples)
     {
         clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
                                            startSampleInFile, numSamples, lengthInSamples);
@@ -818,6 +831,21 @@ public:
         }
     }
 
+    static void copySampleData (unsigned int bitsPerSample, const bool usesFloatingPointData,
+                                float* const* destSamples, int startOffsetInDestBuffer, int numDestChannels,
+                                const void* sourceData, int numChannels, int numSamples) noexcept
+    {
+        switch (bitsPerSample)
+        {
+            case 8:     ReadHelper<AudioData::Float32, AudioData::UInt8,   AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            case 16:    ReadHelper<AudioData::Float32, AudioData::Int16,   AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            case 24:    ReadHelper<AudioData::Float32, AudioData::Int24,   AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            case 32:    if (usesFloatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples);
+                        else                       ReadHelper<AudioData::Float32, AudioData::Int32,   AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
+            default:    jassertfalse; break;
+        }
+    }
+
     int64 bwavChunkStart, bwavSize;
     int64 dataChunkStart, dataLength;
     int bytesPerFrame;
@@ -837,7 +865,9 @@ public:
         : AudioFormatWriter (out, TRANS (wavFormatName), sampleRate_, numChannels_, bits),
           lengthInSamples (0),
           bytesWritten (0),
-          writeFailed (false)
+          reservedFileSize (0),
+          writeFailed (false),
+          canPreallocate (true)
     {
         using namespace WavFileHelpers;
 
@@ -890,6 +920,8 @@ public:
             default:    jassertfalse; break;
         }
 
+        reserveSpaceFor (bytes);
+
         if (! output->write (tempBlock.getData(), bytes))
         {
             // failed to write to disk, so let's try writing the header.
@@ -911,8 +943,35 @@ public:
 private:
     MemoryBlock tempBlock, bwavChunk, smplChunk, instChunk, cueChunk, listChunk;
     uint64 lengthInSamples, bytesWritten;
-    int64 headerPosition;
-    bool writeFailed;
+    int64 headerPosition, reservedFileSize;
+    bool writeFailed, canPreallocate;
+
+    // When writing to a file, its disk space is reserved in large steps ahead of the
+    // data, so that a long recording stays contiguous on disk and the filesystem doesn't
+    // need to allocate more space on every write.
+    void reserveSpaceFor (const size_t numBytesToWrite)
+    {
+        if (! canPreallocate)
+            return;
+
+        const int64 endOfWrite = output->getPosition() + (int64) numBytesToWrite;
+
+        if (endOfWrite <= reservedFileSize)
+            return;
+
+        const int64 newSize = endOfWrite + jmax ((int64) 64 * 1024 * 1024,
+                                                 (int64) (numChannels * bitsPerSample / 8 * sampleRate * 10.0));
+
+        Result result (Result::fail (String::empty));
+
+        if (FileOutputStream* const fos = dynamic_cast <FileOutputStream*> (output))
+            result = fos->preallocate (newSize);
+        else if (AsyncFileOutputStream* const afos = dynamic_cast <AsyncFileOutputStream*> (output))
+            result = afos->preallocate (newSize);
+
+        canPreallocate = result.wasOk();
+        reservedFileSize = newSize;
+    }
 
     static int getChannelMask (const int numChannels) noexcept
     {
@@ -1068,6 +1127,19 @@ public:
 
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples)
+    {
+        return readSamplesOfType (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    bool readSamplesAsFloat (float** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                             int64 startSampleInFile, int numSamples)
+    {
+        return readSamplesOfType (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    template <typename SampleType>
+    bool readSamplesOfType (SampleType** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                            int64 startSampleInFile, int numSamples)
     {
         clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
                                            startSampleInFile, numSamples, lengthInSamples);
@@ -1156,6 +1228,15 @@ Array<int> WavAudioFormat::getPossibleBitDepths()
 bool WavAudioFormat::canDoStereo()  { return true; }
 bool WavAudioFormat::canDoMono()    { return true; }
 
+bool WavAudioFormat::canHandleHeader (const void* headerData, const int numBytes)
+{
+    const char* const d = static_cast <const char*> (headerData);
+
+    return numBytes >= 12
+            && (memcmp (d, "RIFF", 4) == 0 || memcmp (d, "RF64", 4) == 0 || memcmp (d, "BW64", 4) == 0)
+            && memcmp (d + 8, "WAVE", 4) == 0;
+}
+
 AudioFormatReader* WavAudioFormat::createReaderFor (InputStream* sourceStream,
                                                     const bool deleteStreamIfOpeningFails)
 {
@@ -27,6 +27,11 @@
 /**
     Reads and Writes WAV format audio files.
 
+    Files whose data grows beyond 4GB are written in the RF64 format, and both RF64
+    and BW64 files can be read. When a writer's stream is a FileOutputStream or an
+    AsyncFileOutputStream, disk space for the file is reserved in large steps as it
+    grows, and an AsyncFileOutputStream is the best choice for long recordings.
+
     @see AudioFormat
 */
 class JUCE_API  WavAudioFormat  : public AudioFormat
@@ -139,6 +144,8 @@ public:
     bool canDoMono();
 
     //==============================================================================
+    bool canHandleHeader (const void* headerData, int numBytes);
+
     AudioFormatReader* createReaderFor (InputStream* sourceStream,
                                         bool deleteStreamIfOpeningFails);
 
@@ -43,6 +43,11 @@ bool AudioFormat::canHandleFile (const File& f)
     return false;
 }
 
+bool AudioFormat::canHandleHeader (const void*, int)
+{
+    return false;
+}
+
 const String& AudioFormat::getFormatName() const                { return formatName; }
 const StringArray& AudioFormat::getFileExtensions() const       { return fileExtensions; }
 bool AudioFormat::isCompressed()                                { return false; }
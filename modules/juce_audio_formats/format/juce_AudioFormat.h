@@ -69,6 +69,18 @@ public:
     */
     virtual bool canHandleFile (const File& fileToTest);
 
+    /** Returns true if the first few bytes of a file look like the start of this format.
+
+        This lets AudioFormatManager pick the right format for a file or stream without
+        having to try each one in turn, which is much quicker when files have the wrong
+        extension. It should only check for magic numbers or tags at the start of the data,
+        and shouldn't assume that more than a few dozen bytes are available.
+
+        The base class implementation returns false, which means that the format will only be
+        tried after any formats that recognise the header.
+    */
+    virtual bool canHandleHeader (const void* headerData, int numBytes);
+
     /** Returns a set of sample rates that the format can read and write. */
     virtual Array<int> getPossibleSampleRates() = 0;
 
@@ -109,6 +109,15 @@ AudioFormat* AudioFormatManager::findFormatForFileExtension (const String& fileE
     return nullptr;
 }
 
+AudioFormat* AudioFormatManager::findFormatForHeader (const void* const headerData, const int numBytes) const
+{
+    for (int i = 0; i < getNumKnownFormats(); ++i)
+        if (getKnownFormat(i)->canHandleHeader (headerData, numBytes))
+            return getKnownFormat(i);
+
+    return nullptr;
+}
+
 String AudioFormatManager::getWildcardForAllFormats() const
 {
     StringArray extensions;
@@ -133,17 +142,7 @@ AudioFormatReader* AudioFormatManager::createReaderFor (const File& file)
     // use them to open a file!
     jassert (getNumKnownFormats() > 0);
 
-    for (int i = 0; i < getNumKnownFormats(); ++i)
-    {
-        AudioFormat* const af = getKnownFormat(i);
-
-        if (af->canHandleFile (file))
-            if (InputStream* const in = file.createInputStream())
-                if (AudioFormatReader* const r = af->createReaderFor (in, true))
-                    return r;
-    }
-
-    return nullptr;
+    return createReaderForStream (file.createInputStream(), &file);
 }
 
 AudioFormatReader* AudioFormatManager::createReaderFor (InputStream* audioFileStream)
@@ -152,15 +151,41 @@ AudioFormatReader* AudioFormatManager::createReaderFor (InputStream* audioFileSt
     // use them to open a file!
     jassert (getNumKnownFormats() > 0);
 
+    return createReaderForStream (audioFileStream, nullptr);
+}
+
+AudioFormatReader* AudioFormatManager::createReaderForStream (InputStream* const audioFileStream, const File* const file)
+{
     ScopedPointer <InputStream> in (audioFileStream);
 
     if (in != nullptr)
     {
         const int64 originalStreamPos = in->getPosition();
 
+        // Read the start of the stream once, and use it to decide the order in which to
+        // try the formats: first any that recognise the header, then any that match the
+        // file's extension, then everything else.
+        uint8 header [64];
+        const int headerSize = jmax (0, in->read (header, (int) sizeof (header)));
+        in->setPosition (originalStreamPos);
+
+        Array<AudioFormat*> formatsToTry;
+
         for (int i = 0; i < getNumKnownFormats(); ++i)
+            if (getKnownFormat(i)->canHandleHeader (header, headerSize))
+                formatsToTry.add (getKnownFormat(i));
+
+        if (file != nullptr)
+            for (int i = 0; i < getNumKnownFormats(); ++i)
+                if (getKnownFormat(i)->canHandleFile (*file))
+                    formatsToTry.addIfNotAlreadyThere (getKnownFormat(i));
+
+        for (int i = 0; i < getNumKnownFormats(); ++i)
+            formatsToTry.addIfNotAlreadyThere (getKnownFormat(i));
+
+        for (int i = 0; i < formatsToTry.size(); ++i)
         {
-            if (AudioFormatReader* const r = getKnownFormat(i)->createReaderFor (in, false))
+            if (AudioFormatReader* const r = formatsToTry.getUnchecked(i)->createReaderFor (in, false))
             {
                 in.release();
                 return r;
@@ -93,6 +93,16 @@ public:
     */
     AudioFormat* findFormatForFileExtension (const String& fileExtension) const;
 
+    /** Looks for a known format that recognises the first few bytes of a file.
+
+        This uses AudioFormat::canHandleHeader() to check for things like the "RIFF" or
+        "fLaC" tags at the start of a file, so it can find the right format even if the
+        file has the wrong extension.
+
+        @returns the first format that recognises the header, or nullptr if none of them do
+    */
+    AudioFormat* findFormatForHeader (const void* headerData, int numBytes) const;
+
     /** Returns the format which has been set as the default one.
 
         You can set a format as being the default when it is registered. It's useful
@@ -115,6 +125,11 @@ public:
     /** Searches through the known formats to try to create a suitable reader for
         this file.
 
+        The file is only opened once. Its first few bytes are used to decide which
+        format to try first (see findFormatForHeader()), followed by any formats that
+        match its extension, and then the rest of them, so mislabelled files can still
+        be opened.
+
         If none of the registered formats can open the file, it'll return 0. If it
         returns a reader, it's the caller's responsibility to delete the reader.
     */
@@ -127,7 +142,8 @@ public:
         reader that is returned, so the caller should not keep any references to it.
 
         The stream that is passed-in must be capable of being repositioned so
-        that all the formats can have a go at opening it.
+        that all the formats can have a go at opening it. Any formats that recognise
+        the first few bytes of the stream are tried before the others.
 
         If none of the registered formats can open the stream, it'll return 0. If it
         returns a reader, it's the caller's responsibility to delete the reader.
@@ -139,6 +155,8 @@ private:
     OwnedArray<AudioFormat> knownFormats;
     int defaultFormatIndex;
 
+    AudioFormatReader* createReaderForStream (InputStream*, const File*);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatManager)
 };
 
@@ -39,11 +39,27 @@ AudioFormatReader::~AudioFormatReader()
     delete input;
 }
 
-bool AudioFormatReader::read (int* const* destSamples,
-                              int numDestChannels,
-                              int64 startSampleInSource,
-                              int numSamplesToRead,
-                              const bool fillLeftoverChannelsWithCopies)
+namespace AudioFormatReaderHelpers
+{
+    static inline bool readSamplesOfType (AudioFormatReader& reader, int** dest, int numDestChannels,
+                                          int startOffsetInDestBuffer, int64 startSampleInFile, int numSamples)
+    {
+        return reader.readSamples (dest, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    static inline bool readSamplesOfType (AudioFormatReader& reader, float** dest, int numDestChannels,
+                                          int startOffsetInDestBuffer, int64 startSampleInFile, int numSamples)
+    {
+        return reader.readSamplesAsFloat (dest, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+}
+
+template <typename SampleType>
+bool AudioFormatReader::readInternal (SampleType* const* destSamples,
+                                      int numDestChannels,
+                                      int64 startSampleInSource,
+                                      int numSamplesToRead,
+                                      const bool fillLeftoverChannelsWithCopies)
 {
     jassert (numDestChannels > 0); // you have to actually give this some channels to work with!
 
@@ -55,7 +71,7 @@ bool AudioFormatReader::read (int* const* destSamples,
 
         for (int i = numDestChannels; --i >= 0;)
             if (destSamples[i] != nullptr)
-                zeromem (destSamples[i], sizeof (int) * (size_t) silence);
+                zeromem (destSamples[i], sizeof (SampleType) * (size_t) silence);
 
         startOffsetInDestBuffer += silence;
         numSamplesToRead -= silence;
@@ -65,16 +81,16 @@ bool AudioFormatReader::read (int* const* destSamples,
     if (numSamplesToRead <= 0)
         return true;
 
-    if (! readSamples (const_cast <int**> (destSamples),
-                       jmin ((int) numChannels, numDestChannels), startOffsetInDestBuffer,
-                       startSampleInSource, numSamplesToRead))
+    if (! AudioFormatReaderHelpers::readSamplesOfType (*this, const_cast <SampleType**> (destSamples),
+                                                       jmin ((int) numChannels, numDestChannels), startOffsetInDestBuffer,
+                                                       startSampleInSource, numSamplesToRead))
         return false;
 
     if (numDestChannels > (int) numChannels)
     {
         if (fillLeftoverChannelsWithCopies)
         {
-            int* lastFullChannel = destSamples[0];
+            SampleType* lastFullChannel = destSamples[0];
 
             for (int i = (int) numChannels; --i > 0;)
             {
@@ -88,13 +104,63 @@ bool AudioFormatReader::read (int* const* destSamples,
             if (lastFullChannel != nullptr)
                 for (int i = (int) numChannels; i < numDestChannels; ++i)
                     if (destSamples[i] != nullptr)
-                        memcpy (destSamples[i], lastFullChannel, sizeof (int) * (size_t) numSamplesToRead);
+                        memcpy (destSamples[i] + startOffsetInDestBuffer, lastFullChannel + startOffsetInDestBuffer,
+                                sizeof (SampleType) * (size_t) numSamplesToRead);
         }
         else
         {
             for (int i = (int) numChannels; i < numDestChannels; ++i)
                 if (destSamples[i] != nullptr)
-                    zeromem (destSamples[i], sizeof (int) * (size_t) numSamplesToRead);
+                    zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (SampleType) * (size_t) numSamplesToRead);
+        }
+    }
+
+    return true;
+}
+
+bool AudioFormatReader::read (int* const* destSamples,
+                              int numDestChannels,
+                              int64 startSampleInSource,
+                              int numSamplesToRead,
+                              const bool fillLeftoverChannelsWithCopies)
+{
+    return readInternal (destSamples, numDestChannels, startSampleInSource,
+                         numSamplesToRead, fillLeftoverChannelsWithCopies);
+}
+
+bool AudioFormatReader::read (float* const* destSamples,
+                              int numDestChannels,
+                              int64 startSampleInSource,
+                              int numSamplesToRead,
+                              const bool fillLeftoverChannelsWithCopies)
+{
+    return readInternal (destSamples, numDestChannels, startSampleInSource,
+                         numSamplesToRead, fillLeftoverChannelsWithCopies);
+}
+
+bool AudioFormatReader::readSamplesAsFloat (float** destSamples,
+                                            int numDestChannels,
+                                            int startOffsetInDestBuffer,
+                                            int64 startSampleInFile,
+                                            int numSamples)
+{
+    if (! readSamples (reinterpret_cast<int**> (destSamples), numDestChannels,
+                       startOffsetInDestBuffer, startSampleInFile, numSamples))
+        return false;
+
+    if (! usesFloatingPointData)
+    {
+        typedef AudioData::Pointer <AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst> DestType;
+        typedef AudioData::Pointer <AudioData::Int32,   AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const>    SourceType;
+
+        for (int i = 0; i < numDestChannels; ++i)
+        {
+            if (float* const d = destSamples[i])
+            {
+                // converting in-place is safe here because both formats are the same size
+                DestType (d + startOffsetInDestBuffer)
+                    .convertSamples (SourceType (d + startOffsetInDestBuffer), numSamples);
+            }
         }
     }
 
@@ -114,42 +180,28 @@ void AudioFormatReader::read (AudioSampleBuffer* buffer,
     if (numSamples > 0)
     {
         const int numTargetChannels = buffer->getNumChannels();
-        int* chans[3];
+        float* chans[3];
 
         if (useReaderLeftChan == useReaderRightChan)
         {
-            chans[0] = reinterpret_cast<int*> (buffer->getSampleData (0, startSample));
-            chans[1] = (numChannels > 1 && numTargetChannels > 1) ? reinterpret_cast<int*> (buffer->getSampleData (1, startSample)) : nullptr;
+            chans[0] = buffer->getSampleData (0, startSample);
+            chans[1] = (numChannels > 1 && numTargetChannels > 1) ? buffer->getSampleData (1, startSample) : nullptr;
         }
         else if (useReaderLeftChan || (numChannels == 1))
         {
-            chans[0] = reinterpret_cast<int*> (buffer->getSampleData (0, startSample));
+            chans[0] = buffer->getSampleData (0, startSample);
             chans[1] = nullptr;
         }
         else if (useReaderRightChan)
         {
             chans[0] = nullptr;
-            chans[1] = reinterpret_cast<int*> (buffer->getSampleData (0, startSample));
+            chans[1] = buffer->getSampleData (0, startSample);
         }
 
         chans[2] = nullptr;
 
         read (chans, 2, readerStartSample, numSamples, true);
 
-        if (! usesFloatingPointData)
-        {
-            for (int j = 0; j < 2; ++j)
-            {
-                if (float* const d = reinterpret_cast <float*> (chans[j]))
-                {
-                    const float multiplier = 1.0f / 0x7fffffff;
-
-                    for (int i = 0; i < numSamples; ++i)
-                        d[i] = *reinterpret_cast<int*> (d + i) * multiplier;
-                }
-            }
-        }
-
         if (numTargetChannels > 1 && (chans[0] == nullptr || chans[1] == nullptr))
         {
             // if this is a stereo buffer and the source was mono, dupe the first channel..
@@ -160,29 +212,17 @@ void AudioFormatReader::read (AudioSampleBuffer* buffer,
     }
 }
 
-template <typename SampleType>
-static inline void getChannelMinAndMax (SampleType* channel, const int numSamples, SampleType& mn, SampleType& mx)
-{
-    findMinAndMax (channel, numSamples, mn, mx);
-}
-
-static inline void getChannelMinAndMax (float* channel, const int numSamples, float& mn, float& mx)
-{
-    FloatVectorOperations::findMinAndMax (channel, numSamples, mn, mx);
-}
-
-template <typename SampleType>
-static void getStereoMinAndMax (SampleType* const* channels, const int numChannels, const int numSamples,
-                                SampleType& lmin, SampleType& lmax, SampleType& rmin, SampleType& rmax)
+static void getStereoMinAndMax (const float* const* channels, const int numChannels, const int numSamples,
+                                float& lmin, float& lmax, float& rmin, float& rmax) noexcept
 {
-    SampleType bufMin, bufMax;
-    getChannelMinAndMax (channels[0], numSamples, bufMin, bufMax);
+    float bufMin, bufMax;
+    FloatVectorOperations::findMinAndMax (channels[0], numSamples, bufMin, bufMax);
     lmax = jmax (lmax, bufMax);
     lmin = jmin (lmin, bufMin);
 
     if (numChannels > 1)
     {
-        getChannelMinAndMax (channels[1], numSamples, bufMin, bufMax);
+        FloatVectorOperations::findMinAndMax (channels[1], numSamples, bufMin, bufMax);
         rmax = jmax (rmax, bufMax);
         rmin = jmin (rmin, bufMin);
     }
@@ -206,58 +246,34 @@ void AudioFormatReader::readMaxLevels (int64 startSampleInFile, int64 numSamples
         return;
     }
 
-    const int bufferSize = (int) jmin (numSamples, (int64) 4096);
-    AudioSampleBuffer tempSampleBuffer ((int) numChannels, bufferSize);
+    // The data is always fetched as floats, so that readers which override readSamplesAsFloat()
+    // can convert straight into the scan buffer, and the scan itself can use the vectorised
+    // FloatVectorOperations::findMinAndMax() whatever the source format is.
+    const int bufferSize = (int) jmin (numSamples, (int64) 8192);
+    AudioSampleBuffer tempSampleBuffer (jmax (2, (int) numChannels), bufferSize);
 
-    float** const floatBuffer = tempSampleBuffer.getArrayOfChannels();
-    int* const* intBuffer = reinterpret_cast<int* const*> (floatBuffer);
-
-    if (usesFloatingPointData)
-    {
-        float lmin = 1.0e6f;
-        float lmax = -lmin;
-        float rmin = lmin;
-        float rmax = lmax;
-
-        while (numSamples > 0)
-        {
-            const int numToDo = (int) jmin (numSamples, (int64) bufferSize);
-            if (! read (intBuffer, 2, startSampleInFile, numToDo, false))
-                break;
+    float* const* const floatBuffer = tempSampleBuffer.getArrayOfChannels();
 
-            numSamples -= numToDo;
-            startSampleInFile += numToDo;
-            getStereoMinAndMax (floatBuffer, (int) numChannels, numToDo, lmin, lmax, rmin, rmax);
-        }
+    float lmin = 1.0e6f;
+    float lmax = -lmin;
+    float rmin = lmin;
+    float rmax = lmax;
 
-        lowestLeft   = lmin;
-        highestLeft  = lmax;
-        lowestRight  = rmin;
-        highestRight = rmax;
-    }
-    else
+    while (numSamples > 0)
     {
-        int lmax = std::numeric_limits<int>::min();
-        int lmin = std::numeric_limits<int>::max();
-        int rmax = std::numeric_limits<int>::min();
-        int rmin = std::numeric_limits<int>::max();
-
-        while (numSamples > 0)
-        {
-            const int numToDo = (int) jmin (numSamples, (int64) bufferSize);
-            if (! read (intBuffer, 2, startSampleInFile, numToDo, false))
-                break;
-
-            numSamples -= numToDo;
-            startSampleInFile += numToDo;
-            getStereoMinAndMax (intBuffer, (int) numChannels, numToDo, lmin, lmax, rmin, rmax);
-        }
+        const int numToDo = (int) jmin (numSamples, (int64) bufferSize);
+        if (! read (floatBuffer, 2, startSampleInFile, numToDo, false))
+            break;
 
-        lowestLeft   = lmin / (float) std::numeric_limits<int>::max();
-        highestLeft  = lmax / (float) std::numeric_limits<int>::max();
-        lowestRight  = rmin / (float) std::numeric_limits<int>::max();
-        highestRight = rmax / (float) std::numeric_limits<int>::max();
+        numSamples -= numToDo;
+        startSampleInFile += numToDo;
+        getStereoMinAndMax (floatBuffer, (int) numChannels, numToDo, lmin, lmax, rmin, rmax);
     }
+
+    lowestLeft   = lmin;
+    highestLeft  = lmax;
+    lowestRight  = rmin;
+    highestRight = rmax;
 }
 
 int64 AudioFormatReader::searchForLevel (int64 startSample,
@@ -110,6 +110,21 @@ public:
                int numSamplesToRead,
                bool fillLeftoverChannelsWithCopies);
 
+    /** Reads samples from the stream as floating-point data.
+
+        This behaves just like the integer version of read(), but the samples are
+        delivered in the range -1.0 to 1.0, whatever the source's format. Readers that
+        override readSamplesAsFloat() will convert their data straight into the
+        destination buffers, without going via an intermediate 32-bit integer block.
+
+        @see readSamplesAsFloat
+    */
+    bool read (float* const* destSamples,
+               int numDestChannels,
+               int64 startSampleInSource,
+               int numSamplesToRead,
+               bool fillLeftoverChannelsWithCopies);
+
     /** Fills a section of an AudioSampleBuffer from this reader.
 
         This will convert the reader's fixed- or floating-point data to
@@ -227,6 +242,21 @@ public:
                               int64 startSampleInFile,
                               int numSamples) = 0;
 
+    /** Performs a low-level read operation into floating-point buffers.
+
+        Callers should use read() instead of calling this directly.
+
+        The parameters are the same as for readSamples(). The default implementation
+        calls readSamples() and converts the result in-place, but formats that can
+        convert their raw data directly to floats should override this to avoid the
+        extra pass.
+    */
+    virtual bool readSamplesAsFloat (float** destSamples,
+                                     int numDestChannels,
+                                     int startOffsetInDestBuffer,
+                                     int64 startSampleInFile,
+                                     int numSamples);
+
 
 protected:
     //==============================================================================
@@ -260,7 +290,8 @@ protected:
     /** Used by AudioFormatReader subclasses to clear any parts of the data blocks that lie
         beyond the end of their available length.
     */
-    static void clearSamplesBeyondAvailableLength (int** destSamples, int numDestChannels,
+    template <typename SampleType>
+    static void clearSamplesBeyondAvailableLength (SampleType** destSamples, int numDestChannels,
                                                    int startOffsetInDestBuffer, int64 startSampleInFile,
                                                    int& numSamples, int64 fileLengthInSamples)
     {
@@ -271,7 +302,7 @@ protected:
         {
             for (int i = numDestChannels; --i >= 0;)
                 if (destSamples[i] != nullptr)
-                    zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (int) * (size_t) numSamples);
+                    zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (SampleType) * (size_t) numSamples);
 
             numSamples = (int) samplesAvailable;
         }
@@ -280,6 +311,11 @@ protected:
 private:
     String formatName;
 
+    template <typename SampleType>
+    bool readInternal (SampleType* const* destSamples, int numDestChannels,
+                       int64 startSampleInSource, int numSamplesToRead,
+                       bool fillLeftoverChannelsWithCopies);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatReader)
 };
 
@@ -33,7 +33,8 @@ AudioFormatWriter::AudioFormatWriter (OutputStream* const out,
     bitsPerSample (bitsPerSample_),
     usesFloatingPointData (false),
     output (out),
-    formatName (formatName_)
+    formatName (formatName_),
+    ditherEnabled (false)
 {
 }
 
@@ -148,12 +149,27 @@ bool AudioFormatWriter::writeFromFloatArrays (const float** channels, int numSou
     chans[numSourceChannels] = nullptr;
     int startSample = 0;
 
+    const bool shouldDither = ditherEnabled && bitsPerSample < 32;
+    const float ditherAmplitude = 1.0f / (float) (1 << jmax (0, (int) bitsPerSample - 1));
+    float dithered [4096];
+
     while (numSamples > 0)
     {
         const int numToDo = jmin (numSamples, maxSamples);
 
         for (int i = 0; i < numSourceChannels; ++i)
-            convertFloatsToInts (chans[i], channels[i] + startSample, numToDo);
+        {
+            if (shouldDither)
+            {
+                ditherRandom.fillTriangular (dithered, numToDo, ditherAmplitude);
+                FloatVectorOperations::add (dithered, channels[i] + startSample, numToDo);
+                convertFloatsToInts (chans[i], dithered, numToDo);
+            }
+            else
+            {
+                convertFloatsToInts (chans[i], channels[i] + startSample, numToDo);
+            }
+        }
 
         if (! write ((const int**) chans, numToDo))
             return false;
@@ -171,13 +187,13 @@ bool AudioFormatWriter::writeFromAudioSampleBuffer (const AudioSampleBuffer& sou
     jassert (startSample >= 0 && startSample + numSamples <= source.getNumSamples() && numSourceChannels > 0);
 
     if (startSample == 0)
-        return writeFromFloatArrays ((const float**) source.getArrayOfChannels(), numSourceChannels, numSamples);
+        return writeFromFloatArrays (source.getArrayOfReadPointers(), numSourceChannels, numSamples);
 
     const float* chans [256];
     jassert ((int) numChannels < numElementsInArray (chans));
 
     for (int i = 0; i < numSourceChannels; ++i)
-        chans[i] = source.getSampleData (i, startSample);
+        chans[i] = source.getReadPointer (i, startSample);
 
     chans[numSourceChannels] = nullptr;
 
@@ -196,6 +212,10 @@ public:
           writer (w),
           receiver (nullptr),
           samplesWritten (0),
+          minSamplesPerWrite (bufferSize / 8),
+          maxMillisecsBetweenWrites (100),
+          lastWriteTime (Time::getMillisecondCounter()),
+          highWaterMark (0),
           isRunning (true)
     {
         timeSliceThread.addTimeSliceClient (this);
@@ -206,7 +226,7 @@ public:
         isRunning = false;
         timeSliceThread.removeTimeSliceClient (this);
 
-        while (writePendingData() == 0)
+        while (writePendingData (true) == 0)
         {}
     }
 
@@ -221,7 +241,10 @@ public:
         prepareToWrite (numSamples, start1, size1, start2, size2);
 
         if (size1 + size2 < numSamples)
+        {
+            highWaterMark = getTotalSize();
             return false;
+        }
 
         for (int i = buffer.getNumChannels(); --i >= 0;)
         {
@@ -230,24 +253,38 @@ public:
         }
 
         finishedWrite (size1 + size2);
-        timeSliceThread.notify();
+
+        const int numReady = getNumReady();
+
+        if (numReady > highWaterMark)
+            highWaterMark = numReady;
+
+        // (no point waking the thread until there's enough to be worth writing)
+        if (numReady >= minSamplesPerWrite)
+            timeSliceThread.notify();
+
         return true;
     }
 
     int useTimeSlice()
     {
-        return writePendingData();
+        return writePendingData (false);
     }
 
-    int writePendingData()
+    int writePendingData (const bool writeEverything)
     {
-        const int numToDo = getTotalSize() / 4;
+        const int numReady = getNumReady();
+
+        // Rather than writing each little bit as soon as it arrives, the data is left to
+        // build up, so that when lots of writers share a thread, each file gets written in
+        // long runs rather than lots of small interleaved ones.
+        if (numReady <= 0
+             || (numReady < minSamplesPerWrite && ! writeEverything
+                  && Time::getMillisecondCounter() - lastWriteTime < (uint32) maxMillisecsBetweenWrites))
+            return 10;
 
         int start1, size1, start2, size2;
-        prepareToRead (numToDo, start1, size1, start2, size2);
-
-        if (size1 <= 0)
-            return 10;
+        prepareToRead (numReady, start1, size1, start2, size2);
 
         writer->writeFromAudioSampleBuffer (buffer, start1, size1);
 
@@ -268,6 +305,7 @@ public:
         }
 
         finishedRead (size1 + size2);
+        lastWriteTime = Time::getMillisecondCounter();
         return 0;
     }
 
@@ -281,6 +319,15 @@ public:
         samplesWritten = 0;
     }
 
+    void setWriteBatching (const int minSamples, const int maxMillisecs) noexcept
+    {
+        minSamplesPerWrite = jlimit (1, getTotalSize() - 1, minSamples);
+        maxMillisecsBetweenWrites = jmax (0, maxMillisecs);
+    }
+
+    int getHighWaterMark() const noexcept       { return highWaterMark; }
+    void resetHighWaterMark() noexcept          { highWaterMark = 0; }
+
 private:
     AudioSampleBuffer buffer;
     TimeSliceThread& timeSliceThread;
@@ -288,6 +335,9 @@ private:
     CriticalSection thumbnailLock;
     IncomingDataReceiver* receiver;
     int64 samplesWritten;
+    volatile int minSamplesPerWrite, maxMillisecsBetweenWrites;
+    uint32 lastWriteTime;
+    volatile int highWaterMark;
     volatile bool isRunning;
 
     JUCE_DECLARE_NON_COPYABLE (Buffer)
@@ -311,3 +361,28 @@ void AudioFormatWriter::ThreadedWriter::setDataReceiver (AudioFormatWriter::Thre
 {
     buffer->setDataReceiver (receiver);
 }
+
+void AudioFormatWriter::ThreadedWriter::setWriteBatching (int minNumSamplesPerWrite, int maxMillisecondsBetweenWrites)
+{
+    buffer->setWriteBatching (minNumSamplesPerWrite, maxMillisecondsBetweenWrites);
+}
+
+int AudioFormatWriter::ThreadedWriter::getBufferSize() const noexcept
+{
+    return buffer->getTotalSize();
+}
+
+int AudioFormatWriter::ThreadedWriter::getFreeSpace() const noexcept
+{
+    return buffer->getFreeSpace();
+}
+
+int AudioFormatWriter::ThreadedWriter::getHighWaterMark() const noexcept
+{
+    return buffer->getHighWaterMark();
+}
+
+void AudioFormatWriter::ThreadedWriter::resetHighWaterMark() noexcept
+{
+    buffer->resetHighWaterMark();
+}
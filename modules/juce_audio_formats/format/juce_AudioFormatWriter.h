@@ -146,6 +146,21 @@ public:
     /** Returns true if it's a floating-point format, false if it's fixed-point. */
     bool isFloatingPoint() const noexcept       { return usesFloatingPointData; }
 
+    //==============================================================================
+    /** Turns dithering on or off for floating-point data written to a fixed-point format.
+
+        When this is enabled, writeFromFloatArrays() and the other methods that take float
+        data add triangular (TPDF) noise of one LSB of the file's bit depth before they
+        round the samples, which removes the distortion that plain truncation would cause.
+        It's off by default. Data that's passed to write() as integers is never dithered.
+
+        @see Random::fillTriangular
+    */
+    void setDitherEnabled (bool shouldDither) noexcept      { ditherEnabled = shouldDither; }
+
+    /** Returns true if dithering has been turned on with setDitherEnabled(). */
+    bool isDitherEnabled() const noexcept                   { return ditherEnabled; }
+
     //==============================================================================
     /**
         Provides a FIFO for an AudioFormatWriter, allowing you to push incoming
@@ -202,6 +217,44 @@ public:
         */
         void setDataReceiver (IncomingDataReceiver* receiver);
 
+        /** Controls how the buffered data is batched up before being written.
+
+            The background thread leaves the data to build up until there are at least
+            minNumSamplesPerWrite samples waiting, or until maxMillisecondsBetweenWrites has
+            passed since the last write, and then writes it all in one go. When lots of
+            writers share the same thread (e.g. when recording many tracks at once), this
+            means that each file gets written in long runs rather than as a stream of small,
+            interleaved writes.
+
+            The default is an eighth of the buffer size, or 100ms. Bigger batches make for
+            more efficient disk access, but leave less free space in the FIFO, and mean that
+            any IncomingDataReceiver will be updated less often.
+        */
+        void setWriteBatching (int minNumSamplesPerWrite, int maxMillisecondsBetweenWrites);
+
+        /** Returns the size of the FIFO, in samples. */
+        int getBufferSize() const noexcept;
+
+        /** Returns the number of samples that could be passed to write() right now
+            without it failing.
+            The background thread only ever frees up more space, so if you're the only
+            thread that calls write(), a block of this size is guaranteed to fit.
+        */
+        int getFreeSpace() const noexcept;
+
+        /** Returns the largest number of samples that have been waiting in the FIFO at
+            any one time.
+
+            This lets you check how close the FIFO has come to overflowing, so you can size
+            it safely. If a call to write() has ever failed because the FIFO was full, this
+            will be the full buffer size.
+            @see resetHighWaterMark
+        */
+        int getHighWaterMark() const noexcept;
+
+        /** Resets the value returned by getHighWaterMark(). */
+        void resetHighWaterMark() noexcept;
+
     private:
         class Buffer;
         friend class ScopedPointer<Buffer>;
@@ -254,6 +307,8 @@ protected:
 
 private:
     String formatName;
+    bool ditherEnabled;
+    Random ditherRandom;
     friend class ThreadedWriter;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatWriter)
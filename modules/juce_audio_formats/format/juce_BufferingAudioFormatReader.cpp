@@ -78,7 +78,7 @@ bool BufferingAudioReader::readSamples (int** destSamples, int numDestChannels,
                     dest += startOffsetInDestBuffer;
 
                     if (j < (int) numChannels)
-                        FloatVectorOperations::copy (dest, block->buffer.getSampleData (j, offset), numToDo);
+                        FloatVectorOperations::copy (dest, block->buffer.getReadPointer (j, offset), numToDo);
                     else
                         FloatVectorOperations::clear (dest, numToDo);
                 }
@@ -109,6 +109,72 @@ bool BufferingAudioReader::readSamples (int** destSamples, int numDestChannels,
     return true;
 }
 
+void BufferingAudioReader::readMaxLevels (int64 startSampleInFile, int64 numSamples,
+                                          float& lowestLeft, float& highestLeft,
+                                          float& lowestRight, float& highestRight)
+{
+    if (numSamples <= 0)
+    {
+        AudioFormatReader::readMaxLevels (startSampleInFile, numSamples,
+                                          lowestLeft, highestLeft, lowestRight, highestRight);
+        return;
+    }
+
+    float lmin = 1.0e6f;
+    float lmax = -lmin;
+    float rmin = lmin;
+    float rmax = lmax;
+
+    while (numSamples > 0)
+    {
+        float mn0, mx0, mn1, mx1;
+        int64 numDone = 0;
+
+        {
+            const ScopedLock sl (lock);
+
+            if (const BufferedBlock* const block = getBlockContaining (startSampleInFile))
+            {
+                const int offset = (int) (startSampleInFile - block->range.getStart());
+                const int numToDo = (int) jmin (numSamples, block->range.getEnd() - startSampleInFile);
+
+                block->buffer.findMinMax (0, offset, numToDo, mn0, mx0);
+
+                if (numChannels > 1)
+                    block->buffer.findMinMax (1, offset, numToDo, mn1, mx1);
+                else
+                {
+                    mn1 = mn0;
+                    mx1 = mx0;
+                }
+
+                numDone = numToDo;
+            }
+        }
+
+        if (numDone == 0)
+        {
+            // not buffered yet, so read a block's worth through the normal path, which
+            // also tells the background thread where we are
+            numDone = jmin (numSamples, (int64) samplesPerBlock);
+            AudioFormatReader::readMaxLevels (startSampleInFile, numDone, mn0, mx0, mn1, mx1);
+        }
+
+        lmin = jmin (lmin, mn0);
+        lmax = jmax (lmax, mx0);
+        rmin = jmin (rmin, mn1);
+        rmax = jmax (rmax, mx1);
+
+        startSampleInFile += numDone;
+        numSamples -= numDone;
+    }
+
+    lowestLeft   = lmin;
+    highestLeft  = lmax;
+    lowestRight  = rmin;
+    highestRight = rmax;
+}
+
 BufferingAudioReader::BufferedBlock::BufferedBlock (AudioFormatReader& reader, int64 pos, int numSamples)
     : range (pos, pos + numSamples),
       buffer (reader.numChannels, numSamples)
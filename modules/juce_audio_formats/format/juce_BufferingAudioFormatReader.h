@@ -63,6 +63,13 @@ public:
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples);
 
+    /** Scans any blocks that have already been buffered directly, and only goes back
+        to the source reader for the parts of the range that aren't in memory.
+    */
+    void readMaxLevels (int64 startSample, int64 numSamples,
+                        float& lowestLeft, float& highestLeft,
+                        float& lowestRight, float& highestRight);
+
 private:
     ScopedPointer<AudioFormatReader> source;
     TimeSliceThread& thread;
@@ -0,0 +1,515 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+struct AudioBlockCache::BlockKey
+{
+    BlockKey (int64 source_, int64 index_) noexcept : source (source_), index (index_) {}
+
+    bool operator== (const BlockKey& other) const noexcept   { return source == other.source && index == other.index; }
+
+    int64 source, index;
+};
+
+struct AudioBlockCache::BlockKeyHash
+{
+    static int generateHash (const BlockKey& key, const int upperLimit) noexcept
+    {
+        const uint64 h = ((uint64) key.source * 0x9e3779b97f4a7c15ULL) ^ (uint64) key.index;
+        return (int) ((h ^ (h >> 32)) % (uint64) upperLimit);
+    }
+};
+
+struct AudioBlockCache::Block
+{
+    Block (int64 source, int64 index, int numChannels_, int numSamples_)
+        : key (source, index), numChannels (numChannels_), numSamples (numSamples_),
+          data ((size_t) (numChannels_ * numSamples_)),
+          previous (nullptr), next (nullptr)
+    {
+    }
+
+    int64 getSizeInBytes() const noexcept      { return (int64) sizeof (int) * numChannels * numSamples + (int64) sizeof (Block); }
+    int* getChannel (int channel) const noexcept { return data + channel * numSamples; }
+
+    const BlockKey key;
+    const int numChannels, numSamples;
+    HeapBlock<int> data;
+    Block* previous;   // (more recently used)
+    Block* next;       // (less recently used)
+
+    JUCE_DECLARE_NON_COPYABLE (Block)
+};
+
+//==============================================================================
+AudioBlockCache::AudioBlockCache (const int64 maxBytesInMemory, const File& spillDirectory_)
+    : blocks (new HashMap<BlockKey, Block*, BlockKeyHash> (1021)),
+      mostRecent (nullptr), leastRecent (nullptr),
+      maxBytes (maxBytesInMemory), currentBytes (0),
+      spillDirectory (spillDirectory_)
+{
+    if (spillDirectory != File::nonexistent)
+        spillDirectory.createDirectory();
+}
+
+AudioBlockCache::~AudioBlockCache()
+{
+    clear();
+}
+
+void AudioBlockCache::setMaximumSize (const int64 maxBytesInMemory)
+{
+    OwnedArray<Block> removed;
+
+    {
+        const ScopedLock sl (lock);
+        maxBytes = maxBytesInMemory;
+        removeExcessBlocks (removed);
+    }
+
+    spill (removed);
+}
+
+int64 AudioBlockCache::getCurrentSize() const
+{
+    const ScopedLock sl (lock);
+    return currentBytes;
+}
+
+void AudioBlockCache::clear()
+{
+    OwnedArray<Block> removed;
+
+    {
+        const ScopedLock sl (lock);
+
+        while (Block* const b = leastRecent)
+        {
+            unlink (b);
+            removed.add (b);
+        }
+
+        blocks->clear();
+        currentBytes = 0;
+    }
+}
+
+void AudioBlockCache::clearSpillDirectory()
+{
+    if (spillDirectory != File::nonexistent)
+    {
+        Array<File> files;
+        spillDirectory.findChildFiles (files, File::findFiles, false, "*.decodedaudio");
+
+        for (int i = files.size(); --i >= 0;)
+            files.getReference(i).deleteFile();
+    }
+}
+
+int64 AudioBlockCache::createSourceHash (const File& file)
+{
+    return (file.getFullPathName() + "/" + String (file.getSize())
+              + "/" + String (file.getLastModificationTime().toMilliseconds())).hashCode64();
+}
+
+//==============================================================================
+bool AudioBlockCache::readBlock (const int64 sourceHash, const int64 blockIndex,
+                                 const int numChannels, const int numSamples,
+                                 int* const* const dest, const int numDestChannels, const int destOffset,
+                                 const int offsetInBlock, const int numToCopy)
+{
+    ScopedPointer<Block> loaded;
+
+    for (;;)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            Block* b = (*blocks) [BlockKey (sourceHash, blockIndex)];
+
+            if (b == nullptr && loaded != nullptr)
+            {
+                b = loaded.release();
+                insert (b);
+            }
+
+            if (b != nullptr)
+            {
+                jassert (b->numChannels == numChannels && b->numSamples == numSamples);
+
+                // move it to the front of the list..
+                unlink (b);
+                b->next = mostRecent;
+
+                if (mostRecent != nullptr)
+                    mostRecent->previous = b;
+
+                mostRecent = b;
+
+                if (leastRecent == nullptr)
+                    leastRecent = b;
+
+                for (int i = 0; i < numDestChannels; ++i)
+                    if (dest[i] != nullptr && i < numChannels)
+                        memcpy (dest[i] + destOffset, b->getChannel (i) + offsetInBlock, sizeof (int) * (size_t) numToCopy);
+
+                ++numHits;
+                break;
+            }
+        }
+
+        // not in memory, so see if it was spilled to disk earlier..
+        if (loaded != nullptr || spillDirectory == File::nonexistent)
+            return false;
+
+        loaded = readSpilledBlock (sourceHash, blockIndex, numChannels, numSamples);
+
+        if (loaded == nullptr)
+            return false;
+    }
+
+    OwnedArray<Block> removed;
+
+    {
+        const ScopedLock sl (lock);
+        removeExcessBlocks (removed);
+    }
+
+    spill (removed);
+    return true;
+}
+
+void AudioBlockCache::addBlock (const int64 sourceHash, const int64 blockIndex,
+                                const int numChannels, const int numSamples,
+                                const int* const* const data)
+{
+    ++numMisses;
+
+    Block* const b = new Block (sourceHash, blockIndex, numChannels, numSamples);
+
+    for (int i = 0; i < numChannels; ++i)
+        memcpy (b->getChannel (i), data[i], sizeof (int) * (size_t) numSamples);
+
+    OwnedArray<Block> removed;
+
+    {
+        const ScopedLock sl (lock);
+
+        if (blocks->contains (b->key))
+            removed.add (b); // (another reader got there first)
+        else
+            insert (b);
+
+        removeExcessBlocks (removed);
+    }
+
+    spill (removed);
+}
+
+void AudioBlockCache::insert (Block* const b)
+{
+    // (must be called with the lock held)
+    blocks->set (b->key, b);
+    currentBytes += b->getSizeInBytes();
+
+    b->previous = nullptr;
+    b->next = mostRecent;
+
+    if (mostRecent != nullptr)
+        mostRecent->previous = b;
+
+    mostRecent = b;
+
+    if (leastRecent == nullptr)
+        leastRecent = b;
+}
+
+void AudioBlockCache::unlink (Block* const b) noexcept
+{
+    // (must be called with the lock held)
+    if (b->previous != nullptr)  b->previous->next = b->next;
+    else if (mostRecent == b)    mostRecent = b->next;
+
+    if (b->next != nullptr)      b->next->previous = b->previous;
+    else if (leastRecent == b)   leastRecent = b->previous;
+
+    b->previous = b->next = nullptr;
+}
+
+void AudioBlockCache::removeExcessBlocks (OwnedArray<Block>& removed)
+{
+    // (must be called with the lock held)
+    while (currentBytes > maxBytes && leastRecent != nullptr)
+    {
+        Block* const b = leastRecent;
+        unlink (b);
+        blocks->remove (b->key);
+        currentBytes -= b->getSizeInBytes();
+        removed.add (b);
+    }
+}
+
+//==============================================================================
+File AudioBlockCache::getSpillFile (const int64 sourceHash, const int64 blockIndex) const
+{
+    return spillDirectory.getChildFile (String::toHexString (sourceHash) + "_"
+                                          + String (blockIndex) + ".decodedaudio");
+}
+
+void AudioBlockCache::spill (OwnedArray<Block>& removed)
+{
+    // (this is done without the lock held, so the file writing doesn't hold up other readers)
+    if (spillDirectory == File::nonexistent)
+        return;
+
+    for (int i = 0; i < removed.size(); ++i)
+    {
+        const Block& b = *removed.getUnchecked (i);
+        const File file (getSpillFile (b.key.source, b.key.index));
+
+        if (! file.exists())
+        {
+            const File temp (file.getSiblingFile (file.getFileNameWithoutExtension() + ".tmp"));
+
+            {
+                FileOutputStream out (temp);
+
+                if (out.failedToOpen())
+                    continue;
+
+                out.writeInt (b.numChannels);
+                out.writeInt (b.numSamples);
+                out.write (b.data, sizeof (int) * (size_t) (b.numChannels * b.numSamples));
+            }
+
+            temp.moveFileTo (file);
+        }
+    }
+}
+
+AudioBlockCache::Block* AudioBlockCache::readSpilledBlock (const int64 sourceHash, const int64 blockIndex,
+                                                          const int numChannels, const int numSamples) const
+{
+    FileInputStream in (getSpillFile (sourceHash, blockIndex));
+
+    if (in.failedToOpen() || in.readInt() != numChannels || in.readInt() != numSamples)
+        return nullptr;
+
+    ScopedPointer<Block> b (new Block (sourceHash, blockIndex, numChannels, numSamples));
+    const int numBytes = (int) sizeof (int) * numChannels * numSamples;
+
+    if (in.read (b->data, numBytes) != numBytes)
+        return nullptr;
+
+    return b.release();
+}
+
+//==============================================================================
+CachingAudioFormatReader::CachingAudioFormatReader (AudioFormatReader* const sourceReader,
+                                                    AudioBlockCache& cache_,
+                                                    const int64 sourceHash_,
+                                                    const int samplesPerBlock_)
+    : AudioFormatReader (nullptr, sourceReader->getFormatName()),
+      source (sourceReader), cache (cache_),
+      sourceHash (sourceHash_), samplesPerBlock (samplesPerBlock_)
+{
+    jassert (samplesPerBlock > 0);
+
+    sampleRate            = source->sampleRate;
+    lengthInSamples       = source->lengthInSamples;
+    numChannels           = source->numChannels;
+    metadataValues        = source->metadataValues;
+    bitsPerSample         = source->bitsPerSample;
+    usesFloatingPointData = source->usesFloatingPointData;
+}
+
+CachingAudioFormatReader::~CachingAudioFormatReader()
+{
+}
+
+bool CachingAudioFormatReader::readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                            int64 startSampleInFile, int numSamples)
+{
+    clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                       startSampleInFile, numSamples, lengthInSamples);
+
+    for (int i = (int) numChannels; i < numDestChannels; ++i)
+        if (destSamples[i] != nullptr)
+            zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (int) * (size_t) numSamples);
+
+    while (numSamples > 0)
+    {
+        const int64 blockIndex = startSampleInFile / samplesPerBlock;
+        const int64 blockStart = blockIndex * samplesPerBlock;
+        const int blockLength = (int) jmin ((int64) samplesPerBlock, lengthInSamples - blockStart);
+        const int offsetInBlock = (int) (startSampleInFile - blockStart);
+        const int numToDo = jmin (numSamples, blockLength - offsetInBlock);
+
+        if (! cache.readBlock (sourceHash, blockIndex, (int) numChannels, blockLength,
+                               destSamples, numDestChannels, startOffsetInDestBuffer,
+                               offsetInBlock, numToDo))
+        {
+            if (decodedData == nullptr)
+            {
+                decodedData.malloc ((size_t) (samplesPerBlock * (int) numChannels));
+                decodedChannels.malloc ((size_t) numChannels + 1);
+
+                for (int i = 0; i < (int) numChannels; ++i)
+                    decodedChannels[i] = decodedData + i * samplesPerBlock;
+
+                decodedChannels[numChannels] = nullptr;
+            }
+
+            if (! source->read (decodedChannels, (int) numChannels, blockStart, blockLength, false))
+                return false;
+
+            cache.addBlock (sourceHash, blockIndex, (int) numChannels, blockLength, decodedChannels);
+
+            for (int i = jmin (numDestChannels, (int) numChannels); --i >= 0;)
+                if (destSamples[i] != nullptr)
+                    memcpy (destSamples[i] + startOffsetInDestBuffer, decodedChannels[i] + offsetInBlock,
+                            sizeof (int) * (size_t) numToDo);
+        }
+
+        startOffsetInDestBuffer += numToDo;
+        startSampleInFile += numToDo;
+        numSamples -= numToDo;
+    }
+
+    return true;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class CachingAudioFormatReaderTests  : public UnitTest
+{
+public:
+    CachingAudioFormatReaderTests() : UnitTest ("CachingAudioFormatReader") {}
+
+    struct CountingReader  : public AudioFormatReader
+    {
+        CountingReader() : AudioFormatReader (nullptr, "test"), numReads (0)
+        {
+            sampleRate = 44100.0;
+            lengthInSamples = 100000;
+            numChannels = 2;
+            bitsPerSample = 32;
+        }
+
+        bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                          int64 startSampleInFile, int numSamples)
+        {
+            ++numReads;
+
+            for (int chan = 0; chan < numDestChannels; ++chan)
+                if (destSamples[chan] != nullptr)
+                    for (int i = 0; i < numSamples; ++i)
+                        destSamples[chan][startOffsetInDestBuffer + i] = getValue (chan, startSampleInFile + i);
+
+            return true;
+        }
+
+        static int getValue (int chan, int64 pos) noexcept    { return (int) pos * 2 + chan + 1; }
+
+        int numReads;
+    };
+
+    bool checkRead (AudioFormatReader& reader, int64 start, int num)
+    {
+        HeapBlock<int> left ((size_t) num), right ((size_t) num);
+        int* chans[] = { left, right, nullptr };
+
+        if (! reader.read (chans, 2, start, num, false))
+            return false;
+
+        for (int i = 0; i < num; ++i)
+        {
+            const int64 pos = start + i;
+            const bool exists = pos >= 0 && pos < reader.lengthInSamples;
+
+            if (left[i]  != (exists ? CountingReader::getValue (0, pos) : 0)
+             || right[i] != (exists ? CountingReader::getValue (1, pos) : 0))
+                return false;
+        }
+
+        return true;
+    }
+
+    void runTest()
+    {
+        beginTest ("Reading through the cache");
+
+        AudioBlockCache cache (1024 * 1024);
+        CountingReader* source = new CountingReader();
+        CachingAudioFormatReader reader (source, cache, 1234, 4096);
+
+        Random r (0x1234);
+
+        for (int i = 0; i < 200; ++i)
+            expect (checkRead (reader, r.nextInt (110000) - 5000, r.nextInt (10000) + 1));
+
+        // 100000 samples in 4096-sample blocks = 25 blocks, each decoded once
+        expectEquals (source->numReads, 25);
+        expectEquals (cache.getNumMisses(), 25);
+
+        beginTest ("Sharing and eviction");
+
+        CountingReader* source2 = new CountingReader();
+        CachingAudioFormatReader reader2 (source2, cache, 1234, 4096);
+        expect (checkRead (reader2, 0, 100000));
+        expectEquals (source2->numReads, 0);
+
+        cache.setMaximumSize (4 * 4096 * 2 * sizeof (int) + 4 * 1024);
+        expect (cache.getCurrentSize() <= 4 * 4096 * 2 * (int64) sizeof (int) + 4 * 1024);
+        expect (checkRead (reader2, 0, 100000));
+        expectEquals (source2->numReads, 25);
+
+        beginTest ("Spilling to disk");
+
+        const File dir (File::createTempFile ("cache"));
+
+        {
+            AudioBlockCache spillingCache (8 * 4096 * 2 * sizeof (int), dir);
+            CachingAudioFormatReader reader3 (new CountingReader(), spillingCache, 5678, 4096);
+            expect (checkRead (reader3, 0, 100000));
+        }
+
+        {
+            AudioBlockCache spillingCache (8 * 4096 * 2 * sizeof (int), dir);
+            CountingReader* source4 = new CountingReader();
+            CachingAudioFormatReader reader4 (source4, spillingCache, 5678, 4096);
+            expect (checkRead (reader4, 0, 40000));
+            expectEquals (source4->numReads, 0);
+
+            spillingCache.clearSpillDirectory();
+        }
+
+        dir.deleteRecursively();
+    }
+};
+
+static CachingAudioFormatReaderTests cachingAudioFormatReaderTests;
+
+#endif
@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_CACHINGAUDIOFORMATREADER_JUCEHEADER__
+#define __JUCE_CACHINGAUDIOFORMATREADER_JUCEHEADER__
+
+//==============================================================================
+/**
+    A size-limited cache of decoded audio, which can be shared between any number of
+    CachingAudioFormatReader objects.
+
+    The cache holds blocks of decoded samples, keyed by a hash that identifies their source
+    and the index of the block within it. When the cache gets too big, the blocks that
+    were least recently used are discarded.
+
+    If you give it a spill directory, the discarded blocks are written there instead of
+    just being thrown away, and any block that's not in memory will be looked for there
+    before the source is asked to decode it again. As long as the source hashes are stable
+    (see createSourceHash()), this means the decoded data can be reused later on, even by
+    another run of your app. The cache doesn't delete anything in the directory itself, so
+    use clearSpillDirectory() when you want to get rid of the files.
+
+    All of the methods are thread-safe.
+
+    @see CachingAudioFormatReader
+*/
+class JUCE_API  AudioBlockCache
+{
+public:
+    //==============================================================================
+    /** Creates a cache.
+
+        @param maxBytesInMemory     the most memory that the decoded blocks can use
+        @param spillDirectory       if this isn't File::nonexistent, blocks that get removed
+                                    from memory will be written to files in this directory
+    */
+    explicit AudioBlockCache (int64 maxBytesInMemory,
+                              const File& spillDirectory = File::nonexistent);
+
+    /** Destructor. */
+    ~AudioBlockCache();
+
+    //==============================================================================
+    /** Changes the maximum amount of memory that the cache can use. */
+    void setMaximumSize (int64 maxBytesInMemory);
+
+    /** Returns the number of bytes of decoded data currently held in memory. */
+    int64 getCurrentSize() const;
+
+    /** Removes all the blocks from memory (without writing them to the spill directory). */
+    void clear();
+
+    /** Deletes any files that have been written to the spill directory. */
+    void clearSpillDirectory();
+
+    /** Returns the number of block requests that were satisfied from memory or disk. */
+    int getNumHits() const noexcept                 { return numHits.get(); }
+
+    /** Returns the number of block requests that had to be decoded by the source. */
+    int getNumMisses() const noexcept               { return numMisses.get(); }
+
+    //==============================================================================
+    /** Makes a hash that identifies a file, for use as a CachingAudioFormatReader's source hash.
+
+        This combines the file's full path with its size and modification time, so if the file
+        changes, any blocks that were cached for the old version won't be used.
+    */
+    static int64 createSourceHash (const File& file);
+
+private:
+    //==============================================================================
+    friend class CachingAudioFormatReader;
+    struct Block;
+    struct BlockKey;
+    struct BlockKeyHash;
+
+    CriticalSection lock;
+    ScopedPointer<HashMap<BlockKey, Block*, BlockKeyHash> > blocks;
+    Block* mostRecent;
+    Block* leastRecent;
+    int64 maxBytes, currentBytes;
+    const File spillDirectory;
+    Atomic<int> numHits, numMisses;
+
+    bool readBlock (int64 sourceHash, int64 blockIndex, int numChannels, int numSamples,
+                    int* const* dest, int numDestChannels, int destOffset,
+                    int offsetInBlock, int numToCopy);
+
+    void addBlock (int64 sourceHash, int64 blockIndex, int numChannels, int numSamples,
+                   const int* const* data);
+
+    void insert (Block*);
+    void unlink (Block*) noexcept;
+    void removeExcessBlocks (OwnedArray<Block>& removed);
+    void spill (OwnedArray<Block>& removed);
+    File getSpillFile (int64 sourceHash, int64 blockIndex) const;
+    Block* readSpilledBlock (int64 sourceHash, int64 blockIndex, int numChannels, int numSamples) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioBlockCache)
+};
+
+
+//==============================================================================
+/**
+    An AudioFormatReader that keeps the data it decodes in an AudioBlockCache.
+
+    Wrapping a reader for a compressed format (FLAC, Ogg-Vorbis, MP3, etc.) in one of
+    these makes random access much cheaper, because a section that has been read before
+    doesn't need to be seeked to and decoded again. That helps with things like scrubbing
+    and drawing waveforms.
+
+    The data is read from the source in whole blocks, so a read that touches part of
+    a block that isn't cached will decode the whole of it.
+
+    @see AudioBlockCache, AudioFormatReader
+*/
+class JUCE_API  CachingAudioFormatReader  : public AudioFormatReader
+{
+public:
+    /** Creates a reader.
+
+        @param sourceReader     the source reader to wrap. This CachingAudioFormatReader
+                                takes ownership of this object and will delete it later
+                                when no longer needed
+        @param cache            the cache to use. This mustn't be deleted while the
+                                reader still exists
+        @param sourceHash       a number that uniquely identifies the source's data - readers
+                                with the same hash will share the same cached blocks. For
+                                files, you can use AudioBlockCache::createSourceHash()
+        @param samplesPerBlock  the number of samples in each cached block
+    */
+    CachingAudioFormatReader (AudioFormatReader* sourceReader,
+                              AudioBlockCache& cache,
+                              int64 sourceHash,
+                              int samplesPerBlock = 16384);
+
+    /** Destructor. */
+    ~CachingAudioFormatReader();
+
+    bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      int64 startSampleInFile, int numSamples);
+
+private:
+    ScopedPointer<AudioFormatReader> source;
+    AudioBlockCache& cache;
+    const int64 sourceHash;
+    const int samplesPerBlock;
+    HeapBlock<int> decodedData;
+    HeapBlock<int*> decodedChannels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachingAudioFormatReader)
+};
+
+
+#endif   // __JUCE_CACHINGAUDIOFORMATREADER_JUCEHEADER__
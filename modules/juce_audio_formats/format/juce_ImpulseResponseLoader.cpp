@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+ImpulseResponseLoader::ImpulseResponseLoader (ConvolutionAudioSource& target_)
+    : Thread ("Impulse response loader"),
+      target (target_),
+      maxLength (0)
+{
+}
+
+ImpulseResponseLoader::~ImpulseResponseLoader()
+{
+    stopThread (10000);
+}
+
+void ImpulseResponseLoader::loadImpulseResponse (AudioFormatReader* const newReader, const double maxLengthSeconds)
+{
+    stopThread (10000);
+
+    reader = newReader;
+    maxLength = maxLengthSeconds;
+
+    if (reader != nullptr)
+        startThread (3);
+}
+
+void ImpulseResponseLoader::run()
+{
+    int64 length = reader->lengthInSamples;
+
+    if (maxLength > 0)
+        length = jmin (length, (int64) (maxLength * reader->sampleRate));
+
+    const int numSamples = (int) jmin ((int64) std::numeric_limits<int>::max(), length);
+    const int numChannels = jmax (1, (int) reader->numChannels);
+
+    AudioSampleBuffer buffer (numChannels, numSamples);
+    HeapBlock<int*> channels ((size_t) numChannels + 1, true);
+    const int blockSize = 65536;
+
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        if (threadShouldExit())
+            return;
+
+        const int num = jmin (blockSize, numSamples - start);
+
+        for (int i = 0; i < numChannels; ++i)
+            channels[i] = reinterpret_cast<int*> (buffer.getSampleData (i, start));
+
+        reader->read (channels, numChannels, start, num, true);
+
+        if (! reader->usesFloatingPointData)
+        {
+            const float multiplier = 1.0f / 0x7fffffff;
+
+            for (int i = 0; i < numChannels; ++i)
+            {
+                float* const d = buffer.getSampleData (i, start);
+
+                for (int j = 0; j < num; ++j)
+                    d[j] = *reinterpret_cast<int*> (d + j) * multiplier;
+            }
+        }
+    }
+
+    if (! threadShouldExit())
+        target.setImpulseResponse (buffer, reader->sampleRate);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImpulseResponseLoaderTests  : public UnitTest
+{
+public:
+    ImpulseResponseLoaderTests() : UnitTest ("ImpulseResponseLoader") {}
+
+    struct ImpulseSource  : public AudioSource
+    {
+        ImpulseSource() : position (0) {}
+
+        void prepareToPlay (int, double)     { position = 0; }
+        void releaseResources()              {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info)
+        {
+            info.clearActiveBufferRegion();
+
+            if (position == 0 && info.numSamples > 0)
+                for (int i = info.buffer->getNumChannels(); --i >= 0;)
+                    *info.buffer->getSampleData (i, info.startSample) = 1.0f;
+
+            position += info.numSamples;
+        }
+
+        int position;
+    };
+
+    void runTest()
+    {
+        beginTest ("Loading and resampling");
+
+        // a response at 22050Hz with a single spike at 100 samples..
+        MemoryBlock wavData;
+
+        {
+            AudioSampleBuffer response (1, 1000);
+            response.clear();
+            *response.getSampleData (0, 100) = 0.5f;
+
+            WavAudioFormat wav;
+            ScopedPointer<AudioFormatWriter> writer (wav.createWriterFor (new MemoryOutputStream (wavData, false),
+                                                                          22050.0, 1, 24, StringPairArray(), 0));
+            expect (writer != nullptr);
+            writer->writeFromAudioSampleBuffer (response, 0, 1000);
+        }
+
+        ImpulseSource impulse;
+        ConvolutionAudioSource convolver (&impulse, false, 2);
+        convolver.prepareToPlay (512, 44100.0);
+
+        {
+            ImpulseResponseLoader loader (convolver);
+
+            WavAudioFormat wav;
+            loader.loadImpulseResponse (wav.createReaderFor (new MemoryInputStream (wavData, false), true));
+
+            for (int i = 0; i < 500 && loader.isLoading(); ++i)
+                Thread::sleep (10);
+
+            expect (! loader.isLoading());
+        }
+
+        // ..played back at 44100Hz, the spike should be at 200 samples, with the same overall gain
+        AudioSampleBuffer output (2, 4096);
+
+        for (int start = 0; start < 4096; start += 512)
+            convolver.getNextAudioBlock (AudioSourceChannelInfo (&output, start, 512));
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            const float* const data = output.getSampleData (channel);
+            int peak = 0;
+            double sum = 0;
+
+            for (int i = 0; i < 4096; ++i)
+            {
+                sum += data[i];
+
+                if (std::abs (data[i]) > std::abs (data[peak]))
+                    peak = i;
+            }
+
+            expect (std::abs (peak - 200) <= 1);
+            expect (std::abs (sum - 0.5) < 0.01);
+        }
+    }
+};
+
+static ImpulseResponseLoaderTests impulseResponseLoaderTests;
+
+#endif
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_IMPULSERESPONSELOADER_JUCEHEADER__
+#define __JUCE_IMPULSERESPONSELOADER_JUCEHEADER__
+
+#include "juce_AudioFormatReader.h"
+
+
+//==============================================================================
+/**
+    Reads impulse responses from AudioFormatReaders on a background thread, and gives
+    them to a ConvolutionAudioSource.
+
+    The reading and the preparation of the convolution both happen on this object's
+    thread, so the audio keeps playing while a new response is loaded.
+
+    @see ConvolutionAudioSource
+*/
+class JUCE_API  ImpulseResponseLoader  : private Thread
+{
+public:
+    //==============================================================================
+    /** Creates a loader that will send its responses to the given source.
+        The source must not be deleted before this object.
+    */
+    explicit ImpulseResponseLoader (ConvolutionAudioSource& target);
+
+    /** Destructor.
+        If a response is being loaded, this waits for the load to be abandoned.
+    */
+    ~ImpulseResponseLoader();
+
+    //==============================================================================
+    /** Starts reading a new impulse response in the background.
+
+        Any load that's already in progress is abandoned.
+
+        @param reader               the reader to load from - this object takes ownership of it
+        @param maxLengthSeconds     if greater than 0, the response is truncated to this length
+    */
+    void loadImpulseResponse (AudioFormatReader* reader, double maxLengthSeconds = 0);
+
+    /** Returns true if a response is still being loaded. */
+    bool isLoading() const                                      { return isThreadRunning(); }
+
+private:
+    //==============================================================================
+    ConvolutionAudioSource& target;
+    ScopedPointer<AudioFormatReader> reader;
+    double maxLength;
+
+    void run();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ImpulseResponseLoader)
+};
+
+
+#endif   // __JUCE_IMPULSERESPONSELOADER_JUCEHEADER__
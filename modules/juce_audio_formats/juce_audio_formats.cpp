@@ -105,6 +105,8 @@ namespace juce
 #include "format/juce_AudioFormatWriter.cpp"
 #include "format/juce_AudioSubsectionReader.cpp"
 #include "format/juce_BufferingAudioFormatReader.cpp"
+#include "format/juce_CachingAudioFormatReader.cpp"
+#include "format/juce_ImpulseResponseLoader.cpp"
 #include "sampler/juce_Sampler.cpp"
 #include "codecs/juce_AiffAudioFormat.cpp"
 #include "codecs/juce_CoreAudioFormat.cpp"
@@ -108,6 +108,12 @@ namespace juce
 #ifndef __JUCE_BUFFERINGAUDIOFORMATREADER_JUCEHEADER__
  #include "format/juce_BufferingAudioFormatReader.h"
 #endif
+#ifndef __JUCE_CACHINGAUDIOFORMATREADER_JUCEHEADER__
+ #include "format/juce_CachingAudioFormatReader.h"
+#endif
+#ifndef __JUCE_IMPULSERESPONSELOADER_JUCEHEADER__
+ #include "format/juce_ImpulseResponseLoader.h"
+#endif
 #ifndef __JUCE_MEMORYMAPPEDAUDIOFORMATREADER_JUCEHEADER__
  #include "format/juce_MemoryMappedAudioFormatReader.h"
 #endif
@@ -29,12 +29,45 @@ SamplerSound::SamplerSound (const String& name_,
                             const int midiNoteForNormalPitch,
                             const double attackTimeSecs,
                             const double releaseTimeSecs,
-                            const double maxSampleLengthSeconds)
+                            const double maxSampleLengthSeconds,
+                            const StorageFormat storageFormat_)
     : name (name_),
+      storageFormat (storageFormat_),
       midiNotes (midiNotes_),
       midiRootNote (midiNoteForNormalPitch)
+{
+    initialise (source, attackTimeSecs, releaseTimeSecs, maxSampleLengthSeconds, std::numeric_limits<int>::max());
+}
+
+SamplerSound::SamplerSound (const String& name_,
+                            AudioFormatReader& source,
+                            const BigInteger& midiNotes_,
+                            const int midiNoteForNormalPitch,
+                            const double attackTimeSecs,
+                            const double releaseTimeSecs,
+                            const double maxSampleLengthSeconds,
+                            const int maxSamplesToLoad)
+    : name (name_),
+      storageFormat (storeAsFloat),
+      midiNotes (midiNotes_),
+      midiRootNote (midiNoteForNormalPitch)
+{
+    initialise (source, attackTimeSecs, releaseTimeSecs, maxSampleLengthSeconds, maxSamplesToLoad);
+}
+
+SamplerSound::~SamplerSound()
+{
+}
+
+void SamplerSound::initialise (AudioFormatReader& source,
+                               const double attackTimeSecs,
+                               const double releaseTimeSecs,
+                               const double maxSampleLengthSeconds,
+                               const int maxSamplesToLoad)
 {
     sourceSampleRate = source.sampleRate;
+    numStoredChannels = 0;
+    numStoredSamples = 0;
 
     if (sourceSampleRate <= 0 || source.lengthInSamples <= 0)
     {
@@ -47,17 +80,126 @@ SamplerSound::SamplerSound (const String& name_,
         length = jmin ((int) source.lengthInSamples,
                        (int) (maxSampleLengthSeconds * sourceSampleRate));
 
-        data = new AudioSampleBuffer (jmin (2, (int) source.numChannels), length + 4);
+        const int numToLoad = jmin (length, jmax (0, maxSamplesToLoad));
 
-        source.read (data, 0, length + 4, 0, true, true);
+        numStoredChannels = jmin (2, (int) source.numChannels);
+        numStoredSamples = numToLoad + 4;
+
+        if (storageFormat == storeAsFloat)
+        {
+            data = new AudioSampleBuffer (numStoredChannels, numStoredSamples);
+            source.read (data, 0, numStoredSamples, 0, true, true);
+        }
+        else
+        {
+            loadPacked (source, numStoredSamples);
+        }
 
         attackSamples = roundToInt (attackTimeSecs * sourceSampleRate);
         releaseSamples = roundToInt (releaseTimeSecs * sourceSampleRate);
     }
 }
 
-SamplerSound::~SamplerSound()
+void SamplerSound::loadPacked (AudioFormatReader& source, const int numSamples)
 {
+    const int bytesPerSample = getBytesPerSample();
+    const float scale = storageFormat == storeAsInt16 ? 32768.0f : 8388608.0f;
+    const int maxValue = (int) scale - 1;
+
+    packedData.malloc ((size_t) (numStoredChannels * numSamples * bytesPerSample));
+
+    AudioSampleBuffer temp (numStoredChannels, jmin (numSamples, 8192));
+
+    for (int pos = 0; pos < numSamples;)
+    {
+        const int num = jmin (numSamples - pos, temp.getNumSamples());
+        source.read (&temp, 0, num, pos, true, true);
+
+        for (int chan = 0; chan < numStoredChannels; ++chan)
+        {
+            const float* const src = temp.getSampleData (chan);
+            char* const dest = packedData + (chan * numSamples + pos) * bytesPerSample;
+
+            for (int i = 0; i < num; ++i)
+            {
+                const int value = jlimit (-maxValue - 1, maxValue, roundToInt (src[i] * scale));
+
+                if (storageFormat == storeAsInt16)
+                    reinterpret_cast <int16*> (dest) [i] = (int16) value;
+                else
+                    ByteOrder::littleEndian24BitToChars (value, dest + i * 3);
+            }
+        }
+
+        pos += num;
+    }
+}
+
+int SamplerSound::getBytesPerSample() const noexcept
+{
+    switch (storageFormat)
+    {
+        case storeAsInt16:  return 2;
+        case storeAsInt24:  return 3;
+        default:            return (int) sizeof (float);
+    }
+}
+
+size_t SamplerSound::getMemoryUsage() const noexcept
+{
+    return (size_t) (numStoredChannels * numStoredSamples * getBytesPerSample());
+}
+
+void SamplerSound::readSamples (float* const* const dest, int startSample, int numSamples) const noexcept
+{
+    for (int chan = 0; chan < numStoredChannels; ++chan)
+    {
+        float* d = dest [chan];
+        int start = startSample, num = numSamples;
+
+        if (start < 0)
+        {
+            const int numBefore = jmin (num, -start);
+            FloatVectorOperations::clear (d, numBefore);
+            d += numBefore;
+            start += numBefore;
+            num -= numBefore;
+        }
+
+        const int numAvailable = jlimit (0, jmax (0, num), numStoredSamples - start);
+
+        if (num > numAvailable)
+            FloatVectorOperations::clear (d + numAvailable, num - numAvailable);
+
+        if (numAvailable <= 0)
+            continue;
+
+        switch (storageFormat)
+        {
+            case storeAsInt16:
+                FloatVectorOperations::convertFixedToFloat (d, reinterpret_cast <const int16*> (packedData.getData())
+                                                                 + chan * numStoredSamples + start,
+                                                            1.0f / 32768.0f, numAvailable);
+                break;
+
+            case storeAsInt24:
+            {
+                const char* src = packedData + (chan * numStoredSamples + start) * 3;
+
+                for (int i = 0; i < numAvailable; ++i)
+                {
+                    d[i] = ByteOrder::littleEndian24Bit (src) * (1.0f / 8388608.0f);
+                    src += 3;
+                }
+
+                break;
+            }
+
+            default:
+                FloatVectorOperations::copy (d, data->getSampleData (chan, start), numAvailable);
+                break;
+        }
+    }
 }
 
 bool SamplerSound::appliesToNote (const int midiNoteNumber)
@@ -70,9 +212,257 @@ bool SamplerSound::appliesToChannel (const int /*midiChannel*/)
     return true;
 }
 
+//==============================================================================
+StreamingSamplerSound::StreamingSamplerSound (const String& name_,
+                                              AudioFormatReader* const source,
+                                              const BigInteger& midiNotes_,
+                                              const int midiNoteForNormalPitch,
+                                              const double attackTimeSecs,
+                                              const double releaseTimeSecs,
+                                              const double maxSampleLengthSeconds,
+                                              const double preloadTimeSecs)
+    : SamplerSound (name_, *source, midiNotes_, midiNoteForNormalPitch,
+                    attackTimeSecs, releaseTimeSecs, maxSampleLengthSeconds,
+                    roundToInt (preloadTimeSecs * source->sampleRate)),
+      reader (source)
+{
+    numPreloaded = getAudioData() != nullptr ? getAudioData()->getNumSamples() - 4 : 0;
+}
+
+StreamingSamplerSound::~StreamingSamplerSound()
+{
+}
+
+void StreamingSamplerSound::readStreamedSamples (AudioSampleBuffer& dest, const int destStartSample,
+                                                 const int numSamples, const int sourceStartSample)
+{
+    const ScopedLock sl (readerLock);
+    reader->read (&dest, destStartSample, numSamples, sourceStartSample, true, true);
+}
+
+//==============================================================================
+/** The ring buffer that a SamplerVoice plays a StreamingSamplerSound from.
+
+    The voice reads samples between its read position and the end of the valid
+    region, and the background thread fills the space after that, up to one buffer's
+    length ahead of the read position. Each time the voice starts a new note, the
+    generation count changes, so that a fill which was in progress for the old note
+    doesn't get marked as valid.
+*/
+class SamplerVoice::Stream  : public TimeSliceClient
+{
+public:
+    Stream (TimeSliceThread& thread_, const int bufferSize)
+        : thread (thread_),
+          buffer (2, jmax (1024, bufferSize)),
+          generation (0),
+          readPosition (0),
+          validEnd (0),
+          streamEnd (0)
+    {
+        buffer.clear();
+        thread.addTimeSliceClient (this);
+    }
+
+    ~Stream()
+    {
+        thread.removeTimeSliceClient (this);
+    }
+
+    /** Starts streaming a sound from the given position. (Called by the voice). */
+    void start (StreamingSamplerSound* const newSound, const int startSample, const int endSample)
+    {
+        SynthesiserSound::Ptr oldSound; // (so that the old sound isn't released while the lock is held)
+
+        {
+            const SpinLock::ScopedLockType sl (lock);
+            oldSound = sound;
+            sound = newSound;
+            readPosition = validEnd = startSample;
+            streamEnd = endSample;
+            ++generation;
+        }
+
+        // (this only takes the thread's list lock, which is never held for long)
+        if (newSound != nullptr)
+            thread.moveToFrontOfQueue (this);
+    }
+
+    void stop()                                 { start (nullptr, 0, 0); }
+
+    /** Returns the end of the region that the voice can currently read. */
+    int getValidEnd() const noexcept
+    {
+        const SpinLock::ScopedLockType sl (lock);
+        return validEnd;
+    }
+
+    /** Tells the stream that the voice has finished with the samples before this position. */
+    void setReadPosition (const int newPosition) noexcept
+    {
+        const SpinLock::ScopedLockType sl (lock);
+        readPosition = jmax (readPosition, newPosition);
+    }
+
+    int getReadPosition() const noexcept
+    {
+        const SpinLock::ScopedLockType sl (lock);
+        return readPosition;
+    }
+
+    const AudioSampleBuffer& getBuffer() const noexcept     { return buffer; }
+
+    int useTimeSlice()
+    {
+        SynthesiserSound::Ptr s;
+        int g, start, end, limit;
+
+        {
+            const SpinLock::ScopedLockType sl (lock);
+            s = sound;
+            g = generation;
+            start = readPosition;
+            end = validEnd;
+            limit = streamEnd;
+        }
+
+        StreamingSamplerSound* const streamingSound = static_cast <StreamingSamplerSound*> (s.get());
+
+        if (streamingSound == nullptr)
+            return 20;
+
+        const int size = buffer.getNumSamples();
+        const int num = jmin (jmin (start + size, limit) - end, 8192);
+
+        if (num <= 0)
+            return 5;
+
+        const int bufferPos = end % size;
+        const int num1 = jmin (num, size - bufferPos);
+
+        streamingSound->readStreamedSamples (buffer, bufferPos, num1, end);
+
+        if (num > num1)
+            streamingSound->readStreamedSamples (buffer, 0, num - num1, end + num1);
+
+        {
+            const SpinLock::ScopedLockType sl (lock);
+
+            if (generation == g)
+                validEnd = end + num;
+        }
+
+        return 0;
+    }
+
+private:
+    TimeSliceThread& thread;
+    AudioSampleBuffer buffer;
+    SpinLock lock;
+    SynthesiserSound::Ptr sound;
+    int generation, readPosition, validEnd, streamEnd;
+
+    JUCE_DECLARE_NON_COPYABLE (Stream)
+};
+
+//==============================================================================
+namespace SamplerHelpers
+{
+    struct InMemorySource
+    {
+        InMemorySource (const AudioSampleBuffer& data)
+            : inL (data.getReadPointer (0, 0)),
+              inR (data.getNumChannels() > 1 ? data.getReadPointer (1, 0) : nullptr)
+        {
+        }
+
+        bool isStereo() const noexcept              { return inR != nullptr; }
+        float getLeft (const int pos) const noexcept    { return inL [pos]; }
+        float getRight (const int pos) const noexcept   { return inR [pos]; }
+
+        const float* inL;
+        const float* inR;
+    };
+
+    struct StreamedSource
+    {
+        StreamedSource (const AudioSampleBuffer& preloaded, const int numPreloaded_,
+                        const AudioSampleBuffer& ring, const int validStart_, const int validEnd_)
+            : preL (preloaded.getReadPointer (0, 0)),
+              preR (preloaded.getNumChannels() > 1 ? preloaded.getReadPointer (1, 0) : nullptr),
+              ringL (ring.getReadPointer (0, 0)),
+              ringR (ring.getReadPointer (1, 0)),
+              numPreloaded (numPreloaded_),
+              ringSize (ring.getNumSamples()),
+              validStart (validStart_),
+              validEnd (validEnd_)
+        {
+        }
+
+        bool isStereo() const noexcept              { return preR != nullptr; }
+        float getLeft (const int pos) const noexcept    { return get (preL, ringL, pos); }
+        float getRight (const int pos) const noexcept   { return get (preR, ringR, pos); }
+
+        float get (const float* pre, const float* ring, const int pos) const noexcept
+        {
+            if (pos < numPreloaded)
+                return pre [pos];
+
+            if (pos >= validStart && pos < validEnd)
+                return ring [pos % ringSize];
+
+            return 0.0f; // (the disk hasn't kept up - there's not much we can do about it here!)
+        }
+
+        const float* preL;
+        const float* preR;
+        const float* ringL;
+        const float* ringR;
+        int numPreloaded, ringSize, validStart, validEnd;
+    };
+
+    /* Plays a section of a sound that's stored as integers, after the voice has converted
+       it into its decode buffer. The first sample in the buffer is firstSample.
+    */
+    struct DecodedSource
+    {
+        enum { maxSamples = 1024 };
+
+        DecodedSource (const float* const* channels, const int numChannels, const int firstSample_)
+            : inL (channels[0]),
+              inR (numChannels > 1 ? channels[1] : nullptr),
+              firstSample (firstSample_)
+        {
+        }
+
+        bool isStereo() const noexcept                  { return inR != nullptr; }
+        float getLeft (const int pos) const noexcept    { return inL [pos - firstSample]; }
+        float getRight (const int pos) const noexcept   { return inR [pos - firstSample]; }
+
+        const float* inL;
+        const float* inR;
+        int firstSample;
+    };
+}
+
 //==============================================================================
 SamplerVoice::SamplerVoice()
-    : pitchRatio (0.0),
+    : isStreaming (false),
+      decodeBuffer (2 * SamplerHelpers::DecodedSource::maxSamples),
+      pitchRatio (0.0),
+      sourceSamplePosition (0.0),
+      lgain (0.0f),
+      rgain (0.0f),
+      isInAttack (false),
+      isInRelease (false)
+{
+}
+
+SamplerVoice::SamplerVoice (TimeSliceThread& streamingThread, const int streamBufferSizeSamples)
+    : stream (new Stream (streamingThread, streamBufferSizeSamples)),
+      isStreaming (false),
+      decodeBuffer (2 * SamplerHelpers::DecodedSource::maxSamples),
+      pitchRatio (0.0),
       sourceSamplePosition (0.0),
       lgain (0.0f),
       rgain (0.0f),
@@ -97,6 +487,17 @@ void SamplerVoice::startNote (const int midiNoteNumber,
 {
     if (const SamplerSound* const sound = dynamic_cast <const SamplerSound*> (s))
     {
+        StreamingSamplerSound* const streamingSound = dynamic_cast <StreamingSamplerSound*> (s);
+        isStreaming = streamingSound != nullptr && stream != nullptr
+                        && streamingSound->getNumPreloadedSamples() < sound->length;
+
+        // To play the whole of a StreamingSamplerSound, the voice needs to have been
+        // created with a TimeSliceThread!
+        jassert (streamingSound == nullptr || stream != nullptr);
+
+        if (isStreaming)
+            stream->start (streamingSound, streamingSound->getNumPreloadedSamples(), sound->length + 4);
+
         pitchRatio = pow (2.0, (midiNoteNumber - sound->midiRootNote) / 12.0)
                         * sound->sourceSampleRate / getSampleRate();
 
@@ -139,6 +540,12 @@ void SamplerVoice::stopNote (const bool allowTailOff)
     else
     {
         clearCurrentNote();
+
+        if (isStreaming)
+        {
+            isStreaming = false;
+            stream->stop();
+        }
     }
 }
 
@@ -156,71 +563,328 @@ void SamplerVoice::renderNextBlock (AudioSampleBuffer& outputBuffer, int startSa
 {
     if (const SamplerSound* const playingSound = static_cast <SamplerSound*> (getCurrentlyPlayingSound().get()))
     {
-        const float* const inL = playingSound->data->getSampleData (0, 0);
-        const float* const inR = playingSound->data->getNumChannels() > 1
-                                    ? playingSound->data->getSampleData (1, 0) : nullptr;
+        if (playingSound->storageFormat != SamplerSound::storeAsFloat)
+        {
+            if (playingSound->packedData != nullptr)
+                renderPacked (*playingSound, outputBuffer, startSample, numSamples);
+
+            return;
+        }
 
-        float* outL = outputBuffer.getSampleData (0, startSample);
-        float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getSampleData (1, startSample) : nullptr;
+        if (playingSound->data == nullptr)
+            return;
 
-        while (--numSamples >= 0)
+        if (isStreaming)
         {
-            const int pos = (int) sourceSamplePosition;
-            const float alpha = (float) (sourceSamplePosition - pos);
-            const float invAlpha = 1.0f - alpha;
+            const SamplerHelpers::StreamedSource source (*playingSound->data,
+                                                         static_cast <const StreamingSamplerSound*> (playingSound)->getNumPreloadedSamples(),
+                                                         stream->getBuffer(), stream->getReadPosition(), stream->getValidEnd());
 
-            // just using a very simple linear interpolation here..
-            float l = (inL [pos] * invAlpha + inL [pos + 1] * alpha);
-            float r = (inR != nullptr) ? (inR [pos] * invAlpha + inR [pos + 1] * alpha)
-                                       : l;
+            renderFrom (source, playingSound->length, outputBuffer, startSample, numSamples);
 
-            l *= lgain;
-            r *= rgain;
+            if (isStreaming)
+                stream->setReadPosition ((int) sourceSamplePosition);
+        }
+        else
+        {
+            // (if this is a streaming sound and we can't stream, only the preloaded part can be played)
+            renderFrom (SamplerHelpers::InMemorySource (*playingSound->data),
+                        jmin (playingSound->length, playingSound->data->getNumSamples() - 4),
+                        outputBuffer, startSample, numSamples);
+        }
+    }
+}
 
-            if (isInAttack)
-            {
-                l *= attackReleaseLevel;
-                r *= attackReleaseLevel;
+void SamplerVoice::renderPacked (const SamplerSound& sound, AudioSampleBuffer& outputBuffer,
+                                 int startSample, int numSamples)
+{
+    const int maxSamples = SamplerHelpers::DecodedSource::maxSamples;
+    float* const channels[] = { decodeBuffer, decodeBuffer + maxSamples };
+    const int length = jmin (sound.length, sound.numStoredSamples - 4);
 
-                attackReleaseLevel += attackDelta;
+    // Each chunk converts the section of the sound that the next few output samples will
+    // need (plus a sample's margin for rounding errors in the position), and then plays it
+    // like a normal in-memory sound.
+    const int maxOutputSamplesPerChunk = jmax (1, (int) ((maxSamples - 4) / jmax (1.0, pitchRatio)) - 1);
 
-                if (attackReleaseLevel >= 1.0f)
-                {
-                    attackReleaseLevel = 1.0f;
-                    isInAttack = false;
-                }
-            }
-            else if (isInRelease)
-            {
-                l *= attackReleaseLevel;
-                r *= attackReleaseLevel;
+    while (numSamples > 0)
+    {
+        const int numThisTime = jmin (numSamples, maxOutputSamplesPerChunk);
+        const int firstSample = (int) sourceSamplePosition;
+        const int lastSample = (int) (sourceSamplePosition + numThisTime * pitchRatio) + 2;
 
-                attackReleaseLevel += releaseDelta;
+        sound.readSamples (channels, firstSample, jmin (maxSamples, lastSample - firstSample + 1));
 
-                if (attackReleaseLevel <= 0.0f)
-                {
-                    stopNote (false);
-                    break;
-                }
-            }
+        renderFrom (SamplerHelpers::DecodedSource (channels, sound.numStoredChannels, firstSample),
+                    length, outputBuffer, startSample, numThisTime);
 
-            if (outR != nullptr)
-            {
-                *outL++ += l;
-                *outR++ += r;
-            }
-            else
+        if (getCurrentlyPlayingSound() == nullptr)
+            break;
+
+        startSample += numThisTime;
+        numSamples -= numThisTime;
+    }
+}
+
+template <class SourceType>
+void SamplerVoice::renderFrom (const SourceType& source, const int length,
+                               AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+    float* outL = outputBuffer.getSampleData (0, startSample);
+    float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getSampleData (1, startSample) : nullptr;
+
+    while (--numSamples >= 0)
+    {
+        const int pos = (int) sourceSamplePosition;
+        const float alpha = (float) (sourceSamplePosition - pos);
+        const float invAlpha = 1.0f - alpha;
+
+        // just using a very simple linear interpolation here..
+        float l = (source.getLeft (pos) * invAlpha + source.getLeft (pos + 1) * alpha);
+        float r = source.isStereo() ? (source.getRight (pos) * invAlpha + source.getRight (pos + 1) * alpha)
+                                    : l;
+
+        l *= lgain;
+        r *= rgain;
+
+        if (isInAttack)
+        {
+            l *= attackReleaseLevel;
+            r *= attackReleaseLevel;
+
+            attackReleaseLevel += attackDelta;
+
+            if (attackReleaseLevel >= 1.0f)
             {
-                *outL++ += (l + r) * 0.5f;
+                attackReleaseLevel = 1.0f;
+                isInAttack = false;
             }
+        }
+        else if (isInRelease)
+        {
+            l *= attackReleaseLevel;
+            r *= attackReleaseLevel;
 
-            sourceSamplePosition += pitchRatio;
+            attackReleaseLevel += releaseDelta;
 
-            if (sourceSamplePosition > playingSound->length)
+            if (attackReleaseLevel <= 0.0f)
             {
                 stopNote (false);
                 break;
             }
         }
+
+        if (outR != nullptr)
+        {
+            *outL++ += l;
+            *outR++ += r;
+        }
+        else
+        {
+            *outL++ += (l + r) * 0.5f;
+        }
+
+        sourceSamplePosition += pitchRatio;
+
+        if (sourceSamplePosition > length)
+        {
+            stopNote (false);
+            break;
+        }
     }
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SamplerTests  : public UnitTest
+{
+public:
+    SamplerTests() : UnitTest ("Sampler") {}
+
+    static AudioFormatReader* createTestReader (const MemoryBlock& wavData)
+    {
+        WavAudioFormat wav;
+        return wav.createReaderFor (new MemoryInputStream (wavData, false), true);
+    }
+
+    // writes a 24-bit stereo wav file containing a pair of sine waves
+    static bool createTestWav (MemoryBlock& wavData, const int numSamples)
+    {
+        AudioSampleBuffer source (2, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            *source.getSampleData (0, i) = (float) std::sin (i * 0.01) * 0.5f;
+            *source.getSampleData (1, i) = (float) std::sin (i * 0.013) * 0.5f;
+        }
+
+        WavAudioFormat wav;
+        ScopedPointer<AudioFormatWriter> writer (wav.createWriterFor (new MemoryOutputStream (wavData, false),
+                                                                      44100.0, 2, 24, StringPairArray(), 0));
+        return writer != nullptr && writer->writeFromAudioSampleBuffer (source, 0, numSamples);
+    }
+
+    static void render (Synthesiser& synth, AudioSampleBuffer& result, const bool waitForStream)
+    {
+        synth.setCurrentPlaybackSampleRate (44100.0);
+        result.clear();
+
+        MidiBuffer midi;
+        midi.addEvent (MidiMessage::noteOn (1, 60, 1.0f), 10);
+
+        for (int pos = 0; pos < result.getNumSamples(); pos += 256)
+        {
+            synth.renderNextBlock (result, midi, pos, jmin (256, result.getNumSamples() - pos));
+
+            if (waitForStream)
+                Thread::sleep (2);
+        }
+    }
+
+    void runTest()
+    {
+        beginTest ("Streaming");
+
+        const int numSamples = 30000;
+        MemoryBlock wavData;
+        expect (createTestWav (wavData, numSamples));
+
+        BigInteger notes;
+        notes.setRange (0, 128, true);
+
+        AudioSampleBuffer inMemory (2, numSamples + 1000), streamed (2, numSamples + 1000);
+
+        {
+            ScopedPointer<AudioFormatReader> reader (createTestReader (wavData));
+            Synthesiser synth;
+            synth.addVoice (new SamplerVoice());
+            synth.addSound (new SamplerSound ("test", *reader, notes, 60, 0.001, 0.001, 10.0));
+            render (synth, inMemory, false);
+        }
+
+        {
+            TimeSliceThread thread ("Sampler streaming test");
+            thread.startThread();
+
+            {
+                Synthesiser synth;
+                synth.addVoice (new SamplerVoice (thread, 4096));
+                synth.addSound (new StreamingSamplerSound ("test", createTestReader (wavData),
+                                                           notes, 60, 0.001, 0.001, 10.0, 0.05));
+
+                expectEquals (static_cast <StreamingSamplerSound*> (synth.getSound (0))->getNumPreloadedSamples(), 2205);
+                render (synth, streamed, true);
+            }
+
+            thread.stopThread (1000);
+        }
+
+        bool matches = true;
+
+        for (int chan = 0; chan < 2; ++chan)
+            for (int i = 0; i < inMemory.getNumSamples(); ++i)
+                matches = matches && std::abs (*inMemory.getSampleData (chan, i) - *streamed.getSampleData (chan, i)) < 1.0e-6f;
+
+        expect (inMemory.getMagnitude (0, numSamples) > 0.4f);
+        expect (matches, "streamed sample didn't match the in-memory one");
+
+        beginTest ("Integer storage");
+
+        for (int format = SamplerSound::storeAsInt16; format <= SamplerSound::storeAsInt24; ++format)
+        {
+            AudioSampleBuffer packed (2, numSamples + 1000);
+            size_t memoryUsage;
+
+            {
+                ScopedPointer<AudioFormatReader> reader (createTestReader (wavData));
+                Synthesiser synth;
+                synth.addVoice (new SamplerVoice());
+
+                SamplerSound* const sound = new SamplerSound ("test", *reader, notes, 60, 0.001, 0.001, 10.0,
+                                                              (SamplerSound::StorageFormat) format);
+                synth.addSound (sound);
+                expect (sound->getAudioData() == nullptr);
+                memoryUsage = sound->getMemoryUsage();
+                render (synth, packed, false);
+            }
+
+            // the test file is 24-bit, so only the 16-bit version loses anything
+            const float tolerance = format == SamplerSound::storeAsInt24 ? 0.0f : 1.0e-4f;
+            matches = true;
+
+            for (int chan = 0; chan < 2; ++chan)
+                for (int i = 0; i < inMemory.getNumSamples(); ++i)
+                    matches = matches && std::abs (*inMemory.getSampleData (chan, i) - *packed.getSampleData (chan, i)) <= tolerance;
+
+            expect (matches, "integer storage didn't match the float version");
+            expectEquals ((int) memoryUsage, 2 * (numSamples + 4) * (format == SamplerSound::storeAsInt16 ? 2 : 3));
+        }
+    }
+};
+
+static SamplerTests samplerTests;
+
+//==============================================================================
+class SamplerBenchmark  : public Benchmark
+{
+public:
+    SamplerBenchmark (const int numVoices_, const SamplerSound::StorageFormat format_)
+        : Benchmark ("Synthesiser: " + String (numVoices_) + " SamplerVoices"
+                        + (format_ == SamplerSound::storeAsInt16 ? " playing 16-bit samples" : "")
+                        + ", 512 samples", 512),
+          numVoices (numVoices_),
+          format (format_),
+          buffer (2, 512)
+    {
+    }
+
+    void initialise()
+    {
+        MemoryBlock wavData;
+        SamplerTests::createTestWav (wavData, 441000);
+        ScopedPointer<AudioFormatReader> reader (SamplerTests::createTestReader (wavData));
+
+        BigInteger notes;
+        notes.setRange (0, 128, true);
+
+        synth = new Synthesiser();
+        synth->setCurrentPlaybackSampleRate (44100.0);
+        synth->addSound (new SamplerSound ("test", *reader, notes, 60, 0.001, 0.1, 10.0, format));
+
+        for (int i = 0; i < numVoices; ++i)
+            synth->addVoice (new SamplerVoice());
+    }
+
+    void runIteration()
+    {
+        // (restarts the notes whenever they've finished playing)
+        if (synth->getVoice (0)->getCurrentlyPlayingNote() < 0)
+            for (int i = 0; i < numVoices; ++i)
+                midi.addEvent (MidiMessage::noteOn (1, 40 + i, 0.5f), 0);
+
+        buffer.clear();
+        synth->renderNextBlock (buffer, midi, 0, buffer.getNumSamples());
+        midi.clear();
+
+        preventOptimisation (buffer.getSampleData (0));
+    }
+
+    void shutdown()
+    {
+        synth = nullptr;
+    }
+
+private:
+    const int numVoices;
+    const SamplerSound::StorageFormat format;
+    ScopedPointer<Synthesiser> synth;
+    AudioSampleBuffer buffer;
+    MidiBuffer midi;
+};
+
+static SamplerBenchmark samplerBenchmark8 (8, SamplerSound::storeAsFloat);
+static SamplerBenchmark samplerBenchmark32 (32, SamplerSound::storeAsFloat);
+static SamplerBenchmark int16SamplerBenchmark32 (32, SamplerSound::storeAsInt16);
+
+#endif
@@ -32,17 +32,32 @@
     A subclass of SynthesiserSound that represents a sampled audio clip.
 
     This is a pretty basic sampler, and just attempts to load the whole audio stream
-    into memory.
+    into memory. For samples that are too big for that, see StreamingSamplerSound.
 
     To use it, create a Synthesiser, add some SamplerVoice objects to it, then
     give it some SampledSound objects to play.
 
+    By default the audio is kept as 32-bit floats, but it can also be kept as 16 or
+    24-bit integers, which fits two or four-thirds as much audio into the same memory.
+    Voices convert it back to floats as they play it. That's lossless for audio that
+    was 16 or 24-bit to begin with, which is usually the case for sample libraries.
+
     @see SamplerVoice, Synthesiser, SynthesiserSound
 */
 class JUCE_API  SamplerSound    : public SynthesiserSound
 {
 public:
     //==============================================================================
+    /** The formats that a SamplerSound can keep its audio in.
+        @see SamplerSound::getStorageFormat
+    */
+    enum StorageFormat
+    {
+        storeAsFloat,       /**< The audio is kept as 32-bit floats, in an AudioSampleBuffer. */
+        storeAsInt16,       /**< The audio is kept as 16-bit integers. */
+        storeAsInt24        /**< The audio is kept as packed 24-bit integers. */
+    };
+
     /** Creates a sampled sound from an audio reader.
 
         This will attempt to load the audio from the source into memory and store
@@ -60,6 +75,8 @@ public:
         @param releaseTimeSecs  the decay (fade-out) time, in seconds
         @param maxSampleLengthSeconds   a maximum length of audio to read from the audio
                                         source, in seconds
+        @param storageFormat    the format to keep the audio in. The integer formats clip
+                                the audio to the -1 to 1 range
     */
     SamplerSound (const String& name,
                   AudioFormatReader& source,
@@ -67,7 +84,8 @@ public:
                   int midiNoteForNormalPitch,
                   double attackTimeSecs,
                   double releaseTimeSecs,
-                  double maxSampleLengthSeconds);
+                  double maxSampleLengthSeconds,
+                  StorageFormat storageFormat = storeAsFloat);
 
     /** Destructor. */
     ~SamplerSound();
@@ -77,31 +95,138 @@ public:
     const String& getName() const                           { return name; }
 
     /** Returns the audio sample data.
-        This could be 0 if there was a problem loading it.
+        This could be 0 if there was a problem loading it, or if the audio isn't stored as
+        floats (in which case, use readSamples() instead). For a StreamingSamplerSound,
+        this only contains the part of the sample that is kept in memory.
     */
     AudioSampleBuffer* getAudioData() const                 { return data; }
 
+    /** Returns the format that the audio is kept in. */
+    StorageFormat getStorageFormat() const noexcept         { return storageFormat; }
+
+    /** Returns the number of channels of audio that are kept in memory (at most two). */
+    int getNumChannels() const noexcept                     { return numStoredChannels; }
+
+    /** Returns the number of bytes used to hold the audio in memory. */
+    size_t getMemoryUsage() const noexcept;
+
+    /** Converts some of the audio that's held in memory to floats, whatever its storage format.
+
+        The dest array needs an entry for each of getNumChannels() channels. Any samples
+        that are outside the part that's kept in memory are set to zero.
+    */
+    void readSamples (float* const* dest, int startSample, int numSamples) const noexcept;
+
 
     //==============================================================================
     bool appliesToNote (const int midiNoteNumber);
     bool appliesToChannel (const int midiChannel);
 
 
+protected:
+    //==============================================================================
+    /** Creates a sound which only loads up to maxSamplesToLoad samples of the source
+        into memory. This is used by StreamingSamplerSound.
+    */
+    SamplerSound (const String& name,
+                  AudioFormatReader& source,
+                  const BigInteger& midiNotes,
+                  int midiNoteForNormalPitch,
+                  double attackTimeSecs,
+                  double releaseTimeSecs,
+                  double maxSampleLengthSeconds,
+                  int maxSamplesToLoad);
+
 private:
     //==============================================================================
     friend class SamplerVoice;
 
     String name;
     ScopedPointer <AudioSampleBuffer> data;
+    HeapBlock <char> packedData;
+    StorageFormat storageFormat;
+    int numStoredChannels, numStoredSamples;
     double sourceSampleRate;
     BigInteger midiNotes;
     int length, attackSamples, releaseSamples;
     int midiRootNote;
 
+    void initialise (AudioFormatReader&, double attackTimeSecs, double releaseTimeSecs,
+                     double maxSampleLengthSeconds, int maxSamplesToLoad);
+    void loadPacked (AudioFormatReader&, int numSamples);
+    int getBytesPerSample() const noexcept;
+
     JUCE_LEAK_DETECTOR (SamplerSound)
 };
 
 
+//==============================================================================
+/**
+    A SamplerSound that streams most of its audio from disk.
+
+    Only the start of the sample is loaded into memory. When a SamplerVoice plays
+    this sound, it starts playing the in-memory part straight away. Meanwhile a
+    background thread reads the rest of the sample into a ring buffer that belongs
+    to the voice. So the preloaded part needs to be long enough to cover the time it
+    takes to start reading from the disk.
+
+    To play these sounds, the SamplerVoices must be created with the constructor that
+    takes a TimeSliceThread. Voices that can't stream will only play the preloaded part.
+
+    @see SamplerSound, SamplerVoice
+*/
+class JUCE_API  StreamingSamplerSound    : public SamplerSound
+{
+public:
+    //==============================================================================
+    /** Creates a streaming sound from an audio reader.
+
+        @param name         a name for the sample
+        @param source       the audio to play. The sound takes ownership of this reader,
+                            and will keep reading from it while the sound is playing, so
+                            its data must stay available
+        @param midiNotes    the set of midi keys that this sound should be played on
+        @param midiNoteForNormalPitch   the midi note at which the sample should be played
+                                        with its natural rate
+        @param attackTimeSecs   the attack (fade-in) time, in seconds
+        @param releaseTimeSecs  the decay (fade-out) time, in seconds
+        @param maxSampleLengthSeconds   a maximum length of audio to play from the source,
+                                        in seconds
+        @param preloadTimeSecs  how much of the start of the sample to keep in memory, in seconds
+    */
+    StreamingSamplerSound (const String& name,
+                           AudioFormatReader* source,
+                           const BigInteger& midiNotes,
+                           int midiNoteForNormalPitch,
+                           double attackTimeSecs,
+                           double releaseTimeSecs,
+                           double maxSampleLengthSeconds,
+                           double preloadTimeSecs);
+
+    /** Destructor. */
+    ~StreamingSamplerSound();
+
+    //==============================================================================
+    /** Returns the number of samples at the start of the sound that are held in memory. */
+    int getNumPreloadedSamples() const noexcept                 { return numPreloaded; }
+
+    /** Reads some of the sample's audio into a buffer.
+        This is called by the background streaming thread. It's safe to call it from
+        more than one thread at once.
+    */
+    void readStreamedSamples (AudioSampleBuffer& dest, int destStartSample,
+                              int numSamples, int sourceStartSample);
+
+private:
+    //==============================================================================
+    ScopedPointer<AudioFormatReader> reader;
+    CriticalSection readerLock;
+    int numPreloaded;
+
+    JUCE_LEAK_DETECTOR (StreamingSamplerSound)
+};
+
+
 //==============================================================================
 /**
     A subclass of SynthesiserVoice that can play a SamplerSound.
@@ -109,6 +234,9 @@ private:
     To use it, create a Synthesiser, add some SamplerVoice objects to it, then
     give it some SampledSound objects to play.
 
+    SamplerVoices only touch their own state while rendering, so they can be used with
+    Synthesiser::setNumRenderingThreads().
+
     @see SamplerSound, Synthesiser, SynthesiserVoice
 */
 class JUCE_API  SamplerVoice    : public SynthesiserVoice
@@ -116,9 +244,18 @@ class JUCE_API  SamplerVoice    : public SynthesiserVoice
 public:
     //==============================================================================
     /** Creates a SamplerVoice.
+        A voice created like this can't stream from a StreamingSamplerSound.
     */
     SamplerVoice();
 
+    /** Creates a SamplerVoice that can play StreamingSamplerSounds.
+
+        The voice registers itself with the given thread, which it uses to read the
+        audio into a ring buffer of streamBufferSizeSamples samples. The thread must
+        be running, and must outlive the voice.
+    */
+    SamplerVoice (TimeSliceThread& streamingThread, int streamBufferSizeSamples = 65536);
+
     /** Destructor. */
     ~SamplerVoice();
 
@@ -142,11 +279,22 @@ public:
 
 private:
     //==============================================================================
+    class Stream;
+    friend class ScopedPointer<Stream>;
+    ScopedPointer<Stream> stream;
+    bool isStreaming;
+
+    HeapBlock<float> decodeBuffer;
+
     double pitchRatio;
     double sourceSamplePosition;
     float lgain, rgain, attackReleaseLevel, attackDelta, releaseDelta;
     bool isInAttack, isInRelease;
 
+    template <class SourceType>
+    void renderFrom (const SourceType&, int length, AudioSampleBuffer&, int startSample, int numSamples);
+    void renderPacked (const SamplerSound&, AudioSampleBuffer&, int startSample, int numSamples);
+
     JUCE_LEAK_DETECTOR (SamplerVoice)
 };
 
@@ -38,6 +38,7 @@
 #endif
 
 #include "../utility/juce_IncludeModuleHeaders.h"
+#include "../utility/juce_PluginMidiOutput.h"
 #undef Component
 
 #ifdef __clang__
@@ -641,6 +642,35 @@ struct AAXClasses
             JUCE_DECLARE_NON_COPYABLE (IndexAsParamID)
         };
 
+        // Posts events straight to the output node, one packet per event. (Sysex can't be
+        // sent this way because a packet only holds 4 bytes, so those get dropped)
+        struct MidiNodeOutput
+        {
+            MidiNodeOutput (AAX_IMIDINode* const node) noexcept  : midiNodeOut (node)
+            {
+                packet.mIsImmediate = false;
+            }
+
+            bool addEvent (const void* const midiData, const int numBytes, const int samplePosition)
+            {
+                if (numBytes > 4)
+                    return false;
+
+                packet.mTimestamp = (uint32_t) samplePosition;
+                packet.mLength    = (uint32_t) numBytes;
+                memcpy (packet.mData, midiData, (size_t) numBytes);
+
+                const AAX_Result result = midiNodeOut->PostMIDIPacket (&packet);
+                check (result);
+                return result == AAX_SUCCESS;
+            }
+
+            AAX_IMIDINode* const midiNodeOut;
+            AAX_CMidiPacket packet;
+
+            JUCE_DECLARE_NON_COPYABLE (MidiNodeOutput)
+        };
+
         void process (float* const* channels, const int numChans, const int bufferSize,
                       const bool bypass, AAX_IMIDINode* midiNodeIn, AAX_IMIDINode* midiNodeOut)
         {
@@ -677,26 +707,8 @@ struct AAXClasses
 
            #if JucePlugin_ProducesMidiOutput
             {
-                const juce::uint8* midiEventData;
-                int midiEventSize, midiEventPosition;
-                MidiBuffer::Iterator i (midiBuffer);
-
-                AAX_CMidiPacket packet;
-                packet.mIsImmediate = false;
-
-                while (i.getNextEvent (midiEventData, midiEventSize, midiEventPosition))
-                {
-                    jassert (isPositiveAndBelow (midiEventPosition, bufferSize));
-
-                    if (midiEventSize <= 4)
-                    {
-                        packet.mTimestamp   = (uint32_t) midiEventPosition;
-                        packet.mLength      = (uint32_t) midiEventSize;
-                        memcpy (packet.mData, midiEventData, midiEventSize);
-
-                        check (midiNodeOut->PostMIDIPacket (&packet));
-                    }
-                }
+                MidiNodeOutput output (midiNodeOut);
+                PluginMidiOutput::copyEvents (midiBuffer, bufferSize, output);
             }
            #endif
         }
@@ -756,6 +768,9 @@ struct AAXClasses
             audioProcessor.setPlayConfigDetails (numberOfInputChannels, numberOfOutputChannels, sampleRate, bufferSize);
             audioProcessor.prepareToPlay (sampleRate, bufferSize);
 
+            midiBuffer.ensureSize (2048);
+            midiBuffer.clear();
+
             check (Controller()->SetSignalLatency (audioProcessor.getLatencySamples()));
         }
 
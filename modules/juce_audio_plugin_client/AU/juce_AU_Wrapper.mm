@@ -46,6 +46,7 @@
 #include <AudioUnit/AUCocoaUIView.h>
 #include <AudioUnit/AudioUnit.h>
 #include <AudioToolbox/AudioUnitUtilities.h>
+#include <CoreMIDI/MIDIServices.h>
 
 #if JUCE_SUPPORT_CARBON
  #define Point CarbonDummyPointName
@@ -85,6 +86,7 @@
 #include "../utility/juce_FakeMouseMoveGenerator.h"
 #include "../utility/juce_CarbonVisibility.h"
 #include "../utility/juce_PluginHostType.h"
+#include "../utility/juce_PluginMidiOutput.h"
 #include "../../juce_core/native/juce_osx_ObjCHelpers.h"
 
 //==============================================================================
@@ -106,11 +108,189 @@ static const int numChannelConfigs = sizeof (channelConfigs) / sizeof (*channelC
  #define JUCE_STATE_DICTIONARY_KEY   CFSTR("jucePluginState")
 #endif
 
+//==============================================================================
+/*  A copy of the filter's parameter values that any thread can read or write without locking,
+    plus a set of flags for the change notifications that are waiting to be sent to the host.
+
+    This lets the render thread report parameter changes without calling into the AU event
+    system, and lets the host read values back without calling into the filter. Several
+    changes to the same parameter before the next dispatch are coalesced into one event.
+*/
+class AUParameterMirror
+{
+public:
+    AUParameterMirror()  : numParameters (0) {}
+
+    enum EventFlags
+    {
+        valueChanged    = 1,
+        gestureBegan    = 2,
+        gestureEnded    = 4
+    };
+
+    void initialise (AudioProcessor& filter)
+    {
+        numParameters = filter.getNumParameters();
+        values.calloc ((size_t) numParameters);
+        pendingEvents.calloc ((size_t) numParameters);
+        anyEventsPending = 0;
+
+        refresh (filter);
+    }
+
+    void refresh (AudioProcessor& filter)
+    {
+        for (int i = 0; i < numParameters; ++i)
+            values[i] = filter.getParameter (i);
+    }
+
+    bool contains (const int index) const noexcept                  { return isPositiveAndBelow (index, numParameters); }
+    float getValue (const int index) const noexcept                 { return contains (index) ? values[index].get() : 0.0f; }
+
+    void setValue (const int index, const float newValue) noexcept
+    {
+        if (contains (index))
+            values[index] = newValue;
+    }
+
+    void addPendingEvent (const int index, const int eventFlag) noexcept
+    {
+        if (contains (index))
+        {
+            Atomic<int>& flags = pendingEvents[index];
+
+            for (;;)
+            {
+                const int oldFlags = flags.get();
+
+                if ((oldFlags & eventFlag) != 0 || flags.compareAndSetBool (oldFlags | eventFlag, oldFlags))
+                    break;
+            }
+
+            anyEventsPending = 1;
+        }
+    }
+
+    /** Removes the flags for the next parameter that has events waiting, starting the search at
+        the given index. Returns its index, or -1 if there's nothing left to send.
+    */
+    int getNextPendingEvents (int startIndex, int& eventFlags) noexcept
+    {
+        if (startIndex == 0 && anyEventsPending.exchange (0) == 0)
+            return -1;
+
+        for (int i = startIndex; i < numParameters; ++i)
+        {
+            eventFlags = pendingEvents[i].exchange (0);
+
+            if (eventFlags != 0)
+                return i;
+        }
+
+        return -1;
+    }
+
+private:
+    HeapBlock<Atomic<float> > values;
+    HeapBlock<Atomic<int> > pendingEvents;
+    Atomic<int> anyEventsPending;
+    int numParameters;
+
+    JUCE_DECLARE_NON_COPYABLE (AUParameterMirror)
+};
+
+#if JucePlugin_ProducesMidiOutput
+//==============================================================================
+/*  Builds the MIDIPacketList that gets passed to the host's MIDI output callback.
+
+    The list lives in a block that's allocated by setSize() before playback starts, so
+    filling it on the render thread doesn't allocate. If a block has more events than
+    will fit, the list is sent to the host early and then reused, so nothing is lost.
+    Each packet's timestamp is the sample offset of its events within the block.
+*/
+class AUMidiOutputPacketList
+{
+public:
+    AUMidiOutputPacketList()  : numBytes (0), currentPacket (nullptr), timeStamp (nullptr)
+    {
+        zerostruct (callback);
+    }
+
+    void setSize (const size_t newNumBytes)
+    {
+        if (newNumBytes != numBytes)
+        {
+            data.malloc (newNumBytes);
+            numBytes = newNumBytes;
+        }
+
+        currentPacket = MIDIPacketListInit (getList());
+    }
+
+    void setCallback (const AUMIDIOutputCallbackStruct& newCallback) noexcept   { callback = newCallback; }
+    bool hasCallback() const noexcept       { return callback.midiOutputCallback != nullptr; }
+
+    void startBlock (const AudioTimeStamp& blockTimeStamp) noexcept
+    {
+        timeStamp = &blockTimeStamp;
+
+        if (data != nullptr)
+            currentPacket = MIDIPacketListInit (getList());
+    }
+
+    bool addEvent (const void* const midiData, const int size, const int samplePosition)
+    {
+        if (currentPacket == nullptr)
+            return false;
+
+        MIDIPacket* next = MIDIPacketListAdd (getList(), (ByteCount) numBytes, currentPacket,
+                                              (MIDITimeStamp) samplePosition, (ByteCount) size, (const Byte*) midiData);
+
+        if (next == nullptr)
+        {
+            sendToHost();
+
+            next = MIDIPacketListAdd (getList(), (ByteCount) numBytes, currentPacket,
+                                      (MIDITimeStamp) samplePosition, (ByteCount) size, (const Byte*) midiData);
+
+            if (next == nullptr)
+                return false;  // (this event's too big for the list even when it's empty)
+        }
+
+        currentPacket = next;
+        return true;
+    }
+
+    void sendToHost()
+    {
+        if (currentPacket != nullptr && getList()->numPackets > 0)
+        {
+            if (callback.midiOutputCallback != nullptr && timeStamp != nullptr)
+                callback.midiOutputCallback (callback.userData, timeStamp, 0, getList());
+
+            currentPacket = MIDIPacketListInit (getList());
+        }
+    }
+
+private:
+    HeapBlock<char> data;
+    size_t numBytes;
+    MIDIPacket* currentPacket;
+    AUMIDIOutputCallbackStruct callback;
+    const AudioTimeStamp* timeStamp;
+
+    MIDIPacketList* getList() const noexcept    { return reinterpret_cast <MIDIPacketList*> (data.getData()); }
+
+    JUCE_DECLARE_NON_COPYABLE (AUMidiOutputPacketList)
+};
+#endif
+
 //==============================================================================
 class JuceAU   : public JuceAUBaseClass,
                  public AudioProcessorListener,
                  public AudioPlayHead,
-                 public ComponentListener
+                 public ComponentListener,
+                 private Timer
 {
 public:
     //==============================================================================
@@ -138,10 +318,12 @@ public:
         juceFilter->addListener (this);
 
         Globals()->UseIndexedParameters (juceFilter->getNumParameters());
+        parameters.initialise (*juceFilter);
 
         activePlugins.add (this);
 
         zerostruct (auEvent);
+        zerostruct (lastRenderTimeStamp);
         auEvent.mArgument.mParameter.mAudioUnit = GetComponentInstance();
         auEvent.mArgument.mParameter.mScope = kAudioUnitScope_Global;
         auEvent.mArgument.mParameter.mElement = 0;
@@ -157,10 +339,13 @@ public:
         streamDescription.SetCanonical ((UInt32) channelConfigs[0][0], false);
         Inputs().GetIOElement(0)->SetStreamFormat (streamDescription);
        #endif
+
+        startTimer (30);
     }
 
     ~JuceAU()
     {
+        stopTimer();
         deleteActiveEditors();
         juceFilter = nullptr;
         clearPresetsArray();
@@ -210,6 +395,20 @@ public:
                 outWritable = false;
                 return noErr;
             }
+           #if JucePlugin_ProducesMidiOutput
+            else if (inID == kAudioUnitProperty_MIDIOutputCallbackInfo)
+            {
+                outDataSize = sizeof (CFArrayRef);
+                outWritable = false;
+                return noErr;
+            }
+            else if (inID == kAudioUnitProperty_MIDIOutputCallback)
+            {
+                outDataSize = sizeof (AUMIDIOutputCallbackStruct);
+                outWritable = true;
+                return noErr;
+            }
+           #endif
             else if (inID == kAudioUnitProperty_CocoaUI)
             {
                #if MAC_OS_X_VERSION_MIN_REQUIRED < MAC_OS_X_VERSION_10_5
@@ -250,6 +449,15 @@ public:
                 *(UInt32*) outData = 1;
                 return noErr;
             }
+           #if JucePlugin_ProducesMidiOutput
+            else if (inID == kAudioUnitProperty_MIDIOutputCallbackInfo)
+            {
+                // (the host takes ownership of this array)
+                CFStringRef outputNames[] = { CFSTR ("MIDI Out") };
+                *(CFArrayRef*) outData = CFArrayCreate (kCFAllocatorDefault, (const void**) outputNames, 1, &kCFTypeArrayCallBacks);
+                return noErr;
+            }
+           #endif
             else if (inID == kAudioUnitProperty_CocoaUI)
             {
                #if MAC_OS_X_VERSION_MIN_REQUIRED < MAC_OS_X_VERSION_10_5
@@ -291,6 +499,18 @@ public:
             return noErr;
         }
 
+       #if JucePlugin_ProducesMidiOutput
+        if (inScope == kAudioUnitScope_Global && inID == kAudioUnitProperty_MIDIOutputCallback)
+        {
+            if (inDataSize < sizeof (AUMIDIOutputCallbackStruct))
+                return kAudioUnitErr_InvalidPropertyValue;
+
+            const ScopedLock sl (juceFilter->getCallbackLock());
+            midiOutput.setCallback (*(const AUMIDIOutputCallbackStruct*) inData);
+            return noErr;
+        }
+       #endif
+
         return JuceAUBaseClass::SetProperty (inID, inScope, inElement, inData, inDataSize);
     }
 
@@ -347,7 +567,10 @@ public:
                     const juce::uint8* const rawBytes = CFDataGetBytePtr (data);
 
                     if (numBytes > 0)
+                    {
                         juceFilter->setCurrentProgramStateInformation (rawBytes, numBytes);
+                        parameters.refresh (*juceFilter);
+                    }
                 }
             }
         }
@@ -423,7 +646,8 @@ public:
     {
         if (inScope == kAudioUnitScope_Global && juceFilter != nullptr)
         {
-            outValue = juceFilter->getParameter ((int) inID);
+            outValue = parameters.contains ((int) inID) ? parameters.getValue ((int) inID)
+                                                        : juceFilter->getParameter ((int) inID);
             return noErr;
         }
 
@@ -438,7 +662,13 @@ public:
     {
         if (inScope == kAudioUnitScope_Global && juceFilter != nullptr)
         {
-            juceFilter->setParameter ((int) inID, inValue);
+            // changes that the host has scheduled part-way through the next buffer get
+            // queued, so that the filter can apply them at the right sample..
+            if (inBufferOffsetInFrames == 0
+                 || ! juceFilter->queueParameterChange ((int) inID, inValue, (int) inBufferOffsetInFrames))
+                juceFilter->setParameter ((int) inID, inValue);
+
+            parameters.setValue ((int) inID, inValue);
             return noErr;
         }
 
@@ -553,23 +783,63 @@ public:
         }
     }
 
-    void audioProcessorParameterChanged (AudioProcessor*, int index, float /*newValue*/)
+    void audioProcessorParameterChanged (AudioProcessor*, int index, float newValue)
     {
-        sendAUEvent (kAudioUnitEvent_ParameterValueChange, index);
+        parameters.setValue (index, newValue);
+        addParameterEvent (index, AUParameterMirror::valueChanged);
     }
 
     void audioProcessorParameterChangeGestureBegin (AudioProcessor*, int index)
     {
-        sendAUEvent (kAudioUnitEvent_BeginParameterChangeGesture, index);
+        addParameterEvent (index, AUParameterMirror::gestureBegan);
     }
 
     void audioProcessorParameterChangeGestureEnd (AudioProcessor*, int index)
     {
-        sendAUEvent (kAudioUnitEvent_EndParameterChangeGesture, index);
+        addParameterEvent (index, AUParameterMirror::gestureEnded);
+    }
+
+    void addParameterEvent (const int index, const int eventFlag)
+    {
+        parameters.addPendingEvent (index, eventFlag);
+
+        // Changes that come from the message thread are sent straight away, along with anything
+        // else that's waiting, so the host sees them in order. Changes made on any other thread
+        // (i.e. the render thread) get sent by the next timer callback.
+        const MessageManager* const mm = MessageManager::getInstanceWithoutCreating();
+
+        if (mm != nullptr && mm->isThisTheMessageThread())
+            sendPendingParameterEvents();
+    }
+
+    void sendPendingParameterEvents()
+    {
+        int flags = 0;
+
+        for (int index = parameters.getNextPendingEvents (0, flags); index >= 0;
+                 index = parameters.getNextPendingEvents (index + 1, flags))
+        {
+            if ((flags & AUParameterMirror::gestureBegan) != 0)
+                sendAUEvent (kAudioUnitEvent_BeginParameterChangeGesture, index);
+
+            if ((flags & AUParameterMirror::valueChanged) != 0)
+                sendAUEvent (kAudioUnitEvent_ParameterValueChange, index);
+
+            if ((flags & AUParameterMirror::gestureEnded) != 0)
+                sendAUEvent (kAudioUnitEvent_EndParameterChangeGesture, index);
+        }
+    }
+
+    void timerCallback()
+    {
+        sendPendingParameterEvents();
     }
 
     void audioProcessorChanged (AudioProcessor*)
     {
+        if (juceFilter != nullptr)
+            parameters.refresh (*juceFilter);
+
         PropertyChanged (kAudioUnitProperty_Latency, kAudioUnitScope_Global, 0);
     }
 
@@ -657,6 +927,10 @@ public:
             incomingEvents.ensureSize (2048);
             incomingEvents.clear();
 
+           #if JucePlugin_ProducesMidiOutput
+            midiOutput.setSize (65536);
+           #endif
+
             channels.calloc ((size_t) jmax (juceFilter->getNumInputChannels(),
                                             juceFilter->getNumOutputChannels()) + 4);
 
@@ -669,6 +943,7 @@ public:
                             UInt32 nFrames)
     {
         lastSMPTETime = inTimeStamp.mSMPTETime;
+        lastRenderTimeStamp = inTimeStamp;
 
        #if ! JucePlugin_IsSynth
         return JuceAUBaseClass::Render (ioActionFlags, inTimeStamp, nFrames);
@@ -773,6 +1048,8 @@ public:
 
                 const ScopedLock sl (juceFilter->getCallbackLock());
 
+                juceFilter->prepareParameterChangesForBlock ((int) numSamples);
+
                 if (juceFilter->isSuspended())
                 {
                     for (int j = 0; j < numOut; ++j)
@@ -793,17 +1070,13 @@ public:
             if (! midiEvents.isEmpty())
             {
                #if JucePlugin_ProducesMidiOutput
-                const juce::uint8* midiEventData;
-                int midiEventSize, midiEventPosition;
-                MidiBuffer::Iterator i (midiEvents);
+                const ScopedLock sl (juceFilter->getCallbackLock());
 
-                while (i.getNextEvent (midiEventData, midiEventSize, midiEventPosition))
+                if (midiOutput.hasCallback())
                 {
-                    jassert (isPositiveAndBelow (midiEventPosition, (int) numSamples));
-
-
-
-                    //xxx
+                    midiOutput.startBlock (lastRenderTimeStamp);
+                    PluginMidiOutput::copyEvents (midiEvents, (int) numSamples, midiOutput);
+                    midiOutput.sendToHost();
                 }
                #else
                 // if your plugin creates midi messages, you'll need to set
@@ -920,6 +1193,7 @@ public:
         chosenPreset.presetName = juceFilter->getProgramName (chosenPresetNumber).toCFString();
 
         juceFilter->setCurrentProgram (chosenPresetNumber);
+        parameters.refresh (*juceFilter);
         SetAFactoryPresetAsCurrent (chosenPreset);
 
         return noErr;
@@ -1168,8 +1442,13 @@ private:
     MidiBuffer midiEvents, incomingEvents;
     bool prepared;
     SMPTETime lastSMPTETime;
+    AudioTimeStamp lastRenderTimeStamp;
+   #if JucePlugin_ProducesMidiOutput
+    AUMidiOutputPacketList midiOutput;
+   #endif
     AUChannelInfo channelInfo [numChannelConfigs];
     AudioUnitEvent auEvent;
+    AUParameterMirror parameters;
     mutable Array<AUPreset> presetsArray;
     CriticalSection incomingMidiLock;
 
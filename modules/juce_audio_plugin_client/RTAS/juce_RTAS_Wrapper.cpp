@@ -591,6 +591,8 @@ protected:
 
                 AudioSampleBuffer chans (channels, totalChans, numSamples);
 
+                juceFilter->prepareParameterChangesForBlock (numSamples);
+
                 if (mBypassed)
                     juceFilter->processBlockBypassed (chans, midiEvents);
                 else
@@ -101,6 +101,7 @@
 #include "../utility/juce_IncludeModuleHeaders.h"
 #include "../utility/juce_FakeMouseMoveGenerator.h"
 #include "../utility/juce_PluginHostType.h"
+#include "../utility/juce_PluginMidiOutput.h"
 
 #ifdef _MSC_VER
  #pragma pack (pop)
@@ -328,6 +329,7 @@ public:
          hasShutdown (false),
          firstProcessCallback (true),
          shouldDeleteEditor (false),
+         scratchBuffer (1, 1),
          hostWindow (0)
     {
         filter->setPlayConfigDetails (numInChans, numOutChans, 0, 0);
@@ -371,7 +373,6 @@ public:
                 jassert (editorComp == 0);
 
                 channels.free();
-                deleteTempChannels();
 
                 jassert (activePlugins.contains (this));
                 activePlugins.removeFirstMatchingValue (this);
@@ -535,22 +536,19 @@ public:
 
     void process (float** inputs, float** outputs, VstInt32 numSamples)
     {
-        const int numIn = numInChans;
-        const int numOut = numOutChans;
-
-        AudioSampleBuffer temp (numIn, numSamples);
-        for (int i = numIn; --i >= 0;)
-            memcpy (temp.getSampleData (i), outputs[i], sizeof (float) * (size_t) numSamples);
-
-        processReplacing (inputs, outputs, numSamples);
-
-        AudioSampleBuffer dest (outputs, numOut, numSamples);
-
-        for (int i = jmin (numIn, numOut); --i >= 0;)
-            dest.addFrom (i, 0, temp, i, 0, numSamples);
+        processAudio (inputs, outputs, numSamples, true);
     }
 
     void processReplacing (float** inputs, float** outputs, VstInt32 numSamples)
+    {
+        processAudio (inputs, outputs, numSamples, false);
+    }
+
+    /*  Nothing in here allocates, as long as the processor doesn't: the channel list, scratch
+        channels and midi buffers are all set up in resume(), for the block size that the host
+        announced. If the host then sends a bigger block than that, it gets processed in pieces.
+    */
+    void processAudio (float** inputs, float** outputs, const int numSamples, const bool accumulate)
     {
         if (firstProcessCallback)
         {
@@ -582,82 +580,43 @@ public:
         {
             const ScopedLock sl (filter->getCallbackLock());
 
-            const int numIn = numInChans;
-            const int numOut = numOutChans;
+            const int maxBlockSize = scratchBuffer.getNumSamples();
 
             if (filter->isSuspended())
             {
-                for (int i = 0; i < numOut; ++i)
-                    FloatVectorOperations::clear (outputs[i], numSamples);
+                if (! accumulate)
+                    for (int i = 0; i < numOutChans; ++i)
+                        FloatVectorOperations::clear (outputs[i], numSamples);
+            }
+            else if (numSamples <= maxBlockSize)
+            {
+                processSubBlock (inputs, outputs, 0, numSamples, accumulate, midiEvents);
             }
             else
             {
-                int i;
-                for (i = 0; i < numOut; ++i)
-                {
-                    float* chan = tempChannels.getUnchecked(i);
-
-                    if (chan == nullptr)
-                    {
-                        chan = outputs[i];
-
-                        // if some output channels are disabled, some hosts supply the same buffer
-                        // for multiple channels - this buggers up our method of copying the
-                        // inputs over the outputs, so we need to create unique temp buffers in this case..
-                        for (int j = i; --j >= 0;)
-                        {
-                            if (outputs[j] == chan)
-                            {
-                                chan = new float [blockSize * 2];
-                                tempChannels.set (i, chan);
-                                break;
-                            }
-                        }
-                    }
+                subBlockMidiIn.swapWith (midiEvents);
 
-                    if (i < numIn && chan != inputs[i])
-                        memcpy (chan, inputs[i], sizeof (float) * (size_t) numSamples);
-
-                    channels[i] = chan;
-                }
+                for (int start = 0; start < numSamples; start += maxBlockSize)
+                {
+                    const int num = jmin (maxBlockSize, numSamples - start);
 
-                for (; i < numIn; ++i)
-                    channels[i] = inputs[i];
+                    subBlockMidi.clear();
+                    subBlockMidi.addEvents (subBlockMidiIn, start, num, -start);
 
-                {
-                    AudioSampleBuffer chans (channels, jmax (numIn, numOut), numSamples);
+                    processSubBlock (inputs, outputs, start, num, accumulate, subBlockMidi);
 
-                    if (isBypassed)
-                        filter->processBlockBypassed (chans, midiEvents);
-                    else
-                        filter->processBlock (chans, midiEvents);
+                    midiEvents.addEvents (subBlockMidi, 0, num, start);
                 }
 
-                // copy back any temp channels that may have been used..
-                for (i = 0; i < numOut; ++i)
-                    if (const float* const chan = tempChannels.getUnchecked(i))
-                        memcpy (outputs[i], chan, sizeof (float) * (size_t) numSamples);
+                subBlockMidiIn.clear();
             }
         }
 
         if (! midiEvents.isEmpty())
         {
            #if JucePlugin_ProducesMidiOutput
-            const int numEvents = midiEvents.getNumEvents();
-
-            outgoingEvents.ensureSize (numEvents);
             outgoingEvents.clear();
-
-            const juce::uint8* midiEventData;
-            int midiEventSize, midiEventPosition;
-            MidiBuffer::Iterator i (midiEvents);
-
-            while (i.getNextEvent (midiEventData, midiEventSize, midiEventPosition))
-            {
-                jassert (midiEventPosition >= 0 && midiEventPosition < numSamples);
-
-                outgoingEvents.addEvent (midiEventData, midiEventSize, midiEventPosition);
-            }
+            PluginMidiOutput::copyEvents (midiEvents, numSamples, outgoingEvents);
 
             sendVstEventsToHost (outgoingEvents.events);
            #elif JUCE_DEBUG
@@ -682,6 +641,73 @@ public:
         }
     }
 
+    void processSubBlock (float** inputs, float** outputs, const int offset, const int numSamples,
+                          const bool accumulate, MidiBuffer& midiMessages)
+    {
+        const int numIn = numInChans;
+        const int numOut = numOutChans;
+
+        int i;
+        for (i = 0; i < numOut; ++i)
+        {
+            float* const output = outputs[i];
+
+            // The processor works in-place on the output buffers, unless that's not safe: an
+            // accumulating call has to keep the original output data, and if some output channels
+            // are disabled, some hosts supply the same buffer for several channels, or reuse an
+            // input buffer for a different output. Those channels go via a scratch buffer instead.
+            bool useScratch = accumulate;
+
+            for (int j = i; --j >= 0 && ! useScratch;)
+                useScratch = (outputs[j] == output);
+
+            for (int j = numIn; --j >= 0 && ! useScratch;)
+                useScratch = (j != i && inputs[j] == output);
+
+            float* const chan = useScratch ? scratchBuffer.getSampleData (i) : (output + offset);
+
+            if (i < numIn)
+            {
+                if (chan != inputs[i] + offset)
+                    memcpy (chan, inputs[i] + offset, sizeof (float) * (size_t) numSamples);
+            }
+            else if (useScratch)
+            {
+                FloatVectorOperations::clear (chan, numSamples);
+            }
+
+            channels[i] = chan;
+        }
+
+        for (; i < numIn; ++i)
+            channels[i] = inputs[i] + offset;
+
+        {
+            AudioSampleBuffer chans (channels, jmax (numIn, numOut), numSamples);
+
+            filter->prepareParameterChangesForBlock (numSamples);
+
+            if (isBypassed)
+                filter->processBlockBypassed (chans, midiMessages);
+            else
+                filter->processBlock (chans, midiMessages);
+        }
+
+        // copy back any scratch channels that were used..
+        for (i = 0; i < numOut; ++i)
+        {
+            float* const output = outputs[i] + offset;
+
+            if (channels[i] != output)
+            {
+                if (accumulate)
+                    FloatVectorOperations::add (output, channels[i], numSamples);
+                else
+                    memcpy (output, channels[i], sizeof (float) * (size_t) numSamples);
+            }
+        }
+    }
+
     //==============================================================================
     VstInt32 startProcess()  { return 0; }
     VstInt32 stopProcess()   { return 0; }
@@ -706,19 +732,24 @@ public:
             filter->setNonRealtime (getCurrentProcessLevel() == 4 /* kVstProcessLevelOffline */);
             filter->setPlayConfigDetails (numInChans, numOutChans, rate, blockSize);
 
-            deleteTempChannels();
+            scratchBuffer.setSize (jmax (1, numOutChans), jmax (1, blockSize));
 
             filter->prepareToPlay (rate, blockSize);
 
             midiEvents.ensureSize (2048);
             midiEvents.clear();
+            subBlockMidi.ensureSize (2048);
+            subBlockMidiIn.ensureSize (2048);
 
             setInitialDelay (filter->getLatencySamples());
 
             AudioEffectX::resume();
 
            #if JucePlugin_ProducesMidiOutput
-            outgoingEvents.ensureSize (512);
+            // (any events beyond this capacity get dropped, so that nothing has to be
+            // allocated on the audio thread)
+            outgoingEvents.setCapacity (1024, 65536);
+            outgoingEvents.setOverflowPolicy (VSTMidiEventList::dropWhenFull);
            #endif
         }
     }
@@ -734,8 +765,7 @@ public:
 
             isProcessing = false;
             channels.free();
-
-            deleteTempChannels();
+            scratchBuffer.setSize (1, 1);
         }
     }
 
@@ -1452,7 +1482,8 @@ private:
     int numInChans, numOutChans;
     bool isProcessing, isBypassed, hasShutdown, firstProcessCallback, shouldDeleteEditor;
     HeapBlock<float*> channels;
-    Array<float*> tempChannels;  // see note in processReplacing()
+    AudioSampleBuffer scratchBuffer;  // see note in processSubBlock()
+    MidiBuffer subBlockMidi, subBlockMidiIn;
 
    #if JUCE_MAC
     void* hostWindow;
@@ -1509,18 +1540,6 @@ private:
     static void checkWhetherMessageThreadIsCorrect() {}
    #endif
 
-    //==============================================================================
-    void deleteTempChannels()
-    {
-        for (int i = tempChannels.size(); --i >= 0;)
-            delete[] (tempChannels.getUnchecked(i));
-
-        tempChannels.clear();
-
-        if (filter != nullptr)
-            tempChannels.insertMultiple (0, 0, filter->getNumInputChannels() + filter->getNumOutputChannels());
-    }
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JuceVSTWrapper)
 };
 
@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_PLUGINMIDIOUTPUT_JUCEHEADER__
+#define __JUCE_PLUGINMIDIOUTPUT_JUCEHEADER__
+
+//==============================================================================
+/** Hands the events that a plugin's processBlock() left in its MidiBuffer over to
+    whatever event list a wrapper uses to send them to the host.
+
+    The events are passed on in order with their exact sample positions. The only
+    time a position gets changed is if the plugin has put an event outside the block,
+    in which case it's clamped to the nearest valid sample (and an assertion fires).
+
+    EventListType needs a method
+        bool addEvent (const void* data, int numBytes, int samplePosition)
+    which returns false if the event had to be dropped. Nothing in here allocates,
+    so as long as the wrapper has preallocated its list, this is realtime-safe.
+*/
+struct PluginMidiOutput
+{
+    /** Copies all the events into the list, returning the number that were dropped. */
+    template <class EventListType>
+    static int copyEvents (const MidiBuffer& midiEvents, const int numSamples, EventListType& dest)
+    {
+        const juce::uint8* midiEventData;
+        int midiEventSize, midiEventPosition;
+        int numDropped = 0;
+
+        MidiBuffer::Iterator i (midiEvents);
+
+        while (i.getNextEvent (midiEventData, midiEventSize, midiEventPosition))
+        {
+            /*  If this is triggered, your processBlock() has added an event at a position
+                that's outside the block it was given.
+            */
+            jassert (isPositiveAndBelow (midiEventPosition, numSamples));
+
+            if (! dest.addEvent (midiEventData, midiEventSize,
+                                 jlimit (0, jmax (0, numSamples - 1), midiEventPosition)))
+                ++numDropped;
+        }
+
+        return numDropped;
+    }
+};
+
+#endif   // __JUCE_PLUGINMIDIOUTPUT_JUCEHEADER__
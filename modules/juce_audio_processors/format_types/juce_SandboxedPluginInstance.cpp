@@ -0,0 +1,1589 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace SandboxHelpers
+{
+    enum
+    {
+        magicNumber         = 0x4a534278,
+        maxNumChannels      = 32,
+        maxBlockSize        = 4096,
+        midiCapacity        = 65536,
+        controlCapacity     = 4 * 1024 * 1024,
+        maxCachedParameters = 2048,
+        parameterQueueSize  = 1024   // must be a power of two
+    };
+
+    static const char* const commandLineFlag = "--juce-plugin-sandbox";
+
+    //==============================================================================
+    /* Each direction of traffic has one of these. The sender fills in the data and then
+       increments requestNumber; the receiver does its work and sets replyNumber to match.
+    */
+    struct ChannelState
+    {
+        Atomic<int32> requestNumber, replyNumber;
+        int32 dataSize, numChannels, numSamples, midiSize;
+    };
+
+    /* A single-producer, single-consumer ring of parameter changes. Each process
+       serialises its own writers and readers with a local lock.
+    */
+    struct ParameterQueue
+    {
+        bool push (const int index, const float value) noexcept
+        {
+            const uint32 w = writeIndex.get();
+
+            if (w - readIndex.get() >= (uint32) parameterQueueSize)
+                return false;
+
+            Change& c = changes [w & (parameterQueueSize - 1)];
+            c.index = index;
+            c.value = value;
+            writeIndex = w + 1;
+            return true;
+        }
+
+        bool pop (int& index, float& value) noexcept
+        {
+            const uint32 r = readIndex.get();
+
+            if (r == writeIndex.get())
+                return false;
+
+            const Change& c = changes [r & (parameterQueueSize - 1)];
+            index = c.index;
+            value = c.value;
+            readIndex = r + 1;
+            return true;
+        }
+
+        struct Change
+        {
+            int32 index;
+            float value;
+        };
+
+        Atomic<uint32> readIndex, writeIndex;
+        Change changes [parameterQueueSize];
+    };
+
+    struct SharedHeader
+    {
+        int32 magic, hostProcessId;
+        Atomic<int32> latencySamples, changeCounter;
+        ChannelState audio, control;
+        ParameterQueue hostToPlugin, pluginToHost;
+        float parameterValues [maxCachedParameters];
+    };
+
+    //==============================================================================
+    /* The block of memory that both processes map: the header, followed by the audio
+       channels, the midi data, and the payload for control messages.
+    */
+    class SharedBlock
+    {
+    public:
+        SharedBlock (const File& file)
+            : map (file, MemoryMappedFile::readWrite)
+        {
+        }
+
+        bool isValid() const noexcept
+        {
+            return map.getData() != nullptr && map.getSize() >= getTotalSize();
+        }
+
+        SharedHeader& getHeader() const noexcept        { return *static_cast <SharedHeader*> (map.getData()); }
+        float* getChannel (const int index) const noexcept
+        {
+            return reinterpret_cast <float*> (getBytes() + getAudioOffset()) + index * (int) maxBlockSize;
+        }
+
+        char* getMidiData() const noexcept              { return getBytes() + getMidiOffset(); }
+        char* getControlData() const noexcept           { return getBytes() + getControlOffset(); }
+
+        static size_t getTotalSize() noexcept           { return getControlOffset() + (size_t) controlCapacity; }
+
+        static bool createFile (const File& file)
+        {
+            FileOutputStream out (file);
+
+            if (out.failedToOpen())
+                return false;
+
+            HeapBlock<char> zeros (65536, true);
+
+            for (size_t remaining = getTotalSize(); remaining > 0;)
+            {
+                const size_t numToWrite = jmin (remaining, (size_t) 65536);
+
+                if (! out.write (zeros, numToWrite))
+                    return false;
+
+                remaining -= numToWrite;
+            }
+
+            return true;
+        }
+
+    private:
+        MemoryMappedFile map;
+
+        char* getBytes() const noexcept                 { return static_cast <char*> (map.getData()); }
+
+        static size_t roundUp (const size_t n) noexcept { return (n + 63) & ~(size_t) 63; }
+        static size_t getAudioOffset() noexcept         { return roundUp (sizeof (SharedHeader)); }
+        static size_t getMidiOffset() noexcept          { return getAudioOffset() + maxNumChannels * maxBlockSize * sizeof (float); }
+        static size_t getControlOffset() noexcept       { return getMidiOffset() + (size_t) midiCapacity; }
+
+        JUCE_DECLARE_NON_COPYABLE (SharedBlock)
+    };
+
+    static File createSharedFile()
+    {
+       #if JUCE_LINUX
+        File dir ("/dev/shm");
+
+        if (! dir.isDirectory())
+       #endif
+            dir = File::getSpecialLocation (File::tempDirectory);
+
+        const File file (dir.getNonexistentChildFile ("juce_plugin_sandbox", ".tmp", false));
+
+        return SharedBlock::createFile (file) ? file : File::nonexistent;
+    }
+
+    //==============================================================================
+    static void wakeWaiters (Atomic<int32>& word) noexcept
+    {
+       #if JUCE_LINUX
+        syscall (SYS_futex, (int*) &word.value, FUTEX_WAKE, INT_MAX, 0, 0, 0);
+       #else
+        (void) word;
+       #endif
+    }
+
+    /* Waits until the value changes from oldValue, returning false if it timed out.
+       The other process is usually quick to answer, so this spins for a while before
+       going to sleep.
+    */
+    static bool waitWhileEqual (Atomic<int32>& word, const int32 oldValue, const int timeoutMs) noexcept
+    {
+        for (int i = 4000; --i >= 0;)
+            if (word.get() != oldValue)
+                return true;
+
+        const uint32 startTime = Time::getMillisecondCounter();
+
+        for (;;)
+        {
+            if (word.get() != oldValue)
+                return true;
+
+            const int elapsed = (int) (Time::getMillisecondCounter() - startTime);
+
+            if (elapsed >= timeoutMs)
+                return false;
+
+           #if JUCE_LINUX
+            struct timespec slice;
+            slice.tv_sec = 0;
+            slice.tv_nsec = jmin (10, timeoutMs - elapsed) * 1000000;
+
+            syscall (SYS_futex, (int*) &word.value, FUTEX_WAIT, oldValue, &slice, 0, 0);
+           #else
+            if (elapsed == 0)
+                Thread::yield();
+            else
+                Thread::sleep (1);
+           #endif
+        }
+    }
+
+    //==============================================================================
+    /* Midi events are packed as [int32 position][int32 size][data, padded to 4 bytes]. */
+    static int writeMidi (const MidiBuffer& midi, char* const dest,
+                          const int startSample, const int numSamples) noexcept
+    {
+        MidiBuffer::Iterator i (midi);
+        i.setNextSamplePosition (startSample);
+
+        const uint8* data;
+        int numBytes, samplePosition, size = 0;
+
+        while (i.getNextEvent (data, numBytes, samplePosition)
+                 && samplePosition < startSample + numSamples)
+        {
+            const int paddedSize = (numBytes + 3) & ~3;
+
+            if (size + 8 + paddedSize > (int) midiCapacity)
+            {
+                jassertfalse; // too much midi for one block - the rest will be dropped
+                break;
+            }
+
+            const int32 header[2] = { samplePosition - startSample, numBytes };
+            memcpy (dest + size, header, sizeof (header));
+            memcpy (dest + size + 8, data, (size_t) numBytes);
+            size += 8 + paddedSize;
+        }
+
+        return size;
+    }
+
+    /* The sizes and positions come from the other process, which may have crashed
+       half-way through writing them, so anything that doesn't fit inside the shared
+       block or the audio block is treated as the end of the data.
+    */
+    static void readMidi (MidiBuffer& midi, const char* const source, const int32 size,
+                          const int sampleOffset, const int numSamples)
+    {
+        const int totalSize = jlimit (0, (int) midiCapacity, (int) size);
+
+        for (int i = 0; i + 8 <= totalSize;)
+        {
+            int32 header[2];
+            memcpy (header, source + i, sizeof (header));
+
+            const int numBytes = header[1];
+
+            if (numBytes <= 0 || numBytes > totalSize - (i + 8))
+                break;
+
+            midi.addEvent (source + i + 8, numBytes,
+                           sampleOffset + jlimit (0, jmax (0, numSamples - 1), (int) header[0]));
+
+            i += 8 + ((numBytes + 3) & ~3);
+        }
+    }
+
+    static void writeTree (const ValueTree& tree, SharedBlock& shared, ChannelState& channel)
+    {
+        MemoryOutputStream out;
+        tree.writeToStream (out);
+
+        if (out.getDataSize() > (size_t) controlCapacity)
+        {
+            jassertfalse; // a message that doesn't fit in the shared memory!
+            out.reset();
+            ValueTree ("error").writeToStream (out);
+        }
+
+        memcpy (shared.getControlData(), out.getData(), out.getDataSize());
+        channel.dataSize = (int32) out.getDataSize();
+    }
+
+    static ValueTree readTree (const SharedBlock& shared, const ChannelState& channel)
+    {
+        return ValueTree::readFromData (shared.getControlData(),
+                                        (size_t) jlimit (0, (int) controlCapacity, (int) channel.dataSize));
+    }
+
+    static ValueTree createError (const String& message)
+    {
+        ValueTree error ("error");
+        error.setProperty ("message", message, nullptr);
+        return error;
+    }
+
+    static int getCurrentProcessId() noexcept
+    {
+       #if JUCE_WINDOWS
+        return (int) GetCurrentProcessId();
+       #else
+        return (int) getpid();
+       #endif
+    }
+
+    static bool isProcessRunning (const int processId) noexcept
+    {
+       #if JUCE_WINDOWS
+        HANDLE h = OpenProcess (SYNCHRONIZE, FALSE, (DWORD) processId);
+
+        if (h == 0)
+            return false;
+
+        const bool running = WaitForSingleObject (h, 0) == WAIT_TIMEOUT;
+        CloseHandle (h);
+        return running;
+       #else
+        return kill ((pid_t) processId, 0) == 0 || errno == EPERM;
+       #endif
+    }
+}
+
+//==============================================================================
+/* The side of the sandbox that actually hosts the plugin. It normally lives in the child
+   process, but can also be run inside the host by SandboxedPluginInstance::createInProcess().
+*/
+class SandboxServer  : private AudioProcessorListener
+{
+public:
+    SandboxServer (const File& sharedFile, AudioPluginFormatManager& formats, const bool isChildProcess_)
+        : shared (sharedFile),
+          formatManager (formats),
+          isChildProcess (isChildProcess_),
+          channels (SandboxHelpers::maxNumChannels),
+          audioThread (*this),
+          controlThread (*this)
+    {
+        if (shared.isValid())
+            for (int i = 0; i < SandboxHelpers::maxNumChannels; ++i)
+                channels[i] = shared.getChannel (i);
+
+        midi.ensureSize (SandboxHelpers::midiCapacity);
+    }
+
+    ~SandboxServer()
+    {
+        audioThread.stopThread (2000);
+        controlThread.stopThread (2000);
+
+        if (plugin != nullptr)
+            plugin->removeListener (this);
+    }
+
+    bool isValid() const noexcept
+    {
+        return shared.isValid() && shared.getHeader().magic == SandboxHelpers::magicNumber;
+    }
+
+    void start()
+    {
+        audioThread.startThread (8);
+        controlThread.startThread();
+    }
+
+private:
+    //==============================================================================
+    class AudioThread  : public Thread
+    {
+    public:
+        AudioThread (SandboxServer& owner_) : Thread ("Plugin sandbox audio"), owner (owner_) {}
+        void run()  { owner.runAudioThread(); }
+
+    private:
+        SandboxServer& owner;
+        JUCE_DECLARE_NON_COPYABLE (AudioThread)
+    };
+
+    class ControlThread  : public Thread
+    {
+    public:
+        ControlThread (SandboxServer& owner_) : Thread ("Plugin sandbox control"), owner (owner_) {}
+        void run()  { owner.runControlThread(); }
+
+    private:
+        SandboxServer& owner;
+        JUCE_DECLARE_NON_COPYABLE (ControlThread)
+    };
+
+    struct CommandCall
+    {
+        CommandCall (SandboxServer& owner_, const ValueTree& request_)
+            : owner (owner_), request (request_) {}
+
+        SandboxServer& owner;
+        ValueTree request, reply;
+    };
+
+    class QuitMessage  : public CallbackMessage
+    {
+    public:
+        QuitMessage (SandboxServer* server_) : server (server_) {}
+
+        void messageCallback()
+        {
+            delete server;
+            JUCEApplication::quit();
+        }
+
+    private:
+        SandboxServer* server;
+    };
+
+    //==============================================================================
+    SandboxHelpers::SharedBlock shared;
+    AudioPluginFormatManager& formatManager;
+    ScopedPointer<AudioPluginInstance> plugin;
+    const bool isChildProcess;
+    HeapBlock<float*> channels;
+    MidiBuffer midi;
+    SpinLock hostChangesLock, pluginChangesLock;
+    AudioThread audioThread;
+    ControlThread controlThread;
+
+    //==============================================================================
+    void runAudioThread()
+    {
+        using namespace SandboxHelpers;
+        SharedHeader& header = shared.getHeader();
+        int32 lastRequest = 0;
+
+        while (! audioThread.threadShouldExit())
+        {
+            if (waitWhileEqual (header.audio.requestNumber, lastRequest, 100))
+            {
+                lastRequest = header.audio.requestNumber.get();
+                processAudioBlock (header);
+                header.audio.replyNumber = lastRequest;
+                wakeWaiters (header.audio.replyNumber);
+            }
+        }
+    }
+
+    void processAudioBlock (SandboxHelpers::SharedHeader& header)
+    {
+        using namespace SandboxHelpers;
+        const int numSamples = jlimit (0, (int) maxBlockSize, (int) header.audio.numSamples);
+
+        if (plugin == nullptr)
+        {
+            header.audio.midiSize = 0;
+            return;
+        }
+
+        applyHostParameterChanges();
+
+        const int numChannels = jmin ((int) maxNumChannels,
+                                      jmax (plugin->getNumInputChannels(), plugin->getNumOutputChannels()));
+
+        for (int i = jmax (0, (int) header.audio.numChannels); i < numChannels; ++i)
+            zeromem (channels[i], sizeof (float) * (size_t) numSamples);
+
+        AudioSampleBuffer buffer (channels, numChannels, numSamples);
+
+        midi.clear();
+        readMidi (midi, shared.getMidiData(), header.audio.midiSize, 0, numSamples);
+
+        {
+            const ScopedLock sl (plugin->getCallbackLock());
+
+            if (plugin->isSuspended())
+                buffer.clear();
+            else
+                plugin->processBlock (buffer, midi);
+        }
+
+        header.audio.midiSize = writeMidi (midi, shared.getMidiData(), 0, numSamples);
+        header.latencySamples = plugin->getLatencySamples();
+    }
+
+    //==============================================================================
+    void runControlThread()
+    {
+        using namespace SandboxHelpers;
+        SharedHeader& header = shared.getHeader();
+        int32 lastRequest = 0;
+        int numIdleSlices = 0;
+
+        while (! controlThread.threadShouldExit())
+        {
+            // changes are also picked up here, so that they still arrive when no audio is running
+            applyHostParameterChanges();
+
+            if (! waitWhileEqual (header.control.requestNumber, lastRequest, 20))
+            {
+                if (isChildProcess && ++numIdleSlices >= 50)
+                {
+                    numIdleSlices = 0;
+
+                    if (! isProcessRunning (header.hostProcessId))
+                    {
+                        (new QuitMessage (this))->post();
+                        return;
+                    }
+                }
+
+                continue;
+            }
+
+            lastRequest = header.control.requestNumber.get();
+            applyHostParameterChanges();
+
+            CommandCall call (*this, readTree (shared, header.control));
+
+            if (isChildProcess)
+                MessageManager::getInstance()->callFunctionOnMessageThread (handleCommandCallback, &call);
+            else
+                handleCommandCallback (&call);
+
+            writeTree (call.reply, shared, header.control);
+            header.control.replyNumber = lastRequest;
+            wakeWaiters (header.control.replyNumber);
+
+            if (call.request.hasType ("quit"))
+            {
+                if (isChildProcess)
+                    (new QuitMessage (this))->post();
+
+                return;
+            }
+        }
+    }
+
+    static void* handleCommandCallback (void* userData)
+    {
+        CommandCall* const call = static_cast <CommandCall*> (userData);
+        call->reply = call->owner.handleCommand (call->request);
+        return nullptr;
+    }
+
+    ValueTree handleCommand (const ValueTree& request)
+    {
+        using namespace SandboxHelpers;
+
+        if (request.hasType ("quit"))
+            return ValueTree ("ok");
+
+        if (request.hasType ("load"))
+            return loadPlugin (request);
+
+        if (plugin == nullptr)
+            return createError ("No plug-in has been loaded");
+
+        if (request.hasType ("describe"))
+            return createInfo();
+
+        if (request.hasType ("prepare"))
+        {
+            plugin->setNonRealtime (request ["nonRealtime"]);
+            plugin->prepareToPlay (request ["sampleRate"], jmin ((int) maxBlockSize, (int) request ["blockSize"]));
+            return createInfo();
+        }
+
+        if (request.hasType ("release"))
+        {
+            plugin->releaseResources();
+            return ValueTree ("ok");
+        }
+
+        if (request.hasType ("reset"))
+        {
+            plugin->reset();
+            return ValueTree ("ok");
+        }
+
+        ValueTree reply ("ok");
+
+        if (request.hasType ("getParameter"))
+        {
+            reply.setProperty ("value", plugin->getParameter (request ["index"]), nullptr);
+        }
+        else if (request.hasType ("parameterText"))
+        {
+            reply.setProperty ("text", plugin->getParameterText (request ["index"]), nullptr);
+        }
+        else if (request.hasType ("programName"))
+        {
+            reply.setProperty ("name", plugin->getProgramName (request ["index"]), nullptr);
+        }
+        else if (request.hasType ("changeProgramName"))
+        {
+            plugin->changeProgramName (request ["index"], request ["name"]);
+        }
+        else if (request.hasType ("setProgram"))
+        {
+            plugin->setCurrentProgram (request ["index"]);
+            refreshParameterCache();
+            return createInfo();
+        }
+        else if (request.hasType ("getState"))
+        {
+            MemoryBlock state;
+
+            if (request ["currentProgramOnly"])
+                plugin->getCurrentProgramStateInformation (state);
+            else
+                plugin->getStateInformation (state);
+
+            reply.setProperty ("data", state.toBase64Encoding(), nullptr);
+        }
+        else if (request.hasType ("setState"))
+        {
+            MemoryBlock state;
+            state.fromBase64Encoding (request ["data"]);
+
+            if (request ["currentProgramOnly"])
+                plugin->setCurrentProgramStateInformation (state.getData(), (int) state.getSize());
+            else
+                plugin->setStateInformation (state.getData(), (int) state.getSize());
+
+            refreshParameterCache();
+            return createInfo();
+        }
+        else
+        {
+            jassertfalse;
+            return createError ("Unknown command");
+        }
+
+        return reply;
+    }
+
+    ValueTree loadPlugin (const ValueTree& request)
+    {
+        using namespace SandboxHelpers;
+
+        if (plugin != nullptr)
+            return createError ("A plug-in has already been loaded");
+
+        ScopedPointer<XmlElement> xml (XmlDocument::parse (request ["description"].toString()));
+        PluginDescription description;
+
+        if (xml == nullptr || ! description.loadFromXml (*xml))
+            return createError ("The plug-in description was invalid");
+
+        String errorMessage;
+        plugin = formatManager.createPluginInstance (description, errorMessage);
+
+        if (plugin == nullptr)
+            return createError (errorMessage);
+
+        refreshParameterCache();
+        plugin->addListener (this);
+        return createInfo();
+    }
+
+    ValueTree createInfo()
+    {
+        using namespace SandboxHelpers;
+        ValueTree info ("info");
+
+        info.setProperty ("name", plugin->getName(), nullptr);
+        info.setProperty ("latency", plugin->getLatencySamples(), nullptr);
+        info.setProperty ("tailLength", plugin->getTailLengthSeconds(), nullptr);
+        info.setProperty ("acceptsMidi", plugin->acceptsMidi(), nullptr);
+        info.setProperty ("producesMidi", plugin->producesMidi(), nullptr);
+        info.setProperty ("silenceInSilenceOut", plugin->silenceInProducesSilenceOut(), nullptr);
+        info.setProperty ("numPrograms", plugin->getNumPrograms(), nullptr);
+        info.setProperty ("currentProgram", plugin->getCurrentProgram(), nullptr);
+
+        ValueTree inputs ("inputs"), outputs ("outputs"), parameters ("parameters");
+
+        for (int i = 0; i < jmin ((int) maxNumChannels, plugin->getNumInputChannels()); ++i)
+        {
+            ValueTree channel ("channel");
+            channel.setProperty ("name", plugin->getInputChannelName (i), nullptr);
+            channel.setProperty ("stereoPair", plugin->isInputChannelStereoPair (i), nullptr);
+            inputs.addChild (channel, -1, nullptr);
+        }
+
+        for (int i = 0; i < jmin ((int) maxNumChannels, plugin->getNumOutputChannels()); ++i)
+        {
+            ValueTree channel ("channel");
+            channel.setProperty ("name", plugin->getOutputChannelName (i), nullptr);
+            channel.setProperty ("stereoPair", plugin->isOutputChannelStereoPair (i), nullptr);
+            outputs.addChild (channel, -1, nullptr);
+        }
+
+        for (int i = 0; i < plugin->getNumParameters(); ++i)
+        {
+            ValueTree parameter ("parameter");
+            parameter.setProperty ("name", plugin->getParameterName (i), nullptr);
+            parameters.addChild (parameter, -1, nullptr);
+        }
+
+        info.addChild (inputs, -1, nullptr);
+        info.addChild (outputs, -1, nullptr);
+        info.addChild (parameters, -1, nullptr);
+        return info;
+    }
+
+    //==============================================================================
+    void applyHostParameterChanges()
+    {
+        if (plugin != nullptr)
+        {
+            const SpinLock::ScopedLockType sl (hostChangesLock);
+            int index;
+            float value;
+
+            while (shared.getHeader().hostToPlugin.pop (index, value))
+                if (isPositiveAndBelow (index, plugin->getNumParameters()))
+                    plugin->setParameter (index, value);
+        }
+    }
+
+    void refreshParameterCache()
+    {
+        const int num = jmin ((int) SandboxHelpers::maxCachedParameters, plugin->getNumParameters());
+
+        for (int i = 0; i < num; ++i)
+            shared.getHeader().parameterValues[i] = plugin->getParameter (i);
+    }
+
+    void audioProcessorParameterChanged (AudioProcessor*, int parameterIndex, float newValue)
+    {
+        SandboxHelpers::SharedHeader& header = shared.getHeader();
+
+        if (isPositiveAndBelow (parameterIndex, (int) SandboxHelpers::maxCachedParameters))
+            header.parameterValues [parameterIndex] = newValue;
+
+        const SpinLock::ScopedLockType sl (pluginChangesLock);
+        header.pluginToHost.push (parameterIndex, newValue);
+    }
+
+    void audioProcessorChanged (AudioProcessor*)
+    {
+        ++(shared.getHeader().changeCounter);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (SandboxServer)
+};
+
+//==============================================================================
+class SandboxedPluginInstance::Connection
+{
+public:
+    Connection()
+        : sharedFile (SandboxHelpers::createSharedFile()),
+          controlRequests (0), audioRequests (0),
+          audioReplyPending (false)
+    {
+        if (sharedFile.existsAsFile())
+        {
+            shared = new SandboxHelpers::SharedBlock (sharedFile);
+
+            if (shared->isValid())
+            {
+                shared->getHeader().magic = SandboxHelpers::magicNumber;
+                shared->getHeader().hostProcessId = SandboxHelpers::getCurrentProcessId();
+            }
+            else
+            {
+                shared = nullptr;
+            }
+        }
+    }
+
+    ~Connection()
+    {
+        if (childProcess != nullptr)
+        {
+            if (! hasCrashed())
+                sendCommand (ValueTree ("quit"), 2000);
+
+            for (int i = 200; --i >= 0 && childProcess->isRunning();)
+                Thread::sleep (10);
+
+            if (childProcess->isRunning())
+                childProcess->kill();
+
+            childProcess = nullptr;
+        }
+
+        server = nullptr;
+        shared = nullptr;
+        sharedFile.deleteFile();
+    }
+
+    static Connection* launchChildProcess (String& errorMessage)
+    {
+        ScopedPointer<Connection> c (new Connection());
+
+        if (c->shared == nullptr)
+        {
+            errorMessage = TRANS ("Couldn't create the shared memory for the plug-in sandbox");
+            return nullptr;
+        }
+
+        StringArray args;
+        args.add (File::getSpecialLocation (File::currentExecutableFile).getFullPathName());
+        args.add (SandboxHelpers::commandLineFlag);
+        args.add (c->sharedFile.getFullPathName());
+
+        c->childProcess = new ChildProcess();
+
+        if (! c->childProcess->start (args))
+        {
+            c->childProcess = nullptr;
+            errorMessage = TRANS ("Couldn't launch the plug-in sandbox process");
+            return nullptr;
+        }
+
+        return c.release();
+    }
+
+    static Connection* launchInProcess (AudioPluginFormatManager& formats, String& errorMessage)
+    {
+        ScopedPointer<Connection> c (new Connection());
+
+        if (c->shared != nullptr)
+        {
+            c->server = new SandboxServer (c->sharedFile, formats, false);
+
+            if (c->server->isValid())
+            {
+                c->server->start();
+                return c.release();
+            }
+        }
+
+        errorMessage = TRANS ("Couldn't create the shared memory for the plug-in sandbox");
+        return nullptr;
+    }
+
+    bool hasCrashed() const noexcept        { return crashed.get() != 0; }
+
+    //==============================================================================
+    ValueTree sendCommand (const ValueTree& command, const int timeoutMs)
+    {
+        using namespace SandboxHelpers;
+        const ScopedLock sl (controlLock);
+
+        if (hasCrashed())
+            return ValueTree::invalid;
+
+        SharedHeader& header = shared->getHeader();
+        writeTree (command, *shared, header.control);
+
+        header.control.requestNumber = ++controlRequests;
+        wakeWaiters (header.control.requestNumber);
+
+        if (! waitForReply (header.control.replyNumber, controlRequests - 1, timeoutMs))
+        {
+            markCrashed();
+            return ValueTree::invalid;
+        }
+
+        return readTree (*shared, header.control);
+    }
+
+    /** Sends a block through the plugin in chunks, returning false if the output
+        should be silence instead.
+    */
+    bool processBlock (AudioSampleBuffer& buffer, const MidiBuffer& midiIn, MidiBuffer& midiOut,
+                       int numIns, int numOuts, const double sampleRate)
+    {
+        using namespace SandboxHelpers;
+        midiOut.clear();
+
+        if (hasCrashed())
+            return false;
+
+        SharedHeader& header = shared->getHeader();
+
+        if (audioReplyPending)
+        {
+            // the server is still busy with a block that we gave up waiting for..
+            if (header.audio.replyNumber.get() != audioRequests)
+            {
+                if (! isServerAlive())
+                    markCrashed();
+
+                return false;
+            }
+
+            audioReplyPending = false;
+        }
+
+        numIns  = jmin (numIns,  buffer.getNumChannels(), (int) maxNumChannels);
+        numOuts = jmin (numOuts, buffer.getNumChannels(), (int) maxNumChannels);
+        const int numSamples = buffer.getNumSamples();
+
+        for (int start = 0; start < numSamples; start += maxBlockSize)
+        {
+            const int num = jmin ((int) maxBlockSize, numSamples - start);
+            // (allows four block lengths, but never less than the millisecond counter can measure)
+            const int timeoutMs = jmax (2, roundToInt (4000.0 * num / jmax (1.0, sampleRate)));
+
+            for (int i = 0; i < numIns; ++i)
+                memcpy (shared->getChannel (i), buffer.getSampleData (i, start), sizeof (float) * (size_t) num);
+
+            header.audio.numChannels = numIns;
+            header.audio.numSamples = num;
+            header.audio.midiSize = writeMidi (midiIn, shared->getMidiData(), start, num);
+
+            header.audio.requestNumber = ++audioRequests;
+            wakeWaiters (header.audio.requestNumber);
+
+            if (! waitForReply (header.audio.replyNumber, audioRequests - 1, timeoutMs))
+            {
+                audioReplyPending = true;
+                midiOut.clear();
+                return false;
+            }
+
+            for (int i = 0; i < numOuts; ++i)
+                memcpy (buffer.getSampleData (i, start), shared->getChannel (i), sizeof (float) * (size_t) num);
+
+            readMidi (midiOut, shared->getMidiData(), header.audio.midiSize, start, num);
+        }
+
+        return true;
+    }
+
+    void resetAudio() noexcept
+    {
+        // (lets the next block start afresh once the server has caught up)
+        audioReplyPending = audioReplyPending && shared->getHeader().audio.replyNumber.get() != audioRequests;
+    }
+
+    //==============================================================================
+    float getCachedParameter (const int index) const noexcept
+    {
+        jassert (isPositiveAndBelow (index, (int) SandboxHelpers::maxCachedParameters));
+        return shared->getHeader().parameterValues [index];
+    }
+
+    void setParameter (const int index, const float value) noexcept
+    {
+        SandboxHelpers::SharedHeader& header = shared->getHeader();
+
+        if (isPositiveAndBelow (index, (int) SandboxHelpers::maxCachedParameters))
+            header.parameterValues [index] = value;
+
+        const SpinLock::ScopedLockType sl (hostChangesLock);
+        header.hostToPlugin.push (index, value);
+    }
+
+    bool popPluginParameterChange (int& index, float& value) noexcept
+    {
+        const SpinLock::ScopedLockType sl (pluginChangesLock);
+        return shared->getHeader().pluginToHost.pop (index, value);
+    }
+
+    int getLatencySamples() const noexcept      { return shared->getHeader().latencySamples.get(); }
+    int getChangeCounter() const noexcept       { return shared->getHeader().changeCounter.get(); }
+
+private:
+    //==============================================================================
+    File sharedFile;
+    ScopedPointer<SandboxHelpers::SharedBlock> shared;
+    ScopedPointer<ChildProcess> childProcess;
+    ScopedPointer<SandboxServer> server;
+    CriticalSection controlLock;
+    SpinLock hostChangesLock, pluginChangesLock;
+    Atomic<int> crashed;
+    int32 controlRequests, audioRequests;
+    bool audioReplyPending;
+
+    bool isServerAlive() const
+    {
+        return childProcess == nullptr || childProcess->isRunning();
+    }
+
+    void markCrashed()
+    {
+        if (crashed.compareAndSetBool (1, 0) && childProcess != nullptr)
+            childProcess->kill();
+    }
+
+    bool waitForReply (Atomic<int32>& replyNumber, const int32 oldValue, const int timeoutMs)
+    {
+        const uint32 startTime = Time::getMillisecondCounter();
+
+        for (;;)
+        {
+            const int remaining = timeoutMs - (int) (Time::getMillisecondCounter() - startTime);
+
+            if (remaining <= 0)
+                return false;
+
+            if (SandboxHelpers::waitWhileEqual (replyNumber, oldValue, jmin (50, remaining)))
+                return true;
+
+            if (! isServerAlive())
+            {
+                markCrashed();
+                return false;
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Connection)
+};
+
+//==============================================================================
+SandboxedPluginInstance::SandboxedPluginInstance (Connection* c)
+    : connection (c), lastChangeCounter (0)
+{
+    midiOutput.setFixedCapacity (SandboxHelpers::midiCapacity);
+}
+
+SandboxedPluginInstance::~SandboxedPluginInstance()
+{
+    cancelPendingUpdate();
+    connection = nullptr;
+}
+
+SandboxedPluginInstance* SandboxedPluginInstance::create (const PluginDescription& desc, String& errorMessage)
+{
+    Connection* const c = Connection::launchChildProcess (errorMessage);
+
+    if (c == nullptr)
+        return nullptr;
+
+    ScopedPointer<SandboxedPluginInstance> instance (new SandboxedPluginInstance (c));
+    return instance->load (desc, errorMessage) ? instance.release() : nullptr;
+}
+
+SandboxedPluginInstance* SandboxedPluginInstance::createInProcess (const PluginDescription& desc,
+                                                                   AudioPluginFormatManager& formatsToUse,
+                                                                   String& errorMessage)
+{
+    Connection* const c = Connection::launchInProcess (formatsToUse, errorMessage);
+
+    if (c == nullptr)
+        return nullptr;
+
+    ScopedPointer<SandboxedPluginInstance> instance (new SandboxedPluginInstance (c));
+    return instance->load (desc, errorMessage) ? instance.release() : nullptr;
+}
+
+bool SandboxedPluginInstance::handleCommandLine (const String& commandLine, AudioPluginFormatManager& formatsToUse)
+{
+    using namespace SandboxHelpers;
+
+    if (! commandLine.trim().startsWith (commandLineFlag))
+        return false;
+
+    redirectWorkerProcessOutput();
+
+    const File sharedFile (commandLine.fromFirstOccurrenceOf (commandLineFlag, false, false).trim().unquoted());
+    ScopedPointer<SandboxServer> server (new SandboxServer (sharedFile, formatsToUse, true));
+
+    if (server->isValid())
+        server.release()->start();  // (this will delete itself when the host has finished with it)
+    else
+        JUCEApplication::quit();
+
+    return true;
+}
+
+bool SandboxedPluginInstance::hasCrashed() const noexcept
+{
+    return connection == nullptr || connection->hasCrashed();
+}
+
+//==============================================================================
+bool SandboxedPluginInstance::load (const PluginDescription& desc, String& errorMessage)
+{
+    description = desc;
+
+    ScopedPointer<XmlElement> xml (desc.createXml());
+    ValueTree command ("load");
+    command.setProperty ("description", xml->createDocument (String::empty, true, false), nullptr);
+
+    const ValueTree reply (connection->sendCommand (command, 30000));
+
+    if (! reply.isValid())
+    {
+        errorMessage = TRANS ("The plug-in sandbox process stopped responding");
+        return false;
+    }
+
+    if (reply.hasType ("error"))
+    {
+        errorMessage = reply ["message"].toString();
+        return false;
+    }
+
+    updateInfo (reply);
+    return true;
+}
+
+ValueTree SandboxedPluginInstance::sendCommand (const ValueTree& command)
+{
+    return connection->sendCommand (command, 20000);
+}
+
+ValueTree SandboxedPluginInstance::getInfo() const
+{
+    const ScopedLock sl (infoLock);
+    return info;
+}
+
+void SandboxedPluginInstance::updateInfo (const ValueTree& newInfo)
+{
+    if (newInfo.hasType ("info"))
+    {
+        {
+            const ScopedLock sl (infoLock);
+            info = newInfo;
+        }
+
+        setPlayConfigDetails (newInfo.getChildWithName ("inputs").getNumChildren(),
+                              newInfo.getChildWithName ("outputs").getNumChildren(),
+                              getSampleRate(), getBlockSize());
+        setLatencySamples (newInfo ["latency"]);
+    }
+}
+
+void SandboxedPluginInstance::handleAsyncUpdate()
+{
+    updateInfo (sendCommand (ValueTree ("describe")));
+    updateHostDisplay();
+}
+
+//==============================================================================
+void SandboxedPluginInstance::fillInPluginDescription (PluginDescription& desc) const
+{
+    desc = description;
+
+    const ValueTree currentInfo (getInfo());
+    desc.name = currentInfo ["name"].toString();
+    desc.numInputChannels = currentInfo.getChildWithName ("inputs").getNumChildren();
+    desc.numOutputChannels = currentInfo.getChildWithName ("outputs").getNumChildren();
+}
+
+const String SandboxedPluginInstance::getName() const
+{
+    return getInfo() ["name"].toString();
+}
+
+void SandboxedPluginInstance::prepareToPlay (double sampleRate, int estimatedSamplesPerBlock)
+{
+    setPlayConfigDetails (getNumInputChannels(), getNumOutputChannels(), sampleRate, estimatedSamplesPerBlock);
+
+    // (each chunk's midi fits into midiCapacity, so this is enough for a whole block)
+    const int numChunks = jmax (1, (estimatedSamplesPerBlock + SandboxHelpers::maxBlockSize - 1) / SandboxHelpers::maxBlockSize);
+    midiOutput.setFixedCapacity ((size_t) numChunks * SandboxHelpers::midiCapacity);
+
+    ValueTree command ("prepare");
+    command.setProperty ("sampleRate", sampleRate, nullptr);
+    command.setProperty ("blockSize", estimatedSamplesPerBlock, nullptr);
+    command.setProperty ("nonRealtime", isNonRealtime(), nullptr);
+
+    updateInfo (sendCommand (command));
+    connection->resetAudio();
+}
+
+void SandboxedPluginInstance::releaseResources()
+{
+    sendCommand (ValueTree ("release"));
+}
+
+void SandboxedPluginInstance::reset()
+{
+    sendCommand (ValueTree ("reset"));
+}
+
+void SandboxedPluginInstance::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
+{
+    if (connection->processBlock (buffer, midiMessages, midiOutput,
+                                  getNumInputChannels(), getNumOutputChannels(), getSampleRate()))
+    {
+        // (copied rather than swapped, so that midiOutput keeps its preallocated space)
+        midiMessages = midiOutput;
+    }
+    else
+    {
+        buffer.clear();
+        midiMessages.clear();
+    }
+
+    for (int i = getNumOutputChannels(); i < buffer.getNumChannels(); ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    int index;
+    float value;
+
+    while (connection->popPluginParameterChange (index, value))
+        if (isPositiveAndBelow (index, getNumParameters()))
+            sendParamChangeMessageToListeners (index, value);
+
+    if (! hasCrashed())
+    {
+        setLatencySamples (connection->getLatencySamples());
+
+        const int changeCounter = connection->getChangeCounter();
+
+        if (lastChangeCounter != changeCounter)
+        {
+            lastChangeCounter = changeCounter;
+            triggerAsyncUpdate();
+        }
+    }
+}
+
+//==============================================================================
+static ValueTree getSandboxInfoChild (const ValueTree& info, const char* const group, const int index)
+{
+    return info.getChildWithName (group).getChild (index);
+}
+
+const String SandboxedPluginInstance::getInputChannelName (int index) const
+{
+    return getSandboxInfoChild (getInfo(), "inputs", index) ["name"].toString();
+}
+
+const String SandboxedPluginInstance::getOutputChannelName (int index) const
+{
+    return getSandboxInfoChild (getInfo(), "outputs", index) ["name"].toString();
+}
+
+bool SandboxedPluginInstance::isInputChannelStereoPair (int index) const
+{
+    return getSandboxInfoChild (getInfo(), "inputs", index) ["stereoPair"];
+}
+
+bool SandboxedPluginInstance::isOutputChannelStereoPair (int index) const
+{
+    return getSandboxInfoChild (getInfo(), "outputs", index) ["stereoPair"];
+}
+
+bool SandboxedPluginInstance::silenceInProducesSilenceOut() const   { return getInfo() ["silenceInSilenceOut"]; }
+double SandboxedPluginInstance::getTailLengthSeconds() const        { return getInfo() ["tailLength"]; }
+bool SandboxedPluginInstance::acceptsMidi() const                   { return getInfo() ["acceptsMidi"]; }
+bool SandboxedPluginInstance::producesMidi() const                  { return getInfo() ["producesMidi"]; }
+
+bool SandboxedPluginInstance::hasEditor() const                     { return false; }
+AudioProcessorEditor* SandboxedPluginInstance::createEditor()       { return nullptr; }
+
+//==============================================================================
+int SandboxedPluginInstance::getNumParameters()
+{
+    return getInfo().getChildWithName ("parameters").getNumChildren();
+}
+
+const String SandboxedPluginInstance::getParameterName (int index)
+{
+    return getSandboxInfoChild (getInfo(), "parameters", index) ["name"].toString();
+}
+
+float SandboxedPluginInstance::getParameter (int index)
+{
+    if (hasCrashed())
+        return 0.0f;
+
+    if (isPositiveAndBelow (index, (int) SandboxHelpers::maxCachedParameters))
+        return connection->getCachedParameter (index);
+
+    ValueTree command ("getParameter");
+    command.setProperty ("index", index, nullptr);
+    return sendCommand (command) ["value"];
+}
+
+const String SandboxedPluginInstance::getParameterText (int index)
+{
+    ValueTree command ("parameterText");
+    command.setProperty ("index", index, nullptr);
+    return sendCommand (command) ["text"].toString();
+}
+
+void SandboxedPluginInstance::setParameter (int index, float newValue)
+{
+    if (! hasCrashed())
+        connection->setParameter (index, newValue);
+}
+
+//==============================================================================
+int SandboxedPluginInstance::getNumPrograms()       { return getInfo() ["numPrograms"]; }
+int SandboxedPluginInstance::getCurrentProgram()    { return getInfo() ["currentProgram"]; }
+
+void SandboxedPluginInstance::setCurrentProgram (int index)
+{
+    ValueTree command ("setProgram");
+    command.setProperty ("index", index, nullptr);
+    updateInfo (sendCommand (command));
+}
+
+const String SandboxedPluginInstance::getProgramName (int index)
+{
+    ValueTree command ("programName");
+    command.setProperty ("index", index, nullptr);
+    return sendCommand (command) ["name"].toString();
+}
+
+void SandboxedPluginInstance::changeProgramName (int index, const String& newName)
+{
+    ValueTree command ("changeProgramName");
+    command.setProperty ("index", index, nullptr);
+    command.setProperty ("name", newName, nullptr);
+    sendCommand (command);
+}
+
+//==============================================================================
+void SandboxedPluginInstance::getState (juce::MemoryBlock& destData, const bool currentProgramOnly)
+{
+    ValueTree command ("getState");
+    command.setProperty ("currentProgramOnly", currentProgramOnly, nullptr);
+
+    destData.setSize (0);
+    destData.fromBase64Encoding (sendCommand (command) ["data"].toString());
+}
+
+void SandboxedPluginInstance::setState (const void* data, int sizeInBytes, const bool currentProgramOnly)
+{
+    ValueTree command ("setState");
+    command.setProperty ("currentProgramOnly", currentProgramOnly, nullptr);
+    command.setProperty ("data", MemoryBlock (data, (size_t) sizeInBytes).toBase64Encoding(), nullptr);
+
+    updateInfo (sendCommand (command));
+}
+
+void SandboxedPluginInstance::getStateInformation (juce::MemoryBlock& destData)                 { getState (destData, false); }
+void SandboxedPluginInstance::getCurrentProgramStateInformation (juce::MemoryBlock& destData)   { getState (destData, true); }
+void SandboxedPluginInstance::setStateInformation (const void* data, int size)                  { setState (data, size, false); }
+void SandboxedPluginInstance::setCurrentProgramStateInformation (const void* data, int size)    { setState (data, size, true); }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SandboxTestPlugin  : public AudioPluginInstance
+{
+public:
+    SandboxTestPlugin() : gain (1.0f)       { setPlayConfigDetails (2, 2, 0, 0); }
+
+    void fillInPluginDescription (PluginDescription& d) const
+    {
+        d.name = getName();
+        d.pluginFormatName = "SandboxTest";
+        d.numInputChannels = d.numOutputChannels = 2;
+    }
+
+    const String getName() const                        { return "Sandbox Test"; }
+    void prepareToPlay (double, int)                    {}
+    void releaseResources()                             {}
+
+    void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midi)
+    {
+        buffer.applyGain (0, buffer.getNumSamples(), gain);
+
+        // a controller moves the gain, as if the user had changed it in the plugin's editor
+        MidiBuffer::Iterator i (midi);
+        MidiMessage m;
+        int pos;
+
+        while (i.getNextEvent (m, pos))
+            if (m.isController())
+                setParameterNotifyingHost (0, m.getControllerValue() / 127.0f);
+    }
+
+    const String getInputChannelName (int i) const      { return "In " + String (i + 1); }
+    const String getOutputChannelName (int i) const     { return "Out " + String (i + 1); }
+    bool isInputChannelStereoPair (int) const           { return true; }
+    bool isOutputChannelStereoPair (int) const          { return true; }
+    bool silenceInProducesSilenceOut() const            { return true; }
+    double getTailLengthSeconds() const                 { return 0; }
+    bool acceptsMidi() const                            { return true; }
+    bool producesMidi() const                           { return true; }
+    bool hasEditor() const                              { return false; }
+    AudioProcessorEditor* createEditor()                { return nullptr; }
+
+    int getNumParameters()                              { return 1; }
+    const String getParameterName (int)                 { return "Gain"; }
+    float getParameter (int)                            { return gain; }
+    const String getParameterText (int)                 { return String (gain, 2); }
+    void setParameter (int, float newValue)             { gain = newValue; }
+
+    int getNumPrograms()                                { return 1; }
+    int getCurrentProgram()                             { return 0; }
+    void setCurrentProgram (int)                        {}
+    const String getProgramName (int)                   { return "Default"; }
+    void changeProgramName (int, const String&)         {}
+
+    void getStateInformation (juce::MemoryBlock& destData)
+    {
+        const float value = gain;
+        destData.replaceWith (&value, sizeof (value));
+    }
+
+    void setStateInformation (const void* data, int size)
+    {
+        if (size == (int) sizeof (float))
+            gain = *static_cast <const float*> (data);
+    }
+
+private:
+    volatile float gain;
+};
+
+class SandboxTestFormat  : public AudioPluginFormat
+{
+public:
+    String getName() const                                              { return "SandboxTest"; }
+    void findAllTypesForFile (OwnedArray <PluginDescription>&, const String&)    {}
+
+    AudioPluginInstance* createInstanceFromDescription (const PluginDescription& desc)
+    {
+        return desc.pluginFormatName == getName() ? new SandboxTestPlugin() : nullptr;
+    }
+
+    bool fileMightContainThisPluginType (const String&)                 { return false; }
+    String getNameOfPluginFromIdentifier (const String& identifier)     { return identifier; }
+    bool pluginNeedsRescanning (const PluginDescription&)               { return false; }
+    bool doesPluginStillExist (const PluginDescription& desc)           { return desc.pluginFormatName == getName(); }
+    bool canScanForPlugins() const                                      { return false; }
+    StringArray searchPathsForPlugins (const FileSearchPath&, bool)     { return StringArray(); }
+    FileSearchPath getDefaultLocationsToSearch()                        { return FileSearchPath(); }
+};
+
+class SandboxedPluginInstanceTests  : public UnitTest
+{
+public:
+    SandboxedPluginInstanceTests() : UnitTest ("SandboxedPluginInstance") {}
+
+    struct ParameterListener  : public AudioProcessorListener
+    {
+        ParameterListener() : lastIndex (-1), lastValue (0) {}
+
+        void audioProcessorParameterChanged (AudioProcessor*, int index, float value)
+        {
+            lastIndex = index;
+            lastValue = value;
+        }
+
+        void audioProcessorChanged (AudioProcessor*) {}
+
+        int lastIndex;
+        float lastValue;
+    };
+
+    void fillBuffer (AudioSampleBuffer& buffer)
+    {
+        for (int i = 0; i < buffer.getNumChannels(); ++i)
+            FloatVectorOperations::fill (buffer.getSampleData (i), 1.0f, buffer.getNumSamples());
+    }
+
+    void runTest()
+    {
+        AudioPluginFormatManager formats;
+        formats.addFormat (new SandboxTestFormat());
+
+        PluginDescription desc;
+        desc.name = "Sandbox Test";
+        desc.pluginFormatName = "SandboxTest";
+
+        beginTest ("Loading");
+
+        String error;
+        ScopedPointer<SandboxedPluginInstance> plugin (SandboxedPluginInstance::createInProcess (desc, formats, error));
+        expect (plugin != nullptr, error);
+
+        if (plugin == nullptr)
+            return;
+
+        expectEquals (plugin->getName(), String ("Sandbox Test"));
+        expectEquals (plugin->getNumOutputChannels(), 2);
+        expectEquals (plugin->getOutputChannelName (1), String ("Out 2"));
+        expectEquals (plugin->getNumParameters(), 1);
+        expectEquals (plugin->getParameterName (0), String ("Gain"));
+        expectEquals (plugin->getProgramName (0), String ("Default"));
+        expect (plugin->producesMidi() && ! plugin->hasCrashed());
+
+        {
+            PluginDescription missing;
+            missing.pluginFormatName = "Nonexistent";
+            error = String::empty;
+
+            ScopedPointer<SandboxedPluginInstance> failed (SandboxedPluginInstance::createInProcess (missing, formats, error));
+            expect (failed == nullptr && error.isNotEmpty());
+        }
+
+        beginTest ("Processing");
+
+        plugin->prepareToPlay (44100.0, 512);
+        plugin->setParameter (0, 0.5f);
+        expectEquals (plugin->getParameter (0), 0.5f);
+
+        AudioSampleBuffer buffer (2, 512);
+        fillBuffer (buffer);
+        MidiBuffer midi;
+        midi.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 100);
+
+        plugin->processBlock (buffer, midi);
+        expectEquals (buffer.getSampleData (0)[0], 0.5f);
+        expectEquals (buffer.getSampleData (1)[511], 0.5f);
+        expectEquals (getSingleEventPosition (midi), 100);
+        expectEquals (plugin->getParameterText (0), String ("0.50"));
+
+        beginTest ("Blocks larger than the shared buffers");
+
+        AudioSampleBuffer largeBuffer (2, 5000);
+        fillBuffer (largeBuffer);
+        midi.clear();
+        midi.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 4500);
+
+        plugin->processBlock (largeBuffer, midi);
+        expectEquals (largeBuffer.getSampleData (0)[100], 0.5f);
+        expectEquals (largeBuffer.getSampleData (1)[4999], 0.5f);
+        expectEquals (getSingleEventPosition (midi), 4500);
+
+        beginTest ("Parameter changes from the plugin");
+
+        ParameterListener listener;
+        plugin->addListener (&listener);
+
+        midi.clear();
+        midi.addEvent (MidiMessage::controllerEvent (1, 7, 127), 0);
+        plugin->processBlock (buffer, midi);
+
+        expectEquals (plugin->getParameter (0), 1.0f);
+        expectEquals (listener.lastIndex, 0);
+        expectEquals (listener.lastValue, 1.0f);
+        plugin->removeListener (&listener);
+
+        beginTest ("State");
+
+        plugin->setParameter (0, 0.25f);
+        MemoryBlock state;
+        plugin->getStateInformation (state);
+        expectEquals ((int) state.getSize(), (int) sizeof (float));
+
+        plugin->setParameter (0, 0.75f);
+        plugin->setStateInformation (state.getData(), (int) state.getSize());
+        expectEquals (plugin->getParameter (0), 0.25f);
+        expectEquals (plugin->getParameterText (0), String ("0.25"));
+
+        plugin->releaseResources();
+        expect (! plugin->hasCrashed());
+
+        beginTest ("Corrupt midi data");
+
+        HeapBlock<char> data (SandboxHelpers::midiCapacity, true);
+        const int32 events[] = { 10, 3, 0x7f3c90, 9000, 3, 0x7f3c80, 0, 0x7fffffff };
+        memcpy (data, events, sizeof (events));
+
+        MidiBuffer received;
+        SandboxHelpers::readMidi (received, data, (int32) sizeof (events), 0, 512);
+        expectEquals (received.getNumEvents(), 2);
+        expectEquals (received.getLastEventTime(), 511);
+
+        received.clear();
+        SandboxHelpers::readMidi (received, data, 0x7fffffff, 0, 512);
+        expectEquals (received.getNumEvents(), 2);
+    }
+
+    static int getSingleEventPosition (const MidiBuffer& midi)
+    {
+        if (midi.getNumEvents() != 1)
+            return -1;
+
+        MidiBuffer::Iterator i (midi);
+        MidiMessage m;
+        int pos = -1;
+        i.getNextEvent (m, pos);
+        return pos;
+    }
+};
+
+static SandboxedPluginInstanceTests sandboxedPluginInstanceTests;
+
+#endif
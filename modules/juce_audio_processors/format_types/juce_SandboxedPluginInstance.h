@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SANDBOXEDPLUGININSTANCE_JUCEHEADER__
+#define __JUCE_SANDBOXEDPLUGININSTANCE_JUCEHEADER__
+
+#include "../processors/juce_AudioPluginInstance.h"
+#include "../format/juce_AudioPluginFormatManager.h"
+
+
+//==============================================================================
+/**
+    A plugin instance that runs the real plugin in a separate process.
+
+    The plugin is loaded by a child process, which is a copy of your own executable,
+    started with a special command-line. Audio, midi and parameter changes are passed
+    between the two processes through a block of shared memory, so a plugin that crashes
+    or hangs only takes down its own process: this object will just carry on producing
+    silence, and hasCrashed() will return true.
+
+    To use this, your application must call handleCommandLine() as early as possible
+    when it starts up, and if that returns true, must do nothing else except run its
+    message loop until the sandbox quits, e.g.
+
+    @code
+    void MyApp::initialise (const String& commandLine)
+    {
+        if (SandboxedPluginInstance::handleCommandLine (commandLine, sandboxFormatManager))
+            return;
+
+        ...normal start-up...
+    }
+    @endcode
+
+    The plugin's own editor can't be shown in the host process, so hasEditor() returns
+    false, and you should use a GenericAudioProcessorEditor to control it instead.
+
+    @see AudioPluginFormatManager
+*/
+class JUCE_API  SandboxedPluginInstance   : public AudioPluginInstance,
+                                            private AsyncUpdater
+{
+public:
+    //==============================================================================
+    /** Launches a sandbox process and loads the given plugin in it.
+
+        The child process uses whichever formats were registered with the format manager
+        that it passed to handleCommandLine(). If the process can't be started or the plugin
+        fails to load, this returns nullptr and leaves a message in errorMessage.
+    */
+    static SandboxedPluginInstance* create (const PluginDescription& description,
+                                            String& errorMessage);
+
+    /** Loads a plugin using the sandbox's shared-memory transport, but runs its server
+        on threads inside this process instead of in a child process.
+
+        This gives no protection against crashes - it's mainly useful for debugging a
+        plugin's behaviour inside the sandbox, and for testing.
+    */
+    static SandboxedPluginInstance* createInProcess (const PluginDescription& description,
+                                                     AudioPluginFormatManager& formatsToUse,
+                                                     String& errorMessage);
+
+    /** Destructor. This shuts down the child process. */
+    ~SandboxedPluginInstance();
+
+    //==============================================================================
+    /** Call this when your app starts, to check whether this process has been launched
+        as a plugin sandbox.
+
+        If the command-line is the one used by create(), this starts serving the host on
+        some background threads and returns true, in which case your app should simply
+        run its message loop - it'll be told to quit when the host deletes the
+        instance or exits. If it returns false, the app should start up normally.
+    */
+    static bool handleCommandLine (const String& commandLine,
+                                   AudioPluginFormatManager& formatsToUse);
+
+    /** Returns true if the child process has died or stopped responding.
+        Once this has happened, the instance just outputs silence.
+    */
+    bool hasCrashed() const noexcept;
+
+    //==============================================================================
+    /** @internal */
+    void fillInPluginDescription (PluginDescription&) const;
+    /** @internal */
+    const String getName() const;
+    /** @internal */
+    void prepareToPlay (double sampleRate, int estimatedSamplesPerBlock);
+    /** @internal */
+    void releaseResources();
+    /** @internal */
+    void processBlock (AudioSampleBuffer&, MidiBuffer&);
+    /** @internal */
+    void reset();
+
+    /** @internal */
+    const String getInputChannelName (int) const;
+    /** @internal */
+    const String getOutputChannelName (int) const;
+    /** @internal */
+    bool isInputChannelStereoPair (int) const;
+    /** @internal */
+    bool isOutputChannelStereoPair (int) const;
+    /** @internal */
+    bool silenceInProducesSilenceOut() const;
+    /** @internal */
+    double getTailLengthSeconds() const;
+    /** @internal */
+    bool acceptsMidi() const;
+    /** @internal */
+    bool producesMidi() const;
+
+    /** @internal */
+    bool hasEditor() const;
+    /** @internal */
+    AudioProcessorEditor* createEditor();
+
+    /** @internal */
+    int getNumParameters();
+    /** @internal */
+    const String getParameterName (int);
+    /** @internal */
+    float getParameter (int);
+    /** @internal */
+    const String getParameterText (int);
+    /** @internal */
+    void setParameter (int, float);
+
+    /** @internal */
+    int getNumPrograms();
+    /** @internal */
+    int getCurrentProgram();
+    /** @internal */
+    void setCurrentProgram (int);
+    /** @internal */
+    const String getProgramName (int);
+    /** @internal */
+    void changeProgramName (int, const String&);
+
+    /** @internal */
+    void getStateInformation (juce::MemoryBlock&);
+    /** @internal */
+    void getCurrentProgramStateInformation (juce::MemoryBlock&);
+    /** @internal */
+    void setStateInformation (const void*, int);
+    /** @internal */
+    void setCurrentProgramStateInformation (const void*, int);
+
+private:
+    //==============================================================================
+    class Connection;
+    friend class ScopedPointer<Connection>;
+    ScopedPointer<Connection> connection;
+
+    PluginDescription description;
+    ValueTree info;
+    CriticalSection infoLock;
+    MidiBuffer midiOutput;
+    int lastChangeCounter;
+
+    SandboxedPluginInstance (Connection*);
+
+    bool load (const PluginDescription&, String& errorMessage);
+    ValueTree getInfo() const;
+    void updateInfo (const ValueTree&);
+    ValueTree sendCommand (const ValueTree& command);
+    void getState (juce::MemoryBlock&, bool currentProgramOnly);
+    void setState (const void*, int, bool currentProgramOnly);
+    void handleAsyncUpdate();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SandboxedPluginInstance)
+};
+
+
+#endif   // __JUCE_SANDBOXEDPLUGININSTANCE_JUCEHEADER__
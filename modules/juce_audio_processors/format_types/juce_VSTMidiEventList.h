@@ -34,13 +34,29 @@
     events to the list.
 
     This is used by both the VST hosting code and the plugin wrapper.
+
+    All the events and their sysex data live in blocks that are only reallocated when
+    the list runs out of room, so once setCapacity() has been called, filling the list
+    on the audio thread won't allocate anything unless it overflows. What happens then
+    depends on the OverflowPolicy - with dropWhenFull, the extra events are just
+    discarded, so addEvent() is always realtime-safe.
 */
 class VSTMidiEventList
 {
 public:
     //==============================================================================
-    VSTMidiEventList()
-        : numEventsUsed (0), numEventsAllocated (0)
+    /** The ways in which the list can deal with more events than it has room for. */
+    enum OverflowPolicy
+    {
+        growWhenFull,   /**< More space is allocated - nothing is lost, but this isn't realtime-safe. */
+        dropWhenFull    /**< Events that don't fit are discarded and counted - see getNumEventsDropped(). */
+    };
+
+    //==============================================================================
+    VSTMidiEventList (const OverflowPolicy policy = growWhenFull)
+        : numEventsUsed (0), numEventsAllocated (0),
+          numSysexBytesUsed (0), numSysexBytesAllocated (0),
+          numEventsDropped (0), overflowPolicy (policy)
     {
     }
 
@@ -50,55 +66,74 @@ public:
     }
 
     //==============================================================================
-    void clear()
+    /** Preallocates enough space for the given number of events and bytes of sysex data.
+        This allocates memory, so shouldn't be called on the audio thread.
+    */
+    void setCapacity (const int numEvents, const int numSysexBytes)
+    {
+        ensureSize (numEvents);
+        ensureSysexSize (numSysexBytes);
+    }
+
+    /** Returns the number of events that can currently be held without overflowing. */
+    int getCapacity() const noexcept                            { return numEventsAllocated; }
+
+    void setOverflowPolicy (const OverflowPolicy newPolicy) noexcept    { overflowPolicy = newPolicy; }
+    OverflowPolicy getOverflowPolicy() const noexcept           { return overflowPolicy; }
+
+    /** Returns the total number of events that have been discarded because the list was full. */
+    int getNumEventsDropped() const noexcept                    { return numEventsDropped; }
+
+    //==============================================================================
+    void clear() noexcept
     {
         numEventsUsed = 0;
+        numSysexBytesUsed = 0;
 
         if (events != nullptr)
             events->numEvents = 0;
     }
 
-    void addEvent (const void* const midiData, const int numBytes, const int frameOffset)
+    /** Adds an event, returning false if it had to be dropped. */
+    bool addEvent (const void* const midiData, const int numBytes, const int frameOffset)
     {
-        ensureSize (numEventsUsed + 1);
+        const int numSysexBytes = numBytes > 4 ? numBytes : 0;
 
-        VstMidiEvent* const e = (VstMidiEvent*) (events->events [numEventsUsed]);
+        if (! makeRoomFor (numSysexBytes))
+        {
+            ++numEventsDropped;
+            return false;
+        }
+
+        VstEvent* const e = events->events [numEventsUsed];
         events->numEvents = ++numEventsUsed;
 
-        if (numBytes <= 4)
+        if (numSysexBytes == 0)
         {
-            if (e->type == kVstSysExType)
-            {
-                delete[] (((VstMidiSysexEvent*) e)->sysexDump);
-                e->type = kVstMidiType;
-                e->byteSize = sizeof (VstMidiEvent);
-                e->noteLength = 0;
-                e->noteOffset = 0;
-                e->detune = 0;
-                e->noteOffVelocity = 0;
-            }
+            VstMidiEvent* const me = (VstMidiEvent*) e;
+            zerostruct (*me);
 
-            e->deltaFrames = frameOffset;
-            memcpy (e->midiData, midiData, (size_t) numBytes);
+            me->type = kVstMidiType;
+            me->byteSize = sizeof (VstMidiEvent);
+            me->deltaFrames = frameOffset;
+            memcpy (me->midiData, midiData, (size_t) numBytes);
         }
         else
         {
             VstMidiSysexEvent* const se = (VstMidiSysexEvent*) e;
-
-            if (se->type == kVstSysExType)
-                delete[] se->sysexDump;
-
-            se->sysexDump = new char [numBytes];
-            memcpy (se->sysexDump, midiData, (size_t) numBytes);
+            zerostruct (*se);
 
             se->type = kVstSysExType;
             se->byteSize = sizeof (VstMidiSysexEvent);
             se->deltaFrames = frameOffset;
-            se->flags = 0;
             se->dumpBytes = numBytes;
-            se->resvd1 = 0;
-            se->resvd2 = 0;
+            se->sysexDump = sysexData + numSysexBytesUsed;
+            memcpy (se->sysexDump, midiData, (size_t) numBytes);
+
+            numSysexBytesUsed += numBytes;
         }
+
+        return true;
     }
 
     //==============================================================================
@@ -141,8 +176,13 @@ public:
             else
                 events.realloc (size, 1);
 
-            for (int i = numEventsAllocated; i < numEventsNeeded; ++i)
-                events->events[i] = allocateVSTEvent();
+            // (moving the pool is fine, because all the pointers into it get rebuilt)
+            eventPool.realloc ((size_t) numEventsNeeded * getEventSize(), 1);
+            zeromem (eventPool + (size_t) numEventsAllocated * getEventSize(),
+                     (size_t) (numEventsNeeded - numEventsAllocated) * getEventSize());
+
+            for (int i = 0; i < numEventsNeeded; ++i)
+                events->events[i] = (VstEvent*) (eventPool + (size_t) i * getEventSize());
 
             numEventsAllocated = numEventsNeeded;
         }
@@ -150,38 +190,69 @@ public:
 
     void freeEvents()
     {
-        if (events != nullptr)
-        {
-            for (int i = numEventsAllocated; --i >= 0;)
-                freeVSTEvent (events->events[i]);
+        events.free();
+        eventPool.free();
+        sysexData.free();
 
-            events.free();
-            numEventsUsed = 0;
-            numEventsAllocated = 0;
-        }
+        numEventsUsed = 0;
+        numEventsAllocated = 0;
+        numSysexBytesUsed = 0;
+        numSysexBytesAllocated = 0;
     }
 
     //==============================================================================
     HeapBlock <VstEvents> events;
 
 private:
+    HeapBlock <char> eventPool, sysexData;
     int numEventsUsed, numEventsAllocated;
+    int numSysexBytesUsed, numSysexBytesAllocated;
+    int numEventsDropped;
+    OverflowPolicy overflowPolicy;
 
-    static VstEvent* allocateVSTEvent()
+    static size_t getEventSize() noexcept
     {
-        VstEvent* const e = (VstEvent*) std::calloc (1, sizeof (VstMidiEvent) > sizeof (VstMidiSysexEvent) ? sizeof (VstMidiEvent)
-                                                                                                           : sizeof (VstMidiSysexEvent));
-        e->type = kVstMidiType;
-        e->byteSize = sizeof (VstMidiEvent);
-        return e;
+        return sizeof (VstMidiEvent) > sizeof (VstMidiSysexEvent) ? sizeof (VstMidiEvent)
+                                                                  : sizeof (VstMidiSysexEvent);
     }
 
-    static void freeVSTEvent (VstEvent* e)
+    bool makeRoomFor (const int numSysexBytes)
     {
-        if (e->type == kVstSysExType)
-            delete[] (((VstMidiSysexEvent*) e)->sysexDump);
+        if (numEventsUsed < numEventsAllocated
+             && numSysexBytesUsed + numSysexBytes <= numSysexBytesAllocated)
+            return true;
+
+        if (overflowPolicy == dropWhenFull)
+            return false;
+
+        ensureSize (numEventsUsed + 1);
+        ensureSysexSize (numSysexBytesUsed + numSysexBytes);
+        return true;
+    }
 
-        std::free (e);
+    void ensureSysexSize (int numBytesNeeded)
+    {
+        if (numBytesNeeded > numSysexBytesAllocated)
+        {
+            numBytesNeeded = (numBytesNeeded + 1024) & ~1023;
+
+            HeapBlock <char> newData ((size_t) numBytesNeeded);
+
+            if (numSysexBytesUsed > 0)
+                memcpy (newData, sysexData, (size_t) numSysexBytesUsed);
+
+            // any sysex events already in the list have to be pointed at the new block..
+            for (int i = 0; i < numEventsUsed; ++i)
+            {
+                VstMidiSysexEvent* const se = (VstMidiSysexEvent*) events->events[i];
+
+                if (se->type == kVstSysExType)
+                    se->sysexDump = newData + (se->sysexDump - sysexData);
+            }
+
+            sysexData.swapWith (newData);
+            numSysexBytesAllocated = numBytesNeeded;
+        }
     }
 };
 
@@ -928,7 +928,12 @@ public:
                                     || (dispatch (effCanDo, 0, 0, (void*) "receiveVstMidiEvent", 0) > 0);
 
             if (wantsMidiMessages)
-                midiEventsToSend.ensureSize (256);
+            {
+                // (if a block has more events than this, the extra ones get dropped rather
+                // than allocating more space on the audio thread)
+                midiEventsToSend.setCapacity (1024, 65536);
+                midiEventsToSend.setOverflowPolicy (VSTMidiEventList::dropWhenFull);
+            }
             else
                 midiEventsToSend.freeEvents();
 
@@ -1035,7 +1040,6 @@ public:
             if (wantsMidiMessages)
             {
                 midiEventsToSend.clear();
-                midiEventsToSend.ensureSize (1);
 
                 MidiBuffer::Iterator iter (midiMessages);
                 const uint8* midiData;
@@ -52,6 +52,11 @@
  #endif
 #endif
 
+#if JUCE_LINUX
+ #include <sys/syscall.h>
+ #include <linux/futex.h>
+#endif
+
 #if JUCE_PLUGINHOST_VST && JUCE_LINUX
  #include <X11/Xlib.h>
  #include <X11/Xutil.h>
@@ -72,6 +77,22 @@ static inline bool arrayContainsPlugin (const OwnedArray<PluginDescription>& lis
     return false;
 }
 
+// Worker processes send their output back to the host through a pipe which the host never
+// reads, so they call this to stop anything that a plugin prints from filling it up.
+static inline void redirectWorkerProcessOutput()
+{
+   #if ! JUCE_WINDOWS
+    const int nullHandle = open ("/dev/null", O_WRONLY);
+
+    if (nullHandle >= 0)
+    {
+        dup2 (nullHandle, 1);
+        dup2 (nullHandle, 2);
+        close (nullHandle);
+    }
+   #endif
+}
+
 // START_AUTOINCLUDE format/*.cpp, processors/*.cpp, format_types/*.cpp,
 // format_types/*.mm, scanning/*.cpp
 #include "format/juce_AudioPluginFormat.cpp"
@@ -82,11 +103,13 @@ static inline bool arrayContainsPlugin (const OwnedArray<PluginDescription>& lis
 #include "processors/juce_GenericAudioProcessorEditor.cpp"
 #include "processors/juce_PluginDescription.cpp"
 #include "format_types/juce_LADSPAPluginFormat.cpp"
+#include "format_types/juce_SandboxedPluginInstance.cpp"
 #include "format_types/juce_VSTPluginFormat.cpp"
 #include "format_types/juce_AudioUnitPluginFormat.mm"
 #include "scanning/juce_KnownPluginList.cpp"
 #include "scanning/juce_PluginDirectoryScanner.cpp"
 #include "scanning/juce_PluginListComponent.cpp"
+#include "scanning/juce_PluginScannerPool.cpp"
 // END_AUTOINCLUDE
 
 }
@@ -102,6 +102,9 @@ namespace juce
 #ifndef __JUCE_LADSPAPLUGINFORMAT_JUCEHEADER__
  #include "format_types/juce_LADSPAPluginFormat.h"
 #endif
+#ifndef __JUCE_SANDBOXEDPLUGININSTANCE_JUCEHEADER__
+ #include "format_types/juce_SandboxedPluginInstance.h"
+#endif
 #include "format_types/juce_VSTMidiEventList.h"
 #ifndef __JUCE_VSTPLUGINFORMAT_JUCEHEADER__
  #include "format_types/juce_VSTPluginFormat.h"
@@ -115,6 +118,9 @@ namespace juce
 #ifndef __JUCE_PLUGINLISTCOMPONENT_JUCEHEADER__
  #include "scanning/juce_PluginListComponent.h"
 #endif
+#ifndef __JUCE_PLUGINSCANNERPOOL_JUCEHEADER__
+ #include "scanning/juce_PluginScannerPool.h"
+#endif
 // END_AUTOINCLUDE
 
 }
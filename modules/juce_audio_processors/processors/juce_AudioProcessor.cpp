@@ -30,6 +30,190 @@ void JUCE_CALLTYPE AudioProcessor::setTypeOfNextNewPlugin (AudioProcessor::Wrapp
     wrapperTypeBeingCreated = type;
 }
 
+//==============================================================================
+class AudioProcessor::ParameterChangeQueue
+{
+public:
+    ParameterChangeQueue()
+        : fifo (queueSize)
+    {
+        queuedChanges.calloc ((size_t) queueSize);
+        blockChanges.ensureStorageAllocated (queueSize);
+    }
+
+    bool add (const ParameterChange& change) noexcept
+    {
+        const SpinLock::ScopedLockType sl (writeLock);
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 <= 0)
+            return false;
+
+        queuedChanges [start1] = change;
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+    // Moves all the queued changes into blockChanges, sorted by position. The array's
+    // storage was preallocated to hold a full queue, so this never allocates.
+    void readChangesForBlock (const int numSamples) noexcept
+    {
+        blockChanges.clearQuick();
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            addToBlock (queuedChanges [start1 + i], numSamples);
+
+        for (int i = 0; i < size2; ++i)
+            addToBlock (queuedChanges [start2 + i], numSamples);
+
+        fifo.finishedRead (size1 + size2);
+    }
+
+    Array<ParameterChange> blockChanges;
+
+private:
+    enum { queueSize = 1024 };
+
+    AbstractFifo fifo;
+    HeapBlock<ParameterChange> queuedChanges;
+    SpinLock writeLock;
+
+    void addToBlock (ParameterChange change, const int numSamples) noexcept
+    {
+        change.samplePosition = jlimit (0, jmax (0, numSamples - 1), change.samplePosition);
+
+        // changes normally arrive in order, so search backwards for the insertion point, which
+        // also keeps changes that happen at the same position in the order they were queued.
+        int index = blockChanges.size();
+
+        while (index > 0 && blockChanges.getReference (index - 1).samplePosition > change.samplePosition)
+            --index;
+
+        blockChanges.insert (index, change);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParameterChangeQueue)
+};
+
+//==============================================================================
+// Keeps a bit for each parameter, which the audio thread can set without locking, and
+// tells the listeners about the flagged parameters later, on the message thread.
+class AudioProcessor::ParameterChangeNotifier  : private Timer,
+                                                private AsyncUpdater
+{
+public:
+    ParameterChangeNotifier (AudioProcessor& owner_)
+        : owner (owner_), numParameters (0)
+    {
+    }
+
+    ~ParameterChangeNotifier()
+    {
+        stopTimer();
+        cancelPendingUpdate();
+    }
+
+    // Must be called on the message thread.
+    void setDispatchInterval (const int milliseconds)
+    {
+        allocateFlags();
+
+        if (milliseconds > 0)
+            startTimer (milliseconds);
+        else
+            stopTimer();
+    }
+
+    // Can be called on any thread.
+    void parameterChanged (const int parameterIndex) noexcept
+    {
+        Atomic<uint32>* const words = flags.get();
+
+        if (words != nullptr && isPositiveAndBelow (parameterIndex, numParameters))
+        {
+            Atomic<uint32>& word = words [parameterIndex >> 5];
+            const uint32 bit = ((uint32) 1) << (parameterIndex & 31);
+
+            for (;;)
+            {
+                const uint32 oldValue = word.get();
+
+                if ((oldValue & bit) != 0 || word.compareAndSetBool (oldValue | bit, oldValue))
+                    break;
+            }
+        }
+        else
+        {
+            // (the flags haven't been allocated yet, so the message thread
+            // will have to check all the parameters)
+            refreshAll = 1;
+        }
+
+        pending = 1;
+
+        // when the timer's running it'll find the change, so there's no need to post a message
+        if (! isTimerRunning())
+            triggerAsyncUpdate();
+    }
+
+    // Must be called on the message thread.
+    void dispatchPendingChanges()
+    {
+        if (pending.exchange (0) == 0)
+            return;
+
+        allocateFlags();
+        Atomic<uint32>* const words = flags.get();
+        const bool all = refreshAll.exchange (0) != 0;
+
+        for (int i = 0; i < (numParameters + 31) / 32; ++i)
+        {
+            uint32 bits = words[i].exchange (0);
+
+            if (all)
+                bits = ~(uint32) 0;
+
+            for (int bit = 0; bits != 0; ++bit, bits >>= 1)
+            {
+                const int index = i * 32 + bit;
+
+                if ((bits & 1) != 0 && index < numParameters)
+                    owner.callParameterChangeListeners (index, owner.getParameter (index));
+            }
+        }
+    }
+
+private:
+    AudioProcessor& owner;
+    HeapBlock<Atomic<uint32> > flagStorage;
+    Atomic<Atomic<uint32>*> flags;
+    int numParameters;
+    Atomic<int> pending, refreshAll;
+
+    // The number of parameters mustn't change after the processor's been created, so once
+    // the flags have been allocated, they stay put until the notifier is deleted.
+    void allocateFlags()
+    {
+        if (flags.get() == nullptr)
+        {
+            numParameters = owner.getNumParameters();
+            flagStorage.calloc ((size_t) jmax (1, (numParameters + 31) / 32));
+            flags = flagStorage.getData();
+        }
+    }
+
+    void timerCallback()        { dispatchPendingChanges(); }
+    void handleAsyncUpdate()    { dispatchPendingChanges(); }
+
+    JUCE_DECLARE_NON_COPYABLE (ParameterChangeNotifier)
+};
+
+//==============================================================================
 AudioProcessor::AudioProcessor()
     : wrapperType (wrapperTypeBeingCreated.get()),
       playHead (nullptr),
@@ -39,8 +223,13 @@ AudioProcessor::AudioProcessor()
       numOutputChannels (0),
       latencySamples (0),
       suspended (false),
-      nonRealtime (false)
+      nonRealtime (false),
+      parameterNotificationMode (notifyListenersSynchronously),
+      processingPrecision (singlePrecision),
+      floatConversionBuffer (1, 0)
 {
+    parameterChangeQueue = new ParameterChangeQueue();
+    parameterChangeNotifier = new ParameterChangeNotifier (*this);
 }
 
 AudioProcessor::~AudioProcessor()
@@ -88,6 +277,8 @@ void AudioProcessor::setPlayConfigDetails (const int newNumIns,
 
         numChannelsChanged();
     }
+
+    updateFloatConversionBuffer();
 }
 
 void AudioProcessor::numChannelsChanged() {}
@@ -119,16 +310,52 @@ void AudioProcessor::setParameterNotifyingHost (const int parameterIndex,
     sendParamChangeMessageToListeners (parameterIndex, newValue);
 }
 
+void AudioProcessor::setParameterNotifyingHostAsync (const int parameterIndex,
+                                                     const float newValue)
+{
+    jassert (isPositiveAndBelow (parameterIndex, getNumParameters()));
+
+    setParameter (parameterIndex, newValue);
+    parameterChangeNotifier->parameterChanged (parameterIndex);
+}
+
 AudioProcessorListener* AudioProcessor::getListenerLocked (const int index) const noexcept
 {
     const ScopedLock sl (listenerLock);
     return listeners [index];
 }
 
+void AudioProcessor::setParameterNotificationMode (const ParameterNotificationMode newMode,
+                                                   const int dispatchIntervalMs)
+{
+    // the notifier's timer has to be started and stopped on the message thread
+    jassert (MessageManager::getInstance()->isThisTheMessageThread());
+
+    parameterNotificationMode = newMode;
+
+    if (newMode == notifyListenersSynchronously)
+    {
+        parameterChangeNotifier->setDispatchInterval (0);
+        parameterChangeNotifier->dispatchPendingChanges();
+    }
+    else
+    {
+        parameterChangeNotifier->setDispatchInterval (jmax (1, dispatchIntervalMs));
+    }
+}
+
 void AudioProcessor::sendParamChangeMessageToListeners (const int parameterIndex, const float newValue)
 {
     jassert (isPositiveAndBelow (parameterIndex, getNumParameters()));
 
+    if (parameterNotificationMode == notifyListenersAsynchronously)
+        parameterChangeNotifier->parameterChanged (parameterIndex);
+    else
+        callParameterChangeListeners (parameterIndex, newValue);
+}
+
+void AudioProcessor::callParameterChangeListeners (const int parameterIndex, const float newValue)
+{
     for (int i = listeners.size(); --i >= 0;)
         if (AudioProcessorListener* l = getListenerLocked (i))
             l->audioProcessorParameterChanged (this, parameterIndex, newValue);
@@ -145,6 +372,8 @@ void AudioProcessor::beginParameterChangeGesture (int parameterIndex)
     changingParams.setBit (parameterIndex);
    #endif
 
+    flushPendingNotificationsIfOnMessageThread();
+
     for (int i = listeners.size(); --i >= 0;)
         if (AudioProcessorListener* l = getListenerLocked (i))
             l->audioProcessorParameterChangeGestureBegin (this, parameterIndex);
@@ -162,11 +391,22 @@ void AudioProcessor::endParameterChangeGesture (int parameterIndex)
     changingParams.clearBit (parameterIndex);
    #endif
 
+    flushPendingNotificationsIfOnMessageThread();
+
     for (int i = listeners.size(); --i >= 0;)
         if (AudioProcessorListener* l = getListenerLocked (i))
             l->audioProcessorParameterChangeGestureEnd (this, parameterIndex);
 }
 
+// When the listeners are being notified asynchronously, any changes that are still waiting need to
+// be sent before telling them about a gesture, or they'd see the gesture end before its last change.
+void AudioProcessor::flushPendingNotificationsIfOnMessageThread()
+{
+    if (parameterNotificationMode == notifyListenersAsynchronously
+         && MessageManager::getInstance()->isThisTheMessageThread())
+        parameterChangeNotifier->dispatchPendingChanges();
+}
+
 void AudioProcessor::updateHostDisplay()
 {
     for (int i = listeners.size(); --i >= 0;)
@@ -174,6 +414,48 @@ void AudioProcessor::updateHostDisplay()
             l->audioProcessorChanged (this);
 }
 
+//==============================================================================
+bool AudioProcessor::queueParameterChange (const int parameterIndex, const float newValue,
+                                           const int samplePosition) noexcept
+{
+    const ParameterChange change = { parameterIndex, newValue, samplePosition };
+    return parameterChangeQueue->add (change);
+}
+
+void AudioProcessor::prepareParameterChangesForBlock (const int numSamples)
+{
+    parameterChangeQueue->readChangesForBlock (numSamples);
+
+    if (! handlesSampleAccurateParameterChanges())
+    {
+        Array<ParameterChange>& changes = parameterChangeQueue->blockChanges;
+
+        for (int i = 0; i < changes.size(); ++i)
+        {
+            const ParameterChange& change = changes.getReference (i);
+            setParameter (change.parameterIndex, change.newValue);
+        }
+
+        changes.clearQuick();
+    }
+}
+
+bool AudioProcessor::handlesSampleAccurateParameterChanges() const
+{
+    return false;
+}
+
+int AudioProcessor::getNumParameterChangesInBlock() const noexcept
+{
+    return parameterChangeQueue->blockChanges.size();
+}
+
+const AudioProcessor::ParameterChange& AudioProcessor::getParameterChangeInBlock (const int index) const noexcept
+{
+    return parameterChangeQueue->blockChanges.getReference (index);
+}
+
+//==============================================================================
 String AudioProcessor::getParameterLabel (int) const        { return String::empty; }
 bool AudioProcessor::isParameterAutomatable (int) const     { return true; }
 bool AudioProcessor::isMetaParameter (int) const            { return false; }
@@ -187,6 +469,47 @@ void AudioProcessor::suspendProcessing (const bool shouldBeSuspended)
 void AudioProcessor::reset() {}
 void AudioProcessor::processBlockBypassed (AudioSampleBuffer&, MidiBuffer&) {}
 
+//==============================================================================
+bool AudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return false;
+}
+
+void AudioProcessor::setProcessingPrecision (const ProcessingPrecision newPrecision) noexcept
+{
+    processingPrecision = newPrecision;
+    updateFloatConversionBuffer();
+}
+
+void AudioProcessor::updateFloatConversionBuffer()
+{
+    // (allocated up-front so that the default double-precision processBlock() doesn't
+    // need to touch the heap on the audio thread)
+    if (processingPrecision == doublePrecision && ! supportsDoublePrecisionProcessing())
+        floatConversionBuffer.setSize (jmax (1, numInputChannels, numOutputChannels), blockSize, false, false, true);
+    else
+        floatConversionBuffer.setSize (1, 0);
+}
+
+void AudioProcessor::processBlock (AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
+{
+    // If you've overridden supportsDoublePrecisionProcessing(), you need to override this too!
+    jassert (! supportsDoublePrecisionProcessing());
+
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+
+    floatConversionBuffer.setSize (numChannels, numSamples, false, false, true);
+
+    for (int i = 0; i < numChannels; ++i)
+        FloatVectorOperations::copy (floatConversionBuffer.getSampleData (i), buffer.getSampleData (i), numSamples);
+
+    processBlock (floatConversionBuffer, midiMessages);
+
+    for (int i = jmin (numChannels, numOutputChannels); --i >= 0;)
+        FloatVectorOperations::copy (buffer.getSampleData (i), floatConversionBuffer.getSampleData (i), numSamples);
+}
+
 //==============================================================================
 void AudioProcessor::editorBeingDeleted (AudioProcessorEditor* const editor) noexcept
 {
@@ -296,3 +619,176 @@ void AudioPlayHead::CurrentPositionInfo::resetToDefault()
     timeSigDenominator = 4;
     bpm = 120;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioProcessorParameterChangeTests  : public UnitTest
+{
+public:
+    AudioProcessorParameterChangeTests() : UnitTest ("AudioProcessor parameter changes") {}
+
+    class TestProcessor  : public AudioProcessor
+    {
+    public:
+        TestProcessor (const bool sampleAccurate_)  : sampleAccurate (sampleAccurate_)
+        {
+            zeromem (values, sizeof (values));
+        }
+
+        const String getName() const                        { return "Test"; }
+        void prepareToPlay (double, int)                    {}
+        void releaseResources()                             {}
+
+        void processBlock (AudioSampleBuffer&, MidiBuffer&)
+        {
+            blockChanges.clearQuick();
+
+            for (int i = 0; i < getNumParameterChangesInBlock(); ++i)
+                blockChanges.add (getParameterChangeInBlock (i));
+        }
+
+        bool handlesSampleAccurateParameterChanges() const  { return sampleAccurate; }
+
+        const String getInputChannelName (int) const        { return String::empty; }
+        const String getOutputChannelName (int) const       { return String::empty; }
+        bool isInputChannelStereoPair (int) const           { return true; }
+        bool isOutputChannelStereoPair (int) const          { return true; }
+        bool silenceInProducesSilenceOut() const            { return true; }
+        double getTailLengthSeconds() const                 { return 0; }
+        bool acceptsMidi() const                            { return false; }
+        bool producesMidi() const                           { return false; }
+        bool hasEditor() const                              { return false; }
+        AudioProcessorEditor* createEditor()                { return nullptr; }
+        int getNumParameters()                              { return numElementsInArray (values); }
+        const String getParameterName (int)                 { return String::empty; }
+        float getParameter (int index)                      { return values [index]; }
+        const String getParameterText (int)                 { return String::empty; }
+        void setParameter (int index, float newValue)       { values [index] = newValue; }
+        int getNumPrograms()                                { return 0; }
+        int getCurrentProgram()                             { return 0; }
+        void setCurrentProgram (int)                        {}
+        const String getProgramName (int)                   { return String::empty; }
+        void changeProgramName (int, const String&)         {}
+        void getStateInformation (juce::MemoryBlock&)       {}
+        void setStateInformation (const void*, int)         {}
+
+        Array<ParameterChange> blockChanges;
+        float values [4];
+
+    private:
+        const bool sampleAccurate;
+    };
+
+    struct CountingListener  : public AudioProcessorListener
+    {
+        CountingListener() : numCalls (0) {}
+
+        void audioProcessorParameterChanged (AudioProcessor*, int parameterIndex, float newValue)
+        {
+            ++numCalls;
+            lastValues.set (parameterIndex, newValue);
+        }
+
+        void audioProcessorChanged (AudioProcessor*) {}
+
+        int numCalls;
+        HashMap<int, float> lastValues;
+    };
+
+    static void processBlock (AudioProcessor& processor, const int numSamples)
+    {
+        AudioSampleBuffer buffer (2, numSamples);
+        MidiBuffer midi;
+
+        processor.prepareParameterChangesForBlock (numSamples);
+        processor.processBlock (buffer, midi);
+    }
+
+    void runTest()
+    {
+        beginTest ("Sample-accurate changes");
+
+        {
+            TestProcessor processor (true);
+
+            expect (processor.queueParameterChange (1, 0.5f, 100));
+            expect (processor.queueParameterChange (2, 0.25f, 10));
+            expect (processor.queueParameterChange (1, 0.75f, 100));
+            expect (processor.queueParameterChange (3, 1.0f, 1000));
+            processBlock (processor, 256);
+
+            expectEquals (processor.blockChanges.size(), 4);
+            expectEquals (processor.blockChanges[0].parameterIndex, 2);
+            expectEquals (processor.blockChanges[0].samplePosition, 10);
+            expectEquals (processor.blockChanges[1].newValue, 0.5f);
+            expectEquals (processor.blockChanges[2].newValue, 0.75f);
+            expectEquals (processor.blockChanges[3].samplePosition, 255);
+
+            // the processor is responsible for applying them itself..
+            expectEquals (processor.values[1], 0.0f);
+
+            processBlock (processor, 256);
+            expectEquals (processor.blockChanges.size(), 0);
+        }
+
+        beginTest ("Changes for other processors");
+
+        {
+            TestProcessor processor (false);
+
+            expect (processor.queueParameterChange (0, 0.5f, 100));
+            expect (processor.queueParameterChange (0, 0.25f, 200));
+            processBlock (processor, 256);
+
+            expectEquals (processor.blockChanges.size(), 0);
+            expectEquals (processor.values[0], 0.25f);
+        }
+
+        beginTest ("Full queue");
+
+        {
+            TestProcessor processor (true);
+            int numQueued = 0;
+
+            while (processor.queueParameterChange (0, 0.5f, 0))
+                ++numQueued;
+
+            expect (numQueued > 0);
+            processBlock (processor, 256);
+            expectEquals (processor.blockChanges.size(), numQueued);
+            expect (processor.queueParameterChange (0, 0.5f, 0));
+        }
+
+        beginTest ("Coalesced notifications");
+
+        {
+            TestProcessor processor (false);
+            CountingListener listener;
+            processor.addListener (&listener);
+
+            processor.setParameterNotifyingHost (0, 0.1f);
+            expectEquals (listener.numCalls, 1);
+
+            processor.setParameterNotificationMode (AudioProcessor::notifyListenersAsynchronously, 1000);
+
+            for (int i = 0; i < 1000; ++i)
+                processor.setParameterNotifyingHost (1 + i % 2, i / 1000.0f);
+
+            expectEquals (listener.numCalls, 1);
+            expectEquals (processor.values[2], 0.999f);
+
+            // switching back sends anything that's still pending..
+            processor.setParameterNotificationMode (AudioProcessor::notifyListenersSynchronously);
+            expectEquals (listener.numCalls, 3);
+            expectEquals (listener.lastValues [1], 0.998f);
+            expectEquals (listener.lastValues [2], 0.999f);
+
+            processor.removeListener (&listener);
+        }
+    }
+};
+
+static AudioProcessorParameterChangeTests audioProcessorParameterChangeTests;
+
+#endif
@@ -145,6 +145,53 @@ public:
     virtual void processBlockBypassed (AudioSampleBuffer& buffer,
                                        MidiBuffer& midiMessages);
 
+    /** Renders the next block using 64-bit samples.
+
+        This is called instead of the single-precision processBlock() when the host
+        has put the processor into double-precision mode with setProcessingPrecision().
+        The buffer layout and the rules about which channels to read and write are
+        exactly the same as for the 32-bit version.
+
+        The default implementation converts the buffer to floats, calls the 32-bit
+        processBlock(), and converts the output channels back again, so any processor
+        can be used in a 64-bit host or graph. If your processor can do its work in
+        double precision, override this method and make supportsDoublePrecisionProcessing()
+        return true.
+
+        @see supportsDoublePrecisionProcessing, setProcessingPrecision
+    */
+    virtual void processBlock (AudioBuffer<double>& buffer,
+                               MidiBuffer& midiMessages);
+
+    //==============================================================================
+    /** The types of sample that a processor's processBlock() may be called with. */
+    enum ProcessingPrecision
+    {
+        singlePrecision,    /**< The host will call processBlock() with an AudioSampleBuffer. */
+        doublePrecision     /**< The host will call processBlock() with an AudioBuffer<double>. */
+    };
+
+    /** Returns true if this processor overrides the double-precision processBlock().
+
+        If this returns false, a host can still run the processor in double-precision
+        mode, but the audio will be converted to floats around each call.
+    */
+    virtual bool supportsDoublePrecisionProcessing() const;
+
+    /** Tells the processor which version of processBlock() the host is going to call.
+
+        Hosts should call this before setPlayConfigDetails() and prepareToPlay(), so that
+        the processor can allocate any conversion buffers it needs before playback starts.
+        The default is singlePrecision.
+    */
+    void setProcessingPrecision (ProcessingPrecision newPrecision) noexcept;
+
+    /** Returns the precision that was set with setProcessingPrecision(). */
+    ProcessingPrecision getProcessingPrecision() const noexcept         { return processingPrecision; }
+
+    /** Returns true if the host is going to call the double-precision processBlock(). */
+    bool isUsingDoublePrecision() const noexcept                        { return processingPrecision == doublePrecision; }
+
     //==============================================================================
     /** Returns the current AudioPlayHead object that should be used to find
         out the state and position of the playhead.
@@ -250,7 +297,11 @@ public:
     */
     void setLatencySamples (int newLatency);
 
-    /** Returns true if a silent input always produces a silent output. */
+    /** Returns true if a silent input always produces a silent output.
+
+        Hosts such as the AudioProcessorGraph may use this, along with getTailLengthSeconds(),
+        to stop calling processBlock() while the input is silent.
+    */
     virtual bool silenceInProducesSilenceOut() const = 0;
 
     /** Returns the length of the filter's tail, in seconds. */
@@ -333,8 +384,11 @@ public:
 
     /** Called by the host to tell this processor whether it's being used in a non-realtime
         capacity for offline rendering or bouncing.
+
+        If you override this (e.g. to pass the mode on to some other processors), be sure
+        to call the base class method.
     */
-    void setNonRealtime (bool isNonRealtime) noexcept;
+    virtual void setNonRealtime (bool isNonRealtime) noexcept;
 
     //==============================================================================
     /** Creates the filter's UI.
@@ -436,6 +490,46 @@ public:
     */
     void setParameterNotifyingHost (int parameterIndex, float newValue);
 
+    /** Changes a parameter, and notifies the host and listeners asynchronously.
+
+        This works like setParameterNotifyingHost(), but instead of calling the listeners
+        straight away, it just flags the parameter as changed and lets the message thread
+        tell them about it later. If a parameter changes many times before that happens,
+        the listeners only get one callback for it, with its latest value.
+
+        It doesn't take any locks, so it's a better choice than setParameterNotifyingHost()
+        when a parameter is being changed from the audio thread, or very frequently.
+
+        @see setParameterNotificationMode
+    */
+    void setParameterNotifyingHostAsync (int parameterIndex, float newValue);
+
+    /** The ways in which the processor's listeners can be told about parameter changes.
+        @see setParameterNotificationMode
+    */
+    enum ParameterNotificationMode
+    {
+        notifyListenersSynchronously,   /**< Listeners are called straight away, on whatever thread changed the parameter. */
+        notifyListenersAsynchronously   /**< Changed parameters are flagged, and a timer on the message thread tells the listeners about them. */
+    };
+
+    /** Chooses how setParameterNotifyingHost() tells the listeners about a change.
+
+        By default, the listeners are called synchronously. In asynchronous mode, changing
+        a parameter just sets a bit for it without taking any locks, and a timer on the
+        message thread calls the listeners every dispatchIntervalMs milliseconds for the
+        parameters that have changed since last time, with their latest values. This is
+        much cheaper when a processor has a lot of parameters under heavy automation, at
+        the expense of the listeners hearing about changes a little later.
+
+        This must be called on the message thread.
+    */
+    void setParameterNotificationMode (ParameterNotificationMode newMode,
+                                       int dispatchIntervalMs = 30);
+
+    /** Returns the current mode set by setParameterNotificationMode(). */
+    ParameterNotificationMode getParameterNotificationMode() const noexcept     { return parameterNotificationMode; }
+
     /** Returns true if the host can automate this parameter.
 
         By default, this returns true for all parameters.
@@ -477,6 +571,61 @@ public:
     */
     void updateHostDisplay();
 
+    //==============================================================================
+    /** Describes a change to a parameter that happens part-way through a block.
+        @see queueParameterChange, getParameterChangeInBlock
+    */
+    struct ParameterChange
+    {
+        int parameterIndex;     /**< The index of the parameter that changes. */
+        float newValue;         /**< The parameter's new value, between 0 and 1.0. */
+        int samplePosition;     /**< The sample within the block at which the change happens. */
+    };
+
+    /** Queues a parameter change to take effect part-way through the next block.
+
+        This is intended for hosts and plugin wrappers that have timestamped automation
+        data. The change will be delivered to the processBlock() call that follows the
+        next call to prepareParameterChangesForBlock(), at the given sample position.
+
+        This doesn't take any locks, so can be called on the audio thread or any other
+        thread. It returns false if the queue is full, in which case the change is lost.
+    */
+    bool queueParameterChange (int parameterIndex, float newValue, int samplePosition) noexcept;
+
+    /** Hosts should call this just before each processBlock() call, to deliver any
+        changes that have been queued with queueParameterChange().
+
+        If the processor's handlesSampleAccurateParameterChanges() method returns true,
+        the changes are made available to processBlock() via getParameterChangeInBlock().
+        Otherwise, each one is applied with setParameter() straight away, so processors
+        that don't know about sample-accurate changes still get the new values.
+    */
+    void prepareParameterChangesForBlock (int numSamples);
+
+    /** Override this to return true if your processBlock() method reads the parameter
+        changes for each block with getParameterChangeInBlock() and applies them itself.
+
+        The default implementation returns false.
+    */
+    virtual bool handlesSampleAccurateParameterChanges() const;
+
+    /** Returns the number of parameter changes that happen during the current block.
+        This should only be called from inside your processBlock() method.
+        @see getParameterChangeInBlock
+    */
+    int getNumParameterChangesInBlock() const noexcept;
+
+    /** Returns one of the parameter changes that happen during the current block.
+
+        The changes are sorted by their sample position, and the positions are always
+        within the block. This should only be called from inside your processBlock() method,
+        and it's up to you to call setParameter() (or whatever you need to do) for each one.
+
+        @see getNumParameterChangesInBlock, handlesSampleAccurateParameterChanges
+    */
+    const ParameterChange& getParameterChangeInBlock (int index) const noexcept;
+
     //==============================================================================
     /** Returns the number of preset programs the filter supports.
 
@@ -628,6 +777,9 @@ private:
     double sampleRate;
     int blockSize, numInputChannels, numOutputChannels, latencySamples;
     bool suspended, nonRealtime;
+    ParameterNotificationMode parameterNotificationMode;
+    ProcessingPrecision processingPrecision;
+    AudioSampleBuffer floatConversionBuffer;
     CriticalSection callbackLock, listenerLock;
     String inputSpeakerArrangement, outputSpeakerArrangement;
 
@@ -635,7 +787,18 @@ private:
     BigInteger changingParams;
    #endif
 
+    class ParameterChangeQueue;
+    friend class ScopedPointer<ParameterChangeQueue>;
+    ScopedPointer<ParameterChangeQueue> parameterChangeQueue;
+
+    class ParameterChangeNotifier;
+    friend class ScopedPointer<ParameterChangeNotifier>;
+    ScopedPointer<ParameterChangeNotifier> parameterChangeNotifier;
+
     AudioProcessorListener* getListenerLocked (int) const noexcept;
+    void callParameterChangeListeners (int parameterIndex, float newValue);
+    void flushPendingNotificationsIfOnMessageThread();
+    void updateFloatConversionBuffer();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessor)
 };
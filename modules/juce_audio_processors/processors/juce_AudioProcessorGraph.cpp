@@ -29,6 +29,15 @@ const int AudioProcessorGraph::midiChannelIndex = 0x1000;
 namespace GraphRenderingOps
 {
 
+// The amount of space initially reserved in each of the shared midi buffers, so that
+// busy blocks don't have to grow them from inside the audio callback.
+const size_t initialMidiBufferSize = 4096;
+
+// The smallest delay line that's allocated for latency compensation. These are made bigger than
+// the latency they're first needed for, so that a plugin's latency can change without the
+// rendering sequence having to be rebuilt.
+const int minimumDelayCapacity = 8192;
+
 //==============================================================================
 class AudioGraphRenderingOp
 {
@@ -36,24 +45,89 @@ public:
     AudioGraphRenderingOp() {}
     virtual ~AudioGraphRenderingOp()  {}
 
-    virtual void perform (AudioSampleBuffer& sharedBufferChans,
+    /** Runs the op on a block.
+
+        The silentChannels array has a flag for each of the shared audio channels, which is
+        true when that channel is known to contain nothing but zeros. All the flags except
+        channel 0's are cleared at the start of each block, and the ops keep them up to date,
+        so that they can skip any work on channels that are silent.
+
+        The channel pointers are fetched from the shared buffer once per block, before the
+        ops are shared out between threads, because the buffer's own methods update its
+        hasBeenCleared() flag, which the ops mustn't do from more than one thread at once.
+    */
+    virtual void perform (float* const* sharedBufferChans,
                           const OwnedArray <MidiBuffer>& sharedMidiBuffers,
+                          bool* silentChannels,
                           const int numSamples) = 0;
 
+    /** Runs the op on a block of double-precision samples. */
+    virtual void perform (double* const* sharedBufferChans,
+                          const OwnedArray <MidiBuffer>& sharedMidiBuffers,
+                          bool* silentChannels,
+                          const int numSamples) = 0;
+
+    /** Adds the shared resources that this op reads and writes to the arrays,
+        so that the parallel scheduler can work out which ops can run concurrently.
+        @see getAudioChannelResource, getMidiBufferResource, getGraphIOResource
+    */
+    virtual void getResourcesUsed (Array<int>& reads, Array<int>& writes) const = 0;
+
+    static int getGraphIOResource() noexcept                    { return 0; }
+    static int getAudioChannelResource (int channel) noexcept   { return 1 + channel * 2; }
+    static int getMidiBufferResource (int buffer) noexcept      { return 2 + buffer * 2; }
+
     JUCE_LEAK_DETECTOR (AudioGraphRenderingOp)
 };
 
 //==============================================================================
-class ClearChannelOp : public AudioGraphRenderingOp
+/** Implements both versions of perform() by calling the op's render() method,
+    which is a template that works with either type of sample.
+*/
+template <class OpType, class BaseClass = AudioGraphRenderingOp>
+class AudioGraphRenderingOpBase  : public BaseClass
+{
+public:
+    AudioGraphRenderingOpBase() {}
+
+    template <typename ArgType>
+    explicit AudioGraphRenderingOpBase (const ArgType baseClassArg)  : BaseClass (baseClassArg) {}
+
+    void perform (float* const* sharedBufferChans, const OwnedArray <MidiBuffer>& sharedMidiBuffers,
+                  bool* const silentChannels, const int numSamples)
+    {
+        static_cast <OpType*> (this)->render (sharedBufferChans, sharedMidiBuffers, silentChannels, numSamples);
+    }
+
+    void perform (double* const* sharedBufferChans, const OwnedArray <MidiBuffer>& sharedMidiBuffers,
+                  bool* const silentChannels, const int numSamples)
+    {
+        static_cast <OpType*> (this)->render (sharedBufferChans, sharedMidiBuffers, silentChannels, numSamples);
+    }
+};
+
+//==============================================================================
+class ClearChannelOp : public AudioGraphRenderingOpBase<ClearChannelOp>
 {
 public:
     ClearChannelOp (const int channelNum_)
         : channelNum (channelNum_)
     {}
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    template <typename SampleType>
+    void render (SampleType* const* sharedBufferChans, const OwnedArray <MidiBuffer>&,
+                 bool* const silentChannels, const int numSamples)
+    {
+        if (! silentChannels [channelNum])
+        {
+            FloatVectorOperations::clear (sharedBufferChans [channelNum], numSamples);
+            silentChannels [channelNum] = true;
+        }
+    }
+
+    void getResourcesUsed (Array<int>&, Array<int>& writes) const
     {
-        sharedBufferChans.clear (channelNum, 0, numSamples);
+        writes.add (getAudioChannelResource (channelNum));
     }
 
 private:
@@ -63,7 +137,7 @@ private:
 };
 
 //==============================================================================
-class CopyChannelOp : public AudioGraphRenderingOp
+class CopyChannelOp : public AudioGraphRenderingOpBase<CopyChannelOp>
 {
 public:
     CopyChannelOp (const int srcChannelNum_, const int dstChannelNum_)
@@ -71,9 +145,29 @@ public:
           dstChannelNum (dstChannelNum_)
     {}
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    template <typename SampleType>
+    void render (SampleType* const* sharedBufferChans, const OwnedArray <MidiBuffer>&,
+                 bool* const silentChannels, const int numSamples)
+    {
+        if (silentChannels [srcChannelNum])
+        {
+            if (! silentChannels [dstChannelNum])
+            {
+                FloatVectorOperations::clear (sharedBufferChans [dstChannelNum], numSamples);
+                silentChannels [dstChannelNum] = true;
+            }
+        }
+        else
+        {
+            FloatVectorOperations::copy (sharedBufferChans [dstChannelNum], sharedBufferChans [srcChannelNum], numSamples);
+            silentChannels [dstChannelNum] = false;
+        }
+    }
+
+    void getResourcesUsed (Array<int>& reads, Array<int>& writes) const
     {
-        sharedBufferChans.copyFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
+        reads.add (getAudioChannelResource (srcChannelNum));
+        writes.add (getAudioChannelResource (dstChannelNum));
     }
 
 private:
@@ -83,7 +177,7 @@ private:
 };
 
 //==============================================================================
-class AddChannelOp : public AudioGraphRenderingOp
+class AddChannelOp : public AudioGraphRenderingOpBase<AddChannelOp>
 {
 public:
     AddChannelOp (const int srcChannelNum_, const int dstChannelNum_)
@@ -91,9 +185,26 @@ public:
           dstChannelNum (dstChannelNum_)
     {}
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    template <typename SampleType>
+    void render (SampleType* const* sharedBufferChans, const OwnedArray <MidiBuffer>&,
+                 bool* const silentChannels, const int numSamples)
+    {
+        if (silentChannels [srcChannelNum])
+            return;
+
+        // (adding to silence is just a copy)
+        if (silentChannels [dstChannelNum])
+            FloatVectorOperations::copy (sharedBufferChans [dstChannelNum], sharedBufferChans [srcChannelNum], numSamples);
+        else
+            FloatVectorOperations::add (sharedBufferChans [dstChannelNum], sharedBufferChans [srcChannelNum], numSamples);
+
+        silentChannels [dstChannelNum] = false;
+    }
+
+    void getResourcesUsed (Array<int>& reads, Array<int>& writes) const
     {
-        sharedBufferChans.addFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
+        reads.add (getAudioChannelResource (srcChannelNum));
+        writes.add (getAudioChannelResource (dstChannelNum));
     }
 
 private:
@@ -103,18 +214,24 @@ private:
 };
 
 //==============================================================================
-class ClearMidiBufferOp : public AudioGraphRenderingOp
+class ClearMidiBufferOp : public AudioGraphRenderingOpBase<ClearMidiBufferOp>
 {
 public:
     ClearMidiBufferOp (const int bufferNum_)
         : bufferNum (bufferNum_)
     {}
 
-    void perform (AudioSampleBuffer&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int)
+    template <typename SampleType>
+    void render (SampleType* const*, const OwnedArray <MidiBuffer>& sharedMidiBuffers, bool*, const int)
     {
         sharedMidiBuffers.getUnchecked (bufferNum)->clear();
     }
 
+    void getResourcesUsed (Array<int>&, Array<int>& writes) const
+    {
+        writes.add (getMidiBufferResource (bufferNum));
+    }
+
 private:
     const int bufferNum;
 
@@ -122,7 +239,7 @@ private:
 };
 
 //==============================================================================
-class CopyMidiBufferOp : public AudioGraphRenderingOp
+class CopyMidiBufferOp : public AudioGraphRenderingOpBase<CopyMidiBufferOp>
 {
 public:
     CopyMidiBufferOp (const int srcBufferNum_, const int dstBufferNum_)
@@ -130,11 +247,20 @@ public:
           dstBufferNum (dstBufferNum_)
     {}
 
-    void perform (AudioSampleBuffer&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int)
+    template <typename SampleType>
+    void render (SampleType* const*, const OwnedArray <MidiBuffer>& sharedMidiBuffers, bool*, const int)
     {
+        // (this copies into the destination's existing storage, so won't reallocate
+        // unless the source has more events than the destination has ever held)
         *sharedMidiBuffers.getUnchecked (dstBufferNum) = *sharedMidiBuffers.getUnchecked (srcBufferNum);
     }
 
+    void getResourcesUsed (Array<int>& reads, Array<int>& writes) const
+    {
+        reads.add (getMidiBufferResource (srcBufferNum));
+        writes.add (getMidiBufferResource (dstBufferNum));
+    }
+
 private:
     const int srcBufferNum, dstBufferNum;
 
@@ -142,7 +268,7 @@ private:
 };
 
 //==============================================================================
-class AddMidiBufferOp : public AudioGraphRenderingOp
+class AddMidiBufferOp : public AudioGraphRenderingOpBase<AddMidiBufferOp>
 {
 public:
     AddMidiBufferOp (const int srcBufferNum_, const int dstBufferNum_)
@@ -150,12 +276,19 @@ public:
           dstBufferNum (dstBufferNum_)
     {}
 
-    void perform (AudioSampleBuffer&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
+    template <typename SampleType>
+    void render (SampleType* const*, const OwnedArray <MidiBuffer>& sharedMidiBuffers, bool*, const int numSamples)
     {
         sharedMidiBuffers.getUnchecked (dstBufferNum)
             ->addEvents (*sharedMidiBuffers.getUnchecked (srcBufferNum), 0, numSamples, 0);
     }
 
+    void getResourcesUsed (Array<int>& reads, Array<int>& writes) const
+    {
+        reads.add (getMidiBufferResource (srcBufferNum));
+        writes.add (getMidiBufferResource (dstBufferNum));
+    }
+
 private:
     const int srcBufferNum, dstBufferNum;
 
@@ -163,78 +296,314 @@ private:
 };
 
 //==============================================================================
-class DelayChannelOp : public AudioGraphRenderingOp
+/** Base class for the ops that compensate for latency, whose delay can be changed
+    between blocks without rebuilding the rendering sequence.
+*/
+class AdjustableDelayOp : public AudioGraphRenderingOp
+{
+public:
+    AdjustableDelayOp (const int maxDelay_)
+        : maxDelay (maxDelay_), delay (0)
+    {}
+
+    int getMaxDelay() const noexcept        { return maxDelay; }
+
+    void setDelay (int newDelay)
+    {
+        newDelay = jlimit (0, maxDelay, newDelay);
+
+        if (delay != newDelay)
+        {
+            delay = newDelay;
+            delayChanged();
+        }
+    }
+
+protected:
+    const int maxDelay;
+    int delay;
+
+    virtual void delayChanged() = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (AdjustableDelayOp)
+};
+
+//==============================================================================
+class DelayChannelOp : public AudioGraphRenderingOpBase<DelayChannelOp, AdjustableDelayOp>
 {
 public:
-    DelayChannelOp (const int channel_, const int numSamplesDelay_)
-        : channel (channel_),
-          bufferSize (numSamplesDelay_ + 1),
-          readIndex (0), writeIndex (numSamplesDelay_)
+    DelayChannelOp (const int channel_, const int maxDelay_)
+        : AudioGraphRenderingOpBase<DelayChannelOp, AdjustableDelayOp> (maxDelay_),
+          channel (channel_),
+          bufferSize (maxDelay_ + 1),
+          readIndex (0), writeIndex (0),
+          numSilentSamplesInLine (maxDelay_ + 1)
     {
         buffer.calloc ((size_t) bufferSize);
     }
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    template <typename SampleType>
+    void render (SampleType* const* sharedBufferChans, const OwnedArray <MidiBuffer>&,
+                 bool* const silentChannels, const int numSamples)
     {
-        float* data = sharedBufferChans.getSampleData (channel, 0);
+        if (delay <= 0)
+            return;
+
+        // if the line's full of silence and more silence is coming in, there's nothing to do..
+        if (silentChannels [channel])
+        {
+            if (numSilentSamplesInLine >= bufferSize)
+                return;
+
+            numSilentSamplesInLine += numSamples;
+        }
+        else
+        {
+            numSilentSamplesInLine = 0;
+        }
+
+        silentChannels [channel] = false;
+
+        SampleType* data = sharedBufferChans [channel];
 
         for (int i = numSamples; --i >= 0;)
         {
             buffer [writeIndex] = *data;
-            *data++ = buffer [readIndex];
+            *data++ = (SampleType) buffer [readIndex];
 
             if (++readIndex  >= bufferSize) readIndex = 0;
             if (++writeIndex >= bufferSize) writeIndex = 0;
         }
     }
 
+    void getResourcesUsed (Array<int>&, Array<int>& writes) const
+    {
+        writes.add (getAudioChannelResource (channel));
+    }
+
 private:
-    HeapBlock<float> buffer;
+    HeapBlock<double> buffer;   // (double, so that it can be used to delay either type of sample)
     const int channel, bufferSize;
-    int readIndex, writeIndex;
+    int readIndex, writeIndex, numSilentSamplesInLine;
+
+    void delayChanged()
+    {
+        // (whatever was in the line belongs to the old delay, so it's safer to start again from silence)
+        buffer.clear ((size_t) bufferSize);
+        numSilentSamplesInLine = bufferSize;
+        readIndex = (writeIndex + bufferSize - delay) % bufferSize;
+    }
 
     JUCE_DECLARE_NON_COPYABLE (DelayChannelOp)
 };
 
+//==============================================================================
+class DelayMidiBufferOp : public AudioGraphRenderingOpBase<DelayMidiBufferOp, AdjustableDelayOp>
+{
+public:
+    DelayMidiBufferOp (const int bufferNum_, const int maxDelay_)
+        : AudioGraphRenderingOpBase<DelayMidiBufferOp, AdjustableDelayOp> (maxDelay_),
+          bufferNum (bufferNum_)
+    {
+        pendingEvents.ensureSize (initialMidiBufferSize);
+        scratchBuffer.ensureSize (initialMidiBufferSize);
+    }
+
+    template <typename SampleType>
+    void render (SampleType* const*, const OwnedArray <MidiBuffer>& sharedMidiBuffers, bool*, const int numSamples)
+    {
+        if (delay <= 0 && pendingEvents.isEmpty())
+            return;
+
+        MidiBuffer& buffer = *sharedMidiBuffers.getUnchecked (bufferNum);
+
+        // The pending events are timed relative to the start of the current block, so the
+        // ones that are due go out now, and the rest are moved along ready for the next block.
+        pendingEvents.addEvents (buffer, 0, -1, delay);
+
+        buffer.clear();
+        buffer.addEvents (pendingEvents, 0, numSamples, 0);
+
+        scratchBuffer.clear();
+        scratchBuffer.addEvents (pendingEvents, numSamples, -1, -numSamples);
+        pendingEvents.swapWith (scratchBuffer);
+    }
+
+    void getResourcesUsed (Array<int>&, Array<int>& writes) const
+    {
+        writes.add (getMidiBufferResource (bufferNum));
+    }
+
+private:
+    const int bufferNum;
+    MidiBuffer pendingEvents, scratchBuffer;
+
+    void delayChanged() {}  // (events that are already waiting keep their original timing)
+
+    JUCE_DECLARE_NON_COPYABLE (DelayMidiBufferOp)
+};
 
 //==============================================================================
-class ProcessBufferOp : public AudioGraphRenderingOp
+class ProcessBufferOp : public AudioGraphRenderingOpBase<ProcessBufferOp>
 {
 public:
-    ProcessBufferOp (const AudioProcessorGraph::Node::Ptr& node_,
+    ProcessBufferOp (const AudioProcessorGraph& graph_,
+                     const AudioProcessorGraph::Node::Ptr& node_,
                      const Array <int>& audioChannelsToUse_,
                      const int totalChans_,
                      const int midiBufferToUse_)
         : node (node_),
           processor (node_->getProcessor()),
+          graph (graph_),
           audioChannelsToUse (audioChannelsToUse_),
           totalChans (jmax (1, totalChans_)),
-          midiBufferToUse (midiBufferToUse_)
+          midiBufferToUse (midiBufferToUse_),
+          numSilentSamplesIn (0),
+          isAudioInputNode (false)
     {
-        channels.calloc ((size_t) totalChans);
+        typedef AudioProcessorGraph::AudioGraphIOProcessor IOProc;
+
+        if (IOProc* const ioProc = dynamic_cast <IOProc*> (processor))
+            isAudioInputNode = ioProc->getType() == IOProc::audioInputNode;
+
+        floatChannels.calloc ((size_t) totalChans);
+        doubleChannels.calloc ((size_t) totalChans);
 
         while (audioChannelsToUse.size() < totalChans)
             audioChannelsToUse.add (0);
     }
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
+    template <typename SampleType>
+    void render (SampleType* const* sharedBufferChans, const OwnedArray <MidiBuffer>& sharedMidiBuffers,
+                 bool* const silentChannels, const int numSamples)
     {
+        MidiBuffer& midiBuffer = *sharedMidiBuffers.getUnchecked (midiBufferToUse);
+
+        processor->prepareParameterChangesForBlock (numSamples);
+
+        if (isInputSilent (silentChannels, midiBuffer))
+        {
+            // once the processor's tail has finished, its output will be silent too, so
+            // there's no need to call it until some non-silent input arrives..
+            if (numSilentSamplesIn >= getTailLengthSamples())
+            {
+                clearOutputs (sharedBufferChans, silentChannels, numSamples);
+                return;
+            }
+
+            numSilentSamplesIn += numSamples;
+        }
+        else
+        {
+            numSilentSamplesIn = 0;
+        }
+
+        SampleType** const channels = getChannelList (sharedBufferChans);
+
         for (int i = totalChans; --i >= 0;)
-            channels[i] = sharedBufferChans.getSampleData (audioChannelsToUse.getUnchecked (i), 0);
+        {
+            const int chan = audioChannelsToUse.getUnchecked (i);
+            channels[i] = sharedBufferChans [chan];
+
+            if (chan != 0)
+                silentChannels [chan] = false;
+        }
+
+        AudioBuffer<SampleType> buffer (channels, totalChans, numSamples);
+
+        if (graph.isNodeProfilingEnabled())
+        {
+            const int64 startTicks = Time::getHighResolutionTicks();
+            processor->processBlock (buffer, midiBuffer);
+            const int64 endTicks = Time::getHighResolutionTicks();
+
+            node->getTimingStats().addCall (1.0e6 * Time::highResolutionTicksToSeconds (endTicks - startTicks));
+        }
+        else
+        {
+            processor->processBlock (buffer, midiBuffer);
+        }
+
+        // the graph's input is often silent (e.g. when rendering offline), and if so, it's
+        // worth spotting that so that everything downstream can be skipped
+        if (isAudioInputNode)
+            for (int i = jmin (totalChans, processor->getNumOutputChannels()); --i >= 0;)
+                if (audioChannelsToUse.getUnchecked (i) != 0 && buffer.getMagnitude (i, 0, numSamples) == 0)
+                    silentChannels [audioChannelsToUse.getUnchecked (i)] = true;
+    }
+
+    void getResourcesUsed (Array<int>& reads, Array<int>& writes) const
+    {
+        for (int i = 0; i < totalChans; ++i)
+        {
+            const int chan = audioChannelsToUse.getUnchecked (i);
+
+            // channel 0 is the shared, read-only empty buffer
+            if (chan == 0)
+                reads.add (getAudioChannelResource (chan));
+            else
+                writes.add (getAudioChannelResource (chan));
+        }
 
-        AudioSampleBuffer buffer (channels, totalChans, numSamples);
+        writes.add (getMidiBufferResource (midiBufferToUse));
 
-        processor->processBlock (buffer, *sharedMidiBuffers.getUnchecked (midiBufferToUse));
+        // the graph's I/O nodes all share the graph's own input and output buffers
+        if (dynamic_cast <AudioProcessorGraph::AudioGraphIOProcessor*> (processor) != nullptr)
+            writes.add (getGraphIOResource());
     }
 
     const AudioProcessorGraph::Node::Ptr node;
     AudioProcessor* const processor;
 
 private:
+    const AudioProcessorGraph& graph;
     Array <int> audioChannelsToUse;
-    HeapBlock <float*> channels;
+    HeapBlock <float*> floatChannels;
+    HeapBlock <double*> doubleChannels;
     int totalChans;
     int midiBufferToUse;
+    int64 numSilentSamplesIn;
+    bool isAudioInputNode;
+
+    bool isInputSilent (const bool* const silentChannels, const MidiBuffer& midiBuffer) const
+    {
+        if (! processor->silenceInProducesSilenceOut())
+            return false;
+
+        if (processor->acceptsMidi() && ! midiBuffer.isEmpty())
+            return false;
+
+        for (int i = jmin (totalChans, processor->getNumInputChannels()); --i >= 0;)
+            if (! silentChannels [audioChannelsToUse.getUnchecked (i)])
+                return false;
+
+        return true;
+    }
+
+    // The number of samples of silent input after which the output must also be silent
+    int64 getTailLengthSamples() const
+    {
+        return (int64) (processor->getTailLengthSeconds() * processor->getSampleRate())
+                 + processor->getLatencySamples();
+    }
+
+    float** getChannelList (float* const*) const noexcept       { return floatChannels; }
+    double** getChannelList (double* const*) const noexcept     { return doubleChannels; }
+
+    template <typename SampleType>
+    void clearOutputs (SampleType* const* sharedBufferChans, bool* const silentChannels, const int numSamples)
+    {
+        for (int i = jmin (totalChans, processor->getNumOutputChannels()); --i >= 0;)
+        {
+            const int chan = audioChannelsToUse.getUnchecked (i);
+
+            if (! silentChannels [chan])
+            {
+                FloatVectorOperations::clear (sharedBufferChans [chan], numSamples);
+                silentChannels [chan] = true;
+            }
+        }
+    }
 
     JUCE_DECLARE_NON_COPYABLE (ProcessBufferOp)
 };
@@ -249,22 +618,35 @@ public:
     //==============================================================================
     RenderingOpSequenceCalculator (AudioProcessorGraph& graph_,
                                    const Array<void*>& orderedNodes_,
-                                   Array<void*>& renderingOps)
+                                   Array<void*>& renderingOps_,
+                                   const bool canReuseBuffers_ = true)
         : graph (graph_),
           orderedNodes (orderedNodes_),
-          totalLatency (0)
+          renderingOps (renderingOps_),
+          totalLatency (0),
+          delayCapacity (minimumDelayCapacity),
+          canReuseBuffers (canReuseBuffers_)
     {
         nodeIds.add ((uint32) zeroNodeID); // first buffer is read-only zeros
         channels.add (0);
 
         midiNodeIds.add ((uint32) zeroNodeID);
 
+        buildConnectionTables();
+        calculateLatencies();
+
         for (int i = 0; i < orderedNodes.size(); ++i)
         {
             createRenderingOpsForNode ((AudioProcessorGraph::Node*) orderedNodes.getUnchecked(i),
-                                       renderingOps, i);
+                                       renderingOps_, i);
 
-            markAnyUnusedBuffersAsFree (i);
+            // When rendering on multiple threads, recycling a buffer would make the node
+            // that uses it next wait for all the previous users to finish with it..
+            if (canReuseBuffers)
+            {
+                mixOutputsIntoLaterInputs (i, renderingOps_);
+                markAnyUnusedBuffersAsFree (i);
+            }
         }
 
         graph.setLatencySamples (totalLatency);
@@ -273,51 +655,209 @@ public:
     int getNumBuffersNeeded() const         { return nodeIds.size(); }
     int getNumMidiBuffersNeeded() const     { return midiNodeIds.size(); }
 
+    AudioProcessorGraph::RenderingSequenceStats getStats() const
+    {
+        AudioProcessorGraph::RenderingSequenceStats stats = { nodeIds.size() - 1, midiNodeIds.size() - 1, 0, 0, 0, 0 };
+
+        for (int i = 0; i < renderingOps.size(); ++i)
+        {
+            const AudioGraphRenderingOp* const op = static_cast<const AudioGraphRenderingOp*> (renderingOps.getUnchecked (i));
+
+            if (dynamic_cast <const CopyChannelOp*> (op) != nullptr || dynamic_cast <const CopyMidiBufferOp*> (op) != nullptr)
+                ++stats.numCopies;
+            else if (dynamic_cast <const AddChannelOp*> (op) != nullptr || dynamic_cast <const AddMidiBufferOp*> (op) != nullptr)
+                ++stats.numMixes;
+            else if (dynamic_cast <const ClearChannelOp*> (op) != nullptr || dynamic_cast <const ClearMidiBufferOp*> (op) != nullptr)
+                ++stats.numClears;
+            else if (dynamic_cast <const AdjustableDelayOp*> (op) != nullptr)
+                ++stats.numDelays;
+        }
+
+        return stats;
+    }
+
+    //==============================================================================
+    // These describe the latency of each path through the graph, so that the delays can be
+    // recalculated later if any of the processors change their latency.
+    struct CompensationDelay
+    {
+        int stepIndex, sourceStepIndex;
+        AdjustableDelayOp* op;
+    };
+
+    int getNumSteps() const noexcept                                { return orderedNodes.size(); }
+    const Array<int>& getSourceSteps (const int step) const         { return *sourceSteps.getUnchecked (step); }
+    const Array<CompensationDelay>& getCompensationDelays() const   { return compensationDelays; }
+    int getTotalLatency() const noexcept                            { return totalLatency; }
+
+    AudioProcessor* getProcessorForStep (const int step) const
+    {
+        return ((const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (step))->getProcessor();
+    }
+
 private:
     //==============================================================================
     AudioProcessorGraph& graph;
     const Array<void*>& orderedNodes;
+    const Array<void*>& renderingOps;
     Array <int> channels;
     Array <uint32> nodeIds, midiNodeIds;
 
-    enum { freeNodeID = 0xffffffff, zeroNodeID = 0xfffffffe };
+    // The buffers that aren't in use, most recently freed last. Handing out the one that was freed
+    // last means that the next node usually works on memory that's still in the cache.
+    Array <int> freeBuffers, freeMidiBuffers;
 
-    static bool isNodeBusy (uint32 nodeID) noexcept { return nodeID != freeNodeID && nodeID != zeroNodeID; }
+    enum { freeNodeID = 0xffffffff, zeroNodeID = 0xfffffffe, mixNodeID = 0xfffffffd };
 
-    Array <uint32> nodeDelayIDs;
-    Array <int> nodeDelays;
-    int totalLatency;
+    static bool isNodeBusy (uint32 nodeID) noexcept { return nodeID != freeNodeID && nodeID != zeroNodeID; }
 
-    int getNodeDelay (const uint32 nodeID) const          { return nodeDelays [nodeDelayIDs.indexOf (nodeID)]; }
+    Array<int> inputLatencies, outputLatencies;
+    OwnedArray <Array<int> > sourceSteps;
+    Array<CompensationDelay> compensationDelays;
+    int totalLatency, delayCapacity;
+    const bool canReuseBuffers;
 
-    void setNodeDelay (const uint32 nodeID, const int latency)
+    // Works out the latency at the input and output of each node. A source that comes later in
+    // the sequence (i.e. a feedback loop) doesn't count, because its data comes from the previous block.
+    void calculateLatencies()
     {
-        const int index = nodeDelayIDs.indexOf (nodeID);
+        int maxPathLatency = 0;
 
-        if (index >= 0)
+        for (int step = 0; step < orderedNodes.size(); ++step)
         {
-            nodeDelays.set (index, latency);
+            const Array<const AudioProcessorGraph::Connection*>& inputs = *nodeInputs.getUnchecked (step);
+            Array<int>* const sources = new Array<int>();
+            sourceSteps.add (sources);
+
+            int maxLatency = 0;
+
+            for (int i = 0; i < inputs.size(); ++i)
+            {
+                const int sourceStep = stepIndexes [(int) inputs.getUnchecked(i)->sourceNodeId];
+
+                if (! sources->contains (sourceStep))
+                {
+                    sources->add (sourceStep);
+
+                    if (sourceStep < step)
+                        maxLatency = jmax (maxLatency, outputLatencies.getUnchecked (sourceStep));
+                }
+            }
+
+            AudioProcessor* const processor = getProcessorForStep (step);
+
+            inputLatencies.add (maxLatency);
+            outputLatencies.add (maxLatency + processor->getLatencySamples());
+            maxPathLatency = jmax (maxPathLatency, outputLatencies.getLast());
+
+            if (processor->getNumOutputChannels() == 0)
+                totalLatency = jmax (totalLatency, maxLatency);
         }
-        else
+
+        delayCapacity = jmax (minimumDelayCapacity, maxPathLatency * 2);
+    }
+
+    // A node whose inputs all come from the same place never needs any compensation, but
+    // if there's more than one source, each input gets a delay, even if it's zero for now.
+    bool needsCompensation (const int stepIndex) const
+    {
+        return sourceSteps.getUnchecked (stepIndex)->size() > 1;
+    }
+
+    void addCompensationDelay (Array<void*>& renderingOps, const int bufferIndex, const bool isMidi,
+                               const int stepIndex, const uint32 sourceNodeId)
+    {
+        const int sourceStep = stepIndexes [(int) sourceNodeId];
+
+        AdjustableDelayOp* const op = isMidi ? (AdjustableDelayOp*) new DelayMidiBufferOp (bufferIndex, delayCapacity)
+                                             : (AdjustableDelayOp*) new DelayChannelOp (bufferIndex, delayCapacity);
+
+        op->setDelay (inputLatencies.getUnchecked (stepIndex)
+                        - (sourceStep < stepIndex ? outputLatencies.getUnchecked (sourceStep) : 0));
+
+        renderingOps.add (static_cast<AudioGraphRenderingOp*> (op));
+
+        const CompensationDelay d = { stepIndex, sourceStep, op };
+        compensationDelays.add (d);
+    }
+
+    //==============================================================================
+    // These tables are built once before the ops are created, so that finding the inputs to a
+    // node, or checking whether a node's output is still used later on, doesn't involve searching
+    // all the graph's connections.
+    struct Usage
+    {
+        int stepIndex, destChannel;
+    };
+
+    struct SourceChannelHash
+    {
+        static int generateHash (const int64 key, const int upperLimit) noexcept
         {
-            nodeDelayIDs.add (nodeID);
-            nodeDelays.add (latency);
+            return (int) (((uint32) key ^ (uint32) (key >> 32) * 0x9e3779b1) % (uint32) upperLimit);
         }
+    };
+
+    static int64 getSourceKey (const uint32 nodeId, const int channel) noexcept
+    {
+        return (int64) (((uint64) nodeId << 32) | (uint32) channel);
     }
 
-    int getInputLatencyForNode (const uint32 nodeID) const
+    HashMap <int, int> stepIndexes;
+    OwnedArray <Array<const AudioProcessorGraph::Connection*> > nodeInputs;
+    HashMap <int64, int, SourceChannelHash> sourceUsageIndexes;
+    OwnedArray <Array<Usage> > sourceUsages;
+
+    // The buffers into which the sources of a mixed input channel are being summed, indexed
+    // by the step and channel number of the input that they're for
+    HashMap <int64, int, SourceChannelHash> mixBuffers;
+
+    void buildConnectionTables()
     {
-        int maxLatency = 0;
+        for (int i = 0; i < orderedNodes.size(); ++i)
+        {
+            stepIndexes.set ((int) ((const AudioProcessorGraph::Node*) orderedNodes.getUnchecked(i))->nodeId, i);
+            nodeInputs.add (new Array<const AudioProcessorGraph::Connection*>());
+        }
 
+        // (iterating backwards so that each node's inputs end up in the same order as
+        // they would be found by scanning the connection list from the end)
         for (int i = graph.getNumConnections(); --i >= 0;)
         {
             const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
 
-            if (c->destNodeId == nodeID)
-                maxLatency = jmax (maxLatency, getNodeDelay (c->sourceNodeId));
+            if (stepIndexes.contains ((int) c->destNodeId))
+                nodeInputs.getUnchecked (stepIndexes [(int) c->destNodeId])->add (c);
         }
 
-        return maxLatency;
+        for (int step = 0; step < orderedNodes.size(); ++step)
+        {
+            const AudioProcessorGraph::Node* const node = (const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (step);
+            const int numIns = node->getProcessor()->getNumInputChannels();
+            const Array<const AudioProcessorGraph::Connection*>& inputs = *nodeInputs.getUnchecked (step);
+
+            for (int i = 0; i < inputs.size(); ++i)
+            {
+                const AudioProcessorGraph::Connection* const c = inputs.getUnchecked(i);
+
+                if (c->destChannelIndex == AudioProcessorGraph::midiChannelIndex
+                      ? c->sourceChannelIndex == AudioProcessorGraph::midiChannelIndex
+                      : (c->sourceChannelIndex != AudioProcessorGraph::midiChannelIndex
+                           && isPositiveAndBelow (c->destChannelIndex, numIns)))
+                {
+                    const int64 key = getSourceKey (c->sourceNodeId, c->sourceChannelIndex);
+
+                    if (! sourceUsageIndexes.contains (key))
+                    {
+                        sourceUsageIndexes.set (key, sourceUsages.size());
+                        sourceUsages.add (new Array<Usage>());
+                    }
+
+                    const Usage u = { step, c->destChannelIndex };
+                    sourceUsages.getUnchecked (sourceUsageIndexes [key])->add (u);
+                }
+            }
+        }
     }
 
     //==============================================================================
@@ -332,7 +872,9 @@ private:
         Array <int> audioChannelsToUse;
         int midiBufferToUse = -1;
 
-        int maxLatency = getInputLatencyForNode (node->nodeId);
+        const Array<const AudioProcessorGraph::Connection*>& inputs = *nodeInputs.getUnchecked (ourRenderingIndex);
+
+        const bool compensating = needsCompensation (ourRenderingIndex);
 
         for (int inputChan = 0; inputChan < numIns; ++inputChan)
         {
@@ -340,11 +882,11 @@ private:
             Array <uint32> sourceNodes;
             Array<int> sourceOutputChans;
 
-            for (int i = graph.getNumConnections(); --i >= 0;)
+            for (int i = 0; i < inputs.size(); ++i)
             {
-                const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+                const AudioProcessorGraph::Connection* const c = inputs.getUnchecked (i);
 
-                if (c->destNodeId == node->nodeId && c->destChannelIndex == inputChan)
+                if (c->destChannelIndex == inputChan)
                 {
                     sourceNodes.add (c->sourceNodeId);
                     sourceOutputChans.add (c->sourceChannelIndex);
@@ -352,6 +894,7 @@ private:
             }
 
             int bufIndex = -1;
+            bool usesNewBuffer = false;
 
             if (sourceNodes.size() == 0)
             {
@@ -383,7 +926,7 @@ private:
                     jassert (bufIndex >= 0);
                 }
 
-                if (inputChan < numOuts
+                if ((inputChan < numOuts || compensating)
                      && isBufferNeededLater (ourRenderingIndex,
                                              inputChan,
                                              srcNode, srcChan))
@@ -395,12 +938,17 @@ private:
                     renderingOps.add (new CopyChannelOp (bufIndex, newFreeBuffer));
 
                     bufIndex = newFreeBuffer;
+                    usesNewBuffer = true;
                 }
 
-                const int nodeDelay = getNodeDelay (srcNode);
-
-                if (nodeDelay < maxLatency)
-                    renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay));
+                if (compensating && bufIndex != getReadOnlyEmptyBuffer())
+                    addCompensationDelay (renderingOps, bufIndex, false, ourRenderingIndex, srcNode);
+            }
+            else if (mixBuffers.contains (getSourceKey ((uint32) ourRenderingIndex, inputChan)))
+            {
+                // all the inputs have already been mixed together as they were rendered..
+                bufIndex = mixBuffers [getSourceKey ((uint32) ourRenderingIndex, inputChan)];
+                usesNewBuffer = true;
             }
             else
             {
@@ -424,9 +972,8 @@ private:
                         reusableInputIndex = i;
                         bufIndex = sourceBufIndex;
 
-                        const int nodeDelay = getNodeDelay (sourceNodes.getUnchecked (i));
-                        if (nodeDelay < maxLatency)
-                            renderingOps.add (new DelayChannelOp (sourceBufIndex, maxLatency - nodeDelay));
+                        if (compensating)
+                            addCompensationDelay (renderingOps, bufIndex, false, ourRenderingIndex, sourceNodes.getUnchecked (i));
 
                         break;
                     }
@@ -438,6 +985,9 @@ private:
                     bufIndex = getFreeBuffer (false);
                     jassert (bufIndex != 0);
 
+                    // (mark it straight away, so that it can't be picked as a temporary buffer below)
+                    markBufferAsContaining (bufIndex, node->nodeId, inputChan);
+
                     const int srcIndex = getBufferContaining (sourceNodes.getUnchecked (0),
                                                               sourceOutputChans.getUnchecked (0));
                     if (srcIndex < 0)
@@ -448,13 +998,12 @@ private:
                     else
                     {
                         renderingOps.add (new CopyChannelOp (srcIndex, bufIndex));
+
+                        if (compensating)
+                            addCompensationDelay (renderingOps, bufIndex, false, ourRenderingIndex, sourceNodes.getFirst());
                     }
 
                     reusableInputIndex = 0;
-                    const int nodeDelay = getNodeDelay (sourceNodes.getFirst());
-
-                    if (nodeDelay < maxLatency)
-                        renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay));
                 }
 
                 for (int j = 0; j < sourceNodes.size(); ++j)
@@ -465,23 +1014,19 @@ private:
                                                             sourceOutputChans.getUnchecked(j));
                         if (srcIndex >= 0)
                         {
-                            const int nodeDelay = getNodeDelay (sourceNodes.getUnchecked (j));
-
-                            if (nodeDelay < maxLatency)
+                            if (compensating)
                             {
-                                if (! isBufferNeededLater (ourRenderingIndex, inputChan,
-                                                           sourceNodes.getUnchecked(j),
-                                                           sourceOutputChans.getUnchecked(j)))
-                                {
-                                    renderingOps.add (new DelayChannelOp (srcIndex, maxLatency - nodeDelay));
-                                }
-                                else // buffer is reused elsewhere, can't be delayed
+                                if (isBufferNeededLater (ourRenderingIndex, inputChan,
+                                                         sourceNodes.getUnchecked(j),
+                                                         sourceOutputChans.getUnchecked(j)))
                                 {
+                                    // buffer is reused elsewhere, so it can't be delayed in-place
                                     const int bufferToDelay = getFreeBuffer (false);
                                     renderingOps.add (new CopyChannelOp (srcIndex, bufferToDelay));
-                                    renderingOps.add (new DelayChannelOp (bufferToDelay, maxLatency - nodeDelay));
                                     srcIndex = bufferToDelay;
                                 }
+
+                                addCompensationDelay (renderingOps, srcIndex, false, ourRenderingIndex, sourceNodes.getUnchecked (j));
                             }
 
                             renderingOps.add (new AddChannelOp (srcIndex, bufIndex));
@@ -493,7 +1038,8 @@ private:
             jassert (bufIndex >= 0);
             audioChannelsToUse.add (bufIndex);
 
-            if (inputChan < numOuts)
+            // (a new buffer for an input-only channel gets marked too, so that the next channel can't be given it)
+            if (inputChan < numOuts || usesNewBuffer)
                 markBufferAsContaining (bufIndex, node->nodeId, inputChan);
         }
 
@@ -509,11 +1055,11 @@ private:
         // Now the same thing for midi..
         Array <uint32> midiSourceNodes;
 
-        for (int i = graph.getNumConnections(); --i >= 0;)
+        for (int i = 0; i < inputs.size(); ++i)
         {
-            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+            const AudioProcessorGraph::Connection* const c = inputs.getUnchecked (i);
 
-            if (c->destNodeId == node->nodeId && c->destChannelIndex == AudioProcessorGraph::midiChannelIndex)
+            if (c->destChannelIndex == AudioProcessorGraph::midiChannelIndex)
                 midiSourceNodes.add (c->sourceNodeId);
         }
 
@@ -544,6 +1090,9 @@ private:
                     renderingOps.add (new CopyMidiBufferOp (midiBufferToUse, newFreeBuffer));
                     midiBufferToUse = newFreeBuffer;
                 }
+
+                if (compensating)
+                    addCompensationDelay (renderingOps, midiBufferToUse, true, ourRenderingIndex, midiSourceNodes.getUnchecked(0));
             }
             else
             {
@@ -570,6 +1119,10 @@ private:
                     // we've found one of our input buffers that can be re-used..
                     reusableInputIndex = i;
                     midiBufferToUse = sourceBufIndex;
+
+                    if (compensating)
+                        addCompensationDelay (renderingOps, midiBufferToUse, true, ourRenderingIndex, midiSourceNodes.getUnchecked(i));
+
                     break;
                 }
             }
@@ -580,12 +1133,22 @@ private:
                 midiBufferToUse = getFreeBuffer (true);
                 jassert (midiBufferToUse >= 0);
 
+                // (mark it straight away, so that it can't be picked as a temporary buffer below)
+                markBufferAsContaining (midiBufferToUse, node->nodeId, AudioProcessorGraph::midiChannelIndex);
+
                 const int srcIndex = getBufferContaining (midiSourceNodes.getUnchecked(0),
                                                           AudioProcessorGraph::midiChannelIndex);
                 if (srcIndex >= 0)
+                {
                     renderingOps.add (new CopyMidiBufferOp (srcIndex, midiBufferToUse));
+
+                    if (compensating)
+                        addCompensationDelay (renderingOps, midiBufferToUse, true, ourRenderingIndex, midiSourceNodes.getUnchecked(0));
+                }
                 else
+                {
                     renderingOps.add (new ClearMidiBufferOp (midiBufferToUse));
+                }
 
                 reusableInputIndex = 0;
             }
@@ -594,48 +1157,178 @@ private:
             {
                 if (j != reusableInputIndex)
                 {
-                    const int srcIndex = getBufferContaining (midiSourceNodes.getUnchecked(j),
-                                                              AudioProcessorGraph::midiChannelIndex);
+                    int srcIndex = getBufferContaining (midiSourceNodes.getUnchecked(j),
+                                                        AudioProcessorGraph::midiChannelIndex);
                     if (srcIndex >= 0)
+                    {
+                        if (compensating)
+                        {
+                            if (isBufferNeededLater (ourRenderingIndex, AudioProcessorGraph::midiChannelIndex,
+                                                     midiSourceNodes.getUnchecked(j),
+                                                     AudioProcessorGraph::midiChannelIndex))
+                            {
+                                // buffer is reused elsewhere, so it can't be delayed in-place
+                                const int bufferToDelay = getFreeBuffer (true);
+                                renderingOps.add (new CopyMidiBufferOp (srcIndex, bufferToDelay));
+                                srcIndex = bufferToDelay;
+                            }
+
+                            addCompensationDelay (renderingOps, srcIndex, true, ourRenderingIndex, midiSourceNodes.getUnchecked(j));
+                        }
+
                         renderingOps.add (new AddMidiBufferOp (srcIndex, midiBufferToUse));
+                    }
                 }
             }
         }
 
-        if (node->getProcessor()->producesMidi())
+        // (if the buffers aren't being recycled, every node needs its own midi buffer, because
+        // any nodes that might be run concurrently mustn't share a scratch buffer)
+        if (node->getProcessor()->producesMidi() || ! canReuseBuffers)
             markBufferAsContaining (midiBufferToUse, node->nodeId,
                                     AudioProcessorGraph::midiChannelIndex);
 
-        setNodeDelay (node->nodeId, maxLatency + node->getProcessor()->getLatencySamples());
+        renderingOps.add (new ProcessBufferOp (graph, node, audioChannelsToUse,
+                                               totalChans, midiBufferToUse));
+    }
+
+    //==============================================================================
+    // Rather than leaving all the inputs of a mixed channel until the node that uses them comes
+    // up, each one is added into a shared buffer as soon as it's been rendered, so that the buffer
+    // holding it can be recycled straight away. Otherwise every branch of the graph that feeds
+    // into a mixer would keep hold of its own buffers until the end of the sequence.
+    void mixOutputsIntoLaterInputs (const int stepIndex, Array<void*>& renderingOps)
+    {
+        const AudioProcessorGraph::Node* const node = (const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (stepIndex);
 
-        if (numOuts == 0)
-            totalLatency = maxLatency;
+        for (int chan = 0; chan < node->getProcessor()->getNumOutputChannels(); ++chan)
+        {
+            const int64 key = getSourceKey (node->nodeId, chan);
+            const int srcIndex = getBufferContaining (node->nodeId, chan);
 
-        renderingOps.add (new ProcessBufferOp (node, audioChannelsToUse,
-                                               totalChans, midiBufferToUse));
+            if (srcIndex <= 0 || ! sourceUsageIndexes.contains (key))
+                continue;
+
+            Array<Usage>& usages = *sourceUsages.getUnchecked (sourceUsageIndexes [key]);
+
+            for (int i = usages.size(); --i >= 0;)
+            {
+                const Usage u (usages.getReference(i));
+                const int64 mixKey = getSourceKey ((uint32) u.stepIndex, u.destChannel);
+
+                if (mixBuffers.contains (mixKey))
+                    addToMix (renderingOps, node->nodeId, chan, u, mixBuffers [mixKey]);
+            }
+
+            // if nothing else needs this channel, it can become the buffer that the others are mixed into..
+            if (usages.size() == 1 && canMixEarly (usages.getReference(0).stepIndex, usages.getReference(0).destChannel))
+            {
+                const Usage u (usages.getReference(0));
+                usages.clear();
+
+                mixBuffers.set (getSourceKey ((uint32) u.stepIndex, u.destChannel), srcIndex);
+                nodeIds.set (srcIndex, (uint32) mixNodeID);
+
+                if (needsCompensation (u.stepIndex))
+                    addCompensationDelay (renderingOps, srcIndex, false, u.stepIndex, node->nodeId);
+
+                // ..in which case, any of the other inputs that have already been rendered get added now
+                const Array<const AudioProcessorGraph::Connection*>& inputs = *nodeInputs.getUnchecked (u.stepIndex);
+
+                for (int i = 0; i < inputs.size(); ++i)
+                {
+                    const AudioProcessorGraph::Connection* const c = inputs.getUnchecked(i);
+
+                    if (c->destChannelIndex == u.destChannel
+                         && stepIndexes [(int) c->sourceNodeId] <= stepIndex
+                         && ! (c->sourceNodeId == node->nodeId && c->sourceChannelIndex == chan))
+                        addToMix (renderingOps, c->sourceNodeId, c->sourceChannelIndex, u, srcIndex);
+                }
+            }
+        }
+    }
+
+    void addToMix (Array<void*>& renderingOps, const uint32 sourceNodeId, const int sourceChan,
+                   const Usage& usage, const int mixIndex)
+    {
+        int srcIndex = getBufferContaining (sourceNodeId, sourceChan);
+        removeUsage (sourceNodeId, sourceChan, usage);
+
+        if (srcIndex <= 0)
+            return;
+
+        if (needsCompensation (usage.stepIndex))
+        {
+            if (sourceUsages.getUnchecked (sourceUsageIndexes [getSourceKey (sourceNodeId, sourceChan)])->size() > 0)
+            {
+                // buffer is reused elsewhere, so it can't be delayed in-place
+                const int bufferToDelay = getFreeBuffer (false);
+                renderingOps.add (new CopyChannelOp (srcIndex, bufferToDelay));
+                srcIndex = bufferToDelay;
+            }
+
+            addCompensationDelay (renderingOps, srcIndex, false, usage.stepIndex, sourceNodeId);
+        }
+
+        renderingOps.add (new AddChannelOp (srcIndex, mixIndex));
+    }
+
+    // The inputs can only be mixed ahead of time if they all come from earlier in the sequence.
+    bool canMixEarly (const int stepIndex, const int inputChan) const
+    {
+        const Array<const AudioProcessorGraph::Connection*>& inputs = *nodeInputs.getUnchecked (stepIndex);
+        int numSources = 0;
+
+        for (int i = 0; i < inputs.size(); ++i)
+        {
+            const AudioProcessorGraph::Connection* const c = inputs.getUnchecked(i);
+
+            if (c->destChannelIndex == inputChan)
+            {
+                if (stepIndexes [(int) c->sourceNodeId] >= stepIndex)
+                    return false;
+
+                ++numSources;
+            }
+        }
+
+        return numSources > 1;
+    }
+
+    void removeUsage (const uint32 nodeId, const int outputChannel, const Usage& usage)
+    {
+        Array<Usage>& usages = *sourceUsages.getUnchecked (sourceUsageIndexes [getSourceKey (nodeId, outputChannel)]);
+
+        for (int i = usages.size(); --i >= 0;)
+            if (usages.getReference(i).stepIndex == usage.stepIndex && usages.getReference(i).destChannel == usage.destChannel)
+                usages.remove (i);
     }
 
     //==============================================================================
+    // (the buffer stays free until it's marked as containing something, so calling this
+    // again before then will return the same one)
     int getFreeBuffer (const bool forMidi)
     {
         if (forMidi)
         {
-            for (int i = 1; i < midiNodeIds.size(); ++i)
-                if (midiNodeIds.getUnchecked(i) == freeNodeID)
-                    return i;
+            if (freeMidiBuffers.size() == 0)
+            {
+                midiNodeIds.add ((uint32) freeNodeID);
+                freeMidiBuffers.add (midiNodeIds.size() - 1);
+            }
 
-            midiNodeIds.add ((uint32) freeNodeID);
-            return midiNodeIds.size() - 1;
+            return freeMidiBuffers.getLast();
         }
         else
         {
-            for (int i = 1; i < nodeIds.size(); ++i)
-                if (nodeIds.getUnchecked(i) == freeNodeID)
-                    return i;
+            if (freeBuffers.size() == 0)
+            {
+                nodeIds.add ((uint32) freeNodeID);
+                channels.add (0);
+                freeBuffers.add (nodeIds.size() - 1);
+            }
 
-            nodeIds.add ((uint32) freeNodeID);
-            channels.add (0);
-            return nodeIds.size() - 1;
+            return freeBuffers.getLast();
         }
     }
 
@@ -668,11 +1361,13 @@ private:
         for (int i = 0; i < nodeIds.size(); ++i)
         {
             if (isNodeBusy (nodeIds.getUnchecked(i))
+                 && nodeIds.getUnchecked(i) != (uint32) mixNodeID
                  && ! isBufferNeededLater (stepIndex, -1,
                                            nodeIds.getUnchecked(i),
                                            channels.getUnchecked(i)))
             {
                 nodeIds.set (i, (uint32) freeNodeID);
+                freeBuffers.add (i);
             }
         }
 
@@ -684,37 +1379,33 @@ private:
                                            AudioProcessorGraph::midiChannelIndex))
             {
                 midiNodeIds.set (i, (uint32) freeNodeID);
+                freeMidiBuffers.add (i);
             }
         }
     }
 
-    bool isBufferNeededLater (int stepIndexToSearchFrom,
-                              int inputChannelOfIndexToIgnore,
+    bool isBufferNeededLater (const int stepIndexToSearchFrom,
+                              const int inputChannelOfIndexToIgnore,
                               const uint32 nodeId,
                               const int outputChanIndex) const
     {
-        while (stepIndexToSearchFrom < orderedNodes.size())
+        const int64 key = getSourceKey (nodeId, outputChanIndex);
+
+        if (! sourceUsageIndexes.contains (key))
+            return false;
+
+        // the usages are in step order, so only the ones at the end need checking..
+        const Array<Usage>& usages = *sourceUsages.getUnchecked (sourceUsageIndexes [key]);
+
+        for (int i = usages.size(); --i >= 0;)
         {
-            const AudioProcessorGraph::Node* const node = (const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (stepIndexToSearchFrom);
+            const Usage& u = usages.getReference (i);
 
-            if (outputChanIndex == AudioProcessorGraph::midiChannelIndex)
-            {
-                if (inputChannelOfIndexToIgnore != AudioProcessorGraph::midiChannelIndex
-                     && graph.getConnectionBetween (nodeId, AudioProcessorGraph::midiChannelIndex,
-                                                    node->nodeId, AudioProcessorGraph::midiChannelIndex) != nullptr)
-                    return true;
-            }
-            else
-            {
-                for (int i = 0; i < node->getProcessor()->getNumInputChannels(); ++i)
-                    if (i != inputChannelOfIndexToIgnore
-                         && graph.getConnectionBetween (nodeId, outputChanIndex,
-                                                        node->nodeId, i) != nullptr)
-                        return true;
-            }
+            if (u.stepIndex < stepIndexToSearchFrom)
+                break;
 
-            inputChannelOfIndexToIgnore = -1;
-            ++stepIndexToSearchFrom;
+            if (u.stepIndex > stepIndexToSearchFrom || u.destChannel != inputChannelOfIndexToIgnore)
+                return true;
         }
 
         return false;
@@ -727,6 +1418,7 @@ private:
             jassert (bufferNum > 0 && bufferNum < midiNodeIds.size());
 
             midiNodeIds.set (bufferNum, nodeId);
+            freeMidiBuffers.removeFirstMatchingValue (bufferNum);
         }
         else
         {
@@ -734,6 +1426,7 @@ private:
 
             nodeIds.set (bufferNum, nodeId);
             channels.set (bufferNum, outputIndex);
+            freeBuffers.removeFirstMatchingValue (bufferNum);
         }
     }
 
@@ -742,6 +1435,8 @@ private:
 
 //==============================================================================
 // Holds a fast lookup table for checking which nodes are inputs to others.
+// The complete set of nodes that feed into each node is only worked out the first
+// time that node is queried, and is then cached.
 class ConnectionLookupTable
 {
 public:
@@ -765,47 +1460,80 @@ public:
     }
 
     bool isAnInputTo (const uint32 possibleInputId,
-                      const uint32 possibleDestinationId) const noexcept
+                      const uint32 possibleDestinationId)
     {
-        return isAnInputToRecursive (possibleInputId, possibleDestinationId, entries.size());
+        int index;
+
+        if (Entry* const entry = findEntry (possibleDestinationId, index))
+        {
+            if (! entry->allSourcesFound)
+                findAllSources (*entry);
+
+            DefaultElementComparator<uint32> comparator;
+            return entry->allSrcNodes.indexOfSorted (comparator, possibleInputId) >= 0;
+        }
+
+        return false;
     }
 
 private:
     //==============================================================================
     struct Entry
     {
-        explicit Entry (const uint32 destNodeId_) noexcept : destNodeId (destNodeId_) {}
+        explicit Entry (const uint32 destNodeId_) noexcept
+            : destNodeId (destNodeId_), allSourcesFound (false) {}
 
         const uint32 destNodeId;
         SortedSet<uint32> srcNodes;
 
+        // all the nodes which feed into this one, either directly or indirectly (sorted)
+        Array<uint32> allSrcNodes;
+        bool allSourcesFound;
+
         JUCE_DECLARE_NON_COPYABLE (Entry)
     };
 
     OwnedArray<Entry> entries;
 
-    bool isAnInputToRecursive (const uint32 possibleInputId,
-                               const uint32 possibleDestinationId,
-                               int recursionCheck) const noexcept
+    void findAllSources (Entry& entry)
     {
-        int index;
+        SortedSet<uint32> found;
+        Array<uint32> nodesToVisit;
+
+        for (int i = entry.srcNodes.size(); --i >= 0;)
+            nodesToVisit.add (entry.srcNodes.getUnchecked (i));
 
-        if (const Entry* const entry = findEntry (possibleDestinationId, index))
+        while (nodesToVisit.size() > 0)
         {
-            const SortedSet<uint32>& srcNodes = entry->srcNodes;
+            const uint32 nodeId = nodesToVisit.getLast();
+            nodesToVisit.removeLast();
 
-            if (srcNodes.contains (possibleInputId))
-                return true;
+            if (found.contains (nodeId))
+                continue;
+
+            found.add (nodeId);
 
-            if (--recursionCheck >= 0)
+            int index;
+            if (const Entry* const source = findEntry (nodeId, index))
             {
-                for (int i = 0; i < srcNodes.size(); ++i)
-                    if (isAnInputToRecursive (possibleInputId, srcNodes.getUnchecked(i), recursionCheck))
-                        return true;
+                if (source->allSourcesFound)
+                {
+                    for (int i = source->allSrcNodes.size(); --i >= 0;)
+                        found.add (source->allSrcNodes.getUnchecked (i));
+                }
+                else
+                {
+                    for (int i = source->srcNodes.size(); --i >= 0;)
+                        if (! found.contains (source->srcNodes.getUnchecked (i)))
+                            nodesToVisit.add (source->srcNodes.getUnchecked (i));
+                }
             }
         }
 
-        return false;
+        for (int i = 0; i < found.size(); ++i)
+            entry.allSrcNodes.add (found.getUnchecked (i));
+
+        entry.allSourcesFound = true;
     }
 
     Entry* findEntry (const uint32 destNodeId, int& insertIndex) const noexcept
@@ -873,660 +1601,2408 @@ struct ConnectionSorter
 }
 
 //==============================================================================
-AudioProcessorGraph::Connection::Connection (const uint32 sourceNodeId_, const int sourceChannelIndex_,
-                                             const uint32 destNodeId_, const int destChannelIndex_) noexcept
-    : sourceNodeId (sourceNodeId_), sourceChannelIndex (sourceChannelIndex_),
-      destNodeId (destNodeId_), destChannelIndex (destChannelIndex_)
-{
-}
+/** Runs a rendering sequence across a set of worker threads.
 
-//==============================================================================
-AudioProcessorGraph::Node::Node (const uint32 nodeId_, AudioProcessor* const processor_) noexcept
-    : nodeId (nodeId_),
-      processor (processor_),
-      isPrepared (false)
+    The ops are grouped into levels, where no two ops within a level touch the
+    same shared buffer in a conflicting way. All the threads work through each
+    level together, and then wait for it to be completed before moving on to
+    the next one.
+*/
+class AudioProcessorGraph::ParallelRenderer  : private WorkerThreadGroup::Job
 {
-    jassert (processor != nullptr);
-}
+public:
+    ParallelRenderer (const int numThreads)
+        : threads ("Graph rendering thread", numThreads),
+          currentBuffers (nullptr),
+          currentDoubleBuffers (nullptr),
+          currentMidiBuffers (nullptr),
+          currentSilentChannels (nullptr),
+          currentNumSamples (0)
+    {
+    }
 
-void AudioProcessorGraph::Node::prepare (const double sampleRate, const int blockSize,
-                                         AudioProcessorGraph* const graph)
-{
-    if (! isPrepared)
+    int getNumThreads() const noexcept      { return threads.getNumThreads(); }
+
+    //==============================================================================
+    struct Level
     {
-        isPrepared = true;
-        setParentGraph (graph);
+        Array<GraphRenderingOps::AudioGraphRenderingOp*> ops;
+        Atomic<int> nextIndex, numDone;
+    };
 
-        processor->setPlayConfigDetails (processor->getNumInputChannels(),
-                                         processor->getNumOutputChannels(),
-                                         sampleRate, blockSize);
+    struct Schedule
+    {
+        Schedule() : isWorthParallelising (false) {}
 
-        processor->prepareToPlay (sampleRate, blockSize);
-    }
-}
+        OwnedArray<Level> levels;
+        bool isWorthParallelising;
 
-void AudioProcessorGraph::Node::unprepare()
-{
-    if (isPrepared)
+        JUCE_DECLARE_NON_COPYABLE (Schedule)
+    };
+
+    static Schedule* createSchedule (const Array<void*>& renderingOps)
     {
-        isPrepared = false;
-        processor->releaseResources();
-    }
-}
+        using namespace GraphRenderingOps;
 
-void AudioProcessorGraph::Node::setParentGraph (AudioProcessorGraph* const graph) const
-{
-    if (AudioProcessorGraph::AudioGraphIOProcessor* const ioProc
-            = dynamic_cast <AudioProcessorGraph::AudioGraphIOProcessor*> (processor.get()))
-        ioProc->setParentGraph (graph);
-}
+        Schedule* const s = new Schedule();
 
-//==============================================================================
-AudioProcessorGraph::AudioProcessorGraph()
-    : lastNodeId (0),
-      renderingBuffers (1, 1),
-      currentAudioOutputBuffer (1, 1)
-{
-}
+        // For each resource, these hold (1 + the index of the level) that last wrote
+        // or read it, so that a zero means that it hasn't been touched yet.
+        Array<int> lastWriteLevel, lastReadLevel;
+        Array<int> reads, writes;
+        Array<int> numProcessOps;
 
-AudioProcessorGraph::~AudioProcessorGraph()
-{
-    clearRenderingSequence();
-    clear();
-}
+        for (int i = 0; i < renderingOps.size(); ++i)
+        {
+            AudioGraphRenderingOp* const op = static_cast<AudioGraphRenderingOp*> (renderingOps.getUnchecked(i));
 
-const String AudioProcessorGraph::getName() const
-{
-    return "Audio Graph";
-}
+            reads.clearQuick();
+            writes.clearQuick();
+            op->getResourcesUsed (reads, writes);
 
-//==============================================================================
-void AudioProcessorGraph::clear()
-{
-    nodes.clear();
-    connections.clear();
-    triggerAsyncUpdate();
-}
+            int level = 0;
 
-AudioProcessorGraph::Node* AudioProcessorGraph::getNodeForId (const uint32 nodeId) const
-{
-    for (int i = nodes.size(); --i >= 0;)
-        if (nodes.getUnchecked(i)->nodeId == nodeId)
-            return nodes.getUnchecked(i);
+            for (int j = reads.size(); --j >= 0;)
+                level = jmax (level, lastWriteLevel [reads.getUnchecked(j)]);
 
-    return nullptr;
-}
+            for (int j = writes.size(); --j >= 0;)
+                level = jmax (level, lastWriteLevel [writes.getUnchecked(j)],
+                                     lastReadLevel [writes.getUnchecked(j)]);
 
-AudioProcessorGraph::Node* AudioProcessorGraph::addNode (AudioProcessor* const newProcessor, uint32 nodeId)
-{
-    if (newProcessor == nullptr || newProcessor == this)
-    {
-        jassertfalse;
-        return nullptr;
-    }
+            while (s->levels.size() <= level)
+            {
+                s->levels.add (new Level());
+                numProcessOps.add (0);
+            }
 
-    for (int i = nodes.size(); --i >= 0;)
-    {
-        if (nodes.getUnchecked(i)->getProcessor() == newProcessor)
-        {
-            jassertfalse; // Cannot add the same object to the graph twice!
-            return nullptr;
+            s->levels.getUnchecked (level)->ops.add (op);
+
+            if (dynamic_cast <ProcessBufferOp*> (op) != nullptr)
+            {
+                numProcessOps.set (level, numProcessOps.getUnchecked (level) + 1);
+
+                if (numProcessOps.getUnchecked (level) > 1)
+                    s->isWorthParallelising = true;
+            }
+
+            for (int j = writes.size(); --j >= 0;)
+                setLevel (lastWriteLevel, writes.getUnchecked(j), level + 1);
+
+            for (int j = reads.size(); --j >= 0;)
+                setLevel (lastReadLevel, reads.getUnchecked(j), jmax (level + 1, lastReadLevel [reads.getUnchecked(j)]));
         }
+
+        return s;
     }
 
-    if (nodeId == 0)
+    /** Must be called with the graph's callback lock held. */
+    void swapSchedule (ScopedPointer<Schedule>& other) noexcept
     {
-        nodeId = ++lastNodeId;
+        Schedule* const oldSchedule = schedule.release();
+        schedule = other.release();
+        other = oldSchedule;
     }
-    else
+
+    //==============================================================================
+    /** Renders the current schedule, returning false if it isn't worth running it
+        on multiple threads, in which case the caller should render it serially.
+    */
+    template <typename SampleType>
+    bool perform (SampleType* const* sharedBufferChans, const OwnedArray <MidiBuffer>& sharedMidiBuffers,
+                  bool* const silentChannels, const int numSamples)
     {
-        // you can't add a node with an id that already exists in the graph..
-        jassert (getNodeForId (nodeId) == nullptr);
-        removeNode (nodeId);
+        if (schedule == nullptr || ! schedule->isWorthParallelising)
+            return false;
 
-        if (nodeId > lastNodeId)
-            lastNodeId = nodeId;
-    }
+        setCurrentBuffers (sharedBufferChans);
+        currentMidiBuffers = &sharedMidiBuffers;
+        currentSilentChannels = silentChannels;
+        currentNumSamples = numSamples;
 
-    newProcessor->setPlayHead (getPlayHead());
+        for (int i = schedule->levels.size(); --i >= 0;)
+        {
+            Level& level = *schedule->levels.getUnchecked(i);
+            level.nextIndex = 0;
+            level.numDone = 0;
+        }
 
-    Node* const n = new Node (nodeId, newProcessor);
-    nodes.add (n);
-    triggerAsyncUpdate();
+        threads.run (*this);
+        return true;
+    }
 
-    n->setParentGraph (this);
-    return n;
-}
+private:
+    //==============================================================================
+    WorkerThreadGroup threads;
+    ScopedPointer<Schedule> schedule;
 
-bool AudioProcessorGraph::removeNode (const uint32 nodeId)
-{
-    disconnectNode (nodeId);
+    float* const* currentBuffers;
+    double* const* currentDoubleBuffers;
+    const OwnedArray <MidiBuffer>* currentMidiBuffers;
+    bool* currentSilentChannels;
+    int currentNumSamples;
 
-    for (int i = nodes.size(); --i >= 0;)
+    void runOnThread (int)
     {
-        if (nodes.getUnchecked(i)->nodeId == nodeId)
+        for (int i = 0; i < schedule->levels.size(); ++i)
         {
-            nodes.getUnchecked(i)->setParentGraph (nullptr);
-            nodes.remove (i);
-            triggerAsyncUpdate();
+            Level& level = *schedule->levels.getUnchecked(i);
+            const int numOps = level.ops.size();
 
-            return true;
+            for (;;)
+            {
+                const int index = (++level.nextIndex) - 1;
+
+                if (index >= numOps)
+                    break;
+
+                GraphRenderingOps::AudioGraphRenderingOp* const op = level.ops.getUnchecked (index);
+
+                if (currentDoubleBuffers != nullptr)
+                    op->perform (currentDoubleBuffers, *currentMidiBuffers, currentSilentChannels, currentNumSamples);
+                else
+                    op->perform (currentBuffers, *currentMidiBuffers, currentSilentChannels, currentNumSamples);
+
+                ++level.numDone;
+            }
+
+            while (level.numDone.get() < numOps)
+                Thread::yield();
         }
     }
 
-    return false;
-}
+    void setCurrentBuffers (float* const* buffers) noexcept
+    {
+        currentBuffers = buffers;
+        currentDoubleBuffers = nullptr;
+    }
+
+    void setCurrentBuffers (double* const* buffers) noexcept
+    {
+        currentBuffers = nullptr;
+        currentDoubleBuffers = buffers;
+    }
+
+    static void setLevel (Array<int>& levels, const int resource, const int value)
+    {
+        while (levels.size() <= resource)
+            levels.add (0);
+
+        levels.set (resource, value);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelRenderer)
+};
 
 //==============================================================================
-const AudioProcessorGraph::Connection* AudioProcessorGraph::getConnectionBetween (const uint32 sourceNodeId,
-                                                                                  const int sourceChannelIndex,
-                                                                                  const uint32 destNodeId,
-                                                                                  const int destChannelIndex) const
-{
-    const Connection c (sourceNodeId, sourceChannelIndex, destNodeId, destChannelIndex);
-    GraphRenderingOps::ConnectionSorter sorter;
-    return connections [connections.indexOfSorted (sorter, &c)];
-}
+/** Keeps the latency compensation in a rendering sequence up to date.
 
-bool AudioProcessorGraph::isConnected (const uint32 possibleSourceNodeId,
-                                       const uint32 possibleDestNodeId) const
+    At the start of each block, this checks whether any of the processors have changed
+    their latency, and if so, recalculates the latency of every path through the graph
+    and adjusts the sequence's delay ops to match, so that the change takes effect at
+    the block boundary without the sequence being rebuilt. A rebuild is only needed if a
+    delay grows beyond the space that was allocated for it.
+*/
+class AudioProcessorGraph::LatencyCompensator  : private AsyncUpdater
 {
-    for (int i = connections.size(); --i >= 0;)
+public:
+    LatencyCompensator (AudioProcessorGraph& graph_,
+                        const GraphRenderingOps::RenderingOpSequenceCalculator& calculator)
+        : graph (graph_),
+          delays (calculator.getCompensationDelays()),
+          totalLatency (calculator.getTotalLatency())
     {
-        const Connection* const c = connections.getUnchecked(i);
-
-        if (c->sourceNodeId == possibleSourceNodeId
-             && c->destNodeId == possibleDestNodeId)
+        for (int i = 0; i < calculator.getNumSteps(); ++i)
         {
-            return true;
+            AudioProcessor* const processor = calculator.getProcessorForStep (i);
+            const Step step = { processor, processor->getLatencySamples(),
+                                processor->getNumOutputChannels() == 0, calculator.getSourceSteps (i) };
+            steps.add (step);
         }
+
+        inputLatencies.insertMultiple (0, 0, steps.size());
+        outputLatencies.insertMultiple (0, 0, steps.size());
     }
 
-    return false;
-}
+    ~LatencyCompensator()
+    {
+        cancelPendingUpdate();
+    }
 
-bool AudioProcessorGraph::canConnect (const uint32 sourceNodeId,
-                                      const int sourceChannelIndex,
-                                      const uint32 destNodeId,
-                                      const int destChannelIndex) const
-{
-    if (sourceChannelIndex < 0
-         || destChannelIndex < 0
-         || sourceNodeId == destNodeId
-         || (destChannelIndex == midiChannelIndex) != (sourceChannelIndex == midiChannelIndex))
-        return false;
+    // Called by the audio thread before rendering each block.
+    void update()
+    {
+        bool anyChanged = false;
 
-    const Node* const source = getNodeForId (sourceNodeId);
+        for (int i = steps.size(); --i >= 0;)
+        {
+            Step& step = steps.getReference (i);
+            const int latency = step.processor->getLatencySamples();
 
-    if (source == nullptr
-         || (sourceChannelIndex != midiChannelIndex && sourceChannelIndex >= source->processor->getNumOutputChannels())
-         || (sourceChannelIndex == midiChannelIndex && ! source->processor->producesMidi()))
-        return false;
+            if (latency != step.latency)
+            {
+                step.latency = latency;
+                anyChanged = true;
+            }
+        }
 
-    const Node* const dest = getNodeForId (destNodeId);
+        if (anyChanged)
+            recalculate();
+    }
 
-    if (dest == nullptr
-         || (destChannelIndex != midiChannelIndex && destChannelIndex >= dest->processor->getNumInputChannels())
-         || (destChannelIndex == midiChannelIndex && ! dest->processor->acceptsMidi()))
-        return false;
+private:
+    struct Step
+    {
+        AudioProcessor* processor;
+        int latency;
+        bool isOutput;
+        Array<int> sources;
+    };
 
-    return getConnectionBetween (sourceNodeId, sourceChannelIndex,
-                                 destNodeId, destChannelIndex) == nullptr;
-}
+    AudioProcessorGraph& graph;
+    Array<Step> steps;
+    const Array<GraphRenderingOps::RenderingOpSequenceCalculator::CompensationDelay> delays;
+    Array<int> inputLatencies, outputLatencies;
+    Atomic<int> totalLatency;
+
+    // This is the same calculation that the RenderingOpSequenceCalculator does, but
+    // because all the arrays are already the right size, it doesn't allocate anything.
+    void recalculate()
+    {
+        int newTotalLatency = 0;
 
-bool AudioProcessorGraph::addConnection (const uint32 sourceNodeId,
-                                         const int sourceChannelIndex,
-                                         const uint32 destNodeId,
-                                         const int destChannelIndex)
-{
-    if (! canConnect (sourceNodeId, sourceChannelIndex, destNodeId, destChannelIndex))
-        return false;
+        for (int i = 0; i < steps.size(); ++i)
+        {
+            const Step& step = steps.getReference (i);
+            int maxLatency = 0;
 
-    GraphRenderingOps::ConnectionSorter sorter;
-    connections.addSorted (sorter, new Connection (sourceNodeId, sourceChannelIndex,
-                                                   destNodeId, destChannelIndex));
-    triggerAsyncUpdate();
-    return true;
-}
+            for (int j = step.sources.size(); --j >= 0;)
+            {
+                const int source = step.sources.getUnchecked (j);
 
-void AudioProcessorGraph::removeConnection (const int index)
-{
-    connections.remove (index);
-    triggerAsyncUpdate();
-}
+                if (source < i)
+                    maxLatency = jmax (maxLatency, outputLatencies.getUnchecked (source));
+            }
 
-bool AudioProcessorGraph::removeConnection (const uint32 sourceNodeId, const int sourceChannelIndex,
-                                            const uint32 destNodeId, const int destChannelIndex)
-{
-    bool doneAnything = false;
+            inputLatencies.set (i, maxLatency);
+            outputLatencies.set (i, maxLatency + step.latency);
 
-    for (int i = connections.size(); --i >= 0;)
-    {
-        const Connection* const c = connections.getUnchecked(i);
+            if (step.isOutput)
+                newTotalLatency = jmax (newTotalLatency, maxLatency);
+        }
+
+        bool allDelaysFit = true;
 
-        if (c->sourceNodeId == sourceNodeId
-             && c->destNodeId == destNodeId
-             && c->sourceChannelIndex == sourceChannelIndex
-             && c->destChannelIndex == destChannelIndex)
+        for (int i = delays.size(); --i >= 0;)
         {
-            removeConnection (i);
-            doneAnything = true;
+            const GraphRenderingOps::RenderingOpSequenceCalculator::CompensationDelay& d = delays.getReference (i);
+
+            const int delay = inputLatencies.getUnchecked (d.stepIndex)
+                                - (d.sourceStepIndex < d.stepIndex ? outputLatencies.getUnchecked (d.sourceStepIndex) : 0);
+
+            allDelaysFit = allDelaysFit && delay <= d.op->getMaxDelay();
+            d.op->setDelay (delay);
         }
+
+        if (totalLatency.exchange (newTotalLatency) != newTotalLatency)
+            triggerAsyncUpdate();
+
+        // if the delay lines aren't long enough, the sequence has to be rebuilt with bigger ones..
+        if (! allDelaysFit)
+            graph.triggerAsyncUpdate();
     }
 
-    return doneAnything;
-}
+    void handleAsyncUpdate()
+    {
+        graph.setLatencySamples (totalLatency.get());
+    }
 
-bool AudioProcessorGraph::disconnectNode (const uint32 nodeId)
+    JUCE_DECLARE_NON_COPYABLE (LatencyCompensator)
+};
+
+//==============================================================================
+/** Renders a run of blocks offline by splitting the rendering sequence into a
+    pipeline of stages, each of which runs on its own thread.
+
+    Every block goes through the stages in order, so it has exactly the same ops performed
+    on it as when it's rendered serially, and each stage renders the blocks in order, so
+    the state of all the ops and processors evolves in the same way too. But while stage 1
+    is working on one block, stage 0 can already be rendering the next one. Each block in
+    flight needs its own shared buffers, so there's a set of those for each stage.
+
+    This relies on none of the ops reading data that an earlier block left in a shared
+    buffer, which is the case because the sequence never renders feedback connections.
+*/
+template <typename SampleType>
+class AudioProcessorGraph::OfflinePipeline
 {
-    bool doneAnything = false;
+public:
+    OfflinePipeline (AudioProcessorGraph& graph_, const int maxNumStages)
+        : graph (graph_),
+          audioBlocks (nullptr),
+          midiBlocks (nullptr)
+    {
+        createStages (maxNumStages);
+    }
 
-    for (int i = connections.size(); --i >= 0;)
+    int getNumStages() const noexcept       { return stages.size(); }
+
+    void render (const Array<AudioBuffer<SampleType>*>& audio, const Array<MidiBuffer*>& midi)
     {
-        const Connection* const c = connections.getUnchecked(i);
+        audioBlocks = &audio;
+        midiBlocks = &midi;
+        createSlots();
+
+        OwnedArray<StageThread> threads;
 
-        if (c->sourceNodeId == nodeId || c->destNodeId == nodeId)
+        for (int i = 1; i < stages.size(); ++i)
         {
-            removeConnection (i);
-            doneAnything = true;
+            threads.add (new StageThread (*this, i));
+            threads.getLast()->startThread();
         }
+
+        renderStage (0);
+
+        for (int i = threads.size(); --i >= 0;)
+            threads.getUnchecked(i)->waitForThreadToExit (-1);
     }
 
-    return doneAnything;
-}
+    /** Called by the graph's I/O processors to find the buffers for the block that
+        their stage is currently rendering.
+    */
+    void getIOBuffers (const AudioProcessor* const ioProcessor,
+                       AudioBuffer<SampleType>*& input, AudioBuffer<SampleType>*& output,
+                       MidiBuffer*& midiInput, MidiBuffer*& midiOutput) const noexcept
+    {
+        const int index = ioProcessors.indexOf (ioProcessor);
+        jassert (index >= 0);
 
-bool AudioProcessorGraph::isConnectionLegal (const Connection* const c) const
-{
-    jassert (c != nullptr);
+        if (index >= 0)
+        {
+            Slot& slot = *slots.getUnchecked (stages.getUnchecked (ioStages.getUnchecked (index))->currentSlot);
 
-    const Node* const source = getNodeForId (c->sourceNodeId);
-    const Node* const dest   = getNodeForId (c->destNodeId);
+            input = slot.input;
+            output = &slot.output;
+            midiInput = slot.midiInput;
+            midiOutput = &slot.midiOutput;
+        }
+    }
 
-    return source != nullptr
-        && dest != nullptr
-        && (c->sourceChannelIndex != midiChannelIndex ? isPositiveAndBelow (c->sourceChannelIndex, source->processor->getNumOutputChannels())
-                                                      : source->processor->producesMidi())
-        && (c->destChannelIndex   != midiChannelIndex ? isPositiveAndBelow (c->destChannelIndex, dest->processor->getNumInputChannels())
-                                                      : dest->processor->acceptsMidi());
-}
+private:
+    //==============================================================================
+    struct Stage
+    {
+        Stage() : currentSlot (0) {}
 
-bool AudioProcessorGraph::removeIllegalConnections()
-{
-    bool doneAnything = false;
+        Array<GraphRenderingOps::AudioGraphRenderingOp*> ops;
+        Atomic<int> numBlocksDone;
+        WaitableEvent blockDone;
+        int currentSlot;
+    };
 
-    for (int i = connections.size(); --i >= 0;)
+    // The buffers for one of the blocks that are in flight.
+    struct Slot
     {
-        if (! isConnectionLegal (connections.getUnchecked(i)))
+        Slot() : sharedBuffers (1, 1), input (nullptr), output (1, 1), midiInput (nullptr) {}
+
+        AudioBuffer<SampleType> sharedBuffers;
+        OwnedArray<MidiBuffer> sharedMidiBuffers;
+        HeapBlock<bool> silentChannels;
+
+        AudioBuffer<SampleType>* input;
+        AudioBuffer<SampleType> output;
+        MidiBuffer* midiInput;
+        MidiBuffer midiOutput;
+    };
+
+    class StageThread  : public Thread
+    {
+    public:
+        StageThread (OfflinePipeline& owner_, const int stageIndex_)
+            : Thread ("Graph offline rendering stage " + String (stageIndex_)),
+              owner (owner_), stageIndex (stageIndex_)
         {
-            removeConnection (i);
-            doneAnything = true;
         }
-    }
 
-    return doneAnything;
-}
+        void run()      { owner.renderStage (stageIndex); }
 
-//==============================================================================
-static void deleteRenderOpArray (Array<void*>& ops)
-{
-    for (int i = ops.size(); --i >= 0;)
-        delete static_cast<GraphRenderingOps::AudioGraphRenderingOp*> (ops.getUnchecked(i));
-}
+    private:
+        OfflinePipeline& owner;
+        const int stageIndex;
 
-void AudioProcessorGraph::clearRenderingSequence()
-{
-    Array<void*> oldOps;
+        JUCE_DECLARE_NON_COPYABLE (StageThread)
+    };
 
+    AudioProcessorGraph& graph;
+    OwnedArray<Stage> stages;
+    OwnedArray<Slot> slots;
+    Array<const AudioProcessor*> ioProcessors;
+    Array<int> ioStages;
+    const Array<AudioBuffer<SampleType>*>* audioBlocks;
+    const Array<MidiBuffer*>* midiBlocks;
+
+    // Divides the sequence into stages that should take roughly the same amount of time,
+    // using the nodes' timing stats if there are any, and giving each stage at least one node.
+    void createStages (const int maxNumStages)
     {
-        const ScopedLock sl (getCallbackLock());
-        renderingOps.swapWithArray (oldOps);
-    }
+        using namespace GraphRenderingOps;
 
-    deleteRenderOpArray (oldOps);
-}
+        Array<double> costs;
+        double totalCost = 0;
 
-bool AudioProcessorGraph::isAnInputTo (const uint32 possibleInputId,
-                                       const uint32 possibleDestinationId,
-                                       const int recursionCheck) const
-{
-    if (recursionCheck > 0)
-    {
-        for (int i = connections.size(); --i >= 0;)
+        for (int i = 0; i < graph.renderingOps.size(); ++i)
         {
-            const AudioProcessorGraph::Connection* const c = connections.getUnchecked (i);
+            double cost = 0;
 
-            if (c->destNodeId == possibleDestinationId
-                 && (c->sourceNodeId == possibleInputId
-                      || isAnInputTo (possibleInputId, c->sourceNodeId, recursionCheck - 1)))
-                return true;
+            if (ProcessBufferOp* const op = dynamic_cast <ProcessBufferOp*> (static_cast <AudioGraphRenderingOp*> (graph.renderingOps.getUnchecked(i))))
+                cost = 1.0 + op->node->getTimingStats().getAverageMicroseconds();
+
+            costs.add (cost);
+            totalCost += cost;
         }
-    }
 
-    return false;
-}
+        int numNodes = 0;
 
-void AudioProcessorGraph::buildRenderingSequence()
-{
-    Array<void*> newRenderingOps;
-    int numRenderingBuffersNeeded = 2;
-    int numMidiBuffersNeeded = 1;
+        for (int i = costs.size(); --i >= 0;)
+            if (costs.getUnchecked(i) > 0)
+                ++numNodes;
 
-    {
-        MessageManagerLock mml;
+        const int numStages = jmax (1, jmin (maxNumStages, numNodes));
+        stages.add (new Stage());
 
-        Array<void*> orderedNodes;
+        bool stageHasNode = false;
+        double costSoFar = 0;
 
+        for (int i = 0; i < graph.renderingOps.size(); ++i)
         {
-            const GraphRenderingOps::ConnectionLookupTable table (connections);
+            AudioGraphRenderingOp* const op = static_cast <AudioGraphRenderingOp*> (graph.renderingOps.getUnchecked(i));
+            const double cost = costs.getUnchecked(i);
 
-            for (int i = 0; i < nodes.size(); ++i)
+            if (cost > 0)
             {
-                Node* const node = nodes.getUnchecked(i);
+                if (stageHasNode && stages.size() < numStages
+                     && costSoFar >= totalCost * stages.size() / numStages)
+                {
+                    stages.add (new Stage());
+                    stageHasNode = false;
+                }
 
-                node->prepare (getSampleRate(), getBlockSize(), this);
+                stageHasNode = true;
 
-                int j = 0;
-                for (; j < orderedNodes.size(); ++j)
-                    if (table.isAnInputTo (node->nodeId, ((Node*) orderedNodes.getUnchecked(j))->nodeId))
-                      break;
+                AudioProcessor* const processor = static_cast <ProcessBufferOp*> (op)->processor;
 
-                orderedNodes.insert (j, node);
+                if (dynamic_cast <AudioProcessorGraph::AudioGraphIOProcessor*> (processor) != nullptr)
+                {
+                    ioProcessors.add (processor);
+                    ioStages.add (stages.size() - 1);
+                }
             }
+
+            stages.getLast()->ops.add (op);
+            costSoFar += cost;
         }
+    }
 
-        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newRenderingOps);
+    void createSlots()
+    {
+        int maxBlockSize = graph.getBlockSize();
 
-        numRenderingBuffersNeeded = calculator.getNumBuffersNeeded();
-        numMidiBuffersNeeded = calculator.getNumMidiBuffersNeeded();
+        for (int i = audioBlocks->size(); --i >= 0;)
+            maxBlockSize = jmax (maxBlockSize, audioBlocks->getUnchecked(i)->getNumSamples());
+
+        for (int i = jmin (stages.size(), audioBlocks->size()); --i >= 0;)
+        {
+            Slot* const slot = new Slot();
+            slots.add (slot);
+
+            slot->sharedBuffers.setSize (graph.numRenderingBuffersInUse, maxBlockSize);
+            slot->sharedBuffers.clear();
+            slot->silentChannels.calloc ((size_t) graph.numRenderingBuffersInUse);
+
+            for (int j = graph.midiBuffers.size(); --j >= 0;)
+            {
+                MidiBuffer* const m = new MidiBuffer();
+                m->ensureSize (GraphRenderingOps::initialMidiBufferSize);
+                slot->sharedMidiBuffers.add (m);
+            }
+
+            slot->midiOutput.ensureSize (GraphRenderingOps::initialMidiBufferSize);
+        }
     }
 
+    void renderStage (const int stageIndex)
     {
-        // swap over to the new rendering sequence..
-        const ScopedLock sl (getCallbackLock());
+        Stage& stage = *stages.getUnchecked (stageIndex);
+        const int lastStage = stages.size() - 1;
 
-        renderingBuffers.setSize (numRenderingBuffersNeeded, getBlockSize());
-        renderingBuffers.clear();
+        for (int block = 0; block < audioBlocks->size(); ++block)
+        {
+            if (stageIndex > 0)
+                waitForStage (stageIndex - 1, block + 1);
+            else if (block >= slots.size())
+                waitForStage (lastStage, block + 1 - slots.size()); // (the slot must be free again)
 
-        for (int i = midiBuffers.size(); --i >= 0;)
-            midiBuffers.getUnchecked(i)->clear();
+            const int slotIndex = block % slots.size();
+            Slot& slot = *slots.getUnchecked (slotIndex);
+            AudioBuffer<SampleType>& buffer = *audioBlocks->getUnchecked (block);
+            MidiBuffer& midi = *midiBlocks->getUnchecked (block);
+            const int numSamples = buffer.getNumSamples();
 
-        while (midiBuffers.size() < numMidiBuffersNeeded)
-            midiBuffers.add (new MidiBuffer());
+            if (stageIndex == 0)
+                startBlock (slot, buffer, midi);
 
-        renderingOps.swapWithArray (newRenderingOps);
+            stage.currentSlot = slotIndex;
+
+            SampleType* const* const sharedChannels = slot.sharedBuffers.getArrayOfChannels();
+
+            for (int i = 0; i < stage.ops.size(); ++i)
+                stage.ops.getUnchecked(i)->perform (sharedChannels, slot.sharedMidiBuffers,
+                                                    slot.silentChannels, numSamples);
+
+            if (stageIndex == lastStage)
+                finishBlock (slot, buffer, midi);
+
+            ++stage.numBlocksDone;
+            stage.blockDone.signal();
+        }
     }
 
-    // delete the old ones..
-    deleteRenderOpArray (newRenderingOps);
-}
+    void waitForStage (const int stageIndex, const int numBlocksNeeded)
+    {
+        Stage& stage = *stages.getUnchecked (stageIndex);
 
-void AudioProcessorGraph::handleAsyncUpdate()
+        while (stage.numBlocksDone.get() < numBlocksNeeded)
+            stage.blockDone.wait (100);
+    }
+
+    // These do the same as the start and end of AudioProcessorGraph::renderBlock()
+    void startBlock (Slot& slot, AudioBuffer<SampleType>& buffer, MidiBuffer& midi)
+    {
+        zeromem (slot.silentChannels, sizeof (bool) * (size_t) graph.numRenderingBuffersInUse);
+        slot.silentChannels[0] = true;
+
+        slot.input = &buffer;
+        slot.output.setSize (jmax (1, buffer.getNumChannels()), buffer.getNumSamples(), false, false, true);
+        slot.output.clear();
+        slot.midiInput = &midi;
+        slot.midiOutput.clear();
+    }
+
+    void finishBlock (Slot& slot, AudioBuffer<SampleType>& buffer, MidiBuffer& midi)
+    {
+        for (int i = 0; i < buffer.getNumChannels(); ++i)
+            buffer.copyFrom (i, 0, slot.output, i, 0, buffer.getNumSamples());
+
+        midi.clear();
+        midi.addEvents (slot.midiOutput, 0, buffer.getNumSamples(), 0);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (OfflinePipeline)
+};
+
+//==============================================================================
+AudioProcessorGraph::Connection::Connection (const uint32 sourceNodeId_, const int sourceChannelIndex_,
+                                             const uint32 destNodeId_, const int destChannelIndex_) noexcept
+    : sourceNodeId (sourceNodeId_), sourceChannelIndex (sourceChannelIndex_),
+      destNodeId (destNodeId_), destChannelIndex (destChannelIndex_)
 {
-    buildRenderingSequence();
 }
 
 //==============================================================================
-void AudioProcessorGraph::prepareToPlay (double /*sampleRate*/, int estimatedSamplesPerBlock)
+AudioProcessorGraph::NodeTimingStats::NodeTimingStats() noexcept
 {
-    currentAudioInputBuffer = nullptr;
-    currentAudioOutputBuffer.setSize (jmax (1, getNumOutputChannels()), estimatedSamplesPerBlock);
-    currentMidiInputBuffer = nullptr;
-    currentMidiOutputBuffer.clear();
-
-    clearRenderingSequence();
-    buildRenderingSequence();
 }
 
-void AudioProcessorGraph::releaseResources()
+void AudioProcessorGraph::NodeTimingStats::addCall (const double microsecondsTaken) noexcept
 {
-    for (int i = 0; i < nodes.size(); ++i)
-        nodes.getUnchecked(i)->unprepare();
+    const int microseconds = jmax (0, roundToInt (microsecondsTaken));
 
-    renderingBuffers.setSize (1, 1);
-    midiBuffers.clear();
+    ++numCalls;
+    totalNanoseconds += (int64) jmax (0.0, microsecondsTaken * 1000.0);
 
-    currentAudioInputBuffer = nullptr;
-    currentAudioOutputBuffer.setSize (1, 1);
-    currentMidiInputBuffer = nullptr;
-    currentMidiOutputBuffer.clear();
+    if (microseconds > maxMicroseconds.get())
+        maxMicroseconds = microseconds;
+
+    // bin n holds the calls that took up to 2^(n/4) microseconds
+    int bin = 0;
+
+    if (microsecondsTaken > 1.0)
+        bin = jmin ((int) numHistogramBins - 1, (int) std::ceil (4.0 * std::log (microsecondsTaken) / std::log (2.0)));
+
+    ++(histogram [bin]);
 }
 
-void AudioProcessorGraph::reset()
+void AudioProcessorGraph::NodeTimingStats::reset() noexcept
 {
-    const ScopedLock sl (getCallbackLock());
+    numCalls = 0;
+    maxMicroseconds = 0;
+    totalNanoseconds = 0;
 
-    for (int i = 0; i < nodes.size(); ++i)
-        nodes.getUnchecked(i)->getProcessor()->reset();
+    for (int i = 0; i < numHistogramBins; ++i)
+        histogram[i] = 0;
 }
 
-void AudioProcessorGraph::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
+double AudioProcessorGraph::NodeTimingStats::getAverageMicroseconds() const noexcept
 {
-    const int numSamples = buffer.getNumSamples();
+    const int num = numCalls.get();
+    return num > 0 ? totalNanoseconds.get() / (1000.0 * num) : 0.0;
+}
 
-    currentAudioInputBuffer = &buffer;
-    currentAudioOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples);
-    currentAudioOutputBuffer.clear();
-    currentMidiInputBuffer = &midiMessages;
-    currentMidiOutputBuffer.clear();
+double AudioProcessorGraph::NodeTimingStats::getPercentileMicroseconds (const double proportion) const noexcept
+{
+    int total = 0;
+
+    for (int i = 0; i < numHistogramBins; ++i)
+        total += histogram[i].get();
 
-    for (int i = 0; i < renderingOps.size(); ++i)
+    if (total == 0)
+        return 0.0;
+
+    const int target = jmax (1, (int) std::ceil (jlimit (0.0, 1.0, proportion) * total));
+    int count = 0;
+
+    for (int i = 0; i < numHistogramBins; ++i)
     {
-        GraphRenderingOps::AudioGraphRenderingOp* const op
-            = (GraphRenderingOps::AudioGraphRenderingOp*) renderingOps.getUnchecked(i);
+        count += histogram[i].get();
 
-        op->perform (renderingBuffers, midiBuffers, numSamples);
+        // (the top of the bin is an over-estimate, so it's limited to the slowest call seen)
+        if (count >= target)
+            return jmin (std::pow (2.0, i / 4.0), jmax (1.0, getMaxMicroseconds()));
     }
 
-    for (int i = 0; i < buffer.getNumChannels(); ++i)
-        buffer.copyFrom (i, 0, currentAudioOutputBuffer, i, 0, numSamples);
+    return getMaxMicroseconds();
+}
 
-    midiMessages.clear();
-    midiMessages.addEvents (currentMidiOutputBuffer, 0, buffer.getNumSamples(), 0);
+int AudioProcessorGraph::NodeTimingStats::getHistogramCount (const int binIndex) const noexcept
+{
+    return isPositiveAndBelow (binIndex, (int) numHistogramBins) ? histogram [binIndex].get() : 0;
 }
 
-const String AudioProcessorGraph::getInputChannelName (int channelIndex) const
+//==============================================================================
+AudioProcessorGraph::Node::Node (const uint32 nodeId_, AudioProcessor* const processor_) noexcept
+    : nodeId (nodeId_),
+      processor (processor_),
+      isPrepared (false)
 {
-    return "Input " + String (channelIndex + 1);
+    jassert (processor != nullptr);
 }
 
-const String AudioProcessorGraph::getOutputChannelName (int channelIndex) const
+void AudioProcessorGraph::Node::prepare (const double sampleRate, const int blockSize,
+                                         AudioProcessorGraph* const graph)
 {
-    return "Output " + String (channelIndex + 1);
-}
+    if (! isPrepared)
+    {
+        isPrepared = true;
+        setParentGraph (graph);
 
-bool AudioProcessorGraph::isInputChannelStereoPair (int /*index*/) const    { return true; }
-bool AudioProcessorGraph::isOutputChannelStereoPair (int /*index*/) const   { return true; }
-bool AudioProcessorGraph::silenceInProducesSilenceOut() const               { return false; }
-double AudioProcessorGraph::getTailLengthSeconds() const                    { return 0; }
-bool AudioProcessorGraph::acceptsMidi() const   { return true; }
-bool AudioProcessorGraph::producesMidi() const  { return true; }
-void AudioProcessorGraph::getStateInformation (juce::MemoryBlock& /*destData*/)   {}
-void AudioProcessorGraph::setStateInformation (const void* /*data*/, int /*sizeInBytes*/)   {}
+        processor->setProcessingPrecision (graph->getProcessingPrecision());
+        processor->setPlayConfigDetails (processor->getNumInputChannels(),
+                                         processor->getNumOutputChannels(),
+                                         sampleRate, blockSize);
 
+        processor->prepareToPlay (sampleRate, blockSize);
+    }
+}
 
-//==============================================================================
-AudioProcessorGraph::AudioGraphIOProcessor::AudioGraphIOProcessor (const IODeviceType type_)
-    : type (type_),
-      graph (nullptr)
+void AudioProcessorGraph::Node::unprepare()
 {
+    if (isPrepared)
+    {
+        isPrepared = false;
+        processor->releaseResources();
+    }
 }
 
-AudioProcessorGraph::AudioGraphIOProcessor::~AudioGraphIOProcessor()
+void AudioProcessorGraph::Node::setParentGraph (AudioProcessorGraph* const graph) const
 {
+    if (AudioProcessorGraph::AudioGraphIOProcessor* const ioProc
+            = dynamic_cast <AudioProcessorGraph::AudioGraphIOProcessor*> (processor.get()))
+        ioProc->setParentGraph (graph);
 }
 
-const String AudioProcessorGraph::AudioGraphIOProcessor::getName() const
+//==============================================================================
+AudioProcessorGraph::AudioProcessorGraph()
+    : lastNodeId (0),
+      renderingBuffers (1, 1),
+      doubleRenderingBuffers (1, 1),
+      numRenderingBuffersInUse (1),
+      currentAudioInputBuffer (nullptr),
+      currentAudioOutputBuffer (1, 1),
+      currentDoubleAudioInputBuffer (nullptr),
+      currentDoubleAudioOutputBuffer (1, 1),
+      currentMidiInputBuffer (nullptr),
+      activeOfflinePipeline (nullptr)
 {
-    switch (type)
-    {
-        case audioOutputNode:   return "Audio Output";
-        case audioInputNode:    return "Audio Input";
-        case midiOutputNode:    return "Midi Output";
-        case midiInputNode:     return "Midi Input";
-        default:                break;
-    }
-
-    return String::empty;
+    silentChannels.calloc (1);
+    zerostruct (renderingSequenceStats);
 }
 
-void AudioProcessorGraph::AudioGraphIOProcessor::fillInPluginDescription (PluginDescription& d) const
+AudioProcessorGraph::~AudioProcessorGraph()
 {
-    d.name = getName();
-    d.uid = d.name.hashCode();
-    d.category = "I/O devices";
-    d.pluginFormatName = "Internal";
-    d.manufacturerName = "Raw Material Software";
-    d.version = "1.0";
-    d.isInstrument = false;
-
-    d.numInputChannels = getNumInputChannels();
-    if (type == audioOutputNode && graph != nullptr)
-        d.numInputChannels = graph->getNumInputChannels();
+    clearRenderingSequence();
+    clear();
+    parallelRenderer = nullptr;
+}
 
-    d.numOutputChannels = getNumOutputChannels();
-    if (type == audioInputNode && graph != nullptr)
-        d.numOutputChannels = graph->getNumOutputChannels();
+const String AudioProcessorGraph::getName() const
+{
+    return "Audio Graph";
 }
 
-void AudioProcessorGraph::AudioGraphIOProcessor::prepareToPlay (double, int)
+//==============================================================================
+void AudioProcessorGraph::clear()
 {
-    jassert (graph != nullptr);
+    nodes.clear();
+    nodeLookup.clear();
+    connections.clear();
+    triggerAsyncUpdate();
 }
 
-void AudioProcessorGraph::AudioGraphIOProcessor::releaseResources()
+AudioProcessorGraph::Node* AudioProcessorGraph::getNodeForId (const uint32 nodeId) const
 {
+    return nodeLookup [(int) nodeId];
 }
 
-void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioSampleBuffer& buffer,
-                                                               MidiBuffer& midiMessages)
+AudioProcessorGraph::Node* AudioProcessorGraph::addNode (AudioProcessor* const newProcessor, uint32 nodeId)
 {
-    jassert (graph != nullptr);
+    if (newProcessor == nullptr || newProcessor == this)
+    {
+        jassertfalse;
+        return nullptr;
+    }
 
-    switch (type)
+    for (int i = nodes.size(); --i >= 0;)
     {
-        case audioOutputNode:
+        if (nodes.getUnchecked(i)->getProcessor() == newProcessor)
         {
-            for (int i = jmin (graph->currentAudioOutputBuffer.getNumChannels(),
-                               buffer.getNumChannels()); --i >= 0;)
-            {
-                graph->currentAudioOutputBuffer.addFrom (i, 0, buffer, i, 0, buffer.getNumSamples());
-            }
-
-            break;
+            jassertfalse; // Cannot add the same object to the graph twice!
+            return nullptr;
         }
+    }
 
-        case audioInputNode:
-        {
-            for (int i = jmin (graph->currentAudioInputBuffer->getNumChannels(),
-                               buffer.getNumChannels()); --i >= 0;)
-            {
-                buffer.copyFrom (i, 0, *graph->currentAudioInputBuffer, i, 0, buffer.getNumSamples());
-            }
+    if (nodeId == 0)
+    {
+        nodeId = ++lastNodeId;
+    }
+    else
+    {
+        // you can't add a node with an id that already exists in the graph..
+        jassert (getNodeForId (nodeId) == nullptr);
+        removeNode (nodeId);
 
-            break;
-        }
+        if (nodeId > lastNodeId)
+            lastNodeId = nodeId;
+    }
 
-        case midiOutputNode:
-            graph->currentMidiOutputBuffer.addEvents (midiMessages, 0, buffer.getNumSamples(), 0);
-            break;
+    newProcessor->setPlayHead (getPlayHead());
+    newProcessor->setNonRealtime (isNonRealtime());
 
-        case midiInputNode:
-            midiMessages.addEvents (*graph->currentMidiInputBuffer, 0, buffer.getNumSamples(), 0);
-            break;
+    Node* const n = new Node (nodeId, newProcessor);
+    nodes.add (n);
+    nodeLookup.set ((int) nodeId, n);
+    triggerAsyncUpdate();
 
-        default:
-            break;
-    }
+    n->setParentGraph (this);
+    return n;
 }
 
-bool AudioProcessorGraph::AudioGraphIOProcessor::silenceInProducesSilenceOut() const
+bool AudioProcessorGraph::removeNode (const uint32 nodeId)
 {
-    return isOutput();
-}
+    disconnectNode (nodeId);
 
-double AudioProcessorGraph::AudioGraphIOProcessor::getTailLengthSeconds() const
-{
-    return 0;
-}
+    for (int i = nodes.size(); --i >= 0;)
+    {
+        if (nodes.getUnchecked(i)->nodeId == nodeId)
+        {
+            nodes.getUnchecked(i)->setParentGraph (nullptr);
+            nodeLookup.remove ((int) nodeId);
+            nodes.remove (i);
+            triggerAsyncUpdate();
 
-bool AudioProcessorGraph::AudioGraphIOProcessor::acceptsMidi() const
-{
-    return type == midiOutputNode;
+            return true;
+        }
+    }
+
+    return false;
 }
 
-bool AudioProcessorGraph::AudioGraphIOProcessor::producesMidi() const
+//==============================================================================
+const AudioProcessorGraph::Connection* AudioProcessorGraph::getConnectionBetween (const uint32 sourceNodeId,
+                                                                                  const int sourceChannelIndex,
+                                                                                  const uint32 destNodeId,
+                                                                                  const int destChannelIndex) const
 {
-    return type == midiInputNode;
+    const Connection c (sourceNodeId, sourceChannelIndex, destNodeId, destChannelIndex);
+    GraphRenderingOps::ConnectionSorter sorter;
+    return connections [connections.indexOfSorted (sorter, &c)];
 }
 
-const String AudioProcessorGraph::AudioGraphIOProcessor::getInputChannelName (int channelIndex) const
+bool AudioProcessorGraph::isConnected (const uint32 possibleSourceNodeId,
+                                       const uint32 possibleDestNodeId) const
 {
-    switch (type)
+    if (const Node* const source = getNodeForId (possibleSourceNodeId))
     {
-        case audioOutputNode:   return "Output " + String (channelIndex + 1);
-        case midiOutputNode:    return "Midi Output";
-        default:                break;
+        for (int i = source->outputs.size(); --i >= 0;)
+            if (source->outputs.getUnchecked(i)->destNodeId == possibleDestNodeId)
+                return true;
     }
 
-    return String::empty;
+    return false;
 }
 
-const String AudioProcessorGraph::AudioGraphIOProcessor::getOutputChannelName (int channelIndex) const
+bool AudioProcessorGraph::canConnect (const uint32 sourceNodeId,
+                                      const int sourceChannelIndex,
+                                      const uint32 destNodeId,
+                                      const int destChannelIndex) const
 {
-    switch (type)
-    {
-        case audioInputNode:    return "Input " + String (channelIndex + 1);
-        case midiInputNode:     return "Midi Input";
-        default:                break;
-    }
+    if (sourceChannelIndex < 0
+         || destChannelIndex < 0
+         || sourceNodeId == destNodeId
+         || (destChannelIndex == midiChannelIndex) != (sourceChannelIndex == midiChannelIndex))
+        return false;
 
-    return String::empty;
-}
+    const Node* const source = getNodeForId (sourceNodeId);
 
-bool AudioProcessorGraph::AudioGraphIOProcessor::isInputChannelStereoPair (int /*index*/) const
-{
-    return type == audioInputNode || type == audioOutputNode;
+    if (source == nullptr
+         || (sourceChannelIndex != midiChannelIndex && sourceChannelIndex >= source->processor->getNumOutputChannels())
+         || (sourceChannelIndex == midiChannelIndex && ! source->processor->producesMidi()))
+        return false;
+
+    const Node* const dest = getNodeForId (destNodeId);
+
+    if (dest == nullptr
+         || (destChannelIndex != midiChannelIndex && destChannelIndex >= dest->processor->getNumInputChannels())
+         || (destChannelIndex == midiChannelIndex && ! dest->processor->acceptsMidi()))
+        return false;
+
+    return getConnectionBetween (sourceNodeId, sourceChannelIndex,
+                                 destNodeId, destChannelIndex) == nullptr;
 }
 
-bool AudioProcessorGraph::AudioGraphIOProcessor::isOutputChannelStereoPair (int index) const
+bool AudioProcessorGraph::addConnection (const uint32 sourceNodeId,
+                                         const int sourceChannelIndex,
+                                         const uint32 destNodeId,
+                                         const int destChannelIndex)
 {
-    return isInputChannelStereoPair (index);
-}
+    if (! canConnect (sourceNodeId, sourceChannelIndex, destNodeId, destChannelIndex))
+        return false;
 
-bool AudioProcessorGraph::AudioGraphIOProcessor::isInput() const   { return type == audioInputNode  || type == midiInputNode; }
-bool AudioProcessorGraph::AudioGraphIOProcessor::isOutput() const  { return type == audioOutputNode || type == midiOutputNode; }
+    Connection* const c = new Connection (sourceNodeId, sourceChannelIndex,
+                                          destNodeId, destChannelIndex);
 
-bool AudioProcessorGraph::AudioGraphIOProcessor::hasEditor() const                  { return false; }
-AudioProcessorEditor* AudioProcessorGraph::AudioGraphIOProcessor::createEditor()    { return nullptr; }
+    GraphRenderingOps::ConnectionSorter sorter;
+    connections.addSorted (sorter, c);
 
-int AudioProcessorGraph::AudioGraphIOProcessor::getNumParameters()                  { return 0; }
-const String AudioProcessorGraph::AudioGraphIOProcessor::getParameterName (int)     { return String::empty; }
+    getNodeForId (sourceNodeId)->outputs.add (c);
+    getNodeForId (destNodeId)->inputs.add (c);
 
-float AudioProcessorGraph::AudioGraphIOProcessor::getParameter (int)                { return 0.0f; }
-const String AudioProcessorGraph::AudioGraphIOProcessor::getParameterText (int)     { return String::empty; }
-void AudioProcessorGraph::AudioGraphIOProcessor::setParameter (int, float)          { }
+    triggerAsyncUpdate();
+    return true;
+}
 
-int AudioProcessorGraph::AudioGraphIOProcessor::getNumPrograms()                    { return 0; }
-int AudioProcessorGraph::AudioGraphIOProcessor::getCurrentProgram()                 { return 0; }
-void AudioProcessorGraph::AudioGraphIOProcessor::setCurrentProgram (int)            { }
+void AudioProcessorGraph::removeConnection (const int index)
+{
+    if (const Connection* const c = connections [index])
+    {
+        if (Node* const source = getNodeForId (c->sourceNodeId))
+            source->outputs.removeFirstMatchingValue (c);
 
-const String AudioProcessorGraph::AudioGraphIOProcessor::getProgramName (int)       { return String::empty; }
-void AudioProcessorGraph::AudioGraphIOProcessor::changeProgramName (int, const String&) {}
+        if (Node* const dest = getNodeForId (c->destNodeId))
+            dest->inputs.removeFirstMatchingValue (c);
 
-void AudioProcessorGraph::AudioGraphIOProcessor::getStateInformation (juce::MemoryBlock&) {}
-void AudioProcessorGraph::AudioGraphIOProcessor::setStateInformation (const void*, int) {}
+        connections.remove (index);
+        triggerAsyncUpdate();
+    }
+}
 
-void AudioProcessorGraph::AudioGraphIOProcessor::setParentGraph (AudioProcessorGraph* const newGraph)
+bool AudioProcessorGraph::removeConnection (const uint32 sourceNodeId, const int sourceChannelIndex,
+                                            const uint32 destNodeId, const int destChannelIndex)
 {
-    graph = newGraph;
+    const Connection c (sourceNodeId, sourceChannelIndex, destNodeId, destChannelIndex);
+    GraphRenderingOps::ConnectionSorter sorter;
+    const int index = connections.indexOfSorted (sorter, &c);
 
-    if (graph != nullptr)
+    if (index < 0)
+        return false;
+
+    removeConnection (index);
+    return true;
+}
+
+bool AudioProcessorGraph::disconnectNode (const uint32 nodeId)
+{
+    const Node* const node = getNodeForId (nodeId);
+
+    if (node == nullptr || (node->inputs.size() == 0 && node->outputs.size() == 0))
+        return false;
+
+    Array<const Connection*> attached (node->inputs);
+    attached.addArray (node->outputs);
+
+    GraphRenderingOps::ConnectionSorter sorter;
+
+    for (int i = attached.size(); --i >= 0;)
     {
-        setPlayConfigDetails (type == audioOutputNode ? graph->getNumOutputChannels() : 0,
-                              type == audioInputNode ? graph->getNumInputChannels() : 0,
-                              getSampleRate(),
-                              getBlockSize());
+        removeConnection (connections.indexOfSorted (sorter, attached.getUnchecked(i)));
+    }
 
-        updateHostDisplay();
+    return true;
+}
+
+bool AudioProcessorGraph::isConnectionLegal (const Connection* const c) const
+{
+    jassert (c != nullptr);
+
+    const Node* const source = getNodeForId (c->sourceNodeId);
+    const Node* const dest   = getNodeForId (c->destNodeId);
+
+    return source != nullptr
+        && dest != nullptr
+        && (c->sourceChannelIndex != midiChannelIndex ? isPositiveAndBelow (c->sourceChannelIndex, source->processor->getNumOutputChannels())
+                                                      : source->processor->producesMidi())
+        && (c->destChannelIndex   != midiChannelIndex ? isPositiveAndBelow (c->destChannelIndex, dest->processor->getNumInputChannels())
+                                                      : dest->processor->acceptsMidi());
+}
+
+bool AudioProcessorGraph::removeIllegalConnections()
+{
+    bool doneAnything = false;
+
+    for (int i = connections.size(); --i >= 0;)
+    {
+        if (! isConnectionLegal (connections.getUnchecked(i)))
+        {
+            removeConnection (i);
+            doneAnything = true;
+        }
+    }
+
+    return doneAnything;
+}
+
+//==============================================================================
+static void deleteRenderOpArray (Array<void*>& ops)
+{
+    for (int i = ops.size(); --i >= 0;)
+        delete static_cast<GraphRenderingOps::AudioGraphRenderingOp*> (ops.getUnchecked(i));
+}
+
+void AudioProcessorGraph::clearRenderingSequence()
+{
+    Array<void*> oldOps;
+
+    ScopedPointer<ParallelRenderer::Schedule> oldSchedule;
+    ScopedPointer<LatencyCompensator> oldCompensator;
+
+    {
+        const ScopedLock sl (getCallbackLock());
+        renderingOps.swapWithArray (oldOps);
+        oldCompensator = latencyCompensator.release();
+
+        if (parallelRenderer != nullptr)
+            parallelRenderer->swapSchedule (oldSchedule);
+    }
+
+    deleteRenderOpArray (oldOps);
+}
+
+//==============================================================================
+void AudioProcessorGraph::setNumRenderingThreads (int numThreads)
+{
+    numThreads = jmax (0, numThreads);
+
+    if (numThreads != getNumRenderingThreads())
+    {
+        ScopedPointer<ParallelRenderer> newRenderer;
+
+        if (numThreads > 0)
+            newRenderer = new ParallelRenderer (numThreads);
+
+        {
+            const ScopedLock sl (getCallbackLock());
+            parallelRenderer.swapWith (newRenderer);
+        }
+
+        // the buffers need to be re-allocated to suit the new mode..
+        triggerAsyncUpdate();
+    }
+}
+
+int AudioProcessorGraph::getNumRenderingThreads() const noexcept
+{
+    return parallelRenderer != nullptr ? parallelRenderer->getNumThreads() : 0;
+}
+
+void AudioProcessorGraph::setNodeProfilingEnabled (const bool shouldBeEnabled) noexcept
+{
+    nodeProfilingEnabled = shouldBeEnabled ? 1 : 0;
+}
+
+void AudioProcessorGraph::resetNodeTimingStats()
+{
+    for (int i = nodes.size(); --i >= 0;)
+        nodes.getUnchecked(i)->getTimingStats().reset();
+}
+
+void AudioProcessorGraph::buildRenderingSequence()
+{
+    Array<void*> newRenderingOps;
+    ScopedPointer<LatencyCompensator> newCompensator;
+    int numRenderingBuffersNeeded = 2;
+    int numMidiBuffersNeeded = 1;
+
+    {
+        MessageManagerLock mml;
+
+        Array<void*> orderedNodes;
+
+        {
+            GraphRenderingOps::ConnectionLookupTable table (connections);
+
+            for (int i = 0; i < nodes.size(); ++i)
+            {
+                Node* const node = nodes.getUnchecked(i);
+
+                node->prepare (getSampleRate(), getBlockSize(), this);
+
+                int j = 0;
+                for (; j < orderedNodes.size(); ++j)
+                    if (table.isAnInputTo (node->nodeId, ((Node*) orderedNodes.getUnchecked(j))->nodeId))
+                      break;
+
+                orderedNodes.insert (j, node);
+            }
+        }
+
+        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newRenderingOps,
+                                                                     parallelRenderer == nullptr);
+
+        numRenderingBuffersNeeded = calculator.getNumBuffersNeeded();
+        numMidiBuffersNeeded = calculator.getNumMidiBuffersNeeded();
+        renderingSequenceStats = calculator.getStats();
+        newCompensator = new LatencyCompensator (*this, calculator);
+    }
+
+    ScopedPointer<ParallelRenderer::Schedule> newSchedule;
+
+    if (parallelRenderer != nullptr)
+        newSchedule = ParallelRenderer::createSchedule (newRenderingOps);
+
+    {
+        // swap over to the new rendering sequence..
+        const ScopedLock sl (getCallbackLock());
+
+        // (avoid reallocating if the existing buffers are already big enough, and only
+        // keep the set of buffers that matches the precision that we're rendering at)
+        if (isUsingDoublePrecision())
+        {
+            doubleRenderingBuffers.setSize (numRenderingBuffersNeeded, getBlockSize(), false, false, true);
+            doubleRenderingBuffers.clear();
+            renderingBuffers.setSize (1, 1);
+        }
+        else
+        {
+            renderingBuffers.setSize (numRenderingBuffersNeeded, getBlockSize(), false, false, true);
+            renderingBuffers.clear();
+            doubleRenderingBuffers.setSize (1, 1);
+        }
+
+        numRenderingBuffersInUse = jmax (1, numRenderingBuffersNeeded);
+        silentChannels.realloc ((size_t) numRenderingBuffersInUse);
+
+        for (int i = midiBuffers.size(); --i >= 0;)
+            midiBuffers.getUnchecked(i)->clear();
+
+        while (midiBuffers.size() < numMidiBuffersNeeded)
+        {
+            MidiBuffer* const m = new MidiBuffer();
+            m->ensureSize (GraphRenderingOps::initialMidiBufferSize);
+            midiBuffers.add (m);
+        }
+
+        renderingOps.swapWithArray (newRenderingOps);
+        latencyCompensator.swapWith (newCompensator);
+
+        if (parallelRenderer != nullptr)
+            parallelRenderer->swapSchedule (newSchedule);
+    }
+
+    // delete the old ones..
+    deleteRenderOpArray (newRenderingOps);
+}
+
+void AudioProcessorGraph::handleAsyncUpdate()
+{
+    buildRenderingSequence();
+}
+
+//==============================================================================
+void AudioProcessorGraph::prepareToPlay (double /*sampleRate*/, int estimatedSamplesPerBlock)
+{
+    currentAudioInputBuffer = nullptr;
+    currentDoubleAudioInputBuffer = nullptr;
+
+    if (isUsingDoublePrecision())
+    {
+        currentDoubleAudioOutputBuffer.setSize (jmax (1, getNumOutputChannels()), estimatedSamplesPerBlock);
+        currentAudioOutputBuffer.setSize (1, 1);
+    }
+    else
+    {
+        currentAudioOutputBuffer.setSize (jmax (1, getNumOutputChannels()), estimatedSamplesPerBlock);
+        currentDoubleAudioOutputBuffer.setSize (1, 1);
+    }
+
+    currentMidiInputBuffer = nullptr;
+    currentMidiOutputBuffer.clear();
+    currentMidiOutputBuffer.ensureSize (GraphRenderingOps::initialMidiBufferSize);
+
+    clearRenderingSequence();
+    buildRenderingSequence();
+}
+
+void AudioProcessorGraph::releaseResources()
+{
+    for (int i = 0; i < nodes.size(); ++i)
+        nodes.getUnchecked(i)->unprepare();
+
+    renderingBuffers.setSize (1, 1);
+    doubleRenderingBuffers.setSize (1, 1);
+    midiBuffers.clear();
+
+    currentAudioInputBuffer = nullptr;
+    currentAudioOutputBuffer.setSize (1, 1);
+    currentDoubleAudioInputBuffer = nullptr;
+    currentDoubleAudioOutputBuffer.setSize (1, 1);
+    currentMidiInputBuffer = nullptr;
+    currentMidiOutputBuffer.clear();
+}
+
+void AudioProcessorGraph::reset()
+{
+    const ScopedLock sl (getCallbackLock());
+
+    for (int i = 0; i < nodes.size(); ++i)
+        nodes.getUnchecked(i)->getProcessor()->reset();
+}
+
+void AudioProcessorGraph::setNonRealtime (const bool isProcessingNonRealtime) noexcept
+{
+    AudioProcessor::setNonRealtime (isProcessingNonRealtime);
+
+    const ScopedLock sl (getCallbackLock());
+
+    for (int i = 0; i < nodes.size(); ++i)
+        nodes.getUnchecked(i)->getProcessor()->setNonRealtime (isProcessingNonRealtime);
+}
+
+void AudioProcessorGraph::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
+{
+    // If you've put the graph into double-precision mode, it needs to be called with doubles!
+    jassert (! isUsingDoublePrecision());
+
+    renderBlock (buffer, midiMessages, renderingBuffers, currentAudioInputBuffer, currentAudioOutputBuffer);
+}
+
+void AudioProcessorGraph::processBlock (AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
+{
+    // The graph only allocates its double-precision buffers when it's prepared in
+    // double-precision mode, so call setProcessingPrecision() before prepareToPlay()!
+    jassert (isUsingDoublePrecision());
+
+    renderBlock (buffer, midiMessages, doubleRenderingBuffers, currentDoubleAudioInputBuffer, currentDoubleAudioOutputBuffer);
+}
+
+bool AudioProcessorGraph::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <typename SampleType>
+void AudioProcessorGraph::renderBlock (AudioBuffer<SampleType>& buffer, MidiBuffer& midiMessages,
+                                       AudioBuffer<SampleType>& sharedBuffers,
+                                       AudioBuffer<SampleType>*& currentInput, AudioBuffer<SampleType>& currentOutput)
+{
+    const int numSamples = buffer.getNumSamples();
+
+    if (sharedBuffers.getNumChannels() < numRenderingBuffersInUse)
+    {
+        // the current rendering sequence was built for the other precision..
+        buffer.clear();
+        midiMessages.clear();
+        return;
+    }
+
+    currentInput = &buffer;
+    currentOutput.setSize (jmax (1, buffer.getNumChannels()), numSamples);
+    currentOutput.clear();
+    currentMidiInputBuffer = &midiMessages;
+    currentMidiOutputBuffer.clear();
+
+    if (latencyCompensator != nullptr)
+        latencyCompensator->update();
+
+    // (channel 0 is the shared empty buffer, which is always silent)
+    zeromem (silentChannels, sizeof (bool) * (size_t) numRenderingBuffersInUse);
+    silentChannels[0] = true;
+
+    // (fetched here, before any work is shared out, so that the ops never touch the buffer object itself)
+    SampleType* const* const sharedChannels = sharedBuffers.getArrayOfChannels();
+
+    if (parallelRenderer == nullptr
+         || ! parallelRenderer->perform (sharedChannels, midiBuffers, silentChannels, numSamples))
+    {
+        for (int i = 0; i < renderingOps.size(); ++i)
+        {
+            GraphRenderingOps::AudioGraphRenderingOp* const op
+                = (GraphRenderingOps::AudioGraphRenderingOp*) renderingOps.getUnchecked(i);
+
+            op->perform (sharedChannels, midiBuffers, silentChannels, numSamples);
+        }
     }
+
+    for (int i = 0; i < buffer.getNumChannels(); ++i)
+        buffer.copyFrom (i, 0, currentOutput, i, 0, numSamples);
+
+    midiMessages.clear();
+    midiMessages.addEvents (currentMidiOutputBuffer, 0, buffer.getNumSamples(), 0);
 }
+
+void AudioProcessorGraph::processBlocksOffline (const Array<AudioSampleBuffer*>& audioBlocks,
+                                                const Array<MidiBuffer*>& midiBlocks)
+{
+    // If you've put the graph into double-precision mode, it needs to be called with doubles!
+    jassert (! isUsingDoublePrecision());
+
+    renderBlocksOffline (audioBlocks, midiBlocks, renderingBuffers, currentAudioInputBuffer, currentAudioOutputBuffer);
+}
+
+void AudioProcessorGraph::processBlocksOffline (const Array<AudioBuffer<double>*>& audioBlocks,
+                                                const Array<MidiBuffer*>& midiBlocks)
+{
+    jassert (isUsingDoublePrecision());
+
+    renderBlocksOffline (audioBlocks, midiBlocks, doubleRenderingBuffers, currentDoubleAudioInputBuffer, currentDoubleAudioOutputBuffer);
+}
+
+template <typename SampleType>
+void AudioProcessorGraph::renderBlocksOffline (const Array<AudioBuffer<SampleType>*>& audioBlocks,
+                                               const Array<MidiBuffer*>& midiBlocks,
+                                               AudioBuffer<SampleType>& sharedBuffers,
+                                               AudioBuffer<SampleType>*& currentInput, AudioBuffer<SampleType>& currentOutput)
+{
+    // each block of audio needs a midi buffer to go with it!
+    jassert (audioBlocks.size() == midiBlocks.size());
+
+    const ScopedLock sl (getCallbackLock());
+
+    if (audioBlocks.size() > 1
+         && audioBlocks.size() == midiBlocks.size()
+         && getNumRenderingThreads() > 0
+         && sharedBuffers.getNumChannels() >= numRenderingBuffersInUse)
+    {
+        if (latencyCompensator != nullptr)
+            latencyCompensator->update();
+
+        OfflinePipeline<SampleType> pipeline (*this, jmin (audioBlocks.size(), 1 + getNumRenderingThreads()));
+
+        if (pipeline.getNumStages() > 1)
+        {
+            activeOfflinePipeline = &pipeline;
+            pipeline.render (audioBlocks, midiBlocks);
+            activeOfflinePipeline = nullptr;
+            return;
+        }
+    }
+
+    for (int i = 0; i < jmin (audioBlocks.size(), midiBlocks.size()); ++i)
+        renderBlock (*audioBlocks.getUnchecked(i), *midiBlocks.getUnchecked(i),
+                     sharedBuffers, currentInput, currentOutput);
+}
+
+const String AudioProcessorGraph::getInputChannelName (int channelIndex) const
+{
+    return "Input " + String (channelIndex + 1);
+}
+
+const String AudioProcessorGraph::getOutputChannelName (int channelIndex) const
+{
+    return "Output " + String (channelIndex + 1);
+}
+
+bool AudioProcessorGraph::isInputChannelStereoPair (int /*index*/) const    { return true; }
+bool AudioProcessorGraph::isOutputChannelStereoPair (int /*index*/) const   { return true; }
+bool AudioProcessorGraph::silenceInProducesSilenceOut() const               { return false; }
+double AudioProcessorGraph::getTailLengthSeconds() const                    { return 0; }
+bool AudioProcessorGraph::acceptsMidi() const   { return true; }
+bool AudioProcessorGraph::producesMidi() const  { return true; }
+void AudioProcessorGraph::getStateInformation (juce::MemoryBlock& /*destData*/)   {}
+void AudioProcessorGraph::setStateInformation (const void* /*data*/, int /*sizeInBytes*/)   {}
+
+
+//==============================================================================
+AudioProcessorGraph::AudioGraphIOProcessor::AudioGraphIOProcessor (const IODeviceType type_)
+    : type (type_),
+      graph (nullptr)
+{
+}
+
+AudioProcessorGraph::AudioGraphIOProcessor::~AudioGraphIOProcessor()
+{
+}
+
+const String AudioProcessorGraph::AudioGraphIOProcessor::getName() const
+{
+    switch (type)
+    {
+        case audioOutputNode:   return "Audio Output";
+        case audioInputNode:    return "Audio Input";
+        case midiOutputNode:    return "Midi Output";
+        case midiInputNode:     return "Midi Input";
+        default:                break;
+    }
+
+    return String::empty;
+}
+
+void AudioProcessorGraph::AudioGraphIOProcessor::fillInPluginDescription (PluginDescription& d) const
+{
+    d.name = getName();
+    d.uid = d.name.hashCode();
+    d.category = "I/O devices";
+    d.pluginFormatName = "Internal";
+    d.manufacturerName = "Raw Material Software";
+    d.version = "1.0";
+    d.isInstrument = false;
+
+    d.numInputChannels = getNumInputChannels();
+    if (type == audioOutputNode && graph != nullptr)
+        d.numInputChannels = graph->getNumInputChannels();
+
+    d.numOutputChannels = getNumOutputChannels();
+    if (type == audioInputNode && graph != nullptr)
+        d.numOutputChannels = graph->getNumOutputChannels();
+}
+
+void AudioProcessorGraph::AudioGraphIOProcessor::prepareToPlay (double, int)
+{
+    jassert (graph != nullptr);
+}
+
+void AudioProcessorGraph::AudioGraphIOProcessor::releaseResources()
+{
+}
+
+void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioSampleBuffer& buffer,
+                                                               MidiBuffer& midiMessages)
+{
+    jassert (graph != nullptr);
+
+    AudioSampleBuffer* input = graph->currentAudioInputBuffer;
+    AudioSampleBuffer* output = &graph->currentAudioOutputBuffer;
+    MidiBuffer* midiInput = graph->currentMidiInputBuffer;
+    MidiBuffer* midiOutput = &graph->currentMidiOutputBuffer;
+
+    if (graph->activeOfflinePipeline != nullptr)
+        static_cast <OfflinePipeline<float>*> (graph->activeOfflinePipeline)
+            ->getIOBuffers (this, input, output, midiInput, midiOutput);
+
+    processAudio (buffer, midiMessages, input, *output, midiInput, *midiOutput);
+}
+
+void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioBuffer<double>& buffer,
+                                                               MidiBuffer& midiMessages)
+{
+    jassert (graph != nullptr);
+
+    AudioBuffer<double>* input = graph->currentDoubleAudioInputBuffer;
+    AudioBuffer<double>* output = &graph->currentDoubleAudioOutputBuffer;
+    MidiBuffer* midiInput = graph->currentMidiInputBuffer;
+    MidiBuffer* midiOutput = &graph->currentMidiOutputBuffer;
+
+    if (graph->activeOfflinePipeline != nullptr)
+        static_cast <OfflinePipeline<double>*> (graph->activeOfflinePipeline)
+            ->getIOBuffers (this, input, output, midiInput, midiOutput);
+
+    processAudio (buffer, midiMessages, input, *output, midiInput, *midiOutput);
+}
+
+bool AudioProcessorGraph::AudioGraphIOProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <typename SampleType>
+void AudioProcessorGraph::AudioGraphIOProcessor::processAudio (AudioBuffer<SampleType>& buffer, MidiBuffer& midiMessages,
+                                                               AudioBuffer<SampleType>* const graphInput,
+                                                               AudioBuffer<SampleType>& graphOutput,
+                                                               MidiBuffer* const graphMidiInput,
+                                                               MidiBuffer& graphMidiOutput)
+{
+    switch (type)
+    {
+        case audioOutputNode:
+        {
+            for (int i = jmin (graphOutput.getNumChannels(),
+                               buffer.getNumChannels()); --i >= 0;)
+            {
+                graphOutput.addFrom (i, 0, buffer, i, 0, buffer.getNumSamples());
+            }
+
+            break;
+        }
+
+        case audioInputNode:
+        {
+            for (int i = jmin (graphInput->getNumChannels(),
+                               buffer.getNumChannels()); --i >= 0;)
+            {
+                buffer.copyFrom (i, 0, *graphInput, i, 0, buffer.getNumSamples());
+            }
+
+            break;
+        }
+
+        case midiOutputNode:
+            graphMidiOutput.addEvents (midiMessages, 0, buffer.getNumSamples(), 0);
+            break;
+
+        case midiInputNode:
+            midiMessages.addEvents (*graphMidiInput, 0, buffer.getNumSamples(), 0);
+            break;
+
+        default:
+            break;
+    }
+}
+
+bool AudioProcessorGraph::AudioGraphIOProcessor::silenceInProducesSilenceOut() const
+{
+    return isOutput();
+}
+
+double AudioProcessorGraph::AudioGraphIOProcessor::getTailLengthSeconds() const
+{
+    return 0;
+}
+
+bool AudioProcessorGraph::AudioGraphIOProcessor::acceptsMidi() const
+{
+    return type == midiOutputNode;
+}
+
+bool AudioProcessorGraph::AudioGraphIOProcessor::producesMidi() const
+{
+    return type == midiInputNode;
+}
+
+const String AudioProcessorGraph::AudioGraphIOProcessor::getInputChannelName (int channelIndex) const
+{
+    switch (type)
+    {
+        case audioOutputNode:   return "Output " + String (channelIndex + 1);
+        case midiOutputNode:    return "Midi Output";
+        default:                break;
+    }
+
+    return String::empty;
+}
+
+const String AudioProcessorGraph::AudioGraphIOProcessor::getOutputChannelName (int channelIndex) const
+{
+    switch (type)
+    {
+        case audioInputNode:    return "Input " + String (channelIndex + 1);
+        case midiInputNode:     return "Midi Input";
+        default:                break;
+    }
+
+    return String::empty;
+}
+
+bool AudioProcessorGraph::AudioGraphIOProcessor::isInputChannelStereoPair (int /*index*/) const
+{
+    return type == audioInputNode || type == audioOutputNode;
+}
+
+bool AudioProcessorGraph::AudioGraphIOProcessor::isOutputChannelStereoPair (int index) const
+{
+    return isInputChannelStereoPair (index);
+}
+
+bool AudioProcessorGraph::AudioGraphIOProcessor::isInput() const   { return type == audioInputNode  || type == midiInputNode; }
+bool AudioProcessorGraph::AudioGraphIOProcessor::isOutput() const  { return type == audioOutputNode || type == midiOutputNode; }
+
+bool AudioProcessorGraph::AudioGraphIOProcessor::hasEditor() const                  { return false; }
+AudioProcessorEditor* AudioProcessorGraph::AudioGraphIOProcessor::createEditor()    { return nullptr; }
+
+int AudioProcessorGraph::AudioGraphIOProcessor::getNumParameters()                  { return 0; }
+const String AudioProcessorGraph::AudioGraphIOProcessor::getParameterName (int)     { return String::empty; }
+
+float AudioProcessorGraph::AudioGraphIOProcessor::getParameter (int)                { return 0.0f; }
+const String AudioProcessorGraph::AudioGraphIOProcessor::getParameterText (int)     { return String::empty; }
+void AudioProcessorGraph::AudioGraphIOProcessor::setParameter (int, float)          { }
+
+int AudioProcessorGraph::AudioGraphIOProcessor::getNumPrograms()                    { return 0; }
+int AudioProcessorGraph::AudioGraphIOProcessor::getCurrentProgram()                 { return 0; }
+void AudioProcessorGraph::AudioGraphIOProcessor::setCurrentProgram (int)            { }
+
+const String AudioProcessorGraph::AudioGraphIOProcessor::getProgramName (int)       { return String::empty; }
+void AudioProcessorGraph::AudioGraphIOProcessor::changeProgramName (int, const String&) {}
+
+void AudioProcessorGraph::AudioGraphIOProcessor::getStateInformation (juce::MemoryBlock&) {}
+void AudioProcessorGraph::AudioGraphIOProcessor::setStateInformation (const void*, int) {}
+
+void AudioProcessorGraph::AudioGraphIOProcessor::setParentGraph (AudioProcessorGraph* const newGraph)
+{
+    graph = newGraph;
+
+    if (graph != nullptr)
+    {
+        setPlayConfigDetails (type == audioOutputNode ? graph->getNumOutputChannels() : 0,
+                              type == audioInputNode ? graph->getNumInputChannels() : 0,
+                              getSampleRate(),
+                              getBlockSize());
+
+        updateHostDisplay();
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioProcessorGraphTests  : public UnitTest
+{
+public:
+    AudioProcessorGraphTests() : UnitTest ("AudioProcessorGraph") {}
+
+    class GainProcessor  : public AudioProcessor
+    {
+    public:
+        GainProcessor (const float gain_) : gain (gain_)    { setPlayConfigDetails (2, 2, 44100.0, 512); }
+
+        const String getName() const                        { return "Gain"; }
+        void prepareToPlay (double, int)                    {}
+        void releaseResources()                             {}
+
+        void processBlock (AudioSampleBuffer& buffer, MidiBuffer&)
+        {
+            buffer.applyGain (0, buffer.getNumSamples(), gain);
+        }
+
+        const String getInputChannelName (int) const        { return String::empty; }
+        const String getOutputChannelName (int) const       { return String::empty; }
+        bool isInputChannelStereoPair (int) const           { return true; }
+        bool isOutputChannelStereoPair (int) const          { return true; }
+        bool silenceInProducesSilenceOut() const            { return true; }
+        double getTailLengthSeconds() const                 { return 0; }
+        bool acceptsMidi() const                            { return false; }
+        bool producesMidi() const                           { return false; }
+        bool hasEditor() const                              { return false; }
+        AudioProcessorEditor* createEditor()                { return nullptr; }
+        int getNumParameters()                              { return 0; }
+        const String getParameterName (int)                 { return String::empty; }
+        float getParameter (int)                            { return 0; }
+        const String getParameterText (int)                 { return String::empty; }
+        void setParameter (int, float)                      {}
+        int getNumPrograms()                                { return 0; }
+        int getCurrentProgram()                             { return 0; }
+        void setCurrentProgram (int)                        {}
+        const String getProgramName (int)                   { return String::empty; }
+        void changeProgramName (int, const String&)         {}
+        void getStateInformation (juce::MemoryBlock&)       {}
+        void setStateInformation (const void*, int)         {}
+
+    private:
+        const float gain;
+    };
+
+    // A GainProcessor that delays its input, and reports the delay as its latency.
+    class DelayProcessor  : public GainProcessor
+    {
+    public:
+        DelayProcessor (const int delay_)
+            : GainProcessor (1.0f), delay (delay_), writeIndex (0), delayLine (2, 1024)
+        {
+            delayLine.clear();
+            setLatencySamples (delay);
+        }
+
+        void setDelay (const int newDelay)
+        {
+            delay = newDelay;
+            delayLine.clear();
+            setLatencySamples (delay);
+        }
+
+        void processBlock (AudioSampleBuffer& buffer, MidiBuffer&)
+        {
+            const int size = delayLine.getNumSamples();
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                for (int chan = 0; chan < 2; ++chan)
+                {
+                    float* const sample = buffer.getSampleData (chan, i);
+                    *delayLine.getSampleData (chan, writeIndex) = *sample;
+                    *sample = *delayLine.getSampleData (chan, (writeIndex + size - delay) % size);
+                }
+
+                writeIndex = (writeIndex + 1) % size;
+            }
+        }
+
+    private:
+        int delay, writeIndex;
+        AudioSampleBuffer delayLine;
+    };
+
+    // A GainProcessor that counts its callbacks, and has a tail.
+    class CountingProcessor  : public GainProcessor
+    {
+    public:
+        CountingProcessor (const double tailLength_, const bool silenceInProducesSilenceOut_)
+            : GainProcessor (1.0f), numCallbacks (0),
+              tailLength (tailLength_), silenceInSilenceOut (silenceInProducesSilenceOut_)
+        {
+        }
+
+        void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midi)
+        {
+            ++numCallbacks;
+            GainProcessor::processBlock (buffer, midi);
+        }
+
+        bool silenceInProducesSilenceOut() const        { return silenceInSilenceOut; }
+        double getTailLengthSeconds() const             { return tailLength; }
+
+        int numCallbacks;
+
+    private:
+        const double tailLength;
+        const bool silenceInSilenceOut;
+    };
+
+    // A GainProcessor that can also do its processing in double precision.
+    class DoubleGainProcessor  : public GainProcessor
+    {
+    public:
+        DoubleGainProcessor (const double gain_)
+            : GainProcessor ((float) gain_), numDoubleCallbacks (0), doubleGain (gain_)
+        {
+        }
+
+        bool supportsDoublePrecisionProcessing() const  { return true; }
+
+        void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midi)
+        {
+            GainProcessor::processBlock (buffer, midi);
+        }
+
+        void processBlock (AudioBuffer<double>& buffer, MidiBuffer&)
+        {
+            ++numDoubleCallbacks;
+            buffer.applyGain (0, buffer.getNumSamples(), doubleGain);
+        }
+
+        int numDoubleCallbacks;
+
+    private:
+        const double doubleGain;
+    };
+
+    // Creates numBranches parallel chains of two gain nodes between the graph's input and output,
+    // and returns the total gain that the graph should apply.
+    static float createGraph (AudioProcessorGraph& graph, const int numBranches)
+    {
+        typedef AudioProcessorGraph::AudioGraphIOProcessor IOProc;
+
+        graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+
+        const uint32 in  = graph.addNode (new IOProc (IOProc::audioInputNode))->nodeId;
+        const uint32 out = graph.addNode (new IOProc (IOProc::audioOutputNode))->nodeId;
+        float totalGain = 0;
+
+        for (int i = 0; i < numBranches; ++i)
+        {
+            const float gain1 = 0.5f + (i % 4) * 0.25f;
+            const float gain2 = 1.0f / (1 + i % 3);
+
+            const uint32 n1 = graph.addNode (new GainProcessor (gain1))->nodeId;
+            const uint32 n2 = graph.addNode (new GainProcessor (gain2))->nodeId;
+
+            for (int chan = 0; chan < 2; ++chan)
+            {
+                graph.addConnection (in, chan, n1, chan);
+                graph.addConnection (n1, chan, n2, chan);
+                graph.addConnection (n2, chan, out, chan);
+            }
+
+            totalGain += gain1 * gain2;
+        }
+
+        return totalGain;
+    }
+
+    void testRendering (const int numThreads)
+    {
+        AudioProcessorGraph graph;
+        const float expectedGain = createGraph (graph, 8);
+
+        graph.setNumRenderingThreads (numThreads);
+        expectEquals (graph.getNumRenderingThreads(), numThreads);
+        graph.prepareToPlay (44100.0, 512);
+
+        AudioSampleBuffer buffer (2, 512);
+        MidiBuffer midi;
+
+        for (int block = 0; block < 10; ++block)
+        {
+            for (int chan = 0; chan < 2; ++chan)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    *buffer.getSampleData (chan, i) = (float) std::sin ((block * 512 + i) * 0.01 + chan);
+
+            graph.processBlock (buffer, midi);
+
+            bool ok = true;
+
+            for (int chan = 0; chan < 2; ++chan)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    ok = ok && std::abs (*buffer.getSampleData (chan, i)
+                                           - expectedGain * (float) std::sin ((block * 512 + i) * 0.01 + chan)) < 0.0001f;
+
+            expect (ok, "rendered output was incorrect");
+        }
+
+        graph.releaseResources();
+    }
+
+    static double getTestSignal (const int block, const int sample, const int chan)
+    {
+        return std::sin ((block * 512 + sample) * 0.01 + chan);
+    }
+
+    void testDoublePrecision (const int numThreads)
+    {
+        typedef AudioProcessorGraph::AudioGraphIOProcessor IOProc;
+        AudioBuffer<double> buffer (2, 512);
+        MidiBuffer midi;
+
+        {
+            // processors that can only handle floats get their audio converted..
+            AudioProcessorGraph graph;
+            graph.setProcessingPrecision (AudioProcessor::doublePrecision);
+            graph.setNumRenderingThreads (numThreads);
+            const double expectedGain = createGraph (graph, 8);
+            graph.prepareToPlay (44100.0, 512);
+
+            for (int block = 0; block < 10; ++block)
+            {
+                for (int chan = 0; chan < 2; ++chan)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        *buffer.getSampleData (chan, i) = getTestSignal (block, i, chan);
+
+                graph.processBlock (buffer, midi);
+
+                bool ok = true;
+
+                for (int chan = 0; chan < 2; ++chan)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        ok = ok && std::abs (*buffer.getSampleData (chan, i) - expectedGain * getTestSignal (block, i, chan)) < 0.0001;
+
+                expect (ok, "rendered output was incorrect");
+            }
+
+            graph.releaseResources();
+        }
+
+        {
+            // ..but a path made of double-precision processors keeps its full resolution
+            AudioProcessorGraph graph;
+            graph.setProcessingPrecision (AudioProcessor::doublePrecision);
+            graph.setNumRenderingThreads (numThreads);
+            graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+
+            DoubleGainProcessor* const third  = new DoubleGainProcessor (1.0 / 3.0);
+            DoubleGainProcessor* const triple = new DoubleGainProcessor (3.0);
+
+            const uint32 in  = graph.addNode (new IOProc (IOProc::audioInputNode))->nodeId;
+            const uint32 out = graph.addNode (new IOProc (IOProc::audioOutputNode))->nodeId;
+            const uint32 n1  = graph.addNode (third)->nodeId;
+            const uint32 n2  = graph.addNode (triple)->nodeId;
+
+            for (int chan = 0; chan < 2; ++chan)
+            {
+                graph.addConnection (in, chan, n1, chan);
+                graph.addConnection (n1, chan, n2, chan);
+                graph.addConnection (n2, chan, out, chan);
+            }
+
+            graph.prepareToPlay (44100.0, 512);
+
+            for (int block = 0; block < 10; ++block)
+            {
+                for (int chan = 0; chan < 2; ++chan)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        *buffer.getSampleData (chan, i) = getTestSignal (block, i, chan);
+
+                graph.processBlock (buffer, midi);
+
+                bool ok = true;
+
+                for (int chan = 0; chan < 2; ++chan)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        ok = ok && std::abs (*buffer.getSampleData (chan, i) - getTestSignal (block, i, chan)) < 1.0e-12;
+
+                expect (ok, "double-precision output lost resolution");
+            }
+
+            expectEquals (third->numDoubleCallbacks, 10);
+            expectEquals (triple->numDoubleCallbacks, 10);
+
+            graph.releaseResources();
+        }
+    }
+
+    void testConnections()
+    {
+        AudioProcessorGraph graph;
+        graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+
+        const uint32 n1 = graph.addNode (new GainProcessor (1.0f))->nodeId;
+        const uint32 n2 = graph.addNode (new GainProcessor (1.0f))->nodeId;
+        const uint32 n3 = graph.addNode (new GainProcessor (1.0f))->nodeId;
+
+        expect (graph.addConnection (n1, 0, n2, 0));
+        expect (graph.addConnection (n1, 1, n2, 1));
+        expect (graph.addConnection (n2, 0, n3, 1));
+        expect (! graph.addConnection (n1, 0, n2, 0));
+        expect (! graph.canConnect (n1, 2, n3, 0));
+
+        expect (graph.isConnected (n1, n2));
+        expect (graph.isConnected (n2, n3));
+        expect (! graph.isConnected (n2, n1));
+        expect (! graph.isConnected (n1, n3));
+        expect (graph.getConnectionBetween (n2, 0, n3, 1) != nullptr);
+
+        expect (graph.removeConnection (n1, 0, n2, 0));
+        expect (! graph.removeConnection (n1, 0, n2, 0));
+        expect (graph.isConnected (n1, n2));
+        expect (graph.removeConnection (n1, 1, n2, 1));
+        expect (! graph.isConnected (n1, n2));
+
+        expect (graph.addConnection (n1, 0, n2, 0));
+        expect (graph.removeNode (n2));
+        expectEquals (graph.getNumConnections(), 0);
+        expect (graph.getNodeForId (n2) == nullptr);
+        expect (! graph.isConnected (n1, n2));
+        expect (! graph.disconnectNode (n1));
+    }
+
+    // Renders a block of a sine wave through the graph, and checks that the output
+    // is twice the input, delayed by the given number of samples.
+    bool renderDelayedBlock (AudioProcessorGraph& graph, const int block, const int expectedDelay)
+    {
+        AudioSampleBuffer buffer (2, 512);
+        MidiBuffer midi;
+
+        for (int chan = 0; chan < 2; ++chan)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                *buffer.getSampleData (chan, i) = (float) std::sin ((block * 512 + i) * 0.01 + chan);
+
+        graph.processBlock (buffer, midi);
+
+        bool ok = true;
+
+        for (int chan = 0; chan < 2; ++chan)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                ok = ok && std::abs (*buffer.getSampleData (chan, i)
+                                       - 2.0f * (float) std::sin ((block * 512 + i - expectedDelay) * 0.01 + chan)) < 0.0001f;
+
+        return ok;
+    }
+
+    void testLatencyCompensation()
+    {
+        typedef AudioProcessorGraph::AudioGraphIOProcessor IOProc;
+
+        AudioProcessorGraph graph;
+        graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+
+        DelayProcessor* const delayProcessor = new DelayProcessor (100);
+
+        const uint32 in  = graph.addNode (new IOProc (IOProc::audioInputNode))->nodeId;
+        const uint32 out = graph.addNode (new IOProc (IOProc::audioOutputNode))->nodeId;
+        const uint32 n1 = graph.addNode (delayProcessor)->nodeId;
+        const uint32 n2 = graph.addNode (new GainProcessor (1.0f))->nodeId;
+
+        for (int chan = 0; chan < 2; ++chan)
+        {
+            graph.addConnection (in, chan, n1, chan);
+            graph.addConnection (in, chan, n2, chan);
+            graph.addConnection (n1, chan, out, chan);
+            graph.addConnection (n2, chan, out, chan);
+        }
+
+        graph.prepareToPlay (44100.0, 512);
+        expectEquals (graph.getLatencySamples(), 100);
+
+        // (the first block of each run is skipped, because the delay lines start out silent)
+        bool ok = true;
+
+        for (int block = 0; block < 10; ++block)
+            ok = (renderDelayedBlock (graph, block, 100) || block == 0) && ok;
+
+        expect (ok, "the undelayed path wasn't compensated");
+
+        // changing the latency while playing should re-tune the delays without a rebuild..
+        delayProcessor->setDelay (300);
+
+        for (int block = 10; block < 20; ++block)
+            ok = (renderDelayedBlock (graph, block, 300) || block == 10) && ok;
+
+        expect (ok, "the delays weren't re-tuned after a latency change");
+
+        graph.releaseResources();
+    }
+
+    void testSilenceSkipping()
+    {
+        typedef AudioProcessorGraph::AudioGraphIOProcessor IOProc;
+
+        AudioProcessorGraph graph;
+        graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+
+        // a tail of 1000 samples means two more callbacks once the input goes silent
+        CountingProcessor* const withTail = new CountingProcessor (1000.0 / 44100.0, true);
+        CountingProcessor* const alwaysOn = new CountingProcessor (0, false);
+
+        const uint32 in  = graph.addNode (new IOProc (IOProc::audioInputNode))->nodeId;
+        const uint32 out = graph.addNode (new IOProc (IOProc::audioOutputNode))->nodeId;
+        const uint32 n1 = graph.addNode (withTail)->nodeId;
+        const uint32 n2 = graph.addNode (alwaysOn)->nodeId;
+        const uint32 n3 = graph.addNode (new GainProcessor (1.0f))->nodeId;
+
+        for (int chan = 0; chan < 2; ++chan)
+        {
+            graph.addConnection (in, chan, n1, chan);
+            graph.addConnection (n1, chan, n2, chan);
+            graph.addConnection (n2, chan, n3, chan);
+            graph.addConnection (n3, chan, out, chan);
+        }
+
+        graph.prepareToPlay (44100.0, 512);
+
+        AudioSampleBuffer buffer (2, 512);
+        MidiBuffer midi;
+        buffer.clear();
+
+        for (int block = 0; block < 10; ++block)
+        {
+            if (block == 0 || block == 9)
+                for (int chan = 0; chan < 2; ++chan)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        *buffer.getSampleData (chan, i) = (float) std::sin (i * 0.01 + chan);
+            else
+                buffer.clear();
+
+            graph.processBlock (buffer, midi);
+
+            if (block > 0 && block < 9)
+                expectEquals (buffer.getMagnitude (0, buffer.getNumSamples()), 0.0f);
+        }
+
+        expectEquals (withTail->numCallbacks, 1 + 2 + 1);
+        expectEquals (alwaysOn->numCallbacks, 10);
+
+        graph.releaseResources();
+    }
+
+    // A GainProcessor that takes at least the given time to process each block.
+    class BusyProcessor  : public GainProcessor
+    {
+    public:
+        BusyProcessor (const double microseconds_)
+            : GainProcessor (1.0f), microseconds (microseconds_)
+        {
+        }
+
+        void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midi)
+        {
+            const double endTime = Time::getMillisecondCounterHiRes() + microseconds / 1000.0;
+
+            while (Time::getMillisecondCounterHiRes() < endTime)
+            {}
+
+            GainProcessor::processBlock (buffer, midi);
+        }
+
+    private:
+        const double microseconds;
+    };
+
+    void testNodeProfiling (const int numThreads)
+    {
+        typedef AudioProcessorGraph::AudioGraphIOProcessor IOProc;
+
+        AudioProcessorGraph graph;
+        graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+        graph.setNumRenderingThreads (numThreads);
+
+        const uint32 in  = graph.addNode (new IOProc (IOProc::audioInputNode))->nodeId;
+        const uint32 out = graph.addNode (new IOProc (IOProc::audioOutputNode))->nodeId;
+        AudioProcessorGraph::Node* const slow = graph.addNode (new BusyProcessor (500.0));
+        AudioProcessorGraph::Node* const fast = graph.addNode (new GainProcessor (1.0f));
+
+        for (int chan = 0; chan < 2; ++chan)
+        {
+            graph.addConnection (in, chan, slow->nodeId, chan);
+            graph.addConnection (in, chan, fast->nodeId, chan);
+            graph.addConnection (slow->nodeId, chan, out, chan);
+            graph.addConnection (fast->nodeId, chan, out, chan);
+        }
+
+        graph.prepareToPlay (44100.0, 512);
+
+        AudioSampleBuffer buffer (2, 512);
+        MidiBuffer midi;
+
+        for (int block = 0; block < 20; ++block)
+        {
+            if (block == 5)
+                graph.setNodeProfilingEnabled (true);
+
+            buffer.clear();
+            *buffer.getSampleData (0, 0) = 1.0f;
+            graph.processBlock (buffer, midi);
+        }
+
+        expect (graph.isNodeProfilingEnabled());
+        expectEquals (slow->getTimingStats().getNumCalls(), 15);
+        expectEquals (fast->getTimingStats().getNumCalls(), 15);
+
+        const AudioProcessorGraph::NodeTimingStats& stats = slow->getTimingStats();
+        expect (stats.getAverageMicroseconds() >= 500.0);
+        expect (stats.getMaxMicroseconds() >= stats.getAverageMicroseconds() - 1.0);
+        expect (stats.getPercentileMicroseconds (0.99) >= stats.getPercentileMicroseconds (0.5));
+        expect (stats.getPercentileMicroseconds (0.5) >= 400.0);
+        expect (fast->getTimingStats().getAverageMicroseconds() < stats.getAverageMicroseconds());
+
+        graph.setNodeProfilingEnabled (false);
+        graph.resetNodeTimingStats();
+        graph.processBlock (buffer, midi);
+
+        expectEquals (slow->getTimingStats().getNumCalls(), 0);
+        expectEquals (slow->getTimingStats().getMaxMicroseconds(), 0.0);
+
+        graph.releaseResources();
+    }
+
+    void testTimingStatsHistogram()
+    {
+        AudioProcessorGraph::NodeTimingStats stats;
+        expectEquals (stats.getPercentileMicroseconds (0.99), 0.0);
+
+        for (int i = 0; i < 98; ++i)
+            stats.addCall (10.0);
+
+        stats.addCall (1000.0);
+        stats.addCall (0.5);
+
+        expectEquals (stats.getNumCalls(), 100);
+        expectEquals (stats.getMaxMicroseconds(), 1000.0);
+        expect (std::abs (stats.getAverageMicroseconds() - (980.0 + 1000.0 + 0.5) / 100.0) < 0.001);
+        expectEquals (stats.getHistogramCount (0), 1);
+        expectEquals (stats.getHistogramCount (14), 98);    // 2^(13/4) < 10 <= 2^(14/4)
+        expect (stats.getPercentileMicroseconds (0.5) >= 10.0 && stats.getPercentileMicroseconds (0.5) < 12.0);
+        expect (stats.getPercentileMicroseconds (0.99) < 12.0);
+        expectEquals (stats.getPercentileMicroseconds (1.0), 1000.0);
+
+        stats.reset();
+        expectEquals (stats.getNumCalls(), 0);
+        expectEquals (stats.getHistogramCount (14), 0);
+    }
+
+    void testBufferAllocation()
+    {
+        typedef AudioProcessorGraph::AudioGraphIOProcessor IOProc;
+
+        {
+            // a long chain of in-place processors should only ever need one buffer per channel..
+            AudioProcessorGraph graph;
+            graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+
+            uint32 previous = graph.addNode (new IOProc (IOProc::audioInputNode))->nodeId;
+
+            for (int i = 0; i < 32; ++i)
+            {
+                const uint32 next = graph.addNode (new GainProcessor (1.0f))->nodeId;
+
+                for (int chan = 0; chan < 2; ++chan)
+                    graph.addConnection (previous, chan, next, chan);
+
+                previous = next;
+            }
+
+            const uint32 out = graph.addNode (new IOProc (IOProc::audioOutputNode))->nodeId;
+
+            for (int chan = 0; chan < 2; ++chan)
+                graph.addConnection (previous, chan, out, chan);
+
+            graph.prepareToPlay (44100.0, 512);
+
+            const AudioProcessorGraph::RenderingSequenceStats stats (graph.getRenderingSequenceStats());
+            expectEquals (stats.numAudioBuffers, 2);
+            expectEquals (stats.numCopies, 0);
+            expectEquals (stats.numMixes, 0);
+            graph.releaseResources();
+        }
+
+        {
+            // ..and parallel branches only need copies of the input for all but the last one, and
+            // get mixed into the output as they go, rather than each keeping its own buffers
+            AudioProcessorGraph graph;
+            createGraph (graph, 8);
+            graph.prepareToPlay (44100.0, 512);
+
+            const AudioProcessorGraph::RenderingSequenceStats stats (graph.getRenderingSequenceStats());
+            expectEquals (stats.numCopies, 2 * 7);
+            expectEquals (stats.numMixes, 2 * 7);
+            expect (stats.numAudioBuffers <= 6, String (stats.numAudioBuffers) + " buffers were used");
+            graph.releaseResources();
+        }
+    }
+
+    // A chain of stateful processors with a parallel branch joining it at the output, and a
+    // midi path from the graph's input to its output.
+    static void createChainGraph (AudioProcessorGraph& graph)
+    {
+        typedef AudioProcessorGraph::AudioGraphIOProcessor IOProc;
+
+        graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+
+        const uint32 in      = graph.addNode (new IOProc (IOProc::audioInputNode))->nodeId;
+        const uint32 out     = graph.addNode (new IOProc (IOProc::audioOutputNode))->nodeId;
+        const uint32 midiIn  = graph.addNode (new IOProc (IOProc::midiInputNode))->nodeId;
+        const uint32 midiOut = graph.addNode (new IOProc (IOProc::midiOutputNode))->nodeId;
+        const uint32 branch  = graph.addNode (new GainProcessor (0.5f))->nodeId;
+
+        uint32 previous = in;
+
+        for (int i = 0; i < 8; ++i)
+        {
+            AudioProcessor* const p = (i % 2 == 0) ? (AudioProcessor*) new DelayProcessor (3 + i * 5)
+                                                   : (AudioProcessor*) new GainProcessor (0.9f);
+            const uint32 next = graph.addNode (p)->nodeId;
+
+            for (int chan = 0; chan < 2; ++chan)
+                graph.addConnection (previous, chan, next, chan);
+
+            previous = next;
+        }
+
+        for (int chan = 0; chan < 2; ++chan)
+        {
+            graph.addConnection (previous, chan, out, chan);
+            graph.addConnection (in, chan, branch, chan);
+            graph.addConnection (branch, chan, out, chan);
+        }
+
+        graph.addConnection (midiIn, AudioProcessorGraph::midiChannelIndex,
+                             midiOut, AudioProcessorGraph::midiChannelIndex);
+    }
+
+    void testOfflineRendering()
+    {
+        const int numBlocks = 40;
+        OwnedArray<AudioSampleBuffer> serialAudio, offlineAudio;
+        OwnedArray<MidiBuffer> serialMidi, offlineMidi;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const int numSamples = block == numBlocks - 1 ? 100 : 512;
+            serialAudio.add (new AudioSampleBuffer (2, numSamples));
+            serialMidi.add (new MidiBuffer());
+
+            for (int chan = 0; chan < 2; ++chan)
+                for (int i = 0; i < numSamples; ++i)
+                    *serialAudio.getLast()->getSampleData (chan, i) = (float) getTestSignal (block, i, chan);
+
+            if (block % 7 == 3)
+                serialMidi.getLast()->addEvent (MidiMessage::noteOn (1, block, 0.5f), block);
+
+            offlineAudio.add (new AudioSampleBuffer (*serialAudio.getLast()));
+            offlineMidi.add (new MidiBuffer (*serialMidi.getLast()));
+        }
+
+        {
+            AudioProcessorGraph graph;
+            createChainGraph (graph);
+            graph.prepareToPlay (44100.0, 512);
+
+            for (int block = 0; block < numBlocks; ++block)
+                graph.processBlock (*serialAudio.getUnchecked (block), *serialMidi.getUnchecked (block));
+
+            graph.releaseResources();
+        }
+
+        {
+            AudioProcessorGraph graph;
+            graph.setNumRenderingThreads (3);
+            createChainGraph (graph);
+            graph.prepareToPlay (44100.0, 512);
+
+            graph.setNonRealtime (true);
+            expect (graph.getNode (0)->getProcessor()->isNonRealtime());
+
+            // (rendered in two halves, to check that the state carries over between calls)
+            for (int half = 0; half < 2; ++half)
+            {
+                Array<AudioSampleBuffer*> audio;
+                Array<MidiBuffer*> midi;
+
+                for (int block = half * numBlocks / 2; block < (half + 1) * numBlocks / 2; ++block)
+                {
+                    audio.add (offlineAudio.getUnchecked (block));
+                    midi.add (offlineMidi.getUnchecked (block));
+                }
+
+                graph.processBlocksOffline (audio, midi);
+            }
+
+            graph.releaseResources();
+        }
+
+        bool audioMatches = true, midiMatches = true;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const AudioSampleBuffer& b1 = *serialAudio.getUnchecked (block);
+            const AudioSampleBuffer& b2 = *offlineAudio.getUnchecked (block);
+
+            for (int chan = 0; chan < 2; ++chan)
+                audioMatches = audioMatches && memcmp (b1.getReadPointer (chan), b2.getReadPointer (chan),
+                                                       sizeof (float) * (size_t) b1.getNumSamples()) == 0;
+
+            const MidiBuffer& m1 = *serialMidi.getUnchecked (block);
+            const MidiBuffer& m2 = *offlineMidi.getUnchecked (block);
+
+            midiMatches = midiMatches && m1.getNumEvents() == m2.getNumEvents()
+                            && m1.getFirstEventTime() == m2.getFirstEventTime()
+                            && m1.getNumEvents() == (block % 7 == 3 ? 1 : 0);
+        }
+
+        expect (audioMatches, "the pipelined output was different from the serial output");
+        expect (midiMatches, "the pipelined midi was different from the serial midi");
+
+        {
+            // nodes that are added later should pick up the graph's mode..
+            AudioProcessorGraph graph;
+            graph.setNonRealtime (true);
+            expect (graph.addNode (new GainProcessor (1.0f))->getProcessor()->isNonRealtime());
+
+            graph.setNonRealtime (false);
+            expect (! graph.getNode (0)->getProcessor()->isNonRealtime());
+        }
+    }
+
+    void runTest()
+    {
+        beginTest ("Connections");
+        testConnections();
+
+        beginTest ("Rendering");
+        testRendering (0);
+
+        beginTest ("Multi-threaded rendering");
+        testRendering (3);
+
+        beginTest ("Latency compensation");
+        testLatencyCompensation();
+
+        beginTest ("Silence skipping");
+        testSilenceSkipping();
+
+        beginTest ("Double-precision rendering");
+        testDoublePrecision (0);
+        testDoublePrecision (3);
+
+        beginTest ("Buffer allocation");
+        testBufferAllocation();
+
+        beginTest ("Offline rendering");
+        testOfflineRendering();
+
+        beginTest ("Node profiling");
+        testTimingStatsHistogram();
+        testNodeProfiling (0);
+        testNodeProfiling (3);
+
+        beginTest ("Rebuild time");
+
+        for (int numBranches = 16; numBranches <= 256; numBranches *= 2)
+        {
+            AudioProcessorGraph graph;
+            createGraph (graph, numBranches);
+
+            const double startTime = Time::getMillisecondCounterHiRes();
+            graph.prepareToPlay (44100.0, 512);
+            const double rebuildTime = Time::getMillisecondCounterHiRes() - startTime;
+
+            const double editStartTime = Time::getMillisecondCounterHiRes();
+            graph.removeConnection (graph.getConnection (0)->sourceNodeId, 0, graph.getConnection (0)->destNodeId, 0);
+            graph.prepareToPlay (44100.0, 512);
+            const double editTime = Time::getMillisecondCounterHiRes() - editStartTime;
+
+            logMessage (String (graph.getNumNodes()) + " nodes, " + String (graph.getNumConnections())
+                          + " connections: build " + String (rebuildTime, 2) + "ms, edit "
+                          + String (editTime, 2) + "ms");
+
+            graph.releaseResources();
+        }
+    }
+};
+
+static AudioProcessorGraphTests audioProcessorGraphTests;
+
+//==============================================================================
+class AudioProcessorGraphBenchmark  : public Benchmark
+{
+public:
+    AudioProcessorGraphBenchmark (const int numBranches_)
+        : Benchmark ("AudioProcessorGraph: render " + String (numBranches_) + " branches", 512),
+          numBranches (numBranches_),
+          buffer (2, 512)
+    {
+    }
+
+    void initialise()
+    {
+        graph = new AudioProcessorGraph();
+        AudioProcessorGraphTests::createGraph (*graph, numBranches);
+        graph->prepareToPlay (44100.0, 512);
+        buffer.clear();
+    }
+
+    void runIteration()
+    {
+        graph->processBlock (buffer, midi);
+    }
+
+    void shutdown()
+    {
+        graph->releaseResources();
+        graph = nullptr;
+    }
+
+private:
+    const int numBranches;
+    ScopedPointer<AudioProcessorGraph> graph;
+    AudioSampleBuffer buffer;
+    MidiBuffer midi;
+};
+
+static AudioProcessorGraphBenchmark audioProcessorGraphBenchmark4 (4);
+static AudioProcessorGraphBenchmark audioProcessorGraphBenchmark32 (32);
+static AudioProcessorGraphBenchmark audioProcessorGraphBenchmark128 (128);
+
+#endif
@@ -44,6 +44,22 @@
 
     To play back a graph through an audio device, you might want to use an
     AudioProcessorPlayer object.
+
+    The graph compensates for the latencies that its processors report with
+    AudioProcessor::setLatencySamples(): wherever paths of different lengths meet,
+    the shorter ones are delayed so that everything arrives in step, and the graph
+    reports the longest path's latency as its own. If a processor's latency changes
+    while playing, the delays are re-tuned at the start of the next block.
+
+    The graph also keeps track of which of its internal buffers are silent, and
+    skips mixing them. A processor whose silenceInProducesSilenceOut() method returns
+    true stops being called once its input has been silent for longer than its tail
+    and latency, and starts again as soon as any sound (or midi) arrives.
+
+    If the graph is put into double-precision mode with setProcessingPrecision()
+    before it's prepared, it keeps all its internal buffers as doubles, and each node
+    is given the same precision. Nodes that can't process doubles have their audio
+    converted to floats (and back) around their processBlock() calls.
 */
 class JUCE_API  AudioProcessorGraph   : public AudioProcessor,
                                         private AsyncUpdater
@@ -58,6 +74,81 @@ public:
     */
     ~AudioProcessorGraph();
 
+    struct Connection;
+
+    //==============================================================================
+    /** Timing statistics for the processBlock() calls of one node in the graph.
+
+        These are only gathered while profiling is turned on with
+        AudioProcessorGraph::setNodeProfilingEnabled(). Everything's stored in atomics,
+        so a UI can poll the getter methods from any thread while the graph is being
+        rendered, without any locking.
+
+        Blocks in which a node was skipped because its input was silent aren't counted.
+
+        @see Node::getTimingStats
+    */
+    class JUCE_API  NodeTimingStats
+    {
+    public:
+        //==============================================================================
+        /** Creates an empty set of stats. */
+        NodeTimingStats() noexcept;
+
+        //==============================================================================
+        enum
+        {
+            /** The times are gathered in a histogram with four bins per octave, so bin 0
+                holds calls that took up to 1 microsecond, and the final bin gathers up
+                every call that took 2^24 microseconds (about 16 seconds) or more.
+            */
+            numHistogramBins = 97
+        };
+
+        //==============================================================================
+        /** Records a call.
+            This is called by the graph's rendering threads - it doesn't block or allocate.
+        */
+        void addCall (double microsecondsTaken) noexcept;
+
+        /** Clears all the stats.
+            If this is called while the graph is rendering, a call that's in the middle of
+            being added may be only partially included.
+        */
+        void reset() noexcept;
+
+        //==============================================================================
+        /** Returns the number of calls that have been recorded. */
+        int getNumCalls() const noexcept                            { return numCalls.get(); }
+
+        /** Returns the average time that the calls have taken, in microseconds. */
+        double getAverageMicroseconds() const noexcept;
+
+        /** Returns the longest time that any call has taken, in microseconds. */
+        double getMaxMicroseconds() const noexcept                  { return (double) maxMicroseconds.get(); }
+
+        /** Returns an estimate of the time within which the given proportion of calls
+            finished, in microseconds - e.g. getPercentileMicroseconds (0.99) for the 99th
+            percentile.
+
+            This is taken from the histogram, so it's only accurate to within about 20%.
+        */
+        double getPercentileMicroseconds (double proportion) const noexcept;
+
+        /** Returns the number of calls that fell into one of the histogram bins.
+            @see numHistogramBins
+        */
+        int getHistogramCount (int binIndex) const noexcept;
+
+    private:
+        //==============================================================================
+        Atomic<int> numCalls, maxMicroseconds;
+        Atomic<int64> totalNanoseconds;
+        Atomic<int> histogram [numHistogramBins];
+
+        JUCE_DECLARE_NON_COPYABLE (NodeTimingStats)
+    };
+
     //==============================================================================
     /** Represents one of the nodes, or processors, in an AudioProcessorGraph.
 
@@ -83,6 +174,12 @@ public:
         */
         NamedValueSet properties;
 
+        /** Returns the timing statistics for this node's processor.
+            These are only updated while the graph's profiling is enabled.
+            @see AudioProcessorGraph::setNodeProfilingEnabled
+        */
+        NodeTimingStats& getTimingStats() noexcept              { return timingStats; }
+
         //==============================================================================
         /** A convenient typedef for referring to a pointer to a node object. */
         typedef ReferenceCountedObjectPtr <Node> Ptr;
@@ -93,6 +190,10 @@ public:
 
         const ScopedPointer<AudioProcessor> processor;
         bool isPrepared;
+        NodeTimingStats timingStats;
+
+        // the connections attached to this node, which are kept up to date by the graph
+        Array<const Connection*> inputs, outputs;
 
         Node (uint32 nodeId, AudioProcessor*) noexcept;
 
@@ -256,6 +357,118 @@ public:
     */
     static const int midiChannelIndex;
 
+    //==============================================================================
+    /** Enables multi-threaded rendering of the graph.
+
+        If the number of threads is greater than zero, the graph will create that many
+        worker threads, which will help the audio thread to render any independent
+        branches of the graph concurrently. Nodes which depend on the output of
+        other nodes will still wait for those nodes to finish before being processed.
+
+        Passing zero (the default) will render everything on the audio thread that
+        calls processBlock().
+
+        Because the processors in the graph may be called from any of these threads,
+        they must not make any assumptions about which thread their processBlock()
+        method is called on.
+
+        This should be called from the message thread.
+    */
+    void setNumRenderingThreads (int numThreads);
+
+    /** Returns the number of worker threads that were set with setNumRenderingThreads(). */
+    int getNumRenderingThreads() const noexcept;
+
+    //==============================================================================
+    /** Renders a run of consecutive blocks as quickly as possible, e.g. for bouncing.
+
+        The result is exactly the same as calling processBlock() on each of the blocks in
+        turn. But if the graph has some rendering threads (see setNumRenderingThreads()),
+        its rendering sequence is split into a pipeline of stages, one per thread, so that
+        while the later nodes are processing one block, the earlier ones are already
+        working on the next. This keeps all the threads busy even when the graph is a long
+        chain of processors that couldn't otherwise be rendered in parallel.
+
+        Each node still sees the blocks one at a time and in the right order, but the blocks
+        may be processed on different threads.
+
+        The two arrays must be the same size. Each block's audio and midi are replaced by
+        the graph's output, and no block can be longer than the block size that the graph
+        was prepared with. The more blocks that are passed in, the longer the pipeline stays
+        full, so it's best to render dozens of blocks per call. Any changes to the nodes'
+        latencies take effect at the start of the next call.
+
+        This blocks until everything has been rendered, and it holds the callback lock while
+        doing so. You'll probably also want to call setNonRealtime (true) before rendering,
+        which the graph passes on to all its nodes.
+    */
+    void processBlocksOffline (const Array<AudioSampleBuffer*>& audioBlocks,
+                               const Array<MidiBuffer*>& midiBlocks);
+
+    /** Renders a run of consecutive double-precision blocks as quickly as possible.
+
+        This is the double-precision version of processBlocksOffline(), which can only be
+        used when the graph has been prepared in double-precision mode.
+    */
+    void processBlocksOffline (const Array<AudioBuffer<double>*>& audioBlocks,
+                               const Array<MidiBuffer*>& midiBlocks);
+
+    //==============================================================================
+    /** Turns on the timing of each node's processBlock() calls.
+
+        When this is enabled, the graph measures how long each of its nodes takes to
+        process every block, and adds the results to the node's NodeTimingStats object,
+        which can be polled to show where the CPU time is going. When it's disabled
+        (the default), the only cost is checking the flag once per node.
+
+        This can be called from any thread.
+        @see Node::getTimingStats, resetNodeTimingStats
+    */
+    void setNodeProfilingEnabled (bool shouldBeEnabled) noexcept;
+
+    /** Returns true if node profiling has been turned on.
+        @see setNodeProfilingEnabled
+    */
+    bool isNodeProfilingEnabled() const noexcept                     { return nodeProfilingEnabled.get() != 0; }
+
+    /** Clears the timing statistics of all the nodes in the graph. */
+    void resetNodeTimingStats();
+
+    //==============================================================================
+    /** Describes the rendering sequence that the graph has built for its current layout.
+        @see getRenderingSequenceStats
+    */
+    struct RenderingSequenceStats
+    {
+        /** The number of shared audio channels that the nodes are rendered into, not
+            including the read-only channel of silence that unconnected inputs are given.
+        */
+        int numAudioBuffers;
+
+        /** The number of shared midi buffers, not including the read-only empty one. */
+        int numMidiBuffers;
+
+        /** The number of audio channels and midi buffers that have to be copied because
+            their contents are still needed after a node has processed them in-place.
+        */
+        int numCopies;
+
+        /** The number of channels and midi buffers that are mixed into another one. */
+        int numMixes;
+
+        /** The number of channels and midi buffers that are cleared before being used. */
+        int numClears;
+
+        /** The number of latency compensation delays. */
+        int numDelays;
+    };
+
+    /** Returns some statistics about the rendering sequence that was last built.
+        The sequence is rebuilt asynchronously whenever the graph changes, so this will
+        be out of date until that has happened.
+    */
+    RenderingSequenceStats getRenderingSequenceStats() const noexcept   { return renderingSequenceStats; }
+
 
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
@@ -315,6 +528,8 @@ public:
         void prepareToPlay (double sampleRate, int estimatedSamplesPerBlock);
         void releaseResources();
         void processBlock (AudioSampleBuffer&, MidiBuffer&);
+        void processBlock (AudioBuffer<double>&, MidiBuffer&);
+        bool supportsDoublePrecisionProcessing() const;
 
         const String getInputChannelName (int channelIndex) const;
         const String getOutputChannelName (int channelIndex) const;
@@ -350,6 +565,11 @@ public:
         const IODeviceType type;
         AudioProcessorGraph* graph;
 
+        template <typename SampleType>
+        void processAudio (AudioBuffer<SampleType>&, MidiBuffer&,
+                           AudioBuffer<SampleType>* graphInput, AudioBuffer<SampleType>& graphOutput,
+                           MidiBuffer* graphMidiInput, MidiBuffer& graphMidiOutput);
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioGraphIOProcessor)
     };
 
@@ -361,7 +581,10 @@ public:
     void prepareToPlay (double sampleRate, int estimatedSamplesPerBlock);
     void releaseResources();
     void processBlock (AudioSampleBuffer&, MidiBuffer&);
+    void processBlock (AudioBuffer<double>&, MidiBuffer&);
+    bool supportsDoublePrecisionProcessing() const;
     void reset();
+    void setNonRealtime (bool isProcessingNonRealtime) noexcept;
 
     const String getInputChannelName (int channelIndex) const;
     const String getOutputChannelName (int channelIndex) const;
@@ -394,22 +617,50 @@ public:
 private:
     //==============================================================================
     ReferenceCountedArray <Node> nodes;
+    HashMap <int, Node*> nodeLookup;
     OwnedArray <Connection> connections;
     uint32 lastNodeId;
     AudioSampleBuffer renderingBuffers;
+    AudioBuffer<double> doubleRenderingBuffers;
+    int numRenderingBuffersInUse;
     OwnedArray <MidiBuffer> midiBuffers;
+    HeapBlock <bool> silentChannels;
     Array<void*> renderingOps;
+    RenderingSequenceStats renderingSequenceStats;
+    Atomic<int> nodeProfilingEnabled;
 
     friend class AudioGraphIOProcessor;
     AudioSampleBuffer* currentAudioInputBuffer;
     AudioSampleBuffer currentAudioOutputBuffer;
+    AudioBuffer<double>* currentDoubleAudioInputBuffer;
+    AudioBuffer<double> currentDoubleAudioOutputBuffer;
     MidiBuffer* currentMidiInputBuffer;
     MidiBuffer currentMidiOutputBuffer;
 
+    class ParallelRenderer;
+    friend class ScopedPointer<ParallelRenderer>;
+    ScopedPointer<ParallelRenderer> parallelRenderer;
+
+    class LatencyCompensator;
+    friend class ScopedPointer<LatencyCompensator>;
+    ScopedPointer<LatencyCompensator> latencyCompensator;
+
+    template <typename SampleType> class OfflinePipeline;
+    void* activeOfflinePipeline;   // the OfflinePipeline that processBlocksOffline() is running, if any
+
     void handleAsyncUpdate();
     void clearRenderingSequence();
     void buildRenderingSequence();
-    bool isAnInputTo (uint32 possibleInputId, uint32 possibleDestinationId, int recursionCheck) const;
+
+    template <typename SampleType>
+    void renderBlock (AudioBuffer<SampleType>& buffer, MidiBuffer& midiMessages,
+                      AudioBuffer<SampleType>& sharedBuffers,
+                      AudioBuffer<SampleType>*& currentInput, AudioBuffer<SampleType>& currentOutput);
+
+    template <typename SampleType>
+    void renderBlocksOffline (const Array<AudioBuffer<SampleType>*>& audioBlocks, const Array<MidiBuffer*>& midiBlocks,
+                              AudioBuffer<SampleType>& sharedBuffers,
+                              AudioBuffer<SampleType>*& currentInput, AudioBuffer<SampleType>& currentOutput);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorGraph)
 };
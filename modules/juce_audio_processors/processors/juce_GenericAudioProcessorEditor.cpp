@@ -23,53 +23,42 @@
   ==============================================================================
 */
 
-class ProcessorParameterPropertyComp   : public PropertyComponent,
-                                         private AudioProcessorListener,
-                                         private Timer
+class ProcessorParameterPropertyComp   : public PropertyComponent
 {
 public:
-    ProcessorParameterPropertyComp (const String& name, AudioProcessor& p, const int index_)
-        : PropertyComponent (name),
+    ProcessorParameterPropertyComp (AudioProcessor& p, const int index_)
+        : PropertyComponent (getNameForParameter (p, index_)),
           owner (p),
           index (index_),
-          paramHasChanged (false),
           slider (p, index_)
     {
-        startTimer (100);
         addAndMakeVisible (&slider);
-        owner.addListener (this);
-    }
-
-    ~ProcessorParameterPropertyComp()
-    {
-        owner.removeListener (this);
     }
 
     void refresh()
     {
-        paramHasChanged = false;
         slider.setValue (owner.getParameter (index), dontSendNotification);
     }
 
-    void audioProcessorChanged (AudioProcessor*)  {}
-
-    void audioProcessorParameterChanged (AudioProcessor*, int parameterIndex, float)
+    /** Re-uses this component to show a different parameter. */
+    void setParameterIndex (const int newIndex)
     {
-        if (parameterIndex == index)
-            paramHasChanged = true;
+        if (index != newIndex)
+        {
+            index = newIndex;
+            slider.index = newIndex;
+            setName (getNameForParameter (owner, newIndex));
+            repaint();
+        }
+
+        refresh();
+        slider.updateText();
     }
 
-    void timerCallback()
+    static String getNameForParameter (AudioProcessor& p, const int index)
     {
-        if (paramHasChanged)
-        {
-            refresh();
-            startTimer (1000 / 50);
-        }
-        else
-        {
-            startTimer (jmin (1000 / 4, getTimerInterval() + 10));
-        }
+        const String name (p.getParameterName (index));
+        return name.trim().isEmpty() ? String ("Unnamed") : name;
     }
 
 private:
@@ -100,17 +89,16 @@ private:
             return owner.getParameterText (index);
         }
 
-    private:
         //==============================================================================
         AudioProcessor& owner;
-        const int index;
+        int index;
 
+    private:
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParamSlider)
     };
 
     AudioProcessor& owner;
-    const int index;
-    bool volatile paramHasChanged;
+    int index;
     ParamSlider slider;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorParameterPropertyComp)
@@ -118,37 +106,128 @@ private:
 
 
 //==============================================================================
-GenericAudioProcessorEditor::GenericAudioProcessorEditor (AudioProcessor* const p)
-    : AudioProcessorEditor (p)
+// The list's model, and a single listener for the whole editor. Changes are flagged in
+// a bitset (which may happen on the audio thread), and a timer refreshes any of the
+// flagged rows that are on-screen. Rows that aren't on-screen have no components, and
+// will just read their current values when they're scrolled into view.
+class GenericAudioProcessorEditor::ParameterList  : public ListBoxModel,
+                                                    private AudioProcessorListener,
+                                                    private Timer
 {
-    jassert (p != nullptr);
-    setOpaque (true);
+public:
+    ParameterList (AudioProcessor& p, ListBox& list_)
+        : owner (p), list (list_),
+          numParameters (p.getNumParameters()),
+          numWords ((numParameters + 31) / 32)
+    {
+        changedBits.calloc ((size_t) jmax (1, numWords));
+        owner.addListener (this);
+        startTimer (100);
+    }
+
+    ~ParameterList()
+    {
+        owner.removeListener (this);
+    }
+
+    int getNumRows()                                    { return numParameters; }
+    void paintListBoxItem (int, Graphics&, int, int, bool)  {}
+
+    Component* refreshComponentForRow (int rowNumber, bool, Component* existingComponentToUpdate)
+    {
+        ProcessorParameterPropertyComp* comp = dynamic_cast <ProcessorParameterPropertyComp*> (existingComponentToUpdate);
 
-    addAndMakeVisible (&panel);
+        if (! isPositiveAndBelow (rowNumber, numParameters))
+        {
+            delete existingComponentToUpdate;
+            return nullptr;
+        }
+
+        if (comp == nullptr)
+        {
+            delete existingComponentToUpdate;
+            comp = new ProcessorParameterPropertyComp (owner, rowNumber);
+        }
 
-    Array <PropertyComponent*> params;
+        comp->setParameterIndex (rowNumber);
+        return comp;
+    }
 
-    const int numParams = p->getNumParameters();
-    int totalHeight = 0;
+private:
+    AudioProcessor& owner;
+    ListBox& list;
+    const int numParameters, numWords;
+    HeapBlock <Atomic <uint32> > changedBits;
+    Atomic <int> anyChanged;
+
+    void audioProcessorChanged (AudioProcessor*)  {}
+
+    void audioProcessorParameterChanged (AudioProcessor*, int parameterIndex, float)
+    {
+        if (isPositiveAndBelow (parameterIndex, numParameters))
+        {
+            Atomic <uint32>& word = changedBits [parameterIndex >> 5];
+            const uint32 bit = ((uint32) 1) << (parameterIndex & 31);
+
+            for (;;)
+            {
+                const uint32 oldBits = word.get();
+
+                if ((oldBits & bit) != 0 || word.compareAndSetBool (oldBits | bit, oldBits))
+                    break;
+            }
+
+            anyChanged = 1;
+        }
+    }
 
-    for (int i = 0; i < numParams; ++i)
+    void timerCallback()
     {
-        String name (p->getParameterName (i));
-        if (name.trim().isEmpty())
-            name = "Unnamed";
+        if (anyChanged.exchange (0) != 0)
+        {
+            for (int i = 0; i < numWords; ++i)
+            {
+                uint32 bits = changedBits[i].exchange (0);
+
+                for (int bit = 0; bits != 0; ++bit, bits >>= 1)
+                    if ((bits & 1) != 0)
+                        if (ProcessorParameterPropertyComp* const comp
+                               = dynamic_cast <ProcessorParameterPropertyComp*> (list.getComponentForRowNumber (i * 32 + bit)))
+                            comp->refresh();
+            }
 
-        ProcessorParameterPropertyComp* const pc = new ProcessorParameterPropertyComp (name, *p, i);
-        params.add (pc);
-        totalHeight += pc->getPreferredHeight();
+            startTimer (1000 / 50);
+        }
+        else
+        {
+            startTimer (jmin (1000 / 4, getTimerInterval() + 10));
+        }
     }
 
-    panel.addProperties (params);
+    JUCE_DECLARE_NON_COPYABLE (ParameterList)
+};
+
+//==============================================================================
+GenericAudioProcessorEditor::GenericAudioProcessorEditor (AudioProcessor* const p)
+    : AudioProcessorEditor (p)
+{
+    jassert (p != nullptr);
+    setOpaque (true);
+
+    const int rowHeight = 25;
+
+    parameterList = new ParameterList (*p, list);
+    list.setModel (parameterList);
+    list.setRowHeight (rowHeight);
+    list.setColour (ListBox::backgroundColourId, Colours::white);
+    addAndMakeVisible (&list);
 
-    setSize (400, jlimit (25, 400, totalHeight));
+    setSize (400, jlimit (25, 400, p->getNumParameters() * rowHeight));
 }
 
 GenericAudioProcessorEditor::~GenericAudioProcessorEditor()
 {
+    list.setModel (nullptr);
 }
 
 void GenericAudioProcessorEditor::paint (Graphics& g)
@@ -158,5 +237,5 @@ void GenericAudioProcessorEditor::paint (Graphics& g)
 
 void GenericAudioProcessorEditor::resized()
 {
-    panel.setBounds (getLocalBounds());
+    list.setBounds (getLocalBounds());
 }
@@ -37,6 +37,10 @@
     This can be used for showing an editor for a processor that doesn't supply
     its own custom editor.
 
+    The parameters are shown in a ListBox, so only the rows that are on-screen have
+    any components, and a single timer refreshes those of them whose parameters
+    have changed. This keeps it usable for processors with thousands of parameters.
+
     @see AudioProcessor
 */
 class JUCE_API  GenericAudioProcessorEditor      : public AudioProcessorEditor
@@ -52,7 +56,11 @@ public:
 
 private:
     //==============================================================================
-    PropertyPanel panel;
+    ListBox list;
+
+    class ParameterList;
+    friend class ScopedPointer<ParameterList>;
+    ScopedPointer<ParameterList> parameterList;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GenericAudioProcessorEditor)
 };
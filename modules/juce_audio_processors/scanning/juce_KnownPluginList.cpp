@@ -28,6 +28,8 @@ KnownPluginList::~KnownPluginList() {}
 
 void KnownPluginList::clear()
 {
+    clearFilesWithoutPlugins();
+
     if (types.size() > 0)
     {
         types.clear();
@@ -82,6 +84,11 @@ void KnownPluginList::removeType (const int index)
 bool KnownPluginList::isListingUpToDate (const String& fileOrIdentifier,
                                          AudioPluginFormat& formatToUse) const
 {
+    const ScopedLock sl (scanLock);
+
+    if (isFileWithoutPluginsUpToDate (fileOrIdentifier))
+        return true;
+
     if (getTypeForFile (fileOrIdentifier) == nullptr)
         return false;
 
@@ -109,6 +116,9 @@ bool KnownPluginList::scanAndAddFile (const String& fileOrIdentifier,
 {
     const ScopedLock sl (scanLock);
 
+    if (dontRescanIfAlreadyInList && isFileWithoutPluginsUpToDate (fileOrIdentifier))
+        return false;
+
     if (dontRescanIfAlreadyInList
          && getTypeForFile (fileOrIdentifier) != nullptr)
     {
@@ -135,13 +145,14 @@ bool KnownPluginList::scanAndAddFile (const String& fileOrIdentifier,
         return false;
 
     OwnedArray <PluginDescription> found;
+    bool crashed = false;
 
     {
         const ScopedUnlock sl (scanLock);
         if (scanner != nullptr)
         {
             if (! scanner->findPluginTypesFor (format, found, fileOrIdentifier))
-                addToBlacklist (fileOrIdentifier);
+                crashed = true;
         }
         else
         {
@@ -149,6 +160,11 @@ bool KnownPluginList::scanAndAddFile (const String& fileOrIdentifier,
         }
     }
 
+    if (crashed)
+        addToBlacklist (fileOrIdentifier);
+
+    setFileHasNoPlugins (fileOrIdentifier, found.size() == 0 && ! crashed);
+
     for (int i = 0; i < found.size(); ++i)
     {
         PluginDescription* const desc = found.getUnchecked(i);
@@ -238,6 +254,53 @@ void KnownPluginList::clearBlacklistedFiles()
     }
 }
 
+//==============================================================================
+int KnownPluginList::indexOfFileWithoutPlugins (const String& fileOrIdentifier) const
+{
+    for (int i = filesWithoutPlugins.size(); --i >= 0;)
+        if (filesWithoutPlugins.getReference(i).fileOrIdentifier == fileOrIdentifier)
+            return i;
+
+    return -1;
+}
+
+bool KnownPluginList::isFileWithoutPluginsUpToDate (const String& fileOrIdentifier) const
+{
+    const int index = indexOfFileWithoutPlugins (fileOrIdentifier);
+
+    return index >= 0
+            && File (fileOrIdentifier).getLastModificationTime()
+                 == filesWithoutPlugins.getReference (index).lastFileModTime;
+}
+
+void KnownPluginList::setFileHasNoPlugins (const String& fileOrIdentifier, const bool hasNoPlugins)
+{
+    const int index = indexOfFileWithoutPlugins (fileOrIdentifier);
+
+    // (only real files can be cached, as there's no modification time for other types of ID)
+    if (hasNoPlugins && File::isAbsolutePath (fileOrIdentifier))
+    {
+        ScannedFile f;
+        f.fileOrIdentifier = fileOrIdentifier;
+        f.lastFileModTime = File (fileOrIdentifier).getLastModificationTime();
+
+        if (index >= 0)
+            filesWithoutPlugins.set (index, f);
+        else
+            filesWithoutPlugins.add (f);
+    }
+    else if (index >= 0)
+    {
+        filesWithoutPlugins.remove (index);
+    }
+}
+
+void KnownPluginList::clearFilesWithoutPlugins()
+{
+    const ScopedLock sl (scanLock);
+    filesWithoutPlugins.clear();
+}
+
 //==============================================================================
 struct PluginSorter
 {
@@ -293,6 +356,17 @@ XmlElement* KnownPluginList::createXml() const
     for (int i = 0; i < blacklist.size(); ++i)
         e->createNewChildElement ("BLACKLISTED")->setAttribute ("id", blacklist[i]);
 
+    {
+        const ScopedLock sl (scanLock);
+
+        for (int i = 0; i < filesWithoutPlugins.size(); ++i)
+        {
+            XmlElement* const f = e->createNewChildElement ("NOPLUGINS");
+            f->setAttribute ("file", filesWithoutPlugins.getReference(i).fileOrIdentifier);
+            f->setAttribute ("fileTime", String::toHexString (filesWithoutPlugins.getReference(i).lastFileModTime.toMilliseconds()));
+        }
+    }
+
     return e;
 }
 
@@ -308,9 +382,20 @@ void KnownPluginList::recreateFromXml (const XmlElement& xml)
             PluginDescription info;
 
             if (e->hasTagName ("BLACKLISTED"))
+            {
                 blacklist.add (e->getStringAttribute ("id"));
+            }
+            else if (e->hasTagName ("NOPLUGINS"))
+            {
+                ScannedFile f;
+                f.fileOrIdentifier = e->getStringAttribute ("file");
+                f.lastFileModTime = Time (e->getStringAttribute ("fileTime").getHexValue64());
+                filesWithoutPlugins.add (f);
+            }
             else if (info.loadFromXml (*e))
+            {
                 addType (info);
+            }
         }
     }
 }
@@ -103,6 +103,9 @@ public:
 
     /** Returns true if the specified file is already known about and if it
         hasn't been modified since our entry was created.
+
+        This is also true for a file that was scanned without finding any plugins in it,
+        as long as its modification time hasn't changed since then.
     */
     bool isListingUpToDate (const String& possiblePluginFileOrIdentifier,
                             AudioPluginFormat& formatToUse) const;
@@ -127,6 +130,15 @@ public:
     /** Clears all the blacklisted files. */
     void clearBlacklistedFiles();
 
+    //==============================================================================
+    /** Forgets about any files that were scanned without finding any plugins.
+
+        The list remembers these files along with their modification times, so that
+        later scans can skip them until they change. This cache is saved by createXml()
+        and is also emptied by clear().
+    */
+    void clearFilesWithoutPlugins();
+
     //==============================================================================
     /** Sort methods used to change the order of the plugins in the list.
     */
@@ -201,9 +213,21 @@ private:
     //==============================================================================
     OwnedArray <PluginDescription> types;
     StringArray blacklist;
+
+    struct ScannedFile
+    {
+        String fileOrIdentifier;
+        Time lastFileModTime;
+    };
+
+    Array<ScannedFile> filesWithoutPlugins;
     ScopedPointer<CustomScanner> scanner;
     CriticalSection scanLock;
 
+    int indexOfFileWithoutPlugins (const String&) const;
+    bool isFileWithoutPluginsUpToDate (const String&) const;
+    void setFileHasNoPlugins (const String&, bool hasNoPlugins);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KnownPluginList)
 };
 
@@ -74,7 +74,10 @@ String PluginDirectoryScanner::getNextPluginFileThatWillBeScanned() const
 
 void PluginDirectoryScanner::updateProgress()
 {
-    progress = (1.0f - nextIndex.get() / (float) filesOrIdentifiersToScan.size());
+    // (when several threads are scanning, the index can overshoot the end of the list)
+    progress = filesOrIdentifiersToScan.size() > 0
+                 ? (1.0f - jmax (0, nextIndex.get()) / (float) filesOrIdentifiersToScan.size())
+                 : 1.0f;
 }
 
 bool PluginDirectoryScanner::scanNextFile (const bool dontRescanIfAlreadyInList)
@@ -90,19 +93,18 @@ bool PluginDirectoryScanner::scanNextFile (const bool dontRescanIfAlreadyInList)
             OwnedArray <PluginDescription> typesFound;
 
             // Add this plugin to the end of the dead-man's pedal list in case it crashes...
-            StringArray crashedPlugins (readDeadMansPedalFile (deadMansPedalFile));
-            crashedPlugins.removeString (file);
-            crashedPlugins.add (file);
-            setDeadMansPedalFile (crashedPlugins);
+            updateDeadMansPedal (file, true);
 
             list.scanAndAddFile (file, dontRescanIfAlreadyInList, typesFound, format);
 
             // Managed to load without crashing, so remove it from the dead-man's-pedal..
-            crashedPlugins.removeString (file);
-            setDeadMansPedalFile (crashedPlugins);
+            updateDeadMansPedal (file, false);
 
             if (typesFound.size() == 0 && ! list.getBlacklistedFiles().contains (file))
+            {
+                const ScopedLock sl (lock);
                 failedFiles.add (file);
+            }
         }
     }
 
@@ -116,6 +118,20 @@ bool PluginDirectoryScanner::skipNextFile()
     return --nextIndex > 0;
 }
 
+void PluginDirectoryScanner::updateDeadMansPedal (const String& file, const bool isBeingScanned)
+{
+    // (several threads may be scanning at once, so the file has to be re-read each time)
+    const ScopedLock sl (lock);
+
+    StringArray crashedPlugins (readDeadMansPedalFile (deadMansPedalFile));
+    crashedPlugins.removeString (file);
+
+    if (isBeingScanned)
+        crashedPlugins.add (file);
+
+    setDeadMansPedalFile (crashedPlugins);
+}
+
 void PluginDirectoryScanner::setDeadMansPedalFile (const StringArray& newContents)
 {
     if (deadMansPedalFile != File::nonexistent)
@@ -131,3 +147,148 @@ void PluginDirectoryScanner::applyBlacklistingsFromDeadMansPedal (KnownPluginLis
     for (int i = 0; i < crashedPlugins.size(); ++i)
         list.addToBlacklist (crashedPlugins[i]);
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ScanTestFormat  : public AudioPluginFormat
+{
+public:
+    String getName() const                                          { return "ScanTest"; }
+
+    void findAllTypesForFile (OwnedArray <PluginDescription>& results, const String& fileOrIdentifier)
+    {
+        ++numFilesLoaded;
+        const File file (fileOrIdentifier);
+
+        if (file.loadFileAsString() == "plugin")
+        {
+            PluginDescription* const desc = new PluginDescription();
+            desc->name = file.getFileNameWithoutExtension();
+            desc->pluginFormatName = getName();
+            desc->fileOrIdentifier = fileOrIdentifier;
+            desc->lastFileModTime = file.getLastModificationTime();
+            desc->uid = fileOrIdentifier.hashCode();
+            results.add (desc);
+        }
+    }
+
+    AudioPluginInstance* createInstanceFromDescription (const PluginDescription&)   { return nullptr; }
+    bool fileMightContainThisPluginType (const String& f)           { return f.endsWith (".scantest"); }
+    String getNameOfPluginFromIdentifier (const String& f)          { return f; }
+    bool doesPluginStillExist (const PluginDescription& desc)       { return File (desc.fileOrIdentifier).exists(); }
+    bool canScanForPlugins() const                                  { return true; }
+    FileSearchPath getDefaultLocationsToSearch()                    { return FileSearchPath(); }
+
+    bool pluginNeedsRescanning (const PluginDescription& desc)
+    {
+        return File (desc.fileOrIdentifier).getLastModificationTime() != desc.lastFileModTime;
+    }
+
+    StringArray searchPathsForPlugins (const FileSearchPath& path, bool recursive)
+    {
+        StringArray results;
+
+        for (int i = 0; i < path.getNumPaths(); ++i)
+        {
+            Array<File> files;
+            path[i].findChildFiles (files, File::findFiles, recursive, "*.scantest");
+
+            for (int j = 0; j < files.size(); ++j)
+                results.add (files.getReference(j).getFullPathName());
+        }
+
+        return results;
+    }
+
+    Atomic<int> numFilesLoaded;
+};
+
+class PluginDirectoryScannerTests  : public UnitTest
+{
+public:
+    PluginDirectoryScannerTests() : UnitTest ("PluginDirectoryScanner") {}
+
+    // Pretends that any file containing "crash" brought down its scanning process.
+    struct CrashingScanner  : public KnownPluginList::CustomScanner
+    {
+        bool findPluginTypesFor (AudioPluginFormat& format, OwnedArray <PluginDescription>& result,
+                                 const String& fileOrIdentifier)
+        {
+            if (File (fileOrIdentifier).loadFileAsString() == "crash")
+                return false;
+
+            format.findAllTypesForFile (result, fileOrIdentifier);
+            return true;
+        }
+    };
+
+    void scan (KnownPluginList& list, ScanTestFormat& format, const File& dir, int numFailedFilesExpected)
+    {
+        const File deadMansPedal (dir.getSiblingFile ("juce_scan_test_pedal.txt"));
+
+        PluginDirectoryScanner scanner (list, format, FileSearchPath (dir.getFullPathName()), false, deadMansPedal);
+        PluginScannerPool (4).scanAll (scanner, true);
+
+        expectEquals (scanner.getProgress(), 1.0f);
+        expectEquals (scanner.getFailedFiles().size(), numFailedFilesExpected);
+        expectEquals (readDeadMansPedalFile (deadMansPedal).size(), 0);
+        deadMansPedal.deleteFile();
+    }
+
+    void runTest()
+    {
+        const File dir (File::getSpecialLocation (File::tempDirectory)
+                          .getNonexistentChildFile ("juce_scan_test", String::empty, false));
+        dir.createDirectory();
+
+        for (int i = 0; i < 20; ++i)
+            dir.getChildFile ("plugin" + String (i) + ".scantest")
+               .replaceWithText (i % 2 == 0 ? "plugin" : "empty");
+
+        dir.getChildFile ("bad.scantest").replaceWithText ("crash");
+
+        ScanTestFormat format;
+        KnownPluginList list;
+        list.setCustomScanner (new CrashingScanner());
+
+        beginTest ("Parallel scanning");
+        scan (list, format, dir, 10);
+
+        expectEquals (format.numFilesLoaded.get(), 20);
+        expectEquals (list.getNumTypes(), 10);
+        expectEquals (list.getBlacklistedFiles().size(), 1);
+
+        beginTest ("Only changed files are rescanned");
+        scan (list, format, dir, 0);
+        expectEquals (format.numFilesLoaded.get(), 20);
+
+        const File changedFile (dir.getChildFile ("plugin1.scantest"));
+        changedFile.replaceWithText ("plugin");
+        changedFile.setLastModificationTime (changedFile.getLastModificationTime() + RelativeTime (10.0));
+
+        scan (list, format, dir, 0);
+        expectEquals (format.numFilesLoaded.get(), 21);
+        expectEquals (list.getNumTypes(), 11);
+
+        beginTest ("Saving the scan cache");
+        {
+            ScopedPointer<XmlElement> xml (list.createXml());
+            KnownPluginList reloaded;
+            reloaded.recreateFromXml (*xml);
+
+            const String emptyFile (dir.getChildFile ("plugin3.scantest").getFullPathName());
+            expect (reloaded.isListingUpToDate (emptyFile, format));
+            expect (reloaded.isListingUpToDate (changedFile.getFullPathName(), format));
+
+            reloaded.clear();
+            expect (! reloaded.isListingUpToDate (emptyFile, format));
+        }
+
+        dir.deleteRecursively();
+    }
+};
+
+static PluginDirectoryScannerTests pluginDirectoryScannerTests;
+
+#endif
@@ -74,6 +74,9 @@ public:
     //==============================================================================
     /** Tries the next likely-looking file.
 
+        This can be called by several threads at once to scan in parallel - see
+        PluginScannerPool::scanAll().
+
         If dontRescanIfAlreadyInList is true, then the file will only be loaded and
         re-tested if it's not already in the list, or if the file's modification
         time has changed since the list was created. If dontRescanIfAlreadyInList is
@@ -117,8 +120,10 @@ private:
     StringArray failedFiles;
     Atomic<int> nextIndex;
     float progress;
+    CriticalSection lock;
 
     void updateProgress();
+    void updateDeadMansPedal (const String& file, bool isBeingScanned);
     void setDeadMansPedalFile (const StringArray& newContents);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginDirectoryScanner)
@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+static const char* const pluginScanWorkerFlag = "--juce-plugin-scan";
+
+PluginScannerPool::PluginScannerPool (const int maxNumWorkerProcesses, const int timeoutMsPerFile)
+    : maxNumWorkers (jmax (1, maxNumWorkerProcesses)),
+      timeoutMs (timeoutMsPerFile),
+      numActiveWorkers (0)
+{
+}
+
+PluginScannerPool::~PluginScannerPool()
+{
+    // deleting the pool while it's still scanning!
+    jassert (numActiveWorkers == 0);
+}
+
+//==============================================================================
+File PluginScannerPool::startWorker()
+{
+    for (;;)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            if (numActiveWorkers < maxNumWorkers)
+            {
+                ++numActiveWorkers;
+
+                // (the file is created here, so that no other worker can pick the same name)
+                const File resultFile (File::getSpecialLocation (File::tempDirectory)
+                                         .getNonexistentChildFile ("juce_plugin_scan", ".xml", false));
+                resultFile.create();
+                return resultFile;
+            }
+        }
+
+        workerFinished.wait (100);
+    }
+}
+
+void PluginScannerPool::workerHasFinished (const File& resultFile)
+{
+    resultFile.deleteFile();
+
+    {
+        const ScopedLock sl (lock);
+        --numActiveWorkers;
+    }
+
+    workerFinished.signal();
+}
+
+bool PluginScannerPool::findPluginTypesFor (AudioPluginFormat& format,
+                                            OwnedArray <PluginDescription>& result,
+                                            const String& fileOrIdentifier)
+{
+    const File resultFile (startWorker());
+
+    StringArray args;
+    args.add (File::getSpecialLocation (File::currentExecutableFile).getFullPathName());
+    args.add (pluginScanWorkerFlag);
+    args.add (format.getName());
+    args.add (fileOrIdentifier);
+    args.add (resultFile.getFullPathName());
+
+    ChildProcess worker;
+
+    if (! worker.start (args))
+    {
+        // If a worker can't be launched, there's nothing to do but scan it here..
+        jassertfalse;
+        workerHasFinished (resultFile);
+        format.findAllTypesForFile (result, fileOrIdentifier);
+        return true;
+    }
+
+    const uint32 startTime = Time::getMillisecondCounter();
+
+    while (worker.isRunning())
+    {
+        if (Time::getMillisecondCounter() - startTime > (uint32) timeoutMs)
+        {
+            worker.kill();
+            break;
+        }
+
+        Thread::sleep (10);
+    }
+
+    // If the worker managed to write its results, they're used even if it
+    // crashed afterwards, e.g. while unloading the plugin.
+    ScopedPointer<XmlElement> xml (XmlDocument::parse (resultFile));
+    workerHasFinished (resultFile);
+
+    if (xml == nullptr || ! xml->hasTagName ("SCANRESULTS"))
+        return false;
+
+    forEachXmlChildElement (*xml, e)
+    {
+        PluginDescription desc;
+
+        if (desc.loadFromXml (*e))
+            result.add (new PluginDescription (desc));
+    }
+
+    return true;
+}
+
+//==============================================================================
+class PluginScanThread  : public Thread
+{
+public:
+    PluginScanThread (PluginDirectoryScanner& scanner_, const bool dontRescan_)
+        : Thread ("Plugin scanner"), scanner (scanner_), dontRescan (dontRescan_)
+    {
+    }
+
+    void run()
+    {
+        while (scanner.scanNextFile (dontRescan) && ! threadShouldExit())
+        {}
+    }
+
+private:
+    PluginDirectoryScanner& scanner;
+    const bool dontRescan;
+
+    JUCE_DECLARE_NON_COPYABLE (PluginScanThread)
+};
+
+void PluginScannerPool::scanAll (PluginDirectoryScanner& scanner, const bool dontRescanIfAlreadyInList)
+{
+    OwnedArray<PluginScanThread> threads;
+
+    for (int i = 0; i < maxNumWorkers; ++i)
+    {
+        threads.add (new PluginScanThread (scanner, dontRescanIfAlreadyInList));
+        threads.getLast()->startThread();
+    }
+
+    for (int i = 0; i < threads.size(); ++i)
+        threads.getUnchecked(i)->waitForThreadToExit (-1);
+}
+
+//==============================================================================
+bool PluginScannerPool::handleCommandLine (const String& commandLine, AudioPluginFormatManager& formatsToUse)
+{
+    StringArray args;
+    args.addTokens (commandLine, true);
+    args.trim();
+    args.removeEmptyStrings();
+
+    if (args[0] != pluginScanWorkerFlag || args.size() < 4)
+        return false;
+
+    redirectWorkerProcessOutput();
+
+    const String formatName (args[1].unquoted());
+    const String fileOrIdentifier (args[2].unquoted());
+    XmlElement results ("SCANRESULTS");
+
+    for (int i = 0; i < formatsToUse.getNumFormats(); ++i)
+    {
+        AudioPluginFormat* const format = formatsToUse.getFormat (i);
+
+        if (format->getName() == formatName)
+        {
+            OwnedArray <PluginDescription> found;
+            format->findAllTypesForFile (found, fileOrIdentifier);
+
+            for (int j = 0; j < found.size(); ++j)
+                results.addChildElement (found.getUnchecked(j)->createXml());
+
+            break;
+        }
+    }
+
+    results.writeToFile (File (args[3].unquoted()), String::empty);
+    JUCEApplication::quit();
+    return true;
+}
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_PLUGINSCANNERPOOL_JUCEHEADER__
+#define __JUCE_PLUGINSCANNERPOOL_JUCEHEADER__
+
+#include "juce_KnownPluginList.h"
+#include "juce_PluginDirectoryScanner.h"
+#include "../format/juce_AudioPluginFormatManager.h"
+
+
+//==============================================================================
+/**
+    A KnownPluginList::CustomScanner that loads each plugin file in a separate worker
+    process.
+
+    If a plugin crashes or hangs while it's being scanned, only its worker dies, and the
+    file gets added to the list's blacklist while the scan carries on. Several workers can
+    run at once, so this is best used with several scanning threads - either by calling
+    scanAll(), or by using PluginListComponent::setNumberOfThreadsForScanning().
+
+    The workers are copies of your own executable, launched with a special command-line,
+    so your app must pass its command-line to handleCommandLine() as soon as it starts,
+    and do nothing else if that returns true:
+
+    @code
+    void MyApp::initialise (const String& commandLine)
+    {
+        if (PluginScannerPool::handleCommandLine (commandLine, formatManager))
+            return;
+
+        knownPluginList.setCustomScanner (new PluginScannerPool (4));
+        ...
+    }
+    @endcode
+
+    @see KnownPluginList::setCustomScanner, PluginDirectoryScanner
+*/
+class JUCE_API  PluginScannerPool  : public KnownPluginList::CustomScanner
+{
+public:
+    //==============================================================================
+    /** Creates a pool.
+
+        @param maxNumWorkerProcesses    the most workers that will be allowed to run at once -
+                                        any more scan requests will wait for one to finish
+        @param timeoutMsPerFile         how long a worker may take before it's assumed to have
+                                        hung, and is killed
+    */
+    PluginScannerPool (int maxNumWorkerProcesses, int timeoutMsPerFile = 60000);
+
+    /** Destructor. */
+    ~PluginScannerPool();
+
+    /** Returns the number of workers that can run at once. */
+    int getMaxNumWorkerProcesses() const noexcept               { return maxNumWorkers; }
+
+    //==============================================================================
+    /** Runs a scanner to completion, with one thread for each worker process.
+
+        The files are only loaded in the worker processes if this pool is the custom scanner
+        of the list that the scanner is adding to; otherwise they're just scanned in parallel
+        inside this process.
+    */
+    void scanAll (PluginDirectoryScanner& scanner, bool dontRescanIfAlreadyInList);
+
+    //==============================================================================
+    /** Call this when your app starts, to check whether this process has been launched
+        as a scanning worker.
+
+        If it has, this does the scan, then tells the app to quit and returns true. If it
+        returns false, the app should start up normally.
+    */
+    static bool handleCommandLine (const String& commandLine,
+                                   AudioPluginFormatManager& formatsToUse);
+
+    //==============================================================================
+    /** @internal */
+    bool findPluginTypesFor (AudioPluginFormat& format,
+                             OwnedArray <PluginDescription>& result,
+                             const String& fileOrIdentifier);
+
+private:
+    //==============================================================================
+    const int maxNumWorkers, timeoutMs;
+    int numActiveWorkers;
+    CriticalSection lock;
+    WaitableEvent workerFinished;
+
+    File startWorker();
+    void workerHasFinished (const File&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginScannerPool)
+};
+
+
+#endif   // __JUCE_PLUGINSCANNERPOOL_JUCEHEADER__
@@ -78,19 +78,21 @@ class AudioThumbnail::LevelDataSource   : public TimeSliceClient
 public:
     LevelDataSource (AudioThumbnail& thumb, AudioFormatReader* newReader, int64 hash)
         : lengthInSamples (0), numSamplesFinished (0), sampleRate (0), numChannels (0),
-          hashCode (hash), owner (thumb), reader (newReader)
+          hashCode (hash), owner (thumb), reader (newReader),
+          blockBuffer (2, 1)
     {
     }
 
     LevelDataSource (AudioThumbnail& thumb, InputSource* src)
         : lengthInSamples (0), numSamplesFinished (0), sampleRate (0), numChannels (0),
-          hashCode (src->hashCode()), owner (thumb), source (src)
+          hashCode (src->hashCode()), owner (thumb), source (src),
+          blockBuffer (2, 1)
     {
     }
 
     ~LevelDataSource()
     {
-        owner.cache.getTimeSliceThread().removeTimeSliceClient (this);
+        owner.cache.removeThumbnailClient (this);
     }
 
     enum { timeBeforeDeletingReader = 3000 };
@@ -112,7 +114,7 @@ public:
             if (lengthInSamples <= 0 || isFullyLoaded())
                 reader = nullptr;
             else
-                owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+                owner.cache.addThumbnailClient (this);
         }
     }
 
@@ -127,12 +129,16 @@ public:
             if (reader != nullptr)
             {
                 lastReaderUseTime = Time::getMillisecondCounter();
-                owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+                owner.cache.addThumbnailClient (this);
             }
         }
 
         if (reader != nullptr)
         {
+            // (a memory-mapped reader can only scan the part of the file that it has mapped)
+            if (isMemoryMapped())
+                numSamples = (int) jlimit ((int64) 0, (int64) numSamples, reader->lengthInSamples - startSample);
+
             float l[4] = { 0 };
             reader->readMaxLevels (startSample, numSamples, l[0], l[1], l[2], l[3]);
 
@@ -207,12 +213,43 @@ private:
     ScopedPointer <AudioFormatReader> reader;
     CriticalSection readerLock;
     uint32 lastReaderUseTime;
+    AudioSampleBuffer blockBuffer;
 
     void createReader()
     {
         if (reader == nullptr && source != nullptr)
-            if (InputStream* audioFileStream = source->createInputStream())
-                reader = owner.formatManagerToUse.createReaderFor (audioFileStream);
+        {
+            reader = createMemoryMappedReader();
+
+            if (reader == nullptr)
+                if (InputStream* audioFileStream = source->createInputStream())
+                    reader = owner.formatManagerToUse.createReaderFor (audioFileStream);
+        }
+    }
+
+    // If the source is a file in a format that can be memory-mapped, its levels can be
+    // scanned directly from the mapped data, which is much quicker than reading it.
+    AudioFormatReader* createMemoryMappedReader() const
+    {
+        if (const FileInputSource* const fileSource = dynamic_cast <const FileInputSource*> (source.get()))
+        {
+            const File& file = fileSource->getFile();
+
+            if (AudioFormat* const format = owner.formatManagerToUse.findFormatForFileExtension (file.getFileExtension()))
+            {
+                ScopedPointer<MemoryMappedAudioFormatReader> mappedReader (format->createMemoryMappedReader (file));
+
+                if (mappedReader != nullptr && mappedReader->mapEntireFile())
+                    return mappedReader.release();
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool isMemoryMapped() const noexcept
+    {
+        return dynamic_cast <const MemoryMappedAudioFormatReader*> (reader.get()) != nullptr;
     }
 
     bool readNextBlock()
@@ -234,15 +271,37 @@ private:
                 HeapBlock<MinMaxValue> levelData ((size_t) numThumbSamps * 2);
                 MinMaxValue* levels[2] = { levelData, levelData + numThumbSamps };
 
-                for (int i = 0; i < numThumbSamps; ++i)
+                if (isMemoryMapped())
                 {
-                    float lowestLeft, highestLeft, lowestRight, highestRight;
+                    for (int i = 0; i < numThumbSamps; ++i)
+                    {
+                        float lowestLeft, highestLeft, lowestRight, highestRight;
 
-                    reader->readMaxLevels ((firstThumbIndex + i) * owner.samplesPerThumbSample, owner.samplesPerThumbSample,
-                                           lowestLeft, highestLeft, lowestRight, highestRight);
+                        reader->readMaxLevels ((firstThumbIndex + i) * (int64) owner.samplesPerThumbSample, owner.samplesPerThumbSample,
+                                               lowestLeft, highestLeft, lowestRight, highestRight);
 
-                    levels[0][i].setFloat (lowestLeft, highestLeft);
-                    levels[1][i].setFloat (lowestRight, highestRight);
+                        levels[0][i].setFloat (lowestLeft, highestLeft);
+                        levels[1][i].setFloat (lowestRight, highestRight);
+                    }
+                }
+                else
+                {
+                    // reading the whole block in one go avoids the overhead of calling readMaxLevels()
+                    // separately for every thumbnail sample
+                    const int numSamps = numThumbSamps * owner.samplesPerThumbSample;
+                    blockBuffer.setSize (2, numSamps, false, false, true);
+                    reader->read (&blockBuffer, 0, numSamps, firstThumbIndex * (int64) owner.samplesPerThumbSample, true, true);
+
+                    for (int chan = 0; chan < 2; ++chan)
+                    {
+                        for (int i = 0; i < numThumbSamps; ++i)
+                        {
+                            float low, high;
+                            FloatVectorOperations::findMinAndMax (blockBuffer.getSampleData (chan, i * owner.samplesPerThumbSample),
+                                                                  owner.samplesPerThumbSample, low, high);
+                            levels[chan][i].setFloat (low, high);
+                        }
+                    }
                 }
 
                 {
@@ -260,6 +319,11 @@ private:
 };
 
 //==============================================================================
+/*  As well as the thumbnail's own samples, this keeps a pyramid of coarser levels, where each
+    value holds the range of levelScale values from the level below. A range of any length can
+    then be measured by only visiting a handful of values from each level, so drawing a long
+    file while zoomed out doesn't mean iterating over every one of its thumbnail samples.
+*/
 class AudioThumbnail::ThumbData
 {
 public:
@@ -269,6 +333,8 @@ public:
         ensureSize (numThumbSamples);
     }
 
+    enum { levelScale = 4 };
+
     inline MinMaxValue* getData (const int thumbSampleIndex) noexcept
     {
         jassert (thumbSampleIndex < data.size());
@@ -289,14 +355,28 @@ public:
             char mx = -128;
             char mn = 127;
 
-            while (startSample <= endSample)
+            for (int level = 0; startSample <= endSample; ++level)
             {
-                const MinMaxValue& v = data.getReference (startSample);
+                const Array<MinMaxValue>& values = getLevel (level);
+
+                if (level < coarserLevels.size())
+                {
+                    // take the values at each end that don't fill a whole value of the next level..
+                    while (startSample <= endSample && (startSample % levelScale) != 0)
+                        addToRange (values.getReference (startSample++), mn, mx);
 
-                if (v.getMinValue() < mn)  mn = v.getMinValue();
-                if (v.getMaxValue() > mx)  mx = v.getMaxValue();
+                    while (startSample <= endSample && ((endSample + 1) % levelScale) != 0)
+                        addToRange (values.getReference (endSample--), mn, mx);
 
-                ++startSample;
+                    // ..and let the next level deal with the aligned part in the middle
+                    startSample /= levelScale;
+                    endSample = (endSample + 1) / levelScale - 1;
+                }
+                else
+                {
+                    while (startSample <= endSample)
+                        addToRange (values.getReference (startSample++), mn, mx);
+                }
             }
 
             if (mn <= mx)
@@ -320,6 +400,35 @@ public:
 
         for (int i = 0; i < numValues; ++i)
             dest[i] = values[i];
+
+        updateLevels (startIndex, numValues);
+    }
+
+    // Recalculates the coarser levels after some of the thumbnail's samples have been changed.
+    void updateLevels (int startIndex, int numValues)
+    {
+        for (int level = 0; level < coarserLevels.size() && numValues > 0; ++level)
+        {
+            const Array<MinMaxValue>& source = getLevel (level);
+            Array<MinMaxValue>& dest = *coarserLevels.getUnchecked (level);
+
+            const int first = startIndex / levelScale;
+            const int last  = (startIndex + numValues - 1) / levelScale;
+
+            for (int i = first; i <= last; ++i)
+            {
+                char mx = -128;
+                char mn = 127;
+
+                for (int j = i * levelScale; j < jmin ((i + 1) * levelScale, source.size()); ++j)
+                    addToRange (source.getReference (j), mn, mx);
+
+                dest.getReference (i).set (mn, mx);
+            }
+
+            startIndex = first;
+            numValues = last + 1 - first;
+        }
     }
 
     void resetPeak() noexcept
@@ -331,9 +440,12 @@ public:
     {
         if (peakLevel < 0)
         {
-            for (int i = 0; i < data.size(); ++i)
+            // (the coarsest level covers all the data, and is the smallest one to search)
+            const Array<MinMaxValue>& values = getLevel (coarserLevels.size());
+
+            for (int i = 0; i < values.size(); ++i)
             {
-                const int peak = data[i].getPeak();
+                const int peak = values.getReference (i).getPeak();
                 if (peak > peakLevel)
                     peakLevel = peak;
             }
@@ -344,16 +456,290 @@ public:
 
 private:
     Array <MinMaxValue> data;
+    OwnedArray <Array <MinMaxValue> > coarserLevels;
     int peakLevel;
 
+    const Array<MinMaxValue>& getLevel (const int level) const noexcept
+    {
+        return level == 0 ? data : *coarserLevels.getUnchecked (level - 1);
+    }
+
+    static inline void addToRange (const MinMaxValue& v, char& mn, char& mx) noexcept
+    {
+        if (v.getMinValue() < mn)  mn = v.getMinValue();
+        if (v.getMaxValue() > mx)  mx = v.getMaxValue();
+    }
+
     void ensureSize (const int thumbSamples)
     {
-        const int extraNeeded = thumbSamples - data.size();
+        const int oldSize = data.size();
+        const int extraNeeded = thumbSamples - oldSize;
+
         if (extraNeeded > 0)
+        {
             data.insertMultiple (-1, MinMaxValue(), extraNeeded);
+
+            const int oldNumLevels = coarserLevels.size();
+            int levelSize = data.size();
+
+            for (int level = 0; levelSize > levelScale; ++level)
+            {
+                levelSize = (levelSize + levelScale - 1) / levelScale;
+
+                if (level >= coarserLevels.size())
+                    coarserLevels.add (new Array<MinMaxValue>());
+
+                Array<MinMaxValue>& values = *coarserLevels.getUnchecked (level);
+                values.insertMultiple (-1, MinMaxValue(), levelSize - values.size());
+            }
+
+            // a new level needs filling in from scratch, but otherwise only the values
+            // that cover the new samples have changed
+            if (coarserLevels.size() > oldNumLevels)
+                updateLevels (0, data.size());
+            else
+                updateLevels (oldSize, extraNeeded);
+        }
     }
 };
 
+#if JUCE_MODULE_AVAILABLE_juce_opengl && JUCE_USE_OPENGL_SHADERS
+//==============================================================================
+/*  Draws thumbnails that are being painted into a component with an OpenGLContext attached.
+
+    Rather than drawing a vertical line through the Graphics context for each pixel, the
+    min/max levels are uploaded as a one-pixel-high texture, and a shader turns them into
+    an alpha mask of the waveform, which is then filled with the current brush.
+
+    This happens in the middle of the GL renderer's own drawing, which caches a lot of the
+    GL state, so everything that gets changed here is put back afterwards.
+*/
+class AudioThumbnailOpenGLRenderer  : public ReferenceCountedObject
+{
+public:
+    static bool drawWaveform (Graphics& g, const Rectangle<int>& area,
+                              const PixelARGB* const levels, const float verticalScale)
+    {
+        OpenGLContext* const context = OpenGLContext::getCurrentContext();
+
+        if (context == nullptr || g.isVectorDevice() || ! context->areShadersAvailable())
+            return false;
+
+        static const char rendererID[] = "juceAudioThumbnailRenderer";
+        AudioThumbnailOpenGLRenderer* renderer = static_cast <AudioThumbnailOpenGLRenderer*> (context->getAssociatedObject (rendererID));
+
+        if (renderer == nullptr)
+        {
+            renderer = new AudioThumbnailOpenGLRenderer (*context);
+            context->setAssociatedObject (rendererID, renderer);
+        }
+
+        if (! renderer->linkedOk)
+            return false;
+
+        Image image;
+
+        {
+            const SavedGLState savedState (*context, (GLuint) renderer->position.attributeID);
+            image = renderer->render (levels, area.getWidth(), area.getHeight(), verticalScale);
+        }
+
+        if (! image.isValid())
+            return false;
+
+        g.drawImageAt (image, area.getX(), area.getY(), true);
+        return true;
+    }
+
+    static PixelARGB getLevelPixel (const char minValue, const char maxValue) noexcept
+    {
+        // the max level goes in both red and blue so it doesn't matter which byte order the texture uses
+        return PixelARGB (maxValue > minValue ? 0xff : 0,
+                          (uint8) (maxValue + 128), (uint8) (minValue + 128), (uint8) (maxValue + 128));
+    }
+
+private:
+    AudioThumbnailOpenGLRenderer (OpenGLContext& context_)
+        : context (context_),
+          program (context),
+          linkedOk (buildProgram (program)),
+          position (program, "position"),
+          screenSize (program, "screenSize"),
+          levelsTexture (program, "levels"),
+          textureWidth (program, "textureWidth"),
+          verticalScale (program, "verticalScale")
+    {
+    }
+
+    OpenGLContext& context;
+    OpenGLShaderProgram program;
+    const bool linkedOk;
+    OpenGLShaderProgram::Attribute position;
+    OpenGLShaderProgram::Uniform screenSize, levelsTexture, textureWidth, verticalScale;
+    OpenGLTexture levels;
+    Array<Image> images;
+
+    enum { maxNumImages = 8 };
+
+   #if JUCE_OPENGL_ES
+    #define JUCE_THUMBNAIL_PRECISION "precision highp float;"
+   #else
+    #define JUCE_THUMBNAIL_PRECISION
+   #endif
+
+    static bool buildProgram (OpenGLShaderProgram& prog)
+    {
+        return prog.addShader (JUCE_THUMBNAIL_PRECISION
+                               "attribute vec2 position;"
+                               "uniform vec2 screenSize;"
+                               "varying vec2 pixelPos;"
+                               "void main()"
+                               "{"
+                               " pixelPos = position;"
+                               " vec2 scaled = position / (0.5 * screenSize);"
+                               " gl_Position = vec4 (scaled.x - 1.0, 1.0 - scaled.y, 0, 1.0);"
+                               "}", GL_VERTEX_SHADER)
+            && prog.addShader (JUCE_THUMBNAIL_PRECISION
+                               "uniform sampler2D levels;"
+                               "uniform float textureWidth;"
+                               "uniform float verticalScale;"
+                               "uniform vec2 screenSize;"
+                               "varying vec2 pixelPos;"
+                               "void main()"
+                               "{"
+                               " vec4 level = texture2D (levels, vec2 ((floor (pixelPos.x) + 0.5) / textureWidth, 0.5));"
+                               " float midY = screenSize.y * 0.5;"
+                               " float top = max (midY - (level.r * 255.0 - 128.0) * verticalScale - 0.3, 0.0);"
+                               " float bottom = min (midY - (level.g * 255.0 - 128.0) * verticalScale + 0.3, screenSize.y);"
+                               " float y = floor (pixelPos.y);"
+                               " gl_FragColor = vec4 (level.a * clamp (min (y + 1.0, bottom) - max (y, top), 0.0, 1.0));"
+                               "}", GL_FRAGMENT_SHADER)
+            && prog.link();
+    }
+
+   #undef JUCE_THUMBNAIL_PRECISION
+
+    Image render (const PixelARGB* const levelData, const int width, const int height, const float scale)
+    {
+        Image image (getImage (width, height));
+        OpenGLFrameBuffer* const frameBuffer = OpenGLImageType::getFrameBufferFrom (image);
+
+        if (frameBuffer == nullptr || ! frameBuffer->makeCurrentRenderingTarget())
+            return Image::null;
+
+        glViewport (0, 0, width, height);
+        glDisable (GL_BLEND);
+
+        context.extensions.glActiveTexture (GL_TEXTURE0);
+        levels.loadARGB (levelData, width, 1);
+
+        program.use();
+        screenSize.set ((GLfloat) width, (GLfloat) height);
+        levelsTexture.set ((GLint) 0);
+        textureWidth.set ((GLfloat) levels.getWidth());
+        verticalScale.set (scale);
+
+        const GLshort w = (GLshort) width, h = (GLshort) height;
+        const GLshort vertices[] = { 0, h, w, h, 0, 0, w, 0 };
+
+        context.extensions.glBindBuffer (GL_ARRAY_BUFFER, 0);
+        context.extensions.glVertexAttribPointer ((GLuint) position.attributeID, 2, GL_SHORT, GL_FALSE, 4, vertices);
+        context.extensions.glEnableVertexAttribArray ((GLuint) position.attributeID);
+
+        glDrawArrays (GL_TRIANGLE_STRIP, 0, 4);
+        return image;
+    }
+
+    Image getImage (const int width, const int height)
+    {
+        for (int i = images.size(); --i >= 0;)
+        {
+            const Image image (images.getReference (i));
+
+            if (image.getWidth() == width && image.getHeight() == height)
+            {
+                images.remove (i);
+                images.add (image);
+                return image;
+            }
+        }
+
+        if (images.size() >= maxNumImages)
+            images.remove (0);
+
+        const Image image (Image::ARGB, width, height, false, OpenGLImageType());
+        images.add (image);
+        return image;
+    }
+
+    //==============================================================================
+    struct SavedGLState
+    {
+        SavedGLState (OpenGLContext& context_, const GLuint attribute_)
+            : context (context_), attribute (attribute_),
+              frameBuffer (OpenGLFrameBuffer::getCurrentFrameBufferTarget()),
+              blendEnabled (glIsEnabled (GL_BLEND)),
+              attribPointer (nullptr)
+        {
+            glGetIntegerv (GL_CURRENT_PROGRAM, &program);
+            glGetIntegerv (GL_ACTIVE_TEXTURE, &activeTexture);
+            glGetIntegerv (GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+            glGetIntegerv (GL_VIEWPORT, viewport);
+
+            context.extensions.glActiveTexture (GL_TEXTURE0);
+            glGetIntegerv (GL_TEXTURE_BINDING_2D, &texture);
+
+            context.extensions.glGetVertexAttribiv (attribute, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &attribEnabled);
+            context.extensions.glGetVertexAttribiv (attribute, GL_VERTEX_ATTRIB_ARRAY_SIZE, &attribSize);
+            context.extensions.glGetVertexAttribiv (attribute, GL_VERTEX_ATTRIB_ARRAY_TYPE, &attribType);
+            context.extensions.glGetVertexAttribiv (attribute, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, &attribNormalised);
+            context.extensions.glGetVertexAttribiv (attribute, GL_VERTEX_ATTRIB_ARRAY_STRIDE, &attribStride);
+            context.extensions.glGetVertexAttribiv (attribute, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &attribBuffer);
+            context.extensions.glGetVertexAttribPointerv (attribute, GL_VERTEX_ATTRIB_ARRAY_POINTER, &attribPointer);
+        }
+
+        ~SavedGLState()
+        {
+            context.extensions.glBindBuffer (GL_ARRAY_BUFFER, (GLuint) attribBuffer);
+
+            if (attribBuffer != 0 || attribPointer != nullptr)
+                context.extensions.glVertexAttribPointer (attribute, attribSize, (GLenum) attribType,
+                                                          (GLboolean) attribNormalised, attribStride, attribPointer);
+
+            if (attribEnabled != 0)
+                context.extensions.glEnableVertexAttribArray (attribute);
+            else
+                context.extensions.glDisableVertexAttribArray (attribute);
+
+            context.extensions.glBindBuffer (GL_ARRAY_BUFFER, (GLuint) arrayBuffer);
+            context.extensions.glBindFramebuffer (GL_FRAMEBUFFER, frameBuffer);
+            glViewport (viewport[0], viewport[1], viewport[2], viewport[3]);
+
+            if (blendEnabled)
+                glEnable (GL_BLEND);
+            else
+                glDisable (GL_BLEND);
+
+            glBindTexture (GL_TEXTURE_2D, (GLuint) texture);
+            context.extensions.glActiveTexture ((GLenum) activeTexture);
+            context.extensions.glUseProgram ((GLuint) program);
+        }
+
+        OpenGLContext& context;
+        const GLuint attribute;
+        const GLuint frameBuffer;
+        const GLboolean blendEnabled;
+        GLint program, activeTexture, arrayBuffer, texture, viewport[4];
+        GLint attribEnabled, attribSize, attribType, attribNormalised, attribStride, attribBuffer;
+        GLvoid* attribPointer;
+
+        JUCE_DECLARE_NON_COPYABLE (SavedGLState)
+    };
+
+    JUCE_DECLARE_NON_COPYABLE (AudioThumbnailOpenGLRenderer)
+};
+#endif
+
 //==============================================================================
 class AudioThumbnail::CachedWindow
 {
@@ -362,6 +748,9 @@ public:
         : cachedStart (0), cachedTimePerPixel (0),
           numChannelsCached (0), numSamplesCached (0),
           cacheNeedsRefilling (true)
+         #if JUCE_MODULE_AVAILABLE_juce_opengl && JUCE_USE_OPENGL_SHADERS
+          , numOpenGLLevelsAllocated (0)
+         #endif
     {
     }
 
@@ -384,6 +773,11 @@ public:
 
             if (! clip.isEmpty())
             {
+               #if JUCE_MODULE_AVAILABLE_juce_opengl && JUCE_USE_OPENGL_SHADERS
+                if (drawChannelWithOpenGL (g, area, channelNum, verticalZoomFactor))
+                    return;
+               #endif
+
                 const float topY = (float) area.getY();
                 const float bottomY = (float) area.getBottom();
                 const float midY = (topY + bottomY) * 0.5f;
@@ -411,6 +805,32 @@ private:
     int numChannelsCached, numSamplesCached;
     bool cacheNeedsRefilling;
 
+   #if JUCE_MODULE_AVAILABLE_juce_opengl && JUCE_USE_OPENGL_SHADERS
+    HeapBlock<PixelARGB> openGLLevels;
+    int numOpenGLLevelsAllocated;
+
+    bool drawChannelWithOpenGL (Graphics& g, const Rectangle<int>& area,
+                                const int channelNum, const float verticalZoomFactor)
+    {
+        const int width = jmin (numSamplesCached, area.getWidth());
+
+        if (width > numOpenGLLevelsAllocated)
+        {
+            numOpenGLLevelsAllocated = width;
+            openGLLevels.malloc ((size_t) width);
+        }
+
+        const MinMaxValue* cacheData = getData (channelNum, 0);
+
+        for (int i = 0; i < width; ++i)
+            openGLLevels[i] = AudioThumbnailOpenGLRenderer::getLevelPixel (cacheData[i].getMinValue(),
+                                                                          cacheData[i].getMaxValue());
+
+        return AudioThumbnailOpenGLRenderer::drawWaveform (g, area.withWidth (width), openGLLevels,
+                                                          verticalZoomFactor * area.getHeight() / 256.0f);
+    }
+   #endif
+
     bool refillCache (const int numSamples, double startTime, const double endTime,
                       const double rate, const int numChans, const int sampsPerThumbSample,
                       LevelDataSource* levelData, const OwnedArray<ThumbData>& chans)
@@ -597,6 +1017,9 @@ bool AudioThumbnail::loadFrom (InputStream& rawInput)
         for (int chan = 0; chan < numChannels; ++chan)
             channels.getUnchecked(chan)->getData(i)->read (input);
 
+    for (int chan = 0; chan < numChannels; ++chan)
+        channels.getUnchecked(chan)->updateLevels (0, numThumbnailSamples);
+
     return true;
 }
 
@@ -692,7 +1115,7 @@ void AudioThumbnail::addBlock (const int64 startSample, const AudioSampleBuffer&
 
         for (int chan = 0; chan < numChans; ++chan)
         {
-            const float* const sourceData = incoming.getSampleData (chan, startOffsetInBuffer);
+            const float* const sourceData = incoming.getReadPointer (chan, startOffsetInBuffer);
             MinMaxValue* const dest = thumbData + numToDo * chan;
             thumbChannels [chan] = dest;
 
@@ -788,6 +1211,10 @@ void AudioThumbnail::drawChannel (Graphics& g, const Rectangle<int>& area, doubl
 {
     const ScopedLock sl (lock);
 
+    // (any thumbnails that are on-screen get finished before the ones that aren't)
+    if (source != nullptr && ! isFullyLoaded())
+        cache.prioritiseThumbnailClient (source);
+
     window->drawChannel (g, area, startTime, endTime, channelNum, verticalZoomFactor,
                          sampleRate, numChannels, samplesPerThumbSample, source, channels);
 }
@@ -144,6 +144,10 @@ public:
         The waveform will be scaled vertically so that a full-volume sample will fill
         the rectangle vertically, but you can also specify an extra vertical scale factor
         with the verticalZoomFactor parameter.
+
+        If the juce_opengl module is available and this is being called while an
+        OpenGLContext is painting its component, the waveform is rendered by a shader
+        from a texture of the level data, instead of being drawn line-by-line.
     */
     void drawChannel (Graphics& g,
                       const Rectangle<int>& area,
@@ -56,18 +56,502 @@ private:
 };
 
 //==============================================================================
-AudioThumbnailCache::AudioThumbnailCache (const int maxNumThumbs)
+/*  Shares out the thumbnail clients between a set of ThreadPool jobs. Each job repeatedly
+    picks the client that's been prioritised most recently (or the one that's waited longest,
+    if none have) and gives it a time-slice, so no client is ever run by two threads at once.
+*/
+class AudioThumbnailCache::ThumbnailThreadPool
+{
+public:
+    ThumbnailThreadPool (const int numThreads_)
+        : numThreads (numThreads_), pool (numThreads_), lastPriority (0)
+    {
+        for (int i = 0; i < numThreads; ++i)
+            pool.addJob (new Worker (*this), true);
+    }
+
+    ~ThumbnailThreadPool()
+    {
+        pool.removeAllJobs (true, 10000);
+    }
+
+    void addClient (TimeSliceClient* const client)
+    {
+        {
+            const ScopedLock sl (lock);
+            const int index = indexOf (client);
+
+            if (index >= 0)
+            {
+                clients.getReference (index).nextCallTime = Time::getMillisecondCounter();
+            }
+            else
+            {
+                const ClientInfo info = { client, Time::getMillisecondCounter(), 0, false };
+                clients.add (info);
+            }
+        }
+
+        workAvailable.signal();
+    }
+
+    void removeClient (TimeSliceClient* const client)
+    {
+        const ScopedLock sl (lock);
+
+        for (;;)
+        {
+            const int index = indexOf (client);
+
+            if (index < 0)
+                break;
+
+            if (! clients.getReference (index).isRunning)
+            {
+                clients.remove (index);
+                break;
+            }
+
+            const ScopedUnlock su (lock);
+            clientFinished.wait (10);
+        }
+    }
+
+    void prioritiseClient (TimeSliceClient* const client)
+    {
+        {
+            const ScopedLock sl (lock);
+            const int index = indexOf (client);
+
+            if (index < 0)
+                return;
+
+            ClientInfo& info = clients.getReference (index);
+            info.priority = ++lastPriority;
+            info.nextCallTime = Time::getMillisecondCounter();
+        }
+
+        workAvailable.signal();
+    }
+
+    const int numThreads;
+
+private:
+    struct ClientInfo
+    {
+        TimeSliceClient* client;
+        uint32 nextCallTime, priority;
+        bool isRunning;
+    };
+
+    class Worker  : public ThreadPoolJob
+    {
+    public:
+        Worker (ThumbnailThreadPool& owner_)
+            : ThreadPoolJob ("thumbnail worker"), owner (owner_)
+        {
+        }
+
+        JobStatus runJob()
+        {
+            while (! shouldExit())
+            {
+                int timeToWait = 0;
+
+                if (TimeSliceClient* const client = owner.startNextClient (timeToWait))
+                    owner.clientHasFinished (client, client->useTimeSlice());
+                else
+                    owner.workAvailable.wait (timeToWait);
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        ThumbnailThreadPool& owner;
+
+        JUCE_DECLARE_NON_COPYABLE (Worker)
+    };
+
+    friend class Worker;
+
+    ThreadPool pool;
+    Array<ClientInfo> clients;
+    CriticalSection lock;
+    WaitableEvent workAvailable, clientFinished;
+    uint32 lastPriority;
+
+    int indexOf (TimeSliceClient* const client) const noexcept
+    {
+        for (int i = clients.size(); --i >= 0;)
+            if (clients.getReference (i).client == client)
+                return i;
+
+        return -1;
+    }
+
+    TimeSliceClient* startNextClient (int& timeToWait)
+    {
+        const ScopedLock sl (lock);
+        const uint32 now = Time::getMillisecondCounter();
+        timeToWait = 100;
+        int best = -1;
+
+        for (int i = 0; i < clients.size(); ++i)
+        {
+            const ClientInfo& info = clients.getReference (i);
+
+            if (! info.isRunning)
+            {
+                const int msUntilDue = (int) (info.nextCallTime - now);
+
+                if (msUntilDue <= 0)
+                {
+                    if (best < 0 || info.priority > clients.getReference (best).priority)
+                        best = i;
+                }
+                else
+                {
+                    timeToWait = jmin (timeToWait, msUntilDue);
+                }
+            }
+        }
+
+        if (best < 0)
+            return nullptr;
+
+        ClientInfo& info = clients.getReference (best);
+        info.isRunning = true;
+        return info.client;
+    }
+
+    void clientHasFinished (TimeSliceClient* const client, const int msUntilNextCall)
+    {
+        {
+            const ScopedLock sl (lock);
+            const int index = indexOf (client);
+
+            if (index >= 0)
+            {
+                ClientInfo info (clients.getReference (index));
+                clients.remove (index);
+
+                // (moving it to the back of the queue lets the others that have the same priority take a turn)
+                if (msUntilNextCall >= 0)
+                {
+                    info.isRunning = false;
+                    info.nextCallTime = Time::getMillisecondCounter() + (uint32) msUntilNextCall;
+                    clients.add (info);
+                }
+            }
+        }
+
+        clientFinished.signal();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ThumbnailThreadPool)
+};
+
+//==============================================================================
+/*  Keeps track of the thumbnail files in a disk cache directory.
+
+    The index file is a short header followed by a fixed-size record for each thumbnail,
+    sorted by hash code. It stays memory-mapped, so a lookup is just a binary search of
+    the mapped data, and marking a thumbnail as used only touches its own record. The
+    index is only re-written when thumbnails are added or removed.
+*/
+class AudioThumbnailCache::DiskIndex
+{
+public:
+    DiskIndex (const File& directory_, const int64 maxNumBytes_)
+        : directory (directory_), maxNumBytes (maxNumBytes_)
+    {
+        openIndex();
+    }
+
+    const File directory;
+    int64 maxNumBytes;
+
+    bool read (const int64 hash, MemoryBlock& data)
+    {
+        const int index = findRecord (hash);
+
+        if (index < 0)
+            return false;
+
+        if (getThumbFile (hash).loadFileAsData (data) && data.getSize() > 0)
+        {
+            setInt64 (getRecordData (index) + lastUsedOffset, Time::currentTimeMillis());
+            return true;
+        }
+
+        remove (hash);
+        return false;
+    }
+
+    void write (const int64 hash, const MemoryBlock& data)
+    {
+        {
+            TemporaryFile temp (getThumbFile (hash));
+
+            if (! (temp.getFile().replaceWithData (data.getData(), data.getSize())
+                    && temp.overwriteTargetFileWithTemporary()))
+                return;
+        }
+
+        Array<Record> records;
+        getRecords (records);
+        removeRecord (records, hash);
+
+        const Record r = { hash, (int64) data.getSize(), Time::currentTimeMillis() };
+        records.add (r);
+
+        removeLeastRecentlyUsed (records, hash);
+        writeIndex (records);
+    }
+
+    void remove (const int64 hash)
+    {
+        getThumbFile (hash).deleteFile();
+
+        if (findRecord (hash) >= 0)
+        {
+            Array<Record> records;
+            getRecords (records);
+            removeRecord (records, hash);
+            writeIndex (records);
+        }
+    }
+
+    int64 getTotalSize() const
+    {
+        int64 total = 0;
+
+        for (int i = getNumRecords(); --i >= 0;)
+            total += getInt64 (getRecordData (i) + sizeOffset);
+
+        return total;
+    }
+
+private:
+    //==============================================================================
+    struct Record
+    {
+        int64 hash, numBytes, lastUsed;
+    };
+
+    enum
+    {
+        headerSize = 8,
+        recordSize = 24,
+        hashOffset = 0,
+        sizeOffset = 8,
+        lastUsedOffset = 16
+    };
+
+    ScopedPointer<MemoryMappedFile> map;
+
+    File getIndexFile() const                       { return directory.getChildFile ("thumbnails.index"); }
+    File getThumbFile (const int64 hash) const      { return directory.getChildFile (String::toHexString (hash) + ".thumb"); }
+
+    static int getIndexMagicHeader() noexcept       { return (int) ByteOrder::littleEndianInt ("ThmI"); }
+
+    static int64 getInt64 (const char* const data) noexcept
+    {
+        uint64 v;
+        memcpy (&v, data, sizeof (v));
+        return (int64) ByteOrder::swapIfBigEndian (v);
+    }
+
+    static void setInt64 (char* const data, const int64 value) noexcept
+    {
+        const uint64 v = ByteOrder::swapIfBigEndian ((uint64) value);
+        memcpy (data, &v, sizeof (v));
+    }
+
+    int getNumRecords() const noexcept
+    {
+        return map != nullptr ? (int) ((map->getSize() - headerSize) / recordSize) : 0;
+    }
+
+    char* getRecordData (const int index) const noexcept
+    {
+        return static_cast <char*> (map->getData()) + headerSize + index * recordSize;
+    }
+
+    int findRecord (const int64 hash) const noexcept
+    {
+        int start = 0, end = getNumRecords();
+
+        while (start < end)
+        {
+            const int mid = (start + end) / 2;
+            const int64 midHash = getInt64 (getRecordData (mid) + hashOffset);
+
+            if (midHash == hash)
+                return mid;
+
+            if (midHash < hash)
+                start = mid + 1;
+            else
+                end = mid;
+        }
+
+        return -1;
+    }
+
+    void getRecords (Array<Record>& records) const
+    {
+        for (int i = 0; i < getNumRecords(); ++i)
+        {
+            const char* const data = getRecordData (i);
+            const Record r = { getInt64 (data + hashOffset), getInt64 (data + sizeOffset), getInt64 (data + lastUsedOffset) };
+            records.add (r);
+        }
+    }
+
+    static void removeRecord (Array<Record>& records, const int64 hash)
+    {
+        for (int i = records.size(); --i >= 0;)
+            if (records.getReference (i).hash == hash)
+                records.remove (i);
+    }
+
+    void removeLeastRecentlyUsed (Array<Record>& records, const int64 hashToKeep)
+    {
+        int64 total = 0;
+
+        for (int i = records.size(); --i >= 0;)
+            total += records.getReference (i).numBytes;
+
+        while (total > maxNumBytes && records.size() > 1)
+        {
+            int oldest = -1;
+
+            for (int i = records.size(); --i >= 0;)
+                if (records.getReference (i).hash != hashToKeep
+                     && (oldest < 0 || records.getReference (i).lastUsed < records.getReference (oldest).lastUsed))
+                    oldest = i;
+
+            getThumbFile (records.getReference (oldest).hash).deleteFile();
+            total -= records.getReference (oldest).numBytes;
+            records.remove (oldest);
+        }
+    }
+
+    struct HashComparator
+    {
+        static int compareElements (const Record& first, const Record& second) noexcept
+        {
+            return first.hash < second.hash ? -1 : (first.hash > second.hash ? 1 : 0);
+        }
+    };
+
+    void writeIndex (Array<Record>& records)
+    {
+        HashComparator comparator;
+        records.sort (comparator);
+
+        MemoryOutputStream out;
+        out.writeInt (getIndexMagicHeader());
+        out.writeInt (1); // version
+
+        for (int i = 0; i < records.size(); ++i)
+        {
+            const Record& r = records.getReference (i);
+            out.writeInt64 (r.hash);
+            out.writeInt64 (r.numBytes);
+            out.writeInt64 (r.lastUsed);
+        }
+
+        map = nullptr;
+
+        {
+            TemporaryFile temp (getIndexFile());
+
+            if (temp.getFile().replaceWithData (out.getData(), out.getDataSize()))
+                temp.overwriteTargetFileWithTemporary();
+        }
+
+        mapIndex();
+    }
+
+    void mapIndex()
+    {
+        map = new MemoryMappedFile (getIndexFile(), MemoryMappedFile::readWrite);
+
+        if (map->getData() == nullptr || map->getSize() < headerSize
+             || (int) ByteOrder::littleEndianInt (map->getData()) != getIndexMagicHeader())
+            map = nullptr;
+    }
+
+    void openIndex()
+    {
+        mapIndex();
+
+        if (map == nullptr)
+        {
+            // without a valid index, there's no way of knowing which of the thumbnails are
+            // still wanted, so they're all thrown away
+            Array<File> oldThumbs;
+            directory.findChildFiles (oldThumbs, File::findFiles, false, "*.thumb");
+
+            for (int i = oldThumbs.size(); --i >= 0;)
+                oldThumbs.getReference (i).deleteFile();
+
+            Array<Record> noRecords;
+            writeIndex (noRecords);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (DiskIndex)
+};
+
+//==============================================================================
+AudioThumbnailCache::AudioThumbnailCache (const int maxNumThumbs, const int numThumbnailThreads)
     : thread ("thumb cache"),
       maxNumThumbsToStore (maxNumThumbs)
 {
     jassert (maxNumThumbsToStore > 0);
     thread.startThread (2);
+
+    if (numThumbnailThreads > 0)
+        threadPool = new ThumbnailThreadPool (numThumbnailThreads);
 }
 
 AudioThumbnailCache::~AudioThumbnailCache()
 {
 }
 
+int AudioThumbnailCache::getNumThumbnailThreads() const noexcept
+{
+    return threadPool != nullptr ? threadPool->numThreads : 0;
+}
+
+void AudioThumbnailCache::addThumbnailClient (TimeSliceClient* const client)
+{
+    if (threadPool != nullptr)
+        threadPool->addClient (client);
+    else
+        thread.addTimeSliceClient (client);
+}
+
+void AudioThumbnailCache::removeThumbnailClient (TimeSliceClient* const client)
+{
+    if (threadPool != nullptr)
+        threadPool->removeClient (client);
+    else
+        thread.removeTimeSliceClient (client);
+}
+
+void AudioThumbnailCache::prioritiseThumbnailClient (TimeSliceClient* const client)
+{
+    if (threadPool != nullptr)
+        threadPool->prioritiseClient (client);
+    else
+        thread.moveToFrontOfQueue (client);
+}
+
 AudioThumbnailCache::ThumbnailCacheEntry* AudioThumbnailCache::findThumbFor (const int64 hash) const
 {
     for (int i = thumbs.size(); --i >= 0;)
@@ -77,6 +561,18 @@ AudioThumbnailCache::ThumbnailCacheEntry* AudioThumbnailCache::findThumbFor (con
     return nullptr;
 }
 
+AudioThumbnailCache::ThumbnailCacheEntry* AudioThumbnailCache::createThumbFor (const int64 hash)
+{
+    ThumbnailCacheEntry* const te = new ThumbnailCacheEntry (hash);
+
+    if (thumbs.size() < maxNumThumbsToStore)
+        thumbs.add (te);
+    else
+        thumbs.set (findOldestThumb(), te);
+
+    return te;
+}
+
 int AudioThumbnailCache::findOldestThumb() const
 {
     int oldest = 0;
@@ -109,6 +605,21 @@ bool AudioThumbnailCache::loadThumb (AudioThumbnailBase& thumb, const int64 hash
         return true;
     }
 
+    if (diskIndex != nullptr)
+    {
+        MemoryBlock data;
+
+        if (diskIndex->read (hashCode, data))
+        {
+            ThumbnailCacheEntry* const te = createThumbFor (hashCode);
+            te->data.swapWith (data);
+
+            MemoryInputStream in (te->data, false);
+            thumb.loadFrom (in);
+            return true;
+        }
+    }
+
     return loadNewThumb (thumb, hashCode);
 }
 
@@ -119,20 +630,16 @@ void AudioThumbnailCache::storeThumb (const AudioThumbnailBase& thumb,
     ThumbnailCacheEntry* te = findThumbFor (hashCode);
 
     if (te == nullptr)
-    {
-        te = new ThumbnailCacheEntry (hashCode);
-
-        if (thumbs.size() < maxNumThumbsToStore)
-            thumbs.add (te);
-        else
-            thumbs.set (findOldestThumb(), te);
-    }
+        te = createThumbFor (hashCode);
 
     {
         MemoryOutputStream out (te->data, false);
         thumb.saveTo (out);
     }
 
+    if (diskIndex != nullptr)
+        diskIndex->write (hashCode, te->data);
+
     saveNewlyFinishedThumbnail (thumb, hashCode);
 }
 
@@ -149,6 +656,9 @@ void AudioThumbnailCache::removeThumb (const int64 hashCode)
     for (int i = thumbs.size(); --i >= 0;)
         if (thumbs.getUnchecked(i)->hash == hashCode)
             thumbs.remove (i);
+
+    if (diskIndex != nullptr)
+        diskIndex->remove (hashCode);
 }
 
 static inline int getThumbnailCacheFileMagicHeader() noexcept
@@ -182,6 +692,44 @@ void AudioThumbnailCache::writeToStream (OutputStream& out)
         thumbs.getUnchecked(i)->write (out);
 }
 
+//==============================================================================
+bool AudioThumbnailCache::setDiskCacheDirectory (const File& directory, const int64 maxNumBytesOnDisk)
+{
+    const ScopedLock sl (lock);
+
+    if (directory == File::nonexistent)
+    {
+        diskIndex = nullptr;
+        return true;
+    }
+
+    if (diskIndex != nullptr && diskIndex->directory == directory)
+    {
+        diskIndex->maxNumBytes = maxNumBytesOnDisk;
+        return true;
+    }
+
+    diskIndex = nullptr;
+
+    if (directory.createDirectory().failed())
+        return false;
+
+    diskIndex = new DiskIndex (directory, maxNumBytesOnDisk);
+    return true;
+}
+
+File AudioThumbnailCache::getDiskCacheDirectory() const
+{
+    const ScopedLock sl (lock);
+    return diskIndex != nullptr ? diskIndex->directory : File::nonexistent;
+}
+
+int64 AudioThumbnailCache::getDiskCacheSize() const
+{
+    const ScopedLock sl (lock);
+    return diskIndex != nullptr ? diskIndex->getTotalSize() : 0;
+}
+
 void AudioThumbnailCache::saveNewlyFinishedThumbnail (const AudioThumbnailBase&, int64)
 {
 }
@@ -37,6 +37,13 @@
     that need it, and it maintains a set of low-res previews in memory, to avoid
     having to re-scan audio files too often.
 
+    If you're loading a lot of files at once, the cache can also be given a pool of
+    threads, so that several thumbnails can be generated in parallel. The thumbnails
+    that have been drawn on-screen most recently are always generated first.
+
+    To keep thumbnails between sessions, you can give the cache a directory with
+    setDiskCacheDirectory(), where it'll store a copy of each one that's finished.
+
     @see AudioThumbnail
 */
 class JUCE_API  AudioThumbnailCache
@@ -47,8 +54,12 @@ public:
 
         The maxNumThumbsToStore parameter lets you specify how many previews should
         be kept in memory at once.
+
+        If numThumbnailThreads is greater than zero, the thumbnails will be generated
+        by a pool of that many threads, rather than taking turns on the single
+        time-slice thread.
     */
-    explicit AudioThumbnailCache (int maxNumThumbsToStore);
+    explicit AudioThumbnailCache (int maxNumThumbsToStore, int numThumbnailThreads = 0);
 
     /** Destructor. */
     virtual ~AudioThumbnailCache();
@@ -87,9 +98,58 @@ public:
     */
     void writeToStream (OutputStream& stream);
 
+    //==============================================================================
+    /** Makes the cache keep a copy of every finished thumbnail in a directory on disk.
+
+        Each thumbnail is stored in its own file, along with an index file that the cache
+        memory-maps to find them. Nothing is loaded up-front: a thumbnail is only read
+        from disk when it's requested and isn't already in memory, so this can be used
+        for projects with thousands of files.
+
+        When the files in the directory add up to more than maxNumBytesOnDisk, the ones
+        that were used least recently are deleted.
+
+        Passing File::nonexistent stops using the disk. Returns false if the directory
+        couldn't be created.
+    */
+    bool setDiskCacheDirectory (const File& directory, int64 maxNumBytesOnDisk);
+
+    /** Returns the directory that was set with setDiskCacheDirectory(), if there is one. */
+    File getDiskCacheDirectory() const;
+
+    /** Returns the number of bytes of thumbnail data that are stored in the disk cache. */
+    int64 getDiskCacheSize() const;
+
     /** Returns the thread that client thumbnails can use. */
     TimeSliceThread& getTimeSliceThread() noexcept      { return thread; }
 
+    /** Returns the number of threads that were requested in the constructor. */
+    int getNumThumbnailThreads() const noexcept;
+
+    //==============================================================================
+    /** Starts calling a client that's generating a thumbnail in the background.
+
+        If the cache has a pool of thumbnail threads, the client will be run by one of
+        those; otherwise it's added to the time-slice thread. As with a TimeSliceThread,
+        the client will be called until its useTimeSlice() method returns a negative value.
+
+        This is called automatically by the AudioThumbnail class, so you shouldn't
+        normally need to call it directly.
+    */
+    void addThumbnailClient (TimeSliceClient* client);
+
+    /** Stops calling a client that was added with addThumbnailClient().
+        If the client is currently running, this will wait until it has finished.
+    */
+    void removeThumbnailClient (TimeSliceClient* client);
+
+    /** Moves a client to the front of the queue, so that it gets run before any others.
+
+        AudioThumbnail calls this whenever an unfinished thumbnail is drawn, so that
+        the ones that are visible get finished first.
+    */
+    void prioritiseThumbnailClient (TimeSliceClient* client);
+
 protected:
     /** This can be overridden to provide a custom callback for saving thumbnails
         once they have finished being loaded.
@@ -105,6 +165,14 @@ private:
     //==============================================================================
     TimeSliceThread thread;
 
+    class ThumbnailThreadPool;
+    friend class ScopedPointer<ThumbnailThreadPool>;
+    ScopedPointer<ThumbnailThreadPool> threadPool;
+
+    class DiskIndex;
+    friend class ScopedPointer<DiskIndex>;
+    ScopedPointer<DiskIndex> diskIndex;
+
     class ThumbnailCacheEntry;
     friend class OwnedArray<ThumbnailCacheEntry>;
     OwnedArray<ThumbnailCacheEntry> thumbs;
@@ -112,6 +180,7 @@ private:
     int maxNumThumbsToStore;
 
     ThumbnailCacheEntry* findThumbFor (int64 hash) const;
+    ThumbnailCacheEntry* createThumbFor (int64 hash);
     int findOldestThumb() const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioThumbnailCache)
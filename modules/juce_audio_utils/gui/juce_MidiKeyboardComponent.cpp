@@ -71,6 +71,7 @@ MidiKeyboardComponent::MidiKeyboardComponent (MidiKeyboardState& state_,
       midiChannel (1),
       midiInChannelMask (0xffff),
       velocity (1.0f),
+      lastStateChangeCounter (state_.getChangeCounter() - 1),
       shouldCheckState (false),
       rangeStart (0),
       rangeEnd (127),
@@ -97,14 +98,11 @@ MidiKeyboardComponent::MidiKeyboardComponent (MidiKeyboardState& state_,
     setOpaque (true);
     setWantsKeyboardFocus (true);
 
-    state.addListener (this);
-
     startTimer (1000 / 20);
 }
 
 MidiKeyboardComponent::~MidiKeyboardComponent()
 {
-    state.removeListener (this);
 }
 
 //==============================================================================
@@ -650,17 +648,6 @@ void MidiKeyboardComponent::resized()
     }
 }
 
-//==============================================================================
-void MidiKeyboardComponent::handleNoteOn (MidiKeyboardState*, int /*midiChannel*/, int /*midiNoteNumber*/, float /*velocity*/)
-{
-    shouldCheckState = true; // (probably being called from the audio thread, so avoid blocking in here)
-}
-
-void MidiKeyboardComponent::handleNoteOff (MidiKeyboardState*, int /*midiChannel*/, int /*midiNoteNumber*/)
-{
-    shouldCheckState = true; // (probably being called from the audio thread, so avoid blocking in here)
-}
-
 //==============================================================================
 void MidiKeyboardComponent::resetAnyKeysInUse()
 {
@@ -803,9 +790,14 @@ void MidiKeyboardComponent::mouseWheelMove (const MouseEvent&, const MouseWheelD
 
 void MidiKeyboardComponent::timerCallback()
 {
-    if (shouldCheckState)
+    // (polling the state's counter means the audio thread never has to call back into
+    // the UI, and any number of key changes since the last tick get handled together)
+    const int stateChangeCounter = state.getChangeCounter();
+
+    if (shouldCheckState || stateChangeCounter != lastStateChangeCounter)
     {
         shouldCheckState = false;
+        lastStateChangeCounter = stateChangeCounter;
 
         for (int i = rangeStart; i <= rangeEnd; ++i)
         {
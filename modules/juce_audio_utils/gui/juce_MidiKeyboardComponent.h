@@ -46,7 +46,6 @@
     @see MidiKeyboardState
 */
 class JUCE_API  MidiKeyboardComponent  : public Component,
-                                         public MidiKeyboardStateListener,
                                          public ChangeBroadcaster,
                                          private Timer
 {
@@ -289,10 +288,6 @@ public:
     /** @internal */
     void focusLost (FocusChangeType);
     /** @internal */
-    void handleNoteOn (MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity);
-    /** @internal */
-    void handleNoteOff (MidiKeyboardState*, int midiChannel, int midiNoteNumber);
-    /** @internal */
     void colourChanged();
 
 protected:
@@ -382,6 +377,7 @@ private:
 
     Array<int> mouseOverNotes, mouseDownNotes;
     BigInteger keysPressed, keysCurrentlyDrawnDown;
+    int lastStateChangeCounter;
     bool shouldCheckState;
 
     int rangeStart, rangeEnd;
@@ -39,15 +39,20 @@
 #include "../juce_core/native/juce_BasicNativeHeaders.h"
 #include "juce_audio_utils.h"
 
+#if JUCE_MODULE_AVAILABLE_juce_opengl
+ #include "../juce_opengl/juce_opengl.h"
+#endif
+
 namespace juce
 {
 
-// START_AUTOINCLUDE gui/*.cpp, players/*.cpp
+// START_AUTOINCLUDE gui/*.cpp, players/*.cpp, recording/*.cpp
 #include "gui/juce_AudioDeviceSelectorComponent.cpp"
 #include "gui/juce_AudioThumbnail.cpp"
 #include "gui/juce_AudioThumbnailCache.cpp"
 #include "gui/juce_MidiKeyboardComponent.cpp"
 #include "players/juce_AudioProcessorPlayer.cpp"
+#include "recording/juce_MultiTrackRecorder.cpp"
 // END_AUTOINCLUDE
 
 }
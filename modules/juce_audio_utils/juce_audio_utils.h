@@ -53,6 +53,9 @@ namespace juce
 #ifndef __JUCE_AUDIOPROCESSORPLAYER_JUCEHEADER__
  #include "players/juce_AudioProcessorPlayer.h"
 #endif
+#ifndef __JUCE_MULTITRACKRECORDER_JUCEHEADER__
+ #include "recording/juce_MultiTrackRecorder.h"
+#endif
 
 }
 
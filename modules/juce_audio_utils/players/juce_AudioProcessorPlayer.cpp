@@ -28,9 +28,11 @@ AudioProcessorPlayer::AudioProcessorPlayer()
       sampleRate (0),
       blockSize (0),
       isPrepared (false),
+      isDoublePrecision (false),
       numInputChans (0),
       numOutputChans (0),
-      tempBuffer (1, 1)
+      tempBuffer (1, 1),
+      conversionBuffer (1, 1)
 {
 }
 
@@ -46,6 +48,10 @@ void AudioProcessorPlayer::setProcessor (AudioProcessor* const processorToPlay)
     {
         if (processorToPlay != nullptr && sampleRate > 0 && blockSize > 0)
         {
+            processorToPlay->setProcessingPrecision (isDoublePrecision && processorToPlay->supportsDoublePrecisionProcessing()
+                                                        ? AudioProcessor::doublePrecision
+                                                        : AudioProcessor::singlePrecision);
+
             processorToPlay->setPlayConfigDetails (numInputChans, numOutputChans,
                                                    sampleRate, blockSize);
 
@@ -59,6 +65,11 @@ void AudioProcessorPlayer::setProcessor (AudioProcessor* const processorToPlay)
             oldOne = isPrepared ? processor : nullptr;
             processor = processorToPlay;
             isPrepared = true;
+
+            if (processor != nullptr && processor->isUsingDoublePrecision())
+                conversionBuffer.setSize (jmax (1, numInputChans, numOutputChans), blockSize, false, false, true);
+            else
+                conversionBuffer.setSize (1, 1);
         }
 
         if (oldOne != nullptr)
@@ -66,6 +77,18 @@ void AudioProcessorPlayer::setProcessor (AudioProcessor* const processorToPlay)
     }
 }
 
+void AudioProcessorPlayer::setDoublePrecisionProcessing (const bool shouldUseDoublePrecision)
+{
+    if (isDoublePrecision != shouldUseDoublePrecision)
+    {
+        // (the processor has to be re-prepared to change its precision)
+        AudioProcessor* const oldProcessor = processor;
+        setProcessor (nullptr);
+        isDoublePrecision = shouldUseDoublePrecision;
+        setProcessor (oldProcessor);
+    }
+}
+
 //==============================================================================
 void AudioProcessorPlayer::audioDeviceIOCallback (const float** const inputChannelData,
                                                   const int numInputChannels,
@@ -126,14 +149,30 @@ void AudioProcessorPlayer::audioDeviceIOCallback (const float** const inputChann
     if (processor != nullptr)
     {
         const ScopedLock sl2 (processor->getCallbackLock());
+        const RealtimeSafetyChecker::ScopedRealtimeContext realtimeContext;
 
         if (processor->isSuspended())
         {
             for (int i = 0; i < numOutputChannels; ++i)
                 zeromem (outputChannelData[i], sizeof (float) * (size_t) numSamples);
         }
+        else if (processor->isUsingDoublePrecision())
+        {
+            // (this only reallocates if the device's block is bigger than it said it would be)
+            conversionBuffer.setSize (totalNumChans, numSamples, false, false, true);
+
+            for (int i = 0; i < totalNumChans; ++i)
+                FloatVectorOperations::copy (conversionBuffer.getSampleData (i), channels[i], numSamples);
+
+            processor->prepareParameterChangesForBlock (numSamples);
+            processor->processBlock (conversionBuffer, incomingMidi);
+
+            for (int i = 0; i < numOutputChannels; ++i)
+                FloatVectorOperations::copy (outputChannelData[i], conversionBuffer.getSampleData (i), numSamples);
+        }
         else
         {
+            processor->prepareParameterChangesForBlock (numSamples);
             processor->processBlock (buffer, incomingMidi);
         }
     }
@@ -178,9 +217,10 @@ void AudioProcessorPlayer::audioDeviceStopped()
     blockSize = 0;
     isPrepared = false;
     tempBuffer.setSize (1, 1);
+    conversionBuffer.setSize (1, 1);
 }
 
-void AudioProcessorPlayer::handleIncomingMidiMessage (MidiInput*, const MidiMessage& message)
+void AudioProcessorPlayer::handleIncomingMidiMessage (MidiInput* source, const MidiMessage& message)
 {
-    messageCollector.addMessageToQueue (message);
+    messageCollector.handleIncomingMidiMessage (source, message);
 }
@@ -69,6 +69,22 @@ public:
     */
     MidiMessageCollector& getMidiMessageCollector()                 { return messageCollector; }
 
+    //==============================================================================
+    /** Switches the player between 32 and 64-bit processing.
+
+        When this is enabled and the processor supports double-precision processing
+        (e.g. an AudioProcessorGraph), the device's audio is converted to doubles before
+        it's passed to the processor, and only converted back to floats for the device.
+        Processors that can't handle doubles are always run in single precision.
+
+        Changing this while playing will re-prepare the current processor.
+        @see AudioProcessor::setProcessingPrecision
+    */
+    void setDoublePrecisionProcessing (bool shouldUseDoublePrecision);
+
+    /** Returns true if double-precision processing has been enabled. */
+    bool getDoublePrecisionProcessing() const noexcept              { return isDoublePrecision; }
+
     //==============================================================================
     /** @internal */
     void audioDeviceIOCallback (const float** inputChannelData,
@@ -89,11 +105,12 @@ private:
     CriticalSection lock;
     double sampleRate;
     int blockSize;
-    bool isPrepared;
+    bool isPrepared, isDoublePrecision;
 
     int numInputChans, numOutputChans;
     HeapBlock<float*> channels;
     AudioSampleBuffer tempBuffer;
+    AudioBuffer<double> conversionBuffer;
 
     MidiBuffer incomingMidi;
     MidiMessageCollector messageCollector;
@@ -0,0 +1,337 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+struct MultiTrackRecorder::TrackInfo
+{
+    TrackInfo (const File& file_, AudioFormat& format_, const BigInteger& channels_,
+               const int bitsPerSample_, const int qualityOptionIndex_)
+        : file (file_), format (format_), channels (channels_),
+          bitsPerSample (bitsPerSample_), qualityOptionIndex (qualityOptionIndex_)
+    {}
+
+    const File file;
+    AudioFormat& format;
+    const BigInteger channels;
+    const int bitsPerSample, qualityOptionIndex;
+
+    JUCE_DECLARE_NON_COPYABLE (TrackInfo)
+};
+
+//==============================================================================
+class MultiTrackRecorder::Track
+{
+public:
+    Track (AudioFormatWriter* const writer_, TimeSliceThread& thread,
+           const BigInteger& channelBits, const int fifoSize)
+        : writer (new AudioFormatWriter::ThreadedWriter (writer_, thread, fifoSize)),
+          bufferSize (fifoSize)
+    {
+        for (int i = 0; i <= channelBits.getHighestBit(); ++i)
+            if (channelBits[i])
+                channels.add (i);
+
+        pointers.calloc ((size_t) channels.size());
+    }
+
+    static Track* create (const TrackInfo& info, const double sampleRate,
+                          TimeSliceThread& thread, const int fifoSize)
+    {
+        if (info.channels.countNumberOfSetBits() == 0)
+            return nullptr;
+
+        info.file.deleteFile();
+        ScopedPointer<FileOutputStream> out (info.file.createOutputStream());
+
+        if (out == nullptr)
+            return nullptr;
+
+        AudioFormatWriter* const w
+            = info.format.createWriterFor (out, sampleRate, (unsigned int) info.channels.countNumberOfSetBits(),
+                                           info.bitsPerSample, StringPairArray(), info.qualityOptionIndex);
+
+        if (w == nullptr)
+            return nullptr;
+
+        out.release();
+        return new Track (w, thread, info.channels, fifoSize);
+    }
+
+    // Called on the audio thread, once it's checked that the block will fit into the FIFO.
+    void write (const float** const inputs, const int numInputs, const int numSamples,
+                const float* const silence, const int silenceSize)
+    {
+        bool anyMissing = false;
+
+        for (int i = channels.size(); --i >= 0;)
+        {
+            const int chan = channels.getUnchecked (i);
+            anyMissing = anyMissing || chan >= numInputs || inputs[chan] == nullptr;
+        }
+
+        if (! anyMissing)
+        {
+            for (int i = channels.size(); --i >= 0;)
+                pointers[i] = inputs [channels.getUnchecked (i)];
+
+            writer->write (pointers, numSamples);
+            return;
+        }
+
+        // Channels that the device isn't supplying are recorded as silence, which has to
+        // be done in chunks no bigger than the block of zeros that was allocated for it.
+        for (int pos = 0; pos < numSamples; pos += silenceSize)
+        {
+            for (int i = channels.size(); --i >= 0;)
+            {
+                const int chan = channels.getUnchecked (i);
+                pointers[i] = (chan < numInputs && inputs[chan] != nullptr) ? inputs[chan] + pos : silence;
+            }
+
+            writer->write (pointers, jmin (silenceSize, numSamples - pos));
+        }
+    }
+
+    bool hasRoomFor (const int numSamples) const noexcept
+    {
+        return writer->getFreeSpace() >= numSamples;
+    }
+
+    float getHighWaterMark() const noexcept
+    {
+        return writer->getHighWaterMark() / (float) bufferSize;
+    }
+
+    void resetHighWaterMark() noexcept
+    {
+        writer->resetHighWaterMark();
+    }
+
+private:
+    ScopedPointer<AudioFormatWriter::ThreadedWriter> writer;
+    Array<int> channels;
+    HeapBlock<const float*> pointers;
+    const int bufferSize;
+
+    JUCE_DECLARE_NON_COPYABLE (Track)
+};
+
+//==============================================================================
+MultiTrackRecorder::MultiTrackRecorder (const int numWriterThreads)
+    : silenceSize (4096),
+      sampleRate (0),
+      bufferLength (2.0)
+{
+    silence.calloc ((size_t) silenceSize);
+
+    for (int i = jmax (1, numWriterThreads); --i >= 0;)
+    {
+        TimeSliceThread* const t = new TimeSliceThread ("Audio Recorder Thread");
+        threads.add (t);
+        t->startThread();
+    }
+}
+
+MultiTrackRecorder::~MultiTrackRecorder()
+{
+    stopRecording();
+}
+
+//==============================================================================
+void MultiTrackRecorder::addTrack (const File& file, AudioFormat& format, const BigInteger& inputChannels,
+                                   const int bitsPerSample, const int qualityOptionIndex)
+{
+    const ScopedLock sl (lock);
+
+    jassert (! isRecording()); // you can't change the tracks while recording!
+    trackInfos.add (new TrackInfo (file, format, inputChannels, bitsPerSample, qualityOptionIndex));
+}
+
+void MultiTrackRecorder::clearTracks()
+{
+    const ScopedLock sl (lock);
+
+    jassert (! isRecording()); // you can't change the tracks while recording!
+    trackInfos.clear();
+}
+
+int MultiTrackRecorder::getNumTracks() const noexcept
+{
+    return trackInfos.size();
+}
+
+void MultiTrackRecorder::setBufferLength (const double seconds)
+{
+    bufferLength = jmax (0.1, seconds);
+}
+
+//==============================================================================
+bool MultiTrackRecorder::startRecording()
+{
+    const ScopedLock sl (lock);
+
+    stopRecording();
+
+    if (sampleRate <= 0 || trackInfos.size() == 0)
+        return false;
+
+    const int fifoSize = jmax (8192, roundToInt (bufferLength * sampleRate));
+    ScopedPointer<OwnedArray<Track> > newTracks (new OwnedArray<Track>());
+
+    for (int i = 0; i < trackInfos.size(); ++i)
+    {
+        Track* const t = Track::create (*trackInfos.getUnchecked (i), sampleRate,
+                                        *threads.getUnchecked (i % threads.size()), fifoSize);
+
+        if (t == nullptr)
+            return false;
+
+        newTracks->add (t);
+    }
+
+    resetStatistics();
+    numSamplesRecorded = 0;
+
+    recordingTracks = newTracks;
+    activeTracks = recordingTracks.get();
+    return true;
+}
+
+void MultiTrackRecorder::stopRecording()
+{
+    const ScopedLock sl (lock);
+
+    if (recordingTracks != nullptr)
+    {
+        activeTracks = nullptr;
+        audioThreadHandover.waitForAudioThread();
+
+        recordingTracks = nullptr; // (deleting the writers flushes the rest of the data to disk)
+    }
+}
+
+bool MultiTrackRecorder::isRecording() const noexcept
+{
+    return activeTracks.get() != nullptr;
+}
+
+int64 MultiTrackRecorder::getNumSamplesRecorded() const noexcept
+{
+    return numSamplesRecorded.get();
+}
+
+//==============================================================================
+int MultiTrackRecorder::getNumOverflows() const noexcept
+{
+    return numOverflows.get();
+}
+
+int64 MultiTrackRecorder::getNumDroppedSamples() const noexcept
+{
+    return numDroppedSamples.get();
+}
+
+float MultiTrackRecorder::getFifoHighWaterMark() const
+{
+    const ScopedLock sl (lock);
+    float highest = 0;
+
+    if (recordingTracks != nullptr)
+        for (int i = recordingTracks->size(); --i >= 0;)
+            highest = jmax (highest, recordingTracks->getUnchecked (i)->getHighWaterMark());
+
+    return highest;
+}
+
+void MultiTrackRecorder::resetStatistics()
+{
+    const ScopedLock sl (lock);
+
+    numOverflows = 0;
+    numDroppedSamples = 0;
+
+    if (recordingTracks != nullptr)
+        for (int i = recordingTracks->size(); --i >= 0;)
+            recordingTracks->getUnchecked (i)->resetHighWaterMark();
+}
+
+//==============================================================================
+void MultiTrackRecorder::audioDeviceIOCallback (const float** const inputChannelData, const int numInputChannels,
+                                                float** const outputChannelData, const int numOutputChannels,
+                                                const int numSamples)
+{
+    {
+        const AudioThreadHandover::ScopedCallback sc (audioThreadHandover);
+        OwnedArray<Track>* const tracks = activeTracks.get();
+
+        if (tracks != nullptr)
+        {
+            // A block is either written to every track or dropped from all of them, so
+            // that the files never drift out of step with each other.
+            bool allHaveRoom = true;
+
+            for (int i = tracks->size(); --i >= 0;)
+                allHaveRoom = allHaveRoom && tracks->getUnchecked (i)->hasRoomFor (numSamples);
+
+            if (allHaveRoom)
+            {
+                for (int i = 0; i < tracks->size(); ++i)
+                    tracks->getUnchecked (i)->write (inputChannelData, numInputChannels, numSamples,
+                                                     silence, silenceSize);
+            }
+            else
+            {
+                ++numOverflows;
+                numDroppedSamples += numSamples;
+            }
+
+            numSamplesRecorded += numSamples;
+        }
+    }
+
+    for (int i = 0; i < numOutputChannels; ++i)
+        if (outputChannelData[i] != nullptr)
+            zeromem (outputChannelData[i], sizeof (float) * (size_t) numSamples);
+}
+
+void MultiTrackRecorder::audioDeviceAboutToStart (AudioIODevice* const device)
+{
+    // If the sample rate changes, a recording that's in progress will carry on at the old one!
+    jassert (! isRecording() || device->getCurrentSampleRate() == sampleRate);
+
+    sampleRate = device->getCurrentSampleRate();
+
+    const int blockSize = device->getCurrentBufferSizeSamples();
+
+    if (blockSize > silenceSize)
+    {
+        silenceSize = blockSize;
+        silence.calloc ((size_t) silenceSize);
+    }
+}
+
+void MultiTrackRecorder::audioDeviceStopped()
+{
+    sampleRate = 0;
+}
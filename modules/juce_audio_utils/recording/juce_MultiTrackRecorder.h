@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_MULTITRACKRECORDER_JUCEHEADER__
+#define __JUCE_MULTITRACKRECORDER_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    An AudioIODeviceCallback that records its incoming audio straight to disk.
+
+    You give it a set of tracks, each of which takes some of the device's input
+    channels and writes them to its own file, in any AudioFormat (e.g. a
+    WavAudioFormat or FlacAudioFormat). For each track, the audio callback just
+    copies the incoming data into a FIFO that was allocated when recording started,
+    and the encoding and disk-writing is done by a small pool of background threads,
+    so the audio thread never allocates memory, takes a lock or touches the disk.
+
+    If the disk can't keep up and any track's FIFO doesn't have room for an incoming
+    block, that block is dropped from all of the tracks, so the files always stay in
+    step with each other. This is counted so that you can find out about it with
+    getNumOverflows() and getNumDroppedSamples(), and getFifoHighWaterMark() will
+    tell you how close the FIFOs have come to overflowing.
+
+    To use one, call addTrack() for each file you want, register this object as a
+    callback with your AudioIODevice or AudioDeviceManager, and then call
+    startRecording() and stopRecording().
+
+    @see AudioFormatWriter::ThreadedWriter
+*/
+class JUCE_API  MultiTrackRecorder  : public AudioIODeviceCallback
+{
+public:
+    //==============================================================================
+    /** Creates a recorder.
+
+        @param numWriterThreads     the number of background threads that the tracks will
+                                    be shared between for encoding and writing to disk
+    */
+    explicit MultiTrackRecorder (int numWriterThreads = 2);
+
+    /** Destructor.
+        If a recording is in progress, it'll be stopped and flushed to disk.
+    */
+    ~MultiTrackRecorder();
+
+    //==============================================================================
+    /** Adds a track to be recorded.
+
+        @param file                 the file to write - if it already exists, it'll be
+                                    overwritten when recording starts
+        @param format               the format to encode it with. This object must not be
+                                    deleted while the recorder is using it
+        @param inputChannels        the device input channels that the file should contain,
+                                    in order. These are indexes into the array of channels
+                                    that the audio callback receives
+        @param bitsPerSample        the bit depth to pass to AudioFormat::createWriterFor()
+        @param qualityOptionIndex   the quality option to pass to AudioFormat::createWriterFor()
+
+        Tracks can't be changed while a recording is in progress.
+    */
+    void addTrack (const File& file, AudioFormat& format, const BigInteger& inputChannels,
+                   int bitsPerSample = 24, int qualityOptionIndex = 0);
+
+    /** Removes all the tracks. */
+    void clearTracks();
+
+    /** Returns the number of tracks that have been added. */
+    int getNumTracks() const noexcept;
+
+    /** Sets the length of the FIFO used by each track, in seconds.
+
+        This only takes effect for the next call to startRecording(). The default is 2 seconds.
+    */
+    void setBufferLength (double seconds);
+
+    //==============================================================================
+    /** Opens the track files and starts recording.
+
+        The recorder must be attached to an audio device that's running, because the
+        files are created with the device's sample rate. Returns false if that's not
+        the case, or if any of the files couldn't be opened, in which case nothing
+        will be recorded.
+    */
+    bool startRecording();
+
+    /** Stops recording.
+        This will block until all the buffered data has been written and the files
+        have been closed.
+    */
+    void stopRecording();
+
+    /** Returns true if a recording is in progress. */
+    bool isRecording() const noexcept;
+
+    /** Returns the number of samples that have arrived since the recording started. */
+    int64 getNumSamplesRecorded() const noexcept;
+
+    //==============================================================================
+    /** Returns the number of blocks that were dropped because a track's FIFO was full. */
+    int getNumOverflows() const noexcept;
+
+    /** Returns the number of samples that have been dropped because a track's FIFO
+        was full. Each dropped block is only counted once, however many tracks there are.
+    */
+    int64 getNumDroppedSamples() const noexcept;
+
+    /** Returns the fullest that any track's FIFO has been, as a proportion of its size.
+        The nearer this gets to 1.0, the nearer the recorder has come to dropping data -
+        use getNumOverflows() to find out whether it actually has.
+    */
+    float getFifoHighWaterMark() const;
+
+    /** Resets the overflow counts and high-water mark. */
+    void resetStatistics();
+
+    //==============================================================================
+    /** @internal */
+    void audioDeviceIOCallback (const float** inputChannelData, int numInputChannels,
+                                float** outputChannelData, int numOutputChannels, int numSamples);
+    /** @internal */
+    void audioDeviceAboutToStart (AudioIODevice*);
+    /** @internal */
+    void audioDeviceStopped();
+
+private:
+    //==============================================================================
+    struct TrackInfo;
+    class Track;
+
+    OwnedArray<TrackInfo> trackInfos;
+    OwnedArray<TimeSliceThread> threads;
+    ScopedPointer<OwnedArray<Track> > recordingTracks;
+    Atomic<OwnedArray<Track>*> activeTracks;
+    AudioThreadHandover audioThreadHandover;
+    Atomic<int> numOverflows;
+    Atomic<int64> numSamplesRecorded, numDroppedSamples;
+    CriticalSection lock;
+    HeapBlock<float> silence;
+    int silenceSize;
+    double sampleRate, bufferLength;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultiTrackRecorder)
+};
+
+
+#endif   // __JUCE_MULTITRACKRECORDER_JUCEHEADER__
@@ -31,6 +31,8 @@ b2BroadPhase::b2BroadPhase()
 	m_moveCapacity = 16;
 	m_moveCount = 0;
 	m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+
+	m_parallelExecutor = NULL;
 }
 
 b2BroadPhase::~b2BroadPhase()
@@ -95,6 +97,150 @@ void b2BroadPhase::UnBufferMove(int32 proxyId)
 	}
 }
 
+void b2BroadPhase::FindPairs()
+{
+	// Splitting the queries up is only worth it if each thread gets a decent share.
+	const int32 minMovesPerTask = 64;
+
+	// Reset pair buffer
+	m_pairCount = 0;
+
+	if (m_parallelExecutor != NULL)
+	{
+		int32 taskCount = b2Min(m_parallelExecutor->GetThreadCount(), m_moveCount / minMovesPerTask);
+		if (taskCount > 1)
+		{
+			FindPairsInParallel(taskCount);
+			return;
+		}
+	}
+
+	for (int32 i = 0; i < m_moveCount; ++i)
+	{
+		m_queryProxyId = m_moveBuffer[i];
+		if (m_queryProxyId == e_nullProxy)
+		{
+			continue;
+		}
+
+		// We have to query the tree with the fat AABB so that
+		// we don't fail to create a pair that may touch later.
+		const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
+
+		// Query tree, create pairs and add them pair buffer.
+		m_tree.Query(this, fatAABB);
+	}
+}
+
+// Queries the tree for one slice of the move buffer, collecting the pairs in
+// a buffer of its own. The tree isn't modified while the queries run.
+struct b2PairQuery
+{
+	bool QueryCallback(int32 proxyId)
+	{
+		// A proxy cannot form a pair with itself.
+		if (proxyId == queryProxyId)
+		{
+			return true;
+		}
+
+		// Grow the pair buffer as needed.
+		if (pairCount == pairCapacity)
+		{
+			b2Pair* oldBuffer = pairs;
+			pairCapacity *= 2;
+			pairs = (b2Pair*)b2Alloc(pairCapacity * sizeof(b2Pair));
+			memcpy(pairs, oldBuffer, pairCount * sizeof(b2Pair));
+			b2Free(oldBuffer);
+		}
+
+		pairs[pairCount].proxyIdA = b2Min(proxyId, queryProxyId);
+		pairs[pairCount].proxyIdB = b2Max(proxyId, queryProxyId);
+		++pairCount;
+
+		return true;
+	}
+
+	b2Pair* pairs;
+	int32 pairCount;
+	int32 pairCapacity;
+	int32 queryProxyId;
+	int32 moveStart;
+	int32 moveEnd;
+};
+
+class b2FindPairsTask : public b2ParallelTask
+{
+public:
+	void Execute(int32 index)
+	{
+		b2PairQuery& query = queries[index];
+
+		for (int32 i = query.moveStart; i < query.moveEnd; ++i)
+		{
+			query.queryProxyId = moveBuffer[i];
+			if (query.queryProxyId == b2BroadPhase::e_nullProxy)
+			{
+				continue;
+			}
+
+			tree->Query(&query, tree->GetFatAABB(query.queryProxyId));
+		}
+	}
+
+	const b2DynamicTree* tree;
+	const int32* moveBuffer;
+	b2PairQuery* queries;
+};
+
+void b2BroadPhase::FindPairsInParallel(int32 taskCount)
+{
+	b2PairQuery* queries = (b2PairQuery*)b2Alloc(taskCount * sizeof(b2PairQuery));
+
+	for (int32 i = 0; i < taskCount; ++i)
+	{
+		b2PairQuery& query = queries[i];
+		query.pairCapacity = 16;
+		query.pairCount = 0;
+		query.pairs = (b2Pair*)b2Alloc(query.pairCapacity * sizeof(b2Pair));
+		query.moveStart = (m_moveCount * i) / taskCount;
+		query.moveEnd = (m_moveCount * (i + 1)) / taskCount;
+	}
+
+	b2FindPairsTask task;
+	task.tree = &m_tree;
+	task.moveBuffer = m_moveBuffer;
+	task.queries = queries;
+	m_parallelExecutor->Run(&task, taskCount);
+
+	// Gather all the pairs into the main buffer, ready for sorting.
+	int32 pairCount = 0;
+	for (int32 i = 0; i < taskCount; ++i)
+	{
+		pairCount += queries[i].pairCount;
+	}
+
+	if (pairCount > m_pairCapacity)
+	{
+		while (m_pairCapacity < pairCount)
+		{
+			m_pairCapacity *= 2;
+		}
+
+		b2Free(m_pairBuffer);
+		m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
+	}
+
+	for (int32 i = 0; i < taskCount; ++i)
+	{
+		memcpy(m_pairBuffer + m_pairCount, queries[i].pairs, queries[i].pairCount * sizeof(b2Pair));
+		m_pairCount += queries[i].pairCount;
+		b2Free(queries[i].pairs);
+	}
+
+	b2Free(queries);
+}
+
 // This is called from b2DynamicTree::Query when we are gathering pairs.
 bool b2BroadPhase::QueryCallback(int32 proxyId)
 {
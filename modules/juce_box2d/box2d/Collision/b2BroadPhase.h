@@ -20,6 +20,7 @@
 #define B2_BROAD_PHASE_H
 
 #include "../Common/b2Settings.h"
+#include "../Common/b2ParallelExecutor.h"
 #include "b2Collision.h"
 #include "b2DynamicTree.h"
 #include <algorithm>
@@ -100,6 +101,10 @@ public:
 	/// Get the quality metric of the embedded tree.
 	float32 GetTreeQuality() const;
 
+	/// Set an executor to query the tree for several moved proxies at once
+	/// when UpdatePairs is called, or NULL to do it all on the calling thread.
+	void SetParallelExecutor(b2ParallelExecutor* executor);
+
 private:
 
 	friend class b2DynamicTree;
@@ -107,6 +112,8 @@ private:
 	void BufferMove(int32 proxyId);
 	void UnBufferMove(int32 proxyId);
 
+	void FindPairs();
+	void FindPairsInParallel(int32 taskCount);
 	bool QueryCallback(int32 proxyId);
 
 	b2DynamicTree m_tree;
@@ -122,6 +129,8 @@ private:
 	int32 m_pairCount;
 
 	int32 m_queryProxyId;
+
+	b2ParallelExecutor* m_parallelExecutor;
 };
 
 /// This is used to sort pairs.
@@ -177,28 +186,16 @@ inline float32 b2BroadPhase::GetTreeQuality() const
 	return m_tree.GetAreaRatio();
 }
 
+inline void b2BroadPhase::SetParallelExecutor(b2ParallelExecutor* executor)
+{
+	m_parallelExecutor = executor;
+}
+
 template <typename T>
 void b2BroadPhase::UpdatePairs(T* callback)
 {
-	// Reset pair buffer
-	m_pairCount = 0;
-
 	// Perform tree queries for all moving proxies.
-	for (int32 i = 0; i < m_moveCount; ++i)
-	{
-		m_queryProxyId = m_moveBuffer[i];
-		if (m_queryProxyId == e_nullProxy)
-		{
-			continue;
-		}
-
-		// We have to query the tree with the fat AABB so that
-		// we don't fail to create a pair that may touch later.
-		const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
-
-		// Query tree, create pairs and add them pair buffer.
-		m_tree.Query(this, fatAABB);
-	}
+	FindPairs();
 
 	// Reset move buffer
 	m_moveCount = 0;
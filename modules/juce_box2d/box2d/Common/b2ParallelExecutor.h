@@ -0,0 +1,53 @@
+/*
+* Copyright (c) 2011 Erin Catto http://box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_PARALLEL_EXECUTOR_H
+#define B2_PARALLEL_EXECUTOR_H
+
+#include "b2Settings.h"
+
+/// A piece of work that can be split into independent parts, so that a
+/// b2ParallelExecutor can run them at the same time.
+class b2ParallelTask
+{
+public:
+	virtual ~b2ParallelTask() {}
+
+	/// Runs one part of the task. Different parts may be run at the same time
+	/// on different threads.
+	virtual void Execute(int32 index) = 0;
+};
+
+/// Implement this to let a world spread its island solving and broad-phase
+/// work across several threads.
+/// @see b2World::SetParallelExecutor
+class b2ParallelExecutor
+{
+public:
+	virtual ~b2ParallelExecutor() {}
+
+	/// Get the number of threads that tasks can be run on, including the one
+	/// that calls Run. The world splits its work into at most this many parts.
+	virtual int32 GetThreadCount() const = 0;
+
+	/// Call task->Execute(i) for each i in [0, count), in any order and on any
+	/// threads, and return when all of them have finished.
+	virtual void Run(b2ParallelTask* task, int32 count) = 0;
+};
+
+#endif
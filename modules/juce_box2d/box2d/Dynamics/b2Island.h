@@ -35,7 +35,8 @@ class b2Island
 {
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
-			b2StackAllocator* allocator, b2ContactListener* listener);
+			b2StackAllocator* allocator, b2ContactListener* listener,
+			int32 sharedBodyCount = 0);
 	~b2Island();
 
 	void Clear()
@@ -52,7 +53,17 @@ public:
 	void Add(b2Body* body)
 	{
 		b2Assert(m_bodyCount < m_bodyCapacity);
-		body->m_islandIndex = m_bodyCount;
+		body->m_islandIndex = m_sharedBodyCount + m_bodyCount;
+		m_bodies[m_bodyCount] = body;
+		++m_bodyCount;
+	}
+
+	/// Add a static body that other islands may be using at the same time. Its
+	/// island index must already have been set to one of the shared slots.
+	void AddShared(b2Body* body)
+	{
+		b2Assert(m_bodyCount < m_bodyCapacity);
+		b2Assert(0 <= body->m_islandIndex && body->m_islandIndex < m_sharedBodyCount);
 		m_bodies[m_bodyCount] = body;
 		++m_bodyCount;
 	}
@@ -81,6 +92,7 @@ public:
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
 
+	int32 m_sharedBodyCount;
 	int32 m_bodyCount;
 	int32 m_jointCount;
 	int32 m_contactCount;
@@ -33,6 +33,7 @@
 #include "../Common/b2Draw.h"
 #include "../Common/b2Timer.h"
 #include <new>
+#include <algorithm>
 
 b2World::b2World(const b2Vec2& gravity)
 {
@@ -60,6 +61,10 @@ b2World::b2World(const b2Vec2& gravity)
 
 	m_contactManager.m_allocator = &m_blockAllocator;
 
+	m_parallelExecutor = NULL;
+	m_taskAllocators = NULL;
+	m_taskAllocatorCount = 0;
+
 	memset(&m_profile, 0, sizeof(b2Profile));
 }
 
@@ -82,6 +87,8 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	delete[] m_taskAllocators;
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -104,6 +111,13 @@ void b2World::SetDebugDraw(b2Draw* debugDraw)
 	m_debugDraw = debugDraw;
 }
 
+void b2World::SetParallelExecutor(b2ParallelExecutor* executor)
+{
+	b2Assert(IsLocked() == false);
+	m_parallelExecutor = executor;
+	m_contactManager.m_broadPhase.SetParallelExecutor(executor);
+}
+
 b2Body* b2World::CreateBody(const b2BodyDef* def)
 {
 	b2Assert(IsLocked() == false);
@@ -382,6 +396,122 @@ void b2World::SetAllowSleeping(bool flag)
 	}
 }
 
+void b2World::ClearIslandFlags()
+{
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b->m_flags &= ~b2Body::e_islandFlag;
+	}
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		c->m_flags &= ~b2Contact::e_islandFlag;
+	}
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		j->m_islandFlag = false;
+	}
+}
+
+// Adds everything that's connected to the seed body to the island.
+void b2World::BuildIsland(b2Body* seed, b2Body** stack, int32 stackSize, b2Island* island)
+{
+	B2_NOT_USED(stackSize);
+
+	int32 stackCount = 0;
+	stack[stackCount++] = seed;
+	seed->m_flags |= b2Body::e_islandFlag;
+
+	// Perform a depth first search (DFS) on the constraint graph.
+	while (stackCount > 0)
+	{
+		// Grab the next body off the stack and add it to the island.
+		b2Body* b = stack[--stackCount];
+		b2Assert(b->IsActive() == true);
+		island->Add(b);
+
+		// Make sure the body is awake.
+		b->SetAwake(true);
+
+		// To keep islands as small as possible, we don't
+		// propagate islands across static bodies.
+		if (b->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		// Search all contacts connected to this body.
+		for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+		{
+			b2Contact* contact = ce->contact;
+
+			// Has this contact already been added to an island?
+			if (contact->m_flags & b2Contact::e_islandFlag)
+			{
+				continue;
+			}
+
+			// Is this contact solid and touching?
+			if (contact->IsEnabled() == false ||
+				contact->IsTouching() == false)
+			{
+				continue;
+			}
+
+			// Skip sensors.
+			bool sensorA = contact->m_fixtureA->m_isSensor;
+			bool sensorB = contact->m_fixtureB->m_isSensor;
+			if (sensorA || sensorB)
+			{
+				continue;
+			}
+
+			island->Add(contact);
+			contact->m_flags |= b2Contact::e_islandFlag;
+
+			b2Body* other = ce->other;
+
+			// Was the other body already added to this island?
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
+
+		// Search all joints connect to this body.
+		for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+		{
+			if (je->joint->m_islandFlag == true)
+			{
+				continue;
+			}
+
+			b2Body* other = je->other;
+
+			// Don't simulate joints connected to inactive bodies.
+			if (other->IsActive() == false)
+			{
+				continue;
+			}
+
+			island->Add(je->joint);
+			je->joint->m_islandFlag = true;
+
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
+	}
+}
+
 // Find islands, integrate and solve constraints, solve position constraints
 void b2World::Solve(const b2TimeStep& step)
 {
@@ -389,6 +519,13 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
+	if (m_parallelExecutor != NULL)
+	{
+		SolveInParallel(step);
+		SynchronizeFixtures();
+		return;
+	}
+
 	// Size the island for the worst case.
 	b2Island island(m_bodyCount,
 					m_contactManager.m_contactCount,
@@ -397,18 +534,7 @@ void b2World::Solve(const b2TimeStep& step)
 					m_contactManager.m_contactListener);
 
 	// Clear all the island flags.
-	for (b2Body* b = m_bodyList; b; b = b->m_next)
-	{
-		b->m_flags &= ~b2Body::e_islandFlag;
-	}
-	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
-	{
-		c->m_flags &= ~b2Contact::e_islandFlag;
-	}
-	for (b2Joint* j = m_jointList; j; j = j->m_next)
-	{
-		j->m_islandFlag = false;
-	}
+	ClearIslandFlags();
 
 	// Build and simulate all awake islands.
 	int32 stackSize = m_bodyCount;
@@ -433,144 +559,251 @@ void b2World::Solve(const b2TimeStep& step)
 
 		// Reset island and stack.
 		island.Clear();
-		int32 stackCount = 0;
-		stack[stackCount++] = seed;
-		seed->m_flags |= b2Body::e_islandFlag;
+		BuildIsland(seed, stack, stackSize, &island);
 
-		// Perform a depth first search (DFS) on the constraint graph.
-		while (stackCount > 0)
-		{
-			// Grab the next body off the stack and add it to the island.
-			b2Body* b = stack[--stackCount];
-			b2Assert(b->IsActive() == true);
-			island.Add(b);
-
-			// Make sure the body is awake.
-			b->SetAwake(true);
+		b2Profile profile;
+		island.Solve(&profile, step, m_gravity, m_allowSleep);
+		m_profile.solveInit += profile.solveInit;
+		m_profile.solveVelocity += profile.solveVelocity;
+		m_profile.solvePosition += profile.solvePosition;
 
-			// To keep islands as small as possible, we don't
-			// propagate islands across static bodies.
+		// Post solve cleanup.
+		for (int32 i = 0; i < island.m_bodyCount; ++i)
+		{
+			// Allow static bodies to participate in other islands.
+			b2Body* b = island.m_bodies[i];
 			if (b->GetType() == b2_staticBody)
 			{
-				continue;
+				b->m_flags &= ~b2Body::e_islandFlag;
 			}
+		}
+	}
 
-			// Search all contacts connected to this body.
-			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
-			{
-				b2Contact* contact = ce->contact;
-
-				// Has this contact already been added to an island?
-				if (contact->m_flags & b2Contact::e_islandFlag)
-				{
-					continue;
-				}
+	m_stackAllocator.Free(stack);
 
-				// Is this contact solid and touching?
-				if (contact->IsEnabled() == false ||
-					contact->IsTouching() == false)
-				{
-					continue;
-				}
+	SynchronizeFixtures();
+}
 
-				// Skip sensors.
-				bool sensorA = contact->m_fixtureA->m_isSensor;
-				bool sensorB = contact->m_fixtureB->m_isSensor;
-				if (sensorA || sensorB)
-				{
-					continue;
-				}
+// The part of an island list that belongs to one island.
+struct b2IslandRange
+{
+	int32 bodyStart, bodyCount;
+	int32 contactStart, contactCount;
+	int32 jointStart, jointCount;
+};
 
-				island.Add(contact);
-				contact->m_flags |= b2Contact::e_islandFlag;
+// Used to put the biggest islands first, so that they're shared out evenly.
+inline bool b2IslandRangeIsBigger(const b2IslandRange& range1, const b2IslandRange& range2)
+{
+	return range1.bodyCount + range1.contactCount > range2.bodyCount + range2.contactCount;
+}
 
-				b2Body* other = ce->other;
+// Solves every n'th island, where n is the number of tasks. Each task has its
+// own stack allocator, and adds up its own profile.
+class b2SolveIslandsTask : public b2ParallelTask
+{
+public:
+	void Execute(int32 index)
+	{
+		b2Profile& taskProfile = profiles[index];
+		taskProfile.solveInit = 0.0f;
+		taskProfile.solveVelocity = 0.0f;
+		taskProfile.solvePosition = 0.0f;
 
-				// Was the other body already added to this island?
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+		for (int32 i = index; i < rangeCount; i += taskCount)
+		{
+			const b2IslandRange& range = ranges[i];
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
-			}
+			b2Island island(range.bodyCount, range.contactCount, range.jointCount,
+							allocators + index, listener, sharedBodyCount);
 
-			// Search all joints connect to this body.
-			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+			for (int32 j = 0; j < range.bodyCount; ++j)
 			{
-				if (je->joint->m_islandFlag == true)
+				b2Body* b = islands->m_bodies[range.bodyStart + j];
+				if (b->GetType() == b2_staticBody)
 				{
-					continue;
+					island.AddShared(b);
 				}
-
-				b2Body* other = je->other;
-
-				// Don't simulate joints connected to inactive bodies.
-				if (other->IsActive() == false)
+				else
 				{
-					continue;
+					island.Add(b);
 				}
+			}
+			for (int32 j = 0; j < range.contactCount; ++j)
+			{
+				island.Add(islands->m_contacts[range.contactStart + j]);
+			}
+			for (int32 j = 0; j < range.jointCount; ++j)
+			{
+				island.Add(islands->m_joints[range.jointStart + j]);
+			}
+
+			b2Profile profile;
+			island.Solve(&profile, *step, gravity, allowSleep);
+			taskProfile.solveInit += profile.solveInit;
+			taskProfile.solveVelocity += profile.solveVelocity;
+			taskProfile.solvePosition += profile.solvePosition;
+		}
+	}
 
-				island.Add(je->joint);
-				je->joint->m_islandFlag = true;
+	const b2Island* islands;
+	const b2IslandRange* ranges;
+	int32 rangeCount;
+	int32 taskCount;
+	int32 sharedBodyCount;
+	b2StackAllocator* allocators;
+	b2Profile* profiles;
+	b2ContactListener* listener;
+	const b2TimeStep* step;
+	b2Vec2 gravity;
+	bool allowSleep;
+};
 
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+// Finds all the awake islands first, and then solves them on the executor's
+// threads. A static body can be part of several islands at once, so rather
+// than letting each island overwrite its island index, every static body that
+// is touched gets a slot of its own at the start of all the islands' state arrays.
+void b2World::SolveInParallel(const b2TimeStep& step)
+{
+	ClearIslandFlags();
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
-			}
+	// A static body is added to an island once for each contact or joint that
+	// connects it, so in the worst case there can be more entries than bodies.
+	b2Island islands(m_bodyCount + m_contactManager.m_contactCount + m_jointCount,
+					 m_contactManager.m_contactCount,
+					 m_jointCount,
+					 &m_stackAllocator,
+					 m_contactManager.m_contactListener);
+
+	int32 stackSize = m_bodyCount;
+	b2IslandRange* ranges = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+	int32 rangeCount = 0;
+
+	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	{
+		if (seed->m_flags & b2Body::e_islandFlag)
+		{
+			continue;
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		if (seed->IsAwake() == false || seed->IsActive() == false)
+		{
+			continue;
+		}
 
-		// Post solve cleanup.
-		for (int32 i = 0; i < island.m_bodyCount; ++i)
+		// The seed can be dynamic or kinematic.
+		if (seed->GetType() == b2_staticBody)
 		{
-			// Allow static bodies to participate in other islands.
-			b2Body* b = island.m_bodies[i];
+			continue;
+		}
+
+		b2IslandRange& range = ranges[rangeCount++];
+		range.bodyStart = islands.m_bodyCount;
+		range.contactStart = islands.m_contactCount;
+		range.jointStart = islands.m_jointCount;
+
+		BuildIsland(seed, stack, stackSize, &islands);
+
+		range.bodyCount = islands.m_bodyCount - range.bodyStart;
+		range.contactCount = islands.m_contactCount - range.contactStart;
+		range.jointCount = islands.m_jointCount - range.jointStart;
+
+		// Allow static bodies to participate in other islands.
+		for (int32 i = range.bodyStart; i < islands.m_bodyCount; ++i)
+		{
+			b2Body* b = islands.m_bodies[i];
 			if (b->GetType() == b2_staticBody)
 			{
 				b->m_flags &= ~b2Body::e_islandFlag;
+				b->m_islandIndex = -1;
 			}
 		}
 	}
 
 	m_stackAllocator.Free(stack);
 
+	// Give each static body its shared slot.
+	int32 sharedBodyCount = 0;
+	for (int32 i = 0; i < islands.m_bodyCount; ++i)
 	{
-		b2Timer timer;
-		// Synchronize fixtures, check for out of range bodies.
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		b2Body* b = islands.m_bodies[i];
+		if (b->GetType() == b2_staticBody && b->m_islandIndex < 0)
 		{
-			// If a body was not in an island then it did not move.
-			if ((b->m_flags & b2Body::e_islandFlag) == 0)
-			{
-				continue;
-			}
+			b->m_islandIndex = sharedBodyCount++;
+		}
+	}
 
-			if (b->GetType() == b2_staticBody)
-			{
-				continue;
-			}
+	std::sort(ranges, ranges + rangeCount, b2IslandRangeIsBigger);
+
+	int32 taskCount = b2Min(m_parallelExecutor->GetThreadCount(), rangeCount);
+	if (taskCount > m_taskAllocatorCount)
+	{
+		delete[] m_taskAllocators;
+		m_taskAllocators = new b2StackAllocator[taskCount];
+		m_taskAllocatorCount = taskCount;
+	}
+
+	b2Profile* profiles = (b2Profile*)m_stackAllocator.Allocate(b2Max(taskCount, 1) * sizeof(b2Profile));
+
+	b2SolveIslandsTask task;
+	task.islands = &islands;
+	task.ranges = ranges;
+	task.rangeCount = rangeCount;
+	task.taskCount = taskCount;
+	task.sharedBodyCount = sharedBodyCount;
+	task.allocators = m_taskAllocators;
+	task.profiles = profiles;
+	task.listener = m_contactManager.m_contactListener;
+	task.step = &step;
+	task.gravity = m_gravity;
+	task.allowSleep = m_allowSleep;
+
+	if (taskCount > 1)
+	{
+		m_parallelExecutor->Run(&task, taskCount);
+	}
+	else if (taskCount == 1)
+	{
+		task.Execute(0);
+	}
+
+	for (int32 i = 0; i < taskCount; ++i)
+	{
+		m_profile.solveInit += profiles[i].solveInit;
+		m_profile.solveVelocity += profiles[i].solveVelocity;
+		m_profile.solvePosition += profiles[i].solvePosition;
+	}
 
-			// Update fixtures (for broad-phase).
-			b->SynchronizeFixtures();
+	m_stackAllocator.Free(profiles);
+	m_stackAllocator.Free(ranges);
+}
+
+void b2World::SynchronizeFixtures()
+{
+	b2Timer timer;
+
+	// Synchronize fixtures, check for out of range bodies.
+	for (b2Body* b = m_bodyList; b; b = b->GetNext())
+	{
+		// If a body was not in an island then it did not move.
+		if ((b->m_flags & b2Body::e_islandFlag) == 0)
+		{
+			continue;
 		}
 
-		// Look for new contacts.
-		m_contactManager.FindNewContacts();
-		m_profile.broadphase = timer.GetMilliseconds();
+		if (b->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		// Update fixtures (for broad-phase).
+		b->SynchronizeFixtures();
 	}
+
+	// Look for new contacts.
+	m_contactManager.FindNewContacts();
+	m_profile.broadphase = timer.GetMilliseconds();
 }
 
 // Find TOI contacts and solve them.
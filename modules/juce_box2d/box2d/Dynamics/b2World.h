@@ -22,6 +22,7 @@
 #include "../Common/b2Math.h"
 #include "../Common/b2BlockAllocator.h"
 #include "../Common/b2StackAllocator.h"
+#include "../Common/b2ParallelExecutor.h"
 #include "b2ContactManager.h"
 #include "b2WorldCallbacks.h"
 #include "b2TimeStep.h"
@@ -34,6 +35,7 @@ class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+class b2Island;
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -66,6 +68,17 @@ public:
 	/// by you and must remain in scope.
 	void SetDebugDraw(b2Draw* debugDraw);
 
+	/// Register an executor that lets the world solve independent islands, and
+	/// find new broad-phase pairs, on several threads at once. The executor is
+	/// owned by you and must remain in scope. Pass NULL to go back to solving
+	/// everything on the thread that calls Step.
+	/// @warning while an executor is set, b2ContactListener::PostSolve may be
+	/// called on several threads at the same time.
+	void SetParallelExecutor(b2ParallelExecutor* executor);
+
+	/// Get the executor set by SetParallelExecutor, or NULL.
+	b2ParallelExecutor* GetParallelExecutor() const { return m_parallelExecutor; }
+
 	/// Create a rigid body given a definition. No reference to the definition
 	/// is retained.
 	/// @warning This function is locked during callbacks.
@@ -220,14 +233,24 @@ private:
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	void SolveInParallel(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
 
+	void ClearIslandFlags();
+	void BuildIsland(b2Body* seed, b2Body** stack, int32 stackSize, b2Island* island);
+	void SynchronizeFixtures();
+
 	void DrawJoint(b2Joint* joint);
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 
 	b2BlockAllocator m_blockAllocator;
 	b2StackAllocator m_stackAllocator;
 
+	// Each of the executor's threads needs its own stack allocator.
+	b2ParallelExecutor* m_parallelExecutor;
+	b2StackAllocator* m_taskAllocators;
+	int32 m_taskAllocatorCount;
+
 	int32 m_flags;
 
 	b2ContactManager m_contactManager;
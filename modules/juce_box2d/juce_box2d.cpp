@@ -87,4 +87,5 @@
 namespace juce
 {
 #include "utils/juce_Box2DRenderer.cpp"
+#include "utils/juce_Box2DThreadPoolExecutor.cpp"
 }
@@ -34,6 +34,7 @@
 namespace juce
 {
   #include "utils/juce_Box2DRenderer.h"
+  #include "utils/juce_Box2DThreadPoolExecutor.h"
 }
 
 #endif   // __JUCE_BOX2D_JUCEHEADER__
@@ -23,7 +23,8 @@
   ==============================================================================
 */
 
-Box2DRenderer::Box2DRenderer() noexcept   : graphics (nullptr)
+Box2DRenderer::Box2DRenderer() noexcept
+    : graphics (nullptr), numBatchesInUse (0), lastBatchIndex (0)
 {
     SetFlags (e_shapeBit);
 }
@@ -40,6 +41,80 @@ void Box2DRenderer::render (Graphics& g, b2World& world,
 
     world.SetDebugDraw (this);
     world.DrawDebugData();
+
+    drawBatches();
+}
+
+Box2DRenderer::ColourBatch& Box2DRenderer::getBatch (const b2Color& c)
+{
+    const Colour colour (getColour (c));
+
+    // Box2D tends to draw runs of shapes in the same colour, so check the last one first.
+    if (lastBatchIndex < numBatchesInUse && batches.getUnchecked (lastBatchIndex)->colour == colour)
+        return *batches.getUnchecked (lastBatchIndex);
+
+    for (int i = 0; i < numBatchesInUse; ++i)
+    {
+        if (batches.getUnchecked (i)->colour == colour)
+        {
+            lastBatchIndex = i;
+            return *batches.getUnchecked (i);
+        }
+    }
+
+    if (numBatchesInUse == batches.size())
+        batches.add (new ColourBatch());
+
+    lastBatchIndex = numBatchesInUse++;
+    ColourBatch& batch = *batches.getUnchecked (lastBatchIndex);
+    batch.colour = colour;
+    return batch;
+}
+
+void Box2DRenderer::drawBatches()
+{
+    const PathStrokeType stroke (getLineThickness());
+
+    for (int i = 0; i < numBatchesInUse; ++i)
+    {
+        ColourBatch& batch = *batches.getUnchecked (i);
+        graphics->setColour (batch.colour);
+
+        if (! batch.polygons.isEmpty())  graphics->fillPath (batch.polygons);
+        if (! batch.circles.isEmpty())   graphics->fillPath (batch.circles);
+        if (! batch.outlines.isEmpty())  graphics->strokePath (batch.outlines, stroke);
+
+        // Clearing a path keeps its storage, so the next frame won't need to allocate.
+        batch.polygons.clear();
+        batch.circles.clear();
+        batch.outlines.clear();
+    }
+
+    numBatchesInUse = 0;
+    lastBatchIndex = 0;
+}
+
+void Box2DRenderer::renderProfile (Graphics& g, const b2World& world, const Rectangle<float>& target)
+{
+    g.setColour (Colours::white);
+    g.setFont (13.0f);
+    g.drawFittedText (getProfileDescription (world.GetProfile()),
+                      target.getSmallestIntegerContainer(), Justification::topLeft, 8, 1.0f);
+}
+
+String Box2DRenderer::getProfileDescription (const b2Profile& p)
+{
+    String s;
+    s << "step: "           << String (p.step, 2)          << " ms" << newLine
+      << "collide: "        << String (p.collide, 2)       << " ms" << newLine
+      << "solve: "          << String (p.solve, 2)         << " ms" << newLine
+      << "solve init: "     << String (p.solveInit, 2)     << " ms" << newLine
+      << "solve velocity: " << String (p.solveVelocity, 2) << " ms" << newLine
+      << "solve position: " << String (p.solvePosition, 2) << " ms" << newLine
+      << "broad-phase: "    << String (p.broadphase, 2)    << " ms" << newLine
+      << "solve TOI: "      << String (p.solveTOI, 2)      << " ms";
+
+    return s;
 }
 
 Colour Box2DRenderer::getColour (const b2Color& c) const
@@ -52,51 +127,43 @@ float Box2DRenderer::getLineThickness() const
     return 0.1f;
 }
 
-static void createPath (Path& p, const b2Vec2* vertices, int32 vertexCount)
+static void addPolygon (Path& p, const b2Vec2* vertices, int32 vertexCount)
 {
     p.startNewSubPath (vertices[0].x, vertices[0].y);
 
     for (int i = 1; i < vertexCount; ++i)
         p.lineTo (vertices[i].x, vertices[i].y);
+
+    p.closeSubPath();
 }
 
 void Box2DRenderer::DrawPolygon (const b2Vec2* vertices, int32 vertexCount, const b2Color& color)
 {
-    graphics->setColour (getColour (color));
-
-    Path p;
-    createPath (p, vertices, vertexCount);
-    graphics->strokePath (p, PathStrokeType (getLineThickness()));
+    addPolygon (getBatch (color).outlines, vertices, vertexCount);
 }
 
 void Box2DRenderer::DrawSolidPolygon (const b2Vec2* vertices, int32 vertexCount, const b2Color& color)
 {
-    graphics->setColour (getColour (color));
-
-    Path p;
-    createPath (p, vertices, vertexCount);
-    graphics->fillPath (p);
+    addPolygon (getBatch (color).polygons, vertices, vertexCount);
 }
 
 void Box2DRenderer::DrawCircle (const b2Vec2& center, float32 radius, const b2Color& color)
 {
-    graphics->setColour (getColour (color));
-    graphics->drawEllipse (center.x - radius, center.y - radius,
-                           radius * 2.0f, radius * 2.0f,
-                           getLineThickness());
+    getBatch (color).outlines.addEllipse (center.x - radius, center.y - radius,
+                                          radius * 2.0f, radius * 2.0f);
 }
 
-void Box2DRenderer::DrawSolidCircle (const b2Vec2& center, float32 radius, const b2Vec2& axis, const b2Color& color)
+void Box2DRenderer::DrawSolidCircle (const b2Vec2& center, float32 radius, const b2Vec2&, const b2Color& color)
 {
-    graphics->setColour (getColour (color));
-    graphics->fillEllipse (center.x - radius, center.y - radius,
-                           radius * 2.0f, radius * 2.0f);
+    getBatch (color).circles.addEllipse (center.x - radius, center.y - radius,
+                                         radius * 2.0f, radius * 2.0f);
 }
 
 void Box2DRenderer::DrawSegment (const b2Vec2& p1, const b2Vec2& p2, const b2Color& color)
 {
-    graphics->setColour (getColour (color));
-    graphics->drawLine (p1.x, p1.y, p2.x, p2.y, getLineThickness());
+    Path& p = getBatch (color).outlines;
+    p.startNewSubPath (p1.x, p1.y);
+    p.lineTo (p2.x, p2.y);
 }
 
 void Box2DRenderer::DrawTransform (const b2Transform&)
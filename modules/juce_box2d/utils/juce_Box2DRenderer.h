@@ -31,6 +31,12 @@
 
     To use it, simply create an instance of this class in your paint() method,
     and call its render() method.
+
+    Rather than drawing each shape as it arrives, the b2Draw methods add the shapes
+    to one path for each colour, and render() draws them all at the end. So a world
+    is drawn with a handful of fillPath() and strokePath() calls, however many bodies
+    it has. If you keep the renderer between frames instead of creating a new one each
+    time, it'll also reuse the paths' storage.
 */
 class Box2DRenderer   : public b2Draw
 
@@ -55,6 +61,18 @@ public:
                  float box2DWorldRight, float box2DWorldBottom,
                  const Rectangle<float>& targetArea);
 
+    /** Draws the timings from the world's most recent step as a few lines of text.
+
+        This shows the b2Profile that b2World::GetProfile() returns, so you can see how
+        long each phase of the step is taking, e.g. to decide whether the world would
+        benefit from a Box2DThreadPoolExecutor. Call it outside render(), as render()
+        leaves the context transformed into the world's coordinates.
+    */
+    void renderProfile (Graphics& g, const b2World& world, const Rectangle<float>& targetArea);
+
+    /** Returns a description of a b2Profile's timings, one phase per line. */
+    static String getProfileDescription (const b2Profile& profile);
+
     // b2Draw methods:
     void DrawPolygon (const b2Vec2*, int32, const b2Color&) override;
     void DrawSolidPolygon (const b2Vec2*, int32, const b2Color&) override;
@@ -71,6 +89,21 @@ public:
 protected:
     Graphics* graphics;
 
+private:
+    // Polygons and circles are kept apart because their windings may differ,
+    // which would leave holes where they overlap.
+    struct ColourBatch
+    {
+        Colour colour;
+        Path polygons, circles, outlines;
+    };
+
+    OwnedArray<ColourBatch> batches;
+    int numBatchesInUse, lastBatchIndex;
+
+    ColourBatch& getBatch (const b2Color&);
+    void drawBatches();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Box2DRenderer)
 };
 
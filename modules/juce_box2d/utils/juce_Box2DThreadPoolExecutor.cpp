@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+Box2DThreadPoolExecutor::Box2DThreadPoolExecutor (ThreadPool& p)
+    : pool (p), numPartsAllocated (0)
+{
+}
+
+Box2DThreadPoolExecutor::~Box2DThreadPoolExecutor()
+{
+}
+
+int32 Box2DThreadPoolExecutor::GetThreadCount() const
+{
+    // The calling thread does one part of each task itself.
+    return (int32) pool.getNumThreads() + 1;
+}
+
+void Box2DThreadPoolExecutor::Run (b2ParallelTask* task, int32 count)
+{
+    jassert (task != nullptr);
+
+    if (count <= 1)
+    {
+        if (count == 1)
+            task->Execute (0);
+
+        return;
+    }
+
+    if (numPartsAllocated < count)
+    {
+        parts.malloc ((size_t) count);
+        numPartsAllocated = count;
+    }
+
+    allPartsFinished.reset();
+    numPartsRemaining = count - 1;
+
+    for (int32 i = 1; i < count; ++i)
+    {
+        Part& part = parts[i];
+        part.owner = this;
+        part.task = task;
+        part.index = i;
+
+        pool.addJob (runPart, &part);
+    }
+
+    task->Execute (0);
+    allPartsFinished.wait();
+}
+
+void Box2DThreadPoolExecutor::runPart (void* userData)
+{
+    const Part& part = *static_cast<const Part*> (userData);
+    part.task->Execute (part.index);
+
+    if (--(part.owner->numPartsRemaining) == 0)
+        part.owner->allPartsFinished.signal();
+}
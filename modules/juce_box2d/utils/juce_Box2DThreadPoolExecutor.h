@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_BOX2DTHREADPOOLEXECUTOR_JUCEHEADER__
+#define __JUCE_BOX2DTHREADPOOLEXECUTOR_JUCEHEADER__
+
+//=============================================================================
+/** Lets a b2World spread its work across the threads of a ThreadPool.
+
+    Create one of these and pass it to b2World::SetParallelExecutor(). The world will
+    then solve its independent islands of bodies, and query its broad-phase tree, on
+    the pool's threads as well as the one that calls b2World::Step(). That makes a big
+    difference to worlds with thousands of bodies, as long as they're spread across
+    many islands.
+
+    While this is in use, your b2ContactListener::PostSolve() method may be called on
+    several threads at once.
+
+    @see Box2DRenderer::renderProfile
+*/
+class Box2DThreadPoolExecutor  : public b2ParallelExecutor
+{
+public:
+    /** Creates an executor that runs tasks on the given pool.
+        The pool must not be deleted while the executor is in use.
+    */
+    explicit Box2DThreadPoolExecutor (ThreadPool& pool);
+
+    /** Destructor. */
+    ~Box2DThreadPoolExecutor();
+
+    // b2ParallelExecutor methods:
+    int32 GetThreadCount() const override;
+    void Run (b2ParallelTask*, int32 count) override;
+
+private:
+    struct Part
+    {
+        Box2DThreadPoolExecutor* owner;
+        b2ParallelTask* task;
+        int32 index;
+    };
+
+    ThreadPool& pool;
+    HeapBlock<Part> parts;
+    int numPartsAllocated;
+    Atomic<int> numPartsRemaining;
+    WaitableEvent allPartsFinished;
+
+    static void runPart (void*);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Box2DThreadPoolExecutor)
+};
+
+
+#endif   // __JUCE_BOX2DTHREADPOOLEXECUTOR_JUCEHEADER__
@@ -148,9 +148,9 @@ public:
 private:
     StringPool identifierPool;
 
-    static DISPID getHashFromString (const String::CharPointerType& s) noexcept
+    static DISPID getHashFromString (const String& s) noexcept
     {
-        return (DISPID) (pointer_sized_int) s.getAddress();
+        return (DISPID) (pointer_sized_int) s.getCharPointer().getAddress();
     }
 
     JUCE_DECLARE_NON_COPYABLE (IDispatchHelper)
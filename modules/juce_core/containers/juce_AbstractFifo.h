@@ -210,7 +210,9 @@ public:
 private:
     //==============================================================================
     int bufferSize;
-    Atomic <int> validStart, validEnd;
+    Atomic <int> validStart;
+    char padding [64 - sizeof (Atomic <int>)]; // keeps the reader's and writer's positions on separate cache lines
+    Atomic <int> validEnd;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AbstractFifo)
 };
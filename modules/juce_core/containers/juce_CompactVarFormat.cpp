@@ -0,0 +1,1122 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace CompactVarFormatHelpers
+{
+    enum
+    {
+        formatMagic     = 0xc7,
+        formatVersion   = 1,
+
+        tagVoid         = 0,
+        tagFalse        = 1,
+        tagTrue         = 2,
+        tagInt          = 3,    // zig-zag varint
+        tagInt64        = 4,    // zig-zag varint
+        tagDouble       = 5,    // 8 bytes, little-endian
+        tagString       = 6,    // varint length, UTF-8 bytes, null terminator
+        tagBinary       = 7,    // varint length, bytes
+        tagArray        = 8,    // varint count, 32-bit body size, items
+        tagObject       = 9,    // varint count, 32-bit body size, (varint key index, item) pairs
+        tagIntArray     = 10,   // varint count, padding to a 4-byte boundary, 32-bit ints
+        tagInt64Array   = 11,   // varint count, padding to an 8-byte boundary, 64-bit ints
+        tagDoubleArray  = 12,   // varint count, padding to an 8-byte boundary, doubles
+        numTags         = 13,
+
+        // (these never appear in the data - they're the types of the elements of packed arrays)
+        elementInt      = 0x40,
+        elementInt64    = 0x41,
+        invalidType     = 0xff,
+
+        maxDepth        = 1024
+    };
+
+    static inline bool isPackedArray (const uint8 type) noexcept
+    {
+        return type == tagIntArray || type == tagInt64Array || type == tagDoubleArray;
+    }
+
+    static inline size_t getElementSize (const uint8 packedArrayType) noexcept
+    {
+        return packedArrayType == tagIntArray ? 4 : 8;
+    }
+
+    static inline uint8 getElementType (const uint8 packedArrayType) noexcept
+    {
+        return packedArrayType == tagIntArray ? (uint8) elementInt
+                                              : (packedArrayType == tagInt64Array ? (uint8) elementInt64 : (uint8) tagDouble);
+    }
+
+    static inline uint64 zigZagEncode (const int64 v) noexcept    { return (((uint64) v) << 1) ^ (uint64) (v >> 63); }
+    static inline int64 zigZagDecode (const uint64 v) noexcept    { return (int64) (v >> 1) ^ -(int64) (v & 1); }
+
+    static bool readVarint (const uint8*& p, const uint8* const end, uint64& result) noexcept
+    {
+        result = 0;
+
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (p >= end)
+                return false;
+
+            const uint8 byte = *p++;
+            result |= ((uint64) (byte & 0x7f)) << shift;
+
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    static inline uint32 readUInt32 (const uint8* const p) noexcept
+    {
+        uint32 v;
+        memcpy (&v, p, sizeof (v));
+        return ByteOrder::swapIfBigEndian (v);
+    }
+
+    static inline uint64 readUInt64 (const uint8* const p) noexcept
+    {
+        uint64 v;
+        memcpy (&v, p, sizeof (v));
+        return ByteOrder::swapIfBigEndian (v);
+    }
+
+    static inline double readDouble (const uint8* const p) noexcept
+    {
+        union { uint64 asInt; double asDouble; } n;
+        n.asInt = readUInt64 (p);
+        return n.asDouble;
+    }
+
+    //==============================================================================
+    class Writer
+    {
+    public:
+        Writer() : keyIndexes (64) {}
+
+        void writeMessage (const var& v)
+        {
+            addKeys (v);
+
+            out.writeByte ((char) formatMagic);
+            out.writeByte ((char) formatVersion);
+            writeVarint ((uint64) keys.size());
+
+            for (int i = 0; i < keys.size(); ++i)
+            {
+                const CharPointer_UTF8 name (keys.getReference(i).getCharPointer());
+                out.write (name.getAddress(), name.sizeInBytes());
+            }
+
+            writeValue (v);
+        }
+
+        MemoryOutputStream out;
+
+    private:
+        FlatHashMap<Identifier, int> keyIndexes;
+        Array<Identifier> keys;
+
+        void addKeys (const var& v)
+        {
+            if (DynamicObject* const object = v.getDynamicObject())
+            {
+                const NamedValueSet& props = object->getProperties();
+
+                for (int i = 0; i < props.size(); ++i)
+                {
+                    const Identifier name (props.getName (i));
+
+                    if (! keyIndexes.contains (name))
+                    {
+                        keyIndexes.set (name, keys.size());
+                        keys.add (name);
+                    }
+
+                    addKeys (props.getValueAt (i));
+                }
+            }
+            else if (const Array<var>* const array = v.getArray())
+            {
+                for (int i = 0; i < array->size(); ++i)
+                    addKeys (array->getReference (i));
+            }
+        }
+
+        void writeVarint (uint64 v)
+        {
+            uint8 data [10];
+            int num = 0;
+
+            while (v >= 0x80)
+            {
+                data [num++] = (uint8) (v | 0x80);
+                v >>= 7;
+            }
+
+            data [num++] = (uint8) v;
+            out.write (data, (size_t) num);
+        }
+
+        void writeAlignmentPadding (const size_t alignment)
+        {
+            const size_t position = (size_t) out.getPosition();
+            out.writeRepeatedByte (0, (alignment - (position & (alignment - 1))) & (alignment - 1));
+        }
+
+        void writeBodySize (const int64 sizePosition)
+        {
+            const int64 endPosition = out.getPosition();
+            out.setPosition (sizePosition);
+            out.writeInt ((int) (endPosition - sizePosition - 4));
+            out.setPosition (endPosition);
+        }
+
+        void writeValue (const var& v)
+        {
+            if (v.isBool())
+            {
+                out.writeByte ((char) (static_cast<bool> (v) ? tagTrue : tagFalse));
+            }
+            else if (v.isInt())
+            {
+                out.writeByte ((char) tagInt);
+                writeVarint (zigZagEncode (static_cast<int> (v)));
+            }
+            else if (v.isInt64())
+            {
+                out.writeByte ((char) tagInt64);
+                writeVarint (zigZagEncode (static_cast<int64> (v)));
+            }
+            else if (v.isDouble())
+            {
+                out.writeByte ((char) tagDouble);
+                out.writeDouble (static_cast<double> (v));
+            }
+            else if (v.isString())
+            {
+                const String s (v.toString());
+                const size_t numBytes = s.getNumBytesAsUTF8();
+                out.writeByte ((char) tagString);
+                writeVarint (numBytes);
+                out.write (s.toRawUTF8(), numBytes + 1);
+            }
+            else if (const MemoryBlock* const mb = v.getBinaryData())
+            {
+                out.writeByte ((char) tagBinary);
+                writeVarint (mb->getSize());
+                out.write (mb->getData(), mb->getSize());
+            }
+            else if (const Array<var>* const array = v.getArray())
+            {
+                writeArray (*array);
+            }
+            else if (const Array<int>* const ints = v.getIntArray())
+            {
+                writePackedArray (tagIntArray, *ints);
+            }
+            else if (const Array<float>* const floats = v.getFloatArray())
+            {
+                writePackedArray (tagDoubleArray, *floats);
+            }
+            else if (const Array<double>* const doubles = v.getDoubleArray())
+            {
+                writePackedArray (tagDoubleArray, *doubles);
+            }
+            else if (DynamicObject* const object = v.getDynamicObject())
+            {
+                writeObject (*object);
+            }
+            else
+            {
+                // Only DynamicObjects can be stored, and methods are written as void
+                jassert (v.isVoid() || v.isMethod());
+                out.writeByte ((char) tagVoid);
+            }
+        }
+
+        static uint8 getPackedArrayType (const Array<var>& array) noexcept
+        {
+            if (array.size() == 0)
+                return tagArray;
+
+            const var& first = array.getReference (0);
+            const uint8 type = first.isInt() ? (uint8) tagIntArray
+                                             : (first.isInt64() ? (uint8) tagInt64Array
+                                                                : (first.isDouble() ? (uint8) tagDoubleArray : (uint8) tagArray));
+
+            for (int i = 1; i < array.size() && type != tagArray; ++i)
+            {
+                const var& v = array.getReference (i);
+
+                if (! (type == tagIntArray ? v.isInt() : (type == tagInt64Array ? v.isInt64() : v.isDouble())))
+                    return tagArray;
+            }
+
+            return type;
+        }
+
+        void writeArray (const Array<var>& array)
+        {
+            const uint8 type = getPackedArrayType (array);
+            out.writeByte ((char) type);
+            writeVarint ((uint64) array.size());
+
+            if (type == tagArray)
+            {
+                const int64 sizePosition = out.getPosition();
+                out.writeInt (0);
+
+                for (int i = 0; i < array.size(); ++i)
+                    writeValue (array.getReference (i));
+
+                writeBodySize (sizePosition);
+            }
+            else
+            {
+                writeAlignmentPadding (getElementSize (type));
+
+                for (int i = 0; i < array.size(); ++i)
+                {
+                    const var& v = array.getReference (i);
+
+                    if (type == tagIntArray)         out.writeInt (static_cast<int> (v));
+                    else if (type == tagInt64Array)  out.writeInt64 (static_cast<int64> (v));
+                    else                             out.writeDouble (static_cast<double> (v));
+                }
+            }
+        }
+
+        // (float arrays are widened and stored as doubles)
+        template <typename ElementType>
+        void writePackedArray (const uint8 type, const Array<ElementType>& array)
+        {
+            out.writeByte ((char) type);
+            writeVarint ((uint64) array.size());
+            writeAlignmentPadding (getElementSize (type));
+
+            for (int i = 0; i < array.size(); ++i)
+            {
+                if (type == tagIntArray)    out.writeInt ((int) array.getUnchecked (i));
+                else                        out.writeDouble ((double) array.getUnchecked (i));
+            }
+        }
+
+        void writeObject (DynamicObject& object)
+        {
+            const NamedValueSet& props = object.getProperties();
+
+            out.writeByte ((char) tagObject);
+            writeVarint ((uint64) props.size());
+            const int64 sizePosition = out.getPosition();
+            out.writeInt (0);
+
+            for (int i = 0; i < props.size(); ++i)
+            {
+                writeVarint ((uint64) keyIndexes [props.getName (i)]);
+                writeValue (props.getValueAt (i));
+            }
+
+            writeBodySize (sizePosition);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (Writer)
+    };
+}
+
+//==============================================================================
+void CompactVarFormat::write (OutputStream& output, const var& value)
+{
+    CompactVarFormatHelpers::Writer writer;
+    writer.writeMessage (value);
+    output << writer.out;
+}
+
+Result CompactVarFormat::read (const void* const data, const size_t numBytes, var& result)
+{
+    result = var::null;
+    const Reader reader (data, numBytes);
+
+    if (reader.getResult().failed())
+        return reader.getResult();
+
+    Array<Identifier> keys;
+    keys.ensureStorageAllocated (reader.keys.size());
+
+    for (int i = 0; i < reader.keys.size(); ++i)
+        keys.add (Identifier (reader.keys.getUnchecked (i)));
+
+    if (! convertToVar (reader.getRoot(), result, keys, 0))
+    {
+        result = var::null;
+        return Result::fail ("Corrupt data");
+    }
+
+    return Result::ok();
+}
+
+var CompactVarFormat::read (const MemoryBlock& data)
+{
+    var result;
+    read (data.getData(), data.getSize(), result);
+    return result;
+}
+
+bool CompactVarFormat::convertToVar (const Node& node, var& result, const Array<Identifier>& keys, const int depth)
+{
+    using namespace CompactVarFormatHelpers;
+
+    switch (node.type)
+    {
+        case tagVoid:       result = var::null; return true;
+        case tagFalse:      result = false; return true;
+        case tagTrue:       result = true; return true;
+        case tagInt:
+        case elementInt:    result = (int) node.getInt64(); return node.getEnd() != nullptr;
+        case tagInt64:
+        case elementInt64:  result = node.getInt64(); return node.getEnd() != nullptr;
+        case tagDouble:     result = node.getDouble(); return node.getEnd() != nullptr;
+
+        case tagString:
+        {
+            const uint8* const textEnd = node.getEnd();
+
+            if (textEnd == nullptr)
+                return false;
+
+            result = String (node.getText(), CharPointer_UTF8 (reinterpret_cast <const char*> (textEnd - 1)));
+            return true;
+        }
+
+        case tagBinary:
+            if (node.getEnd() == nullptr)
+                return false;
+
+            result = MemoryBlock (node.getBinaryData(), node.getBinaryDataSize());
+            return true;
+
+        case tagArray:
+        case tagIntArray:
+        case tagInt64Array:
+        case tagDoubleArray:
+        {
+            uint32 numItems;
+            const uint8* contentStart;
+            const uint8* contentEnd;
+
+            if (depth >= maxDepth || ! node.getContents (numItems, contentStart, contentEnd))
+                return false;
+
+            Array<var> array;
+            array.ensureStorageAllocated ((int) numItems);
+            Node item (node.getFirstChild());
+
+            for (uint32 i = 0; i < numItems; ++i)
+            {
+                var v;
+
+                if (! convertToVar (item, v, keys, depth + 1))
+                    return false;
+
+                array.add (v);
+                item = item.getNextSibling();
+            }
+
+            result = array;
+            return true;
+        }
+
+        case tagObject:
+        {
+            uint32 numItems;
+            const uint8* contentStart;
+            const uint8* contentEnd;
+
+            if (depth >= maxDepth || ! node.getContents (numItems, contentStart, contentEnd))
+                return false;
+
+            DynamicObject* const object = new DynamicObject();
+            result = object;
+            NamedValueSet& props = object->getProperties();
+            Node item (node.getFirstChild());
+
+            for (uint32 i = 0; i < numItems; ++i)
+            {
+                var v;
+
+                if (! convertToVar (item, v, keys, depth + 1))
+                    return false;
+
+                props.set (keys.getReference (item.keyIndex), v);
+                item = item.getNextSibling();
+            }
+
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+//==============================================================================
+CompactVarFormat::Reader::Reader (const void* const data, const size_t numBytes)
+    : start (static_cast <const uint8*> (data)), end (start + numBytes),
+      root (nullptr), result (Result::ok())
+{
+    readHeader();
+}
+
+CompactVarFormat::Reader::Reader (const MemoryBlock& data)
+    : start (static_cast <const uint8*> (data.getData())), end (start + data.getSize()),
+      root (nullptr), result (Result::ok())
+{
+    readHeader();
+}
+
+CompactVarFormat::Reader::~Reader()
+{
+}
+
+void CompactVarFormat::Reader::readHeader()
+{
+    using namespace CompactVarFormatHelpers;
+
+    if (end - start < 3 || start[0] != formatMagic || start[1] != formatVersion)
+    {
+        result = Result::fail ("Not a valid compact var stream");
+        return;
+    }
+
+    const uint8* p = start + 2;
+    uint64 numKeys;
+
+    if (! readVarint (p, end, numKeys) || numKeys > (uint64) (end - p))
+    {
+        result = Result::fail ("Corrupt data");
+        return;
+    }
+
+    keys.ensureStorageAllocated ((int) numKeys);
+
+    for (uint64 i = 0; i < numKeys; ++i)
+    {
+        const uint8* const terminator = static_cast <const uint8*> (memchr (p, 0, (size_t) (end - p)));
+
+        if (terminator == nullptr)
+        {
+            keys.clear();
+            result = Result::fail ("Corrupt data");
+            return;
+        }
+
+        keys.add (reinterpret_cast <const char*> (p));
+        p = terminator + 1;
+    }
+
+    root = p;
+}
+
+CompactVarFormat::Node CompactVarFormat::Reader::getRoot() const noexcept
+{
+    if (root == nullptr)
+        return Node();
+
+    return Node::createFromTag (this, root, end, CompactVarFormatHelpers::tagVoid, -1);
+}
+
+int CompactVarFormat::Reader::findKey (const char* const name) const noexcept
+{
+    for (int i = 0; i < keys.size(); ++i)
+        if (strcmp (keys.getUnchecked (i), name) == 0)
+            return i;
+
+    return -1;
+}
+
+//==============================================================================
+CompactVarFormat::Node::Node() noexcept
+    : reader (nullptr), data (nullptr), parentEnd (nullptr),
+      type (CompactVarFormatHelpers::invalidType), parentType (CompactVarFormatHelpers::tagVoid), keyIndex (-1)
+{
+}
+
+CompactVarFormat::Node::Node (const Reader* const r, const uint8 t, const uint8* const d,
+                              const uint8* const pe, const uint8 pt, const int key) noexcept
+    : reader (r), data (d), parentEnd (pe), type (t), parentType (pt), keyIndex (key)
+{
+}
+
+CompactVarFormat::Node CompactVarFormat::Node::createFromTag (const Reader* const r, const uint8* const tag,
+                                                              const uint8* const parentEnd, const uint8 parentType,
+                                                              const int keyIndex) noexcept
+{
+    if (tag >= parentEnd || *tag >= CompactVarFormatHelpers::numTags)
+        return Node();
+
+    return Node (r, *tag, tag + 1, parentEnd, parentType, keyIndex);
+}
+
+CompactVarFormat::Node CompactVarFormat::Node::createItem (const Reader* const r, const uint8 parentType,
+                                                           const uint8* position, const uint8* const parentEnd) noexcept
+{
+    using namespace CompactVarFormatHelpers;
+
+    if (parentType == tagArray)
+        return createFromTag (r, position, parentEnd, parentType, -1);
+
+    if (parentType == tagObject)
+    {
+        uint64 key;
+
+        if (! readVarint (position, parentEnd, key) || key >= (uint64) r->keys.size())
+            return Node();
+
+        return createFromTag (r, position, parentEnd, parentType, (int) key);
+    }
+
+    if (isPackedArray (parentType) && position + getElementSize (parentType) <= parentEnd)
+        return Node (r, getElementType (parentType), position, parentEnd, parentType, -1);
+
+    return Node();
+}
+
+bool CompactVarFormat::Node::getContents (uint32& numItems, const uint8*& contentStart, const uint8*& contentEnd) const noexcept
+{
+    using namespace CompactVarFormatHelpers;
+
+    const uint8* p = data;
+    uint64 count;
+
+    if (! readVarint (p, parentEnd, count))
+        return false;
+
+    if (type == tagArray || type == tagObject)
+    {
+        if (parentEnd - p < 4)
+            return false;
+
+        const uint32 bodySize = readUInt32 (p);
+        p += 4;
+
+        if (bodySize > (uint64) (parentEnd - p) || count > bodySize)
+            return false;
+
+        contentEnd = p + bodySize;
+    }
+    else if (isPackedArray (type))
+    {
+        const size_t elementSize = getElementSize (type);
+        p += (elementSize - ((size_t) (p - reader->start) & (elementSize - 1))) & (elementSize - 1);
+
+        if (p > parentEnd || count > (uint64) (parentEnd - p) / elementSize)
+            return false;
+
+        contentEnd = p + count * elementSize;
+    }
+    else
+    {
+        return false;
+    }
+
+    numItems = (uint32) count;
+    contentStart = p;
+    return true;
+}
+
+const uint8* CompactVarFormat::Node::getEnd() const noexcept
+{
+    using namespace CompactVarFormatHelpers;
+
+    const uint8* p = data;
+    uint64 n;
+
+    switch (type)
+    {
+        case tagVoid:
+        case tagFalse:
+        case tagTrue:       return p;
+
+        case tagInt:
+        case tagInt64:      return readVarint (p, parentEnd, n) ? p : nullptr;
+
+        case elementInt:    return p + 4 <= parentEnd ? p + 4 : nullptr;
+        case elementInt64:
+        case tagDouble:     return p + 8 <= parentEnd ? p + 8 : nullptr;
+
+        case tagString:
+            return (readVarint (p, parentEnd, n) && n < (uint64) (parentEnd - p) && p[n] == 0) ? p + n + 1 : nullptr;
+
+        case tagBinary:
+            return (readVarint (p, parentEnd, n) && n <= (uint64) (parentEnd - p)) ? p + n : nullptr;
+
+        default:
+        {
+            uint32 numItems;
+            const uint8* contentStart;
+            const uint8* contentEnd;
+            return getContents (numItems, contentStart, contentEnd) ? contentEnd : nullptr;
+        }
+    }
+}
+
+bool CompactVarFormat::Node::isValid() const noexcept       { return type != CompactVarFormatHelpers::invalidType; }
+bool CompactVarFormat::Node::isVoid() const noexcept        { return type == CompactVarFormatHelpers::tagVoid; }
+bool CompactVarFormat::Node::isBool() const noexcept        { return type == CompactVarFormatHelpers::tagFalse || type == CompactVarFormatHelpers::tagTrue; }
+bool CompactVarFormat::Node::isInt() const noexcept         { return type == CompactVarFormatHelpers::tagInt || type == CompactVarFormatHelpers::elementInt; }
+bool CompactVarFormat::Node::isInt64() const noexcept       { return type == CompactVarFormatHelpers::tagInt64 || type == CompactVarFormatHelpers::elementInt64; }
+bool CompactVarFormat::Node::isDouble() const noexcept      { return type == CompactVarFormatHelpers::tagDouble; }
+bool CompactVarFormat::Node::isString() const noexcept      { return type == CompactVarFormatHelpers::tagString; }
+bool CompactVarFormat::Node::isArray() const noexcept       { return type == CompactVarFormatHelpers::tagArray || CompactVarFormatHelpers::isPackedArray (type); }
+bool CompactVarFormat::Node::isObject() const noexcept      { return type == CompactVarFormatHelpers::tagObject; }
+bool CompactVarFormat::Node::isBinaryData() const noexcept  { return type == CompactVarFormatHelpers::tagBinary; }
+
+int64 CompactVarFormat::Node::getInt64() const noexcept
+{
+    using namespace CompactVarFormatHelpers;
+
+    switch (type)
+    {
+        case tagTrue:       return 1;
+        case elementInt:    return (int64) (int) readUInt32 (data);
+        case elementInt64:  return (int64) readUInt64 (data);
+
+        case tagDouble:
+            return getEnd() != nullptr ? (int64) readDouble (data) : 0;
+
+        case tagInt:
+        case tagInt64:
+        {
+            const uint8* p = data;
+            uint64 n;
+            return readVarint (p, parentEnd, n) ? zigZagDecode (n) : 0;
+        }
+
+        default:            return 0;
+    }
+}
+
+double CompactVarFormat::Node::getDouble() const noexcept
+{
+    if (type == CompactVarFormatHelpers::tagDouble)
+        return getEnd() != nullptr ? CompactVarFormatHelpers::readDouble (data) : 0.0;
+
+    return (double) getInt64();
+}
+
+bool CompactVarFormat::Node::getBool() const noexcept
+{
+    return type == CompactVarFormatHelpers::tagDouble ? (getDouble() != 0.0)
+                                                      : (getInt64() != 0);
+}
+
+CharPointer_UTF8 CompactVarFormat::Node::getText() const noexcept
+{
+    if (type == CompactVarFormatHelpers::tagString && getEnd() != nullptr)
+    {
+        const uint8* p = data;
+        uint64 n;
+        CompactVarFormatHelpers::readVarint (p, parentEnd, n);
+        return CharPointer_UTF8 (reinterpret_cast <const char*> (p));
+    }
+
+    return CharPointer_UTF8 ("");
+}
+
+String CompactVarFormat::Node::toString() const
+{
+    if (type == CompactVarFormatHelpers::tagString)
+        return String (getText());
+
+    return toVar().toString();
+}
+
+const void* CompactVarFormat::Node::getBinaryData() const noexcept
+{
+    if (type == CompactVarFormatHelpers::tagBinary && getEnd() != nullptr)
+    {
+        const uint8* p = data;
+        uint64 n;
+        CompactVarFormatHelpers::readVarint (p, parentEnd, n);
+        return p;
+    }
+
+    return nullptr;
+}
+
+size_t CompactVarFormat::Node::getBinaryDataSize() const noexcept
+{
+    if (const uint8* const dataEnd = (type == CompactVarFormatHelpers::tagBinary ? getEnd() : nullptr))
+        return (size_t) (dataEnd - static_cast <const uint8*> (getBinaryData()));
+
+    return 0;
+}
+
+int CompactVarFormat::Node::size() const noexcept
+{
+    uint32 numItems;
+    const uint8* contentStart;
+    const uint8* contentEnd;
+
+    return getContents (numItems, contentStart, contentEnd) ? (int) numItems : 0;
+}
+
+CompactVarFormat::Node CompactVarFormat::Node::getFirstChild() const noexcept
+{
+    uint32 numItems;
+    const uint8* contentStart;
+    const uint8* contentEnd;
+
+    if (getContents (numItems, contentStart, contentEnd) && numItems > 0)
+        return createItem (reader, type, contentStart, contentEnd);
+
+    return Node();
+}
+
+CompactVarFormat::Node CompactVarFormat::Node::getNextSibling() const noexcept
+{
+    if (parentType != CompactVarFormatHelpers::tagVoid)
+        if (const uint8* const next = getEnd())
+            return createItem (reader, parentType, next, parentEnd);
+
+    return Node();
+}
+
+CompactVarFormat::Node CompactVarFormat::Node::operator[] (const int index) const noexcept
+{
+    uint32 numItems;
+    const uint8* contentStart;
+    const uint8* contentEnd;
+
+    if (! (getContents (numItems, contentStart, contentEnd) && isPositiveAndBelow (index, (int) numItems)))
+        return Node();
+
+    // (the elements of a packed array can be found directly)
+    if (CompactVarFormatHelpers::isPackedArray (type))
+        return createItem (reader, type, contentStart + (size_t) index * CompactVarFormatHelpers::getElementSize (type), contentEnd);
+
+    Node item (createItem (reader, type, contentStart, contentEnd));
+
+    for (int i = 0; i < index; ++i)
+        item = item.getNextSibling();
+
+    return item;
+}
+
+CompactVarFormat::Node CompactVarFormat::Node::operator[] (const char* const propertyName) const noexcept
+{
+    if (type == CompactVarFormatHelpers::tagObject)
+    {
+        const int key = reader->findKey (propertyName);
+
+        if (key >= 0)
+            for (Node item (getFirstChild()); item.isValid(); item = item.getNextSibling())
+                if (item.keyIndex == key)
+                    return item;
+    }
+
+    return Node();
+}
+
+const char* CompactVarFormat::Node::getName() const noexcept
+{
+    return keyIndex >= 0 ? reader->keys.getUnchecked (keyIndex) : nullptr;
+}
+
+const void* CompactVarFormat::Node::getNumericArray (const uint8 arrayType) const noexcept
+{
+   #if JUCE_LITTLE_ENDIAN
+    uint32 numItems;
+    const uint8* contentStart;
+    const uint8* contentEnd;
+
+    if (type == arrayType && getContents (numItems, contentStart, contentEnd)
+         && (((pointer_sized_int) contentStart) & (CompactVarFormatHelpers::getElementSize (type) - 1)) == 0)
+        return contentStart;
+   #else
+    (void) arrayType;
+   #endif
+
+    return nullptr;
+}
+
+const int* CompactVarFormat::Node::getIntArray() const noexcept        { return static_cast <const int*>    (getNumericArray (CompactVarFormatHelpers::tagIntArray)); }
+const int64* CompactVarFormat::Node::getInt64Array() const noexcept    { return static_cast <const int64*>  (getNumericArray (CompactVarFormatHelpers::tagInt64Array)); }
+const double* CompactVarFormat::Node::getDoubleArray() const noexcept  { return static_cast <const double*> (getNumericArray (CompactVarFormatHelpers::tagDoubleArray)); }
+
+var CompactVarFormat::Node::toVar() const
+{
+    Array<Identifier> keys;
+
+    if (reader != nullptr)
+        for (int i = 0; i < reader->keys.size(); ++i)
+            keys.add (Identifier (String (CharPointer_UTF8 (reader->keys.getUnchecked (i)))));
+
+    var result;
+    CompactVarFormat::convertToVar (*this, result, keys, 0);
+    return result;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class CompactVarFormatTests  : public UnitTest
+{
+public:
+    CompactVarFormatTests() : UnitTest ("CompactVarFormat") {}
+
+    static var createRandomVar (Random& r, int depth, bool allowBinary)
+    {
+        switch (r.nextInt (depth > 3 ? 7 : 11))
+        {
+            case 0:     return var::null;
+            case 1:     return r.nextInt();
+            case 2:     return r.nextInt64();
+            case 3:     return r.nextBool();
+            case 4:     return r.nextDouble() * 1.0e6 - 5.0e5;
+            case 5:     return String::repeatedString (String::fromUTF8 ("abc\xc3\xa9 "), r.nextInt (10)) + String (r.nextInt());
+
+            case 6:
+            {
+                if (! allowBinary)
+                    return String::empty;
+
+                MemoryBlock mb ((size_t) r.nextInt (40));
+                for (size_t i = 0; i < mb.getSize(); ++i)
+                    mb[(int) i] = (char) r.nextInt (256);
+                return mb;
+            }
+
+            case 7:
+            case 8:
+            {
+                Array<var> array;
+                const int type = r.nextInt (4);
+
+                for (int i = r.nextInt (30); --i >= 0;)
+                {
+                    switch (type)
+                    {
+                        case 0:   array.add (r.nextInt()); break;
+                        case 1:   array.add (r.nextInt64()); break;
+                        case 2:   array.add (r.nextDouble()); break;
+                        default:  array.add (createRandomVar (r, depth + 1, allowBinary)); break;
+                    }
+                }
+
+                return array;
+            }
+
+            default:
+            {
+                DynamicObject* const o = new DynamicObject();
+
+                for (int i = r.nextInt (20); --i >= 0;)
+                    o->setProperty ("prop" + String (r.nextInt (40)), createRandomVar (r, depth + 1, allowBinary));
+
+                return o;
+            }
+        }
+    }
+
+    static bool areIdentical (const var& a, const var& b)
+    {
+        if (const Array<var>* const aa = a.getArray())
+        {
+            const Array<var>* const ba = b.getArray();
+
+            if (ba == nullptr || aa->size() != ba->size())
+                return false;
+
+            for (int i = 0; i < aa->size(); ++i)
+                if (! areIdentical (aa->getReference (i), ba->getReference (i)))
+                    return false;
+
+            return true;
+        }
+
+        if (DynamicObject* const ao = a.getDynamicObject())
+        {
+            DynamicObject* const bo = b.getDynamicObject();
+
+            if (bo == nullptr || ao->getProperties().size() != bo->getProperties().size())
+                return false;
+
+            for (int i = 0; i < ao->getProperties().size(); ++i)
+                if (ao->getProperties().getName (i) != bo->getProperties().getName (i)
+                     || ! areIdentical (ao->getProperties().getValueAt (i), bo->getProperties().getValueAt (i)))
+                    return false;
+
+            return true;
+        }
+
+        return a.equalsWithSameType (b);
+    }
+
+    static MemoryBlock toBlock (const var& v)
+    {
+        MemoryOutputStream mo;
+        CompactVarFormat::write (mo, v);
+        return mo.getMemoryBlock();
+    }
+
+    void runTest()
+    {
+        beginTest ("Round trip");
+        Random r;
+        r.setSeedRandomly();
+
+        for (int i = 200; --i >= 0;)
+        {
+            const var v (createRandomVar (r, 0, true));
+            const MemoryBlock data (toBlock (v));
+
+            var result;
+            expect (CompactVarFormat::read (data.getData(), data.getSize(), result).wasOk());
+            expect (areIdentical (v, result));
+
+            CompactVarFormat::Reader reader (data);
+            expect (areIdentical (v, reader.getRoot().toVar()));
+        }
+
+        beginTest ("Reading in place");
+
+        {
+            DynamicObject* const o = new DynamicObject();
+            var v (o);
+            Array<var> samples, ids;
+
+            for (int i = 0; i < 100; ++i)
+            {
+                samples.add (i * 0.5);
+                ids.add (i * 3);
+            }
+
+            o->setProperty ("name", String::fromUTF8 ("caf\xc3\xa9"));
+            o->setProperty ("samples", samples);
+            o->setProperty ("ids", ids);
+            o->setProperty ("flag", true);
+            o->setProperty ("big", (int64) 1 << 40);
+
+            const MemoryBlock data (toBlock (v));
+            const CompactVarFormat::Reader reader (data);
+            expect (reader.getResult().wasOk());
+
+            const CompactVarFormat::Node root (reader.getRoot());
+            expect (root.isObject() && root.size() == 5);
+            expect (String (root ["name"].getText()) == String::fromUTF8 ("caf\xc3\xa9"));
+            expect (root ["flag"].getBool() && root ["big"].isInt64() && root ["big"].getInt64() == (int64) 1 << 40);
+            expect (! root ["missing"].isValid() && ! root ["name"]["x"].isValid() && ! root [7].isValid());
+
+            const double* const d = root ["samples"].getDoubleArray();
+            expect (d != nullptr && d[99] == 49.5 && root ["samples"].size() == 100);
+            expect (root ["ids"].getIntArray() != nullptr && root ["ids"].getIntArray()[10] == 30);
+            expect (root ["ids"][20].isInt() && root ["ids"][20].getInt64() == 60);
+            expect (root ["samples"].getIntArray() == nullptr);
+
+            StringArray names;
+
+            for (CompactVarFormat::Node item (root.getFirstChild()); item.isValid(); item = item.getNextSibling())
+                names.add (item.getName());
+
+            expect (names.joinIntoString (",") == "name,samples,ids,flag,big");
+        }
+
+        beginTest ("Corrupt data");
+
+        for (int i = 50; --i >= 0;)
+        {
+            const MemoryBlock data (toBlock (createRandomVar (r, 0, true)));
+
+            // every truncated version must either fail or be read safely..
+            for (size_t len = 0; len < data.getSize(); ++len)
+            {
+                var result;
+                CompactVarFormat::read (data.getData(), len, result);
+            }
+
+            MemoryBlock damaged (data);
+
+            for (int j = 0; j < 10; ++j)
+            {
+                damaged [r.nextInt ((int) damaged.getSize())] = (char) r.nextInt (256);
+
+                var result;
+                CompactVarFormat::read (damaged.getData(), damaged.getSize(), result);
+            }
+        }
+
+        var result;
+        expect (CompactVarFormat::read ("{}", 2, result).failed());
+
+        beginTest ("Benchmark");
+
+        DynamicObject* const root = new DynamicObject();
+        var rootVar (root);
+
+        for (int i = 0; i < 2000; ++i)
+            root->setProperty ("item" + String (i), createRandomVar (r, 2, false));
+
+        const int numIterations = 5;
+        String json;
+        MemoryBlock data;
+
+        const double startTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numIterations; ++i)
+            json = JSON::toString (rootVar, true);
+
+        const double jsonWriteTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numIterations; ++i)
+            JSON::parse (json);
+
+        const double jsonReadTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numIterations; ++i)
+            data = toBlock (rootVar);
+
+        const double compactWriteTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numIterations; ++i)
+            expect (CompactVarFormat::read (data.getData(), data.getSize(), result).wasOk());
+
+        const double compactReadTime = Time::getMillisecondCounterHiRes();
+
+        logMessage ("JSON: " + String ((int) (json.getNumBytesAsUTF8() / 1024)) + " KB, write "
+                     + String ((jsonWriteTime - startTime) / numIterations, 2) + " ms, read "
+                     + String ((jsonReadTime - jsonWriteTime) / numIterations, 2) + " ms");
+
+        logMessage ("Compact: " + String ((int) (data.getSize() / 1024)) + " KB, write "
+                     + String ((compactWriteTime - jsonReadTime) / numIterations, 2) + " ms, read "
+                     + String ((compactReadTime - compactWriteTime) / numIterations, 2) + " ms");
+    }
+};
+
+static CompactVarFormatTests compactVarFormatTests;
+
+#endif
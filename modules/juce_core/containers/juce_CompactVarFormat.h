@@ -0,0 +1,256 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_COMPACTVARFORMAT_JUCEHEADER__
+#define __JUCE_COMPACTVARFORMAT_JUCEHEADER__
+
+#include "juce_Variant.h"
+#include "../misc/juce_Result.h"
+class OutputStream;
+
+
+//==============================================================================
+/**
+    Converts var objects to and from a compact binary format.
+
+    This is intended for passing data between processes, where the size of the
+    message and the time taken to decode it matter more than being human-readable.
+    Compared with var::writeToStream(), it:
+    - can store objects (i.e. DynamicObjects), as well as all the other var types.
+    - writes each property name only once per message, in a table at the start,
+      and refers to it by index after that.
+    - uses variable-length integers for lengths, counts and integer values.
+    - stores arrays that contain only ints, only int64s or only doubles as packed,
+      aligned blocks of numbers.
+
+    The data can be turned back into a var with read(), but if you only need some of
+    it, a Reader lets you look at the values in place, without copying anything or
+    creating any objects.
+
+    @code
+    MemoryOutputStream message;
+    CompactVarFormat::write (message, myData);
+    ...
+
+    CompactVarFormat::Reader reader (message.getData(), message.getDataSize());
+    const CompactVarFormat::Node samples (reader.getRoot() ["samples"]);
+
+    if (const double* values = samples.getDoubleArray())
+        processSamples (values, samples.size());
+    @endcode
+
+    @see var, JSON
+*/
+class JUCE_API  CompactVarFormat
+{
+public:
+    //==============================================================================
+    /** Writes a var, and everything that it contains, to a stream.
+
+        Methods can't be stored, and are written as void values.
+    */
+    static void write (OutputStream& output, const var& value);
+
+    /** Converts some data that was created by write() back into a var.
+
+        If the data is corrupt, this returns an error and sets the result to void.
+    */
+    static Result read (const void* data, size_t numBytes, var& result);
+
+    /** Converts a block of data that was created by write() back into a var.
+        If the data is corrupt, this returns a void var.
+    */
+    static var read (const MemoryBlock& data);
+
+    //==============================================================================
+    class Reader;
+
+    /**
+        A read-only view of one of the values inside some data that was created by
+        CompactVarFormat::write().
+
+        A Node is a small object that just points into the data, so you can copy it
+        around freely, but the data and the Reader that it came from must outlive it.
+        If you ask for an array element or property that doesn't exist, or the data
+        is corrupt, you'll get a Node for which isValid() returns false, and whose
+        methods all return empty values.
+    */
+    class JUCE_API  Node
+    {
+    public:
+        /** Creates an invalid node. */
+        Node() noexcept;
+
+        /** Returns false if this doesn't refer to a value. */
+        bool isValid() const noexcept;
+
+        bool isVoid() const noexcept;
+        bool isBool() const noexcept;
+        bool isInt() const noexcept;
+        bool isInt64() const noexcept;
+        bool isDouble() const noexcept;
+        bool isString() const noexcept;
+        bool isArray() const noexcept;
+        bool isObject() const noexcept;
+        bool isBinaryData() const noexcept;
+
+        /** Returns a bool, int, int64 or double value as a bool. */
+        bool getBool() const noexcept;
+        /** Returns a bool, int, int64 or double value as an int64. */
+        int64 getInt64() const noexcept;
+        /** Returns a bool, int, int64 or double value as a double. */
+        double getDouble() const noexcept;
+
+        /** Returns the text of a string value.
+            This points directly into the data, and is null-terminated.
+        */
+        CharPointer_UTF8 getText() const noexcept;
+
+        /** Returns the value as a String.
+            Unlike getText(), this will also convert numbers and bools to a string.
+        */
+        String toString() const;
+
+        /** Returns the contents of a binary data value. */
+        const void* getBinaryData() const noexcept;
+        /** Returns the size of a binary data value. */
+        size_t getBinaryDataSize() const noexcept;
+
+        /** Returns the number of elements in an array, or properties in an object. */
+        int size() const noexcept;
+
+        /** Returns one of the elements of an array, or the value of one of the
+            properties of an object.
+            This has to skip over all the items before it, so if you're iterating an
+            array, it's quicker to use getFirstChild() and getNextSibling().
+        */
+        Node operator[] (int index) const noexcept;
+
+        /** Returns the value of one of an object's properties. */
+        Node operator[] (const char* propertyName) const noexcept;
+
+        /** If this is the value of one of an object's properties, this returns the
+            property's name; otherwise it returns nullptr.
+        */
+        const char* getName() const noexcept;
+
+        /** Returns the first element of an array, or the first property value of an object. */
+        Node getFirstChild() const noexcept;
+
+        /** Returns the item that follows this one in its parent array or object.
+            When called on the last item, this returns an invalid node.
+        */
+        Node getNextSibling() const noexcept;
+
+        /** If this is an array which was stored as a packed block of ints, this returns
+            a pointer to them; otherwise it returns nullptr.
+            The pointer refers directly to the data, and will also be null if the data
+            doesn't start at an address that's suitably aligned, or if the machine is
+            big-endian.
+        */
+        const int* getIntArray() const noexcept;
+
+        /** If this is an array which was stored as a packed block of int64s, this returns
+            a pointer to them; otherwise it returns nullptr.
+            @see getIntArray
+        */
+        const int64* getInt64Array() const noexcept;
+
+        /** If this is an array which was stored as a packed block of doubles, this returns
+            a pointer to them; otherwise it returns nullptr.
+            @see getIntArray
+        */
+        const double* getDoubleArray() const noexcept;
+
+        /** Creates a var containing a copy of this value, and everything inside it. */
+        var toVar() const;
+
+    private:
+        friend class CompactVarFormat;
+        friend class Reader;
+        const Reader* reader;
+        const uint8* data;
+        const uint8* parentEnd;
+        uint8 type, parentType;
+        int keyIndex;
+
+        Node (const Reader*, uint8 type, const uint8* data, const uint8* parentEnd, uint8 parentType, int keyIndex) noexcept;
+        static Node createFromTag (const Reader*, const uint8* tag, const uint8* parentEnd, uint8 parentType, int keyIndex) noexcept;
+        static Node createItem (const Reader*, uint8 parentType, const uint8* position, const uint8* parentEnd) noexcept;
+        const uint8* getEnd() const noexcept;
+        bool getContents (uint32& numItems, const uint8*& contentStart, const uint8*& contentEnd) const noexcept;
+        const void* getNumericArray (uint8 arrayType) const noexcept;
+    };
+
+    //==============================================================================
+    /**
+        Provides access to the values in some data that was created by
+        CompactVarFormat::write(), without making a copy of it.
+
+        The data must remain valid and unchanged while the Reader and any Nodes that
+        it has returned are in use.
+    */
+    class JUCE_API  Reader
+    {
+    public:
+        /** Creates a Reader for a block of data. */
+        Reader (const void* data, size_t numBytes);
+
+        /** Creates a Reader for the contents of a MemoryBlock. */
+        explicit Reader (const MemoryBlock& data);
+
+        /** Destructor. */
+        ~Reader();
+
+        /** Returns an error if the data doesn't start with a valid header. */
+        const Result& getResult() const noexcept        { return result; }
+
+        /** Returns the top-level value. */
+        Node getRoot() const noexcept;
+
+    private:
+        friend class CompactVarFormat;
+        friend class Node;
+        const uint8* const start;
+        const uint8* const end;
+        const uint8* root;
+        Array<const char*> keys;
+        Result result;
+
+        void readHeader();
+        int findKey (const char* name) const noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE (Reader)
+    };
+
+private:
+    //==============================================================================
+    static bool convertToVar (const Node&, var& result, const Array<Identifier>& keys, int depth);
+
+    CompactVarFormat(); // This class can't be instantiated - just use its static methods.
+};
+
+
+#endif   // __JUCE_COMPACTVARFORMAT_JUCEHEADER__
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#if JUCE_UNIT_TESTS
+
+class FlatHashMapTests  : public UnitTest
+{
+public:
+    FlatHashMapTests() : UnitTest ("FlatHashMap") {}
+
+    template <class MapType>
+    static bool mapsMatch (const MapType& map, const HashMap<int, int>& reference)
+    {
+        if (map.size() != reference.size())
+            return false;
+
+        int numIterated = 0;
+
+        for (typename MapType::Iterator i (map); i.next();)
+        {
+            if (! reference.contains (i.getKey()) || reference [i.getKey()] != i.getValue())
+                return false;
+
+            ++numIterated;
+        }
+
+        return numIterated == reference.size();
+    }
+
+    template <class MapType>
+    static double timeInserts (MapType& map, const Array<int>& keys)
+    {
+        const double start = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < keys.size(); ++i)
+            map.set (keys.getUnchecked(i), i);
+
+        return Time::getMillisecondCounterHiRes() - start;
+    }
+
+    template <class MapType>
+    static double timeLookups (const MapType& map, const Array<int>& keys, int64& total)
+    {
+        const double start = Time::getMillisecondCounterHiRes();
+
+        for (int repeat = 0; repeat < 4; ++repeat)
+            for (int i = 0; i < keys.size(); ++i)
+                total += map [keys.getUnchecked(i)];
+
+        return Time::getMillisecondCounterHiRes() - start;
+    }
+
+    template <class MapType>
+    static double timeIteration (const MapType& map, int64& total)
+    {
+        const double start = Time::getMillisecondCounterHiRes();
+
+        for (int repeat = 0; repeat < 4; ++repeat)
+            for (typename MapType::Iterator i (map); i.next();)
+                total += i.getValue();
+
+        return Time::getMillisecondCounterHiRes() - start;
+    }
+
+    void runTest()
+    {
+        beginTest ("Basics");
+
+        {
+            FlatHashMap<String, String> map;
+            expectEquals (map.size(), 0);
+            expect (! map.contains ("a"));
+            expectEquals (map ["a"], String::empty);
+
+            map.set ("a", "1");
+            map.set ("b", "2");
+            map.set ("a", "3");
+
+            expectEquals (map.size(), 2);
+            expectEquals (map ["a"], String ("3"));
+            expectEquals (map ["b"], String ("2"));
+            expect (map.containsValue ("2"));
+            expect (! map.containsValue ("1"));
+
+            map.remove ("a");
+            expectEquals (map.size(), 1);
+            expect (! map.contains ("a"));
+
+            FlatHashMap<String, String> other;
+            other.set ("x", "y");
+            map.swapWith (other);
+            expectEquals (map ["x"], String ("y"));
+            expectEquals (other ["b"], String ("2"));
+
+            map.clear();
+            expectEquals (map.size(), 0);
+            expect (! map.contains ("x"));
+        }
+
+        beginTest ("Random operations");
+
+        {
+            Random r (0x5678);
+            FlatHashMap<int, int> map;
+            HashMap<int, int> reference;
+
+            for (int i = 0; i < 50000; ++i)
+            {
+                const int key = r.nextInt (5000) - 2500;
+
+                switch (r.nextInt (4))
+                {
+                    case 0:
+                    case 1:     map.set (key, i); reference.set (key, i); break;
+                    case 2:     map.remove (key); reference.remove (key); break;
+                    default:    expect (map.contains (key) == reference.contains (key)); break;
+                }
+            }
+
+            expect (mapsMatch (map, reference));
+
+            map.remapTable (map.getNumSlots() * 4);
+            expect (mapsMatch (map, reference));
+
+            map.remapTable (1);
+            expect (map.getNumSlots() > map.size());
+            expect (mapsMatch (map, reference));
+
+            for (int value = 0; value < 50000; value += 3)
+            {
+                map.removeValue (value);
+                reference.removeValue (value);
+            }
+
+            expect (mapsMatch (map, reference));
+        }
+
+        beginTest ("Benchmark");
+
+        {
+            Random r (0x1234);
+            Array<int> keys;
+
+            for (int i = 0; i < 200000; ++i)
+                keys.add (r.nextInt());
+
+            HashMap<int, int> chained;
+            FlatHashMap<int, int> flat;
+            int64 chainedTotal = 0, flatTotal = 0;
+
+            const double chainedInsert = timeInserts (chained, keys);
+            const double flatInsert    = timeInserts (flat, keys);
+            const double chainedLookup = timeLookups (chained, keys, chainedTotal);
+            const double flatLookup    = timeLookups (flat, keys, flatTotal);
+            const double chainedIterate = timeIteration (chained, chainedTotal);
+            const double flatIterate    = timeIteration (flat, flatTotal);
+
+            expect (chainedTotal == flatTotal);
+
+            logMessage ("Insert:  HashMap " + String (chainedInsert, 1) + " ms, FlatHashMap " + String (flatInsert, 1) + " ms");
+            logMessage ("Lookup:  HashMap " + String (chainedLookup, 1) + " ms, FlatHashMap " + String (flatLookup, 1) + " ms");
+            logMessage ("Iterate: HashMap " + String (chainedIterate, 1) + " ms, FlatHashMap " + String (flatIterate, 1) + " ms");
+        }
+    }
+};
+
+static FlatHashMapTests flatHashMapUnitTests;
+
+#endif
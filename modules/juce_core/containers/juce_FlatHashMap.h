@@ -0,0 +1,477 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_FLATHASHMAP_JUCEHEADER__
+#define __JUCE_FLATHASHMAP_JUCEHEADER__
+
+#include "juce_HashMap.h"
+#include "../memory/juce_HeapBlock.h"
+
+
+//==============================================================================
+/**
+    Holds a set of mappings between some key/value pairs, stored in a single flat table.
+
+    This has the same template parameters and methods as HashMap, and can be used as a
+    drop-in replacement for it, but it works very differently inside. HashMap allocates a
+    separate entry for every item and chains them from its slots, whereas this keeps all
+    the keys and values side-by-side in one contiguous block, using "Robin Hood" open
+    addressing to resolve collisions. That means adding an item doesn't allocate unless
+    the table needs to grow, and a lookup usually touches only one or two neighbouring
+    slots, so it's a lot kinder to the CPU's caches.
+
+    Each slot also stores the full hash of its key, so most mismatches are rejected
+    without comparing keys, and growing the table never has to call your hash function
+    again. The hash function class works as it does for HashMap, but it will be asked for
+    hashes over a very large range, so it should spread its results across the whole of
+    that range rather than just returning small numbers.
+
+    Unlike HashMap, removing items may move other items around in the table, so any
+    Iterator must not be used after the map has been changed.
+
+    @code
+    FlatHashMap<int, String> hash;
+    hash.set (1, "item1");
+    hash.set (2, "item2");
+
+    DBG (hash [1]); // prints "item1"
+
+    for (FlatHashMap<int, String>::Iterator i (hash); i.next();)
+        DBG (i.getKey() << " -> " << i.getValue());
+    @endcode
+
+    @see HashMap, DefaultHashFunctions
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionToUse = DefaultHashFunctions,
+          class TypeOfCriticalSectionToUse = DummyCriticalSection>
+class FlatHashMap
+{
+private:
+    typedef PARAMETER_TYPE (KeyType)   KeyTypeParameter;
+    typedef PARAMETER_TYPE (ValueType) ValueTypeParameter;
+
+public:
+    //==============================================================================
+    /** Creates an empty hash-map.
+
+        The number of slots is rounded up to a power of two, and will grow automatically
+        as items are added, or it can be changed manually using remapTable().
+    */
+    explicit FlatHashMap (const int numberOfSlots = defaultHashTableSize)
+       : numSlots (0), totalNumItems (0)
+    {
+        allocateSlots (getNumSlotsNeeded (numberOfSlots));
+    }
+
+    /** Destructor. */
+    ~FlatHashMap()
+    {
+        clear();
+    }
+
+    //==============================================================================
+    /** Removes all values from the map.
+        Note that this will clear the content, but won't affect the number of slots (see
+        remapTable and getNumSlots).
+    */
+    void clear()
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = numSlots; --i >= 0;)
+        {
+            if (hashes[i] != 0)
+            {
+                entries[i].~Entry();
+                hashes[i] = 0;
+            }
+        }
+
+        totalNumItems = 0;
+    }
+
+    //==============================================================================
+    /** Returns the current number of items in the map. */
+    inline int size() const noexcept
+    {
+        return totalNumItems;
+    }
+
+    /** Returns the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is returned.
+        @param keyToLookFor    the key of the item being requested
+    */
+    inline ValueType operator[] (KeyTypeParameter keyToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+        const int index = findSlot (keyToLookFor, generateHashFor (keyToLookFor));
+
+        return index >= 0 ? entries[index].value : ValueType();
+    }
+
+    //==============================================================================
+    /** Returns true if the map contains an item with the specied key. */
+    bool contains (KeyTypeParameter keyToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+        return findSlot (keyToLookFor, generateHashFor (keyToLookFor)) >= 0;
+    }
+
+    /** Returns true if the hash contains at least one occurrence of a given value. */
+    bool containsValue (ValueTypeParameter valueToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = numSlots; --i >= 0;)
+            if (hashes[i] != 0 && entries[i].value == valueToLookFor)
+                return true;
+
+        return false;
+    }
+
+    //==============================================================================
+    /** Adds or replaces an element in the hash-map.
+        If there's already an item with the given key, this will replace its value. Otherwise, a new item
+        will be added to the map.
+    */
+    void set (KeyTypeParameter newKey, ValueTypeParameter newValue)
+    {
+        const ScopedLockType sl (getLock());
+        const uint32 hash = generateHashFor (newKey);
+        const int index = findSlot (newKey, hash);
+
+        if (index >= 0)
+        {
+            entries[index].value = newValue;
+            return;
+        }
+
+        if ((totalNumItems + 1) * 8 > numSlots * 7)
+            remapTable (numSlots * 2);
+
+        insertNewItem (hash, newKey, newValue);
+        ++totalNumItems;
+    }
+
+    /** Removes an item with the given key. */
+    void remove (KeyTypeParameter keyToRemove)
+    {
+        const ScopedLockType sl (getLock());
+        const int index = findSlot (keyToRemove, generateHashFor (keyToRemove));
+
+        if (index >= 0)
+            removeSlot (index);
+    }
+
+    /** Removes all items with the given value. */
+    void removeValue (ValueTypeParameter valueToRemove)
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots;)
+        {
+            // removing an item may shift the next one back into this slot, so
+            // only move on when this slot has been checked
+            if (hashes[i] != 0 && entries[i].value == valueToRemove)
+                removeSlot (i);
+            else
+                ++i;
+        }
+    }
+
+    /** Remaps the hash-map to use a different number of slots.
+        The number is rounded up to a power of two, and won't be made smaller than the
+        number needed to hold the items that are already in the map.
+        @see getNumSlots()
+    */
+    void remapTable (int newNumberOfSlots)
+    {
+        const ScopedLockType sl (getLock());
+
+        newNumberOfSlots = getNumSlotsNeeded (jmax (newNumberOfSlots, (totalNumItems * 8) / 7 + 1));
+
+        if (newNumberOfSlots == numSlots)
+            return;
+
+        HeapBlock<uint32> oldHashes;
+        HeapBlock<Entry> oldEntries;
+        oldHashes.swapWith (hashes);
+        oldEntries.swapWith (entries);
+        const int oldNumSlots = numSlots;
+
+        allocateSlots (newNumberOfSlots);
+
+        for (int i = 0; i < oldNumSlots; ++i)
+        {
+            if (oldHashes[i] != 0)
+            {
+                Entry& e = oldEntries[i];
+                insertNewItem (oldHashes[i], e.key, e.value);
+                e.~Entry();
+            }
+        }
+    }
+
+    /** Returns the number of slots in the table.
+        @see remapTable()
+    */
+    inline int getNumSlots() const noexcept
+    {
+        return numSlots;
+    }
+
+    //==============================================================================
+    /** Efficiently swaps the contents of two hash-maps. */
+    void swapWith (FlatHashMap& otherHashMap) noexcept
+    {
+        const ScopedLockType lock1 (getLock());
+        const ScopedLockType lock2 (otherHashMap.getLock());
+
+        hashes.swapWith (otherHashMap.hashes);
+        entries.swapWith (otherHashMap.entries);
+        std::swap (numSlots, otherHashMap.numSlots);
+        std::swap (totalNumItems, otherHashMap.totalNumItems);
+    }
+
+    //==============================================================================
+    /** Returns the CriticalSection that locks this structure.
+        To lock, you can call getLock().enter() and getLock().exit(), or preferably use
+        an object of ScopedLockType as an RAII lock for it.
+    */
+    inline const TypeOfCriticalSectionToUse& getLock() const noexcept      { return lock; }
+
+    /** Returns the type of scoped lock to use for locking this array */
+    typedef typename TypeOfCriticalSectionToUse::ScopedLockType ScopedLockType;
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        Entry (KeyTypeParameter k, ValueTypeParameter v)  : key (k), value (v) {}
+
+        KeyType key;
+        ValueType value;
+    };
+
+public:
+    //==============================================================================
+    /** Iterates over the items in a FlatHashMap.
+
+        To use it, repeatedly call next() until it returns false, e.g.
+        @code
+        for (FlatHashMap<String, String>::Iterator i (myMap); i.next();)
+            DBG (i.getKey() << " -> " << i.getValue());
+        @endcode
+
+        The order in which items are iterated bears no resemblence to the order in which
+        they were originally added!
+
+        As soon as you call any non-const methods on the original hash-map, any
+        iterators that were created beforehand will cease to be valid, and should not be used.
+
+        @see FlatHashMap
+    */
+    class Iterator
+    {
+    public:
+        //==============================================================================
+        Iterator (const FlatHashMap& hashMapToIterate)
+            : hashMap (hashMapToIterate), index (-1)
+        {}
+
+        /** Moves to the next item, if one is available.
+            When this returns true, you can get the item's key and value using getKey() and
+            getValue(). If it returns false, the iteration has finished and you should stop.
+        */
+        bool next()
+        {
+            while (++index < hashMap.numSlots)
+                if (hashMap.hashes[index] != 0)
+                    return true;
+
+            return false;
+        }
+
+        /** Returns the current item's key.
+            This should only be called when a call to next() has just returned true.
+        */
+        KeyType getKey() const
+        {
+            return isPositiveAndBelow (index, hashMap.numSlots) ? hashMap.entries[index].key : KeyType();
+        }
+
+        /** Returns the current item's value.
+            This should only be called when a call to next() has just returned true.
+        */
+        ValueType getValue() const
+        {
+            return isPositiveAndBelow (index, hashMap.numSlots) ? hashMap.entries[index].value : ValueType();
+        }
+
+    private:
+        //==============================================================================
+        const FlatHashMap& hashMap;
+        int index;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Iterator)
+    };
+
+private:
+    //==============================================================================
+    enum { defaultHashTableSize = 16 };
+    friend class Iterator;
+
+    // For each slot, hashes holds 0 if it's empty, or else the hash of its key with the top
+    // bit set. The key and value live at the same index in entries.
+    HeapBlock<uint32> hashes;
+    HeapBlock<Entry> entries;
+    int numSlots, totalNumItems;
+    TypeOfCriticalSectionToUse lock;
+
+    static int getNumSlotsNeeded (const int minimumNumSlots) noexcept
+    {
+        int n = 8;
+
+        while (n < minimumNumSlots)
+            n <<= 1;
+
+        return n;
+    }
+
+    void allocateSlots (const int newNumSlots)
+    {
+        hashes.calloc ((size_t) newNumSlots);
+        entries.malloc ((size_t) newNumSlots);
+        numSlots = newNumSlots;
+    }
+
+    uint32 generateHashFor (KeyTypeParameter key) const
+    {
+        const int rawHash = HashFunctionToUse::generateHash (key, 0x7fffffff);
+        jassert (rawHash >= 0); // your hash function is generating out-of-range numbers!
+
+        // scramble the bits so that sequences of similar keys spread out across the table
+        uint32 hash = ((uint32) rawHash) * 0x9e3779b1u;
+        hash ^= (hash >> 16);
+        return hash | 0x80000000u;
+    }
+
+    // The number of slots that the item in this slot is away from where its hash wanted it to be
+    inline int getProbeDistance (const int index, const uint32 hash) const noexcept
+    {
+        return (index - (int) hash) & (numSlots - 1);
+    }
+
+    int findSlot (KeyTypeParameter key, const uint32 hash) const
+    {
+        const int mask = numSlots - 1;
+
+        for (int index = (int) hash & mask, distance = 0;; index = (index + 1) & mask, ++distance)
+        {
+            const uint32 h = hashes[index];
+
+            // Because items are always kept in order of their probe distance, we can
+            // stop as soon as we reach one that's closer to home than ours would be.
+            if (h == 0 || getProbeDistance (index, h) < distance)
+                return -1;
+
+            if (h == hash && entries[index].key == key)
+                return index;
+        }
+    }
+
+    void insertNewItem (uint32 hash, KeyTypeParameter newKey, ValueTypeParameter newValue)
+    {
+        const int mask = numSlots - 1;
+        int index = (int) hash & mask;
+        int distance = 0;
+
+        // find the first slot where the item is further from home than the current occupant..
+        for (;; index = (index + 1) & mask, ++distance)
+        {
+            const uint32 h = hashes[index];
+
+            if (h == 0)
+            {
+                new (entries + index) Entry (newKey, newValue);
+                hashes[index] = hash;
+                return;
+            }
+
+            if (getProbeDistance (index, h) < distance)
+                break;
+        }
+
+        // ..then put it there, shifting the following occupants along to the next empty slot
+        int lastIndex = index;
+
+        while (hashes [lastIndex = (lastIndex + 1) & mask] != 0)
+        {}
+
+        const int beforeLast = (lastIndex - 1) & mask;
+        new (entries + lastIndex) Entry (entries [beforeLast]);
+        hashes [lastIndex] = hashes [beforeLast];
+
+        for (int i = beforeLast; i != index; i = (i - 1) & mask)
+        {
+            entries[i] = entries [(i - 1) & mask];
+            hashes[i] = hashes [(i - 1) & mask];
+        }
+
+        entries[index].key = newKey;
+        entries[index].value = newValue;
+        hashes[index] = hash;
+    }
+
+    void removeSlot (int index)
+    {
+        const int mask = numSlots - 1;
+
+        // shift the following items back until one is found that's already at home
+        for (;;)
+        {
+            const int next = (index + 1) & mask;
+            const uint32 h = hashes[next];
+
+            if (h == 0 || getProbeDistance (next, h) == 0)
+                break;
+
+            entries[index] = entries[next];
+            hashes[index] = h;
+            index = next;
+        }
+
+        entries[index].~Entry();
+        hashes[index] = 0;
+        --totalNumItems;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlatHashMap)
+};
+
+
+#endif   // __JUCE_FLATHASHMAP_JUCEHEADER__
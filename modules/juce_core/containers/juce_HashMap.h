@@ -48,6 +48,8 @@ public:
     static int generateHash (const String& key, const int upperLimit) noexcept    { return (int) (((uint32) key.hashCode()) % (uint32) upperLimit); }
     /** Generates a simple hash from a variant. */
     static int generateHash (const var& key, const int upperLimit) noexcept       { return generateHash (key.toString(), upperLimit); }
+    /** Generates a simple hash from an Identifier, using the hash code it already holds. */
+    static int generateHash (const Identifier& key, const int upperLimit) noexcept { return (int) (((uint32) key.getHashCode()) % (uint32) upperLimit); }
 };
 
 
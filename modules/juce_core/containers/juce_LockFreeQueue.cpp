@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#if JUCE_UNIT_TESTS
+
+class LockFreeQueueTests  : public UnitTest
+{
+public:
+    LockFreeQueueTests() : UnitTest ("Lock-free queues") {}
+
+    template <class QueueType>
+    class ProducerThread  : public Thread
+    {
+    public:
+        ProducerThread (QueueType& queue_, int producerIndex_, int numItems_)
+            : Thread ("queue producer"), queue (queue_), producerIndex (producerIndex_), numItems (numItems_)
+        {
+        }
+
+        void run()
+        {
+            for (int i = 0; i < numItems && ! threadShouldExit();)
+            {
+                if (queue.push ((producerIndex << 24) + i))
+                    ++i;
+                else
+                    Thread::yield();
+            }
+        }
+
+    private:
+        QueueType& queue;
+        const int producerIndex, numItems;
+    };
+
+    template <class QueueType>
+    class ConsumerThread  : public Thread
+    {
+    public:
+        ConsumerThread (QueueType& queue_, int numProducers_, int numItemsPerProducer_)
+            : Thread ("queue consumer"), queue (queue_),
+              numProducers (numProducers_), numItemsPerProducer (numItemsPerProducer_),
+              total (0), numReceived (0), itemsWereInOrder (true)
+        {
+        }
+
+        void run()
+        {
+            Array<int> lastFromEachProducer;
+            lastFromEachProducer.insertMultiple (0, -1, numProducers);
+
+            for (;;)
+            {
+                int item;
+
+                if (! queue.waitAndPop (item, 100))
+                {
+                    if (threadShouldExit())
+                        break;
+
+                    continue;
+                }
+
+                if (item < 0)
+                    break;
+
+                const int producer = item >> 24;
+                const int index = item & 0xffffff;
+
+                if (index <= lastFromEachProducer [producer])
+                    itemsWereInOrder = false;
+
+                lastFromEachProducer.set (producer, index);
+                total += index;
+                ++numReceived;
+            }
+        }
+
+        QueueType& queue;
+        const int numProducers, numItemsPerProducer;
+        int64 total;
+        int numReceived;
+        bool itemsWereInOrder;
+    };
+
+    template <class QueueType>
+    void testThreaded (int numProducers, int numConsumers)
+    {
+        const int numItemsPerProducer = 50000;
+        QueueType queue (64);
+
+        OwnedArray<ConsumerThread<QueueType> > consumers;
+        OwnedArray<ProducerThread<QueueType> > producers;
+
+        for (int i = 0; i < numConsumers; ++i)
+        {
+            consumers.add (new ConsumerThread<QueueType> (queue, numProducers, numItemsPerProducer));
+            consumers.getLast()->startThread();
+        }
+
+        for (int i = 0; i < numProducers; ++i)
+        {
+            producers.add (new ProducerThread<QueueType> (queue, i, numItemsPerProducer));
+            producers.getLast()->startThread();
+        }
+
+        for (int i = 0; i < numProducers; ++i)
+            expect (producers.getUnchecked(i)->waitForThreadToExit (30000));
+
+        for (int i = 0; i < numConsumers; ++i)
+            while (! queue.push (-1))
+                Thread::yield();
+
+        int64 total = 0;
+        int numReceived = 0;
+
+        for (int i = 0; i < numConsumers; ++i)
+        {
+            ConsumerThread<QueueType>& consumer = *consumers.getUnchecked(i);
+            expect (consumer.waitForThreadToExit (30000));
+            expect (consumer.itemsWereInOrder);
+
+            total += consumer.total;
+            numReceived += consumer.numReceived;
+        }
+
+        expectEquals (numReceived, numProducers * numItemsPerProducer);
+        expect (total == numProducers * (int64) numItemsPerProducer * (numItemsPerProducer - 1) / 2);
+        expect (queue.isEmpty());
+    }
+
+    template <class QueueType>
+    void testSingleThreaded()
+    {
+        QueueType queue (5);
+        expectEquals (queue.getCapacity(), 8);
+
+        String result;
+        expect (! queue.pop (result));
+        expect (! queue.waitAndPop (result, 10));
+
+        for (int i = 0; i < queue.getCapacity(); ++i)
+            expect (queue.push (String (i)));
+
+        expect (! queue.push ("overflow"));
+        expectEquals (queue.getNumReady(), queue.getCapacity());
+
+        for (int i = 0; i < queue.getCapacity(); ++i)
+        {
+            expect (queue.pop (result));
+            expectEquals (result, String (i));
+            expect (queue.push (String (i + 100)));
+        }
+
+        for (int i = 0; i < queue.getCapacity(); ++i)
+        {
+            expect (queue.waitAndPop (result, 0));
+            expectEquals (result, String (i + 100));
+        }
+
+        expect (queue.isEmpty());
+    }
+
+    void runTest()
+    {
+        beginTest ("Single producer, single consumer");
+        testSingleThreaded <SingleProducerSingleConsumerQueue<String> >();
+        testThreaded <SingleProducerSingleConsumerQueue<int> > (1, 1);
+
+        beginTest ("Multiple producers, single consumer");
+        testSingleThreaded <MultiProducerSingleConsumerQueue<String> >();
+        testThreaded <MultiProducerSingleConsumerQueue<int> > (3, 1);
+
+        beginTest ("Multiple producers, multiple consumers");
+        testSingleThreaded <MultiProducerMultiConsumerQueue<String> >();
+        testThreaded <MultiProducerMultiConsumerQueue<int> > (3, 3);
+    }
+};
+
+static LockFreeQueueTests lockFreeQueueUnitTests;
+
+#endif
@@ -0,0 +1,486 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_LOCKFREEQUEUE_JUCEHEADER__
+#define __JUCE_LOCKFREEQUEUE_JUCEHEADER__
+
+#include "../memory/juce_Atomic.h"
+#include "../memory/juce_HeapBlock.h"
+#include "../threads/juce_WaitableEvent.h"
+#include "../time/juce_Time.h"
+
+
+//==============================================================================
+namespace LockFreeQueueHelpers
+{
+    /** The granularity at which the queues keep their producer and consumer state apart.
+        This is the cache-line size on all the CPUs we support, so data that is written by
+        different threads doesn't end up fighting over the same line.
+    */
+    enum { cacheLineSize = 64 };
+
+    /** An atomic position that is written by one end of a queue, along with a private copy
+        of the other end's position, taking up a whole cache line between them.
+    */
+    struct QueueEnd
+    {
+        QueueEnd() noexcept : otherEndsPosition (0) {}
+
+        Atomic<uint32> position;
+        uint32 otherEndsPosition;
+        char padding [cacheLineSize - sizeof (Atomic<uint32>) - sizeof (uint32)];
+    };
+
+    /** Rounds a capacity up to a power of two, so that positions can be wrapped with a mask. */
+    inline uint32 getCapacityToUse (int requestedCapacity) noexcept
+    {
+        jassert (requestedCapacity > 0 && requestedCapacity <= 0x40000000);
+
+        uint32 capacity = 2;
+
+        while (capacity < (uint32) requestedCapacity)
+            capacity <<= 1;
+
+        return capacity;
+    }
+
+    /** Lets consumer threads that aren't time-critical block until an item arrives.
+
+        The producer only touches the WaitableEvent when a consumer is actually waiting,
+        so a queue that's only ever polled never makes a system call.
+    */
+    class ConsumerWaiter
+    {
+    public:
+        ConsumerWaiter() noexcept {}
+
+        /** Called by producers after publishing an item. The publishing operation must have
+            been a full memory barrier (all the queues use Atomic::set or compareAndSetBool).
+        */
+        void itemAdded() const noexcept
+        {
+            if (numWaiting.value > 0)
+                event.signal();
+        }
+
+        template <class QueueType, typename ElementType>
+        bool waitAndPop (QueueType& queue, ElementType& result, const int timeOutMilliseconds)
+        {
+            if (queue.pop (result))
+                return true;
+
+            const uint32 startTime = Time::getMillisecondCounter();
+
+            for (;;)
+            {
+                int timeLeft = -1;
+
+                if (timeOutMilliseconds >= 0)
+                {
+                    timeLeft = timeOutMilliseconds - (int) (Time::getMillisecondCounter() - startTime);
+
+                    if (timeLeft <= 0)
+                        return queue.pop (result);
+                }
+
+                ++numWaiting;
+
+                // must check again after registering, in case an item arrived
+                // before the producer could have seen us waiting..
+                const bool gotItem = queue.pop (result) || (event.wait (timeLeft) && queue.pop (result));
+
+                --numWaiting;
+
+                if (gotItem)
+                    return true;
+            }
+        }
+
+    private:
+        Atomic<int> numWaiting;
+        WaitableEvent event;
+
+        JUCE_DECLARE_NON_COPYABLE (ConsumerWaiter)
+    };
+
+    /** A bounded queue in which each slot carries a sequence number, so that several
+        producers (and optionally several consumers) can claim slots with a single
+        compare-and-swap, and then fill or empty them without blocking each other.
+    */
+    template <typename ElementType, bool allowMultipleConsumers>
+    class SequencedQueue
+    {
+    public:
+        SequencedQueue (int requestedCapacity)
+            : capacity (getCapacityToUse (requestedCapacity)),
+              mask (capacity - 1),
+              cells (capacity)
+        {
+            for (uint32 i = 0; i < capacity; ++i)
+                new (cells + i) Cell (i);
+        }
+
+        ~SequencedQueue()
+        {
+            for (uint32 i = 0; i < capacity; ++i)
+                cells[i].~Cell();
+        }
+
+        int getCapacity() const noexcept        { return (int) capacity; }
+
+        int getNumReady() const noexcept
+        {
+            const int num = (int) (writer.position.get() - reader.position.get());
+            return jlimit (0, (int) capacity, num);
+        }
+
+        bool push (const ElementType& newItem)
+        {
+            uint32 pos = writer.position.get();
+
+            for (;;)
+            {
+                Cell& cell = cells [pos & mask];
+                const int diff = (int) (cell.sequence.get() - pos);
+
+                if (diff == 0)
+                {
+                    if (writer.position.compareAndSetBool (pos + 1, pos))
+                    {
+                        cell.value = newItem;
+                        cell.sequence = pos + 1;
+                        waiter.itemAdded();
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false; // full
+                }
+
+                pos = writer.position.get();
+            }
+        }
+
+        bool pop (ElementType& result)
+        {
+            uint32 pos = reader.position.get();
+
+            for (;;)
+            {
+                Cell& cell = cells [pos & mask];
+                const int diff = (int) (cell.sequence.get() - (pos + 1));
+
+                if (diff == 0)
+                {
+                    if (! allowMultipleConsumers)
+                        reader.position = pos + 1;
+                    else if (! reader.position.compareAndSetBool (pos + 1, pos))
+                    {
+                        pos = reader.position.get();
+                        continue;
+                    }
+
+                    result = cell.value;
+                    cell.value = ElementType(); // don't keep a stale copy of objects that hold resources
+                    cell.sequence = pos + capacity;
+                    return true;
+                }
+
+                if (diff < 0 || ! allowMultipleConsumers)
+                    return false; // empty
+
+                pos = reader.position.get();
+            }
+        }
+
+        bool waitAndPop (ElementType& result, int timeOutMilliseconds)
+        {
+            return waiter.waitAndPop (*this, result, timeOutMilliseconds);
+        }
+
+    private:
+        struct Cell
+        {
+            Cell (uint32 initialSequence) : value() { sequence = initialSequence; }
+
+            Atomic<uint32> sequence;
+            ElementType value;
+        };
+
+        const uint32 capacity, mask;
+        HeapBlock<Cell> cells;
+        char separator [cacheLineSize];
+        QueueEnd writer, reader;
+        ConsumerWaiter waiter;
+
+        JUCE_DECLARE_NON_COPYABLE (SequencedQueue)
+    };
+}
+
+//==============================================================================
+/**
+    A bounded, lock-free queue for passing objects from one thread to another.
+
+    Exactly one thread may call push() and exactly one (other) thread may call pop().
+    Both push() and pop() are wait-free and never allocate, so either end can safely
+    be used on an audio thread.
+
+    Unlike AbstractFifo, this holds the items itself. Each end keeps its position and
+    its cached copy of the other end's position on a separate cache line, so the
+    two threads only share memory when one of them actually needs to see the other's
+    progress.
+
+    The element type must be default-constructible and copyable. When an item is popped,
+    its slot is reset to a default-constructed object, so the queue never keeps objects
+    alive once they've been read.
+
+    A consumer that isn't time-critical may call waitAndPop() to block until an item
+    arrives. When a consumer is blocked, push() will signal a WaitableEvent to wake it,
+    so only use waitAndPop() if the producer can tolerate that system call.
+
+    @see MultiProducerSingleConsumerQueue, MultiProducerMultiConsumerQueue, AbstractFifo
+*/
+template <typename ElementType>
+class SingleProducerSingleConsumerQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue that can hold at least the given number of items.
+        The capacity is rounded up to a power of two.
+    */
+    SingleProducerSingleConsumerQueue (int minimumCapacity)
+        : capacity (LockFreeQueueHelpers::getCapacityToUse (minimumCapacity)),
+          mask (capacity - 1),
+          items (capacity)
+    {
+        for (uint32 i = 0; i < capacity; ++i)
+            new (items + i) ElementType();
+    }
+
+    /** Destructor. */
+    ~SingleProducerSingleConsumerQueue()
+    {
+        for (uint32 i = 0; i < capacity; ++i)
+            items[i].~ElementType();
+    }
+
+    //==============================================================================
+    /** Returns the maximum number of items that the queue can hold. */
+    int getCapacity() const noexcept            { return (int) capacity; }
+
+    /** Returns the number of items waiting to be read.
+        Other threads may change this at any moment, so treat it only as a hint.
+    */
+    int getNumReady() const noexcept            { return (int) (writer.position.get() - reader.position.get()); }
+
+    /** Returns true if there's nothing waiting to be read. Like getNumReady(), this is only a hint. */
+    bool isEmpty() const noexcept               { return getNumReady() == 0; }
+
+    //==============================================================================
+    /** Adds an item to the back of the queue.
+        This may only be called by the producer thread.
+        @returns false if the queue was full, in which case nothing was added
+    */
+    bool push (const ElementType& newItem)
+    {
+        const uint32 pos = writer.position.value;
+
+        if (pos - writer.otherEndsPosition >= capacity)
+        {
+            writer.otherEndsPosition = reader.position.get();
+
+            if (pos - writer.otherEndsPosition >= capacity)
+                return false;
+        }
+
+        items [pos & mask] = newItem;
+        writer.position = pos + 1;
+        waiter.itemAdded();
+        return true;
+    }
+
+    /** Removes the item at the front of the queue.
+        This may only be called by the consumer thread.
+        @returns false if the queue was empty, in which case result is left unchanged
+    */
+    bool pop (ElementType& result)
+    {
+        const uint32 pos = reader.position.value;
+
+        if (pos == reader.otherEndsPosition)
+        {
+            reader.otherEndsPosition = writer.position.get();
+
+            if (pos == reader.otherEndsPosition)
+                return false;
+        }
+
+        ElementType& item = items [pos & mask];
+        result = item;
+        item = ElementType();
+        reader.position = pos + 1;
+        return true;
+    }
+
+    /** Removes the item at the front of the queue, blocking if the queue is empty.
+        This may only be called by the consumer thread, and shouldn't be used on a
+        real-time thread.
+        @param result               on success, receives the item
+        @param timeOutMilliseconds  the longest to wait, or -1 to wait for ever
+        @returns false if no item arrived before the time-out
+    */
+    bool waitAndPop (ElementType& result, int timeOutMilliseconds = -1)
+    {
+        return waiter.waitAndPop (*this, result, timeOutMilliseconds);
+    }
+
+private:
+    //==============================================================================
+    const uint32 capacity, mask;
+    HeapBlock<ElementType> items;
+    char separator [LockFreeQueueHelpers::cacheLineSize];
+    LockFreeQueueHelpers::QueueEnd writer, reader;
+    LockFreeQueueHelpers::ConsumerWaiter waiter;
+
+    JUCE_DECLARE_NON_COPYABLE (SingleProducerSingleConsumerQueue)
+};
+
+//==============================================================================
+/**
+    A bounded, lock-free queue that any number of threads may push to, and one thread pops from.
+
+    This is the usual shape for sending messages to a single audio, disk or UI thread
+    from several others. push() claims a slot with a compare-and-swap, and pop() is
+    wait-free. Neither ever allocates or spins waiting for another thread.
+
+    If a producer is suspended after claiming a slot but before it has filled it, pop()
+    will report the queue as empty until that producer resumes, even if other producers
+    have pushed items after it.
+
+    The element type must be default-constructible and copyable, and waitAndPop() works
+    in the same way as it does in SingleProducerSingleConsumerQueue.
+
+    @see SingleProducerSingleConsumerQueue, MultiProducerMultiConsumerQueue
+*/
+template <typename ElementType>
+class MultiProducerSingleConsumerQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue that can hold at least the given number of items.
+        The capacity is rounded up to a power of two.
+    */
+    MultiProducerSingleConsumerQueue (int minimumCapacity)  : queue (minimumCapacity) {}
+
+    /** Returns the maximum number of items that the queue can hold. */
+    int getCapacity() const noexcept                                    { return queue.getCapacity(); }
+
+    /** Returns the number of items waiting to be read. This is only a hint. */
+    int getNumReady() const noexcept                                    { return queue.getNumReady(); }
+
+    /** Returns true if there's nothing waiting to be read. This is only a hint. */
+    bool isEmpty() const noexcept                                       { return getNumReady() == 0; }
+
+    /** Adds an item to the back of the queue. This may be called from any thread.
+        @returns false if the queue was full, in which case nothing was added
+    */
+    bool push (const ElementType& newItem)                              { return queue.push (newItem); }
+
+    /** Removes the item at the front of the queue. This may only be called by the consumer thread.
+        @returns false if the queue was empty, in which case result is left unchanged
+    */
+    bool pop (ElementType& result)                                      { return queue.pop (result); }
+
+    /** Removes the item at the front of the queue, blocking if the queue is empty.
+        This may only be called by the consumer thread, and shouldn't be used on a real-time thread.
+        @returns false if no item arrived before the time-out
+    */
+    bool waitAndPop (ElementType& result, int timeOutMilliseconds = -1) { return queue.waitAndPop (result, timeOutMilliseconds); }
+
+private:
+    LockFreeQueueHelpers::SequencedQueue<ElementType, false> queue;
+
+    JUCE_DECLARE_NON_COPYABLE (MultiProducerSingleConsumerQueue)
+};
+
+//==============================================================================
+/**
+    A bounded, lock-free queue that any number of threads may push to and pop from.
+
+    Both push() and pop() claim their slot with a compare-and-swap, so a thread may have
+    to retry if another one claims the same slot first. Neither of them ever blocks, but
+    a thread that gets suspended after claiming a slot and before it has finished with it
+    does hold the others up: until it resumes, pop() will report the queue as empty once
+    it reaches that slot, and push() will report it as full once it has wrapped round to it.
+
+    The element type must be default-constructible and copyable. Any number of consumers
+    may use waitAndPop().
+
+    @see SingleProducerSingleConsumerQueue, MultiProducerSingleConsumerQueue
+*/
+template <typename ElementType>
+class MultiProducerMultiConsumerQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue that can hold at least the given number of items.
+        The capacity is rounded up to a power of two.
+    */
+    MultiProducerMultiConsumerQueue (int minimumCapacity)  : queue (minimumCapacity) {}
+
+    /** Returns the maximum number of items that the queue can hold. */
+    int getCapacity() const noexcept                                    { return queue.getCapacity(); }
+
+    /** Returns the number of items waiting to be read. This is only a hint. */
+    int getNumReady() const noexcept                                    { return queue.getNumReady(); }
+
+    /** Returns true if there's nothing waiting to be read. This is only a hint. */
+    bool isEmpty() const noexcept                                       { return getNumReady() == 0; }
+
+    /** Adds an item to the back of the queue. This may be called from any thread.
+        @returns false if the queue was full, in which case nothing was added
+    */
+    bool push (const ElementType& newItem)                              { return queue.push (newItem); }
+
+    /** Removes the item at the front of the queue. This may be called from any thread.
+        @returns false if the queue was empty, in which case result is left unchanged
+    */
+    bool pop (ElementType& result)                                      { return queue.pop (result); }
+
+    /** Removes the item at the front of the queue, blocking if the queue is empty.
+        This shouldn't be used on a real-time thread.
+        @returns false if no item arrived before the time-out
+    */
+    bool waitAndPop (ElementType& result, int timeOutMilliseconds = -1) { return queue.waitAndPop (result, timeOutMilliseconds); }
+
+private:
+    LockFreeQueueHelpers::SequencedQueue<ElementType, true> queue;
+
+    JUCE_DECLARE_NON_COPYABLE (MultiProducerMultiConsumerQueue)
+};
+
+
+#endif   // __JUCE_LOCKFREEQUEUE_JUCEHEADER__
@@ -46,8 +46,7 @@ NamedValueSet::NamedValue& NamedValueSet::NamedValue::operator= (const NamedValu
 
 #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
 NamedValueSet::NamedValue::NamedValue (NamedValue&& other) noexcept
-    : nextListItem (static_cast <LinkedListPointer<NamedValue>&&> (other.nextListItem)),
-      name (static_cast <Identifier&&> (other.name)),
+    : name (static_cast <Identifier&&> (other.name)),
       value (static_cast <var&&> (other.value))
 {
 }
@@ -59,7 +58,6 @@ inline NamedValueSet::NamedValue::NamedValue (const Identifier n, var&& v)
 
 NamedValueSet::NamedValue& NamedValueSet::NamedValue::operator= (NamedValue&& other) noexcept
 {
-    nextListItem = static_cast <LinkedListPointer<NamedValue>&&> (other.nextListItem);
     name = static_cast <Identifier&&> (other.name);
     value = static_cast <var&&> (other.value);
     return *this;
@@ -71,61 +69,65 @@ bool NamedValueSet::NamedValue::operator== (const NamedValueSet::NamedValue& oth
     return name == other.name && value == other.value;
 }
 
+//==============================================================================
+// Maps each name to its index + 1 in the values array (so that 0 means "not found")
+class NamedValueSet::HashIndex
+{
+public:
+    HashIndex() {}
+
+    FlatHashMap<Identifier, int> positions;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (HashIndex)
+};
+
 //==============================================================================
 NamedValueSet::NamedValueSet() noexcept
 {
 }
 
 NamedValueSet::NamedValueSet (const NamedValueSet& other)
+    : values (other.values)
 {
-    values.addCopyOfList (other.values);
+    rebuildHashIndex();
 }
 
 NamedValueSet& NamedValueSet::operator= (const NamedValueSet& other)
 {
-    clear();
-    values.addCopyOfList (other.values);
+    values = other.values;
+    rebuildHashIndex();
     return *this;
 }
 
 #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
 NamedValueSet::NamedValueSet (NamedValueSet&& other) noexcept
-    : values (static_cast <LinkedListPointer<NamedValue>&&> (other.values))
+    : values (static_cast <Array<NamedValue>&&> (other.values)),
+      hashIndex (static_cast <ScopedPointer<HashIndex>&&> (other.hashIndex))
 {
 }
 
 NamedValueSet& NamedValueSet::operator= (NamedValueSet&& other) noexcept
 {
-    other.values.swapWith (values);
+    other.values.swapWithArray (values);
+    other.hashIndex.swapWith (hashIndex);
     return *this;
 }
 #endif
 
 NamedValueSet::~NamedValueSet()
 {
-    clear();
 }
 
 void NamedValueSet::clear()
 {
-    values.deleteAll();
+    hashIndex = nullptr;
+    values.clear();
 }
 
 bool NamedValueSet::operator== (const NamedValueSet& other) const
 {
-    const NamedValue* i1 = values;
-    const NamedValue* i2 = other.values;
-
-    while (i1 != nullptr && i2 != nullptr)
-    {
-        if (! (*i1 == *i2))
-            return false;
-
-        i1 = i1->nextListItem;
-        i2 = i2->nextListItem;
-    }
-
-    return true;
+    return values == other.values;
 }
 
 bool NamedValueSet::operator!= (const NamedValueSet& other) const
@@ -138,13 +140,54 @@ int NamedValueSet::size() const noexcept
     return values.size();
 }
 
-const var& NamedValueSet::operator[] (const Identifier name) const
+//==============================================================================
+int NamedValueSet::indexOf (const Identifier name) const noexcept
+{
+    if (hashIndex != nullptr)
+        return hashIndex->positions [name] - 1;
+
+    for (int i = 0; i < values.size(); ++i)
+        if (values.getReference(i).name == name)
+            return i;
+
+    return -1;
+}
+
+void NamedValueSet::valueAdded()
+{
+    if (hashIndex != nullptr)
+        updateHashIndex (values.size() - 1);
+    else if (values.size() >= minimumSizeToHash)
+        rebuildHashIndex();
+}
+
+void NamedValueSet::rebuildHashIndex()
+{
+    if (values.size() >= minimumSizeToHash)
+    {
+        hashIndex = new HashIndex();
+        hashIndex->positions.remapTable (values.size() * 2);
+        updateHashIndex (0);
+    }
+    else
+    {
+        hashIndex = nullptr;
+    }
+}
+
+void NamedValueSet::updateHashIndex (const int firstIndexToUpdate)
 {
-    for (NamedValue* i = values; i != nullptr; i = i->nextListItem)
-        if (i->name == name)
-            return i->value;
+    jassert (hashIndex != nullptr);
 
-    return var::null;
+    for (int i = firstIndexToUpdate; i < values.size(); ++i)
+        hashIndex->positions.set (values.getReference(i).name, i + 1);
+}
+
+//==============================================================================
+const var& NamedValueSet::operator[] (const Identifier name) const
+{
+    const int index = indexOf (name);
+    return index >= 0 ? values.getReference (index).value : var::null;
 }
 
 var NamedValueSet::getWithDefault (const Identifier name, const var& defaultReturnValue) const
@@ -157,111 +200,94 @@ var NamedValueSet::getWithDefault (const Identifier name, const var& defaultRetu
 
 var* NamedValueSet::getVarPointer (const Identifier name) const noexcept
 {
-    for (NamedValue* i = values; i != nullptr; i = i->nextListItem)
-        if (i->name == name)
-            return &(i->value);
-
-    return nullptr;
+    const int index = indexOf (name);
+    return index >= 0 ? &(values.getReference (index).value) : nullptr;
 }
 
 #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
 bool NamedValueSet::set (const Identifier name, var&& newValue)
 {
-    LinkedListPointer<NamedValue>* i = &values;
-
-    while (i->get() != nullptr)
+    if (var* const v = getVarPointer (name))
     {
-        NamedValue* const v = i->get();
-
-        if (v->name == name)
-        {
-            if (v->value.equalsWithSameType (newValue))
-                return false;
-
-            v->value = static_cast <var&&> (newValue);
-            return true;
-        }
+        if (v->equalsWithSameType (newValue))
+            return false;
 
-        i = &(v->nextListItem);
+        *v = static_cast <var&&> (newValue);
+        return true;
     }
 
-    i->insertNext (new NamedValue (name, static_cast <var&&> (newValue)));
+    values.add (NamedValue (name, static_cast <var&&> (newValue)));
+    valueAdded();
     return true;
 }
 #endif
 
 bool NamedValueSet::set (const Identifier name, const var& newValue)
 {
-    LinkedListPointer<NamedValue>* i = &values;
-
-    while (i->get() != nullptr)
+    if (var* const v = getVarPointer (name))
     {
-        NamedValue* const v = i->get();
-
-        if (v->name == name)
-        {
-            if (v->value.equalsWithSameType (newValue))
-                return false;
-
-            v->value = newValue;
-            return true;
-        }
+        if (v->equalsWithSameType (newValue))
+            return false;
 
-        i = &(v->nextListItem);
+        *v = newValue;
+        return true;
     }
 
-    i->insertNext (new NamedValue (name, newValue));
+    values.add (NamedValue (name, newValue));
+    valueAdded();
     return true;
 }
 
 bool NamedValueSet::contains (const Identifier name) const
 {
-    return getVarPointer (name) != nullptr;
+    return indexOf (name) >= 0;
 }
 
 bool NamedValueSet::remove (const Identifier name)
 {
-    LinkedListPointer<NamedValue>* i = &values;
+    const int index = indexOf (name);
 
-    for (;;)
-    {
-        NamedValue* const v = i->get();
+    if (index < 0)
+        return false;
 
-        if (v == nullptr)
-            break;
+    values.remove (index);
 
-        if (v->name == name)
+    if (hashIndex != nullptr)
+    {
+        // (keep the index until the set has shrunk well below the threshold, so that
+        // adding and removing an item at the threshold doesn't keep rebuilding it)
+        if (values.size() < minimumSizeToHash / 2)
         {
-            delete i->removeNext();
-            return true;
+            hashIndex = nullptr;
+        }
+        else
+        {
+            hashIndex->positions.remove (name);
+            updateHashIndex (index);
         }
-
-        i = &(v->nextListItem);
     }
 
-    return false;
+    return true;
 }
 
 const Identifier NamedValueSet::getName (const int index) const
 {
-    const NamedValue* const v = values[index];
-    jassert (v != nullptr);
-    return v->name;
+    jassert (isPositiveAndBelow (index, values.size()));
+    return values [index].name;
 }
 
 const var& NamedValueSet::getValueAt (const int index) const
 {
-    const NamedValue* const v = values[index];
-    jassert (v != nullptr);
-    return v->value;
+    jassert (isPositiveAndBelow (index, values.size()));
+    return values.getReference (index).value;
 }
 
 void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 {
     clear();
-    LinkedListPointer<NamedValue>::Appender appender (values);
 
     const int numAtts = xml.getNumAttributes(); // xxx inefficient - should write an att iterator..
+    values.ensureStorageAllocated (numAtts);
 
     for (int i = 0; i < numAtts; ++i)
     {
@@ -274,33 +300,115 @@ void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 
             if (mb.fromBase64Encoding (value))
             {
-                appender.append (new NamedValue (name.substring (7), var (mb)));
+                values.add (NamedValue (name.substring (7), var (mb)));
                 continue;
             }
         }
 
-        appender.append (new NamedValue (name, var (value)));
+        values.add (NamedValue (name, var (value)));
     }
+
+    rebuildHashIndex();
 }
 
 void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
 {
-    for (NamedValue* i = values; i != nullptr; i = i->nextListItem)
+    for (int j = 0; j < values.size(); ++j)
     {
-        if (const MemoryBlock* mb = i->value.getBinaryData())
+        const NamedValue& i = values.getReference (j);
+
+        if (const MemoryBlock* mb = i.value.getBinaryData())
         {
-            xml.setAttribute ("base64:" + i->name.toString(),
+            xml.setAttribute ("base64:" + i.name.toString(),
                               mb->toBase64Encoding());
         }
         else
         {
             // These types can't be stored as XML!
-            jassert (! i->value.isObject());
-            jassert (! i->value.isMethod());
-            jassert (! i->value.isArray());
+            jassert (! i.value.isObject());
+            jassert (! i.value.isMethod());
+            jassert (! i.value.isArray());
 
-            xml.setAttribute (i->name.toString(),
-                              i->value.toString());
+            xml.setAttribute (i.name.toString(),
+                              i.value.toString());
         }
     }
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class NamedValueSetTests  : public UnitTest
+{
+public:
+    NamedValueSetTests() : UnitTest ("NamedValueSet") {}
+
+    static Identifier getName (int i)    { return Identifier ("item" + String (i)); }
+
+    void expectContents (const NamedValueSet& set, const Array<int>& expectedItems)
+    {
+        expectEquals (set.size(), expectedItems.size());
+
+        for (int i = 0; i < expectedItems.size(); ++i)
+        {
+            const int item = expectedItems.getUnchecked (i);
+            expect (set.getName (i) == getName (item));
+            expect (set [getName (item)] == var (item));
+        }
+    }
+
+    void runTest()
+    {
+        beginTest ("Adding and removing");
+
+        NamedValueSet set;
+        Array<int> items;
+        Random r (0x4321);
+
+        for (int i = 0; i < 300; ++i)
+        {
+            expect (set.set (getName (i), i));
+            items.add (i);
+        }
+
+        expect (! set.set (getName (10), 10));
+        expect (! set.contains ("missing"));
+        expect (set ["missing"].isVoid());
+        expectContents (set, items);
+
+        while (items.size() > 5)
+        {
+            const int index = r.nextInt (items.size());
+            expect (set.remove (getName (items [index])));
+            expect (! set.contains (getName (items [index])));
+            items.remove (index);
+        }
+
+        expectContents (set, items);
+
+        for (int i = 300; i < 400; ++i)
+        {
+            set.set (getName (i), i);
+            items.add (i);
+        }
+
+        expectContents (set, items);
+
+        beginTest ("Copying");
+
+        NamedValueSet copy (set);
+        expect (copy == set);
+        expectContents (copy, items);
+
+        copy.set (getName (0), "changed");
+        expect (copy != set);
+
+        set.clear();
+        expectEquals (set.size(), 0);
+        expect (! set.contains (getName (300)));
+    }
+};
+
+static NamedValueSetTests namedValueSetUnitTests;
+
+#endif
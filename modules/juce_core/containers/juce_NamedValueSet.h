@@ -27,11 +27,9 @@
 #define __JUCE_NAMEDVALUESET_JUCEHEADER__
 
 #include "juce_Variant.h"
-#include "../containers/juce_LinkedListPointer.h"
+#include "juce_Array.h"
+#include "../memory/juce_ScopedPointer.h"
 class XmlElement;
-#ifndef DOXYGEN
- class JSONFormatter;
-#endif
 
 
 //==============================================================================
@@ -39,6 +37,11 @@ class XmlElement;
 
     This can be used as a basic structure to hold a set of var object, which can
     be retrieved by using their identifier.
+
+    The values are kept in the order in which they were added, so accessing them by
+    index is quick. Small sets are searched linearly, but once a set grows beyond a
+    few dozen items, it also keeps a hash table of its names, so that looking up a
+    name doesn't get slower as the set gets bigger.
 */
 class JUCE_API  NamedValueSet
 {
@@ -120,6 +123,7 @@ public:
 
         Do not use this method unless you really need access to the internal var object
         for some reason - for normal reading and writing always prefer operator[]() and set().
+        The pointer will become invalid as soon as any value is added to or removed from the set.
     */
     var* getVarPointer (const Identifier name) const noexcept;
 
@@ -148,18 +152,21 @@ private:
        #endif
         bool operator== (const NamedValue& other) const noexcept;
 
-        LinkedListPointer<NamedValue> nextListItem;
         Identifier name;
         var value;
-
-    private:
-        JUCE_LEAK_DETECTOR (NamedValue)
     };
 
-    friend class LinkedListPointer<NamedValue>;
-    LinkedListPointer<NamedValue> values;
+    class HashIndex;
+
+    Array<NamedValue> values;
+    ScopedPointer<HashIndex> hashIndex; // only used once the set reaches minimumSizeToHash
+
+    enum { minimumSizeToHash = 32 };
 
-    friend class JSONFormatter;
+    int indexOf (const Identifier name) const noexcept;
+    void valueAdded();
+    void rebuildHashIndex();
+    void updateHashIndex (int firstIndexToUpdate);
 };
 
 
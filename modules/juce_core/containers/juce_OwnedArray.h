@@ -27,6 +27,7 @@
 #define __JUCE_OWNEDARRAY_JUCEHEADER__
 
 #include "juce_ArrayAllocationBase.h"
+#include "../memory/juce_ContainerDeletePolicy.h"
 #include "juce_ElementComparator.h"
 #include "../threads/juce_CriticalSection.h"
 
@@ -390,9 +391,7 @@ public:
                 }
             }
 
-            delete toDelete; // don't want to use a ScopedPointer here because if the
-                             // object has a private destructor, both OwnedArray and
-                             // ScopedPointer would need to be friend classes..
+            ContainerDeletePolicy<ObjectClass>::destroy (toDelete);
         }
         else
         {
@@ -570,9 +569,7 @@ public:
             }
         }
 
-        delete toDelete; // don't want to use a ScopedPointer here because if the
-                         // object has a private destructor, both OwnedArray and
-                         // ScopedPointer would need to be friend classes..
+        ContainerDeletePolicy<ObjectClass>::destroy (toDelete);
 
         if ((numUsed << 1) < data.numAllocated)
             minimiseStorageOverheads();
@@ -661,7 +658,7 @@ public:
             {
                 for (int i = startIndex; i < endIndex; ++i)
                 {
-                    delete data.elements [i];
+                    ContainerDeletePolicy<ObjectClass>::destroy (data.elements [i]);
                     data.elements [i] = nullptr; // (in case one of the destructors accesses this array and hits a dangling pointer)
                 }
             }
@@ -857,7 +854,7 @@ private:
     void deleteAllObjects()
     {
         while (numUsed > 0)
-            delete data.elements [--numUsed];
+            ContainerDeletePolicy<ObjectClass>::destroy (data.elements [--numUsed]);
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OwnedArray)
@@ -108,6 +108,26 @@ public:
         return *this;
     }
 
+   #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+    /** Takes over the objects from another array, without changing their reference counts. */
+    ReferenceCountedArray (ReferenceCountedArray&& other) noexcept
+        : data (static_cast <ArrayAllocationBase <ObjectClass*, TypeOfCriticalSectionToUse>&&> (other.data)),
+          numUsed (other.numUsed)
+    {
+        other.numUsed = 0;
+    }
+
+    /** Takes over the objects from another array, without changing their reference counts.
+        Any existing objects in this array will first be released.
+    */
+    ReferenceCountedArray& operator= (ReferenceCountedArray&& other) noexcept
+    {
+        ReferenceCountedArray otherCopy (static_cast <ReferenceCountedArray&&> (other));
+        swapWithArray (otherCopy);
+        return *this;
+    }
+   #endif
+
     /** Destructor.
         Any objects in the array will be released, and may be deleted if not referenced from elsewhere.
     */
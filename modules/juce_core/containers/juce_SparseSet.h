@@ -113,11 +113,7 @@ public:
     /** Checks whether a particular value is in the set. */
     bool contains (const Type valueToLookFor) const
     {
-        for (int i = 0; i < values.size(); ++i)
-            if (valueToLookFor < values.getUnchecked(i))
-                return (i & 1) != 0;
-
-        return false;
+        return (getNumBoundariesUpTo (valueToLookFor) & 1) != 0;
     }
 
     //==============================================================================
@@ -165,14 +161,17 @@ public:
     void addRange (const Range<Type> range)
     {
         jassert (range.getLength() >= 0);
+
         if (range.getLength() > 0)
         {
-            removeRange (range);
-
-            values.addUsingDefaultSort (range.getStart());
-            values.addUsingDefaultSort (range.getEnd());
-
-            simplify();
+            const int first = getNumBoundariesBelow (range.getStart());
+            const int last  = getNumBoundariesUpTo (range.getEnd());
+
+            // any boundaries inside the range go, and its ends become boundaries
+            // unless they fall inside (or touch) ranges that are already there
+            replaceBoundaries (first, last,
+                               (first & 1) == 0, range.getStart(),
+                               (last & 1) == 0,  range.getEnd());
         }
     }
 
@@ -183,51 +182,29 @@ public:
     {
         jassert (rangeToRemove.getLength() >= 0);
 
-        if (rangeToRemove.getLength() > 0
-             && values.size() > 0
-             && rangeToRemove.getStart() < values.getUnchecked (values.size() - 1)
-             && values.getUnchecked(0) < rangeToRemove.getEnd())
+        if (rangeToRemove.getLength() > 0)
         {
-            const bool onAtStart = contains (rangeToRemove.getStart() - 1);
-            const Type lastValue (jmin (rangeToRemove.getEnd(), values.getLast()));
-            const bool onAtEnd = contains (lastValue);
-
-            for (int i = values.size(); --i >= 0;)
-            {
-                if (values.getUnchecked(i) <= lastValue)
-                {
-                    while (values.getUnchecked(i) >= rangeToRemove.getStart())
-                    {
-                        values.remove (i);
-
-                        if (--i < 0)
-                            break;
-                    }
-
-                    break;
-                }
-            }
-
-            if (onAtStart)   values.addUsingDefaultSort (rangeToRemove.getStart());
-            if (onAtEnd)     values.addUsingDefaultSort (lastValue);
-
-            simplify();
+            const int first = getNumBoundariesBelow (rangeToRemove.getStart());
+            const int last  = getNumBoundariesUpTo (rangeToRemove.getEnd());
+
+            // the ends of the range only become boundaries if they cut through an existing range
+            replaceBoundaries (first, last,
+                               (first & 1) != 0, rangeToRemove.getStart(),
+                               (last & 1) != 0,  rangeToRemove.getEnd());
         }
     }
 
     /** Does an XOR of the values in a given range. */
     void invertRange (const Range<Type> range)
     {
-        SparseSet newItems;
-        newItems.addRange (range);
-
-        for (int i = getNumRanges(); --i >= 0;)
-            newItems.removeRange (getRange (i));
-
-        removeRange (range);
+        jassert (range.getLength() >= 0);
 
-        for (int i = newItems.getNumRanges(); --i >= 0;)
-            addRange (newItems.getRange(i));
+        if (range.getLength() > 0)
+        {
+            // inverting a range just toggles whether each of its ends is a boundary
+            toggleBoundary (range.getStart());
+            toggleBoundary (range.getEnd());
+        }
     }
 
     /** Checks whether any part of a given range overlaps any part of this set. */
@@ -235,14 +212,10 @@ public:
     {
         if (range.getLength() > 0)
         {
-            for (int i = getNumRanges(); --i >= 0;)
-            {
-                if (values.getUnchecked ((i << 1) + 1) <= range.getStart())
-                    return false;
-
-                if (values.getUnchecked (i << 1) < range.getEnd())
-                    return true;
-            }
+            const int i = getNumBoundariesUpTo (range.getStart());
+
+            return (i & 1) != 0
+                    || (i < values.size() && values.getUnchecked (i) < range.getEnd());
         }
 
         return false;
@@ -253,15 +226,10 @@ public:
     {
         if (range.getLength() > 0)
         {
-            for (int i = getNumRanges(); --i >= 0;)
-            {
-                if (values.getUnchecked ((i << 1) + 1) <= range.getStart())
-                    return false;
-
-                if (values.getUnchecked (i << 1) <= range.getStart()
-                     && range.getEnd() <= values.getUnchecked ((i << 1) + 1))
-                    return true;
-            }
+            const int i = getNumBoundariesUpTo (range.getStart());
+
+            return (i & 1) != 0
+                    && range.getEnd() <= values.getUnchecked (i);
         }
 
         return false;
@@ -280,16 +248,66 @@ public:
 
 private:
     //==============================================================================
-    // alternating start/end values of ranges of values that are present.
+    // alternating start/end values of ranges of values that are present, kept in ascending
+    // order with no empty or touching ranges, so that they can be binary-searched.
     Array<Type, DummyCriticalSection> values;
 
-    void simplify()
+    // Returns the index of the first boundary that's >= value
+    int getNumBoundariesBelow (const Type value) const noexcept
     {
+        int start = 0, end = values.size();
+
+        while (start < end)
+        {
+            const int mid = (start + end) >> 1;
+
+            if (values.getUnchecked (mid) < value)
+                start = mid + 1;
+            else
+                end = mid;
+        }
+
+        return start;
+    }
+
+    // Returns the index of the first boundary that's > value
+    int getNumBoundariesUpTo (const Type value) const noexcept
+    {
+        int start = 0, end = values.size();
+
+        while (start < end)
+        {
+            const int mid = (start + end) >> 1;
+
+            if (value < values.getUnchecked (mid))
+                end = mid;
+            else
+                start = mid + 1;
+        }
+
+        return start;
+    }
+
+    void replaceBoundaries (const int first, const int last,
+                            const bool addStart, const Type start,
+                            const bool addEnd, const Type end)
+    {
+        values.removeRange (first, last - first);
+
+        if (addEnd)    values.insert (first, end);
+        if (addStart)  values.insert (first, start);
+
         jassert ((values.size() & 1) == 0);
+    }
+
+    void toggleBoundary (const Type value)
+    {
+        const int i = getNumBoundariesBelow (value);
 
-        for (int i = values.size(); --i > 0;)
-            if (values.getUnchecked(i) == values.getUnchecked (i - 1))
-                values.removeRange (--i, 2);
+        if (i < values.size() && values.getUnchecked (i) == value)
+            values.remove (i);
+        else
+            values.insert (i, value);
     }
 };
 
@@ -32,7 +32,10 @@ enum VariantStreamMarkers
     varMarker_String    = 5,
     varMarker_Int64     = 6,
     varMarker_Array     = 7,
-    varMarker_Binary    = 8
+    varMarker_Binary    = 8,
+    varMarker_IntArray    = 9,
+    varMarker_FloatArray  = 10,
+    varMarker_DoubleArray = 11
 };
 
 //==============================================================================
@@ -50,6 +53,9 @@ public:
     virtual ReferenceCountedObject* toObject (const ValueUnion&) const noexcept { return nullptr; }
     virtual Array<var>* toArray (const ValueUnion&) const noexcept              { return nullptr; }
     virtual MemoryBlock* toBinary (const ValueUnion&) const noexcept            { return nullptr; }
+    virtual Array<int>* toIntArray (const ValueUnion&) const noexcept           { return nullptr; }
+    virtual Array<float>* toFloatArray (const ValueUnion&) const noexcept       { return nullptr; }
+    virtual Array<double>* toDoubleArray (const ValueUnion&) const noexcept     { return nullptr; }
 
     virtual bool isVoid() const noexcept      { return false; }
     virtual bool isInt() const noexcept       { return false; }
@@ -61,6 +67,11 @@ public:
     virtual bool isArray() const noexcept     { return false; }
     virtual bool isBinary() const noexcept    { return false; }
     virtual bool isMethod() const noexcept    { return false; }
+    virtual bool isNumericArray() const noexcept  { return false; }
+
+    virtual int getNumElements (const ValueUnion&) const noexcept               { return 0; }
+    virtual var getElement (const ValueUnion&, int) const                       { return var::null; }
+    virtual void appendElementsTo (const ValueUnion&, Array<var>&) const        {}
 
     virtual void cleanUp (ValueUnion&) const noexcept {}
     virtual void createCopy (ValueUnion& dest, const ValueUnion& source) const      { dest = source; }
@@ -273,9 +284,14 @@ public:
     String toString (const ValueUnion&) const                           { return "[Array]"; }
     bool isArray() const noexcept                                       { return true; }
     Array<var>* toArray (const ValueUnion& data) const noexcept         { return data.arrayValue; }
+    int getNumElements (const ValueUnion& data) const noexcept          { return data.arrayValue->size(); }
+    var getElement (const ValueUnion& data, int index) const            { return data.arrayValue->getReference (index); }
 
     bool equals (const ValueUnion& data, const ValueUnion& otherData, const VariantType& otherType) const noexcept
     {
+        if (otherType.isNumericArray())
+            return otherType.equals (otherData, data, *this);
+
         const Array<var>* const otherArray = otherType.toArray (otherData);
         return otherArray != nullptr && *otherArray == *(data.arrayValue);
     }
@@ -324,6 +340,113 @@ public:
     }
 };
 
+//==============================================================================
+template <typename ElementType>
+class var::VariantType_NumericArray   : public var::VariantType
+{
+public:
+    VariantType_NumericArray() noexcept {}
+    static const VariantType_NumericArray instance;
+
+    typedef Array<ElementType> ArrayType;
+
+    void cleanUp (ValueUnion& data) const noexcept                      { delete getArray (data); }
+    void createCopy (ValueUnion& dest, const ValueUnion& source) const  { dest.numericArrayValue = new ArrayType (*getArray (source)); }
+
+    String toString (const ValueUnion&) const                           { return "[Array]"; }
+    bool isNumericArray() const noexcept                                { return true; }
+    Array<int>* toIntArray (const ValueUnion& data) const noexcept          { return getArrayIfType (data, (int*) nullptr); }
+    Array<float>* toFloatArray (const ValueUnion& data) const noexcept      { return getArrayIfType (data, (float*) nullptr); }
+    Array<double>* toDoubleArray (const ValueUnion& data) const noexcept    { return getArrayIfType (data, (double*) nullptr); }
+    int getNumElements (const ValueUnion& data) const noexcept              { return getArray (data)->size(); }
+    var getElement (const ValueUnion& data, int index) const                { return var (getArray (data)->getUnchecked (index)); }
+
+    void appendElementsTo (const ValueUnion& data, Array<var>& dest) const
+    {
+        const ArrayType& array = *getArray (data);
+        dest.ensureStorageAllocated (dest.size() + array.size());
+
+        for (int i = 0; i < array.size(); ++i)
+            dest.add (var (array.getUnchecked (i)));
+    }
+
+    bool equals (const ValueUnion& data, const ValueUnion& otherData, const VariantType& otherType) const noexcept
+    {
+        const ArrayType& array = *getArray (data);
+
+        if (&otherType == this)
+            return array == *getArray (otherData);
+
+        if (! (otherType.isArray() || otherType.isNumericArray())
+              || otherType.getNumElements (otherData) != array.size())
+            return false;
+
+        for (int i = 0; i < array.size(); ++i)
+            if (var (array.getUnchecked (i)) != otherType.getElement (otherData, i))
+                return false;
+
+        return true;
+    }
+
+    void writeToStream (const ValueUnion& data, OutputStream& output) const
+    {
+        const ArrayType& array = *getArray (data);
+        MemoryOutputStream buffer (sizeof (ElementType) * (size_t) array.size() + 8);
+        buffer.writeCompressedInt (array.size());
+
+        for (int i = 0; i < array.size(); ++i)
+            writeElement (buffer, array.getUnchecked (i));
+
+        output.writeCompressedInt (1 + (int) buffer.getDataSize());
+        output.writeByte (getStreamMarker ((ElementType*) nullptr));
+        output << buffer;
+    }
+
+    static var readFromStream (InputStream& input, const int numBytes)
+    {
+        MemoryBlock block ((size_t) numBytes - 1);
+        block.setSize ((size_t) jmax (0, input.read (block.getData(), numBytes - 1)));
+
+        MemoryInputStream in (block, false);
+        const int numElements = in.readCompressedInt();
+        var v ((ArrayType()));
+        ArrayType& array = *getArray (v.value);
+
+        // (the count is checked against the size of the block, so that corrupt data
+        // can't make us allocate a huge array)
+        if (numElements > 0 && numElements <= (int) (in.getNumBytesRemaining() / (int64) sizeof (ElementType)))
+        {
+            array.resize (numElements);
+            ElementType* const elements = array.getRawDataPointer();
+
+            for (int i = 0; i < numElements; ++i)
+                readElement (in, elements[i]);
+        }
+
+        return v;
+    }
+
+private:
+    static inline ArrayType* getArray (const ValueUnion& data) noexcept     { return static_cast <ArrayType*> (data.numericArrayValue); }
+
+    static inline ArrayType* getArrayIfType (const ValueUnion& data, ElementType*) noexcept   { return getArray (data); }
+
+    template <typename OtherType>
+    static inline Array<OtherType>* getArrayIfType (const ValueUnion&, OtherType*) noexcept   { return nullptr; }
+
+    static char getStreamMarker (int*) noexcept         { return (char) varMarker_IntArray; }
+    static char getStreamMarker (float*) noexcept       { return (char) varMarker_FloatArray; }
+    static char getStreamMarker (double*) noexcept      { return (char) varMarker_DoubleArray; }
+
+    static void writeElement (OutputStream& out, const int v)       { out.writeInt (v); }
+    static void writeElement (OutputStream& out, const float v)     { out.writeFloat (v); }
+    static void writeElement (OutputStream& out, const double v)    { out.writeDouble (v); }
+
+    static void readElement (InputStream& in, int& v)       { v = in.readInt(); }
+    static void readElement (InputStream& in, float& v)     { v = in.readFloat(); }
+    static void readElement (InputStream& in, double& v)    { v = in.readDouble(); }
+};
+
 //==============================================================================
 class var::VariantType_Method   : public var::VariantType
 {
@@ -359,6 +482,9 @@ const var::VariantType_Array   var::VariantType_Array::instance;
 const var::VariantType_Binary  var::VariantType_Binary::instance;
 const var::VariantType_Method  var::VariantType_Method::instance;
 
+template <typename ElementType>
+const var::VariantType_NumericArray<ElementType> var::VariantType_NumericArray<ElementType>::instance;
+
 
 //==============================================================================
 var::var() noexcept : type (&VariantType_Void::instance)
@@ -384,6 +510,9 @@ var::var (const bool v) noexcept      : type (&VariantType_Bool::instance)   { v
 var::var (const double v) noexcept    : type (&VariantType_Double::instance) { value.doubleValue = v; }
 var::var (MethodFunction m) noexcept  : type (&VariantType_Method::instance) { value.methodValue = m; }
 var::var (const Array<var>& v)        : type (&VariantType_Array::instance)  { value.arrayValue = new Array<var> (v); }
+var::var (const Array<int>& v)        : type (&VariantType_NumericArray<int>::instance)     { value.numericArrayValue = new Array<int> (v); }
+var::var (const Array<float>& v)      : type (&VariantType_NumericArray<float>::instance)   { value.numericArrayValue = new Array<float> (v); }
+var::var (const Array<double>& v)     : type (&VariantType_NumericArray<double>::instance)  { value.numericArrayValue = new Array<double> (v); }
 var::var (const String& v)            : type (&VariantType_String::instance) { new (value.stringValue) String (v); }
 var::var (const char* const v)        : type (&VariantType_String::instance) { new (value.stringValue) String (v); }
 var::var (const wchar_t* const v)     : type (&VariantType_String::instance) { new (value.stringValue) String (v); }
@@ -410,6 +539,7 @@ bool var::isObject() const noexcept     { return type->isObject(); }
 bool var::isArray() const noexcept      { return type->isArray(); }
 bool var::isBinaryData() const noexcept { return type->isBinary(); }
 bool var::isMethod() const noexcept     { return type->isMethod(); }
+bool var::isNumericArray() const noexcept   { return type->isNumericArray(); }
 
 var::operator int() const noexcept                      { return type->toInt (value); }
 var::operator int64() const noexcept                    { return type->toInt64 (value); }
@@ -421,6 +551,9 @@ var::operator String() const                            { return type->toString
 ReferenceCountedObject* var::getObject() const noexcept { return type->toObject (value); }
 Array<var>* var::getArray() const noexcept              { return type->toArray (value); }
 MemoryBlock* var::getBinaryData() const noexcept        { return type->toBinary (value); }
+Array<int>* var::getIntArray() const noexcept           { return type->toIntArray (value); }
+Array<float>* var::getFloatArray() const noexcept       { return type->toFloatArray (value); }
+Array<double>* var::getDoubleArray() const noexcept     { return type->toDoubleArray (value); }
 DynamicObject* var::getDynamicObject() const noexcept   { return dynamic_cast <DynamicObject*> (getObject()); }
 
 //==============================================================================
@@ -439,6 +572,9 @@ var& var::operator= (const char* const v)        { type->cleanUp (value); type =
 var& var::operator= (const wchar_t* const v)     { type->cleanUp (value); type = &VariantType_String::instance; new (value.stringValue) String (v); return *this; }
 var& var::operator= (const String& v)            { type->cleanUp (value); type = &VariantType_String::instance; new (value.stringValue) String (v); return *this; }
 var& var::operator= (const Array<var>& v)        { var v2 (v); swapWith (v2); return *this; }
+var& var::operator= (const Array<int>& v)        { var v2 (v); swapWith (v2); return *this; }
+var& var::operator= (const Array<float>& v)      { var v2 (v); swapWith (v2); return *this; }
+var& var::operator= (const Array<double>& v)     { var v2 (v); swapWith (v2); return *this; }
 var& var::operator= (ReferenceCountedObject* v)  { var v2 (v); swapWith (v2); return *this; }
 var& var::operator= (MethodFunction v)           { var v2 (v); swapWith (v2); return *this; }
 
@@ -466,6 +602,26 @@ var::var (MemoryBlock&& v)  : type (&VariantType_Binary::instance)
     value.binaryValue = new MemoryBlock (static_cast<MemoryBlock&&> (v));
 }
 
+var::var (Array<var>&& v)  : type (&VariantType_Array::instance)
+{
+    value.arrayValue = new Array<var> (static_cast<Array<var>&&> (v));
+}
+
+var::var (Array<int>&& v)  : type (&VariantType_NumericArray<int>::instance)
+{
+    value.numericArrayValue = new Array<int> (static_cast<Array<int>&&> (v));
+}
+
+var::var (Array<float>&& v)  : type (&VariantType_NumericArray<float>::instance)
+{
+    value.numericArrayValue = new Array<float> (static_cast<Array<float>&&> (v));
+}
+
+var::var (Array<double>&& v)  : type (&VariantType_NumericArray<double>::instance)
+{
+    value.numericArrayValue = new Array<double> (static_cast<Array<double>&&> (v));
+}
+
 var& var::operator= (String&& v)
 {
     type->cleanUp (value);
@@ -473,6 +629,12 @@ var& var::operator= (String&& v)
     new (value.stringValue) String (static_cast<String&&> (v));
     return *this;
 }
+
+var& var::operator= (MemoryBlock&& v)     { var v2 (static_cast<MemoryBlock&&> (v)); swapWith (v2); return *this; }
+var& var::operator= (Array<var>&& v)      { var v2 (static_cast<Array<var>&&> (v)); swapWith (v2); return *this; }
+var& var::operator= (Array<int>&& v)      { var v2 (static_cast<Array<int>&&> (v)); swapWith (v2); return *this; }
+var& var::operator= (Array<float>&& v)    { var v2 (static_cast<Array<float>&&> (v)); swapWith (v2); return *this; }
+var& var::operator= (Array<double>&& v)   { var v2 (static_cast<Array<double>&&> (v)); swapWith (v2); return *this; }
 #endif
 
 //==============================================================================
@@ -571,10 +733,7 @@ var var::call (const Identifier method, const var& arg1, const var& arg2, const
 //==============================================================================
 int var::size() const
 {
-    if (const Array<var>* const array = getArray())
-        return array->size();
-
-    return 0;
+    return type->getNumElements (value);
 }
 
 const var& var::operator[] (int arrayIndex) const
@@ -609,7 +768,9 @@ Array<var>* var::convertToArray()
         var v (tempVar);
         array = v.value.arrayValue;
 
-        if (! isVoid())
+        if (isNumericArray())
+            type->appendElementsTo (value, *array);
+        else if (! isVoid())
             array->add (*this);
 
         swapWith (v);
@@ -697,6 +858,10 @@ var var::readFromStream (InputStream& input)
                 return v;
             }
 
+            case varMarker_IntArray:    return VariantType_NumericArray<int>::readFromStream (input, numBytes);
+            case varMarker_FloatArray:  return VariantType_NumericArray<float>::readFromStream (input, numBytes);
+            case varMarker_DoubleArray: return VariantType_NumericArray<double>::readFromStream (input, numBytes);
+
             default:
                 input.skipNextBytes (numBytes - 1); break;
         }
@@ -704,3 +869,72 @@ var var::readFromStream (InputStream& input)
 
     return var::null;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class VariantTests  : public UnitTest
+{
+public:
+    VariantTests() : UnitTest ("Variant") {}
+
+    static var writeAndReadBack (const var& v)
+    {
+        MemoryOutputStream mo;
+        v.writeToStream (mo);
+        MemoryInputStream mi (mo.getData(), mo.getDataSize(), false);
+        return var::readFromStream (mi);
+    }
+
+    void runTest()
+    {
+        beginTest ("Numeric arrays");
+
+        Array<int> ints;
+        Array<double> doubles;
+        Array<var> vars;
+
+        for (int i = 0; i < 100; ++i)
+        {
+            ints.add (i * 3 - 50);
+            doubles.add (i * 0.5);
+            vars.add (i * 3 - 50);
+        }
+
+        var v (ints);
+        expect (v.isNumericArray() && ! v.isArray());
+        expect (v.getArray() == nullptr && v.getDoubleArray() == nullptr);
+        expect (v.getIntArray() != nullptr && *v.getIntArray() == ints);
+        expectEquals (v.size(), 100);
+        expect (v == var (vars) && var (vars) == v);
+        expect (v != var (doubles));
+        expect (var (doubles).equalsWithSameType (var (doubles)));
+
+        const var copy (v);
+        v.getIntArray()->set (0, 1234);
+        expect (copy != v);
+        expect (copy.equalsWithSameType (writeAndReadBack (copy)));
+        expect (var (doubles).equalsWithSameType (writeAndReadBack (var (doubles))));
+        expect (var (Array<float>()).equalsWithSameType (writeAndReadBack (var (Array<float>()))));
+
+        var appended (copy);
+        appended.append (123);
+        expect (appended.isArray());
+        expectEquals (appended.size(), 101);
+        expect (appended[0] == var (-50) && appended[100] == var (123));
+
+        Array<float> floats;
+        floats.add (1.5f);
+        floats.add (-2.0f);
+        expectEquals (JSON::toString (var (floats), true), String ("[1.5, -2]"));
+        expect (JSON::parse (JSON::toString (copy)) == copy);
+
+        MemoryOutputStream compact;
+        CompactVarFormat::write (compact, var (floats));
+        expect (CompactVarFormat::read (compact.getMemoryBlock()) == var (floats));
+    }
+};
+
+static VariantTests variantUnitTests;
+
+#endif
@@ -44,6 +44,11 @@
     any kind of ReferenceCountedObject. The var class is intended to act like
     the kind of values used in dynamic scripting languages.
 
+    As well as arrays of other vars, a var can hold a dense array of ints, floats or
+    doubles, which keeps its elements in a single contiguous block rather than wrapping
+    each one in a var of its own. This is a much cheaper way of passing large blocks of
+    numbers around through JSON, ValueTrees, etc.
+
     You can save/load var objects either in a small, proprietary binary format
     using writeToStream()/readFromStream(), or as JSON by using the JSON class.
 
@@ -75,6 +80,9 @@ public:
     var (const wchar_t* value);
     var (const String& value);
     var (const Array<var>& value);
+    var (const Array<int>& value);
+    var (const Array<float>& value);
+    var (const Array<double>& value);
     var (ReferenceCountedObject* object);
     var (MethodFunction method) noexcept;
     var (const void* binaryData, size_t dataSize);
@@ -89,6 +97,9 @@ public:
     var& operator= (const wchar_t* value);
     var& operator= (const String& value);
     var& operator= (const Array<var>& value);
+    var& operator= (const Array<int>& value);
+    var& operator= (const Array<float>& value);
+    var& operator= (const Array<double>& value);
     var& operator= (ReferenceCountedObject* object);
     var& operator= (MethodFunction method);
 
@@ -96,8 +107,17 @@ public:
     var (var&& other) noexcept;
     var (String&& value);
     var (MemoryBlock&& binaryData);
+    var (Array<var>&& value);
+    var (Array<int>&& value);
+    var (Array<float>&& value);
+    var (Array<double>&& value);
     var& operator= (var&& other) noexcept;
     var& operator= (String&& value);
+    var& operator= (MemoryBlock&& binaryData);
+    var& operator= (Array<var>&& value);
+    var& operator= (Array<int>&& value);
+    var& operator= (Array<float>&& value);
+    var& operator= (Array<double>&& value);
    #endif
 
     void swapWith (var& other) noexcept;
@@ -119,6 +139,24 @@ public:
     */
     Array<var>* getArray() const noexcept;
 
+    /** If this variant holds a dense array of ints, this provides access to it.
+        The same lifetime caveats apply as for getArray().
+        @see isNumericArray
+    */
+    Array<int>* getIntArray() const noexcept;
+
+    /** If this variant holds a dense array of floats, this provides access to it.
+        The same lifetime caveats apply as for getArray().
+        @see isNumericArray
+    */
+    Array<float>* getFloatArray() const noexcept;
+
+    /** If this variant holds a dense array of doubles, this provides access to it.
+        The same lifetime caveats apply as for getArray().
+        @see isNumericArray
+    */
+    Array<double>* getDoubleArray() const noexcept;
+
     /** If this variant holds a memory block, this provides access to it.
         NOTE: Beware when you use this - the MemoryBlock pointer is only valid for the lifetime
         of the variant that returned it, so be very careful not to call this method on temporary
@@ -140,6 +178,14 @@ public:
     bool isObject() const noexcept;
     bool isArray() const noexcept;
     bool isBinaryData() const noexcept;
+
+    /** Returns true if this holds a dense array of ints, floats or doubles.
+        Note that isArray() returns false for these, and getArray() will return nullptr,
+        but size() works for both kinds of array, and a numeric array is considered
+        equal to an Array\<var\> that contains the same values.
+        @see getIntArray, getFloatArray, getDoubleArray
+    */
+    bool isNumericArray() const noexcept;
     bool isMethod() const noexcept;
 
     /** Returns true if this var has the same value as the one supplied.
@@ -157,7 +203,8 @@ public:
 
     //==============================================================================
     /** If the var is an array, this returns the number of elements.
-        If the var isn't actually an array, this will return 0.
+        This also works for the dense numeric arrays. If the var isn't actually an
+        array, this will return 0.
     */
     int size() const;
 
@@ -181,7 +228,8 @@ public:
 
     /** Appends an element to the var, converting it to an array if it isn't already one.
         If the var isn't an array, it will be converted to one, and if its value was non-void,
-        this value will be kept as the first element of the new array. The parameter value
+        this value will be kept as the first element of the new array. (A dense numeric array
+        is converted to an Array\<var\> containing its elements). The parameter value
         will then be appended to it.
         For more control over the array's contents, you can call getArray() and manipulate
         it directly as an Array\<var\>.
@@ -244,15 +292,16 @@ public:
 
     //==============================================================================
     /** Writes a binary representation of this value to a stream.
-        The data can be read back later using readFromStream().
-        @see JSON
+        The data can be read back later using readFromStream(). Objects can't be written
+        this way - for a more compact format which can store them, use CompactVarFormat.
+        @see JSON, CompactVarFormat
     */
     void writeToStream (OutputStream& output) const;
 
     /** Reads back a stored binary representation of a value.
         The data in the stream must have been written using writeToStream(), or this
         will have unpredictable results.
-        @see JSON
+        @see JSON, CompactVarFormat
     */
     static var readFromStream (InputStream& input);
 
@@ -269,6 +318,8 @@ private:
     class VariantType_Array;   friend class VariantType_Array;
     class VariantType_Binary;  friend class VariantType_Binary;
     class VariantType_Method;  friend class VariantType_Method;
+    template <typename ElementType> class VariantType_NumericArray;
+    template <typename ElementType> friend class VariantType_NumericArray;
 
     union ValueUnion
     {
@@ -280,6 +331,7 @@ private:
         ReferenceCountedObject* objectValue;
         Array<var>* arrayValue;
         MemoryBlock* binaryValue;
+        void* numericArrayValue;
         MethodFunction methodValue;
     };
 
@@ -0,0 +1,1063 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace AsyncFileIOHelpers
+{
+   #if JUCE_WINDOWS
+    static Result getResultForErrorCode (const DWORD error)
+    {
+        TCHAR messageBuffer [256] = { 0 };
+
+        FormatMessage (FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+                       nullptr, error, MAKELANGID (LANG_NEUTRAL, SUBLANG_DEFAULT),
+                       messageBuffer, (DWORD) numElementsInArray (messageBuffer) - 1, nullptr);
+
+        return Result::fail (String (messageBuffer));
+    }
+
+    static inline HANDLE getHandle (void* fileHandle) noexcept     { return (HANDLE) fileHandle; }
+   #else
+    static Result getResultForErrorCode (const int error)
+    {
+        return Result::fail (String (strerror (error)));
+    }
+
+    static inline int getFD (void* fileHandle) noexcept            { return (int) (pointer_sized_int) fileHandle; }
+   #endif
+
+    static inline bool isAligned (const int64 value) noexcept
+    {
+        return (value & (int64) (AsyncFileIO::getDirectIOAlignment() - 1)) == 0;
+    }
+}
+
+//==============================================================================
+// An engine performs the requests for all the open files. There's only ever one of them,
+// which is created when the first file is opened and deleted when the last one is closed.
+class AsyncFileIO::Engine
+{
+public:
+    Engine() {}
+    virtual ~Engine() {}
+
+    virtual bool attach (AsyncFileIO&)          { return true; }
+    virtual void start (Request&) = 0;
+    virtual bool isNative() const noexcept = 0;
+
+    static Engine* retain();
+    static void release();
+
+private:
+    static Engine* create();
+
+    struct SharedEngine
+    {
+        SharedEngine() : engine (nullptr), numUsers (0) {}
+
+        CriticalSection lock;
+        Engine* engine;
+        int numUsers;
+    };
+
+    static SharedEngine& getSharedEngine()
+    {
+        static SharedEngine sharedEngine;
+        return sharedEngine;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Engine)
+};
+
+AsyncFileIO::Engine* AsyncFileIO::Engine::retain()
+{
+    SharedEngine& shared = getSharedEngine();
+    const ScopedLock sl (shared.lock);
+
+    if (shared.numUsers++ == 0)
+        shared.engine = create();
+
+    return shared.engine;
+}
+
+void AsyncFileIO::Engine::release()
+{
+    SharedEngine& shared = getSharedEngine();
+    ScopedPointer<Engine> engineToDelete;
+
+    {
+        const ScopedLock sl (shared.lock);
+
+        if (--shared.numUsers == 0)
+        {
+            engineToDelete = shared.engine;
+            shared.engine = nullptr;
+        }
+    }
+}
+
+//==============================================================================
+#if ! JUCE_WINDOWS
+// Performs each request with a blocking call on a pool of threads.
+class AsyncFileIO::ThreadedEngine  : public AsyncFileIO::Engine
+{
+public:
+    ThreadedEngine() : pool (4) {}
+
+    void start (Request& request)           { pool.addJob (&perform, &request); }
+    bool isNative() const noexcept          { return false; }
+
+private:
+    ThreadPool pool;
+
+    static void perform (void* userData)
+    {
+        Request& request = *static_cast <Request*> (userData);
+        const int fd = AsyncFileIOHelpers::getFD (request.owner->fileHandle);
+        char* const data = static_cast <char*> (request.buffer);
+        size_t numDone = 0;
+
+        for (;;)
+        {
+            const size_t numToDo = request.numBytesRequested - numDone;
+            const off_t position = (off_t) (request.filePosition + (int64) numDone);
+
+            const ssize_t result = request.isWriteRequest ? pwrite (fd, data + numDone, numToDo, position)
+                                                          : pread  (fd, data + numDone, numToDo, position);
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                requestFinished (request, (int64) numDone, AsyncFileIOHelpers::getResultForErrorCode (errno));
+                return;
+            }
+
+            numDone += (size_t) result;
+
+            // (a short read means the end of the file, but a short write needs to carry on)
+            if (! request.isWriteRequest || result == 0 || numDone >= request.numBytesRequested)
+                break;
+        }
+
+        requestFinished (request, (int64) numDone, Result::ok());
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ThreadedEngine)
+};
+#endif
+
+//==============================================================================
+#if JUCE_LINUX
+// Uses the kernel's io_uring interface. The structures are declared here rather than
+// taken from <linux/io_uring.h>, so that this still builds against older kernel headers,
+// and falls back to the ThreadedEngine at runtime if the kernel doesn't support it.
+namespace UringABI
+{
+    struct SubmissionRingOffsets    { uint32 head, tail, ringMask, ringEntries, flags, dropped, array, reserved1; uint64 reserved2; };
+    struct CompletionRingOffsets    { uint32 head, tail, ringMask, ringEntries, overflow, entries, flags, reserved1; uint64 reserved2; };
+
+    struct Params
+    {
+        uint32 submissionEntries, completionEntries, flags, threadCPU, threadIdle, features, workQueueFD, reserved[3];
+        SubmissionRingOffsets submissionOffsets;
+        CompletionRingOffsets completionOffsets;
+    };
+
+    struct SubmissionEntry
+    {
+        uint8 opcode, flags;
+        uint16 priority;
+        int32 fd;
+        uint64 offset, address;
+        uint32 length, operationFlags;
+        uint64 userData;
+        uint64 padding[3];
+    };
+
+    struct CompletionEntry
+    {
+        uint64 userData;
+        int32 result;
+        uint32 flags;
+    };
+
+    enum
+    {
+       #ifdef __NR_io_uring_setup
+        setupSyscall = __NR_io_uring_setup,
+        enterSyscall = __NR_io_uring_enter,
+       #else
+        setupSyscall = 425,
+        enterSyscall = 426,
+       #endif
+        opNop = 0,
+        opReadv = 1,
+        opWritev = 2,
+        enterGetEvents = 1,
+        featureSingleMmap = 1
+    };
+
+    static const off_t submissionRingOffset = 0;
+    static const off_t completionRingOffset = 0x8000000;
+    static const off_t submissionEntriesOffset = 0x10000000;
+
+    static inline uint32 loadAcquire (const uint32* p) noexcept              { return __atomic_load_n (p, __ATOMIC_ACQUIRE); }
+    static inline void storeRelease (uint32* p, const uint32 v) noexcept     { __atomic_store_n (p, v, __ATOMIC_RELEASE); }
+}
+
+class AsyncFileIO::UringEngine  : public AsyncFileIO::Engine,
+                                  private Thread
+{
+public:
+    UringEngine()
+        : Thread ("AsyncFileIO"), ringFD (-1),
+          submissionRing (nullptr), completionRing (nullptr), submissionEntries (nullptr),
+          submissionRingSize (0), completionRingSize (0), submissionEntriesSize (0),
+          maxInFlight (0), numInFlight (0)
+    {
+    }
+
+    ~UringEngine()
+    {
+        if (isThreadRunning())
+        {
+            signalThreadShouldExit();
+
+            {
+                // (a no-op request wakes the thread up, so that it notices it should exit)
+                const ScopedLock sl (lock);
+                submit (nullptr);
+            }
+
+            stopThread (-1);
+        }
+
+        if (submissionEntries != nullptr)
+            munmap (submissionEntries, submissionEntriesSize);
+
+        if (completionRing != nullptr && completionRing != submissionRing)
+            munmap (completionRing, completionRingSize);
+
+        if (submissionRing != nullptr)
+            munmap (submissionRing, submissionRingSize);
+
+        if (ringFD >= 0)
+            ::close (ringFD);
+    }
+
+    bool initialise()
+    {
+        using namespace UringABI;
+
+        Params params;
+        zerostruct (params);
+
+        ringFD = (int) syscall (setupSyscall, (long) 128, &params);
+
+        if (ringFD < 0)
+            return false;
+
+        submissionRingSize = params.submissionOffsets.array + params.submissionEntries * sizeof (uint32);
+        completionRingSize = params.completionOffsets.entries + params.completionEntries * sizeof (CompletionEntry);
+
+        if ((params.features & featureSingleMmap) != 0)
+            submissionRingSize = completionRingSize = jmax (submissionRingSize, completionRingSize);
+
+        submissionRing = mapRegion (submissionRingSize, submissionRingOffset);
+
+        if (submissionRing == nullptr)
+            return false;
+
+        completionRing = (params.features & featureSingleMmap) != 0 ? submissionRing
+                                                                     : mapRegion (completionRingSize, completionRingOffset);
+
+        submissionEntriesSize = params.submissionEntries * sizeof (SubmissionEntry);
+        submissionEntries = static_cast <SubmissionEntry*> (mapRegion (submissionEntriesSize, submissionEntriesOffset));
+
+        if (completionRing == nullptr || submissionEntries == nullptr)
+            return false;
+
+        char* const sq = static_cast <char*> (submissionRing);
+        submissionTail  = reinterpret_cast <uint32*> (sq + params.submissionOffsets.tail);
+        submissionMask  = *reinterpret_cast <uint32*> (sq + params.submissionOffsets.ringMask);
+        submissionArray = reinterpret_cast <uint32*> (sq + params.submissionOffsets.array);
+
+        char* const cq = static_cast <char*> (completionRing);
+        completionHead  = reinterpret_cast <uint32*> (cq + params.completionOffsets.head);
+        completionTail  = reinterpret_cast <uint32*> (cq + params.completionOffsets.tail);
+        completionMask  = *reinterpret_cast <uint32*> (cq + params.completionOffsets.ringMask);
+        completions     = reinterpret_cast <CompletionEntry*> (cq + params.completionOffsets.entries);
+
+        // never having more requests running than the completion ring can hold means
+        // that no completions can ever be lost
+        maxInFlight = (int) params.completionEntries - 1;
+
+        startThread (8);
+        return true;
+    }
+
+    void start (Request& request)
+    {
+        int error = 0;
+
+        {
+            const ScopedLock sl (lock);
+
+            if (numInFlight >= maxInFlight)
+                waitingRequests.add (&request);
+            else
+                error = submit (&request);
+        }
+
+        if (error != 0)
+            requestFinished (request, 0, AsyncFileIOHelpers::getResultForErrorCode (error));
+    }
+
+    bool isNative() const noexcept          { return true; }
+
+private:
+    int ringFD;
+    void* submissionRing;
+    void* completionRing;
+    UringABI::SubmissionEntry* submissionEntries;
+    size_t submissionRingSize, completionRingSize, submissionEntriesSize;
+    uint32* submissionTail;
+    uint32* submissionArray;
+    uint32 submissionMask, completionMask;
+    uint32* completionHead;
+    uint32* completionTail;
+    UringABI::CompletionEntry* completions;
+
+    CriticalSection lock;
+    int maxInFlight, numInFlight;
+    Array <Request*> waitingRequests;
+
+    long enter (const int numToSubmit, const int minToComplete, const int enterFlags) const
+    {
+        // (all the arguments need to be longs to go through syscall()'s varargs)
+        return syscall (UringABI::enterSyscall, (long) ringFD, (long) numToSubmit, (long) minToComplete,
+                        (long) enterFlags, (long) 0, (long) 0);
+    }
+
+    void* mapRegion (const size_t size, const off_t offset) const
+    {
+        void* const address = mmap (0, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, offset);
+        return address != MAP_FAILED ? address : nullptr;
+    }
+
+    // Adds a request to the submission ring and passes it to the kernel. This must be called
+    // with the lock held, and returns an errno value if it fails.
+    int submit (Request* const request)
+    {
+        using namespace UringABI;
+
+        const uint32 tail = *submissionTail;
+        const uint32 index = tail & submissionMask;
+        SubmissionEntry& entry = submissionEntries [index];
+        zerostruct (entry);
+
+        if (request != nullptr)
+        {
+            const size_t numDone = (size_t) request->numBytesTransferred;
+
+            iovec* const vec = reinterpret_cast <iovec*> (request->platformData);
+            vec->iov_base = static_cast <char*> (request->buffer) + numDone;
+            vec->iov_len = request->numBytesRequested - numDone;
+
+            entry.opcode = (uint8) (request->isWriteRequest ? opWritev : opReadv);
+            entry.fd = AsyncFileIOHelpers::getFD (request->owner->fileHandle);
+            entry.offset = (uint64) (request->filePosition + (int64) numDone);
+            entry.address = (uint64) (pointer_sized_uint) vec;
+            entry.length = 1;
+            entry.userData = (uint64) (pointer_sized_uint) request;
+        }
+        else
+        {
+            entry.opcode = (uint8) opNop;
+        }
+
+        submissionArray [index] = index;
+        storeRelease (submissionTail, tail + 1);
+
+        for (;;)
+        {
+            if (enter (1, 0, 0) == 1)
+                break;
+
+            if (errno != EINTR && errno != EAGAIN)
+            {
+                const int error = errno;
+                storeRelease (submissionTail, tail);
+                return error;
+            }
+        }
+
+        ++numInFlight;
+        return 0;
+    }
+
+    void run()
+    {
+        using namespace UringABI;
+
+        while (! threadShouldExit())
+        {
+            if (enter (0, 1, enterGetEvents) < 0 && errno != EINTR)
+                break;
+
+            for (;;)
+            {
+                const uint32 head = *completionHead;
+
+                if (head == loadAcquire (completionTail))
+                    break;
+
+                const CompletionEntry completion (completions [head & completionMask]);
+                storeRelease (completionHead, head + 1);
+
+                if (completion.userData != 0)
+                    handleCompletion (*reinterpret_cast <Request*> ((pointer_sized_uint) completion.userData),
+                                      completion.result);
+            }
+        }
+    }
+
+    void handleCompletion (Request& request, const int result)
+    {
+        if (result > 0)
+            request.numBytesTransferred += result;
+
+        const bool needsResubmitting = (result == -EINTR || result == -EAGAIN)
+                                         || (result > 0 && request.isWriteRequest
+                                              && request.numBytesTransferred < (int64) request.numBytesRequested);
+
+        Array <Request*> failedRequests;
+        int error = 0;
+
+        {
+            const ScopedLock sl (lock);
+            --numInFlight;
+
+            if (needsResubmitting)
+            {
+                error = submit (&request);
+            }
+            else
+            {
+                while (numInFlight < maxInFlight && waitingRequests.size() > 0)
+                {
+                    Request* const next = waitingRequests.remove (0);
+
+                    if (submit (next) != 0)
+                        failedRequests.add (next);
+                }
+            }
+        }
+
+        if (! needsResubmitting)
+            requestFinished (request, request.numBytesTransferred,
+                             result < 0 ? AsyncFileIOHelpers::getResultForErrorCode (-result) : Result::ok());
+        else if (error != 0)
+            requestFinished (request, request.numBytesTransferred, AsyncFileIOHelpers::getResultForErrorCode (error));
+
+        for (int i = 0; i < failedRequests.size(); ++i)
+            requestFinished (*failedRequests.getUnchecked (i), 0, Result::fail ("Couldn't start the request"));
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (UringEngine)
+};
+#endif
+
+//==============================================================================
+#if JUCE_WINDOWS
+// Uses overlapped I/O, with the results collected from a completion port.
+class AsyncFileIO::CompletionPortEngine  : public AsyncFileIO::Engine,
+                                           private Thread
+{
+public:
+    CompletionPortEngine()
+        : Thread ("AsyncFileIO"),
+          port (CreateIoCompletionPort (INVALID_HANDLE_VALUE, 0, 0, 1))
+    {
+        startThread (8);
+    }
+
+    ~CompletionPortEngine()
+    {
+        signalThreadShouldExit();
+        PostQueuedCompletionStatus (port, 0, 0, 0);
+        stopThread (-1);
+        CloseHandle (port);
+    }
+
+    bool attach (AsyncFileIO& file)
+    {
+        return CreateIoCompletionPort (AsyncFileIOHelpers::getHandle (file.fileHandle), port, 1, 0) != 0;
+    }
+
+    void start (Request& request)
+    {
+        static_jassert (sizeof (OverlappedRequest) <= sizeof (request.platformData));
+
+        OverlappedRequest& o = *reinterpret_cast <OverlappedRequest*> (request.platformData);
+        zerostruct (o.overlapped);
+        o.overlapped.Offset = (DWORD) request.filePosition;
+        o.overlapped.OffsetHigh = (DWORD) (request.filePosition >> 32);
+        o.request = &request;
+
+        const HANDLE h = AsyncFileIOHelpers::getHandle (request.owner->fileHandle);
+
+        const BOOL ok = request.isWriteRequest ? WriteFile (h, request.buffer, (DWORD) request.numBytesRequested, 0, &o.overlapped)
+                                               : ReadFile  (h, request.buffer, (DWORD) request.numBytesRequested, 0, &o.overlapped);
+
+        // (if it succeeds straight away, the result still gets posted to the completion port)
+        if (! ok)
+        {
+            const DWORD error = GetLastError();
+
+            if (error != ERROR_IO_PENDING)
+                requestFinished (request, 0, error == ERROR_HANDLE_EOF ? Result::ok()
+                                                                       : AsyncFileIOHelpers::getResultForErrorCode (error));
+        }
+    }
+
+    bool isNative() const noexcept          { return true; }
+
+private:
+    struct OverlappedRequest
+    {
+        OVERLAPPED overlapped;
+        Request* request;
+    };
+
+    HANDLE port;
+
+    void run()
+    {
+        for (;;)
+        {
+            DWORD numBytes = 0;
+            ULONG_PTR key = 0;
+            OVERLAPPED* overlapped = nullptr;
+
+            const BOOL ok = GetQueuedCompletionStatus (port, &numBytes, &key, &overlapped, INFINITE);
+
+            if (overlapped == nullptr)
+            {
+                if (threadShouldExit() || ! ok)
+                    break;
+
+                continue;
+            }
+
+            Request& request = *reinterpret_cast <OverlappedRequest*> (overlapped)->request;
+            const DWORD error = ok ? 0 : GetLastError();
+
+            requestFinished (request, (int64) numBytes,
+                             (error == 0 || error == ERROR_HANDLE_EOF) ? Result::ok()
+                                                                       : AsyncFileIOHelpers::getResultForErrorCode (error));
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (CompletionPortEngine)
+};
+#endif
+
+//==============================================================================
+AsyncFileIO::Engine* AsyncFileIO::Engine::create()
+{
+   #if JUCE_WINDOWS
+    return new CompletionPortEngine();
+   #else
+    #if JUCE_LINUX
+     ScopedPointer<UringEngine> uring (new UringEngine());
+
+     if (uring->initialise())
+         return uring.release();
+    #endif
+
+    return new ThreadedEngine();
+   #endif
+}
+
+bool AsyncFileIO::isUsingNativeAsyncIO()
+{
+    const bool native = Engine::retain()->isNative();
+    Engine::release();
+    return native;
+}
+
+//==============================================================================
+AsyncFileIO::Request::Request()
+    : userData (0), owner (nullptr), listener (nullptr), buffer (nullptr),
+      numBytesRequested (0), filePosition (0), numBytesTransferred (0),
+      isWriteRequest (false), result (Result::ok()), finished (true)
+{
+    finished.signal();
+}
+
+AsyncFileIO::Request::~Request()
+{
+    // If you hit this, you're deleting a request that's still running!
+    jassert (! isPending());
+
+    finished.wait();
+}
+
+bool AsyncFileIO::Request::isPending() const
+{
+    return ! finished.wait (0);
+}
+
+bool AsyncFileIO::Request::waitForCompletion (const int timeOutMilliseconds) const
+{
+    return finished.wait (timeOutMilliseconds);
+}
+
+//==============================================================================
+AsyncFileIO::AsyncFileIO (const File& file_, const int flags_)
+    : file (file_), flags (flags_), status (Result::ok()),
+      fileHandle (nullptr), engine (nullptr), hasPreallocated (false), numPendingRequests (0),
+      noRequestsPending (true)
+{
+    using namespace AsyncFileIOHelpers;
+
+    noRequestsPending.signal();
+    const bool writable = (flags & readWrite) != 0;
+
+   #if JUCE_WINDOWS
+    const DWORD attributes = FILE_FLAG_OVERLAPPED
+                              | ((flags & directIO) != 0 ? (FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH) : 0)
+                              | ((flags & sequentialAccess) != 0 ? FILE_FLAG_SEQUENTIAL_SCAN : 0)
+                              | ((flags & randomAccess) != 0 ? FILE_FLAG_RANDOM_ACCESS : 0);
+
+    HANDLE h = CreateFile (file.getFullPathName().toWideCharPointer(),
+                           GENERIC_READ | (writable ? GENERIC_WRITE : 0),
+                           writable ? FILE_SHARE_READ : (FILE_SHARE_READ | FILE_SHARE_WRITE), 0,
+                           writable ? OPEN_ALWAYS : OPEN_EXISTING, attributes, 0);
+
+    if (h == INVALID_HANDLE_VALUE)
+    {
+        status = getResultForErrorCode (GetLastError());
+        return;
+    }
+
+    fileHandle = (void*) h;
+   #else
+    int openFlags = writable ? (O_RDWR | O_CREAT) : O_RDONLY;
+
+   #ifdef O_DIRECT
+    if ((flags & directIO) != 0)
+        openFlags |= O_DIRECT;
+   #endif
+
+    const int fd = ::open (file.getFullPathName().toUTF8(), openFlags, 0644);
+
+    if (fd < 0)
+    {
+        status = getResultForErrorCode (errno);
+        return;
+    }
+
+    fileHandle = (void*) (pointer_sized_int) fd;
+
+   #if JUCE_MAC || JUCE_IOS
+    if ((flags & directIO) != 0)
+        fcntl (fd, F_NOCACHE, 1);
+
+    if ((flags & (sequentialAccess | randomAccess)) != 0)
+        fcntl (fd, F_RDAHEAD, (flags & sequentialAccess) != 0 ? 1 : 0);
+   #else
+    if ((flags & (sequentialAccess | randomAccess)) != 0)
+        posix_fadvise (fd, 0, 0, (flags & sequentialAccess) != 0 ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_RANDOM);
+   #endif
+   #endif
+
+    engine = Engine::retain();
+
+    if (! engine->attach (*this))
+    {
+        closeHandle();
+        status = Result::fail ("Couldn't use asynchronous I/O with this file");
+    }
+}
+
+AsyncFileIO::~AsyncFileIO()
+{
+    waitForAllRequests();
+
+    if (engine != nullptr)
+        Engine::release();
+
+    if (status.wasOk())
+        closeHandle();
+}
+
+void AsyncFileIO::closeHandle()
+{
+   #if JUCE_WINDOWS
+    CloseHandle (AsyncFileIOHelpers::getHandle (fileHandle));
+   #else
+    const int fd = AsyncFileIOHelpers::getFD (fileHandle);
+
+    // space reserved beyond the end of the file isn't always given back on closing,
+    // but truncating it to its own length releases it
+    struct stat info;
+    if (hasPreallocated && fstat (fd, &info) == 0)
+        (void) ftruncate (fd, info.st_size);
+
+    ::close (fd);
+   #endif
+}
+
+int64 AsyncFileIO::getFileSize() const
+{
+    if (status.failed())
+        return -1;
+
+   #if JUCE_WINDOWS
+    LARGE_INTEGER size;
+    return GetFileSizeEx (AsyncFileIOHelpers::getHandle (fileHandle), &size) ? (int64) size.QuadPart : -1;
+   #else
+    struct stat info;
+    return fstat (AsyncFileIOHelpers::getFD (fileHandle), &info) == 0 ? (int64) info.st_size : -1;
+   #endif
+}
+
+//==============================================================================
+bool AsyncFileIO::read (Request& request, void* destBuffer, size_t numBytes,
+                        int64 filePosition, Listener* listener)
+{
+    return startRequest (request, destBuffer, numBytes, filePosition, false, listener);
+}
+
+bool AsyncFileIO::write (Request& request, const void* sourceData, size_t numBytes,
+                         int64 filePosition, Listener* listener)
+{
+    return startRequest (request, const_cast <void*> (sourceData), numBytes, filePosition, true, listener);
+}
+
+bool AsyncFileIO::startRequest (Request& request, void* const buffer, const size_t numBytes,
+                                const int64 filePosition, const bool isWrite, Listener* const listener)
+{
+    using namespace AsyncFileIOHelpers;
+
+    jassert (buffer != nullptr || numBytes == 0);
+    jassert (filePosition >= 0 && numBytes < 0x7fffffff);
+
+    if (status.failed() || (isWrite && (flags & readWrite) == 0))
+        return false;
+
+    if (request.isPending())
+    {
+        jassertfalse; // you can't start a request while it's still being used for another one!
+        return false;
+    }
+
+    if ((flags & directIO) != 0
+         && ! (isAligned ((int64) (pointer_sized_int) buffer) && isAligned ((int64) numBytes) && isAligned (filePosition)))
+    {
+        jassertfalse; // with directIO, all of these must be multiples of getDirectIOAlignment()
+        return false;
+    }
+
+    request.owner = this;
+    request.listener = listener;
+    request.buffer = buffer;
+    request.numBytesRequested = numBytes;
+    request.filePosition = filePosition;
+    request.isWriteRequest = isWrite;
+    request.numBytesTransferred = 0;
+    request.result = Result::ok();
+    request.finished.reset();
+
+    {
+        const ScopedLock sl (pendingLock);
+
+        if (numPendingRequests++ == 0)
+            noRequestsPending.reset();
+    }
+
+    engine->start (request);
+    return true;
+}
+
+void AsyncFileIO::requestFinished (Request& request, const int64 numBytesTransferred, const Result& result)
+{
+    AsyncFileIO& owner = *request.owner;
+
+    request.numBytesTransferred = numBytesTransferred;
+    request.result = result;
+
+    if (request.listener != nullptr)
+        request.listener->asyncFileIORequestFinished (request);
+
+    // (once this has been signalled, the request may be deleted or reused)
+    request.finished.signal();
+
+    const ScopedLock sl (owner.pendingLock);
+
+    if (--owner.numPendingRequests == 0)
+        owner.noRequestsPending.signal();
+}
+
+void AsyncFileIO::waitForAllRequests()
+{
+    noRequestsPending.wait();
+
+    // (this makes sure that the thread which signalled the event has finished with the lock)
+    const ScopedLock sl (pendingLock);
+}
+
+//==============================================================================
+Result AsyncFileIO::flush()
+{
+    if (status.failed())
+        return status;
+
+   #if JUCE_WINDOWS
+    if (! FlushFileBuffers (AsyncFileIOHelpers::getHandle (fileHandle)))
+        return AsyncFileIOHelpers::getResultForErrorCode (GetLastError());
+   #else
+    if (fsync (AsyncFileIOHelpers::getFD (fileHandle)) != 0)
+        return AsyncFileIOHelpers::getResultForErrorCode (errno);
+   #endif
+
+    return Result::ok();
+}
+
+Result AsyncFileIO::setFileSize (const int64 newSize)
+{
+    if (status.failed())
+        return status;
+
+   #if JUCE_WINDOWS
+    const HANDLE h = AsyncFileIOHelpers::getHandle (fileHandle);
+    LARGE_INTEGER position;
+    position.QuadPart = newSize;
+
+    if (! (SetFilePointerEx (h, position, 0, FILE_BEGIN) && SetEndOfFile (h)))
+        return AsyncFileIOHelpers::getResultForErrorCode (GetLastError());
+   #else
+    if (ftruncate (AsyncFileIOHelpers::getFD (fileHandle), (off_t) newSize) != 0)
+        return AsyncFileIOHelpers::getResultForErrorCode (errno);
+   #endif
+
+    return Result::ok();
+}
+
+Result AsyncFileIO::preallocate (const int64 totalFileSize)
+{
+    if (status.failed())
+        return status;
+
+   #if JUCE_WINDOWS
+    #if _WIN32_WINNT >= 0x0600
+     FILE_ALLOCATION_INFO info;
+     info.AllocationSize.QuadPart = totalFileSize;
+
+     if (! SetFileInformationByHandle (AsyncFileIOHelpers::getHandle (fileHandle), FileAllocationInfo, &info, sizeof (info)))
+         return AsyncFileIOHelpers::getResultForErrorCode (GetLastError());
+
+     hasPreallocated = true;
+     return Result::ok();
+    #else
+     (void) totalFileSize;
+     return Result::fail ("Preallocation needs Windows Vista or later");
+    #endif
+   #elif JUCE_LINUX
+    if (fallocate (AsyncFileIOHelpers::getFD (fileHandle), FALLOC_FL_KEEP_SIZE, 0, (off_t) totalFileSize) != 0)
+        return AsyncFileIOHelpers::getResultForErrorCode (errno);
+
+    hasPreallocated = true;
+    return Result::ok();
+   #elif JUCE_MAC || JUCE_IOS
+    const int64 currentSize = getFileSize();
+
+    if (totalFileSize <= currentSize)
+        return Result::ok();
+
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t) (totalFileSize - currentSize), 0 };
+
+    if (fcntl (AsyncFileIOHelpers::getFD (fileHandle), F_PREALLOCATE, &store) == -1)
+    {
+        store.fst_flags = F_ALLOCATEALL;
+
+        if (fcntl (AsyncFileIOHelpers::getFD (fileHandle), F_PREALLOCATE, &store) == -1)
+            return AsyncFileIOHelpers::getResultForErrorCode (errno);
+    }
+
+    hasPreallocated = true;
+    return Result::ok();
+   #else
+    (void) totalFileSize;
+    return Result::fail ("Preallocation isn't supported on this platform");
+   #endif
+}
+
+void AsyncFileIO::prefetch (const int64 startPosition, const int64 numBytes)
+{
+    if (status.failed() || (flags & directIO) != 0)
+        return;
+
+   #if JUCE_MAC || JUCE_IOS
+    struct radvisory advice;
+    advice.ra_offset = (off_t) startPosition;
+    advice.ra_count = (int) jmin (numBytes, (int64) 0x7fffffff);
+    fcntl (AsyncFileIOHelpers::getFD (fileHandle), F_RDADVISE, &advice);
+   #elif JUCE_LINUX || JUCE_ANDROID
+    posix_fadvise (AsyncFileIOHelpers::getFD (fileHandle), (off_t) startPosition, (off_t) numBytes, POSIX_FADV_WILLNEED);
+   #else
+    (void) startPosition;
+    (void) numBytes;
+   #endif
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AsyncFileIOTests  : public UnitTest
+{
+public:
+    AsyncFileIOTests()  : UnitTest ("AsyncFileIO") {}
+
+    struct CountingListener  : public AsyncFileIO::Listener
+    {
+        void asyncFileIORequestFinished (AsyncFileIO::Request& request)
+        {
+            if (request.getResult().wasOk())
+                numBytes += (int) request.getNumBytesTransferred();
+
+            ++numRequests;
+        }
+
+        Atomic<int> numRequests, numBytes;
+    };
+
+    void runTest()
+    {
+        beginTest ("Writing and reading");
+
+        const File file (File::createTempFile ("asyncio"));
+        const int blockSize = 8192, numBlocks = 64;
+
+        MemoryBlock data ((size_t) (blockSize * numBlocks));
+        Random rng;
+
+        for (size_t i = 0; i < data.getSize(); ++i)
+            data[(int) i] = (char) rng.nextInt (256);
+
+        {
+            AsyncFileIO io (file, AsyncFileIO::readWrite);
+            expect (io.openedOk());
+
+            OwnedArray<AsyncFileIO::Request> requests;
+            CountingListener listener;
+
+            // (the blocks are all written at once, in reverse order)
+            for (int i = numBlocks; --i >= 0;)
+            {
+                requests.add (new AsyncFileIO::Request());
+                expect (io.write (*requests.getLast(), static_cast <char*> (data.getData()) + i * blockSize,
+                                  (size_t) blockSize, (int64) i * blockSize, &listener));
+            }
+
+            io.waitForAllRequests();
+            expectEquals (listener.numRequests.get(), numBlocks);
+            expectEquals (listener.numBytes.get(), numBlocks * blockSize);
+            expect (io.flush().wasOk());
+            expectEquals (io.getFileSize(), (int64) data.getSize());
+        }
+
+        {
+            AsyncFileIO io (file, AsyncFileIO::readOnly | AsyncFileIO::sequentialAccess);
+            expect (io.openedOk());
+            io.prefetch (0, (int64) data.getSize());
+
+            MemoryBlock readBack (data.getSize());
+            OwnedArray<AsyncFileIO::Request> requests;
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                requests.add (new AsyncFileIO::Request());
+                expect (io.read (*requests.getLast(), static_cast <char*> (readBack.getData()) + i * blockSize,
+                                 (size_t) blockSize, (int64) i * blockSize));
+            }
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                AsyncFileIO::Request& request = *requests.getUnchecked (i);
+                expect (request.waitForCompletion());
+                expect (request.getResult().wasOk() && request.getNumBytesTransferred() == blockSize);
+            }
+
+            expect (readBack == data);
+
+            beginTest ("End of file");
+
+            char buffer [100];
+            AsyncFileIO::Request request;
+
+            expect (io.read (request, buffer, sizeof (buffer), (int64) data.getSize() - 40));
+            expect (request.waitForCompletion() && request.getResult().wasOk());
+            expectEquals (request.getNumBytesTransferred(), (int64) 40);
+            expect (memcmp (buffer, static_cast <const char*> (data.getData()) + data.getSize() - 40, 40) == 0);
+
+            expect (io.read (request, buffer, sizeof (buffer), (int64) data.getSize() + 1000));
+            expect (request.waitForCompletion());
+            expectEquals (request.getNumBytesTransferred(), (int64) 0);
+
+            expect (! io.write (request, buffer, sizeof (buffer), 0));
+        }
+
+        beginTest ("Direct I/O");
+
+        {
+            // (not all filesystems support direct I/O, so this only checks it if the file can be opened)
+            AsyncFileIO io (file, AsyncFileIO::readOnly | AsyncFileIO::directIO);
+
+            if (io.openedOk())
+            {
+                const size_t alignment = AsyncFileIO::getDirectIOAlignment();
+                HeapBlock<char> rawBuffer (alignment * 3);
+                char* const buffer = reinterpret_cast <char*> ((reinterpret_cast <pointer_sized_uint> (rawBuffer.getData()) + alignment - 1)
+                                                                 & ~(pointer_sized_uint) (alignment - 1));
+
+                AsyncFileIO::Request request;
+                expect (io.read (request, buffer, alignment * 2, (int64) alignment));
+                expect (request.waitForCompletion() && request.getResult().wasOk());
+                expect (memcmp (buffer, static_cast <const char*> (data.getData()) + alignment, alignment * 2) == 0);
+            }
+        }
+
+        expect (! AsyncFileIO (file.getSiblingFile ("nonexistent_asyncio_file")).openedOk());
+        file.deleteFile();
+    }
+};
+
+static AsyncFileIOTests asyncFileIOTests;
+
+#endif
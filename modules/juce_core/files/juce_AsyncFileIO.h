@@ -0,0 +1,287 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ASYNCFILEIO_JUCEHEADER__
+#define __JUCE_ASYNCFILEIO_JUCEHEADER__
+
+#include "juce_File.h"
+#include "../threads/juce_WaitableEvent.h"
+#include "../threads/juce_CriticalSection.h"
+
+
+//==============================================================================
+/**
+    Reads and writes a file asynchronously.
+
+    Rather than blocking the calling thread, each read or write is started with a Request
+    object and carried on in the background, and you can either have a Listener called when
+    it has finished, or wait for the Request to complete when you need its result. Any number of
+    requests can be running at once, so the OS can schedule them in whatever order suits
+    the disk best.
+
+    On Linux this uses io_uring when the kernel supports it, and on Windows it uses
+    overlapped I/O. Elsewhere (or if io_uring is unavailable), a small shared pool of
+    background threads performs the reads and writes.
+
+    @code
+    AsyncFileIO file (myFile, AsyncFileIO::readOnly | AsyncFileIO::sequentialAccess);
+
+    HeapBlock<char> buffer (65536);
+    AsyncFileIO::Request request;
+    file.read (request, buffer, 65536, 0);
+
+    // ...do something else while the data arrives...
+
+    if (request.waitForCompletion() && request.getResult().wasOk())
+        useTheData (buffer, (int) request.getNumBytesTransferred());
+    @endcode
+
+    @see AsyncFileInputStream, AsyncFileOutputStream
+*/
+class JUCE_API  AsyncFileIO
+{
+public:
+    //==============================================================================
+    /** Flags used when opening the file. */
+    enum OpenFlags
+    {
+        readOnly            = 0,    /**< Opens an existing file for reading. */
+        readWrite           = 1,    /**< Opens the file for reading and writing, creating it if it doesn't exist. */
+
+        directIO            = 2,    /**< Bypasses the OS's file cache, transferring data directly between the
+                                         disk and your buffers. This can be much faster for very large files that
+                                         would otherwise just fill the cache, but the buffers, sizes and file
+                                         positions of all requests must then be multiples of getDirectIOAlignment(). */
+
+        sequentialAccess    = 4,    /**< A hint that the file will mostly be read from start to end, so the OS should
+                                         read ahead of the requests aggressively. */
+        randomAccess        = 8     /**< A hint that the file will be read in a random order, so the OS shouldn't
+                                         bother reading ahead. */
+    };
+
+    /** Opens a file.
+        @param file     the file to open
+        @param flags    a combination of values from the OpenFlags enum
+        @see getStatus
+    */
+    AsyncFileIO (const File& file, int flags = readOnly);
+
+    /** Destructor.
+        If any requests are still running, this will wait for them to finish before
+        closing the file.
+    */
+    ~AsyncFileIO();
+
+    //==============================================================================
+    /** Returns the file that this object is using. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Returns the result of opening the file. */
+    const Result& getStatus() const noexcept            { return status; }
+
+    /** Returns true if the file was opened successfully. */
+    bool openedOk() const noexcept                      { return status.wasOk(); }
+
+    /** Returns the current size of the file in bytes, or -1 if it isn't open. */
+    int64 getFileSize() const;
+
+    //==============================================================================
+    class Request;
+
+    /** Receives a callback when a Request has finished.
+        @see AsyncFileIO::read, AsyncFileIO::write
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called when a request has finished, successfully or not.
+
+            This is called on a background thread that is shared with other requests,
+            so it should return quickly. It may start other requests, but must not start
+            a new one using the same Request object, or delete it - the request is only
+            treated as finished once this callback has returned.
+        */
+        virtual void asyncFileIORequestFinished (Request& request) = 0;
+    };
+
+    //==============================================================================
+    /**
+        Holds the state of one read or write.
+
+        A Request can be used for any number of reads and writes, one after another,
+        but only one at a time - it mustn't be reused or deleted while it's still pending.
+    */
+    class JUCE_API  Request
+    {
+    public:
+        /** Creates a request that isn't doing anything. */
+        Request();
+
+        /** Destructor.
+            This will wait for the request to finish if it's still pending.
+        */
+        ~Request();
+
+        /** Returns true if the request has been started and hasn't yet finished. */
+        bool isPending() const;
+
+        /** Waits for the request to finish.
+            @returns true if it has finished, or false if the timeout expired first
+        */
+        bool waitForCompletion (int timeOutMilliseconds = -1) const;
+
+        /** After the request has finished, this returns the number of bytes that were read
+            or written. A read that returns fewer bytes than were asked for has reached the
+            end of the file.
+        */
+        int64 getNumBytesTransferred() const noexcept       { return numBytesTransferred; }
+
+        /** After the request has finished, this says whether it succeeded. */
+        const Result& getResult() const noexcept            { return result; }
+
+        /** Returns the file position at which the request started. */
+        int64 getFilePosition() const noexcept              { return filePosition; }
+
+        /** Returns the number of bytes that the request was asked to read or write. */
+        size_t getNumBytesRequested() const noexcept        { return numBytesRequested; }
+
+        /** Returns the buffer that the request is reading into or writing from. */
+        void* getBuffer() const noexcept                    { return buffer; }
+
+        /** Returns true if the request is a write, or false for a read. */
+        bool isWrite() const noexcept                       { return isWriteRequest; }
+
+        /** A value that you can use to keep track of which request is which in a Listener callback. */
+        pointer_sized_int userData;
+
+    private:
+        friend class AsyncFileIO;
+
+        AsyncFileIO* owner;
+        Listener* listener;
+        void* buffer;
+        size_t numBytesRequested;
+        int64 filePosition, numBytesTransferred;
+        bool isWriteRequest;
+        Result result;
+        WaitableEvent finished;
+        pointer_sized_int platformData [8];
+
+        JUCE_DECLARE_NON_COPYABLE (Request)
+    };
+
+    //==============================================================================
+    /** Starts reading some data from the file.
+
+        The buffer must stay valid until the request has finished. If a listener is supplied,
+        it'll be called when the request finishes (see Listener::asyncFileIORequestFinished()),
+        and must not be deleted before then.
+
+        @returns false if the request couldn't be started, e.g. because the file isn't open,
+                 the request object is already in use, or the parameters aren't aligned correctly
+                 for a file that's using directIO
+    */
+    bool read (Request& request, void* destBuffer, size_t numBytes,
+               int64 filePosition, Listener* listener = nullptr);
+
+    /** Starts writing some data to the file.
+
+        The data must stay valid until the request has finished. If a listener is supplied,
+        it'll be called when the request finishes (see Listener::asyncFileIORequestFinished()),
+        and must not be deleted before then.
+
+        @returns false if the request couldn't be started, e.g. because the file isn't open for
+                 writing, the request object is already in use, or the parameters aren't aligned
+                 correctly for a file that's using directIO
+    */
+    bool write (Request& request, const void* sourceData, size_t numBytes,
+                int64 filePosition, Listener* listener = nullptr);
+
+    /** Waits for all the requests that are running to finish. */
+    void waitForAllRequests();
+
+    /** Makes sure that everything that has been written has reached the disk.
+        This doesn't wait for requests that are still running - call waitForAllRequests() first
+        if you need those to be included.
+    */
+    Result flush();
+
+    /** Changes the size of the file, cutting it short or extending it. */
+    Result setFileSize (int64 newSize);
+
+    /** Asks the filesystem to reserve space for the file to grow to the given size,
+        without changing its length.
+        @see FileOutputStream::preallocate
+    */
+    Result preallocate (int64 totalFileSize);
+
+    /** Tells the OS that a section of the file will be needed soon, so that it can start
+        loading it into its cache in the background. This is only a hint, and does nothing
+        on some platforms, or for files that are using directIO.
+    */
+    void prefetch (int64 startPosition, int64 numBytes);
+
+    //==============================================================================
+    /** Returns the alignment that buffers, sizes and file positions must have when
+        a file is opened with the directIO flag.
+    */
+    static size_t getDirectIOAlignment() noexcept       { return 4096; }
+
+    /** Returns true if requests are being performed by the OS's own asynchronous I/O
+        mechanism, or false if they're being run by background threads.
+    */
+    static bool isUsingNativeAsyncIO();
+
+private:
+    //==============================================================================
+    class Engine;
+    class ThreadedEngine;
+    class UringEngine;
+    class CompletionPortEngine;
+    friend class ThreadedEngine;
+    friend class UringEngine;
+    friend class CompletionPortEngine;
+
+    const File file;
+    const int flags;
+    Result status;
+    void* fileHandle;
+    Engine* engine;
+    bool hasPreallocated;
+    CriticalSection pendingLock;
+    int numPendingRequests;
+    WaitableEvent noRequestsPending;
+
+    void closeHandle();
+    bool startRequest (Request&, void*, size_t, int64, bool, Listener*);
+    static void requestFinished (Request&, int64 numBytesTransferred, const Result&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileIO)
+};
+
+#endif   // __JUCE_ASYNCFILEIO_JUCEHEADER__
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+AsyncFileInputStream::AsyncFileInputStream (const File& fileToRead,
+                                            const int blockSizeBytes,
+                                            const int numBlocksToReadAhead)
+    : file (fileToRead, AsyncFileIO::readOnly | AsyncFileIO::sequentialAccess),
+      status (file.getStatus()),
+      blockSize (jmax (16, blockSizeBytes)),
+      totalLength (jmax ((int64) 0, file.getFileSize())),
+      position (0)
+{
+    // (one block for the current position, plus the ones being read ahead)
+    for (int i = jmax (0, numBlocksToReadAhead) + 1; --i >= 0;)
+    {
+        Block* const b = new Block();
+        b->data.malloc ((size_t) blockSize);
+        b->blockNumber = -1;
+        blocks.add (b);
+    }
+}
+
+AsyncFileInputStream::~AsyncFileInputStream()
+{
+    file.waitForAllRequests();
+}
+
+int64 AsyncFileInputStream::getTotalLength()
+{
+    return totalLength;
+}
+
+bool AsyncFileInputStream::isExhausted()
+{
+    return position >= totalLength;
+}
+
+int64 AsyncFileInputStream::getPosition()
+{
+    return position;
+}
+
+bool AsyncFileInputStream::setPosition (const int64 pos)
+{
+    position = jlimit ((int64) 0, totalLength, pos);
+    return true;
+}
+
+AsyncFileInputStream::Block& AsyncFileInputStream::startReading (const int64 blockNumber)
+{
+    Block& b = *blocks.getUnchecked ((int) (blockNumber % blocks.size()));
+
+    if (b.blockNumber != blockNumber)
+    {
+        // (if the block was being used for a different part of the file, that read has to finish first)
+        b.request.waitForCompletion();
+        b.blockNumber = blockNumber;
+
+        if (! file.read (b.request, b.data, (size_t) blockSize, blockNumber * blockSize))
+            b.blockNumber = -1;
+    }
+
+    return b;
+}
+
+int AsyncFileInputStream::read (void* const destBuffer, const int maxBytesToRead)
+{
+    jassert (destBuffer != nullptr && maxBytesToRead >= 0);
+
+    char* dest = static_cast <char*> (destBuffer);
+    int numRead = 0;
+
+    while (numRead < maxBytesToRead && position < totalLength && status.wasOk())
+    {
+        const int64 blockNumber = position / blockSize;
+        Block& b = startReading (blockNumber);
+
+        for (int i = 1; i < blocks.size() && (blockNumber + i) * blockSize < totalLength; ++i)
+            startReading (blockNumber + i);
+
+        if (b.blockNumber != blockNumber)
+        {
+            status = Result::fail ("Couldn't read from the file");
+            break;
+        }
+
+        b.request.waitForCompletion();
+
+        if (b.request.getResult().failed())
+        {
+            status = b.request.getResult();
+            break;
+        }
+
+        const int offset = (int) (position - blockNumber * blockSize);
+        const int numToCopy = jmin (maxBytesToRead - numRead, (int) b.request.getNumBytesTransferred() - offset);
+
+        if (numToCopy <= 0)
+            break;  // (the file must have got shorter)
+
+        memcpy (dest, b.data + offset, (size_t) numToCopy);
+        dest += numToCopy;
+        numRead += numToCopy;
+        position += numToCopy;
+    }
+
+    return numRead;
+}
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ASYNCFILEINPUTSTREAM_JUCEHEADER__
+#define __JUCE_ASYNCFILEINPUTSTREAM_JUCEHEADER__
+
+#include "juce_AsyncFileIO.h"
+#include "../streams/juce_InputStream.h"
+#include "../containers/juce_OwnedArray.h"
+
+
+//==============================================================================
+/**
+    An input stream that reads ahead from a local file in the background.
+
+    The file is read in blocks, and whenever the stream reads from one block, it starts
+    reading the next few in the background using AsyncFileIO. When the data is read in order,
+    it's usually already waiting in memory by the time it's needed, so the caller rarely has
+    to wait for the disk.
+
+    That makes it a good choice for the stream given to an AudioFormatReader that's wrapped in
+    a BufferingAudioReader, or anything else that streams through a file from one end to the other.
+
+    @see FileInputStream, AsyncFileOutputStream, AsyncFileIO
+*/
+class JUCE_API  AsyncFileInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates an AsyncFileInputStream.
+
+        @param fileToRead               the file to read from - if the file can't be accessed for some
+                                        reason, then the stream will just contain no data
+        @param blockSizeBytes           the size of the blocks in which the file is read
+        @param numBlocksToReadAhead     how many blocks beyond the current position to read ahead of time
+    */
+    AsyncFileInputStream (const File& fileToRead,
+                          int blockSizeBytes = 64 * 1024,
+                          int numBlocksToReadAhead = 4);
+
+    /** Destructor. */
+    ~AsyncFileInputStream();
+
+    //==============================================================================
+    /** Returns the file that this stream is reading from. */
+    const File& getFile() const noexcept                { return file.getFile(); }
+
+    /** Returns the status of the stream.
+        The result will be ok if the file opened successfully. If an error occurs while
+        opening or reading from the file, this will contain an error message.
+    */
+    const Result& getStatus() const noexcept            { return status; }
+
+    /** Returns true if the stream couldn't be opened for some reason. */
+    bool failedToOpen() const noexcept                  { return ! file.openedOk(); }
+
+    /** Returns true if the stream opened without problems. */
+    bool openedOk() const noexcept                      { return file.openedOk(); }
+
+    //==============================================================================
+    int64 getTotalLength();
+    int read (void* destBuffer, int maxBytesToRead);
+    bool isExhausted();
+    int64 getPosition();
+    bool setPosition (int64 pos);
+
+private:
+    //==============================================================================
+    struct Block
+    {
+        HeapBlock <char> data;
+        AsyncFileIO::Request request;
+        int64 blockNumber;
+    };
+
+    AsyncFileIO file;
+    Result status;
+    OwnedArray <Block> blocks;
+    const int blockSize;
+    int64 totalLength, position;
+
+    Block& startReading (int64 blockNumber);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileInputStream)
+};
+
+#endif   // __JUCE_ASYNCFILEINPUTSTREAM_JUCEHEADER__
@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+AsyncFileOutputStream::AsyncFileOutputStream (const File& fileToWriteTo,
+                                              const int bufferSizeBytes,
+                                              const int numBuffers)
+    : file (fileToWriteTo, AsyncFileIO::readWrite),
+      status (file.getStatus()),
+      bufferSize (jmax (16, bufferSizeBytes)),
+      currentBuffer (0),
+      numBytesInBuffer (0),
+      bufferPosition (jmax ((int64) 0, file.getFileSize()))
+{
+    for (int i = jmax (2, numBuffers); --i >= 0;)
+    {
+        Buffer* const b = new Buffer();
+        b->data.malloc ((size_t) bufferSize);
+        buffers.add (b);
+    }
+}
+
+AsyncFileOutputStream::~AsyncFileOutputStream()
+{
+    flush();
+}
+
+int64 AsyncFileOutputStream::getPosition()
+{
+    return bufferPosition + numBytesInBuffer;
+}
+
+bool AsyncFileOutputStream::checkResult (const AsyncFileIO::Request& request)
+{
+    if (request.getResult().failed())
+        status = request.getResult();
+    else if (request.getNumBytesTransferred() != (int64) request.getNumBytesRequested())
+        status = Result::fail ("Couldn't write all the data to the file");
+
+    return status.wasOk();
+}
+
+bool AsyncFileOutputStream::writeCurrentBuffer()
+{
+    if (numBytesInBuffer == 0)
+        return status.wasOk();
+
+    Buffer& b = *buffers.getUnchecked (currentBuffer);
+
+    if (! file.write (b.request, b.data, (size_t) numBytesInBuffer, bufferPosition))
+        status = Result::fail ("Couldn't write to the file");
+
+    bufferPosition += numBytesInBuffer;
+    numBytesInBuffer = 0;
+
+    // move on to the next buffer, waiting for it to finish being written if it's still busy
+    currentBuffer = (currentBuffer + 1) % buffers.size();
+    Buffer& next = *buffers.getUnchecked (currentBuffer);
+    next.request.waitForCompletion();
+
+    return checkResult (next.request);
+}
+
+bool AsyncFileOutputStream::waitForAllWrites()
+{
+    file.waitForAllRequests();
+
+    for (int i = 0; i < buffers.size(); ++i)
+        checkResult (buffers.getUnchecked (i)->request);
+
+    return status.wasOk();
+}
+
+bool AsyncFileOutputStream::setPosition (const int64 newPosition)
+{
+    if (newPosition == getPosition())
+        return true;
+
+    // (any writes that are still running have to finish first, in case the next ones overlap them)
+    writeCurrentBuffer();
+    waitForAllWrites();
+
+    bufferPosition = newPosition;
+    return status.wasOk();
+}
+
+bool AsyncFileOutputStream::write (const void* const data, size_t numBytes)
+{
+    jassert (data != nullptr && ((ssize_t) numBytes) >= 0);
+
+    if (! file.openedOk())
+        return false;
+
+    const char* source = static_cast <const char*> (data);
+
+    while (numBytes > 0)
+    {
+        const int numToCopy = (int) jmin (numBytes, (size_t) (bufferSize - numBytesInBuffer));
+        memcpy (buffers.getUnchecked (currentBuffer)->data + numBytesInBuffer, source, (size_t) numToCopy);
+        numBytesInBuffer += numToCopy;
+        source += numToCopy;
+        numBytes -= (size_t) numToCopy;
+
+        if (numBytesInBuffer == bufferSize && ! writeCurrentBuffer())
+            return false;
+    }
+
+    return status.wasOk();
+}
+
+Result AsyncFileOutputStream::preallocate (const int64 totalFileSize)
+{
+    return file.preallocate (totalFileSize);
+}
+
+void AsyncFileOutputStream::flush()
+{
+    if (file.openedOk())
+    {
+        writeCurrentBuffer();
+
+        if (waitForAllWrites())
+        {
+            const Result result (file.flush());
+
+            if (result.failed())
+                status = result;
+        }
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AsyncFileStreamTests  : public UnitTest
+{
+public:
+    AsyncFileStreamTests()  : UnitTest ("AsyncFile streams") {}
+
+    void runTest()
+    {
+        beginTest ("Writing");
+
+        const File file (File::createTempFile ("asyncstream"));
+        Random rng;
+        MemoryOutputStream expected;
+
+        {
+            AsyncFileOutputStream out (file, 1000 + rng.nextInt (5000), 3);
+            expect (out.openedOk());
+
+            for (int i = 0; i < 500; ++i)
+            {
+                MemoryBlock chunk ((size_t) rng.nextInt (3000));
+
+                for (size_t j = 0; j < chunk.getSize(); ++j)
+                    chunk[(int) j] = (char) rng.nextInt (256);
+
+                expect (out.write (chunk.getData(), chunk.getSize()));
+                expected << chunk;
+            }
+
+            expectEquals (out.getPosition(), (int64) expected.getDataSize());
+
+            // overwrite a header at the start, as a file format writer might do
+            expect (out.setPosition (0));
+            out.writeInt (0x12345678);
+            expect (out.setPosition ((int64) expected.getDataSize()));
+            out.writeInt (0x7654321);
+        }
+
+        expected.setPosition (0);
+        expected.writeInt (0x12345678);
+        expected.setPosition ((int64) expected.getDataSize());
+        expected.writeInt (0x7654321);
+
+        MemoryBlock fileData;
+        expect (file.loadFileAsData (fileData));
+        expect (fileData == expected.getMemoryBlock());
+
+        {
+            AsyncFileOutputStream out (file);
+            expectEquals (out.getPosition(), (int64) expected.getDataSize());
+        }
+
+        beginTest ("Reading");
+
+        {
+            AsyncFileInputStream in (file, 4096, 3);
+            expect (in.openedOk());
+            expectEquals (in.getTotalLength(), (int64) fileData.getSize());
+
+            MemoryOutputStream result;
+            result.writeFromInputStream (in, -1);
+            expect (result.getMemoryBlock() == fileData);
+            expect (in.isExhausted());
+
+            for (int i = 0; i < 200; ++i)
+            {
+                const int64 pos = rng.nextInt ((int) fileData.getSize());
+                expect (in.setPosition (pos));
+
+                char buffer [5000];
+                const int numWanted = rng.nextInt (5000);
+                const int num = in.read (buffer, numWanted);
+                expectEquals (num, (int) jmin ((int64) numWanted, (int64) fileData.getSize() - pos));
+                expect (memcmp (buffer, static_cast <const char*> (fileData.getData()) + pos, (size_t) num) == 0);
+                expectEquals (in.getPosition(), pos + num);
+            }
+        }
+
+        file.deleteFile();
+    }
+};
+
+static AsyncFileStreamTests asyncFileStreamTests;
+
+#endif
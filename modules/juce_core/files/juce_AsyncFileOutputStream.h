@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ASYNCFILEOUTPUTSTREAM_JUCEHEADER__
+#define __JUCE_ASYNCFILEOUTPUTSTREAM_JUCEHEADER__
+
+#include "juce_AsyncFileIO.h"
+#include "../streams/juce_OutputStream.h"
+#include "../containers/juce_OwnedArray.h"
+
+
+//==============================================================================
+/**
+    An output stream that writes into a local file in the background.
+
+    The data is collected into a set of buffers, and whenever one fills up, it's written to
+    the file using AsyncFileIO while the next one is being filled. So the caller only has to
+    wait for the disk if it produces data faster than the disk can write it for long enough
+    to fill all the buffers.
+
+    That makes it a good choice for the stream given to an AudioFormatWriter which is used by an
+    AudioFormatWriter::ThreadedWriter, so that when lots of writers share the same background
+    thread, one slow disk write doesn't hold up all the others.
+
+    @see FileOutputStream, AsyncFileInputStream, AsyncFileIO
+*/
+class JUCE_API  AsyncFileOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates an AsyncFileOutputStream.
+
+        If the file doesn't exist, it will first be created. If it already exists, the
+        stream's write-position will be set to the end of the file, as it is for a
+        FileOutputStream.
+
+        @param fileToWriteTo    the file to write to
+        @param bufferSizeBytes  the size of each of the buffers
+        @param numBuffers       the number of buffers to use - this is how many writes can be
+                                in progress at once, while the stream is still accepting data
+    */
+    AsyncFileOutputStream (const File& fileToWriteTo,
+                           int bufferSizeBytes = 256 * 1024,
+                           int numBuffers = 4);
+
+    /** Destructor.
+        This writes any remaining data and waits for it to reach the disk.
+    */
+    ~AsyncFileOutputStream();
+
+    //==============================================================================
+    /** Returns the file that this stream is writing to. */
+    const File& getFile() const noexcept                { return file.getFile(); }
+
+    /** Returns the status of the stream.
+        The result will be ok if the file opened successfully. If an error occurs while
+        opening or writing to the file, this will contain an error message.
+    */
+    const Result& getStatus() const noexcept            { return status; }
+
+    /** Returns true if the stream couldn't be opened for some reason. */
+    bool failedToOpen() const noexcept                  { return ! file.openedOk(); }
+
+    /** Returns true if the stream opened without problems. */
+    bool openedOk() const noexcept                      { return file.openedOk(); }
+
+    //==============================================================================
+    /** Writes any buffered data, waits until all of it has been written, and then
+        makes sure it has reached the disk.
+    */
+    void flush();
+
+    /** Asks the filesystem to reserve space for the file to grow to the given size,
+        without changing its length.
+        @see FileOutputStream::preallocate
+    */
+    Result preallocate (int64 totalFileSize);
+
+    int64 getPosition();
+    bool setPosition (int64 pos);
+    bool write (const void* data, size_t numBytes);
+
+private:
+    //==============================================================================
+    struct Buffer
+    {
+        HeapBlock <char> data;
+        AsyncFileIO::Request request;
+    };
+
+    AsyncFileIO file;
+    Result status;
+    OwnedArray <Buffer> buffers;
+    const int bufferSize;
+    int currentBuffer, numBytesInBuffer;
+    int64 bufferPosition;
+
+    bool writeCurrentBuffer();
+    bool waitForAllWrites();
+    bool checkResult (const AsyncFileIO::Request&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileOutputStream)
+};
+
+#endif   // __JUCE_ASYNCFILEOUTPUTSTREAM_JUCEHEADER__
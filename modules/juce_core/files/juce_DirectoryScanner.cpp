@@ -0,0 +1,547 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+DirectoryScanner::Entry::Entry() noexcept
+    : fileSize (0), isDirectory (false), isHidden (false)
+{
+}
+
+//==============================================================================
+// The contents of a single directory, as read from the OS. Listings can be shared between
+// searches when they're held in the cache.
+class DirectoryScanner::Listing  : public ReferenceCountedObject
+{
+public:
+    Listing (const String& path_) : path (path_) {}
+
+    void read()
+    {
+        DirectoryIterator iter (File::createFileWithoutCheckingPath (path), false, "*", File::findFilesAndDirectories);
+        Item item;
+
+        while (iter.next (&item.isDirectory, &item.isHidden, &item.fileSize, &item.modificationTime, nullptr, nullptr))
+        {
+            item.name = iter.getFile().getFileName();
+            items.add (item);
+        }
+    }
+
+    struct Item
+    {
+        Item() noexcept : fileSize (0), isDirectory (false), isHidden (false) {}
+
+        String name;
+        int64 fileSize;
+        Time modificationTime;
+        bool isDirectory, isHidden;
+    };
+
+    typedef ReferenceCountedObjectPtr<Listing> Ptr;
+
+    const String path;  // (with a trailing separator)
+    Array<Item> items;
+    Ptr nextWithSameWatch;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Listing)
+};
+
+//==============================================================================
+// Keeps the cached listings, and the watches that tell it when they've become out of date.
+class DirectoryScanner::ChangeMonitor
+{
+public:
+    ChangeMonitor()
+       #if JUCE_LINUX
+        : fd (inotify_init1 (IN_NONBLOCK | IN_CLOEXEC))
+       #endif
+    {
+    }
+
+    ~ChangeMonitor()
+    {
+       #if JUCE_LINUX
+        if (fd >= 0)
+            close (fd);
+       #endif
+    }
+
+    bool isOk() const noexcept
+    {
+       #if JUCE_LINUX
+        return fd >= 0;
+       #else
+        return false;
+       #endif
+    }
+
+    // Throws away any listings that have changed since the last time this was called.
+    void processChanges()
+    {
+       #if JUCE_LINUX
+        int64 buffer [1024];
+
+        for (;;)
+        {
+            const ssize_t numBytes = ::read (fd, buffer, sizeof (buffer));
+
+            if (numBytes <= 0)
+                break;
+
+            for (ssize_t pos = 0; pos + (ssize_t) sizeof (struct inotify_event) <= numBytes;)
+            {
+                const struct inotify_event* const e = reinterpret_cast <const struct inotify_event*> (addBytesToPointer (buffer, pos));
+
+                if ((e->mask & IN_Q_OVERFLOW) != 0)
+                    clear();  // (if the kernel has lost track of some changes, nothing can be trusted)
+                else
+                    invalidate (e->wd);
+
+                pos += (ssize_t) sizeof (struct inotify_event) + (ssize_t) e->len;
+            }
+        }
+       #endif
+    }
+
+    Listing::Ptr getListing (const String& path) const
+    {
+        const ScopedLock sl (lock);
+        return listings [path];
+    }
+
+    // This must be called before the listing is read, so that any changes made while
+    // it's being read will be noticed next time.
+    void startWatching (Listing* const listing)
+    {
+       #if JUCE_LINUX
+        const int wd = inotify_add_watch (fd, listing->path.toUTF8(),
+                                          IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO
+                                            | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+
+        if (wd >= 0)
+        {
+            const ScopedLock sl (lock);
+
+            // (the same directory can be reached by more than one path, in which case they'll share a watch)
+            listing->nextWithSameWatch = watches [wd];
+            watches.set (wd, listing);
+            listings.set (listing->path, listing);
+        }
+       #else
+        (void) listing;
+       #endif
+    }
+
+    void clear()
+    {
+        const ScopedLock sl (lock);
+
+       #if JUCE_LINUX
+        for (FlatHashMap<int, Listing::Ptr>::Iterator i (watches); i.next();)
+            inotify_rm_watch (fd, i.getKey());
+       #endif
+
+        for (FlatHashMap<String, Listing::Ptr>::Iterator i (listings); i.next();)
+            i.getValue()->nextWithSameWatch = nullptr;
+
+        watches.clear();
+        listings.clear();
+    }
+
+    int getNumListings() const
+    {
+        const ScopedLock sl (lock);
+        return listings.size();
+    }
+
+private:
+   #if JUCE_LINUX
+    int fd;
+   #endif
+    FlatHashMap<int, Listing::Ptr> watches;
+    FlatHashMap<String, Listing::Ptr> listings;
+    CriticalSection lock;
+
+    void invalidate (const int wd)
+    {
+        const ScopedLock sl (lock);
+
+        for (Listing::Ptr l (watches [wd]); l != nullptr;)
+        {
+            if (listings [l->path] == l)
+                listings.remove (l->path);
+
+            const Listing::Ptr next (l->nextWithSameWatch);
+            l->nextWithSameWatch = nullptr;
+            l = next;
+        }
+
+        watches.remove (wd);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ChangeMonitor)
+};
+
+//==============================================================================
+// A directory in the tree being searched, and the subdirectories inside it that will be searched too.
+class DirectoryScanner::Node
+{
+public:
+    Node (Search& search_, const String& path_)
+        : search (search_), path (File::addTrailingSeparator (path_))
+    {
+    }
+
+    Search& search;
+    const String path;
+    Listing::Ptr listing;
+    OwnedArray<Node> children;  // (in the same order as they appear in the listing)
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Node)
+};
+
+//==============================================================================
+class DirectoryScanner::Search
+{
+public:
+    Search (DirectoryScanner& owner_, const int whatToLookFor_, const bool isRecursive_, const String& pattern)
+        : owner (owner_), whatToLookFor (whatToLookFor_), isRecursive (isRecursive_), pool (nullptr)
+    {
+        wildCards.addTokens (pattern, ";,", "\"'");
+        wildCards.trim();
+        wildCards.removeEmptyStrings();
+
+        // you have to specify the type of files you're looking for!
+        jassert ((whatToLookFor & (File::findFiles | File::findDirectories)) != 0);
+        jassert (whatToLookFor > 0 && whatToLookFor <= 7);
+    }
+
+    int run (Array<Entry>& results, const File& directory)
+    {
+        Node root (*this, directory.getFullPathName());
+
+        if (owner.numThreads > 1 && isRecursive)
+        {
+            ThreadPool threadPool (owner.numThreads);
+            pool = &threadPool;
+            numJobsRemaining = 1;
+
+            threadPool.addJob (&readNodeJob, &root);
+            allJobsFinished.wait();
+        }
+        else
+        {
+            readNode (root);
+        }
+
+        const int numBefore = results.size();
+        addResults (root, results);
+        return results.size() - numBefore;
+    }
+
+private:
+    DirectoryScanner& owner;
+    const int whatToLookFor;
+    const bool isRecursive;
+    StringArray wildCards;
+    ThreadPool* pool;
+    Atomic<int> numJobsRemaining;
+    WaitableEvent allJobsFinished;
+
+    bool shouldSearchInside (const Listing::Item& item) const noexcept
+    {
+        return isRecursive && item.isDirectory
+                 && ((whatToLookFor & File::ignoreHiddenFiles) == 0 || ! item.isHidden);
+    }
+
+    bool matches (const Listing::Item& item) const
+    {
+        if ((whatToLookFor & (item.isDirectory ? File::findDirectories : File::findFiles)) == 0)
+            return false;
+
+        if ((whatToLookFor & File::ignoreHiddenFiles) != 0 && item.isHidden)
+            return false;
+
+        for (int i = 0; i < wildCards.size(); ++i)
+            if (item.name.matchesWildcard (wildCards[i], ! File::areFileNamesCaseSensitive()))
+                return true;
+
+        return false;
+    }
+
+    void readNode (Node& node)
+    {
+        ChangeMonitor* const monitor = owner.changeMonitor;
+
+        if (monitor != nullptr)
+            node.listing = monitor->getListing (node.path);
+
+        if (node.listing == nullptr)
+        {
+            node.listing = new Listing (node.path);
+
+            if (monitor != nullptr)
+                monitor->startWatching (node.listing);
+
+            node.listing->read();
+        }
+
+        const Array<Listing::Item>& items = node.listing->items;
+
+        for (int i = 0; i < items.size(); ++i)
+            if (shouldSearchInside (items.getReference (i)))
+                node.children.add (new Node (*this, node.path + items.getReference (i).name));
+
+        if (pool == nullptr)
+        {
+            for (int i = 0; i < node.children.size(); ++i)
+                readNode (*node.children.getUnchecked (i));
+        }
+        else
+        {
+            numJobsRemaining += node.children.size();
+
+            for (int i = 0; i < node.children.size(); ++i)
+                pool->addJob (&readNodeJob, node.children.getUnchecked (i));
+        }
+    }
+
+    static void readNodeJob (void* userData)
+    {
+        Node& node = *static_cast <Node*> (userData);
+        Search& search = node.search;
+
+        search.readNode (node);
+
+        if (--search.numJobsRemaining == 0)
+            search.allJobsFinished.signal();
+    }
+
+    // The results are gathered up in the same order that a DirectoryIterator would find them,
+    // so that it doesn't matter which order the threads happened to read the directories in.
+    void addResults (const Node& node, Array<Entry>& results) const
+    {
+        const Array<Listing::Item>& items = node.listing->items;
+        int childIndex = 0;
+
+        for (int i = 0; i < items.size(); ++i)
+        {
+            const Listing::Item& item = items.getReference (i);
+
+            if (matches (item))
+            {
+                Entry e;
+                e.file = File::createFileWithoutCheckingPath (node.path + item.name);
+                e.fileSize = item.fileSize;
+                e.modificationTime = item.modificationTime;
+                e.isDirectory = item.isDirectory;
+                e.isHidden = item.isHidden;
+                results.add (e);
+            }
+
+            if (shouldSearchInside (item))
+                addResults (*node.children.getUnchecked (childIndex++), results);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Search)
+};
+
+//==============================================================================
+DirectoryScanner::DirectoryScanner (const int numThreads_)
+    : numThreads (numThreads_)
+{
+}
+
+DirectoryScanner::~DirectoryScanner()
+{
+}
+
+int DirectoryScanner::findChildFiles (Array<Entry>& results, const File& directory,
+                                      const int whatToLookFor, const bool searchRecursively,
+                                      const String& wildCardPattern)
+{
+    const ScopedLock sl (searchLock);
+
+    if (changeMonitor != nullptr)
+        changeMonitor->processChanges();
+
+    Search search (*this, whatToLookFor, searchRecursively, wildCardPattern);
+    return search.run (results, directory);
+}
+
+bool DirectoryScanner::setCachingEnabled (const bool shouldCacheContents)
+{
+    const ScopedLock sl (searchLock);
+
+    if (shouldCacheContents != isCachingEnabled())
+    {
+        changeMonitor = nullptr;
+
+        if (shouldCacheContents)
+        {
+            changeMonitor = new ChangeMonitor();
+
+            if (! changeMonitor->isOk())
+                changeMonitor = nullptr;
+        }
+    }
+
+    return isCachingEnabled();
+}
+
+bool DirectoryScanner::isCachingEnabled() const noexcept
+{
+    return changeMonitor != nullptr;
+}
+
+void DirectoryScanner::clearCache()
+{
+    const ScopedLock sl (searchLock);
+
+    if (changeMonitor != nullptr)
+        changeMonitor->clear();
+}
+
+int DirectoryScanner::getNumCachedDirectories() const
+{
+    const ScopedLock sl (searchLock);
+
+    if (changeMonitor == nullptr)
+        return 0;
+
+    changeMonitor->processChanges();
+    return changeMonitor->getNumListings();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class DirectoryScannerTests  : public UnitTest
+{
+public:
+    DirectoryScannerTests() : UnitTest ("DirectoryScanner") {}
+
+    static void createTree (const File& folder, Random& r, const int depth)
+    {
+        folder.createDirectory();
+
+        for (int i = r.nextInt (6); --i >= 0;)
+            folder.getChildFile ("file" + String (i) + (r.nextBool() ? ".txt" : ".dat"))
+                  .replaceWithText (String::repeatedString ("x", r.nextInt (100)));
+
+        folder.getChildFile (".hidden").create();
+
+        if (depth > 0)
+            for (int i = r.nextInt (4); --i >= 0;)
+                createTree (folder.getChildFile ((i == 0 ? ".folder" : "folder") + String (i)), r, depth - 1);
+    }
+
+    void checkMatchesIterator (DirectoryScanner& scanner, const File& root, const int whatToLookFor,
+                               const bool recursive, const String& pattern)
+    {
+        Array<File> expected;
+        root.findChildFiles (expected, whatToLookFor, recursive, pattern);
+
+        Array<DirectoryScanner::Entry> results;
+        expectEquals (scanner.findChildFiles (results, root, whatToLookFor, recursive, pattern), expected.size());
+        expectEquals (results.size(), expected.size());
+
+        bool allMatch = true;
+
+        for (int i = 0; i < jmin (results.size(), expected.size()); ++i)
+        {
+            const DirectoryScanner::Entry& e = results.getReference (i);
+
+            allMatch = allMatch && e.file == expected.getReference (i)
+                                && e.isDirectory == e.file.isDirectory()
+                                && (e.isDirectory || e.fileSize == e.file.getSize());
+        }
+
+        expect (allMatch);
+    }
+
+    void runTest()
+    {
+        const File root (File::createTempFile ("scannertest"));
+        Random r (1234);
+        createTree (root, r, 4);
+        createTree (root.getChildFile ("folder9"), r, 2);
+
+        beginTest ("Searching");
+
+        for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+        {
+            DirectoryScanner scanner (numThreads);
+
+            checkMatchesIterator (scanner, root, File::findFiles, true, "*");
+            checkMatchesIterator (scanner, root, File::findFilesAndDirectories, true, "*");
+            checkMatchesIterator (scanner, root, File::findDirectories | File::ignoreHiddenFiles, true, "*");
+            checkMatchesIterator (scanner, root, File::findFiles, true, "*.txt;*.dat");
+            checkMatchesIterator (scanner, root, File::findFilesAndDirectories, false, "*");
+        }
+
+        beginTest ("Caching");
+
+        DirectoryScanner scanner;
+
+        if (scanner.setCachingEnabled (true))
+        {
+            Array<DirectoryScanner::Entry> results;
+            scanner.findChildFiles (results, root, File::findFilesAndDirectories, true);
+
+            int numDirectories = 1;
+            for (int i = 0; i < results.size(); ++i)
+                if (results.getReference (i).isDirectory)
+                    ++numDirectories;
+
+            expectEquals (scanner.getNumCachedDirectories(), numDirectories);
+            checkMatchesIterator (scanner, root, File::findFilesAndDirectories, true, "*");
+
+            const File folder (root.getChildFile ("folder9"));
+            folder.getChildFile ("newfile").replaceWithText ("1234");
+            expectEquals (scanner.getNumCachedDirectories(), numDirectories - 1);
+            checkMatchesIterator (scanner, root, File::findFilesAndDirectories, true, "*");
+
+            folder.getChildFile ("newfile").appendText ("5678");
+            expectEquals (scanner.getNumCachedDirectories(), numDirectories - 1);
+            checkMatchesIterator (scanner, root, File::findFiles, true, "newfile");
+
+            scanner.clearCache();
+            expectEquals (scanner.getNumCachedDirectories(), 0);
+            checkMatchesIterator (scanner, root, File::findFilesAndDirectories, true, "*");
+
+            scanner.setCachingEnabled (false);
+            expect (! scanner.isCachingEnabled());
+        }
+
+        root.deleteRecursively();
+    }
+};
+
+static DirectoryScannerTests directoryScannerTests;
+
+#endif
@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_DIRECTORYSCANNER_JUCEHEADER__
+#define __JUCE_DIRECTORYSCANNER_JUCEHEADER__
+
+#include "juce_File.h"
+#include "../containers/juce_OwnedArray.h"
+#include "../memory/juce_ScopedPointer.h"
+#include "../threads/juce_CriticalSection.h"
+
+
+//==============================================================================
+/**
+    Searches a whole tree of directories using several threads at once.
+
+    This finds the same files as File::findChildFiles() or a DirectoryIterator, and returns
+    them in the same order, but each subdirectory that it finds is handed to a ThreadPool
+    to be read, so on a large tree (and particularly on a network drive or an SSD, where
+    many requests can be in flight at once) it finishes much more quickly.
+
+    The size, modification time and other details of each file are returned along with it,
+    using whatever information the OS provides while reading the directory, so there's no
+    need to look each file up again afterwards.
+
+    If caching is turned on with setCachingEnabled(), the scanner also remembers the contents
+    of each directory it reads, and watches them for changes. When the same tree is scanned
+    again, only the directories that have changed since the last scan need to be read again.
+
+    e.g. @code
+    DirectoryScanner scanner;
+    Array<DirectoryScanner::Entry> results;
+
+    scanner.findChildFiles (results, File ("/samples"), File::findFiles, true, "*.wav");
+
+    for (int i = 0; i < results.size(); ++i)
+        totalSize += results.getReference(i).fileSize;
+    @endcode
+
+    @see DirectoryIterator, File::findChildFiles
+*/
+class JUCE_API  DirectoryScanner
+{
+public:
+    //==============================================================================
+    /** Creates a scanner.
+
+        @param numThreads   the number of threads to use to read the directories. If this is 1
+                            or less, the directories are all read on the calling thread.
+    */
+    explicit DirectoryScanner (int numThreads = 4);
+
+    /** Destructor. */
+    ~DirectoryScanner();
+
+    //==============================================================================
+    /** Holds the details of a file that was found by a DirectoryScanner. */
+    struct JUCE_API  Entry
+    {
+        Entry() noexcept;
+
+        /** The file that was found. */
+        File file;
+
+        /** The size of the file, in bytes. */
+        int64 fileSize;
+
+        /** The time at which the file was last modified. */
+        Time modificationTime;
+
+        /** True if this is a directory rather than a file. */
+        bool isDirectory;
+
+        /** True if the file is hidden. */
+        bool isHidden;
+    };
+
+    /** Searches a directory for files that match a wildcard pattern.
+
+        This takes the same parameters as File::findChildFiles(), and finds the same files
+        in the same order. It blocks until the whole search is complete.
+
+        @param results              an array to which the entries that are found will be added
+        @param directory            the directory to search
+        @param whatToLookFor        a value from the File::TypesOfFileToFind enum
+        @param searchRecursively    if true, all the subdirectories will be searched too
+        @param wildCardPattern      the filename pattern to match - this may contain several
+                                    patterns separated by a semi-colon or comma
+        @returns the number of entries that were added to the results array
+    */
+    int findChildFiles (Array<Entry>& results,
+                        const File& directory,
+                        int whatToLookFor,
+                        bool searchRecursively,
+                        const String& wildCardPattern = "*");
+
+    //==============================================================================
+    /** Turns the cache of directory contents on or off.
+
+        While caching is enabled, the contents of each directory that is read are kept, and
+        the directory is watched for changes (on Linux, this uses inotify). A later search
+        that covers the same directory will re-use its contents unless something inside it has
+        changed - a file being created, deleted, renamed, written to or having its attributes
+        changed will all cause the directory to be read again.
+
+        Each directory that's watched uses one of the user's inotify watches, which are limited
+        by the system (see /proc/sys/fs/inotify/max_user_watches). If no more watches can be
+        added, then any further directories simply aren't cached.
+
+        Turning caching off clears the cache.
+
+        @returns true if caching is now enabled. This will be false if you try to enable it on
+                 a platform where there's no way of being told about changes to the directories,
+                 in which case every search reads all the directories again.
+    */
+    bool setCachingEnabled (bool shouldCacheContents);
+
+    /** Returns true if caching has been enabled with setCachingEnabled(). */
+    bool isCachingEnabled() const noexcept;
+
+    /** Throws away all the cached directory contents. */
+    void clearCache();
+
+    /** Returns the number of directories whose contents are in the cache and still valid. */
+    int getNumCachedDirectories() const;
+
+private:
+    //==============================================================================
+    class Listing;
+    class Node;
+    class Search;
+    class ChangeMonitor;
+    friend class Search;
+
+    const int numThreads;
+    ScopedPointer<ChangeMonitor> changeMonitor;
+    CriticalSection searchLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DirectoryScanner)
+};
+
+#endif   // __JUCE_DIRECTORYSCANNER_JUCEHEADER__
@@ -33,7 +33,8 @@ FileOutputStream::FileOutputStream (const File& f, const int bufferSize_)
       currentPosition (0),
       bufferSize (bufferSize_),
       bytesInBuffer (0),
-      buffer ((size_t) jmax (bufferSize_, 16))
+      buffer ((size_t) jmax (bufferSize_, 16)),
+      hasPreallocated (false)
 {
     openHandle();
 }
@@ -86,6 +86,17 @@ public:
     */
     Result truncate();
 
+    /** Asks the filesystem to reserve enough disk space for the file to grow to the
+        given size, without changing the file's length.
+
+        When a long recording is being written, reserving space in large steps ahead of
+        the data lets the filesystem keep the file contiguous, and stops each write having
+        to allocate more blocks. The reservation is released when the file is closed if it
+        wasn't used. If the platform or filesystem can't do this, an error is returned and
+        nothing else happens.
+    */
+    Result preallocate (int64 totalFileSize);
+
     //==============================================================================
     void flush();
     int64 getPosition();
@@ -102,6 +113,7 @@ private:
     int64 currentPosition;
     size_t bufferSize, bytesInBuffer;
     HeapBlock <char> buffer;
+    bool hasPreallocated;
 
     void openHandle();
     void closeHandle();
@@ -0,0 +1,934 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+FileSystemWatcher::Change::Change() noexcept
+    : changeTypes (0)
+{
+}
+
+FileSystemWatcher::Change::Change (const File& file_, const int changeTypes_) noexcept
+    : file (file_), changeTypes (changeTypes_)
+{
+}
+
+//==============================================================================
+#if JUCE_LINUX
+
+class FileSystemWatcher::Pimpl  : private Thread
+{
+public:
+    Pimpl (FileSystemWatcher& owner_)
+        : Thread ("FileSystemWatcher"),
+          owner (owner_),
+          fd (inotify_init1 (IN_NONBLOCK | IN_CLOEXEC))
+    {
+        wakeUpPipe[0] = wakeUpPipe[1] = -1;
+
+        if (fd >= 0 && pipe (wakeUpPipe) == 0)
+            startThread();
+    }
+
+    ~Pimpl()
+    {
+        signalThreadShouldExit();
+
+        if (wakeUpPipe[1] >= 0)
+        {
+            const char c = 0;
+            (void) ::write (wakeUpPipe[1], &c, 1);
+        }
+
+        stopThread (10000);
+
+        if (fd >= 0)            close (fd);
+        if (wakeUpPipe[0] >= 0) close (wakeUpPipe[0]);
+        if (wakeUpPipe[1] >= 0) close (wakeUpPipe[1]);
+    }
+
+    bool isOk() const noexcept
+    {
+        return isThreadRunning();
+    }
+
+    bool addFolder (const File& folder, const bool includeSubfolders)
+    {
+        const ScopedLock sl (lock);
+
+        if (! addWatch (folder.getFullPathName(), includeSubfolders))
+            return false;
+
+        if (includeSubfolders)
+            watchSubfolders (folder, false);
+
+        return true;
+    }
+
+    void removeFolder (const File&)
+    {
+        // Because watched trees can overlap, the simplest way to remove one is to
+        // start again with the folders that are left.
+        const ScopedLock sl (lock);
+
+        for (FlatHashMap<int, Watch>::Iterator i (watches); i.next();)
+            inotify_rm_watch (fd, i.getKey());
+
+        watches.clear();
+
+        for (int i = 0; i < owner.folders.size(); ++i)
+            addFolder (owner.folders.getReference (i).folder, owner.folders.getReference (i).includeSubfolders);
+    }
+
+private:
+    struct Watch
+    {
+        Watch() noexcept : includeSubfolders (false) {}
+        Watch (const String& path_, const bool includeSubfolders_) : path (path_), includeSubfolders (includeSubfolders_) {}
+
+        String path;
+        bool includeSubfolders;
+    };
+
+    FileSystemWatcher& owner;
+    const int fd;
+    int wakeUpPipe[2];
+    FlatHashMap<int, Watch> watches;
+    CriticalSection lock;
+
+    bool addWatch (const String& path, const bool includeSubfolders)
+    {
+        const int wd = inotify_add_watch (fd, path.toUTF8(),
+                                          IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO
+                                            | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+
+        if (wd < 0)
+            return false;
+
+        // (if this folder is already being watched as part of another tree, it'll get the same watch)
+        watches.set (wd, Watch (path, includeSubfolders || watches [wd].includeSubfolders));
+        return true;
+    }
+
+    // Adds watches to all the subfolders of a folder. If it's a folder that has only just
+    // appeared, then anything inside it must also be new, so it's reported as having been created.
+    void watchSubfolders (const File& folder, const bool reportContentsAsCreated)
+    {
+        DirectoryIterator iter (folder, true, "*", reportContentsAsCreated ? File::findFilesAndDirectories
+                                                                           : File::findDirectories);
+        bool isDirectory;
+
+        while (iter.next (&isDirectory, nullptr, nullptr, nullptr, nullptr, nullptr))
+        {
+            const String path (iter.getFile().getFullPathName());
+
+            if (isDirectory)
+                addWatch (path, true);
+
+            if (reportContentsAsCreated)
+                owner.addChange (path, fileCreated);
+        }
+    }
+
+    void run()
+    {
+        int64 buffer [1024];  // (the events need to be aligned)
+
+        while (! threadShouldExit())
+        {
+            struct pollfd fds[2];
+            fds[0].fd = fd;
+            fds[0].events = POLLIN;
+            fds[0].revents = 0;
+            fds[1].fd = wakeUpPipe[0];
+            fds[1].events = POLLIN;
+            fds[1].revents = 0;
+
+            if (poll (fds, 2, owner.getMillisecondsUntilBatchIsDue()) < 0 && errno != EINTR)
+                break;
+
+            if (threadShouldExit())
+                break;
+
+            if ((fds[0].revents & POLLIN) != 0)
+            {
+                for (;;)
+                {
+                    const ssize_t numBytes = ::read (fd, buffer, sizeof (buffer));
+
+                    if (numBytes <= 0)
+                        break;
+
+                    for (ssize_t pos = 0; pos + (ssize_t) sizeof (struct inotify_event) <= numBytes;)
+                    {
+                        const struct inotify_event& e = *reinterpret_cast <const struct inotify_event*> (addBytesToPointer (buffer, pos));
+                        handleEvent (e);
+                        pos += (ssize_t) sizeof (struct inotify_event) + (ssize_t) e.len;
+                    }
+                }
+            }
+
+            owner.deliverChanges (false);
+        }
+    }
+
+    void handleEvent (const struct inotify_event& e)
+    {
+        if ((e.mask & IN_Q_OVERFLOW) != 0)
+        {
+            const Array<File> folders (owner.getWatchedFolders());
+
+            for (int i = 0; i < folders.size(); ++i)
+                owner.addChange (folders.getReference (i).getFullPathName(), folderNeedsRescanning);
+
+            return;
+        }
+
+        const ScopedLock sl (lock);
+
+        if (! watches.contains (e.wd))
+            return;
+
+        const Watch watch (watches [e.wd]);
+
+        if ((e.mask & IN_IGNORED) != 0)
+        {
+            watches.remove (e.wd);
+            return;
+        }
+
+        int type = 0;
+        if ((e.mask & IN_CREATE) != 0)                                  type |= fileCreated;
+        if ((e.mask & (IN_DELETE | IN_DELETE_SELF)) != 0)               type |= fileDeleted;
+        if ((e.mask & (IN_MODIFY | IN_ATTRIB)) != 0)                    type |= fileModified;
+        if ((e.mask & (IN_MOVED_FROM | IN_MOVE_SELF)) != 0)             type |= fileRenamedOldName;
+        if ((e.mask & IN_MOVED_TO) != 0)                                type |= fileRenamedNewName;
+
+        if (e.len == 0)
+        {
+            // (this is a change to the watched folder itself)
+            owner.addChange (watch.path, type);
+            return;
+        }
+
+        const String path (File::addTrailingSeparator (watch.path) + String (CharPointer_UTF8 (e.name)));
+        owner.addChange (path, type);
+
+        if (watch.includeSubfolders && (e.mask & IN_ISDIR) != 0 && (e.mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+        {
+            // a new folder has appeared inside a tree that's being watched, so it needs watching too
+            addWatch (path, true);
+            watchSubfolders (File::createFileWithoutCheckingPath (path), true);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+//==============================================================================
+#elif JUCE_WINDOWS
+
+class FileSystemWatcher::Pimpl  : private Thread
+{
+public:
+    Pimpl (FileSystemWatcher& owner_)
+        : Thread ("FileSystemWatcher"),
+          owner (owner_),
+          wakeUpEvent (CreateEvent (0, FALSE, FALSE, 0))
+    {
+        if (wakeUpEvent != 0)
+            startThread();
+    }
+
+    ~Pimpl()
+    {
+        signalThreadShouldExit();
+
+        if (wakeUpEvent != 0)
+        {
+            SetEvent (wakeUpEvent);
+            stopThread (10000);
+            CloseHandle (wakeUpEvent);
+        }
+    }
+
+    bool isOk() const noexcept
+    {
+        return isThreadRunning();
+    }
+
+    bool addFolder (const File& folder, const bool includeSubfolders)
+    {
+        const ScopedLock sl (lock);
+
+        // (one handle is used for waking the thread up)
+        if (watches.size() >= MAXIMUM_WAIT_OBJECTS - 1)
+            return false;
+
+        const HANDLE h = CreateFile (folder.getFullPathName().toWideCharPointer(), FILE_LIST_DIRECTORY,
+                                     FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, 0, OPEN_EXISTING,
+                                     FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, 0);
+
+        if (h == INVALID_HANDLE_VALUE)
+            return false;
+
+        watches.add (new Watch (folder.getFullPathName(), includeSubfolders, h));
+        SetEvent (wakeUpEvent);
+        return true;
+    }
+
+    void removeFolder (const File& folder)
+    {
+        const ScopedLock sl (lock);
+
+        // (the handles are closed by the thread, because it's the one that started reading them)
+        for (int i = 0; i < watches.size(); ++i)
+            if (File (watches.getUnchecked (i)->path) == folder)
+                watches.getUnchecked (i)->shouldClose = true;
+
+        SetEvent (wakeUpEvent);
+    }
+
+private:
+    struct Watch
+    {
+        Watch (const String& path_, const bool includeSubfolders_, const HANDLE handle_)
+            : path (path_), includeSubfolders (includeSubfolders_),
+              handle (handle_), buffer (bufferSize / sizeof (DWORD)),
+              isReading (false), shouldClose (false)
+        {
+            zerostruct (overlapped);
+            overlapped.hEvent = CreateEvent (0, TRUE, FALSE, 0);
+        }
+
+        ~Watch()
+        {
+            if (isReading)
+            {
+                DWORD n = 0;
+                CancelIo (handle);
+                GetOverlappedResult (handle, &overlapped, &n, TRUE);
+            }
+
+            CloseHandle (handle);
+            CloseHandle (overlapped.hEvent);
+        }
+
+        bool startReading()
+        {
+            isReading = ReadDirectoryChangesW (handle, buffer, bufferSize, includeSubfolders,
+                                               FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME
+                                                 | FILE_NOTIFY_CHANGE_ATTRIBUTES | FILE_NOTIFY_CHANGE_SIZE
+                                                 | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_CREATION,
+                                               0, &overlapped, 0) != 0;
+            return isReading;
+        }
+
+        // (this is the largest buffer that will work with network drives)
+        enum { bufferSize = 64 * 1024 };
+
+        const String path;
+        const bool includeSubfolders;
+        const HANDLE handle;
+        HeapBlock<DWORD> buffer;
+        OVERLAPPED overlapped;
+        bool isReading, shouldClose;
+
+        JUCE_DECLARE_NON_COPYABLE (Watch)
+    };
+
+    FileSystemWatcher& owner;
+    const HANDLE wakeUpEvent;
+    OwnedArray<Watch> watches;
+    CriticalSection lock;
+
+    void run()
+    {
+        while (! threadShouldExit())
+        {
+            HANDLE handles [MAXIMUM_WAIT_OBJECTS];
+            Watch* watchForHandle [MAXIMUM_WAIT_OBJECTS];
+            DWORD numHandles = 0;
+            handles [numHandles++] = wakeUpEvent;
+
+            {
+                const ScopedLock sl (lock);
+
+                for (int i = watches.size(); --i >= 0;)
+                {
+                    Watch* const w = watches.getUnchecked (i);
+
+                    if (w->shouldClose)
+                    {
+                        watches.remove (i);
+                        continue;
+                    }
+
+                    if (! (w->isReading || w->startReading()))
+                    {
+                        // (the folder has probably been deleted)
+                        owner.addChange (w->path, folderNeedsRescanning);
+                        watches.remove (i);
+                        continue;
+                    }
+
+                    watchForHandle [numHandles] = w;
+                    handles [numHandles++] = w->overlapped.hEvent;
+                }
+            }
+
+            const int timeout = owner.getMillisecondsUntilBatchIsDue();
+            const DWORD result = WaitForMultipleObjects (numHandles, handles, FALSE, timeout < 0 ? INFINITE : (DWORD) timeout);
+
+            if (threadShouldExit())
+                break;
+
+            if (result > WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + numHandles)
+                readChanges (*watchForHandle [result - WAIT_OBJECT_0]);
+
+            owner.deliverChanges (false);
+        }
+
+        const ScopedLock sl (lock);
+        watches.clear();
+    }
+
+    void readChanges (Watch& w)
+    {
+        DWORD numBytes = 0;
+        w.isReading = false;
+
+        if (! GetOverlappedResult (w.handle, &w.overlapped, &numBytes, FALSE) || numBytes == 0)
+        {
+            // (the buffer overflowed, so some changes have been lost)
+            owner.addChange (w.path, folderNeedsRescanning);
+            return;
+        }
+
+        ResetEvent (w.overlapped.hEvent);
+
+        for (const char* p = reinterpret_cast <const char*> (w.buffer.getData());;)
+        {
+            const FILE_NOTIFY_INFORMATION& info = *reinterpret_cast <const FILE_NOTIFY_INFORMATION*> (p);
+            const String name (info.FileName, info.FileNameLength / sizeof (WCHAR));
+            int type = 0;
+
+            switch (info.Action)
+            {
+                case FILE_ACTION_ADDED:             type = fileCreated; break;
+                case FILE_ACTION_REMOVED:           type = fileDeleted; break;
+                case FILE_ACTION_MODIFIED:          type = fileModified; break;
+                case FILE_ACTION_RENAMED_OLD_NAME:  type = fileRenamedOldName; break;
+                case FILE_ACTION_RENAMED_NEW_NAME:  type = fileRenamedNewName; break;
+                default:                            break;
+            }
+
+            if (type != 0)
+                owner.addChange (File::addTrailingSeparator (w.path) + name, type);
+
+            if (info.NextEntryOffset == 0)
+                break;
+
+            p += info.NextEntryOffset;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+//==============================================================================
+#elif JUCE_MAC
+
+class FileSystemWatcher::Pimpl
+{
+public:
+    Pimpl (FileSystemWatcher& owner_)
+        : owner (owner_),
+          queue (dispatch_queue_create ("juce.FileSystemWatcher", DISPATCH_QUEUE_SERIAL))
+    {
+    }
+
+    ~Pimpl()
+    {
+        watches.clear();
+
+        if (queue != nullptr)
+            dispatch_release (queue);
+    }
+
+    bool isOk() const noexcept
+    {
+        return queue != nullptr;
+    }
+
+    bool addFolder (const File& folder, const bool includeSubfolders)
+    {
+        ScopedPointer<Watch> w (new Watch (owner, queue, folder, includeSubfolders));
+
+        if (w->stream == nullptr)
+            return false;
+
+        watches.add (w.release());
+        return true;
+    }
+
+    void removeFolder (const File& folder)
+    {
+        for (int i = watches.size(); --i >= 0;)
+            if (watches.getUnchecked (i)->folder == folder)
+                watches.remove (i);
+    }
+
+private:
+    struct Watch
+    {
+        Watch (FileSystemWatcher& owner_, dispatch_queue_t queue_, const File& folder_, const bool includeSubfolders_)
+            : owner (owner_), queue (queue_), folder (folder_), includeSubfolders (includeSubfolders_), stream (nullptr)
+        {
+            CFStringRef path = CFStringCreateWithCString (kCFAllocatorDefault, folder.getFullPathName().toUTF8(), kCFStringEncodingUTF8);
+            CFArrayRef paths = CFArrayCreate (kCFAllocatorDefault, (const void**) &path, 1, &kCFTypeArrayCallBacks);
+
+            FSEventStreamContext context;
+            zerostruct (context);
+            context.info = this;
+
+            FSEventStreamCreateFlags flags = kFSEventStreamCreateFlagWatchRoot;
+           #if defined (MAC_OS_X_VERSION_10_7) && MAC_OS_X_VERSION_MIN_REQUIRED >= MAC_OS_X_VERSION_10_7
+            flags |= kFSEventStreamCreateFlagFileEvents;
+           #endif
+
+            // FSEvents does its own batching, so its latency is used as the batch interval
+            stream = FSEventStreamCreate (kCFAllocatorDefault, &callback, &context, paths,
+                                          kFSEventStreamEventIdSinceNow, owner.batchInterval / 1000.0, flags);
+
+            CFRelease (paths);
+            CFRelease (path);
+
+            if (stream != nullptr)
+            {
+                FSEventStreamSetDispatchQueue (stream, queue);
+
+                if (! FSEventStreamStart (stream))
+                {
+                    FSEventStreamInvalidate (stream);
+                    FSEventStreamRelease (stream);
+                    stream = nullptr;
+                }
+            }
+        }
+
+        ~Watch()
+        {
+            if (stream != nullptr)
+            {
+                FSEventStreamStop (stream);
+                FSEventStreamInvalidate (stream);
+                FSEventStreamRelease (stream);
+
+                // (this waits for any callback that's already running on the queue to finish)
+                dispatch_sync_f (queue, nullptr, &doNothing);
+            }
+        }
+
+        static void doNothing (void*) {}
+
+        static void callback (ConstFSEventStreamRef, void* info, size_t numEvents, void* eventPaths,
+                              const FSEventStreamEventFlags* eventFlags, const FSEventStreamEventId*)
+        {
+            Watch& w = *static_cast <Watch*> (info);
+            const char* const* const paths = static_cast <const char* const*> (eventPaths);
+
+            for (size_t i = 0; i < numEvents; ++i)
+            {
+                const File file (CharPointer_UTF8 (paths[i]));
+                const FSEventStreamEventFlags flags = eventFlags[i];
+
+                if ((flags & (kFSEventStreamEventFlagMustScanSubDirs | kFSEventStreamEventFlagUserDropped
+                               | kFSEventStreamEventFlagKernelDropped)) != 0)
+                {
+                    w.owner.addChange (file.getFullPathName(), folderNeedsRescanning);
+                    continue;
+                }
+
+                // (FSEvents always watches the whole tree)
+                if (! (w.includeSubfolders || file == w.folder || file.getParentDirectory() == w.folder))
+                    continue;
+
+                int type = 0;
+
+               #if defined (MAC_OS_X_VERSION_10_7) && MAC_OS_X_VERSION_MIN_REQUIRED >= MAC_OS_X_VERSION_10_7
+                if ((flags & kFSEventStreamEventFlagItemCreated) != 0)   type |= fileCreated;
+                if ((flags & kFSEventStreamEventFlagItemRemoved) != 0)   type |= fileDeleted;
+
+                if ((flags & (kFSEventStreamEventFlagItemModified | kFSEventStreamEventFlagItemInodeMetaMod
+                               | kFSEventStreamEventFlagItemFinderInfoMod | kFSEventStreamEventFlagItemChangeOwner
+                               | kFSEventStreamEventFlagItemXattrMod)) != 0)
+                    type |= fileModified;
+
+                // (FSEvents doesn't say which end of a rename this is, so it has to be guessed)
+                if ((flags & kFSEventStreamEventFlagItemRenamed) != 0)
+                    type |= file.exists() ? fileRenamedNewName : fileRenamedOldName;
+               #endif
+
+                w.owner.addChange (file.getFullPathName(), type != 0 ? type : fileModified);
+            }
+
+            w.owner.deliverChanges (true);
+        }
+
+        FileSystemWatcher& owner;
+        dispatch_queue_t queue;
+        const File folder;
+        const bool includeSubfolders;
+        FSEventStreamRef stream;
+
+        JUCE_DECLARE_NON_COPYABLE (Watch)
+    };
+
+    FileSystemWatcher& owner;
+    dispatch_queue_t queue;
+    OwnedArray<Watch> watches;
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+//==============================================================================
+#else
+
+class FileSystemWatcher::Pimpl
+{
+public:
+    Pimpl (FileSystemWatcher&) {}
+
+    bool isOk() const noexcept                  { return false; }
+    bool addFolder (const File&, bool)          { return false; }
+    void removeFolder (const File&)             {}
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+#endif
+
+//==============================================================================
+FileSystemWatcher::FileSystemWatcher()
+    : batchStartTime (0), batchInterval (100)
+{
+    pimpl = new Pimpl (*this);
+}
+
+FileSystemWatcher::~FileSystemWatcher()
+{
+    // (this stops the background thread, so there'll be no more callbacks)
+    pimpl = nullptr;
+}
+
+bool FileSystemWatcher::isSupported() noexcept
+{
+   #if JUCE_LINUX || JUCE_WINDOWS || JUCE_MAC
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+void FileSystemWatcher::addListener (Listener* const listener)
+{
+    jassert (listener != nullptr);
+
+    const ScopedLock sl (listenerLock);
+    listeners.addIfNotAlreadyThere (listener);
+}
+
+void FileSystemWatcher::removeListener (Listener* const listener)
+{
+    const ScopedLock sl (listenerLock);
+    listeners.removeFirstMatchingValue (listener);
+}
+
+bool FileSystemWatcher::addFolder (const File& folder, const bool includeSubfolders)
+{
+    const ScopedLock sl (folderLock);
+
+    if (! (folder.isDirectory() && pimpl->isOk() && pimpl->addFolder (folder, includeSubfolders)))
+        return false;
+
+    WatchedFolder w;
+    w.folder = folder;
+    w.includeSubfolders = includeSubfolders;
+    folders.add (w);
+    return true;
+}
+
+void FileSystemWatcher::removeFolder (const File& folder)
+{
+    const ScopedLock sl (folderLock);
+
+    for (int i = folders.size(); --i >= 0;)
+        if (folders.getReference (i).folder == folder)
+            folders.remove (i);
+
+    pimpl->removeFolder (folder);
+}
+
+void FileSystemWatcher::removeAllFolders()
+{
+    const ScopedLock sl (folderLock);
+
+    while (folders.size() > 0)
+        removeFolder (folders.getReference (0).folder);
+}
+
+Array<File> FileSystemWatcher::getWatchedFolders() const
+{
+    const ScopedLock sl (folderLock);
+    Array<File> result;
+
+    for (int i = 0; i < folders.size(); ++i)
+        result.add (folders.getReference (i).folder);
+
+    return result;
+}
+
+void FileSystemWatcher::setBatchInterval (const int milliseconds)
+{
+    const ScopedLock sl (changeLock);
+    batchInterval = jmax (0, milliseconds);
+}
+
+//==============================================================================
+void FileSystemWatcher::addChange (const String& path, const int changeType)
+{
+    const ScopedLock sl (changeLock);
+
+    // changes to a file that's already in the batch are merged into its existing entry
+    const int index = pendingChangeIndex [path] - 1;
+
+    if (index >= 0)
+    {
+        pendingChanges.getReference (index).changeTypes |= changeType;
+    }
+    else
+    {
+        if (pendingChanges.size() == 0)
+            batchStartTime = Time::getMillisecondCounter();
+
+        pendingChangeIndex.set (path, pendingChanges.size() + 1);
+        pendingChanges.add (Change (File::createFileWithoutCheckingPath (path), changeType));
+    }
+}
+
+int FileSystemWatcher::getMillisecondsUntilBatchIsDue() const
+{
+    const ScopedLock sl (changeLock);
+
+    if (pendingChanges.size() == 0)
+        return -1;
+
+    return jmax (0, batchInterval - (int) (Time::getMillisecondCounter() - batchStartTime));
+}
+
+void FileSystemWatcher::deliverChanges (const bool evenIfNotDue)
+{
+    Array<Change> changes;
+
+    {
+        const ScopedLock sl (changeLock);
+
+        if (pendingChanges.size() == 0 || ! (evenIfNotDue || getMillisecondsUntilBatchIsDue() == 0))
+            return;
+
+        changes.swapWithArray (pendingChanges);
+        pendingChangeIndex.clear();
+    }
+
+    const ScopedLock sl (listenerLock);
+
+    for (int i = listeners.size(); --i >= 0;)
+    {
+        listeners.getUnchecked (i)->fileSystemChanged (*this, changes);
+        i = jmin (i, listeners.size());
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FileSystemWatcherTests  : public UnitTest,
+                                private FileSystemWatcher::Listener
+{
+public:
+    FileSystemWatcherTests() : UnitTest ("FileSystemWatcher"), numBatches (0) {}
+
+    void fileSystemChanged (FileSystemWatcher&, const Array<FileSystemWatcher::Change>& changes)
+    {
+        const ScopedLock sl (lock);
+        received.addArray (changes);
+        ++numBatches;
+    }
+
+    int getChangesFor (const File& f, int* numEntries = nullptr) const
+    {
+        const ScopedLock sl (lock);
+        int types = 0, num = 0;
+
+        for (int i = 0; i < received.size(); ++i)
+        {
+            if (received.getReference (i).file == f)
+            {
+                types |= received.getReference (i).changeTypes;
+                ++num;
+            }
+        }
+
+        if (numEntries != nullptr)
+            *numEntries = num;
+
+        return types;
+    }
+
+    bool waitForChange (const File& f, const int type) const
+    {
+        for (int i = 500; --i >= 0;)
+        {
+            if ((getChangesFor (f) & type) != 0)
+                return true;
+
+            Thread::sleep (10);
+        }
+
+        return false;
+    }
+
+    void clearReceived()
+    {
+        const ScopedLock sl (lock);
+        received.clear();
+        numBatches = 0;
+    }
+
+    void runTest()
+    {
+        if (! FileSystemWatcher::isSupported())
+            return;
+
+        const File folder (File::createTempFile ("watchertest"));
+        folder.createDirectory();
+
+        beginTest ("Changes");
+
+        {
+            FileSystemWatcher watcher;
+            watcher.setBatchInterval (20);
+            watcher.addListener (this);
+            expect (! watcher.addFolder (folder.getChildFile ("nonexistent"), false));
+            expect (watcher.addFolder (folder, false));
+            expect (watcher.getWatchedFolders().size() == 1);
+
+            const File f1 (folder.getChildFile ("file1.txt"));
+            const File f2 (folder.getChildFile ("file2.txt"));
+
+            f1.create();
+            expect (waitForChange (f1, FileSystemWatcher::fileCreated));
+
+            f1.appendText ("5678");
+            expect (waitForChange (f1, FileSystemWatcher::fileModified));
+
+            f1.moveFileTo (f2);
+            expect (waitForChange (f1, FileSystemWatcher::fileRenamedOldName));
+            expect (waitForChange (f2, FileSystemWatcher::fileRenamedNewName));
+
+            f2.deleteFile();
+            expect (waitForChange (f2, FileSystemWatcher::fileDeleted));
+
+            // changes inside subfolders shouldn't be reported when they're not being watched
+            const File sub (folder.getChildFile ("sub"));
+            sub.createDirectory();
+            sub.getChildFile ("inner.txt").replaceWithText ("x");
+            expect (waitForChange (sub, FileSystemWatcher::fileCreated));
+            folder.getChildFile ("marker").create();
+            expect (waitForChange (folder.getChildFile ("marker"), FileSystemWatcher::fileCreated));
+            expect (getChangesFor (sub.getChildFile ("inner.txt")) == 0);
+
+            watcher.removeFolder (folder);
+            expect (watcher.getWatchedFolders().size() == 0);
+            watcher.removeListener (this);
+        }
+
+        beginTest ("Subfolders");
+
+        {
+            clearReceived();
+            FileSystemWatcher watcher;
+            watcher.setBatchInterval (20);
+            watcher.addListener (this);
+            expect (watcher.addFolder (folder, true));
+
+            const File existing (folder.getChildFile ("sub").getChildFile ("inner.txt"));
+            existing.appendText ("y");
+            expect (waitForChange (existing, FileSystemWatcher::fileModified));
+
+            // a folder created after the watch was added should also be watched
+            const File newFolder (folder.getChildFile ("new").getChildFile ("deeper"));
+            newFolder.createDirectory();
+            const File deepFile (newFolder.getChildFile ("deep.txt"));
+            deepFile.create();
+            expect (waitForChange (deepFile, FileSystemWatcher::fileCreated));
+
+            watcher.removeAllFolders();
+            expect (watcher.getWatchedFolders().size() == 0);
+        }
+
+        beginTest ("Batching");
+
+        {
+            clearReceived();
+            FileSystemWatcher watcher;
+            watcher.setBatchInterval (1000);
+            watcher.addListener (this);
+            expect (watcher.addFolder (folder, false));
+
+            const File f (folder.getChildFile ("batched.txt"));
+
+            for (int i = 0; i < 50; ++i)
+                f.appendText ("abcd");
+
+            expect (waitForChange (f, FileSystemWatcher::fileCreated));
+
+            int numEntries = 0;
+            expect ((getChangesFor (f, &numEntries) & FileSystemWatcher::fileModified) != 0);
+            expectEquals (numEntries, 1);
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    Array<FileSystemWatcher::Change> received;
+    int numBatches;
+    CriticalSection lock;
+};
+
+static FileSystemWatcherTests fileSystemWatcherTests;
+
+#endif
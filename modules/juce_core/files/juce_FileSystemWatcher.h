@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_FILESYSTEMWATCHER_JUCEHEADER__
+#define __JUCE_FILESYSTEMWATCHER_JUCEHEADER__
+
+#include "juce_File.h"
+#include "../containers/juce_Array.h"
+#include "../containers/juce_FlatHashMap.h"
+#include "../memory/juce_ScopedPointer.h"
+#include "../threads/juce_CriticalSection.h"
+
+
+//==============================================================================
+/**
+    Watches a set of folders, and tells its listeners when files inside them change.
+
+    The OS's own change notifications are used (inotify on Linux, FSEvents on OSX and
+    ReadDirectoryChangesW on Windows), so there's no need to keep rescanning a folder to
+    find out whether anything in it has changed.
+
+    The changes are collected on a background thread, and delivered to the listeners in
+    batches. If the same file changes several times in quick succession, the changes are
+    merged into a single entry in the batch - so e.g. a file that's being written in lots of
+    small pieces will just produce one change, with its fileModified flag set.
+
+    e.g. @code
+    class ThumbnailCache  : public FileSystemWatcher::Listener
+    {
+        void fileSystemChanged (FileSystemWatcher&, const Array<FileSystemWatcher::Change>& changes)
+        {
+            for (int i = 0; i < changes.size(); ++i)
+                removeThumbnailFor (changes.getReference(i).file);
+        }
+        ...
+    };
+
+    watcher.addListener (&thumbnailCache);
+    watcher.addFolder (File ("~/Pictures"), true);
+    @endcode
+
+    @see DirectoryScanner
+*/
+class JUCE_API  FileSystemWatcher
+{
+public:
+    //==============================================================================
+    /** Creates a watcher that isn't watching any folders yet. */
+    FileSystemWatcher();
+
+    /** Destructor.
+        No more listener callbacks will be made once this has been called.
+    */
+    ~FileSystemWatcher();
+
+    //==============================================================================
+    /** The kinds of change that can be reported. Because changes to the same file are merged
+        together, the Change::changeTypes value may contain a combination of these flags.
+    */
+    enum ChangeTypes
+    {
+        fileCreated             = 1,    /**< The file was created. */
+        fileDeleted             = 2,    /**< The file was deleted. */
+        fileModified            = 4,    /**< The file's contents or attributes were changed. */
+        fileRenamedOldName      = 8,    /**< The file was renamed or moved away from this path. */
+        fileRenamedNewName      = 16,   /**< A file was renamed or moved to this path. */
+
+        /** Some changes were lost (e.g. because too many happened at once for the OS to keep
+            track of them all), so anything inside this folder may have changed, and if you're
+            caching anything about its contents, you'll need to read it all again.
+        */
+        folderNeedsRescanning   = 32
+    };
+
+    /** Describes a change to a file. */
+    struct JUCE_API  Change
+    {
+        Change() noexcept;
+        Change (const File& file, int changeTypes) noexcept;
+
+        /** The file or folder that changed. */
+        File file;
+
+        /** A combination of values from the ChangeTypes enum. */
+        int changeTypes;
+    };
+
+    //==============================================================================
+    /** Receives the changes that a FileSystemWatcher finds. */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called with a batch of changes.
+
+            This is called on the watcher's background thread, so if you need to do anything
+            with the message thread, you'll need to post a message to it.
+        */
+        virtual void fileSystemChanged (FileSystemWatcher& watcher, const Array<Change>& changes) = 0;
+    };
+
+    /** Registers a listener to receive the changes.
+        The listener mustn't be deleted while it's still registered.
+    */
+    void addListener (Listener* listener);
+
+    /** Removes a listener that was previously added.
+        Once this returns, the listener won't be called again, so it's safe to delete it.
+    */
+    void removeListener (Listener* listener);
+
+    //==============================================================================
+    /** Starts watching a folder.
+
+        @param folder               the folder to watch
+        @param includeSubfolders    if true, changes anywhere inside the folder's tree of subfolders
+                                    are reported, including inside folders that are created after
+                                    this call. If false, only the folder's immediate children are watched.
+        @returns false if the folder doesn't exist, or if the OS refuses to watch it
+    */
+    bool addFolder (const File& folder, bool includeSubfolders);
+
+    /** Stops watching a folder that was added with addFolder().
+        Any changes from it that have already been collected may still be delivered.
+    */
+    void removeFolder (const File& folder);
+
+    /** Stops watching all the folders. */
+    void removeAllFolders();
+
+    /** Returns the folders that were added with addFolder(). */
+    Array<File> getWatchedFolders() const;
+
+    //==============================================================================
+    /** Sets how long the watcher collects changes for before passing them to the listeners.
+
+        When the first change of a batch arrives, the watcher waits for this many milliseconds
+        before delivering the batch, so that a burst of changes can be merged together. The
+        default is 100ms.
+    */
+    void setBatchInterval (int milliseconds);
+
+    /** Returns true if the watcher can be used on this platform. */
+    static bool isSupported() noexcept;
+
+private:
+    //==============================================================================
+    class Pimpl;
+    friend class Pimpl;
+    friend class ScopedPointer<Pimpl>;
+
+    struct WatchedFolder
+    {
+        File folder;
+        bool includeSubfolders;
+    };
+
+    Array<WatchedFolder> folders;
+    Array<Listener*> listeners;
+    Array<Change> pendingChanges;
+    FlatHashMap<String, int> pendingChangeIndex;
+    CriticalSection folderLock, changeLock, listenerLock;
+    uint32 batchStartTime;
+    int batchInterval;
+    ScopedPointer<Pimpl> pimpl;
+
+    void addChange (const String& path, int changeType);
+    int getMillisecondsUntilBatchIsDue() const;
+    void deliverChanges (bool evenIfNotDue);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FileSystemWatcher)
+};
+
+#endif   // __JUCE_FILESYSTEMWATCHER_JUCEHEADER__
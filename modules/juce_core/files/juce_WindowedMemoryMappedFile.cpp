@@ -0,0 +1,547 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+WindowedMemoryMappedFile::WindowedMemoryMappedFile (const File& file_, const MemoryMappedFile::AccessMode mode_,
+                                                    const size_t windowSize_, const size_t maxAccessSize_,
+                                                    const int maxNumWindows_)
+    : file (file_), mode (mode_),
+      windowSize (jmax ((size_t) 1, windowSize_)),
+      maxAccessSize (maxAccessSize_),
+      maxNumWindows (jmax (1, maxNumWindows_)),
+      accessPattern (normalAccess),
+      dataSize (0), fileSize (0), useCounter (0)
+{
+    jassert (mode == MemoryMappedFile::readOnly || mode == MemoryMappedFile::readWrite);
+
+   #if JUCE_WINDOWS
+    SYSTEM_INFO systemInfo;
+    GetNativeSystemInfo (&systemInfo);
+    const size_t granularity = (size_t) systemInfo.dwAllocationGranularity;
+
+    const HANDLE h = CreateFile (file.getFullPathName().toWideCharPointer(),
+                                 mode == MemoryMappedFile::readWrite ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                                 FILE_SHARE_READ, 0,
+                                 mode == MemoryMappedFile::readWrite ? OPEN_ALWAYS : OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, 0);
+
+    fileHandle = nullptr;
+
+    if (h != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER size;
+
+        if (GetFileSizeEx (h, &size))
+        {
+            fileHandle = (void*) h;
+            dataSize = fileSize = (int64) size.QuadPart;
+        }
+        else
+        {
+            CloseHandle (h);
+        }
+    }
+   #else
+    const size_t granularity = (size_t) sysconf (_SC_PAGE_SIZE);
+
+    fileHandle = open (file.getFullPathName().toUTF8(),
+                       mode == MemoryMappedFile::readWrite ? (O_CREAT | O_RDWR) : O_RDONLY, 00644);
+
+    if (fileHandle != -1)
+    {
+        struct stat info;
+
+        if (fstat (fileHandle, &info) == 0)
+        {
+            dataSize = fileSize = (int64) info.st_size;
+        }
+        else
+        {
+            close (fileHandle);
+            fileHandle = -1;
+        }
+    }
+   #endif
+
+    // (the windows have to start at positions that the OS can map)
+    windowSize = ((windowSize + granularity - 1) / granularity) * granularity;
+}
+
+WindowedMemoryMappedFile::~WindowedMemoryMappedFile()
+{
+    unmapAllWindows();
+
+    if (openedOk())
+    {
+       #if JUCE_WINDOWS
+        if (fileSize != dataSize)
+        {
+            LARGE_INTEGER li;
+            li.QuadPart = dataSize;
+
+            if (SetFilePointerEx ((HANDLE) fileHandle, li, 0, FILE_BEGIN))
+                SetEndOfFile ((HANDLE) fileHandle);
+        }
+
+        CloseHandle ((HANDLE) fileHandle);
+       #else
+        if (fileSize != dataSize)
+            (void) ftruncate (fileHandle, (off_t) dataSize);
+
+        close (fileHandle);
+       #endif
+    }
+}
+
+bool WindowedMemoryMappedFile::openedOk() const noexcept
+{
+   #if JUCE_WINDOWS
+    return fileHandle != nullptr;
+   #else
+    return fileHandle != -1;
+   #endif
+}
+
+int64 WindowedMemoryMappedFile::getSize() const noexcept
+{
+    const ScopedLock sl (lock);
+    return dataSize;
+}
+
+void WindowedMemoryMappedFile::setAccessPattern (const AccessPattern newPattern)
+{
+    const ScopedLock sl (lock);
+    accessPattern = newPattern;
+}
+
+//==============================================================================
+void* WindowedMemoryMappedFile::getData (const int64 position, const size_t numBytes)
+{
+    jassert (numBytes <= maxAccessSize); // you can't ask for a bigger block than this!
+
+    const ScopedLock sl (lock);
+
+    if (position < 0 || numBytes > maxAccessSize || position + (int64) numBytes > dataSize)
+        return nullptr;
+
+    size_t numBytesAvailable;
+    void* const data = getDataInternal (position, numBytesAvailable);
+
+    jassert (data == nullptr || numBytesAvailable >= numBytes);
+    return data;
+}
+
+size_t WindowedMemoryMappedFile::read (int64 position, void* const destBuffer, const size_t numBytes)
+{
+    const ScopedLock sl (lock);
+    size_t numRead = 0;
+
+    while (numRead < numBytes && position >= 0 && position < dataSize)
+    {
+        size_t numBytesAvailable;
+        const void* const source = getDataInternal (position, numBytesAvailable);
+
+        if (source == nullptr)
+            break;
+
+        const size_t num = (size_t) jmin ((int64) (numBytes - numRead), (int64) numBytesAvailable, dataSize - position);
+        memcpy (addBytesToPointer (destBuffer, numRead), source, num);
+        numRead += num;
+        position += (int64) num;
+    }
+
+    return numRead;
+}
+
+bool WindowedMemoryMappedFile::append (const void* const data, size_t numBytes)
+{
+    jassert (mode == MemoryMappedFile::readWrite); // you can only append to a file that was opened for writing!
+
+    const ScopedLock sl (lock);
+
+    if (mode != MemoryMappedFile::readWrite || ! openedOk())
+        return false;
+
+    if (dataSize + (int64) numBytes > fileSize)
+    {
+        // The file is grown a whole window at a time, so that this doesn't need doing too often
+        const int64 newFileSize = ((dataSize + (int64) numBytes + (int64) windowSize - 1) / (int64) windowSize) * (int64) windowSize;
+
+       #if ! JUCE_WINDOWS  // (on Windows, mapping the new windows will extend the file)
+        #if JUCE_LINUX
+         // (allocating the space now avoids a crash when writing to the mapping if the disk fills up)
+         if (posix_fallocate (fileHandle, (off_t) fileSize, (off_t) (newFileSize - fileSize)) != 0)
+        #endif
+        {
+            if (ftruncate (fileHandle, (off_t) newFileSize) != 0)
+                return false;
+        }
+       #endif
+
+        fileSize = newFileSize;
+
+        // any windows that were cut short by the old end of the file need to be mapped again
+        for (int i = windows.size(); --i >= 0;)
+        {
+            if (windows.getReference (i).length < windowSize + maxAccessSize)
+            {
+                unmapWindow (windows.getReference (i));
+                windows.remove (i);
+            }
+        }
+    }
+
+    const char* source = static_cast <const char*> (data);
+
+    while (numBytes > 0)
+    {
+        size_t numBytesAvailable;
+        void* const dest = getDataInternal (dataSize, numBytesAvailable);
+
+        if (dest == nullptr)
+            return false;
+
+        const size_t num = jmin (numBytes, numBytesAvailable);
+        memcpy (dest, source, num);
+        source += num;
+        numBytes -= num;
+        dataSize += (int64) num;
+    }
+
+    return true;
+}
+
+Result WindowedMemoryMappedFile::flush()
+{
+    const ScopedLock sl (lock);
+
+    for (int i = 0; i < windows.size(); ++i)
+    {
+        const Window& w = windows.getReference (i);
+
+       #if JUCE_WINDOWS
+        if (! FlushViewOfFile (w.address, w.length))
+       #else
+        if (msync (w.address, w.length, MS_SYNC) != 0)
+       #endif
+            return Result::fail ("Couldn't flush the mapped data");
+    }
+
+   #if JUCE_WINDOWS
+    if (openedOk() && mode == MemoryMappedFile::readWrite && ! FlushFileBuffers ((HANDLE) fileHandle))
+        return Result::fail ("Couldn't flush the file");
+   #endif
+
+    return Result::ok();
+}
+
+void WindowedMemoryMappedFile::prefetch (int64 position, size_t numBytes)
+{
+    const ScopedLock sl (lock);
+
+    // (only as many windows as can be kept mapped at once are worth loading)
+    for (int i = 0; i < maxNumWindows && numBytes > 0 && position >= 0 && position < dataSize; ++i)
+    {
+        const Window* const w = getWindowFor (position);
+
+        if (w == nullptr)
+            break;
+
+        const size_t num = (size_t) jmin ((int64) numBytes, w->start + (int64) windowSize - position, dataSize - position);
+        prefetchWindowRange (*w, position, num);
+        position += (int64) num;
+        numBytes -= num;
+    }
+}
+
+//==============================================================================
+void* WindowedMemoryMappedFile::getDataInternal (const int64 position, size_t& numBytesAvailable)
+{
+    const Window* const w = getWindowFor (position);
+
+    if (w == nullptr)
+        return nullptr;
+
+    numBytesAvailable = (size_t) (w->start + (int64) w->length - position);
+    return addBytesToPointer (w->address, position - w->start);
+}
+
+const WindowedMemoryMappedFile::Window* WindowedMemoryMappedFile::getWindowFor (const int64 position)
+{
+    if (position < 0 || position >= fileSize || ! openedOk())
+        return nullptr;
+
+    const int64 start = position - position % (int64) windowSize;
+
+    for (int i = windows.size(); --i >= 0;)
+    {
+        Window& w = windows.getReference (i);
+
+        if (w.start == start)
+        {
+            w.lastUsed = ++useCounter;
+            return &w;
+        }
+    }
+
+    if (windows.size() >= maxNumWindows)
+    {
+        int leastRecentlyUsed = 0;
+
+        for (int i = 1; i < windows.size(); ++i)
+            if (windows.getReference (i).lastUsed - windows.getReference (leastRecentlyUsed).lastUsed > 0x80000000u)
+                leastRecentlyUsed = i;
+
+        unmapWindow (windows.getReference (leastRecentlyUsed));
+        windows.remove (leastRecentlyUsed);
+    }
+
+    Window w;
+    w.start = start;
+    w.length = (size_t) jmin ((int64) (windowSize + maxAccessSize), fileSize - start);
+    w.address = nullptr;
+    w.lastUsed = ++useCounter;
+
+    if (! mapWindow (w))
+        return nullptr;
+
+    windows.add (w);
+    return &windows.getReference (windows.size() - 1);
+}
+
+bool WindowedMemoryMappedFile::mapWindow (Window& w)
+{
+    const bool writable = (mode == MemoryMappedFile::readWrite);
+
+   #if JUCE_WINDOWS
+    const int64 end = w.start + (int64) w.length;
+
+    const HANDLE mappingHandle = CreateFileMapping ((HANDLE) fileHandle, 0, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                                    (DWORD) (end >> 32), (DWORD) end, 0);
+
+    if (mappingHandle == 0)
+        return false;
+
+    w.address = MapViewOfFile (mappingHandle, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ,
+                               (DWORD) (w.start >> 32), (DWORD) w.start, (SIZE_T) w.length);
+
+    CloseHandle (mappingHandle);
+
+    if (w.address == nullptr)
+        return false;
+
+    // (there's no equivalent of madvise, so the best that can be done is to load the whole window)
+    if (accessPattern == sequentialAccess)
+        prefetchWindowRange (w, w.start, w.length);
+   #else
+    void* const m = mmap (0, w.length, writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                          MAP_SHARED, fileHandle, (off_t) w.start);
+
+    if (m == MAP_FAILED)
+        return false;
+
+    w.address = m;
+
+    if (accessPattern != normalAccess)
+        madvise (m, w.length, accessPattern == sequentialAccess ? MADV_SEQUENTIAL : MADV_RANDOM);
+   #endif
+
+    return true;
+}
+
+void WindowedMemoryMappedFile::unmapWindow (const Window& w)
+{
+   #if JUCE_WINDOWS
+    UnmapViewOfFile (w.address);
+   #else
+    munmap (w.address, w.length);
+   #endif
+}
+
+void WindowedMemoryMappedFile::unmapAllWindows()
+{
+    for (int i = windows.size(); --i >= 0;)
+        unmapWindow (windows.getReference (i));
+
+    windows.clear();
+}
+
+void WindowedMemoryMappedFile::prefetchWindowRange (const Window& w, const int64 position, const size_t numBytes)
+{
+   #if JUCE_WINDOWS
+    const size_t start = (size_t) (position - w.start);
+    const size_t length = jmin (w.length - start, numBytes);
+
+    struct RangeEntry
+    {
+        void* address;
+        SIZE_T numBytes;
+    };
+
+    typedef BOOL (WINAPI* PrefetchVirtualMemoryFn) (HANDLE, ULONG_PTR, RangeEntry*, ULONG);
+
+    // (this is only available from Windows 8 onwards)
+    static PrefetchVirtualMemoryFn prefetchVirtualMemory
+        = (PrefetchVirtualMemoryFn) GetProcAddress (GetModuleHandleA ("kernel32.dll"), "PrefetchVirtualMemory");
+
+    if (prefetchVirtualMemory != nullptr)
+    {
+        RangeEntry entry = { addBytesToPointer (w.address, start), length };
+        prefetchVirtualMemory (GetCurrentProcess(), 1, &entry, 0);
+    }
+   #else
+    // (the windows always begin on a page boundary, so this rounds the range out to whole pages)
+    const size_t offset = (size_t) (position - w.start);
+    const size_t pageSize = (size_t) sysconf (_SC_PAGE_SIZE);
+    const size_t start = offset - (offset % pageSize);
+
+    madvise (addBytesToPointer (w.address, start), jmin (w.length - start, numBytes + (offset - start)), MADV_WILLNEED);
+   #endif
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class WindowedMemoryMappedFileTests  : public UnitTest
+{
+public:
+    WindowedMemoryMappedFileTests() : UnitTest ("WindowedMemoryMappedFile") {}
+
+    static void fillBlock (int* data, int64 firstIndex, int num)
+    {
+        for (int i = 0; i < num; ++i)
+            data[i] = (int) (firstIndex + i);
+    }
+
+    void runTest()
+    {
+        const File tempFile (File::createTempFile ("mmtest"));
+        const int numInts = 300000;
+
+        {
+            HeapBlock<int> data ((size_t) numInts);
+            fillBlock (data, 0, numInts);
+            tempFile.replaceWithData (data, sizeof (int) * (size_t) numInts);
+        }
+
+        beginTest ("Reading");
+
+        {
+            WindowedMemoryMappedFile mmf (tempFile, MemoryMappedFile::readOnly, 65536, 4096, 3);
+            expect (mmf.openedOk());
+            expectEquals (mmf.getSize(), (int64) numInts * 4);
+            expect (mmf.getData (mmf.getSize() - 3, 4) == nullptr);
+            expect (mmf.getData (-1, 4) == nullptr);
+
+            Random r (1);
+            bool allOk = true;
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                if (i == 1000)
+                    mmf.setAccessPattern (WindowedMemoryMappedFile::randomAccess);
+
+                const int index = r.nextInt (numInts - 1024);
+                const int num = 1 + r.nextInt (1024);
+                const int* p = static_cast <const int*> (mmf.getData ((int64) index * 4, (size_t) num * 4));
+
+                allOk = allOk && p != nullptr && p[0] == index && p[num - 1] == index + num - 1;
+            }
+
+            expect (allOk);
+
+            mmf.prefetch (0, 500000);
+            HeapBlock<int> buffer ((size_t) numInts + 100);
+            expect (mmf.read (4, buffer, (size_t) numInts * 4) == (size_t) (numInts - 1) * 4);
+
+            for (int i = 0; i < numInts - 1; ++i)
+                allOk = allOk && buffer[i] == i + 1;
+
+            expect (allOk);
+        }
+
+        beginTest ("Appending");
+
+        {
+            const File appendFile (tempFile.getSiblingFile ("appendtest"));
+            appendFile.deleteFile();
+
+            {
+                WindowedMemoryMappedFile mmf (appendFile, MemoryMappedFile::readWrite, 65536, 4096, 2);
+                expect (mmf.openedOk());
+                mmf.setAccessPattern (WindowedMemoryMappedFile::sequentialAccess);
+
+                Random r (2);
+                HeapBlock<int> block (20000);
+                int64 numWritten = 0;
+
+                while (numWritten < numInts)
+                {
+                    const int num = (int) jmin ((int64) r.nextInt (20000), numInts - numWritten);
+                    fillBlock (block, numWritten, num);
+                    expect (mmf.append (block, (size_t) num * 4));
+                    numWritten += num;
+                }
+
+                expectEquals (mmf.getSize(), (int64) numInts * 4);
+                expect (mmf.flush().wasOk());
+
+                const int* p = static_cast <const int*> (mmf.getData (4000, 16));
+                expect (p != nullptr && p[0] == 1000);
+            }
+
+            expectEquals (appendFile.getSize(), (int64) numInts * 4);
+
+            MemoryBlock written;
+            appendFile.loadFileAsData (written);
+            MemoryBlock original;
+            tempFile.loadFileAsData (original);
+            expect (written == original);
+
+            {
+                // appending to an existing file adds to the end of it
+                WindowedMemoryMappedFile mmf (appendFile, MemoryMappedFile::readWrite, 65536, 4096, 2);
+                const int extra = 12345;
+                expect (mmf.append (&extra, sizeof (extra)));
+            }
+
+            expectEquals (appendFile.getSize(), (int64) numInts * 4 + 4);
+            appendFile.deleteFile();
+        }
+
+        beginTest ("Missing files");
+
+        {
+            WindowedMemoryMappedFile mmf (tempFile.getSiblingFile ("nonexistent_mmtest"), MemoryMappedFile::readOnly);
+            expect (! mmf.openedOk());
+            expect (mmf.getData (0, 1) == nullptr);
+        }
+
+        tempFile.deleteFile();
+    }
+};
+
+static WindowedMemoryMappedFileTests windowedMemoryMappedFileTests;
+
+#endif
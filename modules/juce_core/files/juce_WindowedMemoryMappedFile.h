@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_WINDOWEDMEMORYMAPPEDFILE_JUCEHEADER__
+#define __JUCE_WINDOWEDMEMORYMAPPEDFILE_JUCEHEADER__
+
+#include "juce_MemoryMappedFile.h"
+#include "../containers/juce_Array.h"
+#include "../threads/juce_CriticalSection.h"
+#include "../misc/juce_Result.h"
+
+
+//==============================================================================
+/**
+    Maps a file into memory a window at a time, so that files of any size can be accessed
+    without needing enough address space to map the whole thing.
+
+    The file is divided into fixed-size windows, and each window is only mapped when some data
+    inside it is asked for. A limited number of windows are kept mapped at once, and when more are
+    needed, the one that was used least recently is unmapped.
+
+    Each window is mapped with a little extra data past its end, so that any block of data up to
+    the maximum access size that was given to the constructor can always be returned as a single
+    contiguous pointer, even if it crosses the boundary between two windows.
+
+    When opened in readWrite mode, data can also be appended to the end of the file with append().
+    The file is grown a whole window at a time to make room for it, and then trimmed back to the
+    size of the data that was actually written when the object is deleted, so this is a fast way
+    to write a large file that's produced sequentially.
+
+    @see MemoryMappedFile
+*/
+class JUCE_API  WindowedMemoryMappedFile
+{
+public:
+    //==============================================================================
+    /** Opens a file, ready to map windows of it as they're needed.
+
+        @param file             the file to open. In readOnly mode, it must already exist, but in
+                                readWrite mode it'll be created if it doesn't.
+        @param mode             whether the file will be read or written
+        @param windowSize       the size of each window - this will be rounded up to a multiple
+                                of the OS's mapping granularity
+        @param maxAccessSize    the largest block of data that can be asked for at once with getData()
+        @param maxNumWindows    the number of windows that will be kept mapped at once
+    */
+    WindowedMemoryMappedFile (const File& file,
+                              MemoryMappedFile::AccessMode mode,
+                              size_t windowSize = 4 * 1024 * 1024,
+                              size_t maxAccessSize = 64 * 1024,
+                              int maxNumWindows = 8);
+
+    /** Destructor.
+        If data was appended to the file, it's trimmed to the end of the data that was written.
+    */
+    ~WindowedMemoryMappedFile();
+
+    //==============================================================================
+    /** Returns true if the file was opened successfully. */
+    bool openedOk() const noexcept;
+
+    /** Returns the file that this object is mapping. */
+    const File& getFile() const noexcept                    { return file; }
+
+    /** Returns the size of the file's data, including anything that has been appended. */
+    int64 getSize() const noexcept;
+
+    /** Returns the size of the windows that are being used. */
+    size_t getWindowSize() const noexcept                   { return windowSize; }
+
+    /** Returns the largest block of data that can be asked for with getData(). */
+    size_t getMaxAccessSize() const noexcept                { return maxAccessSize; }
+
+    //==============================================================================
+    /** Returns a pointer to a block of the file's data, mapping it if necessary.
+
+        The block must lie entirely within the file, and numBytes mustn't be larger than
+        getMaxAccessSize(). If it's out of range, or can't be mapped, this returns nullptr.
+
+        The pointer stays valid until enough other windows have been mapped to push this one
+        out of the list of active ones - which means it's always safe to use it until the next
+        call to any of this object's methods, and for longer if only a few windows are being used.
+        In readOnly mode, you mustn't write to the memory.
+    */
+    void* getData (int64 position, size_t numBytes);
+
+    /** Copies a block of data out of the file.
+        Unlike getData(), this can read any number of bytes.
+        @returns the number of bytes that were read, which will be less than numBytes if the
+                 end of the file is reached
+    */
+    size_t read (int64 position, void* destBuffer, size_t numBytes);
+
+    /** Adds some data to the end of the file.
+        This can only be used in readWrite mode.
+    */
+    bool append (const void* data, size_t numBytes);
+
+    /** Makes sure that anything that has been written to the mapped windows is written to disk. */
+    Result flush();
+
+    //==============================================================================
+    /** Describes how the file's data is likely to be accessed, so that the OS can optimise
+        the way that it reads from the disk.
+    */
+    enum AccessPattern
+    {
+        normalAccess,
+        sequentialAccess,   /**< The data will be read in order, so the OS should read ahead aggressively. */
+        randomAccess        /**< The data will be read in a random order, so reading ahead would be wasted. */
+    };
+
+    /** Tells the OS how the data is likely to be accessed.
+        The default is normalAccess. This affects windows that are mapped after it's called.
+    */
+    void setAccessPattern (AccessPattern newPattern);
+
+    /** Asks the OS to start loading a section of the file into memory in the background,
+        because it'll be needed soon.
+    */
+    void prefetch (int64 position, size_t numBytes);
+
+private:
+    //==============================================================================
+    struct Window
+    {
+        int64 start;
+        size_t length;
+        void* address;
+        uint32 lastUsed;
+    };
+
+    const File file;
+    const MemoryMappedFile::AccessMode mode;
+    size_t windowSize, maxAccessSize;
+    const int maxNumWindows;
+    AccessPattern accessPattern;
+    Array<Window> windows;
+    int64 dataSize, fileSize;
+    uint32 useCounter;
+    CriticalSection lock;
+
+   #if JUCE_WINDOWS
+    void* fileHandle;
+   #else
+    int fileHandle;
+   #endif
+
+    void* getDataInternal (int64 position, size_t& numBytesAvailable);
+    const Window* getWindowFor (int64 position);
+    bool mapWindow (Window&);
+    void unmapWindow (const Window&);
+    void unmapAllWindows();
+    void prefetchWindowRange (const Window&, int64 position, size_t numBytes);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WindowedMemoryMappedFile)
+};
+
+#endif   // __JUCE_WINDOWEDMEMORYMAPPEDFILE_JUCEHEADER__
@@ -264,6 +264,19 @@ private:
 
     static Result parseString (String::CharPointerType& t, var& result)
     {
+        // if there are no escape sequences, the string can be copied directly from the input..
+        {
+            typedef String::CharPointerType::CharType CharType;
+            const String::CharPointerType end (CharacterFunctions::findFirstOf (t.getAddress(), (CharType) '"', (CharType) '\\'));
+
+            if (*end == '"')
+            {
+                result = String (t, end);
+                t = end + 1;
+                return Result::ok();
+            }
+        }
+
         MemoryOutputStream buffer (256);
 
         for (;;)
@@ -327,7 +340,7 @@ public:
     {
         if (v.isString())
         {
-            writeString (out, v.toString().getCharPointer());
+            writeString (out, v.toString());
         }
         else if (v.isVoid())
         {
@@ -337,10 +350,26 @@ public:
         {
             out << (static_cast<bool> (v) ? "true" : "false");
         }
+        else if (v.isInt() || v.isInt64())
+        {
+            writeInt (out, static_cast<int64> (v));
+        }
         else if (v.isArray())
         {
             writeArray (out, *v.getArray(), indentLevel, allOnOneLine);
         }
+        else if (const Array<int>* const ints = v.getIntArray())
+        {
+            writeArray (out, *ints, indentLevel, allOnOneLine);
+        }
+        else if (const Array<float>* const floats = v.getFloatArray())
+        {
+            writeArray (out, *floats, indentLevel, allOnOneLine);
+        }
+        else if (const Array<double>* const doubles = v.getDoubleArray())
+        {
+            writeArray (out, *doubles, indentLevel, allOnOneLine);
+        }
         else if (v.isObject())
         {
             if (DynamicObject* const object = v.getDynamicObject())
@@ -357,38 +386,45 @@ public:
         }
     }
 
-private:
-    enum { indentSize = 2 };
-
-    static void writeEscapedChar (OutputStream& out, const unsigned short value)
+    static void writeString (OutputStream& out, const String& s)
     {
-        out << "\\u" << String::toHexString ((int) value).paddedLeft ('0', 4);
+        const String::CharPointerType t (s.getCharPointer());
+        writeString (out, t, t.findTerminatingNull());
     }
 
-    static void writeString (OutputStream& out, String::CharPointerType t)
+    // The text is escaped into a small buffer, which is written to the stream in
+    // blocks, rather than making a call to the stream for every character.
+    template <class CharPointer>
+    static void writeString (OutputStream& out, CharPointer t, const CharPointer end)
     {
-        out << '"';
+        char buffer [256];
+        int n = 0;
+        buffer[n++] = '"';
 
-        for (;;)
+        while (t.getAddress() < end.getAddress())
         {
+            if (n > (int) sizeof (buffer) - 16)
+            {
+                out.write (buffer, (size_t) n);
+                n = 0;
+            }
+
             const juce_wchar c (t.getAndAdvance());
 
             switch (c)
             {
-                case 0:  out << '"'; return;
-
-                case '\"':  out << "\\\""; break;
-                case '\\':  out << "\\\\"; break;
-                case '\b':  out << "\\b";  break;
-                case '\f':  out << "\\f";  break;
-                case '\t':  out << "\\t";  break;
-                case '\r':  out << "\\r";  break;
-                case '\n':  out << "\\n";  break;
+                case '\"':  buffer[n++] = '\\'; buffer[n++] = '"';  break;
+                case '\\':  buffer[n++] = '\\'; buffer[n++] = '\\'; break;
+                case '\b':  buffer[n++] = '\\'; buffer[n++] = 'b';  break;
+                case '\f':  buffer[n++] = '\\'; buffer[n++] = 'f';  break;
+                case '\t':  buffer[n++] = '\\'; buffer[n++] = 't';  break;
+                case '\r':  buffer[n++] = '\\'; buffer[n++] = 'r';  break;
+                case '\n':  buffer[n++] = '\\'; buffer[n++] = 'n';  break;
 
                 default:
                     if (c >= 32 && c < 127)
                     {
-                        out << (char) c;
+                        buffer[n++] = (char) c;
                     }
                     else
                     {
@@ -399,17 +435,40 @@ private:
                             utf16.write (c);
 
                             for (int i = 0; i < 2; ++i)
-                                writeEscapedChar (out, (unsigned short) chars[i]);
+                                n = writeEscapedChar (buffer, n, (unsigned short) chars[i]);
                         }
                         else
                         {
-                            writeEscapedChar (out, (unsigned short) c);
+                            n = writeEscapedChar (buffer, n, (unsigned short) c);
                         }
                     }
 
                     break;
             }
         }
+
+        buffer[n++] = '"';
+        out.write (buffer, (size_t) n);
+    }
+
+    static void writeInt (OutputStream& out, const int64 value)
+    {
+        char buffer [24];
+        char* const end = buffer + numElementsInArray (buffer);
+        char* t = end;
+        uint64 v = (value >= 0) ? (uint64) value : (uint64) 0 - (uint64) value;
+
+        do
+        {
+            *--t = (char) ('0' + (int) (v % 10));
+            v /= 10;
+
+        } while (v > 0);
+
+        if (value < 0)
+            *--t = '-';
+
+        out.write (t, (size_t) (end - t));
     }
 
     static void writeSpaces (OutputStream& out, int numSpaces)
@@ -417,7 +476,33 @@ private:
         out.writeRepeatedByte (' ', (size_t) numSpaces);
     }
 
-    static void writeArray (OutputStream& out, const Array<var>& array,
+    enum { indentSize = 2 };
+
+private:
+    static int writeEscapedChar (char* const buffer, int n, const unsigned short value)
+    {
+        static const char hexDigits[] = "0123456789abcdef";
+
+        buffer[n++] = '\\';
+        buffer[n++] = 'u';
+
+        for (int shift = 12; shift >= 0; shift -= 4)
+            buffer[n++] = hexDigits [(value >> shift) & 15];
+
+        return n;
+    }
+
+    static void writeElement (OutputStream& out, const var& v, const int indentLevel, const bool allOnOneLine)
+    {
+        write (out, v, indentLevel, allOnOneLine);
+    }
+
+    static void writeElement (OutputStream& out, const int v, int, bool)      { writeInt (out, v); }
+    static void writeElement (OutputStream& out, const float v, int, bool)    { out << String (v); }
+    static void writeElement (OutputStream& out, const double v, int, bool)   { out << String (v); }
+
+    template <typename ElementType>
+    static void writeArray (OutputStream& out, const Array<ElementType>& array,
                             const int indentLevel, const bool allOnOneLine)
     {
         out << '[';
@@ -429,7 +514,7 @@ private:
             if (! allOnOneLine)
                 writeSpaces (out, indentLevel + indentSize);
 
-            write (out, array.getReference(i), indentLevel + indentSize, allOnOneLine);
+            writeElement (out, array.getReference(i), indentLevel + indentSize, allOnOneLine);
 
             if (i < array.size() - 1)
             {
@@ -457,23 +542,17 @@ private:
         if (! allOnOneLine)
             out << newLine;
 
-        LinkedListPointer<NamedValueSet::NamedValue>* i = &(props.values);
-
-        for (;;)
+        for (int i = 0; i < props.size(); ++i)
         {
-            NamedValueSet::NamedValue* const v = i->get();
-
-            if (v == nullptr)
-                break;
-
             if (! allOnOneLine)
                 writeSpaces (out, indentLevel + indentSize);
 
-            writeString (out, v->name);
+            const String::CharPointerType name (props.getName (i).getCharPointer());
+            writeString (out, name, name.findTerminatingNull());
             out << ": ";
-            write (out, v->value, indentLevel + indentSize, allOnOneLine);
+            write (out, props.getValueAt (i), indentLevel + indentSize, allOnOneLine);
 
-            if (v->nextListItem.get() != nullptr)
+            if (i < props.size() - 1)
             {
                 if (allOnOneLine)
                     out << ", ";
@@ -482,8 +561,6 @@ private:
             }
             else if (! allOnOneLine)
                 out << newLine;
-
-            i = &(v->nextListItem);
         }
 
         if (! allOnOneLine)
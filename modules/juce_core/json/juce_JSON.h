@@ -41,7 +41,7 @@ class File;
     functions allow you to parse JSON into a var object, and to convert a var
     object to JSON-formatted text.
 
-    @see var
+    @see var, JSONStreamParser, JSONStreamWriter, CompactVarFormat
 */
 class JUCE_API  JSON
 {
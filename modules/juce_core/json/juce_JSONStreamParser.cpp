@@ -0,0 +1,730 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace JSONStreamParserHelpers
+{
+    static inline bool isWhitespace (const char c) noexcept
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    static inline bool isNumberChar (const char c) noexcept
+    {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+    }
+
+    static char* writeUTF8 (char* dest, const juce_wchar c) noexcept
+    {
+        CharPointer_UTF8 p (dest);
+        p.write (c);
+        return p.getAddress();
+    }
+}
+
+//==============================================================================
+JSONStreamParser::JSONStreamParser (Listener& l)
+    : listener (l), state (expectValue),
+      numPendingBytes (0), pendingDataSize (0), decodedStringSize (0)
+{
+}
+
+JSONStreamParser::~JSONStreamParser()
+{
+}
+
+void JSONStreamParser::reset()
+{
+    state = expectValue;
+    containers.clearQuick();
+    numPendingBytes = 0;
+    error = String::empty;
+}
+
+Result JSONStreamParser::parse (const void* const data, const size_t numBytes)
+{
+    if (error.isEmpty())
+    {
+        if (numPendingBytes == 0)
+        {
+            // the usual case: parse straight from the caller's data, and keep any incomplete token at the end
+            const size_t numUsed = process (static_cast <const char*> (data), numBytes, false);
+
+            if (error.isEmpty())
+                appendToPendingData (static_cast <const char*> (data) + numUsed, numBytes - numUsed);
+        }
+        else
+        {
+            appendToPendingData (static_cast <const char*> (data), numBytes);
+
+            const size_t numUsed = process (pendingData, numPendingBytes, false);
+            numPendingBytes -= numUsed;
+            memmove (pendingData, pendingData + numUsed, numPendingBytes);
+            pendingData [numPendingBytes] = 0;
+        }
+    }
+
+    return error.isEmpty() ? Result::ok() : Result::fail (error);
+}
+
+Result JSONStreamParser::finish()
+{
+    if (error.isEmpty())
+    {
+        if (numPendingBytes > 0)
+        {
+            process (pendingData, numPendingBytes, true);
+            numPendingBytes = 0;
+        }
+
+        if (error.isEmpty() && (state != expectValue || containers.size() > 0))
+            error = "Unexpected end of input";
+    }
+
+    return error.isEmpty() ? Result::ok() : Result::fail (error);
+}
+
+Result JSONStreamParser::parse (InputStream& input)
+{
+    char buffer [16384];
+
+    for (;;)
+    {
+        const int numRead = input.read (buffer, sizeof (buffer));
+
+        if (numRead <= 0)
+            break;
+
+        const Result r (parse (buffer, (size_t) numRead));
+
+        if (r.failed())
+            return r;
+    }
+
+    return finish();
+}
+
+void JSONStreamParser::appendToPendingData (const char* const data, const size_t numBytes)
+{
+    if (numBytes > 0)
+    {
+        if (numPendingBytes + numBytes + 1 > pendingDataSize)
+        {
+            pendingDataSize = jmax ((size_t) 256, (numPendingBytes + numBytes + 1) * 2);
+            pendingData.realloc (pendingDataSize);
+        }
+
+        memcpy (pendingData + numPendingBytes, data, numBytes);
+        numPendingBytes += numBytes;
+
+        // (a terminator means that the number parser can't run off the end of the data)
+        pendingData [numPendingBytes] = 0;
+    }
+}
+
+void JSONStreamParser::setError (const char* const message, const char* const location, const char* const end)
+{
+    error = message;
+
+    if (location != nullptr && location < end)
+        error << ": \"" << String::fromUTF8 (location, (int) jmin ((size_t) 20, (size_t) (end - location))) << '"';
+}
+
+void JSONStreamParser::valueFinished()
+{
+    if (containers.size() == 0)
+    {
+        state = expectValue;
+        listener.documentEnded();
+    }
+    else
+    {
+        state = expectCommaOrEnd;
+    }
+}
+
+//==============================================================================
+size_t JSONStreamParser::process (const char* const data, const size_t numBytes, const bool isEndOfInput)
+{
+    using namespace JSONStreamParserHelpers;
+    const char* p = data;
+    const char* const end = data + numBytes;
+
+    for (;;)
+    {
+        while (p < end && isWhitespace (*p))
+            ++p;
+
+        if (p >= end)
+            return numBytes;
+
+        const char c = *p;
+
+        switch (state)
+        {
+            case expectColon:
+                if (c != ':')
+                {
+                    setError ("Expected ':', but found", p, end);
+                    return 0;
+                }
+
+                ++p;
+                state = expectValue;
+                continue;
+
+            case expectCommaOrEnd:
+                if (c == ',')
+                {
+                    ++p;
+                    state = (containers.getLast() == '{') ? expectProperty : expectValue;
+                    continue;
+                }
+
+                if (c == '}' || c == ']')
+                {
+                    if (containers.getLast() != (c == '}' ? '{' : '['))
+                    {
+                        setError ("Mismatched brackets", p, end);
+                        return 0;
+                    }
+
+                    ++p;
+                    containers.removeLast();
+
+                    if (c == '}')
+                        listener.objectEnded();
+                    else
+                        listener.arrayEnded();
+
+                    valueFinished();
+                    continue;
+                }
+
+                setError ("Expected ',' or closing bracket, but found", p, end);
+                return 0;
+
+            case expectPropertyOrObjectEnd:
+                if (c == '}')
+                {
+                    ++p;
+                    containers.removeLast();
+                    listener.objectEnded();
+                    valueFinished();
+                    continue;
+                }
+
+                // fall through..
+
+            case expectProperty:
+            {
+                if (c != '"')
+                {
+                    setError ("Expected object member declaration, but found", p, end);
+                    return 0;
+                }
+
+                const char* const next = readString (p, end, isEndOfInput, true);
+
+                if (next == nullptr)
+                    return error.isEmpty() ? (size_t) (p - data) : 0;
+
+                p = next;
+                state = expectColon;
+                continue;
+            }
+
+            case expectValueOrArrayEnd:
+                if (c == ']')
+                {
+                    ++p;
+                    containers.removeLast();
+                    listener.arrayEnded();
+                    valueFinished();
+                    continue;
+                }
+
+                // fall through..
+
+            case expectValue:
+            default:
+            {
+                if (c == '{')
+                {
+                    ++p;
+                    containers.add ('{');
+                    listener.objectStarted();
+                    state = expectPropertyOrObjectEnd;
+                    continue;
+                }
+
+                if (c == '[')
+                {
+                    ++p;
+                    containers.add ('[');
+                    listener.arrayStarted();
+                    state = expectValueOrArrayEnd;
+                    continue;
+                }
+
+                const char* next;
+
+                if (c == '"')
+                    next = readString (p, end, isEndOfInput, false);
+                else if (c == '-' || (c >= '0' && c <= '9'))
+                    next = readNumber (p, end, isEndOfInput);
+                else
+                    next = readKeyword (p, end, isEndOfInput);
+
+                if (next == nullptr)
+                    return error.isEmpty() ? (size_t) (p - data) : 0;
+
+                p = next;
+                valueFinished();
+                continue;
+            }
+        }
+    }
+}
+
+//==============================================================================
+const char* JSONStreamParser::readString (const char* const start, const char* const end,
+                                          const bool isEndOfInput, const bool isPropertyName)
+{
+    const char* const textStart = start + 1;
+    const char* p = textStart;
+
+    while (p < end && *p != '"' && *p != '\\')
+        ++p;
+
+    if (p < end && *p == '"')
+    {
+        // no escape sequences, so the listener can read the text directly from the input
+        if (isPropertyName)
+            listener.propertyName (CharPointer_UTF8 (textStart), CharPointer_UTF8 (p));
+        else
+            listener.stringValue (CharPointer_UTF8 (textStart), CharPointer_UTF8 (p));
+
+        return p + 1;
+    }
+
+    if (p >= end)
+    {
+        if (isEndOfInput)
+            setError ("Unexpected end-of-input in string constant", start, end);
+
+        return nullptr; // (the rest of the string is in the next chunk)
+    }
+
+    // (the decoded text can't be longer than the escaped version)
+    if (decodedStringSize < (size_t) (end - textStart) + 1)
+    {
+        decodedStringSize = (size_t) (end - textStart) * 2 + 64;
+        decodedString.malloc (decodedStringSize);
+    }
+
+    const size_t numPlainBytes = (size_t) (p - textStart);
+    memcpy (decodedString, textStart, numPlainBytes);
+    char* dest = decodedString + numPlainBytes;
+
+    while (p < end)
+    {
+        const char c = *p++;
+
+        if (c == '"')
+        {
+            if (isPropertyName)
+                listener.propertyName (CharPointer_UTF8 (decodedString), CharPointer_UTF8 (dest));
+            else
+                listener.stringValue (CharPointer_UTF8 (decodedString), CharPointer_UTF8 (dest));
+
+            return p;
+        }
+
+        if (c != '\\')
+        {
+            *dest++ = c;
+            continue;
+        }
+
+        if (p >= end)
+            break;
+
+        switch (*p++)
+        {
+            case '"':   *dest++ = '"';  break;
+            case '\\':  *dest++ = '\\'; break;
+            case '/':   *dest++ = '/';  break;
+            case 'b':   *dest++ = '\b'; break;
+            case 'f':   *dest++ = '\f'; break;
+            case 'n':   *dest++ = '\n'; break;
+            case 'r':   *dest++ = '\r'; break;
+            case 't':   *dest++ = '\t'; break;
+
+            case 'u':
+            {
+                if (end - p < 4)
+                {
+                    p = end;
+                    break;
+                }
+
+                juce_wchar u = 0;
+
+                for (int i = 0; i < 4; ++i)
+                {
+                    const int digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) *p++);
+
+                    if (digitValue < 0)
+                    {
+                        setError ("Syntax error in unicode escape sequence", start, end);
+                        return nullptr;
+                    }
+
+                    u = (juce_wchar) ((u << 4) + digitValue);
+                }
+
+                // combine a UTF-16 surrogate pair if there's one..
+                if (u >= 0xd800 && u < 0xdc00)
+                {
+                    if (end - p < 6 && ! isEndOfInput)
+                    {
+                        p = end;
+                        break;
+                    }
+
+                    if (end - p >= 6 && p[0] == '\\' && p[1] == 'u')
+                    {
+                        juce_wchar low = 0;
+
+                        for (int i = 2; i < 6; ++i)
+                        {
+                            const int digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) p[i]);
+                            low = (juce_wchar) ((low << 4) + jmax (0, digitValue));
+                        }
+
+                        if (low >= 0xdc00 && low < 0xe000)
+                        {
+                            u = (juce_wchar) (0x10000 + ((u - 0xd800) << 10) + (low - 0xdc00));
+                            p += 6;
+                        }
+                    }
+                }
+
+                dest = JSONStreamParserHelpers::writeUTF8 (dest, u);
+                break;
+            }
+
+            default:
+                setError ("Illegal escape sequence in string", start, end);
+                return nullptr;
+        }
+    }
+
+    if (isEndOfInput)
+        setError ("Unexpected end-of-input in string constant", start, end);
+
+    return nullptr;
+}
+
+const char* JSONStreamParser::readNumber (const char* const start, const char* const end, const bool isEndOfInput)
+{
+    const char* p = start;
+
+    while (p < end && JSONStreamParserHelpers::isNumberChar (*p))
+        ++p;
+
+    if (p == end && ! isEndOfInput)
+        return nullptr; // (more digits might follow in the next chunk)
+
+    const bool isNegative = (*start == '-');
+    const char* digits = isNegative ? start + 1 : start;
+
+    if (digits == p || *digits < '0' || *digits > '9')
+    {
+        setError ("Syntax error in number", start, end);
+        return nullptr;
+    }
+
+    // the fast path, for integers that fit into an int64 (19 digits can't overflow a uint64)..
+    if (p - digits <= 19)
+    {
+        uint64 value = 0;
+        const char* d = digits;
+
+        while (d < p && *d >= '0' && *d <= '9')
+            value = value * 10 + (uint64) (*d++ - '0');
+
+        const uint64 limit = (uint64) 0x7fffffffffffffffLL + (isNegative ? 1 : 0);
+
+        if (d == p && value <= limit)
+        {
+            listener.intValue (isNegative ? (int64) ((uint64) 0 - value) : (int64) value);
+            return p;
+        }
+    }
+
+    // (the character after the number is always within the data or a null terminator, so the
+    // double parser will stop at the end of the number)
+    CharPointer_UTF8 t (digits);
+    const double value = CharacterFunctions::readDoubleValue (t);
+
+    if (t.getAddress() != p)
+    {
+        setError ("Syntax error in number", start, end);
+        return nullptr;
+    }
+
+    listener.doubleValue (isNegative ? -value : value);
+    return p;
+}
+
+const char* JSONStreamParser::readKeyword (const char* const start, const char* const end, const bool isEndOfInput)
+{
+    static const char* const keywords[] = { "true", "false", "null" };
+
+    for (int i = 0; i < numElementsInArray (keywords); ++i)
+    {
+        const char* const keyword = keywords[i];
+
+        if (*start != *keyword)
+            continue;
+
+        const size_t keywordLength = strlen (keyword);
+        const size_t numAvailable = jmin (keywordLength, (size_t) (end - start));
+
+        if (memcmp (start, keyword, numAvailable) != 0)
+            break;
+
+        if (numAvailable < keywordLength)
+        {
+            if (isEndOfInput)
+                break;
+
+            return nullptr;
+        }
+
+        switch (i)
+        {
+            case 0:   listener.boolValue (true); break;
+            case 1:   listener.boolValue (false); break;
+            default:  listener.nullValue(); break;
+        }
+
+        return start + keywordLength;
+    }
+
+    setError ("Syntax error", start, end);
+    return nullptr;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONStreamParserTests  : public UnitTest
+{
+public:
+    JSONStreamParserTests() : UnitTest ("JSONStreamParser") {}
+
+    // Rebuilds a var from the parser's callbacks, so that it can be compared with JSON::parse()
+    struct VarBuilder  : public JSONStreamParser::Listener
+    {
+        VarBuilder() : numDocuments (0) {}
+
+        void objectStarted()        { stack.add (var (new DynamicObject())); }
+        void arrayStarted()         { stack.add (var (Array<var>())); }
+        void objectEnded()          { containerEnded(); }
+        void arrayEnded()           { containerEnded(); }
+
+        void propertyName (CharPointer_UTF8 start, CharPointer_UTF8 end)    { names.add (String (start, end)); }
+        void stringValue (CharPointer_UTF8 start, CharPointer_UTF8 end)     { addValue (String (start, end)); }
+
+        void intValue (int64 value)
+        {
+            if (value == (int64) (int) value)
+                addValue ((int) value);
+            else
+                addValue (value);
+        }
+
+        void doubleValue (double value)     { addValue (value); }
+        void boolValue (bool value)         { addValue (value); }
+        void nullValue()                    { addValue (var::null); }
+        void documentEnded()                { ++numDocuments; }
+
+        void containerEnded()
+        {
+            const var v (stack.getLast());
+            stack.removeLast();
+            addValue (v);
+        }
+
+        void addValue (const var& v)
+        {
+            if (stack.size() == 0)
+            {
+                result = v;
+            }
+            else if (DynamicObject* const o = stack.getLast().getDynamicObject())
+            {
+                o->setProperty (names [names.size() - 1], v);
+                names.remove (names.size() - 1);
+            }
+            else
+            {
+                stack.getReference (stack.size() - 1).append (v);
+            }
+        }
+
+        Array<var> stack;
+        StringArray names;
+        var result;
+        int numDocuments;
+    };
+
+    static String parseWithBuilder (const String& json, int maxChunkSize, Random& r, Result& result)
+    {
+        VarBuilder builder;
+        JSONStreamParser parser (builder);
+
+        const char* data = json.toRawUTF8();
+        size_t numLeft = json.getNumBytesAsUTF8();
+        result = Result::ok();
+
+        while (numLeft > 0 && result.wasOk())
+        {
+            const size_t chunkSize = jmin (numLeft, (size_t) (1 + r.nextInt (maxChunkSize)));
+            result = parser.parse (data, chunkSize);
+            data += chunkSize;
+            numLeft -= chunkSize;
+        }
+
+        if (result.wasOk())
+            result = parser.finish();
+
+        return JSON::toString (builder.result, true);
+    }
+
+    bool parsesOK (const char* json)
+    {
+        Random r;
+        Result result (Result::ok());
+        parseWithBuilder (json, 1, r, result);
+        return result.wasOk();
+    }
+
+    void runTest()
+    {
+        beginTest ("Parsing");
+        Random r;
+        r.setSeedRandomly();
+
+        for (int i = 100; --i >= 0;)
+        {
+            // (JSON::parse() only accepts an object or array at the top level)
+            const String json ("[" + JSON::toString (JSONTests::createRandomVar (r, 0), r.nextBool()) + "]");
+            const String expected (JSON::toString (JSON::parse (json), true));
+
+            Result result (Result::ok());
+            expect (parseWithBuilder (json, 1 << 20, r, result) == expected);
+            expect (result.wasOk());
+
+            expect (parseWithBuilder (json, 1 + r.nextInt (20), r, result) == expected);
+            expect (result.wasOk());
+        }
+
+        {
+            const String json ("[\"a\\u00e9\\ud83d\\ude00\\n\", \"plain\", -0.5e2, 1e300]");
+            Result result (Result::ok());
+            expect (parseWithBuilder (json, 1, r, result) == JSON::toString (JSON::parse (json), true));
+            expect (result.wasOk());
+
+            // (surrogate pairs are combined into a single character)
+            juce_wchar decoded[] = { 'a', 0xe9, 0x1f600, '\n', 0 };
+            VarBuilder builder;
+            JSONStreamParser parser (builder);
+            expect (parser.parse (json.toRawUTF8(), json.getNumBytesAsUTF8()).wasOk());
+            expect (builder.result[0] == String (CharPointer_UTF32 (decoded)));
+        }
+
+        {
+            VarBuilder builder;
+            JSONStreamParser parser (builder);
+            const char* const chunk1 = "{\"a\": 1}\n{\"b\": [2";
+            const char* const chunk2 = "]}\n7";
+
+            expect (parser.parse (chunk1, strlen (chunk1)).wasOk());
+            expect (builder.numDocuments == 1 && parser.getDepth() == 2);
+            expect (parser.parse (chunk2, strlen (chunk2)).wasOk() && builder.numDocuments == 2);
+            expect (parser.finish().wasOk() && builder.numDocuments == 3);
+        }
+
+        beginTest ("Errors");
+
+        expect (parsesOK ("{ \"a\": [1, 2.5, true, false, null, \"x\"], \"b\": {} }"));
+        expect (! parsesOK ("{ \"a\" 1 }"));
+        expect (! parsesOK ("[1, 2}"));
+        expect (! parsesOK ("[1, 2"));
+        expect (! parsesOK ("[tru]"));
+        expect (! parsesOK ("[1.2.3]"));
+        expect (! parsesOK ("[\"abc"));
+        expect (! parsesOK ("[\"\\q\"]"));
+        expect (! parsesOK ("{ 1: 2 }"));
+
+        beginTest ("Benchmark");
+
+        DynamicObject* const root = new DynamicObject();
+        var rootVar (root);
+
+        for (int i = 0; i < 2000; ++i)
+            root->setProperty ("item" + String (i), JSONTests::createRandomVar (r, 2));
+
+        const String json (JSON::toString (rootVar));
+        const int numIterations = 5;
+
+        const double startTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numIterations; ++i)
+            JSON::parse (json);
+
+        const double parseTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numIterations; ++i)
+        {
+            JSONStreamParser::Listener nullListener;
+            JSONStreamParser parser (nullListener);
+            expect (parser.parse (json.toRawUTF8(), json.getNumBytesAsUTF8()).wasOk() && parser.finish().wasOk());
+        }
+
+        const double streamTime = Time::getMillisecondCounterHiRes();
+
+        logMessage (String ((int) (json.getNumBytesAsUTF8() / 1024)) + " KB"
+                     + "  JSON::parse: " + String ((parseTime - startTime) / numIterations, 2) + " ms"
+                     + "  JSONStreamParser: " + String ((streamTime - parseTime) / numIterations, 2) + " ms");
+    }
+};
+
+static JSONStreamParserTests jsonStreamParserTests;
+
+#endif
@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_JSONSTREAMPARSER_JUCEHEADER__
+#define __JUCE_JSONSTREAMPARSER_JUCEHEADER__
+
+#include "../misc/juce_Result.h"
+#include "../containers/juce_Array.h"
+#include "../memory/juce_HeapBlock.h"
+class InputStream;
+
+
+//==============================================================================
+/**
+    An incremental JSON parser which reports what it finds to a listener, rather
+    than building a var structure.
+
+    You can feed it data in chunks of any size as it arrives (e.g. from a socket),
+    and it'll call the listener for every value as soon as it's complete. Strings and
+    numbers are read straight from the raw UTF-8 bytes: the listener is given a pointer
+    to the text of each string (in the caller's data wherever possible), so nothing is
+    allocated unless the string contains escape sequences, or is split between chunks.
+
+    @code
+    struct TemperatureReader  : public JSONStreamParser::Listener
+    {
+        void propertyName (CharPointer_UTF8 start, CharPointer_UTF8 end)
+        {
+            isTemperature = (String (start, end) == "temperature");
+        }
+
+        void doubleValue (double value)
+        {
+            if (isTemperature)
+                ...
+        }
+
+        bool isTemperature;
+    };
+
+    TemperatureReader reader;
+    JSONStreamParser parser (reader);
+
+    while (socket.waitUntilReady (true, -1) > 0)
+    {
+        const int numRead = socket.read (buffer, sizeof (buffer), false);
+        ...
+        if (parser.parse (buffer, (size_t) numRead).failed())
+            break;
+    }
+    @endcode
+
+    A sequence of top-level values (e.g. one document per line) can be fed to the same
+    parser, and Listener::documentEnded() is called at the end of each one. Nesting is
+    tracked without recursion, so there's no limit to the depth of the input.
+
+    @see JSON, JSONStreamWriter
+*/
+class JUCE_API  JSONStreamParser
+{
+public:
+    //==============================================================================
+    /** Receives the callbacks from a JSONStreamParser.
+
+        The text pointers passed to propertyName() and stringValue() are only valid
+        during the callback. All the methods have empty default implementations, so
+        you only need to override the ones you're interested in.
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener()  {}
+
+        /** Called when a '{' is found. */
+        virtual void objectStarted()                                            {}
+        /** Called at the end of an object. */
+        virtual void objectEnded()                                              {}
+        /** Called when a '[' is found. */
+        virtual void arrayStarted()                                             {}
+        /** Called at the end of an array. */
+        virtual void arrayEnded()                                               {}
+        /** Called with the name of an object's property, before its value is reported. */
+        virtual void propertyName (CharPointer_UTF8 /*start*/, CharPointer_UTF8 /*end*/)   {}
+        /** Called for a string value, with any escape sequences already decoded. */
+        virtual void stringValue (CharPointer_UTF8 /*start*/, CharPointer_UTF8 /*end*/)    {}
+        /** Called for a number that has no fractional part or exponent and fits into an int64. */
+        virtual void intValue (int64 /*value*/)                                 {}
+        /** Called for any other number. */
+        virtual void doubleValue (double /*value*/)                             {}
+        /** Called for a 'true' or 'false' value. */
+        virtual void boolValue (bool /*value*/)                                 {}
+        /** Called for a 'null' value. */
+        virtual void nullValue()                                                {}
+        /** Called after each complete top-level value. */
+        virtual void documentEnded()                                            {}
+    };
+
+    //==============================================================================
+    /** Creates a parser which will send its callbacks to the given listener. */
+    explicit JSONStreamParser (Listener& listener);
+
+    /** Destructor. */
+    ~JSONStreamParser();
+
+    //==============================================================================
+    /** Parses the next chunk of UTF-8 input.
+
+        Any part of a token that's incomplete at the end of the data is kept until the
+        next call. Once an error has been found, this will keep returning the same failure
+        until reset() is called.
+    */
+    Result parse (const void* utf8Data, size_t numBytes);
+
+    /** Tells the parser that there's no more input.
+        This completes a number that was at the very end of the data, and returns an error
+        if the input stopped part-way through a value.
+    */
+    Result finish();
+
+    /** Reads and parses everything from a stream, and then calls finish(). */
+    Result parse (InputStream& input);
+
+    /** Discards any partially-parsed input and errors, so that the parser can start again. */
+    void reset();
+
+    /** Returns the number of objects and arrays that the parser is currently inside. */
+    int getDepth() const noexcept                   { return containers.size(); }
+
+private:
+    //==============================================================================
+    enum State
+    {
+        expectValue,
+        expectValueOrArrayEnd,
+        expectPropertyOrObjectEnd,
+        expectProperty,
+        expectColon,
+        expectCommaOrEnd
+    };
+
+    Listener& listener;
+    State state;
+    Array<char> containers;
+    HeapBlock<char> pendingData, decodedString;
+    size_t numPendingBytes, pendingDataSize, decodedStringSize;
+    String error;
+
+    size_t process (const char* data, size_t numBytes, bool isEndOfInput);
+    const char* readString (const char* start, const char* end, bool isEndOfInput, bool isPropertyName);
+    const char* readNumber (const char* start, const char* end, bool isEndOfInput);
+    const char* readKeyword (const char* start, const char* end, bool isEndOfInput);
+    void appendToPendingData (const char* data, size_t numBytes);
+    void valueFinished();
+    void setError (const char* message, const char* location, const char* end);
+
+    JUCE_DECLARE_NON_COPYABLE (JSONStreamParser)
+};
+
+
+#endif   // __JUCE_JSONSTREAMPARSER_JUCEHEADER__
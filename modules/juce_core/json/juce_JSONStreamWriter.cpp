@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+JSONStreamWriter::JSONStreamWriter (OutputStream& destination, const bool oneLine)
+    : out (destination), numTopLevelValues (0),
+      allOnOneLine (oneLine), propertyNamePending (false)
+{
+}
+
+JSONStreamWriter::~JSONStreamWriter()
+{
+    // You've left some objects or arrays without closing them!
+    jassert (levels.size() == 0);
+}
+
+//==============================================================================
+void JSONStreamWriter::startItem()
+{
+    Level& level = levels.getReference (levels.size() - 1);
+
+    if (level.numItems++ > 0)
+    {
+        if (allOnOneLine)
+            out << ", ";
+        else
+            out << ',' << newLine;
+    }
+
+    if (! allOnOneLine)
+        JSONFormatter::writeSpaces (out, levels.size() * JSONFormatter::indentSize);
+}
+
+void JSONStreamWriter::startValue()
+{
+    if (levels.size() == 0)
+    {
+        if (numTopLevelValues++ > 0)
+            out << newLine;
+    }
+    else if (levels.getLast().isObject)
+    {
+        // Inside an object, each value must be preceded by a call to writePropertyName()!
+        jassert (propertyNamePending);
+        propertyNamePending = false;
+    }
+    else
+    {
+        startItem();
+    }
+}
+
+void JSONStreamWriter::startContainer (const bool isObject)
+{
+    startValue();
+    out << (isObject ? '{' : '[');
+
+    if (! allOnOneLine)
+        out << newLine;
+
+    const Level level = { isObject, 0 };
+    levels.add (level);
+}
+
+void JSONStreamWriter::endContainer (const bool isObject)
+{
+    // The brackets must be closed in the same order that they were opened!
+    jassert (levels.size() > 0 && levels.getLast().isObject == isObject);
+    // An object member has been given a name but no value!
+    jassert (! propertyNamePending);
+
+    if (levels.size() > 0)
+    {
+        const Level level (levels.getLast());
+        levels.removeLast();
+
+        if (! allOnOneLine)
+        {
+            if (level.numItems > 0)
+                out << newLine;
+
+            JSONFormatter::writeSpaces (out, levels.size() * JSONFormatter::indentSize);
+        }
+
+        out << (isObject ? '}' : ']');
+    }
+}
+
+void JSONStreamWriter::startObject()    { startContainer (true); }
+void JSONStreamWriter::endObject()      { endContainer (true); }
+void JSONStreamWriter::startArray()     { startContainer (false); }
+void JSONStreamWriter::endArray()       { endContainer (false); }
+
+void JSONStreamWriter::writePropertyName (const String& name)
+{
+    const String::CharPointerType t (name.getCharPointer());
+    writePropertyName (t, t.findTerminatingNull());
+}
+
+void JSONStreamWriter::writePropertyName (const char* const name)
+{
+    const CharPointer_UTF8 t (name);
+    writePropertyName (t, t.findTerminatingNull());
+}
+
+void JSONStreamWriter::writePropertyName (const CharPointer_UTF8 start, const CharPointer_UTF8 end)
+{
+    // Property names can only be written inside an object, and each one needs a value!
+    jassert (levels.size() > 0 && levels.getLast().isObject && ! propertyNamePending);
+
+    if (levels.size() > 0)
+        startItem();
+
+    JSONFormatter::writeString (out, start, end);
+    out << ": ";
+    propertyNamePending = true;
+}
+
+//==============================================================================
+void JSONStreamWriter::writeString (const String& text)
+{
+    const String::CharPointerType t (text.getCharPointer());
+    writeString (t, t.findTerminatingNull());
+}
+
+void JSONStreamWriter::writeString (const CharPointer_UTF8 start, const CharPointer_UTF8 end)
+{
+    startValue();
+    JSONFormatter::writeString (out, start, end);
+}
+
+void JSONStreamWriter::writeInt (const int64 value)
+{
+    startValue();
+    JSONFormatter::writeInt (out, value);
+}
+
+void JSONStreamWriter::writeDouble (const double value)
+{
+    startValue();
+    out << value;
+}
+
+void JSONStreamWriter::writeBool (const bool value)
+{
+    startValue();
+    out << (value ? "true" : "false");
+}
+
+void JSONStreamWriter::writeNull()
+{
+    startValue();
+    out << "null";
+}
+
+void JSONStreamWriter::writeVar (const var& value)
+{
+    startValue();
+    JSONFormatter::write (out, value, levels.size() * JSONFormatter::indentSize, allOnOneLine);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONStreamWriterTests  : public UnitTest
+{
+public:
+    JSONStreamWriterTests() : UnitTest ("JSONStreamWriter") {}
+
+    static void writeWithCalls (JSONStreamWriter& writer, const var& v)
+    {
+        if (v.isString())                   writer.writeString (v.toString());
+        else if (v.isVoid())                writer.writeNull();
+        else if (v.isBool())                writer.writeBool (static_cast<bool> (v));
+        else if (v.isInt() || v.isInt64())  writer.writeInt (static_cast<int64> (v));
+        else if (v.isDouble())              writer.writeDouble (static_cast<double> (v));
+        else if (const Array<var>* const array = v.getArray())
+        {
+            writer.startArray();
+
+            for (int i = 0; i < array->size(); ++i)
+                writeWithCalls (writer, array->getReference (i));
+
+            writer.endArray();
+        }
+        else if (DynamicObject* const object = v.getDynamicObject())
+        {
+            NamedValueSet& props = object->getProperties();
+            writer.startObject();
+
+            for (int i = 0; i < props.size(); ++i)
+            {
+                writer.writePropertyName (props.getName (i).toString());
+                writeWithCalls (writer, props.getValueAt (i));
+            }
+
+            writer.endObject();
+        }
+    }
+
+    void runTest()
+    {
+        beginTest ("Writing");
+        Random r;
+        r.setSeedRandomly();
+
+        for (int i = 100; --i >= 0;)
+        {
+            const var v (JSONTests::createRandomVar (r, 0));
+            const bool oneLine = r.nextBool();
+
+            MemoryOutputStream mo1, mo2;
+
+            {
+                JSONStreamWriter writer (mo1, oneLine);
+                writeWithCalls (writer, v);
+                expect (writer.getDepth() == 0);
+            }
+
+            {
+                JSONStreamWriter writer (mo2, oneLine);
+                writer.writeVar (v);
+            }
+
+            const String expected (JSON::toString (v, oneLine));
+            expect (mo1.toString() == expected);
+            expect (mo2.toString() == expected);
+        }
+
+        {
+            MemoryOutputStream mo;
+            JSONStreamWriter writer (mo, true);
+
+            writer.startObject();
+            writer.writePropertyName ("a\"b");
+            writer.startArray();
+            writer.writeInt (-9223372036854775807LL - 1);
+            writer.writeVar (JSON::parse ("{\"x\": [1, 2]}"));
+            writer.writeString (CharPointer_UTF8 ("tab\there"), CharPointer_UTF8 ("tab\there") + 3);
+            writer.endArray();
+            writer.endObject();
+            writer.writeNull();
+
+            expect (mo.toString() == String ("{\"a\\\"b\": [-9223372036854775808, {\"x\": [1, 2]}, \"tab\"]}") + NewLine::getDefault() + "null");
+        }
+    }
+};
+
+static JSONStreamWriterTests jsonStreamWriterTests;
+
+#endif
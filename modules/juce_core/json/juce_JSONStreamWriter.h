@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_JSONSTREAMWRITER_JUCEHEADER__
+#define __JUCE_JSONSTREAMWRITER_JUCEHEADER__
+
+#include "../containers/juce_Array.h"
+#include "../containers/juce_Variant.h"
+class OutputStream;
+
+
+//==============================================================================
+/**
+    Writes JSON directly to an OutputStream, one value at a time.
+
+    This lets you produce a large JSON document without first building it as a var
+    structure, or holding the whole text in memory. The commas, indentation and string
+    escaping are all taken care of, and the output is formatted in exactly the same way
+    as JSON::writeToStream() would format the equivalent var.
+
+    @code
+    JSONStreamWriter writer (stream);
+
+    writer.startObject();
+    writer.writePropertyName ("name");
+    writer.writeString ("Fred");
+    writer.writePropertyName ("scores");
+    writer.startArray();
+
+    for (int i = 0; i < numScores; ++i)
+        writer.writeInt (scores[i]);
+
+    writer.endArray();
+    writer.endObject();
+    @endcode
+
+    If you write more than one top-level value, each one is put on a new line.
+
+    @see JSON, JSONStreamParser
+*/
+class JUCE_API  JSONStreamWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer for a stream.
+        The stream must remain valid for the lifetime of the writer.
+    */
+    explicit JSONStreamWriter (OutputStream& destination, bool allOnOneLine = false);
+
+    /** Destructor. */
+    ~JSONStreamWriter();
+
+    //==============================================================================
+    /** Begins a new object. Each of its members must be written as a call to
+        writePropertyName() followed by a value, and it must be closed with endObject().
+    */
+    void startObject();
+
+    /** Closes the object that was begun by startObject(). */
+    void endObject();
+
+    /** Begins a new array, which must be closed with endArray(). */
+    void startArray();
+
+    /** Closes the array that was begun by startArray(). */
+    void endArray();
+
+    /** Writes the name of an object member. The next value that is written becomes its value. */
+    void writePropertyName (const String& name);
+
+    /** Writes the name of an object member. The next value that is written becomes its value. */
+    void writePropertyName (const char* name);
+
+    /** Writes the name of an object member from a range of UTF-8 text. */
+    void writePropertyName (CharPointer_UTF8 start, CharPointer_UTF8 end);
+
+    //==============================================================================
+    /** Writes a string value. */
+    void writeString (const String& text);
+
+    /** Writes a string value from a range of UTF-8 text. */
+    void writeString (CharPointer_UTF8 start, CharPointer_UTF8 end);
+
+    /** Writes an integer value. */
+    void writeInt (int64 value);
+
+    /** Writes a floating-point value. */
+    void writeDouble (double value);
+
+    /** Writes a 'true' or 'false' value. */
+    void writeBool (bool value);
+
+    /** Writes a 'null' value. */
+    void writeNull();
+
+    /** Writes a var, along with anything that it contains. */
+    void writeVar (const var& value);
+
+    //==============================================================================
+    /** Returns the number of objects and arrays that are currently open. */
+    int getDepth() const noexcept                   { return levels.size(); }
+
+private:
+    //==============================================================================
+    struct Level
+    {
+        bool isObject;
+        int numItems;
+    };
+
+    OutputStream& out;
+    Array<Level> levels;
+    int numTopLevelValues;
+    const bool allOnOneLine;
+    bool propertyNamePending;
+
+    void startValue();
+    void startItem();
+    void startContainer (bool isObject);
+    void endContainer (bool isObject);
+
+    JUCE_DECLARE_NON_COPYABLE (JSONStreamWriter)
+};
+
+
+#endif   // __JUCE_JSONSTREAMWRITER_JUCEHEADER__
@@ -48,6 +48,18 @@
  #include <cwctype>
 #endif
 
+#ifndef JUCE_USE_SSE_INTRINSICS
+ #define JUCE_USE_SSE_INTRINSICS 1
+#endif
+
+#if ! JUCE_INTEL
+ #undef JUCE_USE_SSE_INTRINSICS
+#endif
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#endif
+
 #if JUCE_WINDOWS
  #include <ctime>
  #include <winsock2.h>
@@ -86,6 +98,18 @@
  #include <sys/time.h>
  #include <net/if.h>
  #include <sys/ioctl.h>
+ #include <sys/uio.h>
+ #include <poll.h>
+
+ #if JUCE_LINUX || JUCE_ANDROID
+  #include <sys/epoll.h>
+  #include <sys/syscall.h>
+  #include <linux/futex.h>
+ #endif
+
+ #if JUCE_MAC || JUCE_IOS
+  #include <sys/event.h>
+ #endif
 
  #if ! JUCE_ANDROID
   #include <execinfo.h>
@@ -107,28 +131,45 @@ namespace juce
 {
 
 #include "containers/juce_AbstractFifo.cpp"
+#include "containers/juce_CompactVarFormat.cpp"
 #include "containers/juce_DynamicObject.cpp"
+#include "containers/juce_FlatHashMap.cpp"
+#include "containers/juce_LockFreeQueue.cpp"
 #include "containers/juce_NamedValueSet.cpp"
 #include "containers/juce_PropertySet.cpp"
 #include "containers/juce_Variant.cpp"
+#include "files/juce_AsyncFileIO.cpp"
+#include "files/juce_AsyncFileInputStream.cpp"
+#include "files/juce_AsyncFileOutputStream.cpp"
 #include "files/juce_DirectoryIterator.cpp"
+#include "files/juce_DirectoryScanner.cpp"
 #include "files/juce_File.cpp"
 #include "files/juce_FileInputStream.cpp"
 #include "files/juce_FileOutputStream.cpp"
 #include "files/juce_FileSearchPath.cpp"
+#include "files/juce_FileSystemWatcher.cpp"
 #include "files/juce_TemporaryFile.cpp"
+#include "files/juce_WindowedMemoryMappedFile.cpp"
 #include "json/juce_JSON.cpp"
+#include "json/juce_JSONStreamParser.cpp"
+#include "json/juce_JSONStreamWriter.cpp"
+#include "logging/juce_AsyncLogger.cpp"
 #include "logging/juce_FileLogger.cpp"
 #include "logging/juce_Logger.cpp"
 #include "maths/juce_BigInteger.cpp"
 #include "maths/juce_Expression.cpp"
 #include "maths/juce_Random.cpp"
+#include "memory/juce_FixedSizeMemoryPool.cpp"
+#include "memory/juce_MemoryArena.cpp"
 #include "memory/juce_MemoryBlock.cpp"
 #include "misc/juce_Result.cpp"
 #include "misc/juce_Uuid.cpp"
+#include "network/juce_HTTPClient.cpp"
 #include "network/juce_MACAddress.cpp"
 #include "network/juce_NamedPipe.cpp"
+#include "network/juce_SharedMemoryPipe.cpp"
 #include "network/juce_Socket.cpp"
+#include "network/juce_SocketEventLoop.cpp"
 #include "network/juce_URL.cpp"
 #include "network/juce_IPAddress.cpp"
 #include "streams/juce_BufferedInputStream.cpp"
@@ -144,22 +185,33 @@ namespace juce
 #include "text/juce_LocalisedStrings.cpp"
 #include "text/juce_String.cpp"
 #include "text/juce_StringArray.cpp"
+#include "text/juce_StringBuilder.cpp"
 #include "text/juce_StringPairArray.cpp"
 #include "text/juce_StringPool.cpp"
 #include "text/juce_TextDiff.cpp"
 #include "threads/juce_ChildProcess.cpp"
+#include "threads/juce_ChildProcessPool.cpp"
+#include "threads/juce_DeferredReleasePool.cpp"
+#include "threads/juce_ParallelAlgorithms.cpp"
 #include "threads/juce_ReadWriteLock.cpp"
+#include "threads/juce_RealtimeSafetyChecker.cpp"
 #include "threads/juce_Thread.cpp"
 #include "threads/juce_ThreadPool.cpp"
 #include "threads/juce_TimeSliceThread.cpp"
+#include "threads/juce_WorkerThreadGroup.cpp"
 #include "time/juce_PerformanceCounter.cpp"
 #include "time/juce_RelativeTime.cpp"
 #include "time/juce_Time.cpp"
+#include "unit_tests/juce_Benchmark.cpp"
 #include "unit_tests/juce_UnitTest.cpp"
+#include "xml/juce_CompactXmlTree.cpp"
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
+#include "xml/juce_XmlStreamReader.cpp"
 #include "zip/juce_GZIPDecompressorInputStream.cpp"
 #include "zip/juce_GZIPCompressorOutputStream.cpp"
+#include "zip/juce_LZDecompressorInputStream.cpp"
+#include "zip/juce_LZCompressorOutputStream.cpp"
 #include "zip/juce_ZipFile.cpp"
 
 //==============================================================================
@@ -213,3 +265,42 @@ namespace juce
 #include "threads/juce_HighResolutionTimer.cpp"
 
 }
+
+//==============================================================================
+#if JUCE_CHECK_REALTIME_SAFETY
+// Replacements for the global new and delete operators, so that allocations made
+// on a real-time thread can be reported. See RealtimeSafetyChecker.
+#if JUCE_COMPILER_SUPPORTS_NOEXCEPT
+ #define JUCE_OPERATOR_NEW_THROW_SPEC
+#else
+ #define JUCE_OPERATOR_NEW_THROW_SPEC throw (std::bad_alloc)
+#endif
+
+void* operator new (size_t size) JUCE_OPERATOR_NEW_THROW_SPEC
+{
+    juce::RealtimeSafetyChecker::checkOperation ("operator new");
+
+    if (void* const p = std::malloc (size > 0 ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (size_t size) JUCE_OPERATOR_NEW_THROW_SPEC
+{
+    return operator new (size);
+}
+
+void operator delete (void* p) noexcept
+{
+    JUCE_REALTIME_SAFETY_CHECK_FREE (p)
+    std::free (p);
+}
+
+void operator delete[] (void* p) noexcept
+{
+    operator delete (p);
+}
+
+#undef JUCE_OPERATOR_NEW_THROW_SPEC
+#endif
@@ -96,6 +96,18 @@ namespace DummyNamespaceStatementToCatchSyntaxErrors {}
  #define JUCE_CHECK_MEMORY_LEAKS 1
 #endif
 
+//=============================================================================
+/** Config: JUCE_CHECK_REALTIME_SAFETY
+
+    Enables checks which report any memory allocation, blocking lock, wait or sleep made by a
+    thread that has marked itself as real-time. See the RealtimeSafetyChecker class for details.
+    This replaces the global new and delete operators and adds overhead to every allocation,
+    so it's intended for debug builds only.
+*/
+#ifndef JUCE_CHECK_REALTIME_SAFETY
+ #define JUCE_CHECK_REALTIME_SAFETY 0
+#endif
+
 //=============================================================================
 /** Config: JUCE_DONT_AUTOLINK_TO_WIN32_LIBRARIES
 
@@ -157,18 +169,27 @@ namespace juce
 #ifndef __JUCE_ARRAYALLOCATIONBASE_JUCEHEADER__
  #include "containers/juce_ArrayAllocationBase.h"
 #endif
+#ifndef __JUCE_COMPACTVARFORMAT_JUCEHEADER__
+ #include "containers/juce_CompactVarFormat.h"
+#endif
 #ifndef __JUCE_DYNAMICOBJECT_JUCEHEADER__
  #include "containers/juce_DynamicObject.h"
 #endif
 #ifndef __JUCE_ELEMENTCOMPARATOR_JUCEHEADER__
  #include "containers/juce_ElementComparator.h"
 #endif
+#ifndef __JUCE_FLATHASHMAP_JUCEHEADER__
+ #include "containers/juce_FlatHashMap.h"
+#endif
 #ifndef __JUCE_HASHMAP_JUCEHEADER__
  #include "containers/juce_HashMap.h"
 #endif
 #ifndef __JUCE_LINKEDLISTPOINTER_JUCEHEADER__
  #include "containers/juce_LinkedListPointer.h"
 #endif
+#ifndef __JUCE_LOCKFREEQUEUE_JUCEHEADER__
+ #include "containers/juce_LockFreeQueue.h"
+#endif
 #ifndef __JUCE_NAMEDVALUESET_JUCEHEADER__
  #include "containers/juce_NamedValueSet.h"
 #endif
@@ -193,9 +214,21 @@ namespace juce
 #ifndef __JUCE_VARIANT_JUCEHEADER__
  #include "containers/juce_Variant.h"
 #endif
+#ifndef __JUCE_ASYNCFILEIO_JUCEHEADER__
+ #include "files/juce_AsyncFileIO.h"
+#endif
+#ifndef __JUCE_ASYNCFILEINPUTSTREAM_JUCEHEADER__
+ #include "files/juce_AsyncFileInputStream.h"
+#endif
+#ifndef __JUCE_ASYNCFILEOUTPUTSTREAM_JUCEHEADER__
+ #include "files/juce_AsyncFileOutputStream.h"
+#endif
 #ifndef __JUCE_DIRECTORYITERATOR_JUCEHEADER__
  #include "files/juce_DirectoryIterator.h"
 #endif
+#ifndef __JUCE_DIRECTORYSCANNER_JUCEHEADER__
+ #include "files/juce_DirectoryScanner.h"
+#endif
 #ifndef __JUCE_FILE_JUCEHEADER__
  #include "files/juce_File.h"
 #endif
@@ -208,15 +241,30 @@ namespace juce
 #ifndef __JUCE_FILESEARCHPATH_JUCEHEADER__
  #include "files/juce_FileSearchPath.h"
 #endif
+#ifndef __JUCE_FILESYSTEMWATCHER_JUCEHEADER__
+ #include "files/juce_FileSystemWatcher.h"
+#endif
 #ifndef __JUCE_MEMORYMAPPEDFILE_JUCEHEADER__
  #include "files/juce_MemoryMappedFile.h"
 #endif
 #ifndef __JUCE_TEMPORARYFILE_JUCEHEADER__
  #include "files/juce_TemporaryFile.h"
 #endif
+#ifndef __JUCE_WINDOWEDMEMORYMAPPEDFILE_JUCEHEADER__
+ #include "files/juce_WindowedMemoryMappedFile.h"
+#endif
 #ifndef __JUCE_JSON_JUCEHEADER__
  #include "json/juce_JSON.h"
 #endif
+#ifndef __JUCE_JSONSTREAMPARSER_JUCEHEADER__
+ #include "json/juce_JSONStreamParser.h"
+#endif
+#ifndef __JUCE_JSONSTREAMWRITER_JUCEHEADER__
+ #include "json/juce_JSONStreamWriter.h"
+#endif
+#ifndef __JUCE_ASYNCLOGGER_JUCEHEADER__
+ #include "logging/juce_AsyncLogger.h"
+#endif
 #ifndef __JUCE_FILELOGGER_JUCEHEADER__
  #include "logging/juce_FileLogger.h"
 #endif
@@ -244,6 +292,12 @@ namespace juce
 #ifndef __JUCE_BYTEORDER_JUCEHEADER__
  #include "memory/juce_ByteOrder.h"
 #endif
+#ifndef __JUCE_CONTAINERDELETEPOLICY_JUCEHEADER__
+ #include "memory/juce_ContainerDeletePolicy.h"
+#endif
+#ifndef __JUCE_FIXEDSIZEMEMORYPOOL_JUCEHEADER__
+ #include "memory/juce_FixedSizeMemoryPool.h"
+#endif
 #ifndef __JUCE_HEAPBLOCK_JUCEHEADER__
  #include "memory/juce_HeapBlock.h"
 #endif
@@ -253,6 +307,9 @@ namespace juce
 #ifndef __JUCE_MEMORY_JUCEHEADER__
  #include "memory/juce_Memory.h"
 #endif
+#ifndef __JUCE_MEMORYARENA_JUCEHEADER__
+ #include "memory/juce_MemoryArena.h"
+#endif
 #ifndef __JUCE_MEMORYBLOCK_JUCEHEADER__
  #include "memory/juce_MemoryBlock.h"
 #endif
@@ -280,6 +337,9 @@ namespace juce
 #ifndef __JUCE_WINDOWSREGISTRY_JUCEHEADER__
  #include "misc/juce_WindowsRegistry.h"
 #endif
+#ifndef __JUCE_HTTPCLIENT_JUCEHEADER__
+ #include "network/juce_HTTPClient.h"
+#endif
 #ifndef __JUCE_IPADDRESS_JUCEHEADER__
  #include "network/juce_IPAddress.h"
 #endif
@@ -289,9 +349,15 @@ namespace juce
 #ifndef __JUCE_NAMEDPIPE_JUCEHEADER__
  #include "network/juce_NamedPipe.h"
 #endif
+#ifndef __JUCE_SHAREDMEMORYPIPE_JUCEHEADER__
+ #include "network/juce_SharedMemoryPipe.h"
+#endif
 #ifndef __JUCE_SOCKET_JUCEHEADER__
  #include "network/juce_Socket.h"
 #endif
+#ifndef __JUCE_SOCKETEVENTLOOP_JUCEHEADER__
+ #include "network/juce_SocketEventLoop.h"
+#endif
 #ifndef __JUCE_URL_JUCEHEADER__
  #include "network/juce_URL.h"
 #endif
@@ -361,6 +427,9 @@ namespace juce
 #ifndef __JUCE_STRINGARRAY_JUCEHEADER__
  #include "text/juce_StringArray.h"
 #endif
+#ifndef __JUCE_STRINGBUILDER_JUCEHEADER__
+ #include "text/juce_StringBuilder.h"
+#endif
 #ifndef __JUCE_STRINGPAIRARRAY_JUCEHEADER__
  #include "text/juce_StringPairArray.h"
 #endif
@@ -373,9 +442,15 @@ namespace juce
 #ifndef __JUCE_CHILDPROCESS_JUCEHEADER__
  #include "threads/juce_ChildProcess.h"
 #endif
+#ifndef __JUCE_CHILDPROCESSPOOL_JUCEHEADER__
+ #include "threads/juce_ChildProcessPool.h"
+#endif
 #ifndef __JUCE_CRITICALSECTION_JUCEHEADER__
  #include "threads/juce_CriticalSection.h"
 #endif
+#ifndef __JUCE_DEFERREDRELEASEPOOL_JUCEHEADER__
+ #include "threads/juce_DeferredReleasePool.h"
+#endif
 #ifndef __JUCE_DYNAMICLIBRARY_JUCEHEADER__
  #include "threads/juce_DynamicLibrary.h"
 #endif
@@ -385,12 +460,18 @@ namespace juce
 #ifndef __JUCE_INTERPROCESSLOCK_JUCEHEADER__
  #include "threads/juce_InterProcessLock.h"
 #endif
+#ifndef __JUCE_PARALLELALGORITHMS_JUCEHEADER__
+ #include "threads/juce_ParallelAlgorithms.h"
+#endif
 #ifndef __JUCE_PROCESS_JUCEHEADER__
  #include "threads/juce_Process.h"
 #endif
 #ifndef __JUCE_READWRITELOCK_JUCEHEADER__
  #include "threads/juce_ReadWriteLock.h"
 #endif
+#ifndef __JUCE_REALTIMESAFETYCHECKER_JUCEHEADER__
+ #include "threads/juce_RealtimeSafetyChecker.h"
+#endif
 #ifndef __JUCE_SCOPEDLOCK_JUCEHEADER__
  #include "threads/juce_ScopedLock.h"
 #endif
@@ -418,6 +499,9 @@ namespace juce
 #ifndef __JUCE_WAITABLEEVENT_JUCEHEADER__
  #include "threads/juce_WaitableEvent.h"
 #endif
+#ifndef __JUCE_WORKERTHREADGROUP_JUCEHEADER__
+ #include "threads/juce_WorkerThreadGroup.h"
+#endif
 #ifndef __JUCE_PERFORMANCECOUNTER_JUCEHEADER__
  #include "time/juce_PerformanceCounter.h"
 #endif
@@ -427,21 +511,36 @@ namespace juce
 #ifndef __JUCE_TIME_JUCEHEADER__
  #include "time/juce_Time.h"
 #endif
+#ifndef __JUCE_BENCHMARK_JUCEHEADER__
+ #include "unit_tests/juce_Benchmark.h"
+#endif
 #ifndef __JUCE_UNITTEST_JUCEHEADER__
  #include "unit_tests/juce_UnitTest.h"
 #endif
+#ifndef __JUCE_COMPACTXMLTREE_JUCEHEADER__
+ #include "xml/juce_CompactXmlTree.h"
+#endif
 #ifndef __JUCE_XMLDOCUMENT_JUCEHEADER__
  #include "xml/juce_XmlDocument.h"
 #endif
 #ifndef __JUCE_XMLELEMENT_JUCEHEADER__
  #include "xml/juce_XmlElement.h"
 #endif
+#ifndef __JUCE_XMLSTREAMREADER_JUCEHEADER__
+ #include "xml/juce_XmlStreamReader.h"
+#endif
 #ifndef __JUCE_GZIPCOMPRESSOROUTPUTSTREAM_JUCEHEADER__
  #include "zip/juce_GZIPCompressorOutputStream.h"
 #endif
 #ifndef __JUCE_GZIPDECOMPRESSORINPUTSTREAM_JUCEHEADER__
  #include "zip/juce_GZIPDecompressorInputStream.h"
 #endif
+#ifndef __JUCE_LZCOMPRESSOROUTPUTSTREAM_JUCEHEADER__
+ #include "zip/juce_LZCompressorOutputStream.h"
+#endif
+#ifndef __JUCE_LZDECOMPRESSORINPUTSTREAM_JUCEHEADER__
+ #include "zip/juce_LZDecompressorInputStream.h"
+#endif
 #ifndef __JUCE_ZIPFILE_JUCEHEADER__
  #include "zip/juce_ZipFile.h"
 #endif
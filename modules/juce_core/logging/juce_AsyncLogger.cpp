@@ -0,0 +1,398 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+struct AsyncLogger::Record
+{
+    int64 time;             // (used to sort the different threads' messages back into order)
+    const char* label;      // the string literal passed to logValue(), or nullptr for a text message
+    double value;
+    int numTextBytes;       // the number of UTF-8 bytes that follow this header in the buffer
+};
+
+struct AsyncLogger::PendingMessage
+{
+    PendingMessage() noexcept : time (0) {}
+    PendingMessage (const int64 t, const String& s) : time (t), text (s) {}
+
+    int64 time;
+    String text;
+};
+
+struct AsyncLogger::PendingMessageComparator
+{
+    static int compareElements (const PendingMessage& first, const PendingMessage& second) noexcept
+    {
+        return first.time < second.time ? -1 : (first.time > second.time ? 1 : 0);
+    }
+};
+
+//==============================================================================
+/*  Each thread that logs gets one of these, which it adds records to without locking.
+    They're kept in a list which is only ever added to, and only get deleted along with
+    the logger, so the background thread can walk the list safely at any time.
+*/
+struct AsyncLogger::ThreadBuffer
+{
+    ThreadBuffer (const Thread::ThreadID threadId_, const int size)
+        : threadId (threadId_), fifo (size), data ((size_t) size), next (nullptr)
+    {
+    }
+
+    bool write (const Record& record, const void* const text) noexcept
+    {
+        const int numBytes = (int) sizeof (Record) + record.numTextBytes;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (numBytes, start1, size1, start2, size2);
+
+        if (size1 + size2 < numBytes)
+        {
+            ++numDropped;
+            return false;
+        }
+
+        copyIn (start1, &record, (int) sizeof (Record));
+        copyIn ((start1 + (int) sizeof (Record)) % fifo.getTotalSize(), text, record.numTextBytes);
+
+        fifo.finishedWrite (numBytes);
+        return true;
+    }
+
+    // Moves all the waiting records into the array, returning the number that were dropped
+    int read (Array<PendingMessage>& messages)
+    {
+        const int numDroppedHere = numDropped.exchange (0);
+        const int numReady = fifo.getNumReady();
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+        int pos = start1, numLeft = numReady;
+
+        if (numDroppedHere > 0)
+            messages.add (PendingMessage (numReady > 0 ? peekTime (pos) : Time::getHighResolutionTicks(),
+                                          "(" + String (numDroppedHere) + " messages were dropped because the log buffer was full)"));
+
+        while (numLeft >= (int) sizeof (Record))
+        {
+            Record record;
+            copyOut (pos, &record, (int) sizeof (Record));
+            pos = (pos + (int) sizeof (Record)) % fifo.getTotalSize();
+
+            if (record.label != nullptr)
+            {
+                messages.add (PendingMessage (record.time, String (CharPointer_UTF8 (record.label)) + ": " + String (record.value)));
+            }
+            else
+            {
+                HeapBlock<char> text ((size_t) record.numTextBytes + 1);
+                copyOut (pos, text, record.numTextBytes);
+                text [record.numTextBytes] = 0;
+                messages.add (PendingMessage (record.time, String (CharPointer_UTF8 (text))));
+            }
+
+            pos = (pos + record.numTextBytes) % fifo.getTotalSize();
+            numLeft -= (int) sizeof (Record) + record.numTextBytes;
+        }
+
+        fifo.finishedRead (numReady);
+        return numDroppedHere;
+    }
+
+    const Thread::ThreadID threadId;
+    AbstractFifo fifo;
+    HeapBlock<char> data;
+    Atomic<int> numDropped;
+    ThreadBuffer* next;
+
+private:
+    void copyIn (const int pos, const void* const source, const int numBytes) noexcept
+    {
+        const int numBeforeWrap = jmin (numBytes, fifo.getTotalSize() - pos);
+        memcpy (data + pos, source, (size_t) numBeforeWrap);
+        memcpy (data, static_cast <const char*> (source) + numBeforeWrap, (size_t) (numBytes - numBeforeWrap));
+    }
+
+    void copyOut (const int pos, void* const dest, const int numBytes) const noexcept
+    {
+        const int numBeforeWrap = jmin (numBytes, fifo.getTotalSize() - pos);
+        memcpy (dest, data + pos, (size_t) numBeforeWrap);
+        memcpy (static_cast <char*> (dest) + numBeforeWrap, data, (size_t) (numBytes - numBeforeWrap));
+    }
+
+    int64 peekTime (const int pos) const noexcept
+    {
+        Record record;
+        copyOut (pos, &record, (int) sizeof (Record));
+        return record.time;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ThreadBuffer)
+};
+
+//==============================================================================
+AsyncLogger::AsyncLogger (const File& file, const int bufferSizePerThread)
+    : Thread ("Async Logger"),
+      bufferSize (jmax (1024, bufferSizePerThread))
+{
+    if (! file.exists())
+        file.create();  // (to create the parent directories)
+
+    destStream.setOwned (new FileOutputStream (file));
+    startThread();
+}
+
+AsyncLogger::AsyncLogger (OutputStream* const destStream_, const bool deleteDestStreamWhenDestroyed,
+                          const int bufferSizePerThread)
+    : Thread ("Async Logger"),
+      destStream (destStream_, deleteDestStreamWhenDestroyed),
+      bufferSize (jmax (1024, bufferSizePerThread))
+{
+    jassert (destStream_ != nullptr);
+    startThread();
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stopThread (5000);
+    flush();
+
+    for (ThreadBuffer* b = firstBuffer.get(); b != nullptr;)
+    {
+        ThreadBuffer* const next = b->next;
+        delete b;
+        b = next;
+    }
+}
+
+//==============================================================================
+AsyncLogger::ThreadBuffer& AsyncLogger::getBufferForCurrentThread()
+{
+    const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+
+    for (ThreadBuffer* b = firstBuffer.get(); b != nullptr; b = b->next)
+        if (b->threadId == threadId)
+            return *b;
+
+    ThreadBuffer* const newBuffer = new ThreadBuffer (threadId, bufferSize);
+
+    do
+    {
+        newBuffer->next = firstBuffer.get();
+    }
+    while (! firstBuffer.compareAndSetBool (newBuffer, newBuffer->next));
+
+    return *newBuffer;
+}
+
+void AsyncLogger::prepareCurrentThread()
+{
+    getBufferForCurrentThread();
+}
+
+void AsyncLogger::logMessage (const String& message)
+{
+    const CharPointer_UTF8 utf8 (message.toUTF8());
+
+    Record record;
+    record.time = Time::getHighResolutionTicks();
+    record.label = nullptr;
+    record.value = 0;
+    record.numTextBytes = (int) jmin ((size_t) bufferSize / 2, message.getNumBytesAsUTF8());
+
+    ThreadBuffer& buffer = getBufferForCurrentThread();
+    buffer.write (record, utf8.getAddress());
+
+    // (logValue() doesn't do this, as waking the thread could block for a moment)
+    if (buffer.fifo.getNumReady() > bufferSize / 2)
+        notify();
+}
+
+bool AsyncLogger::logValue (const char* const stringLiteral, const double value)
+{
+    jassert (stringLiteral != nullptr);
+
+    Record record;
+    record.time = Time::getHighResolutionTicks();
+    record.label = stringLiteral;
+    record.value = value;
+    record.numTextBytes = 0;
+
+    return getBufferForCurrentThread().write (record, nullptr);
+}
+
+//==============================================================================
+void AsyncLogger::flush()
+{
+    const ScopedLock sl (flushLock);
+
+    Array<PendingMessage> messages;
+
+    for (ThreadBuffer* b = firstBuffer.get(); b != nullptr; b = b->next)
+        numDroppedMessages += b->read (messages);
+
+    if (messages.size() > 0)
+    {
+        PendingMessageComparator comparator;
+        messages.sort (comparator, true);
+
+        for (int i = 0; i < messages.size(); ++i)
+            *destStream << messages.getReference (i).text << newLine;
+
+        destStream->flush();
+    }
+}
+
+void AsyncLogger::run()
+{
+    while (! threadShouldExit())
+    {
+        wait (100);
+        flush();
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AsyncLoggerTests  : public UnitTest
+{
+public:
+    AsyncLoggerTests() : UnitTest ("AsyncLogger") {}
+
+    class LoggingThread  : public Thread
+    {
+    public:
+        LoggingThread (AsyncLogger& l, int index_, int numMessages_)
+            : Thread ("logging test"), logger (l), index (index_), numMessages (numMessages_) {}
+
+        void run()
+        {
+            for (int i = 0; i < numMessages; ++i)
+            {
+                if ((i & 1) == 0)
+                    logger.logMessage (String (index) + " " + String (i));
+                else
+                    logger.logValue ("value", index * 100000 + i);
+            }
+        }
+
+    private:
+        AsyncLogger& logger;
+        const int index, numMessages;
+    };
+
+    void runTest()
+    {
+        beginTest ("Multiple threads");
+
+        {
+            MemoryOutputStream output;
+            const int numThreads = 4, numMessages = 1000;
+
+            {
+                AsyncLogger logger (&output, false, 256 * 1024);
+                OwnedArray<LoggingThread> threads;
+
+                for (int i = 0; i < numThreads; ++i)
+                {
+                    threads.add (new LoggingThread (logger, i, numMessages));
+                    threads.getLast()->startThread();
+                }
+
+                for (int i = 0; i < numThreads; ++i)
+                    threads.getUnchecked (i)->waitForThreadToExit (10000);
+
+                expectEquals (logger.getNumDroppedMessages(), (int64) 0);
+            }
+
+            StringArray lines;
+            lines.addLines (output.toString());
+            lines.removeEmptyStrings();
+            expectEquals (lines.size(), numThreads * numMessages);
+
+            Array<int> lastIndexForThread;
+            lastIndexForThread.insertMultiple (0, -1, numThreads);
+            bool allInOrder = true;
+
+            for (int i = 0; i < lines.size(); ++i)
+            {
+                int thread, index;
+
+                if (lines[i].startsWith ("value: "))
+                {
+                    const int n = lines[i].fromFirstOccurrenceOf (": ", false, false).getIntValue();
+                    thread = n / 100000;
+                    index = n % 100000;
+                }
+                else
+                {
+                    thread = lines[i].upToFirstOccurrenceOf (" ", false, false).getIntValue();
+                    index = lines[i].fromFirstOccurrenceOf (" ", false, false).getIntValue();
+                }
+
+                allInOrder = allInOrder && isPositiveAndBelow (thread, numThreads)
+                                        && index == lastIndexForThread [thread] + 1;
+
+                if (isPositiveAndBelow (thread, numThreads))
+                    lastIndexForThread.set (thread, index);
+            }
+
+            expect (allInOrder);
+        }
+
+        beginTest ("Dropped messages");
+
+        {
+            MemoryOutputStream output;
+
+            {
+                AsyncLogger logger (&output, false, 1024);
+                logger.flush();
+
+                int numAccepted = 0;
+
+                for (int i = 0; i < 1000; ++i)
+                    if (logger.logValue ("x", i))
+                        ++numAccepted;
+
+                expect (numAccepted > 0 && numAccepted < 1000);
+
+                logger.flush();
+                expectEquals (logger.getNumDroppedMessages(), (int64) (1000 - numAccepted));
+
+                expect (logger.logValue ("after", 1.0));
+            }
+
+            const String text (output.toString());
+            expect (text.contains ("messages were dropped"));
+            expect (text.contains ("after: 1"));
+        }
+    }
+};
+
+static AsyncLoggerTests asyncLoggerTests;
+
+#endif
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ASYNCLOGGER_JUCEHEADER__
+#define __JUCE_ASYNCLOGGER_JUCEHEADER__
+
+#include "juce_Logger.h"
+#include "../files/juce_File.h"
+#include "../streams/juce_OutputStream.h"
+#include "../memory/juce_OptionalScopedPointer.h"
+#include "../threads/juce_Thread.h"
+#include "../threads/juce_CriticalSection.h"
+
+
+//==============================================================================
+/**
+    A Logger that writes its messages to a file or stream on a background thread.
+
+    Calling logMessage() just copies the text into a ring buffer that belongs to the
+    calling thread, without taking any locks, so threads that log don't hold each other
+    up or have to wait for the disk. A background thread collects the messages from all
+    the threads' buffers every so often, sorts them back into the order in which they were
+    logged, and writes them out in one batch. A thread whose buffer is getting full will
+    also wake the background thread up early.
+
+    If a thread logs faster than this, and fills up its buffer, its messages are dropped
+    rather than making it wait. A note of how many messages were lost is written into the
+    log, and the total is available from getNumDroppedMessages().
+
+    For logging from real-time threads, logValue() records a string literal and a number
+    without building a String, so it never allocates or blocks. Each thread's buffer is
+    allocated the first time it logs anything, so a real-time thread should call
+    prepareCurrentThread() before it starts its time-critical work.
+
+    @see FileLogger, Logger
+*/
+class JUCE_API  AsyncLogger  : public Logger,
+                               private Thread
+{
+public:
+    //==============================================================================
+    /** Creates a logger that appends to a file.
+        If the file doesn't exist, it will be created, along with any parent directories
+        that are needed.
+
+        @param fileToWriteTo            the file to append the messages to
+        @param bufferSizePerThread      the size of the buffer that each thread that logs gets
+                                        given, which limits how much it can log between one
+                                        batch being written and the next
+    */
+    AsyncLogger (const File& fileToWriteTo, int bufferSizePerThread = 64 * 1024);
+
+    /** Creates a logger that writes to a stream.
+
+        The stream is only ever used by the logger's background thread, and by flush().
+
+        @param destStream                       the stream to write the messages to
+        @param deleteDestStreamWhenDestroyed    whether the logger should delete the stream
+        @param bufferSizePerThread              the size of the buffer that each thread that logs gets
+                                                given, which limits how much it can log between one
+                                                batch being written and the next
+    */
+    AsyncLogger (OutputStream* destStream, bool deleteDestStreamWhenDestroyed,
+                 int bufferSizePerThread = 64 * 1024);
+
+    /** Destructor.
+        Any messages that are still waiting are written out before the logger is deleted.
+    */
+    ~AsyncLogger();
+
+    //==============================================================================
+    /** Adds a message to the calling thread's buffer, to be written out later.
+        This doesn't block, but the String that's passed in will normally have had to be
+        allocated, so it's not suitable for real-time threads - see logValue() instead.
+    */
+    void logMessage (const String& message);
+
+    /** Adds a message made of a string and a number to the calling thread's buffer.
+
+        Only the pointer to the string is stored, and the message isn't formatted until the
+        background thread writes it out, so the string must be a literal or something else
+        that will stay valid for the logger's lifetime. Unless this is the first time that
+        the thread has logged anything, this never allocates or blocks.
+
+        @returns false if the thread's buffer was full, and the message was dropped
+    */
+    bool logValue (const char* stringLiteral, double value);
+
+    /** Makes sure the calling thread has its buffer allocated, so that later calls to
+        logValue() won't need to allocate.
+    */
+    void prepareCurrentThread();
+
+    /** Writes out all the messages that are waiting, and flushes the destination stream.
+        This is done regularly by the background thread, but can also be called by any other
+        thread when the messages need to be written immediately.
+    */
+    void flush();
+
+    /** Returns the total number of messages that have been dropped because a thread's
+        buffer was full. Messages are only counted once flush() has seen them.
+    */
+    int64 getNumDroppedMessages() const noexcept            { return numDroppedMessages.get(); }
+
+
+private:
+    //==============================================================================
+    struct Record;
+    struct ThreadBuffer;
+    struct PendingMessage;
+    struct PendingMessageComparator;
+
+    OptionalScopedPointer<OutputStream> destStream;
+    const int bufferSize;
+    Atomic<ThreadBuffer*> firstBuffer;
+    Atomic<int64> numDroppedMessages;
+    CriticalSection flushLock;
+
+    ThreadBuffer& getBufferForCurrentThread();
+    void run();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncLogger)
+};
+
+
+#endif   // __JUCE_ASYNCLOGGER_JUCEHEADER__
@@ -376,6 +376,246 @@ int BigInteger::findNextClearBit (int i) const noexcept
     return i;
 }
 
+//==============================================================================
+namespace BigIntegerHelpers
+{
+    // These work on arrays of little-endian 32-bit words, using 64-bit intermediates.
+
+    // r += a, where r has at least as many words as a. Returns the carry out of the top of r.
+    static uint32 addWords (uint32* const r, const size_t numR, const uint32* const a, const size_t numA) noexcept
+    {
+        uint64 carry = 0;
+        size_t i = 0;
+
+        for (; i < numA; ++i)
+        {
+            carry += (uint64) r[i] + a[i];
+            r[i] = (uint32) carry;
+            carry >>= 32;
+        }
+
+        for (; carry != 0 && i < numR; ++i)
+        {
+            carry += r[i];
+            r[i] = (uint32) carry;
+            carry >>= 32;
+        }
+
+        return (uint32) carry;
+    }
+
+    // r -= a, where r has at least as many words as a. Returns the borrow out of the top of r.
+    static uint32 subtractWords (uint32* const r, const size_t numR, const uint32* const a, const size_t numA) noexcept
+    {
+        uint32 borrow = 0;
+        size_t i = 0;
+
+        for (; i < numA; ++i)
+        {
+            const uint64 difference = (uint64) r[i] - a[i] - borrow;
+            r[i] = (uint32) difference;
+            borrow = (uint32) (difference >> 32) & 1;
+        }
+
+        for (; borrow != 0 && i < numR; ++i)
+            borrow = (r[i]-- == 0) ? 1 : 0;
+
+        return borrow;
+    }
+
+    static int compareWords (const uint32* const a, const uint32* const b, size_t numWords) noexcept
+    {
+        while (numWords > 0)
+        {
+            --numWords;
+
+            if (a[numWords] != b[numWords])
+                return a[numWords] > b[numWords] ? 1 : -1;
+        }
+
+        return 0;
+    }
+
+    // r = a * b, where r has room for numA + numB words
+    static void multiplyWordsSimple (uint32* const r, const uint32* const a, const size_t numA,
+                                     const uint32* const b, const size_t numB) noexcept
+    {
+        zeromem (r, sizeof (uint32) * (numA + numB));
+
+        for (size_t i = 0; i < numB; ++i)
+        {
+            const uint64 multiplier = b[i];
+            uint64 carry = 0;
+
+            for (size_t j = 0; j < numA; ++j)
+            {
+                carry += r[i + j] + a[j] * multiplier;
+                r[i + j] = (uint32) carry;
+                carry >>= 32;
+            }
+
+            r[i + numA] = (uint32) carry;
+        }
+    }
+
+    // Below this many words, Karatsuba's extra additions cost more than they save.
+    enum { karatsubaThreshold = 32 };
+
+    // r = a * b, where a and b both have numWords words, and r has room for twice that
+    static void multiplyWordsKaratsuba (uint32* const r, const uint32* const a, const uint32* const b, const size_t numWords)
+    {
+        if (numWords < karatsubaThreshold)
+        {
+            multiplyWordsSimple (r, a, numWords, b, numWords);
+            return;
+        }
+
+        // With a = a1.x + a0 and b = b1.x + b0, a * b = a1.b1.x^2 + ((a0 + a1)(b0 + b1) - a0.b0 - a1.b1).x + a0.b0
+        const size_t low = numWords / 2, high = numWords - low;
+
+        multiplyWordsKaratsuba (r, a, b, low);
+        multiplyWordsKaratsuba (r + 2 * low, a + low, b + low, high);
+
+        HeapBlock<uint32> temp (4 * (high + 1));
+        uint32* const sumA = temp;
+        uint32* const sumB = temp + (high + 1);
+        uint32* const middle = temp + 2 * (high + 1);
+
+        memcpy (sumA, a + low, sizeof (uint32) * high);
+        memcpy (sumB, b + low, sizeof (uint32) * high);
+        sumA[high] = addWords (sumA, high, a, low);
+        sumB[high] = addWords (sumB, high, b, low);
+
+        multiplyWordsKaratsuba (middle, sumA, sumB, high + 1);
+
+        subtractWords (middle, 2 * (high + 1), r, 2 * low);
+        subtractWords (middle, 2 * (high + 1), r + 2 * low, 2 * high);
+
+        // (the middle term always fits into 2 * high + 1 words)
+        const uint32 carry = addWords (r + low, 2 * numWords - low, middle, 2 * high + 1);
+        jassert (carry == 0); (void) carry;
+    }
+
+    // r = a * b, where r has room for numA + numB words
+    static void multiplyWords (uint32* const r, const uint32* a, size_t numA, const uint32* b, size_t numB)
+    {
+        if (numA < numB)
+        {
+            std::swap (a, b);
+            std::swap (numA, numB);
+        }
+
+        if (numB < karatsubaThreshold)
+        {
+            multiplyWordsSimple (r, a, numA, b, numB);
+            return;
+        }
+
+        // the longer number is split into pieces the same size as the shorter one
+        zeromem (r, sizeof (uint32) * (numA + numB));
+        HeapBlock<uint32> piece (numB), product (2 * numB);
+
+        for (size_t pos = 0; pos < numA; pos += numB)
+        {
+            const size_t numInPiece = jmin (numB, numA - pos);
+            zeromem (piece, sizeof (uint32) * numB);
+            memcpy (piece, a + pos, sizeof (uint32) * numInPiece);
+
+            multiplyWordsKaratsuba (product, piece, b, numB);
+            addWords (r + pos, numA + numB - pos, product, numInPiece + numB);
+        }
+    }
+
+    // Knuth's algorithm D: finds the quotient (numU - numV + 1 words) and the remainder (numV words)
+    // of u / v, where numU >= numV and the top word of v is non-zero.
+    static void divideWords (uint32* const quotient, uint32* const remainder,
+                             const uint32* const u, const size_t numU,
+                             const uint32* const v, const size_t numV)
+    {
+        jassert (numU >= numV && v[numV - 1] != 0);
+
+        if (numV == 1)
+        {
+            uint64 rem = 0;
+
+            for (size_t j = numU; j-- > 0;)
+            {
+                rem = (rem << 32) | u[j];
+                quotient[j] = (uint32) (rem / v[0]);
+                rem -= quotient[j] * (uint64) v[0];
+            }
+
+            remainder[0] = (uint32) rem;
+            return;
+        }
+
+        // normalise, so that the top bit of the divisor is set
+        const int shift = 31 - BitFunctions::highestBitInInt (v[numV - 1]);
+        HeapBlock<uint32> vn (numV), un (numU + 1);
+
+        for (size_t i = numV - 1; i > 0; --i)
+            vn[i] = (v[i] << shift) | (uint32) ((uint64) v[i - 1] >> (32 - shift));
+
+        vn[0] = v[0] << shift;
+
+        un[numU] = (uint32) ((uint64) u[numU - 1] >> (32 - shift));
+
+        for (size_t i = numU - 1; i > 0; --i)
+            un[i] = (u[i] << shift) | (uint32) ((uint64) u[i - 1] >> (32 - shift));
+
+        un[0] = u[0] << shift;
+
+        const uint64 base = (uint64) 1 << 32;
+
+        for (size_t j = numU - numV + 1; j-- > 0;)
+        {
+            // estimate the next quotient word from the top two words, which can only be too big by 2 at most
+            const uint64 top = ((uint64) un[j + numV] << 32) | un[j + numV - 1];
+            uint64 estimate = top / vn[numV - 1];
+            uint64 estimateRemainder = top - estimate * vn[numV - 1];
+
+            while (estimate >= base
+                    || estimate * vn[numV - 2] > ((estimateRemainder << 32) | un[j + numV - 2]))
+            {
+                --estimate;
+                estimateRemainder += vn[numV - 1];
+
+                if (estimateRemainder >= base)
+                    break;
+            }
+
+            // multiply and subtract
+            uint64 borrow = 0, carry = 0;
+
+            for (size_t i = 0; i < numV; ++i)
+            {
+                carry += estimate * vn[i];
+                const uint64 difference = (uint64) un[i + j] - (uint32) carry - borrow;
+                un[i + j] = (uint32) difference;
+                borrow = (difference >> 32) & 1;
+                carry >>= 32;
+            }
+
+            const uint64 difference = (uint64) un[j + numV] - carry - borrow;
+            un[j + numV] = (uint32) difference;
+
+            if ((difference >> 32) != 0)
+            {
+                // the estimate was one too big, so add back a divisor's worth
+                --estimate;
+                un[j + numV] += addWords (un + j, numV, vn, numV);
+            }
+
+            quotient[j] = (uint32) estimate;
+        }
+
+        for (size_t i = 0; i < numV - 1; ++i)
+            remainder[i] = (un[i] >> shift) | (uint32) ((uint64) un[i + 1] << (32 - shift));
+
+        remainder[numV - 1] = un[numV - 1] >> shift;
+    }
+}
+
 //==============================================================================
 BigInteger& BigInteger::operator+= (const BigInteger& other)
 {
@@ -480,23 +720,25 @@ BigInteger& BigInteger::operator-= (const BigInteger& other)
 
 BigInteger& BigInteger::operator*= (const BigInteger& other)
 {
-    BigInteger total;
-    highestBit = getHighestBit();
-    const bool wasNegative = isNegative();
-    setNegative (false);
+    const int ourHB = getHighestBit();
+    const int otherHB = other.getHighestBit();
 
-    for (int i = 0; i <= highestBit; ++i)
+    if (ourHB < 0 || otherHB < 0)
     {
-        if (operator[](i))
-        {
-            BigInteger n (other);
-            n.setNegative (false);
-            n <<= i;
-            total += n;
-        }
+        clear();
+        return *this;
     }
 
-    total.setNegative (wasNegative ^ other.isNegative());
+    const size_t numWords = bitToIndex (ourHB) + 1;
+    const size_t numOtherWords = bitToIndex (otherHB) + 1;
+
+    BigInteger total;
+    total.ensureSize (numWords + numOtherWords);
+    BigIntegerHelpers::multiplyWords (total.values, values, numWords, other.values, numOtherWords);
+
+    total.highestBit = ourHB + otherHB + 1;
+    total.highestBit = total.getHighestBit();
+    total.setNegative (isNegative() ^ other.isNegative());
     swapWith (total);
     return *this;
 }
@@ -517,30 +759,34 @@ void BigInteger::divideBy (const BigInteger& divisor, BigInteger& remainder)
     else
     {
         const bool wasNegative = isNegative();
+        const bool divisorWasNegative = divisor.isNegative();
+        const size_t numWords = bitToIndex (ourHB) + 1;
+        const size_t numDivisorWords = bitToIndex (divHB) + 1;
 
-        swapWith (remainder);
-        remainder.setNegative (false);
-        clear();
-
-        BigInteger temp (divisor);
-        temp.setNegative (false);
-
-        int leftShift = ourHB - divHB;
-        temp <<= leftShift;
+        BigInteger dividend;
+        swapWith (dividend);
 
-        while (leftShift >= 0)
+        if (numWords < numDivisorWords)
         {
-            if (remainder.compareAbsolute (temp) >= 0)
-            {
-                remainder -= temp;
-                setBit (leftShift);
-            }
+            remainder.swapWith (dividend);
+        }
+        else
+        {
+            const size_t numQuotientWords = numWords - numDivisorWords + 1;
+            ensureSize (numQuotientWords);
+            remainder.clear();
+            remainder.ensureSize (numDivisorWords);
+
+            BigIntegerHelpers::divideWords (values, remainder.values, dividend.values, numWords,
+                                            divisor.values, numDivisorWords);
 
-            if (--leftShift >= 0)
-                temp >>= 1;
+            highestBit = (int) numQuotientWords * 32 - 1;
+            highestBit = getHighestBit();
+            remainder.highestBit = (int) numDivisorWords * 32 - 1;
+            remainder.highestBit = remainder.getHighestBit();
         }
 
-        negative = wasNegative ^ divisor.isNegative();
+        negative = wasNegative ^ divisorWasNegative;
         remainder.setNegative (wasNegative);
     }
 }
@@ -820,27 +1066,186 @@ BigInteger BigInteger::findGreatestCommonDivisor (BigInteger n) const
     return m;
 }
 
+//==============================================================================
+namespace BigIntegerHelpers
+{
+    /* Does Montgomery multiplication, which finds (a * b / R) mod n for an odd modulus n,
+       where R = 2 ^ (32 * numWords). Working with values multiplied by R means that the
+       reductions after each step can be done with word multiplies and shifts instead of
+       a division.
+    */
+    class MontgomeryMultiplier
+    {
+    public:
+        MontgomeryMultiplier (const uint32* const modulus_, const size_t numWords_)
+            : modulus (modulus_), numWords (numWords_), temp (numWords_ + 2)
+        {
+            jassert ((modulus[0] & 1) != 0);
+
+            // Newton's iteration doubles the number of correct low bits each time
+            uint32 inverse = modulus[0];
+
+            for (int i = 0; i < 4; ++i)
+                inverse *= 2 - modulus[0] * inverse;
+
+            negativeInverse = (uint32) 0 - inverse;
+        }
+
+        // The arguments all have numWords words, and the result may be the same array as a or b.
+        void multiply (uint32* const result, const uint32* const a, const uint32* const b) noexcept
+        {
+            uint32* const t = temp;
+            zeromem (t, sizeof (uint32) * (numWords + 2));
+
+            for (size_t i = 0; i < numWords; ++i)
+            {
+                const uint64 multiplier = b[i];
+                uint64 carry = 0;
+
+                for (size_t j = 0; j < numWords; ++j)
+                {
+                    carry += t[j] + a[j] * multiplier;
+                    t[j] = (uint32) carry;
+                    carry >>= 32;
+                }
+
+                carry += t[numWords];
+                t[numWords] = (uint32) carry;
+                t[numWords + 1] = (uint32) (carry >> 32);
+
+                // adds a multiple of the modulus that clears the bottom word, and shifts down a word
+                const uint64 m = (uint32) (t[0] * negativeInverse);
+                carry = (t[0] + m * modulus[0]) >> 32;
+
+                for (size_t j = 1; j < numWords; ++j)
+                {
+                    carry += t[j] + m * modulus[j];
+                    t[j - 1] = (uint32) carry;
+                    carry >>= 32;
+                }
+
+                carry += t[numWords];
+                t[numWords - 1] = (uint32) carry;
+                t[numWords] = t[numWords + 1] + (uint32) (carry >> 32);
+            }
+
+            if (t[numWords] != 0 || compareWords (t, modulus, numWords) >= 0)
+                subtractWords (t, numWords + 1, modulus, numWords);
+
+            memcpy (result, t, sizeof (uint32) * numWords);
+        }
+
+    private:
+        const uint32* const modulus;
+        const size_t numWords;
+        HeapBlock<uint32> temp;
+        uint32 negativeInverse;
+
+        JUCE_DECLARE_NON_COPYABLE (MontgomeryMultiplier)
+    };
+
+    static void copyToWords (uint32* const dest, const size_t numWords, const BigInteger& source) noexcept
+    {
+        for (size_t i = 0; i < numWords; ++i)
+            dest[i] = source.getBitRangeAsInt ((int) i * 32, 32);
+    }
+}
+
 void BigInteger::exponentModulo (const BigInteger& exponent, const BigInteger& modulus)
 {
     BigInteger exp (exponent);
     exp %= modulus;
 
-    BigInteger value (1);
-    swapWith (value);
-    value %= modulus;
+    if (modulus.isNegative() || isNegative() || exp.isNegative()
+         || ! modulus[0] || modulus.getHighestBit() < 32)
+    {
+        BigInteger value (1);
+        swapWith (value);
+        value %= modulus;
+
+        while (! exp.isZero())
+        {
+            if (exp [0])
+            {
+                operator*= (value);
+                operator%= (modulus);
+            }
+
+            value *= value;
+            value %= modulus;
+            exp >>= 1;
+        }
+
+        return;
+    }
+
+    // For an odd modulus, all the work is done with Montgomery multiplication, and a sliding
+    // window over the exponent bits, which needs far fewer multiplications than going bit-by-bit
+    using namespace BigIntegerHelpers;
+
+    const size_t numWords = bitToIndex (modulus.getHighestBit()) + 1;
+    const int expHighestBit = exp.getHighestBit();
+    const int windowSize = expHighestBit > 671 ? 6 : (expHighestBit > 239 ? 5 : (expHighestBit > 79 ? 4 : (expHighestBit > 23 ? 3 : 1)));
+    const size_t numOddPowers = (size_t) 1 << (windowSize - 1);
 
-    while (! exp.isZero())
+    HeapBlock<uint32> modulusWords (numWords), rSquared (numWords), one (numWords, true),
+                      result (numWords), oddPowers (numWords * numOddPowers);
+
+    copyToWords (modulusWords, numWords, modulus);
+
+    {
+        BigInteger r;
+        r.setBit ((int) numWords * 64);
+        r %= modulus;
+        copyToWords (rSquared, numWords, r);
+
+        BigInteger base (*this);
+        base %= modulus;
+        copyToWords (oddPowers, numWords, base);
+    }
+
+    MontgomeryMultiplier montgomery (modulusWords, numWords);
+
+    // builds a table of base^1, base^3, base^5...
+    montgomery.multiply (oddPowers, oddPowers, rSquared);
+    montgomery.multiply (result, oddPowers, oddPowers);
+
+    for (size_t i = 1; i < numOddPowers; ++i)
+        montgomery.multiply (oddPowers + i * numWords, oddPowers + (i - 1) * numWords, result);
+
+    one[0] = 1;
+    montgomery.multiply (result, one, rSquared);
+
+    for (int i = expHighestBit; i >= 0;)
     {
-        if (exp [0])
+        if (! exp[i])
         {
-            operator*= (value);
-            operator%= (modulus);
+            montgomery.multiply (result, result, result);
+            --i;
+            continue;
         }
 
-        value *= value;
-        value %= modulus;
-        exp >>= 1;
+        // finds the longest run of bits that fits the window and ends in a 1
+        int windowStart = jmax (0, i - windowSize + 1);
+
+        while (! exp[windowStart])
+            ++windowStart;
+
+        for (int j = windowStart; j <= i; ++j)
+            montgomery.multiply (result, result, result);
+
+        const uint32 window = exp.getBitRangeAsInt (windowStart, i - windowStart + 1);
+        montgomery.multiply (result, result, oddPowers + (window >> 1) * numWords);
+        i = windowStart - 1;
     }
+
+    montgomery.multiply (result, result, one);
+
+    clear();
+    ensureSize (numWords);
+    memcpy (values, result, sizeof (uint32) * numWords);
+    highestBit = (int) numWords * 32 - 1;
+    highestBit = getHighestBit();
 }
 
 void BigInteger::inverseModulo (const BigInteger& modulus)
@@ -1016,3 +1421,128 @@ void BigInteger::loadFromMemoryBlock (const MemoryBlock& data)
     for (int i = (int) data.getSize(); --i >= 0;)
         this->setBitRangeAsInt (i << 3, 8, (uint32) data [i]);
 }
+
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class BigIntegerTests  : public UnitTest
+{
+public:
+    BigIntegerTests() : UnitTest ("BigInteger") {}
+
+    static BigInteger getRandomNumber (Random& r, const int maxBits)
+    {
+        BigInteger n;
+        r.fillBitsRandomly (n, 0, r.nextInt (maxBits) + 1);
+        return n;
+    }
+
+    static BigInteger multiplyByShifting (const BigInteger& a, const BigInteger& b)
+    {
+        BigInteger total;
+
+        for (int i = b.getHighestBit(); i >= 0; --i)
+            if (b[i])
+                total += a << i;
+
+        return total;
+    }
+
+    static BigInteger exponentModuloBitByBit (BigInteger value, BigInteger exponent, const BigInteger& modulus)
+    {
+        BigInteger result (1);
+        exponent %= modulus;
+        value %= modulus;
+
+        while (! exponent.isZero())
+        {
+            if (exponent[0])
+                result = (result * value) % modulus;
+
+            value = (value * value) % modulus;
+            exponent >>= 1;
+        }
+
+        return result;
+    }
+
+    void runTest()
+    {
+        Random r;
+
+        beginTest ("Multiplication");
+
+        for (int i = 0; i < 100; ++i)
+        {
+            BigInteger a (getRandomNumber (r, 4000)), b (getRandomNumber (r, 4000));
+            a.setNegative (r.nextBool());
+
+            BigInteger expected (multiplyByShifting (a, b));
+            expected.setNegative (a.isNegative());
+
+            expect (a * b == expected);
+        }
+
+        beginTest ("Division");
+
+        for (int i = 0; i < 100; ++i)
+        {
+            BigInteger a (getRandomNumber (r, 4000)), b (getRandomNumber (r, 2000) + 1);
+            a.setNegative (r.nextBool());
+            b.setNegative (r.nextBool());
+
+            BigInteger quotient (a), remainder;
+            quotient.divideBy (b, remainder);
+
+            expect (quotient * b + remainder == a);
+            expect (remainder.compareAbsolute (b) < 0);
+        }
+
+        expectEquals (BigInteger ((int64) 1234567890123456789LL).toString (10), String ("1234567890123456789"));
+
+        beginTest ("Exponent modulo");
+
+        for (int i = 0; i < 30; ++i)
+        {
+            BigInteger modulus (getRandomNumber (r, 1200));
+
+            if (i % 3 != 0)
+                modulus.setBit (0);   // (an odd modulus uses Montgomery multiplication)
+
+            const BigInteger value (getRandomNumber (r, 1500)), exponent (getRandomNumber (r, 1200));
+
+            BigInteger result (value);
+            result.exponentModulo (exponent, modulus);
+
+            expect (result == exponentModuloBitByBit (value, exponent, modulus));
+        }
+
+        beginTest ("Exponent modulo speed");
+
+        {
+            BigInteger modulus, value, exponent;
+            r.fillBitsRandomly (modulus, 0, 2048);
+            r.fillBitsRandomly (value, 0, 2048);
+            r.fillBitsRandomly (exponent, 0, 2048);
+            modulus.setBit (2047);
+            modulus.setBit (0);
+
+            double start = Time::getMillisecondCounterHiRes();
+            BigInteger result (value);
+            result.exponentModulo (exponent, modulus);
+            const double fastTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            expect (result == exponentModuloBitByBit (value, exponent, modulus));
+            const double bitByBitTime = Time::getMillisecondCounterHiRes() - start;
+
+            logMessage ("2048-bit exponentModulo: " + String (fastTime, 1) + " ms, bit-by-bit with division: "
+                          + String (bitByBitTime, 1) + " ms");
+        }
+    }
+};
+
+static BigIntegerTests bigIntegerTests;
+
+#endif
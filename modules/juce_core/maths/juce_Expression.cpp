@@ -1180,3 +1180,327 @@ String Expression::Scope::getScopeUID() const
 {
     return String::empty;
 }
+
+//==============================================================================
+Expression::Compiled::Compiled (const Expression& expression, const Scope& scope_, const StringArray& inputSymbols)
+    : inputNames (inputSymbols),
+      scope (scope_),
+      cachedResult (0),
+      needsEvaluating (true)
+{
+    inputValues.insertMultiple (0, 0.0, inputNames.size());
+    inputsUsed.insertMultiple (0, false, inputNames.size());
+
+    try
+    {
+        compile (expression.term, 0);
+    }
+    catch (Helpers::EvaluationError& e)
+    {
+        error = e.description;
+        program.clear();
+        inputsUsed.clearQuick();
+        inputsUsed.insertMultiple (0, false, inputNames.size());
+        addInstruction (pushConstant, 0, 0, 0.0);
+    }
+
+    // work out how deep the stack can get..
+    int depth = 0, maxDepth = 1;
+
+    for (int i = 0; i < program.size(); ++i)
+    {
+        const Instruction& in = program.getReference (i);
+
+        switch (in.type)
+        {
+            case pushConstant:
+            case pushInput:     ++depth; break;
+            case negateValue:   break;
+            case callFunction:  depth += 1 - in.numParameters; break;
+            default:            --depth; break;
+        }
+
+        maxDepth = jmax (maxDepth, depth);
+    }
+
+    stack.malloc ((size_t) maxDepth);
+}
+
+Expression::Compiled::~Compiled()
+{
+}
+
+void Expression::Compiled::addInstruction (const InstructionType type, const int index,
+                                           const int numParameters, const double value)
+{
+    const Instruction in = { type, index, numParameters, value };
+    program.add (in);
+}
+
+bool Expression::Compiled::endsWithConstants (const int numConstants) const noexcept
+{
+    if (numConstants > program.size())
+        return false;
+
+    for (int i = program.size() - numConstants; i < program.size(); ++i)
+        if (program.getReference (i).type != pushConstant)
+            return false;
+
+    return true;
+}
+
+void Expression::Compiled::compile (Term* const t, const int recursionDepth)
+{
+    Helpers::checkRecursionDepth (recursionDepth);
+
+    switch (t->getType())
+    {
+        case constantType:
+            addInstruction (pushConstant, 0, 0, t->toDouble());
+            break;
+
+        case symbolType:
+        {
+            const String symbol (t->getName());
+            const int inputIndex = inputNames.indexOf (symbol);
+
+            if (inputIndex >= 0)
+            {
+                inputsUsed.set (inputIndex, true);
+                addInstruction (pushInput, inputIndex, 0, 0.0);
+            }
+            else
+            {
+                // (any other symbols are assumed not to change, so are inlined)
+                const Expression value (scope.getSymbolValue (symbol));
+                compile (value.term, recursionDepth + 1);
+            }
+
+            break;
+        }
+
+        case functionType:
+        {
+            const int numParams = t->getNumInputs();
+
+            for (int i = 0; i < numParams; ++i)
+                compile (t->getInput (i), recursionDepth + 1);
+
+            if (endsWithConstants (numParams))
+            {
+                HeapBlock<double> params ((size_t) numParams + 1);
+
+                for (int i = 0; i < numParams; ++i)
+                    params[i] = program.getReference (program.size() - numParams + i).value;
+
+                program.removeRange (program.size() - numParams, numParams);
+                addInstruction (pushConstant, 0, 0, scope.evaluateFunction (t->getName(), params, numParams));
+            }
+            else
+            {
+                functionNames.addIfNotAlreadyThere (t->getName());
+                addInstruction (callFunction, functionNames.indexOf (t->getName()), numParams, 0.0);
+            }
+
+            break;
+        }
+
+        case operatorType:
+        {
+            if (dynamic_cast <Helpers::DotOperator*> (t) != nullptr)
+            {
+                // relative scopes can't be compiled, so these are evaluated now
+                addInstruction (pushConstant, 0, 0, t->resolve (scope, recursionDepth)->toDouble());
+                break;
+            }
+
+            if (dynamic_cast <Helpers::Negate*> (t) != nullptr)
+            {
+                compile (t->getInput (0), recursionDepth);
+
+                if (endsWithConstants (1))
+                    program.getReference (program.size() - 1).value *= -1.0;
+                else
+                    addInstruction (negateValue, 0, 0, 0.0);
+
+                break;
+            }
+
+            Helpers::BinaryTerm* const binaryTerm = dynamic_cast <Helpers::BinaryTerm*> (t);
+            jassert (binaryTerm != nullptr);
+
+            compile (t->getInput (0), recursionDepth);
+            compile (t->getInput (1), recursionDepth);
+
+            if (endsWithConstants (2))
+            {
+                const double result = binaryTerm->performFunction (program.getReference (program.size() - 2).value,
+                                                                   program.getReference (program.size() - 1).value);
+                program.removeRange (program.size() - 2, 2);
+                addInstruction (pushConstant, 0, 0, result);
+            }
+            else if (dynamic_cast <Helpers::Add*> (t) != nullptr)       addInstruction (addValues, 0, 0, 0.0);
+            else if (dynamic_cast <Helpers::Subtract*> (t) != nullptr)  addInstruction (subtractValues, 0, 0, 0.0);
+            else if (dynamic_cast <Helpers::Multiply*> (t) != nullptr)  addInstruction (multiplyValues, 0, 0, 0.0);
+            else if (dynamic_cast <Helpers::Divide*> (t) != nullptr)    addInstruction (divideValues, 0, 0, 0.0);
+            else                                                        jassertfalse;
+
+            break;
+        }
+
+        default:
+            jassertfalse;
+            break;
+    }
+}
+
+double Expression::Compiled::run() const
+{
+    double* sp = stack;
+
+    for (int i = 0; i < program.size(); ++i)
+    {
+        const Instruction& in = program.getReference (i);
+
+        switch (in.type)
+        {
+            case pushConstant:      *sp++ = in.value; break;
+            case pushInput:         *sp++ = inputValues.getUnchecked (in.index); break;
+            case addValues:         --sp; sp[-1] += *sp; break;
+            case subtractValues:    --sp; sp[-1] -= *sp; break;
+            case multiplyValues:    --sp; sp[-1] *= *sp; break;
+            case divideValues:      --sp; sp[-1] /= *sp; break;
+            case negateValue:       sp[-1] = -sp[-1]; break;
+
+            case callFunction:
+                // (the parameters are already in order on the top of the stack)
+                sp -= in.numParameters;
+                *sp = scope.evaluateFunction (functionNames [in.index], sp, in.numParameters);
+                ++sp;
+                break;
+
+            default:
+                jassertfalse;
+                break;
+        }
+    }
+
+    jassert (sp == stack + 1);
+    return stack[0];
+}
+
+double Expression::Compiled::evaluate()
+{
+    if (needsEvaluating)
+    {
+        needsEvaluating = false;
+
+        try
+        {
+            cachedResult = run();
+        }
+        catch (Helpers::EvaluationError&)
+        {
+            cachedResult = 0;
+        }
+    }
+
+    return cachedResult;
+}
+
+bool Expression::Compiled::isConstant() const noexcept
+{
+    return program.size() == 1 && program.getReference (0).type == pushConstant;
+}
+
+void Expression::Compiled::setInput (const int inputIndex, const double newValue) noexcept
+{
+    jassert (isPositiveAndBelow (inputIndex, inputValues.size()));
+
+    if (isPositiveAndBelow (inputIndex, inputValues.size())
+         && inputValues.getUnchecked (inputIndex) != newValue)
+    {
+        inputValues.set (inputIndex, newValue);
+        needsEvaluating = needsEvaluating || inputsUsed.getUnchecked (inputIndex);
+    }
+}
+
+double Expression::Compiled::getInput (const int inputIndex) const noexcept
+{
+    return inputValues [inputIndex];
+}
+
+bool Expression::Compiled::dependsOnInput (const int inputIndex) const noexcept
+{
+    return inputsUsed [inputIndex];
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ExpressionTests  : public UnitTest
+{
+public:
+    ExpressionTests() : UnitTest ("Expression") {}
+
+    struct TestScope  : public Expression::Scope
+    {
+        Expression getSymbolValue (const String& symbol) const
+        {
+            if (symbol == "a")      return Expression (a);
+            if (symbol == "b")      return Expression (b);
+            if (symbol == "scale")  return Expression ("2 * 3");
+            if (symbol == "loop")   return Expression ("loop + 1");
+
+            return Expression::Scope::getSymbolValue (symbol);
+        }
+
+        double a, b;
+    };
+
+    void runTest()
+    {
+        beginTest ("Compiled expressions");
+
+        TestScope scope;
+        StringArray inputs;
+        inputs.add ("a");
+        inputs.add ("b");
+        inputs.add ("unused");
+
+        const Expression e ("a * scale + max (a, b) / (b - 1) - -sin (b) + abs (-scale)");
+        Expression::Compiled compiled (e, scope, inputs);
+
+        expect (compiled.compiledOk() && ! compiled.isConstant());
+        expect (compiled.dependsOnInput (0) && compiled.dependsOnInput (1) && ! compiled.dependsOnInput (2));
+
+        Random r;
+
+        for (int i = 0; i < 100; ++i)
+        {
+            scope.a = r.nextDouble() * 100.0;
+            scope.b = r.nextDouble() * 100.0;
+            compiled.setInput (0, scope.a);
+            compiled.setInput (1, scope.b);
+
+            expectEquals (compiled.evaluate(), e.evaluate (scope));
+        }
+
+        compiled.setInput (2, 123.0);
+        expectEquals (compiled.evaluate(), e.evaluate (scope));
+
+        Expression::Compiled constant (Expression ("scale * cos (0) - 1"), scope, inputs);
+        expect (constant.isConstant() && ! constant.dependsOnInput (0));
+        expectEquals (constant.evaluate(), 5.0);
+
+        Expression::Compiled badSymbol (Expression ("a + nothing"), scope, inputs);
+        expect (! badSymbol.compiledOk() && badSymbol.evaluate() == 0.0);
+
+        Expression::Compiled recursive (Expression ("loop"), scope, inputs);
+        expect (! recursive.compiledOk());
+    }
+};
+
+static ExpressionTests expressionTests;
+
+#endif
@@ -29,6 +29,8 @@
 #include "../memory/juce_ReferenceCountedObject.h"
 #include "../containers/juce_Array.h"
 #include "../memory/juce_ScopedPointer.h"
+#include "../memory/juce_HeapBlock.h"
+#include "../text/juce_StringArray.h"
 
 
 //==============================================================================
@@ -217,6 +219,9 @@ public:
     /** Returns a list of all symbols that may be needed to resolve this expression in the given scope. */
     void findReferencedSymbols (Array<Symbol>& results, const Scope& scope) const;
 
+    //==============================================================================
+    class Compiled;
+
     //==============================================================================
     /** An exception that can be thrown by Expression::parse(). */
     class ParseError  : public std::exception
@@ -268,4 +273,116 @@ private:
     explicit Expression (Term*);
 };
 
+//==============================================================================
+/**
+    A form of an Expression that has been compiled so that it can be evaluated
+    quickly, over and over again.
+
+    When you create one of these, you give it the names of the symbols that are its
+    inputs. Each of these gets a numbered slot, which you set with setInput(). All the
+    other symbols are looked up in the Scope once, when the expression is compiled, and
+    any parts of the expression that don't depend on the inputs are worked out in advance.
+    E.g.
+    @code
+    StringArray inputs;
+    inputs.add ("x");
+    Expression::Compiled e (Expression ("x * scale + offset"), myScope, inputs);
+
+    e.setInput (0, 1.5);
+    double result = e.evaluate();
+    @endcode
+
+    The result is cached, so evaluate() only does any work if one of the inputs that the
+    expression uses has changed since the last time it was called. This means that functions
+    are assumed to depend only on their parameters.
+
+    If the values of any symbols other than the inputs change, you'll need to compile the
+    expression again. Any functions that can't be worked out in advance will be called via
+    the Scope, so it must stay valid for as long as you use this object.
+
+    @see Expression::evaluate
+*/
+class JUCE_API  Expression::Compiled
+{
+public:
+    //==============================================================================
+    /** Compiles an expression.
+        The inputSymbols list contains the names of the symbols that should be treated
+        as inputs. All the inputs start off with a value of 0.
+        If it fails (e.g. because it uses an unknown symbol), compiledOk() will return false,
+        and the expression will always evaluate to 0.
+    */
+    Compiled (const Expression& expression, const Scope& scope, const StringArray& inputSymbols);
+
+    /** Destructor. */
+    ~Compiled();
+
+    //==============================================================================
+    /** Returns true if the expression was compiled without any errors. */
+    bool compiledOk() const noexcept                        { return error.isEmpty(); }
+
+    /** If the expression failed to compile, this returns a description of the problem. */
+    const String& getCompileError() const noexcept          { return error; }
+
+    /** Returns true if the expression doesn't depend on any of its inputs. */
+    bool isConstant() const noexcept;
+
+    //==============================================================================
+    /** Returns the number of input symbols. */
+    int getNumInputs() const noexcept                       { return inputValues.size(); }
+
+    /** Changes the value of one of the inputs.
+        The index refers to the list of symbols that was passed to the constructor.
+    */
+    void setInput (int inputIndex, double newValue) noexcept;
+
+    /** Returns the current value of one of the inputs. */
+    double getInput (int inputIndex) const noexcept;
+
+    /** Returns true if the result depends on the given input. */
+    bool dependsOnInput (int inputIndex) const noexcept;
+
+    //==============================================================================
+    /** Returns the result of the expression for the current input values. */
+    double evaluate();
+
+private:
+    //==============================================================================
+    enum InstructionType
+    {
+        pushConstant,
+        pushInput,
+        addValues,
+        subtractValues,
+        multiplyValues,
+        divideValues,
+        negateValue,
+        callFunction
+    };
+
+    struct Instruction
+    {
+        InstructionType type;
+        int index, numParameters;
+        double value;
+    };
+
+    Array<Instruction> program;
+    StringArray inputNames, functionNames;
+    Array<double> inputValues;
+    Array<bool> inputsUsed;
+    HeapBlock<double> stack;
+    const Scope& scope;
+    String error;
+    double cachedResult;
+    bool needsEvaluating;
+
+    void compile (Term*, int recursionDepth);
+    void addInstruction (InstructionType, int index, int numParameters, double value);
+    bool endsWithConstants (int numConstants) const noexcept;
+    double run() const;
+
+    JUCE_DECLARE_NON_COPYABLE (Compiled)
+};
+
 #endif   // __JUCE_EXPRESSION_JUCEHEADER__
@@ -134,6 +134,141 @@ void Random::fillBitsRandomly (BigInteger& arrayToChange, int startBit, int numB
         arrayToChange.setBit (startBit + numBits, nextBool());
 }
 
+//==============================================================================
+namespace RandomHelpers
+{
+    /*  Four xorshift32 generators that are stepped together, which maps directly onto
+        a single SSE register. Each step produces four floats in the range 0 to 1.0.
+    */
+    class UniformGenerator
+    {
+    public:
+        UniformGenerator (Random& r) noexcept
+        {
+            uint32 seeds[4];
+
+            for (int i = 0; i < 4; ++i)
+            {
+                do { seeds[i] = (uint32) r.nextInt(); }
+                while (seeds[i] == 0); // (a zero state would stay stuck at zero)
+            }
+
+           #if JUCE_USE_SSE_INTRINSICS
+            state = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (seeds));
+           #else
+            memcpy (state, seeds, sizeof (state));
+           #endif
+        }
+
+        void next (float* const dest) noexcept
+        {
+           #if JUCE_USE_SSE_INTRINSICS
+            state = _mm_xor_si128 (state, _mm_slli_epi32 (state, 13));
+            state = _mm_xor_si128 (state, _mm_srli_epi32 (state, 17));
+            state = _mm_xor_si128 (state, _mm_slli_epi32 (state, 5));
+
+            _mm_storeu_ps (dest, _mm_mul_ps (_mm_cvtepi32_ps (_mm_srli_epi32 (state, 8)),
+                                             _mm_set1_ps (1.0f / 16777216.0f)));
+           #else
+            for (int i = 0; i < 4; ++i)
+            {
+                uint32 x = state[i];
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                state[i] = x;
+
+                dest[i] = (float) (int) (x >> 8) * (1.0f / 16777216.0f);
+            }
+           #endif
+        }
+
+    private:
+       #if JUCE_USE_SSE_INTRINSICS
+        __m128i state;
+       #else
+        uint32 state[4];
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE (UniformGenerator)
+    };
+}
+
+void Random::fillFloats (float* dest, int numValues, const float minValue, const float maxValue) noexcept
+{
+    RandomHelpers::UniformGenerator generator (*this);
+    const float range = maxValue - minValue;
+    float values[4];
+
+    for (; numValues > 0; numValues -= 4)
+    {
+        float* const d = numValues >= 4 ? dest : values;
+        generator.next (d);
+
+        for (int i = 0; i < 4; ++i)
+            d[i] = minValue + d[i] * range;
+
+        if (d == values)
+        {
+            memcpy (dest, values, sizeof (float) * (size_t) numValues);
+            break;
+        }
+
+        dest += 4;
+    }
+}
+
+void Random::fillGaussian (float* dest, int numValues, const float standardDeviation) noexcept
+{
+    RandomHelpers::UniformGenerator generator (*this);
+    const float twoPi = (float) (double_Pi * 2.0);
+    float u[4], values[4];
+
+    for (; numValues > 0; numValues -= 4)
+    {
+        float* const d = numValues >= 4 ? dest : values;
+
+        for (int pair = 0; pair < 4; pair += 2)
+        {
+            generator.next (u);
+
+            for (int i = 0; i < 2; ++i)
+            {
+                const float radius = standardDeviation * std::sqrt (-2.0f * std::log (1.0f - u[i * 2]));
+                const float angle = twoPi * u[i * 2 + 1];
+
+                d[pair + i] = radius * (i == 0 ? std::cos (angle) : std::sin (angle));
+            }
+        }
+
+        if (d == values)
+        {
+            memcpy (dest, values, sizeof (float) * (size_t) numValues);
+            break;
+        }
+
+        dest += 4;
+    }
+}
+
+void Random::fillTriangular (float* dest, int numValues, const float amplitude) noexcept
+{
+    RandomHelpers::UniformGenerator generator (*this);
+    float a[4], b[4];
+
+    for (; numValues > 0; numValues -= 4)
+    {
+        generator.next (a);
+        generator.next (b);
+
+        for (int i = 0; i < 4; ++i)
+            a[i] = (a[i] - b[i]) * amplitude;
+
+        memcpy (dest, a, sizeof (float) * (size_t) jmin (4, numValues));
+        dest += 4;
+    }
+}
+
 //==============================================================================
 #if JUCE_UNIT_TESTS
 
@@ -165,6 +300,63 @@ public:
                 expect (r.nextInt (n) >= 0 && r.nextInt (n) < n);
             }
         }
+
+        beginTest ("Block generators");
+
+        {
+            const int num = 20003;
+            HeapBlock<float> data ((size_t) num + 1), data2 ((size_t) num);
+            data [num] = 12345.0f;
+
+            Random r;
+            const int64 seed = r.nextInt64();
+
+            r.setSeed (seed);
+            r.fillFloats (data, num, -2.0f, 3.0f);
+            expect (data [num] == 12345.0f);
+
+            double sum = 0;
+            for (int i = 0; i < num; ++i)
+            {
+                expect (data[i] >= -2.0f && data[i] < 3.0f);
+                sum += data[i];
+            }
+
+            expect (std::abs (sum / num - 0.5) < 0.1);
+
+            r.setSeed (seed);
+            r.fillFloats (data2, num, -2.0f, 3.0f);
+            expect (memcmp (data, data2, sizeof (float) * (size_t) num) == 0);
+
+            r.fillGaussian (data, num, 2.0f);
+            expect (data [num] == 12345.0f);
+
+            double sumSquares = 0;
+            sum = 0;
+            for (int i = 0; i < num; ++i)
+            {
+                sum += data[i];
+                sumSquares += data[i] * data[i];
+            }
+
+            expect (std::abs (sum / num) < 0.1);
+            expect (std::abs (std::sqrt (sumSquares / num) - 2.0) < 0.1);
+
+            r.fillTriangular (data, num, 0.5f);
+            expect (data [num] == 12345.0f);
+
+            int numNearZero = 0;
+            for (int i = 0; i < num; ++i)
+            {
+                expect (data[i] > -0.5f && data[i] < 0.5f);
+
+                if (std::abs (data[i]) < 0.25f)
+                    ++numNearZero;
+            }
+
+            // three quarters of a triangular distribution lies within half its amplitude
+            expect (std::abs (numNearZero / (double) num - 0.75) < 0.02);
+        }
     }
 };
 
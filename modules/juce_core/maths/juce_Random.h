@@ -100,6 +100,35 @@ public:
     /** Sets a range of bits in a BigInteger to random values. */
     void fillBitsRandomly (BigInteger& arrayToChange, int startBit, int numBits);
 
+    //==============================================================================
+    /** Fills a block of floats with uniformly-distributed random values.
+
+        This is much quicker than calling nextFloat() for each value, so it's the one
+        to use for generating noise. The values come from a set of xorshift generators
+        that are stepped four at a time. Those generators are seeded from this object's
+        sequence, so the results for a given seed are repeatable, and separate Random
+        objects with different seeds (e.g. one per thread) produce independent streams.
+
+        @returns (in dest) values in the range minValue (inclusive) to maxValue (exclusive)
+    */
+    void fillFloats (float* dest, int numValues, float minValue = 0.0f, float maxValue = 1.0f) noexcept;
+
+    /** Fills a block of floats with normally-distributed random values.
+
+        The values have a mean of zero and the given standard deviation, and are
+        made with the Box-Muller transform from the same generators as fillFloats().
+    */
+    void fillGaussian (float* dest, int numValues, float standardDeviation = 1.0f) noexcept;
+
+    /** Fills a block of floats with random values that have a triangular distribution.
+
+        Each value is the difference between two uniform values, so the results lie
+        between -amplitude and +amplitude, and are most likely to be near zero. With an
+        amplitude of one LSB of the target bit depth, this is the standard TPDF dither
+        signal for adding to audio before its word length is reduced.
+    */
+    void fillTriangular (float* dest, int numValues, float amplitude) noexcept;
+
     //==============================================================================
     /** Resets this Random object to a given seed value. */
     void setSeed (int64 newSeed) noexcept;
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_CONTAINERDELETEPOLICY_JUCEHEADER__
+#define __JUCE_CONTAINERDELETEPOLICY_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    Used by container classes as an indirect way to delete an object of a
+    particular type.
+
+    The generic implementation of this class simply calls 'delete', but you can
+    create a specialised version of it for a particular class if you need to
+    get rid of that type of object in some other way - e.g. to return it to a
+    FixedSizeMemoryPool rather than to the heap:
+
+    @code
+    template <>
+    struct ContainerDeletePolicy<MyObject>
+    {
+        static void destroy (MyObject* object)
+        {
+            object->~MyObject();
+            MyObject::getPool().release (object);
+        }
+    };
+    @endcode
+
+    The specialisation must be visible before any container of that type is used.
+
+    @see ScopedPointer, OwnedArray, FixedSizeMemoryPool
+*/
+template <typename ObjectType>
+struct ContainerDeletePolicy
+{
+    static void destroy (ObjectType* object)
+    {
+        delete object;
+    }
+};
+
+
+#endif   // __JUCE_CONTAINERDELETEPOLICY_JUCEHEADER__
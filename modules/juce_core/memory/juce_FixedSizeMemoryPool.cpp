@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+FixedSizeMemoryPool::FixedSizeMemoryPool (const size_t elementSizeInBytes, const int elementsPerChunk_)
+    : elementSize (jmax (elementSizeInBytes, sizeof (FreeElement))),
+      elementsPerChunk (elementsPerChunk_),
+      numInUse (0),
+      freeList (nullptr)
+{
+    jassert (elementsPerChunk > 0);
+
+    elementSize = elementSize >= 16 ? ((elementSize + 15) & ~(size_t) 15)
+                                    : ((elementSize + 7) & ~(size_t) 7);
+}
+
+FixedSizeMemoryPool::~FixedSizeMemoryPool()
+{
+    for (int i = chunks.size(); --i >= 0;)
+        ::free (chunks.getUnchecked (i));
+}
+
+void* FixedSizeMemoryPool::allocate()
+{
+    if (freeList == nullptr)
+    {
+        char* const chunk = static_cast <char*> (::malloc (elementSize * (size_t) elementsPerChunk));
+        jassert (chunk != nullptr); // out of memory!
+
+        chunks.add (chunk);
+        addChunkToFreeList (chunk);
+    }
+
+    FreeElement* const e = freeList;
+    freeList = e->next;
+    ++numInUse;
+    return e;
+}
+
+void FixedSizeMemoryPool::release (void* const element) noexcept
+{
+    if (element != nullptr)
+    {
+        jassert (numInUse > 0);
+
+        FreeElement* const e = static_cast <FreeElement*> (element);
+        e->next = freeList;
+        freeList = e;
+        --numInUse;
+    }
+}
+
+void FixedSizeMemoryPool::releaseAll() noexcept
+{
+    freeList = nullptr;
+
+    for (int i = chunks.size(); --i >= 0;)
+        addChunkToFreeList (chunks.getUnchecked (i));
+
+    numInUse = 0;
+}
+
+void FixedSizeMemoryPool::addChunkToFreeList (char* const chunk) noexcept
+{
+    // (added in reverse, so that the elements get handed out in address order)
+    for (int i = elementsPerChunk; --i >= 0;)
+    {
+        FreeElement* const e = reinterpret_cast <FreeElement*> (chunk + elementSize * (size_t) i);
+        e->next = freeList;
+        freeList = e;
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct PooledTestObject
+{
+    PooledTestObject (int value_) noexcept  : value (value_)  { ++numLiving; }
+    ~PooledTestObject() noexcept                              { --numLiving; }
+
+    static PooledTestObject* create (const int value)
+    {
+        return new (pool->allocate()) PooledTestObject (value);
+    }
+
+    int value;
+    char padding [20];
+
+    static FixedSizeMemoryPool* pool;
+    static int numLiving;
+};
+
+FixedSizeMemoryPool* PooledTestObject::pool = nullptr;
+int PooledTestObject::numLiving = 0;
+
+template <>
+struct ContainerDeletePolicy<PooledTestObject>
+{
+    static void destroy (PooledTestObject* object)
+    {
+        object->~PooledTestObject();
+        PooledTestObject::pool->release (object);
+    }
+};
+
+struct HeapTestObject
+{
+    HeapTestObject (int value_) noexcept  : value (value_) {}
+
+    int value;
+    char padding [20];
+};
+
+class FixedSizeMemoryPoolTests  : public UnitTest
+{
+public:
+    FixedSizeMemoryPoolTests() : UnitTest ("FixedSizeMemoryPool") {}
+
+    void runTest()
+    {
+        {
+            beginTest ("Allocation");
+
+            FixedSizeMemoryPool pool (20, 16);
+            expect (pool.getElementSize() == 32);
+
+            Array<void*> elements;
+
+            for (int i = 0; i < 100; ++i)
+            {
+                void* const e = pool.allocate();
+                expect ((reinterpret_cast <pointer_sized_uint> (e) & 15) == 0);
+                expect (! elements.contains (e));
+                elements.add (e);
+            }
+
+            expectEquals (pool.getNumElementsInUse(), 100);
+            expect (pool.getCapacity() >= 100);
+
+            const int capacity = pool.getCapacity();
+
+            for (int i = 0; i < elements.size(); i += 2)
+                pool.release (elements.getUnchecked (i));
+
+            expectEquals (pool.getNumElementsInUse(), 50);
+
+            for (int i = 0; i < 50; ++i)
+                pool.allocate();
+
+            expectEquals (pool.getCapacity(), capacity);
+
+            pool.releaseAll();
+            expectEquals (pool.getNumElementsInUse(), 0);
+            expectEquals (pool.getCapacity(), capacity);
+        }
+
+        {
+            beginTest ("OwnedArray with a ContainerDeletePolicy");
+
+            FixedSizeMemoryPool pool (sizeof (PooledTestObject));
+            PooledTestObject::pool = &pool;
+
+            {
+                OwnedArray<PooledTestObject> array;
+
+                for (int i = 0; i < 1000; ++i)
+                    array.add (PooledTestObject::create (i));
+
+                expectEquals (PooledTestObject::numLiving, 1000);
+                expectEquals (pool.getNumElementsInUse(), 1000);
+
+                array.removeRange (0, 500);
+                array.set (0, PooledTestObject::create (-1));
+                expectEquals (array[0]->value, -1);
+                expectEquals (array[1]->value, 501);
+                expectEquals (pool.getNumElementsInUse(), 500);
+
+                ScopedPointer<PooledTestObject> single (PooledTestObject::create (1));
+                expectEquals (pool.getNumElementsInUse(), 501);
+            }
+
+            expectEquals (PooledTestObject::numLiving, 0);
+            expectEquals (pool.getNumElementsInUse(), 0);
+
+            beginTest ("Benchmark");
+
+            const int numObjects = 100000;
+            double heapTime = 0, poolTime = 0;
+
+            for (int run = 0; run < 5; ++run)
+            {
+                double start = Time::getMillisecondCounterHiRes();
+
+                {
+                    OwnedArray<HeapTestObject> array;
+
+                    for (int i = 0; i < numObjects; ++i)
+                        array.add (new HeapTestObject (i));
+                }
+
+                heapTime += Time::getMillisecondCounterHiRes() - start;
+                start = Time::getMillisecondCounterHiRes();
+
+                {
+                    OwnedArray<PooledTestObject> array;
+
+                    for (int i = 0; i < numObjects; ++i)
+                        array.add (PooledTestObject::create (i));
+                }
+
+                poolTime += Time::getMillisecondCounterHiRes() - start;
+            }
+
+            logMessage ("Creating and deleting " + String (numObjects) + " objects in an OwnedArray: heap "
+                          + String (heapTime / 5.0, 2) + " ms, pool " + String (poolTime / 5.0, 2) + " ms");
+
+            PooledTestObject::pool = nullptr;
+        }
+    }
+};
+
+static FixedSizeMemoryPoolTests fixedSizeMemoryPoolTests;
+
+#endif
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_FIXEDSIZEMEMORYPOOL_JUCEHEADER__
+#define __JUCE_FIXEDSIZEMEMORYPOOL_JUCEHEADER__
+
+#include "../containers/juce_Array.h"
+
+
+//==============================================================================
+/**
+    Allocates blocks of memory of one fixed size, taking them from large chunks
+    rather than from the heap one at a time.
+
+    Allocating and releasing an element just pops or pushes it on a free-list, and
+    the elements are packed together in memory, which makes this a good fit for
+    large numbers of small objects of the same type that are frequently created and
+    deleted.
+
+    To keep these objects in an OwnedArray or ScopedPointer, create them with placement
+    new, and give their class a ContainerDeletePolicy which destroys them and returns
+    them to the pool. A pool can also hand back every element at once with releaseAll(),
+    which doesn't call any destructors.
+
+    All the chunks that the pool allocates are freed when it is deleted, so it must
+    outlive all of the elements that are taken from it.
+
+    This class isn't thread-safe.
+
+    @see MemoryArena, ContainerDeletePolicy
+*/
+class JUCE_API  FixedSizeMemoryPool
+{
+public:
+    //==============================================================================
+    /** Creates a pool.
+        @param elementSizeInBytes   the size of each element. Elements are aligned to
+                                    16 bytes if they're at least that big.
+        @param elementsPerChunk     the number of elements to allocate from the
+                                    system at a time
+    */
+    FixedSizeMemoryPool (size_t elementSizeInBytes, int elementsPerChunk = 256);
+
+    /** Destructor.
+        This frees all the memory that the pool has allocated.
+    */
+    ~FixedSizeMemoryPool();
+
+    //==============================================================================
+    /** Returns an uninitialised element. */
+    void* allocate();
+
+    /** Puts an element that was returned by allocate() back into the pool. */
+    void release (void* element) noexcept;
+
+    /** Returns all of the elements to the pool, without calling any destructors.
+        The chunks are kept so that they can be re-used.
+    */
+    void releaseAll() noexcept;
+
+    //==============================================================================
+    /** Returns the size of each element, which may have been rounded up from
+        the size that was asked for.
+    */
+    size_t getElementSize() const noexcept              { return elementSize; }
+
+    /** Returns the number of elements that are currently in use. */
+    int getNumElementsInUse() const noexcept            { return numInUse; }
+
+    /** Returns the number of elements that the pool has space for without
+        allocating any more memory.
+    */
+    int getCapacity() const noexcept                    { return chunks.size() * elementsPerChunk; }
+
+private:
+    //==============================================================================
+    struct FreeElement
+    {
+        FreeElement* next;
+    };
+
+    size_t elementSize;
+    int elementsPerChunk, numInUse;
+    FreeElement* freeList;
+    Array<char*> chunks;
+
+    void addChunkToFreeList (char* chunk) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (FixedSizeMemoryPool)
+};
+
+
+#endif   // __JUCE_FIXEDSIZEMEMORYPOOL_JUCEHEADER__
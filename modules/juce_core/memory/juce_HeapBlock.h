@@ -26,6 +26,8 @@
 #ifndef __JUCE_HEAPBLOCK_JUCEHEADER__
 #define __JUCE_HEAPBLOCK_JUCEHEADER__
 
+#include "../threads/juce_RealtimeSafetyChecker.h"
+
 #ifndef DOXYGEN
 namespace HeapBlockHelper
 {
@@ -129,6 +131,7 @@ public:
     */
     ~HeapBlock()
     {
+        JUCE_REALTIME_SAFETY_CHECK_FREE (data)
         std::free (data);
     }
 
@@ -261,6 +264,7 @@ public:
     */
     void free()
     {
+        JUCE_REALTIME_SAFETY_CHECK_FREE (data)
         std::free (data);
         data = nullptr;
     }
@@ -290,8 +294,10 @@ private:
     //==============================================================================
     ElementType* data;
 
+    // (this gets called after every allocation)
     void throwOnAllocationFailure() const
     {
+        JUCE_REALTIME_SAFETY_CHECK ("HeapBlock allocation")
         HeapBlockHelper::ThrowOnFail<throwOnFailure>::check (data);
     }
 
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace MemoryArenaHelpers
+{
+    static const size_t headerSize = (sizeof (void*) * 2 + 15) & ~(size_t) 15;
+
+    static inline char* alignPointer (char* const p, const size_t alignment) noexcept
+    {
+        return reinterpret_cast <char*> ((reinterpret_cast <pointer_sized_uint> (p) + (alignment - 1))
+                                            & ~(pointer_sized_uint) (alignment - 1));
+    }
+}
+
+MemoryArena::MemoryArena (const size_t blockSizeInBytes)
+    : currentBlock (nullptr), position (nullptr), blockEnd (nullptr),
+      blockSize (blockSizeInBytes), numBytesUsed (0), numBytesReserved (0)
+{
+    jassert (blockSizeInBytes > 0);
+}
+
+MemoryArena::~MemoryArena()
+{
+    releaseAllMemory();
+}
+
+char* MemoryArena::getBlockData (Block* const block) noexcept
+{
+    return reinterpret_cast <char*> (block) + MemoryArenaHelpers::headerSize;
+}
+
+void MemoryArena::addBlock (const size_t minimumSize)
+{
+    static_jassert (sizeof (Block) <= MemoryArenaHelpers::headerSize);
+
+    const size_t size = jmax (blockSize, minimumSize);
+    Block* const block = static_cast <Block*> (::malloc (MemoryArenaHelpers::headerSize + size));
+    jassert (block != nullptr); // out of memory!
+
+    block->previous = currentBlock;
+    block->size = size;
+    currentBlock = block;
+    position = getBlockData (block);
+    blockEnd = position + size;
+    numBytesReserved += size;
+}
+
+void* MemoryArena::allocate (const size_t numBytes, const size_t alignment)
+{
+    jassert (isPowerOfTwo (alignment));
+
+    char* start = MemoryArenaHelpers::alignPointer (position, alignment);
+
+    if (currentBlock == nullptr || start > blockEnd || (size_t) (blockEnd - start) < numBytes)
+    {
+        addBlock (numBytes + alignment);
+        start = MemoryArenaHelpers::alignPointer (position, alignment);
+    }
+
+    position = start + numBytes;
+    numBytesUsed += numBytes;
+    return start;
+}
+
+void MemoryArena::reset()
+{
+    if (currentBlock != nullptr)
+    {
+        if (currentBlock->previous != nullptr)
+        {
+            // merge all the blocks into one, so that next time it'll all fit without
+            // needing any more allocations
+            const size_t totalSize = numBytesReserved;
+            releaseAllMemory();
+            addBlock (totalSize);
+        }
+        else
+        {
+            position = getBlockData (currentBlock);
+        }
+    }
+
+    numBytesUsed = 0;
+}
+
+void MemoryArena::releaseAllMemory() noexcept
+{
+    while (currentBlock != nullptr)
+    {
+        Block* const previous = currentBlock->previous;
+        ::free (currentBlock);
+        currentBlock = previous;
+    }
+
+    position = nullptr;
+    blockEnd = nullptr;
+    numBytesUsed = 0;
+    numBytesReserved = 0;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class MemoryArenaTests  : public UnitTest
+{
+public:
+    MemoryArenaTests() : UnitTest ("MemoryArena") {}
+
+    void runTest()
+    {
+        beginTest ("Allocation");
+
+        MemoryArena arena (1024);
+        expect (arena.getNumBytesReserved() == 0);
+
+        Random r;
+        Array<int*> blocks;
+        Array<int> sizes;
+
+        for (int i = 0; i < 500; ++i)
+        {
+            const int numInts = r.nextInt (100);
+            const size_t alignment = (size_t) 1 << r.nextInt (7);
+            int* const block = static_cast <int*> (arena.allocate (sizeof (int) * (size_t) numInts, alignment));
+
+            expect ((reinterpret_cast <pointer_sized_uint> (block) & (alignment - 1)) == 0);
+
+            for (int j = 0; j < numInts; ++j)
+                block[j] = i;
+
+            blocks.add (block);
+            sizes.add (numInts);
+        }
+
+        bool allIntact = true;
+
+        for (int i = 0; i < blocks.size(); ++i)
+            for (int j = 0; j < sizes[i]; ++j)
+                allIntact = allIntact && blocks.getUnchecked(i)[j] == i;
+
+        expect (allIntact);
+        expect (arena.getNumBytesUsed() > 0 && arena.getNumBytesReserved() >= arena.getNumBytesUsed());
+
+        beginTest ("Reset");
+
+        const size_t bytesUsed = arena.getNumBytesUsed();
+        arena.reset();
+        expect (arena.getNumBytesUsed() == 0);
+
+        const size_t reservedAfterReset = arena.getNumBytesReserved();
+        expect (reservedAfterReset >= bytesUsed);
+
+        for (int i = 0; i < sizes.size(); ++i)
+            arena.allocate (sizeof (int) * (size_t) sizes[i], 4);
+
+        expect (arena.getNumBytesReserved() == reservedAfterReset);
+
+        double* const d = arena.allocateArray<double> (10000);
+        d[9999] = 1.0;
+        expect (arena.getNumBytesReserved() > reservedAfterReset);
+
+        arena.releaseAllMemory();
+        expect (arena.getNumBytesReserved() == 0 && arena.getNumBytesUsed() == 0);
+    }
+};
+
+static MemoryArenaTests memoryArenaTests;
+
+#endif
@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_MEMORYARENA_JUCEHEADER__
+#define __JUCE_MEMORYARENA_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A monotonic ("bump pointer") allocator, which hands out memory from large
+    blocks and frees it all at once.
+
+    Allocating from an arena just moves a pointer along, and there's no way to free
+    an individual allocation. Instead, reset() throws away everything that has been
+    allocated, so it's ideal for short-lived data that's all built up and thrown
+    away together, e.g. the temporary objects used while processing one block of audio.
+
+    The arena never calls any destructors, so if you create objects in it with
+    placement new, they must either be trivially destructible, or you must call
+    their destructors yourself before calling reset():
+
+    @code
+    MemoryArena arena;
+
+    for (;;)
+    {
+        Node* const n = new (arena.allocate (sizeof (Node))) Node (x, y);
+        float* const temp = arena.allocateArray<float> (numSamples);
+        ...
+
+        arena.reset();
+    }
+    @endcode
+
+    When reset() is called after the arena has had to add extra blocks, they're merged
+    into a single block big enough for everything, so an arena which is reused for a
+    similar workload each time soon stops allocating any memory at all.
+
+    This class isn't thread-safe.
+
+    @see FixedSizeMemoryPool
+*/
+class JUCE_API  MemoryArena
+{
+public:
+    //==============================================================================
+    /** Creates an arena.
+        @param blockSizeInBytes     the size of the blocks that it allocates from the system.
+                                    No memory is allocated until the first call to allocate().
+    */
+    explicit MemoryArena (size_t blockSizeInBytes = 16384);
+
+    /** Destructor.
+        This frees all the memory that the arena has handed out, without calling any
+        destructors.
+    */
+    ~MemoryArena();
+
+    //==============================================================================
+    /** Returns a block of uninitialised memory.
+
+        @param numBytes     the number of bytes needed
+        @param alignment    the alignment of the address returned - this must be a power of 2
+    */
+    void* allocate (size_t numBytes, size_t alignment = 16);
+
+    /** Returns some uninitialised space for an array of elements.
+        The elements aren't constructed, so this is only suitable for primitive types.
+    */
+    template <class ElementType>
+    ElementType* allocateArray (const int numElements)
+    {
+        jassert (numElements >= 0);
+        return static_cast <ElementType*> (allocate (sizeof (ElementType) * (size_t) numElements));
+    }
+
+    /** Discards everything that has been allocated, making all of the arena's memory
+        available for re-use.
+        Any pointers that it had previously returned become invalid.
+    */
+    void reset();
+
+    /** Frees all of the memory that the arena is holding. */
+    void releaseAllMemory() noexcept;
+
+    //==============================================================================
+    /** Returns the number of bytes that have been handed out since the last reset. */
+    size_t getNumBytesUsed() const noexcept             { return numBytesUsed; }
+
+    /** Returns the total size of the blocks that the arena currently holds. */
+    size_t getNumBytesReserved() const noexcept         { return numBytesReserved; }
+
+private:
+    //==============================================================================
+    struct Block
+    {
+        Block* previous;
+        size_t size;
+    };
+
+    Block* currentBlock;
+    char* position;
+    char* blockEnd;
+    size_t blockSize, numBytesUsed, numBytesReserved;
+
+    void addBlock (size_t minimumSize);
+    static char* getBlockData (Block*) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (MemoryArena)
+};
+
+
+#endif   // __JUCE_MEMORYARENA_JUCEHEADER__
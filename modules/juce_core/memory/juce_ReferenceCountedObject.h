@@ -59,7 +59,14 @@
     the pointers can be passed between threads safely. For a faster but non-thread-safe
     version, use SingleThreadedReferenceCountedObject instead.
 
-    @see ReferenceCountedObjectPtr, ReferenceCountedArray, SingleThreadedReferenceCountedObject
+    Each of those atomic operations has a cost when a pointer is copied, so where you're
+    handing a pointer on rather than sharing it, move it instead (when the compiler supports
+    it), which transfers the reference without touching the count. And if a real-time thread
+    might drop the last reference to an object, use a DeferredReleasePool so that the object
+    gets deleted on a different thread.
+
+    @see ReferenceCountedObjectPtr, ReferenceCountedArray, SingleThreadedReferenceCountedObject,
+         DeferredReleasePool
 */
 class JUCE_API  ReferenceCountedObject
 {
@@ -233,12 +240,24 @@ public:
     }
 
    #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
-    /** Takes-over the object from another pointer. */
+    /** Takes-over the object from another pointer.
+        This doesn't need to change the object's reference-count.
+    */
     inline ReferenceCountedObjectPtr (ReferenceCountedObjectPtr&& other) noexcept
         : referencedObject (other.referencedObject)
     {
         other.referencedObject = nullptr;
     }
+
+    /** Takes-over the object from another pointer.
+        This doesn't need to change the object's reference-count.
+    */
+    template <class DerivedClass>
+    inline ReferenceCountedObjectPtr (ReferenceCountedObjectPtr<DerivedClass>&& other) noexcept
+        : referencedObject (static_cast <ReferenceCountedObjectClass*> (other.referencedObject))
+    {
+        other.referencedObject = nullptr;
+    }
    #endif
 
     /** Copies another pointer.
@@ -274,14 +293,36 @@ public:
     }
 
    #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
-    /** Takes-over the object from another pointer. */
-    ReferenceCountedObjectPtr& operator= (ReferenceCountedObjectPtr&& other)
+    /** Takes-over the object from another pointer.
+        The new object's reference-count isn't changed, and the old object is released
+        when the other pointer is destroyed.
+    */
+    ReferenceCountedObjectPtr& operator= (ReferenceCountedObjectPtr&& other) noexcept
     {
         std::swap (referencedObject, other.referencedObject);
         return *this;
     }
+
+    /** Takes-over the object from another pointer.
+        The new object's reference-count isn't changed, and the old object is released.
+    */
+    template <class DerivedClass>
+    ReferenceCountedObjectPtr& operator= (ReferenceCountedObjectPtr<DerivedClass>&& other)
+    {
+        ReferenceCountedObjectPtr temp (static_cast <ReferenceCountedObjectPtr<DerivedClass>&&> (other));
+        std::swap (referencedObject, temp.referencedObject);
+        return *this;
+    }
    #endif
 
+    /** Swaps the objects that this pointer and another one refer to.
+        Neither object's reference-count is changed.
+    */
+    void swapWith (ReferenceCountedObjectPtr& other) noexcept
+    {
+        std::swap (referencedObject, other.referencedObject);
+    }
+
     /** Changes this pointer to point at a different object.
 
         The reference count of the old object is decremented, and it might be
@@ -348,6 +389,8 @@ public:
 private:
     //==============================================================================
     ReferenceCountedObjectClass* referencedObject;
+
+    template <class OtherClass> friend class ReferenceCountedObjectPtr;
 };
 
 
@@ -26,6 +26,8 @@
 #ifndef __JUCE_SCOPEDPOINTER_JUCEHEADER__
 #define __JUCE_SCOPEDPOINTER_JUCEHEADER__
 
+#include "juce_ContainerDeletePolicy.h"
+
 //==============================================================================
 /**
     This class holds a pointer which is automatically deleted when this object goes
@@ -94,7 +96,7 @@ public:
     /** Destructor.
         This will delete the object that this ScopedPointer currently refers to.
     */
-    inline ~ScopedPointer()                                                         { delete object; }
+    inline ~ScopedPointer()                                                         { ContainerDeletePolicy<ObjectType>::destroy (object); }
 
     /** Changes this ScopedPointer to point to a new object.
 
@@ -116,7 +118,7 @@ public:
             ObjectType* const oldObject = object;
             object = objectToTransferFrom.object;
             objectToTransferFrom.object = nullptr;
-            delete oldObject;
+            ContainerDeletePolicy<ObjectType>::destroy (oldObject);
         }
 
         return *this;
@@ -135,7 +137,7 @@ public:
         {
             ObjectType* const oldObject = object;
             object = newObjectToTakePossessionOf;
-            delete oldObject;
+            ContainerDeletePolicy<ObjectType>::destroy (oldObject);
         }
 
         return *this;
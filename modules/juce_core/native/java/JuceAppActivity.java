@@ -50,6 +50,7 @@ import java.net.URL;
 import java.net.HttpURLConnection;
 import javax.microedition.khronos.egl.EGLConfig;
 import javax.microedition.khronos.opengles.GL10;
+import android.media.AudioManager;
 import android.media.MediaScannerConnection;
 import android.media.MediaScannerConnection.MediaScannerConnectionClient;
 
@@ -664,6 +665,25 @@ public final class JuceAppActivity   extends Activity
                         : locale.getDisplayLanguage (java.util.Locale.US);
     }
 
+    //==============================================================================
+    public final int getAudioOutputProperty (String propertyName)
+    {
+        // AudioManager.getProperty() only exists from API level 17, so it has to be found at runtime
+        try
+        {
+            AudioManager audioManager = (AudioManager) getSystemService (Context.AUDIO_SERVICE);
+            java.lang.reflect.Method getProperty = AudioManager.class.getMethod ("getProperty", String.class);
+            String value = (String) getProperty.invoke (audioManager, propertyName);
+
+            if (value != null)
+                return Integer.parseInt (value);
+        }
+        catch (Throwable e)
+        {}
+
+        return 0;
+    }
+
     //==============================================================================
     private final class SingleMediaScanner  implements MediaScannerConnectionClient
     {
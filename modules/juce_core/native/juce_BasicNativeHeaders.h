@@ -187,6 +187,8 @@
  #include <sys/sysinfo.h>
  #include <sys/file.h>
  #include <sys/prctl.h>
+ #include <sys/inotify.h>
+ #include <poll.h>
  #include <signal.h>
  #include <stddef.h>
 
@@ -209,6 +211,7 @@
  #include <dirent.h>
  #include <fnmatch.h>
  #include <sys/wait.h>
+ #include <sys/resource.h>
 #endif
 
 // Need to clear various moronic redefinitions made by system headers..
@@ -360,7 +360,8 @@ extern ThreadLocalJNIEnvHolder threadLocalJNIEnvHolder;
  METHOD (showOkCancelBox,        "showOkCancelBox",      "(Ljava/lang/String;Ljava/lang/String;J)V") \
  METHOD (showYesNoCancelBox,     "showYesNoCancelBox",   "(Ljava/lang/String;Ljava/lang/String;J)V") \
  STATICMETHOD (getLocaleValue,   "getLocaleValue",       "(Z)Ljava/lang/String;") \
- METHOD (scanFile,               "scanFile",             "(Ljava/lang/String;)V")
+ METHOD (scanFile,               "scanFile",             "(Ljava/lang/String;)V") \
+ METHOD (getAudioOutputProperty, "getAudioOutputProperty", "(Ljava/lang/String;)I")
 
 DECLARE_JNI_CLASS (JuceAppActivity, JUCE_ANDROID_ACTIVITY_CLASSPATH);
 #undef JNI_CLASS_MEMBERS
@@ -271,8 +271,26 @@ SystemStats::CPUFlags::CPUFlags()
     hasSSE = false;
     hasSSE2 = false;
     has3DNow = false;
+    hasAVX = false;
+    hasAVX2 = false;
+
+   #if defined (__ARM_FEATURE_CRYPTO)
+    hasSHA = true;
+    hasAES = true;
+   #else
+    hasSHA = false;
+    hasAES = false;
+   #endif
+
+   #if defined (__ARM_NEON__) || defined (__ARM_NEON)
+    hasNeon = true;
+   #else
+    hasNeon = false;
+   #endif
 
     numCpus = jmax (1, sysconf (_SC_NPROCESSORS_ONLN));
+    numPhysicalCpus = numCpus;
+    zerostruct (cacheSizes);
 }
 
 //==============================================================================
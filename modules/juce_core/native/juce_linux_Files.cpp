@@ -247,8 +247,7 @@ class DirectoryIterator::NativeIterator::Pimpl
 {
 public:
     Pimpl (const File& directory, const String& wildCard_)
-        : parentDir (File::addTrailingSeparator (directory.getFullPathName())),
-          wildCard (wildCard_),
+        : wildCard (wildCard_),
           dir (opendir (directory.getFullPathName().toUTF8()))
     {
     }
@@ -281,7 +280,7 @@ public:
                 {
                     filenameFound = CharPointer_UTF8 (de->d_name);
 
-                    updateStatInfoForFile (parentDir + filenameFound, isDir, fileSize, modTime, creationTime, isReadOnly);
+                    getEntryInfo (de, isDir, fileSize, modTime, creationTime, isReadOnly);
 
                     if (isHidden != nullptr)
                         *isHidden = filenameFound.startsWithChar ('.');
@@ -295,9 +294,37 @@ public:
     }
 
 private:
-    String parentDir, wildCard;
+    String wildCard;
     DIR* dir;
 
+    // If only the type of an entry is needed, it can usually be taken from the directory entry
+    // itself. Otherwise, it's stat'ed relative to the open directory, which avoids resolving the
+    // whole path again for every file. (Links still need a stat to find out what they point to).
+    void getEntryInfo (const struct dirent* const de, bool* const isDir, int64* const fileSize,
+                       Time* const modTime, Time* const creationTime, bool* const isReadOnly) const
+    {
+        const bool typeIsKnown = de->d_type != DT_UNKNOWN && de->d_type != DT_LNK;
+
+        if (fileSize != nullptr || modTime != nullptr || creationTime != nullptr
+             || (isDir != nullptr && ! typeIsKnown))
+        {
+            juce_statStruct info;
+            const bool statOk = fstatat64 (dirfd (dir), de->d_name, &info, 0) == 0;
+
+            if (isDir != nullptr)         *isDir        = statOk && ((info.st_mode & S_IFDIR) != 0);
+            if (fileSize != nullptr)      *fileSize     = statOk ? info.st_size : 0;
+            if (modTime != nullptr)       *modTime      = Time (statOk ? (int64) info.st_mtime * 1000 : 0);
+            if (creationTime != nullptr)  *creationTime = Time (statOk ? (int64) info.st_ctime * 1000 : 0);
+        }
+        else if (isDir != nullptr)
+        {
+            *isDir = de->d_type == DT_DIR;
+        }
+
+        if (isReadOnly != nullptr)
+            *isReadOnly = faccessat (dirfd (dir), de->d_name, W_OK, 0) != 0;
+    }
+
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
 };
 
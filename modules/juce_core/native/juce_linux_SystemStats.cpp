@@ -63,6 +63,21 @@ namespace LinuxStatsHelpers
 
         return String::empty;
     }
+
+    String readSysFile (const String& path)
+    {
+        return File ("/sys/devices/system/cpu/" + path).loadFileAsString().trim();
+    }
+
+    int parseCacheSize (const String& text)
+    {
+        const int value = text.getIntValue();
+
+        if (text.endsWithIgnoreCase ("K"))  return value * 1024;
+        if (text.endsWithIgnoreCase ("M"))  return value * 1024 * 1024;
+
+        return value;
+    }
 }
 
 String SystemStats::getCpuVendor()
@@ -138,8 +153,53 @@ SystemStats::CPUFlags::CPUFlags()
     hasSSE   = flags.contains ("sse");
     hasSSE2  = flags.contains ("sse2");
     has3DNow = flags.contains ("3dnow");
+    hasAVX   = flags.contains ("avx");
+    hasAVX2  = flags.contains ("avx2");
+
+    const String features (LinuxStatsHelpers::getCpuInfo ("Features"));
+    hasSHA   = flags.contains ("sha_ni") || features.contains ("sha2");
+    hasAES   = (flags.contains ("aes") && flags.contains ("pclmulqdq"))
+                 || (features.contains ("aes") && features.contains ("pmull"));
+
+   #if defined (__ARM_NEON__) || defined (__ARM_NEON)
+    hasNeon  = true;
+   #else
+    hasNeon  = features.contains ("neon") || features.contains ("asimd");
+   #endif
 
     numCpus = LinuxStatsHelpers::getCpuInfo ("processor").getIntValue() + 1;
+
+    // Each CPU's core is identified by its package and core IDs together, as the core
+    // IDs are only unique within a package.
+    StringArray coreNames;
+
+    for (int i = 0; i < numCpus; ++i)
+    {
+        const String topology ("cpu" + String (i) + "/topology/");
+        const String coreName (LinuxStatsHelpers::readSysFile (topology + "physical_package_id")
+                                 + ":" + LinuxStatsHelpers::readSysFile (topology + "core_id"));
+
+        coreNames.addIfNotAlreadyThere (coreName);
+        physicalCoreForCpu.add (coreNames.indexOf (coreName));
+    }
+
+    numPhysicalCpus = jmax (1, coreNames.size());
+
+    zerostruct (cacheSizes);
+
+    for (int i = 0;; ++i)
+    {
+        const String cache ("cpu0/cache/index" + String (i) + "/");
+        const String type (LinuxStatsHelpers::readSysFile (cache + "type"));
+
+        if (type.isEmpty())
+            break;
+
+        const int level = LinuxStatsHelpers::readSysFile (cache + "level").getIntValue();
+
+        if (type != "Instruction" && level >= 1 && level <= 3)
+            cacheSizes [level - 1] = LinuxStatsHelpers::parseCacheSize (LinuxStatsHelpers::readSysFile (cache + "size"));
+    }
 }
 
 //==============================================================================
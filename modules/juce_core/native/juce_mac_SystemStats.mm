@@ -46,22 +46,47 @@ void Logger::outputDebugString (const String& text)
 //==============================================================================
 namespace SystemStatsHelpers
 {
+    static int64 getSysctlValue (const char* name)
+    {
+        int64 value = 0;
+        size_t valueSize = sizeof (value);
+
+        if (sysctlbyname (name, &value, &valueSize, 0, 0) != 0)
+            return 0;
+
+        // (some of these values are 32-bit)
+        return valueSize == sizeof (int32) ? (int64) *reinterpret_cast<int32*> (&value) : value;
+    }
+
    #if JUCE_INTEL && ! JUCE_NO_INLINE_ASM
-    static void doCPUID (uint32& a, uint32& b, uint32& c, uint32& d, uint32 type)
+    // (the subLeaf goes into ecx, which selects the sub-function for leaves such as 7)
+    static void doCPUID (uint32& a, uint32& b, uint32& c, uint32& d, uint32 type, uint32 subLeaf = 0)
     {
         uint32 la = a, lb = b, lc = c, ld = d;
 
         asm ("mov %%ebx, %%esi \n\t"
              "cpuid \n\t"
              "xchg %%esi, %%ebx"
-               : "=a" (la), "=S" (lb), "=c" (lc), "=d" (ld) : "a" (type)
+               : "=a" (la), "=S" (lb), "=c" (lc), "=d" (ld) : "a" (type), "c" (subLeaf)
            #if JUCE_64BIT
-                  , "b" (lb), "c" (lc), "d" (ld)
+                  , "b" (lb), "d" (ld)
            #endif
         );
 
         a = la; b = lb; c = lc; d = ld;
     }
+
+    // Reads XCR0, the mask of register states that the OS saves. Only call this if CPUID reports OSXSAVE!
+    static uint32 getEnabledRegisterStates()
+    {
+        uint32 eax = 0, edx = 0;
+
+        asm (".byte 0x0f, 0x01, 0xd0" // (xgetbv, which older assemblers don't know about)
+               : "=a" (eax), "=d" (edx) : "c" (0));
+
+        (void) edx;
+        return eax;
+    }
    #endif
 }
 
@@ -69,18 +94,49 @@ namespace SystemStatsHelpers
 SystemStats::CPUFlags::CPUFlags()
 {
    #if JUCE_INTEL && ! JUCE_NO_INLINE_ASM
-    uint32 familyModel = 0, extFeatures = 0, features = 0, dummy = 0;
-    SystemStatsHelpers::doCPUID (familyModel, extFeatures, dummy, features, 1);
+    uint32 familyModel = 0, extFeatures = 0, features = 0, moreFeatures = 0;
+    SystemStatsHelpers::doCPUID (familyModel, extFeatures, moreFeatures, features, 1);
 
     hasMMX   = (features    & (1u << 23)) != 0;
     hasSSE   = (features    & (1u << 25)) != 0;
     hasSSE2  = (features    & (1u << 26)) != 0;
     has3DNow = (extFeatures & (1u << 31)) != 0;
+
+    // AVX is only usable if the OSXSAVE bit is set and the OS is saving the AVX registers..
+    hasAVX   = (moreFeatures & (3u << 27)) == (3u << 27)
+                 && (SystemStatsHelpers::getEnabledRegisterStates() & 6) == 6;
+
+    uint32 maxLevel = 0, structFeatures = 0, dummy = 0;
+    SystemStatsHelpers::doCPUID (maxLevel, dummy, dummy, dummy, 0);
+
+    if (maxLevel >= 7)
+        SystemStatsHelpers::doCPUID (dummy, structFeatures, dummy, dummy, 7, 0);
+
+    hasAVX2  = hasAVX && (structFeatures & (1u << 5)) != 0;
+    hasSHA   = (structFeatures & (1u << 29)) != 0;
+    hasAES   = (moreFeatures & (1u << 25)) != 0 && (moreFeatures & (1u << 1)) != 0;
+    hasNeon  = false;
    #else
     hasMMX = false;
     hasSSE = false;
     hasSSE2 = false;
     has3DNow = false;
+    hasAVX = false;
+    hasAVX2 = false;
+
+    #if defined (__ARM_FEATURE_CRYPTO)
+     hasSHA = true;
+     hasAES = true;
+    #else
+     hasSHA = false;
+     hasAES = false;
+    #endif
+
+    #if JUCE_IOS && (defined (__ARM_NEON__) || defined (__ARM_NEON))
+     hasNeon = true;
+    #else
+     hasNeon = false;
+    #endif
    #endif
 
    #if JUCE_IOS || (MAC_OS_X_VERSION_MIN_REQUIRED >= MAC_OS_X_VERSION_10_5)
@@ -88,6 +144,13 @@ SystemStats::CPUFlags::CPUFlags()
    #else
     numCpus = (int) MPProcessors();
    #endif
+
+    // (the OS doesn't say which logical CPUs share a core, so physicalCoreForCpu is left
+    // empty, and getPhysicalCoreForCpu() assumes that their threads are numbered together)
+    numPhysicalCpus = jlimit (1, numCpus, (int) SystemStatsHelpers::getSysctlValue ("hw.physicalcpu"));
+    cacheSizes[0]   = (int) SystemStatsHelpers::getSysctlValue ("hw.l1dcachesize");
+    cacheSizes[1]   = (int) SystemStatsHelpers::getSysctlValue ("hw.l2cachesize");
+    cacheSizes[2]   = (int) SystemStatsHelpers::getSysctlValue ("hw.l3cachesize");
 }
 
 #if JUCE_MAC
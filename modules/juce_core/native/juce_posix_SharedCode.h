@@ -41,6 +41,7 @@ CriticalSection::~CriticalSection() noexcept
 
 void CriticalSection::enter() const noexcept
 {
+    JUCE_REALTIME_SAFETY_CHECK ("CriticalSection::enter")
     pthread_mutex_lock (&internal);
 }
 
@@ -77,6 +78,7 @@ WaitableEvent::~WaitableEvent() noexcept
 
 bool WaitableEvent::wait (const int timeOutMillisecs) const noexcept
 {
+    JUCE_REALTIME_SAFETY_CHECK ("WaitableEvent::wait")
     pthread_mutex_lock (&mutex);
 
     if (! triggered)
@@ -141,6 +143,8 @@ void WaitableEvent::reset() const noexcept
 //==============================================================================
 void JUCE_CALLTYPE Thread::sleep (int millisecs)
 {
+    JUCE_REALTIME_SAFETY_CHECK ("Thread::sleep")
+
     struct timespec time;
     time.tv_sec = millisecs / 1000;
     time.tv_nsec = (millisecs % 1000) * 1000000;
@@ -443,7 +447,15 @@ void FileOutputStream::closeHandle()
 {
     if (fileHandle != 0)
     {
-        close (getFD (fileHandle));
+        const int fd = getFD (fileHandle);
+
+        // space reserved beyond the end of the file isn't always given back on closing,
+        // but truncating it to its own length releases it
+        struct stat info;
+        if (hasPreallocated && fstat (fd, &info) == 0)
+            (void) ftruncate (fd, info.st_size);
+
+        close (fd);
         fileHandle = 0;
     }
 }
@@ -490,6 +502,48 @@ Result FileOutputStream::truncate()
     return getResultForReturnValue (ftruncate (getFD (fileHandle), (off_t) currentPosition));
 }
 
+static Result preallocateFileSpace (const int fd, const int64 totalFileSize)
+{
+   #if JUCE_LINUX
+    return getResultForReturnValue (fallocate (fd, FALLOC_FL_KEEP_SIZE, 0, (off_t) totalFileSize));
+   #elif JUCE_MAC || JUCE_IOS
+    struct stat info;
+
+    if (fstat (fd, &info) != 0)
+        return getResultForErrno();
+
+    if (totalFileSize <= (int64) info.st_size)
+        return Result::ok();
+
+    // F_PEOFPOSMODE allocates from the end of the space that's already allocated, which may be
+    // beyond the end of the file, so this can reserve a bit more than is strictly needed
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t) (totalFileSize - (int64) info.st_size), 0 };
+
+    if (fcntl (fd, F_PREALLOCATE, &store) == -1)
+    {
+        store.fst_flags = F_ALLOCATEALL;
+
+        if (fcntl (fd, F_PREALLOCATE, &store) == -1)
+            return getResultForErrno();
+    }
+
+    return Result::ok();
+   #else
+    (void) fd; (void) totalFileSize;
+    return Result::fail ("Preallocation isn't supported on this platform");
+   #endif
+}
+
+Result FileOutputStream::preallocate (const int64 totalFileSize)
+{
+    if (fileHandle == 0)
+        return status;
+
+    const Result result (preallocateFileSpace (getFD (fileHandle), totalFileSize));
+    hasPreallocated = hasPreallocated || result.wasOk();
+    return result;
+}
+
 //==============================================================================
 String SystemStats::getEnvironmentVariable (const String& name, const String& defaultValue)
 {
@@ -897,6 +951,48 @@ bool Thread::setThreadPriority (void* handle, int priority)
     return pthread_setschedparam ((pthread_t) handle, policy, &param) == 0;
 }
 
+bool Thread::setCurrentThreadRealtime (const RealtimeOptions& options)
+{
+   #if JUCE_MAC || JUCE_IOS
+    mach_timebase_info_data_t timebase;
+    (void) mach_timebase_info (&timebase);
+    const double ticksPerMs = (1000000.0 * timebase.denom) / timebase.numer;
+
+    const double constraintMs  = options.deadlineMs > 0 ? options.deadlineMs
+                                                        : (options.periodMs > 0 ? options.periodMs : 10.0);
+    const double computationMs = jlimit (0.05, constraintMs, options.computationMs > 0 ? options.computationMs
+                                                                                       : constraintMs / 2.0);
+
+    thread_time_constraint_policy_data_t policy;
+    policy.period      = (uint32_t) (options.periodMs * ticksPerMs);
+    policy.computation = (uint32_t) (computationMs * ticksPerMs);
+    policy.constraint  = (uint32_t) (constraintMs * ticksPerMs);
+    policy.preemptible = true;
+
+    return thread_policy_set (pthread_mach_thread_np (pthread_self()),
+                              THREAD_TIME_CONSTRAINT_POLICY,
+                              (thread_policy_t) &policy,
+                              THREAD_TIME_CONSTRAINT_POLICY_COUNT) == KERN_SUCCESS;
+   #else
+    (void) options;
+
+    // (one below the maximum, so as not to compete with the kernel's own real-time threads)
+    struct sched_param param;
+    param.sched_priority = jmax (sched_get_priority_min (SCHED_FIFO), sched_get_priority_max (SCHED_FIFO) - 1);
+
+    if (pthread_setschedparam (pthread_self(), SCHED_FIFO, &param) == 0)
+        return true;
+
+   #if JUCE_ANDROID
+    // Apps aren't normally allowed to use SCHED_FIFO, but they can give their threads the
+    // same nice level as the system's own audio threads (ANDROID_PRIORITY_AUDIO)
+    setpriority (PRIO_PROCESS, (id_t) gettid(), -16);
+   #endif
+
+    return false;
+   #endif
+}
+
 Thread::ThreadID Thread::getCurrentThreadId()
 {
     return (ThreadID) pthread_self();
@@ -973,13 +1069,24 @@ void* DynamicLibrary::getFunction (const String& functionName) noexcept
 class ChildProcess::ActiveProcess
 {
 public:
-    ActiveProcess (const StringArray& arguments)
-        : childPID (0), pipeHandle (0), readHandle (0)
+    ActiveProcess (const StringArray& arguments, const int streamFlags)
+        : childPID (0), pipeHandle (0), inputHandle (0), readHandle (0)
     {
         int pipeHandles[2] = { 0 };
+        int inputPipeHandles[2] = { 0 };
+
+        if ((streamFlags & wantStdIn) != 0 && pipe (inputPipeHandles) != 0)
+            return;
 
         if (pipe (pipeHandles) == 0)
         {
+            // stop any other child processes inheriting our ends of the pipes, or the
+            // streams wouldn't see their end until those processes had quit too
+            fcntl (pipeHandles[0], F_SETFD, FD_CLOEXEC);
+
+            if (inputPipeHandles[1] != 0)
+                fcntl (inputPipeHandles[1], F_SETFD, FD_CLOEXEC);
+
             const pid_t result = fork();
 
             if (result < 0)
@@ -991,10 +1098,23 @@ public:
             {
                 // we're the child process..
                 close (pipeHandles[0]);   // close the read handle
-                dup2 (pipeHandles[1], 1); // turns the pipe into stdout
-                dup2 (pipeHandles[1], 2); //  + stderr
+
+                const int nullHandle = open ("/dev/null", O_RDWR);
+
+                dup2 ((streamFlags & wantStdOut) != 0 ? pipeHandles[1] : nullHandle, 1); // turns the pipe into stdout
+                dup2 ((streamFlags & wantStdErr) != 0 ? pipeHandles[1] : nullHandle, 2); //  + stderr
                 close (pipeHandles[1]);
 
+                if (inputPipeHandles[0] != 0)
+                {
+                    close (inputPipeHandles[1]);
+                    dup2 (inputPipeHandles[0], 0); // turns the other pipe into stdin
+                    close (inputPipeHandles[0]);
+                }
+
+                if (nullHandle >= 0)
+                    close (nullHandle);
+
                 Array<char*> argv;
                 for (int i = 0; i < arguments.size(); ++i)
                     if (arguments[i].isNotEmpty())
@@ -1011,12 +1131,27 @@ public:
                 childPID = result;
                 pipeHandle = pipeHandles[0];
                 close (pipeHandles[1]); // close the write handle
+
+                if (inputPipeHandles[0] != 0)
+                {
+                    inputHandle = inputPipeHandles[1];
+                    close (inputPipeHandles[0]); // close the child's end of the input pipe
+                    inputPipeHandles[0] = inputPipeHandles[1] = 0;
+                }
             }
         }
+
+        if (inputPipeHandles[0] != 0)
+        {
+            close (inputPipeHandles[0]);
+            close (inputPipeHandles[1]);
+        }
     }
 
     ~ActiveProcess()
     {
+        closeInput();
+
         if (readHandle != 0)
             fclose (readHandle);
 
@@ -1053,6 +1188,84 @@ public:
         return 0;
     }
 
+    int readAvailable (void* const dest, const int maxBytes)
+    {
+        // Data may have been pulled into the stdio buffer by read(), and wouldn't be seen here
+        jassert (readHandle == 0);
+
+        pollfd pfd;
+        pfd.fd = pipeHandle;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        if (poll (&pfd, 1, 0) <= 0)
+            return 0;
+
+        const ssize_t num = ::read (pipeHandle, dest, (size_t) maxBytes);
+
+        if (num > 0)
+            return (int) num;
+
+        return (num < 0 && (errno == EINTR || errno == EAGAIN)) ? 0 : -1;
+    }
+
+    int getOutputHandle() const noexcept    { return pipeHandle; }
+
+    int write (const void* const source, const int numBytes)
+    {
+        jassert (source != nullptr || numBytes == 0);
+
+        if (inputHandle == 0)
+            return -1;
+
+        // If the child has quit, writing to its stdin raises SIGPIPE, which would kill us by
+        // default. So the signal is blocked on this thread while writing, and if the write
+        // raised it, it's consumed here rather than being left pending.
+        sigset_t pipeSignal, oldMask, pending;
+        sigemptyset (&pipeSignal);
+        sigaddset (&pipeSignal, SIGPIPE);
+        sigpending (&pending);
+        const bool wasAlreadyPending = sigismember (&pending, SIGPIPE) != 0;
+        pthread_sigmask (SIG_BLOCK, &pipeSignal, &oldMask);
+
+        int numWritten = 0;
+
+        while (numWritten < numBytes)
+        {
+            const ssize_t num = ::write (inputHandle, addBytesToPointer (source, numWritten),
+                                         (size_t) (numBytes - numWritten));
+
+            if (num < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                if (errno == EPIPE && ! wasAlreadyPending)
+                {
+                    int sig;
+                    sigwait (&pipeSignal, &sig);
+                }
+
+                numWritten = -1;
+                break;
+            }
+
+            numWritten += (int) num;
+        }
+
+        pthread_sigmask (SIG_SETMASK, &oldMask, nullptr);
+        return numWritten;
+    }
+
+    void closeInput()
+    {
+        if (inputHandle != 0)
+        {
+            close (inputHandle);
+            inputHandle = 0;
+        }
+    }
+
     bool killProcess() const
     {
         return ::kill (childPID, SIGKILL) == 0;
@@ -1061,23 +1274,24 @@ public:
     int childPID;
 
 private:
-    int pipeHandle;
+    int pipeHandle, inputHandle;
     FILE* readHandle;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ActiveProcess)
 };
 
-bool ChildProcess::start (const String& command)
+bool ChildProcess::start (const String& command, const int streamFlags)
 {
-    return start (StringArray::fromTokens (command, true));
+    return start (StringArray::fromTokens (command, true), streamFlags);
 }
 
-bool ChildProcess::start (const StringArray& args)
+bool ChildProcess::start (const StringArray& args, const int streamFlags)
 {
     if (args.size() == 0)
         return false;
 
-    activeProcess = new ActiveProcess (args);
+    setOutputCallback (nullptr);
+    activeProcess = new ActiveProcess (args, streamFlags);
 
     if (activeProcess->childPID == 0)
         activeProcess = nullptr;
@@ -1095,6 +1309,41 @@ int ChildProcess::readProcessOutput (void* dest, int numBytes)
     return activeProcess != nullptr ? activeProcess->read (dest, numBytes) : 0;
 }
 
+int ChildProcess::readAvailableOutput (void* dest, int maxBytes)
+{
+    return activeProcess != nullptr ? activeProcess->readAvailable (dest, maxBytes) : -1;
+}
+
+void ChildProcess::waitForOutput (const Array<ChildProcess*>& processes, const int timeoutMs)
+{
+    HeapBlock<pollfd> fds ((size_t) processes.size());
+
+    for (int i = 0; i < processes.size(); ++i)
+    {
+        const ActiveProcess* const p = processes.getUnchecked(i)->activeProcess;
+
+        if (p == nullptr)
+            return;
+
+        fds[i].fd = p->getOutputHandle();
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+
+    poll (fds, (nfds_t) processes.size(), timeoutMs);
+}
+
+int ChildProcess::writeProcessInput (const void* source, int numBytes)
+{
+    return activeProcess != nullptr ? activeProcess->write (source, numBytes) : -1;
+}
+
+void ChildProcess::closeProcessInput()
+{
+    if (activeProcess != nullptr)
+        activeProcess->closeInput();
+}
+
 bool ChildProcess::kill()
 {
     return activeProcess == nullptr || activeProcess->killProcess();
@@ -309,6 +309,23 @@ Result FileOutputStream::truncate()
                                               : WindowsFileHelpers::getResultForLastError();
 }
 
+Result FileOutputStream::preallocate (const int64 totalFileSize)
+{
+    if (fileHandle == nullptr)
+        return status;
+
+   #if _WIN32_WINNT >= 0x0600
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = totalFileSize;
+
+    return SetFileInformationByHandle ((HANDLE) fileHandle, FileAllocationInfo, &info, sizeof (info))
+                ? Result::ok() : WindowsFileHelpers::getResultForLastError();
+   #else
+    (void) totalFileSize;
+    return Result::fail ("Preallocation needs Windows Vista or later");
+   #endif
+}
+
 //==============================================================================
 void MemoryMappedFile::openInternal (const File& file, AccessMode mode)
 {
@@ -112,9 +112,78 @@ SystemStats::CPUFlags::CPUFlags()
     has3DNow = IsProcessorFeaturePresent (PF_3DNOW_INSTRUCTIONS_AVAILABLE) != 0;
    #endif
 
+    hasAVX = false;
+    hasAVX2 = false;
+    hasSHA = false;
+    hasAES = false;
+    hasNeon = false;
+
+   #if JUCE_USE_INTRINSICS
+    int info [4];
+    __cpuid (info, 1);
+    hasAES = (info[2] & (1 << 25)) != 0 && (info[2] & (1 << 1)) != 0;
+
+    // AVX is only usable if the OSXSAVE bit is set and the OS is saving the AVX registers..
+    if ((info[2] & (3 << 27)) == (3 << 27))
+    {
+       #if _MSC_FULL_VER >= 160040219   // (_xgetbv needs VS2010 SP1 or later)
+        hasAVX = (_xgetbv (0) & 6) == 6;
+       #endif
+    }
+
+    __cpuid (info, 0);
+
+    if (info[0] >= 7)
+    {
+        __cpuidex (info, 7, 0);
+        hasAVX2 = hasAVX && (info[1] & (1 << 5)) != 0;
+        hasSHA  = (info[1] & (1 << 29)) != 0;
+    }
+   #endif
+
     SYSTEM_INFO systemInfo;
     GetNativeSystemInfo (&systemInfo);
     numCpus = (int) systemInfo.dwNumberOfProcessors;
+
+    numPhysicalCpus = 0;
+    zerostruct (cacheSizes);
+
+    DWORD bufferSize = 0;
+    GetLogicalProcessorInformation (nullptr, &bufferSize);
+
+    const int numEntries = (int) (bufferSize / sizeof (SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    HeapBlock<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> entries ((size_t) jmax (1, numEntries));
+
+    if (numEntries > 0 && GetLogicalProcessorInformation (entries, &bufferSize))
+    {
+        physicalCoreForCpu.insertMultiple (0, 0, numCpus);
+
+        for (int i = 0; i < numEntries; ++i)
+        {
+            const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& entry = entries[i];
+
+            if (entry.Relationship == RelationProcessorCore)
+            {
+                for (int cpu = 0; cpu < jmin (numCpus, (int) sizeof (ULONG_PTR) * 8); ++cpu)
+                    if ((entry.ProcessorMask & ((ULONG_PTR) 1 << cpu)) != 0)
+                        physicalCoreForCpu.set (cpu, numPhysicalCpus);
+
+                ++numPhysicalCpus;
+            }
+            else if (entry.Relationship == RelationCache
+                      && entry.Cache.Type != CacheInstruction
+                      && entry.Cache.Level >= 1 && entry.Cache.Level <= 3)
+            {
+                cacheSizes [entry.Cache.Level - 1] = (int) entry.Cache.Size;
+            }
+        }
+    }
+
+    if (numPhysicalCpus == 0)
+    {
+        numPhysicalCpus = numCpus;
+        physicalCoreForCpu.clear();
+    }
 }
 
 #if JUCE_MSVC && JUCE_CHECK_MEMORY_LEAKS
@@ -68,6 +68,7 @@ CriticalSection::~CriticalSection() noexcept
 
 void CriticalSection::enter() const noexcept
 {
+    JUCE_REALTIME_SAFETY_CHECK ("CriticalSection::enter")
     EnterCriticalSection ((CRITICAL_SECTION*) internal);
 }
 
@@ -94,6 +95,7 @@ WaitableEvent::~WaitableEvent() noexcept
 
 bool WaitableEvent::wait (const int timeOutMillisecs) const noexcept
 {
+    JUCE_REALTIME_SAFETY_CHECK ("WaitableEvent::wait")
     return WaitForSingleObject (internal, (DWORD) timeOutMillisecs) == WAIT_OBJECT_0;
 }
 
@@ -201,6 +203,23 @@ void Thread::setCurrentThreadAffinityMask (const uint32 affinityMask)
     SetThreadAffinityMask (GetCurrentThread(), affinityMask);
 }
 
+bool Thread::setCurrentThreadRealtime (const RealtimeOptions&)
+{
+    // MMCSS is only available from Vista onwards, so it has to be found at runtime
+    typedef HANDLE (WINAPI* AvSetMmThreadCharacteristicsFunction) (LPCWSTR, LPDWORD);
+
+    static HMODULE avrtModule = LoadLibraryA ("avrt.dll");
+    static AvSetMmThreadCharacteristicsFunction avSetMmThreadCharacteristics
+        = avrtModule != 0 ? (AvSetMmThreadCharacteristicsFunction) GetProcAddress (avrtModule, "AvSetMmThreadCharacteristicsW")
+                          : nullptr;
+
+    DWORD taskIndex = 0;
+    const bool joinedMMCSS = avSetMmThreadCharacteristics != nullptr
+                              && avSetMmThreadCharacteristics (L"Pro Audio", &taskIndex) != 0;
+
+    return (SetThreadPriority (GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != FALSE) && joinedMMCSS;
+}
+
 //==============================================================================
 struct SleepEvent
 {
@@ -226,6 +245,8 @@ static SleepEvent sleepEvent;
 
 void JUCE_CALLTYPE Thread::sleep (const int millisecs)
 {
+    JUCE_REALTIME_SAFETY_CHECK ("Thread::sleep")
+
     if (millisecs >= 10 || sleepEvent.handle == 0)
     {
         Sleep ((DWORD) millisecs);
@@ -462,30 +483,43 @@ void InterProcessLock::exit()
 class ChildProcess::ActiveProcess
 {
 public:
-    ActiveProcess (const String& command)
-        : ok (false), readPipe (0), writePipe (0)
+    ActiveProcess (const String& command, const int streamFlags)
+        : ok (false), readPipe (0), writePipe (0), inputReadPipe (0), inputWritePipe (0)
     {
         SECURITY_ATTRIBUTES securityAtts = { 0 };
         securityAtts.nLength = sizeof (securityAtts);
         securityAtts.bInheritHandle = TRUE;
 
         if (CreatePipe (&readPipe, &writePipe, &securityAtts, 0)
-             && SetHandleInformation (readPipe, HANDLE_FLAG_INHERIT, 0))
+             && SetHandleInformation (readPipe, HANDLE_FLAG_INHERIT, 0)
+             && ((streamFlags & wantStdIn) == 0
+                   || (CreatePipe (&inputReadPipe, &inputWritePipe, &securityAtts, 0)
+                        && SetHandleInformation (inputWritePipe, HANDLE_FLAG_INHERIT, 0))))
         {
             STARTUPINFOW startupInfo = { 0 };
             startupInfo.cb = sizeof (startupInfo);
-            startupInfo.hStdError  = writePipe;
-            startupInfo.hStdOutput = writePipe;
+            startupInfo.hStdError  = (streamFlags & wantStdErr) != 0 ? writePipe : 0;
+            startupInfo.hStdOutput = (streamFlags & wantStdOut) != 0 ? writePipe : 0;
+            startupInfo.hStdInput  = inputReadPipe;
             startupInfo.dwFlags = STARTF_USESTDHANDLES;
 
             ok = CreateProcess (nullptr, const_cast <LPWSTR> (command.toWideCharPointer()),
                                 nullptr, nullptr, TRUE, CREATE_NO_WINDOW | CREATE_UNICODE_ENVIRONMENT,
                                 nullptr, nullptr, &startupInfo, &processInfo) != FALSE;
         }
+
+        // the child has its own copy of this now, and ours would stop it ever seeing the end of its input
+        if (inputReadPipe != 0)
+        {
+            CloseHandle (inputReadPipe);
+            inputReadPipe = 0;
+        }
     }
 
     ~ActiveProcess()
     {
+        closeInput();
+
         if (ok)
         {
             CloseHandle (processInfo.hThread);
@@ -539,6 +573,58 @@ public:
         return total;
     }
 
+    int readAvailable (void* dest, int maxBytes)
+    {
+        DWORD available = 0;
+
+        if (! (ok && PeekNamedPipe ((HANDLE) readPipe, nullptr, 0, nullptr, &available, nullptr)))
+            return -1;
+
+        if (available == 0)
+            return isRunning() ? 0 : -1;
+
+        DWORD numRead = 0;
+        if (! ReadFile ((HANDLE) readPipe, dest, (DWORD) jmin ((int) available, maxBytes), &numRead, nullptr))
+            return -1;
+
+        return (int) numRead;
+    }
+
+    bool hasOutputEvent() const
+    {
+        DWORD available = 0;
+
+        return ! (ok && PeekNamedPipe ((HANDLE) readPipe, nullptr, 0, nullptr, &available, nullptr))
+                 || available > 0 || ! isRunning();
+    }
+
+    int write (const void* source, int numBytes)
+    {
+        int total = 0;
+
+        while (inputWritePipe != 0 && total < numBytes)
+        {
+            DWORD numWritten = 0;
+
+            if (! WriteFile (inputWritePipe, addBytesToPointer (source, total),
+                             (DWORD) (numBytes - total), &numWritten, nullptr))
+                return -1;
+
+            total += (int) numWritten;
+        }
+
+        return inputWritePipe != 0 ? total : -1;
+    }
+
+    void closeInput()
+    {
+        if (inputWritePipe != 0)
+        {
+            CloseHandle (inputWritePipe);
+            inputWritePipe = 0;
+        }
+    }
+
     bool killProcess() const
     {
         return TerminateProcess (processInfo.hProcess, 0) != FALSE;
@@ -547,15 +633,16 @@ public:
     bool ok;
 
 private:
-    HANDLE readPipe, writePipe;
+    HANDLE readPipe, writePipe, inputReadPipe, inputWritePipe;
     PROCESS_INFORMATION processInfo;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ActiveProcess)
 };
 
-bool ChildProcess::start (const String& command)
+bool ChildProcess::start (const String& command, const int streamFlags)
 {
-    activeProcess = new ActiveProcess (command);
+    setOutputCallback (nullptr);
+    activeProcess = new ActiveProcess (command, streamFlags);
 
     if (! activeProcess->ok)
         activeProcess = nullptr;
@@ -563,9 +650,9 @@ bool ChildProcess::start (const String& command)
     return activeProcess != nullptr;
 }
 
-bool ChildProcess::start (const StringArray& args)
+bool ChildProcess::start (const StringArray& args, const int streamFlags)
 {
-    return start (args.joinIntoString (" "));
+    return start (args.joinIntoString (" "), streamFlags);
 }
 
 bool ChildProcess::isRunning() const
@@ -578,6 +665,44 @@ int ChildProcess::readProcessOutput (void* dest, int numBytes)
     return activeProcess != nullptr ? activeProcess->read (dest, numBytes) : 0;
 }
 
+int ChildProcess::readAvailableOutput (void* dest, int maxBytes)
+{
+    return activeProcess != nullptr ? activeProcess->readAvailable (dest, maxBytes) : -1;
+}
+
+void ChildProcess::waitForOutput (const Array<ChildProcess*>& processes, const int timeoutMs)
+{
+    // anonymous pipes can't be waited on, so this has to poll them
+    const uint32 endTime = Time::getMillisecondCounter() + (uint32) timeoutMs;
+
+    for (;;)
+    {
+        for (int i = 0; i < processes.size(); ++i)
+        {
+            const ActiveProcess* const p = processes.getUnchecked(i)->activeProcess;
+
+            if (p == nullptr || p->hasOutputEvent())
+                return;
+        }
+
+        if (Time::getMillisecondCounter() >= endTime)
+            return;
+
+        Sleep (1);
+    }
+}
+
+int ChildProcess::writeProcessInput (const void* source, int numBytes)
+{
+    return activeProcess != nullptr ? activeProcess->write (source, numBytes) : -1;
+}
+
+void ChildProcess::closeProcessInput()
+{
+    if (activeProcess != nullptr)
+        activeProcess->closeInput();
+}
+
 bool ChildProcess::kill()
 {
     return activeProcess == nullptr || activeProcess->killProcess();
@@ -0,0 +1,1139 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace HTTPClientHelpers
+{
+    static bool decomposeURL (const String& url, String& host, int& port, String& path)
+    {
+        if (! url.startsWithIgnoreCase ("http://"))
+            return false;
+
+        const String hostAndPort (url.substring (7).upToFirstOccurrenceOf ("/", false, false)
+                                                    .upToFirstOccurrenceOf ("?", false, false));
+        path = url.substring (7 + hostAndPort.length());
+
+        if (! path.startsWithChar ('/'))
+            path = "/" + path;
+
+        host = hostAndPort.upToFirstOccurrenceOf (":", false, false);
+        port = hostAndPort.containsChar (':') ? hostAndPort.fromFirstOccurrenceOf (":", false, false).getIntValue() : 80;
+
+        return host.isNotEmpty() && port > 0;
+    }
+
+    static String resolveRedirect (const String& location, const String& host, const int port)
+    {
+        if (location.startsWithIgnoreCase ("http://") || location.startsWithIgnoreCase ("https://"))
+            return location;
+
+        return "http://" + host + (port != 80 ? ":" + String (port) : String::empty)
+                 + (location.startsWithChar ('/') ? location : "/" + location);
+    }
+
+    static bool hasHeader (const StringPairArray& headers, const char* const name)
+    {
+        return headers.getAllKeys().contains (name, true);
+    }
+
+    static bool isRedirect (const int statusCode) noexcept
+    {
+        return statusCode == 301 || statusCode == 302 || statusCode == 303
+                || statusCode == 307 || statusCode == 308;
+    }
+
+    // (methods that can safely be sent twice, as defined by RFC 7231, 4.2.2)
+    static bool isIdempotent (const String& method)
+    {
+        return method.equalsIgnoreCase ("GET") || method.equalsIgnoreCase ("HEAD")
+                || method.equalsIgnoreCase ("PUT") || method.equalsIgnoreCase ("DELETE")
+                || method.equalsIgnoreCase ("OPTIONS") || method.equalsIgnoreCase ("TRACE");
+    }
+}
+
+//==============================================================================
+class HTTPClient::RequestJob  : public ThreadPoolJob
+{
+public:
+    RequestJob (HTTPClient& c, const Request& r, Listener* const l, const int id)
+        : ThreadPoolJob ("HTTP request"), client (c), request (r), listener (l), requestId (id)
+    {
+    }
+
+    ~RequestJob()
+    {
+        client.removeJob (this);
+    }
+
+    JobStatus runJob()
+    {
+        const Response response (client.runRequest (request, listener, requestId, this));
+
+        if (listener != nullptr)
+            listener->requestFinished (requestId, response);
+
+        return jobHasFinished;
+    }
+
+    bool isCancelled() const noexcept       { return cancelled.get() != 0 || shouldExit(); }
+    void cancel() noexcept                  { cancelled = 1; }
+
+    HTTPClient& client;
+    const Request request;
+    Listener* const listener;
+    const int requestId;
+    Atomic<int> cancelled;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (RequestJob)
+};
+
+//==============================================================================
+/*  A keep-alive socket connection to a server, with a buffer for reading its responses. */
+class HTTPClient::Connection
+{
+public:
+    Connection (const String& key, const String& host, const int port)
+        : hostKey (key), hostName (host), portNumber (port), lastUsedTime (0),
+          numRequestsSent (0), bufferStart (0), bufferEnd (0),
+          numBytesReceived (0), responseStart (0), closedByServer (false)
+    {
+        buffer.malloc (bufferSize);
+    }
+
+    bool open (const int timeOutMs)
+    {
+        return socket.connect (hostName, portNumber, timeOutMs < 0 ? 60000 : timeOutMs);
+    }
+
+    // True if the server has closed an idle connection (or sent something unexpected)
+    bool isStale() const
+    {
+        return bufferStart != bufferEnd || ! socket.isConnected() || socket.waitUntilReady (true, 0) != 0;
+    }
+
+    bool isWaitingForData() const noexcept  { return bufferStart < bufferEnd; }
+
+    // Call this before sending each request. Returns true if the connection has been used before.
+    bool startRequest() noexcept
+    {
+        responseStart = numBytesReceived;
+        return numRequestsSent++ > 0;
+    }
+
+    // True if the server closed the connection without sending any of the current request's response
+    bool wasClosedBeforeResponse() const noexcept
+    {
+        return closedByServer && numBytesReceived == responseStart;
+    }
+
+    // After a failed write, this checks whether it was because the server had already closed the connection
+    bool checkForClosedConnection()
+    {
+        if (! closedByServer && bufferEnd < bufferSize && socket.waitUntilReady (true, 0) != 0)
+        {
+            const int numRead = socket.read (buffer + bufferEnd, bufferSize - bufferEnd, false);
+
+            if (numRead <= 0)
+            {
+                closedByServer = true;
+            }
+            else
+            {
+                bufferEnd += numRead;
+                numBytesReceived += numRead;
+            }
+        }
+
+        return wasClosedBeforeResponse();
+    }
+
+    //==============================================================================
+    bool writeAll (const void* data, size_t numBytes, const int timeOutMs, RequestJob* const job, Result& error)
+    {
+        while (numBytes > 0)
+        {
+            if (! waitUntilReady (false, timeOutMs, job, error))
+                return false;
+
+            const int numWritten = socket.write (data, (int) jmin (numBytes, (size_t) 65536));
+
+            if (numWritten <= 0)
+            {
+                error = Result::fail ("Failed to send the request");
+                return false;
+            }
+
+            data = addBytesToPointer (data, numWritten);
+            numBytes -= (size_t) numWritten;
+        }
+
+        return true;
+    }
+
+    bool readLine (String& line, const int timeOutMs, RequestJob* const job, Result& error)
+    {
+        for (;;)
+        {
+            const char* const start = buffer + bufferStart;
+            const char* const newLine = static_cast <const char*> (memchr (start, '\n', (size_t) (bufferEnd - bufferStart)));
+
+            if (newLine != nullptr)
+            {
+                const char* lineEnd = newLine;
+
+                if (lineEnd > start && lineEnd[-1] == '\r')
+                    --lineEnd;
+
+                line = String::fromUTF8 (start, (int) (lineEnd - start));
+                bufferStart = (int) (newLine + 1 - buffer);
+                return true;
+            }
+
+            if (bufferStart == 0 && bufferEnd == bufferSize)
+            {
+                error = Result::fail ("Response header line too long");
+                return false;
+            }
+
+            if (! readMore (timeOutMs, job, error))
+                return false;
+        }
+    }
+
+    // Passes the next numBytes bytes to the handler (or all the data until the server closes the connection if numBytes < 0)
+    template <class HandlerType>
+    bool readBody (int64 numBytes, HandlerType& handler, const int timeOutMs, RequestJob* const job, Result& error)
+    {
+        while (numBytes != 0)
+        {
+            if (bufferStart == bufferEnd)
+            {
+                if (! readMore (timeOutMs, job, error))
+                    return numBytes < 0 && closedByServer;
+            }
+
+            const int numToUse = (int) (numBytes < 0 ? (int64) (bufferEnd - bufferStart)
+                                                     : jmin (numBytes, (int64) (bufferEnd - bufferStart)));
+
+            if (! handler.write (buffer + bufferStart, (size_t) numToUse))
+            {
+                error = Result::fail ("Cancelled");
+                return false;
+            }
+
+            bufferStart += numToUse;
+
+            if (numBytes > 0)
+                numBytes -= numToUse;
+        }
+
+        return true;
+    }
+
+    StreamingSocket socket;
+    const String hostKey, hostName;
+    const int portNumber;
+    uint32 lastUsedTime;
+    int numRequestsSent;
+
+private:
+    enum { bufferSize = 16384, pollIntervalMs = 50 };
+
+    HeapBlock<char> buffer;
+    int bufferStart, bufferEnd;
+    int64 numBytesReceived, responseStart;
+    bool closedByServer;
+
+    bool waitUntilReady (const bool forReading, const int timeOutMs, RequestJob* const job, Result& error)
+    {
+        const uint32 startTime = Time::getMillisecondCounter();
+
+        for (;;)
+        {
+            if (job != nullptr && job->isCancelled())
+            {
+                error = Result::fail ("Cancelled");
+                return false;
+            }
+
+            int waitTime = pollIntervalMs;
+
+            if (timeOutMs >= 0)
+            {
+                waitTime = jmin (waitTime, timeOutMs - (int) (Time::getMillisecondCounter() - startTime));
+
+                if (waitTime < 0)
+                {
+                    error = Result::fail ("Timed out");
+                    return false;
+                }
+            }
+
+            const int result = socket.waitUntilReady (forReading, waitTime);
+
+            if (result > 0)
+                return true;
+
+            if (result < 0)
+            {
+                error = Result::fail ("Connection failed");
+                return false;
+            }
+        }
+    }
+
+    bool readMore (const int timeOutMs, RequestJob* const job, Result& error)
+    {
+        if (bufferStart > 0)
+        {
+            memmove (buffer, buffer + bufferStart, (size_t) (bufferEnd - bufferStart));
+            bufferEnd -= bufferStart;
+            bufferStart = 0;
+        }
+
+        if (! waitUntilReady (true, timeOutMs, job, error))
+            return false;
+
+        const int numRead = socket.read (buffer + bufferEnd, bufferSize - bufferEnd, false);
+
+        if (numRead <= 0)
+        {
+            closedByServer = true;
+            error = Result::fail ("Connection closed by server");
+            return false;
+        }
+
+        bufferEnd += numRead;
+        numBytesReceived += numRead;
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Connection)
+};
+
+//==============================================================================
+/*  Receives the body of a response, and passes it on to the listener. */
+struct HTTPResponseBodyHandler
+{
+    HTTPResponseBodyHandler (HTTPClient::Listener* const l, const int id, MemoryBlock* const dest)
+        : listener (l), requestId (id), body (dest), bodySize (0)
+    {
+    }
+
+    bool write (const void* const data, const size_t numBytes)
+    {
+        if (body != nullptr)
+        {
+            body->ensureSize (jmax ((size_t) 1024, bodySize + numBytes, body->getSize() * 2));
+            body->copyFrom (data, (int) bodySize, numBytes);
+            bodySize += numBytes;
+        }
+
+        return listener == nullptr || listener->responseDataReceived (requestId, data, numBytes);
+    }
+
+    HTTPClient::Listener* const listener;
+    const int requestId;
+    MemoryBlock* const body;
+    size_t bodySize;
+
+    JUCE_DECLARE_NON_COPYABLE (HTTPResponseBodyHandler)
+};
+
+//==============================================================================
+HTTPClient::Request::Request (const URL& u)
+    : url (u), method ("GET"), timeOutMs (30000), maxRedirects (5), keepResponseBody (true)
+{
+}
+
+HTTPClient::Response::Response()
+    : result (Result::ok()), statusCode (0), wasCancelled (false)
+{
+}
+
+//==============================================================================
+HTTPClient::HTTPClient (const int numThreads, const int maxConnections)
+    : maxConnectionsPerHost (jmax (1, maxConnections)),
+      keepAliveTimeoutMs (30000),
+      threadPool (jmax (1, numThreads))
+{
+}
+
+HTTPClient::~HTTPClient()
+{
+    cancelAllRequests();
+    threadPool.removeAllJobs (true, 10000);
+
+    const ScopedLock sl (lock);
+    jassert (requestJobs.size() == 0);
+    idleConnections.clear();
+}
+
+//==============================================================================
+int HTTPClient::sendRequest (const Request& request, Listener* const listener)
+{
+    const int requestId = ++nextRequestId;
+    RequestJob* const job = new RequestJob (*this, request, listener, requestId);
+
+    {
+        const ScopedLock sl (lock);
+        requestJobs.add (job);
+    }
+
+    threadPool.addJob (job, true);
+    return requestId;
+}
+
+bool HTTPClient::cancelRequest (const int requestId)
+{
+    const ScopedLock sl (lock);
+
+    for (int i = requestJobs.size(); --i >= 0;)
+    {
+        RequestJob* const job = requestJobs.getUnchecked (i);
+
+        if (job->requestId == requestId)
+        {
+            job->cancel();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void HTTPClient::cancelAllRequests()
+{
+    const ScopedLock sl (lock);
+
+    for (int i = requestJobs.size(); --i >= 0;)
+        requestJobs.getUnchecked (i)->cancel();
+}
+
+void HTTPClient::removeJob (RequestJob* const job)
+{
+    const ScopedLock sl (lock);
+    requestJobs.removeFirstMatchingValue (job);
+}
+
+HTTPClient::Response HTTPClient::performRequest (const Request& request)
+{
+    return runRequest (request, nullptr, 0, nullptr);
+}
+
+//==============================================================================
+void HTTPClient::setKeepAliveTimeout (const int milliseconds) noexcept
+{
+    keepAliveTimeoutMs = milliseconds;
+}
+
+void HTTPClient::closeIdleConnections()
+{
+    OwnedArray<Connection> connectionsToClose;
+
+    {
+        const ScopedLock sl (lock);
+
+        while (idleConnections.size() > 0)
+            connectionsToClose.add (idleConnections.removeAndReturn (idleConnections.size() - 1));
+    }
+}
+
+int HTTPClient::getNumIdleConnections() const
+{
+    const ScopedLock sl (lock);
+    return idleConnections.size();
+}
+
+int HTTPClient::getNumConnectionsOpened() const noexcept
+{
+    return numConnectionsOpened.get();
+}
+
+//==============================================================================
+HTTPClient::Connection* HTTPClient::getConnection (const String& host, const int port, const Request& request,
+                                                   RequestJob* const job, Result& error)
+{
+    const String key (host.toLowerCase() + ":" + String (port));
+    const uint32 startTime = Time::getMillisecondCounter();
+
+    for (;;)
+    {
+        OwnedArray<Connection> connectionsToClose;
+
+        {
+            const ScopedLock sl (lock);
+            const uint32 now = Time::getMillisecondCounter();
+
+            // look for an idle connection to this host, discarding any that have expired or been closed..
+            for (int i = idleConnections.size(); --i >= 0;)
+            {
+                Connection* const c = idleConnections.getUnchecked (i);
+
+                if ((int) (now - c->lastUsedTime) > keepAliveTimeoutMs || c->isStale())
+                {
+                    connectionsToClose.add (idleConnections.removeAndReturn (i));
+                }
+                else if (c->hostKey == key)
+                {
+                    numActiveConnections.set (key, numActiveConnections [key] + 1);
+                    return idleConnections.removeAndReturn (i);
+                }
+            }
+
+            if (numActiveConnections [key] < maxConnectionsPerHost)
+            {
+                numActiveConnections.set (key, numActiveConnections [key] + 1);
+                break;
+            }
+        }
+
+        // all the connections to this host are busy, so wait for one to be released..
+        if (job != nullptr && job->isCancelled())
+        {
+            error = Result::fail ("Cancelled");
+            return nullptr;
+        }
+
+        if (request.timeOutMs >= 0 && (int) (Time::getMillisecondCounter() - startTime) > request.timeOutMs)
+        {
+            error = Result::fail ("Timed out waiting for a connection");
+            return nullptr;
+        }
+
+        connectionReleased.wait (50);
+    }
+
+    ScopedPointer<Connection> c (new Connection (key, host, port));
+
+    if (! c->open (request.timeOutMs))
+    {
+        releaseConnection (c.release(), false);
+        error = Result::fail ("Couldn't connect to " + key);
+        return nullptr;
+    }
+
+    ++numConnectionsOpened;
+    return c.release();
+}
+
+void HTTPClient::releaseConnection (Connection* const c, const bool canBeReused)
+{
+    ScopedPointer<Connection> connectionToClose;
+
+    {
+        const ScopedLock sl (lock);
+        numActiveConnections.set (c->hostKey, numActiveConnections [c->hostKey] - 1);
+
+        if (canBeReused && c->socket.isConnected() && ! c->isWaitingForData())
+        {
+            c->lastUsedTime = Time::getMillisecondCounter();
+            idleConnections.add (c);
+        }
+        else
+        {
+            connectionToClose = c;
+        }
+    }
+
+    connectionReleased.signal();
+}
+
+//==============================================================================
+HTTPClient::Response HTTPClient::runRequest (const Request& originalRequest, Listener* const listener,
+                                             const int requestId, RequestJob* const job)
+{
+    using namespace HTTPClientHelpers;
+
+    Response response;
+    Request request (originalRequest);
+    String address (request.url.toString (true));
+    int numRedirects = 0;
+
+    for (;;)
+    {
+        String host, path;
+        int port;
+
+        if (! decomposeURL (address, host, port, path))
+        {
+            response.result = Result::fail ("Unsupported URL: " + address);
+            return response;
+        }
+
+        const bool isHead = request.method.equalsIgnoreCase ("HEAD");
+        const bool canBeResent = isIdempotent (request.method);
+        bool canBeReused = false, isRedirecting = false;
+
+        for (int attempt = 0;; ++attempt)
+        {
+            response.result = Result::ok();
+            response.statusCode = 0;
+            response.headers.clear();
+            response.body.setSize (0);
+
+            Connection* const c = getConnection (host, port, request, job, response.result);
+
+            if (c == nullptr)
+                break;
+
+            const bool isReusedConnection = c->startRequest();
+
+            // send the request..
+            {
+                MemoryOutputStream header (1024);
+                header << request.method << ' ' << path << " HTTP/1.1\r\n";
+
+                const StringArray& names = request.headers.getAllKeys();
+                const StringArray& values = request.headers.getAllValues();
+
+                if (! hasHeader (request.headers, "Host"))
+                    header << "Host: " << host << (port != 80 ? ":" + String (port) : String::empty) << "\r\n";
+
+                if (! hasHeader (request.headers, "User-Agent"))
+                    header << "User-Agent: JUCE/" JUCE_STRINGIFY(JUCE_MAJOR_VERSION)
+                              "." JUCE_STRINGIFY(JUCE_MINOR_VERSION) "." JUCE_STRINGIFY(JUCE_BUILDNUMBER) "\r\n";
+
+                if (! hasHeader (request.headers, "Content-Length")
+                     && (request.body.getSize() > 0 || request.method.equalsIgnoreCase ("POST") || request.method.equalsIgnoreCase ("PUT")))
+                    header << "Content-Length: " << (int64) request.body.getSize() << "\r\n";
+
+                for (int i = 0; i < names.size(); ++i)
+                    header << names[i] << ": " << values[i] << "\r\n";
+
+                header << "\r\n" << request.body;
+
+                if (! c->writeAll (header.getData(), header.getDataSize(), request.timeOutMs, job, response.result))
+                {
+                    // (a connection that has been idle may have been closed by the server, so try again on a new one)
+                    const bool shouldRetry = isReusedConnection && attempt == 0 && canBeResent
+                                               && c->checkForClosedConnection();
+                    releaseConnection (c, false);
+
+                    if (shouldRetry)
+                        continue;
+
+                    break;
+                }
+            }
+
+            // read the status line and header fields, skipping any interim 1xx responses..
+            String statusLine, httpVersion;
+
+            for (;;)
+            {
+                if (! c->readLine (statusLine, request.timeOutMs, job, response.result))
+                    break;
+
+                httpVersion = statusLine.upToFirstOccurrenceOf (" ", false, false);
+                response.statusCode = statusLine.fromFirstOccurrenceOf (" ", false, false).getIntValue();
+
+                if (! httpVersion.startsWithIgnoreCase ("HTTP/") || response.statusCode < 100)
+                {
+                    response.result = Result::fail ("Invalid response: " + statusLine.substring (0, 40));
+                    break;
+                }
+
+                for (;;)
+                {
+                    String line;
+
+                    if (! c->readLine (line, request.timeOutMs, job, response.result))
+                        break;
+
+                    if (line.isEmpty())
+                        break;
+
+                    const String name (line.upToFirstOccurrenceOf (":", false, false).trim());
+                    const String value (line.fromFirstOccurrenceOf (":", false, false).trim());
+                    const String previousValue (response.headers [name]);
+                    response.headers.set (name, previousValue.isEmpty() ? value : (previousValue + "," + value));
+                }
+
+                if (response.result.failed() || response.statusCode >= 200 || response.statusCode == 101)
+                    break;
+
+                response.headers.clear();
+            }
+
+            if (response.result.failed())
+            {
+                // (the request may already have been acted on, so it's only sent again if that's harmless
+                // and the server closed the connection without replying, as RFC 7230, 6.3.1 requires)
+                const bool shouldRetry = isReusedConnection && attempt == 0 && canBeResent
+                                           && c->wasClosedBeforeResponse();
+                response.statusCode = 0;
+                releaseConnection (c, false);
+
+                if (shouldRetry)
+                    continue;
+
+                break;
+            }
+
+            // read the body..
+            const String location (response.headers ["Location"]);
+            isRedirecting = isRedirect (response.statusCode) && location.isNotEmpty() && numRedirects < request.maxRedirects;
+
+            if (! isRedirecting && listener != nullptr)
+                listener->responseHeadersReceived (requestId, response.statusCode, response.headers);
+
+            const String connectionHeader (response.headers ["Connection"]);
+            canBeReused = httpVersion.equalsIgnoreCase ("HTTP/1.1") ? ! connectionHeader.containsIgnoreCase ("close")
+                                                                    : connectionHeader.containsIgnoreCase ("keep-alive");
+
+            HTTPResponseBodyHandler handler (isRedirecting ? nullptr : listener, requestId,
+                                             (request.keepResponseBody && ! isRedirecting) ? &response.body : nullptr);
+
+            bool bodyOk = true;
+
+            if (response.statusCode == 101)
+            {
+                // (the connection has been switched to a different protocol)
+                canBeReused = false;
+            }
+            else if (isHead || response.statusCode == 204 || response.statusCode == 304)
+            {
+                // (these responses never have a body)
+            }
+            else if (response.headers ["Transfer-Encoding"].containsIgnoreCase ("chunked"))
+            {
+                for (;;)
+                {
+                    String line;
+                    bodyOk = c->readLine (line, request.timeOutMs, job, response.result);
+
+                    if (! bodyOk)
+                        break;
+
+                    const int64 chunkSize = line.upToFirstOccurrenceOf (";", false, false).trim().getHexValue64();
+
+                    if (chunkSize <= 0)
+                    {
+                        // skip any trailer fields
+                        while ((bodyOk = c->readLine (line, request.timeOutMs, job, response.result)) && line.isNotEmpty())
+                        {}
+
+                        break;
+                    }
+
+                    bodyOk = c->readBody (chunkSize, handler, request.timeOutMs, job, response.result)
+                              && c->readLine (line, request.timeOutMs, job, response.result);
+
+                    if (! bodyOk)
+                        break;
+                }
+            }
+            else if (hasHeader (response.headers, "Content-Length"))
+            {
+                bodyOk = c->readBody (response.headers ["Content-Length"].getLargeIntValue(), handler,
+                                      request.timeOutMs, job, response.result);
+            }
+            else
+            {
+                canBeReused = false;
+                bodyOk = c->readBody (-1, handler, request.timeOutMs, job, response.result);
+
+                if (bodyOk)
+                    response.result = Result::ok();
+            }
+
+            if (! bodyOk)
+            {
+                canBeReused = false;
+
+                if (response.result.wasOk())
+                    response.result = Result::fail ("Connection failed");
+            }
+
+            if (handler.body != nullptr)
+                response.body.setSize (handler.bodySize);
+
+            releaseConnection (c, canBeReused);
+            break;
+        }
+
+        if (! (isRedirecting && response.result.wasOk()))
+            break;
+
+        ++numRedirects;
+        address = resolveRedirect (response.headers ["Location"], host, port);
+
+        if (response.statusCode == 303 || ((response.statusCode == 301 || response.statusCode == 302)
+                                              && request.method.equalsIgnoreCase ("POST")))
+        {
+            request.method = "GET";
+            request.body.setSize (0);
+        }
+    }
+
+    response.wasCancelled = (job != nullptr && job->isCancelled());
+
+    if (response.wasCancelled)
+        response.result = Result::fail ("Cancelled");
+
+    return response;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class HTTPClientTests  : public UnitTest
+{
+public:
+    HTTPClientTests() : UnitTest ("HTTPClient") {}
+
+    //==============================================================================
+    // A minimal local server, which answers each request according to its path
+    class TestServer  : public Thread
+    {
+    public:
+        TestServer() : Thread ("HTTP test server"), port (0)
+        {
+            for (int p = 38100; p < 38200 && port == 0; ++p)
+                if (listener.createListener (p, "127.0.0.1"))
+                    port = p;
+
+            startThread();
+        }
+
+        ~TestServer()
+        {
+            stopThread (5000);
+        }
+
+        void run()
+        {
+            OwnedArray<ConnectionHandler> handlers;
+
+            while (! threadShouldExit())
+            {
+                if (listener.waitUntilReady (true, 50) == 1)
+                {
+                    if (StreamingSocket* const s = listener.waitForNextConnection())
+                    {
+                        ++numConnections;
+                        handlers.add (new ConnectionHandler (*this, s));
+                    }
+                }
+            }
+        }
+
+        URL getURL (const String& path) const      { return URL ("http://127.0.0.1:" + String (port) + path); }
+
+        int port;
+        Atomic<int> numConnections, numVanished;
+
+    private:
+        struct ConnectionHandler  : public Thread
+        {
+            ConnectionHandler (TestServer& o, StreamingSocket* const s)
+                : Thread ("HTTP test connection"), owner (o), socket (s)
+            {
+                startThread();
+            }
+
+            ~ConnectionHandler()
+            {
+                stopThread (5000);
+            }
+
+            bool readMore()
+            {
+                while (! threadShouldExit())
+                {
+                    const int ready = socket->waitUntilReady (true, 50);
+
+                    if (ready < 0)
+                        return false;
+
+                    if (ready > 0)
+                    {
+                        char buffer [4096];
+                        const int numRead = socket->read (buffer, sizeof (buffer), false);
+
+                        if (numRead <= 0)
+                            return false;
+
+                        received += String (buffer, (size_t) numRead);
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            void send (const String& s)
+            {
+                socket->write (s.toRawUTF8(), (int) s.getNumBytesAsUTF8());
+            }
+
+            void run()
+            {
+                handleRequests();
+                socket->close();
+            }
+
+            void handleRequests()
+            {
+                for (;;)
+                {
+                    while (! received.contains ("\r\n\r\n"))
+                        if (! readMore())
+                            return;
+
+                    const String header (received.upToFirstOccurrenceOf ("\r\n\r\n", false, false));
+                    received = received.fromFirstOccurrenceOf ("\r\n\r\n", false, false);
+
+                    const String path (header.fromFirstOccurrenceOf (" ", false, false).upToFirstOccurrenceOf (" ", false, false));
+                    const int contentLength = header.fromFirstOccurrenceOf ("Content-Length:", false, true)
+                                                    .upToFirstOccurrenceOf ("\r\n", false, false).trim().getIntValue();
+
+                    while (received.length() < contentLength)
+                        if (! readMore())
+                            return;
+
+                    const String body (received.substring (0, contentLength));
+                    received = received.substring (contentLength);
+
+                    if (path == "/hello" || path == "/drop")
+                    {
+                        send ("HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello");
+
+                        if (path == "/drop")
+                            return;
+                    }
+                    else if (path == "/chunked")
+                    {
+                        send ("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n7;x=y\r\n, world\r\n0\r\n\r\n");
+                    }
+                    else if (path == "/echo")
+                    {
+                        send ("HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 200 OK\r\nContent-Length: " + String (body.length()) + "\r\n\r\n" + body);
+                    }
+                    else if (path == "/redirect")
+                    {
+                        send ("HTTP/1.1 302 Found\r\nLocation: /hello\r\nContent-Length: 0\r\n\r\n");
+                    }
+                    else if (path == "/vanish")
+                    {
+                        // (closes the connection without replying)
+                        ++owner.numVanished;
+                        return;
+                    }
+                    else if (path == "/close")
+                    {
+                        send ("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nbye");
+                        return;
+                    }
+                    else if (path == "/big")
+                    {
+                        String s;
+                        s.preallocateBytes (100000);
+
+                        for (int i = 0; i < 100000; ++i)
+                            s << (char) ('a' + i % 26);
+
+                        send ("HTTP/1.1 200 OK\r\nContent-Length: 1000000\r\n\r\n");
+
+                        for (int i = 0; i < 10; ++i)
+                            send (s);
+                    }
+                    else if (path == "/slow")
+                    {
+                        for (int i = 0; i < 100 && ! threadShouldExit(); ++i)
+                            Thread::sleep (20);
+
+                        send ("HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\nslow");
+                    }
+                    else
+                    {
+                        send ("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+                    }
+                }
+            }
+
+            TestServer& owner;
+            ScopedPointer<StreamingSocket> socket;
+            String received;
+        };
+
+        StreamingSocket listener;
+    };
+
+    //==============================================================================
+    struct TestListener  : public HTTPClient::Listener
+    {
+        TestListener (const int numExpected)
+            : numRemaining (numExpected), numSucceeded (0), numCancelled (0), numBytesReceived (0)
+        {
+        }
+
+        bool responseDataReceived (int, const void*, size_t numBytes)
+        {
+            numBytesReceived += (int) numBytes;
+            return true;
+        }
+
+        void requestFinished (int, const HTTPClient::Response& response)
+        {
+            if (response.result.wasOk() && response.statusCode == 200)
+                ++numSucceeded;
+
+            if (response.wasCancelled)
+                ++numCancelled;
+
+            if (--numRemaining == 0)
+                finished.signal();
+        }
+
+        Atomic<int> numRemaining, numSucceeded, numCancelled, numBytesReceived;
+        WaitableEvent finished;
+    };
+
+    static String getBody (const HTTPClient::Response& response)
+    {
+        return response.body.toString();
+    }
+
+    void runTest()
+    {
+        TestServer server;
+
+        if (server.port == 0)
+        {
+            logMessage ("Couldn't create a local server, so skipping the HTTPClient tests");
+            return;
+        }
+
+        beginTest ("Keep-alive");
+
+        HTTPClient client (4, 2);
+
+        for (int i = 0; i < 5; ++i)
+        {
+            const HTTPClient::Response response (client.performRequest (HTTPClient::Request (server.getURL ("/hello"))));
+            expect (response.result.wasOk() && response.statusCode == 200 && getBody (response) == "hello");
+            expect (response.headers ["content-length"] == "5");
+        }
+
+        expectEquals (client.getNumConnectionsOpened(), 1);
+        expectEquals (server.numConnections.get(), 1);
+        expectEquals (client.getNumIdleConnections(), 1);
+
+        beginTest ("Response formats");
+
+        expect (getBody (client.performRequest (HTTPClient::Request (server.getURL ("/chunked")))) == "hello, world");
+        expect (client.performRequest (HTTPClient::Request (server.getURL ("/missing"))).statusCode == 404);
+
+        {
+            HTTPClient::Request request (server.getURL ("/echo"));
+            request.method = "POST";
+            request.body.append ("some data", 9);
+
+            const HTTPClient::Response response (client.performRequest (request));
+            expect (response.statusCode == 200 && getBody (response) == "some data");
+        }
+
+        {
+            const HTTPClient::Response response (client.performRequest (HTTPClient::Request (server.getURL ("/redirect"))));
+            expect (response.statusCode == 200 && getBody (response) == "hello");
+        }
+
+        {
+            const HTTPClient::Response response (client.performRequest (HTTPClient::Request (server.getURL ("/close"))));
+            expect (response.result.wasOk() && getBody (response) == "bye");
+        }
+
+        // the server closes this connection after replying, so the next request must notice and reconnect
+        expect (getBody (client.performRequest (HTTPClient::Request (server.getURL ("/drop")))) == "hello");
+        expect (getBody (client.performRequest (HTTPClient::Request (server.getURL ("/hello")))) == "hello");
+
+        expect (client.performRequest (HTTPClient::Request (URL ("https://127.0.0.1/"))).result.failed());
+
+        beginTest ("Resending on a closed keep-alive connection");
+
+        expect (getBody (client.performRequest (HTTPClient::Request (server.getURL ("/hello")))) == "hello");
+        expect (client.performRequest (HTTPClient::Request (server.getURL ("/vanish"))).result.failed());
+        expectEquals (server.numVanished.get(), 2);
+
+        {
+            expect (getBody (client.performRequest (HTTPClient::Request (server.getURL ("/hello")))) == "hello");
+
+            HTTPClient::Request request (server.getURL ("/vanish"));
+            request.method = "POST";
+            request.body.append ("once", 4);
+
+            expect (client.performRequest (request).result.failed());
+            expectEquals (server.numVanished.get(), 3);
+        }
+
+        beginTest ("Asynchronous requests");
+
+        {
+            const int numOpenedBefore = client.getNumConnectionsOpened();
+            const int numRequests = 40;
+            TestListener listener (numRequests);
+
+            for (int i = 0; i < numRequests; ++i)
+                client.sendRequest (HTTPClient::Request (server.getURL ("/hello")), &listener);
+
+            expect (listener.finished.wait (20000));
+            expectEquals (listener.numSucceeded.get(), numRequests);
+            expect (client.getNumConnectionsOpened() - numOpenedBefore <= 2);
+        }
+
+        beginTest ("Streaming");
+
+        {
+            TestListener listener (1);
+            HTTPClient::Request request (server.getURL ("/big"));
+            request.keepResponseBody = false;
+            client.sendRequest (request, &listener);
+
+            expect (listener.finished.wait (20000));
+            expectEquals (listener.numSucceeded.get(), 1);
+            expectEquals (listener.numBytesReceived.get(), 1000000);
+        }
+
+        beginTest ("Cancelling");
+
+        {
+            TestListener listener (1);
+            const uint32 startTime = Time::getMillisecondCounter();
+            const int requestId = client.sendRequest (HTTPClient::Request (server.getURL ("/slow")), &listener);
+
+            Thread::sleep (100);
+            expect (client.cancelRequest (requestId));
+            expect (listener.finished.wait (20000));
+            expectEquals (listener.numCancelled.get(), 1);
+            expect (Time::getMillisecondCounter() - startTime < 1500);
+        }
+    }
+};
+
+static HTTPClientTests httpClientTests;
+
+#endif
@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_HTTPCLIENT_JUCEHEADER__
+#define __JUCE_HTTPCLIENT_JUCEHEADER__
+
+#include "juce_URL.h"
+#include "../threads/juce_ThreadPool.h"
+#include "../threads/juce_WaitableEvent.h"
+#include "../containers/juce_HashMap.h"
+#include "../memory/juce_ScopedPointer.h"
+
+
+//==============================================================================
+/**
+    An HTTP/1.1 client which runs requests asynchronously on a thread pool, and keeps
+    connections open so that they can be re-used by later requests to the same server.
+
+    Unlike URL::createInputStream(), which opens a new connection for every request and
+    blocks the caller until it's done, this keeps a pool of keep-alive connections for
+    each host, runs several requests at the same time (up to a limit per host), and calls
+    a Listener on one of its own threads as the response arrives.
+
+    @code
+    HTTPClient client;
+
+    HTTPClient::Request request (URL ("http://localhost:8080/api/status"));
+    request.headers.set ("Accept", "application/json");
+
+    client.sendRequest (request, myListener);
+    @endcode
+
+    This talks to the server directly over a StreamingSocket, so it only handles
+    plain http:// URLs, and doesn't use any proxy settings.
+
+    @see URL, StreamingSocket
+*/
+class JUCE_API  HTTPClient
+{
+public:
+    //==============================================================================
+    /** Describes a request to send. */
+    struct JUCE_API  Request
+    {
+        /** Creates a GET request for a URL. */
+        explicit Request (const URL& url);
+
+        /** The address to send the request to, including any GET parameters. */
+        URL url;
+
+        /** The HTTP method, e.g. "GET", "POST", "PUT", "DELETE" or "HEAD". */
+        String method;
+
+        /** Any extra header fields to send. Host, Content-Length and User-Agent are added
+            automatically unless you set them here.
+        */
+        StringPairArray headers;
+
+        /** The body of the request, if there is one. */
+        MemoryBlock body;
+
+        /** The longest time to wait for the connection to open or for the server to send
+            more data, in milliseconds. If this is < 0, it will wait forever.
+        */
+        int timeOutMs;
+
+        /** The number of redirect responses that will be followed. */
+        int maxRedirects;
+
+        /** If false, the body of the response isn't kept in the Response object, so the
+            only way to see it is as it's passed to Listener::responseDataReceived().
+        */
+        bool keepResponseBody;
+    };
+
+    //==============================================================================
+    /** The outcome of a request. */
+    struct JUCE_API  Response
+    {
+        Response();
+
+        /** Fails if no complete response was received, e.g. because the connection
+            failed, the request timed-out or it was cancelled.
+        */
+        Result result;
+
+        /** The HTTP status code, or 0 if no response was received. */
+        int statusCode;
+
+        /** The response's header fields. Names are case-insensitive, and repeated fields
+            are combined into a comma-separated list.
+        */
+        StringPairArray headers;
+
+        /** The response body, unless Request::keepResponseBody was false. */
+        MemoryBlock body;
+
+        /** True if the request was cancelled with cancelRequest(). */
+        bool wasCancelled;
+    };
+
+    //==============================================================================
+    /**
+        Receives the results of requests sent with sendRequest().
+
+        All of these methods are called on one of the client's threads, so they must be
+        thread-safe, and should return quickly so that the thread can get on with other
+        requests.
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener()  {}
+
+        /** Called when the status line and header fields of the response have arrived,
+            before any of the body.
+        */
+        virtual void responseHeadersReceived (int /*requestId*/, int /*statusCode*/,
+                                              const StringPairArray& /*headers*/)        {}
+
+        /** Called with each block of the response body as it arrives.
+            If this returns false, the request is cancelled.
+        */
+        virtual bool responseDataReceived (int /*requestId*/, const void* /*data*/,
+                                           size_t /*numBytes*/)                          { return true; }
+
+        /** Called when a request has finished, whether or not it was successful. */
+        virtual void requestFinished (int requestId, const Response& response) = 0;
+    };
+
+    //==============================================================================
+    /** Creates a client.
+
+        @param numThreads               the number of threads that will run requests
+        @param maxConnectionsPerHost    the largest number of connections that will be open
+                                        to any one host:port at the same time. Requests
+                                        beyond this wait for a connection to become free.
+    */
+    HTTPClient (int numThreads = 4, int maxConnectionsPerHost = 6);
+
+    /** Destructor.
+        Any requests that are still running are cancelled. Requests that haven't started
+        yet are abandoned without their listener being called.
+    */
+    ~HTTPClient();
+
+    //==============================================================================
+    /** Queues a request to be run on one of the client's threads.
+
+        The listener can be null if you don't need to know the result; otherwise it must
+        stay valid until its requestFinished() method has been called.
+
+        @returns an ID which is passed to the listener's callbacks, and which can be
+                 used to cancel the request
+    */
+    int sendRequest (const Request& request, Listener* listener);
+
+    /** Cancels a request that was started with sendRequest().
+        Its listener will still be told that it has finished, with a Response for which
+        wasCancelled is true. Returns false if the request has already finished.
+    */
+    bool cancelRequest (int requestId);
+
+    /** Cancels all the requests that are waiting or running. */
+    void cancelAllRequests();
+
+    /** Runs a request on the calling thread, using the client's pool of connections, and
+        returns when the response is complete.
+    */
+    Response performRequest (const Request& request);
+
+    //==============================================================================
+    /** Sets how long an unused connection is kept open, in milliseconds. The default is
+        30 seconds.
+    */
+    void setKeepAliveTimeout (int milliseconds) noexcept;
+
+    /** Closes any connections that aren't currently in use. */
+    void closeIdleConnections();
+
+    /** Returns the number of connections that are open but not in use. */
+    int getNumIdleConnections() const;
+
+    /** Returns the total number of connections that have been opened since the client
+        was created. Comparing this with the number of requests shows how well the
+        connections are being re-used.
+    */
+    int getNumConnectionsOpened() const noexcept;
+
+private:
+    //==============================================================================
+    class Connection;
+    class RequestJob;
+    friend class RequestJob;
+
+    CriticalSection lock;
+    OwnedArray<Connection> idleConnections;
+    HashMap<String, int> numActiveConnections;
+    WaitableEvent connectionReleased;
+    const int maxConnectionsPerHost;
+    int keepAliveTimeoutMs;
+    Atomic<int> numConnectionsOpened, nextRequestId;
+    Array<RequestJob*> requestJobs;
+    ThreadPool threadPool;
+
+    Response runRequest (const Request&, Listener*, int requestId, RequestJob*);
+    Connection* getConnection (const String& host, int port, const Request&, RequestJob*, Result&);
+    void releaseConnection (Connection*, bool canBeReused);
+    void removeJob (RequestJob*);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HTTPClient)
+};
+
+
+#endif   // __JUCE_HTTPCLIENT_JUCEHEADER__
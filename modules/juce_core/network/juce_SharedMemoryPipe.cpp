@@ -0,0 +1,823 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace SharedMemoryPipeHelpers
+{
+    enum { magicNumber = 0x6a73686d, minBufferSize = 4096, maxBufferSize = 1 << 30 };
+    enum { notConnected = 0, connected = 1, closed = 2 };
+
+    // Each value gets a cache line of its own, so that the two processes don't contend for
+    // them, and so that 32 and 64-bit processes agree about the layout.
+    struct SharedValue
+    {
+        Atomic<int> value;
+        char padding [64 - sizeof (Atomic<int>)];
+    };
+
+    // One of these for each direction. The positions are free-running counters, and only
+    // the bottom bits are used to index the buffer.
+    struct Ring
+    {
+        SharedValue writePosition, readPosition;
+        SharedValue dataSignal, spaceSignal, readerWaiting, writerWaiting;
+    };
+
+    // The block of shared memory starts with this, and is followed by the buffers for the two rings.
+    struct Header
+    {
+        SharedValue magic, bufferSize, creatorState, clientState, creatorProcessId, clientProcessId;
+        Ring rings[2];
+    };
+
+    static int getCurrentProcessId() noexcept
+    {
+       #if JUCE_WINDOWS
+        return (int) GetCurrentProcessId();
+       #else
+        return (int) getpid();
+       #endif
+    }
+
+    static bool isProcessRunning (const int processId) noexcept
+    {
+       #if JUCE_WINDOWS
+        HANDLE h = OpenProcess (SYNCHRONIZE, FALSE, (DWORD) processId);
+
+        if (h == 0)
+            return GetLastError() == ERROR_ACCESS_DENIED;
+
+        const bool isRunning = WaitForSingleObject (h, 0) == WAIT_TIMEOUT;
+        CloseHandle (h);
+        return isRunning;
+       #else
+        return kill ((pid_t) processId, 0) == 0 || errno != ESRCH;
+       #endif
+    }
+
+   #if ! JUCE_WINDOWS
+    static String getSharedMemoryFilePath (const String& name)
+    {
+        const String fileName (File::createLegalFileName (name) + "_shm");
+
+       #if JUCE_IOS
+        return File::getSpecialLocation (File::tempDirectory).getChildFile (fileName).getFullPathName();
+       #else
+        // (on Linux, /dev/shm is a RAM-based filesystem, so nothing ever gets written to disk)
+        const File shmFolder ("/dev/shm");
+        return (shmFolder.isDirectory() ? shmFolder : File ("/tmp")).getChildFile (fileName).getFullPathName();
+       #endif
+    }
+   #endif
+
+    static uint32 getTimeoutEnd (const int timeOutMilliseconds) noexcept
+    {
+        return timeOutMilliseconds >= 0 ? Time::getMillisecondCounter() + (uint32) timeOutMilliseconds : 0;
+    }
+}
+
+//==============================================================================
+class SharedMemoryPipe::Pimpl
+{
+public:
+    Pimpl (const bool isCreator_)
+        : bufferSize (0), header (nullptr), isCreator (isCreator_), isAttached (false),
+         #if JUCE_WINDOWS
+          mappingHandle (0),
+         #else
+          fileHandle (-1),
+         #endif
+          mappedSize (0)
+    {
+        buffers[0] = buffers[1] = nullptr;
+
+       #if JUCE_WINDOWS
+        for (int i = 0; i < numElementsInArray (events); ++i)
+            events[i] = 0;
+       #endif
+    }
+
+    ~Pimpl()
+    {
+        using namespace SharedMemoryPipeHelpers;
+
+        if (isAttached)
+        {
+            (isCreator ? header->creatorState : header->clientState).value = closed;
+            wakeAll();
+        }
+
+       #if JUCE_WINDOWS
+        if (header != nullptr)
+            UnmapViewOfFile (header);
+
+        if (mappingHandle != 0)
+            CloseHandle (mappingHandle);
+
+        for (int i = 0; i < numElementsInArray (events); ++i)
+            if (events[i] != 0)
+                CloseHandle (events[i]);
+       #else
+        if (header != nullptr)
+            munmap (header, mappedSize);
+
+        if (fileHandle >= 0)
+            ::close (fileHandle);
+
+        if (isCreator && filePath.isNotEmpty())
+            unlink (filePath.toUTF8());
+       #endif
+    }
+
+    //==============================================================================
+    bool create (const String& name, int requestedBufferSize)
+    {
+        using namespace SharedMemoryPipeHelpers;
+
+        bufferSize = (int) nextPowerOfTwo (jlimit ((int) minBufferSize, (int) maxBufferSize, requestedBufferSize));
+        mappedSize = sizeof (Header) + 2 * (size_t) bufferSize;
+
+       #if JUCE_WINDOWS
+        const uint64 size = (uint64) mappedSize;
+        mappingHandle = CreateFileMapping (INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, (DWORD) (size >> 32), (DWORD) size,
+                                           getObjectName (name, "mem").toWideCharPointer());
+
+        // (if the name is already in use, another process must be holding onto it)
+        if (mappingHandle == 0 || GetLastError() == ERROR_ALREADY_EXISTS)
+            return false;
+
+        header = static_cast <Header*> (MapViewOfFile (mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+       #else
+        filePath = getSharedMemoryFilePath (name);
+        fileHandle = ::open (filePath.toUTF8(), O_RDWR | O_CREAT | O_EXCL, 0666);
+
+        if (fileHandle < 0 && errno == EEXIST)
+        {
+            // a file that's left over from a process that has died can be replaced..
+            if (isAbandoned (filePath))
+            {
+                unlink (filePath.toUTF8());
+                fileHandle = ::open (filePath.toUTF8(), O_RDWR | O_CREAT | O_EXCL, 0666);
+            }
+        }
+
+        if (fileHandle < 0)
+        {
+            filePath = String::empty;
+            return false;
+        }
+
+        if (ftruncate (fileHandle, (off_t) mappedSize) != 0)
+            return false;
+
+        void* const mapped = mmap (0, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileHandle, 0);
+        header = mapped != MAP_FAILED ? static_cast <Header*> (mapped) : nullptr;
+       #endif
+
+        if (header == nullptr || ! openEvents (name))
+            return false;
+
+        // (the new memory will be full of zeros, so only the non-zero values need setting,
+        // and the magic number goes in last so that a client never sees a half-initialised header)
+        header->bufferSize.value = bufferSize;
+        header->creatorProcessId.value = getCurrentProcessId();
+        header->creatorState.value = connected;
+        Atomic<int>::memoryBarrier();
+        header->magic.value = magicNumber;
+
+        isAttached = true;
+        setBufferPointers();
+        return true;
+    }
+
+    bool open (const String& name)
+    {
+        using namespace SharedMemoryPipeHelpers;
+
+       #if JUCE_WINDOWS
+        mappingHandle = OpenFileMapping (FILE_MAP_ALL_ACCESS, FALSE, getObjectName (name, "mem").toWideCharPointer());
+
+        if (mappingHandle == 0)
+            return false;
+
+        header = static_cast <Header*> (MapViewOfFile (mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+
+        MEMORY_BASIC_INFORMATION info;
+
+        if (header == nullptr || VirtualQuery (header, &info, sizeof (info)) == 0)
+            return false;
+
+        mappedSize = (size_t) info.RegionSize;
+       #else
+        fileHandle = ::open (getSharedMemoryFilePath (name).toUTF8(), O_RDWR);
+
+        if (fileHandle < 0)
+            return false;
+
+        struct stat info;
+
+        if (fstat (fileHandle, &info) != 0 || (size_t) info.st_size < sizeof (Header))
+            return false;
+
+        mappedSize = (size_t) info.st_size;
+
+        void* const mapped = mmap (0, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileHandle, 0);
+        header = mapped != MAP_FAILED ? static_cast <Header*> (mapped) : nullptr;
+       #endif
+
+        if (header == nullptr || header->magic.value.get() != magicNumber)
+            return false;
+
+        bufferSize = header->bufferSize.value.get();
+
+        if (bufferSize < minBufferSize || ! isPowerOfTwo (bufferSize)
+             || mappedSize < sizeof (Header) + 2 * (size_t) bufferSize
+             || header->creatorState.value.get() != connected
+             || ! header->clientState.value.compareAndSetBool (connected, notConnected))
+            return false;
+
+        isAttached = true;
+        header->clientProcessId.value = getCurrentProcessId();
+
+        if (! openEvents (name))
+            return false;
+
+        setBufferPointers();
+        return true;
+    }
+
+    bool isOpen() const noexcept
+    {
+        return ! hasOtherEndClosed();
+    }
+
+    //==============================================================================
+    int read (char* destBuffer, const int maxBytesToRead, const int timeOutMilliseconds)
+    {
+        using namespace SharedMemoryPipeHelpers;
+
+        const int ringIndex = isCreator ? 1 : 0;
+        Ring& ring = header->rings [ringIndex];
+        const char* const buffer = buffers [ringIndex];
+        const uint32 timeoutEnd = getTimeoutEnd (timeOutMilliseconds);
+        int bytesRead = 0;
+
+        while (bytesRead < maxBytesToRead)
+        {
+            const int readPosition = ring.readPosition.value.value;
+            const int numReady = ring.writePosition.value.get() - readPosition;
+
+            if (numReady == 0)
+            {
+                if (! waitFor (ringIndex, true, timeoutEnd))
+                    return (bytesRead > 0 || ! hasStopped()) ? bytesRead : -1;
+
+                continue;
+            }
+
+            const int num = jmin (numReady, maxBytesToRead - bytesRead);
+            const int index = readPosition & (bufferSize - 1);
+            const int num1 = jmin (num, bufferSize - index);
+
+            memcpy (destBuffer + bytesRead, buffer + index, (size_t) num1);
+            memcpy (destBuffer + bytesRead + num1, buffer, (size_t) (num - num1));
+
+            Atomic<int>::memoryBarrier();
+            ring.readPosition.value = readPosition + num;
+            bytesRead += num;
+
+            if (ring.writerWaiting.value.get() != 0)
+                wake (ringIndex * 2 + 1);
+        }
+
+        return bytesRead;
+    }
+
+    int write (const void* const* sourceBuffers, const int* bufferSizes, const int numBuffers, const int timeOutMilliseconds)
+    {
+        using namespace SharedMemoryPipeHelpers;
+
+        const int ringIndex = isCreator ? 0 : 1;
+        Ring& ring = header->rings [ringIndex];
+        char* const buffer = buffers [ringIndex];
+        const uint32 timeoutEnd = getTimeoutEnd (timeOutMilliseconds);
+
+        int numBytesToWrite = 0;
+        for (int i = 0; i < numBuffers; ++i)
+            numBytesToWrite += bufferSizes[i];
+
+        int bytesWritten = 0, sourceIndex = 0, sourceOffset = 0;
+
+        while (bytesWritten < numBytesToWrite)
+        {
+            if (hasStopped())
+                return -1;
+
+            const int writePosition = ring.writePosition.value.value;
+            const int freeSpace = bufferSize - (writePosition - ring.readPosition.value.get());
+
+            if (freeSpace == 0)
+            {
+                if (! waitFor (ringIndex, false, timeoutEnd))
+                    return bytesWritten > 0 ? bytesWritten : -1;
+
+                continue;
+            }
+
+            const int num = jmin (freeSpace, numBytesToWrite - bytesWritten);
+
+            for (int done = 0; done < num;)
+            {
+                const int numFromSource = jmin (num - done, bufferSizes [sourceIndex] - sourceOffset);
+                const int index = (writePosition + done) & (bufferSize - 1);
+                const int num1 = jmin (numFromSource, bufferSize - index);
+                const char* const source = static_cast <const char*> (sourceBuffers [sourceIndex]) + sourceOffset;
+
+                memcpy (buffer + index, source, (size_t) num1);
+                memcpy (buffer, source + num1, (size_t) (numFromSource - num1));
+
+                done += numFromSource;
+                sourceOffset += numFromSource;
+
+                if (sourceOffset >= bufferSizes [sourceIndex])
+                {
+                    ++sourceIndex;
+                    sourceOffset = 0;
+                }
+            }
+
+            Atomic<int>::memoryBarrier();
+            ring.writePosition.value = writePosition + num;
+            bytesWritten += num;
+
+            if (ring.readerWaiting.value.get() != 0)
+                wake (ringIndex * 2);
+        }
+
+        return bytesWritten;
+    }
+
+    void stop()
+    {
+        stopRequested = 1;
+        wakeAll();
+    }
+
+    int bufferSize;
+
+private:
+    SharedMemoryPipeHelpers::Header* header;
+    const bool isCreator;
+    bool isAttached;
+    char* buffers[2];
+    Atomic<int> stopRequested;
+
+   #if JUCE_WINDOWS
+    HANDLE mappingHandle;
+    HANDLE events[4];
+   #else
+    String filePath;
+    int fileHandle;
+   #endif
+    size_t mappedSize;
+
+    //==============================================================================
+    void setBufferPointers() noexcept
+    {
+        buffers[0] = reinterpret_cast <char*> (header + 1);
+        buffers[1] = buffers[0] + bufferSize;
+    }
+
+    bool hasStopped() const noexcept
+    {
+        return stopRequested.get() != 0 || hasOtherEndClosed();
+    }
+
+    bool hasOtherEndClosed() const noexcept
+    {
+        return (isCreator ? header->clientState : header->creatorState).value.get() == SharedMemoryPipeHelpers::closed;
+    }
+
+    bool isReady (const int ringIndex, const bool forReading) const noexcept
+    {
+        const SharedMemoryPipeHelpers::Ring& ring = header->rings [ringIndex];
+        const int numReady = ring.writePosition.value.get() - ring.readPosition.value.get();
+
+        return forReading ? numReady > 0 : numReady < bufferSize;
+    }
+
+    // Blocks until the ring has some data or space, returning false if the timeout expires or the pipe closes.
+    bool waitFor (const int ringIndex, const bool forReading, const uint32 timeoutEnd)
+    {
+        using namespace SharedMemoryPipeHelpers;
+
+        Ring& ring = header->rings [ringIndex];
+        Atomic<int>& waitingFlag = (forReading ? ring.readerWaiting : ring.writerWaiting).value;
+        const int signalIndex = ringIndex * 2 + (forReading ? 0 : 1);
+        const int signalValue = getSignal (signalIndex).get();
+
+        // (the flag is set before checking again, so that the other end can't miss the fact that we're waiting)
+        waitingFlag = 1;
+        bool isStillOk = true;
+
+        if (! isReady (ringIndex, forReading))
+        {
+            int timeToWait = 500;
+
+            if (timeoutEnd != 0)
+                timeToWait = jmin (timeToWait, (int) (timeoutEnd - Time::getMillisecondCounter()));
+
+            if (hasStopped() || timeToWait <= 0)
+            {
+                isStillOk = false;
+            }
+            else
+            {
+                waitForSignal (signalIndex, signalValue, timeToWait);
+
+                if (! isReady (ringIndex, forReading))
+                    checkOtherProcessIsRunning();
+            }
+        }
+
+        waitingFlag = 0;
+        return isStillOk;
+    }
+
+    void checkOtherProcessIsRunning()
+    {
+        using namespace SharedMemoryPipeHelpers;
+
+        SharedValue& otherState     = isCreator ? header->clientState : header->creatorState;
+        SharedValue& otherProcessId = isCreator ? header->clientProcessId : header->creatorProcessId;
+        const int processId = otherProcessId.value.get();
+
+        if (otherState.value.get() == connected && processId != 0 && ! isProcessRunning (processId))
+            otherState.value = closed;
+    }
+
+   #if ! JUCE_WINDOWS
+    static bool isAbandoned (const String& path)
+    {
+        using namespace SharedMemoryPipeHelpers;
+
+        bool abandoned = true;
+        const int fd = ::open (path.toUTF8(), O_RDWR);
+
+        if (fd >= 0)
+        {
+            struct stat info;
+
+            if (fstat (fd, &info) == 0 && (size_t) info.st_size >= sizeof (Header))
+            {
+                void* const mapped = mmap (0, sizeof (Header), PROT_READ, MAP_SHARED, fd, 0);
+
+                if (mapped != MAP_FAILED)
+                {
+                    const Header* const h = static_cast <const Header*> (mapped);
+
+                    abandoned = h->creatorState.value.value != connected
+                                 || ! isProcessRunning (h->creatorProcessId.value.value);
+
+                    munmap (mapped, sizeof (Header));
+                }
+            }
+
+            ::close (fd);
+        }
+
+        return abandoned;
+    }
+   #endif
+
+    //==============================================================================
+    Atomic<int>& getSignal (const int signalIndex) const noexcept
+    {
+        SharedMemoryPipeHelpers::Ring& ring = header->rings [signalIndex / 2];
+        return ((signalIndex & 1) == 0 ? ring.dataSignal : ring.spaceSignal).value;
+    }
+
+    void wakeAll()
+    {
+        for (int i = 0; i < 4; ++i)
+            wake (i);
+    }
+
+   #if JUCE_WINDOWS
+    static String getObjectName (const String& name, const char* const suffix)
+    {
+        return "Local\\juce_shm_" + File::createLegalFileName (name) + "_" + suffix;
+    }
+
+    bool openEvents (const String& name)
+    {
+        for (int i = 0; i < numElementsInArray (events); ++i)
+        {
+            // (auto-reset events, which are created by whichever end gets there first)
+            events[i] = CreateEvent (0, FALSE, FALSE, getObjectName (name, String (i).toRawUTF8()).toWideCharPointer());
+
+            if (events[i] == 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    void waitForSignal (const int signalIndex, int, const int timeoutMs)
+    {
+        WaitForSingleObject (events [signalIndex], (DWORD) timeoutMs);
+    }
+
+    void wake (const int signalIndex)
+    {
+        ++getSignal (signalIndex);
+        SetEvent (events [signalIndex]);
+    }
+
+   #elif JUCE_LINUX || JUCE_ANDROID
+    bool openEvents (const String&) noexcept    { return true; }
+
+    void waitForSignal (const int signalIndex, const int expectedValue, const int timeoutMs)
+    {
+        struct timespec timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = (timeoutMs % 1000) * 1000000;
+
+        // (this returns immediately if the signal has changed since expectedValue was read)
+        syscall (SYS_futex, (int*) &(getSignal (signalIndex).value), FUTEX_WAIT, expectedValue, &timeout, 0, 0);
+    }
+
+    void wake (const int signalIndex)
+    {
+        Atomic<int>& signal = getSignal (signalIndex);
+        ++signal;
+        syscall (SYS_futex, (int*) &(signal.value), FUTEX_WAKE, INT_MAX, 0, 0, 0);
+    }
+
+   #else
+    bool openEvents (const String&) noexcept    { return true; }
+
+    void waitForSignal (const int signalIndex, const int expectedValue, const int timeoutMs)
+    {
+        const uint32 timeoutEnd = Time::getMillisecondCounter() + (uint32) timeoutMs;
+
+        while (getSignal (signalIndex).get() == expectedValue
+                && stopRequested.get() == 0
+                && Time::getMillisecondCounter() < timeoutEnd)
+            Thread::sleep (1);
+    }
+
+    void wake (const int signalIndex)
+    {
+        ++getSignal (signalIndex);
+    }
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Pimpl)
+};
+
+//==============================================================================
+SharedMemoryPipe::SharedMemoryPipe()
+{
+}
+
+SharedMemoryPipe::~SharedMemoryPipe()
+{
+    close();
+}
+
+bool SharedMemoryPipe::createNew (const String& name, const int bufferSizeBytes)
+{
+    close();
+
+    ScopedWriteLock sl (lock);
+    currentName = name;
+    pimpl = new Pimpl (true);
+
+    if (! pimpl->create (name, bufferSizeBytes))
+        pimpl = nullptr;
+
+    return pimpl != nullptr;
+}
+
+bool SharedMemoryPipe::openExisting (const String& name)
+{
+    close();
+
+    ScopedWriteLock sl (lock);
+    currentName = name;
+    pimpl = new Pimpl (false);
+
+    if (! pimpl->open (name))
+        pimpl = nullptr;
+
+    return pimpl != nullptr;
+}
+
+void SharedMemoryPipe::close()
+{
+    {
+        ScopedReadLock sl (lock);
+
+        if (pimpl != nullptr)
+            pimpl->stop();
+    }
+
+    ScopedWriteLock sl (lock);
+    pimpl = nullptr;
+}
+
+bool SharedMemoryPipe::isOpen() const
+{
+    ScopedReadLock sl (lock);
+    return pimpl != nullptr && pimpl->isOpen();
+}
+
+String SharedMemoryPipe::getName() const
+{
+    return currentName;
+}
+
+int SharedMemoryPipe::getBufferSize() const
+{
+    ScopedReadLock sl (lock);
+    return pimpl != nullptr ? pimpl->bufferSize : 0;
+}
+
+int SharedMemoryPipe::read (void* destBuffer, int maxBytesToRead, int timeOutMilliseconds)
+{
+    ScopedReadLock sl (lock);
+    return pimpl != nullptr ? pimpl->read (static_cast <char*> (destBuffer), maxBytesToRead, timeOutMilliseconds) : -1;
+}
+
+int SharedMemoryPipe::write (const void* sourceBuffer, int numBytesToWrite, int timeOutMilliseconds)
+{
+    return write (&sourceBuffer, &numBytesToWrite, 1, timeOutMilliseconds);
+}
+
+int SharedMemoryPipe::write (const void* const* sourceBuffers, const int* bufferSizes, int numBuffers, int timeOutMilliseconds)
+{
+    ScopedReadLock sl (lock);
+    return pimpl != nullptr ? pimpl->write (sourceBuffers, bufferSizes, numBuffers, timeOutMilliseconds) : -1;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SharedMemoryPipeTests  : public UnitTest
+{
+public:
+    SharedMemoryPipeTests() : UnitTest ("SharedMemoryPipe") {}
+
+    class WriterThread  : public Thread
+    {
+    public:
+        WriterThread (SharedMemoryPipe& pipe_, const MemoryBlock& data_)
+            : Thread ("pipe writer"), pipe (pipe_), data (data_), succeeded (false)
+        {
+            startThread();
+        }
+
+        ~WriterThread()
+        {
+            stopThread (5000);
+        }
+
+        void run()
+        {
+            Random r;
+            int pos = 0;
+
+            while (pos < (int) data.getSize() && ! threadShouldExit())
+            {
+                const int num = jmin ((int) data.getSize() - pos, r.nextInt (100000) + 1);
+
+                if (pipe.write (static_cast <const char*> (data.getData()) + pos, num, 5000) != num)
+                    return;
+
+                pos += num;
+            }
+
+            succeeded = true;
+        }
+
+        SharedMemoryPipe& pipe;
+        const MemoryBlock& data;
+        bool succeeded;
+    };
+
+    bool readAll (SharedMemoryPipe& pipe, const MemoryBlock& expected)
+    {
+        MemoryBlock received (expected.getSize());
+        Random r;
+        int pos = 0;
+
+        while (pos < (int) received.getSize())
+        {
+            const int num = jmin ((int) received.getSize() - pos, r.nextInt (70000) + 1);
+
+            if (pipe.read (static_cast <char*> (received.getData()) + pos, num, 5000) != num)
+                return false;
+
+            pos += num;
+        }
+
+        return received == expected;
+    }
+
+    void runTest()
+    {
+        const String name ("juce_test_" + String::toHexString (Random::getSystemRandom().nextInt()));
+
+        beginTest ("Connecting");
+
+        SharedMemoryPipe creator, client, secondClient;
+        expect (creator.createNew (name, 10000));
+        expect (creator.isOpen() && creator.getBufferSize() == 16384);
+        expect (! secondClient.createNew (name));
+        expect (client.openExisting (name));
+        expect (client.getBufferSize() == 16384);
+        expect (! secondClient.openExisting (name));
+
+        beginTest ("Sending data");
+
+        MemoryBlock data (3 * 1024 * 1024 + 17);
+        Random r;
+
+        for (size_t i = 0; i < data.getSize(); ++i)
+            data[i] = (char) r.nextInt();
+
+        {
+            WriterThread creatorWriter (creator, data), clientWriter (client, data);
+
+            expect (readAll (client, data));
+            expect (readAll (creator, data));
+
+            creatorWriter.stopThread (5000);
+            clientWriter.stopThread (5000);
+            expect (creatorWriter.succeeded && clientWriter.succeeded);
+        }
+
+        beginTest ("Gather writes");
+
+        {
+            const char* const strings[] = { "one", "", "two", "three" };
+            const void* const sources[] = { strings[0], strings[1], strings[2], strings[3] };
+            const int sizes[] = { 3, 0, 3, 5 };
+            char joined[11] = { 0 };
+
+            expect (creator.write (sources, sizes, 4, 0) == 11);
+            expect (client.read (joined, sizeof (joined), 0) == 11);
+            expect (String (joined, 11) == "onetwothree");
+        }
+
+        beginTest ("Timeouts");
+
+        char buffer[16] = { 0 };
+        expect (client.read (buffer, sizeof (buffer), 20) == 0);
+        expect (creator.write ("abc", 3, 0) == 3);
+        expect (client.read (buffer, sizeof (buffer), 20) == 3);
+        expect (String (buffer, 3) == "abc");
+
+        beginTest ("Closing");
+
+        client.close();
+        expect (! client.isOpen() && ! creator.isOpen());
+        expect (creator.read (buffer, sizeof (buffer), -1) == -1);
+        expect (creator.write (buffer, sizeof (buffer), -1) == -1);
+
+        creator.close();
+        expect (creator.createNew (name));
+        expect (client.openExisting (name));
+        expect (client.write ("abc", 3, -1) == 3);
+        creator.close();
+        expect (! client.isOpen());
+        expect (! secondClient.openExisting (name));
+    }
+};
+
+static SharedMemoryPipeTests sharedMemoryPipeTests;
+
+#endif
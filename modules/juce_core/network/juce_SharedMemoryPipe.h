@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SHAREDMEMORYPIPE_JUCEHEADER__
+#define __JUCE_SHAREDMEMORYPIPE_JUCEHEADER__
+
+#include "../threads/juce_ReadWriteLock.h"
+
+//==============================================================================
+/**
+    A two-way cross-process pipe that passes its data through a block of shared memory.
+
+    This works like a NamedPipe, but both processes map the same region of memory, and the
+    data is copied straight into and out of a pair of ring buffers inside it. Transferring
+    data doesn't involve the kernel at all unless one end has to wait for the other, so it
+    has much lower overhead and latency than a pipe or socket, especially for large blocks.
+
+    One process calls createNew() to set up the shared memory, and one other process can then
+    call openExisting() with the same name to connect to it. The pipe only works between
+    processes on the same machine.
+
+    On Linux and Android, a waiting reader or writer is woken with a futex, and on Windows
+    with a named event. On other platforms it'll poll, so there may be a millisecond or so
+    of extra latency when the reading end has been idle.
+
+    @see NamedPipe, InterprocessConnection
+*/
+class JUCE_API  SharedMemoryPipe
+{
+public:
+    //==============================================================================
+    /** Creates a SharedMemoryPipe. */
+    SharedMemoryPipe();
+
+    /** Destructor. */
+    ~SharedMemoryPipe();
+
+    //==============================================================================
+    /** Creates a new block of shared memory for another process to connect to.
+
+        @param name             the name that the other process will use to open it - this
+                                should be unique to your app
+        @param bufferSizeBytes  the capacity of the buffer in each direction. This will be rounded
+                                up to a power of two. Blocks of data that are bigger than this can
+                                still be sent, but the writer will have to wait for the reader to
+                                make space for them.
+        @returns true if it succeeds, or false if the memory couldn't be created, or if another
+                 process is already using this name.
+    */
+    bool createNew (const String& name, int bufferSizeBytes = 1024 * 1024);
+
+    /** Connects to a block of shared memory that another process has created with createNew().
+
+        Only one process can be connected to the creator at a time.
+
+        @returns true if it succeeds.
+    */
+    bool openExisting (const String& name);
+
+    /** Closes the pipe, if it's open.
+        Any reads or writes that are blocked in other threads will return, and the process at the
+        other end will find that the pipe has closed.
+    */
+    void close();
+
+    /** True if the pipe is open, and the process at the other end hasn't closed it. */
+    bool isOpen() const;
+
+    /** Returns the last name that was used to try to open this pipe. */
+    String getName() const;
+
+    /** Returns the size of the buffer that's used for each direction, or 0 if the pipe isn't open. */
+    int getBufferSize() const;
+
+    //==============================================================================
+    /** Reads data from the pipe.
+
+        This will block until the other process has written enough data to fill the number of
+        bytes specified, or until the timeout expires, or the pipe is closed.
+
+        If timeOutMilliseconds is less than zero, it will wait indefinitely, otherwise
+        this is a maximum timeout for reading from the pipe.
+
+        @returns the number of bytes read, which will be less than maxBytesToRead if the timeout
+                 expired first, or -1 if nothing could be read because the pipe has been closed.
+    */
+    int read (void* destBuffer, int maxBytesToRead, int timeOutMilliseconds);
+
+    /** Writes some data to the pipe.
+
+        If there's not enough free space in the buffer, this will wait for the other process
+        to read some data, or until the timeout expires.
+
+        @returns the number of bytes written, or -1 on failure.
+    */
+    int write (const void* sourceBuffer, int numBytesToWrite, int timeOutMilliseconds);
+
+    /** Writes the contents of several blocks of memory to the pipe, one after the other.
+
+        This does the same as writing each block in turn, but the other end won't be woken until
+        as much of the data as will fit has been written, so it's a good way to send a header and
+        its data together.
+
+        @returns the total number of bytes written, or -1 on failure.
+    */
+    int write (const void* const* sourceBuffers, const int* bufferSizes, int numBuffers, int timeOutMilliseconds);
+
+private:
+    //==============================================================================
+    JUCE_PUBLIC_IN_DLL_BUILD (class Pimpl)
+    ScopedPointer<Pimpl> pimpl;
+    String currentName;
+    ReadWriteLock lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedMemoryPipe)
+};
+
+
+#endif   // __JUCE_SHAREDMEMORYPIPE_JUCEHEADER__
@@ -65,6 +65,11 @@ namespace SocketHelpers
         const int rcvBufSize = 65536;
         const int one = 1;
 
+       #ifdef SO_NOSIGPIPE
+        if (handle > 0 && ! isDatagram)
+            setsockopt (handle, SOL_SOCKET, SO_NOSIGPIPE, (const char*) &one, sizeof (one));
+       #endif
+
         return handle > 0
                 && setsockopt (handle, SOL_SOCKET, SO_RCVBUF, (const char*) &rcvBufSize, sizeof (rcvBufSize)) == 0
                 && setsockopt (handle, SOL_SOCKET, SO_SNDBUF, (const char*) &sndBufSize, sizeof (sndBufSize)) == 0
@@ -86,6 +91,15 @@ namespace SocketHelpers
         return bind (handle, (struct sockaddr*) &servTmpAddr, sizeof (struct sockaddr_in)) >= 0;
     }
 
+    static bool lastErrorWasWouldBlock() noexcept
+    {
+       #if JUCE_WINDOWS
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+       #else
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+       #endif
+    }
+
     static int readSocket (const SocketHandle handle,
                            void* const destBuffer, const int maxBytesToRead,
                            bool volatile& connected,
@@ -107,6 +121,10 @@ namespace SocketHelpers
             }
            #endif
 
+            // a non-blocking socket that has no more data available yet
+            if (bytesThisTime < 0 && connected && lastErrorWasWouldBlock())
+                break;
+
             if (bytesThisTime <= 0 || ! connected)
             {
                 if (bytesRead == 0)
@@ -126,6 +144,7 @@ namespace SocketHelpers
 
     static int waitForReadiness (const SocketHandle handle, const bool forReading, const int timeoutMsecs) noexcept
     {
+       #if JUCE_WINDOWS
         struct timeval timeout;
         struct timeval* timeoutp;
 
@@ -149,13 +168,19 @@ namespace SocketHelpers
         fd_set* const prset = forReading ? &rset : nullptr;
         fd_set* const pwset = forReading ? nullptr : &wset;
 
-       #if JUCE_WINDOWS
         if (select ((int) handle + 1, prset, pwset, 0, timeoutp) < 0)
             return -1;
        #else
+        // (poll is used rather than select, because select can't cope with handles
+        // above FD_SETSIZE, which a busy server can easily reach)
+        struct pollfd pfd;
+        zerostruct (pfd);
+        pfd.fd = handle;
+        pfd.events = forReading ? POLLIN : POLLOUT;
+
         {
             int result;
-            while ((result = select (handle + 1, prset, pwset, 0, timeoutp)) < 0
+            while ((result = poll (&pfd, 1, timeoutMsecs >= 0 ? timeoutMsecs : -1)) < 0
                     && errno == EINTR)
             {
             }
@@ -174,7 +199,12 @@ namespace SocketHelpers
                 return -1;
         }
 
+       #if JUCE_WINDOWS
         return FD_ISSET (handle, forReading ? &rset : &wset) ? 1 : 0;
+       #else
+        return (pfd.revents & (forReading ? POLLIN : POLLOUT)) != 0
+                || (pfd.revents & (POLLHUP | POLLERR)) != 0 ? 1 : 0;
+       #endif
     }
 
     static bool setSocketBlockingState (const SocketHandle handle, const bool shouldBlock) noexcept
@@ -302,15 +332,81 @@ int StreamingSocket::write (const void* sourceBuffer, const int numBytesToWrite)
         return -1;
 
    #if JUCE_WINDOWS
-    return send (handle, (const char*) sourceBuffer, numBytesToWrite, 0);
+    const int result = send (handle, (const char*) sourceBuffer, numBytesToWrite, 0);
    #else
     int result;
 
+   #ifdef MSG_NOSIGNAL
+    // a peer that has closed the connection mustn't be able to kill the process with a SIGPIPE
+    while ((result = (int) ::send (handle, sourceBuffer, (size_t) numBytesToWrite, MSG_NOSIGNAL)) < 0
+   #else
     while ((result = (int) ::write (handle, sourceBuffer, (size_t) numBytesToWrite)) < 0
+   #endif
+            && errno == EINTR)
+    {
+    }
+   #endif
+
+    // a non-blocking socket whose buffer is full
+    if (result < 0 && SocketHelpers::lastErrorWasWouldBlock())
+        return 0;
+
+    return result;
+}
+
+int StreamingSocket::write (const void* const* sourceBuffers, const int* bufferSizes, const int numBuffers)
+{
+    if (isListener || ! connected)
+        return -1;
+
+    jassert (numBuffers >= 0);
+
+    enum { maxBuffersPerCall = 16 };
+    const int num = jmin (numBuffers, (int) maxBuffersPerCall);
+
+   #if JUCE_WINDOWS
+    WSABUF buffers [maxBuffersPerCall];
+
+    for (int i = 0; i < num; ++i)
+    {
+        buffers[i].buf = (CHAR*) sourceBuffers[i];
+        buffers[i].len = (ULONG) bufferSizes[i];
+    }
+
+    DWORD bytesSent = 0;
+
+    if (WSASend (handle, buffers, (DWORD) num, &bytesSent, 0, nullptr, nullptr) != 0)
+        return SocketHelpers::lastErrorWasWouldBlock() ? 0 : -1;
+
+    return (int) bytesSent;
+   #else
+    struct iovec buffers [maxBuffersPerCall];
+
+    for (int i = 0; i < num; ++i)
+    {
+        buffers[i].iov_base = const_cast <void*> (sourceBuffers[i]);
+        buffers[i].iov_len = (size_t) bufferSizes[i];
+    }
+
+    int result;
+
+   #ifdef MSG_NOSIGNAL
+    struct msghdr message;
+    zerostruct (message);
+    message.msg_iov = buffers;
+    message.msg_iovlen = (size_t) num;
+
+    while ((result = (int) ::sendmsg (handle, &message, MSG_NOSIGNAL)) < 0
+   #else
+    while ((result = (int) ::writev (handle, buffers, num)) < 0
+   #endif
             && errno == EINTR)
     {
     }
 
+    if (result < 0 && SocketHelpers::lastErrorWasWouldBlock())
+        return 0;
+
     return result;
    #endif
 }
@@ -323,6 +419,11 @@ int StreamingSocket::waitUntilReady (const bool readyForReading,
                      : -1;
 }
 
+bool StreamingSocket::setBlockingMode (const bool shouldBlock)
+{
+    return handle >= 0 && SocketHelpers::setSocketBlockingState (handle, shouldBlock);
+}
+
 //==============================================================================
 bool StreamingSocket::bindToPort (const int port)
 {
@@ -440,8 +541,13 @@ StreamingSocket* StreamingSocket::waitForNextConnection() const
         const int newSocket = (int) accept (handle, (struct sockaddr*) &address, &len);
 
         if (newSocket >= 0 && connected)
+        {
+            // (on some systems the new socket inherits the listener's non-blocking mode)
+            SocketHelpers::setSocketBlockingState (newSocket, true);
+
             return new StreamingSocket (inet_ntoa (((struct sockaddr_in*) &address)->sin_addr),
                                         portNumber, newSocket);
+        }
     }
 
     return nullptr;
@@ -559,6 +665,11 @@ int DatagramSocket::waitUntilReady (const bool readyForReading,
                      : -1;
 }
 
+bool DatagramSocket::setBlockingMode (const bool shouldBlock)
+{
+    return handle >= 0 && SocketHelpers::setSocketBlockingState (handle, shouldBlock);
+}
+
 int DatagramSocket::read (void* destBuffer, const int maxBytesToRead, const bool blockUntilSpecifiedAmountHasArrived)
 {
     return connected ? SocketHelpers::readSocket (handle, destBuffer, maxBytesToRead, connected, blockUntilSpecifiedAmountHasArrived)
@@ -570,11 +681,15 @@ int DatagramSocket::write (const void* sourceBuffer, const int numBytesToWrite)
     // You need to call connect() first to set the server address..
     jassert (serverAddress != nullptr && connected);
 
-    return connected ? (int) sendto (handle, (const char*) sourceBuffer,
+    if (! connected)
+        return -1;
+
+    const int result = (int) sendto (handle, (const char*) sourceBuffer,
                                      (size_t) numBytesToWrite, 0,
                                      static_cast <const struct addrinfo*> (serverAddress)->ai_addr,
-                                     (juce_socklen_t) static_cast <const struct addrinfo*> (serverAddress)->ai_addrlen)
-                     : -1;
+                                     (juce_socklen_t) static_cast <const struct addrinfo*> (serverAddress)->ai_addrlen);
+
+    return (result < 0 && SocketHelpers::lastErrorWasWouldBlock()) ? 0 : result;
 }
 
 bool DatagramSocket::isLocal() const noexcept
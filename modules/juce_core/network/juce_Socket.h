@@ -109,6 +109,23 @@ public:
     int waitUntilReady (bool readyForReading,
                         int timeoutMsecs) const;
 
+    /** Switches the socket between blocking and non-blocking mode.
+
+        Sockets are blocking by default. In non-blocking mode, read() and write() never
+        wait: they return 0 if no data is available, or if there's no room to send any
+        more. This is normally used along with a SocketEventLoop, which tells you when
+        a socket is ready.
+
+        Because connect() leaves the socket in blocking mode, this should be called after
+        the socket has connected. A listener socket in non-blocking mode will return
+        nullptr from waitForNextConnection() if no connection is waiting; the sockets that
+        it returns are always in blocking mode to begin with.
+
+        @returns true if the mode was changed successfully
+        @see SocketEventLoop
+    */
+    bool setBlockingMode (bool shouldBlock);
+
     /** Reads bytes from the socket.
 
         If blockUntilSpecifiedAmountHasArrived is true, the method will block until
@@ -116,8 +133,9 @@ public:
         flag is false, the method will return as much data as is currently available
         without blocking.
 
-        @returns the number of bytes read, or -1 if there was an error.
-        @see waitUntilReady
+        @returns the number of bytes read, or -1 if there was an error. A socket in
+                 non-blocking mode returns 0 if there's no data available yet.
+        @see waitUntilReady, setBlockingMode
     */
     int read (void* destBuffer, int maxBytesToRead,
               bool blockUntilSpecifiedAmountHasArrived);
@@ -127,10 +145,24 @@ public:
         Note that this method will block unless you have checked the socket is ready
         for writing before calling it (see the waitUntilReady() method).
 
-        @returns the number of bytes written, or -1 if there was an error.
+        @returns the number of bytes written, or -1 if there was an error. A socket in
+                 non-blocking mode may write fewer bytes than requested, and returns 0
+                 if it can't accept any more data at the moment.
     */
     int write (const void* sourceBuffer, int numBytesToWrite);
 
+    /** Writes the contents of several buffers to the socket in a single operation.
+
+        This is a "gather" write, which avoids having to copy the buffers into one
+        block first, e.g. to send a header along with some data. Only the first 16
+        buffers are written by each call.
+
+        @returns the total number of bytes written, or -1 if there was an error. This
+                 may be less than the total size of the buffers, in which case the
+                 remainder needs to be written with another call.
+    */
+    int write (const void* const* sourceBuffers, const int* bufferSizes, int numBuffers);
+
     //==============================================================================
     /** Puts this socket into "listener" mode.
 
@@ -257,6 +289,18 @@ public:
     int waitUntilReady (bool readyForReading,
                         int timeoutMsecs) const;
 
+    /** Switches the socket between blocking and non-blocking mode.
+
+        Sockets are blocking by default. In non-blocking mode, read() and write() never
+        wait: they return 0 if no data is available, or if there's no room to send any
+        more. This is normally used along with a SocketEventLoop, which tells you when
+        a socket is ready.
+
+        @returns true if the mode was changed successfully
+        @see SocketEventLoop
+    */
+    bool setBlockingMode (bool shouldBlock);
+
     /** Reads bytes from the socket.
 
         If blockUntilSpecifiedAmountHasArrived is true, the method will block until
@@ -264,8 +308,9 @@ public:
         flag is false, the method will return as much data as is currently available
         without blocking.
 
-        @returns the number of bytes read, or -1 if there was an error.
-        @see waitUntilReady
+        @returns the number of bytes read, or -1 if there was an error. A socket in
+                 non-blocking mode returns 0 if there's no data available yet.
+        @see waitUntilReady, setBlockingMode
     */
     int read (void* destBuffer, int maxBytesToRead,
               bool blockUntilSpecifiedAmountHasArrived);
@@ -275,7 +320,9 @@ public:
         Note that this method will block unless you have checked the socket is ready
         for writing before calling it (see the waitUntilReady() method).
 
-        @returns the number of bytes written, or -1 if there was an error.
+        @returns the number of bytes written, or -1 if there was an error. A socket in
+                 non-blocking mode may write fewer bytes than requested, and returns 0
+                 if it can't accept any more data at the moment.
     */
     int write (const void* sourceBuffer, int numBytesToWrite);
 
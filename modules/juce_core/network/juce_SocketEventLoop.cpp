@@ -0,0 +1,758 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#if JUCE_WINDOWS
+namespace SocketEventLoopHelpers
+{
+    // WSAPoll is only available from Vista onwards, and isn't declared by all compilers, so
+    // this uses its own copy of the WSAPOLLFD structure and loads the function dynamically.
+    struct PollHandle
+    {
+        SOCKET fd;
+        short events, revents;
+    };
+
+    enum { pollIn = 0x0100, pollOut = 0x0010, pollErr = 0x0001, pollHup = 0x0002, pollInvalid = 0x0004 };
+
+    typedef int (WINAPI *WSAPollFunction) (PollHandle*, ULONG, INT);
+
+    static WSAPollFunction getWSAPollFunction()
+    {
+        static WSAPollFunction wsaPoll = (WSAPollFunction) GetProcAddress (GetModuleHandleA ("ws2_32.dll"), "WSAPoll");
+        return wsaPoll;
+    }
+}
+#elif ! (JUCE_LINUX || JUCE_ANDROID || JUCE_MAC || JUCE_IOS)
+namespace SocketEventLoopHelpers
+{
+    typedef struct pollfd PollHandle;
+
+    enum { pollIn = POLLIN, pollOut = POLLOUT, pollErr = POLLERR, pollHup = POLLHUP, pollInvalid = POLLNVAL };
+}
+#endif
+
+//==============================================================================
+class SocketEventLoop::Pimpl
+{
+public:
+    Pimpl()
+        : nextRegistrationId (1),
+         #if JUCE_LINUX || JUCE_ANDROID
+          queueHandle (epoll_create (256)),
+         #elif JUCE_MAC || JUCE_IOS
+          queueHandle (kqueue()),
+         #else
+          needsRebuild (true),
+         #endif
+          wakeUpReadHandle (-1), wakeUpWriteHandle (-1)
+    {
+        SocketHelpers::initSockets();
+        createWakeUpHandles();
+
+       #if JUCE_LINUX || JUCE_ANDROID || JUCE_MAC || JUCE_IOS
+        if (queueHandle >= 0 && wakeUpReadHandle >= 0)
+        {
+            Registration r;
+            r.events = readyForReading;
+            r.id = 0;
+
+            if (! addToQueue (wakeUpReadHandle, r))
+            {
+                ::close (queueHandle);
+                queueHandle = -1;
+            }
+        }
+       #endif
+    }
+
+    ~Pimpl()
+    {
+       #if JUCE_LINUX || JUCE_ANDROID || JUCE_MAC || JUCE_IOS
+        if (queueHandle >= 0)
+            ::close (queueHandle);
+       #endif
+
+        closeWakeUpHandles();
+    }
+
+    bool isValid() const noexcept
+    {
+       #if JUCE_LINUX || JUCE_ANDROID || JUCE_MAC || JUCE_IOS
+        return queueHandle >= 0 && wakeUpReadHandle >= 0;
+       #elif JUCE_WINDOWS
+        return wakeUpReadHandle >= 0 && SocketEventLoopHelpers::getWSAPollFunction() != nullptr;
+       #else
+        return wakeUpReadHandle >= 0;
+       #endif
+    }
+
+    //==============================================================================
+    bool addSocket (const int handle, Listener* const listener, const int events)
+    {
+        jassert (listener != nullptr);
+
+        const ScopedLock sl (registrationLock);
+
+        if (handle < 0 || listener == nullptr || registrations.contains (handle) || ! isValid())
+            return false;
+
+        Registration r;
+        r.listener = listener;
+        r.events = events;
+        r.id = nextRegistrationId++;
+
+        if (nextRegistrationId == 0)
+            nextRegistrationId = 1; // (0 is reserved for the wake-up handle)
+
+        if (! addToQueue (handle, r))
+            return false;
+
+        registrations.set (handle, r);
+        return true;
+    }
+
+    bool setEventsToWatch (const int handle, const int events)
+    {
+        const ScopedLock sl (registrationLock);
+
+        if (! registrations.contains (handle))
+            return false;
+
+        Registration r (registrations [handle]);
+
+        if (r.events != events)
+        {
+            r.events = events;
+
+            if (! modifyInQueue (handle, r))
+                return false;
+
+            registrations.set (handle, r);
+        }
+
+        return true;
+    }
+
+    void removeSocket (const int handle)
+    {
+        // waits for any callbacks that are in progress to finish
+        const ScopedLock cl (callbackLock);
+        const ScopedLock sl (registrationLock);
+
+        if (registrations.contains (handle))
+        {
+            removeFromQueue (handle);
+            registrations.remove (handle);
+        }
+    }
+
+    int getNumSockets() const noexcept
+    {
+        const ScopedLock sl (registrationLock);
+        return registrations.size();
+    }
+
+    //==============================================================================
+    int runOnce (const int timeoutMs)
+    {
+        const int numSlots = waitForEvents (timeoutMs);
+
+        if (numSlots < 0)
+            return -1;
+
+        const ScopedLock cl (callbackLock);
+        int numDelivered = 0;
+
+        for (int i = 0; i < numSlots; ++i)
+        {
+            int handle, events;
+            uint32 id;
+
+            if (getEvent (i, handle, id, events))
+            {
+                if (id == 0)
+                    drainWakeUpHandle();
+                else if (deliverEvent (handle, id, events))
+                    ++numDelivered;
+            }
+        }
+
+        return numDelivered;
+    }
+
+    void wakeUp()
+    {
+        const char c = 0;
+
+       #if JUCE_WINDOWS
+        send ((SocketHandle) wakeUpWriteHandle, &c, 1, 0);
+       #else
+        const ssize_t result = ::write (wakeUpWriteHandle, &c, 1);
+        (void) result; // (if the pipe is full, the loop will wake up anyway)
+       #endif
+    }
+
+private:
+    //==============================================================================
+    struct Registration
+    {
+        Registration() noexcept : listener (nullptr), events (0), id (0) {}
+
+        Listener* listener;
+        int events;
+        uint32 id;
+    };
+
+    enum { maxEventsPerWait = 256 };
+
+    CriticalSection callbackLock, registrationLock;
+    FlatHashMap<int, Registration> registrations;
+    uint32 nextRegistrationId;
+
+   #if JUCE_LINUX || JUCE_ANDROID
+    int queueHandle;
+    struct epoll_event eventBuffer [maxEventsPerWait];
+   #elif JUCE_MAC || JUCE_IOS
+    int queueHandle;
+    struct kevent eventBuffer [maxEventsPerWait];
+   #else
+    Array<SocketEventLoopHelpers::PollHandle> pollHandles;
+    Array<uint32> pollIds;
+    bool needsRebuild;
+   #endif
+
+    int wakeUpReadHandle, wakeUpWriteHandle;
+
+    //==============================================================================
+    bool deliverEvent (const int handle, const uint32 id, int events)
+    {
+        Listener* listener = nullptr;
+
+        {
+            const ScopedLock sl (registrationLock);
+            const Registration r (registrations [handle]);
+
+            // if the socket was removed (or replaced by a new one with the same handle)
+            // after the event arrived, it gets ignored
+            if (r.id != id || r.listener == nullptr)
+                return false;
+
+            events &= (r.events | closedOrError);
+            listener = r.listener;
+        }
+
+        if (events == 0)
+            return false;
+
+        listener->handleSocketEvent (handle, events);
+        return true;
+    }
+
+    //==============================================================================
+    void createWakeUpHandles()
+    {
+       #if JUCE_WINDOWS
+        // a UDP socket that's connected to itself can be used to interrupt WSAPoll
+        const SocketHandle s = socket (AF_INET, SOCK_DGRAM, 0);
+
+        if (s == INVALID_SOCKET)
+            return;
+
+        struct sockaddr_in address;
+        zerostruct (address);
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+
+        juce_socklen_t len = sizeof (address);
+
+        if (bind (s, (struct sockaddr*) &address, sizeof (address)) == 0
+             && getsockname (s, (struct sockaddr*) &address, &len) == 0
+             && ::connect (s, (struct sockaddr*) &address, sizeof (address)) == 0
+             && SocketHelpers::setSocketBlockingState (s, false))
+        {
+            wakeUpReadHandle = wakeUpWriteHandle = (int) s;
+        }
+        else
+        {
+            closesocket (s);
+        }
+       #else
+        int handles[2];
+
+        if (pipe (handles) == 0)
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                SocketHelpers::setSocketBlockingState (handles[i], false);
+                fcntl (handles[i], F_SETFD, FD_CLOEXEC);
+            }
+
+            wakeUpReadHandle = handles[0];
+            wakeUpWriteHandle = handles[1];
+        }
+       #endif
+    }
+
+    void closeWakeUpHandles()
+    {
+       #if JUCE_WINDOWS
+        if (wakeUpReadHandle >= 0)
+            closesocket ((SocketHandle) wakeUpReadHandle);
+       #else
+        if (wakeUpReadHandle >= 0)
+        {
+            ::close (wakeUpReadHandle);
+            ::close (wakeUpWriteHandle);
+        }
+       #endif
+    }
+
+    void drainWakeUpHandle()
+    {
+        char buffer [64];
+
+       #if JUCE_WINDOWS
+        while (recv ((SocketHandle) wakeUpReadHandle, buffer, sizeof (buffer), 0) > 0)
+       #else
+        while (::read (wakeUpReadHandle, buffer, sizeof (buffer)) > 0)
+       #endif
+        {}
+    }
+
+    //==============================================================================
+   #if JUCE_LINUX || JUCE_ANDROID
+    bool updateQueue (const int operation, const int handle, const Registration& r)
+    {
+        struct epoll_event e;
+        zerostruct (e);
+        e.events = ((r.events & readyForReading) != 0 ? (uint32) EPOLLIN : 0)
+                 | ((r.events & readyForWriting) != 0 ? (uint32) EPOLLOUT : 0);
+        e.data.u64 = (((uint64) r.id) << 32) | (uint32) handle;
+
+        return epoll_ctl (queueHandle, operation, handle, &e) == 0;
+    }
+
+    bool addToQueue (int handle, const Registration& r)         { return updateQueue (EPOLL_CTL_ADD, handle, r); }
+    bool modifyInQueue (int handle, const Registration& r)      { return updateQueue (EPOLL_CTL_MOD, handle, r); }
+    void removeFromQueue (int handle)                           { updateQueue (EPOLL_CTL_DEL, handle, Registration()); }
+
+    int waitForEvents (const int timeoutMs)
+    {
+        const int num = epoll_wait (queueHandle, eventBuffer, maxEventsPerWait, timeoutMs < 0 ? -1 : timeoutMs);
+
+        if (num < 0)
+            return errno == EINTR ? 0 : -1;
+
+        return num;
+    }
+
+    bool getEvent (const int index, int& handle, uint32& id, int& events) const noexcept
+    {
+        const struct epoll_event& e = eventBuffer [index];
+
+        handle = (int) (uint32) e.data.u64;
+        id = (uint32) (e.data.u64 >> 32);
+        events = ((e.events & EPOLLIN) != 0 ? (int) readyForReading : 0)
+               | ((e.events & EPOLLOUT) != 0 ? (int) readyForWriting : 0)
+               | ((e.events & (EPOLLHUP | EPOLLERR)) != 0 ? (int) closedOrError : 0);
+        return true;
+    }
+
+    //==============================================================================
+   #elif JUCE_MAC || JUCE_IOS
+    bool addToQueue (const int handle, const Registration& r)
+    {
+        struct kevent changes[2];
+        void* const userData = (void*) (pointer_sized_uint) r.id;
+
+        EV_SET (&changes[0], handle, EVFILT_READ,  EV_ADD | ((r.events & readyForReading) != 0 ? EV_ENABLE : EV_DISABLE), 0, 0, userData);
+        EV_SET (&changes[1], handle, EVFILT_WRITE, EV_ADD | ((r.events & readyForWriting) != 0 ? EV_ENABLE : EV_DISABLE), 0, 0, userData);
+
+        return kevent (queueHandle, changes, 2, nullptr, 0, nullptr) == 0;
+    }
+
+    bool modifyInQueue (int handle, const Registration& r)      { return addToQueue (handle, r); }
+
+    void removeFromQueue (const int handle)
+    {
+        struct kevent changes[2];
+        EV_SET (&changes[0], handle, EVFILT_READ,  EV_DELETE, 0, 0, nullptr);
+        EV_SET (&changes[1], handle, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+
+        kevent (queueHandle, changes, 2, nullptr, 0, nullptr);
+    }
+
+    int waitForEvents (const int timeoutMs)
+    {
+        struct timespec timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = (timeoutMs % 1000) * 1000000;
+
+        const int num = kevent (queueHandle, nullptr, 0, eventBuffer, maxEventsPerWait,
+                                timeoutMs < 0 ? nullptr : &timeout);
+
+        if (num < 0)
+            return errno == EINTR ? 0 : -1;
+
+        return num;
+    }
+
+    bool getEvent (const int index, int& handle, uint32& id, int& events) const noexcept
+    {
+        const struct kevent& e = eventBuffer [index];
+
+        handle = (int) e.ident;
+        id = (uint32) (pointer_sized_uint) e.udata;
+        events = (e.filter == EVFILT_READ  ? (int) readyForReading : 0)
+               | (e.filter == EVFILT_WRITE ? (int) readyForWriting : 0)
+               | ((e.flags & (EV_EOF | EV_ERROR)) != 0 ? (int) closedOrError : 0);
+        return true;
+    }
+
+    //==============================================================================
+   #else
+    // The poll() version rebuilds its list of handles whenever the registrations change,
+    // so it can only pick up changes made by other threads after being woken up.
+    bool addToQueue (int, const Registration&)      { needsRebuild = true; wakeUp(); return true; }
+    bool modifyInQueue (int, const Registration&)   { needsRebuild = true; wakeUp(); return true; }
+    void removeFromQueue (int)                      { needsRebuild = true; wakeUp(); }
+
+    static SocketEventLoopHelpers::PollHandle createPollHandle (const int handle, const int events) noexcept
+    {
+        SocketEventLoopHelpers::PollHandle p;
+        zerostruct (p);
+        p.fd = (SocketHandle) handle;
+        p.events = (short) (((events & readyForReading) != 0 ? SocketEventLoopHelpers::pollIn : 0)
+                             | ((events & readyForWriting) != 0 ? SocketEventLoopHelpers::pollOut : 0));
+        return p;
+    }
+
+    int waitForEvents (const int timeoutMs)
+    {
+        {
+            const ScopedLock sl (registrationLock);
+
+            if (needsRebuild)
+            {
+                needsRebuild = false;
+                pollHandles.clearQuick();
+                pollIds.clearQuick();
+
+                pollHandles.add (createPollHandle (wakeUpReadHandle, readyForReading));
+                pollIds.add (0);
+
+                for (FlatHashMap<int, Registration>::Iterator i (registrations); i.next();)
+                {
+                    pollHandles.add (createPollHandle (i.getKey(), i.getValue().events));
+                    pollIds.add (i.getValue().id);
+                }
+            }
+        }
+
+       #if JUCE_WINDOWS
+        const int num = SocketEventLoopHelpers::getWSAPollFunction() (pollHandles.getRawDataPointer(), (ULONG) pollHandles.size(), timeoutMs < 0 ? -1 : timeoutMs);
+
+        if (num < 0)
+            return -1;
+       #else
+        const int num = poll (pollHandles.getRawDataPointer(), (nfds_t) pollHandles.size(), timeoutMs < 0 ? -1 : timeoutMs);
+
+        if (num < 0)
+            return errno == EINTR ? 0 : -1;
+       #endif
+
+        return num > 0 ? pollHandles.size() : 0;
+    }
+
+    bool getEvent (const int index, int& handle, uint32& id, int& events) const noexcept
+    {
+        const SocketEventLoopHelpers::PollHandle& p = pollHandles.getReference (index);
+
+        if (p.revents == 0)
+            return false;
+
+        handle = (int) p.fd;
+        id = pollIds.getUnchecked (index);
+        events = ((p.revents & SocketEventLoopHelpers::pollIn) != 0 ? (int) readyForReading : 0)
+               | ((p.revents & SocketEventLoopHelpers::pollOut) != 0 ? (int) readyForWriting : 0)
+               | ((p.revents & (SocketEventLoopHelpers::pollErr | SocketEventLoopHelpers::pollHup
+                                  | SocketEventLoopHelpers::pollInvalid)) != 0 ? (int) closedOrError : 0);
+        return true;
+    }
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+//==============================================================================
+SocketEventLoop::SocketEventLoop()  : pimpl (new Pimpl())
+{
+}
+
+SocketEventLoop::~SocketEventLoop()
+{
+}
+
+bool SocketEventLoop::isValid() const noexcept                                         { return pimpl->isValid(); }
+bool SocketEventLoop::addSocket (int handle, Listener* listener, int eventsToWatch)    { return pimpl->addSocket (handle, listener, eventsToWatch); }
+bool SocketEventLoop::setEventsToWatch (int handle, int eventsToWatch)                 { return pimpl->setEventsToWatch (handle, eventsToWatch); }
+void SocketEventLoop::removeSocket (int handle)                                        { pimpl->removeSocket (handle); }
+int SocketEventLoop::getNumSockets() const noexcept                                    { return pimpl->getNumSockets(); }
+int SocketEventLoop::runOnce (int timeoutMs)                                           { return pimpl->runOnce (timeoutMs); }
+void SocketEventLoop::wakeUp()                                                         { pimpl->wakeUp(); }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SocketEventLoopTests  : public UnitTest
+{
+public:
+    SocketEventLoopTests() : UnitTest ("SocketEventLoop") {}
+
+    //==============================================================================
+    // Accepts connections and echoes back whatever each of them sends
+    class EchoServer  : public SocketEventLoop::Listener
+    {
+    public:
+        EchoServer (SocketEventLoop& l, StreamingSocket& s)
+            : loop (l), listener (s), numAccepted (0), numClosed (0)
+        {
+            listener.setBlockingMode (false);
+            loop.addSocket (listener.getRawSocketHandle(), this, SocketEventLoop::readyForReading);
+        }
+
+        ~EchoServer()
+        {
+            loop.removeSocket (listener.getRawSocketHandle());
+
+            for (int i = clients.size(); --i >= 0;)
+                loop.removeSocket (clients.getUnchecked(i)->getRawSocketHandle());
+        }
+
+        void handleSocketEvent (int handle, int)
+        {
+            if (handle == listener.getRawSocketHandle())
+            {
+                while (StreamingSocket* const s = listener.waitForNextConnection())
+                {
+                    s->setBlockingMode (false);
+                    clients.add (s);
+                    loop.addSocket (s->getRawSocketHandle(), this, SocketEventLoop::readyForReading);
+                    ++numAccepted;
+                }
+
+                return;
+            }
+
+            for (int i = clients.size(); --i >= 0;)
+            {
+                StreamingSocket* const s = clients.getUnchecked(i);
+
+                if (s->getRawSocketHandle() == handle)
+                {
+                    char buffer [256];
+                    const int numRead = s->read (buffer, sizeof (buffer), false);
+
+                    if (numRead > 0)
+                    {
+                        s->write (buffer, numRead);
+                    }
+                    else if (numRead < 0)
+                    {
+                        loop.removeSocket (handle);
+                        clients.remove (i);
+                        ++numClosed;
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        SocketEventLoop& loop;
+        StreamingSocket& listener;
+        OwnedArray<StreamingSocket> clients;
+        Atomic<int> numAccepted, numClosed;
+    };
+
+    class LoopThread  : public Thread
+    {
+    public:
+        LoopThread (SocketEventLoop& l) : Thread ("SocketEventLoop test"), loop (l)
+        {
+            startThread();
+        }
+
+        ~LoopThread()
+        {
+            signalThreadShouldExit();
+            loop.wakeUp();
+            stopThread (5000);
+        }
+
+        void run()
+        {
+            while (! threadShouldExit())
+                loop.runOnce (-1);
+        }
+
+        SocketEventLoop& loop;
+    };
+
+    struct WritabilityListener  : public SocketEventLoop::Listener
+    {
+        WritabilityListener() : lastEvents (0) {}
+        void handleSocketEvent (int, int events)    { lastEvents = events; }
+        int lastEvents;
+    };
+
+    //==============================================================================
+    void runTest()
+    {
+        StreamingSocket listener;
+        int port = 0;
+
+        for (int p = 38300; p < 38400 && port == 0; ++p)
+            if (listener.createListener (p, "127.0.0.1"))
+                port = p;
+
+        if (port == 0)
+        {
+            logMessage ("Couldn't create a local server, so skipping the SocketEventLoop tests");
+            return;
+        }
+
+        beginTest ("Serving many connections");
+
+        SocketEventLoop loop;
+        expect (loop.isValid());
+
+        {
+            EchoServer server (loop, listener);
+            const uint32 startTime = Time::getMillisecondCounter();
+
+            {
+                LoopThread thread (loop);
+                OwnedArray<StreamingSocket> sockets;
+                const int numClients = 200;
+
+                for (int i = 0; i < numClients; ++i)
+                {
+                    StreamingSocket* const s = new StreamingSocket();
+                    sockets.add (s);
+                    expect (s->connect ("127.0.0.1", port, 2000));
+                }
+
+                bool allEchoed = true;
+
+                for (int i = 0; i < numClients; ++i)
+                {
+                    const String message ("message " + String (i));
+                    const int length = (int) message.getNumBytesAsUTF8();
+                    char buffer [64] = { 0 };
+
+                    allEchoed = allEchoed
+                                 && sockets[i]->write (message.toRawUTF8(), length) == length
+                                 && sockets[i]->read (buffer, length, true) == length
+                                 && String (buffer, (size_t) length) == message;
+                }
+
+                expect (allEchoed);
+                expectEquals (server.numAccepted.get(), numClients);
+                expectEquals (loop.getNumSockets(), numClients + 1);
+
+                sockets.clear();
+
+                for (int i = 0; i < 200 && server.numClosed.get() < numClients; ++i)
+                    Thread::sleep (10);
+
+                expectEquals (server.numClosed.get(), numClients);
+                expectEquals (loop.getNumSockets(), 1);
+            }
+
+            // the thread is blocked indefinitely in runOnce(), so this checks that wakeUp() works
+            expect (Time::getMillisecondCounter() - startTime < 4000);
+        }
+
+        expectEquals (loop.getNumSockets(), 0);
+
+        beginTest ("Non-blocking reads and writes");
+
+        {
+            StreamingSocket client;
+            expect (client.connect ("127.0.0.1", port, 2000));
+
+            listener.setBlockingMode (true);
+            ScopedPointer<StreamingSocket> connection (listener.waitForNextConnection());
+            expect (connection != nullptr);
+
+            if (connection != nullptr)
+            {
+                expect (connection->setBlockingMode (false));
+
+                char buffer [16];
+                expectEquals (connection->read (buffer, sizeof (buffer), false), 0);
+
+                WritabilityListener l;
+                expect (loop.addSocket (connection->getRawSocketHandle(), &l, SocketEventLoop::readyForWriting));
+                expect (! loop.addSocket (connection->getRawSocketHandle(), &l, SocketEventLoop::readyForWriting));
+                expectEquals (loop.runOnce (1000), 1);
+                expectEquals (l.lastEvents, (int) SocketEventLoop::readyForWriting);
+
+                l.lastEvents = 0;
+                expect (loop.setEventsToWatch (connection->getRawSocketHandle(), SocketEventLoop::readyForReading));
+                expectEquals (loop.runOnce (20), 0);
+
+                client.write ("x", 1);
+                expectEquals (loop.runOnce (1000), 1);
+                expect ((l.lastEvents & SocketEventLoop::readyForReading) != 0);
+                expectEquals (connection->read (buffer, sizeof (buffer), false), 1);
+
+                // fill up the socket's buffers until it won't take any more
+                HeapBlock<char> data (65536, true);
+                int numWritten = 0, result;
+
+                while ((result = connection->write (data, 65536)) > 0)
+                    numWritten += result;
+
+                expectEquals (result, 0);
+                expect (numWritten > 0);
+
+                client.close();
+                expectEquals (loop.runOnce (1000), 1);
+
+                for (int i = 0; i < 100 && (result = connection->read (buffer, sizeof (buffer), false)) == 0; ++i)
+                    Thread::sleep (10);
+
+                expectEquals (result, -1);
+                loop.removeSocket (connection->getRawSocketHandle());
+            }
+        }
+    }
+};
+
+static SocketEventLoopTests socketEventLoopTests;
+
+#endif
@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SOCKETEVENTLOOP_JUCEHEADER__
+#define __JUCE_SOCKETEVENTLOOP_JUCEHEADER__
+
+#include "../memory/juce_ScopedPointer.h"
+
+
+//==============================================================================
+/**
+    Waits for activity on a large number of sockets at once, and calls back a
+    listener for each socket that becomes ready.
+
+    This uses the most scalable mechanism that the OS provides - epoll on Linux and
+    Android, kqueue on OSX and iOS, and WSAPoll on Windows - so a single thread can
+    look after thousands of connections, instead of needing a blocking thread for
+    each one.
+
+    Sockets are registered by their raw handles (see StreamingSocket::getRawSocketHandle()
+    and DatagramSocket::getRawSocketHandle()), and will normally be put into non-blocking
+    mode, so that a listener can read and write as much as is possible without stalling
+    the loop.
+
+    One thread must repeatedly call runOnce(), which is where all the listener callbacks
+    happen. Sockets can be added, changed and removed from any thread, and removeSocket()
+    will wait for any callback that's in progress on that socket to finish, so once it
+    returns, the listener can safely be deleted.
+
+    @see StreamingSocket::setBlockingMode
+*/
+class JUCE_API  SocketEventLoop
+{
+public:
+    //==============================================================================
+    /** Creates an event loop with no sockets in it. */
+    SocketEventLoop();
+
+    /** Destructor.
+        Any sockets that are still registered are simply forgotten - they aren't closed.
+    */
+    ~SocketEventLoop();
+
+    //==============================================================================
+    /** The flags that describe which events a socket is waiting for, or has received. */
+    enum EventFlags
+    {
+        readyForReading     = 1,   /**< Data (or an incoming connection) is waiting to be read. */
+        readyForWriting     = 2,   /**< There's space in the socket's buffer for more data to be written. */
+        closedOrError       = 4    /**< The other end has closed the connection, or an error has occurred.
+                                        There may still be some data left to read. This is always reported,
+                                        whether or not you ask for it. */
+    };
+
+    //==============================================================================
+    /**
+        Receives callbacks when a socket that's registered with a SocketEventLoop
+        becomes ready.
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called by SocketEventLoop::runOnce() when a socket becomes ready.
+
+            The events parameter is a combination of the values in the EventFlags enum.
+            It's safe to add, change or remove sockets (including this one) from inside
+            this callback.
+        */
+        virtual void handleSocketEvent (int socketHandle, int events) = 0;
+    };
+
+    //==============================================================================
+    /** Returns true if the loop was created successfully.
+        This could only fail if the OS refuses to create the underlying event queue.
+    */
+    bool isValid() const noexcept;
+
+    /** Starts watching a socket for the given events.
+
+        @param socketHandle     the socket's raw handle
+        @param listener         the object to call when events arrive - this mustn't be deleted
+                                while the socket is still registered
+        @param eventsToWatch    a combination of readyForReading and readyForWriting
+        @returns false if the handle is invalid, or was already registered
+    */
+    bool addSocket (int socketHandle, Listener* listener, int eventsToWatch);
+
+    /** Changes the events that a registered socket is being watched for.
+
+        Typically, a socket is only watched for readyForWriting while it has some
+        outgoing data queued that couldn't be written straight away.
+    */
+    bool setEventsToWatch (int socketHandle, int eventsToWatch);
+
+    /** Stops watching a socket.
+
+        If a callback for this socket is in progress on another thread, this will wait for
+        it to finish, and once it returns there will be no more callbacks for the socket.
+        The socket must be removed before it gets closed.
+    */
+    void removeSocket (int socketHandle);
+
+    /** Returns the number of sockets that are currently registered. */
+    int getNumSockets() const noexcept;
+
+    //==============================================================================
+    /** Waits for events, and calls the listeners of any sockets that are ready.
+
+        This should only be called by one thread at a time.
+
+        @param timeoutMs    the maximum time to wait, or a negative value to wait
+                            until either an event arrives or wakeUp() is called
+        @returns the number of events that were delivered, 0 if it timed out or
+                 was woken up, or -1 if an error occurred
+    */
+    int runOnce (int timeoutMs);
+
+    /** Makes a call to runOnce() that's waiting for events return as soon as possible.
+        This can be called from any thread, e.g. to stop the thread that's running the loop.
+    */
+    void wakeUp();
+
+private:
+    //==============================================================================
+    JUCE_PUBLIC_IN_DLL_BUILD (class Pimpl)
+    ScopedPointer<Pimpl> pimpl;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SocketEventLoop)
+};
+
+
+#endif   // __JUCE_SOCKETEVENTLOOP_JUCEHEADER__
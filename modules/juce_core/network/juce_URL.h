@@ -249,6 +249,8 @@ public:
                                 in the response will be stored in this array
         @returns    an input stream that the caller must delete, or a null pointer if there was an
                     error trying to open it.
+
+        @see HTTPClient
      */
     InputStream* createInputStream (bool usePostCommand,
                                     OpenStreamProgressCallback* progressCallback = nullptr,
@@ -54,6 +54,9 @@ public:
     InputStream* createInputStreamFor (const String& relatedItemPath);
     int64 hashCode() const;
 
+    /** Returns the file that this source reads from. */
+    const File& getFile() const noexcept            { return file; }
+
 private:
     //==============================================================================
     const File file;
@@ -29,6 +29,25 @@ const SystemStats::CPUFlags& SystemStats::getCPUFlags()
     return cpuFlags;
 }
 
+int SystemStats::getPhysicalCoreForCpu (const int logicalCpuIndex) noexcept
+{
+    const CPUFlags& flags = getCPUFlags();
+
+    if (! isPositiveAndBelow (logicalCpuIndex, flags.numCpus))
+        return -1;
+
+    // if the platform couldn't tell us, assume that each core's hardware threads are numbered together
+    if (logicalCpuIndex < flags.physicalCoreForCpu.size())
+        return flags.physicalCoreForCpu.getUnchecked (logicalCpuIndex);
+
+    return logicalCpuIndex * flags.numPhysicalCpus / flags.numCpus;
+}
+
+int SystemStats::getCpuCacheSize (const int level) noexcept
+{
+    return (level >= 1 && level <= 3) ? getCPUFlags().cacheSizes [level - 1] : 0;
+}
+
 String SystemStats::getJUCEVersion()
 {
     // Some basic tests, to keep an eye on things and make sure these types work ok
@@ -127,6 +127,34 @@ public:
     /** Returns the number of CPUs. */
     static int getNumCpus() noexcept            { return getCPUFlags().numCpus; }
 
+    /** Returns the number of physical CPU cores.
+        Where a core runs several hardware threads (e.g. with hyper-threading), it only
+        counts once here, whereas getNumCpus() counts each of its threads.
+    */
+    static int getNumPhysicalCpus() noexcept    { return getCPUFlags().numPhysicalCpus; }
+
+    /** Returns the physical core that one of the logical CPUs belongs to.
+
+        The result is in the range 0 to getNumPhysicalCpus() - 1, and logical CPUs which
+        return the same value are hardware threads sharing one core. So for example, to
+        spread worker threads so that no two of them compete for the same core, you could
+        give each one an affinity mask containing a single CPU from a different core.
+
+        @param logicalCpuIndex  a CPU index, from 0 to getNumCpus() - 1, as used in the
+                                masks passed to Thread::setAffinityMask()
+        @returns the physical core index, or -1 if the index is out of range
+    */
+    static int getPhysicalCoreForCpu (int logicalCpuIndex) noexcept;
+
+    /** Returns the size of one level of the CPU's data cache.
+
+        @param level    the cache level, from 1 to 3. The level 1 and 2 caches usually
+                        belong to a single core, and the level 3 cache is usually shared
+                        between all the cores in a package.
+        @returns the size in bytes, or 0 if there's no such cache or it can't be found
+    */
+    static int getCpuCacheSize (int level) noexcept;
+
     /** Returns the approximate CPU speed.
         @returns    the speed in megahertz, e.g. 1500, 2500, 32000 (depending on
                     what year you're reading this...)
@@ -150,6 +178,27 @@ public:
     /** Checks whether AMD 3DNOW instructions are available. */
     static bool has3DNow() noexcept             { return getCPUFlags().has3DNow; }
 
+    /** Checks whether Intel AVX instructions are available, and the OS supports
+        saving the AVX registers.
+    */
+    static bool hasAVX() noexcept               { return getCPUFlags().hasAVX; }
+
+    /** Checks whether Intel AVX2 instructions are available. */
+    static bool hasAVX2() noexcept              { return getCPUFlags().hasAVX2; }
+
+    /** Checks whether the CPU has SHA-256 instructions, i.e. the Intel SHA
+        extensions, or the ARMv8 cryptography extensions.
+    */
+    static bool hasSHA() noexcept               { return getCPUFlags().hasSHA; }
+
+    /** Checks whether the CPU has AES instructions, i.e. the Intel AES-NI and
+        carry-less multiply instructions, or the ARMv8 cryptography extensions.
+    */
+    static bool hasAES() noexcept               { return getCPUFlags().hasAES; }
+
+    /** Checks whether ARM NEON instructions are available. */
+    static bool hasNeon() noexcept              { return getCPUFlags().hasNeon; }
+
     //==============================================================================
     /** Finds out how much RAM is in the machine.
         @returns    the approximate number of megabytes of memory, or zero if
@@ -186,11 +235,18 @@ private:
     {
         CPUFlags();
 
-        int numCpus;
+        int numCpus, numPhysicalCpus;
+        int cacheSizes[3];
+        Array<int> physicalCoreForCpu;
         bool hasMMX : 1;
         bool hasSSE : 1;
         bool hasSSE2 : 1;
         bool has3DNow : 1;
+        bool hasAVX : 1;
+        bool hasAVX2 : 1;
+        bool hasSHA : 1;
+        bool hasAES : 1;
+        bool hasNeon : 1;
     };
 
     SystemStats();
@@ -236,27 +236,30 @@ public:
     size_t length() const noexcept
     {
         const CharType* d = data;
+        const CharType* const end = data + strlen (data);
         size_t count = 0;
 
         for (;;)
         {
+            // runs of ASCII characters are counted without decoding them
+            const size_t numASCII = CharacterFunctions::getNumASCIIBytes (d, (size_t) (end - d));
+            d += numASCII;
+            count += numASCII;
+
+            if (d >= end)
+                break;
+
             const uint32 n = (uint32) (uint8) *d++;
+            uint32 bit = 0x40;
 
-            if ((n & 0x80) != 0)
+            while ((n & bit) != 0 && d < end)
             {
-                uint32 bit = 0x40;
-
-                while ((n & bit) != 0)
-                {
-                    ++d;
-                    bit >>= 1;
+                ++d;
+                bit >>= 1;
 
-                    if (bit == 0)
-                        break; // illegal utf-8 sequence
-                }
+                if (bit == 0)
+                    break; // illegal utf-8 sequence
             }
-            else if (n == 0)
-                break;
 
             ++count;
         }
@@ -371,13 +374,9 @@ public:
     /** Copies a source string to this pointer, advancing this pointer as it goes. */
     void writeAll (const CharPointer_UTF8 src) noexcept
     {
-        const CharType* s = src.data;
-
-        while ((*data = *s) != 0)
-        {
-            ++data;
-            ++s;
-        }
+        const size_t numBytes = strlen (src.data);
+        memcpy (data, src.data, numBytes + 1);
+        data += numBytes;
     }
 
     /** Copies a source string to this pointer, advancing this pointer as it goes.
@@ -407,6 +406,15 @@ public:
         return CharacterFunctions::compare (*this, other);
     }
 
+    /** Compares this string with another one.
+        (Comparing the raw bytes of two UTF-8 strings puts them in the same order as
+        comparing their characters would).
+    */
+    int compare (const CharPointer_UTF8 other) const noexcept
+    {
+        return strcmp (data, other.data);
+    }
+
     /** Compares this string with another one, up to a specified number of characters. */
     template <typename CharPointer>
     int compareUpTo (const CharPointer other, const int maxChars) const noexcept
@@ -506,36 +514,46 @@ public:
     /** Returns true if this data contains a valid string in this encoding. */
     static bool isValidString (const CharType* dataToTest, int maxBytesToRead)
     {
-        while (--maxBytesToRead >= 0 && *dataToTest != 0)
+        if (maxBytesToRead <= 0)
+            return true;
+
+        if (const void* const terminator = memchr (dataToTest, 0, (size_t) maxBytesToRead))
+            maxBytesToRead = (int) (static_cast <const CharType*> (terminator) - dataToTest);
+
+        for (;;)
         {
+            // (runs of ASCII characters are always valid, so are skipped in bulk)
+            const int numASCII = (int) CharacterFunctions::getNumASCIIBytes (dataToTest, (size_t) maxBytesToRead);
+            dataToTest += numASCII;
+            maxBytesToRead -= numASCII;
+
+            if (--maxBytesToRead < 0)
+                break;
+
             const signed char byte = (signed char) *dataToTest++;
+            uint8 bit = 0x40;
+            int numExtraValues = 0;
 
-            if (byte < 0)
+            while ((byte & bit) != 0)
             {
-                uint8 bit = 0x40;
-                int numExtraValues = 0;
+                if (bit < 8)
+                    return false;
 
-                while ((byte & bit) != 0)
-                {
-                    if (bit < 8)
-                        return false;
+                ++numExtraValues;
+                bit >>= 1;
 
-                    ++numExtraValues;
-                    bit >>= 1;
+                if (bit == 8 && (numExtraValues > maxBytesToRead
+                                   || *CharPointer_UTF8 (dataToTest - 1) > 0x10ffff))
+                    return false;
+            }
 
-                    if (bit == 8 && (numExtraValues > maxBytesToRead
-                                       || *CharPointer_UTF8 (dataToTest - 1) > 0x10ffff))
-                        return false;
-                }
+            maxBytesToRead -= numExtraValues;
+            if (maxBytesToRead < 0)
+                return false;
 
-                maxBytesToRead -= numExtraValues;
-                if (maxBytesToRead < 0)
+            while (--numExtraValues >= 0)
+                if ((*dataToTest++ & 0xc0) != 0x80)
                     return false;
-
-                while (--numExtraValues >= 0)
-                    if ((*dataToTest++ & 0xc0) != 0x80)
-                        return false;
-            }
         }
 
         return true;
@@ -559,4 +577,148 @@ private:
     CharType* data;
 };
 
+//==============================================================================
+#ifndef DOXYGEN
+/*  The conversions between UTF-8 and the wider formats are specialised here, so that
+    runs of ASCII characters are counted and copied in bulk rather than being decoded
+    and re-encoded one at a time.
+*/
+struct UTF8ConversionHelpers
+{
+    template <typename DestCharPointerType>
+    static size_t getBytesRequiredFromUTF8 (const CharPointer_UTF8 source) noexcept
+    {
+        const char* src = source.getAddress();
+        const char* const end = src + strlen (src);
+        size_t count = 0;
+
+        while (src < end)
+        {
+            const size_t numASCII = CharacterFunctions::getNumASCIIBytes (src, (size_t) (end - src));
+            count += numASCII * sizeof (typename DestCharPointerType::CharType);
+            src += numASCII;
+
+            if (src >= end)
+                break;
+
+            CharPointer_UTF8 p (src);
+            const juce_wchar c = p.getAndAdvance();
+
+            if (c == 0)
+                break;
+
+            count += DestCharPointerType::getBytesRequiredFor (c);
+            src = p.getAddress();
+        }
+
+        return count;
+    }
+
+    template <typename DestCharPointerType>
+    static void copyFromUTF8 (DestCharPointerType& dest, const CharPointer_UTF8 source) noexcept
+    {
+        typedef typename DestCharPointerType::CharType DestCharType;
+        const char* src = source.getAddress();
+        const char* const end = src + strlen (src);
+
+        while (src < end)
+        {
+            const size_t numASCII = CharacterFunctions::getNumASCIIBytes (src, (size_t) (end - src));
+            DestCharType* const d = dest.getAddress();
+
+            for (size_t i = 0; i < numASCII; ++i)
+                d[i] = (DestCharType) src[i];
+
+            dest = d + numASCII;
+            src += numASCII;
+
+            if (src >= end)
+                break;
+
+            CharPointer_UTF8 p (src);
+            const juce_wchar c = p.getAndAdvance();
+
+            if (c == 0)
+                break;
+
+            dest.write (c);
+            src = p.getAddress();
+        }
+
+        dest.writeNull();
+    }
+
+    template <typename SrcCharPointerType>
+    static size_t getUTF8BytesRequiredFor (SrcCharPointerType text) noexcept
+    {
+        const typename SrcCharPointerType::CharType* s = text.getAddress();
+        size_t count = 0;
+
+        for (;;)
+        {
+            while ((uint32) *s - 1 < 0x7f)
+            {
+                ++s;
+                ++count;
+            }
+
+            text = s;
+            const juce_wchar c = text.getAndAdvance();
+
+            if (c == 0)
+                break;
+
+            count += CharPointer_UTF8::getBytesRequiredFor (c);
+            s = text.getAddress();
+        }
+
+        return count;
+    }
+
+    template <typename SrcCharPointerType>
+    static void copyToUTF8 (CharPointer_UTF8& dest, SrcCharPointerType text) noexcept
+    {
+        const typename SrcCharPointerType::CharType* s = text.getAddress();
+        char* d = dest.getAddress();
+
+        for (;;)
+        {
+            while ((uint32) *s - 1 < 0x7f)
+                *d++ = (char) *s++;
+
+            dest = d;
+            text = s;
+            const juce_wchar c = text.getAndAdvance();
+
+            if (c == 0)
+                break;
+
+            dest.write (c);
+            s = text.getAddress();
+            d = dest.getAddress();
+        }
+
+        dest.writeNull();
+    }
+};
+
+template <>
+inline size_t CharPointer_UTF16::getBytesRequiredFor (CharPointer_UTF8 text) noexcept  { return UTF8ConversionHelpers::getBytesRequiredFromUTF8<CharPointer_UTF16> (text); }
+template <>
+inline size_t CharPointer_UTF32::getBytesRequiredFor (CharPointer_UTF8 text) noexcept  { return UTF8ConversionHelpers::getBytesRequiredFromUTF8<CharPointer_UTF32> (text); }
+template <>
+inline size_t CharPointer_UTF8::getBytesRequiredFor (CharPointer_UTF16 text) noexcept  { return UTF8ConversionHelpers::getUTF8BytesRequiredFor (text); }
+template <>
+inline size_t CharPointer_UTF8::getBytesRequiredFor (CharPointer_UTF32 text) noexcept  { return UTF8ConversionHelpers::getUTF8BytesRequiredFor (text); }
+
+template <>
+inline void CharacterFunctions::copyAll (CharPointer_UTF16& dest, CharPointer_UTF8 src) noexcept   { UTF8ConversionHelpers::copyFromUTF8 (dest, src); }
+template <>
+inline void CharacterFunctions::copyAll (CharPointer_UTF32& dest, CharPointer_UTF8 src) noexcept   { UTF8ConversionHelpers::copyFromUTF8 (dest, src); }
+template <>
+inline void CharacterFunctions::copyAll (CharPointer_UTF8& dest, CharPointer_UTF16 src) noexcept   { UTF8ConversionHelpers::copyToUTF8 (dest, src); }
+template <>
+inline void CharacterFunctions::copyAll (CharPointer_UTF8& dest, CharPointer_UTF32 src) noexcept   { UTF8ConversionHelpers::copyToUTF8 (dest, src); }
+#endif
+
 #endif   // __JUCE_CHARPOINTER_UTF8_JUCEHEADER__
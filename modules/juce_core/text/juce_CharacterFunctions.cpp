@@ -122,6 +122,39 @@ int CharacterFunctions::getHexDigitValue (const juce_wchar digit) noexcept
     return -1;
 }
 
+size_t CharacterFunctions::getNumASCIIBytes (const char* const text, const size_t numBytes) noexcept
+{
+    size_t i = 0;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    while (i + 16 <= numBytes
+            && _mm_movemask_epi8 (_mm_loadu_si128 (reinterpret_cast <const __m128i*> (text + i))) == 0)
+        i += 16;
+   #endif
+
+    while (i + sizeof (uint64) <= numBytes)
+    {
+        uint64 word;
+        memcpy (&word, text + i, sizeof (word));
+
+        if ((word & literal64bit (0x8080808080808080)) != 0)
+            break;
+
+        i += sizeof (uint64);
+    }
+
+    while (i < numBytes && (text[i] & 0x80) == 0)
+        ++i;
+
+    return i;
+}
+
+const char* CharacterFunctions::findFirstOf (const char* const text, const char char1, const char char2) noexcept
+{
+    const char charsToFind[] = { char1, char2, 0 };
+    return text + strcspn (text, charsToFind);
+}
+
 double CharacterFunctions::mulexp10 (const double value, int exponent) noexcept
 {
     if (exponent == 0)
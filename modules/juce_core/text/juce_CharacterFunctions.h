@@ -110,6 +110,36 @@ public:
     /** Returns 0 to 16 for '0' to 'F", or -1 for characters that aren't a legal hex digit. */
     static int getHexDigitValue (juce_wchar digit) noexcept;
 
+    //==============================================================================
+    /** Returns the number of bytes at the start of a block of 8-bit text which are 7-bit
+        ASCII characters, i.e. which have their top bit clear (nulls are included).
+
+        This checks many bytes at a time, so the UTF-8 functions use it to skip quickly
+        over the parts of a string that don't need to be decoded.
+    */
+    static size_t getNumASCIIBytes (const char* text, size_t numBytes) noexcept;
+
+    /** Returns a pointer to the first occurrence of either of two ASCII characters in a
+        null-terminated string, or to its terminating null if neither is found.
+
+        The 8-bit version uses the C library's optimised scanning functions. No byte of a
+        multi-byte UTF-8 sequence can be mistaken for an ASCII character, so it can be used
+        to look for delimiters in UTF-8 text without decoding it.
+    */
+    static const char* findFirstOf (const char* text, char char1, char char2) noexcept;
+
+    /** Returns a pointer to the first occurrence of either of two ASCII characters in a
+        null-terminated string, or to its terminating null if neither is found.
+    */
+    template <typename CharType>
+    static const CharType* findFirstOf (const CharType* text, const CharType char1, const CharType char2) noexcept
+    {
+        while (*text != char1 && *text != char2 && *text != 0)
+            ++text;
+
+        return text;
+    }
+
     //==============================================================================
     /** Parses a character string to read a floating-point number.
         Note that this will advance the pointer that is passed in, leaving it at
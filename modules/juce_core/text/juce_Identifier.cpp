@@ -23,12 +23,129 @@
   ==============================================================================
 */
 
-StringPool& Identifier::getPool()
+//==============================================================================
+/*  The table that all Identifier names are interned in.
+
+    Each name is stored once, along with its hash, in an entry that is never moved or
+    deleted until the program exits. The entries hang off a fixed array of buckets, and
+    new ones are only ever pushed onto the front of a bucket's list with a compare-and-swap,
+    so looking a name up never takes a lock, and threads creating different identifiers
+    at the same time don't get in each other's way.
+*/
+class IdentifierPool
 {
-    static StringPool pool;
-    return pool;
-}
+public:
+    IdentifierPool() noexcept {}
+
+    ~IdentifierPool()
+    {
+        for (int i = 0; i < numBuckets; ++i)
+        {
+            for (Entry* e = buckets[i].get(); e != nullptr;)
+            {
+                Entry* const next = e->next;
+                std::free (e);
+                e = next;
+            }
+        }
+    }
+
+    static IdentifierPool& getInstance()
+    {
+        static IdentifierPool pool;
+        return pool;
+    }
+
+    struct Entry
+    {
+        Entry* next;
+        uint32 hash;
+        String::CharPointerType::CharType text[1];
+
+        String::CharPointerType getText() noexcept      { return String::CharPointerType (text); }
+
+        static Entry* fromText (const String::CharPointerType::CharType* const t) noexcept
+        {
+            return reinterpret_cast <Entry*> (reinterpret_cast <char*> (const_cast <String::CharPointerType::CharType*> (t))
+                                               - offsetof (Entry, text));
+        }
+    };
+
+    template <typename CharPointer>
+    String::CharPointerType getPooledName (const CharPointer name)
+    {
+        const uint32 hash = calculateHash (name);
+        Atomic<Entry*>& bucket = buckets [hash & (numBuckets - 1)];
+
+        Entry* head = bucket.get();
+
+        if (Entry* const existing = findEntry (head, nullptr, name, hash))
+            return existing->getText();
+
+        Entry* const newEntry = createEntry (name, hash);
+
+        for (;;)
+        {
+            newEntry->next = head;
+
+            if (bucket.compareAndSetBool (newEntry, head))
+                return newEntry->getText();
+
+            // another thread got in first, so check whether it added the same name..
+            Entry* const newHead = bucket.get();
+
+            if (Entry* const existing = findEntry (newHead, head, name, hash))
+            {
+                std::free (newEntry);
+                return existing->getText();
+            }
+
+            head = newHead;
+        }
+    }
+
+private:
+    enum { numBuckets = 4096 };
+    Atomic<Entry*> buckets [numBuckets];
+
+    template <typename CharPointer>
+    static uint32 calculateHash (CharPointer name) noexcept
+    {
+        uint32 hash = 2166136261u;
+
+        while (const juce_wchar c = name.getAndAdvance())
+            hash = (hash ^ (uint32) c) * 16777619u;
+
+        return hash;
+    }
+
+    template <typename CharPointer>
+    static Entry* findEntry (Entry* e, const Entry* const end, const CharPointer name, const uint32 hash) noexcept
+    {
+        for (; e != end; e = e->next)
+            if (e->hash == hash && CharacterFunctions::compare (e->getText(), name) == 0)
+                return e;
+
+        return nullptr;
+    }
+
+    template <typename CharPointer>
+    static Entry* createEntry (const CharPointer name, const uint32 hash)
+    {
+        const String s (name);
+        const size_t numBytes = s.getCharPointer().sizeInBytes();
 
+        Entry* const e = static_cast <Entry*> (std::malloc (offsetof (Entry, text) + numBytes));
+        e->next = nullptr;
+        e->hash = hash;
+        memcpy (e->text, s.getCharPointer().getAddress(), numBytes);
+        return e;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (IdentifierPool)
+};
+
+//==============================================================================
 Identifier::Identifier() noexcept
     : name (nullptr)
 {
@@ -46,12 +163,12 @@ Identifier& Identifier::operator= (const Identifier other) noexcept
 }
 
 Identifier::Identifier (const String& nm)
-    : name (Identifier::getPool().getPooledString (nm))
+    : name (IdentifierPool::getInstance().getPooledName (nm.getCharPointer()))
 {
 }
 
 Identifier::Identifier (const char* const nm)
-    : name (Identifier::getPool().getPooledString (nm))
+    : name (IdentifierPool::getInstance().getPooledName (CharPointer_ASCII (nm != nullptr ? nm : "")))
 {
     /* An Identifier string must be suitable for use as a script variable or XML
        attribute, so it can only contain this limited set of characters.. */
@@ -62,6 +179,11 @@ Identifier::~Identifier()
 {
 }
 
+int Identifier::getHashCode() const noexcept
+{
+    return name.getAddress() != nullptr ? (int) IdentifierPool::Entry::fromText (name.getAddress())->hash : 0;
+}
+
 Identifier Identifier::null;
 
 bool Identifier::isValidIdentifier (const String& possibleIdentifier) noexcept
@@ -69,3 +191,79 @@ bool Identifier::isValidIdentifier (const String& possibleIdentifier) noexcept
     return possibleIdentifier.isNotEmpty()
             && possibleIdentifier.containsOnly ("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-:#@$%");
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class IdentifierTests  : public UnitTest
+{
+public:
+    IdentifierTests() : UnitTest ("Identifier") {}
+
+    class CreatorThread  : public Thread
+    {
+    public:
+        CreatorThread (int seed_) : Thread ("identifier creator"), seed (seed_) {}
+
+        void run()
+        {
+            Random r (seed);
+
+            for (int i = 0; i < 20000; ++i)
+            {
+                const int n = r.nextInt (2000);
+                const Identifier id ("concurrent" + String (n));
+                pointers.set (n, id.getCharPointer().getAddress());
+            }
+        }
+
+        const int seed;
+        HashMap<int, const void*> pointers;
+    };
+
+    void runTest()
+    {
+        beginTest ("Pooling");
+
+        const Identifier a ("abc"), b (String ("abc")), c ("abd");
+        expect (a == b);
+        expect (a != c);
+        expect (a.getCharPointer().getAddress() == b.getCharPointer().getAddress());
+        expectEquals (a.toString(), String ("abc"));
+        expectEquals (a.getHashCode(), b.getHashCode());
+        expect (a.getHashCode() != c.getHashCode());
+        expectEquals (Identifier::null.getHashCode(), 0);
+        expect (Identifier::null.isNull());
+
+        beginTest ("Concurrent creation");
+
+        OwnedArray<CreatorThread> threads;
+
+        for (int i = 0; i < 4; ++i)
+            threads.add (new CreatorThread (i + 1));
+
+        for (int i = 0; i < threads.size(); ++i)
+            threads.getUnchecked(i)->startThread();
+
+        for (int i = 0; i < threads.size(); ++i)
+            threads.getUnchecked(i)->waitForThreadToExit (-1);
+
+        bool allMatch = true;
+
+        for (int i = 0; i < threads.size(); ++i)
+        {
+            for (HashMap<int, const void*>::Iterator it (threads.getUnchecked(i)->pointers); it.next();)
+            {
+                const Identifier id ("concurrent" + String (it.getKey()));
+                allMatch = allMatch && id.getCharPointer().getAddress() == it.getValue()
+                                    && id.toString() == "concurrent" + String (it.getKey());
+            }
+        }
+
+        expect (allMatch);
+    }
+};
+
+static IdentifierTests identifierUnitTests;
+
+#endif
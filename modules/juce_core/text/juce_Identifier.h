@@ -26,8 +26,6 @@
 #ifndef __JUCE_IDENTIFIER_JUCEHEADER__
 #define __JUCE_IDENTIFIER_JUCEHEADER__
 
-class StringPool;
-
 
 //==============================================================================
 /**
@@ -37,6 +35,10 @@ class StringPool;
     from a string, so it's much faster to keep a static identifier object to refer
     to frequently-used names, rather than constructing them each time you need it.
 
+    All the names are interned in a global table that can be searched and added to
+    from any number of threads at once without locking, and which also stores a hash
+    of each name, so getHashCode() doesn't have to look at the characters again.
+
     @see NamedPropertySet, ValueTree
 */
 class JUCE_API  Identifier
@@ -81,6 +83,12 @@ public:
     /** Returns this identifier's raw string pointer. */
     const String::CharPointerType getCharPointer() const noexcept       { return name; }
 
+    /** Returns a hash code for this identifier's name.
+        This was calculated when the name was first added to the pool, so it's very fast.
+        A null identifier returns 0.
+    */
+    int getHashCode() const noexcept;
+
     /** Returns true if this Identifier is not null */
     bool isValid() const noexcept                                       { return name.getAddress() != nullptr; }
 
@@ -100,8 +108,6 @@ public:
 private:
     //==============================================================================
     String::CharPointerType name;
-
-    static StringPool& getPool();
 };
 
 
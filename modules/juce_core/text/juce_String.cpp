@@ -128,6 +128,48 @@ public:
         return dest;
     }
 
+   #if JUCE_STRING_UTF_TYPE == 8
+    // ASCII and UTF-8 text can be copied directly into a UTF-8 string, without being decoded
+    static CharPointerType createFromCharPointer (const CharPointer_UTF8 text)
+    {
+        if (text.getAddress() == nullptr || text.isEmpty())
+            return getEmpty();
+
+        const size_t numBytes = strlen (text.getAddress()) + 1;
+        const CharPointerType dest (createUninitialisedBytes (numBytes));
+        memcpy (dest.getAddress(), text.getAddress(), numBytes);
+        return dest;
+    }
+
+    static CharPointerType createFromCharPointer (const CharPointer_ASCII text)
+    {
+        return createFromCharPointer (CharPointer_UTF8 (text.getAddress()));
+    }
+
+    static CharPointerType createFromCharPointer (const CharPointer_UTF8 text, const size_t maxChars)
+    {
+        if (text.getAddress() == nullptr || text.isEmpty() || maxChars == 0)
+            return getEmpty();
+
+        // If the text is all ASCII up to the limit, its length in characters is the
+        // same as its length in bytes, so it can be copied without being decoded.
+        const char* const start = text.getAddress();
+        const void* const terminator = memchr (start, 0, maxChars);
+        const size_t numBytes = terminator != nullptr ? (size_t) (static_cast <const char*> (terminator) - start)
+                                                      : maxChars;
+
+        if (CharacterFunctions::getNumASCIIBytes (start, numBytes) == numBytes)
+            return createFromCharPointer (text, CharPointer_UTF8 (start + numBytes));
+
+        return createFromCharPointer<CharPointer_UTF8> (text, maxChars);
+    }
+
+    static CharPointerType createFromCharPointer (const CharPointer_ASCII text, const size_t maxChars)
+    {
+        return createFromCharPointer (CharPointer_UTF8 (text.getAddress()), maxChars);
+    }
+   #endif
+
     static CharPointerType createFromCharPointer (const CharPointerType start, const CharPointerType end)
     {
         if (start.getAddress() == nullptr || start.isEmpty())
@@ -153,9 +195,48 @@ public:
     }
 
     //==============================================================================
-    static void retain (const CharPointerType text) noexcept
+    // Strings that live in a MemoryArena are given a reference count in this range. They're
+    // never deleted, and retaining one makes a normal heap copy, so that the copy can outlive
+    // the arena. (The counts start well above the threshold, because String objects that share
+    // arena text are destroyed without ever having incremented it).
+    enum
+    {
+        arenaRefCountThreshold = 0x60000000,
+        initialArenaRefCount   = 0x70000000
+    };
+
+    static CharPointerType createInArena (MemoryArena& arena, const CharPointerType start, const CharPointerType end)
+    {
+        const size_t numBytes = (size_t) (reinterpret_cast <const char*> (end.getAddress())
+                                           - reinterpret_cast <const char*> (start.getAddress()));
+
+        StringHolder* const s = static_cast <StringHolder*> (arena.allocate (sizeof (StringHolder) + numBytes,
+                                                                             sizeof (void*)));
+        s->refCount.value = initialArenaRefCount;
+        s->allocatedNumBytes = numBytes + sizeof (CharType);
+        memcpy (s->text, start.getAddress(), numBytes);
+        s->text [numBytes / sizeof (CharType)] = 0;
+        return CharPointerType (s->text);
+    }
+
+    static bool isInArena (const CharPointerType text) noexcept
     {
-        ++(bufferFromText (text)->refCount);
+        return bufferFromText (text)->refCount.get() >= arenaRefCountThreshold;
+    }
+
+    static CharPointerType retain (const CharPointerType text) noexcept
+    {
+        StringHolder* const b = bufferFromText (text);
+
+        if (b->refCount.get() >= arenaRefCountThreshold)
+        {
+            CharPointerType newText (createUninitialisedBytes (b->allocatedNumBytes));
+            memcpy (newText.getAddress(), text.getAddress(), b->allocatedNumBytes);
+            return newText;
+        }
+
+        ++(b->refCount);
+        return text;
     }
 
     static inline void release (StringHolder* const b) noexcept
@@ -169,6 +250,11 @@ public:
         release (bufferFromText (text));
     }
 
+    static int getReferenceCount (const CharPointerType text) noexcept
+    {
+        return bufferFromText (text)->refCount.get() + 1;
+    }
+
     //==============================================================================
     static CharPointerType makeUnique (const CharPointerType text)
     {
@@ -198,6 +284,28 @@ public:
         return newText;
     }
 
+    // Used when appending: if an unshared buffer is too small, it's given 50% more space
+    // than is needed, so that a sequence of appends only copies the text O (log n) times.
+    static CharPointerType makeUniqueForAppending (const CharPointerType text, size_t numBytes)
+    {
+        StringHolder* const b = bufferFromText (text);
+
+        if (b->refCount.get() <= 0)
+        {
+            if (b->allocatedNumBytes >= numBytes)
+                return text;
+
+            if (b != &empty)
+                numBytes = (numBytes + numBytes / 2 + 15) & ~(size_t) 15;
+        }
+
+        CharPointerType newText (createUninitialisedBytes (jmax (b->allocatedNumBytes, numBytes)));
+        memcpy (newText.getAddress(), text.getAddress(), b->allocatedNumBytes);
+        release (b);
+
+        return newText;
+    }
+
     static size_t getAllocatedNumBytes (const CharPointerType text) noexcept
     {
         return bufferFromText (text)->allocatedNumBytes;
@@ -242,6 +350,11 @@ void String::preallocateBytes (const size_t numBytesNeeded)
     text = StringHolder::makeUniqueWithByteSize (text, numBytesNeeded + sizeof (CharPointerType::CharType));
 }
 
+void String::preallocateBytesForAppending (const size_t numBytesNeeded)
+{
+    text = StringHolder::makeUniqueForAppending (text, numBytesNeeded + sizeof (CharPointerType::CharType));
+}
+
 //==============================================================================
 String::String() noexcept  : text (StringHolder::getEmpty())
 {
@@ -253,9 +366,8 @@ String::~String() noexcept
 }
 
 String::String (const String& other) noexcept
-    : text (other.text)
+    : text (StringHolder::retain (other.text))
 {
-    StringHolder::retain (text);
 }
 
 void String::swapWith (String& other) noexcept
@@ -263,10 +375,14 @@ void String::swapWith (String& other) noexcept
     std::swap (text, other.text);
 }
 
+int String::getReferenceCount() const noexcept
+{
+    return StringHolder::getReferenceCount (text);
+}
+
 String& String::operator= (const String& other) noexcept
 {
-    StringHolder::retain (other.text);
-    StringHolder::release (text.atomicSwap (other.text));
+    StringHolder::release (text.atomicSwap (StringHolder::retain (other.text)));
     return *this;
 }
 
@@ -347,6 +463,18 @@ String::String (const CharPointer_UTF32 start, const CharPointer_UTF32 end)  : t
 
 String::String (const std::string& s) : text (StringHolder::createFromFixedLength (s.data(), s.size())) {}
 
+String::String (MemoryArena& arena, const String& other)
+    : text (other.isEmpty() ? StringHolder::getEmpty()
+                            : (StringHolder::isInArena (other.text) ? other.text
+                                                                    : StringHolder::createInArena (arena, other.text, other.text.findTerminatingNull())))
+{
+}
+
+String::String (MemoryArena& arena, const CharPointerType start, const CharPointerType end)
+    : text (StringHolder::createInArena (arena, start, end))
+{
+}
+
 String String::charToString (const juce_wchar character)
 {
     String result (PreallocationBytes (CharPointerType::getBytesRequiredFor (character)));
@@ -640,6 +768,20 @@ String& String::operator+= (const String& other)
     return *this;
 }
 
+#if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+String& String::operator+= (String&& other)
+{
+    if (isEmpty())
+    {
+        std::swap (text, other.text);
+        return *this;
+    }
+
+    appendCharPointer (other.text);
+    return *this;
+}
+#endif
+
 String& String::operator+= (const char ch)
 {
     const char asString[] = { ch, 0 };
@@ -675,7 +817,7 @@ String& String::operator+= (const int number)
         const size_t newBytesNeeded = sizeof (CharPointerType::CharType) + byteOffsetOfNull
                                         + sizeof (CharPointerType::CharType) * (size_t) numExtraChars;
 
-        text = StringHolder::makeUniqueWithByteSize (text, newBytesNeeded);
+        text = StringHolder::makeUniqueForAppending (text, newBytesNeeded);
 
         CharPointerType newEnd (addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull));
         newEnd.writeWithCharLimit (CharPointer_ASCII (start), numExtraChars);
@@ -703,14 +845,16 @@ JUCE_API String JUCE_CALLTYPE operator+ (const wchar_t s1, const String& s2)
 JUCE_API String JUCE_CALLTYPE operator+ (const juce_wchar s1, const String& s2) { return String::charToString (s1) + s2; }
 #endif
 
-JUCE_API String JUCE_CALLTYPE operator+ (String s1, const String& s2)       { return s1 += s2; }
-JUCE_API String JUCE_CALLTYPE operator+ (String s1, const char* const s2)   { return s1 += s2; }
-JUCE_API String JUCE_CALLTYPE operator+ (String s1, const wchar_t* s2)      { return s1 += s2; }
+// These return s1 by name rather than returning the reference from +=, so that compilers
+// with move semantics can move the result out instead of copying it.
+JUCE_API String JUCE_CALLTYPE operator+ (String s1, const String& s2)       { s1 += s2; return s1; }
+JUCE_API String JUCE_CALLTYPE operator+ (String s1, const char* const s2)   { s1 += s2; return s1; }
+JUCE_API String JUCE_CALLTYPE operator+ (String s1, const wchar_t* s2)      { s1 += s2; return s1; }
 
-JUCE_API String JUCE_CALLTYPE operator+ (String s1, const char s2)          { return s1 += s2; }
-JUCE_API String JUCE_CALLTYPE operator+ (String s1, const wchar_t s2)       { return s1 += s2; }
+JUCE_API String JUCE_CALLTYPE operator+ (String s1, const char s2)          { s1 += s2; return s1; }
+JUCE_API String JUCE_CALLTYPE operator+ (String s1, const wchar_t s2)       { s1 += s2; return s1; }
 #if ! JUCE_NATIVE_WCHAR_IS_UTF32
-JUCE_API String JUCE_CALLTYPE operator+ (String s1, const juce_wchar s2)    { return s1 += s2; }
+JUCE_API String JUCE_CALLTYPE operator+ (String s1, const juce_wchar s2)    { s1 += s2; return s1; }
 #endif
 
 JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const char s2)             { return s1 += s2; }
@@ -2371,6 +2515,75 @@ public:
             TestUTFConversion <CharPointer_UTF16>::test (*this);
         }
 
+        {
+            beginTest ("UTF-8 fast paths");
+
+            // long ASCII runs broken up by multi-byte characters, so that the word-sized
+            // scanning loops get to see runs that start and end at every alignment
+            Random r;
+            String mixed;
+
+            for (int i = 0; i < 40; ++i)
+            {
+                mixed << String::repeatedString ("abcdefgh", r.nextInt (5)).substring (r.nextInt (8));
+                mixed << (juce_wchar) (0x80 + r.nextInt (0x2000));
+            }
+
+            const String ascii (String::repeatedString ("0123456789", 10));
+            const char* const utf8 = mixed.toUTF8();
+            const size_t numBytes = strlen (utf8);
+
+            expectEquals ((int) CharacterFunctions::getNumASCIIBytes (ascii.toUTF8(), 100), 100);
+            expect (CharacterFunctions::getNumASCIIBytes (utf8, numBytes) < numBytes);
+            expect (CharPointer_UTF8::isValidString (utf8, (int) numBytes));
+            expect (! CharPointer_UTF8::isValidString ("abcdefghijklmnop\xc0", 17));
+            expectEquals ((int) CharPointer_UTF8 (utf8).length(), mixed.length());
+
+            expectEquals (String (CharPointer_UTF8 (utf8)), mixed);
+            expectEquals (String (CharPointer_UTF8 (utf8), 37), mixed.substring (0, 37));
+            expectEquals (String (ascii.toUTF8(), 37), ascii.substring (0, 37));
+            expectEquals (String (ascii.toUTF8(), 1000), ascii);
+
+            expectEquals (String (mixed.toUTF16()), mixed);
+            expectEquals (String (mixed.toUTF32()), mixed);
+            expectEquals ((int) CharPointer_UTF8::getBytesRequiredFor (mixed.toUTF32()), (int) numBytes);
+            expectEquals ((int) CharPointer_UTF16::getBytesRequiredFor (mixed.toUTF8()),
+                          (int) (sizeof (CharPointer_UTF16::CharType) * (size_t) mixed.length()));
+
+            const char* const text = "abcdefghijklmnop\"qrst\\";
+            expect (CharacterFunctions::findFirstOf (text, '"', '\\') == text + 16);
+            expect (CharacterFunctions::findFirstOf (text, 'x', 'y') == text + strlen (text));
+        }
+
+        {
+            beginTest ("Strings in a MemoryArena");
+
+            String copy;
+
+            {
+                MemoryArena arena;
+                const String original ("arena text");
+                const String s1 (arena, original);
+                const String s2 (arena, s1);
+
+                expect (s1 == original && s2 == original);
+                expect (s1.getCharPointer().getAddress() != original.getCharPointer().getAddress());
+                expect (s2.getCharPointer().getAddress() == s1.getCharPointer().getAddress());
+                expect (arena.getNumBytesUsed() > 0);
+
+                copy = s1;
+                expect (copy == original && copy.getCharPointer().getAddress() != s1.getCharPointer().getAddress());
+
+                String appended (s2);
+                appended << " and more";
+                expect (appended == "arena text and more" && s2 == original);
+
+                expect (String (arena, String::empty).isEmpty());
+            }
+
+            expect (copy == "arena text");
+        }
+
         {
             beginTest ("StringArray");
 
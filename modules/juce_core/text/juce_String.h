@@ -38,16 +38,17 @@
 #endif
 
 #include "../memory/juce_Atomic.h"
-#include "juce_CharPointer_UTF8.h"
 #include "juce_CharPointer_UTF16.h"
 #include "juce_CharPointer_UTF32.h"
 #include "juce_CharPointer_ASCII.h"
+#include "juce_CharPointer_UTF8.h"  // (must come after the others, as it adds fast conversions to them)
 
 #if JUCE_MSVC
  #pragma warning (pop)
 #endif
 
 class OutputStream;
+class MemoryArena;
 
 //==============================================================================
 /**
@@ -192,6 +193,28 @@ public:
     #error "You must set the value of JUCE_STRING_UTF_TYPE to be either 8, 16, or 32!"
    #endif
 
+    //==============================================================================
+    /** Creates a string whose text is stored in a MemoryArena, rather than in its own
+        block of heap memory.
+
+        This is for building very large numbers of strings which will all be thrown away
+        together (see CompactXmlTree), as the arena can free them all at once.
+
+        Copying the string (or assigning it to another String) makes a normal heap-allocated
+        copy, so copies can safely outlive the arena. But this String object itself, and any
+        raw pointers to its characters, mustn't be used or destroyed after the arena has been
+        reset or deleted.
+
+        If textToCopy was itself created in an arena, its text is shared rather than copied
+        again, so the result must be treated as belonging to that arena.
+    */
+    String (MemoryArena& arena, const String& textToCopy);
+
+    /** Creates a string whose text is stored in a MemoryArena.
+        @see String (MemoryArena&, const String&)
+    */
+    String (MemoryArena& arena, CharPointerType start, CharPointerType end);
+
     //==============================================================================
     /** Generates a probably-unique 32-bit hashcode from this string. */
     int hashCode() const noexcept;
@@ -214,6 +237,12 @@ public:
 
     /** Appends another string at the end of this one. */
     String& operator+= (const String& stringToAppend);
+   #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+    /** Appends another string at the end of this one.
+        If this string is empty, it simply takes over the other string's buffer.
+    */
+    String& operator+= (String&& stringToAppend);
+   #endif
     /** Appends another string at the end of this one. */
     String& operator+= (const char* textToAppend);
     /** Appends another string at the end of this one. */
@@ -259,7 +288,7 @@ public:
             {
                 const size_t byteOffsetOfNull = getByteOffsetOfEnd();
 
-                preallocateBytes (byteOffsetOfNull + extraBytesNeeded);
+                preallocateBytesForAppending (byteOffsetOfNull + extraBytesNeeded);
                 CharPointerType (addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull)).writeWithCharLimit (textToAppend, (int) (numChars + 1));
             }
         }
@@ -280,7 +309,7 @@ public:
             {
                 const size_t byteOffsetOfNull = getByteOffsetOfEnd();
 
-                preallocateBytes (byteOffsetOfNull + extraBytesNeeded);
+                preallocateBytesForAppending (byteOffsetOfNull + extraBytesNeeded);
                 CharPointerType (addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull)).writeAll (textToAppend);
             }
         }
@@ -1191,6 +1220,11 @@ public:
     */
     void swapWith (String& other) noexcept;
 
+    /** Returns the number of String objects which are currently sharing the same
+        internal data as this one.
+    */
+    int getReferenceCount() const noexcept;
+
     //==============================================================================
    #if JUCE_MAC || JUCE_IOS || DOXYGEN
     /** MAC ONLY - Creates a String from an OSX CFString. */
@@ -1220,6 +1254,7 @@ private:
 
     explicit String (const PreallocationBytes&); // This constructor preallocates a certain amount of memory
     void appendFixedLength (const char* text, int numExtraChars);
+    void preallocateBytesForAppending (size_t numBytesNeeded);
     size_t getByteOffsetOfEnd() const noexcept;
     JUCE_DEPRECATED (String (const String& stringToCopy, size_t charsToAllocate));
 
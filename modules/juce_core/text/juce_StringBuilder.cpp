@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+StringBuilder::StringBuilder() noexcept
+    : numBytesUsed (0), numBytesAllocated (0)
+{
+}
+
+StringBuilder::StringBuilder (const String& initialText)
+    : text (initialText),
+      numBytesUsed (initialText.getCharPointer().sizeInBytes() - sizeof (String::CharPointerType::CharType)),
+      numBytesAllocated (0)
+{
+}
+
+StringBuilder::~StringBuilder()
+{
+}
+
+void StringBuilder::reserve (const size_t numBytesNeeded)
+{
+    if (numBytesNeeded > numBytesAllocated)
+    {
+        numBytesAllocated = numBytesNeeded;
+        text.preallocateBytes (numBytesAllocated);
+    }
+}
+
+void StringBuilder::clear() noexcept
+{
+    text = String::empty;
+    numBytesUsed = 0;
+    numBytesAllocated = 0;
+}
+
+String::CharPointerType::CharType* StringBuilder::prepareToAppend (const size_t numExtraBytes)
+{
+    const size_t numBytesNeeded = numBytesUsed + numExtraBytes;
+
+    if (numBytesNeeded > numBytesAllocated)
+        numBytesAllocated = jmax (numBytesNeeded, numBytesAllocated + numBytesAllocated / 2, (size_t) 64);
+
+    // If a String returned by toString() is still sharing our buffer, this gives us a
+    // private copy of it before we write to it.
+    text.preallocateBytes (numBytesAllocated);
+
+    String::CharPointerType::CharType* const end = addBytesToPointer (text.getCharPointer().getAddress(), (int) numBytesUsed);
+    numBytesUsed = numBytesNeeded;
+    return end;
+}
+
+//==============================================================================
+StringBuilder& StringBuilder::operator<< (const String& s)      { return appendCharPointer (s.getCharPointer()); }
+StringBuilder& StringBuilder::operator<< (const wchar_t* t)     { return appendCharPointer (castToCharPointer_wchar_t (t)); }
+
+StringBuilder& StringBuilder::operator<< (const char* t)
+{
+    // (see the String class's const char* constructor for why this must be ascii)
+    jassert (t == nullptr || CharPointer_ASCII::isValidString (t, std::numeric_limits<int>::max()));
+
+    return appendCharPointer (CharPointer_ASCII (t));
+}
+
+StringBuilder& StringBuilder::operator<< (const char c)
+{
+    const char asString[] = { c, 0 };
+    return operator<< (asString);
+}
+
+StringBuilder& StringBuilder::operator<< (const wchar_t c)
+{
+    const wchar_t asString[] = { c, 0 };
+    return operator<< (asString);
+}
+
+StringBuilder& StringBuilder::operator<< (const int number)
+{
+    char buffer [16];
+    return appendCharPointer (CharPointer_ASCII (NumberToStringConverters::numberToString (buffer + numElementsInArray (buffer), number)));
+}
+
+StringBuilder& StringBuilder::operator<< (const int64 number)
+{
+    char buffer [32];
+    return appendCharPointer (CharPointer_ASCII (NumberToStringConverters::numberToString (buffer + numElementsInArray (buffer), number)));
+}
+
+StringBuilder& StringBuilder::operator<< (const double number)
+{
+    return operator<< (String (number));
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringBuilderTests  : public UnitTest
+{
+public:
+    StringBuilderTests() : UnitTest ("StringBuilder") {}
+
+    static String getPiece (const int i)
+    {
+        return "item" + String (i % 97);
+    }
+
+    void runTest()
+    {
+        {
+            beginTest ("Appending");
+
+            StringBuilder sb;
+            expect (sb.isEmpty() && sb.toString().isEmpty());
+
+            sb << "abc" << String ("def") << L"ghi" << 'j' << (wchar_t) 'k' << 123 << (int64) -45 << 1.5;
+            expectEquals (sb.toString(), String ("abcdefghijk123-451.5"));
+            expectEquals ((int) sb.getNumBytesUsed(), (int) sb.toString().getCharPointer().sizeInBytes() - (int) sizeof (String::CharPointerType::CharType));
+
+            sb << String (CharPointer_UTF8 ("\xc3\xa9"));
+            expectEquals (sb.toString().length(), 21);
+            expect (sb.toString().endsWith (String (CharPointer_UTF8 ("5\xc3\xa9"))));
+
+            sb.clear();
+            expect (sb.isEmpty() && sb.toString().isEmpty());
+
+            StringBuilder sb2 ("start");
+            sb2.reserve (1000);
+            sb2 << "-end";
+            expectEquals (sb2.toString(), String ("start-end"));
+        }
+
+        {
+            beginTest ("Sharing");
+
+            StringBuilder sb;
+            sb << "first";
+            const String copy (sb.toString());
+            sb << "second";
+
+            expectEquals (copy, String ("first"));
+            expectEquals (sb.toString(), String ("firstsecond"));
+        }
+
+        {
+            beginTest ("String concatenation");
+
+            String s, t;
+            StringBuilder sb;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                s += getPiece (i);
+                t = t + getPiece (i);
+                sb << getPiece (i);
+            }
+
+            expectEquals (s, sb.toString());
+            expectEquals (t, sb.toString());
+
+            String empty;
+            empty += String ("moved");
+            expectEquals (empty, String ("moved"));
+            empty += String ("!");
+            expectEquals (empty, String ("moved!"));
+        }
+
+        {
+            beginTest ("Benchmark");
+
+            const int numPieces = 100000;
+            StringArray pieces;
+
+            for (int i = 0; i < numPieces; ++i)
+                pieces.add (getPiece (i));
+
+            double start = Time::getMillisecondCounterHiRes();
+            String appended;
+
+            for (int i = 0; i < numPieces; ++i)
+                appended += pieces[i];
+
+            const double appendTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            String concatenated;
+
+            for (int i = 0; i < numPieces / 10; ++i)
+                concatenated = concatenated + pieces[i];
+
+            const double concatenateTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            StringBuilder sb;
+
+            for (int i = 0; i < numPieces; ++i)
+                sb << pieces[i];
+
+            const double builderTime = Time::getMillisecondCounterHiRes() - start;
+
+            expectEquals (sb.toString(), appended);
+            expect (appended.startsWith (concatenated));
+
+            logMessage ("Building from " + String (numPieces) + " pieces: String += "
+                          + String (appendTime, 2) + " ms, StringBuilder " + String (builderTime, 2)
+                          + " ms; " + String (numPieces / 10) + " pieces with s = s + x: " + String (concatenateTime, 2) + " ms");
+        }
+    }
+};
+
+static StringBuilderTests stringBuilderTests;
+
+#endif
@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_STRINGBUILDER_JUCEHEADER__
+#define __JUCE_STRINGBUILDER_JUCEHEADER__
+
+#include "juce_String.h"
+
+
+//==============================================================================
+/**
+    Builds up a String from a large number of smaller pieces.
+
+    Appending to a String with += has to scan for the end of the existing text each
+    time, so building a long string one piece at a time costs O (n^2) character reads.
+    A StringBuilder keeps track of where its text ends, and grows its buffer
+    geometrically, so appending is amortised O (1) per character appended.
+
+    @code
+    StringBuilder sb;
+    sb.reserve (1024);
+
+    for (int i = 0; i < items.size(); ++i)
+        sb << items[i].getName() << " = " << items[i].getValue() << newLine;
+
+    const String result (sb.toString());
+    @endcode
+
+    The String returned by toString() shares the builder's buffer, so it can be
+    retrieved without copying. If the builder is appended to again while another
+    String still refers to that buffer, the text will be copied first.
+
+    @see String, MemoryOutputStream
+*/
+class JUCE_API  StringBuilder
+{
+public:
+    //==============================================================================
+    /** Creates an empty builder. */
+    StringBuilder() noexcept;
+
+    /** Creates a builder which starts with some initial text. */
+    explicit StringBuilder (const String& initialText);
+
+    /** Destructor. */
+    ~StringBuilder();
+
+    //==============================================================================
+    /** Makes sure there's enough space allocated to hold a total of the given number of
+        bytes of text (in the String::CharPointerType encoding, excluding the terminator).
+        If the buffer is already big enough, this does nothing.
+    */
+    void reserve (size_t numBytesNeeded);
+
+    /** Empties the builder and releases its buffer. */
+    void clear() noexcept;
+
+    /** Returns true if nothing has been appended. */
+    bool isEmpty() const noexcept                       { return numBytesUsed == 0; }
+
+    /** Returns the number of bytes of text that have been appended so far (not
+        including the null terminator).
+    */
+    size_t getNumBytesUsed() const noexcept             { return numBytesUsed; }
+
+    /** Returns the text that has been built up. */
+    const String& toString() const noexcept             { return text; }
+
+    //==============================================================================
+    /** Appends a string. */
+    StringBuilder& operator<< (const String& textToAppend);
+    /** Appends a string. */
+    StringBuilder& operator<< (const char* textToAppend);
+    /** Appends a string. */
+    StringBuilder& operator<< (const wchar_t* textToAppend);
+    /** Appends a character. */
+    StringBuilder& operator<< (char characterToAppend);
+    /** Appends a character. */
+    StringBuilder& operator<< (wchar_t characterToAppend);
+    /** Appends a decimal number. */
+    StringBuilder& operator<< (int number);
+    /** Appends a decimal number. */
+    StringBuilder& operator<< (int64 number);
+    /** Appends a decimal number. */
+    StringBuilder& operator<< (double number);
+
+    /** Appends some text from any kind of character pointer. */
+    template <class CharPointer>
+    StringBuilder& appendCharPointer (const CharPointer textToAppend)
+    {
+        if (textToAppend.getAddress() != nullptr)
+        {
+            const size_t extraBytesNeeded = String::CharPointerType::getBytesRequiredFor (textToAppend);
+
+            if (extraBytesNeeded > 0)
+                String::CharPointerType (prepareToAppend (extraBytesNeeded)).writeAll (textToAppend);
+        }
+
+        return *this;
+    }
+
+private:
+    //==============================================================================
+    String text;
+    size_t numBytesUsed, numBytesAllocated;
+
+    String::CharPointerType::CharType* prepareToAppend (size_t numExtraBytes);
+
+    JUCE_LEAK_DETECTOR (StringBuilder)
+};
+
+
+#endif   // __JUCE_STRINGBUILDER_JUCEHEADER__
@@ -23,89 +23,367 @@
   ==============================================================================
 */
 
-StringPool::StringPool() noexcept   {}
-StringPool::~StringPool()           {}
+struct StringPool::Entry
+{
+    Entry (const String& s, const uint32 hash_)  : string (s), hash (hash_) {}
+
+    const String string;
+    const uint32 hash;
+    Atomic<Entry*> next;
+
+    JUCE_DECLARE_NON_COPYABLE (Entry)
+};
 
-namespace StringPoolHelpers
+//==============================================================================
+/*  Each shard is a fixed-size hash table. Readers walk the lists without a lock, but
+    count themselves in and out, so that garbageCollect() can wait until nobody can still
+    be looking at the entries it has unlinked before deleting them.
+*/
+struct StringPool::Shard
 {
-    template <class StringType>
-    String::CharPointerType getPooledStringFromArray (Array<String>& strings,
-                                                      StringType newString,
-                                                      const CriticalSection& lock)
-    {
-        const ScopedLock sl (lock);
-        int start = 0;
-        int end = strings.size();
+    Shard() : numStrings (0), numAdded (0), numCollected (0) {}
 
-        for (;;)
+    ~Shard()
+    {
+        for (int i = 0; i < numBuckets; ++i)
         {
-            if (start >= end)
+            for (Entry* e = buckets[i].get(); e != nullptr;)
             {
-                jassert (start <= end);
-                strings.insert (start, newString);
-                return strings.getReference (start).getCharPointer();
+                Entry* const next = e->next.get();
+                delete e;
+                e = next;
             }
-            else
+        }
+    }
+
+    enum { numBuckets = 64 };
+
+    Atomic<Entry*> buckets [numBuckets];
+    Atomic<int> numReaders, numStrings;
+    int64 numAdded, numCollected;
+    CriticalSection lock;
+
+    Atomic<Entry*>& getBucket (const uint32 hash) noexcept      { return buckets [hash & (numBuckets - 1)]; }
+
+    template <typename CharPointer>
+    String find (const CharPointer name, const uint32 hash) noexcept
+    {
+        String result;
+        ++numReaders;
+
+        for (Entry* e = getBucket (hash).get(); e != nullptr; e = e->next.get())
+        {
+            if (e->hash == hash && CharacterFunctions::compare (e->string.getCharPointer(), name) == 0)
             {
-                const String& startString = strings.getReference (start);
+                result = e->string;
+                break;
+            }
+        }
+
+        --numReaders;
+        return result;
+    }
 
-                if (startString == newString)
-                    return startString.getCharPointer();
+    template <typename CharPointer>
+    String add (const CharPointer name, const String& original, const uint32 hash)
+    {
+        const ScopedLock sl (lock);
 
-                const int halfway = (start + end) >> 1;
+        // another thread may have added it since we last looked..
+        const String existing (find (name, hash));
 
-                if (halfway == start)
-                {
-                    if (startString.compare (newString) < 0)
-                        ++start;
+        if (existing.isNotEmpty())
+            return existing;
 
-                    strings.insert (start, newString);
-                    return strings.getReference (start).getCharPointer();
-                }
+        Entry* const e = new Entry (original.isNotEmpty() ? original : String (name), hash);
+        link (e);
+        ++numStrings;
+        ++numAdded;
+        return e->string;
+    }
+
+    void link (Entry* const e) noexcept
+    {
+        Atomic<Entry*>& bucket = getBucket (e->hash);
+        e->next = bucket.get();
+        bucket = e;
+    }
 
-                const int comp = strings.getReference (halfway).compare (newString);
+    void garbageCollect()
+    {
+        const ScopedLock sl (lock);
+        Array<Entry*> unlinked;
+
+        for (int i = 0; i < numBuckets; ++i)
+        {
+            Atomic<Entry*>* previous = buckets + i;
 
-                if (comp == 0)
-                    return strings.getReference (halfway).getCharPointer();
-                else if (comp < 0)
-                    start = halfway;
+            for (Entry* e = previous->get(); e != nullptr; e = e->next.get())
+            {
+                if (e->string.getReferenceCount() == 1)
+                {
+                    // (the entry's own next pointer is left intact for any readers that are on it)
+                    *previous = e->next.get();
+                    unlinked.add (e);
+                }
                 else
-                    end = halfway;
+                {
+                    previous = &(e->next);
+                }
+            }
+        }
+
+        if (unlinked.size() == 0)
+            return;
+
+        while (numReaders.get() != 0)
+            Thread::yield();
+
+        // Now nobody can reach the unlinked entries, but a reader may have taken a copy of
+        // one just before it went, in which case it has to go back in.
+        for (int i = 0; i < unlinked.size(); ++i)
+        {
+            Entry* const e = unlinked.getUnchecked (i);
+
+            if (e->string.getReferenceCount() == 1)
+            {
+                delete e;
+                --numStrings;
+                ++numCollected;
+            }
+            else
+            {
+                link (e);
             }
         }
     }
+
+    JUCE_DECLARE_NON_COPYABLE (Shard)
+};
+
+//==============================================================================
+StringPool::StringPool()
+{
+    for (int i = 0; i < 32; ++i)
+        shards.add (new Shard());
+}
+
+StringPool::~StringPool() {}
+
+template <typename CharPointer>
+String StringPool::getPooledStringFor (const CharPointer name, const String& original)
+{
+    uint32 hash = 2166136261u;
+
+    for (CharPointer t (name); ! t.isEmpty();)
+        hash = (hash ^ (uint32) t.getAndAdvance()) * 16777619u;
+
+    // (the top bits pick the shard, and the bottom ones the bucket within it)
+    Shard& shard = *shards.getUnchecked ((int) (hash >> 27));
+    const String existing (shard.find (name, hash));
+
+    return existing.isNotEmpty() ? existing
+                                 : shard.add (name, original, hash);
 }
 
-String::CharPointerType StringPool::getPooledString (const String& s)
+String StringPool::getPooledString (const String& s)
 {
     if (s.isEmpty())
-        return String::empty.getCharPointer();
+        return String::empty;
 
-    return StringPoolHelpers::getPooledStringFromArray (strings, s, lock);
+    return getPooledStringFor (s.getCharPointer(), s);
 }
 
-String::CharPointerType StringPool::getPooledString (const char* const s)
+String StringPool::getPooledString (const char* const s)
 {
     if (s == nullptr || *s == 0)
-        return String::empty.getCharPointer();
+        return String::empty;
 
-    return StringPoolHelpers::getPooledStringFromArray (strings, s, lock);
+    return getPooledStringFor (CharPointer_ASCII (s), String::empty);
 }
 
-String::CharPointerType StringPool::getPooledString (const wchar_t* const s)
+String StringPool::getPooledString (const wchar_t* const s)
 {
     if (s == nullptr || *s == 0)
-        return String::empty.getCharPointer();
+        return String::empty;
 
-    return StringPoolHelpers::getPooledStringFromArray (strings, s, lock);
+    return getPooledStringFor (CharPointer_wchar_t (s), String::empty);
 }
 
 int StringPool::size() const noexcept
 {
-    return strings.size();
+    int total = 0;
+
+    for (int i = 0; i < shards.size(); ++i)
+        total += shards.getUnchecked(i)->numStrings.get();
+
+    return total;
 }
 
-String::CharPointerType StringPool::operator[] (const int index) const noexcept
+String StringPool::operator[] (int index) const
 {
-    return strings [index].getCharPointer();
+    String result;
+
+    for (int i = 0; i < shards.size() && result.isEmpty() && index >= 0; ++i)
+    {
+        Shard& shard = *shards.getUnchecked(i);
+        ++shard.numReaders;
+
+        for (int j = 0; j < Shard::numBuckets && result.isEmpty(); ++j)
+        {
+            for (Entry* e = shard.buckets[j].get(); e != nullptr; e = e->next.get())
+            {
+                if (--index < 0)
+                {
+                    result = e->string;
+                    break;
+                }
+            }
+        }
+
+        --shard.numReaders;
+    }
+
+    return result;
+}
+
+void StringPool::garbageCollect()
+{
+    for (int i = 0; i < shards.size(); ++i)
+        shards.getUnchecked(i)->garbageCollect();
+}
+
+StringPool::Statistics StringPool::getStatistics() const
+{
+    Statistics stats = { 0, 0, shards.size() * (int) Shard::numBuckets, 0, 0, 0 };
+
+    for (int i = 0; i < shards.size(); ++i)
+    {
+        Shard& shard = *shards.getUnchecked(i);
+
+        {
+            const ScopedLock sl (shard.lock);
+            stats.numAdded += shard.numAdded;
+            stats.numCollected += shard.numCollected;
+        }
+
+        ++shard.numReaders;
+
+        for (int j = 0; j < Shard::numBuckets; ++j)
+        {
+            int chainLength = 0;
+
+            for (Entry* e = shard.buckets[j].get(); e != nullptr; e = e->next.get())
+            {
+                ++chainLength;
+                stats.numBytes += e->string.getCharPointer().sizeInBytes();
+            }
+
+            stats.numStrings += chainLength;
+            stats.longestChain = jmax (stats.longestChain, chainLength);
+        }
+
+        --shard.numReaders;
+    }
+
+    return stats;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringPoolTests  : public UnitTest
+{
+public:
+    StringPoolTests() : UnitTest ("StringPool") {}
+
+    class InternThread  : public Thread
+    {
+    public:
+        InternThread (StringPool& pool_, int seed_)
+            : Thread ("string pool"), pool (pool_), seed (seed_), allMatched (true) {}
+
+        void run()
+        {
+            Random r (seed);
+
+            for (int i = 0; i < 20000; ++i)
+            {
+                const String name ("name" + String (r.nextInt (1000)));
+                const String pooled (pool.getPooledString (name));
+                allMatched = allMatched && pooled == name;
+
+                if ((i & 1023) == 0)
+                    pool.garbageCollect();
+            }
+        }
+
+        StringPool& pool;
+        const int seed;
+        bool allMatched;
+    };
+
+    static const void* address (const String& s) noexcept    { return s.getCharPointer().getAddress(); }
+
+    void runTest()
+    {
+        beginTest ("Pooling");
+
+        StringPool pool;
+        const String a (pool.getPooledString ("abc"));
+        const String b (pool.getPooledString (String ("ab") + "c"));
+        const String c (pool.getPooledString (L"abc"));
+        const String d (pool.getPooledString ("abd"));
+
+        expect (address (a) == address (b) && address (a) == address (c));
+        expect (address (a) != address (d));
+        expectEquals (a, String ("abc"));
+        expectEquals (pool.size(), 2);
+        expect (pool.getPooledString (String::empty).isEmpty());
+        expect (pool[0] == "abc" || pool[0] == "abd");
+        expect (pool[2].isEmpty());
+
+        beginTest ("Garbage collection");
+
+        expectEquals (pool.getPooledString ("temporary"), String ("temporary"));
+        expectEquals (pool.size(), 3);
+
+        pool.garbageCollect();
+        expectEquals (pool.size(), 2);
+        expect (address (pool.getPooledString ("abc")) == address (a));
+        expect (address (pool.getPooledString ("abd")) == address (d));
+
+        StringPool::Statistics stats (pool.getStatistics());
+        expectEquals (stats.numStrings, 2);
+        expectEquals ((int) stats.numAdded, 3);
+        expectEquals ((int) stats.numCollected, 1);
+        expect (stats.longestChain >= 1 && stats.numBuckets > 0 && stats.numBytes > 0);
+
+        beginTest ("Concurrent interning");
+
+        StringPool sharedPool;
+        OwnedArray<InternThread> threads;
+
+        for (int i = 0; i < 4; ++i)
+            threads.add (new InternThread (sharedPool, i + 1));
+
+        for (int i = 0; i < threads.size(); ++i)
+            threads.getUnchecked(i)->startThread();
+
+        const String kept (sharedPool.getPooledString ("name1"));
+
+        for (int i = 0; i < threads.size(); ++i)
+        {
+            threads.getUnchecked(i)->waitForThreadToExit (-1);
+            expect (threads.getUnchecked(i)->allMatched);
+        }
+
+        expect (address (sharedPool.getPooledString ("name1")) == address (kept));
+        expect (sharedPool.size() <= 1000);
+        expectEquals (sharedPool.getStatistics().numStrings, sharedPool.size());
+    }
+};
+
+static StringPoolTests stringPoolTests;
+
+#endif
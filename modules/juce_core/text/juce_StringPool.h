@@ -27,7 +27,7 @@
 #define __JUCE_STRINGPOOL_JUCEHEADER__
 
 #include "juce_String.h"
-#include "../containers/juce_Array.h"
+#include "../containers/juce_OwnedArray.h"
 
 
 //==============================================================================
@@ -35,57 +35,99 @@
     A StringPool holds a set of shared strings, which reduces storage overheads and improves
     comparison speed when dealing with many duplicate strings.
 
-    When you add a string to a pool using getPooledString, it'll return a character
-    array containing the same string. This array is owned by the pool, and the same array
-    is returned every time a matching string is asked for. This means that it's trivial to
-    compare two pooled strings for equality, as you can simply compare their pointers. It
+    When you add a string to a pool using getPooledString, it'll return a String which
+    shares its data with the pool's copy of that string, and the same data is returned
+    every time a matching string is asked for. This means that it's trivial to compare two
+    pooled strings for equality, as you can simply compare their character pointers. It
     also cuts down on storage if you're using many copies of the same string.
+
+    The pool is split into a number of independently-locked shards, chosen by each
+    string's hash. Looking up a string that's already in the pool never takes a lock,
+    and adding a new one only locks the shard that it belongs to, so many threads can
+    use the same pool at once without getting in each other's way.
+
+    Strings stay in the pool until it's deleted, unless you call garbageCollect(), which
+    removes any that are no longer being used outside the pool.
 */
 class JUCE_API  StringPool
 {
 public:
     //==============================================================================
     /** Creates an empty pool. */
-    StringPool() noexcept;
+    StringPool();
 
     /** Destructor */
     ~StringPool();
 
     //==============================================================================
-    /** Returns a pointer to a copy of the string that is passed in.
+    /** Returns a pooled copy of the string that is passed in.
 
-        The pool will always return the same pointer when asked for a string that matches it.
-        The pool will own all the pointers that it returns, deleting them when the pool itself
-        is deleted.
+        The pool will always return a string sharing the same character data when asked
+        for a string that matches it.
     */
-    String::CharPointerType getPooledString (const String& original);
+    String getPooledString (const String& original);
 
-    /** Returns a pointer to a copy of the string that is passed in.
+    /** Returns a pooled copy of the string that is passed in.
 
-        The pool will always return the same pointer when asked for a string that matches it.
-        The pool will own all the pointers that it returns, deleting them when the pool itself
-        is deleted.
+        The pool will always return a string sharing the same character data when asked
+        for a string that matches it.
     */
-    String::CharPointerType getPooledString (const char* original);
+    String getPooledString (const char* original);
 
-    /** Returns a pointer to a copy of the string that is passed in.
+    /** Returns a pooled copy of the string that is passed in.
 
-        The pool will always return the same pointer when asked for a string that matches it.
-        The pool will own all the pointers that it returns, deleting them when the pool itself
-        is deleted.
+        The pool will always return a string sharing the same character data when asked
+        for a string that matches it.
     */
-    String::CharPointerType getPooledString (const wchar_t* original);
+    String getPooledString (const wchar_t* original);
 
     //==============================================================================
     /** Returns the number of strings in the pool. */
     int size() const noexcept;
 
-    /** Returns one of the strings in the pool, by index. */
-    String::CharPointerType operator[] (int index) const noexcept;
+    /** Returns one of the strings in the pool, by index.
+
+        The strings aren't kept in any particular order, and this has to search through
+        the pool, so it's only intended for occasional use on small pools.
+    */
+    String operator[] (int index) const;
+
+    //==============================================================================
+    /** Removes any strings that aren't currently being used outside the pool.
+
+        Any strings that are still referenced by a String object elsewhere are kept,
+        so that they'll continue to be matched by subsequent calls to getPooledString().
+        Each shard is locked while it's being cleaned up, and this may briefly wait for
+        any lookups that are still in progress on it.
+    */
+    void garbageCollect();
+
+    /** Some figures describing the state of a pool.
+        @see getStatistics
+    */
+    struct Statistics
+    {
+        int numStrings;             /**< The number of strings currently in the pool. */
+        size_t numBytes;            /**< The total size of the pooled strings' character data. */
+        int numBuckets;             /**< The number of hash buckets that the strings are spread across. */
+        int longestChain;           /**< The largest number of strings that share a single bucket. */
+        int64 numAdded;             /**< The number of strings that have been added since the pool was created. */
+        int64 numCollected;         /**< The number of strings that garbageCollect() has removed. */
+    };
+
+    /** Returns some figures describing the pool's contents and usage. */
+    Statistics getStatistics() const;
 
 private:
-    Array <String> strings;
-    CriticalSection lock;
+    //==============================================================================
+    struct Entry;
+    struct Shard;
+    OwnedArray<Shard> shards;
+
+    template <typename CharPointer>
+    String getPooledStringFor (CharPointer, const String& original);
+
+    JUCE_DECLARE_NON_COPYABLE (StringPool)
 };
 
 
@@ -25,134 +25,310 @@
 
 struct TextDiffHelpers
 {
-    enum { minLengthToMatch = 3 };
-
-    struct StringRegion
+    /*  The diff is done with Myers' O(ND) algorithm, using the linear-space divide-and-conquer
+        version. Large texts are first compared line-by-line using hashes of the lines, and then
+        each block of changed lines is compared character-by-character. In the worst cases (e.g.
+        two completely different texts), the amount of searching is limited, and anything that
+        would take too long to match up is just treated as a deletion followed by an insertion.
+    */
+    enum
     {
-        StringRegion (const String& s) noexcept
-            : text (s.getCharPointer()), start (0), length (s.length()) {}
-
-        StringRegion (const String::CharPointerType& t, int s, int len)  noexcept
-            : text (t), start (s), length (len) {}
+        minLengthForLineDiff = 4096,
+        maxSearchCost = 1 << 24
+    };
 
-        String::CharPointerType text;
-        int start, length;
+    struct CommonRun
+    {
+        int startA, startB, length;
     };
 
-    static void addInsertion (TextDiff& td, const String::CharPointerType& text, int index, int length)
+    typedef Array<CommonRun> CommonRuns;
+
+    static void addCommonRun (CommonRuns& runs, const int startA, const int startB, const int length)
     {
-        TextDiff::Change c;
-        c.insertedText = String (text, (size_t) length);
-        c.start = index;
-        c.length = length;
-        td.changes.add (c);
+        if (length > 0)
+        {
+            if (runs.size() > 0)
+            {
+                CommonRun& last = runs.getReference (runs.size() - 1);
+
+                if (last.startA + last.length == startA && last.startB + last.length == startB)
+                {
+                    last.length += length;
+                    return;
+                }
+            }
+
+            const CommonRun r = { startA, startB, length };
+            runs.add (r);
+        }
     }
 
-    static void addDeletion (TextDiff& td, int index, int length)
+    //==============================================================================
+    struct CharacterSequences
     {
-        TextDiff::Change c;
-        c.start = index;
-        c.length = length;
-        td.changes.add (c);
-    }
+        CharacterSequences (const juce_wchar* a_, const juce_wchar* b_) noexcept  : a (a_), b (b_) {}
+
+        bool areEqual (const int indexA, const int indexB) const noexcept   { return a[indexA] == b[indexB]; }
+
+        void addCommonRun (CommonRuns& runs, int startA, int startB, int length) const
+        {
+            TextDiffHelpers::addCommonRun (runs, startA, startB, length);
+        }
+
+        const juce_wchar* const a;
+        const juce_wchar* const b;
+    };
+
+    struct Line
+    {
+        int start, length;
+        uint32 hash;
+    };
 
-    static void diffSkippingCommonStart (TextDiff& td, const StringRegion& a, const StringRegion& b)
+    static void splitIntoLines (const juce_wchar* const text, const int length, Array<Line>& lines)
     {
-        String::CharPointerType sa (a.text);
-        String::CharPointerType sb (b.text);
-        const int maxLen = jmax (a.length, b.length);
+        int lineStart = 0;
+        uint32 hash = 0;
 
-        for (int i = 0; i < maxLen; ++i, ++sa, ++sb)
+        for (int i = 0; i < length; ++i)
         {
-            if (*sa != *sb)
+            hash = hash * 31 + (uint32) text[i];
+
+            if (text[i] == '\n' || i == length - 1)
             {
-                diffRecursively (td, StringRegion (sa, a.start + i, a.length - i),
-                                     StringRegion (sb, b.start + i, b.length - i));
-                break;
+                const Line line = { lineStart, i + 1 - lineStart, hash };
+                lines.add (line);
+                lineStart = i + 1;
+                hash = 0;
             }
         }
     }
 
-    static void diffRecursively (TextDiff& td, const StringRegion& a, const StringRegion& b)
+    struct LineSequences
     {
-        int indexA, indexB;
-        const int len = findLongestCommonSubstring (a.text, a.length,
-                                                    b.text, b.length,
-                                                    indexA, indexB);
+        LineSequences (const juce_wchar* a_, const juce_wchar* b_) noexcept  : a (a_), b (b_) {}
 
-        if (len >= minLengthToMatch)
+        bool areEqual (const int indexA, const int indexB) const noexcept
         {
-            if (indexA > 0 && indexB > 0)
-                diffSkippingCommonStart (td, StringRegion (a.text, a.start, indexA),
-                                             StringRegion (b.text, b.start, indexB));
-            else if (indexA > 0)
-                addDeletion (td, b.start, indexA);
-            else if (indexB > 0)
-                addInsertion (td, b.text, b.start, indexB);
+            const Line& la = linesA.getReference (indexA);
+            const Line& lb = linesB.getReference (indexB);
 
-            diffRecursively (td, StringRegion (a.text + indexA + len, a.start + indexA + len, a.length - indexA - len),
-                                 StringRegion (b.text + indexB + len, b.start + indexB + len, b.length - indexB - len));
+            return la.hash == lb.hash && la.length == lb.length
+                     && memcmp (a + la.start, b + lb.start, sizeof (juce_wchar) * (size_t) la.length) == 0;
         }
-        else
+
+        void addCommonRun (CommonRuns& runs, int startA, int startB, int length) const
         {
-            if (a.length > 0)   addDeletion (td, b.start, a.length);
-            if (b.length > 0)   addInsertion (td, b.text, b.start, b.length);
+            if (length > 0)
+            {
+                const Line& lastA = linesA.getReference (startA + length - 1);
+
+                TextDiffHelpers::addCommonRun (runs, linesA.getReference (startA).start, linesB.getReference (startB).start,
+                                               lastA.start + lastA.length - linesA.getReference (startA).start);
+            }
         }
-    }
 
-    static int findLongestCommonSubstring (String::CharPointerType a, const int lenA,
-                                           const String::CharPointerType& b, const int lenB,
-                                           int& indexInA, int& indexInB)
+        const juce_wchar* const a;
+        const juce_wchar* const b;
+        Array<Line> linesA, linesB;
+    };
+
+    //==============================================================================
+    template <class Sequences>
+    static void diff (const Sequences& s, CommonRuns& runs, int startA, int endA, int startB, int endB)
     {
-        if (lenA == 0 || lenB == 0)
-            return 0;
+        // skip the common start and end..
+        const int prefixStart = startA;
+
+        while (startA < endA && startB < endB && s.areEqual (startA, startB))
+        {
+            ++startA;
+            ++startB;
+        }
 
-        HeapBlock<int> lines;
-        lines.calloc (2 + 2 * (size_t) lenB);
+        s.addCommonRun (runs, prefixStart, startB - (startA - prefixStart), startA - prefixStart);
 
-        int* l0 = lines;
-        int* l1 = l0 + lenB + 1;
+        const int suffixEnd = endA;
 
-        int bestLength = 0;
-        indexInA = indexInB = 0;
+        while (endA > startA && endB > startB && s.areEqual (endA - 1, endB - 1))
+        {
+            --endA;
+            --endB;
+        }
 
-        for (int i = 0; i < lenA; ++i)
+        if (startA < endA && startB < endB)
         {
-            const juce_wchar ca = a.getAndAdvance();
-            String::CharPointerType b2 (b);
+            int snakeStartA, snakeStartB, snakeEndA, snakeEndB;
+
+            if (findMiddleSnake (s, startA, endA, startB, endB, snakeStartA, snakeStartB, snakeEndA, snakeEndB))
+            {
+                diff (s, runs, startA, snakeStartA, startB, snakeStartB);
+                s.addCommonRun (runs, snakeStartA, snakeStartB, snakeEndA - snakeStartA);
+                diff (s, runs, snakeEndA, endA, snakeEndB, endB);
+            }
+        }
+
+        s.addCommonRun (runs, endA, endB, suffixEnd - endA);
+    }
+
+    template <class Sequences>
+    static bool findMiddleSnake (const Sequences& s, const int startA, const int endA, const int startB, const int endB,
+                                 int& snakeStartA, int& snakeStartB, int& snakeEndA, int& snakeEndB)
+    {
+        const int n = endA - startA;
+        const int m = endB - startB;
+        const int delta = n - m;
+        const bool deltaIsOdd = (delta & 1) != 0;
+        const int maxD = jmin ((n + m + 1) / 2, jmax (64, maxSearchCost / (n + m)));
+        const int offset = maxD + 1;
+
+        // forward[k] and backward[k] hold the furthest x reached on diagonal k, searching
+        // from the start and (in reversed coordinates) from the end.
+        HeapBlock<int> v ((size_t) (4 * maxD + 6));
+        int* const forward  = v + offset;
+        int* const backward = v + (2 * maxD + 3) + offset;
+        forward[1] = 0;
+        backward[1] = 0;
+
+        for (int d = 0; d <= maxD; ++d)
+        {
+            for (int k = -d; k <= d; k += 2)
+            {
+                int x = (k == -d || (k != d && forward[k - 1] < forward[k + 1])) ? forward[k + 1]
+                                                                                : forward[k - 1] + 1;
+                int y = x - k;
+                const int x0 = x, y0 = y;
+
+                while (x < n && y < m && s.areEqual (startA + x, startB + y))
+                {
+                    ++x;
+                    ++y;
+                }
+
+                forward[k] = x;
 
-            for (int j = 0; j < lenB; ++j)
+                if (deltaIsOdd && k >= delta - (d - 1) && k <= delta + (d - 1)
+                     && x + backward[delta - k] >= n)
+                {
+                    snakeStartA = startA + x0;  snakeStartB = startB + y0;
+                    snakeEndA   = startA + x;   snakeEndB   = startB + y;
+                    return true;
+                }
+            }
+
+            for (int k = -d; k <= d; k += 2)
             {
-                if (ca != b2.getAndAdvance())
+                int x = (k == -d || (k != d && backward[k - 1] < backward[k + 1])) ? backward[k + 1]
+                                                                                  : backward[k - 1] + 1;
+                int y = x - k;
+                const int x0 = x, y0 = y;
+
+                while (x < n && y < m && s.areEqual (endA - 1 - x, endB - 1 - y))
                 {
-                    l1[j + 1] = 0;
+                    ++x;
+                    ++y;
                 }
-                else
+
+                backward[k] = x;
+
+                if ((! deltaIsOdd) && delta - k >= -d && delta - k <= d
+                     && x + forward[delta - k] >= n)
                 {
-                    const int len = l0[j] + 1;
-                    l1[j + 1] = len;
-
-                    if (len > bestLength)
-                    {
-                        bestLength = len;
-                        indexInA = i;
-                        indexInB = j;
-                    }
+                    snakeStartA = endA - x;     snakeStartB = endB - y;
+                    snakeEndA   = endA - x0;    snakeEndB   = endB - y0;
+                    return true;
                 }
             }
+        }
+
+        return false; // too expensive - the caller will treat the whole region as changed
+    }
+
+    //==============================================================================
+    static void findCommonRuns (const juce_wchar* const a, const int lenA,
+                                const juce_wchar* const b, const int lenB,
+                                CommonRuns& runs)
+    {
+        const CharacterSequences chars (a, b);
+
+        if (lenA + lenB < minLengthForLineDiff)
+        {
+            diff (chars, runs, 0, lenA, 0, lenB);
+            return;
+        }
+
+        LineSequences lines (a, b);
+        splitIntoLines (a, lenA, lines.linesA);
+        splitIntoLines (b, lenB, lines.linesB);
+
+        CommonRuns lineRuns; // (these are character positions of the lines that match)
+        diff (lines, lineRuns, 0, lines.linesA.size(), 0, lines.linesB.size());
+
+        // now do a character diff on each region between the lines that matched
+        int endOfLastRunA = 0, endOfLastRunB = 0;
+
+        const CommonRun endOfText = { lenA, lenB, 0 };
+        lineRuns.add (endOfText);
+
+        for (int i = 0; i < lineRuns.size(); ++i)
+        {
+            const CommonRun& run = lineRuns.getReference (i);
+
+            diff (chars, runs, endOfLastRunA, run.startA, endOfLastRunB, run.startB);
+            addCommonRun (runs, run.startA, run.startB, run.length);
+
+            endOfLastRunA = run.startA + run.length;
+            endOfLastRunB = run.startB + run.length;
+        }
+    }
 
-            std::swap (l0, l1);
+    static void addChanges (TextDiff& td, const juce_wchar* const b,
+                            const int startA, const int endA, const int startB, const int endB)
+    {
+        // (the indexes are positions in the target, because the changes
+        // before this one will already have been applied)
+        if (endA > startA)
+        {
+            TextDiff::Change c;
+            c.start = startB;
+            c.length = endA - startA;
+            td.changes.add (c);
         }
 
-        indexInA -= bestLength - 1;
-        indexInB -= bestLength - 1;
-        return bestLength;
+        if (endB > startB)
+        {
+            TextDiff::Change c;
+            c.insertedText = String (CharPointer_UTF32 (b + startB), (size_t) (endB - startB));
+            c.start = startB;
+            c.length = endB - startB;
+            td.changes.add (c);
+        }
     }
 };
 
 TextDiff::TextDiff (const String& original, const String& target)
 {
-    TextDiffHelpers::diffSkippingCommonStart (*this, original, target);
+    const CharPointer_UTF32 a (original.toUTF32());
+    const CharPointer_UTF32 b (target.toUTF32());
+    const int lenA = (int) a.length();
+    const int lenB = (int) b.length();
+
+    TextDiffHelpers::CommonRuns runs;
+    TextDiffHelpers::findCommonRuns (a.getAddress(), lenA, b.getAddress(), lenB, runs);
+
+    int endOfLastRunA = 0, endOfLastRunB = 0;
+
+    for (int i = 0; i < runs.size(); ++i)
+    {
+        const TextDiffHelpers::CommonRun& run = runs.getReference (i);
+
+        TextDiffHelpers::addChanges (*this, b.getAddress(), endOfLastRunA, run.startA, endOfLastRunB, run.startB);
+        endOfLastRunA = run.startA + run.length;
+        endOfLastRunB = run.startB + run.length;
+    }
+
+    TextDiffHelpers::addChanges (*this, b.getAddress(), endOfLastRunA, lenA, endOfLastRunB, lenB);
 }
 
 String TextDiff::appliedTo (String text) const
@@ -230,6 +406,32 @@ public:
             testDiff (s, createString());
             testDiff (s + createString(), s + createString());
         }
+
+        beginTest ("Large texts");
+
+        Random r;
+        StringArray lines;
+
+        for (int i = 0; i < 2000; ++i)
+            lines.add (createString());
+
+        const String original (lines.joinIntoString ("\n"));
+
+        for (int i = 0; i < 100; ++i)
+        {
+            const int index = r.nextInt (lines.size());
+
+            switch (r.nextInt (3))
+            {
+                case 0:  lines.remove (index); break;
+                case 1:  lines.insert (index, createString()); break;
+                default: lines.set (index, lines[index] + createString()); break;
+            }
+        }
+
+        testDiff (original, lines.joinIntoString ("\n"));
+        testDiff (original, original.toUpperCase());
+        testDiff (original, String::empty);
     }
 };
 
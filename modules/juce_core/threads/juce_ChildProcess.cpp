@@ -23,8 +23,180 @@
   ==============================================================================
 */
 
-ChildProcess::ChildProcess() {}
-ChildProcess::~ChildProcess() {}
+//==============================================================================
+/*  Services the OutputCallbacks of all the child processes.
+
+    The lock is held while the thread waits for output and runs the callbacks, so that
+    a process can't be deleted or restarted while its pipe is being used. Threads that
+    want to add or remove a process bump numWaiting first, which makes this thread step
+    aside before it takes the lock again.
+*/
+class ChildProcess::IOThread  : public Thread
+{
+public:
+    IOThread()  : Thread ("ChildProcess I/O"), isActive (false)
+    {
+    }
+
+    ~IOThread()
+    {
+        stopThread (2000);
+    }
+
+    static IOThread& getInstance()
+    {
+        static IOThread instance;
+        return instance;
+    }
+
+    void addProcess (ChildProcess* const process)
+    {
+        ++numWaiting;
+        const ScopedLock sl (lock);
+        --numWaiting;
+
+        processes.addIfNotAlreadyThere (process);
+
+        if (! isActive)
+        {
+            waitForThreadToExit (-1); // (it may still be returning from a previous run)
+            isActive = true;
+            startThread();
+        }
+    }
+
+    void removeProcess (ChildProcess* const process)
+    {
+        ++numWaiting;
+        const ScopedLock sl (lock);
+        --numWaiting;
+
+        processes.removeFirstMatchingValue (process);
+    }
+
+    void run()
+    {
+        HeapBlock<char> buffer (bufferSize);
+
+        while (! threadShouldExit())
+        {
+            while (numWaiting.get() > 0)
+                Thread::yield();
+
+            const ScopedLock sl (lock);
+
+            if (processes.size() == 0)
+            {
+                isActive = false;
+                return;
+            }
+
+            waitForOutput (processes, 20);
+
+            const Array<ChildProcess*> processesToCheck (processes);
+
+            for (int i = 0; i < processesToCheck.size(); ++i)
+            {
+                ChildProcess* const process = processesToCheck.getUnchecked (i);
+
+                // a callback may remove or delete any of the other processes, so each one
+                // has to be checked again before it's used
+                for (int numReads = 0; numReads < 16 && processes.contains (process); ++numReads)
+                {
+                    const int num = process->readAvailableOutput (buffer, bufferSize);
+
+                    if (num == 0)
+                        break;
+
+                    OutputCallback* const callback = process->outputCallback;
+
+                    if (num < 0)
+                    {
+                        processes.removeFirstMatchingValue (process);
+                        process->outputCallback = nullptr;
+                        callback->processOutputFinished (*process);
+                        break;
+                    }
+
+                    callback->processOutputReceived (*process, buffer, num);
+                }
+            }
+        }
+
+        const ScopedLock sl (lock);
+        isActive = false;
+    }
+
+private:
+    enum { bufferSize = 8192 };
+
+    CriticalSection lock;
+    Array<ChildProcess*> processes;
+    Atomic<int> numWaiting;
+    bool isActive;
+
+    JUCE_DECLARE_NON_COPYABLE (IOThread)
+};
+
+//==============================================================================
+ChildProcess::ChildProcess()  : outputCallback (nullptr) {}
+
+ChildProcess::~ChildProcess()
+{
+    if (outputCallback != nullptr)
+        setOutputCallback (nullptr);
+}
+
+void ChildProcess::setOutputCallback (OutputCallback* const newCallback)
+{
+    // You need to start the process before attaching a callback to it!
+    jassert (newCallback == nullptr || activeProcess != nullptr);
+
+    if (outputCallback != nullptr || newCallback != nullptr)
+    {
+        IOThread& ioThread = IOThread::getInstance();
+        ioThread.removeProcess (this);
+
+        outputCallback = newCallback;
+
+        if (newCallback != nullptr)
+            ioThread.addProcess (this);
+    }
+}
+
+//==============================================================================
+class ChildProcessInputStream  : public OutputStream
+{
+public:
+    ChildProcessInputStream (ChildProcess& p) noexcept  : process (p), position (0) {}
+
+    void flush() {}
+    bool setPosition (int64)        { return false; }
+    int64 getPosition()             { return position; }
+
+    bool write (const void* const data, const size_t numBytes)
+    {
+        jassert (numBytes < 0x7fffffff);
+
+        const int numWritten = process.writeProcessInput (data, (int) numBytes);
+
+        if (numWritten > 0)
+            position += numWritten;
+
+        return numWritten == (int) numBytes;
+    }
+
+private:
+    ChildProcess& process;
+    int64 position;
+
+    JUCE_DECLARE_NON_COPYABLE (ChildProcessInputStream)
+};
+
+OutputStream* ChildProcess::createProcessInputStream()
+{
+    return new ChildProcessInputStream (*this);
+}
 
 bool ChildProcess::waitForProcessToFinish (const int timeoutMs) const
 {
@@ -82,7 +254,85 @@ public:
         //String output (p.readAllProcessOutput());
         //expect (output.isNotEmpty());
       #endif
+
+      #if JUCE_MAC || JUCE_LINUX
+        beginTest ("Standard input");
+
+        ChildProcess cat;
+        expect (cat.start ("cat", ChildProcess::wantStdOut | ChildProcess::wantStdIn));
+
+        const char text[] = "piped through a child process";
+        expectEquals (cat.writeProcessInput (text, (int) sizeof (text) - 1), (int) sizeof (text) - 1);
+        cat.closeProcessInput();
+
+        expectEquals (cat.readAllProcessOutput(), String (text));
+        expect (cat.waitForProcessToFinish (5000));
+        expectEquals (cat.writeProcessInput (text, 1), -1);
+
+        beginTest ("Output callbacks");
+
+        {
+            const int numProcesses = 4;
+            OwnedArray<ChildProcess> processes;
+            OwnedArray<OutputCollector> collectors;
+
+            for (int i = 0; i < numProcesses; ++i)
+            {
+                ChildProcess* const p = new ChildProcess();
+                OutputCollector* const collector = new OutputCollector();
+                processes.add (p);
+                collectors.add (collector);
+
+                expect (p->start ("cat", ChildProcess::wantStdOut | ChildProcess::wantStdIn));
+                p->setOutputCallback (collector);
+            }
+
+            for (int i = 0; i < numProcesses; ++i)
+            {
+                ScopedPointer<OutputStream> input (processes[i]->createProcessInputStream());
+
+                for (int line = 0; line < 100; ++line)
+                    *input << "process " << i << " line " << line << newLine;
+            }
+
+            for (int i = 0; i < numProcesses; ++i)
+                processes[i]->closeProcessInput();
+
+            for (int i = 0; i < numProcesses; ++i)
+            {
+                expect (collectors[i]->finished.wait (10000));
+
+                const StringArray lines (StringArray::fromLines (collectors[i]->getOutput().trim()));
+                expectEquals (lines.size(), 100);
+                expectEquals (lines[99], "process " + String (i) + " line 99");
+            }
+        }
+      #endif
     }
+
+    struct OutputCollector  : public ChildProcess::OutputCallback
+    {
+        void processOutputReceived (ChildProcess&, const void* data, int numBytes)
+        {
+            const ScopedLock sl (lock);
+            output.write (data, (size_t) numBytes);
+        }
+
+        void processOutputFinished (ChildProcess&)
+        {
+            finished.signal();
+        }
+
+        String getOutput()
+        {
+            const ScopedLock sl (lock);
+            return output.toString();
+        }
+
+        CriticalSection lock;
+        MemoryOutputStream output;
+        WaitableEvent finished;
+    };
 };
 
 static ChildProcessTests childProcessUnitTests;
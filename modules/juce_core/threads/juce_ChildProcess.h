@@ -31,8 +31,16 @@
 /**
     Launches and monitors a child process.
 
-    This class lets you launch an executable, and read its output. You can also
-    use it to check whether the child process has finished.
+    This class lets you launch an executable, read its output and optionally feed
+    data to its standard input. You can also use it to check whether the child
+    process has finished.
+
+    The output can either be read with the blocking readProcessOutput() methods, or
+    delivered to an OutputCallback by a background thread that's shared between all
+    the child processes, so that many processes can be monitored without a thread
+    for each of them.
+
+    @see ChildProcessPool
 */
 class JUCE_API  ChildProcess
 {
@@ -48,14 +56,26 @@ public:
     */
     ~ChildProcess();
 
+    /** These flags are used by the start() methods to choose which of the child
+        process's standard streams are connected to this object.
+    */
+    enum StreamFlags
+    {
+        wantStdOut = 1,     /**< The process's stdout can be read with readProcessOutput(). */
+        wantStdErr = 2,     /**< The process's stderr is merged into the output that readProcessOutput() returns. */
+        wantStdIn  = 4      /**< Data can be sent to the process's stdin with writeProcessInput(). */
+    };
+
     /** Attempts to launch a child process command.
 
         The command should be the name of the executable file, followed by any arguments
         that are required.
         If the process has already been launched, this will launch it again. If a problem
         occurs, the method will return false.
+        The streamFlags argument is a combination of values from StreamFlags.
+        Any OutputCallback that was set for a previous process is detached.
     */
-    bool start (const String& command);
+    bool start (const String& command, int streamFlags = wantStdOut | wantStdErr);
 
     /** Attempts to launch a child process command.
 
@@ -63,8 +83,9 @@ public:
         arguments that are needed.
         If the process has already been launched, this will launch it again. If a problem
         occurs, the method will return false.
+        The streamFlags argument is a combination of values from StreamFlags.
     */
-    bool start (const StringArray& arguments);
+    bool start (const StringArray& arguments, int streamFlags = wantStdOut | wantStdErr);
 
     /** Returns true if the child process is alive. */
     bool isRunning() const;
@@ -80,6 +101,71 @@ public:
     */
     String readAllProcessOutput();
 
+    /** Sends some data to the child process's standard input.
+
+        This only works if the process was started with the wantStdIn flag. The call
+        blocks until all the data has been written to the pipe, so if the process also
+        produces output, you'll need to read it on another thread to avoid the two
+        processes waiting on each other.
+
+        @returns the number of bytes written, or -1 if there was an error (e.g. because
+                 the process has already quit)
+    */
+    int writeProcessInput (const void* sourceData, int numBytesToWrite);
+
+    /** Closes the child process's standard input, so that it sees the end of its input data. */
+    void closeProcessInput();
+
+    /** Creates a stream that writes to the child process's standard input.
+
+        This just wraps writeProcessInput(), so the same rules apply: the process
+        must have been started with the wantStdIn flag, and each write blocks until the
+        pipe has accepted all its data.
+
+        The caller must delete the stream, and mustn't use it after this object has been
+        deleted or restarted. Deleting the stream doesn't close the process's input - use
+        closeProcessInput() for that.
+    */
+    OutputStream* createProcessInputStream();
+
+    //==============================================================================
+    /** Receives the output of a child process asynchronously.
+        @see setOutputCallback
+    */
+    class JUCE_API  OutputCallback
+    {
+    public:
+        /** Destructor. */
+        virtual ~OutputCallback()  {}
+
+        /** Called when some data has arrived from the process's output.
+
+            This is called on the shared ChildProcess I/O thread, which services all
+            the processes that have a callback, so it should return quickly, and must not
+            block waiting for another thread that might be calling setOutputCallback().
+        */
+        virtual void processOutputReceived (ChildProcess& process, const void* data, int numBytes) = 0;
+
+        /** Called on the I/O thread once the process's output has come to an end.
+            The callback is detached from the process after this has been called.
+        */
+        virtual void processOutputFinished (ChildProcess& process) = 0;
+    };
+
+    /** Starts or stops delivering the process's output to a callback.
+
+        Once a callback is set, the process's output is read by a background thread
+        that's shared by all the ChildProcess objects, and which waits for data on all
+        their pipes at once. The callback is detached when the output ends, when start()
+        is called again, or when you call this method with a null pointer. When this
+        method returns, the old callback is guaranteed not to be in use any more (unless
+        it's being called from that callback).
+
+        The process must already have been started, and you shouldn't mix this with calls
+        to readProcessOutput() or readAllProcessOutput().
+    */
+    void setOutputCallback (OutputCallback* callback);
+
     /** Blocks until the process is no longer running. */
     bool waitForProcessToFinish (int timeoutMs) const;
 
@@ -94,6 +180,13 @@ private:
     class ActiveProcess;
     friend class ScopedPointer<ActiveProcess>;
     ScopedPointer<ActiveProcess> activeProcess;
+    OutputCallback* outputCallback;
+
+    class IOThread;
+    friend class IOThread;
+
+    int readAvailableOutput (void* destBuffer, int maxBytes);
+    static void waitForOutput (const Array<ChildProcess*>& processes, int timeoutMs);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChildProcess)
 };
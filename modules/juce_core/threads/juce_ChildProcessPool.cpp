@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+ChildProcessPool::ChildProcessPool (const StringArray& workerCommand,
+                                    const int maxNumWorkers,
+                                    const int streamFlags)
+    : command (workerCommand),
+      maxWorkers (jmax (1, maxNumWorkers)),
+      flags (streamFlags)
+{
+}
+
+ChildProcessPool::~ChildProcessPool()
+{
+    // You need to release all the workers before the pool is deleted!
+    jassert (idleWorkers.size() == workers.size());
+
+    for (int i = workers.size(); --i >= 0;)
+        workers.getUnchecked(i)->kill();
+}
+
+ChildProcess* ChildProcessPool::acquireWorker (const int timeoutMs)
+{
+    const uint32 endTime = Time::getMillisecondCounter() + (uint32) jmax (0, timeoutMs);
+
+    for (;;)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            while (idleWorkers.size() > 0)
+            {
+                ChildProcess* const worker = idleWorkers.getLast();
+                idleWorkers.removeLast();
+
+                if (worker->isRunning())
+                    return worker;
+
+                deleteWorker (worker);
+            }
+
+            if (workers.size() < maxWorkers)
+            {
+                ScopedPointer<ChildProcess> worker (new ChildProcess());
+
+                if (! worker->start (command, flags))
+                    return nullptr;
+
+                workers.add (worker);
+                return worker.release();
+            }
+        }
+
+        const int msLeft = timeoutMs < 0 ? -1 : (int) (endTime - Time::getMillisecondCounter());
+
+        if (timeoutMs >= 0 && (msLeft <= 0 || msLeft > timeoutMs))
+            return nullptr;
+
+        workerReleased.wait (msLeft);
+    }
+}
+
+void ChildProcessPool::releaseWorker (ChildProcess* const worker, const bool canBeReused)
+{
+    if (worker != nullptr)
+    {
+        const ScopedLock sl (lock);
+
+        // This worker doesn't belong to this pool, or has already been released!
+        jassert (workers.contains (worker) && ! idleWorkers.contains (worker));
+
+        if (canBeReused && worker->isRunning())
+        {
+            worker->setOutputCallback (nullptr);
+            idleWorkers.add (worker);
+        }
+        else
+        {
+            deleteWorker (worker);
+        }
+    }
+
+    workerReleased.signal();
+}
+
+void ChildProcessPool::killIdleWorkers()
+{
+    const ScopedLock sl (lock);
+
+    while (idleWorkers.size() > 0)
+    {
+        ChildProcess* const worker = idleWorkers.getLast();
+        idleWorkers.removeLast();
+        deleteWorker (worker);
+    }
+}
+
+void ChildProcessPool::deleteWorker (ChildProcess* const worker)
+{
+    worker->kill();
+    workers.removeObject (worker);
+}
+
+int ChildProcessPool::getNumWorkers() const
+{
+    const ScopedLock sl (lock);
+    return workers.size();
+}
+
+int ChildProcessPool::getNumIdleWorkers() const
+{
+    const ScopedLock sl (lock);
+    return idleWorkers.size();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ChildProcessPoolTests  : public UnitTest
+{
+public:
+    ChildProcessPoolTests() : UnitTest ("ChildProcessPool") {}
+
+    void runTest()
+    {
+      #if JUCE_MAC || JUCE_LINUX
+        beginTest ("Reusing workers");
+
+        ChildProcessPool pool (StringArray ("cat"), 2);
+
+        ChildProcess* const first = pool.acquireWorker();
+        ChildProcess* const second = pool.acquireWorker();
+        expect (first != nullptr && second != nullptr && first != second);
+        expect (pool.acquireWorker() == nullptr);
+        expectEquals (pool.getNumWorkers(), 2);
+
+        const char text[] = "job";
+        expectEquals (first->writeProcessInput (text, 3), 3);
+
+        char reply[4] = { 0 };
+        expectEquals (first->readProcessOutput (reply, 3), 3);
+        expectEquals (String (reply), String (text));
+
+        pool.releaseWorker (first);
+        expectEquals (pool.getNumIdleWorkers(), 1);
+        expect (pool.acquireWorker() == first);
+
+        second->kill();
+        second->waitForProcessToFinish (5000);
+        pool.releaseWorker (second);
+        expectEquals (pool.getNumWorkers(), 1);
+
+        pool.releaseWorker (first, false);
+        expectEquals (pool.getNumWorkers(), 0);
+        expectEquals (pool.getNumIdleWorkers(), 0);
+      #endif
+    }
+};
+
+static ChildProcessPoolTests childProcessPoolUnitTests;
+
+#endif
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_CHILDPROCESSPOOL_JUCEHEADER__
+#define __JUCE_CHILDPROCESSPOOL_JUCEHEADER__
+
+#include "juce_ChildProcess.h"
+#include "juce_CriticalSection.h"
+#include "juce_WaitableEvent.h"
+#include "../containers/juce_OwnedArray.h"
+
+
+//==============================================================================
+/**
+    Keeps a set of long-lived worker processes running, and lends them out for jobs.
+
+    Launching a process is expensive, so for things like transcoding jobs or scanning
+    plugins in a separate process, it's much quicker to keep a few workers running and
+    send each one a series of jobs through its standard input. The pool launches up to
+    a given number of workers on demand, all using the same command.
+
+    e.g. @code
+    ChildProcessPool pool (StringArray::fromTokens ("my_worker --serve", true), 4);
+
+    if (ChildProcess* worker = pool.acquireWorker (5000))
+    {
+        worker->writeProcessInput (job.getData(), (int) job.getSize());
+        ...read the result from worker...
+
+        pool.releaseWorker (worker);
+    }
+    @endcode
+
+    All the methods are thread-safe.
+
+    @see ChildProcess
+*/
+class JUCE_API  ChildProcessPool
+{
+public:
+    //==============================================================================
+    /** Creates a pool.
+
+        @param workerCommand    the executable and arguments used to launch each worker
+        @param maxNumWorkers    the largest number of workers that may be running at once
+        @param streamFlags      the ChildProcess::StreamFlags used when launching the workers
+    */
+    ChildProcessPool (const StringArray& workerCommand,
+                      int maxNumWorkers,
+                      int streamFlags = ChildProcess::wantStdOut | ChildProcess::wantStdIn);
+
+    /** Destructor.
+        Any workers that are still running are killed, so make sure that all the workers
+        have been released before deleting the pool.
+    */
+    ~ChildProcessPool();
+
+    //==============================================================================
+    /** Gets a worker for a job.
+
+        This returns an idle worker if there is one, or otherwise launches a new one if
+        the pool isn't full yet. If all the workers are busy, it waits for up to timeoutMs
+        for one to be released (or forever if timeoutMs is negative).
+
+        @returns the worker, which you must hand back with releaseWorker() when the job is
+                 done, or nullptr if no worker could be started in time
+    */
+    ChildProcess* acquireWorker (int timeoutMs = 0);
+
+    /** Hands a worker back to the pool when its job is finished.
+
+        If the worker has quit, or canBeReused is false (e.g. because the job failed
+        and the worker may be in a bad state), the worker is killed and deleted, and a
+        fresh one will be launched the next time one is needed.
+    */
+    void releaseWorker (ChildProcess* worker, bool canBeReused = true);
+
+    /** Kills and deletes all the workers that aren't currently in use. */
+    void killIdleWorkers();
+
+    //==============================================================================
+    /** Returns the number of workers that are running, whether busy or idle. */
+    int getNumWorkers() const;
+
+    /** Returns the number of running workers that aren't currently in use. */
+    int getNumIdleWorkers() const;
+
+private:
+    //==============================================================================
+    const StringArray command;
+    const int maxWorkers, flags;
+    CriticalSection lock;
+    OwnedArray<ChildProcess> workers;
+    Array<ChildProcess*> idleWorkers;
+    WaitableEvent workerReleased;
+
+    void deleteWorker (ChildProcess*);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChildProcessPool)
+};
+
+
+#endif   // __JUCE_CHILDPROCESSPOOL_JUCEHEADER__
@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+DeferredReleasePool::DeferredReleasePool (const int checkIntervalMilliseconds)
+    : Thread ("Deferred release pool"),
+      checkInterval (jmax (1, checkIntervalMilliseconds))
+{
+    startThread (2);
+}
+
+DeferredReleasePool::~DeferredReleasePool()
+{
+    stopThread (4000);
+    objects.clear();
+}
+
+void DeferredReleasePool::add (ReferenceCountedObject* const object)
+{
+    if (object != nullptr)
+        objects.addIfNotAlreadyThere (object);
+}
+
+int DeferredReleasePool::releaseUnusedObjects()
+{
+    // The unused objects are moved into a separate array so that their destructors
+    // run after the lock has been released, and don't hold up calls to add().
+    ReferenceCountedArray<ReferenceCountedObject> unused;
+
+    {
+        const ScopedLock sl (objects.getLock());
+
+        for (int i = objects.size(); --i >= 0;)
+        {
+            ReferenceCountedObject* const o = objects.getObjectPointerUnchecked (i);
+
+            // (if the pool holds the only reference, nobody else can take a new one)
+            if (o->getReferenceCount() == 1)
+            {
+                unused.add (o);
+                objects.remove (i);
+            }
+        }
+    }
+
+    const int numReleased = unused.size();
+    unused.clear();
+    return numReleased;
+}
+
+int DeferredReleasePool::getNumObjects() const noexcept
+{
+    return objects.size();
+}
+
+void DeferredReleasePool::run()
+{
+    while (! threadShouldExit())
+    {
+        wait (checkInterval);
+
+        if (! threadShouldExit())
+            releaseUnusedObjects();
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class DeferredReleasePoolTests  : public UnitTest
+{
+public:
+    DeferredReleasePoolTests() : UnitTest ("DeferredReleasePool") {}
+
+    struct TestObject  : public ReferenceCountedObject
+    {
+        TestObject (Atomic<int>& numDeleted_) : numDeleted (numDeleted_) {}
+        ~TestObject()   { ++numDeleted; }
+
+        typedef ReferenceCountedObjectPtr<TestObject> Ptr;
+        Atomic<int>& numDeleted;
+    };
+
+    struct DroppingThread  : public Thread
+    {
+        DroppingThread (ReferenceCountedArray<TestObject>& objects_, Atomic<int>& numDeleted_)
+            : Thread ("DeferredReleasePool test"), objects (objects_), numDeleted (numDeleted_), numDeletedHere (-1)
+        {
+        }
+
+        void run()
+        {
+            const int numBefore = numDeleted.get();
+            objects.clear();
+            numDeletedHere = numDeleted.get() - numBefore;
+        }
+
+        ReferenceCountedArray<TestObject>& objects;
+        Atomic<int>& numDeleted;
+        int numDeletedHere;
+    };
+
+    void runTest()
+    {
+        beginTest ("Releasing");
+
+        Atomic<int> numDeleted;
+        ReferenceCountedArray<TestObject> objects;
+
+        {
+            DeferredReleasePool pool (100000);
+
+            for (int i = 0; i < 20; ++i)
+            {
+                TestObject::Ptr o (new TestObject (numDeleted));
+                pool.add (o);
+                pool.add (o);
+                objects.add (o);
+            }
+
+            expectEquals (pool.getNumObjects(), 20);
+            expectEquals (pool.releaseUnusedObjects(), 0);
+
+            TestObject::Ptr stillUsed (objects.getFirst());
+
+            DroppingThread dropper (objects, numDeleted);
+            dropper.startThread();
+            expect (dropper.waitForThreadToExit (5000));
+            expectEquals (dropper.numDeletedHere, 0);
+            expectEquals (numDeleted.get(), 0);
+
+            expectEquals (pool.releaseUnusedObjects(), 19);
+            expectEquals (numDeleted.get(), 19);
+            expectEquals (pool.getNumObjects(), 1);
+
+            stillUsed = nullptr;
+            expectEquals (numDeleted.get(), 19);
+
+            TestObject::Ptr afterShutdown (new TestObject (numDeleted));
+            pool.add (afterShutdown);
+            objects.add (afterShutdown);
+        }
+
+        expectEquals (numDeleted.get(), 20);
+        expectEquals (objects.getObjectPointer (0)->getReferenceCount(), 1);
+        objects.clear();
+        expectEquals (numDeleted.get(), 21);
+
+        beginTest ("Background thread");
+
+        {
+            DeferredReleasePool pool (1);
+            pool.add (new TestObject (numDeleted));
+
+            for (int i = 0; i < 500 && pool.getNumObjects() > 0; ++i)
+                Thread::sleep (10);
+
+            expectEquals (pool.getNumObjects(), 0);
+            expectEquals (numDeleted.get(), 22);
+        }
+
+       #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+        beginTest ("Moving pointers");
+
+        TestObject::Ptr p1 (new TestObject (numDeleted));
+        TestObject::Ptr p2 (static_cast <TestObject::Ptr&&> (p1));
+        expect (p1 == nullptr);
+        expectEquals (p2->getReferenceCount(), 1);
+
+        ReferenceCountedObjectPtr<ReferenceCountedObject> base (static_cast <TestObject::Ptr&&> (p2));
+        expect (p2 == nullptr);
+        expectEquals (base->getReferenceCount(), 1);
+
+        ReferenceCountedArray<TestObject> array1;
+        array1.add (new TestObject (numDeleted));
+        ReferenceCountedArray<TestObject> array2 (static_cast <ReferenceCountedArray<TestObject>&&> (array1));
+        expectEquals (array1.size(), 0);
+        expectEquals (array2.getObjectPointer (0)->getReferenceCount(), 1);
+
+        base = nullptr;
+        array2.clear();
+        expectEquals (numDeleted.get(), 24);
+       #endif
+    }
+};
+
+static DeferredReleasePoolTests deferredReleasePoolUnitTests;
+
+//==============================================================================
+class ReferenceCountingBenchmark  : public Benchmark
+{
+public:
+    enum Mode { copyPointers, copyPointersFromLockedArray, usePointersWithoutCopying, movePointers };
+
+    ReferenceCountingBenchmark (const Mode mode_, const String& description)
+        : Benchmark ("Reference counting: " + description), mode (mode_), checksum (0)
+    {
+    }
+
+    struct Item  : public ReferenceCountedObject
+    {
+        Item (int value_) : value (value_) {}
+        int value;
+    };
+
+    typedef ReferenceCountedObjectPtr<Item> ItemPtr;
+
+    void initialise()
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            pointers.add (new Item (i));
+            lockedItems.add (pointers.getReference (i));
+        }
+    }
+
+    void shutdown()
+    {
+        pointers.clear();
+        lockedItems.clear();
+    }
+
+    void runIteration()
+    {
+        int total = 0;
+
+        if (mode == copyPointers)
+        {
+            for (int i = 0; i < pointers.size(); ++i)
+            {
+                const ItemPtr item (pointers.getReference (i));
+                total += item->value;
+            }
+        }
+        else if (mode == copyPointersFromLockedArray)
+        {
+            for (int i = 0; i < lockedItems.size(); ++i)
+            {
+                const ItemPtr item (lockedItems.getUnchecked (i));
+                total += item->value;
+            }
+        }
+        else if (mode == usePointersWithoutCopying)
+        {
+            for (int i = 0; i < pointers.size(); ++i)
+                total += pointers.getReference (i)->value;
+        }
+       #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+        else
+        {
+            // takes each pointer out of the array and puts it back again, as happens
+            // when they're handed from one owner to another
+            for (int i = 0; i < pointers.size(); ++i)
+            {
+                ItemPtr item (static_cast <ItemPtr&&> (pointers.getReference (i)));
+                total += item->value;
+                pointers.getReference (i) = static_cast <ItemPtr&&> (item);
+            }
+        }
+       #endif
+
+        checksum += total;
+        preventOptimisation (&checksum);
+    }
+
+private:
+    const Mode mode;
+    int checksum;
+    Array<ItemPtr> pointers;
+    ReferenceCountedArray<Item, CriticalSection> lockedItems;
+};
+
+static ReferenceCountingBenchmark referenceCountingBenchmark1 (ReferenceCountingBenchmark::copyPointers, "copy pointers");
+static ReferenceCountingBenchmark referenceCountingBenchmark2 (ReferenceCountingBenchmark::copyPointersFromLockedArray, "copy pointers from a locked array");
+static ReferenceCountingBenchmark referenceCountingBenchmark3 (ReferenceCountingBenchmark::usePointersWithoutCopying, "use raw pointers");
+
+#if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+static ReferenceCountingBenchmark referenceCountingBenchmark4 (ReferenceCountingBenchmark::movePointers, "move pointers");
+#endif
+
+#endif
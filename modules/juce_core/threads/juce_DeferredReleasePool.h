@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_DEFERREDRELEASEPOOL_JUCEHEADER__
+#define __JUCE_DEFERREDRELEASEPOOL_JUCEHEADER__
+
+#include "juce_Thread.h"
+#include "../containers/juce_ReferenceCountedArray.h"
+
+
+//==============================================================================
+/**
+    Keeps reference-counted objects alive until nothing else is using them, and then
+    releases them on a background thread.
+
+    A real-time thread, such as an audio callback, must never be the one that drops the
+    last reference to an object, because that would run the object's destructor and free
+    its memory on that thread. If you add an object to a DeferredReleasePool before handing
+    it over to the real-time thread, the pool holds an extra reference to it, so the
+    real-time thread can let go of it at any time. Every so often, the pool's thread looks
+    for objects which are only referenced by the pool itself, and releases them.
+
+    e.g. @code
+    DeferredReleasePool releasePool;
+
+    void MyEngine::loadSample (const File& file)    // called on the message thread
+    {
+        SampleBuffer::Ptr newBuffer (new SampleBuffer (file));
+        releasePool.add (newBuffer);
+
+        const ScopedLock sl (bufferLock);
+        currentBuffer = newBuffer;  // the audio thread's copy of the old buffer
+                                    // can now be dropped without deleting it
+    }
+    @endcode
+
+    Only call add() from non-real-time threads, as it may allocate memory and takes a lock.
+
+    @see ReferenceCountedObject
+*/
+class JUCE_API  DeferredReleasePool  : private Thread
+{
+public:
+    //==============================================================================
+    /** Creates a pool, and starts its thread.
+        The thread will check for unused objects at the interval given.
+    */
+    explicit DeferredReleasePool (int checkIntervalMilliseconds = 1000);
+
+    /** Destructor.
+        This stops the thread and drops the pool's references to all its objects, so any
+        that aren't referenced elsewhere will be deleted.
+    */
+    ~DeferredReleasePool();
+
+    //==============================================================================
+    /** Adds an object to the pool, which will keep a reference to it until it isn't
+        used anywhere else.
+        Adding an object that's already in the pool does nothing.
+    */
+    void add (ReferenceCountedObject* object);
+
+    /** Releases any objects that are only referenced by the pool, and returns the number
+        of objects that were released.
+        The pool's thread calls this periodically, but you can also call it yourself, e.g.
+        after you've switched a real-time thread over to a new set of objects.
+    */
+    int releaseUnusedObjects();
+
+    /** Returns the number of objects that the pool is currently holding. */
+    int getNumObjects() const noexcept;
+
+private:
+    //==============================================================================
+    ReferenceCountedArray<ReferenceCountedObject, CriticalSection> objects;
+    const int checkInterval;
+
+    void run();
+
+    JUCE_DECLARE_NON_COPYABLE (DeferredReleasePool)
+};
+
+
+#endif   // __JUCE_DEFERREDRELEASEPOOL_JUCEHEADER__
@@ -0,0 +1,345 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+/*  This is shared between the thread that calls ParallelTask::run() and the pool jobs that
+    help it. It's reference-counted because a job may not get started until after all the
+    chunks have been finished (and run() has returned), in which case it has nothing to do,
+    but still needs somewhere to look to find that out.
+*/
+class ParallelTask::SharedState  : public ReferenceCountedObject
+{
+public:
+    SharedState (ParallelTask& task_, const int numChunks_) noexcept
+        : task (task_), numChunks (numChunks_)
+    {
+    }
+
+    void runChunks()
+    {
+        for (;;)
+        {
+            const int chunk = (++nextChunk) - 1;
+
+            if (chunk >= numChunks)
+                break;
+
+            task.runChunk (chunk);
+
+            if (++numChunksFinished == numChunks)
+                finished.signal();
+        }
+    }
+
+    static void runHelperJob (void* userData)
+    {
+        SharedState* const state = static_cast <SharedState*> (userData);
+        state->runChunks();
+        state->decReferenceCount();
+    }
+
+    ParallelTask& task;
+    const int numChunks;
+    Atomic<int> nextChunk, numChunksFinished;
+    WaitableEvent finished;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (SharedState)
+};
+
+void ParallelTask::run (ThreadPool& pool, const int numChunks)
+{
+    if (numChunks <= 1)
+    {
+        if (numChunks == 1)
+            runChunk (0);
+
+        return;
+    }
+
+    const int numHelpers = jmin (pool.getNumThreads(), numChunks - 1);
+    SharedState* const state = new SharedState (*this, numChunks);
+
+    for (int i = numHelpers + 1; --i >= 0;)
+        state->incReferenceCount();
+
+    for (int i = numHelpers; --i >= 0;)
+        pool.addJob (SharedState::runHelperJob, state, ThreadPool::highPriority);
+
+    state->runChunks();
+
+    while (state->numChunksFinished.get() < numChunks)
+        state->finished.wait();
+
+    state->decReferenceCount();
+}
+
+int ParallelTask::getNumChunksToUse (const ThreadPool& pool, const int numItems, const int minItemsPerChunk) noexcept
+{
+    // Using a few chunks per thread lets the faster threads pick up the slack
+    // if some chunks take longer than others.
+    const int chunksPerThread = 8;
+    const int maxChunks = (pool.getNumThreads() + 1) * chunksPerThread;
+
+    return jlimit (1, maxChunks, numItems / jmax (1, minItemsPerChunk));
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParallelAlgorithmTests  : public UnitTest
+{
+public:
+    ParallelAlgorithmTests() : UnitTest ("Parallel algorithms") {}
+
+    struct Incrementer
+    {
+        Incrementer (int* data_) : data (data_) {}
+
+        void operator() (int start, int end)
+        {
+            for (int i = start; i < end; ++i)
+                ++data[i];
+        }
+
+        int* data;
+    };
+
+    struct NestedIncrementer
+    {
+        NestedIncrementer (ThreadPool& pool_, int* data_, int rowLength_)
+            : pool (pool_), data (data_), rowLength (rowLength_) {}
+
+        void operator() (int start, int end)
+        {
+            for (int row = start; row < end; ++row)
+            {
+                Incrementer inc (data + row * rowLength);
+                parallelFor (pool, 0, rowLength, inc, 16);
+            }
+        }
+
+        ThreadPool& pool;
+        int* data;
+        const int rowLength;
+    };
+
+    struct Summer
+    {
+        Summer (const int* data_) : data (data_) {}
+
+        int64 processRange (int start, int end)
+        {
+            int64 total = 0;
+
+            for (int i = start; i < end; ++i)
+                total += data[i];
+
+            return total;
+        }
+
+        int64 combine (int64 a, int64 b)     { return a + b; }
+
+        const int* data;
+    };
+
+    // A deliberately slow function, for measuring how well the work is shared out
+    struct Worker
+    {
+        Worker (double* results_) : results (results_) {}
+
+        void operator() (int start, int end)
+        {
+            for (int i = start; i < end; ++i)
+            {
+                double x = i;
+
+                for (int j = 0; j < 2000; ++j)
+                    x = std::sqrt (x + j);
+
+                results[i] = x;
+            }
+        }
+
+        double* results;
+    };
+
+    struct IntComparator
+    {
+        static int compareElements (int a, int b) noexcept      { return a < b ? -1 : (a > b ? 1 : 0); }
+    };
+
+    struct HighBitsComparator
+    {
+        static int compareElements (int a, int b) noexcept      { return (a >> 16) - (b >> 16); }
+    };
+
+    struct StringPointerComparator
+    {
+        static int compareElements (const String* a, const String* b)   { return a->compare (*b); }
+    };
+
+    void runTest()
+    {
+        ThreadPool pool (jmax (2, SystemStats::getNumCpus()));
+        Random r (0x1234);
+
+        beginTest ("parallelFor");
+
+        {
+            const int num = 100003;
+            HeapBlock<int> data ((size_t) num, true);
+            Incrementer inc (data);
+
+            parallelFor (pool, 0, num, inc);
+            parallelFor (pool, 10, num - 10, inc, 1000);
+
+            bool allCorrect = true;
+
+            for (int i = 0; i < num; ++i)
+                allCorrect = allCorrect && data[i] == ((i < 10 || i >= num - 10) ? 1 : 2);
+
+            expect (allCorrect);
+        }
+
+        beginTest ("Nested parallelFor");
+
+        {
+            const int numRows = 50, rowLength = 1000;
+            HeapBlock<int> data ((size_t) (numRows * rowLength), true);
+            NestedIncrementer inc (pool, data, rowLength);
+
+            parallelFor (pool, 0, numRows, inc);
+
+            bool allCorrect = true;
+
+            for (int i = 0; i < numRows * rowLength; ++i)
+                allCorrect = allCorrect && data[i] == 1;
+
+            expect (allCorrect);
+        }
+
+        beginTest ("parallelReduce");
+
+        {
+            Array<int> data;
+
+            for (int i = 0; i < 200000; ++i)
+                data.add (r.nextInt (1000) - 500);
+
+            int64 expected = 0;
+
+            for (int i = 0; i < data.size(); ++i)
+                expected += data[i];
+
+            Summer summer (data.getRawDataPointer());
+            expect (parallelReduce (pool, 0, data.size(), (int64) 0, summer) == expected);
+            expect (parallelReduce (pool, 0, data.size(), (int64) 5, summer, 100000) == expected + 5);
+            expect (parallelReduce (pool, 0, 0, (int64) 5, summer) == 5);
+        }
+
+        beginTest ("parallelSort");
+
+        {
+            for (int size = 0; size < 100000; size = size * 3 + 7)
+            {
+                Array<int> a, b;
+
+                for (int i = 0; i < size; ++i)
+                    a.add (r.nextInt());
+
+                b = a;
+                IntComparator comp;
+                b.sort (comp);
+                parallelSort (pool, a, comp);
+
+                expect (a == b);
+
+                // check that the retain-order option keeps equivalent items in order..
+                Array<int> c;
+
+                for (int i = 0; i < jmin (size, 3000); ++i)
+                    c.add ((r.nextInt (8) << 16) + i);
+
+                HighBitsComparator highBits;
+                parallelSort (pool, c.getRawDataPointer(), c.size(), highBits, true, 100);
+
+                bool inOrder = true;
+
+                for (int i = 1; i < c.size(); ++i)
+                    inOrder = inOrder && c[i - 1] < c[i];
+
+                expect (inOrder);
+            }
+
+            OwnedArray<String> strings;
+
+            for (int i = 0; i < 10000; ++i)
+                strings.add (new String (r.nextInt()));
+
+            StringPointerComparator stringComp;
+            parallelSort (pool, strings, stringComp);
+
+            bool sorted = true;
+
+            for (int i = 1; i < strings.size(); ++i)
+                sorted = sorted && strings[i - 1]->compare (*strings[i]) <= 0;
+
+            expect (sorted);
+        }
+
+        beginTest ("Scaling");
+
+        {
+            const int num = 20000;
+            HeapBlock<double> results ((size_t) num), expected ((size_t) num);
+            double singleThreadTime = 0;
+
+            Worker reference (expected);
+            reference (0, num);
+
+            for (int numThreads = 1; numThreads <= SystemStats::getNumCpus(); ++numThreads)
+            {
+                ThreadPool testPool (numThreads);
+                Worker worker (results);
+
+                const double start = Time::getMillisecondCounterHiRes();
+                parallelFor (testPool, 0, num, worker);
+                const double time = Time::getMillisecondCounterHiRes() - start;
+
+                if (numThreads == 1)
+                    singleThreadTime = time;
+
+                expect (memcmp (results, expected, sizeof (double) * (size_t) num) == 0);
+
+                logMessage (String (numThreads) + " thread(s): " + String (time, 1) + " ms, speedup "
+                             + String (singleThreadTime / jmax (0.001, time), 2));
+            }
+        }
+    }
+};
+
+static ParallelAlgorithmTests parallelAlgorithmUnitTests;
+
+#endif
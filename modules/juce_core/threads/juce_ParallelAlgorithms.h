@@ -0,0 +1,370 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_PARALLELALGORITHMS_JUCEHEADER__
+#define __JUCE_PARALLELALGORITHMS_JUCEHEADER__
+
+#include "juce_ThreadPool.h"
+#include "../containers/juce_ElementComparator.h"
+
+
+//==============================================================================
+/**
+    The engine that parallelFor(), parallelReduce() and parallelSort() are built on.
+
+    A ParallelTask divides some work into a number of chunks, and its run() method
+    calls runChunk() for each of them, spread across a ThreadPool's threads. The
+    thread that calls run() works on the chunks too, so it's safe to start a task
+    from inside one of the pool's own jobs.
+
+    You'll only need to use this class directly if the helper functions don't fit
+    what you're trying to do.
+
+    @see parallelFor, parallelReduce, parallelSort
+*/
+class JUCE_API  ParallelTask
+{
+public:
+    //==============================================================================
+    ParallelTask() noexcept {}
+
+    /** Destructor. */
+    virtual ~ParallelTask() {}
+
+    /** Subclasses must do the work for one of the chunks in this method.
+
+        It'll be called once for every chunk index between 0 and (numChunks - 1), on
+        any of the pool's threads or on the thread that called run(), and with many
+        of the chunks running at the same time.
+    */
+    virtual void runChunk (int chunkIndex) = 0;
+
+    /** Runs all the chunks, and returns when they've all finished.
+
+        The chunks are handed out one at a time to whichever thread is free, so a few
+        slow chunks won't hold up the others.
+    */
+    void run (ThreadPool& pool, int numChunks);
+
+    /** Chooses how many chunks a range of items should be divided into.
+
+        This aims for several chunks per thread, so that the load can be balanced if some
+        chunks take longer than others, but never makes any chunk smaller than
+        minItemsPerChunk.
+    */
+    static int getNumChunksToUse (const ThreadPool& pool, int numItems, int minItemsPerChunk) noexcept;
+
+private:
+    class SharedState;
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelTask)
+};
+
+
+//==============================================================================
+/** @internal */
+namespace ParallelAlgorithmHelpers
+{
+    inline int getChunkStart (int chunk, int numItems, int numChunks) noexcept
+    {
+        return (int) ((chunk * (int64) numItems) / numChunks);
+    }
+
+    template <class FunctionType>
+    struct ForTask  : public ParallelTask
+    {
+        ForTask (FunctionType& f, int start_, int numItems_, int numChunks_) noexcept
+            : function (f), start (start_), numItems (numItems_), numChunks (numChunks_) {}
+
+        void runChunk (int chunk)
+        {
+            function (start + getChunkStart (chunk, numItems, numChunks),
+                      start + getChunkStart (chunk + 1, numItems, numChunks));
+        }
+
+        FunctionType& function;
+        const int start, numItems, numChunks;
+
+        JUCE_DECLARE_NON_COPYABLE (ForTask)
+    };
+
+    template <typename ResultType, class FunctionType>
+    struct ReduceTask  : public ParallelTask
+    {
+        ReduceTask (FunctionType& f, int start_, int numItems_, int numChunks_, const ResultType& initialValue)
+            : function (f), start (start_), numItems (numItems_), numChunks (numChunks_)
+        {
+            results.insertMultiple (0, initialValue, numChunks);
+        }
+
+        void runChunk (int chunk)
+        {
+            results.getReference (chunk)
+                = function.processRange (start + getChunkStart (chunk, numItems, numChunks),
+                                         start + getChunkStart (chunk + 1, numItems, numChunks));
+        }
+
+        FunctionType& function;
+        const int start, numItems, numChunks;
+        Array<ResultType> results;
+
+        JUCE_DECLARE_NON_COPYABLE (ReduceTask)
+    };
+
+    template <class ElementType, class ElementComparator>
+    struct SortTask  : public ParallelTask
+    {
+        SortTask (ElementComparator& c, ElementType* e, int numItems_, int numChunks_, bool retainOrder_) noexcept
+            : comparator (c), elements (e), numItems (numItems_), numChunks (numChunks_), retainOrder (retainOrder_) {}
+
+        void runChunk (int chunk)
+        {
+            sortArray (comparator, elements, getChunkStart (chunk, numItems, numChunks),
+                       getChunkStart (chunk + 1, numItems, numChunks) - 1, retainOrder);
+        }
+
+        ElementComparator& comparator;
+        ElementType* const elements;
+        const int numItems, numChunks;
+        const bool retainOrder;
+
+        JUCE_DECLARE_NON_COPYABLE (SortTask)
+    };
+
+    // Each pass merges neighbouring pairs of sorted runs, so the number of runs halves each time.
+    template <class ElementType, class ElementComparator>
+    struct MergeTask  : public ParallelTask
+    {
+        MergeTask (ElementComparator& c, ElementType* e, int numItems_, int numSortedChunks_, int runLength_) noexcept
+            : comparator (c), elements (e), numItems (numItems_), numSortedChunks (numSortedChunks_), runLength (runLength_) {}
+
+        void runChunk (int pair)
+        {
+            const int firstRun = pair * 2 * runLength;
+            const int start  = getChunkStart (firstRun, numItems, numSortedChunks);
+            const int middle = getChunkStart (firstRun + runLength, numItems, numSortedChunks);
+            const int end    = getChunkStart (jmin (numSortedChunks, firstRun + 2 * runLength), numItems, numSortedChunks);
+
+            if (middle >= end
+                 || comparator.compareElements (elements [middle - 1], elements [middle]) <= 0)
+                return; // already in order
+
+            // Copy the first run aside, then merge it with the second run back into place.
+            // Taking from the first run when items are equal keeps the merge stable.
+            Array<ElementType> firstHalf;
+            firstHalf.ensureStorageAllocated (middle - start);
+
+            for (int i = start; i < middle; ++i)
+                firstHalf.add (elements[i]);
+
+            int i = 0, j = middle, dest = start;
+            const int numInFirstHalf = firstHalf.size();
+
+            while (i < numInFirstHalf && j < end)
+            {
+                if (comparator.compareElements (elements[j], firstHalf.getReference (i)) < 0)
+                    elements [dest++] = elements [j++];
+                else
+                    elements [dest++] = firstHalf.getReference (i++);
+            }
+
+            while (i < numInFirstHalf)
+                elements [dest++] = firstHalf.getReference (i++);
+        }
+
+        ElementComparator& comparator;
+        ElementType* const elements;
+        const int numItems, numSortedChunks, runLength;
+
+        JUCE_DECLARE_NON_COPYABLE (MergeTask)
+    };
+}
+
+//==============================================================================
+/**
+    Calls a function for each section of a range of indexes, using a ThreadPool to
+    work on several sections at once.
+
+    The function object must have a method with this signature:
+    @code
+    void operator() (int startIndex, int endIndex);
+    @endcode
+
+    ..which will be called with sections of the range [startIndex, endIndex), on several
+    threads at once, and must deal with each index from startIndex up to (but not including)
+    endIndex. E.g. to process a large array:
+    @code
+    struct Doubler
+    {
+        Doubler (float* data_) : data (data_) {}
+
+        void operator() (int start, int end) const
+        {
+            for (int i = start; i < end; ++i)
+                data[i] *= 2.0f;
+        }
+
+        float* data;
+    };
+
+    Doubler doubler (myHeapBlock);
+    parallelFor (myThreadPool, 0, numItems, doubler);
+    @endcode
+
+    This returns when the whole range has been processed.
+
+    @param pool                 the pool whose threads should be used
+    @param startIndex           the first index to process
+    @param endIndex             the index after the last one to process
+    @param function             the function object to call
+    @param minItemsPerChunk     the smallest number of indexes that will be passed to each
+                                call - if there's very little work to do for each index,
+                                a bigger value avoids wasting time on a lot of tiny calls
+*/
+template <class FunctionType>
+void parallelFor (ThreadPool& pool, int startIndex, int endIndex,
+                  FunctionType& function, int minItemsPerChunk = 1)
+{
+    const int numItems = endIndex - startIndex;
+
+    if (numItems > 0)
+    {
+        const int numChunks = ParallelTask::getNumChunksToUse (pool, numItems, minItemsPerChunk);
+        ParallelAlgorithmHelpers::ForTask<FunctionType> task (function, startIndex, numItems, numChunks);
+        task.run (pool, numChunks);
+    }
+}
+
+//==============================================================================
+/**
+    Combines the results of a function that's applied to sections of a range of indexes,
+    using a ThreadPool to work on several sections at once.
+
+    The function object must have methods with these signatures:
+    @code
+    ResultType processRange (int startIndex, int endIndex);
+    ResultType combine (ResultType first, ResultType second);
+    @endcode
+
+    processRange() will be called on several threads at once, with sections of the range
+    [startIndex, endIndex), and must return the result for that section. The section results
+    are then passed to combine(), in order, starting with initialValue, i.e. the result is
+    combine (combine (combine (initialValue, r0), r1), r2)... Because the sections are
+    always combined in the same order, the result for a given range and chunk size is always
+    the same, even for things like floating-point sums.
+
+    @see parallelFor
+*/
+template <typename ResultType, class FunctionType>
+ResultType parallelReduce (ThreadPool& pool, int startIndex, int endIndex,
+                           const ResultType& initialValue,
+                           FunctionType& function, int minItemsPerChunk = 1)
+{
+    ResultType result (initialValue);
+    const int numItems = endIndex - startIndex;
+
+    if (numItems > 0)
+    {
+        const int numChunks = ParallelTask::getNumChunksToUse (pool, numItems, minItemsPerChunk);
+        ParallelAlgorithmHelpers::ReduceTask<ResultType, FunctionType> task (function, startIndex, numItems, numChunks, initialValue);
+        task.run (pool, numChunks);
+
+        for (int i = 0; i < numChunks; ++i)
+            result = function.combine (result, task.results.getReference (i));
+    }
+
+    return result;
+}
+
+//==============================================================================
+/**
+    Sorts a range of elements in an array, using a ThreadPool to sort several sections
+    at once before merging them together.
+
+    The comparator is the same kind of object that sortArray() uses, and must define this
+    method:
+    @code
+    int compareElements (ElementType first, ElementType second);
+    @endcode
+
+    Its compareElements() method will be called from several threads at once.
+
+    @param pool             the pool whose threads should be used
+    @param elements         the array to sort
+    @param numElements      the number of elements to sort
+    @param comparator       an object which defines a compareElements() method
+    @param retainOrderOfEquivalentItems     if true, the order of items that the comparator
+                            deems the same will be maintained
+    @param minItemsPerChunk the smallest section that will be sorted on its own - there's
+                            no point in splitting up small arrays
+    @see sortArray
+*/
+template <class ElementType, class ElementComparator>
+void parallelSort (ThreadPool& pool, ElementType* const elements, const int numElements,
+                   ElementComparator& comparator, const bool retainOrderOfEquivalentItems = false,
+                   const int minItemsPerChunk = 4096)
+{
+    if (numElements <= 1)
+        return;
+
+    const int numChunks = ParallelTask::getNumChunksToUse (pool, numElements, jmax (2, minItemsPerChunk));
+
+    ParallelAlgorithmHelpers::SortTask<ElementType, ElementComparator> sortTask (comparator, elements, numElements, numChunks, retainOrderOfEquivalentItems);
+    sortTask.run (pool, numChunks);
+
+    for (int runLength = 1; runLength < numChunks; runLength *= 2)
+    {
+        // (a run with no partner is already in place, so only the complete pairs are merged)
+        const int numPairs = (numChunks - runLength + 2 * runLength - 1) / (2 * runLength);
+
+        ParallelAlgorithmHelpers::MergeTask<ElementType, ElementComparator> mergeTask (comparator, elements, numElements, numChunks, runLength);
+        mergeTask.run (pool, numPairs);
+    }
+}
+
+/** Sorts an Array using parallelSort().
+    @see parallelSort, Array::sort
+*/
+template <typename ElementType, typename TypeOfCriticalSectionToUse, class ElementComparator>
+void parallelSort (ThreadPool& pool, Array<ElementType, TypeOfCriticalSectionToUse>& array,
+                   ElementComparator& comparator, const bool retainOrderOfEquivalentItems = false)
+{
+    const typename TypeOfCriticalSectionToUse::ScopedLockType lock (array.getLock());
+    parallelSort (pool, array.getRawDataPointer(), array.size(), comparator, retainOrderOfEquivalentItems);
+}
+
+/** Sorts an OwnedArray using parallelSort().
+    @see parallelSort, OwnedArray::sort
+*/
+template <class ObjectClass, class TypeOfCriticalSectionToUse, class ElementComparator>
+void parallelSort (ThreadPool& pool, OwnedArray<ObjectClass, TypeOfCriticalSectionToUse>& array,
+                   ElementComparator& comparator, const bool retainOrderOfEquivalentItems = false)
+{
+    const typename TypeOfCriticalSectionToUse::ScopedLockType lock (array.getLock());
+    parallelSort (pool, array.getRawDataPointer(), array.size(), comparator, retainOrderOfEquivalentItems);
+}
+
+
+#endif   // __JUCE_PARALLELALGORITHMS_JUCEHEADER__
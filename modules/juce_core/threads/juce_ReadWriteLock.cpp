@@ -24,73 +24,157 @@
 */
 
 ReadWriteLock::ReadWriteLock() noexcept
-    : numWaitingWriters (0),
-      numWriters (0),
-      writerThreadId (0)
+    : slotStorage ((numReaderSlots + 1) * slotSize, true)
 {
-    readerThreads.ensureStorageAllocated (16);
+    // each slot is given a cache line of its own
+    slots = slotStorage + (slotSize - (int) (((pointer_sized_int) slotStorage.getData()) & (slotSize - 1)));
 }
 
 ReadWriteLock::~ReadWriteLock() noexcept
 {
-    jassert (readerThreads.size() == 0);
-    jassert (numWriters == 0);
+    jassert (! hasReadersOtherThan (nullptr));
+    jassert (numWriters.get() == 0);
 }
 
 //==============================================================================
-void ReadWriteLock::enterRead() const noexcept
+ReadWriteLock::ReaderSlot& ReadWriteLock::getSlot (const int index) const noexcept
 {
-    while (! tryEnterRead())
-        waitEvent.wait (100);
+    return *reinterpret_cast<ReaderSlot*> (slots + index * slotSize);
 }
 
-bool ReadWriteLock::tryEnterRead() const noexcept
+ReadWriteLock::ReaderSlot& ReadWriteLock::getHomeSlot (const Thread::ThreadID threadId) const noexcept
 {
-    const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+    const uint64 hash = (uint64) (pointer_sized_uint) threadId * literal64bit (0x9e3779b97f4a7c15);
+    return getSlot ((int) (hash >> 59)); // (the top 5 bits, for 32 slots)
+}
 
-    const SpinLock::ScopedLockType sl (accessLock);
+ReadWriteLock::ReaderSlot* ReadWriteLock::findSlotOwnedBy (const Thread::ThreadID threadId) const noexcept
+{
+    ReaderSlot& home = getHomeSlot (threadId);
+
+    if (home.threadID.get() == threadId)
+        return &home;
+
+    // a thread only uses a slot other than its own home slot when that one's taken, so
+    // there's no need to search the others unless one of them is being used like that
+    if (numDisplacedReaders.get() > 0)
+        for (int i = 0; i < numReaderSlots; ++i)
+            if (getSlot (i).threadID.get() == threadId)
+                return &getSlot (i);
+
+    return nullptr;
+}
+
+ReadWriteLock::ReaderSlot* ReadWriteLock::claimSlot (const Thread::ThreadID threadId) const noexcept
+{
+    ReaderSlot& home = getHomeSlot (threadId);
+
+    if (home.threadID.compareAndSetBool (threadId, nullptr))
+        return &home;
+
+    ++numDisplacedReaders;
+
+    // (the home slot is skipped, because releaseSlot() doesn't count a thread that's using it as displaced)
+    for (int i = 0; i < numReaderSlots; ++i)
+        if (&getSlot (i) != &home && getSlot (i).threadID.compareAndSetBool (threadId, nullptr))
+            return &getSlot (i);
 
-    for (int i = 0; i < readerThreads.size(); ++i)
+    --numDisplacedReaders;
+    return nullptr;
+}
+
+void ReadWriteLock::releaseSlot (ReaderSlot& slot, const Thread::ThreadID threadId) const noexcept
+{
+    slot.threadID = nullptr;
+
+    if (&slot != &getHomeSlot (threadId))
+        --numDisplacedReaders;
+
+    if (numWaitingWriters.get() > 0 || numWaitingReaders.get() > 0)
+        waitEvent.signal();
+}
+
+bool ReadWriteLock::canAddReader (const Thread::ThreadID threadId) const noexcept
+{
+    return numWriters.get() + numWaitingWriters.get() == 0
+            || (numWriters.get() > 0 && writerThreadId.get() == threadId);
+}
+
+bool ReadWriteLock::hasReadersOtherThan (const Thread::ThreadID threadId) const noexcept
+{
+    for (int i = 0; i < numReaderSlots; ++i)
     {
-        ThreadRecursionCount& trc = readerThreads.getReference(i);
+        const Thread::ThreadID owner = getSlot (i).threadID.get();
 
-        if (trc.threadID == threadId)
-        {
-            trc.count++;
+        if (owner != nullptr && owner != threadId)
             return true;
-        }
     }
 
-    if (numWriters + numWaitingWriters == 0
-         || (threadId == writerThreadId && numWriters > 0))
+    return false;
+}
+
+//==============================================================================
+void ReadWriteLock::enterRead() const noexcept
+{
+    while (! tryEnterRead())
+    {
+        // This counts as a waiter before trying again, so that any slot or writer that's
+        // released after the second attempt fails will signal the event. (The time-out is
+        // just a backstop, as a waiting writer could take the signal instead).
+        ++numWaitingReaders;
+        const bool entered = tryEnterRead();
+
+        if (! entered)
+            waitEvent.wait (100);
+
+        --numWaitingReaders;
+
+        if (entered)
+            break;
+    }
+}
+
+bool ReadWriteLock::tryEnterRead() const noexcept
+{
+    const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+
+    if (ReaderSlot* const existing = findSlotOwnedBy (threadId))
     {
-        ThreadRecursionCount trc = { threadId, 1 };
-        readerThreads.add (trc);
+        ++(existing->count);
         return true;
     }
 
-    return false;
+    if (! canAddReader (threadId))
+        return false;
+
+    ReaderSlot* const slot = claimSlot (threadId);
+
+    if (slot == nullptr)
+        return false;
+
+    slot->count = 1;
+
+    // Claiming the slot is a full memory barrier, so if a writer arrived before it became
+    // visible, we'll see that here. Any writer that arrives after it will see our slot.
+    if (! canAddReader (threadId))
+    {
+        releaseSlot (*slot, threadId);
+        return false;
+    }
+
+    return true;
 }
 
 void ReadWriteLock::exitRead() const noexcept
 {
     const Thread::ThreadID threadId = Thread::getCurrentThreadId();
-    const SpinLock::ScopedLockType sl (accessLock);
 
-    for (int i = 0; i < readerThreads.size(); ++i)
+    if (ReaderSlot* const slot = findSlotOwnedBy (threadId))
     {
-        ThreadRecursionCount& trc = readerThreads.getReference(i);
-
-        if (trc.threadID == threadId)
-        {
-            if (--(trc.count) == 0)
-            {
-                readerThreads.remove (i);
-                waitEvent.signal();
-            }
+        if (--(slot->count) == 0)
+            releaseSlot (*slot, threadId);
 
-            return;
-        }
+        return;
     }
 
     jassertfalse; // unlocking a lock that wasn't locked..
@@ -102,24 +186,24 @@ void ReadWriteLock::enterWrite() const noexcept
     const Thread::ThreadID threadId = Thread::getCurrentThreadId();
     const SpinLock::ScopedLockType sl (accessLock);
 
+    ++numWaitingWriters;
+
     for (;;)
     {
-        if (readerThreads.size() + numWriters == 0
-             || threadId == writerThreadId
-             || (readerThreads.size() == 1
-                  && readerThreads.getReference(0).threadID == threadId))
+        if ((numWriters.get() == 0 || threadId == writerThreadId.get())
+              && ! hasReadersOtherThan (threadId))
         {
             writerThreadId = threadId;
             ++numWriters;
             break;
         }
 
-        ++numWaitingWriters;
         accessLock.exit();
         waitEvent.wait (100);
         accessLock.enter();
-        --numWaitingWriters;
     }
+
+    --numWaitingWriters;
 }
 
 bool ReadWriteLock::tryEnterWrite() const noexcept
@@ -127,17 +211,21 @@ bool ReadWriteLock::tryEnterWrite() const noexcept
     const Thread::ThreadID threadId = Thread::getCurrentThreadId();
     const SpinLock::ScopedLockType sl (accessLock);
 
-    if (readerThreads.size() + numWriters == 0
-         || threadId == writerThreadId
-         || (readerThreads.size() == 1
-              && readerThreads.getReference(0).threadID == threadId))
+    ++numWaitingWriters;
+
+    const bool canWrite = (numWriters.get() == 0 || threadId == writerThreadId.get())
+                            && ! hasReadersOtherThan (threadId);
+
+    if (canWrite)
     {
         writerThreadId = threadId;
         ++numWriters;
-        return true;
     }
 
-    return false;
+    if (--numWaitingWriters == 0 && ! canWrite)
+        waitEvent.signal(); // (in case a reader backed off because it saw us)
+
+    return canWrite;
 }
 
 void ReadWriteLock::exitWrite() const noexcept
@@ -145,11 +233,160 @@ void ReadWriteLock::exitWrite() const noexcept
     const SpinLock::ScopedLockType sl (accessLock);
 
     // check this thread actually had the lock..
-    jassert (numWriters > 0 && writerThreadId == Thread::getCurrentThreadId());
+    jassert (numWriters.get() > 0 && writerThreadId.get() == Thread::getCurrentThreadId());
+
+    if (numWriters.get() == 1)
+        writerThreadId = nullptr;
 
     if (--numWriters == 0)
-    {
-        writerThreadId = 0;
         waitEvent.signal();
-    }
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ReadWriteLockTests  : public UnitTest
+{
+public:
+    ReadWriteLockTests() : UnitTest ("ReadWriteLock") {}
+
+    class TestThread  : public Thread
+    {
+    public:
+        TestThread (ReadWriteLock& lock_, int& sharedValue_, const bool isWriter_)
+            : Thread ("rwlock test"), lock (lock_), sharedValue (sharedValue_),
+              isWriter (isWriter_), failed (false)
+        {
+            startThread();
+        }
+
+        ~TestThread()
+        {
+            stopThread (5000);
+        }
+
+        void run()
+        {
+            for (int i = 0; i < 20000 && ! threadShouldExit(); ++i)
+            {
+                if (isWriter)
+                {
+                    const ScopedWriteLock swl (lock);
+                    const int oldValue = sharedValue;
+                    sharedValue = -1;
+                    Thread::yield();
+                    sharedValue = oldValue + 1;
+                }
+                else
+                {
+                    const ScopedReadLock srl (lock);
+
+                    if (sharedValue < 0)
+                        failed = true;
+                }
+            }
+        }
+
+        ReadWriteLock& lock;
+        int& sharedValue;
+        const bool isWriter;
+        bool failed;
+    };
+
+    class SlotHolderThread  : public Thread
+    {
+    public:
+        SlotHolderThread (ReadWriteLock& lock_)
+            : Thread ("rwlock test"), lock (lock_), hasEntered (false)
+        {
+        }
+
+        ~SlotHolderThread()
+        {
+            release.signal();
+            stopThread (5000);
+        }
+
+        void run()
+        {
+            lock.enterRead();
+            hasEntered = true;
+            entered.signal();
+            release.wait();
+            lock.exitRead();
+        }
+
+        ReadWriteLock& lock;
+        WaitableEvent entered, release;
+        bool volatile hasEntered;
+    };
+
+    void runTest()
+    {
+        beginTest ("Recursion");
+
+        ReadWriteLock lock;
+
+        lock.enterRead();
+        expect (lock.tryEnterRead());
+        expect (lock.tryEnterWrite());   // (the only reader can also write)
+        lock.exitWrite();
+        lock.exitRead();
+        lock.exitRead();
+
+        lock.enterWrite();
+        expect (lock.tryEnterWrite());
+        expect (lock.tryEnterRead());
+        lock.exitRead();
+        lock.exitWrite();
+        lock.exitWrite();
+
+        beginTest ("Threads");
+
+        int sharedValue = 0;
+        bool anyFailed = false;
+
+        {
+            OwnedArray<TestThread> threads;
+
+            for (int i = 0; i < 6; ++i)
+                threads.add (new TestThread (lock, sharedValue, i < 2));
+
+            for (int i = 0; i < threads.size(); ++i)
+            {
+                expect (threads.getUnchecked(i)->waitForThreadToExit (60000));
+                anyFailed = anyFailed || threads.getUnchecked(i)->failed;
+            }
+        }
+
+        expect (! anyFailed, "a reader saw a half-finished write");
+        expectEquals (sharedValue, 40000);
+
+        beginTest ("Waiting for a reader slot");
+
+        {
+            OwnedArray<SlotHolderThread> holders;
+
+            for (int i = 0; i < 32; ++i)  // (one for each of the lock's reader slots)
+            {
+                SlotHolderThread* const t = new SlotHolderThread (lock);
+                holders.add (t);
+                t->startThread();
+                expect (t->entered.wait (5000));
+            }
+
+            SlotHolderThread lateReader (lock);
+            lateReader.startThread();
+
+            expect (! lateReader.entered.wait (200));
+            expect (! lateReader.hasEntered);
+
+            holders.getUnchecked (7)->release.signal();
+            expect (lateReader.entered.wait (5000));
+        }
+    }
+};
+
+static ReadWriteLockTests readWriteLockUnitTests;
+
+#endif
@@ -30,7 +30,7 @@
 #include "juce_SpinLock.h"
 #include "juce_WaitableEvent.h"
 #include "juce_Thread.h"
-#include "../containers/juce_Array.h"
+#include "../memory/juce_HeapBlock.h"
 
 
 //==============================================================================
@@ -50,6 +50,12 @@
     - If a thread already has the write lock and tries to obtain a read lock, this will succeed.
     - Recursive locking is supported.
 
+    Readers don't share any lock with each other: each reading thread registers itself in
+    one of a set of slots which are kept on separate cache lines, so a read-heavy lock that's
+    used by threads on many cores scales well. Writers have to check all the slots, so they're
+    a bit slower than they would be with a simple mutex. If more than 32 threads try to hold
+    the read lock at once, the extra ones will wait until a slot becomes free.
+
     @see ScopedReadLock, ScopedWriteLock, CriticalSection
 */
 class JUCE_API  ReadWriteLock
@@ -136,18 +142,28 @@ public:
 
 private:
     //==============================================================================
-    SpinLock accessLock;
-    WaitableEvent waitEvent;
-    mutable int numWaitingWriters, numWriters;
-    mutable Thread::ThreadID writerThreadId;
+    enum { numReaderSlots = 32, slotSize = 64 };
 
-    struct ThreadRecursionCount
+    struct ReaderSlot
     {
-        Thread::ThreadID threadID;
-        int count;
+        Atomic<Thread::ThreadID> threadID;
+        int count;  // (only ever used by the thread that owns the slot)
     };
 
-    mutable Array <ThreadRecursionCount> readerThreads;
+    SpinLock accessLock;
+    WaitableEvent waitEvent;
+    mutable Atomic<int> numWaitingWriters, numWriters, numDisplacedReaders, numWaitingReaders;
+    mutable Atomic<Thread::ThreadID> writerThreadId;
+    HeapBlock<char> slotStorage;
+    char* slots;
+
+    ReaderSlot& getSlot (int index) const noexcept;
+    ReaderSlot& getHomeSlot (Thread::ThreadID) const noexcept;
+    ReaderSlot* findSlotOwnedBy (Thread::ThreadID) const noexcept;
+    ReaderSlot* claimSlot (Thread::ThreadID) const noexcept;
+    void releaseSlot (ReaderSlot&, Thread::ThreadID) const noexcept;
+    bool canAddReader (Thread::ThreadID) const noexcept;
+    bool hasReadersOtherThan (Thread::ThreadID) const noexcept;
 
     JUCE_DECLARE_NON_COPYABLE (ReadWriteLock)
 };
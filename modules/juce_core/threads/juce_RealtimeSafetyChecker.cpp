@@ -0,0 +1,266 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace RealtimeSafetyHelpers
+{
+    struct ThreadDepths
+    {
+        int realtime, suspension;
+
+       #if JUCE_NO_COMPILER_THREAD_LOCAL
+        Atomic<Thread::ThreadID> owner;
+       #endif
+    };
+
+   #if JUCE_NO_COMPILER_THREAD_LOCAL
+    /*  Without compiler support for thread-locals, each thread that's inside a ScopedRealtimeContext
+        or ScopedSuspension claims a slot in this table. It's a fixed-size table rather than a
+        ThreadLocalValue, because the lookup happens inside operator new, so it mustn't allocate.
+    */
+    enum { maxThreads = 64 };
+    static ThreadDepths threadDepths [maxThreads];
+    static ThreadDepths overflowDepths;
+
+    static ThreadDepths* getDepths (const bool claimIfMissing) noexcept
+    {
+        const Thread::ThreadID currentThread = Thread::getCurrentThreadId();
+
+        for (int i = 0; i < maxThreads; ++i)
+            if (threadDepths[i].owner.get() == currentThread)
+                return threadDepths + i;
+
+        if (! claimIfMissing)
+            return nullptr;
+
+        for (int i = 0; i < maxThreads; ++i)
+        {
+            if (threadDepths[i].owner.compareAndSetBool (currentThread, Thread::ThreadID()))
+            {
+                threadDepths[i].realtime = 0;
+                threadDepths[i].suspension = 0;
+                return threadDepths + i;
+            }
+        }
+
+        // If you hit this, there are more than maxThreads threads inside real-time
+        // contexts at once, so their checks will get mixed up.
+        jassertfalse;
+        return &overflowDepths;
+    }
+
+    static void releaseDepthsIfUnused (ThreadDepths& d) noexcept
+    {
+        if (d.realtime == 0 && d.suspension == 0)
+            d.owner = Thread::ThreadID();
+    }
+   #else
+    #if JUCE_MSVC
+     static __declspec(thread) ThreadDepths currentThreadDepths;
+    #else
+     static __thread ThreadDepths currentThreadDepths;
+    #endif
+
+    static ThreadDepths* getDepths (bool) noexcept              { return &currentThreadDepths; }
+    static void releaseDepthsIfUnused (ThreadDepths&) noexcept  {}
+   #endif
+
+    static RealtimeSafetyChecker::ViolationHandler violationHandler = nullptr;
+
+    static void defaultViolationHandler (const char* const operationName)
+    {
+        Logger::outputDebugString ("*** Real-time safety violation: " + String (operationName)
+                                     + " was called on a real-time thread" + newLine
+                                     + SystemStats::getStackBacktrace());
+
+        // If you hit this, then code running on a real-time thread has allocated or freed
+        // memory, locked a CriticalSection, or waited or slept. Check the backtrace that
+        // was just logged to see where it happened.
+        jassertfalse;
+    }
+}
+
+RealtimeSafetyChecker::ScopedRealtimeContext::ScopedRealtimeContext() noexcept
+{
+    ++(RealtimeSafetyHelpers::getDepths (true)->realtime);
+}
+
+RealtimeSafetyChecker::ScopedRealtimeContext::~ScopedRealtimeContext() noexcept
+{
+    if (RealtimeSafetyHelpers::ThreadDepths* const d = RealtimeSafetyHelpers::getDepths (false))
+    {
+        --(d->realtime);
+        RealtimeSafetyHelpers::releaseDepthsIfUnused (*d);
+    }
+}
+
+RealtimeSafetyChecker::ScopedSuspension::ScopedSuspension() noexcept
+{
+    ++(RealtimeSafetyHelpers::getDepths (true)->suspension);
+}
+
+RealtimeSafetyChecker::ScopedSuspension::~ScopedSuspension() noexcept
+{
+    if (RealtimeSafetyHelpers::ThreadDepths* const d = RealtimeSafetyHelpers::getDepths (false))
+    {
+        --(d->suspension);
+        RealtimeSafetyHelpers::releaseDepthsIfUnused (*d);
+    }
+}
+
+bool RealtimeSafetyChecker::isCurrentThreadRealtime() noexcept
+{
+    const RealtimeSafetyHelpers::ThreadDepths* const d = RealtimeSafetyHelpers::getDepths (false);
+    return d != nullptr && d->realtime > 0 && d->suspension == 0;
+}
+
+void RealtimeSafetyChecker::checkOperation (const char* const operationName)
+{
+    if (isCurrentThreadRealtime())
+    {
+        const ScopedSuspension suspension; // (the handler will almost certainly need to allocate)
+
+        if (RealtimeSafetyHelpers::violationHandler != nullptr)
+            RealtimeSafetyHelpers::violationHandler (operationName);
+        else
+            RealtimeSafetyHelpers::defaultViolationHandler (operationName);
+    }
+}
+
+void RealtimeSafetyChecker::setViolationHandler (ViolationHandler newHandler) noexcept
+{
+    RealtimeSafetyHelpers::violationHandler = newHandler;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class RealtimeSafetyCheckerTests  : public UnitTest
+{
+public:
+    RealtimeSafetyCheckerTests() : UnitTest ("RealtimeSafetyChecker") {}
+
+    static int numViolations;
+    static const char* lastOperation;
+    static int* volatile escapedPointer;
+
+    static void countViolation (const char* operationName)
+    {
+        ++numViolations;
+        lastOperation = operationName;
+    }
+
+    void runTest()
+    {
+        beginTest ("Marking threads");
+
+        RealtimeSafetyChecker::setViolationHandler (countViolation);
+        numViolations = 0;
+
+        expect (! RealtimeSafetyChecker::isCurrentThreadRealtime());
+        RealtimeSafetyChecker::checkOperation ("test");
+        expectEquals (numViolations, 0);
+
+        bool wasRealtime, wasSuspended, wasRealtimeAfterNesting;
+        int afterCheck, afterSuspendedCheck;
+
+        {
+            const RealtimeSafetyChecker::ScopedRealtimeContext realtimeContext;
+            wasRealtime = RealtimeSafetyChecker::isCurrentThreadRealtime();
+
+            RealtimeSafetyChecker::checkOperation ("test");
+            afterCheck = numViolations;
+
+            {
+                const RealtimeSafetyChecker::ScopedRealtimeContext nestedContext;
+                const RealtimeSafetyChecker::ScopedSuspension suspension;
+
+                wasSuspended = ! RealtimeSafetyChecker::isCurrentThreadRealtime();
+                RealtimeSafetyChecker::checkOperation ("test");
+                afterSuspendedCheck = numViolations;
+            }
+
+            wasRealtimeAfterNesting = RealtimeSafetyChecker::isCurrentThreadRealtime();
+        }
+
+        expect (wasRealtime && wasSuspended && wasRealtimeAfterNesting);
+        expect (! RealtimeSafetyChecker::isCurrentThreadRealtime());
+        expectEquals (afterCheck, 1);
+        expectEquals (afterSuspendedCheck, 1);
+        expectEquals (String (lastOperation), String ("test"));
+
+       #if JUCE_CHECK_REALTIME_SAFETY
+        beginTest ("Catching operations");
+
+        // (the expect() calls are kept outside the real-time context, because they allocate)
+        CriticalSection lock;
+        int afterEmptyBlock, afterMalloc, afterNew, afterFrees, afterTryEnter, afterEnter;
+        numViolations = 0;
+
+        {
+            const RealtimeSafetyChecker::ScopedRealtimeContext realtimeContext;
+
+            HeapBlock<int> block;
+            afterEmptyBlock = numViolations;
+
+            block.malloc (16);
+            afterMalloc = numViolations;
+
+            escapedPointer = new int (1); // (stored in a volatile so the compiler can't elide the allocation)
+            afterNew = numViolations;
+
+            delete escapedPointer;
+            block.free();
+            afterFrees = numViolations;
+
+            if (lock.tryEnter())
+                lock.exit();
+
+            afterTryEnter = numViolations;
+
+            lock.enter();
+            lock.exit();
+            afterEnter = numViolations;
+        }
+
+        expectEquals (afterEmptyBlock, 0);
+        expectEquals (afterMalloc, 1);
+        expectEquals (afterNew, 2);
+        expectEquals (afterFrees, 4);
+        expectEquals (afterTryEnter, 4);
+        expectEquals (afterEnter, 5);
+        expectEquals (numViolations, 5);
+       #endif
+
+        RealtimeSafetyChecker::setViolationHandler (nullptr);
+    }
+};
+
+int RealtimeSafetyCheckerTests::numViolations = 0;
+const char* RealtimeSafetyCheckerTests::lastOperation = nullptr;
+int* volatile RealtimeSafetyCheckerTests::escapedPointer = nullptr;
+
+static RealtimeSafetyCheckerTests realtimeSafetyCheckerTests;
+
+#endif
@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_REALTIMESAFETYCHECKER_JUCEHEADER__
+#define __JUCE_REALTIMESAFETYCHECKER_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A debugging aid that catches operations which shouldn't be performed on a
+    real-time thread, such as an audio callback.
+
+    A thread marks the code that must be real-time safe by creating a
+    ScopedRealtimeContext. While one of those exists, if JUCE_CHECK_REALTIME_SAFETY
+    is enabled, any of these operations performed by that thread will be reported:
+
+    - allocating or freeing memory with the global new and delete operators, or
+      with a HeapBlock (which is what the container classes use)
+    - blocking on a CriticalSection with enter()
+    - waiting on a WaitableEvent
+    - calling Thread::sleep()
+
+    The default handler writes the name of the operation and a stack backtrace to
+    the debug output and then triggers an assertion, so you can see exactly which
+    call made it. You can supply your own handler with setViolationHandler().
+
+    @code
+    void MyCallback::audioDeviceIOCallback (const float** inputChannelData, int numInputChannels,
+                                            float** outputChannelData, int numOutputChannels,
+                                            int numSamples)
+    {
+        const RealtimeSafetyChecker::ScopedRealtimeContext realtimeContext;
+        ...
+    }
+    @endcode
+
+    AudioProcessorPlayer uses this around its calls to AudioProcessor::processBlock().
+
+    When JUCE_CHECK_REALTIME_SAFETY is disabled, none of the checks are compiled in,
+    and marking a thread costs next to nothing.
+
+    @see JUCE_CHECK_REALTIME_SAFETY
+*/
+class JUCE_API  RealtimeSafetyChecker
+{
+public:
+    //==============================================================================
+    /** Marks the current thread as being real-time for as long as this object exists.
+        These can be nested.
+    */
+    class JUCE_API  ScopedRealtimeContext
+    {
+    public:
+        ScopedRealtimeContext() noexcept;
+        ~ScopedRealtimeContext() noexcept;
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (ScopedRealtimeContext)
+    };
+
+    /** Turns off the checks on the current thread while this object exists.
+        This lets you deliberately perform an operation that you know is acceptable,
+        e.g. a lock that is never contended, without it being reported.
+    */
+    class JUCE_API  ScopedSuspension
+    {
+    public:
+        ScopedSuspension() noexcept;
+        ~ScopedSuspension() noexcept;
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (ScopedSuspension)
+    };
+
+    //==============================================================================
+    /** Returns true if the calling thread is inside a ScopedRealtimeContext, and
+        isn't inside a ScopedSuspension.
+    */
+    static bool isCurrentThreadRealtime() noexcept;
+
+    /** Reports the given operation to the violation handler if the calling thread
+        is currently real-time.
+        You can call this from your own code, to mark other operations that mustn't
+        happen on a real-time thread.
+        @param operationName    a string literal describing the operation
+    */
+    static void checkOperation (const char* operationName);
+
+    //==============================================================================
+    /** A function that is called when a real-time thread performs an operation
+        that isn't allowed. Checking is suspended while the handler is running.
+    */
+    typedef void (*ViolationHandler) (const char* operationName);
+
+    /** Replaces the function that gets called when an operation is caught.
+        Passing nullptr restores the default handler, which logs a stack backtrace and
+        triggers an assertion.
+    */
+    static void setViolationHandler (ViolationHandler newHandler) noexcept;
+};
+
+//==============================================================================
+#if JUCE_CHECK_REALTIME_SAFETY || DOXYGEN
+ /** Reports the named operation if it's called on a real-time thread.
+     This compiles to nothing unless JUCE_CHECK_REALTIME_SAFETY is enabled.
+     @see RealtimeSafetyChecker
+ */
+ #define JUCE_REALTIME_SAFETY_CHECK(operationName)      juce::RealtimeSafetyChecker::checkOperation (operationName);
+
+ /** Reports a deallocation if it's called on a real-time thread with a non-null pointer.
+     This compiles to nothing unless JUCE_CHECK_REALTIME_SAFETY is enabled.
+     @see RealtimeSafetyChecker
+ */
+ #define JUCE_REALTIME_SAFETY_CHECK_FREE(pointer)       if ((pointer) != nullptr) juce::RealtimeSafetyChecker::checkOperation ("free");
+#else
+ #define JUCE_REALTIME_SAFETY_CHECK(operationName)
+ #define JUCE_REALTIME_SAFETY_CHECK_FREE(pointer)
+#endif
+
+
+#endif   // __JUCE_REALTIMESAFETYCHECKER_JUCEHEADER__
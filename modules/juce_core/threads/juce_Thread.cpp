@@ -29,6 +29,7 @@ Thread::Thread (const String& threadName_)
       threadId (0),
       threadPriority (5),
       affinityMask (0),
+      isRealtimeThread (false),
       shouldExit (false)
 {
 }
@@ -90,6 +91,9 @@ void Thread::threadEntryPoint()
             if (affinityMask != 0)
                 setCurrentThreadAffinityMask (affinityMask);
 
+            if (isRealtimeThread)
+                setCurrentThreadRealtime (realtimeOptions);
+
             run();
         }
     }
@@ -127,6 +131,7 @@ void Thread::startThread (const int priority)
     if (threadHandle == nullptr)
     {
         threadPriority = priority;
+        isRealtimeThread = false;
         startThread();
     }
     else
@@ -135,6 +140,29 @@ void Thread::startThread (const int priority)
     }
 }
 
+Thread::RealtimeOptions::RealtimeOptions() noexcept
+    : periodMs (0), computationMs (0), deadlineMs (0)
+{
+}
+
+Thread::RealtimeOptions::RealtimeOptions (const double period, const double computation, const double deadline) noexcept
+    : periodMs (period), computationMs (computation), deadlineMs (deadline)
+{
+}
+
+void Thread::startRealtimeThread (const RealtimeOptions& options)
+{
+    const ScopedLock sl (startStopLock);
+
+    if (threadHandle == nullptr)
+    {
+        realtimeOptions = options;
+        isRealtimeThread = true;
+        threadPriority = 10;
+        startThread();
+    }
+}
+
 bool Thread::isThreadRunning() const
 {
     return threadHandle != nullptr;
@@ -241,16 +269,45 @@ void Thread::notify() const
 }
 
 //==============================================================================
+namespace SpinLockHelpers
+{
+    // tells the CPU that we're in a spin-wait loop, so that it can save power and
+    // give more resources to any other hardware threads on the same core
+    static inline void pause() noexcept
+    {
+       #if JUCE_MSVC
+        YieldProcessor();
+       #elif JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+        __asm__ __volatile__ ("pause");
+       #elif (JUCE_GCC || JUCE_CLANG) && (defined (__aarch64__) || (defined (__ARM_ARCH) && __ARM_ARCH >= 7))
+        __asm__ __volatile__ ("yield");
+       #endif
+    }
+}
+
 void SpinLock::enter() const noexcept
 {
     if (! tryEnter())
     {
-        for (int i = 20; --i >= 0;)
-            if (tryEnter())
+        // While the lock is held, just watch its value rather than repeatedly trying to
+        // write to it, which would keep stealing the cache line from the owner. The wait
+        // between attempts doubles each time to avoid having every waiter pounce at once.
+        for (int numPauses = 1; numPauses <= 64; numPauses *= 2)
+        {
+            for (int i = numPauses; --i >= 0;)
+                SpinLockHelpers::pause();
+
+            if (lock.value == 0 && tryEnter())
+                return;
+        }
+
+        for (;;)
+        {
+            if (lock.value == 0 && tryEnter())
                 return;
 
-        while (! tryEnter())
             Thread::yield();
+        }
     }
 }
 
@@ -163,6 +163,9 @@ public:
     */
     bool setPriority (int priority);
 
+    /** Returns the priority that the thread was started with, or last given by setPriority(). */
+    int getPriority() const noexcept                    { return threadPriority; }
+
     /** Changes the priority of the caller thread.
 
         Similar to setPriority(), but this static method acts on the caller thread.
@@ -172,6 +175,69 @@ public:
     */
     static bool setCurrentThreadPriority (int priority);
 
+    //==============================================================================
+    /** Describes the timing of a thread that has to meet deadlines, such as one that
+        renders audio.
+        @see startRealtimeThread, setCurrentThreadRealtime
+    */
+    struct JUCE_API  RealtimeOptions
+    {
+        /** Creates a set of options for a thread that isn't periodic. */
+        RealtimeOptions() noexcept;
+
+        /** Creates a set of options for a thread that does some work at regular intervals.
+            The times are all in milliseconds - see the member variables for details.
+        */
+        RealtimeOptions (double periodMs, double computationMs = 0, double deadlineMs = 0) noexcept;
+
+        /** How often the thread has work to do, or 0 if it doesn't run at regular intervals. */
+        double periodMs;
+
+        /** How much processor time the thread needs in each period, or 0 to use a default of
+            half the deadline.
+        */
+        double computationMs;
+
+        /** How long after the start of each period the work has to be finished, or 0 if it
+            just needs to be done within the period.
+        */
+        double deadlineMs;
+    };
+
+    /** Starts the thread, asking the OS to schedule it as a real-time thread.
+
+        The thread gets the highest priority, and as soon as it starts running it calls
+        setCurrentThreadRealtime() with these options before calling run(). If the OS
+        refuses, the thread still runs, at the highest normal priority.
+
+        If the thread is already running, this does nothing. A later call to startThread (int)
+        will go back to starting it as a normal thread.
+
+        @see setCurrentThreadRealtime
+    */
+    void startRealtimeThread (const RealtimeOptions& options);
+
+    /** Returns true if the thread was last started with startRealtimeThread(). */
+    bool isRealtime() const noexcept                    { return isRealtimeThread; }
+
+    /** Asks the OS to schedule the caller thread as a real-time thread.
+
+        What this does depends on the platform:
+        - On OSX and iOS, the thread is given the Mach time-constraint policy, using the
+          period, computation and deadline from the options.
+        - On Linux and Android, the thread is moved to the SCHED_FIFO class. The timing
+          information isn't used. If Android refuses, the thread is given the same nice
+          level as the system's audio threads instead.
+        - On Windows, the thread joins the "Pro Audio" MMCSS task (on Vista or later) and is
+          given time-critical priority. The timing information isn't used.
+
+        Most systems only let privileged processes do this (e.g. on Linux, the user needs
+        an rtprio limit), so be ready for it to fail.
+
+        @returns true if the OS granted real-time scheduling
+    */
+    static bool setCurrentThreadRealtime (const RealtimeOptions& options);
+
     //==============================================================================
     /** Sets the affinity mask for the thread.
 
@@ -271,6 +337,8 @@ private:
     WaitableEvent startSuspensionEvent, defaultEvent;
     int threadPriority;
     uint32 affinityMask;
+    RealtimeOptions realtimeOptions;
+    bool isRealtimeThread;
     bool volatile shouldExit;
 
    #ifndef DOXYGEN
@@ -26,6 +26,9 @@
 ThreadPoolJob::ThreadPoolJob (const String& name)
     : jobName (name),
       pool (nullptr),
+      previousJob (nullptr),
+      nextJob (nullptr),
+      priority (ThreadPool::normalPriority),
       shouldStop (false),
       isActive (false),
       shouldBeDeleted (false)
@@ -54,13 +57,87 @@ void ThreadPoolJob::signalJobShouldExit()
     shouldStop = true;
 }
 
+//==============================================================================
+namespace ThreadPoolHelpers
+{
+    /*  A fixed-size work-stealing deque (after Chase & Lev). Only the thread that owns
+        it may push() and pop() at the bottom, but any thread may steal() from the top.
+        The owner only has to compete with the thieves for the very last item.
+    */
+    template <typename ItemType>
+    class WorkStealingQueue
+    {
+    public:
+        WorkStealingQueue() noexcept {}
+
+        bool push (const ItemType& item) noexcept
+        {
+            const uint32 b = bottom.get();
+
+            if ((int) (b - top.get()) >= (int) capacity)
+                return false;
+
+            items [b & (capacity - 1)] = item;
+            bottom = b + 1;
+            return true;
+        }
+
+        bool pop (ItemType& result) noexcept
+        {
+            const uint32 b = bottom.get() - 1;
+            bottom = b;
+            const uint32 t = top.get();
+            const int numLeft = (int) (b - t);
+
+            if (numLeft < 0)
+            {
+                bottom = t;
+                return false;
+            }
+
+            result = items [b & (capacity - 1)];
+
+            if (numLeft > 0)
+                return true;
+
+            // this is the last item, so we have to race any thieves for it..
+            const bool gotIt = top.compareAndSetBool (t + 1, t);
+            bottom = t + 1;
+            return gotIt;
+        }
+
+        bool steal (ItemType& result) noexcept
+        {
+            const uint32 t = top.get();
+
+            if ((int) (bottom.get() - t) <= 0)
+                return false;
+
+            result = items [t & (capacity - 1)];
+            return top.compareAndSetBool (t + 1, t);
+        }
+
+        bool isEmpty() const noexcept           { return (int) (bottom.get() - top.get()) <= 0; }
+
+        enum { capacity = 1024 }; // (must be a power of 2)
+
+    private:
+        // (the indexes are allowed to wrap around, so are only ever compared by their difference)
+        Atomic<uint32> top, bottom;
+        ItemType items [capacity];
+
+        JUCE_DECLARE_NON_COPYABLE (WorkStealingQueue)
+    };
+}
+
 //==============================================================================
 class ThreadPool::ThreadPoolThread  : public Thread
 {
 public:
-    ThreadPoolThread (ThreadPool& pool_)
+    ThreadPoolThread (ThreadPool& pool_, const int index_)
         : Thread ("Pool"),
-          pool (pool_)
+          pool (pool_),
+          index (index_)
     {
     }
 
@@ -68,19 +145,110 @@ public:
     {
         while (! threadShouldExit())
         {
-            if (! pool.runNextJob())
+            if (pool.runNextJob (*this))
+                continue;
+
+            isIdle = 1;
+
+            // (this re-check makes sure a job that was added just before we
+            // became idle can't be missed)
+            if (! pool.hasQueuedJobs())
                 wait (500);
+
+            isIdle = 0;
         }
     }
 
-private:
     ThreadPool& pool;
+    const int index;
+    Atomic<int> isIdle;
+    ThreadPoolHelpers::WorkStealingQueue<FunctionJob> localJobs [numPriorityLevels];
 
+private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
 };
 
+//==============================================================================
+/*  Holds the function jobs that are added from outside the pool's threads, or which
+    overflow a thread's local queue. Threads take them from here in small batches,
+    so the lock is only held very briefly, and only occasionally.
+*/
+class ThreadPool::FunctionJobQueue
+{
+public:
+    FunctionJobQueue()
+        : capacity (0), start (0), numItems (0)
+    {
+    }
+
+    /** Adds a job, returning true if the queue was empty beforehand. */
+    bool add (const FunctionJob& job)
+    {
+        const SpinLock::ScopedLockType sl (lock);
+
+        if (numItems >= capacity)
+        {
+            const int newCapacity = jmax (64, capacity * 2);
+            HeapBlock<FunctionJob> newItems ((size_t) newCapacity);
+
+            for (int i = 0; i < numItems; ++i)
+                newItems[i] = items [(start + i) % capacity];
+
+            items.swapWith (newItems);
+            capacity = newCapacity;
+            start = 0;
+        }
+
+        items [(start + numItems) % capacity] = job;
+        numQueued = ++numItems;
+        return numItems == 1;
+    }
+
+    /** Takes the next job, and moves up to maxToMove more of the following ones into
+        the given thread's local queue.
+    */
+    bool take (FunctionJob& result, ThreadPoolHelpers::WorkStealingQueue<FunctionJob>& localQueue, int maxToMove)
+    {
+        if (numQueued.value == 0)
+            return false;
+
+        const SpinLock::ScopedLockType sl (lock);
+
+        if (numItems == 0)
+            return false;
+
+        result = removeFirst();
+
+        while (numItems > 0 && --maxToMove >= 0 && localQueue.push (items [start]))
+            removeFirst();
+
+        numQueued = numItems;
+        return true;
+    }
+
+    bool isEmpty() const noexcept       { return numQueued.get() == 0; }
+    int getNumQueued() const noexcept   { return numQueued.value; }
+
+private:
+    SpinLock lock;
+    HeapBlock<FunctionJob> items;
+    int capacity, start, numItems;
+    Atomic<int> numQueued;
+
+    FunctionJob removeFirst() noexcept
+    {
+        const FunctionJob job (items [start]);
+        start = (start + 1) % capacity;
+        --numItems;
+        return job;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (FunctionJobQueue)
+};
+
 //==============================================================================
 ThreadPool::ThreadPool (const int numThreads)
+    : numJobs (0)
 {
     jassert (numThreads > 0); // not much point having a pool without any threads!
 
@@ -88,6 +256,7 @@ ThreadPool::ThreadPool (const int numThreads)
 }
 
 ThreadPool::ThreadPool()
+    : numJobs (0)
 {
     createThreads (SystemStats::getNumCpus());
 }
@@ -100,8 +269,16 @@ ThreadPool::~ThreadPool()
 
 void ThreadPool::createThreads (int numThreads)
 {
-    for (int i = jmax (1, numThreads); --i >= 0;)
-        threads.add (new ThreadPoolThread (*this));
+    for (int i = 0; i < numPriorityLevels; ++i)
+    {
+        pendingJobs[i].first = pendingJobs[i].last = nullptr;
+        functionJobQueues.add (new FunctionJobQueue());
+    }
+
+    runningJobs.first = runningJobs.last = nullptr;
+
+    for (int i = 0; i < jmax (1, numThreads); ++i)
+        threads.add (new ThreadPoolThread (*this, i));
 
     for (int i = threads.size(); --i >= 0;)
         threads.getUnchecked(i)->startThread();
@@ -116,7 +293,7 @@ void ThreadPool::stopThreads()
         threads.getUnchecked(i)->stopThread (500);
 }
 
-void ThreadPool::addJob (ThreadPoolJob* const job, const bool deleteJobWhenFinished)
+void ThreadPool::addJob (ThreadPoolJob* const job, const bool deleteJobWhenFinished, const JobPriority priority)
 {
     jassert (job != nullptr);
     jassert (job->pool == nullptr);
@@ -127,38 +304,89 @@ void ThreadPool::addJob (ThreadPoolJob* const job, const bool deleteJobWhenFinis
         job->shouldStop = false;
         job->isActive = false;
         job->shouldBeDeleted = deleteJobWhenFinished;
+        job->priority = jlimit (0, (int) numPriorityLevels - 1, (int) priority);
 
         {
             const ScopedLock sl (lock);
-            jobs.add (job);
+            appendToList (pendingJobs [job->priority], job);
+            ++numJobs;
+            ++numPendingJobs;
         }
 
-        for (int i = threads.size(); --i >= 0;)
-            threads.getUnchecked(i)->notify();
+        wakeIdleThread();
     }
 }
 
+void ThreadPool::addJob (JobFunction* const function, void* const userData, const JobPriority priority)
+{
+    jassert (function != nullptr);
+
+    FunctionJob job;
+    job.function = function;
+    job.userData = userData;
+
+    const int level = jlimit (0, (int) numPriorityLevels - 1, (int) priority);
+    ThreadPoolThread* const currentThread = getCurrentPoolThread();
+    bool wasEmpty;
+
+    if (currentThread != nullptr && currentThread->localJobs[level].isEmpty())
+        wasEmpty = currentThread->localJobs[level].push (job);
+    else if (currentThread == nullptr || ! currentThread->localJobs[level].push (job))
+        wasEmpty = functionJobQueues.getUnchecked (level)->add (job);
+    else
+        wasEmpty = false;
+
+    // If the queue already had jobs in it, then a thread has either been woken up for
+    // them already, or will wake another one when it picks one up (see runNextJob()), so
+    // there's no need to pay for a notification on every call when adding a large batch.
+    if (wasEmpty)
+        wakeIdleThread();
+}
+
 int ThreadPool::getNumJobs() const
 {
-    return jobs.size();
+    return numJobs;
+}
+
+int ThreadPool::getNumThreads() const noexcept
+{
+    return threads.size();
 }
 
-ThreadPoolJob* ThreadPool::getJob (const int index) const
+ThreadPoolJob* ThreadPool::getJob (int index) const
 {
     const ScopedLock sl (lock);
-    return jobs [index];
+
+    for (ThreadPoolJob* job = runningJobs.first; job != nullptr; job = job->nextJob)
+        if (--index < 0)
+            return job;
+
+    for (int i = numPriorityLevels; --i >= 0;)
+        for (ThreadPoolJob* job = pendingJobs[i].first; job != nullptr; job = job->nextJob)
+            if (--index < 0)
+                return job;
+
+    return nullptr;
 }
 
 bool ThreadPool::contains (const ThreadPoolJob* const job) const
 {
     const ScopedLock sl (lock);
-    return jobs.contains (const_cast <ThreadPoolJob*> (job));
+
+    if (listContains (runningJobs, job))
+        return true;
+
+    for (int i = numPriorityLevels; --i >= 0;)
+        if (listContains (pendingJobs[i], job))
+            return true;
+
+    return false;
 }
 
 bool ThreadPool::isJobRunning (const ThreadPoolJob* const job) const
 {
     const ScopedLock sl (lock);
-    return jobs.contains (const_cast <ThreadPoolJob*> (job)) && job->isActive;
+    return listContains (runningJobs, job);
 }
 
 bool ThreadPool::waitForJobToFinish (const ThreadPoolJob* const job,
@@ -191,19 +419,25 @@ bool ThreadPool::removeJob (ThreadPoolJob* const job,
     {
         const ScopedLock sl (lock);
 
-        if (jobs.contains (job))
+        if (listContains (runningJobs, job))
         {
-            if (job->isActive)
-            {
-                if (interruptIfRunning)
-                    job->signalJobShouldExit();
+            if (interruptIfRunning)
+                job->signalJobShouldExit();
 
-                dontWait = false;
-            }
-            else
+            dontWait = false;
+        }
+        else
+        {
+            for (int i = numPriorityLevels; --i >= 0;)
             {
-                jobs.removeFirstMatchingValue (job);
-                addToDeleteList (deletionList, job);
+                if (listContains (pendingJobs[i], job))
+                {
+                    removeFromList (pendingJobs[i], job);
+                    --numJobs;
+                    --numPendingJobs;
+                    addToDeleteList (deletionList, job);
+                    break;
+                }
             }
         }
     }
@@ -222,24 +456,32 @@ bool ThreadPool::removeAllJobs (const bool interruptRunningJobs, const int timeO
         {
             const ScopedLock sl (lock);
 
-            for (int i = jobs.size(); --i >= 0;)
+            for (ThreadPoolJob* job = runningJobs.first; job != nullptr; job = job->nextJob)
             {
-                ThreadPoolJob* const job = jobs.getUnchecked(i);
-
                 if (selectedJobsToRemove == nullptr || selectedJobsToRemove->isJobSuitable (job))
                 {
-                    if (job->isActive)
-                    {
-                        jobsToWaitFor.add (job);
+                    jobsToWaitFor.add (job);
 
-                        if (interruptRunningJobs)
-                            job->signalJobShouldExit();
-                    }
-                    else
+                    if (interruptRunningJobs)
+                        job->signalJobShouldExit();
+                }
+            }
+
+            for (int i = numPriorityLevels; --i >= 0;)
+            {
+                for (ThreadPoolJob* job = pendingJobs[i].first; job != nullptr;)
+                {
+                    ThreadPoolJob* const next = job->nextJob;
+
+                    if (selectedJobsToRemove == nullptr || selectedJobsToRemove->isJobSuitable (job))
                     {
-                        jobs.remove (i);
+                        removeFromList (pendingJobs[i], job);
+                        --numJobs;
+                        --numPendingJobs;
                         addToDeleteList (deletionList, job);
                     }
+
+                    job = next;
                 }
             }
         }
@@ -274,12 +516,13 @@ StringArray ThreadPool::getNamesOfAllJobs (const bool onlyReturnActiveJobs) cons
     StringArray s;
     const ScopedLock sl (lock);
 
-    for (int i = 0; i < jobs.size(); ++i)
-    {
-        const ThreadPoolJob* const job = jobs.getUnchecked(i);
-        if (job->isActive || ! onlyReturnActiveJobs)
-            s.add (job->getJobName());
-    }
+    for (const ThreadPoolJob* job = runningJobs.first; job != nullptr; job = job->nextJob)
+        s.add (job->getJobName());
+
+    if (! onlyReturnActiveJobs)
+        for (int i = numPriorityLevels; --i >= 0;)
+            for (const ThreadPoolJob* job = pendingJobs[i].first; job != nullptr; job = job->nextJob)
+                s.add (job->getJobName());
 
     return s;
 }
@@ -295,43 +538,134 @@ bool ThreadPool::setThreadPriorities (const int newPriority)
     return ok;
 }
 
-ThreadPoolJob* ThreadPool::pickNextJobToRun()
+//==============================================================================
+ThreadPool::ThreadPoolThread* ThreadPool::getCurrentPoolThread() const
+{
+    const Thread::ThreadID currentId = Thread::getCurrentThreadId();
+
+    for (int i = threads.size(); --i >= 0;)
+        if (threads.getUnchecked(i)->getThreadId() == currentId)
+            return threads.getUnchecked(i);
+
+    return nullptr;
+}
+
+void ThreadPool::wakeIdleThread()
+{
+    for (int i = threads.size(); --i >= 0;)
+    {
+        ThreadPoolThread* const t = threads.getUnchecked(i);
+
+        if (t->isIdle.value != 0 && t->isIdle.compareAndSetBool (0, 1))
+        {
+            t->notify();
+            break;
+        }
+    }
+}
+
+bool ThreadPool::hasQueuedJobs() const
 {
+    if (numPendingJobs.get() > 0)
+        return true;
+
+    for (int i = numPriorityLevels; --i >= 0;)
+    {
+        if (! functionJobQueues.getUnchecked(i)->isEmpty())
+            return true;
+
+        for (int j = threads.size(); --j >= 0;)
+            if (! threads.getUnchecked(j)->localJobs[i].isEmpty())
+                return true;
+    }
+
+    return false;
+}
+
+bool ThreadPool::pickNextFunctionJob (ThreadPoolThread& thread, const int priority, FunctionJob& job)
+{
+    if (thread.localJobs[priority].pop (job))
+        return true;
+
+    // take a share of any jobs that were added from outside the pool..
+    FunctionJobQueue& shared = *functionJobQueues.getUnchecked (priority);
+    const int numThreads = threads.size();
+
+    if (shared.take (job, thread.localJobs[priority], jmin (32, shared.getNumQueued() / numThreads)))
+        return true;
+
+    // ..and if there aren't any, try to steal some work from one of the other threads
+    for (int i = 1; i < numThreads; ++i)
+        if (threads.getUnchecked ((thread.index + i) % numThreads)->localJobs[priority].steal (job))
+            return true;
+
+    return false;
+}
+
+ThreadPoolJob* ThreadPool::pickNextJobToRun (const int priority)
+{
+    if (numPendingJobs.value == 0)
+        return nullptr;
+
     OwnedArray<ThreadPoolJob> deletionList;
 
     {
         const ScopedLock sl (lock);
 
-        for (int i = 0; i < jobs.size(); ++i)
+        while (ThreadPoolJob* const job = pendingJobs [priority].first)
         {
-            ThreadPoolJob* job = jobs[i];
+            removeFromList (pendingJobs [priority], job);
+            --numPendingJobs;
 
-            if (job != nullptr && ! job->isActive)
+            if (job->shouldStop)
             {
-                if (job->shouldStop)
-                {
-                    jobs.remove (i);
-                    addToDeleteList (deletionList, job);
-                    --i;
-                    continue;
-                }
-
-                job->isActive = true;
-                return job;
+                --numJobs;
+                addToDeleteList (deletionList, job);
+                continue;
             }
+
+            appendToList (runningJobs, job);
+            job->isActive = true;
+            return job;
         }
     }
 
     return nullptr;
 }
 
-bool ThreadPool::runNextJob()
+bool ThreadPool::runNextJob (ThreadPoolThread& thread)
 {
-    ThreadPoolJob* const job = pickNextJobToRun();
+    for (int priority = numPriorityLevels; --priority >= 0;)
+    {
+        FunctionJob functionJob;
+
+        if (pickNextFunctionJob (thread, priority, functionJob))
+        {
+            // if there's more work waiting, make sure another thread gets going on it..
+            if (! (thread.localJobs[priority].isEmpty() && functionJobQueues.getUnchecked (priority)->getNumQueued() == 0))
+                wakeIdleThread();
+
+            JUCE_TRY
+            {
+                functionJob.function (functionJob.userData);
+            }
+            JUCE_CATCH_ALL_ASSERT
+
+            return true;
+        }
+
+        if (ThreadPoolJob* const job = pickNextJobToRun (priority))
+        {
+            runJob (job);
+            return true;
+        }
+    }
 
-    if (job == nullptr)
-        return false;
+    return false;
+}
 
+void ThreadPool::runJob (ThreadPoolJob* const job)
+{
     ThreadPoolJob::JobStatus result = ThreadPoolJob::jobHasFinished;
 
     JUCE_TRY
@@ -345,13 +679,14 @@ bool ThreadPool::runNextJob()
     {
         const ScopedLock sl (lock);
 
-        if (jobs.contains (job))
+        if (listContains (runningJobs, job))
         {
             job->isActive = false;
+            removeFromList (runningJobs, job);
 
             if (result != ThreadPoolJob::jobNeedsRunningAgain || job->shouldStop)
             {
-                jobs.removeFirstMatchingValue (job);
+                --numJobs;
                 addToDeleteList (deletionList, job);
 
                 jobFinishedSignal.signal();
@@ -359,12 +694,11 @@ bool ThreadPool::runNextJob()
             else
             {
                 // move the job to the end of the queue if it wants another go
-                jobs.move (jobs.indexOf (job), -1);
+                appendToList (pendingJobs [job->priority], job);
+                ++numPendingJobs;
             }
         }
     }
-
-    return true;
 }
 
 void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, ThreadPoolJob* const job) const
@@ -375,3 +709,215 @@ void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, Threa
     if (job->shouldBeDeleted)
         deletionList.add (job);
 }
+
+//==============================================================================
+void ThreadPool::appendToList (JobList& list, ThreadPoolJob* const job) noexcept
+{
+    job->previousJob = list.last;
+    job->nextJob = nullptr;
+
+    if (list.last != nullptr)
+        list.last->nextJob = job;
+    else
+        list.first = job;
+
+    list.last = job;
+}
+
+void ThreadPool::removeFromList (JobList& list, ThreadPoolJob* const job) noexcept
+{
+    if (job->previousJob != nullptr)
+        job->previousJob->nextJob = job->nextJob;
+    else
+        list.first = job->nextJob;
+
+    if (job->nextJob != nullptr)
+        job->nextJob->previousJob = job->previousJob;
+    else
+        list.last = job->previousJob;
+
+    job->previousJob = job->nextJob = nullptr;
+}
+
+bool ThreadPool::listContains (const JobList& list, const ThreadPoolJob* const job) noexcept
+{
+    for (const ThreadPoolJob* j = list.first; j != nullptr; j = j->nextJob)
+        if (j == job)
+            return true;
+
+    return false;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ThreadPoolTests  : public UnitTest
+{
+public:
+    ThreadPoolTests() : UnitTest ("ThreadPool") {}
+
+    struct Counter
+    {
+        Atomic<int> count;
+        ThreadPool* pool;
+        int numToSpawn;
+    };
+
+    static void incrementCounter (void* userData)
+    {
+        Counter& c = *static_cast <Counter*> (userData);
+
+        // the first few jobs add some more from inside the pool, to exercise the local queues
+        if (c.numToSpawn > 0 && c.count.get() < 100)
+            for (int i = c.numToSpawn; --i >= 0;)
+                c.pool->addJob (incrementCounter, userData);
+
+        ++(c.count);
+    }
+
+    static bool waitForCount (Atomic<int>& count, const int target)
+    {
+        const uint32 start = Time::getMillisecondCounter();
+
+        while (count.get() < target)
+        {
+            if (Time::getMillisecondCounter() > start + 10000)
+                return false;
+
+            Thread::sleep (1);
+        }
+
+        return true;
+    }
+
+    class OrderingJob  : public ThreadPoolJob
+    {
+    public:
+        OrderingJob (Array<int>& order_, CriticalSection& lock_, WaitableEvent* gate_, const int id_)
+            : ThreadPoolJob ("ordering job"), order (order_), lock (lock_), gate (gate_), id (id_)
+        {}
+
+        JobStatus runJob()
+        {
+            if (gate != nullptr)
+                gate->wait (5000);
+
+            const ScopedLock sl (lock);
+            order.add (id);
+            return jobHasFinished;
+        }
+
+    private:
+        Array<int>& order;
+        CriticalSection& lock;
+        WaitableEvent* gate;
+        const int id;
+    };
+
+    void runTest()
+    {
+        beginTest ("Function jobs");
+
+        {
+            ThreadPool pool (4);
+            Counter c;
+            c.pool = &pool;
+            c.numToSpawn = 0;
+
+            const int numJobs = 20000;
+
+            for (int i = 0; i < numJobs; ++i)
+                pool.addJob (incrementCounter, &c, (ThreadPool::JobPriority) (i % 3));
+
+            expect (waitForCount (c.count, numJobs));
+        }
+
+        beginTest ("Function jobs added by other jobs");
+
+        {
+            ThreadPool pool (3);
+            Counter c;
+            c.pool = &pool;
+            c.numToSpawn = 3;
+
+            pool.addJob (incrementCounter, &c);
+
+            // (each job spawns 3 more until the count reaches 100, so there'll be at least 301)
+            expect (waitForCount (c.count, 301));
+
+            const uint32 start = Time::getMillisecondCounter();
+            int lastCount = -1;
+
+            while (lastCount != c.count.get() && Time::getMillisecondCounter() < start + 5000)
+            {
+                lastCount = c.count.get();
+                Thread::sleep (50);
+            }
+
+            expect ((lastCount - 1) % 3 == 0);
+        }
+
+        beginTest ("Job priorities");
+
+        {
+            ThreadPool pool (1);
+            Array<int> order;
+            CriticalSection orderLock;
+            WaitableEvent gate;
+
+            OrderingJob blocker (order, orderLock, &gate, 0);
+            OrderingJob low (order, orderLock, nullptr, 1), normal (order, orderLock, nullptr, 2), high (order, orderLock, nullptr, 3);
+
+            pool.addJob (&blocker, false);
+
+            while (! pool.isJobRunning (&blocker))
+                Thread::sleep (1);
+
+            pool.addJob (&low, false, ThreadPool::lowPriority);
+            pool.addJob (&normal, false, ThreadPool::normalPriority);
+            pool.addJob (&high, false, ThreadPool::highPriority);
+            expectEquals (pool.getNumJobs(), 4);
+
+            gate.signal();
+
+            expect (pool.waitForJobToFinish (&low, 5000));
+            expect (pool.getNumJobs() == 0);
+            expect (order.size() == 4 && order[0] == 0 && order[1] == 3 && order[2] == 2 && order[3] == 1);
+        }
+
+        beginTest ("Removing jobs");
+
+        {
+            ThreadPool pool (1);
+            Array<int> order;
+            CriticalSection orderLock;
+            WaitableEvent gate;
+
+            OrderingJob blocker (order, orderLock, &gate, 0);
+            OrderingJob a (order, orderLock, nullptr, 1), b (order, orderLock, nullptr, 2);
+
+            pool.addJob (&blocker, false);
+
+            while (! pool.isJobRunning (&blocker))
+                Thread::sleep (1);
+
+            pool.addJob (&a, false);
+            pool.addJob (&b, false);
+
+            expect (pool.contains (&a));
+            expect (pool.removeJob (&a, false, 0));
+            expect (! pool.contains (&a));
+            expect (! pool.removeJob (&blocker, false, 10));
+
+            gate.signal();
+
+            expect (pool.removeAllJobs (false, 5000));
+            expect (pool.getNumJobs() == 0);
+            expect (! order.contains (1));
+        }
+    }
+};
+
+static ThreadPoolTests threadPoolUnitTests;
+
+#endif
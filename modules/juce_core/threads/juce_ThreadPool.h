@@ -126,6 +126,9 @@ private:
     friend class ThreadPoolThread;
     String jobName;
     ThreadPool* pool;
+    ThreadPoolJob* previousJob;
+    ThreadPoolJob* nextJob;
+    int priority;
     bool shouldStop, isActive, shouldBeDeleted;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolJob)
@@ -139,6 +142,11 @@ private:
     When a ThreadPoolJob object is added to the ThreadPool's list, its runJob() method
     will be called by the next pooled thread that becomes free.
 
+    For large numbers of small tasks, the pool can also run plain function calls (see
+    the addJob() method that takes a JobFunction). These don't need a ThreadPoolJob
+    object to be allocated, and are scheduled through a queue belonging to each thread,
+    so that an idle thread can steal work from a busy one without taking any locks.
+
     @see ThreadPoolJob, Thread
 */
 class JUCE_API  ThreadPool
@@ -187,6 +195,19 @@ public:
     };
 
     //==============================================================================
+    /** The priorities that jobs can be given when they're added to the pool.
+
+        A waiting job is never started while there's a waiting job with a higher
+        priority. Jobs that have the same priority are started in roughly the
+        order in which they were added.
+    */
+    enum JobPriority
+    {
+        lowPriority = 0,
+        normalPriority,
+        highPriority
+    };
+
     /** Adds a job to the queue.
 
         Once a job has been added, then the next time a thread is free, it will run
@@ -201,9 +222,32 @@ public:
         If deleteJobWhenFinished is false, the pointer will be used but not deleted, and
         the caller is responsible for making sure the object is not deleted before it has
         been removed from the pool.
+
+        A job that asks to be run again is put back into the queue with the same priority.
     */
     void addJob (ThreadPoolJob* job,
-                 bool deleteJobWhenFinished);
+                 bool deleteJobWhenFinished,
+                 JobPriority priority = normalPriority);
+
+    /** A function that can be run by the pool - see addJob(). */
+    typedef void (JobFunction) (void* userData);
+
+    /** Adds a job that simply calls a function with the given parameter.
+
+        This is much cheaper than creating a ThreadPoolJob, so it's the best way to hand
+        large numbers of small tasks to the pool: nothing is allocated, and if this is called
+        from one of the pool's own threads, the job goes onto that thread's own queue without
+        any locking, where other threads can steal it if they run out of work.
+
+        Because there's no job object, these jobs can't be removed, interrupted or waited-for
+        once they've been added, and they aren't included in getNumJobs(), getJob(), contains()
+        or the other methods that deal with ThreadPoolJob objects. If the pool is deleted, any
+        function jobs that haven't yet started are discarded without being called, so if you
+        need to know when your functions have finished, they'll need to signal this themselves.
+    */
+    void addJob (JobFunction* function,
+                 void* userData,
+                 JobPriority priority = normalPriority);
 
     /** Tries to remove a job from the pool.
 
@@ -245,6 +289,9 @@ public:
     */
     int getNumJobs() const;
 
+    /** Returns the number of threads that the pool is using to run its jobs. */
+    int getNumThreads() const noexcept;
+
     /** Returns one of the jobs in the queue.
 
         Note that this can be a very volatile list as jobs might be continuously getting shifted
@@ -288,22 +335,50 @@ public:
 
 private:
     //==============================================================================
-    Array <ThreadPoolJob*> jobs;
+    enum { numPriorityLevels = 3 };
+
+    struct JobList
+    {
+        ThreadPoolJob* first;
+        ThreadPoolJob* last;
+    };
+
+    struct FunctionJob
+    {
+        JobFunction* function;
+        void* userData;
+    };
+
+    JobList pendingJobs [numPriorityLevels], runningJobs;
+    int numJobs;
+    Atomic<int> numPendingJobs;
 
     class ThreadPoolThread;
+    class FunctionJobQueue;
     friend class ThreadPoolThread;
     friend class OwnedArray <ThreadPoolThread>;
+    friend class OwnedArray <FunctionJobQueue>;
     OwnedArray <ThreadPoolThread> threads;
+    OwnedArray <FunctionJobQueue> functionJobQueues;
 
     CriticalSection lock;
     WaitableEvent jobFinishedSignal;
 
-    bool runNextJob();
-    ThreadPoolJob* pickNextJobToRun();
+    bool runNextJob (ThreadPoolThread&);
+    bool pickNextFunctionJob (ThreadPoolThread&, int priority, FunctionJob&);
+    ThreadPoolJob* pickNextJobToRun (int priority);
+    void runJob (ThreadPoolJob*);
+    bool hasQueuedJobs() const;
+    void wakeIdleThread();
+    ThreadPoolThread* getCurrentPoolThread() const;
     void addToDeleteList (OwnedArray<ThreadPoolJob>&, ThreadPoolJob*) const;
     void createThreads (int numThreads);
     void stopThreads();
 
+    static void appendToList (JobList&, ThreadPoolJob*) noexcept;
+    static void removeFromList (JobList&, ThreadPoolJob*) noexcept;
+    static bool listContains (const JobList&, const ThreadPoolJob*) noexcept;
+
     // Note that this method has changed, and no longer has a parameter to indicate
     // whether the jobs should be deleted - see the new method for details.
     void removeAllJobs (bool, int, bool);
@@ -23,47 +23,84 @@
   ==============================================================================
 */
 
-TimeSliceThread::TimeSliceThread (const String& name)
+TimeSliceClient::TimeSliceClient() noexcept
+    : priority (TimeSliceThread::normalPriority), queueIndex (-1), callingThread (nullptr)
+{
+}
+
+//==============================================================================
+class TimeSliceThread::HelperThread  : public Thread
+{
+public:
+    HelperThread (TimeSliceThread& owner_)
+        : Thread (owner_.getThreadName() + " helper"),
+          owner (owner_), isActive (false), isIdle (false)
+    {
+    }
+
+    void run()
+    {
+        owner.runClients (*this, true);
+    }
+
+    TimeSliceThread& owner;
+    bool isActive, isIdle;
+
+    JUCE_DECLARE_NON_COPYABLE (HelperThread)
+};
+
+//==============================================================================
+TimeSliceThread::TimeSliceThread (const String& name, const int maxNumThreads_)
     : Thread (name),
-      clientBeingCalled (nullptr)
+      maxNumThreads (jmax (1, maxNumThreads_)),
+      mainThreadIsIdle (false)
 {
 }
 
 TimeSliceThread::~TimeSliceThread()
 {
     stopThread (2000);
+    stopHelpers();
 }
 
 //==============================================================================
-void TimeSliceThread::addTimeSliceClient (TimeSliceClient* const client, int millisecondsBeforeStarting)
+void TimeSliceThread::addTimeSliceClient (TimeSliceClient* const client, int millisecondsBeforeStarting,
+                                          const ClientPriority priority)
 {
     if (client != nullptr)
     {
         const ScopedLock sl (listLock);
+
+        removeFromQueue (client);
         client->nextCallTime = Time::getCurrentTime() + RelativeTime::milliseconds (millisecondsBeforeStarting);
+        client->priority = priority;
         clients.addIfNotAlreadyThere (client);
-        notify();
+
+        // if it's being called at the moment, it'll be put back in the queue afterwards
+        if (client->callingThread == nullptr)
+            addToQueue (client);
+
+        wakeIdleThread (millisecondsBeforeStarting <= 0);
     }
 }
 
 void TimeSliceThread::removeTimeSliceClient (TimeSliceClient* const client)
 {
-    const ScopedLock sl1 (listLock);
+    const ScopedLock sl (listLock);
 
-    // if there's a chance we're in the middle of calling this client, we need to
-    // also lock the outer lock..
-    if (clientBeingCalled == client)
+    if (clients.contains (client))
     {
-        const ScopedUnlock ul (listLock); // unlock first to get the order right..
-
-        const ScopedLock sl2 (callbackLock);
-        const ScopedLock sl3 (listLock);
-
         clients.removeFirstMatchingValue (client);
+        removeFromQueue (client);
     }
-    else
+
+    // if we're in the middle of calling this client on another thread, we need
+    // to wait for that to finish..
+    while (client != nullptr && client->callingThread != nullptr
+            && client->callingThread->getThreadId() != Thread::getCurrentThreadId())
     {
-        clients.removeFirstMatchingValue (client);
+        const ScopedUnlock ul (listLock);
+        callbackFinished.wait (10);
     }
 }
 
@@ -74,7 +111,33 @@ void TimeSliceThread::moveToFrontOfQueue (TimeSliceClient* client)
     if (clients.contains (client))
     {
         client->nextCallTime = Time::getCurrentTime();
-        notify();
+
+        if (client->queueIndex >= 0)
+        {
+            removeFromQueue (client);
+            addToQueue (client);
+        }
+
+        wakeIdleThread (true);
+    }
+}
+
+void TimeSliceThread::setClientPriority (TimeSliceClient* client, const ClientPriority newPriority)
+{
+    const ScopedLock sl (listLock);
+
+    if (clients.contains (client) && client->priority != newPriority)
+    {
+        if (client->queueIndex >= 0)
+        {
+            removeFromQueue (client);
+            client->priority = newPriority;
+            addToQueue (client);
+        }
+        else
+        {
+            client->priority = newPriority;
+        }
     }
 }
 
@@ -89,80 +152,436 @@ TimeSliceClient* TimeSliceThread::getClient (const int i) const
     return clients [i];
 }
 
+int TimeSliceThread::getNumActiveThreads() const
+{
+    const ScopedLock sl (listLock);
+
+    int num = isThreadRunning() ? 1 : 0;
+
+    for (int i = helpers.size(); --i >= 0;)
+        if (helpers.getUnchecked(i)->isActive)
+            ++num;
+
+    return num;
+}
+
+//==============================================================================
+void TimeSliceThread::addToQueue (TimeSliceClient* const client)
+{
+    jassert (client->queueIndex < 0);
+
+    Array <TimeSliceClient*>& queue = queues [client->priority];
+    client->queueIndex = queue.size();
+    queue.add (client);
+    moveUpQueue (queue, client->queueIndex);
+}
+
+void TimeSliceThread::removeFromQueue (TimeSliceClient* const client)
+{
+    const int index = client->queueIndex;
+
+    if (index >= 0)
+    {
+        Array <TimeSliceClient*>& queue = queues [client->priority];
+        jassert (queue [index] == client);
+
+        TimeSliceClient* const last = queue.getLast();
+        queue.removeLast();
+        client->queueIndex = -1;
+
+        if (last != client)
+        {
+            queue.set (index, last);
+            last->queueIndex = index;
+            moveUpQueue (queue, index);
+            moveDownQueue (queue, last->queueIndex);
+        }
+    }
+}
+
+void TimeSliceThread::moveUpQueue (Array <TimeSliceClient*>& queue, int index)
+{
+    TimeSliceClient* const client = queue.getUnchecked (index);
+
+    while (index > 0)
+    {
+        const int parentIndex = (index - 1) / 2;
+        TimeSliceClient* const parent = queue.getUnchecked (parentIndex);
+
+        if (! (client->nextCallTime < parent->nextCallTime))
+            break;
+
+        queue.set (index, parent);
+        parent->queueIndex = index;
+        index = parentIndex;
+    }
+
+    queue.set (index, client);
+    client->queueIndex = index;
+}
+
+void TimeSliceThread::moveDownQueue (Array <TimeSliceClient*>& queue, int index)
+{
+    TimeSliceClient* const client = queue.getUnchecked (index);
+    const int size = queue.size();
+
+    for (;;)
+    {
+        int childIndex = index * 2 + 1;
+
+        if (childIndex >= size)
+            break;
+
+        if (childIndex + 1 < size
+             && queue.getUnchecked (childIndex + 1)->nextCallTime < queue.getUnchecked (childIndex)->nextCallTime)
+            ++childIndex;
+
+        TimeSliceClient* const child = queue.getUnchecked (childIndex);
+
+        if (! (child->nextCallTime < client->nextCallTime))
+            break;
+
+        queue.set (index, child);
+        child->queueIndex = index;
+        index = childIndex;
+    }
+
+    queue.set (index, client);
+    client->queueIndex = index;
+}
+
 //==============================================================================
-TimeSliceClient* TimeSliceThread::getNextClient (int index) const
+TimeSliceClient* TimeSliceThread::removeNextDueClient (const Time now, int& timeToWait)
 {
     Time soonest;
-    TimeSliceClient* client = nullptr;
+    bool anyWaiting = false;
+
+    for (int i = numPriorityLevels; --i >= 0;)
+    {
+        if (TimeSliceClient* const client = queues[i].getFirst())
+        {
+            if (client->nextCallTime <= now)
+            {
+                removeFromQueue (client);
+                return client;
+            }
+
+            if (client->nextCallTime < soonest || ! anyWaiting)
+                soonest = client->nextCallTime;
+
+            anyWaiting = true;
+        }
+    }
+
+    timeToWait = anyWaiting ? (int) jlimit ((int64) 1, (int64) 500, (soonest - now).inMilliseconds())
+                            : 500;
+    return nullptr;
+}
+
+bool TimeSliceThread::isAnyClientDue (const Time now) const
+{
+    for (int i = numPriorityLevels; --i >= 0;)
+        if (TimeSliceClient* const client = queues[i].getFirst())
+            if (client->nextCallTime <= now)
+                return true;
+
+    return false;
+}
+
+void TimeSliceThread::wakeIdleThread (const bool startNewThreadIfNeeded)
+{
+    if (mainThreadIsIdle)
+    {
+        mainThreadIsIdle = false;
+        notify();
+        return;
+    }
+
+    for (int i = 0; i < helpers.size(); ++i)
+    {
+        HelperThread* const helper = helpers.getUnchecked(i);
+
+        if (helper->isActive && helper->isIdle)
+        {
+            helper->isIdle = false;
+            helper->notify();
+            return;
+        }
+    }
 
-    for (int i = clients.size(); --i >= 0;)
+    if (startNewThreadIfNeeded && isThreadRunning() && ! threadShouldExit())
     {
-        TimeSliceClient* const c = clients.getUnchecked ((i + index) % clients.size());
+        HelperThread* helper = nullptr;
 
-        if (client == nullptr || c->nextCallTime < soonest)
+        for (int i = 0; i < helpers.size(); ++i)
         {
-            client = c;
-            soonest = c->nextCallTime;
+            if (! helpers.getUnchecked(i)->isActive)
+            {
+                helper = helpers.getUnchecked(i);
+                break;
+            }
+        }
+
+        if (helper == nullptr)
+        {
+            if (helpers.size() + 1 >= maxNumThreads)
+                return;
+
+            helper = new HelperThread (*this);
+            helpers.add (helper);
         }
+
+        // (it may still be on its way out after finishing last time)
+        helper->waitForThreadToExit (-1);
+
+        helper->isActive = true;
+        helper->isIdle = false;
+        helper->startThread (getPriority());
+    }
+}
+
+void TimeSliceThread::stopHelpers()
+{
+    for (int i = helpers.size(); --i >= 0;)
+    {
+        helpers.getUnchecked(i)->signalThreadShouldExit();
+        helpers.getUnchecked(i)->notify();
     }
 
-    return client;
+    for (int i = helpers.size(); --i >= 0;)
+        helpers.getUnchecked(i)->stopThread (4000);
 }
 
-void TimeSliceThread::run()
+//==============================================================================
+void TimeSliceThread::runClients (Thread& thread, const bool isHelper)
 {
-    int index = 0;
+    // helper threads finish after they've had nothing to do for this long
+    const int helperIdleTimeout = 5000;
+    int timeSpentIdle = 0;
 
-    while (! threadShouldExit())
+    while (! (thread.threadShouldExit() || threadShouldExit()))
     {
         int timeToWait = 500;
+        TimeSliceClient* client = nullptr;
+        const Time now (Time::getCurrentTime());
 
         {
-            Time nextClientTime;
+            const ScopedLock sl (listLock);
 
-            {
-                const ScopedLock sl2 (listLock);
+            client = removeNextDueClient (now, timeToWait);
 
-                index = clients.size() > 0 ? ((index + 1) % clients.size()) : 0;
+            if (client != nullptr)
+            {
+                client->callingThread = &thread;
 
-                if (TimeSliceClient* const firstClient = getNextClient (index))
-                    nextClientTime = firstClient->nextCallTime;
+                // if other clients are being kept waiting, get another thread onto them
+                if (isAnyClientDue (now))
+                    wakeIdleThread (true);
             }
+            else if (isHelper)
+            {
+                HelperThread& helper = static_cast <HelperThread&> (thread);
 
-            const Time now (Time::getCurrentTime());
+                if (timeSpentIdle >= helperIdleTimeout)
+                {
+                    helper.isActive = false;
+                    helper.isIdle = false;
+                    return;
+                }
 
-            if (nextClientTime > now)
-            {
-                timeToWait = (int) jmin ((int64) 500, (nextClientTime - now).inMilliseconds());
+                helper.isIdle = true;
             }
             else
             {
-                timeToWait = index == 0 ? 1 : 0;
+                mainThreadIsIdle = true;
+            }
+        }
 
-                const ScopedLock sl (callbackLock);
+        if (client != nullptr)
+        {
+            timeSpentIdle = 0;
+            const int msUntilNextCall = client->useTimeSlice();
+
+            const ScopedLock sl (listLock);
+            client->callingThread = nullptr;
 
+            // (the client may have been removed while we were calling it)
+            if (clients.contains (client) && client->queueIndex < 0)
+            {
+                if (msUntilNextCall >= 0)
                 {
-                    const ScopedLock sl2 (listLock);
-                    clientBeingCalled = getNextClient (index);
+                    client->nextCallTime = now + RelativeTime::milliseconds (msUntilNextCall);
+                    addToQueue (client);
                 }
-
-                if (clientBeingCalled != nullptr)
+                else
                 {
-                    const int msUntilNextCall = clientBeingCalled->useTimeSlice();
+                    clients.removeFirstMatchingValue (client);
+                }
+            }
 
-                    const ScopedLock sl2 (listLock);
+            callbackFinished.signal();
+        }
+        else
+        {
+            thread.wait (timeToWait);
+            timeSpentIdle += timeToWait;
 
-                    if (msUntilNextCall >= 0)
-                        clientBeingCalled->nextCallTime = now + RelativeTime::milliseconds (msUntilNextCall);
-                    else
-                        clients.removeFirstMatchingValue (clientBeingCalled);
+            const ScopedLock sl (listLock);
 
-                    clientBeingCalled = nullptr;
-                }
-            }
+            if (isHelper)
+                static_cast <HelperThread&> (thread).isIdle = false;
+            else
+                mainThreadIsIdle = false;
         }
+    }
 
-        if (timeToWait > 0)
-            wait (timeToWait);
+    if (isHelper)
+    {
+        const ScopedLock sl (listLock);
+        static_cast <HelperThread&> (thread).isActive = false;
     }
 }
+
+void TimeSliceThread::run()
+{
+    runClients (*this, false);
+    stopHelpers();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TimeSliceThreadTests  : public UnitTest
+{
+public:
+    TimeSliceThreadTests() : UnitTest ("TimeSliceThread") {}
+
+    struct OrderRecordingClient  : public TimeSliceClient
+    {
+        OrderRecordingClient (Array<int>& order_, CriticalSection& lock_, int id_)
+            : order (order_), lock (lock_), id (id_) {}
+
+        int useTimeSlice()
+        {
+            const ScopedLock sl (lock);
+            order.add (id);
+            return -1;
+        }
+
+        Array<int>& order;
+        CriticalSection& lock;
+        const int id;
+    };
+
+    struct SlowClient  : public TimeSliceClient
+    {
+        SlowClient() : numCalls (0), overlapped (false) {}
+
+        int useTimeSlice()
+        {
+            if (++isBeingCalled != 1)
+                overlapped = true;
+
+            Thread::sleep (20);
+            ++numCalls;
+            --isBeingCalled;
+            return 0;
+        }
+
+        Atomic<int> numCalls, isBeingCalled;
+        bool overlapped;
+    };
+
+    void runTest()
+    {
+        beginTest ("Priorities");
+
+        {
+            Array<int> order;
+            CriticalSection lock;
+            TimeSliceThread thread ("test");
+
+            OrderRecordingClient low (order, lock, 0), normal (order, lock, 1), high (order, lock, 2);
+            thread.addTimeSliceClient (&low, 0, TimeSliceThread::lowPriority);
+            thread.addTimeSliceClient (&normal);
+            thread.addTimeSliceClient (&high, 0, TimeSliceThread::highPriority);
+
+            thread.startThread();
+
+            for (int i = 0; i < 200 && thread.getNumClients() > 0; ++i)
+                Thread::sleep (5);
+
+            thread.stopThread (2000);
+
+            expectEquals (order.size(), 3);
+            expectEquals (order[0], 2);
+            expectEquals (order[1], 1);
+            expectEquals (order[2], 0);
+        }
+
+        beginTest ("Deadlines");
+
+        {
+            Array<int> order;
+            CriticalSection lock;
+            TimeSliceThread thread ("test");
+            thread.startThread();
+
+            OrderRecordingClient a (order, lock, 0), b (order, lock, 1), c (order, lock, 2);
+            thread.addTimeSliceClient (&a, 150);
+            thread.addTimeSliceClient (&b, 50);
+            thread.addTimeSliceClient (&c, 100);
+
+            for (int i = 0; i < 200 && thread.getNumClients() > 0; ++i)
+                Thread::sleep (5);
+
+            thread.stopThread (2000);
+
+            expectEquals (order.size(), 3);
+            expectEquals (order[0], 1);
+            expectEquals (order[1], 2);
+            expectEquals (order[2], 0);
+        }
+
+        beginTest ("Multiple threads");
+
+        {
+            TimeSliceThread thread ("test", 3);
+            expectEquals (thread.getMaxNumThreads(), 3);
+
+            OwnedArray<SlowClient> slowClients;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                slowClients.add (new SlowClient());
+                thread.addTimeSliceClient (slowClients.getLast());
+            }
+
+            thread.startThread();
+            Thread::sleep (300);
+
+            expect (thread.getNumActiveThreads() > 1);
+            expect (thread.getNumActiveThreads() <= 3);
+
+            for (int i = 0; i < slowClients.size(); ++i)
+            {
+                thread.removeTimeSliceClient (slowClients.getUnchecked(i));
+
+                const int numCalls = slowClients.getUnchecked(i)->numCalls.get();
+                expect (numCalls > 0);
+                expect (slowClients.getUnchecked(i)->isBeingCalled.get() == 0);
+
+                Thread::sleep (30);
+                expectEquals (slowClients.getUnchecked(i)->numCalls.get(), numCalls);
+                expect (! slowClients.getUnchecked(i)->overlapped);
+            }
+
+            thread.stopThread (2000);
+            expectEquals (thread.getNumActiveThreads(), 0);
+        }
+    }
+};
+
+static TimeSliceThreadTests timeSliceThreadUnitTests;
+
+#endif
@@ -28,6 +28,7 @@
 
 #include "juce_Thread.h"
 #include "../containers/juce_Array.h"
+#include "../containers/juce_OwnedArray.h"
 #include "../time/juce_Time.h"
 class TimeSliceThread;
 
@@ -47,6 +48,9 @@ class TimeSliceThread;
 class JUCE_API  TimeSliceClient
 {
 public:
+    /** Creates a client. */
+    TimeSliceClient() noexcept;
+
     /** Destructor. */
     virtual ~TimeSliceClient()   {}
 
@@ -71,6 +75,8 @@ public:
 private:
     friend class TimeSliceThread;
     Time nextCallTime;
+    int priority, queueIndex;
+    Thread* callingThread;
 };
 
 
@@ -79,6 +85,17 @@ private:
     A thread that keeps a list of clients, and calls each one in turn, giving them
     all a chance to run some sort of short task.
 
+    Each client has a time at which it next wants to be called, and the clients are
+    kept in order of that time, so the thread sleeps until the earliest one is due
+    rather than polling the whole list. When several clients are due at once, those
+    with a higher ClientPriority are called first, and clients of equal priority are
+    called in order of how long they've been waiting.
+
+    If you allow it more than one thread, the TimeSliceThread will start extra helper
+    threads when clients are being kept waiting, so that slow clients don't hold up
+    the others, and will let them finish again once they've been idle for a while.
+    A client is never called by more than one thread at a time.
+
     @see TimeSliceClient, Thread
 */
 class JUCE_API  TimeSliceThread   : public Thread
@@ -90,8 +107,11 @@ public:
 
         When first created, the thread is not running. Use the startThread()
         method to start it.
+
+        If maxNumThreads is more than 1, extra helper threads will be started as needed
+        while this thread is running, with the same priority as this thread.
     */
-    explicit TimeSliceThread (const String& threadName);
+    explicit TimeSliceThread (const String& threadName, int maxNumThreads = 1);
 
     /** Destructor.
 
@@ -103,12 +123,27 @@ public:
     ~TimeSliceThread();
 
     //==============================================================================
+    /** The priorities that clients can be given.
+        When more than one client is due to be called, those with higher priorities are
+        called first. Note that a high-priority client that always asks to be called again
+        immediately can stop lower-priority ones from ever being called.
+    */
+    enum ClientPriority
+    {
+        lowPriority = 0,
+        normalPriority,
+        highPriority
+    };
+
     /** Adds a client to the list.
 
         The client's callbacks will start after the number of milliseconds specified
         by millisecondsBeforeStarting (and this may happen before this method has returned).
+        If the client has already been added, this will change when it's next called and
+        its priority.
     */
-    void addTimeSliceClient (TimeSliceClient* client, int millisecondsBeforeStarting = 0);
+    void addTimeSliceClient (TimeSliceClient* client, int millisecondsBeforeStarting = 0,
+                             ClientPriority priority = normalPriority);
 
     /** Removes a client from the list.
 
@@ -123,12 +158,23 @@ public:
     */
     void moveToFrontOfQueue (TimeSliceClient* client);
 
+    /** Changes the priority of a client that has already been added.
+        If the specified client has not been added, nothing will happen.
+    */
+    void setClientPriority (TimeSliceClient* client, ClientPriority newPriority);
+
     /** Returns the number of registered clients. */
     int getNumClients() const;
 
     /** Returns one of the registered clients. */
     TimeSliceClient* getClient (int index) const;
 
+    /** Returns the maximum number of threads that will be used to call the clients. */
+    int getMaxNumThreads() const noexcept                   { return maxNumThreads; }
+
+    /** Returns the number of threads that are currently servicing the clients. */
+    int getNumActiveThreads() const;
+
     //==============================================================================
    #ifndef DOXYGEN
     void run();
@@ -136,11 +182,29 @@ public:
 
     //==============================================================================
 private:
-    CriticalSection callbackLock, listLock;
-    Array <TimeSliceClient*> clients;
-    TimeSliceClient* clientBeingCalled;
+    class HelperThread;
+    friend class HelperThread;
+
+    enum { numPriorityLevels = 3 };
 
-    TimeSliceClient* getNextClient (int index) const;
+    CriticalSection listLock;
+    Array <TimeSliceClient*> clients;
+    Array <TimeSliceClient*> queues [numPriorityLevels]; // binary heaps, ordered by nextCallTime
+    OwnedArray <HelperThread> helpers;
+    WaitableEvent callbackFinished;
+    const int maxNumThreads;
+    bool mainThreadIsIdle;
+
+    void runClients (Thread&, bool isHelper);
+    TimeSliceClient* removeNextDueClient (Time now, int& timeToWait);
+    bool isAnyClientDue (Time now) const;
+    void wakeIdleThread (bool startNewThreadIfNeeded);
+    void stopHelpers();
+
+    void addToQueue (TimeSliceClient*);
+    void removeFromQueue (TimeSliceClient*);
+    void moveUpQueue (Array <TimeSliceClient*>&, int index);
+    void moveDownQueue (Array <TimeSliceClient*>&, int index);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimeSliceThread)
 };
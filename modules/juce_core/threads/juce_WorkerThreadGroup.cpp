@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+class WorkerThreadGroup::Worker  : public Thread
+{
+public:
+    Worker (WorkerThreadGroup& owner_, const String& threadName, const int index_)
+        : Thread (threadName + " " + String (index_)),
+          owner (owner_), index (index_)
+    {
+    }
+
+    void run()
+    {
+        while (! threadShouldExit())
+        {
+            wakeUp.wait();
+
+            if (threadShouldExit())
+                break;
+
+            // if the job has already finished by the time this thread wakes up, the
+            // closed flag will be set, and it must leave without touching the job
+            if (((++owner.activeWorkers) & closedFlag) == 0)
+                owner.currentJob->runOnThread (index);
+
+            --owner.activeWorkers;
+        }
+    }
+
+    WaitableEvent wakeUp;
+
+private:
+    WorkerThreadGroup& owner;
+    const int index;
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+WorkerThreadGroup::WorkerThreadGroup (const String& threadName, const int numThreads, const int threadPriority)
+    : activeWorkers (closedFlag),
+      currentJob (nullptr)
+{
+    for (int i = 0; i < numThreads; ++i)
+    {
+        Worker* const w = new Worker (*this, threadName, i + 1);
+        workers.add (w);
+        w->startThread (threadPriority);
+    }
+}
+
+WorkerThreadGroup::~WorkerThreadGroup()
+{
+    for (int i = workers.size(); --i >= 0;)
+    {
+        workers.getUnchecked(i)->signalThreadShouldExit();
+        workers.getUnchecked(i)->wakeUp.signal();
+    }
+
+    for (int i = workers.size(); --i >= 0;)
+        workers.getUnchecked(i)->stopThread (4000);
+}
+
+void WorkerThreadGroup::run (Job& job)
+{
+    currentJob = &job;
+    activeWorkers -= closedFlag;
+
+    for (int i = workers.size(); --i >= 0;)
+        workers.getUnchecked(i)->wakeUp.signal();
+
+    job.runOnThread (0);
+
+    // stop any more workers joining in, and wait for any that are still busy to leave..
+    activeWorkers += closedFlag;
+
+    while ((activeWorkers.get() & ~closedFlag) != 0)
+        Thread::yield();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class WorkerThreadGroupTests  : public UnitTest
+{
+public:
+    WorkerThreadGroupTests() : UnitTest ("WorkerThreadGroup") {}
+
+    class CountingJob  : public WorkerThreadGroup::Job
+    {
+    public:
+        CountingJob (const int numItems_, const int numThreads)
+            : numItems (numItems_), items ((size_t) numItems_), threadsUsed ((size_t) numThreads + 1)
+        {
+        }
+
+        void reset()
+        {
+            nextItem = 0;
+
+            for (int i = 0; i < numItems; ++i)
+                items[i] = 0;
+        }
+
+        void runOnThread (const int threadIndex)
+        {
+            for (;;)
+            {
+                const int item = (++nextItem) - 1;
+
+                if (item >= numItems)
+                    break;
+
+                ++(items[item]);
+                threadsUsed[threadIndex] = true;
+            }
+        }
+
+        const int numItems;
+        Atomic<int> nextItem;
+        HeapBlock<Atomic<int> > items;
+        HeapBlock<bool> threadsUsed;
+    };
+
+    void runTest()
+    {
+        beginTest ("Every item is done exactly once");
+
+        const int numThreads = 3;
+        WorkerThreadGroup threads ("Test worker", numThreads);
+        expectEquals (threads.getNumThreads(), numThreads);
+
+        CountingJob job (64, numThreads);
+
+        for (int run = 0; run < 2000; ++run)
+        {
+            job.reset();
+            threads.run (job);
+
+            int numWrong = 0;
+
+            for (int i = 0; i < job.numItems; ++i)
+                if (job.items[i].get() != 1)
+                    ++numWrong;
+
+            expectEquals (numWrong, 0);
+        }
+
+        beginTest ("A group with no workers runs the job on the calling thread");
+
+        WorkerThreadGroup noThreads ("Test worker", 0);
+        CountingJob soloJob (16, 0);
+        soloJob.threadsUsed[0] = false;
+        soloJob.reset();
+        noThreads.run (soloJob);
+
+        expect (soloJob.threadsUsed[0]);
+        expectEquals (soloJob.nextItem.get(), soloJob.numItems + 1);
+    }
+};
+
+static WorkerThreadGroupTests workerThreadGroupUnitTests;
+
+#endif
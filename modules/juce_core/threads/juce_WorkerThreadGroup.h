@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_WORKERTHREADGROUP_JUCEHEADER__
+#define __JUCE_WORKERTHREADGROUP_JUCEHEADER__
+
+#include "juce_Thread.h"
+#include "juce_WaitableEvent.h"
+#include "../containers/juce_OwnedArray.h"
+
+
+//==============================================================================
+/**
+    A set of threads that sit waiting to help the calling thread with a job.
+
+    Each call to run() wakes up the workers and runs the job on the calling thread
+    at the same time. Any workers that wake up while the job is still going join in,
+    and run() doesn't return until all of them have left it again. The job's threads
+    will normally claim items of work one at a time from a shared atomic counter, so
+    if a worker is slow to wake up, the other threads just get through its share.
+
+    Unlike a ThreadPool, starting a job doesn't allocate any memory or take any locks,
+    so run() can be called from a real-time thread such as an audio callback.
+
+    e.g. @code
+    class VoiceMixer  : private WorkerThreadGroup::Job
+    {
+    public:
+        VoiceMixer() : threads ("Voice mixing thread", 3) {}
+
+        void mixVoices()    // called on the audio thread
+        {
+            nextVoice = 0;
+            threads.run (*this);
+        }
+
+    private:
+        WorkerThreadGroup threads;
+        Atomic<int> nextVoice;
+
+        void runOnThread (int)
+        {
+            for (;;)
+            {
+                const int i = (++nextVoice) - 1;
+
+                if (i >= numVoices)
+                    break;
+
+                mixVoice (i);
+            }
+        }
+    };
+    @endcode
+
+    @see ThreadPool, ParallelAlgorithms
+*/
+class JUCE_API  WorkerThreadGroup
+{
+public:
+    //==============================================================================
+    /** The work that a WorkerThreadGroup shares out between its threads. */
+    class JUCE_API  Job
+    {
+    public:
+        /** Destructor. */
+        virtual ~Job() {}
+
+        /** Called on each of the threads that take part in a call to run().
+
+            The thread that called run() gets an index of 0, and the workers have indexes
+            from 1 to getNumThreads(), so you can use it to pick per-thread scratch space.
+            Some of the workers may not take part at all, so this should keep doing work
+            until there's none left, rather than relying on the other threads to do any.
+        */
+        virtual void runOnThread (int threadIndex) = 0;
+    };
+
+    //==============================================================================
+    /** Creates and starts a group of worker threads.
+        The threads are named by appending their index to the name given.
+    */
+    WorkerThreadGroup (const String& threadName, int numThreads, int threadPriority = 9);
+
+    /** Destructor.
+        This stops the threads, so you mustn't delete the group while run() is in progress.
+    */
+    ~WorkerThreadGroup();
+
+    //==============================================================================
+    /** Returns the number of worker threads, not counting the thread that calls run(). */
+    int getNumThreads() const noexcept          { return workers.size(); }
+
+    /** Runs a job on the calling thread and any workers that wake up in time to help,
+        and returns once they've all finished with it.
+        Only one thread may call this at a time.
+    */
+    void run (Job& job);
+
+private:
+    //==============================================================================
+    class Worker;
+    friend class Worker;
+
+    enum { closedFlag = 0x40000000 };
+
+    OwnedArray<Worker> workers;
+    Atomic<int> activeWorkers;
+    Job* currentJob;
+
+    JUCE_DECLARE_NON_COPYABLE (WorkerThreadGroup)
+};
+
+
+#endif   // __JUCE_WORKERTHREADGROUP_JUCEHEADER__
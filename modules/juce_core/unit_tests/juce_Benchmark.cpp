@@ -0,0 +1,482 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+Benchmark::Benchmark (const String& name_, const int itemsPerIteration_)
+    : name (name_),
+      itemsPerIteration (jmax (1, itemsPerIteration_))
+{
+    getAllBenchmarks().add (this);
+}
+
+Benchmark::~Benchmark()
+{
+    getAllBenchmarks().removeFirstMatchingValue (this);
+}
+
+Array<Benchmark*>& Benchmark::getAllBenchmarks()
+{
+    static Array<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
+void Benchmark::initialise()  {}
+void Benchmark::shutdown()    {}
+
+static const void* volatile benchmarkResultSink = nullptr;
+
+void Benchmark::preventOptimisation (const void* const result) noexcept
+{
+    benchmarkResultSink = result;
+}
+
+//==============================================================================
+BenchmarkRunner::BenchmarkRunner()
+    : numSamples (30),
+      numWarmUpSamples (3),
+      minimumSampleDuration (0.005)
+{
+}
+
+BenchmarkRunner::~BenchmarkRunner()
+{
+}
+
+void BenchmarkRunner::setNumSamples (const int numSamplesToMeasure, const int numWarmUpSamples_) noexcept
+{
+    numSamples = jmax (1, numSamplesToMeasure);
+    numWarmUpSamples = jmax (0, numWarmUpSamples_);
+}
+
+void BenchmarkRunner::setMinimumSampleDuration (const double seconds) noexcept
+{
+    minimumSampleDuration = seconds;
+}
+
+int BenchmarkRunner::getNumResults() const noexcept
+{
+    return results.size();
+}
+
+const BenchmarkRunner::Result* BenchmarkRunner::getResult (const int index) const noexcept
+{
+    return results [index];
+}
+
+void BenchmarkRunner::runBenchmarks (const Array<Benchmark*>& benchmarks)
+{
+    results.clear();
+
+    for (int i = 0; i < benchmarks.size(); ++i)
+    {
+        if (shouldAbortBenchmarks())
+            break;
+
+        try
+        {
+            runBenchmark (*benchmarks.getUnchecked (i));
+        }
+        catch (...)
+        {
+            logMessage ("!!! Benchmark " + benchmarks.getUnchecked (i)->getName() + " threw an unhandled exception!");
+        }
+    }
+}
+
+void BenchmarkRunner::runAllBenchmarks()
+{
+    runBenchmarks (Benchmark::getAllBenchmarks());
+}
+
+void BenchmarkRunner::runBenchmarksMatching (const String& wildcard)
+{
+    const Array<Benchmark*>& all = Benchmark::getAllBenchmarks();
+    Array<Benchmark*> matching;
+
+    for (int i = 0; i < all.size(); ++i)
+        if (all.getUnchecked (i)->getName().matchesWildcard (wildcard, true))
+            matching.add (all.getUnchecked (i));
+
+    runBenchmarks (matching);
+}
+
+void BenchmarkRunner::logMessage (const String& message)
+{
+    Logger::writeToLog (message);
+}
+
+bool BenchmarkRunner::shouldAbortBenchmarks()
+{
+    return false;
+}
+
+double BenchmarkRunner::timeIterations (Benchmark& benchmark, const int numIterations) const
+{
+    const int64 start = Time::getHighResolutionTicks();
+
+    for (int i = numIterations; --i >= 0;)
+        benchmark.runIteration();
+
+    return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) / numIterations;
+}
+
+namespace BenchmarkHelpers
+{
+    // (the values must be sorted)
+    static double getMedian (const Array<double>& values)
+    {
+        const int n = values.size();
+
+        return (n & 1) != 0 ? values.getUnchecked (n / 2)
+                            : (values.getUnchecked (n / 2 - 1) + values.getUnchecked (n / 2)) * 0.5;
+    }
+
+    static String formatTime (const double seconds)
+    {
+        if (seconds < 1.0e-6)   return String (seconds * 1.0e9, 1) + " ns";
+        if (seconds < 1.0e-3)   return String (seconds * 1.0e6, 2) + " us";
+
+        return String (seconds * 1.0e3, 2) + " ms";
+    }
+
+    static String toNanoseconds (const double seconds)
+    {
+        return String (seconds * 1.0e9, 2);
+    }
+}
+
+void BenchmarkRunner::runBenchmark (Benchmark& benchmark)
+{
+    logMessage ("-----------------------------------------------------------------");
+    logMessage ("Starting benchmark: " + benchmark.getName() + "...");
+
+    benchmark.initialise();
+
+    // find how many iterations are needed for a sample to last long enough to be timed accurately..
+    int iterationsPerSample = 1;
+
+    while (iterationsPerSample < (1 << 30)
+            && timeIterations (benchmark, iterationsPerSample) * iterationsPerSample < minimumSampleDuration)
+        iterationsPerSample *= 2;
+
+    for (int i = 0; i < numWarmUpSamples; ++i)
+        timeIterations (benchmark, iterationsPerSample);
+
+    Array<double> times;
+    double total = 0;
+
+    for (int i = 0; i < numSamples && ! shouldAbortBenchmarks(); ++i)
+    {
+        const double t = timeIterations (benchmark, iterationsPerSample);
+        times.add (t);
+        total += t;
+    }
+
+    benchmark.shutdown();
+
+    if (times.size() == 0)
+        return;
+
+    DefaultElementComparator<double> comparator;
+    times.sort (comparator);
+
+    Result* const r = new Result();
+    results.add (r);
+    r->name = benchmark.getName();
+    r->numSamples = times.size();
+    r->iterationsPerSample = iterationsPerSample;
+    r->median = BenchmarkHelpers::getMedian (times);
+    r->mean = total / times.size();
+    r->minimum = times.getFirst();
+    r->maximum = times.getLast();
+    r->percentile99 = times.getUnchecked (jlimit (0, times.size() - 1, (int) std::ceil (times.size() * 0.99) - 1));
+    r->medianTicks = r->median * (double) Time::getHighResolutionTicksPerSecond();
+    r->itemsPerIteration = benchmark.getItemsPerIteration();
+    r->medianPerItem = r->median / r->itemsPerIteration;
+
+    Array<double> deviations;
+
+    for (int i = 0; i < times.size(); ++i)
+        deviations.add (std::abs (times.getUnchecked (i) - r->median));
+
+    deviations.sort (comparator);
+    r->medianAbsoluteDeviation = BenchmarkHelpers::getMedian (deviations);
+
+    String message ("Median: " + BenchmarkHelpers::formatTime (r->median)
+                     + ", MAD: " + BenchmarkHelpers::formatTime (r->medianAbsoluteDeviation)
+                     + ", 99%: " + BenchmarkHelpers::formatTime (r->percentile99)
+                     + " (" + String (r->numSamples) + " x " + String (r->iterationsPerSample) + " iterations)");
+
+    if (r->itemsPerIteration > 1)
+        message << ", " << BenchmarkHelpers::formatTime (r->medianPerItem) << " per item";
+
+    logMessage (message);
+}
+
+//==============================================================================
+String BenchmarkRunner::createJSON() const
+{
+    Array<var> list;
+
+    for (int i = 0; i < results.size(); ++i)
+    {
+        const Result& r = *results.getUnchecked (i);
+        DynamicObject* const o = new DynamicObject();
+        const var result (o);
+
+        o->setProperty ("name", r.name);
+        o->setProperty ("samples", r.numSamples);
+        o->setProperty ("iterationsPerSample", r.iterationsPerSample);
+        o->setProperty ("medianNs", r.median * 1.0e9);
+        o->setProperty ("madNs", r.medianAbsoluteDeviation * 1.0e9);
+        o->setProperty ("p99Ns", r.percentile99 * 1.0e9);
+        o->setProperty ("meanNs", r.mean * 1.0e9);
+        o->setProperty ("minNs", r.minimum * 1.0e9);
+        o->setProperty ("maxNs", r.maximum * 1.0e9);
+        o->setProperty ("medianTicks", r.medianTicks);
+        o->setProperty ("itemsPerIteration", r.itemsPerIteration);
+        o->setProperty ("medianNsPerItem", r.medianPerItem * 1.0e9);
+        list.add (result);
+    }
+
+    DynamicObject* const root = new DynamicObject();
+    const var json (root);
+    root->setProperty ("ticksPerSecond", Time::getHighResolutionTicksPerSecond());
+    root->setProperty ("benchmarks", list);
+
+    return JSON::toString (json);
+}
+
+String BenchmarkRunner::createCSV() const
+{
+    String s ("name,samples,iterationsPerSample,medianNs,madNs,p99Ns,meanNs,minNs,maxNs,medianTicks,itemsPerIteration,medianNsPerItem\n");
+
+    for (int i = 0; i < results.size(); ++i)
+    {
+        const Result& r = *results.getUnchecked (i);
+
+        s << '"' << r.name.replace ("\"", "\"\"") << "\","
+          << r.numSamples << ','
+          << r.iterationsPerSample << ','
+          << BenchmarkHelpers::toNanoseconds (r.median) << ','
+          << BenchmarkHelpers::toNanoseconds (r.medianAbsoluteDeviation) << ','
+          << BenchmarkHelpers::toNanoseconds (r.percentile99) << ','
+          << BenchmarkHelpers::toNanoseconds (r.mean) << ','
+          << BenchmarkHelpers::toNanoseconds (r.minimum) << ','
+          << BenchmarkHelpers::toNanoseconds (r.maximum) << ','
+          << String (r.medianTicks, 2) << ','
+          << r.itemsPerIteration << ','
+          << BenchmarkHelpers::toNanoseconds (r.medianPerItem) << '\n';
+    }
+
+    return s;
+}
+
+StringArray BenchmarkRunner::findRegressions (const var& baseline, const double maxSlowdown) const
+{
+    StringArray regressions;
+    const var& oldResults = baseline ["benchmarks"];
+
+    for (int i = 0; i < results.size(); ++i)
+    {
+        const Result& r = *results.getUnchecked (i);
+
+        for (int j = 0; j < oldResults.size(); ++j)
+        {
+            const var& old = oldResults[j];
+
+            if (old ["name"].toString() == r.name)
+            {
+                const double oldMedian = old ["medianNs"];
+                const double newMedian = r.median * 1.0e9;
+
+                if (oldMedian > 0 && newMedian > oldMedian * maxSlowdown)
+                    regressions.add (r.name + ": " + String (oldMedian, 2) + " ns -> " + String (newMedian, 2)
+                                       + " ns (" + String (newMedian / oldMedian, 2) + "x)");
+
+                break;
+            }
+        }
+    }
+
+    return regressions;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringBenchmark  : public Benchmark
+{
+public:
+    StringBenchmark() : Benchmark ("String: build, search and compare") {}
+
+    void runIteration()
+    {
+        String s;
+
+        for (int i = 0; i < 100; ++i)
+            s << "item " << i << ", ";
+
+        const bool found = s.contains ("item 99") && s.indexOfIgnoreCase ("ITEM 50") > 0
+                            && s.compareIgnoreCase (s.toUpperCase()) == 0;
+
+        preventOptimisation (&found);
+    }
+};
+
+static StringBenchmark stringBenchmark;
+
+class ArrayBenchmark  : public Benchmark
+{
+public:
+    ArrayBenchmark() : Benchmark ("Array: add, sort and search ints") {}
+
+    void runIteration()
+    {
+        Array<int> a;
+        Random r (1);
+
+        for (int i = 0; i < 1000; ++i)
+            a.add (r.nextInt());
+
+        DefaultElementComparator<int> comparator;
+        a.sort (comparator);
+        const int index = a.indexOf (a[500]);
+
+        preventOptimisation (&index);
+    }
+};
+
+static ArrayBenchmark arrayBenchmark;
+
+class HashMapBenchmark  : public Benchmark
+{
+public:
+    HashMapBenchmark() : Benchmark ("HashMap: insert and look up ints") {}
+
+    void runIteration()
+    {
+        HashMap<int, int> map;
+
+        for (int i = 0; i < 1000; ++i)
+            map.set (i * 7, i);
+
+        int total = 0;
+
+        for (int i = 0; i < 2000; ++i)
+            total += map [i * 7];
+
+        preventOptimisation (&total);
+    }
+};
+
+static HashMapBenchmark hashMapBenchmark;
+
+//==============================================================================
+class BenchmarkTests  : public UnitTest
+{
+public:
+    BenchmarkTests() : UnitTest ("Benchmark") {}
+
+    struct CountingBenchmark  : public Benchmark
+    {
+        CountingBenchmark() : Benchmark ("Counting, \"quoted\""), numIterations (0) {}
+
+        void runIteration()
+        {
+            ++numIterations;
+            Thread::yield();
+        }
+
+        int numIterations;
+    };
+
+    struct QuietRunner  : public BenchmarkRunner
+    {
+        void logMessage (const String&) {}
+    };
+
+    void runTest()
+    {
+        beginTest ("Runner");
+
+        CountingBenchmark benchmark;
+        expect (Benchmark::getAllBenchmarks().contains (&benchmark));
+
+        Array<Benchmark*> benchmarks;
+        benchmarks.add (&benchmark);
+
+        QuietRunner runner;
+        runner.setNumSamples (9, 2);
+        runner.setMinimumSampleDuration (0.0002);
+        runner.runBenchmarks (benchmarks);
+
+        expectEquals (runner.getNumResults(), 1);
+        const BenchmarkRunner::Result* const r = runner.getResult (0);
+        expect (r != nullptr && r->numSamples == 9 && r->iterationsPerSample > 0);
+        expect (benchmark.numIterations >= (9 + 2) * r->iterationsPerSample);
+        expect (r->minimum > 0 && r->minimum <= r->median && r->median <= r->percentile99 && r->percentile99 <= r->maximum);
+        expect (r->medianAbsoluteDeviation >= 0 && r->medianTicks > 0);
+
+        const var json (JSON::parse (runner.createJSON()));
+        expect (json ["benchmarks"].size() == 1);
+        expect (json ["benchmarks"][0]["name"].toString() == benchmark.getName());
+
+        StringArray csv;
+        csv.addLines (runner.createCSV());
+        csv.removeEmptyStrings();
+        expectEquals (csv.size(), 2);
+        expect (csv[1].startsWith ("\"Counting, \"\"quoted\"\"\","));
+
+        beginTest ("Items and regressions");
+
+        expectEquals (r->itemsPerIteration, 1);
+        expect (r->medianPerItem == r->median);
+
+        expect (runner.findRegressions (json, 1000.0).size() == 0);
+
+        DynamicObject* const oldResult = new DynamicObject();
+        const var old (oldResult);
+        oldResult->setProperty ("name", benchmark.getName());
+        oldResult->setProperty ("medianNs", r->median * 1.0e9 * 0.25);
+
+        Array<var> oldList;
+        oldList.add (old);
+
+        DynamicObject* const oldRoot = new DynamicObject();
+        const var baseline (oldRoot);
+        oldRoot->setProperty ("benchmarks", oldList);
+
+        const StringArray regressions (runner.findRegressions (baseline, 2.0));
+        expectEquals (regressions.size(), 1);
+        expect (regressions[0].startsWith (benchmark.getName()));
+
+        runner.runBenchmarksMatching ("no benchmark has this name*");
+        expectEquals (runner.getNumResults(), 0);
+    }
+};
+
+static BenchmarkTests benchmarkTests;
+
+#endif
@@ -0,0 +1,251 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_BENCHMARK_JUCEHEADER__
+#define __JUCE_BENCHMARK_JUCEHEADER__
+
+#include "../text/juce_StringArray.h"
+#include "../containers/juce_OwnedArray.h"
+
+//==============================================================================
+/**
+    This is a base class for classes that measure how long some code takes to run.
+
+    A benchmark is written in the same way as a UnitTest, e.g.
+    @code
+    class StringAppendBenchmark  : public Benchmark
+    {
+    public:
+        StringAppendBenchmark()  : Benchmark ("String append") {}
+
+        void runIteration()
+        {
+            String s;
+            for (int i = 0; i < 100; ++i)
+                s << "abc";
+
+            preventOptimisation (&s);
+        }
+    };
+
+    // Creating a static instance will automatically add the instance to the array
+    // returned by Benchmark::getAllBenchmarks(), so it'll be included when you call
+    // BenchmarkRunner::runAllBenchmarks()
+    static StringAppendBenchmark stringAppendBenchmark;
+    @endcode
+
+    To run the benchmarks, use the BenchmarkRunner class.
+
+    @see BenchmarkRunner, UnitTest
+*/
+class JUCE_API  Benchmark
+{
+public:
+    //==============================================================================
+    /** Creates a benchmark with the given name.
+
+        If each iteration processes a number of items (e.g. audio samples), pass that as
+        itemsPerIteration, and the results will include the time taken per item, which
+        makes it easy to compare benchmarks that use different sizes of data.
+    */
+    explicit Benchmark (const String& name, int itemsPerIteration = 1);
+
+    /** Destructor. */
+    virtual ~Benchmark();
+
+    /** Returns the name of the benchmark. */
+    const String& getName() const noexcept       { return name; }
+
+    /** Returns the number of items that each iteration processes. */
+    int getItemsPerIteration() const noexcept    { return itemsPerIteration; }
+
+    /** Returns the set of all Benchmark objects that currently exist. */
+    static Array<Benchmark*>& getAllBenchmarks();
+
+    //==============================================================================
+    /** You can optionally implement this method to set up any data that the benchmark needs.
+        It's called before any of the iterations are run, and isn't included in the timings.
+    */
+    virtual void initialise();
+
+    /** You can optionally implement this method to clear up after the benchmark has been run. */
+    virtual void shutdown();
+
+    /** Implement this method to perform one iteration of the code that you want to measure.
+        The runner will call it many times, and time how long each call takes on average.
+    */
+    virtual void runIteration() = 0;
+
+    //==============================================================================
+    /** Stops the compiler from optimising away some code because its result is never used.
+        Pass this a pointer to the result of whatever your runIteration() method calculates.
+    */
+    static void preventOptimisation (const void* result) noexcept;
+
+private:
+    //==============================================================================
+    const String name;
+    const int itemsPerIteration;
+
+    JUCE_DECLARE_NON_COPYABLE (Benchmark)
+};
+
+//==============================================================================
+/**
+    Runs a set of benchmarks, and collects statistics about their timings.
+
+    For each benchmark, the runner first works out how many iterations it needs to
+    run so that each timed sample lasts long enough to be measured accurately. It then
+    runs a few samples to warm up, before timing the samples that are used to produce
+    the results.
+
+    The results can be written out as JSON or CSV, e.g. so that a CI system can keep track
+    of how the timings change over time.
+
+    @see Benchmark
+*/
+class JUCE_API  BenchmarkRunner
+{
+public:
+    //==============================================================================
+    /** Creates a runner with some default settings. */
+    BenchmarkRunner();
+
+    /** Destructor. */
+    virtual ~BenchmarkRunner();
+
+    //==============================================================================
+    /** Sets the number of samples that are timed for each benchmark (default is 30), and the
+        number of samples to run and discard before these, to warm up (default is 3).
+    */
+    void setNumSamples (int numSamplesToMeasure, int numWarmUpSamples) noexcept;
+
+    /** Sets the minimum length of time that each sample should take. The number of
+        iterations in each sample is chosen so that it takes at least this long. The
+        default is 0.005 seconds.
+    */
+    void setMinimumSampleDuration (double seconds) noexcept;
+
+    //==============================================================================
+    /** Runs a set of benchmarks.
+        The benchmarks are performed in order, and the results are logged. To run all
+        the registered Benchmark objects, use runAllBenchmarks().
+    */
+    void runBenchmarks (const Array<Benchmark*>& benchmarks);
+
+    /** Runs all the Benchmark objects that currently exist.
+        This calls runBenchmarks() for all the objects listed in Benchmark::getAllBenchmarks().
+    */
+    void runAllBenchmarks();
+
+    /** Runs the Benchmark objects whose names match a wildcard, e.g. "Reverb*".
+        The match ignores case.
+    */
+    void runBenchmarksMatching (const String& wildcard);
+
+    //==============================================================================
+    /** Contains the results of a benchmark.
+        The times are all the number of seconds taken by a single iteration.
+    */
+    struct Result
+    {
+        /** The name of the benchmark. */
+        String name;
+
+        /** The number of samples that were timed. */
+        int numSamples;
+
+        /** The number of times that Benchmark::runIteration() was called in each sample. */
+        int iterationsPerSample;
+
+        double median;                  /**< The median of the times. */
+        double medianAbsoluteDeviation; /**< The median of the differences between each time and the median. */
+        double percentile99;            /**< The 99th percentile of the times. */
+        double mean;                    /**< The mean of the times. */
+        double minimum;                 /**< The fastest time. */
+        double maximum;                 /**< The slowest time. */
+
+        /** The median time, measured in Time::getHighResolutionTicks() units. */
+        double medianTicks;
+
+        /** The number of items that each iteration processed. */
+        int itemsPerIteration;
+
+        /** The median time divided by the number of items processed in each iteration. */
+        double medianPerItem;
+    };
+
+    /** Returns the number of Result objects for the benchmarks that have been run. */
+    int getNumResults() const noexcept;
+
+    /** Returns one of the Result objects for the benchmarks that have been run. */
+    const Result* getResult (int index) const noexcept;
+
+    //==============================================================================
+    /** Returns the results as a JSON document.
+        The times are written as nanoseconds per iteration.
+    */
+    String createJSON() const;
+
+    /** Returns the results as comma-separated values, with a header line.
+        The times are written as nanoseconds per iteration.
+    */
+    String createCSV() const;
+
+    /** Compares the results with an earlier run, to look for benchmarks that have got slower.
+
+        The baseline should be the parsed output of createJSON() from the earlier run.
+        A benchmark counts as slower if its median time is more than maxSlowdown times its
+        median in the baseline (e.g. 1.1 for a 10% slowdown). The array that's returned
+        has a line describing each of these, so it'll be empty if nothing has got slower.
+        Benchmarks that aren't in both sets of results are ignored.
+    */
+    StringArray findRegressions (const var& baseline, double maxSlowdown) const;
+
+protected:
+    /** Logs a message about the benchmarks' progress.
+        By default this just writes the message to the Logger class, but you could override
+        this to do something else with the data.
+    */
+    virtual void logMessage (const String& message);
+
+    /** This can be overridden to let the runner know that it should stop as soon as
+        possible, e.g. because the thread needs to stop.
+    */
+    virtual bool shouldAbortBenchmarks();
+
+private:
+    //==============================================================================
+    OwnedArray<Result> results;
+    int numSamples, numWarmUpSamples;
+    double minimumSampleDuration;
+
+    void runBenchmark (Benchmark&);
+    double timeIterations (Benchmark&, int numIterations) const;
+
+    JUCE_DECLARE_NON_COPYABLE (BenchmarkRunner)
+};
+
+#endif   // __JUCE_BENCHMARK_JUCEHEADER__
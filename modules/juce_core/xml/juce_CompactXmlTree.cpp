@@ -0,0 +1,285 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+CompactXmlTree::CompactXmlTree()
+    : arena (65536),
+      numNameSlots (64),
+      documentElement (nullptr)
+{
+    nameSlots.malloc ((size_t) numNameSlots);
+    memset (nameSlots, 0xff, sizeof (int) * (size_t) numNameSlots);
+
+    const String text ("text");
+    String name (arena, getPooledName (text.getCharPointer(), text.length()));
+    textAttributeName.swapWith (name);
+}
+
+CompactXmlTree::~CompactXmlTree()
+{
+    // Nothing in the tree owns any memory outside the arena, so there's no need to run
+    // the destructors, except to keep the leak-detector happy in a debug build.
+   #if JUCE_CHECK_MEMORY_LEAKS
+    destroyElements (documentElement);
+   #endif
+}
+
+CompactXmlTree* CompactXmlTree::parse (const File& file)
+{
+    XmlDocument doc (file);
+    return doc.getCompactTree();
+}
+
+CompactXmlTree* CompactXmlTree::parse (const String& xmlData)
+{
+    XmlDocument doc (xmlData);
+    return doc.getCompactTree();
+}
+
+//==============================================================================
+// (The strings are all swapped into place, because copying a String that lives in
+// the arena would create a heap copy of it)
+XmlElement* CompactXmlTree::createElement (const String::CharPointerType name, const int numChars)
+{
+    XmlElement* const e = new (arena.allocate (sizeof (XmlElement))) XmlElement ((int) 0);
+
+    String tagName (arena, getPooledName (name, numChars));
+    e->tagName.swapWith (tagName);
+    return e;
+}
+
+XmlElement* CompactXmlTree::createTextElement (const String& text)
+{
+    XmlElement* const e = new (arena.allocate (sizeof (XmlElement))) XmlElement ((int) 0);
+
+    XmlElement::XmlAttributeNode* const att = new (arena.allocate (sizeof (XmlElement::XmlAttributeNode)))
+                                                  XmlElement::XmlAttributeNode (String::empty, String::empty);
+    String name (arena, textAttributeName), value (arena, text);
+    att->name.swapWith (name);
+    att->value.swapWith (value);
+
+    e->attributes = att;
+    return e;
+}
+
+XmlElement::XmlAttributeNode* CompactXmlTree::createAttribute (const String::CharPointerType name, const int numChars,
+                                                               const String& value)
+{
+    XmlElement::XmlAttributeNode* const att = new (arena.allocate (sizeof (XmlElement::XmlAttributeNode)))
+                                                  XmlElement::XmlAttributeNode (String::empty, String::empty);
+    String arenaName (arena, getPooledName (name, numChars)), arenaValue (arena, value);
+    att->name.swapWith (arenaName);
+    att->value.swapWith (arenaValue);
+    return att;
+}
+
+// The elements are destroyed without recursion, by splicing each element's children
+// onto the front of the list of elements that are still waiting to be destroyed.
+void CompactXmlTree::destroyElements (XmlElement* e) noexcept
+{
+    while (e != nullptr)
+    {
+        XmlElement* next = e->nextListItem;
+
+        if (XmlElement* const firstChild = e->firstChildElement)
+        {
+            XmlElement* lastChild = firstChild;
+
+            while (lastChild->nextListItem != nullptr)
+                lastChild = lastChild->nextListItem;
+
+            lastChild->nextListItem = next;
+            next = firstChild;
+        }
+
+        // (the lists are cleared first so that the element's destructor doesn't try to delete them)
+        e->nextListItem = nullptr;
+        e->firstChildElement = nullptr;
+        e->attributes = nullptr;
+        e->~XmlElement();
+
+        e = next;
+    }
+}
+
+//==============================================================================
+const String& CompactXmlTree::getPooledName (const String::CharPointerType name, const int numChars)
+{
+    String::CharPointerType end (name);
+    end += numChars;
+
+    const char* const data = reinterpret_cast <const char*> (name.getAddress());
+    const int numBytes = (int) (reinterpret_cast <const char*> (end.getAddress()) - data);
+
+    uint32 hash = 2166136261u;
+
+    for (int i = 0; i < numBytes; ++i)
+        hash = (hash ^ (uint8) data[i]) * 16777619u;
+
+    const int mask = numNameSlots - 1;
+    int slot = (int) (hash & (uint32) mask);
+
+    for (;; slot = (slot + 1) & mask)
+    {
+        const int index = nameSlots[slot];
+
+        if (index < 0)
+            break;
+
+        const PooledName& p = names.getReference (index);
+
+        if (p.hash == hash && p.numBytes == numBytes
+             && memcmp (p.name.getCharPointer().getAddress(), data, (size_t) numBytes) == 0)
+            return p.name;
+    }
+
+    const int index = names.size();
+    nameSlots[slot] = index;
+    names.add (PooledName());
+
+    PooledName& newName = names.getReference (index);
+    String arenaName (arena, name, end);
+    newName.name.swapWith (arenaName);
+    newName.hash = hash;
+    newName.numBytes = numBytes;
+
+    if (names.size() * 2 > numNameSlots)
+        rehashNames();
+
+    return newName.name;
+}
+
+void CompactXmlTree::rehashNames()
+{
+    numNameSlots *= 2;
+    nameSlots.malloc ((size_t) numNameSlots);
+    memset (nameSlots, 0xff, sizeof (int) * (size_t) numNameSlots);
+
+    const int mask = numNameSlots - 1;
+
+    for (int i = 0; i < names.size(); ++i)
+    {
+        int slot = (int) (names.getReference (i).hash & (uint32) mask);
+
+        while (nameSlots[slot] >= 0)
+            slot = (slot + 1) & mask;
+
+        nameSlots[slot] = i;
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class CompactXmlTreeTests  : public UnitTest
+{
+public:
+    CompactXmlTreeTests() : UnitTest ("CompactXmlTree") {}
+
+    static String createTestDocument (const int numItems)
+    {
+        MemoryOutputStream out;
+        out << "<?xml version=\"1.0\"?>\n<ROOT>\n";
+
+        for (int i = 0; i < numItems; ++i)
+            out << "  <ITEM id=\"" << i << "\" name=\"item &amp; " << i << "\" gain=\"" << (i * 0.25) << "\">\n"
+                << "    text &lt;" << i << "&gt; <![CDATA[raw <data>]]>\n"
+                << "    <EMPTY a=\"b\"/>\n"
+                << "    <CHILD x=\"y\">z</CHILD>\n"
+                << "  </ITEM>\n";
+
+        out << "</ROOT>\n";
+        return out.toString();
+    }
+
+    void runTest()
+    {
+        beginTest ("Parsing");
+
+        {
+            const String document (createTestDocument (100));
+            const ScopedPointer<XmlElement> normalTree (XmlDocument::parse (document));
+            const ScopedPointer<CompactXmlTree> compactTree (CompactXmlTree::parse (document));
+
+            expect (normalTree != nullptr && compactTree != nullptr);
+            expect (compactTree->getDocumentElement()->isEquivalentTo (normalTree, false));
+
+            // ROOT, ITEM, id, name, gain, EMPTY, a, CHILD, x, and "text" for the text elements
+            expectEquals (compactTree->getNumUniqueNames(), 10);
+
+            const XmlElement* const item1 = compactTree->getDocumentElement()->getChildElement (1);
+            const XmlElement* const item2 = compactTree->getDocumentElement()->getChildElement (2);
+            expect (item1->getTagName().getCharPointer().getAddress() == item2->getTagName().getCharPointer().getAddress());
+            expect (item1->getAttributeName (2).getCharPointer().getAddress() == item2->getAttributeName (2).getCharPointer().getAddress());
+            expectEquals (item2->getStringAttribute ("name"), String ("item & 2"));
+            expectEquals (item2->getAllSubText().trim(), String ("text <2> raw <data>z"));
+
+            const ScopedPointer<XmlElement> copy (new XmlElement (*item2));
+            expect (copy->isEquivalentTo (item2, false));
+        }
+
+        {
+            XmlDocument doc ("<a><b x=\"1\"></a>");
+            const ScopedPointer<CompactXmlTree> tree (doc.getCompactTree());
+            expect (tree == nullptr && doc.getLastParseError().isNotEmpty());
+
+            expect (CompactXmlTree::parse (String::empty) == nullptr);
+        }
+
+        beginTest ("Benchmark");
+
+        {
+            const String document (createTestDocument (30000));
+
+            double start = Time::getMillisecondCounterHiRes();
+            ScopedPointer<XmlElement> normalTree (XmlDocument::parse (document));
+            const double normalParseTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            ScopedPointer<CompactXmlTree> compactTree (CompactXmlTree::parse (document));
+            const double compactParseTime = Time::getMillisecondCounterHiRes() - start;
+
+            expect (compactTree->getDocumentElement()->isEquivalentTo (normalTree, false));
+
+            // (the compact tree is deleted first, because freeing its large blocks makes the allocator
+            // tidy up after any small blocks that were freed before it, which would skew the timing)
+            start = Time::getMillisecondCounterHiRes();
+            compactTree = nullptr;
+            const double compactDeleteTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            normalTree = nullptr;
+            const double normalDeleteTime = Time::getMillisecondCounterHiRes() - start;
+
+            logMessage ("Parsing " + String ((int) (document.getNumBytesAsUTF8() / 1024)) + " KB: XmlElement tree "
+                          + String (normalParseTime, 1) + " ms, deleted in " + String (normalDeleteTime, 1)
+                          + " ms. CompactXmlTree " + String (compactParseTime, 1) + " ms, deleted in "
+                          + String (compactDeleteTime, 1) + " ms");
+        }
+    }
+};
+
+static CompactXmlTreeTests compactXmlTreeTests;
+
+#endif
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_COMPACTXMLTREE_JUCEHEADER__
+#define __JUCE_COMPACTXMLTREE_JUCEHEADER__
+
+#include "juce_XmlElement.h"
+#include "../memory/juce_MemoryArena.h"
+#include "../memory/juce_HeapBlock.h"
+
+
+//==============================================================================
+/**
+    A read-only tree of XmlElements whose nodes are all held in a single MemoryArena.
+
+    A tree created by XmlDocument::getDocumentElement() allocates every element and
+    every attribute separately, and gives each one its own copy of its name. For very
+    large documents that's millions of small allocations, and deleting the tree takes
+    as long as building it.
+
+    A CompactXmlTree instead packs all the elements, attributes, attribute values and
+    text into large blocks, and every occurrence of a tag or attribute name shares the
+    same string. Destroying the tree just frees the blocks.
+
+    The elements are ordinary XmlElement objects, so they can be read with all the
+    usual methods:
+
+    @code
+    ScopedPointer<CompactXmlTree> tree (CompactXmlTree::parse (bigFile));
+
+    if (tree != nullptr)
+    {
+        forEachXmlChildElementWithTagName (*tree->getDocumentElement(), e, "ITEM")
+            ...
+    }
+    @endcode
+
+    The tree must not be modified though: don't add, remove or delete any of its
+    elements or attributes, as they weren't allocated with operator new. If you need
+    to edit part of the document, copy the element you need with
+    XmlElement (const XmlElement&), which creates a normal tree.
+
+    Any Strings that you copy from the tree are normal heap-allocated strings, so it's
+    fine to keep them after the tree has been deleted (see String (MemoryArena&, const String&)).
+
+    @see XmlDocument::getCompactTree, XmlElement
+*/
+class JUCE_API  CompactXmlTree
+{
+public:
+    //==============================================================================
+    /** Destructor.
+        All the XmlElements in the tree are destroyed, so any pointers to them become invalid.
+    */
+    ~CompactXmlTree();
+
+    //==============================================================================
+    /** Parses a file into a compact tree.
+        @returns a new tree which the caller must delete, or nullptr if there was an error.
+        @see XmlDocument::getCompactTree
+    */
+    static CompactXmlTree* parse (const File& file);
+
+    /** Parses some XML text into a compact tree.
+        @returns a new tree which the caller must delete, or nullptr if there was an error.
+        @see XmlDocument::getCompactTree
+    */
+    static CompactXmlTree* parse (const String& xmlData);
+
+    //==============================================================================
+    /** Returns the outer element of the document.
+        This will never be null for a tree that was successfully parsed.
+    */
+    const XmlElement* getDocumentElement() const noexcept       { return documentElement; }
+
+    /** Returns the number of different tag and attribute names that the tree contains. */
+    int getNumUniqueNames() const noexcept                      { return names.size(); }
+
+    /** Returns the number of bytes used by the tree's elements, attributes and text. */
+    size_t getNumBytesUsed() const noexcept                     { return arena.getNumBytesUsed(); }
+
+private:
+    //==============================================================================
+    struct PooledName
+    {
+        String name;
+        uint32 hash;
+        int numBytes;
+    };
+
+    MemoryArena arena;
+    Array<PooledName> names;
+    HeapBlock<int> nameSlots;
+    int numNameSlots;
+    String textAttributeName;
+    XmlElement* documentElement;
+
+    friend class XmlDocument;
+    CompactXmlTree();
+
+    XmlElement* createElement (String::CharPointerType name, int numChars);
+    XmlElement* createTextElement (const String& text);
+    XmlElement::XmlAttributeNode* createAttribute (String::CharPointerType name, int numChars, const String& value);
+    const String& getPooledName (String::CharPointerType name, int numChars);
+    void rehashNames();
+    static void destroyElements (XmlElement*) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CompactXmlTree)
+};
+
+
+#endif   // __JUCE_COMPACTXMLTREE_JUCEHEADER__
@@ -26,14 +26,16 @@
 XmlDocument::XmlDocument (const String& documentText)
     : originalText (documentText),
       input (nullptr),
-      ignoreEmptyTextElements (true)
+      ignoreEmptyTextElements (true),
+      compactTree (nullptr)
 {
 }
 
 XmlDocument::XmlDocument (const File& file)
     : input (nullptr),
       ignoreEmptyTextElements (true),
-      inputSource (new FileInputSource (file))
+      inputSource (new FileInputSource (file)),
+      compactTree (nullptr)
 {
 }
 
@@ -94,6 +96,30 @@ namespace XmlIdentifierChars
     }*/
 }
 
+namespace XmlTextScanner
+{
+    /*  Finds the next delimiter by looking at the raw code-units of the string rather than
+        decoding each character. This is safe because the delimiters are all ASCII, and no
+        byte of a multi-byte UTF-8 (or UTF-16) sequence can be mistaken for an ASCII character.
+    */
+    static String::CharPointerType findEndOfText (const String::CharPointerType start,
+                                                  const char delimiter1, const char delimiter2) noexcept
+    {
+        typedef String::CharPointerType::CharType CharType;
+        return String::CharPointerType (CharacterFunctions::findFirstOf (start.getAddress(),
+                                                                         (CharType) delimiter1,
+                                                                         (CharType) delimiter2));
+    }
+
+    static void appendText (String& dest, const String::CharPointerType start, const String::CharPointerType end)
+    {
+        if (dest.isEmpty())
+            dest = String (start, end);
+        else
+            dest += String (start, end);
+    }
+}
+
 XmlElement* XmlDocument::getDocumentElement (const bool onlyReadOuterDocumentElement)
 {
     String textToParse (originalText);
@@ -131,7 +157,9 @@ XmlElement* XmlDocument::getDocumentElement (const bool onlyReadOuterDocumentEle
         {
             ScopedPointer <XmlElement> result (readNextElement (! onlyReadOuterDocumentElement));
 
-            if (! errorOccurred)
+            if (compactTree != nullptr)
+                compactTree->documentElement = result.release(); // (the tree will take care of destroying it)
+            else if (! errorOccurred)
                 return result.release();
         }
         else
@@ -143,6 +171,20 @@ XmlElement* XmlDocument::getDocumentElement (const bool onlyReadOuterDocumentEle
     return nullptr;
 }
 
+CompactXmlTree* XmlDocument::getCompactTree()
+{
+    ScopedPointer <CompactXmlTree> tree (new CompactXmlTree());
+
+    compactTree = tree;
+    getDocumentElement (false);
+    compactTree = nullptr;
+
+    if (errorOccurred || tree->documentElement == nullptr)
+        return nullptr;
+
+    return tree.release();
+}
+
 const String& XmlDocument::getLastParseError() const noexcept
 {
     return lastError;
@@ -182,11 +224,11 @@ juce_wchar XmlDocument::readNextChar() noexcept
 
 int XmlDocument::findNextTokenLength() noexcept
 {
+    String::CharPointerType t (input);
     int len = 0;
-    juce_wchar c = *input;
 
-    while (XmlIdentifierChars::isIdentifierChar (c))
-        c = input [++len];
+    while (XmlIdentifierChars::isIdentifierChar (t.getAndAdvance()))
+        ++len;
 
     return len;
 }
@@ -320,32 +362,20 @@ void XmlDocument::readQuotedString (String& result)
         else
         {
             const String::CharPointerType start (input);
-            size_t numChars = 0;
+            input = XmlTextScanner::findEndOfText (input, (char) quote, '&');
+            XmlTextScanner::appendText (result, start, input);
 
-            for (;;)
+            if (*input == quote)
             {
-                const juce_wchar character = *input;
-
-                if (character == quote)
-                {
-                    result.appendCharPointer (start, numChars);
-                    ++input;
-                    return;
-                }
-                else if (character == '&')
-                {
-                    result.appendCharPointer (start, numChars);
-                    break;
-                }
-                else if (character == 0)
-                {
-                    outOfData = true;
-                    setLastError ("unmatched quotes", false);
-                    break;
-                }
-
                 ++input;
-                ++numChars;
+                return;
+            }
+
+            if (input.isEmpty())
+            {
+                outOfData = true;
+                setLastError ("unmatched quotes", false);
+                break;
             }
         }
     }
@@ -379,7 +409,7 @@ XmlElement* XmlDocument::readNextElement (const bool alsoParseSubElements)
             }
         }
 
-        node = new XmlElement (String (input, (size_t) tagLen));
+        node = createElement (input, tagLen);
         input += tagLen;
         LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (node->attributes);
 
@@ -428,12 +458,9 @@ XmlElement* XmlDocument::readNextElement (const bool alsoParseSubElements)
 
                         if (nextChar == '"' || nextChar == '\'')
                         {
-                            XmlElement::XmlAttributeNode* const newAtt
-                                = new XmlElement::XmlAttributeNode (String (attNameStart, (size_t) attNameLen),
-                                                                    String::empty);
-
-                            readQuotedString (newAtt->value);
-                            attributeAppender.append (newAtt);
+                            String value;
+                            readQuotedString (value);
+                            attributeAppender.append (createAttribute (attNameStart, attNameLen, value));
                             continue;
                         }
                     }
@@ -490,30 +517,30 @@ void XmlDocument::readChildElements (XmlElement* parent)
             {
                 input += 9;
                 const String::CharPointerType inputStart (input);
-
-                size_t len = 0;
+                String::CharPointerType inputEnd (input);
 
                 for (;;)
                 {
-                    if (*input == 0)
+                    input = XmlTextScanner::findEndOfText (input, ']', ']');
+
+                    if (input.isEmpty())
                     {
                         setLastError ("unterminated CDATA section", false);
                         outOfData = true;
+                        inputEnd = input;
                         break;
                     }
-                    else if (input[0] == ']'
-                              && input[1] == ']'
-                              && input[2] == '>')
+                    else if (input[1] == ']' && input[2] == '>')
                     {
+                        inputEnd = input;
                         input += 3;
                         break;
                     }
 
                     ++input;
-                    ++len;
                 }
 
-                childAppender.append (XmlElement::createTextElement (String (inputStart, len)));
+                childAppender.append (createTextElement (String (inputStart, inputEnd)));
             }
             else
             {
@@ -577,39 +604,52 @@ void XmlDocument::readChildElements (XmlElement* parent)
                 else
                 {
                     const String::CharPointerType start (input);
-                    size_t len = 0;
+                    input = XmlTextScanner::findEndOfText (input, '<', '&');
 
-                    for (;;)
+                    if (input.isEmpty())
                     {
-                        const juce_wchar nextChar = *input;
-
-                        if (nextChar == '<' || nextChar == '&')
-                        {
-                            break;
-                        }
-                        else if (nextChar == 0)
-                        {
-                            setLastError ("unmatched tags", false);
-                            outOfData = true;
-                            return;
-                        }
-
-                        ++input;
-                        ++len;
+                        setLastError ("unmatched tags", false);
+                        outOfData = true;
+                        return;
                     }
 
-                    textElementContent.appendCharPointer (start, len);
+                    XmlTextScanner::appendText (textElementContent, start, input);
                 }
             }
 
             if ((! ignoreEmptyTextElements) || textElementContent.containsNonWhitespaceChars())
             {
-                childAppender.append (XmlElement::createTextElement (textElementContent));
+                childAppender.append (createTextElement (textElementContent));
             }
         }
     }
 }
 
+XmlElement* XmlDocument::createElement (const String::CharPointerType tagName, const int tagNameLength)
+{
+    if (compactTree != nullptr)
+        return compactTree->createElement (tagName, tagNameLength);
+
+    return new XmlElement (String (tagName, (size_t) tagNameLength));
+}
+
+XmlElement::XmlAttributeNode* XmlDocument::createAttribute (const String::CharPointerType name, const int nameLength,
+                                                            const String& value)
+{
+    if (compactTree != nullptr)
+        return compactTree->createAttribute (name, nameLength, value);
+
+    return new XmlElement::XmlAttributeNode (String (name, (size_t) nameLength), value);
+}
+
+XmlElement* XmlDocument::createTextElement (const String& text)
+{
+    if (compactTree != nullptr)
+        return compactTree->createTextElement (text);
+
+    return XmlElement::createTextElement (text);
+}
+
 void XmlDocument::readEntity (String& result)
 {
     // skip over the ampersand
@@ -31,6 +31,7 @@
 #include "../files/juce_File.h"
 #include "../memory/juce_ScopedPointer.h"
 class InputSource;
+class CompactXmlTree;
 
 
 //==============================================================================
@@ -108,6 +109,18 @@ public:
     */
     XmlElement* getDocumentElement (bool onlyReadOuterDocumentElement = false);
 
+    /** Parses the document into a CompactXmlTree rather than a tree of separately
+        allocated XmlElements.
+
+        This is much quicker to build and to delete for large documents, but the
+        resulting tree can't be modified.
+
+        @returns    a new tree which the caller will need to delete, or nullptr if there
+                    was an error.
+        @see getLastParseError, CompactXmlTree
+    */
+    CompactXmlTree* getCompactTree();
+
     /** Returns the parsing error that occurred the last time getDocumentElement was called.
 
         @returns the error, or an empty string if there was no error.
@@ -160,6 +173,7 @@ private:
     StringArray tokenisedDTD;
     bool needToLoadDTD, ignoreEmptyTextElements;
     ScopedPointer <InputSource> inputSource;
+    CompactXmlTree* compactTree;
 
     void setLastError (const String& desc, bool carryOn);
     void skipHeader();
@@ -170,6 +184,9 @@ private:
     int findNextTokenLength() noexcept;
     void readQuotedString (String& result);
     void readEntity (String& result);
+    XmlElement* createElement (String::CharPointerType tagName, int tagNameLength);
+    XmlElement::XmlAttributeNode* createAttribute (String::CharPointerType name, int nameLength, const String& value);
+    XmlElement* createTextElement (const String& text);
 
     String getFileContents (const String& filename) const;
     String expandEntity (const String& entity);
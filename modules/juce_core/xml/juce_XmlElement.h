@@ -713,7 +713,9 @@ private:
         XmlAttributeNode& operator= (const XmlAttributeNode&);
     };
 
+    friend class CompactXmlTree;
     friend class XmlDocument;
+    friend class XmlStreamReader;
     friend class LinkedListPointer <XmlAttributeNode>;
     friend class LinkedListPointer <XmlElement>;
     friend class LinkedListPointer <XmlElement>::Appender;
@@ -0,0 +1,787 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+XmlStreamReader::XmlStreamReader (InputStream* const sourceStream,
+                                  const bool deleteSourceWhenDestroyed,
+                                  const int bufferSize_)
+    : source (sourceStream, deleteSourceWhenDestroyed),
+      bufferSize (jmax (8, bufferSize_)),
+      bufferPos (0),
+      bufferEnd (0),
+      sourceExhausted (sourceStream == nullptr),
+      ignoreEmptyTextElements (true),
+      emptyElementPending (false),
+      currentEvent (text),
+      currentDepth (0),
+      numAttributes (0)
+{
+    buffer.malloc ((size_t) bufferSize);
+}
+
+XmlStreamReader::~XmlStreamReader()
+{
+}
+
+void XmlStreamReader::setEmptyTextElementsIgnored (const bool shouldBeIgnored) noexcept
+{
+    ignoreEmptyTextElements = shouldBeIgnored;
+}
+
+const String& XmlStreamReader::getAttributeName (const int index) const noexcept
+{
+    return isPositiveAndBelow (index, numAttributes) ? attributeNames.getReference (index) : String::empty;
+}
+
+const String& XmlStreamReader::getAttributeValue (const int index) const noexcept
+{
+    return isPositiveAndBelow (index, numAttributes) ? attributeValues.getReference (index) : String::empty;
+}
+
+String XmlStreamReader::getStringAttribute (const String& attributeName, const String& defaultReturnValue) const
+{
+    for (int i = 0; i < numAttributes; ++i)
+        if (attributeNames.getReference (i) == attributeName)
+            return attributeValues.getReference (i);
+
+    return defaultReturnValue;
+}
+
+//==============================================================================
+namespace XmlStreamReaderHelpers
+{
+    static inline bool isNameByte (const int c) noexcept
+    {
+        return c >= 0x80 || XmlIdentifierChars::isIdentifierChar ((juce_wchar) c);
+    }
+
+    static inline bool isWhitespaceByte (const int c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    static bool isAllWhitespace (const MemoryOutputStream& data) noexcept
+    {
+        const char* const d = static_cast <const char*> (data.getData());
+
+        for (size_t i = 0; i < data.getDataSize(); ++i)
+            if (! isWhitespaceByte ((uint8) d[i]))
+                return false;
+
+        return true;
+    }
+
+    static String toString (const MemoryOutputStream& data)
+    {
+        return String::fromUTF8 (static_cast <const char*> (data.getData()), (int) data.getDataSize());
+    }
+}
+
+bool XmlStreamReader::fillBuffer()
+{
+    if (sourceExhausted)
+        return false;
+
+    bufferPos = 0;
+    bufferEnd = source->read (buffer, bufferSize);
+
+    if (bufferEnd <= 0)
+    {
+        bufferEnd = 0;
+        sourceExhausted = true;
+        return false;
+    }
+
+    return true;
+}
+
+inline int XmlStreamReader::peekByte()
+{
+    return (bufferPos < bufferEnd || fillBuffer()) ? (int) (uint8) buffer [bufferPos] : -1;
+}
+
+inline int XmlStreamReader::readByte()
+{
+    return (bufferPos < bufferEnd || fillBuffer()) ? (int) (uint8) buffer [bufferPos++] : -1;
+}
+
+void XmlStreamReader::skipWhitespace()
+{
+    while (XmlStreamReaderHelpers::isWhitespaceByte (peekByte()))
+        ++bufferPos;
+}
+
+bool XmlStreamReader::skipPast (const char* const terminator)
+{
+    const int length = (int) strlen (terminator);
+    char window[4] = { 0 };
+    jassert (length <= 3);
+
+    for (int numRead = 1;; ++numRead)
+    {
+        const int c = readByte();
+
+        if (c < 0)
+            return false;
+
+        window[0] = window[1];
+        window[1] = window[2];
+        window[2] = (char) c;
+
+        if (numRead >= length && memcmp (window + 3 - length, terminator, (size_t) length) == 0)
+            return true;
+    }
+}
+
+bool XmlStreamReader::setError (const String& message)
+{
+    lastError = message;
+    currentEvent = parseError;
+    return true;
+}
+
+//==============================================================================
+bool XmlStreamReader::readName (String& result)
+{
+    scratch.reset();
+
+    while (bufferPos < bufferEnd || fillBuffer())
+    {
+        const char* const start = buffer + bufferPos;
+        const char* const end = buffer + bufferEnd;
+        const char* p = start;
+
+        while (p < end && XmlStreamReaderHelpers::isNameByte ((uint8) *p))
+            ++p;
+
+        bufferPos += (int) (p - start);
+
+        if (p < end && scratch.getDataSize() == 0)
+        {
+            // (the usual case, where the whole name is in the buffer)
+            if (p == start)
+                return false;
+
+            result = String::fromUTF8 (start, (int) (p - start));
+            return true;
+        }
+
+        scratch.write (start, (size_t) (p - start));
+
+        if (p < end)
+            break;
+    }
+
+    if (scratch.getDataSize() == 0)
+        return false;
+
+    result = XmlStreamReaderHelpers::toString (scratch);
+    return true;
+}
+
+bool XmlStreamReader::readAttributeValue (String& result)
+{
+    const int quote = readByte();
+
+    if (quote != '"' && quote != '\'')
+        return false;
+
+    scratch.reset();
+
+    while (bufferPos < bufferEnd || fillBuffer())
+    {
+        const char* const start = buffer + bufferPos;
+        const char* const end = buffer + bufferEnd;
+        const char* p = start;
+
+        while (p < end && *p != quote && *p != '&')
+            ++p;
+
+        bufferPos += (int) (p - start);
+
+        if (p < end && *p == quote && scratch.getDataSize() == 0)
+        {
+            result = String::fromUTF8 (start, (int) (p - start));
+            ++bufferPos;
+            return true;
+        }
+
+        scratch.write (start, (size_t) (p - start));
+
+        if (p < end)
+        {
+            if (*p == quote)
+            {
+                ++bufferPos;
+                result = XmlStreamReaderHelpers::toString (scratch);
+                return true;
+            }
+
+            readEntity();
+        }
+    }
+
+    return false;
+}
+
+void XmlStreamReader::readEntity()
+{
+    ++bufferPos; // skip the ampersand
+
+    char name[16];
+    int length = 0;
+
+    for (;;)
+    {
+        const int c = peekByte();
+
+        if (c < 0 || c == ';' || c == '<' || c == '&' || c == '"' || c == '\''
+             || XmlStreamReaderHelpers::isWhitespaceByte (c) || length >= (int) sizeof (name) - 1)
+            break;
+
+        name [length++] = (char) c;
+        ++bufferPos;
+    }
+
+    name [length] = 0;
+
+    if (peekByte() == ';')
+    {
+        ++bufferPos;
+
+        const String entity (name);
+        juce_wchar expanded = 0;
+
+        if (entity.equalsIgnoreCase ("amp"))        expanded = '&';
+        else if (entity.equalsIgnoreCase ("quot"))  expanded = '"';
+        else if (entity.equalsIgnoreCase ("apos"))  expanded = '\'';
+        else if (entity.equalsIgnoreCase ("lt"))    expanded = '<';
+        else if (entity.equalsIgnoreCase ("gt"))    expanded = '>';
+        else if (name[0] == '#' && (name[1] == 'x' || name[1] == 'X'))  expanded = (juce_wchar) entity.substring (2).getHexValue32();
+        else if (name[0] == '#')                    expanded = (juce_wchar) entity.substring (1).getIntValue();
+
+        if (expanded != 0)
+        {
+            char utf8[8];
+            CharPointer_UTF8 dest (utf8);
+            dest.write (expanded);
+            scratch.write (utf8, (size_t) (dest.getAddress() - utf8));
+            return;
+        }
+
+        // not an entity that we know about, so leave it as it is..
+        scratch << '&';
+        scratch.write (name, (size_t) length);
+        scratch << ';';
+        return;
+    }
+
+    scratch << '&';
+    scratch.write (name, (size_t) length);
+}
+
+//==============================================================================
+XmlStreamReader::EventType XmlStreamReader::next()
+{
+    if (currentEvent == endOfDocument || currentEvent == parseError)
+        return currentEvent;
+
+    if (emptyElementPending)
+    {
+        emptyElementPending = false;
+        openTags.remove (openTags.size() - 1);
+        numAttributes = 0;
+        return currentEvent = endElement;
+    }
+
+    if (currentEvent == endElement && openTags.size() == 0)
+        return currentEvent = endOfDocument;
+
+    for (;;)
+    {
+        const int c = peekByte();
+
+        if (c < 0)
+        {
+            if (openTags.size() > 0)
+                setError ("unmatched tags");
+            else
+                currentEvent = endOfDocument;
+
+            return currentEvent;
+        }
+
+        if (c == '<')
+        {
+            ++bufferPos;
+
+            if (readTag())
+                return currentEvent;
+        }
+        else if (readText())
+        {
+            return currentEvent;
+        }
+    }
+}
+
+bool XmlStreamReader::readTag()
+{
+    const int c = peekByte();
+
+    if (c == '?')
+    {
+        if (! skipPast ("?>"))
+            return setError ("unterminated processing instruction");
+
+        return false;
+    }
+
+    if (c == '!')
+    {
+        ++bufferPos;
+        return readSpecialSection();
+    }
+
+    if (c == '/')
+    {
+        ++bufferPos;
+
+        if (! readName (tagName))
+            return setError ("tag name missing");
+
+        skipWhitespace();
+
+        if (readByte() != '>')
+            return setError ("illegal character found in closing tag " + tagName);
+
+        if (openTags.size() == 0 || openTags [openTags.size() - 1] != tagName)
+            return setError ("mismatched closing tag: " + tagName);
+
+        currentDepth = openTags.size();
+        openTags.remove (openTags.size() - 1);
+        numAttributes = 0;
+        currentEvent = endElement;
+        return true;
+    }
+
+    // (allow for a gap after the '<', as XmlDocument does)
+    skipWhitespace();
+
+    if (! readName (tagName))
+        return setError ("tag name missing");
+
+    numAttributes = 0;
+
+    for (;;)
+    {
+        skipWhitespace();
+        const int nextChar = peekByte();
+
+        if (nextChar == '>')
+        {
+            ++bufferPos;
+            break;
+        }
+
+        if (nextChar == '/')
+        {
+            ++bufferPos;
+
+            if (readByte() != '>')
+                return setError ("illegal character found in " + tagName + ": '/'");
+
+            emptyElementPending = true;
+            break;
+        }
+
+        if (nextChar < 0)
+            return setError ("unmatched tags");
+
+        if (numAttributes == attributeNames.size())
+        {
+            attributeNames.add (String::empty);
+            attributeValues.add (String::empty);
+        }
+
+        if (! readName (attributeNames.getReference (numAttributes)))
+            return setError ("illegal character found in " + tagName + ": '"
+                               + String::charToString ((juce_wchar) nextChar) + "'");
+
+        skipWhitespace();
+
+        if (readByte() != '=')
+            return setError ("missing value for attribute " + attributeNames.getReference (numAttributes));
+
+        skipWhitespace();
+
+        if (! readAttributeValue (attributeValues.getReference (numAttributes)))
+            return setError ("unmatched quotes");
+
+        ++numAttributes;
+    }
+
+    openTags.add (tagName);
+    currentDepth = openTags.size();
+    currentEvent = startElement;
+    return true;
+}
+
+bool XmlStreamReader::readSpecialSection()
+{
+    const int c = readByte();
+
+    if (c == '-')
+    {
+        if (readByte() != '-' || ! skipPast ("-->"))
+            return setError ("unterminated comment");
+
+        return false;
+    }
+
+    if (c == '[')
+    {
+        for (const char* t = "CDATA["; *t != 0; ++t)
+            if (readByte() != *t)
+                return setError ("illegal CDATA section");
+
+        scratch.reset();
+
+        for (;;)
+        {
+            const int b = readByte();
+
+            if (b < 0)
+                return setError ("unterminated CDATA section");
+
+            scratch << (char) b;
+
+            const size_t size = scratch.getDataSize();
+
+            if (b == '>' && size >= 3
+                 && memcmp (static_cast <const char*> (scratch.getData()) + size - 3, "]]>", 3) == 0)
+                break;
+        }
+
+        if (openTags.size() == 0)
+            return false;
+
+        textContent = String::fromUTF8 (static_cast <const char*> (scratch.getData()), (int) scratch.getDataSize() - 3);
+        currentDepth = openTags.size();
+        currentEvent = text;
+        return true;
+    }
+
+    // some other kind of declaration, e.g. a DOCTYPE, which may contain nested brackets
+    for (int depth = 1; depth > 0;)
+    {
+        const int b = readByte();
+
+        if (b < 0)
+            return setError ("unterminated declaration");
+
+        if (b == '<')       ++depth;
+        else if (b == '>')  --depth;
+    }
+
+    return false;
+}
+
+bool XmlStreamReader::readText()
+{
+    scratch.reset();
+
+    while (bufferPos < bufferEnd || fillBuffer())
+    {
+        const char* const start = buffer + bufferPos;
+        const char* const end = buffer + bufferEnd;
+        const char* p = start;
+
+        while (p < end && *p != '<' && *p != '&')
+            ++p;
+
+        bufferPos += (int) (p - start);
+        scratch.write (start, (size_t) (p - start));
+
+        if (p < end)
+        {
+            if (*p == '<')
+                break;
+
+            readEntity();
+        }
+    }
+
+    // (anything outside the document element is ignored)
+    if (openTags.size() == 0)
+        return false;
+
+    if (bufferPos >= bufferEnd && sourceExhausted)
+        return setError ("unmatched tags");
+
+    if (ignoreEmptyTextElements && XmlStreamReaderHelpers::isAllWhitespace (scratch))
+        return false;
+
+    textContent = XmlStreamReaderHelpers::toString (scratch);
+    currentDepth = openTags.size();
+    currentEvent = text;
+    return true;
+}
+
+//==============================================================================
+XmlElement* XmlStreamReader::createElementFromCurrentTag() const
+{
+    XmlElement* const e = new XmlElement (tagName);
+    LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (e->attributes);
+
+    for (int i = 0; i < numAttributes; ++i)
+        attributeAppender.append (new XmlElement::XmlAttributeNode (attributeNames.getReference (i),
+                                                                    attributeValues.getReference (i)));
+
+    return e;
+}
+
+XmlElement* XmlStreamReader::readElement()
+{
+    // this can only be called when the reader is positioned at the start of an element!
+    jassert (currentEvent == startElement);
+
+    if (currentEvent != startElement)
+        return nullptr;
+
+    ScopedPointer<XmlElement> root (createElementFromCurrentTag());
+
+    // for each open element, this holds the place where its next child should be added
+    Array<LinkedListPointer<XmlElement>*> childListEnds;
+    childListEnds.add (&(root->firstChildElement));
+
+    while (childListEnds.size() > 0)
+    {
+        switch (next())
+        {
+            case startElement:
+            {
+                XmlElement* const e = createElementFromCurrentTag();
+                LinkedListPointer<XmlElement>*& end = childListEnds.getReference (childListEnds.size() - 1);
+                *end = e;
+                end = &(e->nextListItem);
+                childListEnds.add (&(e->firstChildElement));
+                break;
+            }
+
+            case text:
+            {
+                XmlElement* const e = XmlElement::createTextElement (textContent);
+                LinkedListPointer<XmlElement>*& end = childListEnds.getReference (childListEnds.size() - 1);
+                *end = e;
+                end = &(e->nextListItem);
+                break;
+            }
+
+            case endElement:
+                childListEnds.removeLast();
+                break;
+
+            default:
+                return nullptr;
+        }
+    }
+
+    return root.release();
+}
+
+void XmlStreamReader::skipElement()
+{
+    jassert (currentEvent == startElement);
+
+    if (currentEvent == startElement)
+    {
+        const int depth = currentDepth;
+
+        for (;;)
+        {
+            const EventType e = next();
+
+            if ((e == endElement && currentDepth == depth) || e == parseError || e == endOfDocument)
+                break;
+        }
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlStreamReaderTests  : public UnitTest
+{
+public:
+    XmlStreamReaderTests() : UnitTest ("XmlStreamReader") {}
+
+    static String createTestDocument (const int numItems)
+    {
+        MemoryOutputStream out;
+
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<!-- a comment with -- dashes -->\n"
+            << "<!DOCTYPE ROOT [ <!ELEMENT ROOT ANY> ]>\n"
+            << "<ROOT version=\"1\">\n";
+
+        for (int i = 0; i < numItems; ++i)
+        {
+            out << "  <ITEM id=\"" << i << "\" name='item &amp; \"" << i << "\"' gain=\"" << (i * 0.25) << "\">\n"
+                << "    some text &lt;" << i << "&gt; caf" << String (CharPointer_UTF8 ("\xc3\xa9")) << " &#x263a; &#65;\n"
+                << "    <![CDATA[raw <data> & stuff]]>\n"
+                << "    <EMPTY a=\"b\"/>\n"
+                << "    < SPACED  x = \"y\" >z</SPACED>\n"
+                << "  </ITEM>\n";
+        }
+
+        out << "</ROOT>\n";
+        return out.toString();
+    }
+
+    static InputStream* createStream (const String& text)
+    {
+        return new MemoryInputStream (text.toRawUTF8(), text.getNumBytesAsUTF8(), true);
+    }
+
+    void runTest()
+    {
+        {
+            beginTest ("Events");
+
+            XmlStreamReader reader (createStream ("<a x=\"1\" y='2'><b/>hi<c>&amp;</c></a>"), true, 4);
+
+            expect (reader.next() == XmlStreamReader::startElement);
+            expect (reader.getTagName() == "a" && reader.getDepth() == 1 && reader.getNumAttributes() == 2);
+            expect (reader.getAttributeName (1) == "y" && reader.getStringAttribute ("x") == "1");
+
+            expect (reader.next() == XmlStreamReader::startElement);
+            expect (reader.getTagName() == "b" && reader.getDepth() == 2);
+            expect (reader.next() == XmlStreamReader::endElement);
+            expect (reader.getTagName() == "b" && reader.getDepth() == 2);
+
+            expect (reader.next() == XmlStreamReader::text);
+            expect (reader.getText() == "hi" && reader.getDepth() == 1);
+
+            expect (reader.next() == XmlStreamReader::startElement);
+            reader.skipElement();
+            expect (reader.getCurrentEvent() == XmlStreamReader::endElement && reader.getTagName() == "c");
+
+            expect (reader.next() == XmlStreamReader::endElement);
+            expect (reader.getTagName() == "a" && reader.getDepth() == 1);
+            expect (reader.next() == XmlStreamReader::endOfDocument);
+            expect (reader.next() == XmlStreamReader::endOfDocument);
+        }
+
+        {
+            beginTest ("Errors");
+
+            const char* const badDocuments[] = { "<a><b></a>", "<a>", "<a x=\"1></a>", "<a><!-- x </a>", "<a b></a>" };
+
+            for (int i = 0; i < numElementsInArray (badDocuments); ++i)
+            {
+                XmlStreamReader reader (createStream (badDocuments[i]), true);
+
+                XmlStreamReader::EventType e;
+                do { e = reader.next(); } while (e != XmlStreamReader::endOfDocument && e != XmlStreamReader::parseError);
+
+                expect (e == XmlStreamReader::parseError, badDocuments[i]);
+                expect (reader.getLastParseError().isNotEmpty());
+            }
+        }
+
+        {
+            beginTest ("Building elements");
+
+            const String document (createTestDocument (50));
+            const ScopedPointer<XmlElement> expected (XmlDocument::parse (document));
+            expect (expected != nullptr);
+
+            const int bufferSizes[] = { 8, 13, 100, 65536 };
+
+            for (int i = 0; i < numElementsInArray (bufferSizes); ++i)
+            {
+                XmlStreamReader reader (createStream (document), true, bufferSizes[i]);
+                expect (reader.next() == XmlStreamReader::startElement);
+
+                const ScopedPointer<XmlElement> result (reader.readElement());
+                expect (result != nullptr && result->isEquivalentTo (expected, false));
+                expect (reader.next() == XmlStreamReader::endOfDocument);
+            }
+        }
+
+        {
+            beginTest ("Benchmark");
+
+            const String document (createTestDocument (20000));
+
+            double start = Time::getMillisecondCounterHiRes();
+            const ScopedPointer<XmlElement> fromDocument (XmlDocument::parse (document));
+            const double documentTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            ScopedPointer<XmlElement> fromStream;
+
+            {
+                XmlStreamReader reader (createStream (document), true);
+
+                if (reader.next() == XmlStreamReader::startElement)
+                    fromStream = reader.readElement();
+            }
+
+            const double streamTreeTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            int numStartElements = 0;
+
+            {
+                XmlStreamReader reader (createStream (document), true);
+
+                for (;;)
+                {
+                    const XmlStreamReader::EventType e = reader.next();
+
+                    if (e == XmlStreamReader::startElement)
+                        ++numStartElements;
+                    else if (e != XmlStreamReader::text && e != XmlStreamReader::endElement)
+                        break;
+                }
+            }
+
+            const double streamEventsTime = Time::getMillisecondCounterHiRes() - start;
+
+            expect (fromStream != nullptr && fromStream->isEquivalentTo (fromDocument, false));
+            expectEquals (numStartElements, 20000 * 3 + 1);
+
+            logMessage ("Parsing " + String ((int) (document.getNumBytesAsUTF8() / 1024)) + " KB: XmlDocument "
+                          + String (documentTime, 1) + " ms, XmlStreamReader::readElement "
+                          + String (streamTreeTime, 1) + " ms, XmlStreamReader events only "
+                          + String (streamEventsTime, 1) + " ms");
+        }
+    }
+};
+
+static XmlStreamReaderTests xmlStreamReaderTests;
+
+#endif
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_XMLSTREAMREADER_JUCEHEADER__
+#define __JUCE_XMLSTREAMREADER_JUCEHEADER__
+
+#include "juce_XmlElement.h"
+#include "../streams/juce_InputStream.h"
+#include "../streams/juce_MemoryOutputStream.h"
+#include "../memory/juce_OptionalScopedPointer.h"
+
+
+//==============================================================================
+/**
+    A streaming "pull" parser for XML, which reads a document from an InputStream
+    one event at a time, without building the whole tree in memory.
+
+    XmlDocument loads the entire document into a String and builds an XmlElement for
+    every node, which is fine for small files but slow and memory-hungry for very large
+    ones. This class reads the stream through a fixed-size buffer and scans the raw
+    UTF-8 bytes, so you can handle elements as they go past, or use readElement() to
+    build trees for just the parts of the document that you need.
+
+    @code
+    XmlStreamReader reader (new FileInputStream (bigFile), true);
+
+    for (;;)
+    {
+        const XmlStreamReader::EventType e = reader.next();
+
+        if (e == XmlStreamReader::startElement && reader.getTagName() == "PRESET")
+        {
+            ScopedPointer<XmlElement> preset (reader.readElement());
+            ...
+        }
+        else if (e == XmlStreamReader::endOfDocument || e == XmlStreamReader::parseError)
+        {
+            break;
+        }
+    }
+    @endcode
+
+    The input is assumed to be UTF-8. The standard entities and numeric character
+    references are expanded, but DTDs are skipped, so any other entities are left
+    unexpanded in the text.
+
+    @see XmlDocument, XmlElement
+*/
+class JUCE_API  XmlStreamReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader for a stream.
+
+        @param sourceStream                 the stream to read from
+        @param deleteSourceWhenDestroyed    whether the stream should be deleted by this object
+        @param bufferSize                   the number of bytes to read from the stream at a time
+    */
+    XmlStreamReader (InputStream* sourceStream,
+                     bool deleteSourceWhenDestroyed,
+                     int bufferSize = 65536);
+
+    /** Destructor. */
+    ~XmlStreamReader();
+
+    //==============================================================================
+    /** The types of event that the reader can produce. */
+    enum EventType
+    {
+        startElement,   /**< An opening tag. Its name and attributes are available from getTagName(), getAttributeName(), etc. */
+        endElement,     /**< A closing tag. An empty tag like \<foo/\> produces a startElement followed by an endElement. */
+        text,           /**< A block of text or a CDATA section, which is available from getText(). */
+        endOfDocument,  /**< The outer element has been closed, or the stream ended cleanly. */
+        parseError      /**< Something went wrong - call getLastParseError() to find out what. */
+    };
+
+    /** Reads the next event from the stream.
+        Once endOfDocument or parseError has been returned, every subsequent call
+        will return the same value.
+    */
+    EventType next();
+
+    /** Returns the last event that next() returned. */
+    EventType getCurrentEvent() const noexcept                  { return currentEvent; }
+
+    /** Returns the depth of the current element: 1 for the outer document element,
+        2 for its children, etc. For a text event, this is the depth of the element
+        that contains it.
+    */
+    int getDepth() const noexcept                               { return currentDepth; }
+
+    //==============================================================================
+    /** For a startElement or endElement event, returns the element's tag name. */
+    const String& getTagName() const noexcept                   { return tagName; }
+
+    /** For a startElement event, returns the number of attributes. */
+    int getNumAttributes() const noexcept                       { return numAttributes; }
+
+    /** For a startElement event, returns the name of one of the attributes. */
+    const String& getAttributeName (int index) const noexcept;
+
+    /** For a startElement event, returns the value of one of the attributes. */
+    const String& getAttributeValue (int index) const noexcept;
+
+    /** For a startElement event, returns the value of a named attribute, or the
+        default value if it isn't there.
+    */
+    String getStringAttribute (const String& attributeName,
+                               const String& defaultReturnValue = String::empty) const;
+
+    /** For a text event, returns the text, with any entities expanded. */
+    const String& getText() const noexcept                      { return textContent; }
+
+    //==============================================================================
+    /** When the current event is a startElement, this reads the whole of that element
+        and returns it as an XmlElement tree.
+
+        Afterwards, the current event will be the matching endElement.
+        @returns a new XmlElement which the caller must delete, or nullptr if the current
+                 event isn't a startElement or there's a parse error
+    */
+    XmlElement* readElement();
+
+    /** When the current event is a startElement, this skips over the rest of that
+        element and its children, leaving the current event as its endElement.
+    */
+    void skipElement();
+
+    //==============================================================================
+    /** Returns a description of the error, if a parseError event has been produced. */
+    const String& getLastParseError() const noexcept            { return lastError; }
+
+    /** Sets whether text blocks which contain only whitespace should be skipped.
+        By default these are ignored, as they are by XmlDocument.
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<InputStream> source;
+    HeapBlock<char> buffer;
+    int bufferSize, bufferPos, bufferEnd;
+    bool sourceExhausted, ignoreEmptyTextElements, emptyElementPending;
+
+    EventType currentEvent;
+    int currentDepth;
+    String tagName, textContent, lastError;
+    StringArray openTags;
+    Array<String> attributeNames, attributeValues;
+    int numAttributes;
+    MemoryOutputStream scratch;
+
+    bool fillBuffer();
+    int peekByte();
+    int readByte();
+    bool skipPast (const char* terminator);
+    void skipWhitespace();
+    bool readName (String& result);
+    bool readAttributeValue (String& result);
+    void readEntity();
+
+    bool readTag();
+    bool readSpecialSection();
+    bool readText();
+    bool setError (const String& message);
+    XmlElement* createElementFromCurrentTag() const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlStreamReader)
+};
+
+
+#endif   // __JUCE_XMLSTREAMREADER_JUCEHEADER__
@@ -115,13 +115,288 @@ private:
     JUCE_DECLARE_NON_COPYABLE (GZIPCompressorHelper)
 };
 
+//==============================================================================
+// Compresses blocks of the data on a pool of threads, the way that pigz does. Each block
+// is compressed as raw deflate data, primed with the previous block's last 32K as its
+// dictionary, and ended with a sync flush so that it finishes on a byte boundary. The
+// blocks can then be concatenated, and wrapped in a header and trailer that are written here.
+class GZIPCompressorOutputStream::ParallelCompressor
+{
+public:
+    ParallelCompressor (const int compressionLevel, const int windowBits, const int numThreads, const int blockSizeBytes)
+        : pool (numThreads),
+          level ((compressionLevel < 1 || compressionLevel > 9) ? 6 : compressionLevel),
+          format (windowBits < 0 ? rawFormat : (windowBits > 15 ? gzipFormat : zlibFormat)),
+          windowSizeBits (jlimit (9, 15, windowBits == 0 ? 15 : (std::abs (windowBits) & 15))),
+          blockSize ((size_t) jmax (4096, blockSizeBytes)),
+          maxBlocksInProgress (numThreads * 2),
+          checksum (format == gzipFormat ? zlibNamespace::crc32 (0, nullptr, 0)
+                                         : zlibNamespace::adler32 (0, nullptr, 0)),
+          totalSize (0),
+          hasWrittenHeader (false),
+          finished (false),
+          failed (false)
+    {
+    }
+
+    ~ParallelCompressor()
+    {
+        // (the pool's threads may still be using these, so they have to be finished first)
+        for (int i = blocksInProgress.size(); --i >= 0;)
+            blocksInProgress.getUnchecked(i)->finished.wait();
+    }
+
+    bool write (const uint8* data, size_t dataSize, OutputStream& out)
+    {
+        // When you call flush() on a gzip stream, the stream is closed, and you can
+        // no longer continue to write data to it!
+        jassert (! finished);
+
+        while (dataSize > 0 && ! failed)
+        {
+            if (currentBlock == nullptr)
+                currentBlock = createBlock();
+
+            const size_t numToCopy = jmin (dataSize, blockSize - currentBlock->inputSize);
+            currentBlock->input.copyFrom (data, (int) (currentBlock->dictionarySize + currentBlock->inputSize), numToCopy);
+            currentBlock->inputSize += numToCopy;
+            data += numToCopy;
+            dataSize -= numToCopy;
+
+            if (currentBlock->inputSize >= blockSize)
+            {
+                startBlock (false);
+                writeFinishedBlocks (out, false);
+            }
+        }
+
+        return ! failed;
+    }
+
+    void finish (OutputStream& out)
+    {
+        if (! finished)
+        {
+            finished = true;
+
+            if (currentBlock == nullptr)
+                currentBlock = createBlock();
+
+            startBlock (true);
+            writeFinishedBlocks (out, true);
+
+            if (! (failed || writeTrailer (out)))
+                failed = true;
+        }
+    }
+
+private:
+    //==============================================================================
+    struct Block
+    {
+        Block (const int level_, const int windowSizeBits_, const bool useCRC_)
+            : dictionarySize (0), inputSize (0), outputSize (0), checksum (0),
+              level (level_), windowSizeBits (windowSizeBits_),
+              useCRC (useCRC_), isLast (false), succeeded (false),
+              finished (true)
+        {
+        }
+
+        static void compress (void* block)
+        {
+            static_cast <Block*> (block)->compress();
+        }
+
+        void compress()
+        {
+            using namespace zlibNamespace;
+
+            Bytef* const data = static_cast <Bytef*> (input.getData()) + dictionarySize;
+            checksum = useCRC ? crc32 (crc32 (0, nullptr, 0), data, (uInt) inputSize)
+                              : adler32 (adler32 (0, nullptr, 0), data, (uInt) inputSize);
+
+            z_stream stream;
+            zerostruct (stream);
+
+            if (deflateInit2 (&stream, level, Z_DEFLATED, -windowSizeBits, 8, Z_DEFAULT_STRATEGY) == Z_OK)
+            {
+                if (dictionarySize > 0)
+                    deflateSetDictionary (&stream, static_cast <const Bytef*> (input.getData()), (uInt) dictionarySize);
+
+                // (a sync flush can add a few bytes more than deflateBound allows for)
+                output.setSize ((size_t) deflateBound (&stream, (uLong) inputSize) + 16);
+
+                stream.next_in   = data;
+                stream.avail_in  = (uInt) inputSize;
+                stream.next_out  = static_cast <Bytef*> (output.getData());
+                stream.avail_out = (uInt) output.getSize();
+
+                for (;;)
+                {
+                    const int result = deflate (&stream, isLast ? Z_FINISH : Z_SYNC_FLUSH);
+
+                    if (result == Z_STREAM_END || (result == Z_OK && stream.avail_out > 0 && ! isLast))
+                    {
+                        succeeded = true;
+                        break;
+                    }
+
+                    if (result != Z_OK)
+                        break;
+
+                    if (stream.avail_out == 0)
+                    {
+                        const size_t oldSize = output.getSize();
+                        output.setSize (oldSize * 2);
+                        stream.next_out  = static_cast <Bytef*> (output.getData()) + oldSize;
+                        stream.avail_out = (uInt) oldSize;
+                    }
+                }
+
+                outputSize = output.getSize() - stream.avail_out;
+                deflateEnd (&stream);
+            }
+
+            finished.signal();
+        }
+
+        MemoryBlock input, output; // (the input holds the dictionary, followed by the data to compress)
+        size_t dictionarySize, inputSize, outputSize;
+        zlibNamespace::uLong checksum;
+        const int level, windowSizeBits;
+        const bool useCRC;
+        bool isLast, succeeded;
+        WaitableEvent finished;
+
+        JUCE_DECLARE_NON_COPYABLE (Block)
+    };
+
+    enum Format { rawFormat, zlibFormat, gzipFormat };
+
+    ThreadPool pool;
+    OwnedArray<Block> blocksInProgress;
+    ScopedPointer<Block> currentBlock;
+    MemoryBlock dictionary;
+    const int level;
+    const Format format;
+    const int windowSizeBits;
+    const size_t blockSize;
+    const int maxBlocksInProgress;
+    zlibNamespace::uLong checksum;
+    int64 totalSize;
+    bool hasWrittenHeader, finished, failed;
+
+    Block* createBlock()
+    {
+        Block* const block = new Block (level, windowSizeBits, format == gzipFormat);
+        block->dictionarySize = dictionary.getSize();
+        block->input.setSize (block->dictionarySize + blockSize);
+        block->input.copyFrom (dictionary.getData(), 0, block->dictionarySize);
+        return block;
+    }
+
+    void startBlock (const bool isLast)
+    {
+        Block* const block = currentBlock.release();
+        block->isLast = isLast;
+        block->finished.reset();
+
+        // the end of this block's data becomes the dictionary for the next one
+        const size_t total = block->dictionarySize + block->inputSize;
+        const size_t dictionarySize = jmin (total, (size_t) 32768, (size_t) 1 << windowSizeBits);
+        dictionary.replaceWith (addBytesToPointer (block->input.getData(), total - dictionarySize), dictionarySize);
+
+        blocksInProgress.add (block);
+        pool.addJob (&Block::compress, block);
+    }
+
+    void writeFinishedBlocks (OutputStream& out, const bool waitForAll)
+    {
+        while (blocksInProgress.size() > 0 && ! failed)
+        {
+            Block* const block = blocksInProgress.getFirst();
+            const bool mustWait = waitForAll || blocksInProgress.size() >= maxBlocksInProgress;
+
+            if (! block->finished.wait (mustWait ? -1 : 0))
+                break;
+
+            if (! (block->succeeded
+                    && writeHeader (out)
+                    && out.write (block->output.getData(), block->outputSize)))
+            {
+                failed = true;
+                break;
+            }
+
+            using namespace zlibNamespace;
+            checksum = format == gzipFormat ? crc32_combine   (checksum, block->checksum, (z_off_t) block->inputSize)
+                                            : adler32_combine (checksum, block->checksum, (z_off_t) block->inputSize);
+            totalSize += (int64) block->inputSize;
+            blocksInProgress.remove (0);
+        }
+    }
+
+    bool writeHeader (OutputStream& out)
+    {
+        if (hasWrittenHeader)
+            return true;
+
+        hasWrittenHeader = true;
+
+        if (format == gzipFormat)
+        {
+            const uint8 header[] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0,
+                                     (uint8) (level == 9 ? 2 : (level == 1 ? 4 : 0)), 0xff };
+
+            return out.write (header, sizeof (header));
+        }
+
+        if (format == zlibFormat)
+        {
+            const int levelFlags = level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3));
+            int header = ((Z_DEFLATED + ((windowSizeBits - 8) << 4)) << 8) | (levelFlags << 6);
+            header += 31 - (header % 31);
+
+            const uint8 headerBytes[] = { (uint8) (header >> 8), (uint8) header };
+            return out.write (headerBytes, sizeof (headerBytes));
+        }
+
+        return true;
+    }
+
+    bool writeTrailer (OutputStream& out)
+    {
+        const uint32 sum = (uint32) checksum, size = (uint32) totalSize;
+
+        if (format == gzipFormat)
+        {
+            const uint8 trailer[] = { (uint8) sum,  (uint8) (sum >> 8),  (uint8) (sum >> 16),  (uint8) (sum >> 24),
+                                      (uint8) size, (uint8) (size >> 8), (uint8) (size >> 16), (uint8) (size >> 24) };
+            return out.write (trailer, sizeof (trailer));
+        }
+
+        if (format == zlibFormat)
+        {
+            const uint8 trailer[] = { (uint8) (sum >> 24), (uint8) (sum >> 16), (uint8) (sum >> 8), (uint8) sum };
+            return out.write (trailer, sizeof (trailer));
+        }
+
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelCompressor)
+};
+
 //==============================================================================
 GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream* const out,
-                                                        const int compressionLevel,
+                                                        const int compressionLevel_,
                                                         const bool deleteDestStream,
-                                                        const int windowBits)
+                                                        const int windowBits_)
     : destStream (out, deleteDestStream),
-      helper (new GZIPCompressorHelper (compressionLevel, windowBits))
+      compressionLevel (compressionLevel_),
+      windowBits (windowBits_),
+      hasWrittenData (false),
+      helper (new GZIPCompressorHelper (compressionLevel_, windowBits_))
 {
     jassert (out != nullptr);
 }
@@ -133,14 +408,37 @@ GZIPCompressorOutputStream::~GZIPCompressorOutputStream()
 
 void GZIPCompressorOutputStream::flush()
 {
-    helper->finish (*destStream);
+    if (parallelCompressor != nullptr)
+        parallelCompressor->finish (*destStream);
+    else
+        helper->finish (*destStream);
+
     destStream->flush();
 }
 
+void GZIPCompressorOutputStream::setNumThreads (const int numThreads, const int blockSizeBytes)
+{
+    // the number of threads can't be changed once some data has been written!
+    jassert (! hasWrittenData);
+
+    if (! hasWrittenData)
+    {
+        if (numThreads > 1)
+            parallelCompressor = new ParallelCompressor (compressionLevel, windowBits, numThreads, blockSizeBytes);
+        else
+            parallelCompressor = nullptr;
+    }
+}
+
 bool GZIPCompressorOutputStream::write (const void* destBuffer, size_t howMany)
 {
     jassert (destBuffer != nullptr && (ssize_t) howMany >= 0);
 
+    hasWrittenData = true;
+
+    if (parallelCompressor != nullptr)
+        return parallelCompressor->write (static_cast <const uint8*> (destBuffer), howMany, *destStream);
+
     return helper->write (static_cast <const uint8*> (destBuffer), howMany, *destStream);
 }
 
@@ -202,6 +500,58 @@ public:
                                 original.getData(),
                                 original.getDataSize()) == 0);
         }
+
+        beginTest ("Multi-threaded");
+
+        const int windowBitsOptions[] = { 0, GZIPCompressorOutputStream::windowBitsGZIP, GZIPCompressorOutputStream::windowBitsRaw };
+
+        for (int i = 0; i < 30; ++i)
+        {
+            const int windowBits = windowBitsOptions [i % 3];
+            const bool multiThreaded = (i % 6) < 3;
+
+            MemoryBlock original ((size_t) rng.nextInt (300000));
+
+            for (size_t j = 0; j < original.getSize(); ++j)
+                original[(int) j] = (char) (rng.nextInt (4) == 0 ? rng.nextInt (256) : "compress me "[j % 12]);
+
+            MemoryOutputStream compressed;
+
+            {
+                GZIPCompressorOutputStream zipper (&compressed, rng.nextInt (10), false, windowBits);
+
+                if (multiThreaded)
+                    zipper.setNumThreads (2 + rng.nextInt (3), 1024 + rng.nextInt (50000));
+
+                for (size_t j = 0; j < original.getSize();)
+                {
+                    const size_t num = jmin ((size_t) rng.nextInt (70000) + 1, original.getSize() - j);
+                    zipper.write (static_cast <const char*> (original.getData()) + j, num);
+                    j += num;
+                }
+            }
+
+            if (windowBits == GZIPCompressorOutputStream::windowBitsGZIP)
+                expect (compressed.getDataSize() > 2
+                         && (uint8) static_cast <const char*> (compressed.getData())[0] == 0x1f
+                         && (uint8) static_cast <const char*> (compressed.getData())[1] == 0x8b);
+
+            // read it back both directly from memory, and through a stream that needs buffering
+            for (int pass = 0; pass < 2; ++pass)
+            {
+                InputStream* source = new MemoryInputStream (compressed.getData(), compressed.getDataSize(), false);
+
+                if (pass == 1)
+                    source = new BufferedInputStream (source, 100, true);
+
+                GZIPDecompressorInputStream unzipper (source, true, windowBits == GZIPCompressorOutputStream::windowBitsRaw,
+                                                      -1, 256 + rng.nextInt (100000));
+                MemoryOutputStream uncompressed;
+                uncompressed << unzipper;
+
+                expect (uncompressed.getMemoryBlock() == original);
+            }
+        }
     }
 };
 
@@ -39,7 +39,10 @@
     the gzip data is closed - this means that no more data can be written to
     it, and any subsequent attempts to call write() will cause an assertion.
 
-    @see GZIPDecompressorInputStream
+    To compress large amounts of data more quickly, you can use setNumThreads() to
+    have it compressed by several threads at once.
+
+    @see GZIPDecompressorInputStream, LZCompressorOutputStream
 */
 class JUCE_API  GZIPCompressorOutputStream  : public OutputStream
 {
@@ -75,6 +78,19 @@ public:
     */
     void flush();
 
+    /** Makes the stream compress its data using several threads at once.
+
+        The incoming data is split into blocks of blockSizeBytes, which are compressed in
+        parallel by a pool of background threads, and the results are joined together in order.
+        The output is still a single standard stream that any zlib or gzip decoder can read,
+        and because each block is compressed using the end of the previous one as its dictionary,
+        it's only very slightly bigger than the output of a single-threaded compressor.
+
+        This has to be called before any data is written to the stream. A value for numThreads
+        of less than 2 leaves the stream compressing everything on the calling thread.
+    */
+    void setNumThreads (int numThreads, int blockSizeBytes = 128 * 1024);
+
     int64 getPosition();
     bool setPosition (int64 newPosition);
     bool write (const void* destBuffer, size_t howMany);
@@ -92,10 +108,17 @@ private:
     //==============================================================================
     OptionalScopedPointer<OutputStream> destStream;
 
+    const int compressionLevel, windowBits;
+    bool hasWrittenData;
+
     class GZIPCompressorHelper;
     friend class ScopedPointer <GZIPCompressorHelper>;
     ScopedPointer <GZIPCompressorHelper> helper;
 
+    class ParallelCompressor;
+    friend class ScopedPointer <ParallelCompressor>;
+    ScopedPointer <ParallelCompressor> parallelCompressor;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GZIPCompressorOutputStream)
 };
 
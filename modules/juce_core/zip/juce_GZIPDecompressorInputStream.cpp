@@ -92,7 +92,8 @@ public:
     {
         using namespace zlibNamespace;
         zerostruct (stream);
-        streamIsValid = (inflateInit2 (&stream, dontWrap ? -MAX_WBITS : MAX_WBITS) == Z_OK);
+        // (adding 32 to the window size makes it accept either a zlib or gzip header)
+        streamIsValid = (inflateInit2 (&stream, dontWrap ? -MAX_WBITS : MAX_WBITS + 32) == Z_OK);
         finished = error = ! streamIsValid;
     }
 
@@ -151,8 +152,6 @@ public:
 
     bool finished, needsDictionary, error, streamIsValid;
 
-    enum { gzipDecompBufferSize = 32768 };
-
 private:
     zlibNamespace::z_stream stream;
     uint8* data;
@@ -165,15 +164,17 @@ private:
 GZIPDecompressorInputStream::GZIPDecompressorInputStream (InputStream* const sourceStream_,
                                                           const bool deleteSourceWhenDestroyed,
                                                           const bool noWrap_,
-                                                          const int64 uncompressedStreamLength_)
+                                                          const int64 uncompressedStreamLength_,
+                                                          const int bufferSizeBytes)
   : sourceStream (sourceStream_, deleteSourceWhenDestroyed),
     uncompressedStreamLength (uncompressedStreamLength_),
     noWrap (noWrap_),
     isEof (false),
     activeBufferSize (0),
+    bufferSize (jmax (256, bufferSizeBytes)),
     originalSourcePos (sourceStream_->getPosition()),
     currentPos (0),
-    buffer ((size_t) GZIPDecompressHelper::gzipDecompBufferSize),
+    memorySource (dynamic_cast <MemoryInputStream*> (sourceStream_)),
     helper (new GZIPDecompressHelper (noWrap_))
 {
 }
@@ -184,9 +185,10 @@ GZIPDecompressorInputStream::GZIPDecompressorInputStream (InputStream& sourceStr
     noWrap (false),
     isEof (false),
     activeBufferSize (0),
+    bufferSize (32768),
     originalSourcePos (sourceStream_.getPosition()),
     currentPos (0),
-    buffer ((size_t) GZIPDecompressHelper::gzipDecompBufferSize),
+    memorySource (dynamic_cast <MemoryInputStream*> (&sourceStream_)),
     helper (new GZIPDecompressHelper (false))
 {
 }
@@ -222,19 +224,10 @@ int GZIPDecompressorInputStream::read (void* destBuffer, int howMany)
                     return numRead;
                 }
 
-                if (helper->needsInput())
+                if (helper->needsInput() && ! readMoreInput())
                 {
-                    activeBufferSize = sourceStream->read (buffer, (int) GZIPDecompressHelper::gzipDecompBufferSize);
-
-                    if (activeBufferSize > 0)
-                    {
-                        helper->setInput (buffer, (size_t) activeBufferSize);
-                    }
-                    else
-                    {
-                        isEof = true;
-                        return numRead;
-                    }
+                    isEof = true;
+                    return numRead;
                 }
             }
             else
@@ -252,6 +245,34 @@ int GZIPDecompressorInputStream::read (void* destBuffer, int howMany)
     return 0;
 }
 
+bool GZIPDecompressorInputStream::readMoreInput()
+{
+    if (memorySource != nullptr)
+    {
+        // when the source is already in memory, zlib can read it from there directly
+        const int64 position = memorySource->getPosition();
+        activeBufferSize = (int) jmin ((int64) 0x40000000, memorySource->getTotalLength() - position);
+
+        if (activeBufferSize <= 0)
+            return false;
+
+        helper->setInput (static_cast <uint8*> (const_cast <void*> (memorySource->getData())) + position, (size_t) activeBufferSize);
+        memorySource->setPosition (position + activeBufferSize);
+        return true;
+    }
+
+    if (buffer == nullptr)
+        buffer.malloc ((size_t) bufferSize);
+
+    activeBufferSize = sourceStream->read (buffer, bufferSize);
+
+    if (activeBufferSize <= 0)
+        return false;
+
+    helper->setInput (buffer, (size_t) activeBufferSize);
+    return true;
+}
+
 bool GZIPDecompressorInputStream::isExhausted()
 {
     return helper->error || isEof;
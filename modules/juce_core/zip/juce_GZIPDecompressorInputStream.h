@@ -35,11 +35,14 @@
 /**
     This stream will decompress a source-stream using zlib.
 
+    It can read data that was written with either a zlib or a gzip header, and works
+    out which one is being used automatically.
+
     Tip: if you're reading lots of small items from one of these streams, you
          can increase the performance enormously by passing it through a
          BufferedInputStream, so that it has to read larger blocks less often.
 
-    @see GZIPCompressorOutputStream
+    @see GZIPCompressorOutputStream, LZDecompressorInputStream
 */
 class JUCE_API  GZIPDecompressorInputStream  : public InputStream
 {
@@ -55,11 +58,16 @@ public:
         @param uncompressedStreamLength     if the creator knows the length that the
                                             uncompressed stream will be, then it can supply this
                                             value, which will be returned by getTotalLength()
+        @param bufferSizeBytes              the size of the buffer to use when reading from the
+                                            source stream. A bigger buffer means fewer reads from
+                                            the source. If the source is a MemoryInputStream, no buffer
+                                            is needed, as its data is decompressed directly.
     */
     GZIPDecompressorInputStream (InputStream* sourceStream,
                                  bool deleteSourceWhenDestroyed,
                                  bool noWrap = false,
-                                 int64 uncompressedStreamLength = -1);
+                                 int64 uncompressedStreamLength = -1,
+                                 int bufferSizeBytes = 32768);
 
     /** Creates a decompressor stream.
 
@@ -86,8 +94,12 @@ private:
     const bool noWrap;
     bool isEof;
     int activeBufferSize;
+    const int bufferSize;
     int64 originalSourcePos, currentPos;
     HeapBlock <uint8> buffer;
+    MemoryInputStream* const memorySource;
+
+    bool readMoreInput();
 
     class GZIPDecompressHelper;
     friend class ScopedPointer <GZIPDecompressHelper>;
@@ -0,0 +1,255 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+LZCompressorOutputStream::LZCompressorOutputStream (OutputStream* const destStream_,
+                                                    const bool deleteDestStreamWhenDestroyed,
+                                                    const int blockSizeBytes)
+  : destStream (destStream_, deleteDestStreamWhenDestroyed),
+    blockSize (jlimit (1024, (int) LZHelpers::largestBlockSize, blockSizeBytes)),
+    pendingData ((size_t) blockSize),
+    compressedData ((size_t) blockSize),
+    hashTable ((size_t) 1 << LZHelpers::hashBits),
+    numPending (0)
+{
+    jassert (destStream_ != nullptr);
+
+    uint8 header [LZHelpers::headerSize];
+    memcpy (header, LZHelpers::streamMagic, 4);
+    const uint32 size = ByteOrder::swapIfBigEndian ((uint32) blockSize);
+    memcpy (header + 4, &size, 4);
+    destStream->write (header, sizeof (header));
+}
+
+LZCompressorOutputStream::~LZCompressorOutputStream()
+{
+    flush();
+
+    const uint32 endMarker = 0;
+    destStream->write (&endMarker, sizeof (endMarker));
+    destStream->flush();
+}
+
+bool LZCompressorOutputStream::writeBlock (const uint8* const data, const int size)
+{
+    // (the compressed data has to be smaller than the original, or it gets stored as it is)
+    const int compressedSize = LZHelpers::compressBlock (data, size, compressedData, size - 1, hashTable);
+
+    uint32 header[2];
+    header[0] = ByteOrder::swapIfBigEndian (compressedSize > 0 ? (uint32) compressedSize
+                                                               : ((uint32) size | LZHelpers::storedBlockFlag));
+    header[1] = ByteOrder::swapIfBigEndian ((uint32) size);
+
+    if (compressedSize > 0)
+        return destStream->write (header, sizeof (header))
+                && destStream->write (compressedData, (size_t) compressedSize);
+
+    return destStream->write (header, sizeof (header))
+            && destStream->write (data, (size_t) size);
+}
+
+bool LZCompressorOutputStream::write (const void* destBuffer, size_t howMany)
+{
+    jassert (destBuffer != nullptr && (ssize_t) howMany >= 0);
+
+    const uint8* source = static_cast <const uint8*> (destBuffer);
+
+    while (howMany > 0)
+    {
+        if (numPending == 0 && howMany >= (size_t) blockSize)
+        {
+            // whole blocks can be compressed straight from the caller's data
+            if (! writeBlock (source, blockSize))
+                return false;
+
+            source += blockSize;
+            howMany -= (size_t) blockSize;
+        }
+        else
+        {
+            const int numToCopy = (int) jmin (howMany, (size_t) (blockSize - numPending));
+            memcpy (pendingData + numPending, source, (size_t) numToCopy);
+            numPending += numToCopy;
+            source += numToCopy;
+            howMany -= (size_t) numToCopy;
+
+            if (numPending == blockSize)
+            {
+                numPending = 0;
+
+                if (! writeBlock (pendingData, blockSize))
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void LZCompressorOutputStream::flush()
+{
+    if (numPending > 0)
+    {
+        writeBlock (pendingData, numPending);
+        numPending = 0;
+    }
+
+    destStream->flush();
+}
+
+int64 LZCompressorOutputStream::getPosition()
+{
+    return destStream->getPosition();
+}
+
+bool LZCompressorOutputStream::setPosition (int64 /*newPosition*/)
+{
+    jassertfalse; // can't do it!
+    return false;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LZCompressorTests  : public UnitTest
+{
+public:
+    LZCompressorTests()   : UnitTest ("LZ compression") {}
+
+    static MemoryBlock compress (const MemoryBlock& data, const int blockSize, const int chunkSize)
+    {
+        MemoryOutputStream compressed;
+
+        {
+            LZCompressorOutputStream lz (&compressed, false, blockSize);
+
+            for (size_t i = 0; i < data.getSize(); i += (size_t) chunkSize)
+                lz.write (static_cast <const char*> (data.getData()) + i, jmin ((size_t) chunkSize, data.getSize() - i));
+        }
+
+        return compressed.getMemoryBlock();
+    }
+
+    static MemoryBlock decompress (const MemoryBlock& compressed)
+    {
+        MemoryInputStream compressedInput (compressed, false);
+        LZDecompressorInputStream lz (compressedInput);
+
+        MemoryOutputStream result;
+        result.writeFromInputStream (lz, -1);
+        return result.getMemoryBlock();
+    }
+
+    void runTest()
+    {
+        beginTest ("Round trips");
+
+        Random rng;
+
+        for (int i = 0; i < 50; ++i)
+        {
+            MemoryBlock data ((size_t) rng.nextInt (i < 25 ? 300 : 200000));
+
+            // a mixture of random bytes and repetitive text, so that there are both
+            // compressible and incompressible sections
+            for (size_t j = 0; j < data.getSize(); ++j)
+                data[(int) j] = (char) (rng.nextInt (8) == 0 ? rng.nextInt (256) : "abcabcdabcde"[j % 12]);
+
+            const MemoryBlock compressed (compress (data, 1024 + rng.nextInt (100000), 1 + rng.nextInt (5000)));
+            expect (decompress (compressed) == data);
+
+            if (data.getSize() > 10000)
+                expect (compressed.getSize() < data.getSize());
+        }
+
+        beginTest ("Incompressible data");
+
+        MemoryBlock noise (100000);
+
+        for (size_t j = 0; j < noise.getSize(); ++j)
+            noise[(int) j] = (char) rng.nextInt (256);
+
+        const MemoryBlock compressedNoise (compress (noise, 16384, 100000));
+        expect (decompress (compressedNoise) == noise);
+        expect (compressedNoise.getSize() < noise.getSize() + 100);
+
+        beginTest ("Seeking");
+
+        {
+            MemoryBlock data (50000);
+
+            for (size_t j = 0; j < data.getSize(); ++j)
+                data[(int) j] = (char) (j / 7);
+
+            const MemoryBlock compressed (compress (data, 4096, 50000));
+            MemoryInputStream compressedInput (compressed, false);
+            LZDecompressorInputStream lz (compressedInput);
+
+            for (int j = 0; j < 20; ++j)
+            {
+                const int pos = rng.nextInt (49000);
+                lz.setPosition (pos);
+
+                char buffer [100];
+                expectEquals (lz.read (buffer, 100), 100);
+                expect (memcmp (buffer, static_cast <const char*> (data.getData()) + pos, 100) == 0);
+            }
+        }
+
+        beginTest ("Corrupt data");
+
+        {
+            MemoryBlock data (20000);
+
+            for (size_t j = 0; j < data.getSize(); ++j)
+                data[(int) j] = (char) (j % 50);
+
+            MemoryBlock compressed (compress (data, 20000, 20000));
+
+            for (int j = 0; j < 200; ++j)
+            {
+                MemoryBlock corrupt (compressed);
+                corrupt[rng.nextInt ((int) corrupt.getSize())] ^= (char) (1 + rng.nextInt (255));
+
+                MemoryInputStream compressedInput (corrupt, false);
+                LZDecompressorInputStream lz (compressedInput);
+                MemoryOutputStream result;
+                result.writeFromInputStream (lz, -1);
+
+                expect (result.getDataSize() <= data.getSize());
+            }
+
+            compressed.setSize (compressed.getSize() / 2);
+            MemoryInputStream compressedInput (compressed, false);
+            LZDecompressorInputStream lz (compressedInput);
+            MemoryOutputStream result;
+            result.writeFromInputStream (lz, -1);
+            expect (lz.hasError());
+        }
+    }
+};
+
+static LZCompressorTests lzCompressorTests;
+
+#endif
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_LZCOMPRESSOROUTPUTSTREAM_JUCEHEADER__
+#define __JUCE_LZCOMPRESSOROUTPUTSTREAM_JUCEHEADER__
+
+#include "../streams/juce_OutputStream.h"
+#include "../memory/juce_OptionalScopedPointer.h"
+#include "../memory/juce_HeapBlock.h"
+
+
+//==============================================================================
+/**
+    A stream which compresses the data written into it using a fast LZ77-style codec.
+
+    This doesn't compress as well as a GZIPCompressorOutputStream, but it's many times
+    faster at both compressing and decompressing, so is a good choice for things like
+    caches and temporary files, where speed matters more than size.
+
+    The data is split into blocks which are compressed independently, and any block that
+    doesn't get smaller is stored as it is. The output can only be read by an
+    LZDecompressorInputStream.
+
+    Unlike a GZIPCompressorOutputStream, calling flush() doesn't close the stream - the end
+    of the data is marked when this object is deleted.
+
+    @see LZDecompressorInputStream, GZIPCompressorOutputStream
+*/
+class JUCE_API  LZCompressorOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates a compression stream.
+
+        @param destStream                       the stream into which the compressed data should
+                                                be written
+        @param deleteDestStreamWhenDestroyed    whether or not to delete the destStream object when
+                                                this stream is destroyed
+        @param blockSizeBytes                   the amount of data to compress in each block. Bigger
+                                                blocks compress slightly better, but need more memory
+                                                to compress and decompress
+    */
+    LZCompressorOutputStream (OutputStream* destStream,
+                              bool deleteDestStreamWhenDestroyed = false,
+                              int blockSizeBytes = 256 * 1024);
+
+    /** Destructor.
+        This writes any pending data and the marker for the end of the stream.
+    */
+    ~LZCompressorOutputStream();
+
+    //==============================================================================
+    /** Compresses and writes any data that's waiting to be written, and flushes the
+        destination stream.
+        More data can be written afterwards, although flushing very often will make
+        the compression less effective.
+    */
+    void flush();
+
+    int64 getPosition();
+    bool setPosition (int64 newPosition);
+    bool write (const void* destBuffer, size_t howMany);
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<OutputStream> destStream;
+    const int blockSize;
+    HeapBlock <uint8> pendingData, compressedData;
+    HeapBlock <int> hashTable;
+    int numPending;
+
+    bool writeBlock (const uint8* data, int size);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LZCompressorOutputStream)
+};
+
+#endif   // __JUCE_LZCOMPRESSOROUTPUTSTREAM_JUCEHEADER__
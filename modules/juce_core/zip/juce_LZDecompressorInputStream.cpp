@@ -0,0 +1,441 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+/*  The format used by LZCompressorOutputStream is a 4-byte "JLZ1" tag and the maximum block
+    size, followed by a series of blocks. Each block starts with a little-endian 32-bit header
+    which holds the number of bytes that follow it, with the top bit set if the block was stored
+    uncompressed, followed by its uncompressed size. A zero header marks the end of the stream.
+
+    The blocks themselves use the same byte-oriented scheme as LZ4: a sequence of tokens, each
+    giving a run of literal bytes and then a match of at least 4 bytes copied from up to 64K back.
+*/
+namespace LZHelpers
+{
+    enum
+    {
+        minMatch = 4,
+        lastLiterals = 5,           // the last bytes of a block are always literals..
+        matchFindLimit = 12,        // ..and no match may start closer to the end than this
+        maxOffset = 65535,
+        hashBits = 14,
+        headerSize = 8,
+        largestBlockSize = 64 * 1024 * 1024
+    };
+
+    static const uint32 storedBlockFlag = 0x80000000;
+    static const char* const streamMagic = "JLZ1";
+
+    static inline uint32 read32 (const uint8* const p) noexcept
+    {
+        uint32 v;
+        memcpy (&v, p, sizeof (v));
+        return v;
+    }
+
+    static inline int hash (const uint32 sequence) noexcept
+    {
+        return (int) ((sequence * 2654435761u) >> (32 - hashBits));
+    }
+
+    static inline uint8* writeLength (uint8* dest, int length) noexcept
+    {
+        for (; length >= 255; length -= 255)
+            *dest++ = 255;
+
+        *dest++ = (uint8) length;
+        return dest;
+    }
+
+    static uint8* writeSequence (uint8* dest, const uint8* const literals, const int numLiterals,
+                                 const int offset, const int matchLength) noexcept
+    {
+        uint8* const token = dest++;
+
+        if (numLiterals >= 15)
+        {
+            *token = 15 << 4;
+            dest = writeLength (dest, numLiterals - 15);
+        }
+        else
+        {
+            *token = (uint8) (numLiterals << 4);
+        }
+
+        memcpy (dest, literals, (size_t) numLiterals);
+        dest += numLiterals;
+
+        if (matchLength > 0)
+        {
+            *dest++ = (uint8) offset;
+            *dest++ = (uint8) (offset >> 8);
+
+            const int extraLength = matchLength - minMatch;
+
+            if (extraLength >= 15)
+            {
+                *token |= 15;
+                dest = writeLength (dest, extraLength - 15);
+            }
+            else
+            {
+                *token |= (uint8) extraLength;
+            }
+        }
+
+        return dest;
+    }
+
+    static inline int getMaxSequenceSize (const int numLiterals, const int matchLength) noexcept
+    {
+        return 1 + numLiterals + numLiterals / 255 + 1 + 2 + matchLength / 255 + 1;
+    }
+
+    /*  Compresses a block, returning the compressed size, or 0 if the result wouldn't fit
+        into destSize bytes. The hash table must have (1 << hashBits) elements.
+    */
+    static int compressBlock (const uint8* const source, const int sourceSize,
+                              uint8* const dest, const int destSize, int* const hashTable) noexcept
+    {
+        uint8* d = dest;
+        uint8* const destEnd = dest + destSize;
+        int anchor = 0;
+
+        if (sourceSize > matchFindLimit)
+        {
+            zeromem (hashTable, sizeof (int) << hashBits);
+
+            const int searchLimit = sourceSize - matchFindLimit;
+            const int matchLimit = sourceSize - lastLiterals;
+            int pos = 1;
+            hashTable [hash (read32 (source))] = 0;
+
+            for (;;)
+            {
+                // look for the next match, skipping ahead faster the longer it's been since the last one
+                int match = 0, attempts = 1 << 6;
+
+                for (;;)
+                {
+                    if (pos > searchLimit)
+                        goto writeLastLiterals;
+
+                    const uint32 sequence = read32 (source + pos);
+                    const int h = hash (sequence);
+                    match = hashTable[h];
+                    hashTable[h] = pos;
+
+                    if (pos - match <= maxOffset && read32 (source + match) == sequence)
+                        break;
+
+                    pos += (attempts++ >> 6);
+                }
+
+                while (pos > anchor && match > 0 && source[pos - 1] == source[match - 1])
+                {
+                    --pos;
+                    --match;
+                }
+
+                int length = minMatch;
+
+                while (pos + length < matchLimit && source[pos + length] == source[match + length])
+                    ++length;
+
+                if (d + getMaxSequenceSize (pos - anchor, length) > destEnd)
+                    return 0;
+
+                d = writeSequence (d, source + anchor, pos - anchor, pos - match, length);
+                pos += length;
+                anchor = pos;
+
+                if (pos > searchLimit)
+                    break;
+
+                hashTable [hash (read32 (source + pos - 2))] = pos - 2;
+            }
+        }
+
+    writeLastLiterals:
+        if (d + getMaxSequenceSize (sourceSize - anchor, 0) > destEnd)
+            return 0;
+
+        d = writeSequence (d, source + anchor, sourceSize - anchor, 0, 0);
+        return (int) (d - dest);
+    }
+
+    static inline bool readLength (const uint8*& source, const uint8* const sourceEnd, int& length) noexcept
+    {
+        for (;;)
+        {
+            if (source >= sourceEnd || length > largestBlockSize)
+                return false;
+
+            const int b = *source++;
+            length += b;
+
+            if (b != 255)
+                return true;
+        }
+    }
+
+    /*  Decompresses a block, returning the number of bytes produced, or -1 if the data is
+        corrupt or would overrun the destination.
+    */
+    static int decompressBlock (const uint8* source, const int sourceSize,
+                                uint8* const dest, const int destSize) noexcept
+    {
+        const uint8* const sourceEnd = source + sourceSize;
+        uint8* d = dest;
+        uint8* const destEnd = dest + destSize;
+
+        for (;;)
+        {
+            if (source >= sourceEnd)
+                return -1;
+
+            const int token = *source++;
+            int numLiterals = token >> 4;
+
+            if (numLiterals == 15 && ! readLength (source, sourceEnd, numLiterals))
+                return -1;
+
+            if (numLiterals > sourceEnd - source || numLiterals > destEnd - d)
+                return -1;
+
+            memcpy (d, source, (size_t) numLiterals);
+            d += numLiterals;
+            source += numLiterals;
+
+            if (source == sourceEnd)
+                return (int) (d - dest);
+
+            if (sourceEnd - source < 2)
+                return -1;
+
+            const int offset = source[0] | (source[1] << 8);
+            source += 2;
+
+            if (offset == 0 || offset > d - dest)
+                return -1;
+
+            int length = token & 15;
+
+            if (length == 15 && ! readLength (source, sourceEnd, length))
+                return -1;
+
+            length += minMatch;
+
+            if (length > destEnd - d)
+                return -1;
+
+            const uint8* match = d - offset;
+
+            if (offset >= length)
+            {
+                memcpy (d, match, (size_t) length);
+                d += length;
+            }
+            else
+            {
+                // overlapping matches repeat the bytes that are being written
+                for (uint8* const end = d + length; d < end;)
+                    *d++ = *match++;
+            }
+        }
+    }
+}
+
+//==============================================================================
+LZDecompressorInputStream::LZDecompressorInputStream (InputStream* const sourceStream_,
+                                                      const bool deleteSourceWhenDestroyed,
+                                                      const int64 uncompressedStreamLength_)
+  : sourceStream (sourceStream_, deleteSourceWhenDestroyed),
+    uncompressedStreamLength (uncompressedStreamLength_),
+    originalSourcePos (sourceStream_->getPosition()),
+    currentPos (0), maxBlockSize (0), blockSize (0), blockPosition (0),
+    headerRead (false), isEof (false), error (false)
+{
+}
+
+LZDecompressorInputStream::LZDecompressorInputStream (InputStream& sourceStream_)
+  : sourceStream (&sourceStream_, false),
+    uncompressedStreamLength (-1),
+    originalSourcePos (sourceStream_.getPosition()),
+    currentPos (0), maxBlockSize (0), blockSize (0), blockPosition (0),
+    headerRead (false), isEof (false), error (false)
+{
+}
+
+LZDecompressorInputStream::~LZDecompressorInputStream()
+{
+}
+
+int64 LZDecompressorInputStream::getTotalLength()
+{
+    return uncompressedStreamLength;
+}
+
+bool LZDecompressorInputStream::readNextBlock()
+{
+    using namespace LZHelpers;
+
+    uint8 header [headerSize];
+
+    if (! headerRead)
+    {
+        if (sourceStream->read (header, headerSize) != headerSize
+             || memcmp (header, streamMagic, 4) != 0)
+        {
+            error = true;
+            return false;
+        }
+
+        maxBlockSize = (int) ByteOrder::littleEndianInt (header + 4);
+
+        if (maxBlockSize <= 0 || maxBlockSize > largestBlockSize)
+        {
+            error = true;
+            return false;
+        }
+
+        compressedData.malloc ((size_t) maxBlockSize);
+        blockData.malloc ((size_t) maxBlockSize);
+        headerRead = true;
+    }
+
+    const int numRead = sourceStream->read (header, headerSize);
+
+    if (numRead >= 4 && ByteOrder::littleEndianInt (header) == 0)
+        return false;  // end of stream
+
+    if (numRead != headerSize)
+    {
+        error = true;
+        return false;
+    }
+
+    const uint32 blockHeader = ByteOrder::littleEndianInt (header);
+    const int dataSize = (int) (blockHeader & ~storedBlockFlag);
+    const int originalSize = (int) ByteOrder::littleEndianInt (header + 4);
+
+    if (dataSize > maxBlockSize || originalSize <= 0 || originalSize > maxBlockSize)
+    {
+        error = true;
+        return false;
+    }
+
+    if ((blockHeader & storedBlockFlag) != 0)
+    {
+        if (dataSize != originalSize || sourceStream->read (blockData, dataSize) != dataSize)
+        {
+            error = true;
+            return false;
+        }
+    }
+    else
+    {
+        if (sourceStream->read (compressedData, dataSize) != dataSize
+             || decompressBlock (compressedData, dataSize, blockData, originalSize) != originalSize)
+        {
+            error = true;
+            return false;
+        }
+    }
+
+    blockSize = originalSize;
+    blockPosition = 0;
+    return true;
+}
+
+int LZDecompressorInputStream::read (void* destBuffer, int howMany)
+{
+    jassert (destBuffer != nullptr && howMany >= 0);
+
+    int numRead = 0;
+    uint8* d = static_cast <uint8*> (destBuffer);
+
+    while (howMany > 0 && ! isEof)
+    {
+        if (blockPosition >= blockSize && ! readNextBlock())
+        {
+            isEof = true;
+            break;
+        }
+
+        const int numToCopy = jmin (howMany, blockSize - blockPosition);
+        memcpy (d, blockData + blockPosition, (size_t) numToCopy);
+        blockPosition += numToCopy;
+        currentPos += numToCopy;
+        numRead += numToCopy;
+        howMany -= numToCopy;
+        d += numToCopy;
+    }
+
+    return numRead;
+}
+
+bool LZDecompressorInputStream::isExhausted()
+{
+    return isEof;
+}
+
+int64 LZDecompressorInputStream::getPosition()
+{
+    return currentPos;
+}
+
+void LZDecompressorInputStream::reset()
+{
+    isEof = false;
+    error = false;
+    headerRead = false;
+    currentPos = 0;
+    blockSize = 0;
+    blockPosition = 0;
+}
+
+bool LZDecompressorInputStream::setPosition (int64 newPos)
+{
+    if (newPos < currentPos)
+    {
+        const int64 offsetInBlock = blockPosition - (currentPos - newPos);
+
+        if (offsetInBlock >= 0)
+        {
+            // the position is still inside the current block, so no need to decompress it again..
+            blockPosition = (int) offsetInBlock;
+            currentPos = newPos;
+            isEof = false;
+            return true;
+        }
+
+        // to go backwards any further, reset the stream and start again..
+        reset();
+        sourceStream->setPosition (originalSourcePos);
+    }
+
+    skipNextBytes (newPos - currentPos);
+    return true;
+}
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_LZDECOMPRESSORINPUTSTREAM_JUCEHEADER__
+#define __JUCE_LZDECOMPRESSORINPUTSTREAM_JUCEHEADER__
+
+#include "../streams/juce_InputStream.h"
+#include "../memory/juce_OptionalScopedPointer.h"
+#include "../memory/juce_HeapBlock.h"
+
+
+//==============================================================================
+/**
+    This stream will decompress data that was written by an LZCompressorOutputStream.
+
+    @see LZCompressorOutputStream, GZIPDecompressorInputStream
+*/
+class JUCE_API  LZDecompressorInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a decompressor stream.
+
+        @param sourceStream                 the stream to read from
+        @param deleteSourceWhenDestroyed    whether or not to delete the source stream
+                                            when this object is destroyed
+        @param uncompressedStreamLength     if the creator knows the length that the
+                                            uncompressed stream will be, then it can supply this
+                                            value, which will be returned by getTotalLength()
+    */
+    LZDecompressorInputStream (InputStream* sourceStream,
+                               bool deleteSourceWhenDestroyed,
+                               int64 uncompressedStreamLength = -1);
+
+    /** Creates a decompressor stream.
+
+        @param sourceStream     the stream to read from - the source stream must not be
+                                deleted until this object has been destroyed
+    */
+    LZDecompressorInputStream (InputStream& sourceStream);
+
+    /** Destructor. */
+    ~LZDecompressorInputStream();
+
+    //==============================================================================
+    /** Returns true if the data couldn't be decoded because it was corrupted or wasn't
+        written by an LZCompressorOutputStream.
+    */
+    bool hasError() const noexcept          { return error; }
+
+    //==============================================================================
+    int64 getPosition();
+    bool setPosition (int64 pos);
+    int64 getTotalLength();
+    bool isExhausted();
+    int read (void* destBuffer, int maxBytesToRead);
+
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<InputStream> sourceStream;
+    const int64 uncompressedStreamLength;
+    int64 originalSourcePos, currentPos;
+    HeapBlock <uint8> compressedData, blockData;
+    int maxBlockSize, blockSize, blockPosition;
+    bool headerRead, isEof, error;
+
+    bool readNextBlock();
+    void reset();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LZDecompressorInputStream)
+};
+
+#endif   // __JUCE_LZDECOMPRESSORINPUTSTREAM_JUCEHEADER__
@@ -105,6 +105,20 @@ namespace
 
         return 0;
     }
+
+    File getTargetFileForEntry (const String& filename, const File& targetDirectory)
+    {
+       #if JUCE_WINDOWS
+        return targetDirectory.getChildFile (filename);
+       #else
+        return targetDirectory.getChildFile (filename.replaceCharacter ('\\', '/'));
+       #endif
+    }
+
+    bool isDirectoryEntry (const String& filename)
+    {
+        return filename.endsWithChar ('/') || filename.endsWithChar ('\\');
+    }
 }
 
 //==============================================================================
@@ -226,10 +240,20 @@ ZipFile::ZipFile (InputStream& stream)
     init();
 }
 
-ZipFile::ZipFile (const File& file)
-    : inputStream (nullptr),
-      inputSource (new FileInputSource (file))
+ZipFile::ZipFile (const File& file, const bool useMemoryMapping)
+    : inputStream (nullptr)
 {
+    if (useMemoryMapping)
+    {
+        mappedFile = new MemoryMappedFile (file, MemoryMappedFile::readOnly);
+
+        if (mappedFile->getData() == nullptr)
+            mappedFile = nullptr;
+    }
+
+    if (mappedFile == nullptr)
+        inputSource = new FileInputSource (file);
+
     init();
 }
 
@@ -273,11 +297,8 @@ const ZipFile::ZipEntry* ZipFile::getEntry (const int index) const noexcept
 
 int ZipFile::getIndexOfFileName (const String& fileName) const noexcept
 {
-    for (int i = 0; i < entries.size(); ++i)
-        if (entries.getUnchecked (i)->entry.filename == fileName)
-            return i;
-
-    return -1;
+    // (the index holds each position plus one, so that a missing name gives -1)
+    return entryIndex [fileName] - 1;
 }
 
 const ZipFile::ZipEntry* ZipFile::getEntry (const String& fileName) const noexcept
@@ -291,9 +312,12 @@ InputStream* ZipFile::createStreamForEntry (const int index)
 
     if (ZipEntryHolder* const zei = entries[index])
     {
-        stream = new ZipInputStream (*this, *zei);
+        if (mappedFile != nullptr)
+            stream = createMappedStreamForEntry (*zei);
+        else
+            stream = new ZipInputStream (*this, *zei);
 
-        if (zei->compressed)
+        if (zei->compressed && stream != nullptr)
         {
             stream = new GZIPDecompressorInputStream (stream, true, true,
                                                       zei->entry.uncompressedSize);
@@ -308,6 +332,11 @@ InputStream* ZipFile::createStreamForEntry (const int index)
 
 InputStream* ZipFile::createStreamForEntry (const ZipEntry& entry)
 {
+    const int index = getIndexOfFileName (entry.filename);
+
+    if (index >= 0 && &entries.getUnchecked (index)->entry == &entry)
+        return createStreamForEntry (index);
+
     for (int i = 0; i < entries.size(); ++i)
         if (&entries.getUnchecked (i)->entry == &entry)
             return createStreamForEntry (i);
@@ -319,6 +348,25 @@ void ZipFile::sortEntriesByFilename()
 {
     ZipEntryHolder::FileNameComparator sorter;
     entries.sort (sorter);
+    buildEntryIndex();
+}
+
+InputStream* ZipFile::createMappedStreamForEntry (const ZipEntryHolder& zei) const
+{
+    const char* const data = static_cast <const char*> (mappedFile->getData());
+    const size_t size = mappedFile->getSize();
+
+    if (zei.streamOffset + 30 > size
+         || ByteOrder::littleEndianInt (data + zei.streamOffset) != 0x04034b50)
+        return nullptr;
+
+    const size_t start = zei.streamOffset + 30 + ByteOrder::littleEndianShort (data + zei.streamOffset + 26)
+                                               + ByteOrder::littleEndianShort (data + zei.streamOffset + 28);
+
+    if (start + zei.compressedSize > size)
+        return nullptr;
+
+    return new MemoryInputStream (data + start, zei.compressedSize, false);
 }
 
 //==============================================================================
@@ -327,7 +375,12 @@ void ZipFile::init()
     ScopedPointer <InputStream> toDelete;
     InputStream* in = inputStream;
 
-    if (inputSource != nullptr)
+    if (mappedFile != nullptr)
+    {
+        in = new MemoryInputStream (mappedFile->getData(), mappedFile->getSize(), false);
+        toDelete = in;
+    }
+    else if (inputSource != nullptr)
     {
         in = inputSource->createInputStream();
         toDelete = in;
@@ -370,11 +423,142 @@ void ZipFile::init()
             }
         }
     }
+
+    buildEntryIndex();
+}
+
+void ZipFile::buildEntryIndex()
+{
+    entryIndex.clear();
+    entryIndex.remapTable (entries.size() * 2);
+
+    // (going backwards means that if a name appears more than once, the first one is kept)
+    for (int i = entries.size(); --i >= 0;)
+        entryIndex.set (entries.getUnchecked (i)->entry.filename, i + 1);
 }
 
+//==============================================================================
+class ZipFile::ParallelExtractor
+{
+public:
+    ParallelExtractor (ZipFile& zip_, const File& targetDirectory_, const bool shouldOverwriteFiles_)
+        : zip (zip_), targetDirectory (targetDirectory_), shouldOverwriteFiles (shouldOverwriteFiles_)
+    {
+    }
+
+    Result run (const int numThreads)
+    {
+        // The folders are all created before starting, so that the threads don't race each other
+        // to create the same ones. And if a name appears more than once, only the entry which would
+        // have been left on disk by extracting them in order is used, so no file is written twice.
+        FlatHashMap <String, int> filesToExtract (zip.entries.size() * 2);
+
+        for (int i = 0; i < zip.entries.size(); ++i)
+        {
+            const String& filename = zip.entries.getUnchecked (i)->entry.filename;
+
+            if (isDirectoryEntry (filename))
+            {
+                const Result result (zip.uncompressEntry (i, targetDirectory, shouldOverwriteFiles));
+
+                if (result.failed())
+                    return result;
+            }
+            else if (shouldOverwriteFiles || ! filesToExtract.contains (filename))
+            {
+                filesToExtract.set (filename, i);
+            }
+        }
+
+        for (FlatHashMap <String, int>::Iterator i (filesToExtract); i.next();)
+        {
+            const File folder (getTargetFileForEntry (i.getKey(), targetDirectory).getParentDirectory());
+
+            if (! folder.createDirectory())
+                return Result::fail ("Failed to create target folder: " + folder.getFullPathName());
+
+            jobs.add (new Job (*this, i.getValue()));
+        }
+
+        if (jobs.size() > 0)
+        {
+            numJobsRemaining = jobs.size();
+
+            ThreadPool pool (numThreads);
+
+            for (int i = 0; i < jobs.size(); ++i)
+                pool.addJob (&Job::extract, jobs.getUnchecked (i));
+
+            allJobsFinished.wait();
+        }
+
+        // report the failure of the earliest entry, as extracting them in order would have done
+        const Job* firstFailure = nullptr;
+
+        for (int i = 0; i < jobs.size(); ++i)
+        {
+            const Job* const job = jobs.getUnchecked (i);
+
+            if (job->result.failed() && (firstFailure == nullptr || job->index < firstFailure->index))
+                firstFailure = job;
+        }
+
+        return firstFailure != nullptr ? firstFailure->result : Result::ok();
+    }
+
+private:
+    struct Job
+    {
+        Job (ParallelExtractor& owner_, const int index_)
+            : owner (owner_), index (index_), result (Result::ok())
+        {
+        }
+
+        static void extract (void* userData)
+        {
+            Job& job = *static_cast <Job*> (userData);
+            ParallelExtractor& owner = job.owner;
+
+            // once something has gone wrong, the remaining entries are skipped
+            if (owner.hasFailed.get() == 0)
+            {
+                job.result = owner.zip.uncompressEntry (job.index, owner.targetDirectory, owner.shouldOverwriteFiles);
+
+                if (job.result.failed())
+                    owner.hasFailed = 1;
+            }
+
+            if (--owner.numJobsRemaining == 0)
+                owner.allJobsFinished.signal();
+        }
+
+        ParallelExtractor& owner;
+        const int index;
+        Result result;
+
+        JUCE_DECLARE_NON_COPYABLE (Job)
+    };
+
+    ZipFile& zip;
+    const File targetDirectory;
+    const bool shouldOverwriteFiles;
+    OwnedArray <Job> jobs;
+    Atomic<int> numJobsRemaining, hasFailed;
+    WaitableEvent allJobsFinished;
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelExtractor)
+};
+
 Result ZipFile::uncompressTo (const File& targetDirectory,
-                              const bool shouldOverwriteFiles)
+                              const bool shouldOverwriteFiles,
+                              const int numThreads)
 {
+    if (numThreads > 1 && entries.size() > 1)
+    {
+        ParallelExtractor extractor (*this, targetDirectory, shouldOverwriteFiles);
+        return extractor.run (numThreads);
+    }
+
     for (int i = 0; i < entries.size(); ++i)
     {
         Result result (uncompressEntry (i, targetDirectory, shouldOverwriteFiles));
@@ -391,15 +575,9 @@ Result ZipFile::uncompressEntry (const int index,
 {
     const ZipEntryHolder* zei = entries.getUnchecked (index);
 
-   #if JUCE_WINDOWS
-    const String entryPath (zei->entry.filename);
-   #else
-    const String entryPath (zei->entry.filename.replaceCharacter ('\\', '/'));
-   #endif
+    const File targetFile (getTargetFileForEntry (zei->entry.filename, targetDirectory));
 
-    const File targetFile (targetDirectory.getChildFile (entryPath));
-
-    if (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\'))
+    if (isDirectoryEntry (zei->entry.filename))
         return targetFile.createDirectory(); // (entry is a directory, not a file)
 
     ScopedPointer<InputStream> in (createStreamForEntry (index));
@@ -592,3 +770,86 @@ bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progre
 
     return true;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ZipFileTests  : public UnitTest
+{
+public:
+    ZipFileTests()   : UnitTest ("ZipFile") {}
+
+    void runTest()
+    {
+        beginTest ("Reading");
+
+        const File folder (File::createTempFile ("zipfiletest"));
+        folder.createDirectory();
+
+        Random rng;
+        ZipFile::Builder builder;
+        StringArray names;
+
+        for (int i = 0; i < 40; ++i)
+        {
+            const File source (folder.getChildFile ("source" + String (i)));
+            String content;
+
+            for (int j = rng.nextInt (5000); --j >= 0;)
+                content << (rng.nextBool() ? "abc" : String (rng.nextInt()));
+
+            source.replaceWithText (content);
+
+            const String name ("dir" + String (i % 4) + "/file" + String (i) + ".txt");
+            builder.addFile (source, i % 2 == 0 ? 0 : 9, name);
+            names.add (name);
+        }
+
+        const File zip (folder.getChildFile ("test.zip"));
+
+        {
+            FileOutputStream out (zip);
+            expect (builder.writeToStream (out, nullptr));
+        }
+
+        for (int mapped = 0; mapped < 2; ++mapped)
+        {
+            ZipFile zipFile (zip, mapped != 0);
+            expectEquals (zipFile.getNumEntries(), names.size());
+            expectEquals (zipFile.getIndexOfFileName ("nonexistent"), -1);
+
+            for (int i = 0; i < names.size(); ++i)
+            {
+                expectEquals (zipFile.getIndexOfFileName (names[i]), i);
+
+                ScopedPointer<InputStream> stream (zipFile.createStreamForEntry (*zipFile.getEntry (names[i])));
+                expect (stream != nullptr);
+
+                if (stream != nullptr)
+                    expect (stream->readEntireStreamAsString() == folder.getChildFile ("source" + String (i)).loadFileAsString());
+            }
+
+            zipFile.sortEntriesByFilename();
+            expect (zipFile.getEntry (zipFile.getIndexOfFileName (names[7]))->filename == names[7]);
+        }
+
+        beginTest ("Extracting");
+
+        for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+        {
+            const File target (folder.getChildFile ("extracted" + String (numThreads)));
+            ZipFile zipFile (zip, true);
+            expect (zipFile.uncompressTo (target, true, numThreads).wasOk());
+
+            for (int i = 0; i < names.size(); ++i)
+                expect (target.getChildFile (names[i]).loadFileAsString()
+                          == folder.getChildFile ("source" + String (i)).loadFileAsString());
+        }
+
+        folder.deleteRecursively();
+    }
+};
+
+static ZipFileTests zipFileTests;
+
+#endif
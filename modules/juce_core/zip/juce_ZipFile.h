@@ -27,9 +27,11 @@
 #define __JUCE_ZIPFILE_JUCEHEADER__
 
 #include "../files/juce_File.h"
+#include "../files/juce_MemoryMappedFile.h"
 #include "../streams/juce_InputSource.h"
 #include "../threads/juce_CriticalSection.h"
 #include "../containers/juce_OwnedArray.h"
+#include "../containers/juce_FlatHashMap.h"
 
 
 //==============================================================================
@@ -42,8 +44,15 @@
 class JUCE_API  ZipFile
 {
 public:
-    /** Creates a ZipFile based for a file. */
-    explicit ZipFile (const File& file);
+    /** Creates a ZipFile based for a file.
+
+        If useMemoryMapping is true, the whole file is mapped into memory with a
+        MemoryMappedFile, and the entries are read directly from the mapped data. That avoids
+        having to open and seek the file for every entry, and lets any number of entries be read
+        at the same time by different threads without blocking each other, so it's the best
+        choice for big archives. If the file can't be mapped, it's read in the normal way.
+    */
+    explicit ZipFile (const File& file, bool useMemoryMapping = false);
 
     //==============================================================================
     /** Creates a ZipFile for a given stream.
@@ -103,7 +112,8 @@ public:
     /** Returns the index of the first entry with a given filename.
 
         This uses a case-sensitive comparison to look for a filename in the
-        list of entries. It might return -1 if no match is found.
+        list of entries. It might return -1 if no match is found. The names are
+        kept in a hash table, so this is quick even when there are lots of entries.
 
         @see ZipFile::ZipEntry
     */
@@ -149,12 +159,19 @@ public:
         This will expand all the entries into a target directory. The relative
         paths of the entries are used.
 
+        If numThreads is more than 1, the entries are extracted by a pool of that many threads
+        at once. This works best with a ZipFile that uses memory-mapping or was created from a
+        File, because those can read several entries simultaneously, whereas entries that come
+        from a shared InputStream have to take turns to read it.
+
         @param targetDirectory      the root folder to uncompress to
         @param shouldOverwriteFiles whether to overwrite existing files with similarly-named ones
+        @param numThreads           the number of threads to use for the extraction
         @returns success if the file is successfully unzipped
     */
     Result uncompressTo (const File& targetDirectory,
-                         bool shouldOverwriteFiles = true);
+                         bool shouldOverwriteFiles = true,
+                         int numThreads = 1);
 
     /** Uncompresses one of the entries from the zip file.
 
@@ -220,25 +237,30 @@ private:
     friend class ZipInputStream;
     friend class ZipEntryHolder;
 
+    class ParallelExtractor;
+
     OwnedArray <ZipEntryHolder> entries;
+    FlatHashMap <String, int> entryIndex;
     CriticalSection lock;
     InputStream* inputStream;
     ScopedPointer <InputStream> streamToDelete;
     ScopedPointer <InputSource> inputSource;
+    ScopedPointer <MemoryMappedFile> mappedFile;
 
    #if JUCE_DEBUG
     struct OpenStreamCounter
     {
-        OpenStreamCounter() : numOpenStreams (0) {}
         ~OpenStreamCounter();
 
-        int numOpenStreams;
+        Atomic<int> numOpenStreams;
     };
 
     OpenStreamCounter streamCounter;
    #endif
 
     void init();
+    void buildEntryIndex();
+    InputStream* createMappedStreamForEntry (const ZipEntryHolder&) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZipFile)
 };
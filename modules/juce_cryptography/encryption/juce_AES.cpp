@@ -0,0 +1,832 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace AESHelpers
+{
+    static inline uint8 rotateByte (const uint8 x, const int shift) noexcept   { return (uint8) ((x << shift) | (x >> (8 - shift))); }
+    static inline uint32 rotateRight (const uint32 x, const int shift) noexcept { return (x >> shift) | (x << (32 - shift)); }
+
+    static inline void writeBigEndianInt (uint8* const dest, const uint32 value) noexcept
+    {
+        dest[0] = (uint8) (value >> 24);
+        dest[1] = (uint8) (value >> 16);
+        dest[2] = (uint8) (value >> 8);
+        dest[3] = (uint8) value;
+    }
+
+    struct Tables
+    {
+        Tables() noexcept
+        {
+            // The S-box is built by stepping through the field elements with the generator 3,
+            // keeping a second element which steps through their inverses at the same time.
+            uint8 p = 1, q = 1;
+
+            do
+            {
+                p = (uint8) (p ^ (p << 1) ^ ((p & 0x80) != 0 ? 0x1b : 0));
+
+                q ^= (uint8) (q << 1);
+                q ^= (uint8) (q << 2);
+                q ^= (uint8) (q << 4);
+
+                if ((q & 0x80) != 0)
+                    q ^= 0x09;
+
+                sbox[p] = (uint8) (q ^ rotateByte (q, 1) ^ rotateByte (q, 2) ^ rotateByte (q, 3) ^ rotateByte (q, 4) ^ 0x63);
+            }
+            while (p != 1);
+
+            sbox[0] = 0x63;
+
+            // each entry combines SubBytes and MixColumns for one byte of a column
+            for (int i = 0; i < 256; ++i)
+            {
+                const uint32 s = sbox[i];
+                const uint32 s2 = ((s << 1) ^ ((s & 0x80) != 0 ? 0x1b : 0)) & 0xff;
+                encryptTable[i] = (s2 << 24) | (s << 16) | (s << 8) | (s2 ^ s);
+            }
+        }
+
+        uint8 sbox [256];
+        uint32 encryptTable [256];
+    };
+
+    static const Tables& getTables() noexcept
+    {
+        static const Tables tables;
+        return tables;
+    }
+
+
+    //==============================================================================
+    // Expands a key into the round keys (as big-endian words), returning the number of rounds
+    static int expandKey (uint8* const roundKeys, const void* const keyData, const int keyBytes) noexcept
+    {
+        // AES keys must be 16, 24 or 32 bytes long!
+        jassert (keyBytes == 16 || keyBytes == 24 || keyBytes == 32);
+
+        const int keyWords = keyBytes <= 16 ? 4 : (keyBytes <= 24 ? 6 : 8);
+        const int numRounds = keyWords + 6;
+
+        zeromem (roundKeys, 240);
+        memcpy (roundKeys, keyData, (size_t) jlimit (0, 32, keyBytes));
+
+        const uint8* const sbox = getTables().sbox;
+        uint32 roundConstant = 1;
+
+        for (int i = keyWords; i < 4 * (numRounds + 1); ++i)
+        {
+            uint32 temp = ByteOrder::bigEndianInt (roundKeys + (i - 1) * 4);
+
+            if (i % keyWords == 0)
+            {
+                temp = (temp << 8) | (temp >> 24);
+                temp = (((uint32) sbox[temp >> 24]) << 24) | (((uint32) sbox[(temp >> 16) & 0xff]) << 16)
+                         | (((uint32) sbox[(temp >> 8) & 0xff]) << 8) | sbox[temp & 0xff];
+                temp ^= roundConstant << 24;
+
+                roundConstant = ((roundConstant << 1) ^ ((roundConstant & 0x80) != 0 ? 0x1b : 0)) & 0xff;
+            }
+            else if (keyWords > 6 && i % keyWords == 4)
+            {
+                temp = (((uint32) sbox[temp >> 24]) << 24) | (((uint32) sbox[(temp >> 16) & 0xff]) << 16)
+                         | (((uint32) sbox[(temp >> 8) & 0xff]) << 8) | sbox[temp & 0xff];
+            }
+
+            writeBigEndianInt (roundKeys + i * 4, ByteOrder::bigEndianInt (roundKeys + (i - keyWords) * 4) ^ temp);
+        }
+
+        return numRounds;
+    }
+
+    //==============================================================================
+    static void encryptBlocksGeneric (const uint8* const roundKeys, const int numRounds,
+                                      const uint8* input, uint8* output, size_t numBlocks) noexcept
+    {
+        const Tables& tables = getTables();
+        const uint32* const te = tables.encryptTable;
+        const uint8* const sbox = tables.sbox;
+
+        for (; numBlocks > 0; --numBlocks, input += 16, output += 16)
+        {
+            const uint8* rk = roundKeys;
+
+            uint32 s0 = ByteOrder::bigEndianInt (input)      ^ ByteOrder::bigEndianInt (rk);
+            uint32 s1 = ByteOrder::bigEndianInt (input + 4)  ^ ByteOrder::bigEndianInt (rk + 4);
+            uint32 s2 = ByteOrder::bigEndianInt (input + 8)  ^ ByteOrder::bigEndianInt (rk + 8);
+            uint32 s3 = ByteOrder::bigEndianInt (input + 12) ^ ByteOrder::bigEndianInt (rk + 12);
+
+            #define JUCE_AES_COLUMN(a, b, c, d, keyOffset) \
+                (te[a >> 24] ^ rotateRight (te[(b >> 16) & 0xff], 8) ^ rotateRight (te[(c >> 8) & 0xff], 16) \
+                   ^ rotateRight (te[d & 0xff], 24) ^ ByteOrder::bigEndianInt (rk + keyOffset))
+
+            for (int round = 1; round < numRounds; ++round)
+            {
+                rk += 16;
+
+                const uint32 t0 = JUCE_AES_COLUMN (s0, s1, s2, s3, 0);
+                const uint32 t1 = JUCE_AES_COLUMN (s1, s2, s3, s0, 4);
+                const uint32 t2 = JUCE_AES_COLUMN (s2, s3, s0, s1, 8);
+                const uint32 t3 = JUCE_AES_COLUMN (s3, s0, s1, s2, 12);
+
+                s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+            }
+
+            #undef JUCE_AES_COLUMN
+
+            // the last round has no MixColumns step
+            rk += 16;
+
+            #define JUCE_AES_LAST_COLUMN(a, b, c, d, keyOffset) \
+                ((((uint32) sbox[a >> 24]) << 24) ^ (((uint32) sbox[(b >> 16) & 0xff]) << 16) \
+                   ^ (((uint32) sbox[(c >> 8) & 0xff]) << 8) ^ sbox[d & 0xff] ^ ByteOrder::bigEndianInt (rk + keyOffset))
+
+            writeBigEndianInt (output,      JUCE_AES_LAST_COLUMN (s0, s1, s2, s3, 0));
+            writeBigEndianInt (output + 4,  JUCE_AES_LAST_COLUMN (s1, s2, s3, s0, 4));
+            writeBigEndianInt (output + 8,  JUCE_AES_LAST_COLUMN (s2, s3, s0, s1, 8));
+            writeBigEndianInt (output + 12, JUCE_AES_LAST_COLUMN (s3, s0, s1, s2, 12));
+
+            #undef JUCE_AES_LAST_COLUMN
+        }
+    }
+
+   #if JUCE_USE_AES_INTRINSICS
+    // Four blocks are encrypted at once where possible, as the AES instructions can be
+    // pipelined when there are several independent blocks in flight.
+    JUCE_AES_FUNCTION static void encryptBlocksIntel (const uint8* const roundKeys, const int numRounds,
+                                                      const uint8* input, uint8* output, size_t numBlocks) noexcept
+    {
+        __m128i keys[15];
+
+        for (int i = 0; i <= numRounds; ++i)
+            keys[i] = _mm_loadu_si128 ((const __m128i*) (roundKeys + i * 16));
+
+        for (; numBlocks >= 4; numBlocks -= 4, input += 64, output += 64)
+        {
+            __m128i b0 = _mm_xor_si128 (_mm_loadu_si128 ((const __m128i*) input),        keys[0]);
+            __m128i b1 = _mm_xor_si128 (_mm_loadu_si128 ((const __m128i*) (input + 16)), keys[0]);
+            __m128i b2 = _mm_xor_si128 (_mm_loadu_si128 ((const __m128i*) (input + 32)), keys[0]);
+            __m128i b3 = _mm_xor_si128 (_mm_loadu_si128 ((const __m128i*) (input + 48)), keys[0]);
+
+            for (int i = 1; i < numRounds; ++i)
+            {
+                b0 = _mm_aesenc_si128 (b0, keys[i]);
+                b1 = _mm_aesenc_si128 (b1, keys[i]);
+                b2 = _mm_aesenc_si128 (b2, keys[i]);
+                b3 = _mm_aesenc_si128 (b3, keys[i]);
+            }
+
+            _mm_storeu_si128 ((__m128i*) output,        _mm_aesenclast_si128 (b0, keys[numRounds]));
+            _mm_storeu_si128 ((__m128i*) (output + 16), _mm_aesenclast_si128 (b1, keys[numRounds]));
+            _mm_storeu_si128 ((__m128i*) (output + 32), _mm_aesenclast_si128 (b2, keys[numRounds]));
+            _mm_storeu_si128 ((__m128i*) (output + 48), _mm_aesenclast_si128 (b3, keys[numRounds]));
+        }
+
+        for (; numBlocks > 0; --numBlocks, input += 16, output += 16)
+        {
+            __m128i b = _mm_xor_si128 (_mm_loadu_si128 ((const __m128i*) input), keys[0]);
+
+            for (int i = 1; i < numRounds; ++i)
+                b = _mm_aesenc_si128 (b, keys[i]);
+
+            _mm_storeu_si128 ((__m128i*) output, _mm_aesenclast_si128 (b, keys[numRounds]));
+        }
+    }
+
+    // Multiplies the GHASH state by the hash key for each block, using carry-less multiplication.
+    // Both values are byte-reversed, so that the bit-reflected GCM field elements can be treated
+    // as ordinary polynomials.
+    JUCE_AES_FUNCTION static void ghashBlocksIntel (uint8* const state, const uint8* const hashKey,
+                                                    const uint8* data, size_t numBlocks) noexcept
+    {
+        const __m128i byteReverse = _mm_set_epi8 (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m128i h = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) hashKey), byteReverse);
+        __m128i x = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) state), byteReverse);
+
+        for (; numBlocks > 0; --numBlocks, data += 16)
+        {
+            x = _mm_xor_si128 (x, _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) data), byteReverse));
+
+            // 256-bit product
+            __m128i low    = _mm_clmulepi64_si128 (x, h, 0x00);
+            __m128i middle = _mm_xor_si128 (_mm_clmulepi64_si128 (x, h, 0x10), _mm_clmulepi64_si128 (x, h, 0x01));
+            __m128i high   = _mm_clmulepi64_si128 (x, h, 0x11);
+
+            low  = _mm_xor_si128 (low,  _mm_slli_si128 (middle, 8));
+            high = _mm_xor_si128 (high, _mm_srli_si128 (middle, 8));
+
+            // shift the product left by one bit, to allow for the bit reflection
+            const __m128i lowCarry  = _mm_srli_epi32 (low, 31);
+            const __m128i highCarry = _mm_srli_epi32 (high, 31);
+            low  = _mm_or_si128 (_mm_slli_epi32 (low, 1),  _mm_slli_si128 (lowCarry, 4));
+            high = _mm_or_si128 (_mm_or_si128 (_mm_slli_epi32 (high, 1), _mm_slli_si128 (highCarry, 4)),
+                                 _mm_srli_si128 (lowCarry, 12));
+
+            // reduce modulo x^128 + x^7 + x^2 + x + 1
+            __m128i a = _mm_xor_si128 (_mm_xor_si128 (_mm_slli_epi32 (low, 31), _mm_slli_epi32 (low, 30)),
+                                       _mm_slli_epi32 (low, 25));
+            const __m128i carried = _mm_srli_si128 (a, 4);
+            low = _mm_xor_si128 (low, _mm_slli_si128 (a, 12));
+
+            a = _mm_xor_si128 (_mm_xor_si128 (_mm_srli_epi32 (low, 1), _mm_srli_epi32 (low, 2)),
+                               _mm_xor_si128 (_mm_srli_epi32 (low, 7), carried));
+
+            x = _mm_xor_si128 (high, _mm_xor_si128 (low, a));
+        }
+
+        _mm_storeu_si128 ((__m128i*) state, _mm_shuffle_epi8 (x, byteReverse));
+    }
+   #endif
+
+   #if JUCE_USE_ARM_AES_INTRINSICS
+    static void encryptBlocksARM (const uint8* const roundKeys, const int numRounds,
+                                  const uint8* input, uint8* output, size_t numBlocks) noexcept
+    {
+        uint8x16_t keys[15];
+
+        for (int i = 0; i <= numRounds; ++i)
+            keys[i] = vld1q_u8 (roundKeys + i * 16);
+
+        for (; numBlocks > 0; --numBlocks, input += 16, output += 16)
+        {
+            uint8x16_t b = vld1q_u8 (input);
+
+            // (each vaeseq_u8 does AddRoundKey, SubBytes and ShiftRows)
+            for (int i = 0; i < numRounds - 1; ++i)
+                b = vaesmcq_u8 (vaeseq_u8 (b, keys[i]));
+
+            b = veorq_u8 (vaeseq_u8 (b, keys[numRounds - 1]), keys[numRounds]);
+            vst1q_u8 (output, b);
+        }
+    }
+   #endif
+
+    static bool canUseIntelInstructions() noexcept
+    {
+       #if JUCE_USE_AES_INTRINSICS
+        static const bool hasAES = SystemStats::hasAES();
+        return hasAES;
+       #else
+        return false;
+       #endif
+    }
+
+    static void encryptBlocks (const uint8* const roundKeys, const int numRounds,
+                               const uint8* const input, uint8* const output, const size_t numBlocks) noexcept
+    {
+       #if JUCE_USE_AES_INTRINSICS
+        if (canUseIntelInstructions())
+            return encryptBlocksIntel (roundKeys, numRounds, input, output, numBlocks);
+       #endif
+
+       #if JUCE_USE_ARM_AES_INTRINSICS
+        encryptBlocksARM (roundKeys, numRounds, input, output, numBlocks);
+       #else
+        encryptBlocksGeneric (roundKeys, numRounds, input, output, numBlocks);
+       #endif
+    }
+
+    //==============================================================================
+    /** Calculates the GHASH function used for GCM authentication. */
+    class GHash
+    {
+    public:
+        GHash (const uint8* const hashKey_, const bool useHardware_) noexcept
+            : useHardware (useHardware_)
+        {
+            zerostruct (state);
+            memcpy (hashKey, hashKey_, sizeof (hashKey));
+
+            if (! useHardware)
+                createTable();
+        }
+
+        // Any partial block at the end of the data is padded with zeros.
+        void update (const void* const data, const size_t numBytes) noexcept
+        {
+            const size_t numWholeBytes = numBytes & ~(size_t) 15;
+            processBlocks (static_cast <const uint8*> (data), numWholeBytes / 16);
+
+            if (numWholeBytes < numBytes)
+            {
+                uint8 lastBlock[16] = { 0 };
+                memcpy (lastBlock, static_cast <const uint8*> (data) + numWholeBytes, numBytes - numWholeBytes);
+                processBlocks (lastBlock, 1);
+            }
+        }
+
+        void finish (uint8* const result, const uint64 additionalDataSize, const uint64 dataSize) noexcept
+        {
+            uint8 lengths[16];
+            writeBigEndianInt (lengths,      (uint32) (additionalDataSize >> 29));
+            writeBigEndianInt (lengths + 4,  (uint32) (additionalDataSize << 3));
+            writeBigEndianInt (lengths + 8,  (uint32) (dataSize >> 29));
+            writeBigEndianInt (lengths + 12, (uint32) (dataSize << 3));
+            processBlocks (lengths, 1);
+
+            memcpy (result, state, sizeof (state));
+        }
+
+    private:
+        uint8 state [16], hashKey [16];
+        uint64 tableHigh [16], tableLow [16];
+        const bool useHardware;
+
+        void processBlocks (const uint8* data, size_t numBlocks) noexcept
+        {
+           #if JUCE_USE_AES_INTRINSICS
+            if (useHardware)
+                return ghashBlocksIntel (state, hashKey, data, numBlocks);
+           #endif
+
+            for (; numBlocks > 0; --numBlocks, data += 16)
+            {
+                for (int i = 0; i < 16; ++i)
+                    state[i] ^= data[i];
+
+                multiplyStateByKey();
+            }
+        }
+
+        // Shoup's method, using a table of the key multiplied by each 4-bit value
+        void createTable() noexcept
+        {
+            uint64 high = ((uint64) ByteOrder::bigEndianInt (hashKey) << 32) | ByteOrder::bigEndianInt (hashKey + 4);
+            uint64 low  = ((uint64) ByteOrder::bigEndianInt (hashKey + 8) << 32) | ByteOrder::bigEndianInt (hashKey + 12);
+
+            tableHigh[0] = tableLow[0] = 0;
+            tableHigh[8] = high;
+            tableLow[8] = low;
+
+            for (int i = 4; i > 0; i >>= 1)
+            {
+                const uint64 reduction = (low & 1) != 0 ? ((uint64) 0xe1000000 << 32) : 0;
+                low = (high << 63) | (low >> 1);
+                high = (high >> 1) ^ reduction;
+                tableHigh[i] = high;
+                tableLow[i] = low;
+            }
+
+            for (int i = 2; i <= 8; i *= 2)
+            {
+                for (int j = 1; j < i; ++j)
+                {
+                    tableHigh[i + j] = tableHigh[i] ^ tableHigh[j];
+                    tableLow[i + j]  = tableLow[i]  ^ tableLow[j];
+                }
+            }
+        }
+
+        void multiplyStateByKey() noexcept
+        {
+            static const uint64 remainders[16] =
+            {
+                0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+                0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+            };
+
+            int nibble = state[15] & 15;
+            uint64 high = tableHigh[nibble];
+            uint64 low = tableLow[nibble];
+
+            for (int i = 15; i >= 0; --i)
+            {
+                if (i != 15)
+                {
+                    nibble = state[i] & 15;
+                    const int remainder = (int) (low & 15);
+                    low = (high << 60) | (low >> 4);
+                    high = (high >> 4) ^ (remainders[remainder] << 48) ^ tableHigh[nibble];
+                    low ^= tableLow[nibble];
+                }
+
+                nibble = state[i] >> 4;
+                const int remainder = (int) (low & 15);
+                low = (high << 60) | (low >> 4);
+                high = (high >> 4) ^ (remainders[remainder] << 48) ^ tableHigh[nibble];
+                low ^= tableLow[nibble];
+            }
+
+            writeBigEndianInt (state,      (uint32) (high >> 32));
+            writeBigEndianInt (state + 4,  (uint32) high);
+            writeBigEndianInt (state + 8,  (uint32) (low >> 32));
+            writeBigEndianInt (state + 12, (uint32) low);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (GHash)
+    };
+}
+
+//==============================================================================
+AES::AES (const void* const keyData, const int keyBytes)
+    : numRounds (AESHelpers::expandKey (roundKeys, keyData, keyBytes))
+{
+}
+
+AES::AES (const AES& other) noexcept
+    : numRounds (other.numRounds)
+{
+    memcpy (roundKeys, other.roundKeys, sizeof (roundKeys));
+}
+
+AES& AES::operator= (const AES& other) noexcept
+{
+    memcpy (roundKeys, other.roundKeys, sizeof (roundKeys));
+    numRounds = other.numRounds;
+    return *this;
+}
+
+AES::~AES() noexcept
+{
+    zerostruct (roundKeys);
+}
+
+bool AES::isHardwareAccelerated() noexcept
+{
+   #if JUCE_USE_ARM_AES_INTRINSICS
+    return true;
+   #else
+    return AESHelpers::canUseIntelInstructions();
+   #endif
+}
+
+void AES::encryptBlock (const void* const input, void* const output) const noexcept
+{
+    AESHelpers::encryptBlocks (roundKeys, numRounds, static_cast <const uint8*> (input), static_cast <uint8*> (output), 1);
+}
+
+void AES::applyKeystream (uint8* data, size_t numBytes, const uint8* const nonce,
+                          uint32 counter, int offsetInBlock) const noexcept
+{
+    const size_t maxBlocksPerBatch = 64;
+    uint8 counterBlocks [maxBlocksPerBatch * 16], keystream [maxBlocksPerBatch * 16];
+
+    while (numBytes > 0)
+    {
+        const size_t numBlocks = jmin (maxBlocksPerBatch, ((size_t) offsetInBlock + numBytes + 15) / 16);
+
+        for (size_t i = 0; i < numBlocks; ++i)
+        {
+            memcpy (counterBlocks + i * 16, nonce, 12);
+            AESHelpers::writeBigEndianInt (counterBlocks + i * 16 + 12, counter++);
+        }
+
+        AESHelpers::encryptBlocks (roundKeys, numRounds, counterBlocks, keystream, numBlocks);
+
+        const size_t numToUse = jmin (numBytes, numBlocks * 16 - (size_t) offsetInBlock);
+        const uint8* const source = keystream + offsetInBlock;
+
+        for (size_t i = 0; i < numToUse; ++i)
+            data[i] ^= source[i];
+
+        data += numToUse;
+        numBytes -= numToUse;
+        offsetInBlock = 0;
+    }
+}
+
+void AES::processCTR (void* const data, const size_t numBytes, const void* const nonce,
+                      const int64 streamPosition) const noexcept
+{
+    jassert (streamPosition >= 0 && streamPosition + (int64) numBytes <= ((int64) 1 << 36)); // the counter only covers 64GB
+
+    applyKeystream (static_cast <uint8*> (data), numBytes, static_cast <const uint8*> (nonce),
+                    (uint32) (streamPosition >> 4), (int) (streamPosition & 15));
+}
+
+void AES::calculateTag (uint8* const tag, const uint8* const data, const size_t numBytes, const uint8* const nonce,
+                        const void* const additionalData, const size_t additionalDataSize) const
+{
+    uint8 hashKey[16] = { 0 };
+    encryptBlock (hashKey, hashKey);
+
+    AESHelpers::GHash ghash (hashKey, AESHelpers::canUseIntelInstructions());
+    ghash.update (additionalData, additionalDataSize);
+    ghash.update (data, numBytes);
+    ghash.finish (tag, additionalDataSize, numBytes);
+
+    uint8 firstCounterBlock[16] = { 0 };
+    memcpy (firstCounterBlock, nonce, 12);
+    firstCounterBlock[15] = 1;
+    encryptBlock (firstCounterBlock, firstCounterBlock);
+
+    for (int i = 0; i < 16; ++i)
+        tag[i] ^= firstCounterBlock[i];
+}
+
+void AES::encryptGCM (void* const data, const size_t numBytes, const void* const nonce,
+                      const void* const additionalData, const size_t additionalDataSize, void* const tag) const
+{
+    // (the data's counter blocks start at 2, as block 1 is used for the tag)
+    applyKeystream (static_cast <uint8*> (data), numBytes, static_cast <const uint8*> (nonce), 2, 0);
+    calculateTag (static_cast <uint8*> (tag), static_cast <const uint8*> (data), numBytes,
+                  static_cast <const uint8*> (nonce), additionalData, additionalDataSize);
+}
+
+bool AES::decryptGCM (void* const data, const size_t numBytes, const void* const nonce,
+                      const void* const additionalData, const size_t additionalDataSize, const void* const tag) const
+{
+    uint8 expectedTag[16];
+    calculateTag (expectedTag, static_cast <const uint8*> (data), numBytes,
+                  static_cast <const uint8*> (nonce), additionalData, additionalDataSize);
+
+    // (every byte is compared, so that the time taken doesn't reveal where a forged tag goes wrong)
+    uint8 differences = 0;
+
+    for (int i = 0; i < 16; ++i)
+        differences |= (uint8) (expectedTag[i] ^ static_cast <const uint8*> (tag)[i]);
+
+    if (differences != 0)
+    {
+        zeromem (data, numBytes);
+        return false;
+    }
+
+    applyKeystream (static_cast <uint8*> (data), numBytes, static_cast <const uint8*> (nonce), 2, 0);
+    return true;
+}
+
+//==============================================================================
+// The layout used by AESEncryptingOutputStream and AESDecryptingInputStream
+namespace AESHelpers
+{
+    static const int streamHeaderSize = 16;  // "jAES", the little-endian chunk size, and an 8-byte nonce prefix
+    static const int tagSize = 16;
+    static const uint32 lastChunkFlag = 0x80000000;
+
+    static const char streamMagic[] = "jAES";
+
+    // Each chunk's nonce is made of the stream's random prefix, then its index, with the top bit set
+    // for the last chunk. That stops chunks being re-ordered, or the stream being cut short at
+    // a chunk boundary, without the tags failing to match.
+    static void makeChunkNonce (uint8* const nonce, const uint8* const streamHeader,
+                                const uint32 chunkIndex, const bool isLastChunk) noexcept
+    {
+        memcpy (nonce, streamHeader + 8, 8);
+        writeBigEndianInt (nonce + 8, chunkIndex | (isLastChunk ? lastChunkFlag : 0));
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AESTests  : public UnitTest
+{
+public:
+    AESTests() : UnitTest ("AES") {}
+
+    static MemoryBlock fromHex (const char* const hex)
+    {
+        MemoryBlock m;
+        m.loadFromHexString (hex);
+        return m;
+    }
+
+    static String toHex (const void* const data, const size_t numBytes)
+    {
+        return String::toHexString (data, (int) numBytes, 0);
+    }
+
+    void expectBlock (const char* key, const char* plaintext, const char* expected)
+    {
+        const MemoryBlock k (fromHex (key));
+        MemoryBlock block (fromHex (plaintext));
+
+        AES aes (k.getData(), (int) k.getSize());
+        aes.encryptBlock (block.getData(), block.getData());
+        expectEquals (toHex (block.getData(), 16), String (expected));
+    }
+
+    void expectGCM (const char* key, const char* nonce, const char* plaintext, const char* additionalData,
+                    const char* expectedCiphertext, const char* expectedTag)
+    {
+        const MemoryBlock k (fromHex (key)), n (fromHex (nonce)), a (fromHex (additionalData));
+        const MemoryBlock original (fromHex (plaintext));
+        MemoryBlock data (original);
+        uint8 tag[16];
+
+        AES aes (k.getData(), (int) k.getSize());
+        aes.encryptGCM (data.getData(), data.getSize(), n.getData(), a.getData(), a.getSize(), tag);
+        expectEquals (toHex (data.getData(), data.getSize()), String (expectedCiphertext));
+        expectEquals (toHex (tag, 16), String (expectedTag));
+
+        expect (aes.decryptGCM (data.getData(), data.getSize(), n.getData(), a.getData(), a.getSize(), tag));
+        expect (data == original);
+
+        aes.encryptGCM (data.getData(), data.getSize(), n.getData(), a.getData(), a.getSize(), tag);
+        tag[3] ^= 1;
+        expect (! aes.decryptGCM (data.getData(), data.getSize(), n.getData(), a.getData(), a.getSize(), tag));
+    }
+
+    void runTest()
+    {
+        beginTest ("Block encryption");
+
+        expectBlock ("000102030405060708090a0b0c0d0e0f", "00112233445566778899aabbccddeeff",
+                     "69c4e0d86a7b0430d8cdb78070b4c55a");
+        expectBlock ("000102030405060708090a0b0c0d0e0f1011121314151617", "00112233445566778899aabbccddeeff",
+                     "dda97ca4864cdfe06eaf70a0ec0d7191");
+        expectBlock ("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "00112233445566778899aabbccddeeff",
+                     "8ea2b7ca516745bfeafc49904b496089");
+
+        Random r;
+
+        {
+            uint8 key[32], input[16 * 37], generic[sizeof (input)], best[sizeof (input)];
+
+            for (int i = 0; i < 10; ++i)
+            {
+                for (size_t j = 0; j < sizeof (key); ++j)    key[j] = (uint8) r.nextInt (256);
+                for (size_t j = 0; j < sizeof (input); ++j)  input[j] = (uint8) r.nextInt (256);
+
+                uint8 roundKeys[240];
+                const int numRounds = AESHelpers::expandKey (roundKeys, key, 16 + 8 * (i % 3));
+                AESHelpers::encryptBlocksGeneric (roundKeys, numRounds, input, generic, 37);
+                AESHelpers::encryptBlocks (roundKeys, numRounds, input, best, 37);
+                expect (memcmp (generic, best, sizeof (best)) == 0);
+            }
+        }
+
+        beginTest ("GCM");
+
+        expectGCM ("00000000000000000000000000000000", "000000000000000000000000", "", "",
+                   "", "58e2fccefa7e3061367f1d57a4e7455a");
+        expectGCM ("00000000000000000000000000000000", "000000000000000000000000",
+                   "00000000000000000000000000000000", "",
+                   "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf");
+        expectGCM ("feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+                   "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+                   "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+                   "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+                   "5bc94fbc3221a5db94fae95ae7121a47");
+        expectGCM ("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+                   "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+                   "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+                   "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662",
+                   "76fc6ece0f4e1768cddf8853bb2d551b");
+
+        {
+            uint8 hashKey[16], data[16 * 11 + 5], hardwareResult[16], softwareResult[16];
+
+            for (size_t j = 0; j < sizeof (hashKey); ++j)  hashKey[j] = (uint8) r.nextInt (256);
+            for (size_t j = 0; j < sizeof (data); ++j)     data[j] = (uint8) r.nextInt (256);
+
+            AESHelpers::GHash software (hashKey, false), best (hashKey, AESHelpers::canUseIntelInstructions());
+            software.update (data, sizeof (data));
+            best.update (data, sizeof (data));
+            software.finish (softwareResult, 0, sizeof (data));
+            best.finish (hardwareResult, 0, sizeof (data));
+            expect (memcmp (softwareResult, hardwareResult, 16) == 0);
+        }
+
+        beginTest ("Counter mode");
+
+        {
+            uint8 key[16], nonce[12];
+            for (size_t j = 0; j < sizeof (key); ++j)    key[j] = (uint8) r.nextInt (256);
+            for (size_t j = 0; j < sizeof (nonce); ++j)  nonce[j] = (uint8) r.nextInt (256);
+
+            const AES aes (key, sizeof (key));
+            MemoryBlock original (3000), whole;
+
+            for (size_t i = 0; i < original.getSize(); ++i)
+                original[i] = (char) r.nextInt (256);
+
+            whole = original;
+            aes.processCTR (whole.getData(), whole.getSize(), nonce);
+            expect (whole != original);
+
+            for (int i = 0; i < 20; ++i)
+            {
+                const int start = r.nextInt (2900);
+                const int length = r.nextInt (100);
+                MemoryBlock section (static_cast <const char*> (original.getData()) + start, (size_t) length);
+                aes.processCTR (section.getData(), section.getSize(), nonce, start);
+                expect (memcmp (section.getData(), static_cast <const char*> (whole.getData()) + start, (size_t) length) == 0);
+            }
+
+            aes.processCTR (whole.getData(), whole.getSize(), nonce);
+            expect (whole == original);
+        }
+
+        beginTest ("Streams");
+
+        {
+            const char* const key = "0123456789abcdef0123456789abcdef";
+
+            for (int test = 0; test < 8; ++test)
+            {
+                const int chunkSize = 16 + r.nextInt (200);
+                const int size = test == 0 ? 0 : (test == 1 ? chunkSize * 3 : r.nextInt (5000));
+
+                MemoryBlock original ((size_t) size), encrypted;
+
+                for (int i = 0; i < size; ++i)
+                    original[i] = (char) r.nextInt (256);
+
+                {
+                    AESEncryptingOutputStream out (new MemoryOutputStream (encrypted, false), true, key, 32, chunkSize);
+
+                    for (int pos = 0; pos < size;)
+                    {
+                        const int n = jmin (size - pos, r.nextInt (300));
+                        out.write (static_cast <const char*> (original.getData()) + pos, (size_t) n);
+                        pos += n;
+                    }
+                }
+
+                {
+                    AESDecryptingInputStream in (new MemoryInputStream (encrypted, false), true, key, 32);
+                    expectEquals (in.getTotalLength(), (int64) size);
+
+                    MemoryBlock decrypted;
+                    in.readIntoMemoryBlock (decrypted);
+                    expect (in.getStatus().wasOk());
+                    expect (decrypted == original);
+                    expect (in.isExhausted());
+
+                    for (int i = 0; i < 10 && size > 0; ++i)
+                    {
+                        const int start = r.nextInt (size);
+                        HeapBlock<char> section (100);
+                        in.setPosition (start);
+                        const int numRead = in.read (section, 100);
+                        expectEquals (numRead, jmin (100, size - start));
+                        expect (memcmp (section, static_cast <const char*> (original.getData()) + start, (size_t) numRead) == 0);
+                    }
+                }
+
+                {
+                    AESDecryptingInputStream in (new MemoryInputStream (encrypted, false), true, "0123456789abcdef0123456789abcdeX", 32);
+                    MemoryBlock decrypted;
+                    in.readIntoMemoryBlock (decrypted);
+                    expect (in.getStatus().failed() && decrypted.getSize() == 0);
+                }
+
+                {
+                    MemoryBlock tampered (encrypted);
+                    tampered[16 + r.nextInt ((int) tampered.getSize() - 16)] ^= 0x10;
+
+                    AESDecryptingInputStream in (new MemoryInputStream (tampered, false), true, key, 32);
+                    MemoryBlock decrypted;
+                    in.readIntoMemoryBlock (decrypted);
+                    expect (in.getStatus().failed());
+                }
+
+                if (size > chunkSize)
+                {
+                    // cutting the stream off at a chunk boundary must also be detected
+                    AESDecryptingInputStream in (new MemoryInputStream (encrypted.getData(), (size_t) (16 + chunkSize + 16), false),
+                                                 true, key, 32);
+                    MemoryBlock decrypted;
+                    in.readIntoMemoryBlock (decrypted);
+                    expect (in.getStatus().failed());
+                }
+            }
+        }
+
+        beginTest ("Speed");
+
+        {
+            uint8 key[16] = { 0 }, nonce[12] = { 0 }, tag[16];
+            const AES aes (key, sizeof (key));
+            HeapBlock<uint8> data (1024 * 1024, true);
+
+            const double startTime = Time::getMillisecondCounterHiRes();
+
+            for (int i = 0; i < 32; ++i)
+                aes.encryptGCM (data, 1024 * 1024, nonce, nullptr, 0, tag);
+
+            const double elapsedMs = Time::getMillisecondCounterHiRes() - startTime;
+            logMessage ("AES-128-GCM: " + String (32.0 * 1000.0 / jmax (1.0, elapsedMs), 1) + " MB/s"
+                          + (AES::isHardwareAccelerated() ? " (hardware)" : " (software)"));
+        }
+    }
+};
+
+static AESTests aesTests;
+
+#endif
@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_AES_JUCEHEADER__
+#define __JUCE_AES_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    AES (Rijndael) encryption, with counter mode and Galois/counter mode helpers.
+
+    This uses the Intel AES-NI instructions on CPUs that have them, and the ARMv8
+    cryptography instructions when compiling for a CPU with those, falling back to a
+    table-based implementation elsewhere.
+
+    To encrypt large amounts of data, such as whole files, it's easiest to use an
+    AESEncryptingOutputStream and AESDecryptingInputStream, which add authentication
+    and allow random access to the decrypted data.
+
+    @see AESEncryptingOutputStream, AESDecryptingInputStream, BlowFish
+*/
+class JUCE_API  AES
+{
+public:
+    //==============================================================================
+    /** Creates an object that can encrypt with the specified key.
+        The key must be 16, 24 or 32 bytes long, for AES-128, AES-192 or AES-256.
+    */
+    AES (const void* keyData, int keyBytes);
+
+    /** Creates a copy of another AES object. */
+    AES (const AES& other) noexcept;
+
+    /** Copies another AES object. */
+    AES& operator= (const AES& other) noexcept;
+
+    /** Destructor. */
+    ~AES() noexcept;
+
+    //==============================================================================
+    /** Encrypts a single 16-byte block.
+        The input and output may point to the same place.
+    */
+    void encryptBlock (const void* input, void* output) const noexcept;
+
+    //==============================================================================
+    /** Encrypts or decrypts some data in place, in counter (CTR) mode.
+
+        The keystream is made by encrypting counter blocks made of the 12-byte nonce
+        followed by a 32-bit big-endian block number, starting from zero. As each part
+        of the keystream only depends on its position, streamPosition lets you process a
+        section from the middle of the data on its own.
+
+        Counter mode XORs the data with the keystream, so this both encrypts and decrypts.
+        Never re-use the same key and nonce for two different sets of data!
+    */
+    void processCTR (void* data, size_t numBytes, const void* nonce,
+                     int64 streamPosition = 0) const noexcept;
+
+    /** Encrypts some data in place, in Galois/counter mode (GCM).
+
+        @param data                 the data to encrypt
+        @param numBytes             the size of the data
+        @param nonce                a 12-byte value which must never be re-used with the same key
+        @param additionalData       some optional data which isn't encrypted, but is included in the
+                                    authentication tag, so that it can't be tampered with
+        @param additionalDataSize   the size of the additional data, which may be 0
+        @param tag                  a 16-byte buffer into which the authentication tag is written
+    */
+    void encryptGCM (void* data, size_t numBytes, const void* nonce,
+                     const void* additionalData, size_t additionalDataSize,
+                     void* tag) const;
+
+    /** Checks and decrypts some data in place that was encrypted by encryptGCM().
+
+        If the tag doesn't match the data, nonce and additional data, this returns false
+        and fills the data with zeros, rather than leaving it partly decrypted.
+    */
+    bool decryptGCM (void* data, size_t numBytes, const void* nonce,
+                     const void* additionalData, size_t additionalDataSize,
+                     const void* tag) const;
+
+    //==============================================================================
+    /** Returns true if the CPU's AES instructions are being used. */
+    static bool isHardwareAccelerated() noexcept;
+
+
+private:
+    //==============================================================================
+    uint8 roundKeys [240];
+    int numRounds;
+
+    void applyKeystream (uint8*, size_t, const uint8* nonce, uint32 counter, int offsetInBlock) const noexcept;
+    void calculateTag (uint8* tag, const uint8* data, size_t, const uint8* nonce, const void*, size_t) const;
+
+    JUCE_LEAK_DETECTOR (AES)
+};
+
+
+#endif   // __JUCE_AES_JUCEHEADER__
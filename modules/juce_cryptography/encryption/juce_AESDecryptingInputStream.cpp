@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+AESDecryptingInputStream::AESDecryptingInputStream (InputStream* const sourceStream_,
+                                                    const bool deleteSourceWhenDestroyed,
+                                                    const void* const keyData, const int keyBytes)
+    : sourceStream (sourceStream_, deleteSourceWhenDestroyed),
+      aes (keyData, keyBytes),
+      chunkSize (0), loadedChunkSize (0),
+      originalSourcePos (sourceStream_->getPosition()),
+      currentPos (0), loadedChunkIndex (-1),
+      loadedChunkIsLast (false),
+      status (Result::ok())
+{
+    zerostruct (header);
+
+    if (sourceStream->read (header, sizeof (header)) == (int) sizeof (header)
+         && memcmp (header, AESHelpers::streamMagic, 4) == 0)
+    {
+        chunkSize = (int) ByteOrder::littleEndianInt (header + 4);
+    }
+
+    if (chunkSize < 16 || chunkSize > (1 << 24))
+    {
+        chunkSize = 0;
+        status = Result::fail ("Not an encrypted stream");
+        return;
+    }
+
+    chunk.malloc ((size_t) chunkSize + AESHelpers::tagSize);
+}
+
+AESDecryptingInputStream::~AESDecryptingInputStream()
+{
+    if (chunk != nullptr)
+        zeromem (chunk, (size_t) chunkSize + AESHelpers::tagSize);
+}
+
+bool AESDecryptingInputStream::loadChunkContaining (const int64 position)
+{
+    if (status.failed())
+        return false;
+
+    const int64 index = position / chunkSize;
+
+    if (index == loadedChunkIndex)
+        return true;
+
+    loadedChunkIndex = -1;
+
+    const int64 encryptedChunkSize = chunkSize + (int64) AESHelpers::tagSize;
+    const int numToRead = (int) encryptedChunkSize;
+    int numRead = 0;
+
+    if (index < (int64) AESHelpers::lastChunkFlag
+         && sourceStream->setPosition (originalSourcePos + AESHelpers::streamHeaderSize + index * encryptedChunkSize))
+    {
+        while (numRead < numToRead)
+        {
+            const int n = sourceStream->read (chunk + numRead, numToRead - numRead);
+
+            if (n <= 0)
+                break;
+
+            numRead += n;
+        }
+    }
+
+    // (a chunk that's been cut short, or cut off entirely, is caught here or by its tag,
+    // because a short chunk that wasn't written as the last one won't authenticate)
+    if (numRead < AESHelpers::tagSize)
+    {
+        status = Result::fail ("The encrypted data has been truncated");
+        return false;
+    }
+
+    const int dataSize = numRead - AESHelpers::tagSize;
+    const bool isLast = numRead < numToRead;
+
+    uint8 nonce[12];
+    AESHelpers::makeChunkNonce (nonce, header, (uint32) index, isLast);
+
+    if (! aes.decryptGCM (chunk, (size_t) dataSize, nonce, header, sizeof (header), chunk + dataSize))
+    {
+        status = Result::fail ("The encrypted data has been modified, or the key is wrong");
+        return false;
+    }
+
+    loadedChunkIndex = index;
+    loadedChunkSize = dataSize;
+    loadedChunkIsLast = isLast;
+    return true;
+}
+
+int AESDecryptingInputStream::read (void* const destBuffer, const int maxBytesToRead)
+{
+    jassert (destBuffer != nullptr && maxBytesToRead >= 0);
+
+    int numRead = 0;
+
+    while (numRead < maxBytesToRead && loadChunkContaining (currentPos))
+    {
+        const int offsetInChunk = (int) (currentPos - loadedChunkIndex * chunkSize);
+        const int numToCopy = jmin (maxBytesToRead - numRead, loadedChunkSize - offsetInChunk);
+
+        if (numToCopy <= 0)
+            break;
+
+        memcpy (static_cast <char*> (destBuffer) + numRead, chunk + offsetInChunk, (size_t) numToCopy);
+        numRead += numToCopy;
+        currentPos += numToCopy;
+    }
+
+    return numRead;
+}
+
+bool AESDecryptingInputStream::isExhausted()
+{
+    return ! loadChunkContaining (currentPos)
+            || currentPos - loadedChunkIndex * chunkSize >= loadedChunkSize;
+}
+
+int64 AESDecryptingInputStream::getPosition()
+{
+    return currentPos;
+}
+
+bool AESDecryptingInputStream::setPosition (const int64 newPosition)
+{
+    currentPos = jmax ((int64) 0, newPosition);
+    return status.wasOk();
+}
+
+int64 AESDecryptingInputStream::getTotalLength()
+{
+    const int64 sourceLength = sourceStream->getTotalLength();
+
+    if (status.failed() || sourceLength < 0)
+        return -1;
+
+    const int64 encryptedChunkSize = chunkSize + (int64) AESHelpers::tagSize;
+    const int64 encryptedSize = sourceLength - originalSourcePos - AESHelpers::streamHeaderSize - AESHelpers::tagSize;
+
+    if (encryptedSize < 0)
+        return 0;
+
+    // (all but the last chunk are full, and the last one is always shorter)
+    return (encryptedSize / encryptedChunkSize) * chunkSize
+             + jmin ((int64) chunkSize - 1, encryptedSize % encryptedChunkSize);
+}
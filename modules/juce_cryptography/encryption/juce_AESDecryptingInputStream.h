@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_AESDECRYPTINGINPUTSTREAM_JUCEHEADER__
+#define __JUCE_AESDECRYPTINGINPUTSTREAM_JUCEHEADER__
+
+#include "juce_AES.h"
+
+
+//==============================================================================
+/**
+    An InputStream which checks and decrypts data that was written by an
+    AESEncryptingOutputStream.
+
+    Each chunk of the data is authenticated before any of it is returned, so if the
+    source has been tampered with, truncated, or the wrong key is used, the stream stops
+    returning data and getStatus() will describe the problem. Always check getStatus()
+    after reading, to make sure that you've read all of the data!
+
+    As the chunks can be checked individually, setPosition() is fast as long as the
+    source stream can seek, so this is suitable for streaming from large encrypted files.
+
+    @see AESEncryptingOutputStream, AES
+*/
+class JUCE_API  AESDecryptingInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a decrypting stream.
+
+        @param sourceStream                 the stream to read from
+        @param deleteSourceWhenDestroyed    whether or not to delete the source stream
+                                            when this object is destroyed
+        @param keyData                      the key that the data was encrypted with
+        @param keyBytes                     the size of the key
+    */
+    AESDecryptingInputStream (InputStream* sourceStream,
+                              bool deleteSourceWhenDestroyed,
+                              const void* keyData, int keyBytes);
+
+    /** Destructor. */
+    ~AESDecryptingInputStream();
+
+    //==============================================================================
+    /** Returns an error if the source isn't a valid encrypted stream, or if some of
+        the data that has been read so far failed its authentication check.
+    */
+    Result getStatus() const                { return status; }
+
+    //==============================================================================
+    int64 getPosition();
+    bool setPosition (int64 newPosition);
+    int64 getTotalLength();
+    bool isExhausted();
+    int read (void* destBuffer, int maxBytesToRead);
+
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<InputStream> sourceStream;
+    const AES aes;
+    uint8 header [16];
+    int chunkSize, loadedChunkSize;
+    int64 originalSourcePos, currentPos, loadedChunkIndex;
+    bool loadedChunkIsLast;
+    HeapBlock <uint8> chunk;
+    Result status;
+
+    bool loadChunkContaining (int64 position);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AESDecryptingInputStream)
+};
+
+
+#endif   // __JUCE_AESDECRYPTINGINPUTSTREAM_JUCEHEADER__
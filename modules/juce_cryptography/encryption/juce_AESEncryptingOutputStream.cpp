@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+AESEncryptingOutputStream::AESEncryptingOutputStream (OutputStream* const destStream_,
+                                                      const bool deleteDestStreamWhenDestroyed,
+                                                      const void* const keyData, const int keyBytes,
+                                                      const int chunkSizeBytes)
+    : destStream (destStream_, deleteDestStreamWhenDestroyed),
+      aes (keyData, keyBytes),
+      chunkSize (jlimit (16, 1 << 24, chunkSizeBytes)),
+      buffer ((size_t) chunkSize + AESHelpers::tagSize),
+      numBuffered (0), chunkIndex (0), position (0),
+      isClosed (false), writeFailed (false)
+{
+    jassert (destStream_ != nullptr);
+
+    static Atomic<int> streamCount;
+
+    Random r;
+    r.setSeedRandomly();
+    const int64 noncePrefix = r.nextInt64() ^ Time::getHighResolutionTicks()
+                                ^ (((int64) ++streamCount) << 40);
+
+    memcpy (header, AESHelpers::streamMagic, 4);
+    const uint32 littleEndianChunkSize = ByteOrder::swapIfBigEndian ((uint32) chunkSize);
+    memcpy (header + 4, &littleEndianChunkSize, 4);
+    memcpy (header + 8, &noncePrefix, 8);
+
+    writeFailed = ! destStream->write (header, sizeof (header));
+}
+
+AESEncryptingOutputStream::~AESEncryptingOutputStream()
+{
+    flush();
+}
+
+void AESEncryptingOutputStream::flush()
+{
+    if (! isClosed)
+    {
+        // (the last chunk is always shorter than a full one, even if that means it's empty)
+        writeChunk (true);
+        isClosed = true;
+    }
+
+    destStream->flush();
+}
+
+void AESEncryptingOutputStream::writeChunk (const bool isLastChunk)
+{
+    // Over 2 billion chunks! You'll need to use a bigger chunk size than this..
+    jassert (chunkIndex < AESHelpers::lastChunkFlag);
+
+    uint8 nonce[12];
+    AESHelpers::makeChunkNonce (nonce, header, chunkIndex++, isLastChunk);
+    aes.encryptGCM (buffer, (size_t) numBuffered, nonce, header, sizeof (header), buffer + numBuffered);
+
+    if (! destStream->write (buffer, (size_t) numBuffered + AESHelpers::tagSize))
+        writeFailed = true;
+
+    numBuffered = 0;
+}
+
+bool AESEncryptingOutputStream::write (const void* const dataToWrite, size_t howManyBytes)
+{
+    // When you call flush() on an AES stream, the stream is closed, and you can
+    // no longer continue to write data to it!
+    jassert (! isClosed);
+
+    if (isClosed)
+        return false;
+
+    const uint8* data = static_cast <const uint8*> (dataToWrite);
+    position += (int64) howManyBytes;
+
+    while (howManyBytes > 0)
+    {
+        const int numToCopy = (int) jmin (howManyBytes, (size_t) (chunkSize - numBuffered));
+        memcpy (buffer + numBuffered, data, (size_t) numToCopy);
+        numBuffered += numToCopy;
+        data += numToCopy;
+        howManyBytes -= (size_t) numToCopy;
+
+        if (numBuffered == chunkSize)
+            writeChunk (false);
+    }
+
+    return ! writeFailed;
+}
+
+int64 AESEncryptingOutputStream::getPosition()
+{
+    return position;
+}
+
+bool AESEncryptingOutputStream::setPosition (int64 /*newPosition*/)
+{
+    jassertfalse; // can't do it!
+    return false;
+}
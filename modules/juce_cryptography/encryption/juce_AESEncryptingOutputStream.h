@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_AESENCRYPTINGOUTPUTSTREAM_JUCEHEADER__
+#define __JUCE_AESENCRYPTINGOUTPUTSTREAM_JUCEHEADER__
+
+#include "juce_AES.h"
+
+
+//==============================================================================
+/**
+    An OutputStream which encrypts and authenticates everything written to it using AES.
+
+    The data is split into chunks, each of which is encrypted in Galois/counter mode
+    with its own authentication tag, so that an AESDecryptingInputStream can check and
+    decrypt any part of it without having to read the whole stream. Every stream is given
+    a random nonce, so the same key can be used for lots of streams.
+
+    Important note: as with a GZIPCompressorOutputStream, calling flush() writes the last
+    chunk and closes the stream, so no more data can be written to it afterwards.
+
+    @see AESDecryptingInputStream, AES
+*/
+class JUCE_API  AESEncryptingOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates an encrypting stream.
+
+        @param destStream                       the stream into which the encrypted data should
+                                                be written
+        @param deleteDestStreamWhenDestroyed    whether or not to delete the destStream object when
+                                                this stream is destroyed
+        @param keyData                          the key, which must be 16, 24 or 32 bytes long
+        @param keyBytes                         the size of the key
+        @param chunkSizeBytes                   the amount of data in each authenticated chunk. Smaller
+                                                chunks make random access cheaper when reading the
+                                                stream, but add 16 bytes of overhead each
+    */
+    AESEncryptingOutputStream (OutputStream* destStream,
+                               bool deleteDestStreamWhenDestroyed,
+                               const void* keyData, int keyBytes,
+                               int chunkSizeBytes = 65536);
+
+    /** Destructor. */
+    ~AESEncryptingOutputStream();
+
+    //==============================================================================
+    /** Writes the last chunk and closes the stream.
+        Note that unlike most streams, when you call flush() on an AESEncryptingOutputStream,
+        the stream is closed - this means that no more data can be written to it, and any
+        subsequent attempts to call write() will cause an assertion.
+    */
+    void flush();
+
+    int64 getPosition();
+    bool setPosition (int64 newPosition);
+    bool write (const void* dataToWrite, size_t howManyBytes);
+
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<OutputStream> destStream;
+    const AES aes;
+    const int chunkSize;
+    uint8 header [16];
+    HeapBlock <uint8> buffer;
+    int numBuffered;
+    uint32 chunkIndex;
+    int64 position;
+    bool isClosed, writeFailed;
+
+    void writeChunk (bool isLastChunk);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AESEncryptingOutputStream)
+};
+
+
+#endif   // __JUCE_AESENCRYPTINGOUTPUTSTREAM_JUCEHEADER__
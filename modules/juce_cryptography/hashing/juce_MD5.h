@@ -74,6 +74,15 @@ public:
     */
     explicit MD5 (CharPointer_UTF8 utf8Text) noexcept;
 
+    /** Calculates the checksums of a list of files, using several threads.
+
+        When there are lots of small files to check, this is much quicker than creating
+        them one at a time. The results are returned in the same order as the files,
+        and any file that can't be opened gets a null checksum.
+    */
+    static Array<MD5> fromFiles (const Array<File>& files,
+                                 int numThreads = SystemStats::getNumCpus());
+
     /** Destructor. */
     ~MD5() noexcept;
 
@@ -100,14 +109,54 @@ public:
     bool operator== (const MD5&) const noexcept;
     bool operator!= (const MD5&) const noexcept;
 
+    //==============================================================================
+    /**
+        Calculates an MD5 checksum incrementally, from data that arrives in pieces.
+
+        Feed it the data with as many calls to update() as you need, and then call
+        getResult() to get the checksum of everything that was passed in.
+    */
+    class JUCE_API  Generator
+    {
+    public:
+        /** Creates a generator, ready to be given some data. */
+        Generator() noexcept;
+
+        /** Destructor. */
+        ~Generator() noexcept;
+
+        /** Adds a block of data to the checksum. */
+        void update (const void* data, size_t numBytes) noexcept;
+
+        /** Adds the contents of a stream to the checksum.
+
+            This will read up to the given number of bytes from the stream. If the number
+            of bytes to read is negative, it'll read until the stream is exhausted.
+        */
+        void update (InputStream& input, int64 numBytesToRead = -1);
+
+        /** Returns the checksum of all the data that has been added.
+            This also resets the generator, so it can be re-used for some new data.
+        */
+        MD5 getResult() noexcept;
+
+        /** Discards any data that has been added, and starts again. */
+        void reset() noexcept;
+
+    private:
+        uint8 buffer [64];
+        uint32 state [4];
+        uint32 count [2];
+
+        void transform (const void*) noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE (Generator)
+    };
 
 private:
     //==============================================================================
     uint8 result [16];
 
-    void processData (const void*, size_t) noexcept;
-    void processStream (InputStream&, int64);
-
     JUCE_LEAK_DETECTOR (MD5)
 };
 
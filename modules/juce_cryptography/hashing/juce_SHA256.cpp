@@ -23,138 +23,283 @@
   ==============================================================================
 */
 
-class SHA256Processor
+namespace SHA256Helpers
 {
-public:
-    SHA256Processor() noexcept
-        : length (0)
+    static const uint32 constants[] =
     {
-        state[0] = 0x6a09e667;
-        state[1] = 0xbb67ae85;
-        state[2] = 0x3c6ef372;
-        state[3] = 0xa54ff53a;
-        state[4] = 0x510e527f;
-        state[5] = 0x9b05688c;
-        state[6] = 0x1f83d9ab;
-        state[7] = 0x5be0cd19;
-    }
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    static inline uint32 rotate (const uint32 x, const uint32 y) noexcept                { return (x >> y) | (x << (32 - y)); }
+    static inline uint32 ch  (const uint32 x, const uint32 y, const uint32 z) noexcept   { return z ^ ((y ^ z) & x); }
+    static inline uint32 maj (const uint32 x, const uint32 y, const uint32 z) noexcept   { return y ^ ((y ^ z) & (x ^ y)); }
+
+    static inline uint32 s0 (const uint32 x) noexcept     { return rotate (x, 7)  ^ rotate (x, 18) ^ (x >> 3); }
+    static inline uint32 s1 (const uint32 x) noexcept     { return rotate (x, 17) ^ rotate (x, 19) ^ (x >> 10); }
+    static inline uint32 S0 (const uint32 x) noexcept     { return rotate (x, 2)  ^ rotate (x, 13) ^ rotate (x, 22); }
+    static inline uint32 S1 (const uint32 x) noexcept     { return rotate (x, 6)  ^ rotate (x, 11) ^ rotate (x, 25); }
+
+    // Each of these processes a run of whole 64-byte blocks
+    typedef void (BlockFunction) (uint32* state, const uint8* data, size_t numBlocks);
 
-    // expects 64 bytes of data
-    void processFullBlock (const void* const data) noexcept
+    static void processBlocksGeneric (uint32* const state, const uint8* data, size_t numBlocks) noexcept
     {
-        const uint32 constants[] =
+        for (; numBlocks > 0; --numBlocks, data += 64)
         {
-            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-        };
-
-        uint32 block[16], s[8];
-        memcpy (s, state, sizeof (s));
-
-        for (int i = 0; i < 16; ++i)
-            block[i] = ByteOrder::bigEndianInt (addBytesToPointer (data, i * 4));
-
-        for (uint32 j = 0; j < 64; j += 16)
-        {
-            #define JUCE_SHA256(i) \
-                s[(7 - i) & 7] += S1 (s[(4 - i) & 7]) + ch (s[(4 - i) & 7], s[(5 - i) & 7], s[(6 - i) & 7]) + constants[i + j] \
-                                     + (j != 0 ? (block[i & 15] += s1 (block[(i - 2) & 15]) + block[(i - 7) & 15] + s0 (block[(i - 15) & 15])) \
-                                               : block[i]); \
-                s[(3 - i) & 7] += s[(7 - i) & 7]; \
-                s[(7 - i) & 7] += S0 (s[(0 - i) & 7]) + maj (s[(0 - i) & 7], s[(1 - i) & 7], s[(2 - i) & 7])
-
-            JUCE_SHA256(0);  JUCE_SHA256(1);  JUCE_SHA256(2);  JUCE_SHA256(3);  JUCE_SHA256(4);  JUCE_SHA256(5);  JUCE_SHA256(6);  JUCE_SHA256(7);
-            JUCE_SHA256(8);  JUCE_SHA256(9);  JUCE_SHA256(10); JUCE_SHA256(11); JUCE_SHA256(12); JUCE_SHA256(13); JUCE_SHA256(14); JUCE_SHA256(15);
-            #undef JUCE_SHA256
+            uint32 block[16], s[8];
+            memcpy (s, state, sizeof (s));
+
+            for (int i = 0; i < 16; ++i)
+                block[i] = ByteOrder::bigEndianInt (data + i * 4);
+
+            for (uint32 j = 0; j < 64; j += 16)
+            {
+                #define JUCE_SHA256(i) \
+                    s[(7 - i) & 7] += S1 (s[(4 - i) & 7]) + ch (s[(4 - i) & 7], s[(5 - i) & 7], s[(6 - i) & 7]) + constants[i + j] \
+                                         + (j != 0 ? (block[i & 15] += s1 (block[(i - 2) & 15]) + block[(i - 7) & 15] + s0 (block[(i - 15) & 15])) \
+                                                   : block[i]); \
+                    s[(3 - i) & 7] += s[(7 - i) & 7]; \
+                    s[(7 - i) & 7] += S0 (s[(0 - i) & 7]) + maj (s[(0 - i) & 7], s[(1 - i) & 7], s[(2 - i) & 7])
+
+                JUCE_SHA256(0);  JUCE_SHA256(1);  JUCE_SHA256(2);  JUCE_SHA256(3);  JUCE_SHA256(4);  JUCE_SHA256(5);  JUCE_SHA256(6);  JUCE_SHA256(7);
+                JUCE_SHA256(8);  JUCE_SHA256(9);  JUCE_SHA256(10); JUCE_SHA256(11); JUCE_SHA256(12); JUCE_SHA256(13); JUCE_SHA256(14); JUCE_SHA256(15);
+                #undef JUCE_SHA256
+            }
+
+            for (int i = 0; i < 8; ++i)
+                state[i] += s[i];
         }
+    }
+
+   #if JUCE_USE_SHA_INTRINSICS
+    // Uses the Intel SHA extensions, which keep the state as two registers holding
+    // the words in ABEF and CDGH order, and do two rounds per instruction.
+    JUCE_SHA_FUNCTION static void processBlocksIntel (uint32* const state, const uint8* data, size_t numBlocks) noexcept
+    {
+        const __m128i byteSwapMask = _mm_set_epi8 (12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
 
-        for (int i = 0; i < 8; ++i)
-            state[i] += s[i];
+        const __m128i dcba = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i*) state), 0xb1);
+        const __m128i hgfe = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i*) (state + 4)), 0x1b);
+        __m128i abef = _mm_alignr_epi8 (dcba, hgfe, 8);
+        __m128i cdgh = _mm_blend_epi16 (hgfe, dcba, 0xf0);
 
-        length += 64;
+        for (; numBlocks > 0; --numBlocks, data += 64)
+        {
+            const __m128i previousABEF = abef, previousCDGH = cdgh;
+
+            __m128i m0 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) data),        byteSwapMask);
+            __m128i m1 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (data + 16)), byteSwapMask);
+            __m128i m2 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (data + 32)), byteSwapMask);
+            __m128i m3 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (data + 48)), byteSwapMask);
+            __m128i k;
+
+            // does four rounds using the given message words
+            #define JUCE_SHA256_ROUNDS(index, m) \
+                k = _mm_add_epi32 (m, _mm_loadu_si128 ((const __m128i*) (constants + (index) * 4))); \
+                cdgh = _mm_sha256rnds2_epu32 (cdgh, abef, k); \
+                abef = _mm_sha256rnds2_epu32 (abef, cdgh, _mm_shuffle_epi32 (k, 0x0e));
+
+            // calculates the message words needed four rounds further on
+            #define JUCE_SHA256_SCHEDULE(m, previous, next) \
+                next = _mm_sha256msg2_epu32 (_mm_add_epi32 (next, _mm_alignr_epi8 (m, previous, 4)), m);
+
+            #define JUCE_SHA256_PREPARE(previous, m) \
+                previous = _mm_sha256msg1_epu32 (previous, m);
+
+            JUCE_SHA256_ROUNDS (0,  m0)
+            JUCE_SHA256_ROUNDS (1,  m1)  JUCE_SHA256_PREPARE (m0, m1)
+            JUCE_SHA256_ROUNDS (2,  m2)  JUCE_SHA256_PREPARE (m1, m2)
+            JUCE_SHA256_ROUNDS (3,  m3)  JUCE_SHA256_SCHEDULE (m3, m2, m0)  JUCE_SHA256_PREPARE (m2, m3)
+            JUCE_SHA256_ROUNDS (4,  m0)  JUCE_SHA256_SCHEDULE (m0, m3, m1)  JUCE_SHA256_PREPARE (m3, m0)
+            JUCE_SHA256_ROUNDS (5,  m1)  JUCE_SHA256_SCHEDULE (m1, m0, m2)  JUCE_SHA256_PREPARE (m0, m1)
+            JUCE_SHA256_ROUNDS (6,  m2)  JUCE_SHA256_SCHEDULE (m2, m1, m3)  JUCE_SHA256_PREPARE (m1, m2)
+            JUCE_SHA256_ROUNDS (7,  m3)  JUCE_SHA256_SCHEDULE (m3, m2, m0)  JUCE_SHA256_PREPARE (m2, m3)
+            JUCE_SHA256_ROUNDS (8,  m0)  JUCE_SHA256_SCHEDULE (m0, m3, m1)  JUCE_SHA256_PREPARE (m3, m0)
+            JUCE_SHA256_ROUNDS (9,  m1)  JUCE_SHA256_SCHEDULE (m1, m0, m2)  JUCE_SHA256_PREPARE (m0, m1)
+            JUCE_SHA256_ROUNDS (10, m2)  JUCE_SHA256_SCHEDULE (m2, m1, m3)  JUCE_SHA256_PREPARE (m1, m2)
+            JUCE_SHA256_ROUNDS (11, m3)  JUCE_SHA256_SCHEDULE (m3, m2, m0)  JUCE_SHA256_PREPARE (m2, m3)
+            JUCE_SHA256_ROUNDS (12, m0)  JUCE_SHA256_SCHEDULE (m0, m3, m1)  JUCE_SHA256_PREPARE (m3, m0)
+            JUCE_SHA256_ROUNDS (13, m1)  JUCE_SHA256_SCHEDULE (m1, m0, m2)
+            JUCE_SHA256_ROUNDS (14, m2)  JUCE_SHA256_SCHEDULE (m2, m1, m3)
+            JUCE_SHA256_ROUNDS (15, m3)
+
+            #undef JUCE_SHA256_ROUNDS
+            #undef JUCE_SHA256_SCHEDULE
+            #undef JUCE_SHA256_PREPARE
+
+            abef = _mm_add_epi32 (abef, previousABEF);
+            cdgh = _mm_add_epi32 (cdgh, previousCDGH);
+        }
+
+        const __m128i feba = _mm_shuffle_epi32 (abef, 0x1b);
+        const __m128i dchg = _mm_shuffle_epi32 (cdgh, 0xb1);
+        _mm_storeu_si128 ((__m128i*) state,       _mm_blend_epi16 (feba, dchg, 0xf0));
+        _mm_storeu_si128 ((__m128i*) (state + 4), _mm_alignr_epi8 (dchg, feba, 8));
     }
+   #endif
 
-    void processFinalBlock (const void* const data, unsigned int numBytes) noexcept
+   #if JUCE_USE_ARM_SHA_INTRINSICS
+    // Uses the ARMv8 cryptography extensions, which do four rounds per instruction pair.
+    static void processBlocksARM (uint32* const state, const uint8* data, size_t numBlocks) noexcept
     {
-        jassert (numBytes < 64);
+        uint32x4_t abcd = vld1q_u32 (state);
+        uint32x4_t efgh = vld1q_u32 (state + 4);
 
-        length += numBytes;
-        length *= 8; // (the length is stored as a count of bits, not bytes)
+        for (; numBlocks > 0; --numBlocks, data += 64)
+        {
+            const uint32x4_t previousABCD = abcd, previousEFGH = efgh;
+            uint32x4_t m[4];
 
-        uint8 finalBlocks[128];
+            for (int i = 0; i < 4; ++i)
+                m[i] = vreinterpretq_u32_u8 (vrev32q_u8 (vld1q_u8 (data + i * 16)));
 
-        memcpy (finalBlocks, data, numBytes);
-        finalBlocks [numBytes++] = 128; // append a '1' bit
+            for (int i = 0; i < 16; ++i)
+            {
+                const uint32x4_t k = vaddq_u32 (m[i & 3], vld1q_u32 (constants + i * 4));
 
-        while (numBytes != 56 && numBytes < 64 + 56)
-            finalBlocks [numBytes++] = 0; // pad with zeros..
+                if (i < 12)
+                    m[i & 3] = vsha256su1q_u32 (vsha256su0q_u32 (m[i & 3], m[(i + 1) & 3]), m[(i + 2) & 3], m[(i + 3) & 3]);
 
-        for (int i = 8; --i >= 0;)
-            finalBlocks [numBytes++] = (uint8) (length >> (i * 8)); // append the length.
+                const uint32x4_t oldABCD = abcd;
+                abcd = vsha256hq_u32 (abcd, efgh, k);
+                efgh = vsha256h2q_u32 (efgh, oldABCD, k);
+            }
 
-        jassert (numBytes == 64 || numBytes == 128);
+            abcd = vaddq_u32 (abcd, previousABCD);
+            efgh = vaddq_u32 (efgh, previousEFGH);
+        }
 
-        processFullBlock (finalBlocks);
+        vst1q_u32 (state, abcd);
+        vst1q_u32 (state + 4, efgh);
+    }
+   #endif
 
-        if (numBytes > 64)
-            processFullBlock (finalBlocks + 64);
+    static BlockFunction* findBestBlockFunction() noexcept
+    {
+       #if JUCE_USE_SHA_INTRINSICS
+        if (SystemStats::hasSHA())
+            return processBlocksIntel;
+       #endif
+
+       #if JUCE_USE_ARM_SHA_INTRINSICS
+        return processBlocksARM;
+       #else
+        return processBlocksGeneric;
+       #endif
     }
 
-    void copyResult (uint8* result) const noexcept
+    // (this is chosen on first use rather than during static initialisation, as it needs
+    // SystemStats, which may not have been initialised yet)
+    static void processBlocks (uint32* const state, const uint8* data, size_t numBlocks) noexcept
     {
-        for (int i = 0; i < 8; ++i)
-        {
-            *result++ = (uint8) (state[i] >> 24);
-            *result++ = (uint8) (state[i] >> 16);
-            *result++ = (uint8) (state[i] >> 8);
-            *result++ = (uint8) state[i];
-        }
+        static BlockFunction* const blockFunction = findBestBlockFunction();
+        blockFunction (state, data, numBlocks);
     }
+}
 
-    void processStream (InputStream& input, int64 numBytesToRead, uint8* const result)
+//==============================================================================
+SHA256::Generator::Generator() noexcept
+{
+    reset();
+}
+
+SHA256::Generator::~Generator() noexcept {}
+
+void SHA256::Generator::reset() noexcept
+{
+    state[0] = 0x6a09e667;
+    state[1] = 0xbb67ae85;
+    state[2] = 0x3c6ef372;
+    state[3] = 0xa54ff53a;
+    state[4] = 0x510e527f;
+    state[5] = 0x9b05688c;
+    state[6] = 0x1f83d9ab;
+    state[7] = 0x5be0cd19;
+
+    length = 0;
+    numBuffered = 0;
+}
+
+void SHA256::Generator::update (const void* const data, size_t numBytes) noexcept
+{
+    const uint8* source = static_cast <const uint8*> (data);
+    length += numBytes;
+
+    if (numBuffered > 0)
     {
-        if (numBytesToRead < 0)
-            numBytesToRead = std::numeric_limits<int64>::max();
+        const size_t numToCopy = jmin (numBytes, sizeof (buffer) - numBuffered);
+        memcpy (buffer + numBuffered, source, numToCopy);
+        numBuffered += numToCopy;
+        source += numToCopy;
+        numBytes -= numToCopy;
 
-        for (;;)
-        {
-            uint8 buffer [64];
-            const int bytesRead = input.read (buffer, (int) jmin (numBytesToRead, (int64) sizeof (buffer)));
+        if (numBuffered < sizeof (buffer))
+            return;
 
-            if (bytesRead < (int) sizeof (buffer))
-            {
-                processFinalBlock (buffer, (unsigned int) bytesRead);
-                break;
-            }
+        SHA256Helpers::processBlocks (state, buffer, 1);
+        numBuffered = 0;
+    }
 
-            numBytesToRead -= sizeof (buffer);
-            processFullBlock (buffer);
-        }
+    // whole blocks are hashed straight from the caller's data
+    const size_t numBlocks = numBytes / 64;
+    SHA256Helpers::processBlocks (state, source, numBlocks);
+
+    numBuffered = numBytes - numBlocks * 64;
+    memcpy (buffer, source + numBlocks * 64, numBuffered);
+}
+
+void SHA256::Generator::update (InputStream& input, int64 numBytesToRead)
+{
+    if (numBytesToRead < 0)
+        numBytesToRead = std::numeric_limits<int64>::max();
 
-        copyResult (result);
+    HeapBlock<uint8> tempBuffer ((size_t) jlimit ((int64) 64, (int64) 65536, numBytesToRead));
+
+    while (numBytesToRead > 0)
+    {
+        const int bytesRead = input.read (tempBuffer, (int) jmin (numBytesToRead, (int64) 65536));
+
+        if (bytesRead <= 0)
+            break;
+
+        numBytesToRead -= bytesRead;
+        update (tempBuffer, (size_t) bytesRead);
     }
+}
 
-private:
-    uint32 state[8];
-    uint64 length;
+SHA256 SHA256::Generator::getResult() noexcept
+{
+    const uint64 bitLength = length * 8;
 
-    static inline uint32 rotate (const uint32 x, const uint32 y) noexcept                { return (x >> y) | (x << (32 - y)); }
-    static inline uint32 ch  (const uint32 x, const uint32 y, const uint32 z) noexcept   { return z ^ ((y ^ z) & x); }
-    static inline uint32 maj (const uint32 x, const uint32 y, const uint32 z) noexcept   { return y ^ ((y ^ z) & (x ^ y)); }
+    uint8 padding[72] = { 128 }; // a '1' bit, then zeros up to 56 bytes into a block, then the length
+    const size_t numPaddingBytes = (numBuffered < 56 ? 56 : 120) - numBuffered;
 
-    static inline uint32 s0 (const uint32 x) noexcept     { return rotate (x, 7)  ^ rotate (x, 18) ^ (x >> 3); }
-    static inline uint32 s1 (const uint32 x) noexcept     { return rotate (x, 17) ^ rotate (x, 19) ^ (x >> 10); }
-    static inline uint32 S0 (const uint32 x) noexcept     { return rotate (x, 2)  ^ rotate (x, 13) ^ rotate (x, 22); }
-    static inline uint32 S1 (const uint32 x) noexcept     { return rotate (x, 6)  ^ rotate (x, 11) ^ rotate (x, 25); }
+    for (int i = 0; i < 8; ++i)
+        padding [numPaddingBytes + (size_t) i] = (uint8) (bitLength >> ((7 - i) * 8));
 
-    JUCE_DECLARE_NON_COPYABLE (SHA256Processor)
-};
+    update (padding, numPaddingBytes + 8);
+    jassert (numBuffered == 0);
+
+    SHA256 hash;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        hash.result [i * 4]     = (uint8) (state[i] >> 24);
+        hash.result [i * 4 + 1] = (uint8) (state[i] >> 16);
+        hash.result [i * 4 + 2] = (uint8) (state[i] >> 8);
+        hash.result [i * 4 + 3] = (uint8) state[i];
+    }
+
+    reset();
+    return hash;
+}
 
 //==============================================================================
 SHA256::SHA256() noexcept
@@ -177,18 +322,23 @@ SHA256& SHA256::operator= (const SHA256& other) noexcept
 
 SHA256::SHA256 (const MemoryBlock& data)
 {
-    process (data.getData(), data.getSize());
+    Generator generator;
+    generator.update (data.getData(), data.getSize());
+    *this = generator.getResult();
 }
 
 SHA256::SHA256 (const void* const data, const size_t numBytes)
 {
-    process (data, numBytes);
+    Generator generator;
+    generator.update (data, numBytes);
+    *this = generator.getResult();
 }
 
 SHA256::SHA256 (InputStream& input, const int64 numBytesToRead)
 {
-    SHA256Processor processor;
-    processor.processStream (input, numBytesToRead, result);
+    Generator generator;
+    generator.update (input, numBytesToRead);
+    *this = generator.getResult();
 }
 
 SHA256::SHA256 (const File& file)
@@ -197,8 +347,9 @@ SHA256::SHA256 (const File& file)
 
     if (fin.getStatus().wasOk())
     {
-        SHA256Processor processor;
-        processor.processStream (fin, -1, result);
+        Generator generator;
+        generator.update (fin);
+        *this = generator.getResult();
     }
     else
     {
@@ -209,14 +360,10 @@ SHA256::SHA256 (const File& file)
 SHA256::SHA256 (CharPointer_UTF8 utf8) noexcept
 {
     jassert (utf8.getAddress() != nullptr);
-    process (utf8.getAddress(), utf8.sizeInBytes() - 1);
-}
 
-void SHA256::process (const void* const data, size_t numBytes)
-{
-    MemoryInputStream m (data, numBytes, false);
-    SHA256Processor processor;
-    processor.processStream (m, -1, result);
+    Generator generator;
+    generator.update (utf8.getAddress(), utf8.sizeInBytes() - 1);
+    *this = generator.getResult();
 }
 
 MemoryBlock SHA256::getRawData() const
@@ -232,6 +379,69 @@ String SHA256::toHexString() const
 bool SHA256::operator== (const SHA256& other) const noexcept  { return memcmp (result, other.result, sizeof (result)) == 0; }
 bool SHA256::operator!= (const SHA256& other) const noexcept  { return ! operator== (other); }
 
+//==============================================================================
+struct SHA256FileHasher
+{
+    SHA256FileHasher (const Array<File>& files_, Array<SHA256>& results_)
+        : files (files_), results (results_), nextIndex (0)
+    {
+    }
+
+    static void hashFiles (void* userData)
+    {
+        SHA256FileHasher& hasher = *static_cast <SHA256FileHasher*> (userData);
+
+        for (;;)
+        {
+            const int index = ++hasher.nextIndex - 1;
+
+            if (index >= hasher.files.size())
+                break;
+
+            hasher.results.getReference (index) = SHA256 (hasher.files.getReference (index));
+        }
+
+        if (--hasher.numThreadsRunning == 0)
+            hasher.finished.signal();
+    }
+
+    const Array<File>& files;
+    Array<SHA256>& results;
+    Atomic<int> nextIndex, numThreadsRunning;
+    WaitableEvent finished;
+
+    JUCE_DECLARE_NON_COPYABLE (SHA256FileHasher)
+};
+
+Array<SHA256> SHA256::fromFiles (const Array<File>& files, int numThreads)
+{
+    Array<SHA256> results;
+    results.insertMultiple (0, SHA256(), files.size());
+
+    numThreads = jmin (numThreads, files.size());
+
+    if (numThreads > 1)
+    {
+        // each thread keeps taking the next file from the list, so slow files don't hold up the others
+        SHA256FileHasher hasher (files, results);
+        hasher.numThreadsRunning = numThreads;
+
+        ThreadPool pool (numThreads);
+
+        for (int i = 0; i < numThreads; ++i)
+            pool.addJob (&SHA256FileHasher::hashFiles, &hasher);
+
+        hasher.finished.wait();
+    }
+    else
+    {
+        for (int i = 0; i < files.size(); ++i)
+            results.getReference (i) = SHA256 (files.getReference (i));
+    }
+
+    return results;
+}
+
 
 //==============================================================================
 #if JUCE_UNIT_TESTS
@@ -262,6 +472,84 @@ public:
             SHA256 sha (n, sizeof (n) - 1);
             expectEquals (sha.toHexString(), String ("ef537f25c895bfa782526529a9b63d97aa631564d5d789c2b765448c8635fb6c"));
         }
+
+        {
+            const char n[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+            SHA256 sha (n, sizeof (n) - 1);
+            expectEquals (sha.toHexString(), String ("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+        }
+
+        Random r;
+        MemoryBlock data (5000);
+
+        for (size_t i = 0; i < data.getSize(); ++i)
+            data[i] = (char) r.nextInt (256);
+
+        beginTest ("Incremental hashing");
+
+        for (int i = 0; i < 20; ++i)
+        {
+            const size_t size = (size_t) r.nextInt ((int) data.getSize());
+            const SHA256 expected (data.getData(), size);
+
+            SHA256::Generator generator;
+
+            for (size_t pos = 0; pos < size;)
+            {
+                const size_t chunk = jmin (size - pos, (size_t) r.nextInt (150));
+                generator.update (addBytesToPointer (data.getData(), pos), chunk);
+                pos += chunk;
+            }
+
+            expect (generator.getResult() == expected);
+
+            // (the generator is reset after returning a result)
+            generator.update (data.getData(), size);
+            expect (generator.getResult() == expected);
+        }
+
+        beginTest ("Block functions");
+
+        for (int i = 0; i < 10; ++i)
+        {
+            const size_t numBlocks = (size_t) r.nextInt (70);
+            uint32 generic[8], best[8];
+
+            for (int j = 0; j < 8; ++j)
+                generic[j] = best[j] = (uint32) r.nextInt();
+
+            SHA256Helpers::processBlocksGeneric (generic, static_cast <const uint8*> (data.getData()), numBlocks);
+            SHA256Helpers::processBlocks (best, static_cast <const uint8*> (data.getData()), numBlocks);
+            expect (memcmp (generic, best, sizeof (generic)) == 0);
+        }
+
+        beginTest ("Hashing files");
+
+        const File folder (File::getSpecialLocation (File::tempDirectory)
+                             .getNonexistentChildFile ("SHA256Tests", String::empty, false));
+        folder.createDirectory();
+
+        Array<File> files;
+
+        for (int i = 0; i < 30; ++i)
+        {
+            const File f (folder.getChildFile ("file" + String (i)));
+            f.replaceWithData (data.getData(), (size_t) (i + 1) * 150);
+            files.add (f);
+        }
+
+        files.add (folder.getChildFile ("missing"));
+
+        const Array<SHA256> hashes (SHA256::fromFiles (files, 4));
+        expectEquals (hashes.size(), files.size());
+
+        for (int i = 0; i < 30; ++i)
+            expect (hashes[i] == SHA256 (data.getData(), (size_t) (i + 1) * 150));
+
+        expect (hashes.getLast() == SHA256());
+        expect (SHA256::fromFiles (files, 1) == hashes);
+
+        folder.deleteRecursively();
     }
 };
 
@@ -84,6 +84,16 @@ public:
     */
     explicit SHA256 (CharPointer_UTF8 utf8Text) noexcept;
 
+    //==============================================================================
+    /** Calculates the hashes of a list of files, using several threads.
+
+        When there are lots of small files to hash, this is much quicker than creating
+        them one at a time. The results are returned in the same order as the files,
+        and any file that can't be opened gets a null hash, as with the File constructor.
+    */
+    static Array<SHA256> fromFiles (const Array<File>& files,
+                                    int numThreads = SystemStats::getNumCpus());
+
     //==============================================================================
     /** Returns the hash as a 32-byte block of data. */
     MemoryBlock getRawData() const;
@@ -95,11 +105,53 @@ public:
     bool operator== (const SHA256&) const noexcept;
     bool operator!= (const SHA256&) const noexcept;
 
+    //==============================================================================
+    /**
+        Calculates a SHA-256 hash incrementally, from data that arrives in pieces.
+
+        Feed it the data with as many calls to update() as you need, and then call
+        getResult() to get the hash of everything that was passed in.
+    */
+    class JUCE_API  Generator
+    {
+    public:
+        /** Creates a generator, ready to be given some data. */
+        Generator() noexcept;
+
+        /** Destructor. */
+        ~Generator() noexcept;
+
+        /** Adds a block of data to the hash. */
+        void update (const void* data, size_t numBytes) noexcept;
+
+        /** Adds the contents of a stream to the hash.
+
+            This will read from the stream until the stream is exhausted, or until
+            maxBytesToRead bytes have been read. If maxBytesToRead is negative, the entire
+            stream will be read.
+        */
+        void update (InputStream& input, int64 maxBytesToRead = -1);
+
+        /** Returns the hash of all the data that has been added.
+            This also resets the generator, so it can be re-used for some new data.
+        */
+        SHA256 getResult() noexcept;
+
+        /** Discards any data that has been added, and starts again. */
+        void reset() noexcept;
+
+    private:
+        uint32 state [8];
+        uint64 length;
+        uint8 buffer [64];
+        size_t numBuffered;
+
+        JUCE_DECLARE_NON_COPYABLE (Generator)
+    };
 
 private:
     //==============================================================================
     uint8 result [32];
-    void process (const void*, size_t);
 
     JUCE_LEAK_DETECTOR (SHA256)
 };
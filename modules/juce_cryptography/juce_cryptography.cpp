@@ -38,10 +38,55 @@
 
 #include "juce_cryptography.h"
 
+#if JUCE_INTEL && ((JUCE_MSVC && _MSC_VER >= 1900) \
+                    || (JUCE_GCC && ! JUCE_CLANG && (__GNUC__ * 100 + __GNUC_MINOR__) >= 409) \
+                    || (JUCE_CLANG && ! (JUCE_MAC || JUCE_IOS) && (__clang_major__ * 100 + __clang_minor__) >= 308))
+ #ifndef JUCE_USE_SHA_INTRINSICS
+  #define JUCE_USE_SHA_INTRINSICS 1
+ #endif
+
+ #ifndef JUCE_USE_AES_INTRINSICS
+  #define JUCE_USE_AES_INTRINSICS 1
+ #endif
+#endif
+
+#if JUCE_USE_SHA_INTRINSICS || JUCE_USE_AES_INTRINSICS
+ #include <immintrin.h>
+
+ // The SHA and AES code is compiled for those instruction sets on a per-function basis, and
+ // is only called after checking SystemStats::hasSHA() or SystemStats::hasAES().
+ #if JUCE_MSVC
+  #define JUCE_SHA_FUNCTION
+  #define JUCE_AES_FUNCTION
+ #else
+  #define JUCE_SHA_FUNCTION __attribute__ ((target ("sha,sse4.1")))
+  #define JUCE_AES_FUNCTION __attribute__ ((target ("aes,pclmul,sse4.1")))
+ #endif
+#endif
+
+#ifndef JUCE_USE_ARM_SHA_INTRINSICS
+ #if defined (__ARM_FEATURE_CRYPTO) || defined (__ARM_FEATURE_SHA2)
+  #define JUCE_USE_ARM_SHA_INTRINSICS 1
+ #endif
+#endif
+
+#ifndef JUCE_USE_ARM_AES_INTRINSICS
+ #if defined (__ARM_FEATURE_CRYPTO) || defined (__ARM_FEATURE_AES)
+  #define JUCE_USE_ARM_AES_INTRINSICS 1
+ #endif
+#endif
+
+#if JUCE_USE_ARM_SHA_INTRINSICS || JUCE_USE_ARM_AES_INTRINSICS
+ #include <arm_neon.h>
+#endif
+
 namespace juce
 {
 
 // START_AUTOINCLUDE encryption/*.cpp, hashing/*.cpp
+#include "encryption/juce_AES.cpp"
+#include "encryption/juce_AESDecryptingInputStream.cpp"
+#include "encryption/juce_AESEncryptingOutputStream.cpp"
 #include "encryption/juce_BlowFish.cpp"
 #include "encryption/juce_Primes.cpp"
 #include "encryption/juce_RSAKey.cpp"
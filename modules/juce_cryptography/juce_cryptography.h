@@ -33,6 +33,15 @@ namespace juce
 {
 
 // START_AUTOINCLUDE encryption, hashing
+#ifndef __JUCE_AES_JUCEHEADER__
+ #include "encryption/juce_AES.h"
+#endif
+#ifndef __JUCE_AESDECRYPTINGINPUTSTREAM_JUCEHEADER__
+ #include "encryption/juce_AESDecryptingInputStream.h"
+#endif
+#ifndef __JUCE_AESENCRYPTINGOUTPUTSTREAM_JUCEHEADER__
+ #include "encryption/juce_AESEncryptingOutputStream.h"
+#endif
 #ifndef __JUCE_BLOWFISH_JUCEHEADER__
  #include "encryption/juce_BlowFish.h"
 #endif
@@ -40,6 +40,7 @@ PropertiesFile::Options::Options()
       ignoreCaseOfKeyNames (false),
       millisecondsBeforeSaving (3000),
       storageFormat (PropertiesFile::storeAsXML),
+      saveInBackground (false),
       processLock (nullptr)
 {
 }
@@ -102,11 +103,112 @@ File PropertiesFile::Options::getDefaultFile() const
 }
 
 
+//==============================================================================
+/*  Writes snapshots of the properties to disk on a background thread. If several saves
+    are requested while a write is in progress, only the most recent one gets written.
+*/
+class PropertiesFile::BackgroundWriter  : private Thread
+{
+public:
+    BackgroundWriter (PropertiesFile& owner_)
+        : Thread ("PropertiesFile writer"),
+          owner (owner_), isWriting (false)
+    {
+    }
+
+    ~BackgroundWriter()
+    {
+        waitUntilFinished (-1);
+        stopThread (4000);
+    }
+
+    void write (const StringPairArray& values)
+    {
+        {
+            const ScopedLock sl (lock);
+            pendingValues = new StringPairArray (values);
+        }
+
+        if (! isThreadRunning())
+            startThread (3);
+
+        notify();
+    }
+
+    bool waitUntilFinished (const int timeOutMilliseconds)
+    {
+        const uint32 startTime = Time::getMillisecondCounter();
+
+        for (;;)
+        {
+            {
+                const ScopedLock sl (lock);
+
+                if (pendingValues == nullptr && ! isWriting)
+                    return true;
+            }
+
+            int timeToWait = -1;
+
+            if (timeOutMilliseconds >= 0)
+            {
+                timeToWait = timeOutMilliseconds - (int) (Time::getMillisecondCounter() - startTime);
+
+                if (timeToWait <= 0)
+                    return false;
+            }
+
+            finished.wait (timeToWait);
+        }
+    }
+
+    void run()
+    {
+        while (! threadShouldExit())
+        {
+            ScopedPointer<StringPairArray> values;
+
+            {
+                const ScopedLock sl (lock);
+                values = pendingValues.release();
+                isWriting = (values != nullptr);
+            }
+
+            if (values == nullptr)
+            {
+                finished.signal();
+                wait (-1);
+                continue;
+            }
+
+            if (! owner.writeToFile (*values))
+                owner.setNeedsToBeSaved (true); // (so that the next saveIfNeeded() will try again)
+
+            {
+                const ScopedLock sl (lock);
+                isWriting = false;
+            }
+
+            finished.signal();
+        }
+    }
+
+private:
+    PropertiesFile& owner;
+    CriticalSection lock;
+    ScopedPointer<StringPairArray> pendingValues;
+    bool isWriting;
+    WaitableEvent finished;
+
+    JUCE_DECLARE_NON_COPYABLE (BackgroundWriter)
+};
+
 //==============================================================================
 PropertiesFile::PropertiesFile (const File& f, const Options& o)
     : PropertySet (o.ignoreCaseOfKeyNames),
       file (f), options (o),
-      loadedOk (false), needsWriting (false)
+      loadedOk (false), needsWriting (false),
+      lastWrittenDataHash (0)
 {
     reload();
 }
@@ -114,25 +216,45 @@ PropertiesFile::PropertiesFile (const File& f, const Options& o)
 PropertiesFile::PropertiesFile (const Options& o)
     : PropertySet (o.ignoreCaseOfKeyNames),
       file (o.getDefaultFile()), options (o),
-      loadedOk (false), needsWriting (false)
+      loadedOk (false), needsWriting (false),
+      lastWrittenDataHash (0)
 {
     reload();
 }
 
 bool PropertiesFile::reload()
 {
+    // make sure we don't read back a half-finished save..
+    waitForBackgroundSave (-1);
+
     ProcessScopedLock pl (createProcessLock());
 
     if (pl != nullptr && ! pl->isLocked())
         return false; // locking failure..
 
-    loadedOk = (! file.exists()) || loadAsBinary() || loadAsXml();
+    if (! file.exists())
+    {
+        loadedOk = true;
+        return true;
+    }
+
+    MemoryBlock data;
+    loadedOk = file.loadFileAsData (data) && (loadAsBinary (data) || loadAsXml (data));
+
+    if (loadedOk)
+    {
+        // if the same values get saved again, there's no need to rewrite the file
+        const ScopedLock sl (writeLock);
+        lastWrittenDataHash = getDataHash (data);
+    }
+
     return loadedOk;
 }
 
 PropertiesFile::~PropertiesFile()
 {
     saveIfNeeded();
+    backgroundWriter = nullptr;
 }
 
 InterProcessLock::ScopedLockType* PropertiesFile::createProcessLock() const
@@ -164,20 +286,96 @@ bool PropertiesFile::save()
 
     stopTimer();
 
-    if (file == File::nonexistent
-         || file.isDirectory()
-         || ! file.getParentDirectory().createDirectory())
+    if (file == File::nonexistent)
         return false;
 
+    if (options.saveInBackground)
+    {
+        if (backgroundWriter == nullptr)
+            backgroundWriter = new BackgroundWriter (*this);
+
+        // (copying the values is cheap, because the strings are reference-counted)
+        backgroundWriter->write (getAllProperties());
+        needsWriting = false;
+        return true;
+    }
+
+    if (writeToFile (getAllProperties()))
+    {
+        needsWriting = false;
+        return true;
+    }
+
+    return false;
+}
+
+bool PropertiesFile::waitForBackgroundSave (const int timeOutMilliseconds)
+{
+    return backgroundWriter == nullptr
+            || backgroundWriter->waitUntilFinished (timeOutMilliseconds);
+}
+
+//==============================================================================
+int64 PropertiesFile::getDataHash (const MemoryBlock& data) noexcept
+{
+    // (FNV-1a)
+    const uint8* const bytes = static_cast <const uint8*> (data.getData());
+    uint64 hash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < data.getSize(); ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+
+    return (int64) hash;
+}
+
+bool PropertiesFile::writeToFile (const StringPairArray& values)
+{
+    // This is called on the writer thread when saving in the background, so it mustn't
+    // touch anything apart from the values it's given and the file itself.
+    MemoryOutputStream data;
+
     if (options.storageFormat == storeAsXML)
-        return saveAsXml();
+        writeAsXml (values, data);
+    else
+        writeAsBinary (values, data);
+
+    const ScopedLock sl (writeLock);
+    const int64 hash = getDataHash (data.getMemoryBlock());
+
+    if (hash == lastWrittenDataHash && file.existsAsFile())
+        return true; // nothing has changed since the last time the file was written
+
+    if (file.isDirectory() || ! file.getParentDirectory().createDirectory())
+        return false;
 
-    return saveAsBinary();
+    ProcessScopedLock pl (createProcessLock());
+
+    if (pl != nullptr && ! pl->isLocked())
+        return false; // locking failure..
+
+    // writing to a temporary file and renaming it means that the file can never
+    // be left half-written
+    TemporaryFile tempFile (file);
+
+    {
+        FileOutputStream out (tempFile.getFile());
+
+        if (! (out.openedOk() && out.write (data.getData(), data.getDataSize())))
+            return false;
+    }
+
+    if (tempFile.overwriteTargetFileWithTemporary())
+    {
+        lastWrittenDataHash = hash;
+        return true;
+    }
+
+    return false;
 }
 
-bool PropertiesFile::loadAsXml()
+bool PropertiesFile::loadAsXml (const MemoryBlock& data)
 {
-    XmlDocument parser (file);
+    XmlDocument parser (String::createStringFromData (data.getData(), (int) data.getSize()));
     ScopedPointer<XmlElement> doc (parser.getDocumentElement (true));
 
     if (doc != nullptr && doc->hasTagName (PropertyFileConstants::fileTag))
@@ -213,54 +411,43 @@ bool PropertiesFile::loadAsXml()
     return false;
 }
 
-bool PropertiesFile::saveAsXml()
+void PropertiesFile::writeAsXml (const StringPairArray& values, OutputStream& out) const
 {
     XmlElement doc (PropertyFileConstants::fileTag);
 
-    for (int i = 0; i < getAllProperties().size(); ++i)
+    for (int i = 0; i < values.size(); ++i)
     {
         XmlElement* const e = doc.createNewChildElement (PropertyFileConstants::valueTag);
-        e->setAttribute (PropertyFileConstants::nameAttribute, getAllProperties().getAllKeys() [i]);
+        e->setAttribute (PropertyFileConstants::nameAttribute, values.getAllKeys() [i]);
 
         // if the value seems to contain xml, store it as such..
-        if (XmlElement* const childElement = XmlDocument::parse (getAllProperties().getAllValues() [i]))
+        if (XmlElement* const childElement = XmlDocument::parse (values.getAllValues() [i]))
             e->addChildElement (childElement);
         else
             e->setAttribute (PropertyFileConstants::valueAttribute,
-                             getAllProperties().getAllValues() [i]);
-    }
-
-    ProcessScopedLock pl (createProcessLock());
-
-    if (pl != nullptr && ! pl->isLocked())
-        return false; // locking failure..
-
-    if (doc.writeToFile (file, String::empty))
-    {
-        needsWriting = false;
-        return true;
+                             values.getAllValues() [i]);
     }
 
-    return false;
+    doc.writeToStream (out, String::empty);
 }
 
-bool PropertiesFile::loadAsBinary()
+bool PropertiesFile::loadAsBinary (const MemoryBlock& data)
 {
-    FileInputStream fileStream (file);
+    MemoryInputStream stream (data, false);
 
-    if (fileStream.openedOk())
+    if (data.getSize() >= 4)
     {
-        const int magicNumber = fileStream.readInt();
+        const int magicNumber = stream.readInt();
 
         if (magicNumber == PropertyFileConstants::magicNumberCompressed)
         {
-            SubregionStream subStream (&fileStream, 4, -1, false);
+            SubregionStream subStream (&stream, 4, -1, false);
             GZIPDecompressorInputStream gzip (subStream);
             return loadAsBinary (gzip);
         }
         else if (magicNumber == PropertyFileConstants::magicNumber)
         {
-            return loadAsBinary (fileStream);
+            return loadAsBinary (stream);
         }
     }
 
@@ -286,53 +473,35 @@ bool PropertiesFile::loadAsBinary (InputStream& input)
     return true;
 }
 
-bool PropertiesFile::saveAsBinary()
+void PropertiesFile::writeAsBinary (const StringPairArray& values, OutputStream& output) const
 {
-    ProcessScopedLock pl (createProcessLock());
-
-    if (pl != nullptr && ! pl->isLocked())
-        return false; // locking failure..
+    OutputStream* out = &output;
+    ScopedPointer<GZIPCompressorOutputStream> gzip;
 
-    TemporaryFile tempFile (file);
-    ScopedPointer <OutputStream> out (tempFile.getFile().createOutputStream());
-
-    if (out != nullptr)
+    if (options.storageFormat == storeAsCompressedBinary)
     {
-        if (options.storageFormat == storeAsCompressedBinary)
-        {
-            out->writeInt (PropertyFileConstants::magicNumberCompressed);
-            out->flush();
+        output.writeInt (PropertyFileConstants::magicNumberCompressed);
 
-            out = new GZIPCompressorOutputStream (out.release(), 9, true);
-        }
-        else
-        {
-            // have you set up the storage option flags correctly?
-            jassert (options.storageFormat == storeAsBinary);
+        gzip = new GZIPCompressorOutputStream (&output, 9, false);
+        out = gzip;
+    }
+    else
+    {
+        // have you set up the storage option flags correctly?
+        jassert (options.storageFormat == storeAsBinary);
 
-            out->writeInt (PropertyFileConstants::magicNumber);
-        }
+        output.writeInt (PropertyFileConstants::magicNumber);
+    }
 
-        const int numProperties = getAllProperties().size();
+    const int numProperties = values.size();
 
-        out->writeInt (numProperties);
+    out->writeInt (numProperties);
 
-        for (int i = 0; i < numProperties; ++i)
-        {
-            out->writeString (getAllProperties().getAllKeys() [i]);
-            out->writeString (getAllProperties().getAllValues() [i]);
-        }
-
-        out = nullptr;
-
-        if (tempFile.overwriteTargetFileWithTemporary())
-        {
-            needsWriting = false;
-            return true;
-        }
+    for (int i = 0; i < numProperties; ++i)
+    {
+        out->writeString (values.getAllKeys() [i]);
+        out->writeString (values.getAllValues() [i]);
     }
-
-    return false;
 }
 
 void PropertiesFile::timerCallback()
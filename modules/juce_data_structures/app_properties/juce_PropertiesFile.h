@@ -34,7 +34,8 @@
     the interfaces that read and write values.
 
     Not designed for very large amounts of data, as it keeps all the values in
-    memory and writes them out to disk lazily when they are changed.
+    memory and writes them out to disk lazily when they are changed. If the data that
+    would be written is identical to what's already in the file, the file isn't touched.
 
     Because this class derives from ChangeBroadcaster, ChangeListeners can be registered
     with it, and these will be signalled when a value changes.
@@ -123,6 +124,15 @@ public:
         */
         StorageFormat storageFormat;
 
+        /** If true, save() doesn't write the file itself, but takes a copy of the values and
+            writes them on a background thread, so that a slow disk can't hold up the caller.
+            (The file is always written to a temporary file which then replaces the old one, so
+            it can never be left half-written). You can use waitForBackgroundSave() if you need
+            to make sure that the file has actually been written.
+            The default constructor initialises this value to false.
+        */
+        bool saveInBackground;
+
         /** An optional InterprocessLock object that will be used to prevent multiple threads or
             processes from writing to the file at the same time. The PropertiesFile will keep a
             pointer to this object but will not take ownership of it - the caller is responsible for
@@ -193,12 +203,21 @@ public:
         anything has changed since the last save.
 
         Returns false if it fails to write to the file for some reason (maybe because
-        it's read-only or the directory doesn't exist or something).
+        it's read-only or the directory doesn't exist or something). If the
+        Options::saveInBackground flag is set, this just starts the write and returns true -
+        if the write fails, the file will be flagged as needing to be saved again.
 
         @see saveIfNeeded
     */
     bool save();
 
+    /** If the file is being written on a background thread, this waits for it to finish.
+        Returns false if the timeout expired before it finished. A negative timeout will
+        wait forever.
+        @see Options::saveInBackground
+    */
+    bool waitForBackgroundSave (int timeOutMilliseconds);
+
     /** Returns true if the properties have been altered since the last time they were saved.
         The file is flagged as needing to be saved when you change a value, but you can
         explicitly set this flag with setNeedsToBeSaved().
@@ -228,15 +247,23 @@ private:
     Options options;
     bool loadedOk, needsWriting;
 
+    class BackgroundWriter;
+    friend class BackgroundWriter;
+    ScopedPointer<BackgroundWriter> backgroundWriter;
+    CriticalSection writeLock;
+    int64 lastWrittenDataHash;
+
     typedef const ScopedPointer<InterProcessLock::ScopedLockType> ProcessScopedLock;
     InterProcessLock::ScopedLockType* createProcessLock() const;
 
     void timerCallback();
-    bool saveAsXml();
-    bool saveAsBinary();
-    bool loadAsXml();
-    bool loadAsBinary();
+    bool writeToFile (const StringPairArray&);
+    void writeAsXml (const StringPairArray&, OutputStream&) const;
+    void writeAsBinary (const StringPairArray&, OutputStream&) const;
+    bool loadAsXml (const MemoryBlock&);
+    bool loadAsBinary (const MemoryBlock&);
     bool loadAsBinary (InputStream&);
+    static int64 getDataHash (const MemoryBlock&) noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PropertiesFile)
 };
@@ -42,6 +42,7 @@ namespace juce
 {
 
 // START_AUTOINCLUDE values/*.cpp, undomanager/*.cpp, app_properties/*.cpp
+#include "values/juce_AtomicValueSource.cpp"
 #include "values/juce_Value.cpp"
 #include "values/juce_ValueTree.cpp"
 #include "undomanager/juce_UndoManager.cpp"
@@ -33,6 +33,9 @@ namespace juce
 {
 
 // START_AUTOINCLUDE values, undomanager, app_properties
+#ifndef __JUCE_ATOMICVALUESOURCE_JUCEHEADER__
+ #include "values/juce_AtomicValueSource.h"
+#endif
 #ifndef __JUCE_VALUE_JUCEHEADER__
  #include "values/juce_Value.h"
 #endif
@@ -27,13 +27,50 @@ struct UndoManager::ActionSet
 {
     ActionSet (const String& transactionName)
         : name (transactionName),
-          time (Time::getCurrentTime())
+          time (Time::getCurrentTime()),
+          totalSize (0)
     {}
 
     OwnedArray <UndoableAction> actions;
     String name;
     Time time;
 
+    void add (UndoableAction* const action)
+    {
+        const int size = action->getSizeInUnits();
+        actions.add (action);
+        actionSizes.add (size);
+        totalSize += size;
+    }
+
+    /* Tries to merge a new action into one of the recent ones. It can be merged into an
+       earlier action as long as it's independent of all the actions after that one.
+    */
+    bool coalesce (UndoableAction* const newAction)
+    {
+        const int maxActionsToSearch = 16;  // (keeps this quick when a transaction has lots of actions)
+        const int lastIndexToSearch = jmax (0, actions.size() - maxActionsToSearch);
+
+        for (int i = actions.size(); --i >= lastIndexToSearch;)
+        {
+            UndoableAction* const action = actions.getUnchecked (i);
+
+            if (UndoableAction* const coalescedAction = action->createCoalescedAction (newAction))
+            {
+                const int size = coalescedAction->getSizeInUnits();
+                totalSize += size - actionSizes.getUnchecked (i);
+                actionSizes.set (i, size);
+                actions.set (i, coalescedAction, true);
+                return true;
+            }
+
+            if (! newAction->isIndependentOf (action))
+                break;
+        }
+
+        return false;
+    }
+
     bool perform() const
     {
         for (int i = 0; i < actions.size(); ++i)
@@ -52,15 +89,16 @@ struct UndoManager::ActionSet
         return true;
     }
 
-    int getTotalSize() const
+    // (the sizes are remembered as the actions are added, so that the total that the
+    // UndoManager keeps stays consistent, even if an action's size changes later)
+    int getTotalSize() const noexcept
     {
-        int total = 0;
-
-        for (int i = actions.size(); --i >= 0;)
-            total += actions.getUnchecked(i)->getSizeInUnits();
-
-        return total;
+        return totalSize;
     }
+
+private:
+    Array<int> actionSizes;
+    int totalSize;
 };
 
 //==============================================================================
@@ -121,27 +159,19 @@ bool UndoManager::perform (UndoableAction* const newAction, const String& action
         {
             ActionSet* actionSet = getCurrentSet();
 
-            if (actionSet != nullptr && ! newTransaction)
-            {
-                if (UndoableAction* const lastAction = actionSet->actions.getLast())
-                {
-                    if (UndoableAction* const coalescedAction = lastAction->createCoalescedAction (action))
-                    {
-                        action = coalescedAction;
-                        totalUnitsStored -= lastAction->getSizeInUnits();
-                        actionSet->actions.removeLast();
-                    }
-                }
-            }
-            else
+            if (actionSet == nullptr || newTransaction)
             {
                 actionSet = new ActionSet (currentTransactionName);
                 transactions.insert (nextIndex, actionSet);
                 ++nextIndex;
             }
 
-            totalUnitsStored += action->getSizeInUnits();
-            actionSet->actions.add (action.release());
+            const int oldSize = actionSet->getTotalSize();
+
+            if (! actionSet->coalesce (action))
+                actionSet->add (action.release());
+
+            totalUnitsStored += actionSet->getTotalSize() - oldSize;
             newTransaction = false;
 
             clearFutureTransactions();
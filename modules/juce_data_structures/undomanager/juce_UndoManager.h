@@ -44,6 +44,11 @@
     together - all actions performed between calls to beginNewTransaction() are
     grouped together and are all undone/redone as a group.
 
+    When an action is performed, the manager tries to merge it with one of the recent actions
+    in the same transaction, using UndoableAction::createCoalescedAction(). It looks back past
+    any actions that are independent of the new one (see UndoableAction::isIndependentOf()),
+    so e.g. a drag that produces thousands of small changes only takes up a few actions.
+
     The UndoManager is a ChangeBroadcaster, so listeners can register to be told
     when actions are performed or undone.
 
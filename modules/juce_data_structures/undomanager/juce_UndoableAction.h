@@ -78,8 +78,9 @@ public:
         to work out how much space each one will take up, so that the UndoManager
         can work out how many to keep.
 
-        The default value returned here is 10 - units are arbitrary and
-        don't have to be accurate.
+        The default value returned here is 10. The units are arbitrary and don't have to be
+        accurate, but if you return a rough number of bytes (as the built-in actions do),
+        then UndoManager::setMaxNumberOfStoredUnits() works as a memory budget.
 
         @see UndoManager::getNumberOfUnitsTakenUpByStoredCommands,
              UndoManager::setMaxNumberOfStoredUnits
@@ -94,6 +95,19 @@ public:
         If it's not possible to merge the two actions, the method should return zero.
     */
     virtual UndoableAction* createCoalescedAction (UndoableAction* nextAction)  { (void) nextAction; return nullptr; }
+
+    /** Returns true if this action and another one change completely separate things, so that
+        it makes no difference which order they're performed or undone in.
+
+        The UndoManager uses this to coalesce actions that aren't next to each other: a new action
+        can be merged (using createCoalescedAction()) with one of the recent actions in the same
+        transaction, as long as it's independent of all the actions that came after that one.
+        E.g. if a drag changes two different properties each time the mouse moves, this lets all
+        the changes to each property be merged into one action.
+
+        The default implementation returns false, which is always safe.
+    */
+    virtual bool isIndependentOf (UndoableAction* otherAction)  { (void) otherAction; return false; }
 };
 
 
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+AtomicValueSource::AtomicValueSource (const double initialValue)
+    : currentValue (initialValue)
+{
+}
+
+AtomicValueSource::~AtomicValueSource()
+{
+    cancelPendingUpdate();
+}
+
+void AtomicValueSource::set (const double newValue)
+{
+    if (currentValue.exchange (newValue) != newValue)
+    {
+        ++changeCount;
+        triggerAsyncUpdate();
+    }
+}
+
+var AtomicValueSource::getValue() const
+{
+    return get();
+}
+
+void AtomicValueSource::setValue (const var& newValue)
+{
+    set ((double) newValue);
+}
+
+void AtomicValueSource::handleAsyncUpdate()
+{
+    sendChangeMessage (true);
+}
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ATOMICVALUESOURCE_JUCEHEADER__
+#define __JUCE_ATOMICVALUESOURCE_JUCEHEADER__
+
+#include "juce_Value.h"
+
+//==============================================================================
+/**
+    A ValueSource holding a number that can be read and written from a real-time
+    thread, such as an audio callback.
+
+    A normal Value can only safely be used on the message thread, so this class lets
+    you use the same piece of data for both a Value that's attached to a Slider or
+    Button, and a parameter that your audio code reads directly, without needing
+    to keep a separate copy of it in sync.
+
+    The number is stored atomically, so get() is wait-free and can be called on
+    any thread. set() can also be called on any thread: it updates the value immediately,
+    and the Value's listeners get told about the change later on the message thread.
+    If the value changes many times before the listeners are called, they'll
+    only get one callback.
+
+    E.g.
+    @code
+    AtomicValueSource* gain = new AtomicValueSource (1.0);
+    Value gainValue (gain);   // the Value keeps the source alive
+    slider.getValueObject().referTo (gainValue);
+
+    // then in the audio callback:
+    const float g = (float) gain->get();
+    @endcode
+
+    Because ValueSource's reference count isn't thread-safe, the real-time thread
+    should just use a plain pointer to the source, and it's up to you to make sure
+    that a Value keeps it alive for as long as that thread might use it.
+*/
+class JUCE_API  AtomicValueSource  : public Value::ValueSource,
+                                     private AsyncUpdater
+{
+public:
+    //==============================================================================
+    /** Creates a source with an initial value. */
+    explicit AtomicValueSource (double initialValue = 0.0);
+
+    /** Destructor. */
+    ~AtomicValueSource();
+
+    //==============================================================================
+    /** Returns the current value.
+        This is wait-free, and can be called on any thread.
+    */
+    double get() const noexcept                         { return currentValue.get(); }
+
+    /** Changes the value.
+
+        This can be called on any thread. The new value can be read immediately, and if it
+        has changed, an update is triggered so that any listeners will be notified on the
+        message thread. No memory is allocated, but note that posting the update message
+        can take a lock, although this only happens on the first change since the listeners
+        were last called.
+    */
+    void set (double newValue);
+
+    /** Returns the number of times that the value has been changed.
+
+        Because this only increases, a thread can compare it with the last count that it
+        saw to find out cheaply whether anything has changed since then (e.g. to decide
+        whether some coefficients need recalculating).
+    */
+    uint32 getChangeCount() const noexcept              { return (uint32) changeCount.get(); }
+
+    //==============================================================================
+    /** @internal */
+    var getValue() const;
+    /** @internal */
+    void setValue (const var& newValue);
+
+private:
+    //==============================================================================
+    Atomic<double> currentValue;
+    Atomic<int> changeCount;
+
+    void handleAsyncUpdate();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AtomicValueSource)
+};
+
+
+#endif   // __JUCE_ATOMICVALUESOURCE_JUCEHEADER__
@@ -23,32 +23,133 @@
   ==============================================================================
 */
 
+// The immutable data behind a ValueTree::Snapshot.
+class ValueTree::SnapshotNode  : public ReferenceCountedObject
+{
+public:
+    explicit SnapshotNode (const SharedObject& source);
+
+    XmlElement* createXml() const
+    {
+        XmlElement* const xml = new XmlElement (type.toString());
+        properties.copyToXmlAttributes (*xml);
+
+        for (int i = 0; i < children.size(); ++i)
+            xml->addChildElement (children.getObjectPointerUnchecked(i)->createXml());
+
+        return xml;
+    }
+
+    void writeToStream (OutputStream& output) const
+    {
+        output.writeString (type.toString());
+        output.writeCompressedInt (properties.size());
+
+        for (int j = 0; j < properties.size(); ++j)
+        {
+            output.writeString (properties.getName (j).toString());
+            properties.getValueAt(j).writeToStream (output);
+        }
+
+        output.writeCompressedInt (children.size());
+
+        for (int i = 0; i < children.size(); ++i)
+            children.getObjectPointerUnchecked(i)->writeToStream (output);
+    }
+
+    const Identifier type;
+    const NamedValueSet properties;
+    ReferenceCountedArray<SnapshotNode> children;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SnapshotNode)
+};
+
+//==============================================================================
+/*  The indexed format written by writeToIndexedStream() looks like this:
+
+        int32 magic, int32 version
+        the node records, with each node written after all of its children
+        the string table: compressed int count, then each string
+        int64 string table position, int64 root node position, int32 magic
+
+    A node record holds a compressed int string index for its type, a compressed int
+    number of properties, each of them as a compressed int string index for its name
+    followed by the var data, then a compressed int number of children, and finally
+    an int64 position for each child.
+
+    All the positions are relative to the start of the data.
+*/
+namespace ValueTreeIndexedFormat
+{
+    static const int magic = 0x4254564a; // "JVTB"
+    static const int version = 1;
+    static const int headerSize = 8;
+    static const int trailerSize = 20;
+}
+
+// Holds the data that a lazily-loaded tree is being read from.
+class ValueTree::IndexedDataSource  : public ReferenceCountedObject
+{
+public:
+    IndexedDataSource (const void* data_, const size_t size_, MemoryMappedFile* mappedFile_)
+        : data (static_cast<const char*> (data_)), size (size_), mappedFile (mappedFile_)
+    {
+    }
+
+    ValueTree readRoot();
+    void loadChildren (SharedObject& parent);
+
+private:
+    const char* const data;
+    const size_t size;
+    ScopedPointer<MemoryMappedFile> mappedFile;
+    MemoryBlock ownedData;
+    Array<Identifier> strings;
+
+    friend class ValueTree;
+    SharedObject* readNode (int64 position);
+    bool readStringTable (int64 position);
+
+    JUCE_DECLARE_NON_COPYABLE (IndexedDataSource)
+};
+
+//==============================================================================
 class ValueTree::SharedObject  : public ReferenceCountedObject
 {
 public:
     typedef ReferenceCountedObjectPtr<SharedObject> Ptr;
 
     explicit SharedObject (const Identifier t) noexcept
-        : type (t), parent (nullptr)
+        : type (t), parent (nullptr), lazyChildTablePosition (0), numLazyChildren (0)
     {
     }
 
     SharedObject (const SharedObject& other)
         : ReferenceCountedObject(),
-          type (other.type), properties (other.properties), parent (nullptr)
+          type (other.type), properties (other.properties),
+          snapshot (other.snapshot), // (the copy's data is the same, so it can share the snapshot)
+          parent (nullptr), lazyChildTablePosition (0), numLazyChildren (0)
     {
+        other.ensureChildrenLoaded();
+
         for (int i = 0; i < other.children.size(); ++i)
         {
             SharedObject* const child = new SharedObject (*other.children.getObjectPointerUnchecked(i));
             child->parent = this;
             children.add (child);
         }
+
+        if (other.childLookup != nullptr)
+            getChildIndex().copySettingsFrom (*other.childLookup);
     }
 
     ~SharedObject()
     {
         jassert (parent == nullptr); // this should never happen unless something isn't obeying the ref-counting!
 
+        childLookup = nullptr;
+
         for (int i = children.size(); --i >= 0;)
         {
             const Ptr c (children.getObjectPointerUnchecked(i));
@@ -58,15 +159,29 @@ public:
         }
     }
 
+    //==============================================================================
+    // The listeners that were added with wantsChangesToSubTrees = false only get called
+    // when the change happened to the tree that they're attached to.
     void sendPropertyChangeMessage (ValueTree& tree, const Identifier property)
     {
         for (int i = valueTreesWithListeners.size(); --i >= 0;)
             if (ValueTree* const v = valueTreesWithListeners[i])
                 v->listeners.call (&ValueTree::Listener::valueTreePropertyChanged, tree, property);
+
+        if (tree.object == this)
+            for (int i = valueTreesWithListeners.size(); --i >= 0;)
+                if (ValueTree* const v = valueTreesWithListeners[i])
+                    v->localListeners.call (&ValueTree::Listener::valueTreePropertyChanged, tree, property);
     }
 
     void sendPropertyChangeMessage (const Identifier property)
     {
+        if (NotificationBatch* const batch = findActiveBatch())
+        {
+            batch->add (NotificationBatch::propertyChanged, this, nullptr, property);
+            return;
+        }
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -78,10 +193,21 @@ public:
         for (int i = valueTreesWithListeners.size(); --i >= 0;)
             if (ValueTree* const v = valueTreesWithListeners[i])
                 v->listeners.call (&ValueTree::Listener::valueTreeChildAdded, tree, child);
+
+        if (tree.object == this)
+            for (int i = valueTreesWithListeners.size(); --i >= 0;)
+                if (ValueTree* const v = valueTreesWithListeners[i])
+                    v->localListeners.call (&ValueTree::Listener::valueTreeChildAdded, tree, child);
     }
 
     void sendChildAddedMessage (ValueTree child)
     {
+        if (NotificationBatch* const batch = findActiveBatch())
+        {
+            batch->add (NotificationBatch::childAdded, this, child.object, Identifier());
+            return;
+        }
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -93,10 +219,21 @@ public:
         for (int i = valueTreesWithListeners.size(); --i >= 0;)
             if (ValueTree* const v = valueTreesWithListeners[i])
                 v->listeners.call (&ValueTree::Listener::valueTreeChildRemoved, tree, child);
+
+        if (tree.object == this)
+            for (int i = valueTreesWithListeners.size(); --i >= 0;)
+                if (ValueTree* const v = valueTreesWithListeners[i])
+                    v->localListeners.call (&ValueTree::Listener::valueTreeChildRemoved, tree, child);
     }
 
     void sendChildRemovedMessage (ValueTree child)
     {
+        if (NotificationBatch* const batch = findActiveBatch())
+        {
+            batch->add (NotificationBatch::childRemoved, this, child.object, Identifier());
+            return;
+        }
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -108,10 +245,21 @@ public:
         for (int i = valueTreesWithListeners.size(); --i >= 0;)
             if (ValueTree* const v = valueTreesWithListeners[i])
                 v->listeners.call (&ValueTree::Listener::valueTreeChildOrderChanged, tree);
+
+        if (tree.object == this)
+            for (int i = valueTreesWithListeners.size(); --i >= 0;)
+                if (ValueTree* const v = valueTreesWithListeners[i])
+                    v->localListeners.call (&ValueTree::Listener::valueTreeChildOrderChanged, tree);
     }
 
     void sendChildOrderChangedMessage()
     {
+        if (NotificationBatch* const batch = findActiveBatch())
+        {
+            batch->add (NotificationBatch::childOrderChanged, this, nullptr, Identifier());
+            return;
+        }
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -119,18 +267,432 @@ public:
     }
 
     void sendParentChangeMessage()
+    {
+        if (NotificationBatch* const batch = findActiveBatch())
+            batch->add (NotificationBatch::parentChanged, this, nullptr, Identifier());
+        else
+            deliverParentChangeMessage();
+    }
+
+    void deliverParentChangeMessage()
     {
         ValueTree tree (this);
 
         for (int j = children.size(); --j >= 0;)
             if (SharedObject* const child = children.getObjectPointer (j))
-                child->sendParentChangeMessage();
+                child->deliverParentChangeMessage();
 
         for (int i = valueTreesWithListeners.size(); --i >= 0;)
             if (ValueTree* const v = valueTreesWithListeners[i])
                 v->listeners.call (&ValueTree::Listener::valueTreeParentChanged, tree);
+
+        for (int i = valueTreesWithListeners.size(); --i >= 0;)
+            if (ValueTree* const v = valueTreesWithListeners[i])
+                v->localListeners.call (&ValueTree::Listener::valueTreeParentChanged, tree);
+    }
+
+    //==============================================================================
+    /** Holds the notifications that were triggered inside a ScopedNotificationBatch,
+        so that they can all be delivered when the outermost batch finishes.
+    */
+    class NotificationBatch
+    {
+    public:
+        NotificationBatch() noexcept  : depth (1) {}
+
+        enum NotificationType
+        {
+            propertyChanged,
+            childAdded,
+            childRemoved,
+            childOrderChanged,
+            parentChanged
+        };
+
+        void add (const NotificationType type, SharedObject* const tree,
+                  SharedObject* const child, const Identifier property)
+        {
+            // A property or order change only needs to be reported once, however many
+            // times it happened during the batch..
+            if (type == propertyChanged || type == childOrderChanged)
+                if (! coalescedChanges.add (CoalescingKey (type, tree, property)))
+                    return;
+
+            notifications.add (PendingNotification (type, tree, child, property));
+        }
+
+        void deliver()
+        {
+            for (int i = 0; i < notifications.size(); ++i)
+            {
+                const PendingNotification& n = notifications.getReference (i);
+
+                switch (n.type)
+                {
+                    case propertyChanged:   n.tree->sendPropertyChangeMessage (n.property); break;
+                    case childAdded:        n.tree->sendChildAddedMessage (ValueTree (n.child)); break;
+                    case childRemoved:      n.tree->sendChildRemovedMessage (ValueTree (n.child)); break;
+                    case childOrderChanged: n.tree->sendChildOrderChangedMessage(); break;
+                    case parentChanged:     n.tree->sendParentChangeMessage(); break;
+                    default:                jassertfalse; break;
+                }
+            }
+        }
+
+        int depth;
+
+    private:
+        struct PendingNotification
+        {
+            PendingNotification() noexcept  : type (propertyChanged) {}
+
+            PendingNotification (const NotificationType type_, SharedObject* const tree_,
+                                 SharedObject* const child_, const Identifier property_) noexcept
+                : type (type_), tree (tree_), child (child_), property (property_)
+            {}
+
+            NotificationType type;
+            Ptr tree, child;
+            Identifier property;
+        };
+
+        struct CoalescingKey
+        {
+            CoalescingKey (const NotificationType type_, const SharedObject* const tree_, const Identifier property) noexcept
+                : type (type_), tree (tree_), name (property.getCharPointer().getAddress())
+            {}
+
+            bool operator== (const CoalescingKey& other) const noexcept
+            {
+                return type == other.type && tree == other.tree && name == other.name;
+            }
+
+            bool operator< (const CoalescingKey& other) const noexcept
+            {
+                if (tree != other.tree)  return tree < other.tree;
+                if (name != other.name)  return name < other.name;
+                return type < other.type;
+            }
+
+            NotificationType type;
+            const SharedObject* tree;
+            const void* name; // (identifiers with the same name share the same pooled string)
+        };
+
+        Array<PendingNotification> notifications;
+        SortedSet<CoalescingKey> coalescedChanges;
+
+        JUCE_DECLARE_NON_COPYABLE (NotificationBatch)
+    };
+
+    // If this tree or any of its parents is batching its notifications, this returns
+    // the outermost batch, which is where a change to this tree must be recorded.
+    NotificationBatch* findActiveBatch() const noexcept
+    {
+        NotificationBatch* batch = nullptr;
+
+        for (const SharedObject* t = this; t != nullptr; t = t->parent)
+            if (t->notificationBatch != nullptr)
+                batch = t->notificationBatch;
+
+        return batch;
+    }
+
+    //==============================================================================
+    /** An optional index of a node's children, by type and/or by the values of some
+        chosen properties, so that the first child with a given key can be found without
+        scanning them all.
+
+        For each key, it keeps the first child that has it and the number of children that
+        have it. Adding a child or changing a property is O(1) for keys that aren't shared
+        by other children; when a key is shared, the children may need to be scanned to
+        find out which one comes first.
+    */
+    class ChildIndex
+    {
+    public:
+        explicit ChildIndex (const SharedObject& owner_) noexcept
+            : owner (owner_), indexesTypes (false)
+        {
+        }
+
+        void indexTypes()
+        {
+            if (! indexesTypes)
+            {
+                indexesTypes = true;
+
+                for (int i = 0; i < owner.children.size(); ++i)
+                    addEntry (types, owner.children.getObjectPointerUnchecked (i)->type,
+                              owner.children.getObjectPointerUnchecked (i));
+            }
+        }
+
+        void indexProperty (const Identifier name)
+        {
+            if (findPropertyIndex (name) == nullptr)
+            {
+                PropertyIndex* const p = new PropertyIndex (name);
+                propertyIndexes.add (p);
+
+                for (int i = 0; i < owner.children.size(); ++i)
+                    addToPropertyIndex (*p, owner.children.getObjectPointerUnchecked (i));
+            }
+        }
+
+        void copySettingsFrom (const ChildIndex& other)
+        {
+            if (other.indexesTypes)
+                indexTypes();
+
+            for (int i = 0; i < other.propertyIndexes.size(); ++i)
+                indexProperty (other.propertyIndexes.getUnchecked (i)->name);
+        }
+
+        void rebuild()
+        {
+            OwnedArray<PropertyIndex> oldIndexes;
+            oldIndexes.swapWithArray (propertyIndexes);
+            types.clear();
+
+            const bool shouldIndexTypes = indexesTypes;
+            indexesTypes = false;
+
+            if (shouldIndexTypes)
+                indexTypes();
+
+            for (int i = 0; i < oldIndexes.size(); ++i)
+                indexProperty (oldIndexes.getUnchecked (i)->name);
+        }
+
+        bool isIndexingProperty (const Identifier name) const noexcept
+        {
+            return findPropertyIndex (name) != nullptr;
+        }
+
+        //==============================================================================
+        // This must be called after the child has been put into the owner's list.
+        void childAdded (SharedObject* const child)
+        {
+            if (indexesTypes)
+                addEntry (types, child->type, child);
+
+            for (int i = propertyIndexes.size(); --i >= 0;)
+                addToPropertyIndex (*propertyIndexes.getUnchecked (i), child);
+        }
+
+        // This must be called while the child is still in the owner's list.
+        void childRemoved (SharedObject* const child)
+        {
+            if (indexesTypes)
+                removeEntry (types, child->type, child, TypeMatcher (child->type));
+
+            for (int i = propertyIndexes.size(); --i >= 0;)
+                removeFromPropertyIndex (*propertyIndexes.getUnchecked (i), child);
+        }
+
+        void propertyAdded (SharedObject* const child, const Identifier name)
+        {
+            if (PropertyIndex* const p = findPropertyIndex (name))
+                addToPropertyIndex (*p, child);
+        }
+
+        void propertyRemoved (SharedObject* const child, const Identifier name)
+        {
+            if (PropertyIndex* const p = findPropertyIndex (name))
+                removeFromPropertyIndex (*p, child);
+        }
+
+        //==============================================================================
+        // These return false if there's no suitable index, in which case the caller has to search.
+        bool findChildWithType (const Identifier type, SharedObject*& result) const
+        {
+            if (! indexesTypes)
+                return false;
+
+            result = types [type].first;
+            return true;
+        }
+
+        bool findChildWithProperty (const Identifier name, const var& value, SharedObject*& result) const
+        {
+            const PropertyIndex* const p = findPropertyIndex (name);
+
+            if (p == nullptr || value.isVoid())
+                return false;
+
+            result = p->values [value.toString()].first;
+
+            // (the index matches values by their string form, so for a value of a different
+            // type, e.g. an int being compared with a string, the caller needs to search instead)
+            return result == nullptr || result->getProperty (name) == value;
+        }
+
+    private:
+        struct Entry
+        {
+            Entry() noexcept  : first (nullptr), count (0) {}
+
+            SharedObject* first;
+            int count;
+        };
+
+        struct PropertyIndex
+        {
+            explicit PropertyIndex (const Identifier name_)  : name (name_) {}
+
+            const Identifier name;
+            FlatHashMap<String, Entry> values;
+
+            JUCE_DECLARE_NON_COPYABLE (PropertyIndex)
+        };
+
+        struct TypeMatcher
+        {
+            explicit TypeMatcher (const Identifier type_) noexcept  : type (type_) {}
+            bool matches (const SharedObject& o) const noexcept     { return o.type == type; }
+
+            const Identifier type;
+        };
+
+        struct ValueMatcher
+        {
+            ValueMatcher (const Identifier name_, const String& value_) noexcept  : name (name_), value (value_) {}
+
+            bool matches (const SharedObject& o) const
+            {
+                const var* const v = o.properties.getVarPointer (name);
+                return v != nullptr && v->toString() == value;
+            }
+
+            const Identifier name;
+            const String& value;
+        };
+
+        const SharedObject& owner;
+        bool indexesTypes;
+        FlatHashMap<Identifier, Entry> types;
+        OwnedArray<PropertyIndex> propertyIndexes;
+
+        PropertyIndex* findPropertyIndex (const Identifier name) const noexcept
+        {
+            for (int i = propertyIndexes.size(); --i >= 0;)
+                if (propertyIndexes.getUnchecked (i)->name == name)
+                    return propertyIndexes.getUnchecked (i);
+
+            return nullptr;
+        }
+
+        bool comesBefore (SharedObject* const child, SharedObject* const other) const noexcept
+        {
+            // (children are mostly appended, so this avoids searching for them in that case)
+            return owner.children.getObjectPointerUnchecked (owner.children.size() - 1) != child
+                     && owner.children.indexOf (child) < owner.children.indexOf (other);
+        }
+
+        template <class MapType, typename KeyType>
+        void addEntry (MapType& map, const KeyType& key, SharedObject* const child)
+        {
+            Entry e (map [key]);
+
+            if (e.count == 0 || comesBefore (child, e.first))
+                e.first = child;
+
+            ++e.count;
+            map.set (key, e);
+        }
+
+        template <class MapType, typename KeyType, class MatcherType>
+        void removeEntry (MapType& map, const KeyType& key, SharedObject* const child, const MatcherType& matcher)
+        {
+            Entry e (map [key]);
+            jassert (e.count > 0);
+
+            if (--e.count <= 0)
+            {
+                map.remove (key);
+                return;
+            }
+
+            if (e.first == child)
+            {
+                e.first = nullptr;
+
+                for (int i = 0; i < owner.children.size(); ++i)
+                {
+                    SharedObject* const c = owner.children.getObjectPointerUnchecked (i);
+
+                    if (c != child && matcher.matches (*c))
+                    {
+                        e.first = c;
+                        break;
+                    }
+                }
+
+                jassert (e.first != nullptr);
+            }
+
+            map.set (key, e);
+        }
+
+        void addToPropertyIndex (PropertyIndex& p, SharedObject* const child)
+        {
+            if (const var* const v = child->properties.getVarPointer (p.name))
+                addEntry (p.values, v->toString(), child);
+        }
+
+        void removeFromPropertyIndex (PropertyIndex& p, SharedObject* const child)
+        {
+            if (const var* const v = child->properties.getVarPointer (p.name))
+            {
+                const String value (v->toString());
+                removeEntry (p.values, value, child, ValueMatcher (p.name, value));
+            }
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (ChildIndex)
+    };
+
+    ChildIndex& getChildIndex()
+    {
+        ensureChildrenLoaded();
+
+        if (childLookup == nullptr)
+            childLookup = new ChildIndex (*this);
+
+        return *childLookup;
     }
 
+    // Returns the parent's index if it needs to know when this property changes.
+    ChildIndex* getParentIndexForProperty (const Identifier name) const noexcept
+    {
+        if (parent != nullptr && parent->childLookup != nullptr
+              && parent->childLookup->isIndexingProperty (name))
+            return parent->childLookup;
+
+        return nullptr;
+    }
+
+    //==============================================================================
+    SnapshotNode* getSnapshot()
+    {
+        ensureChildrenLoaded();
+
+        if (snapshot == nullptr)
+            snapshot = new SnapshotNode (*this);
+
+        return snapshot;
+    }
+
+    // This must be called whenever the tree changes, to discard the cached snapshots that
+    // include it. (If a node has no cached snapshot, then neither can any of its parents).
+    void invalidateSnapshots() noexcept
+    {
+        for (SharedObject* t = this; t != nullptr && t->snapshot != nullptr; t = t->parent)
+            t->snapshot = nullptr;
+    }
+
+    //==============================================================================
     const var& getProperty (const Identifier name) const noexcept
     {
         return properties [name];
@@ -145,8 +707,21 @@ public:
     {
         if (undoManager == nullptr)
         {
-            if (properties.set (name, newValue))
+            ChildIndex* const index = getParentIndexForProperty (name);
+
+            if (index != nullptr)
+                index->propertyRemoved (this, name);
+
+            const bool hasChanged = properties.set (name, newValue);
+
+            if (index != nullptr)
+                index->propertyAdded (this, name);
+
+            if (hasChanged)
+            {
+                invalidateSnapshots();
                 sendPropertyChangeMessage (name);
+            }
         }
         else
         {
@@ -171,8 +746,14 @@ public:
     {
         if (undoManager == nullptr)
         {
+            if (ChildIndex* const index = getParentIndexForProperty (name))
+                index->propertyRemoved (this, name);
+
             if (properties.remove (name))
+            {
+                invalidateSnapshots();
                 sendPropertyChangeMessage (name);
+            }
         }
         else
         {
@@ -188,7 +769,12 @@ public:
             while (properties.size() > 0)
             {
                 const Identifier name (properties.getName (properties.size() - 1));
+
+                if (ChildIndex* const index = getParentIndexForProperty (name))
+                    index->propertyRemoved (this, name);
+
                 properties.remove (name);
+                invalidateSnapshots();
                 sendPropertyChangeMessage (name);
             }
         }
@@ -212,6 +798,13 @@ public:
 
     ValueTree getChildWithName (const Identifier typeToMatch) const
     {
+        SharedObject* indexedChild = nullptr;
+
+        if (childLookup != nullptr && childLookup->findChildWithType (typeToMatch, indexedChild))
+            return ValueTree (indexedChild);
+
+        ensureChildrenLoaded();
+
         for (int i = 0; i < children.size(); ++i)
         {
             SharedObject* const s = children.getObjectPointerUnchecked (i);
@@ -224,12 +817,10 @@ public:
 
     ValueTree getOrCreateChildWithName (const Identifier typeToMatch, UndoManager* undoManager)
     {
-        for (int i = 0; i < children.size(); ++i)
-        {
-            SharedObject* const s = children.getObjectPointerUnchecked (i);
-            if (s->type == typeToMatch)
-                return ValueTree (s);
-        }
+        const ValueTree existing (getChildWithName (typeToMatch));
+
+        if (existing.isValid())
+            return existing;
 
         SharedObject* const newObject = new SharedObject (typeToMatch);
         addChild (newObject, -1, undoManager);
@@ -239,6 +830,13 @@ public:
 
     ValueTree getChildWithProperty (const Identifier propertyName, const var& propertyValue) const
     {
+        SharedObject* indexedChild = nullptr;
+
+        if (childLookup != nullptr && childLookup->findChildWithProperty (propertyName, propertyValue, indexedChild))
+            return ValueTree (indexedChild);
+
+        ensureChildrenLoaded();
+
         for (int i = 0; i < children.size(); ++i)
         {
             SharedObject* const s = children.getObjectPointerUnchecked (i);
@@ -258,13 +856,27 @@ public:
         return false;
     }
 
-    int indexOf (const ValueTree& child) const noexcept
+    int indexOf (const ValueTree& child) const
     {
+        ensureChildrenLoaded();
         return children.indexOf (child.object);
     }
 
+    int getNumChildren() const noexcept
+    {
+        return lazySource != nullptr ? numLazyChildren : children.size();
+    }
+
+    SharedObject* getChild (const int index) const
+    {
+        ensureChildrenLoaded();
+        return children.getObjectPointer (index);
+    }
+
     void addChild (SharedObject* child, int index, UndoManager* const undoManager)
     {
+        ensureChildrenLoaded();
+
         if (child != nullptr && child->parent != this)
         {
             if (child != this && ! isAChildOf (child))
@@ -284,6 +896,11 @@ public:
                 {
                     children.insert (index, child);
                     child->parent = this;
+
+                    if (childLookup != nullptr)
+                        childLookup->childAdded (child);
+
+                    invalidateSnapshots();
                     sendChildAddedMessage (ValueTree (child));
                     child->sendParentChangeMessage();
                 }
@@ -306,14 +923,18 @@ public:
 
     void removeChild (const int childIndex, UndoManager* const undoManager)
     {
-        const Ptr child (children.getObjectPointer (childIndex));
+        const Ptr child (getChild (childIndex));
 
         if (child != nullptr)
         {
             if (undoManager == nullptr)
             {
+                if (childLookup != nullptr)
+                    childLookup->childRemoved (child);
+
                 children.remove (childIndex);
                 child->parent = nullptr;
+                invalidateSnapshots();
                 sendChildRemovedMessage (ValueTree (child));
                 child->sendParentChangeMessage();
             }
@@ -326,12 +947,16 @@ public:
 
     void removeAllChildren (UndoManager* const undoManager)
     {
+        ensureChildrenLoaded();
+
         while (children.size() > 0)
             removeChild (children.size() - 1, undoManager);
     }
 
     void moveChild (int currentIndex, int newIndex, UndoManager* undoManager)
     {
+        ensureChildrenLoaded();
+
         // The source index must be a valid index!
         jassert (isPositiveAndBelow (currentIndex, children.size()));
 
@@ -340,7 +965,17 @@ public:
         {
             if (undoManager == nullptr)
             {
+                SharedObject* const child = children.getObjectPointerUnchecked (currentIndex);
+
+                if (childLookup != nullptr)
+                    childLookup->childRemoved (child);
+
                 children.move (currentIndex, newIndex);
+
+                if (childLookup != nullptr)
+                    childLookup->childAdded (child);
+
+                invalidateSnapshots();
                 sendChildOrderChangedMessage();
             }
             else
@@ -355,6 +990,7 @@ public:
 
     void reorderChildren (const OwnedArray<ValueTree>& newOrder, UndoManager* undoManager)
     {
+        ensureChildrenLoaded();
         jassert (newOrder.size() == children.size());
 
         if (undoManager == nullptr)
@@ -365,6 +1001,10 @@ public:
             for (int i = 0; i < newOrder.size(); ++i)
                 children.add (newOrder.getUnchecked(i)->object);
 
+            if (childLookup != nullptr)
+                childLookup->rebuild();
+
+            invalidateSnapshots();
             sendChildOrderChangedMessage();
         }
         else
@@ -387,10 +1027,13 @@ public:
     {
         if (type != other.type
              || properties.size() != other.properties.size()
-             || children.size() != other.children.size()
+             || getNumChildren() != other.getNumChildren()
              || properties != other.properties)
             return false;
 
+        ensureChildrenLoaded();
+        other.ensureChildrenLoaded();
+
         for (int i = 0; i < children.size(); ++i)
             if (! children.getObjectPointerUnchecked(i)->isEquivalentTo (*other.children.getObjectPointerUnchecked(i)))
                 return false;
@@ -400,6 +1043,8 @@ public:
 
     XmlElement* createXml() const
     {
+        ensureChildrenLoaded();
+
         XmlElement* const xml = new XmlElement (type.toString());
         properties.copyToXmlAttributes (*xml);
 
@@ -411,6 +1056,8 @@ public:
 
     void writeToStream (OutputStream& output) const
     {
+        ensureChildrenLoaded();
+
         output.writeString (type.toString());
         output.writeCompressedInt (properties.size());
 
@@ -441,6 +1088,35 @@ public:
     }
 
     //==============================================================================
+    // These give a rough idea of how much memory something takes up, for the undo actions.
+    static int getApproximateSize (const var& v)
+    {
+        int size = (int) sizeof (var);
+
+        if (v.isString())
+            size += (int) v.toString().getCharPointer().sizeInBytes();
+        else if (const MemoryBlock* const mb = v.getBinaryData())
+            size += (int) mb->getSize();
+
+        return size;
+    }
+
+    int getApproximateSizeOfTree() const
+    {
+        int size = (int) sizeof (*this);
+
+        for (int i = properties.size(); --i >= 0;)
+            size += getApproximateSize (properties.getValueAt (i));
+
+        for (int i = children.size(); --i >= 0;)
+            size += children.getObjectPointerUnchecked (i)->getApproximateSizeOfTree();
+
+        return size;
+    }
+
+    //==============================================================================
+    class MoveChildAction;
+
     class SetPropertyAction  : public UndoableAction
     {
     public:
@@ -476,7 +1152,15 @@ public:
 
         int getSizeInUnits()
         {
-            return (int) sizeof (*this); //xxx should be more accurate
+            return (int) sizeof (*this) + getApproximateSize (newValue) + getApproximateSize (oldValue);
+        }
+
+        bool isIndependentOf (UndoableAction* otherAction)
+        {
+            if (SetPropertyAction* const other = dynamic_cast <SetPropertyAction*> (otherAction))
+                return other->target != target || other->name != name;
+
+            return dynamic_cast <MoveChildAction*> (otherAction) != nullptr;
         }
 
         UndoableAction* createCoalescedAction (UndoableAction* nextAction)
@@ -510,7 +1194,9 @@ public:
             : target (target_),
               child (newChild_ != nullptr ? newChild_ : target_->children.getObjectPointer (childIndex_)),
               childIndex (childIndex_),
-              isDeleting (newChild_ == nullptr)
+              isDeleting (newChild_ == nullptr),
+              // (when a child is deleted, this action may be the only thing keeping it alive)
+              size ((int) sizeof (*this) + (isDeleting && child != nullptr ? child->getApproximateSizeOfTree() : 0))
         {
             jassert (child != nullptr);
         }
@@ -544,71 +1230,328 @@ public:
 
         int getSizeInUnits()
         {
-            return (int) sizeof (*this); //xxx should be more accurate
+            return size;
         }
 
     private:
         const Ptr target, child;
         const int childIndex;
         const bool isDeleting;
+        const int size;
 
         JUCE_DECLARE_NON_COPYABLE (AddOrRemoveChildAction)
     };
 
-    //==============================================================================
-    class MoveChildAction  : public UndoableAction
+    //==============================================================================
+    class MoveChildAction  : public UndoableAction
+    {
+    public:
+        MoveChildAction (SharedObject* const parent_, const int startIndex_, const int endIndex_) noexcept
+            : parent (parent_), startIndex (startIndex_), endIndex (endIndex_)
+        {
+        }
+
+        bool perform()
+        {
+            parent->moveChild (startIndex, endIndex, nullptr);
+            return true;
+        }
+
+        bool undo()
+        {
+            parent->moveChild (endIndex, startIndex, nullptr);
+            return true;
+        }
+
+        int getSizeInUnits()
+        {
+            return (int) sizeof (*this);
+        }
+
+        bool isIndependentOf (UndoableAction* otherAction)
+        {
+            return dynamic_cast <SetPropertyAction*> (otherAction) != nullptr;
+        }
+
+        UndoableAction* createCoalescedAction (UndoableAction* nextAction)
+        {
+            if (MoveChildAction* next = dynamic_cast <MoveChildAction*> (nextAction))
+                if (next->parent == parent && next->startIndex == endIndex)
+                    return new MoveChildAction (parent, startIndex, next->endIndex);
+
+            return nullptr;
+        }
+
+    private:
+        const Ptr parent;
+        const int startIndex, endIndex;
+
+        JUCE_DECLARE_NON_COPYABLE (MoveChildAction)
+    };
+
+    //==============================================================================
+    const Identifier type;
+    NamedValueSet properties;
+    ReferenceCountedArray<SharedObject> children;
+    SortedSet<ValueTree*> valueTreesWithListeners;
+    ScopedPointer<NotificationBatch> notificationBatch;
+    ScopedPointer<ChildIndex> childLookup;
+    ReferenceCountedObjectPtr<SnapshotNode> snapshot;
+    SharedObject* parent;
+
+    // If this node was read by readFromIndexedFile() and its children haven't been
+    // needed yet, these say where to find them.
+    ReferenceCountedObjectPtr<IndexedDataSource> lazySource;
+    int64 lazyChildTablePosition;
+    int numLazyChildren;
+
+    inline void ensureChildrenLoaded() const
+    {
+        if (lazySource != nullptr)
+            loadLazyChildren();
+    }
+
+    void loadLazyChildren() const;
+
+private:
+    SharedObject& operator= (const SharedObject&);
+    JUCE_LEAK_DETECTOR (SharedObject)
+};
+
+void ValueTree::SharedObject::loadLazyChildren() const
+{
+    const ReferenceCountedObjectPtr<IndexedDataSource> source (lazySource);
+    SharedObject& o = const_cast<SharedObject&> (*this);
+    o.lazySource = nullptr;
+    source->loadChildren (o);
+}
+
+//==============================================================================
+ValueTree ValueTree::IndexedDataSource::readRoot()
+{
+    using namespace ValueTreeIndexedFormat;
+
+    if (data == nullptr || size < (size_t) (headerSize + trailerSize))
+        return ValueTree::invalid;
+
+    MemoryInputStream header (data, headerSize, false);
+    MemoryInputStream trailer (data + size - trailerSize, trailerSize, false);
+
+    const int headerMagic = header.readInt();
+    const int formatVersion = header.readInt();
+    const int64 stringTablePosition = trailer.readInt64();
+    const int64 rootPosition = trailer.readInt64();
+
+    if (headerMagic != magic || trailer.readInt() != magic)
+        return ValueTree::invalid;
+
+    if (formatVersion > version)
+    {
+        jassertfalse; // this data was written by a newer version of the format!
+        return ValueTree::invalid;
+    }
+
+    if (! readStringTable (stringTablePosition))
+        return ValueTree::invalid;
+
+    return ValueTree (readNode (rootPosition));
+}
+
+bool ValueTree::IndexedDataSource::readStringTable (const int64 position)
+{
+    if (! isPositiveAndBelow (position, (int64) size))
+    {
+        jassertfalse;  // trying to read corrupted data!
+        return false;
+    }
+
+    MemoryInputStream in (data + position, size - (size_t) position, false);
+    const int numStrings = in.readCompressedInt();
+
+    if (numStrings < 0)
+    {
+        jassertfalse;  // trying to read corrupted data!
+        return false;
+    }
+
+    strings.ensureStorageAllocated (numStrings);
+
+    for (int i = 0; i < numStrings; ++i)
+    {
+        const String name (in.readString());
+
+        if (name.isEmpty())
+        {
+            jassertfalse;  // trying to read corrupted data!
+            return false;
+        }
+
+        strings.add (Identifier (name));
+    }
+
+    return true;
+}
+
+ValueTree::SharedObject* ValueTree::IndexedDataSource::readNode (const int64 position)
+{
+    if (! isPositiveAndBelow (position, (int64) size))
+    {
+        jassertfalse;  // trying to read corrupted data!
+        return nullptr;
+    }
+
+    MemoryInputStream in (data + position, size - (size_t) position, false);
+
+    const int typeIndex = in.readCompressedInt();
+
+    if (! isPositiveAndBelow (typeIndex, strings.size()))
+    {
+        jassertfalse;  // trying to read corrupted data!
+        return nullptr;
+    }
+
+    SharedObject* const node = new SharedObject (strings.getReference (typeIndex));
+    const int numProps = in.readCompressedInt();
+
+    for (int i = 0; i < numProps; ++i)
     {
-    public:
-        MoveChildAction (SharedObject* const parent_, const int startIndex_, const int endIndex_) noexcept
-            : parent (parent_), startIndex (startIndex_), endIndex (endIndex_)
+        const int nameIndex = in.readCompressedInt();
+
+        if (! isPositiveAndBelow (nameIndex, strings.size()))
         {
+            jassertfalse;  // trying to read corrupted data!
+            break;
         }
 
-        bool perform()
+        node->properties.set (strings.getReference (nameIndex), var::readFromStream (in));
+    }
+
+    const int numChildren = in.readCompressedInt();
+    const int64 childTablePosition = position + in.getPosition();
+
+    if (numChildren > 0)
+    {
+        if (childTablePosition + numChildren * (int64) sizeof (int64) > (int64) size)
         {
-            parent->moveChild (startIndex, endIndex, nullptr);
-            return true;
+            jassertfalse;  // trying to read corrupted data!
         }
-
-        bool undo()
+        else
         {
-            parent->moveChild (endIndex, startIndex, nullptr);
-            return true;
+            node->lazySource = this;
+            node->lazyChildTablePosition = childTablePosition;
+            node->numLazyChildren = numChildren;
         }
+    }
 
-        int getSizeInUnits()
+    return node;
+}
+
+void ValueTree::IndexedDataSource::loadChildren (SharedObject& parent)
+{
+    MemoryInputStream in (data + parent.lazyChildTablePosition,
+                          (size_t) parent.numLazyChildren * sizeof (int64), false);
+
+    parent.children.ensureStorageAllocated (parent.numLazyChildren);
+
+    for (int i = 0; i < parent.numLazyChildren; ++i)
+    {
+        if (SharedObject* const child = readNode (in.readInt64()))
         {
-            return (int) sizeof (*this); //xxx should be more accurate
+            parent.children.add (child);
+            child->parent = &parent;
         }
+    }
 
-        UndoableAction* createCoalescedAction (UndoableAction* nextAction)
-        {
-            if (MoveChildAction* next = dynamic_cast <MoveChildAction*> (nextAction))
-                if (next->parent == parent && next->startIndex == endIndex)
-                    return new MoveChildAction (parent, startIndex, next->endIndex);
+    parent.numLazyChildren = 0;
+}
 
-            return nullptr;
-        }
+//==============================================================================
+// Writes a tree in the format that IndexedDataSource reads.
+class ValueTree::IndexedFormatWriter
+{
+public:
+    explicit IndexedFormatWriter (OutputStream& output_)
+        : output (output_), startPosition (output_.getPosition())
+    {
+    }
 
-    private:
-        const Ptr parent;
-        const int startIndex, endIndex;
+    void write (const SharedObject* const root)
+    {
+        output.writeInt (ValueTreeIndexedFormat::magic);
+        output.writeInt (ValueTreeIndexedFormat::version);
 
-        JUCE_DECLARE_NON_COPYABLE (MoveChildAction)
-    };
+        const int64 rootPosition = writeNode (*root);
+        const int64 stringTablePosition = getPosition();
 
-    //==============================================================================
-    const Identifier type;
-    NamedValueSet properties;
-    ReferenceCountedArray<SharedObject> children;
-    SortedSet<ValueTree*> valueTreesWithListeners;
-    SharedObject* parent;
+        output.writeCompressedInt (strings.size());
+
+        for (int i = 0; i < strings.size(); ++i)
+            output.writeString (strings.getReference (i).toString());
+
+        output.writeInt64 (stringTablePosition);
+        output.writeInt64 (rootPosition);
+        output.writeInt (ValueTreeIndexedFormat::magic);
+    }
 
 private:
-    SharedObject& operator= (const SharedObject&);
-    JUCE_LEAK_DETECTOR (SharedObject)
+    OutputStream& output;
+    const int64 startPosition;
+    Array<Identifier> strings;
+    FlatHashMap<Identifier, int> stringIndexes;
+
+    int64 getPosition()  { return output.getPosition() - startPosition; }
+
+    int getStringIndex (const Identifier name)
+    {
+        if (stringIndexes.contains (name))
+            return stringIndexes [name];
+
+        stringIndexes.set (name, strings.size());
+        strings.add (name);
+        return strings.size() - 1;
+    }
+
+    int64 writeNode (const SharedObject& node)
+    {
+        node.ensureChildrenLoaded();
+
+        const int numChildren = node.children.size();
+        HeapBlock<int64> childPositions ((size_t) numChildren);
+
+        for (int i = 0; i < numChildren; ++i)
+            childPositions[i] = writeNode (*node.children.getObjectPointerUnchecked (i));
+
+        const int64 position = getPosition();
+        output.writeCompressedInt (getStringIndex (node.type));
+        output.writeCompressedInt (node.properties.size());
+
+        for (int i = 0; i < node.properties.size(); ++i)
+        {
+            output.writeCompressedInt (getStringIndex (node.properties.getName (i)));
+            node.properties.getValueAt (i).writeToStream (output);
+        }
+
+        output.writeCompressedInt (numChildren);
+
+        for (int i = 0; i < numChildren; ++i)
+            output.writeInt64 (childPositions[i]);
+
+        return position;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (IndexedFormatWriter)
 };
 
+//==============================================================================
+ValueTree::SnapshotNode::SnapshotNode (const SharedObject& source)
+    : type (source.type), properties (source.properties)
+{
+    children.ensureStorageAllocated (source.children.size());
+
+    for (int i = 0; i < source.children.size(); ++i)
+        children.add (source.children.getObjectPointerUnchecked(i)->getSnapshot());
+}
+
 //==============================================================================
 ValueTree::ValueTree() noexcept
 {
@@ -634,7 +1577,7 @@ ValueTree::ValueTree (const ValueTree& other)
 
 ValueTree& ValueTree::operator= (const ValueTree& other)
 {
-    if (listeners.size() > 0)
+    if (hasListeners())
     {
         if (object != nullptr)
             object->valueTreesWithListeners.removeValue (this);
@@ -646,19 +1589,34 @@ ValueTree& ValueTree::operator= (const ValueTree& other)
     object = other.object;
 
     listeners.call (&ValueTree::Listener::valueTreeRedirected, *this);
+    localListeners.call (&ValueTree::Listener::valueTreeRedirected, *this);
     return *this;
 }
 
 #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
 ValueTree::ValueTree (ValueTree&& other) noexcept
-    : object (static_cast <SharedObject::Ptr&&> (other.object))
 {
+    // (if the other tree has listeners, it's registered with its object, and has
+    // to keep hold of it so that it can unregister itself later)
+    if (other.hasListeners())
+        object = other.object;
+    else
+        object = static_cast <SharedObject::Ptr&&> (other.object);
+}
+
+ValueTree& ValueTree::operator= (ValueTree&& other)
+{
+    if (hasListeners() || other.hasListeners())
+        return operator= (static_cast <const ValueTree&> (other));
+
+    object = static_cast <SharedObject::Ptr&&> (other.object);
+    return *this;
 }
 #endif
 
 ValueTree::~ValueTree()
 {
-    if (listeners.size() > 0 && object != nullptr)
+    if (hasListeners() && object != nullptr)
         object->valueTreesWithListeners.removeValue (this);
 }
 
@@ -684,6 +1642,11 @@ ValueTree ValueTree::createCopy() const
     return ValueTree (createCopyIfNotNull (object.get()));
 }
 
+ValueTree::Snapshot ValueTree::createSnapshot() const
+{
+    return Snapshot (object != nullptr ? object->getSnapshot() : nullptr);
+}
+
 bool ValueTree::hasType (const Identifier typeName) const
 {
     return object != nullptr && object->type == typeName;
@@ -822,12 +1785,12 @@ Value ValueTree::getPropertyAsValue (const Identifier name, UndoManager* const u
 //==============================================================================
 int ValueTree::getNumChildren() const
 {
-    return object == nullptr ? 0 : object->children.size();
+    return object == nullptr ? 0 : object->getNumChildren();
 }
 
 ValueTree ValueTree::getChild (int index) const
 {
-    return ValueTree (object != nullptr ? object->children.getObjectPointer (index)
+    return ValueTree (object != nullptr ? object->getChild (index)
                                         : static_cast <SharedObject*> (nullptr));
 }
 
@@ -846,6 +1809,24 @@ ValueTree ValueTree::getChildWithProperty (const Identifier propertyName, const
     return object != nullptr ? object->getChildWithProperty (propertyName, propertyValue) : ValueTree::invalid;
 }
 
+void ValueTree::indexChildrenByType()
+{
+    if (object != nullptr)
+        object->getChildIndex().indexTypes();
+}
+
+void ValueTree::indexChildrenByProperty (const Identifier propertyName)
+{
+    if (object != nullptr)
+        object->getChildIndex().indexProperty (propertyName);
+}
+
+void ValueTree::removeChildIndexes()
+{
+    if (object != nullptr)
+        object->childLookup = nullptr;
+}
+
 bool ValueTree::isAChildOf (const ValueTree& possibleParent) const
 {
     return object != nullptr && object->isAChildOf (possibleParent.object);
@@ -873,7 +1854,7 @@ void ValueTree::removeChild (const int childIndex, UndoManager* const undoManage
 void ValueTree::removeChild (const ValueTree& child, UndoManager* const undoManager)
 {
     if (object != nullptr)
-        object->removeChild (object->children.indexOf (child.object), undoManager);
+        object->removeChild (object->indexOf (child), undoManager);
 }
 
 void ValueTree::removeAllChildren (UndoManager* const undoManager)
@@ -892,6 +1873,7 @@ void ValueTree::moveChild (int currentIndex, int newIndex, UndoManager* undoMana
 void ValueTree::createListOfChildren (OwnedArray<ValueTree>& list) const
 {
     jassert (object != nullptr);
+    object->ensureChildrenLoaded();
 
     for (int i = 0; i < object->children.size(); ++i)
         list.add (new ValueTree (object->children.getObjectPointerUnchecked(i)));
@@ -904,31 +1886,69 @@ void ValueTree::reorderChildren (const OwnedArray<ValueTree>& newOrder, UndoMana
 }
 
 //==============================================================================
-void ValueTree::addListener (Listener* listener)
+void ValueTree::addListener (Listener* listener, const bool wantsChangesToSubTrees)
 {
     if (listener != nullptr)
     {
-        if (listeners.size() == 0 && object != nullptr)
+        if ((! hasListeners()) && object != nullptr)
             object->valueTreesWithListeners.add (this);
 
-        listeners.add (listener);
+        if (wantsChangesToSubTrees)
+            listeners.add (listener);
+        else
+            localListeners.add (listener);
     }
 }
 
 void ValueTree::removeListener (Listener* listener)
 {
     listeners.remove (listener);
+    localListeners.remove (listener);
 
-    if (listeners.size() == 0 && object != nullptr)
+    if ((! hasListeners()) && object != nullptr)
         object->valueTreesWithListeners.removeValue (this);
 }
 
+bool ValueTree::hasListeners() const noexcept
+{
+    return listeners.size() > 0 || localListeners.size() > 0;
+}
+
 void ValueTree::sendPropertyChangeMessage (const Identifier property)
 {
     if (object != nullptr)
         object->sendPropertyChangeMessage (property);
 }
 
+//==============================================================================
+ValueTree::ScopedNotificationBatch::ScopedNotificationBatch (const ValueTree& treeToBatch)
+    : tree (treeToBatch)
+{
+    if (SharedObject* const o = tree.object)
+    {
+        if (o->notificationBatch != nullptr)
+            ++(o->notificationBatch->depth);
+        else
+            o->notificationBatch = new SharedObject::NotificationBatch();
+    }
+}
+
+ValueTree::ScopedNotificationBatch::~ScopedNotificationBatch()
+{
+    if (SharedObject* const o = tree.object)
+    {
+        jassert (o->notificationBatch != nullptr);
+
+        if (--(o->notificationBatch->depth) == 0)
+        {
+            // (the batch is detached before delivering it, so that any changes the
+            // listeners make in response get sent normally, or to an enclosing batch)
+            const ScopedPointer<SharedObject::NotificationBatch> batch (o->notificationBatch.release());
+            batch->deliver();
+        }
+    }
+}
+
 //==============================================================================
 XmlElement* ValueTree::createXml() const
 {
@@ -997,6 +2017,30 @@ ValueTree ValueTree::readFromStream (InputStream& input)
     return v;
 }
 
+//==============================================================================
+void ValueTree::writeToIndexedStream (OutputStream& output) const
+{
+    if (object != nullptr)
+        IndexedFormatWriter (output).write (object);
+}
+
+ValueTree ValueTree::readFromIndexedFile (const File& file)
+{
+    MemoryMappedFile* const mappedFile = new MemoryMappedFile (file, MemoryMappedFile::readOnly);
+    const ReferenceCountedObjectPtr<IndexedDataSource> source (new IndexedDataSource (mappedFile->getData(),
+                                                                                      mappedFile->getSize(),
+                                                                                      mappedFile));
+    return source->readRoot();
+}
+
+ValueTree ValueTree::readFromIndexedData (const void* const data, const size_t numBytes)
+{
+    MemoryBlock copy (data, numBytes);
+    const ReferenceCountedObjectPtr<IndexedDataSource> source (new IndexedDataSource (copy.getData(), numBytes, nullptr));
+    source->ownedData.swapWith (copy);
+    return source->readRoot();
+}
+
 ValueTree ValueTree::readFromData (const void* const data, const size_t numBytes)
 {
     MemoryInputStream in (data, numBytes, false);
@@ -1012,6 +2056,123 @@ ValueTree ValueTree::readFromGZIPData (const void* const data, const size_t numB
 
 void ValueTree::Listener::valueTreeRedirected (ValueTree&) {}
 
+//==============================================================================
+ValueTree::Snapshot::Snapshot() noexcept {}
+ValueTree::Snapshot::Snapshot (SnapshotNode* const n) noexcept  : node (n) {}
+ValueTree::Snapshot::Snapshot (const Snapshot& other) noexcept  : node (other.node) {}
+ValueTree::Snapshot::~Snapshot() {}
+
+ValueTree::Snapshot& ValueTree::Snapshot::operator= (const Snapshot& other) noexcept
+{
+    node = other.node;
+    return *this;
+}
+
+bool ValueTree::Snapshot::operator== (const Snapshot& other) const noexcept     { return node == other.node; }
+bool ValueTree::Snapshot::operator!= (const Snapshot& other) const noexcept     { return node != other.node; }
+bool ValueTree::Snapshot::isValid() const noexcept                              { return node != nullptr; }
+
+Identifier ValueTree::Snapshot::getType() const noexcept
+{
+    return node != nullptr ? node->type : Identifier();
+}
+
+bool ValueTree::Snapshot::hasType (const Identifier typeName) const noexcept
+{
+    return node != nullptr && node->type == typeName;
+}
+
+const var& ValueTree::Snapshot::getProperty (const Identifier name) const noexcept
+{
+    return node != nullptr ? node->properties [name] : var::null;
+}
+
+var ValueTree::Snapshot::getProperty (const Identifier name, const var& defaultReturnValue) const
+{
+    return node != nullptr ? node->properties.getWithDefault (name, defaultReturnValue)
+                           : defaultReturnValue;
+}
+
+const var& ValueTree::Snapshot::operator[] (const Identifier name) const noexcept
+{
+    return getProperty (name);
+}
+
+bool ValueTree::Snapshot::hasProperty (const Identifier name) const noexcept
+{
+    return node != nullptr && node->properties.contains (name);
+}
+
+int ValueTree::Snapshot::getNumProperties() const noexcept
+{
+    return node != nullptr ? node->properties.size() : 0;
+}
+
+Identifier ValueTree::Snapshot::getPropertyName (const int index) const noexcept
+{
+    return node != nullptr ? node->properties.getName (index) : Identifier();
+}
+
+int ValueTree::Snapshot::getNumChildren() const noexcept
+{
+    return node != nullptr ? node->children.size() : 0;
+}
+
+ValueTree::Snapshot ValueTree::Snapshot::getChild (const int index) const
+{
+    return Snapshot (node != nullptr ? node->children.getObjectPointer (index) : nullptr);
+}
+
+ValueTree::Snapshot ValueTree::Snapshot::getChildWithName (const Identifier type) const
+{
+    if (node != nullptr)
+        for (int i = 0; i < node->children.size(); ++i)
+            if (node->children.getObjectPointerUnchecked (i)->type == type)
+                return Snapshot (node->children.getObjectPointerUnchecked (i));
+
+    return Snapshot();
+}
+
+ValueTree ValueTree::Snapshot::createValueTree() const
+{
+    if (node == nullptr)
+        return ValueTree::invalid;
+
+    ValueTree v (node->type);
+    v.object->properties = node->properties;
+    v.object->children.ensureStorageAllocated (node->children.size());
+
+    for (int i = 0; i < node->children.size(); ++i)
+    {
+        const ValueTree child (Snapshot (node->children.getObjectPointerUnchecked (i)).createValueTree());
+        v.object->children.add (child.object);
+        child.object->parent = v.object;
+    }
+
+    // (the new tree holds exactly the same data, so it can start off with this as its snapshot)
+    v.object->snapshot = node;
+    return v;
+}
+
+XmlElement* ValueTree::Snapshot::createXml() const
+{
+    return node != nullptr ? node->createXml() : nullptr;
+}
+
+void ValueTree::Snapshot::writeToStream (OutputStream& output) const
+{
+    if (node != nullptr)
+    {
+        node->writeToStream (output);
+    }
+    else
+    {
+        output.writeString (String::empty);
+        output.writeCompressedInt (0);
+        output.writeCompressedInt (0);
+    }
+}
+
 //==============================================================================
 #if JUCE_UNIT_TESTS
 
@@ -1095,8 +2256,222 @@ public:
 
             ValueTree v4 = v2.createCopy();
             expect (v1.isEquivalentTo (v4));
+
+            MemoryOutputStream indexed;
+            v1.writeToIndexedStream (indexed);
+            ValueTree v5 (ValueTree::readFromIndexedData (indexed.getData(), indexed.getDataSize()));
+            expect (v5.getNumChildren() == v1.getNumChildren());
+            expect (v1.isEquivalentTo (v5));
+        }
+
+        beginTest ("Indexed files");
+
+        {
+            ValueTree v1 (createRandomTree (nullptr, 0));
+            const TemporaryFile tempFile;
+
+            {
+                FileOutputStream out (tempFile.getFile());
+                v1.writeToIndexedStream (out);
+            }
+
+            ValueTree v2 (ValueTree::readFromIndexedFile (tempFile.getFile()));
+            expect (v2.isValid() && v1.isEquivalentTo (v2));
+
+            MemoryOutputStream mo1, mo2;
+            v1.writeToStream (mo1);
+            v2.writeToStream (mo2);
+            expect (mo1.getMemoryBlock() == mo2.getMemoryBlock());
+
+            expect (! ValueTree::readFromIndexedData (mo1.getData(), mo1.getDataSize()).isValid());
+        }
+
+        beginTest ("Batched notifications");
+
+        {
+            ValueTree root ("root"), child ("child");
+            root.addChild (child, -1, nullptr);
+
+            CountingListener all, local;
+            ValueTree rootRef (root);
+            rootRef.addListener (&all);
+            rootRef.addListener (&local, false);
+
+            child.setProperty ("a", 1, nullptr);
+            expect (all.numPropertyChanges == 1 && local.numPropertyChanges == 0);
+            root.setProperty ("a", 1, nullptr);
+            expect (all.numPropertyChanges == 2 && local.numPropertyChanges == 1);
+
+            all.reset();
+            local.reset();
+
+            {
+                const ValueTree::ScopedNotificationBatch batch (root);
+
+                {
+                    const ValueTree::ScopedNotificationBatch nestedBatch (child);
+
+                    for (int i = 0; i < 100; ++i)
+                    {
+                        child.setProperty ("a", i, nullptr);
+                        root.setProperty ("b", i, nullptr);
+                        child.addChild (ValueTree ("grandchild"), -1, nullptr);
+                    }
+                }
+
+                root.addChild (ValueTree ("child2"), -1, nullptr);
+                expect (all.numPropertyChanges == 0 && all.numChildrenAdded == 0);
+            }
+
+            expect (all.numPropertyChanges == 2 && all.numChildrenAdded == 101);
+            expect (local.numPropertyChanges == 1 && local.numChildrenAdded == 1);
+            expect (child.getNumChildren() == 100);
+        }
+
+        beginTest ("Indexed children");
+
+        {
+            Random r;
+            ValueTree indexed ("list"), unindexed ("list");
+            indexed.indexChildrenByType();
+            indexed.indexChildrenByProperty ("id");
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                ValueTree* const trees[] = { &indexed, &unindexed };
+                const int numChildren = indexed.getNumChildren();
+                const int index = numChildren > 0 ? r.nextInt (numChildren) : 0;
+                const int otherIndex = r.nextInt (numChildren + 1) - (r.nextBool() ? 1 : 0);
+                const String type ("type" + String (r.nextInt (5)));
+                const int id = r.nextInt (50);
+
+                switch (numChildren > 0 ? r.nextInt (6) : 0)
+                {
+                    case 0:
+                    case 1:
+                        for (int j = 0; j < 2; ++j)
+                        {
+                            ValueTree c (type);
+                            c.setProperty ("id", id, nullptr);
+                            trees[j]->addChild (c, otherIndex, nullptr);
+                        }
+                        break;
+
+                    case 2:
+                        for (int j = 0; j < 2; ++j)
+                            trees[j]->removeChild (index, nullptr);
+                        break;
+
+                    case 3:
+                        for (int j = 0; j < 2; ++j)
+                            trees[j]->moveChild (index, otherIndex, nullptr);
+                        break;
+
+                    case 4:
+                        for (int j = 0; j < 2; ++j)
+                            trees[j]->getChild (index).setProperty ("id", id, nullptr);
+                        break;
+
+                    case 5:
+                        for (int j = 0; j < 2; ++j)
+                            trees[j]->getChild (index).removeProperty ("id", nullptr);
+                        break;
+
+                    default:
+                        break;
+                }
+
+                const int found1 = indexed.indexOf (indexed.getChildWithName (type));
+                const int found2 = indexed.indexOf (indexed.getChildWithProperty ("id", id));
+
+                expectEquals (found1, unindexed.indexOf (unindexed.getChildWithName (type)));
+                expectEquals (found2, unindexed.indexOf (unindexed.getChildWithProperty ("id", id)));
+            }
+
+            expect (indexed.isEquivalentTo (unindexed));
+
+            ValueTree copy (indexed.createCopy());
+            copy.removeChild (0, nullptr);
+            expect (copy.getChildWithProperty ("id", copy.getChild (0)["id"]) == copy.getChild (0)
+                     || ! copy.getChild (0).hasProperty ("id"));
+        }
+
+        beginTest ("Snapshots");
+
+        {
+            ValueTree v (createRandomTree (nullptr, 0));
+            v.addChild (ValueTree ("a"), -1, nullptr);
+            v.addChild (ValueTree ("b"), -1, nullptr);
+            v.getChild (0).setProperty ("x", 1, nullptr);
+
+            const ValueTree::Snapshot s1 (v.createSnapshot());
+            expect (s1 == v.createSnapshot());
+            expect (s1.createValueTree().isEquivalentTo (v));
+            expect (v.createCopy().createSnapshot() == s1);
+
+            MemoryOutputStream mo1, mo2;
+            v.writeToStream (mo1);
+            s1.writeToStream (mo2);
+            expect (mo1.getMemoryBlock() == mo2.getMemoryBlock());
+
+            v.getChild (0).setProperty ("x", 2, nullptr);
+            const ValueTree::Snapshot s2 (v.createSnapshot());
+
+            expect (s1 != s2);
+            expect (s1.getChild (0) != s2.getChild (0));
+            expect (s1.getChild (1) == s2.getChild (1));
+            expect ((int) s1.getChild (0)["x"] == 1 && (int) s2.getChild (0)["x"] == 2);
+
+            ValueTree restored (s1.createValueTree());
+            expect (restored.createSnapshot() == s1);
+            restored.removeChild (1, nullptr);
+            expect (restored.createSnapshot() != s1 && restored.createSnapshot().getChild (0) == s1.getChild (0));
+            expect (s1.getNumChildren() == v.getNumChildren());
+        }
+
+        beginTest ("Undo coalescing");
+
+        {
+            UndoManager um;
+            ValueTree v ("test");
+            v.setProperty ("x", 0, nullptr);
+            v.setProperty ("y", 0, nullptr);
+
+            um.beginNewTransaction();
+
+            for (int i = 1; i <= 100; ++i)
+            {
+                v.setProperty ("x", i, &um);
+                v.setProperty ("y", -i, &um);
+            }
+
+            const int unitsForTwoActions = um.getNumberOfUnitsTakenUpByStoredCommands();
+            expect (unitsForTwoActions > 0 && unitsForTwoActions < 1000);
+            v.setProperty ("text", String::repeatedString ("abcd", 1000), &um);
+            expect (um.getNumberOfUnitsTakenUpByStoredCommands() >= unitsForTwoActions + 4000);
+
+            expect (um.undo());
+            expect ((int) v["x"] == 0 && (int) v["y"] == 0 && ! v.hasProperty ("text"));
+            expect (um.redo());
+            expect ((int) v["x"] == 100 && (int) v["y"] == -100);
         }
     }
+
+private:
+    struct CountingListener  : public ValueTree::Listener
+    {
+        CountingListener() : numPropertyChanges (0), numChildrenAdded (0) {}
+
+        void reset() noexcept   { numPropertyChanges = numChildrenAdded = 0; }
+
+        void valueTreePropertyChanged (ValueTree&, const Identifier&)   { ++numPropertyChanges; }
+        void valueTreeChildAdded (ValueTree&, ValueTree&)               { ++numChildrenAdded; }
+        void valueTreeChildRemoved (ValueTree&, ValueTree&)             {}
+        void valueTreeChildOrderChanged (ValueTree&)                    {}
+        void valueTreeParentChanged (ValueTree&)                        {}
+
+        int numPropertyChanges, numChildrenAdded;
+    };
 };
 
 static ValueTreeTests valueTreeTests;
@@ -93,6 +93,7 @@ public:
 
    #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
     ValueTree (ValueTree&& other) noexcept;
+    ValueTree& operator= (ValueTree&& other);
    #endif
 
     /** Destructor. */
@@ -128,6 +129,31 @@ public:
     /** Returns a deep copy of this tree and all its sub-nodes. */
     ValueTree createCopy() const;
 
+    //==============================================================================
+    /**
+        An immutable copy of the state of a ValueTree at a particular moment.
+
+        A snapshot can't be changed, and doesn't change when the tree it was taken from
+        does, so it's safe to read from any number of threads at once without any locking,
+        e.g. for saving or rendering the data in the background.
+
+        Taking snapshots is cheap: each node in a tree keeps hold of the last snapshot that
+        was taken of it, until it or one of its sub-nodes gets changed. So when you take a
+        new snapshot of a large tree, only the nodes on the path to the parts that have
+        changed since last time need to be copied, and the rest of the new snapshot shares
+        the data of the previous one.
+
+        @see ValueTree::createSnapshot
+    */
+    class Snapshot;
+
+    /** Returns an immutable snapshot of the current state of this tree and its sub-nodes.
+        This must be called on the thread that is changing the tree, but the snapshot
+        that it returns can then be passed to and read by any other thread.
+        @see Snapshot
+    */
+    Snapshot createSnapshot() const;
+
     //==============================================================================
     /** Returns the type of this node.
         The type is specified when the ValueTree is created.
@@ -248,6 +274,38 @@ public:
     */
     ValueTree getChildWithProperty (const Identifier propertyName, const var& propertyValue) const;
 
+    /** Makes this node keep an index of its children's types, so that getChildWithName() and
+        getOrCreateChildWithName() can find a child without scanning through them all.
+
+        This is worth doing for a node that has a large number of children, if you need to
+        look them up by type a lot. The index is kept up-to-date as children are added,
+        removed and moved, and it isn't shared with other nodes, although it will be set up
+        again on a copy made with createCopy().
+
+        @see indexChildrenByProperty, removeChildIndexes
+    */
+    void indexChildrenByType();
+
+    /** Makes this node keep an index of the values that its children have for a particular
+        property, so that getChildWithProperty() can find a child without scanning through
+        them all.
+
+        You can index as many different properties as you need to. The index is kept up-to-date
+        as children are added, removed and moved, and as the property is changed on them.
+
+        Note that the index matches values by their string form, so the value you search for
+        should be the same type as the values that the children hold. E.g. if the children hold
+        doubles, searching for an int may not find a child whose value is equal to it.
+
+        @see indexChildrenByType, removeChildIndexes
+    */
+    void indexChildrenByProperty (const Identifier propertyName);
+
+    /** Removes any indexes that were added with indexChildrenByType() or indexChildrenByProperty().
+        @see indexChildrenByType, indexChildrenByProperty
+    */
+    void removeChildIndexes();
+
     /** Adds a child to this node.
 
         Make sure that the child is removed from any former parent node before calling this, or
@@ -360,6 +418,36 @@ public:
     */
     static ValueTree readFromGZIPData (const void* data, size_t numBytes);
 
+    /** Stores this tree (and all its children) in an indexed binary format.
+
+        Unlike writeToStream(), this stores each type and property name just once, in a table,
+        and it records where each node's children are in the data. That lets the tree be opened
+        with readFromIndexedFile(), which only loads each node's children when they're first
+        needed, so a large file can be opened very quickly if you only look at part of it.
+
+        The stream doesn't need to be seekable.
+        @see readFromIndexedFile, readFromIndexedData
+    */
+    void writeToIndexedStream (OutputStream& output) const;
+
+    /** Opens a file that was written with writeToIndexedStream().
+
+        The file is memory-mapped, and the children of each node are only read from it when
+        something first needs them, so only the parts of the tree that you use get loaded.
+        Because of this, the file must not be changed or deleted while the tree (or any part
+        of it that hasn't been fully loaded) is still in use. If the file can't be opened, or
+        isn't in the right format, this returns an invalid tree.
+        @see writeToIndexedStream
+    */
+    static ValueTree readFromIndexedFile (const File& file);
+
+    /** Loads a tree from a data block that was written with writeToIndexedStream().
+        The data is copied, so the block doesn't need to stay valid after this returns, and
+        the nodes are loaded lazily from the copy, in the same way as readFromIndexedFile().
+        @see writeToIndexedStream
+    */
+    static ValueTree readFromIndexedData (const void* data, size_t numBytes);
+
     //==============================================================================
     /** Listener class for events that happen to a ValueTree.
 
@@ -442,9 +530,14 @@ public:
         will last for as long as you need the listener. In general, you'd never want to add a
         listener to a local stack-based ValueTree, and would usually add one to a member variable.
 
+        If wantsChangesToSubTrees is false, the listener will only be told about changes to
+        the properties and children of this tree itself, and not about changes that happen
+        further down inside its sub-trees. This saves a lot of pointless callbacks for a
+        listener that's attached near the root of a large tree.
+
         @see removeListener
     */
-    void addListener (Listener* listener);
+    void addListener (Listener* listener, bool wantsChangesToSubTrees = true);
 
     /** Removes a listener that was previously added with addListener(). */
     void removeListener (Listener* listener);
@@ -454,6 +547,32 @@ public:
     */
     void sendPropertyChangeMessage (const Identifier property);
 
+    //==============================================================================
+    /**
+        Holds back the listener callbacks for a tree while a batch of changes is made to it.
+
+        While one of these objects exists, any changes made to the tree or to any of its
+        sub-trees are recorded instead of being sent to the listeners straight away. When the
+        object is deleted, the recorded callbacks are all delivered, in the order in which
+        the changes happened. Repeated changes to the same property of the same tree, and
+        repeated re-orderings of the same tree's children are only reported once.
+
+        This makes bulk edits (e.g. loading or pasting a large number of nodes) much cheaper,
+        because the listeners aren't kept busy responding to each intermediate state. Batches
+        can be nested, and the callbacks are sent when the outermost one finishes.
+
+        E.g. @code
+        {
+            ValueTree::ScopedNotificationBatch batch (myTree);
+
+            for (int i = 0; i < 5000; ++i)
+                myTree.addChild (ValueTree ("item"), -1, nullptr);
+
+        } // all the childAdded callbacks get made here
+        @endcode
+    */
+    class ScopedNotificationBatch;
+
     //==============================================================================
     /** This method uses a comparator object to sort the tree's children into order.
 
@@ -498,9 +617,12 @@ private:
     //==============================================================================
     class SharedObject;
     friend class SharedObject;
+    class SnapshotNode;
+    class IndexedDataSource;
+    class IndexedFormatWriter;
 
     ReferenceCountedObjectPtr<SharedObject> object;
-    ListenerList<Listener> listeners;
+    ListenerList<Listener> listeners, localListeners;
 
     template <typename ElementComparator>
     struct ComparatorAdapter
@@ -519,9 +641,112 @@ private:
 
     void createListOfChildren (OwnedArray<ValueTree>&) const;
     void reorderChildren (const OwnedArray<ValueTree>&, UndoManager*);
+    bool hasListeners() const noexcept;
 
     explicit ValueTree (SharedObject*);
 };
 
+//==============================================================================
+class JUCE_API  ValueTree::ScopedNotificationBatch
+{
+public:
+    /** Starts batching the notifications for the given tree and its sub-trees. */
+    explicit ScopedNotificationBatch (const ValueTree& treeToBatch);
+
+    /** Ends the batch, delivering the pending callbacks if this was the outermost one. */
+    ~ScopedNotificationBatch();
+
+private:
+    const ValueTree tree;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedNotificationBatch)
+};
+
+//==============================================================================
+class JUCE_API  ValueTree::Snapshot
+{
+public:
+    /** Creates an invalid snapshot. */
+    Snapshot() noexcept;
+
+    /** Creates another reference to the same snapshot data. */
+    Snapshot (const Snapshot& other) noexcept;
+
+    /** Makes this refer to the same snapshot data as another one. */
+    Snapshot& operator= (const Snapshot& other) noexcept;
+
+    /** Destructor. */
+    ~Snapshot();
+
+    /** Returns true if both snapshots refer to the same data.
+        Because the parts of a tree that haven't changed are shared between the snapshots
+        that are taken of it, you can use this to quickly skip over the sub-trees that are
+        the same in an old and a new snapshot.
+    */
+    bool operator== (const Snapshot& other) const noexcept;
+
+    /** Returns true if the snapshots refer to different data. */
+    bool operator!= (const Snapshot& other) const noexcept;
+
+    /** Returns true if this snapshot holds some valid data. */
+    bool isValid() const noexcept;
+
+    /** Returns the type of the node that this is a snapshot of. */
+    Identifier getType() const noexcept;
+
+    /** Returns true if the node had this type. */
+    bool hasType (const Identifier typeName) const noexcept;
+
+    /** Returns the value of a named property, or a void var if it's not there. */
+    const var& getProperty (const Identifier name) const noexcept;
+
+    /** Returns the value of a named property, or the default value if it's not there. */
+    var getProperty (const Identifier name, const var& defaultReturnValue) const;
+
+    /** Returns the value of a named property, or a void var if it's not there. */
+    const var& operator[] (const Identifier name) const noexcept;
+
+    /** Returns true if the node had a property with this name. */
+    bool hasProperty (const Identifier name) const noexcept;
+
+    /** Returns the number of properties. */
+    int getNumProperties() const noexcept;
+
+    /** Returns the name of one of the properties, or an empty identifier if the index is out of range. */
+    Identifier getPropertyName (int index) const noexcept;
+
+    /** Returns the number of child nodes. */
+    int getNumChildren() const noexcept;
+
+    /** Returns a snapshot of one of the child nodes, or an invalid one if the index is out of range. */
+    Snapshot getChild (int index) const;
+
+    /** Returns the first child with the specified type, or an invalid snapshot if there isn't one. */
+    Snapshot getChildWithName (const Identifier type) const;
+
+    /** Creates a new ValueTree containing a copy of this snapshot's data.
+        This can be used to restore the state of a tree from a snapshot, e.g. for an
+        undo checkpoint.
+    */
+    ValueTree createValueTree() const;
+
+    /** Creates an XmlElement that holds the snapshot's data.
+        The caller must delete the object that is returned.
+        @see ValueTree::createXml
+    */
+    XmlElement* createXml() const;
+
+    /** Writes the snapshot to a stream, in the same format as ValueTree::writeToStream(),
+        so that it can be read back with ValueTree::readFromStream().
+    */
+    void writeToStream (OutputStream& output) const;
+
+private:
+    friend class ValueTree;
+    ReferenceCountedObjectPtr<SnapshotNode> node;
+
+    explicit Snapshot (SnapshotNode*) noexcept;
+};
+
 
 #endif   // __JUCE_VALUETREE_JUCEHEADER__
@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#if JUCE_UNIT_TESTS
+
+namespace ListenerListTestHelpers
+{
+    struct TestListener
+    {
+        TestListener() : listToRemoveFrom (nullptr), listenerToRemove (nullptr) {}
+
+        void callback (int amount)
+        {
+            total += amount;
+
+            if (listToRemoveFrom != nullptr)
+                listToRemoveFrom->remove (listenerToRemove);
+        }
+
+        Atomic<int> total;
+        ThreadSafeListenerList<TestListener>* listToRemoveFrom;
+        TestListener* listenerToRemove;
+    };
+
+    struct CallingThread  : public Thread
+    {
+        CallingThread (ThreadSafeListenerList<TestListener>& list_)
+            : Thread ("listener test"), list (list_)
+        {
+            startThread();
+        }
+
+        ~CallingThread()
+        {
+            stopThread (5000);
+        }
+
+        void run()
+        {
+            while (! threadShouldExit())
+                list.call (&TestListener::callback, 1);
+        }
+
+        ThreadSafeListenerList<TestListener>& list;
+    };
+}
+
+class ThreadSafeListenerListTests  : public UnitTest
+{
+public:
+    ThreadSafeListenerListTests() : UnitTest ("ThreadSafeListenerList") {}
+
+    void runTest()
+    {
+        using namespace ListenerListTestHelpers;
+
+        beginTest ("Adding and removing");
+
+        {
+            ThreadSafeListenerList<TestListener> list;
+            TestListener a, b;
+
+            expect (list.isEmpty());
+            list.add (&a);
+            list.add (&b);
+            list.add (&a);
+            expectEquals (list.size(), 2);
+            expect (list.contains (&a) && list.contains (&b));
+
+            list.call (&TestListener::callback, 3);
+            expectEquals (a.total.get(), 3);
+            expectEquals (b.total.get(), 3);
+
+            list.remove (&a);
+            expect (! list.contains (&a));
+            list.call (&TestListener::callback, 1);
+            expectEquals (a.total.get(), 3);
+            expectEquals (b.total.get(), 4);
+
+            list.clear();
+            expect (list.isEmpty());
+        }
+
+        beginTest ("Removing during a call");
+
+        {
+            ThreadSafeListenerList<TestListener> list;
+            TestListener first, second;
+
+            // listeners are called in reverse order, so 'second' is called first
+            list.add (&first);
+            list.add (&second);
+            second.listToRemoveFrom = &list;
+            second.listenerToRemove = &first;
+
+            list.call (&TestListener::callback, 1);
+            expectEquals (second.total.get(), 1);
+            expectEquals (first.total.get(), 0);
+            expectEquals (list.size(), 1);
+        }
+
+        beginTest ("Calling from several threads");
+
+        {
+            ThreadSafeListenerList<TestListener> list;
+            TestListener listeners[8];
+            OwnedArray<CallingThread> threads;
+
+            for (int i = 0; i < 4; ++i)
+                threads.add (new CallingThread (list));
+
+            Random r;
+
+            for (int i = 0; i < 20000; ++i)
+            {
+                TestListener* const l = listeners + r.nextInt (numElementsInArray (listeners));
+
+                if (r.nextBool())
+                    list.add (l);
+                else
+                    list.remove (l);
+            }
+
+            for (int i = 0; i < numElementsInArray (listeners); ++i)
+                list.add (listeners + i);
+
+            const int totalBefore = listeners[0].total.get();
+            Thread::sleep (20);
+            threads.clear();
+
+            expect (listeners[0].total.get() > totalBefore);
+            expectEquals (list.size(), numElementsInArray (listeners));
+        }
+    }
+};
+
+static ThreadSafeListenerListTests threadSafeListenerListTests;
+
+//==============================================================================
+namespace ListenerListTestHelpers
+{
+    struct BenchmarkListener
+    {
+        BenchmarkListener() : total (0) {}
+        void callback (int amount)      { total += amount; }
+        int total;
+    };
+}
+
+template <class ListType>
+class ListenerListBenchmark  : public Benchmark
+{
+public:
+    ListenerListBenchmark (const String& name) : Benchmark (name) {}
+
+    void initialise()
+    {
+        for (int i = 0; i < numElementsInArray (listeners); ++i)
+            list.add (listeners + i);
+    }
+
+    void runIteration()
+    {
+        for (int i = 0; i < 100; ++i)
+            list.call (&ListenerListTestHelpers::BenchmarkListener::callback, i);
+
+        preventOptimisation (listeners);
+    }
+
+    void shutdown()
+    {
+        list.clear();
+    }
+
+private:
+    ListType list;
+    ListenerListTestHelpers::BenchmarkListener listeners[8];
+};
+
+static ListenerListBenchmark<ListenerList<ListenerListTestHelpers::BenchmarkListener> >
+    listenerListBenchmark ("ListenerList: 100 calls to 8 listeners");
+
+static ListenerListBenchmark<ListenerList<ListenerListTestHelpers::BenchmarkListener,
+                                          Array<ListenerListTestHelpers::BenchmarkListener*, CriticalSection> > >
+    lockedListenerListBenchmark ("ListenerList with a CriticalSection: 100 calls to 8 listeners");
+
+static ListenerListBenchmark<ThreadSafeListenerList<ListenerListTestHelpers::BenchmarkListener> >
+    threadSafeListenerListBenchmark ("ThreadSafeListenerList: 100 calls to 8 listeners");
+
+#endif
@@ -64,6 +64,12 @@
     operation. For an example of a bail-out checker, see the Component::BailOutChecker class,
     which can be used to check when a Component has been deleted. See also
     ListenerList::DummyBailOutChecker, which is a dummy checker that always returns false.
+
+    A ListenerList isn't thread-safe unless you give it an ArrayType with a real lock, and
+    even then it'll take that lock for every listener that it calls. If listeners need to be
+    called from several threads, a ThreadSafeListenerList will usually be a better choice.
+
+    @see ThreadSafeListenerList
 */
 template <class ListenerClass,
           class ArrayType = Array <ListenerClass*> >
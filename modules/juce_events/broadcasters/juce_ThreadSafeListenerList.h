@@ -0,0 +1,444 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_THREADSAFELISTENERLIST_JUCEHEADER__
+#define __JUCE_THREADSAFELISTENERLIST_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A version of ListenerList which can have listeners added, removed and called from
+    any number of threads at the same time.
+
+    The calling methods work in the same way as ListenerList's, but instead of iterating
+    the live array, each call iterates an immutable snapshot of it. Adding or removing a
+    listener builds a new snapshot and swaps it in, so calling the listeners never needs
+    to take a lock or allocate any memory, and a slow callback can't hold up threads that
+    want to change the list. Old snapshots are deleted once no thread is still using them.
+
+    If a listener is removed while a call is in progress, it won't be called after
+    remove() has returned on the thread that's doing the calling. If a different thread
+    removes it, it could still be in the middle of a callback when remove() returns, so
+    you'll need to make sure it isn't deleted until any callbacks that might be using it
+    have finished.
+
+    Because every change copies the whole array, this is best suited to lists which are
+    called much more often than they're changed. For a list that's only used by one
+    thread, a plain ListenerList is cheaper.
+
+    @see ListenerList
+*/
+template <class ListenerClass>
+class ThreadSafeListenerList
+{
+    // Horrible macros required to support VC7..
+    #ifndef DOXYGEN
+     #if JUCE_VC8_OR_EARLIER
+       #define LL_TEMPLATE(a)   typename P##a, typename Q##a
+       #define LL_PARAM(a)      Q##a& param##a
+     #else
+       #define LL_TEMPLATE(a)   typename P##a
+       #define LL_PARAM(a)      PARAMETER_TYPE(P##a) param##a
+     #endif
+    #endif
+
+    typedef Array<ListenerClass*> ListenerArray;
+
+    // While one of these exists, the snapshot it picked up can't be deleted.
+    struct ScopedReader
+    {
+        ScopedReader (const ThreadSafeListenerList& owner_) noexcept
+            : owner (owner_)
+        {
+            ++(owner.numActiveReaders);
+            list = owner.current.get();
+        }
+
+        ~ScopedReader() noexcept
+        {
+            if (--(owner.numActiveReaders) == 0 && owner.numRetiredSnapshots.get() > 0)
+                owner.deleteUnusedSnapshots();
+        }
+
+        const ThreadSafeListenerList& owner;
+        const ListenerArray* list;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedReader)
+    };
+
+public:
+    //==============================================================================
+    /** Creates an empty list. */
+    ThreadSafeListenerList() noexcept
+    {
+    }
+
+    /** Destructor. */
+    ~ThreadSafeListenerList()
+    {
+        // The list is being deleted while another thread is calling its listeners!
+        jassert (numActiveReaders.get() == 0);
+
+        delete current.get();
+
+        for (int i = retiredSnapshots.size(); --i >= 0;)
+            delete retiredSnapshots.getUnchecked (i);
+    }
+
+    //==============================================================================
+    /** Adds a listener to the list.
+        A listener can only be added once, so if the listener is already in the list,
+        this method has no effect.
+        @see remove
+    */
+    void add (ListenerClass* const listenerToAdd)
+    {
+        // Listeners can't be null pointers!
+        jassert (listenerToAdd != nullptr);
+
+        if (listenerToAdd != nullptr)
+        {
+            const ScopedLock sl (writeLock);
+            const ListenerArray* const oldList = current.get();
+
+            if (oldList == nullptr || ! oldList->contains (listenerToAdd))
+            {
+                ListenerArray* const newList = (oldList != nullptr) ? new ListenerArray (*oldList)
+                                                                    : new ListenerArray();
+                newList->add (listenerToAdd);
+                publish (newList);
+            }
+        }
+    }
+
+    /** Removes a listener from the list.
+        If the listener wasn't in the list, this has no effect.
+    */
+    void remove (ListenerClass* const listenerToRemove)
+    {
+        // Listeners can't be null pointers!
+        jassert (listenerToRemove != nullptr);
+
+        const ScopedLock sl (writeLock);
+        const ListenerArray* const oldList = current.get();
+
+        if (oldList != nullptr && oldList->contains (listenerToRemove))
+        {
+            ListenerArray* newList = nullptr;
+
+            if (oldList->size() > 1)
+            {
+                newList = new ListenerArray (*oldList);
+                newList->removeFirstMatchingValue (listenerToRemove);
+            }
+
+            publish (newList);
+        }
+    }
+
+    /** Returns the number of registered listeners. */
+    int size() const noexcept
+    {
+        const ScopedReader reader (*this);
+        return reader.list != nullptr ? reader.list->size() : 0;
+    }
+
+    /** Returns true if any listeners are registered. */
+    bool isEmpty() const noexcept
+    {
+        return current.get() == nullptr;
+    }
+
+    /** Clears the list. */
+    void clear()
+    {
+        const ScopedLock sl (writeLock);
+
+        if (current.get() != nullptr)
+            publish (nullptr);
+    }
+
+    /** Returns true if the specified listener has been added to the list. */
+    bool contains (ListenerClass* const listener) const noexcept
+    {
+        const ScopedReader reader (*this);
+        return reader.list != nullptr && reader.list->contains (listener);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with no parameters. */
+    void call (void (ListenerClass::*callbackFunction) ())
+    {
+        for (Iterator<DummyBailOutChecker> iter (*this); iter.next();)
+            (iter.getListener()->*callbackFunction) ();
+    }
+
+    /** Calls a member function on each listener in the list, with no parameters and a bail-out-checker.
+        See the ListenerList class description for info about writing a bail-out checker. */
+    template <class BailOutCheckerType>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) ())
+    {
+        for (Iterator<BailOutCheckerType> iter (*this); iter.next (bailOutChecker);)
+            (iter.getListener()->*callbackFunction) ();
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 1 parameter. */
+    template <LL_TEMPLATE(1)>
+    void call (void (ListenerClass::*callbackFunction) (P1), LL_PARAM(1))
+    {
+        for (Iterator<DummyBailOutChecker> iter (*this); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1);
+    }
+
+    /** Calls a member function on each listener in the list, with one parameter and a bail-out-checker.
+        See the ListenerList class description for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, LL_TEMPLATE(1)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1),
+                      LL_PARAM(1))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this); iter.next (bailOutChecker);)
+            (iter.getListener()->*callbackFunction) (param1);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 2 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2),
+               LL_PARAM(1), LL_PARAM(2))
+    {
+        for (Iterator<DummyBailOutChecker> iter (*this); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1, param2);
+    }
+
+    /** Calls a member function on each listener in the list, with 2 parameters and a bail-out-checker.
+        See the ListenerList class description for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, LL_TEMPLATE(1), LL_TEMPLATE(2)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1, P2),
+                      LL_PARAM(1), LL_PARAM(2))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this); iter.next (bailOutChecker);)
+            (iter.getListener()->*callbackFunction) (param1, param2);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 3 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3),
+               LL_PARAM(1), LL_PARAM(2), LL_PARAM(3))
+    {
+        for (Iterator<DummyBailOutChecker> iter (*this); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3);
+    }
+
+    /** Calls a member function on each listener in the list, with 3 parameters and a bail-out-checker.
+        See the ListenerList class description for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1, P2, P3),
+                      LL_PARAM(1), LL_PARAM(2), LL_PARAM(3))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this); iter.next (bailOutChecker);)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 4 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4),
+               LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4))
+    {
+        for (Iterator<DummyBailOutChecker> iter (*this); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3, param4);
+    }
+
+    /** Calls a member function on each listener in the list, with 4 parameters and a bail-out-checker.
+        See the ListenerList class description for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1, P2, P3, P4),
+                      LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this); iter.next (bailOutChecker);)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3, param4);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 5 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4), LL_TEMPLATE(5)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5),
+               LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5))
+    {
+        for (Iterator<DummyBailOutChecker> iter (*this); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3, param4, param5);
+    }
+
+    /** Calls a member function on each listener in the list, with 5 parameters and a bail-out-checker.
+        See the ListenerList class description for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4), LL_TEMPLATE(5)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5),
+                      LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this); iter.next (bailOutChecker);)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3, param4, param5);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 6 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4), LL_TEMPLATE(5), LL_TEMPLATE(6)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5, P6),
+               LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5), LL_PARAM(6))
+    {
+        for (Iterator<DummyBailOutChecker> iter (*this); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3, param4, param5, param6);
+    }
+
+    /** Calls a member function on each listener in the list, with 6 parameters and a bail-out-checker.
+        See the ListenerList class description for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4), LL_TEMPLATE(5), LL_TEMPLATE(6)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5, P6),
+                      LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5), LL_PARAM(6))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this); iter.next (bailOutChecker);)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3, param4, param5, param6);
+    }
+
+    //==============================================================================
+    /** A dummy bail-out checker that always returns false.
+        See the ListenerList notes for more info about bail-out checkers.
+    */
+    class DummyBailOutChecker
+    {
+    public:
+        inline bool shouldBailOut() const noexcept     { return false; }
+    };
+
+    //==============================================================================
+    /** Iterates a snapshot of the listeners in a ThreadSafeListenerList.
+        While an Iterator exists, none of the list's old snapshots will be deleted.
+    */
+    template <class BailOutCheckerType>
+    class Iterator
+    {
+    public:
+        //==============================================================================
+        Iterator (const ThreadSafeListenerList& listToIterate) noexcept
+            : reader (listToIterate),
+              index (reader.list != nullptr ? reader.list->size() : 0),
+              listener (nullptr)
+        {}
+
+        ~Iterator() noexcept {}
+
+        //==============================================================================
+        bool next() noexcept
+        {
+            while (--index >= 0)
+            {
+                ListenerClass* const l = reader.list->getUnchecked (index);
+
+                // If the list has changed since this snapshot was taken, we need to skip any
+                // listeners that have been removed in the meantime. (This is just a plain read,
+                // because the same thread's own changes are all that it has to see).
+                const ListenerArray* const latest = reader.owner.current.value;
+
+                if (latest == reader.list || (latest != nullptr && latest->contains (l)))
+                {
+                    listener = l;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool next (const BailOutCheckerType& bailOutChecker) noexcept
+        {
+            return (! bailOutChecker.shouldBailOut()) && next();
+        }
+
+        ListenerClass* getListener() const noexcept
+        {
+            return listener;
+        }
+
+        //==============================================================================
+    private:
+        const ScopedReader reader;
+        int index;
+        ListenerClass* listener;
+
+        JUCE_DECLARE_NON_COPYABLE (Iterator)
+    };
+
+private:
+    //==============================================================================
+    Atomic<ListenerArray*> current;
+    mutable Atomic<int> numActiveReaders, numRetiredSnapshots;
+    mutable Array<ListenerArray*> retiredSnapshots;
+    CriticalSection writeLock;
+
+    // Swaps in a new snapshot. The writeLock must be held when calling this.
+    void publish (ListenerArray* const newList)
+    {
+        if (ListenerArray* const oldList = current.exchange (newList))
+        {
+            retiredSnapshots.add (oldList);
+            ++numRetiredSnapshots;
+        }
+
+        deleteUnusedSnapshots();
+    }
+
+    void deleteUnusedSnapshots() const noexcept
+    {
+        // (a reader that's finishing mustn't block, so if a writer is busy, it can do this instead)
+        const ScopedTryLock sl (writeLock);
+
+        // Any reader that starts after a snapshot was retired will pick up a newer one, so if
+        // there are no readers at this point, none of the retired snapshots can still be in use.
+        if (sl.isLocked() && numActiveReaders.get() == 0)
+        {
+            for (int i = retiredSnapshots.size(); --i >= 0;)
+                delete retiredSnapshots.getUnchecked (i);
+
+            retiredSnapshots.clearQuick();
+            numRetiredSnapshots = 0;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ThreadSafeListenerList)
+
+    #undef LL_TEMPLATE
+    #undef LL_PARAM
+};
+
+
+#endif   // __JUCE_THREADSAFELISTENERLIST_JUCEHEADER__
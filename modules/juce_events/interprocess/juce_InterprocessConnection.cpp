@@ -23,13 +23,184 @@
   ==============================================================================
 */
 
+//==============================================================================
+/*  The threads that look after a server's connections when it's running with
+    an event loop, rather than a thread per connection.
+*/
+class InterprocessConnection::EventLoopPool  : public ReferenceCountedObject
+{
+public:
+    EventLoopPool (const int numThreads)
+        : isShutDown (false)
+    {
+        for (int i = 0; i < jmax (1, numThreads); ++i)
+            threads.add (new LoopThread());
+    }
+
+    ~EventLoopPool()
+    {
+        shutDown();
+    }
+
+    bool isValid() const noexcept
+    {
+        for (int i = threads.size(); --i >= 0;)
+            if (! threads.getUnchecked(i)->loop.isValid())
+                return false;
+
+        return true;
+    }
+
+    SocketEventLoop& getAcceptorLoop() const noexcept
+    {
+        return threads.getUnchecked(0)->loop;
+    }
+
+    SocketEventLoop* addConnection (InterprocessConnection* const connection)
+    {
+        const ScopedLock sl (lock);
+
+        if (isShutDown)
+            return nullptr;
+
+        LoopThread* quietest = threads.getUnchecked (0);
+
+        for (int i = 1; i < threads.size(); ++i)
+            if (threads.getUnchecked(i)->loop.getNumSockets() < quietest->loop.getNumSockets())
+                quietest = threads.getUnchecked(i);
+
+        connections.add (connection);
+        return &(quietest->loop);
+    }
+
+    void removeConnection (InterprocessConnection* const connection)
+    {
+        const ScopedLock sl (lock);
+        connections.removeFirstMatchingValue (connection);
+    }
+
+    void shutDown()
+    {
+        // This can't be done from inside one of the pool's own callbacks!
+        jassert (! isPoolThread());
+
+        for (int i = threads.size(); --i >= 0;)
+            threads.getUnchecked(i)->stop();
+
+        // Now that none of the threads are running, any remaining connections can be closed
+        const ScopedLock sl (lock);
+        isShutDown = true;
+
+        while (connections.size() > 0)
+            connections.remove (connections.size() - 1)->eventLoopShutDown();
+    }
+
+    typedef ReferenceCountedObjectPtr<EventLoopPool> Ptr;
+
+private:
+    struct LoopThread  : public Thread
+    {
+        LoopThread() : Thread ("Juce IPC event loop")
+        {
+            startThread();
+        }
+
+        void run()
+        {
+            while (! threadShouldExit())
+                if (loop.runOnce (-1) < 0)
+                    wait (10);
+        }
+
+        void stop()
+        {
+            signalThreadShouldExit();
+            loop.wakeUp();
+            stopThread (4000);
+        }
+
+        SocketEventLoop loop;
+    };
+
+    OwnedArray<LoopThread> threads;
+    CriticalSection lock;
+    Array<InterprocessConnection*> connections;
+    bool isShutDown;
+
+    bool isPoolThread() const
+    {
+        const Thread::ThreadID current = Thread::getCurrentThreadId();
+
+        for (int i = threads.size(); --i >= 0;)
+            if (threads.getUnchecked(i)->getThreadId() == current)
+                return true;
+
+        return false;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (EventLoopPool)
+};
+
+//==============================================================================
+/*  Keeps a few of the blocks that incoming messages were delivered in, so that
+    a steady stream of messages doesn't need a new allocation for each one.
+*/
+class InterprocessConnection::BufferPool  : public ReferenceCountedObject
+{
+public:
+    BufferPool() noexcept : numFree (0) {}
+
+    void take (MemoryBlock& block, const size_t size)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            if (numFree > 0)
+                block.swapWith (blocks [--numFree]);
+        }
+
+        // (if the messages are all the same size, as they often are, this won't reallocate)
+        block.setSize (size);
+    }
+
+    void recycle (MemoryBlock& block)
+    {
+        if (block.getSize() > 0 && block.getSize() <= maxPooledBlockSize)
+        {
+            const ScopedLock sl (lock);
+
+            if (numFree < numElementsInArray (blocks))
+                blocks [numFree++].swapWith (block);
+        }
+    }
+
+    typedef ReferenceCountedObjectPtr<BufferPool> Ptr;
+
+private:
+    enum { maxPooledBlockSize = 1024 * 1024 };
+
+    CriticalSection lock;
+    MemoryBlock blocks [16];
+    int numFree;
+
+    JUCE_DECLARE_NON_COPYABLE (BufferPool)
+};
+
+//==============================================================================
 InterprocessConnection::InterprocessConnection (const bool callbacksOnMessageThread,
                                                 const uint32 magicMessageHeaderNumber)
     : Thread ("Juce IPC connection"),
       callbackConnectionState (false),
       useMessageThread (callbacksOnMessageThread),
       magicMessageHeader (magicMessageHeaderNumber),
-      pipeReceiveMessageTimeout (-1)
+      pipeReceiveMessageTimeout (-1),
+      eventLoop (nullptr),
+      numIncomingBytes (0),
+      numOutgoingBytes (0),
+      numOutgoingBytesSent (0),
+      maxBatchSize (65536),
+      batchMessages (false),
+      bufferPool (new BufferPool())
 {
 }
 
@@ -98,13 +269,59 @@ bool InterprocessConnection::createPipe (const String& pipeName, const int timeo
     return false;
 }
 
+bool InterprocessConnection::connectToSharedMemory (const String& name, const int writeTimeoutMs)
+{
+    disconnect();
+
+    ScopedPointer <SharedMemoryPipe> newPipe (new SharedMemoryPipe());
+
+    if (newPipe->openExisting (name))
+    {
+        const ScopedLock sl (pipeAndSocketLock);
+        pipeReceiveMessageTimeout = writeTimeoutMs;
+        initialiseWithSharedMemory (newPipe.release());
+        return true;
+    }
+
+    return false;
+}
+
+bool InterprocessConnection::createSharedMemory (const String& name, const int writeTimeoutMs, const int bufferSizeBytes)
+{
+    disconnect();
+
+    ScopedPointer <SharedMemoryPipe> newPipe (new SharedMemoryPipe());
+
+    if (newPipe->createNew (name, bufferSizeBytes))
+    {
+        const ScopedLock sl (pipeAndSocketLock);
+        pipeReceiveMessageTimeout = writeTimeoutMs;
+        initialiseWithSharedMemory (newPipe.release());
+        return true;
+    }
+
+    return false;
+}
+
 void InterprocessConnection::disconnect()
 {
-    if (socket != nullptr)
-        socket->close();
+    flushPendingMessages();
+    detachFromEventLoop();
 
-    if (pipe != nullptr)
-        pipe->close();
+    {
+        // the connection thread may delete these as soon as it notices them closing,
+        // so keep hold of the lock until we've finished with them
+        const ScopedLock sl (pipeAndSocketLock);
+
+        if (socket != nullptr)
+            socket->close();
+
+        if (pipe != nullptr)
+            pipe->close();
+
+        if (sharedMemory != nullptr)
+            sharedMemory->close();
+    }
 
     stopThread (4000);
 
@@ -112,6 +329,7 @@ void InterprocessConnection::disconnect()
         const ScopedLock sl (pipeAndSocketLock);
         socket = nullptr;
         pipe = nullptr;
+        sharedMemory = nullptr;
     }
 
     connectionLostInt();
@@ -122,13 +340,14 @@ bool InterprocessConnection::isConnected() const
     const ScopedLock sl (pipeAndSocketLock);
 
     return ((socket != nullptr && socket->isConnected())
-              || (pipe != nullptr && pipe->isOpen()))
-            && isThreadRunning();
+              || (pipe != nullptr && pipe->isOpen())
+              || (sharedMemory != nullptr && sharedMemory->isOpen()))
+            && (isThreadRunning() || eventLoop != nullptr);
 }
 
 String InterprocessConnection::getConnectedHostName() const
 {
-    if (pipe != nullptr)
+    if (pipe != nullptr || sharedMemory != nullptr)
         return "localhost";
 
     if (socket != nullptr)
@@ -149,20 +368,171 @@ bool InterprocessConnection::sendMessage (const MemoryBlock& message)
     messageHeader [0] = ByteOrder::swapIfBigEndian (magicMessageHeader);
     messageHeader [1] = ByteOrder::swapIfBigEndian ((uint32) message.getSize());
 
-    MemoryBlock messageData (sizeof (messageHeader) + message.getSize());
-    messageData.copyFrom (messageHeader, 0, sizeof (messageHeader));
-    messageData.copyFrom (message.getData(), sizeof (messageHeader), message.getSize());
+    // the header and message are written with a single call, rather than being copied into one block
+    const void* const buffers[] = { messageHeader, message.getData() };
+    const int sizes[] = { (int) sizeof (messageHeader), (int) message.getSize() };
+    const int numBuffers = message.getSize() > 0 ? 2 : 1;
+
+    const ScopedLock sl (pipeAndSocketLock);
+
+    if (socket == nullptr && pipe == nullptr && sharedMemory == nullptr)
+        return false;
+
+    if (batchMessages || numOutgoingBytes > 0)
+    {
+        queueOutgoingData (buffers, sizes, numBuffers, 0);
+
+        if (numOutgoingBytes - numOutgoingBytesSent < maxBatchSize && batchMessages)
+        {
+            // when running on an event loop, the queue will be written on its next pass
+            return eventLoop == nullptr
+                    || eventLoop->setEventsToWatch (socket->getRawSocketHandle(),
+                                                    SocketEventLoop::readyForReading | SocketEventLoop::readyForWriting);
+        }
+
+        return eventLoop != nullptr ? writeOutgoingData()
+                                    : writeQueuedData();
+    }
+
+    if (eventLoop != nullptr)
+    {
+        // when running on an event loop, anything that can't be sent straight away
+        // is queued, and sent when the socket is ready for more
+        const int bytesWritten = socket->write (buffers, sizes, numBuffers);
+
+        if (bytesWritten < 0)
+            return false;
+
+        if (bytesWritten < sizes[0] + sizes[1])
+        {
+            queueOutgoingData (buffers, sizes, numBuffers, (size_t) bytesWritten);
+            return writeOutgoingData();
+        }
+
+        return true;
+    }
 
-    int bytesWritten = 0;
+    return writeAll (buffers, sizes, numBuffers);
+}
+
+void InterprocessConnection::setMessageBatching (const bool shouldBatchMessages, const int maxBatchSizeBytes)
+{
+    {
+        const ScopedLock sl (pipeAndSocketLock);
+        batchMessages = shouldBatchMessages;
+        maxBatchSize = (size_t) jmax (1, maxBatchSizeBytes);
+    }
+
+    if (! shouldBatchMessages)
+        flushPendingMessages();
+}
 
+bool InterprocessConnection::flushPendingMessages()
+{
     const ScopedLock sl (pipeAndSocketLock);
 
-    if (socket != nullptr)
-        bytesWritten = socket->write (messageData.getData(), (int) messageData.getSize());
-    else if (pipe != nullptr)
-        bytesWritten = pipe->write (messageData.getData(), (int) messageData.getSize(), pipeReceiveMessageTimeout);
+    if (eventLoop != nullptr)
+        return writeOutgoingData();
+
+    return writeQueuedData();
+}
+
+bool InterprocessConnection::writeAll (const void* const* buffers, const int* sizes, const int numBuffers)
+{
+    // (the caller must hold pipeAndSocketLock)
+    if (sharedMemory != nullptr)
+    {
+        int totalSize = 0;
+        for (int i = 0; i < numBuffers; ++i)
+            totalSize += sizes[i];
+
+        return sharedMemory->write (buffers, sizes, numBuffers, pipeReceiveMessageTimeout) == totalSize;
+    }
+
+    if (pipe != nullptr)
+    {
+        for (int i = 0; i < numBuffers; ++i)
+            if (sizes[i] > 0 && pipe->write (buffers[i], sizes[i], pipeReceiveMessageTimeout) != sizes[i])
+                return false;
+
+        return true;
+    }
+
+    if (socket == nullptr)
+        return false;
+
+    const void* remainingBuffers[2];
+    int remainingSizes[2];
+    jassert (numBuffers <= numElementsInArray (remainingBuffers));
+
+    for (int i = 0; i < numBuffers; ++i)
+    {
+        remainingBuffers[i] = buffers[i];
+        remainingSizes[i] = sizes[i];
+    }
+
+    int index = 0;
 
-    return bytesWritten == (int) messageData.getSize();
+    while (index < numBuffers)
+    {
+        int bytesWritten = socket->write (remainingBuffers + index, remainingSizes + index, numBuffers - index);
+
+        if (bytesWritten <= 0)
+            return false;
+
+        while (index < numBuffers && bytesWritten >= remainingSizes[index])
+            bytesWritten -= remainingSizes [index++];
+
+        if (index < numBuffers)
+        {
+            remainingBuffers[index] = addBytesToPointer (remainingBuffers[index], bytesWritten);
+            remainingSizes[index] -= bytesWritten;
+        }
+    }
+
+    return true;
+}
+
+bool InterprocessConnection::writeQueuedData()
+{
+    // (the caller must hold pipeAndSocketLock)
+    if (numOutgoingBytesSent >= numOutgoingBytes)
+        return true;
+
+    const void* const data = static_cast <const char*> (outgoingData.getData()) + numOutgoingBytesSent;
+    const int size = (int) (numOutgoingBytes - numOutgoingBytesSent);
+    numOutgoingBytes = numOutgoingBytesSent = 0;
+
+    return writeAll (&data, &size, 1);
+}
+
+void InterprocessConnection::queueOutgoingData (const void* const* buffers, const int* sizes,
+                                                const int numBuffers, size_t numBytesToSkip)
+{
+    // (the caller must hold pipeAndSocketLock)
+    if (numOutgoingBytesSent > 0)
+    {
+        numOutgoingBytes -= numOutgoingBytesSent;
+        memmove (outgoingData.getData(), static_cast <const char*> (outgoingData.getData()) + numOutgoingBytesSent, numOutgoingBytes);
+        numOutgoingBytesSent = 0;
+    }
+
+    size_t totalSize = 0;
+
+    for (int i = 0; i < numBuffers; ++i)
+        totalSize += (size_t) sizes[i];
+
+    outgoingData.ensureSize (numOutgoingBytes + totalSize - numBytesToSkip);
+
+    for (int i = 0; i < numBuffers; ++i)
+    {
+        const size_t skip = jmin (numBytesToSkip, (size_t) sizes[i]);
+        const size_t num = (size_t) sizes[i] - skip;
+        numBytesToSkip -= skip;
+
+        outgoingData.copyFrom (static_cast <const char*> (buffers[i]) + skip, (int) numOutgoingBytes, num);
+        numOutgoingBytes += num;
+    }
 }
 
 //==============================================================================
@@ -174,6 +544,26 @@ void InterprocessConnection::initialiseWithSocket (StreamingSocket* const socket
     startThread();
 }
 
+void InterprocessConnection::initialiseWithEventLoop (StreamingSocket* const socket_, EventLoopPool* const pool)
+{
+    jassert (socket == nullptr && eventLoop == nullptr);
+    socket = socket_;
+    connectionMadeInt();
+
+    SocketEventLoop* const loop = pool->addConnection (this);
+
+    {
+        const ScopedLock sl (pipeAndSocketLock);
+        eventLoopPool = pool;
+        eventLoop = loop;
+    }
+
+    if (loop == nullptr
+         || ! socket->setBlockingMode (false)
+         || ! loop->addSocket (socket->getRawSocketHandle(), this, SocketEventLoop::readyForReading))
+        eventLoopConnectionLost();
+}
+
 void InterprocessConnection::initialiseWithPipe (NamedPipe* const pipe_)
 {
     jassert (pipe == nullptr);
@@ -182,6 +572,14 @@ void InterprocessConnection::initialiseWithPipe (NamedPipe* const pipe_)
     startThread();
 }
 
+void InterprocessConnection::initialiseWithSharedMemory (SharedMemoryPipe* const newPipe)
+{
+    jassert (sharedMemory == nullptr);
+    sharedMemory = newPipe;
+    connectionMadeInt();
+    startThread();
+}
+
 //==============================================================================
 struct ConnectionStateMessage  : public MessageManager::MessageBase
 {
@@ -232,12 +630,17 @@ void InterprocessConnection::connectionLostInt()
     }
 }
 
-struct DataDeliveryMessage  : public Message
+struct InterprocessConnection::DataDeliveryMessage  : public Message
 {
-    DataDeliveryMessage (InterprocessConnection* ipc, const MemoryBlock& d)
-        : owner (ipc), data (d)
+    DataDeliveryMessage (InterprocessConnection* ipc, BufferPool* const pool)
+        : owner (ipc), bufferPool (pool)
     {}
 
+    ~DataDeliveryMessage()
+    {
+        bufferPool->recycle (data);
+    }
+
     void messageCallback()
     {
         if (InterprocessConnection* const ipc = owner)
@@ -245,17 +648,24 @@ struct DataDeliveryMessage  : public Message
     }
 
     WeakReference<InterprocessConnection> owner;
+    BufferPool::Ptr bufferPool;
     MemoryBlock data;
 };
 
-void InterprocessConnection::deliverDataInt (const MemoryBlock& data)
+void InterprocessConnection::deliverDataInt (MemoryBlock& data)
 {
     jassert (callbackConnectionState);
 
     if (useMessageThread)
-        (new DataDeliveryMessage (this, data))->post();
+    {
+        DataDeliveryMessage* const message = new DataDeliveryMessage (this, bufferPool);
+        message->data.swapWith (data);
+        message->post();
+    }
     else
+    {
         messageReceived (data);
+    }
 }
 
 //==============================================================================
@@ -263,7 +673,7 @@ bool InterprocessConnection::readNextMessageInt()
 {
     uint32 messageHeader[2];
     const int bytes = socket != nullptr ? socket->read (messageHeader, sizeof (messageHeader), true)
-                                        : pipe  ->read (messageHeader, sizeof (messageHeader), -1);
+                                        : readFromPipe (messageHeader, sizeof (messageHeader));
 
     if (bytes == sizeof (messageHeader)
          && ByteOrder::swapIfBigEndian (messageHeader[0]) == magicMessageHeader)
@@ -272,7 +682,8 @@ bool InterprocessConnection::readNextMessageInt()
 
         if (bytesInMessage > 0)
         {
-            MemoryBlock messageData ((size_t) bytesInMessage, true);
+            MemoryBlock messageData;
+            bufferPool->take (messageData, (size_t) bytesInMessage);
             int bytesRead = 0;
 
             while (bytesInMessage > 0)
@@ -284,7 +695,7 @@ bool InterprocessConnection::readNextMessageInt()
                 void* const data = addBytesToPointer (messageData.getData(), bytesRead);
 
                 const int bytesIn = socket != nullptr ? socket->read (data, numThisTime, true)
-                                                      : pipe  ->read (data, numThisTime, -1);
+                                                      : readFromPipe (data, numThisTime);
 
                 if (bytesIn <= 0)
                     break;
@@ -293,8 +704,13 @@ bool InterprocessConnection::readNextMessageInt()
                 bytesInMessage -= bytesIn;
             }
 
+            if (bytesInMessage > 0)
+                zeromem (addBytesToPointer (messageData.getData(), bytesRead), (size_t) bytesInMessage);
+
             if (bytesRead >= 0)
                 deliverDataInt (messageData);
+
+            bufferPool->recycle (messageData);
         }
     }
     else if (bytes < 0)
@@ -312,12 +728,24 @@ bool InterprocessConnection::readNextMessageInt()
     return true;
 }
 
+int InterprocessConnection::readFromPipe (void* const destBuffer, const int numBytes)
+{
+    return pipe != nullptr ? pipe->read (destBuffer, numBytes, -1)
+                           : sharedMemory->read (destBuffer, numBytes, -1);
+}
+
 void InterprocessConnection::run()
 {
     while (! threadShouldExit())
     {
         if (socket != nullptr)
         {
+            if (batchMessages)
+            {
+                const ScopedLock sl (pipeAndSocketLock);
+                writeQueuedData();
+            }
+
             const int ready = socket->waitUntilReady (true, 0);
 
             if (ready < 0)
@@ -332,8 +760,21 @@ void InterprocessConnection::run()
             }
             else if (ready > 0)
             {
-                if (! readNextMessageInt())
+                // (incoming data is read in large blocks and then split into messages, rather
+                // than making separate calls to read each message's header and body)
+                const bool isStillOpen = readIncomingData (1);
+                deliverIncomingMessages();
+
+                if (! isStillOpen)
+                {
+                    {
+                        const ScopedLock sl (pipeAndSocketLock);
+                        socket = nullptr;
+                    }
+
+                    connectionLostInt();
                     break;
+                }
             }
             else
             {
@@ -358,9 +799,191 @@ void InterprocessConnection::run()
                     break;
             }
         }
+        else if (sharedMemory != nullptr)
+        {
+            // (if the other end closes, any messages that it sent beforehand will still be
+            // read before this fails)
+            if (! readNextMessageInt())
+                break;
+        }
         else
         {
             break;
         }
     }
 }
+
+//==============================================================================
+void InterprocessConnection::handleSocketEvent (int, const int events)
+{
+    bool isStillOpen = true;
+
+    if ((events & SocketEventLoop::readyForWriting) != 0)
+    {
+        const ScopedLock sl (pipeAndSocketLock);
+        isStillOpen = writeOutgoingData();
+    }
+
+    if (isStillOpen && (events & (SocketEventLoop::readyForReading | SocketEventLoop::closedOrError)) != 0)
+    {
+        isStillOpen = readIncomingData (16);
+        deliverIncomingMessages();
+    }
+
+    if (! isStillOpen && eventLoop != nullptr)
+        eventLoopConnectionLost();
+}
+
+bool InterprocessConnection::readIncomingData (const int maxNumReads)
+{
+    const int bytesPerRead = 65536;
+
+    // (the amount read in one go is limited, so that a busy connection can't hog the loop)
+    for (int i = 0; i < maxNumReads; ++i)
+    {
+        incomingData.ensureSize (numIncomingBytes + bytesPerRead);
+
+        const int bytesIn = socket->read (addBytesToPointer (incomingData.getData(), numIncomingBytes),
+                                          bytesPerRead, false);
+
+        if (bytesIn < 0)
+            return false;
+
+        numIncomingBytes += (size_t) bytesIn;
+
+        if (bytesIn < bytesPerRead)
+            break;
+    }
+
+    return true;
+}
+
+void InterprocessConnection::deliverIncomingMessages()
+{
+    SocketEventLoop* const loop = eventLoop;
+    size_t pos = 0;
+
+    while (numIncomingBytes - pos >= sizeof (uint32) * 2)
+    {
+        const char* const data = static_cast <const char*> (incomingData.getData()) + pos;
+
+        uint32 messageHeader[2];
+        memcpy (messageHeader, data, sizeof (messageHeader));
+
+        const size_t bytesInMessage = ByteOrder::swapIfBigEndian (messageHeader[1]);
+
+        if (ByteOrder::swapIfBigEndian (messageHeader[0]) != magicMessageHeader)
+        {
+            // (a bad header gets skipped, as it is by the threaded version)
+            pos += sizeof (messageHeader);
+            continue;
+        }
+
+        if (numIncomingBytes - pos - sizeof (messageHeader) < bytesInMessage)
+            break;
+
+        pos += sizeof (messageHeader) + bytesInMessage;
+
+        if (bytesInMessage > 0)
+        {
+            MemoryBlock message;
+            bufferPool->take (message, bytesInMessage);
+            message.copyFrom (data + sizeof (messageHeader), 0, bytesInMessage);
+
+            deliverDataInt (message);
+            bufferPool->recycle (message);
+
+            if (loop != nullptr && eventLoop == nullptr)
+                return; // the callback has disconnected us
+        }
+    }
+
+    if (pos > 0)
+    {
+        numIncomingBytes -= pos;
+        memmove (incomingData.getData(), static_cast <const char*> (incomingData.getData()) + pos, numIncomingBytes);
+    }
+}
+
+bool InterprocessConnection::writeOutgoingData()
+{
+    // (the caller must hold pipeAndSocketLock)
+    if (socket == nullptr || eventLoop == nullptr)
+        return false;
+
+    while (numOutgoingBytesSent < numOutgoingBytes)
+    {
+        const int bytesWritten = socket->write (static_cast <const char*> (outgoingData.getData()) + numOutgoingBytesSent,
+                                                (int) jmin ((size_t) 0x10000000, numOutgoingBytes - numOutgoingBytesSent));
+
+        if (bytesWritten < 0)
+            return false;
+
+        if (bytesWritten == 0)
+            break;
+
+        numOutgoingBytesSent += (size_t) bytesWritten;
+    }
+
+    const bool isFinished = numOutgoingBytesSent >= numOutgoingBytes;
+
+    if (isFinished)
+        numOutgoingBytes = numOutgoingBytesSent = 0;
+
+    eventLoop->setEventsToWatch (socket->getRawSocketHandle(),
+                                 isFinished ? SocketEventLoop::readyForReading
+                                            : (SocketEventLoop::readyForReading | SocketEventLoop::readyForWriting));
+    return true;
+}
+
+void InterprocessConnection::detachFromEventLoop()
+{
+    EventLoopPool::Ptr pool;
+    SocketEventLoop* loop = nullptr;
+    int handle = -1;
+
+    {
+        const ScopedLock sl (pipeAndSocketLock);
+        pool = eventLoopPool;
+        loop = eventLoop;
+        eventLoopPool = nullptr;
+        eventLoop = nullptr;
+
+        if (socket != nullptr)
+            handle = socket->getRawSocketHandle();
+    }
+
+    if (pool != nullptr)
+    {
+        pool->removeConnection (this);
+
+        // this waits for any callback that's in progress on another thread
+        if (loop != nullptr && handle >= 0)
+            loop->removeSocket (handle);
+    }
+}
+
+void InterprocessConnection::eventLoopConnectionLost()
+{
+    detachFromEventLoop();
+
+    {
+        const ScopedLock sl (pipeAndSocketLock);
+        socket = nullptr;
+    }
+
+    connectionLostInt();
+}
+
+void InterprocessConnection::eventLoopShutDown()
+{
+    // called when the server stops, after all of its threads have been stopped
+    {
+        const ScopedLock sl (pipeAndSocketLock);
+        eventLoopPool = nullptr;
+        eventLoop = nullptr;
+        socket = nullptr;
+    }
+
+    connectionLostInt();
+}
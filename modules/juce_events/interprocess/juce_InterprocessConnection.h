@@ -33,22 +33,24 @@ class MemoryBlock;
 //==============================================================================
 /**
     Manages a simple two-way messaging connection to another process, using either
-    a socket or a named pipe as the transport medium.
+    a socket, a named pipe or a block of shared memory as the transport medium.
 
-    To connect to a waiting socket or an open pipe, use the connectToSocket() or
-    connectToPipe() methods. If this succeeds, messages can be sent to the other end,
-    and incoming messages will result in a callback via the messageReceived()
+    To connect to a waiting socket, an open pipe or some shared memory, use the connectToSocket(),
+    connectToPipe() or connectToSharedMemory() methods. If this succeeds, messages can be sent to
+    the other end, and incoming messages will result in a callback via the messageReceived()
     method.
 
     To open a pipe and wait for another client to connect to it, use the createPipe()
-    method.
+    method, or createSharedMemory() to do the same with shared memory.
 
     To act as a socket server and create connections for one or more client, see the
-    InterprocessConnectionServer class.
+    InterprocessConnectionServer class. A server can either give each connection its own
+    thread, or serve them all from a small pool of threads using a SocketEventLoop.
 
-    @see InterprocessConnectionServer, Socket, NamedPipe
+    @see InterprocessConnectionServer, Socket, NamedPipe, SharedMemoryPipe
 */
-class JUCE_API  InterprocessConnection    : private Thread
+class JUCE_API  InterprocessConnection    : private Thread,
+                                            private SocketEventLoop::Listener
 {
 public:
     //==============================================================================
@@ -117,18 +119,55 @@ public:
     */
     bool createPipe (const String& pipeName, int pipeReceiveMessageTimeoutMs);
 
-    /** Disconnects and closes any currently-open sockets or pipes. */
+    /** Tries to connect the object to a block of shared memory that another process has created.
+
+        For this to work, another process on the same computer must already have opened
+        an InterprocessConnection object and used createSharedMemory() to create the memory
+        for this to connect to.
+
+        This behaves like a pipe, but the messages are passed through a pair of ring buffers in
+        memory that both processes share, so there's much less overhead than a pipe or socket,
+        especially when sending large messages.
+
+        @param name         the name of the shared memory - this should be unique to your app
+        @param writeTimeoutMs   a timeout to use when waiting for the other end to make space
+                                for a message, or -1 for an infinite timeout.
+        @returns true if it connects successfully.
+        @see createSharedMemory, SharedMemoryPipe
+    */
+    bool connectToSharedMemory (const String& name, int writeTimeoutMs);
+
+    /** Creates a block of shared memory for another process to connect to.
+
+        Another process can then use connectToSharedMemory() to connect to the other end.
+
+        @param name             the name to use for the shared memory - this should be unique to your app
+        @param writeTimeoutMs   a timeout to use when waiting for the other end to make space
+                                for a message, or -1 for an infinite timeout.
+        @param bufferSizeBytes  the size of the buffer to use in each direction. Messages bigger than
+                                this can still be sent, but the sender will have to wait while the
+                                receiver reads them in pieces.
+        @returns true if the memory was created, or false if it fails (e.g. if another process is
+                 already using the name).
+        @see connectToSharedMemory, SharedMemoryPipe
+    */
+    bool createSharedMemory (const String& name, int writeTimeoutMs, int bufferSizeBytes = 1024 * 1024);
+
+    /** Disconnects and closes any currently-open sockets, pipes or shared memory. */
     void disconnect();
 
-    /** True if a socket or pipe is currently active. */
+    /** True if a socket, pipe or block of shared memory is currently active. */
     bool isConnected() const;
 
-    /** Returns the socket that this connection is using (or nullptr if it uses a pipe). */
+    /** Returns the socket that this connection is using (or nullptr if it uses something else). */
     StreamingSocket* getSocket() const noexcept                 { return socket; }
 
-    /** Returns the pipe that this connection is using (or nullptr if it uses a socket). */
+    /** Returns the pipe that this connection is using (or nullptr if it uses something else). */
     NamedPipe* getPipe() const noexcept                         { return pipe; }
 
+    /** Returns the shared memory that this connection is using (or nullptr if it uses something else). */
+    SharedMemoryPipe* getSharedMemoryPipe() const noexcept      { return sharedMemory; }
+
     /** Returns the name of the machine at the other end of this connection.
         This may return an empty string if the name is unknown.
     */
@@ -145,6 +184,27 @@ public:
     */
     bool sendMessage (const MemoryBlock& message);
 
+    /** Turns the batching of outgoing messages on or off.
+
+        When batching is enabled, sendMessage() adds each message to a queue instead of
+        writing it immediately, so that a stream of small messages can be sent with far
+        fewer system calls. The queue gets written when it grows beyond maxBatchSizeBytes,
+        when flushPendingMessages() is called, or, for a socket connection, the next time
+        the connection's thread gets a chance to run, which is usually within a millisecond.
+        A pipe or shared memory connection only writes its queue when it's full or explicitly flushed.
+
+        Turning batching off writes any messages that are still queued.
+
+        @see flushPendingMessages
+    */
+    void setMessageBatching (bool shouldBatchMessages, int maxBatchSizeBytes = 65536);
+
+    /** Writes any messages that have been queued up while batching is turned on.
+        @returns false if there was an error writing the data
+        @see setMessageBatching
+    */
+    bool flushPendingMessages();
+
     //==============================================================================
     /** Called when the connection is first connected.
 
@@ -183,20 +243,49 @@ private:
     CriticalSection pipeAndSocketLock;
     ScopedPointer <StreamingSocket> socket;
     ScopedPointer <NamedPipe> pipe;
+    ScopedPointer <SharedMemoryPipe> sharedMemory;
     bool callbackConnectionState;
     const bool useMessageThread;
     const uint32 magicMessageHeader;
     int pipeReceiveMessageTimeout;
 
+    class EventLoopPool;
+    friend class EventLoopPool;
+    ReferenceCountedObjectPtr<EventLoopPool> eventLoopPool;
+    SocketEventLoop* eventLoop;
+    MemoryBlock incomingData, outgoingData;
+    size_t numIncomingBytes, numOutgoingBytes, numOutgoingBytesSent, maxBatchSize;
+    bool batchMessages;
+
+    class BufferPool;
+    struct DataDeliveryMessage;
+    friend class BufferPool;
+    friend struct DataDeliveryMessage;
+    ReferenceCountedObjectPtr<BufferPool> bufferPool;
+
     friend class InterprocessConnectionServer;
     void initialiseWithSocket (StreamingSocket*);
+    void initialiseWithEventLoop (StreamingSocket*, EventLoopPool*);
     void initialiseWithPipe (NamedPipe*);
+    void initialiseWithSharedMemory (SharedMemoryPipe*);
     void connectionMadeInt();
     void connectionLostInt();
-    void deliverDataInt (const MemoryBlock&);
+    void deliverDataInt (MemoryBlock&);
     bool readNextMessageInt();
+    int readFromPipe (void*, int);
     void run();
 
+    void handleSocketEvent (int, int);
+    bool readIncomingData (int maxNumReads);
+    void deliverIncomingMessages();
+    bool writeOutgoingData();
+    bool writeAll (const void* const*, const int*, int);
+    bool writeQueuedData();
+    void queueOutgoingData (const void* const*, const int*, int, size_t);
+    void detachFromEventLoop();
+    void eventLoopConnectionLost();
+    void eventLoopShutDown();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InterprocessConnection)
 };
 
@@ -34,7 +34,7 @@ InterprocessConnectionServer::~InterprocessConnectionServer()
 }
 
 //==============================================================================
-bool InterprocessConnectionServer::beginWaitingForSocket (const int portNumber)
+bool InterprocessConnectionServer::beginWaitingForSocket (const int portNumber, const int numEventLoopThreads)
 {
     stop();
 
@@ -42,8 +42,21 @@ bool InterprocessConnectionServer::beginWaitingForSocket (const int portNumber)
 
     if (socket->createListener (portNumber))
     {
-        startThread();
-        return true;
+        if (numEventLoopThreads <= 0)
+        {
+            startThread();
+            return true;
+        }
+
+        eventLoopPool = new InterprocessConnection::EventLoopPool (numEventLoopThreads);
+
+        if (eventLoopPool->isValid()
+             && socket->setBlockingMode (false)
+             && eventLoopPool->getAcceptorLoop().addSocket (socket->getRawSocketHandle(), this,
+                                                            SocketEventLoop::readyForReading))
+            return true;
+
+        eventLoopPool = nullptr;
     }
 
     socket = nullptr;
@@ -54,6 +67,15 @@ void InterprocessConnectionServer::stop()
 {
     signalThreadShouldExit();
 
+    if (eventLoopPool != nullptr)
+    {
+        if (socket != nullptr)
+            eventLoopPool->getAcceptorLoop().removeSocket (socket->getRawSocketHandle());
+
+        eventLoopPool->shutDown();
+        eventLoopPool = nullptr;
+    }
+
     if (socket != nullptr)
         socket->close();
 
@@ -76,3 +98,20 @@ void InterprocessConnectionServer::run()
         }
     }
 }
+
+void InterprocessConnectionServer::handleSocketEvent (int, int)
+{
+    // the listener is non-blocking, so this accepts all the clients that are waiting
+    for (;;)
+    {
+        ScopedPointer <StreamingSocket> clientSocket (socket->waitForNextConnection());
+
+        if (clientSocket == nullptr)
+            break;
+
+        InterprocessConnection* newConnection = createConnectionObject();
+
+        if (newConnection != nullptr)
+            newConnection->initialiseWithEventLoop (clientSocket.release(), eventLoopPool);
+    }
+}
@@ -38,9 +38,14 @@
     method, so that it creates suitable connection objects for each client that tries
     to connect.
 
-    @see InterprocessConnection
+    By default, each connection gets a thread of its own, which is fine for a handful of
+    clients. To serve a large number of them, the server can instead use a SocketEventLoop
+    on a small, fixed pool of threads - see beginWaitingForSocket().
+
+    @see InterprocessConnection, SocketEventLoop
 */
-class JUCE_API  InterprocessConnectionServer    : private Thread
+class JUCE_API  InterprocessConnectionServer    : private Thread,
+                                                  private SocketEventLoop::Listener
 {
 public:
     //==============================================================================
@@ -58,14 +63,24 @@ public:
         InterprocessConnection::connectToSocket() method, this object will call
         createConnectionObject() to create a connection to that client.
 
+        If numEventLoopThreads is 0, each connection runs its own thread. Otherwise, this
+        many threads are created, and they use a SocketEventLoop to accept new clients and
+        serve all of the connections between them, so thousands of clients can be handled.
+        In this mode, createConnectionObject() and any callbacks that aren't made on the
+        message thread happen on one of these threads, and so must return quickly.
+
         Use stop() to stop the thread running.
 
         @see createConnectionObject, stop
     */
-    bool beginWaitingForSocket (int portNumber);
+    bool beginWaitingForSocket (int portNumber, int numEventLoopThreads = 0);
 
     /** Terminates the listener thread, if it's active.
 
+        If the server is running with event loop threads, this also disconnects all the
+        connections that they were serving, because these can't run without them.
+        It mustn't be called from one of the server's own callbacks.
+
         @see beginWaitingForSocket
     */
     void stop();
@@ -86,8 +101,10 @@ protected:
 private:
     //==============================================================================
     ScopedPointer <StreamingSocket> socket;
+    ReferenceCountedObjectPtr<InterprocessConnection::EventLoopPool> eventLoopPool;
 
     void run();
+    void handleSocketEvent (int, int);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InterprocessConnectionServer)
 };
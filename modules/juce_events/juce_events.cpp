@@ -72,6 +72,7 @@ namespace juce
 #include "broadcasters/juce_ActionBroadcaster.cpp"
 #include "broadcasters/juce_AsyncUpdater.cpp"
 #include "broadcasters/juce_ChangeBroadcaster.cpp"
+#include "broadcasters/juce_ListenerList.cpp"
 #include "timers/juce_MultiTimer.cpp"
 #include "timers/juce_Timer.cpp"
 #include "interprocess/juce_InterprocessConnection.cpp"
@@ -73,6 +73,9 @@ namespace juce
 #ifndef __JUCE_LISTENERLIST_JUCEHEADER__
  #include "broadcasters/juce_ListenerList.h"
 #endif
+#ifndef __JUCE_THREADSAFELISTENERLIST_JUCEHEADER__
+ #include "broadcasters/juce_ThreadSafeListenerList.h"
+#endif
 #ifndef __JUCE_MULTITIMER_JUCEHEADER__
  #include "timers/juce_MultiTimer.h"
 #endif
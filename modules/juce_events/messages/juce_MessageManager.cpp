@@ -37,9 +37,153 @@ public:
     JUCE_DECLARE_NON_COPYABLE (QuitMessage)
 };
 
+//==============================================================================
+/*  Messages are posted into a queue of our own rather than straight into the OS's event
+    queue, and only a single wake-up message is sent through the OS to get them delivered.
+    Posting a message is then just an allocation and an atomic exchange, and a burst of
+    messages from background threads costs one round-trip through the window system
+    instead of one each.
+
+    The queue is a linked list that producers add to by swapping their node into the head,
+    and which the message thread reads from the tail, using a dummy node to stop the two
+    ends ever having to touch the same node when there's more than one message waiting.
+
+    Producers never wait for each other or for the message thread, but a producer that gets
+    suspended between swapping its node into the head and linking it to the previous one
+    will hold up delivery of its own message and of any that were posted after it, until it
+    resumes. The message thread doesn't spin while that happens - it just stops delivering,
+    and the stalled producer sends a wake-up once it has finished linking its node.
+*/
+class MessageManager::MessageQueue
+{
+public:
+    MessageQueue()
+        : tail (&stub), wakeUpMessage (new WakeUpMessage())
+    {
+        head = &stub;
+    }
+
+    ~MessageQueue()
+    {
+        while (Node* const node = popNode())
+            delete node;
+    }
+
+    void post (const MessageBase::Ptr& message)
+    {
+        ++numMessages;
+        pushNode (new Node (message));
+
+        if (wakeUpPending.compareAndSetBool (1, 0) && ! postMessageToSystemQueue (wakeUpMessage))
+            wakeUpPending = 0;
+    }
+
+    void deliverPendingMessages()
+    {
+        // This must be cleared before looking at the queue, so that anything posted from
+        // now on will send another wake-up
+        wakeUpPending = 0;
+
+        // Only as many messages as were already waiting are delivered here, so that callbacks
+        // which post more messages can't stop the OS from getting its own events through.
+        // (Those messages will have sent another wake-up.)
+        for (int numToDeliver = numMessages.get(); --numToDeliver >= 0;)
+        {
+            Node* const node = popNode();
+
+            if (node == nullptr)
+                break;
+
+            --numMessages;
+            const MessageBase::Ptr message (node->message);
+            delete node;
+
+            JUCE_TRY
+            {
+                message->messageCallback();
+            }
+            JUCE_CATCH_EXCEPTION
+        }
+    }
+
+private:
+    //==============================================================================
+    struct Node
+    {
+        Node() noexcept {}
+        Node (const MessageBase::Ptr& m) noexcept  : message (m) {}
+
+        MessageBase::Ptr message;
+        Atomic<Node*> next;
+    };
+
+    class WakeUpMessage  : public MessageBase
+    {
+    public:
+        WakeUpMessage() {}
+
+        void messageCallback()
+        {
+            if (MessageManager* const mm = MessageManager::instance)
+                mm->messageQueue->deliverPendingMessages();
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (WakeUpMessage)
+    };
+
+    Atomic<Node*> head;
+    Node* tail;
+    Node stub;
+    const MessageBase::Ptr wakeUpMessage;
+    Atomic<int> wakeUpPending, numMessages;
+
+    void pushNode (Node* const node) noexcept
+    {
+        node->next = nullptr;
+        Node* const previous = head.exchange (node);
+        previous->next = node;
+    }
+
+    // This may only be called by the message thread. It returns nullptr if the queue's
+    // empty, or if a producer is half-way through adding the next node (in which case
+    // that producer will send a wake-up when it's finished).
+    Node* popNode() noexcept
+    {
+        Node* node = tail;
+        Node* next = node->next.get();
+
+        if (node == &stub)
+        {
+            if (next == nullptr)
+                return nullptr;
+
+            tail = node = next;
+            next = next->next.get();
+        }
+
+        if (next == nullptr)
+        {
+            if (node != head.get())
+                return nullptr;
+
+            pushNode (&stub);
+            next = node->next.get();
+
+            if (next == nullptr)
+                return nullptr;
+        }
+
+        tail = next;
+        return node;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (MessageQueue)
+};
+
 //==============================================================================
 MessageManager::MessageManager() noexcept
-  : quitMessagePosted (false),
+  : messageQueue (new MessageQueue()),
+    quitMessagePosted (false),
     quitMessageReceived (false),
     messageThreadId (Thread::getCurrentThreadId()),
     threadWithLock (0)
@@ -84,10 +228,12 @@ void MessageManager::deleteInstance()
 //==============================================================================
 void MessageManager::MessageBase::post()
 {
+    const Ptr deleter (this); // (this will delete messages that were just created with a 0 ref count, if they don't get posted)
+
     MessageManager* const mm = MessageManager::instance;
 
-    if (mm == nullptr || mm->quitMessagePosted || ! postMessageToSystemQueue (this))
-        Ptr deleter (this); // (this will delete messages that were just created with a 0 ref count)
+    if (mm != nullptr && ! mm->quitMessagePosted)
+        mm->messageQueue->post (deleter);
 }
 
 //==============================================================================
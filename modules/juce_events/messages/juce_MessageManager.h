@@ -194,8 +194,11 @@ private:
     friend class MessageBase;
     class QuitMessage;
     friend class QuitMessage;
+    class MessageQueue;
+    friend class MessageQueue;
     friend class MessageManagerLock;
 
+    ScopedPointer <MessageQueue> messageQueue;
     ScopedPointer <ActionBroadcaster> broadcaster;
     bool quitMessagePosted, quitMessageReceived;
     Thread::ThreadID messageThreadId;
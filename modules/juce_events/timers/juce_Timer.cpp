@@ -32,7 +32,8 @@ public:
 
     TimerThread()
         : Thread ("Juce Timer"),
-          firstTimer (nullptr),
+          lastCounterValue (Time::getMillisecondCounter()),
+          counterWrapOffset (0),
           callbackNeeded (0)
     {
         triggerAsyncUpdate();
@@ -49,24 +50,11 @@ public:
 
     void run()
     {
-        uint32 lastTime = Time::getMillisecondCounter();
         MessageManager::MessageBase::Ptr messageToSend (new CallTimersMessage());
 
         while (! threadShouldExit())
         {
-            const uint32 now = Time::getMillisecondCounter();
-
-            if (now == lastTime)
-            {
-                wait (1);
-                continue;
-            }
-
-            const int elapsed = (int) (now >= lastTime ? (now - lastTime)
-                                                       : (std::numeric_limits<uint32>::max() - (lastTime - now)));
-            lastTime = now;
-
-            const int timeUntilFirstTimer = getTimeUntilFirstTimer (elapsed);
+            const int timeUntilFirstTimer = getTimeUntilFirstTimer();
 
             if (timeUntilFirstTimer <= 0)
             {
@@ -83,7 +71,7 @@ public:
                        when the app has a modal loop), so this is how long to wait before assuming the
                        message has been lost and trying again.
                     */
-                    const uint32 messageDeliveryTimeout = now + 300;
+                    const uint32 messageDeliveryTimeout = Time::getMillisecondCounter() + 300;
 
                     while (callbackNeeded.get() != 0)
                     {
@@ -99,6 +87,10 @@ public:
                         }
                     }
                 }
+                else
+                {
+                    wait (1);
+                }
             }
             else
             {
@@ -113,13 +105,15 @@ public:
     {
         const LockType::ScopedLockType sl (lock);
 
-        while (firstTimer != nullptr && firstTimer->countdownMs <= 0)
-        {
-            Timer* const t = firstTimer;
-            t->countdownMs = t->periodMs;
+        // All the timers that are due get called from this one message, and any that become
+        // due while the callbacks are running are left for the next one.
+        const int64 now = getTime();
 
-            removeTimer (t);
-            addTimer (t);
+        while (timers.size() > 0 && timers.getUnchecked (0)->timeDue <= now)
+        {
+            Timer* const t = timers.getUnchecked (0);
+            t->timeDue = now + t->periodMs;
+            shuffleTimerDownInQueue (0);
 
             const LockType::ScopedUnlockType ul (lock);
 
@@ -152,11 +146,12 @@ public:
         callTimers();
     }
 
-    static inline void add (Timer* const tim) noexcept
+    static inline void add (Timer* const tim, const int initialDelayMs) noexcept
     {
         if (instance == nullptr)
             instance = new TimerThread();
 
+        tim->timeDue = instance->getTime() + initialDelayMs;
         instance->addTimer (tim);
     }
 
@@ -170,15 +165,10 @@ public:
     {
         if (instance != nullptr)
         {
-            tim->countdownMs = newCounter;
+            tim->timeDue = instance->getTime() + newCounter;
             tim->periodMs = newCounter;
 
-            if ((tim->next != nullptr && tim->next->countdownMs < tim->countdownMs)
-                 || (tim->previous != nullptr && tim->previous->countdownMs > tim->countdownMs))
-            {
-                instance->removeTimer (tim);
-                instance->addTimer (tim);
-            }
+            instance->restoreQueueOrder (tim->positionInQueue);
         }
     }
 
@@ -186,7 +176,9 @@ public:
     static LockType lock;
 
 private:
-    Timer* volatile firstTimer;
+    Array<Timer*> timers; // a binary heap, with the timer that's due soonest at the front
+    uint32 lastCounterValue;
+    int64 counterWrapOffset;
     Atomic <int> callbackNeeded;
 
     struct CallTimersMessage  : public MessageManager::MessageBase
@@ -201,76 +193,123 @@ private:
     };
 
     //==============================================================================
-    void addTimer (Timer* const t) noexcept
+    // Returns the millisecond counter extended to 64 bits, so that timers keep working
+    // when it wraps. This must be called with the lock held.
+    int64 getTime() noexcept
     {
-       #if JUCE_DEBUG
-        // trying to add a timer that's already here - shouldn't get to this point,
-        // so if you get this assertion, let me know!
-        jassert (! timerExists (t));
-       #endif
-
-        Timer* i = firstTimer;
+        const uint32 now = Time::getMillisecondCounter();
 
-        if (i == nullptr || i->countdownMs > t->countdownMs)
-        {
-            t->next = firstTimer;
-            firstTimer = t;
-        }
-        else
+        if (now < lastCounterValue)
         {
-            while (i->next != nullptr && i->next->countdownMs <= t->countdownMs)
-                i = i->next;
+            if (lastCounterValue - now < 0x80000000u)
+                return counterWrapOffset + lastCounterValue; // (never let the time go backwards)
 
-            jassert (i != nullptr);
-
-            t->next = i->next;
-            t->previous = i;
-            i->next = t;
+            counterWrapOffset += ((int64) 1) << 32;
         }
 
-        if (t->next != nullptr)
-            t->next->previous = t;
+        lastCounterValue = now;
+        return counterWrapOffset + now;
+    }
 
-        jassert ((t->next == nullptr || t->next->countdownMs >= t->countdownMs)
-                  && (t->previous == nullptr || t->previous->countdownMs <= t->countdownMs));
+    void addTimer (Timer* const t) noexcept
+    {
+        // trying to add a timer that's already here - shouldn't get to this point,
+        // so if you get this assertion, let me know!
+        jassert (t->positionInQueue < 0);
 
-        notify();
+        timers.add (t);
+        restoreQueueOrder (timers.size() - 1);
     }
 
     void removeTimer (Timer* const t) noexcept
     {
-       #if JUCE_DEBUG
         // trying to remove a timer that's not here - shouldn't get to this point,
         // so if you get this assertion, let me know!
-        jassert (timerExists (t));
-       #endif
+        jassert (isPositiveAndBelow (t->positionInQueue, timers.size()) && timers.getUnchecked (t->positionInQueue) == t);
 
-        if (t->previous != nullptr)
+        const int pos = t->positionInQueue;
+        Timer* const last = timers.getLast();
+        timers.removeLast();
+
+        if (last != t)
         {
-            jassert (firstTimer != t);
-            t->previous->next = t->next;
+            timers.set (pos, last);
+            last->positionInQueue = pos;
+            restoreQueueOrder (pos);
         }
-        else
+
+        t->positionInQueue = -1;
+    }
+
+    void restoreQueueOrder (const int pos) noexcept
+    {
+        const int newPos = shuffleTimerUpInQueue (pos);
+        shuffleTimerDownInQueue (newPos);
+
+        // (the thread only needs waking if the first timer might now be due sooner)
+        if (newPos == 0)
+            notify();
+    }
+
+    int shuffleTimerUpInQueue (int pos) noexcept
+    {
+        Timer* const t = timers.getUnchecked (pos);
+
+        while (pos > 0)
         {
-            jassert (firstTimer == t);
-            firstTimer = t->next;
+            const int parent = (pos - 1) / 2;
+            Timer* const parentTimer = timers.getUnchecked (parent);
+
+            if (parentTimer->timeDue <= t->timeDue)
+                break;
+
+            timers.set (pos, parentTimer);
+            parentTimer->positionInQueue = pos;
+            pos = parent;
         }
 
-        if (t->next != nullptr)
-            t->next->previous = t->previous;
+        timers.set (pos, t);
+        t->positionInQueue = pos;
+        return pos;
+    }
+
+    void shuffleTimerDownInQueue (int pos) noexcept
+    {
+        Timer* const t = timers.getUnchecked (pos);
+        const int numTimers = timers.size();
+
+        for (;;)
+        {
+            int child = pos * 2 + 1;
+
+            if (child >= numTimers)
+                break;
+
+            if (child + 1 < numTimers && timers.getUnchecked (child + 1)->timeDue < timers.getUnchecked (child)->timeDue)
+                ++child;
+
+            Timer* const childTimer = timers.getUnchecked (child);
+
+            if (t->timeDue <= childTimer->timeDue)
+                break;
+
+            timers.set (pos, childTimer);
+            childTimer->positionInQueue = pos;
+            pos = child;
+        }
 
-        t->next = nullptr;
-        t->previous = nullptr;
+        timers.set (pos, t);
+        t->positionInQueue = pos;
     }
 
-    int getTimeUntilFirstTimer (const int numMillisecsElapsed) const
+    int getTimeUntilFirstTimer()
     {
         const LockType::ScopedLockType sl (lock);
 
-        for (Timer* t = firstTimer; t != nullptr; t = t->next)
-            t->countdownMs -= numMillisecsElapsed;
+        if (timers.size() == 0)
+            return 1000;
 
-        return firstTimer != nullptr ? firstTimer->countdownMs : 1000;
+        return (int) jlimit ((int64) -1000, (int64) 1000, timers.getUnchecked (0)->timeDue - getTime());
     }
 
     void handleAsyncUpdate()
@@ -278,17 +317,6 @@ private:
         startThread (7);
     }
 
-   #if JUCE_DEBUG
-    bool timerExists (Timer* const t) const noexcept
-    {
-        for (Timer* tt = firstTimer; tt != nullptr; tt = tt->next)
-            if (tt == t)
-                return true;
-
-        return false;
-    }
-   #endif
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimerThread)
 };
 
@@ -301,10 +329,9 @@ static SortedSet <Timer*> activeTimers;
 #endif
 
 Timer::Timer() noexcept
-   : countdownMs (0),
+   : timeDue (0),
      periodMs (0),
-     previous (nullptr),
-     next (nullptr)
+     positionInQueue (-1)
 {
    #if JUCE_DEBUG
     const TimerThread::LockType::ScopedLockType sl (TimerThread::lock);
@@ -313,10 +340,9 @@ Timer::Timer() noexcept
 }
 
 Timer::Timer (const Timer&) noexcept
-   : countdownMs (0),
+   : timeDue (0),
      periodMs (0),
-     previous (nullptr),
-     next (nullptr)
+     positionInQueue (-1)
 {
    #if JUCE_DEBUG
     const TimerThread::LockType::ScopedLockType sl (TimerThread::lock);
@@ -344,9 +370,8 @@ void Timer::startTimer (const int interval) noexcept
 
     if (periodMs == 0)
     {
-        countdownMs = interval;
         periodMs = jmax (1, interval);
-        TimerThread::add (this);
+        TimerThread::add (this, interval);
     }
     else
     {
@@ -125,9 +125,8 @@ public:
 private:
     class TimerThread;
     friend class TimerThread;
-    int countdownMs, periodMs;
-    Timer* previous;
-    Timer* next;
+    int64 timeDue;
+    int periodMs, positionInQueue;
 
     Timer& operator= (const Timer&);
 };
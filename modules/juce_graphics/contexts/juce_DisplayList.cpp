@@ -0,0 +1,631 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+class DisplayList::Operation
+{
+public:
+    Operation() noexcept : isStateChange (true) {}
+    virtual ~Operation() {}
+
+    virtual void perform (LowLevelGraphicsContext&) const = 0;
+
+    // State changes always have to be performed, but drawing operations can be skipped when
+    // their area (in the recording's device-space) is outside the region being drawn.
+    Rectangle<int> area;
+    bool isStateChange;
+
+    // state changes
+    struct SetOrigin;
+    struct AddTransform;
+    struct ClipToRectangle;
+    struct ClipToRectangleList;
+    struct ExcludeClipRectangle;
+    struct ClipToPath;
+    struct ClipToImageAlpha;
+    struct SaveState;
+    struct RestoreState;
+    struct BeginTransparencyLayer;
+    struct EndTransparencyLayer;
+    struct SetFill;
+    struct SetOpacity;
+    struct SetInterpolationQuality;
+    struct SetFont;
+
+    // drawing operations
+    struct FillRect;
+    struct FillPath;
+    struct DrawImage;
+    struct DrawLine;
+    struct DrawVerticalLine;
+    struct DrawHorizontalLine;
+    struct DrawGlyph;
+};
+
+//==============================================================================
+struct DisplayList::Operation::SetOrigin  : public Operation
+{
+    SetOrigin (int x_, int y_) noexcept : x (x_), y (y_) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.setOrigin (x, y); }
+
+    const int x, y;
+};
+
+struct DisplayList::Operation::AddTransform  : public Operation
+{
+    AddTransform (const AffineTransform& t) noexcept : transform (t) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.addTransform (transform); }
+
+    const AffineTransform transform;
+};
+
+struct DisplayList::Operation::ClipToRectangle  : public Operation
+{
+    ClipToRectangle (const Rectangle<int>& r) noexcept : rect (r) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.clipToRectangle (rect); }
+
+    const Rectangle<int> rect;
+};
+
+struct DisplayList::Operation::ClipToRectangleList  : public Operation
+{
+    ClipToRectangleList (const RectangleList& r) : list (r) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.clipToRectangleList (list); }
+
+    const RectangleList list;
+};
+
+struct DisplayList::Operation::ExcludeClipRectangle  : public Operation
+{
+    ExcludeClipRectangle (const Rectangle<int>& r) noexcept : rect (r) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.excludeClipRectangle (rect); }
+
+    const Rectangle<int> rect;
+};
+
+struct DisplayList::Operation::ClipToPath  : public Operation
+{
+    ClipToPath (const Path& p, const AffineTransform& t) : path (p), transform (t) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.clipToPath (path, transform); }
+
+    const Path path;
+    const AffineTransform transform;
+};
+
+struct DisplayList::Operation::ClipToImageAlpha  : public Operation
+{
+    ClipToImageAlpha (const Image& im, const AffineTransform& t) : image (im), transform (t) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.clipToImageAlpha (image, transform); }
+
+    const Image image;
+    const AffineTransform transform;
+};
+
+struct DisplayList::Operation::SaveState  : public Operation
+{
+    void perform (LowLevelGraphicsContext& g) const     { g.saveState(); }
+};
+
+struct DisplayList::Operation::RestoreState  : public Operation
+{
+    void perform (LowLevelGraphicsContext& g) const     { g.restoreState(); }
+};
+
+struct DisplayList::Operation::BeginTransparencyLayer  : public Operation
+{
+    BeginTransparencyLayer (float opacity_) noexcept : opacity (opacity_) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.beginTransparencyLayer (opacity); }
+
+    const float opacity;
+};
+
+struct DisplayList::Operation::EndTransparencyLayer  : public Operation
+{
+    void perform (LowLevelGraphicsContext& g) const     { g.endTransparencyLayer(); }
+};
+
+struct DisplayList::Operation::SetFill  : public Operation
+{
+    SetFill (const FillType& f) : fill (f) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.setFill (fill); }
+
+    const FillType fill;
+};
+
+struct DisplayList::Operation::SetOpacity  : public Operation
+{
+    SetOpacity (float opacity_) noexcept : opacity (opacity_) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.setOpacity (opacity); }
+
+    const float opacity;
+};
+
+struct DisplayList::Operation::SetInterpolationQuality  : public Operation
+{
+    SetInterpolationQuality (Graphics::ResamplingQuality q) noexcept : quality (q) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.setInterpolationQuality (quality); }
+
+    const Graphics::ResamplingQuality quality;
+};
+
+struct DisplayList::Operation::SetFont  : public Operation
+{
+    SetFont (const Font& f) : font (f) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.setFont (font); }
+
+    const Font font;
+};
+
+//==============================================================================
+struct DisplayList::Operation::FillRect  : public Operation
+{
+    FillRect (const Rectangle<int>& r, bool replace) noexcept : rect (r), replaceExistingContents (replace) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.fillRect (rect, replaceExistingContents); }
+
+    const Rectangle<int> rect;
+    const bool replaceExistingContents;
+};
+
+struct DisplayList::Operation::FillPath  : public Operation
+{
+    FillPath (const Path& p, const AffineTransform& t) : path (p), transform (t) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.fillPath (path, transform); }
+
+    const Path path;
+    const AffineTransform transform;
+};
+
+struct DisplayList::Operation::DrawImage  : public Operation
+{
+    DrawImage (const Image& im, const AffineTransform& t) : image (im), transform (t) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.drawImage (image, transform); }
+
+    const Image image;
+    const AffineTransform transform;
+};
+
+struct DisplayList::Operation::DrawLine  : public Operation
+{
+    DrawLine (const Line<float>& l) noexcept : line (l) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.drawLine (line); }
+
+    const Line<float> line;
+};
+
+struct DisplayList::Operation::DrawVerticalLine  : public Operation
+{
+    DrawVerticalLine (int x_, float top_, float bottom_) noexcept : x (x_), top (top_), bottom (bottom_) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.drawVerticalLine (x, top, bottom); }
+
+    const int x;
+    const float top, bottom;
+};
+
+struct DisplayList::Operation::DrawHorizontalLine  : public Operation
+{
+    DrawHorizontalLine (int y_, float left_, float right_) noexcept : y (y_), left (left_), right (right_) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.drawHorizontalLine (y, left, right); }
+
+    const int y;
+    const float left, right;
+};
+
+struct DisplayList::Operation::DrawGlyph  : public Operation
+{
+    DrawGlyph (int glyph_, const AffineTransform& t) noexcept : glyph (glyph_), transform (t) {}
+    void perform (LowLevelGraphicsContext& g) const     { g.drawGlyph (glyph, transform); }
+
+    const int glyph;
+    const AffineTransform transform;
+};
+
+
+//==============================================================================
+DisplayList::DisplayList() {}
+DisplayList::~DisplayList() {}
+
+void DisplayList::clear()
+{
+    operations.clear();
+    bounds = Rectangle<int>();
+    openStates.clearQuick();
+}
+
+void DisplayList::draw (LowLevelGraphicsContext& context) const
+{
+    draw (context, bounds);
+}
+
+void DisplayList::draw (LowLevelGraphicsContext& context, const Rectangle<int>& areaToDraw) const
+{
+    context.saveState();
+
+    for (int i = 0; i < operations.size(); ++i)
+    {
+        const Operation& op = *operations.getUnchecked (i);
+
+        if (op.isStateChange || op.area.intersects (areaToDraw))
+            op.perform (context);
+    }
+
+    for (int i = openStates.size(); --i >= 0;)
+    {
+        if (openStates.getUnchecked (i))
+            context.endTransparencyLayer();
+        else
+            context.restoreState();
+    }
+
+    context.restoreState();
+}
+
+//==============================================================================
+DisplayList::Recorder::Recorder (DisplayList& listToRecordInto, const RectangleList& clipRegion)
+    : displayList (listToRecordInto),
+      clipTracker (Image (Image::SingleChannel, 1, 1, false), Point<int>(), clipRegion)
+{
+}
+
+DisplayList::Recorder::~Recorder() {}
+
+//==============================================================================
+void DisplayList::Recorder::addStateChange (Operation* const op)
+{
+    displayList.operations.add (op);
+}
+
+void DisplayList::Recorder::addDrawingOperation (Operation* const op, const Rectangle<int>& deviceSpaceArea)
+{
+    op->isStateChange = false;
+    op->area = deviceSpaceArea;
+    displayList.operations.add (op);
+    displayList.bounds = displayList.bounds.getUnion (deviceSpaceArea);
+}
+
+Rectangle<int> DisplayList::Recorder::getDeviceSpaceArea (const Rectangle<float>& r) const
+{
+    const RenderingHelpers::TranslationOrTransform& t = clipTracker.getTransform();
+
+    // (expanded to allow for anti-aliased edges)
+    return (t.isOnlyTranslated ? t.translated (r) : t.transformed (r)).getSmallestIntegerContainer().expanded (1);
+}
+
+Rectangle<int> DisplayList::Recorder::getDrawingArea (const Rectangle<float>& userSpaceArea) const
+{
+    if (clipTracker.isClipEmpty())
+        return Rectangle<int>();
+
+    return getDeviceSpaceArea (userSpaceArea)
+             .getIntersection (getDeviceSpaceArea (clipTracker.getClipBounds().toFloat()));
+}
+
+//==============================================================================
+bool DisplayList::Recorder::isVectorDevice() const                          { return false; }
+float DisplayList::Recorder::getScaleFactor()                               { return clipTracker.getScaleFactor(); }
+bool DisplayList::Recorder::clipRegionIntersects (const Rectangle<int>& r)  { return clipTracker.clipRegionIntersects (r); }
+Rectangle<int> DisplayList::Recorder::getClipBounds() const                 { return clipTracker.getClipBounds(); }
+bool DisplayList::Recorder::isClipEmpty() const                             { return clipTracker.isClipEmpty(); }
+const Font& DisplayList::Recorder::getFont()                                { return clipTracker.getFont(); }
+
+void DisplayList::Recorder::setOrigin (int x, int y)
+{
+    clipTracker.setOrigin (x, y);
+    addStateChange (new Operation::SetOrigin (x, y));
+}
+
+void DisplayList::Recorder::addTransform (const AffineTransform& t)
+{
+    clipTracker.addTransform (t);
+    addStateChange (new Operation::AddTransform (t));
+}
+
+bool DisplayList::Recorder::clipToRectangle (const Rectangle<int>& r)
+{
+    addStateChange (new Operation::ClipToRectangle (r));
+    return clipTracker.clipToRectangle (r);
+}
+
+bool DisplayList::Recorder::clipToRectangleList (const RectangleList& r)
+{
+    addStateChange (new Operation::ClipToRectangleList (r));
+    return clipTracker.clipToRectangleList (r);
+}
+
+void DisplayList::Recorder::excludeClipRectangle (const Rectangle<int>& r)
+{
+    clipTracker.excludeClipRectangle (r);
+    addStateChange (new Operation::ExcludeClipRectangle (r));
+}
+
+void DisplayList::Recorder::clipToPath (const Path& path, const AffineTransform& t)
+{
+    clipTracker.clipToPath (path, t);
+    addStateChange (new Operation::ClipToPath (path, t));
+}
+
+void DisplayList::Recorder::clipToImageAlpha (const Image& im, const AffineTransform& t)
+{
+    clipTracker.clipToImageAlpha (im, t);
+    addStateChange (new Operation::ClipToImageAlpha (im, t));
+}
+
+void DisplayList::Recorder::saveState()
+{
+    clipTracker.saveState();
+    displayList.openStates.add (false);
+    addStateChange (new Operation::SaveState());
+}
+
+void DisplayList::Recorder::restoreState()
+{
+    clipTracker.restoreState();
+    displayList.openStates.removeLast();
+    addStateChange (new Operation::RestoreState());
+}
+
+void DisplayList::Recorder::beginTransparencyLayer (float opacity)
+{
+    // (the clip tracker only needs the layer's state, not its image)
+    clipTracker.saveState();
+    displayList.openStates.add (true);
+    addStateChange (new Operation::BeginTransparencyLayer (opacity));
+}
+
+void DisplayList::Recorder::endTransparencyLayer()
+{
+    clipTracker.restoreState();
+    displayList.openStates.removeLast();
+    addStateChange (new Operation::EndTransparencyLayer());
+}
+
+void DisplayList::Recorder::setFill (const FillType& fillType)
+{
+    clipTracker.setFill (fillType);
+    addStateChange (new Operation::SetFill (fillType));
+}
+
+void DisplayList::Recorder::setOpacity (float opacity)
+{
+    clipTracker.setOpacity (opacity);
+    addStateChange (new Operation::SetOpacity (opacity));
+}
+
+void DisplayList::Recorder::setInterpolationQuality (Graphics::ResamplingQuality quality)
+{
+    clipTracker.setInterpolationQuality (quality);
+    addStateChange (new Operation::SetInterpolationQuality (quality));
+}
+
+void DisplayList::Recorder::setFont (const Font& newFont)
+{
+    // Finding the typeface isn't thread-safe, so it's done now, in case the list gets
+    // replayed on several threads at once.
+    newFont.getTypeface();
+
+    clipTracker.setFont (newFont);
+    addStateChange (new Operation::SetFont (newFont));
+}
+
+//==============================================================================
+void DisplayList::Recorder::fillRect (const Rectangle<int>& r, const bool replaceExistingContents)
+{
+    const Rectangle<int> area (getDrawingArea (r.toFloat()));
+
+    if (! area.isEmpty())
+        addDrawingOperation (new Operation::FillRect (r, replaceExistingContents), area);
+}
+
+void DisplayList::Recorder::fillPath (const Path& path, const AffineTransform& t)
+{
+    const Rectangle<int> area (getDrawingArea (path.getBoundsTransformed (t)));
+
+    if (! area.isEmpty())
+        addDrawingOperation (new Operation::FillPath (path, t), area);
+}
+
+void DisplayList::Recorder::drawImage (const Image& sourceImage, const AffineTransform& t)
+{
+    const Rectangle<int> area (getDrawingArea (sourceImage.getBounds().toFloat().transformed (t)));
+
+    if (! area.isEmpty())
+        addDrawingOperation (new Operation::DrawImage (sourceImage, t), area);
+}
+
+void DisplayList::Recorder::drawLine (const Line <float>& line)
+{
+    const Rectangle<int> area (getDrawingArea (Rectangle<float> (line.getStart(), line.getEnd())));
+
+    if (! area.isEmpty())
+        addDrawingOperation (new Operation::DrawLine (line), area);
+}
+
+void DisplayList::Recorder::drawVerticalLine (const int x, float top, float bottom)
+{
+    const Rectangle<int> area (getDrawingArea (Rectangle<float> ((float) x, top, 1.0f, bottom - top)));
+
+    if (! area.isEmpty())
+        addDrawingOperation (new Operation::DrawVerticalLine (x, top, bottom), area);
+}
+
+void DisplayList::Recorder::drawHorizontalLine (const int y, float left, float right)
+{
+    const Rectangle<int> area (getDrawingArea (Rectangle<float> (left, (float) y, right - left, 1.0f)));
+
+    if (! area.isEmpty())
+        addDrawingOperation (new Operation::DrawHorizontalLine (y, left, right), area);
+}
+
+void DisplayList::Recorder::drawGlyph (int glyphNumber, const AffineTransform& t)
+{
+    const Font& font = clipTracker.getFont();
+    const float fontHeight = font.getHeight();
+    const AffineTransform glyphTransform (AffineTransform::scale (fontHeight * font.getHorizontalScale(), fontHeight)
+                                                         .followedBy (t));
+
+    if (t.isOnlyTranslation() && clipTracker.getTransform().isOnlyTranslated)
+    {
+        // These glyphs come from the glyph cache, which can be used by several threads. The
+        // area is a generous guess at the size of the glyph, to avoid having to load its outline.
+        const Rectangle<int> area (getDrawingArea (Rectangle<float> (-1.0f, -2.0f, 5.0f, 4.0f).transformed (glyphTransform)));
+
+        if (! area.isEmpty())
+            addDrawingOperation (new Operation::DrawGlyph (glyphNumber, t), area);
+    }
+    else
+    {
+        // Other glyphs would be rendered by the typeface itself, which can't be done safely
+        // on several threads at once, so these are stored as paths instead.
+        Path glyphPath;
+        font.getTypeface()->getOutlineForGlyph (glyphNumber, glyphPath);
+        fillPath (glyphPath, glyphTransform);
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class DisplayListTests  : public UnitTest
+{
+public:
+    DisplayListTests() : UnitTest ("DisplayList") {}
+
+    void runTest()
+    {
+        beginTest ("Replaying matches direct rendering");
+
+        const Point<int> origin (3, -2);
+        RectangleList clip (Rectangle<int> (5, 3, 140, 110));
+        clip.subtract (Rectangle<int> (60, 40, 30, 20));
+
+        DisplayList list;
+
+        {
+            DisplayList::Recorder recorder (list, clip.getBounds() - origin);
+            Graphics g (&recorder);
+            drawTestScene (g);
+        }
+
+        expect (! list.isEmpty());
+
+        Image expected (Image::ARGB, 150, 120, true);
+
+        {
+            LowLevelGraphicsSoftwareRenderer context (expected, origin, clip);
+            Graphics g (&context);
+            drawTestScene (g);
+        }
+
+        // (drawn twice, to make sure that replaying doesn't change the list)
+        for (int i = 0; i < 2; ++i)
+        {
+            Image actual (Image::ARGB, 150, 120, true);
+            LowLevelGraphicsSoftwareRenderer context (actual, origin, clip);
+            list.draw (context);
+            expect (context.getClipBounds() == clip.getBounds() - origin);
+            expect (imagesAreEqual (expected, actual));
+        }
+
+        beginTest ("Skipping operations outside an area");
+
+        {
+            Image actual (Image::ARGB, 150, 120, true);
+            LowLevelGraphicsSoftwareRenderer context (actual, origin, clip);
+            context.clipToRectangle (Rectangle<int> (10, 10, 40, 30));
+            list.draw (context, Rectangle<int> (10, 10, 40, 30));
+
+            Image expectedArea (Image::ARGB, 150, 120, true);
+            LowLevelGraphicsSoftwareRenderer context2 (expectedArea, origin, clip);
+            context2.clipToRectangle (Rectangle<int> (10, 10, 40, 30));
+            list.draw (context2);
+
+            expect (imagesAreEqual (expectedArea, actual));
+        }
+
+        beginTest ("Unfinished states");
+
+        {
+            DisplayList list2;
+
+            {
+                DisplayList::Recorder recorder (list2, Rectangle<int> (0, 0, 100, 100));
+                recorder.saveState();
+                recorder.clipToRectangle (Rectangle<int> (10, 10, 20, 20));
+                recorder.beginTransparencyLayer (0.5f);
+                recorder.setFill (Colours::red);
+                recorder.fillRect (Rectangle<int> (0, 0, 100, 100), false);
+            }
+
+            expect (list2.getBounds() == Rectangle<int> (9, 9, 22, 22));
+
+            Image image (Image::ARGB, 100, 100, true);
+            LowLevelGraphicsSoftwareRenderer context (image);
+            list2.draw (context);
+
+            expect (context.getClipBounds() == image.getBounds());
+            expect (image.getPixelAt (20, 20).getAlpha() == 0x80 || image.getPixelAt (20, 20).getAlpha() == 0x7f);
+            expect (image.getPixelAt (40, 40).getAlpha() == 0);
+        }
+    }
+
+private:
+    static bool imagesAreEqual (const Image& image1, const Image& image2)
+    {
+        for (int y = 0; y < image1.getHeight(); ++y)
+            for (int x = 0; x < image1.getWidth(); ++x)
+                if (image1.getPixelAt (x, y) != image2.getPixelAt (x, y))
+                    return false;
+
+        return true;
+    }
+
+    static void drawTestScene (Graphics& g)
+    {
+        g.fillAll (Colours::white);
+
+        g.setGradientFill (ColourGradient (Colours::yellow, 10.0f, 10.0f, Colours::green.withAlpha (0.5f), 150.0f, 120.0f, true));
+        g.fillRoundedRectangle (8.5f, 6.25f, 120.0f, 90.0f, 12.0f);
+
+        g.setColour (Colours::black.withAlpha (0.7f));
+        g.drawLine (0.0f, 0.0f, 140.0f, 115.0f, 3.0f);
+        g.drawHorizontalLine (70, 2.0f, 130.5f);
+
+        g.setFont (14.0f);
+        g.drawText ("Display list", 10, 20, 100, 20, Justification::centredLeft, false);
+
+        {
+            Graphics::ScopedSaveState ss (g);
+            g.addTransform (AffineTransform::rotation (0.3f, 90.0f, 80.0f));
+            g.drawText ("Rotated", 50, 70, 80, 20, Justification::centred, false);
+        }
+
+        g.beginTransparencyLayer (0.6f);
+        g.setColour (Colours::purple);
+        g.fillEllipse (30.0f, 60.0f, 90.0f, 50.0f);
+        g.endTransparencyLayer();
+    }
+};
+
+static DisplayListTests displayListTests;
+
+#endif
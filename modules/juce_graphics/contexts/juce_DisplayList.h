@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_DISPLAYLIST_JUCEHEADER__
+#define __JUCE_DISPLAYLIST_JUCEHEADER__
+
+#include "juce_LowLevelGraphicsSoftwareRenderer.h"
+
+
+//==============================================================================
+/**
+    A recorded sequence of drawing operations, which can be replayed onto any
+    LowLevelGraphicsContext.
+
+    To fill a DisplayList, create a DisplayList::Recorder for it, and draw onto that (usually by
+    wrapping it in a Graphics object). The list keeps copies of all the paths, images, fills
+    and fonts that were used, so once it has been recorded, it can be drawn as many times as
+    you like without having to run the original painting code again.
+
+    Text is recorded as glyphs rather than strings, so the cost of laying it out is also
+    only paid once.
+
+    e.g. @code
+    DisplayList list;
+
+    {
+        DisplayList::Recorder recorder (list, Rectangle<int> (0, 0, 200, 100));
+        Graphics g (&recorder);
+        drawSomething (g);
+    }
+
+    list.draw (someOtherGraphics.getInternalContext());
+    @endcode
+
+    @see Component::setBufferedToDisplayList
+*/
+class JUCE_API  DisplayList
+{
+public:
+    //==============================================================================
+    /** Creates an empty display list. */
+    DisplayList();
+
+    /** Destructor. */
+    ~DisplayList();
+
+    //==============================================================================
+    /** Removes all the recorded operations. */
+    void clear();
+
+    /** Returns true if nothing has been drawn into this list. */
+    bool isEmpty() const noexcept                           { return bounds.isEmpty(); }
+
+    /** Returns the number of operations (including state changes) that have been recorded. */
+    int getNumOperations() const noexcept                   { return operations.size(); }
+
+    /** Returns the area that the recorded drawing operations may touch.
+        This is in the coordinate space that was in use when the recording began.
+    */
+    const Rectangle<int>& getBounds() const noexcept        { return bounds; }
+
+    //==============================================================================
+    /** Replays all the recorded operations onto a context.
+
+        Drawing is done relative to the context's current state, so it'll be positioned,
+        transformed and clipped by whatever origin, transform and clip region the context
+        has. When it returns, the context's state will be the same as it was beforehand.
+    */
+    void draw (LowLevelGraphicsContext& context) const;
+
+    /** Replays the recorded operations onto a context, skipping any drawing operations
+        that lie entirely outside the given area.
+
+        The area is in the coordinate space that was in use when the recording began. This
+        doesn't clip the drawing, so you'll still need to set the context's clip region to
+        the same area if the operations that partially overlap it mustn't spill out of it.
+    */
+    void draw (LowLevelGraphicsContext& context, const Rectangle<int>& areaToDraw) const;
+
+    //==============================================================================
+    class Recorder;
+
+private:
+    //==============================================================================
+    class Operation;
+    friend class Recorder;
+
+    OwnedArray<Operation> operations;
+    Rectangle<int> bounds;
+
+    // The saved states and transparency layers that were still open when the recording
+    // finished, which need closing after the list has been replayed (true = a layer).
+    Array<bool> openStates;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DisplayList)
+};
+
+//==============================================================================
+/**
+    A LowLevelGraphicsContext that records the operations that are performed on it into a
+    DisplayList.
+
+    It answers clip queries as a LowLevelGraphicsSoftwareRenderer would, so that painting
+    code which skips things that are outside the clip region will behave normally.
+
+    @see DisplayList
+*/
+class JUCE_API  DisplayList::Recorder    : public LowLevelGraphicsContext
+{
+public:
+    //==============================================================================
+    /** Creates a recorder that will append operations to a display list.
+
+        @param listToRecordInto     the list to add the operations to. This mustn't be deleted
+                                    before the recorder
+        @param clipRegion           the area that may be drawn on. Anything outside this is
+                                    treated as being clipped away, and won't be recorded
+    */
+    Recorder (DisplayList& listToRecordInto, const RectangleList& clipRegion);
+
+    /** Destructor. */
+    ~Recorder();
+
+    //==============================================================================
+    bool isVectorDevice() const;
+    void setOrigin (int x, int y);
+    void addTransform (const AffineTransform&);
+    float getScaleFactor();
+    bool clipToRectangle (const Rectangle<int>&);
+    bool clipToRectangleList (const RectangleList&);
+    void excludeClipRectangle (const Rectangle<int>&);
+    void clipToPath (const Path&, const AffineTransform&);
+    void clipToImageAlpha (const Image&, const AffineTransform&);
+    bool clipRegionIntersects (const Rectangle<int>&);
+    Rectangle<int> getClipBounds() const;
+    bool isClipEmpty() const;
+
+    void saveState();
+    void restoreState();
+
+    void beginTransparencyLayer (float opacity);
+    void endTransparencyLayer();
+
+    void setFill (const FillType&);
+    void setOpacity (float opacity);
+    void setInterpolationQuality (Graphics::ResamplingQuality);
+
+    void fillRect (const Rectangle<int>&, bool replaceExistingContents);
+    void fillPath (const Path&, const AffineTransform&);
+
+    void drawImage (const Image&, const AffineTransform&);
+
+    void drawLine (const Line <float>&);
+    void drawVerticalLine (int x, float top, float bottom);
+    void drawHorizontalLine (int y, float left, float right);
+
+    void setFont (const Font&);
+    const Font& getFont();
+    void drawGlyph (int glyphNumber, const AffineTransform&);
+
+private:
+    //==============================================================================
+    DisplayList& displayList;
+
+    // This keeps track of the clip region and transform, so that the clip queries can be
+    // answered while recording, but it never draws anything.
+    LowLevelGraphicsSoftwareRenderer clipTracker;
+
+    void addStateChange (Operation*);
+    void addDrawingOperation (Operation*, const Rectangle<int>& deviceSpaceArea);
+    Rectangle<int> getDeviceSpaceArea (const Rectangle<float>& userSpaceArea) const;
+    Rectangle<int> getDrawingArea (const Rectangle<float>& userSpaceArea) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Recorder)
+};
+
+
+#endif   // __JUCE_DISPLAYLIST_JUCEHEADER__
@@ -37,6 +37,153 @@ namespace
     }
 }
 
+//==============================================================================
+// Keeps the glyph arrangements that the text-drawing methods have recently laid out,
+// so that text which is drawn on every repaint doesn't have to be laid out again. The
+// layouts are made at the origin and translated into position when they're drawn.
+class TextLayoutCache  : private DeletedAtShutdown
+{
+public:
+    enum LayoutType
+    {
+        singleLine,
+        multiLine,
+        curtailedLine,
+        fittedText
+    };
+
+    struct Key
+    {
+        Key (const LayoutType type_, const String& text_, const Font& font_,
+             const int width_, const int height_, const int justification_,
+             const int maxLines_ = 0, const float minScale_ = 0)
+            : type (type_), text (text_), font (font_),
+              width (width_), height (height_), justification (justification_),
+              maxLines (maxLines_), minScale (minScale_),
+              hash (text_.hashCode() + 31 * (roundToInt (font_.getHeight() * 64.0f) + 31 * (width_ + 31 * (height_ + 31 * (justification_ + 7 * (int) type_)))))
+        {
+        }
+
+        bool operator== (const Key& other) const noexcept
+        {
+            return hash == other.hash && type == other.type
+                && width == other.width && height == other.height
+                && justification == other.justification
+                && maxLines == other.maxLines && minScale == other.minScale
+                && text == other.text && font == other.font;
+        }
+
+        LayoutType type;
+        String text;
+        Font font;
+        int width, height, justification, maxLines;
+        float minScale;
+        int hash;
+    };
+
+    struct Layout  : public ReferenceCountedObject
+    {
+        Layout (const Key& key_)
+            : key (key_), xOffset (0)
+        {
+            const float w = (float) key.width;
+            const float h = (float) key.height;
+
+            switch (key.type)
+            {
+                case singleLine:
+                {
+                    arrangement.addLineOfText (key.font, key.text, 0, 0);
+
+                    if (key.justification != Justification::left)
+                    {
+                        xOffset = -arrangement.getBoundingBox (0, -1, true).getWidth();
+
+                        if ((key.justification & (Justification::horizontallyCentred | Justification::horizontallyJustified)) != 0)
+                            xOffset /= 2.0f;
+                    }
+
+                    break;
+                }
+
+                case multiLine:
+                    arrangement.addJustifiedText (key.font, key.text, 0, 0, w, Justification::left);
+                    break;
+
+                case curtailedLine:
+                    arrangement.addCurtailedLineOfText (key.font, key.text, 0, 0, w, key.maxLines != 0);
+                    arrangement.justifyGlyphs (0, arrangement.getNumGlyphs(), 0, 0, w, h, key.justification);
+                    break;
+
+                default:
+                    arrangement.addFittedText (key.font, key.text, 0, 0, w, h, key.justification, key.maxLines, key.minScale);
+                    break;
+            }
+        }
+
+        void draw (const Graphics& g, const float x, const float y) const
+        {
+            arrangement.draw (g, AffineTransform::translation (x + xOffset, y));
+        }
+
+        typedef ReferenceCountedObjectPtr<Layout> Ptr;
+
+        const Key key;
+        GlyphArrangement arrangement;
+        float xOffset;
+
+        JUCE_DECLARE_NON_COPYABLE (Layout)
+    };
+
+    TextLayoutCache()
+    {
+        setSize (4096);
+    }
+
+    ~TextLayoutCache()
+    {
+        clearSingletonInstance();
+    }
+
+    Layout::Ptr getLayout (const Key& key)
+    {
+        const ScopedLock sl (lock);
+
+        if (slots.size() == 0)
+            return new Layout (key);
+
+        Layout::Ptr& slot = slots.getReference ((int) (((uint32) key.hash) % (uint32) slots.size()));
+
+        if (slot == nullptr || ! (slot->key == key))
+            slot = new Layout (key);
+
+        return slot;
+    }
+
+    void setSize (const int numLayouts)
+    {
+        const ScopedLock sl (lock);
+        slots.clear();
+        slots.insertMultiple (0, Layout::Ptr(), jmax (0, numLayouts));
+    }
+
+    juce_DeclareSingleton (TextLayoutCache, false);
+
+private:
+    // (each layout has just one slot that it can go into, chosen by its hash code)
+    Array<Layout::Ptr> slots;
+    CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE (TextLayoutCache)
+};
+
+juce_ImplementSingleton (TextLayoutCache);
+
+void Graphics::setTextLayoutCacheSize (const int maxNumLayouts)
+{
+    TextLayoutCache::getInstance()->setSize (maxNumLayouts);
+}
+
 //==============================================================================
 LowLevelGraphicsContext::LowLevelGraphicsContext() {}
 LowLevelGraphicsContext::~LowLevelGraphicsContext() {}
@@ -228,27 +375,13 @@ void Graphics::drawSingleLineText (const String& text, const int startX, const i
     if (text.isNotEmpty()
          && startX < context.getClipBounds().getRight())
     {
-        GlyphArrangement arr;
-        arr.addLineOfText (context.getFont(), text, (float) startX, (float) baselineY);
-
         // Don't pass any vertical placement flags to this method - they'll be ignored.
         jassert (justification.getOnlyVerticalFlags() == 0);
 
-        const int flags = justification.getOnlyHorizontalFlags();
-
-        if (flags != Justification::left)
-        {
-            float w = arr.getBoundingBox (0, -1, true).getWidth();
-
-            if ((flags & (Justification::horizontallyCentred | Justification::horizontallyJustified)) != 0)
-                w /= 2.0f;
+        const TextLayoutCache::Key key (TextLayoutCache::singleLine, text, context.getFont(),
+                                        0, 0, justification.getOnlyHorizontalFlags());
 
-            arr.draw (*this, AffineTransform::translation (-w, 0));
-        }
-        else
-        {
-            arr.draw (*this);
-        }
+        TextLayoutCache::getInstance()->getLayout (key)->draw (*this, (float) startX, (float) baselineY);
     }
 }
 
@@ -256,9 +389,8 @@ void Graphics::drawTextAsPath (const String& text, const AffineTransform& transf
 {
     if (text.isNotEmpty())
     {
-        GlyphArrangement arr;
-        arr.addLineOfText (context.getFont(), text, 0.0f, 0.0f);
-        arr.draw (*this, transform);
+        const TextLayoutCache::Key key (TextLayoutCache::singleLine, text, context.getFont(), 0, 0, Justification::left);
+        TextLayoutCache::getInstance()->getLayout (key)->arrangement.draw (*this, transform);
     }
 }
 
@@ -268,11 +400,10 @@ void Graphics::drawMultiLineText (const String& text, const int startX,
     if (text.isNotEmpty()
          && startX < context.getClipBounds().getRight())
     {
-        GlyphArrangement arr;
-        arr.addJustifiedText (context.getFont(), text,
-                              (float) startX, (float) baselineY, (float) maximumLineWidth,
-                              Justification::left);
-        arr.draw (*this);
+        const TextLayoutCache::Key key (TextLayoutCache::multiLine, text, context.getFont(),
+                                        maximumLineWidth, 0, Justification::left);
+
+        TextLayoutCache::getInstance()->getLayout (key)->draw (*this, (float) startX, (float) baselineY);
     }
 }
 
@@ -282,16 +413,11 @@ void Graphics::drawText (const String& text, const Rectangle<int>& area,
 {
     if (text.isNotEmpty() && context.clipRegionIntersects (area))
     {
-        GlyphArrangement arr;
-        arr.addCurtailedLineOfText (context.getFont(), text,
-                                    0.0f, 0.0f, (float) area.getWidth(),
-                                    useEllipsesIfTooBig);
-
-        arr.justifyGlyphs (0, arr.getNumGlyphs(),
-                           (float) area.getX(), (float) area.getY(),
-                           (float) area.getWidth(), (float) area.getHeight(),
-                           justificationType);
-        arr.draw (*this);
+        const TextLayoutCache::Key key (TextLayoutCache::curtailedLine, text, context.getFont(),
+                                        area.getWidth(), area.getHeight(), justificationType.getFlags(),
+                                        useEllipsesIfTooBig ? 1 : 0);
+
+        TextLayoutCache::getInstance()->getLayout (key)->draw (*this, (float) area.getX(), (float) area.getY());
     }
 }
 
@@ -309,15 +435,11 @@ void Graphics::drawFittedText (const String& text, const Rectangle<int>& area,
 {
     if (text.isNotEmpty() && (! area.isEmpty()) && context.clipRegionIntersects (area))
     {
-        GlyphArrangement arr;
-        arr.addFittedText (context.getFont(), text,
-                           (float) area.getX(), (float) area.getY(),
-                           (float) area.getWidth(), (float) area.getHeight(),
-                           justification,
-                           maximumNumberOfLines,
-                           minimumHorizontalScale);
-
-        arr.draw (*this);
+        const TextLayoutCache::Key key (TextLayoutCache::fittedText, text, context.getFont(),
+                                        area.getWidth(), area.getHeight(), justification.getFlags(),
+                                        maximumNumberOfLines, minimumHorizontalScale);
+
+        TextLayoutCache::getInstance()->getLayout (key)->draw (*this, (float) area.getX(), (float) area.getY());
     }
 }
 
@@ -719,3 +841,59 @@ Graphics::ScopedSaveState::~ScopedSaveState()
 {
     context.restoreState();
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TextLayoutCacheTests  : public UnitTest
+{
+public:
+    TextLayoutCacheTests() : UnitTest ("Text layout cache") {}
+
+    void runTest()
+    {
+        beginTest ("Cached layouts match uncached ones");
+
+        Graphics::setTextLayoutCacheSize (0);
+        const Image expected (drawTestScene());
+
+        Graphics::setTextLayoutCacheSize (16);
+        drawTestScene();
+        const Image actual (drawTestScene());
+
+        Graphics::setTextLayoutCacheSize (4096);
+
+        bool allEqual = true;
+
+        for (int y = 0; y < expected.getHeight(); ++y)
+            for (int x = 0; x < expected.getWidth(); ++x)
+                allEqual = allEqual && expected.getPixelAt (x, y) == actual.getPixelAt (x, y);
+
+        expect (allEqual);
+    }
+
+private:
+    static Image drawTestScene()
+    {
+        Image image (Image::RGB, 300, 200, true);
+        Graphics g (image);
+        g.fillAll (Colours::white);
+        g.setColour (Colours::black);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            g.setFont (12.0f + i * 3.0f);
+            g.drawText ("Left " + String (i), 10, 10 + i * 40, 80, 20, Justification::centredLeft, true);
+            g.drawText ("A curtailed line of text", 100 + i, 10 + i * 40, 60, 20, Justification::centred, true);
+            g.drawFittedText ("Some fitted text that has to wrap", 170, 5 + i * 40, 120, 35, Justification::centred, 2);
+            g.drawSingleLineText ("Right", 290, 150 + i * 10, Justification::right);
+            g.drawMultiLineText ("Multi-line text that wraps", 10, 140 + i * 15, 100 + i * 20);
+        }
+
+        return image;
+    }
+};
+
+static TextLayoutCacheTests textLayoutCacheTests;
+
+#endif
@@ -248,6 +248,16 @@ public:
                          int maximumNumberOfLines,
                          float minimumHorizontalScale = 0.7f) const;
 
+    /** Sets the number of text layouts that the text-drawing methods can keep.
+
+        The drawText(), drawFittedText(), drawSingleLineText(), drawMultiLineText() and
+        drawTextAsPath() methods remember the glyph arrangements that they've recently
+        laid out, keyed on the text, font, size and justification, so that text which gets
+        drawn on every repaint doesn't have to be laid out again each time. The default
+        size is 4096 layouts, and setting it to zero turns the cache off.
+    */
+    static void setTextLayoutCacheSize (int maxNumLayouts);
+
     //==============================================================================
     /** Fills the context's entire clip region with the current colour or brush.
 
@@ -23,6 +23,9 @@
   ==============================================================================
 */
 
+juce_ImplementSingleton (RenderingHelpers::RenderingThreadPool)
+
+//==============================================================================
 LowLevelGraphicsSoftwareRenderer::LowLevelGraphicsSoftwareRenderer (const Image& image)
     : savedState (new RenderingHelpers::SoftwareRendererSavedState (image, image.getBounds()))
 {
@@ -147,3 +150,611 @@ void LowLevelGraphicsSoftwareRenderer::drawGlyph (int glyphNumber, const AffineT
 
 void LowLevelGraphicsSoftwareRenderer::setFont (const Font& newFont)    { savedState->font = newFont; }
 const Font& LowLevelGraphicsSoftwareRenderer::getFont()                 { return savedState->font; }
+
+void LowLevelGraphicsSoftwareRenderer::setPathCacheSizeLimit (const size_t maxNumBytes)
+{
+    RenderingHelpers::PathEdgeTableCache::getInstance().setMemoryLimit (maxNumBytes);
+}
+
+void LowLevelGraphicsSoftwareRenderer::setGlyphCacheSize (const int maxNumGlyphs)
+{
+    using namespace RenderingHelpers;
+    GlyphCache <CachedGlyphEdgeTable <SoftwareRendererSavedState>, SoftwareRendererSavedState>::getInstance()
+        .setMaximumNumGlyphs (maxNumGlyphs);
+}
+
+//==============================================================================
+namespace PixelSpanHelpers
+{
+    /*  Each of these processes as many whole blocks of pixels as it can, and returns the number
+        of pixels that it has done, leaving the caller to deal with any that are left over.
+
+        The blends all use the same arithmetic as PixelARGB::blend(): each destination component
+        is multiplied by (256 - source alpha) and shifted down by 8 bits, and then added to the
+        source component, saturating at 255.
+    */
+   #if JUCE_RENDERING_USE_SSE2
+    namespace SSE2
+    {
+        // Multiplies some 16-bit components by some multipliers of up to 256, and shifts them down by 8 bits.
+        static forcedinline __m128i scale (const __m128i components, const __m128i multipliers) noexcept
+        {
+            return _mm_srli_epi16 (_mm_mullo_epi16 (components, multipliers), 8);
+        }
+
+        // Takes a pair of pixels as 16-bit components, and returns (256 - alpha) for each component.
+        static forcedinline __m128i getInverseAlphas (const __m128i components) noexcept
+        {
+            return _mm_sub_epi16 (_mm_set1_epi16 (256),
+                                  _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (components, _MM_SHUFFLE (3, 3, 3, 3)),
+                                                       _MM_SHUFFLE (3, 3, 3, 3)));
+        }
+
+        static forcedinline __m128i blend (const __m128i d, const __m128i srcLo, const __m128i srcHi) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+
+            return _mm_adds_epu8 (_mm_packus_epi16 (srcLo, srcHi),
+                                  _mm_packus_epi16 (scale (_mm_unpacklo_epi8 (d, zero), getInverseAlphas (srcLo)),
+                                                    scale (_mm_unpackhi_epi8 (d, zero), getInverseAlphas (srcHi))));
+        }
+
+        static int fill (PixelARGB* dest, const PixelARGB colour, const int num) noexcept
+        {
+            const __m128i c = _mm_set1_epi32 ((int) colour.getARGB());
+            int i = 0;
+
+            for (; i <= num - 4; i += 4)
+                _mm_storeu_si128 ((__m128i*) (dest + i), c);
+
+            return i;
+        }
+
+        static int blend (PixelARGB* dest, const PixelARGB colour, const int num) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i src = _mm_unpacklo_epi8 (_mm_set1_epi32 ((int) colour.getARGB()), zero);
+            int i = 0;
+
+            for (; i <= num - 4; i += 4)
+                _mm_storeu_si128 ((__m128i*) (dest + i), blend (_mm_loadu_si128 ((const __m128i*) (dest + i)), src, src));
+
+            return i;
+        }
+
+        static int blend (PixelARGB* dest, const PixelARGB* src, const int num) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            int i = 0;
+
+            for (; i <= num - 4; i += 4)
+            {
+                const __m128i s = _mm_loadu_si128 ((const __m128i*) (src + i));
+
+                _mm_storeu_si128 ((__m128i*) (dest + i), blend (_mm_loadu_si128 ((const __m128i*) (dest + i)),
+                                                                _mm_unpacklo_epi8 (s, zero),
+                                                                _mm_unpackhi_epi8 (s, zero)));
+            }
+
+            return i;
+        }
+
+        static int blend (PixelARGB* dest, const PixelARGB* src, const int num, const uint32 extraAlpha) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i multiplier = _mm_set1_epi16 ((short) extraAlpha);
+            int i = 0;
+
+            for (; i <= num - 4; i += 4)
+            {
+                const __m128i s = _mm_loadu_si128 ((const __m128i*) (src + i));
+
+                _mm_storeu_si128 ((__m128i*) (dest + i), blend (_mm_loadu_si128 ((const __m128i*) (dest + i)),
+                                                                scale (_mm_unpacklo_epi8 (s, zero), multiplier),
+                                                                scale (_mm_unpackhi_epi8 (s, zero), multiplier)));
+            }
+
+            return i;
+        }
+    }
+   #endif
+
+   #if JUCE_RENDERING_USE_AVX2
+    static bool isAVX2Available() noexcept
+    {
+        static const bool avx2Present = SystemStats::hasAVX2();
+        return avx2Present;
+    }
+
+    // These do the same as the SSE2 versions, but with eight pixels at a time. (The AVX2
+    // unpack and pack instructions work within each 128-bit half, so the pixels stay in order).
+    namespace AVX2
+    {
+        JUCE_AVX2_FUNCTION static forcedinline __m256i scale (const __m256i components, const __m256i multipliers) noexcept
+        {
+            return _mm256_srli_epi16 (_mm256_mullo_epi16 (components, multipliers), 8);
+        }
+
+        JUCE_AVX2_FUNCTION static forcedinline __m256i getInverseAlphas (const __m256i components) noexcept
+        {
+            return _mm256_sub_epi16 (_mm256_set1_epi16 (256),
+                                     _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (components, _MM_SHUFFLE (3, 3, 3, 3)),
+                                                             _MM_SHUFFLE (3, 3, 3, 3)));
+        }
+
+        JUCE_AVX2_FUNCTION static forcedinline __m256i blend (const __m256i d, const __m256i srcLo, const __m256i srcHi) noexcept
+        {
+            const __m256i zero = _mm256_setzero_si256();
+
+            return _mm256_adds_epu8 (_mm256_packus_epi16 (srcLo, srcHi),
+                                     _mm256_packus_epi16 (scale (_mm256_unpacklo_epi8 (d, zero), getInverseAlphas (srcLo)),
+                                                          scale (_mm256_unpackhi_epi8 (d, zero), getInverseAlphas (srcHi))));
+        }
+
+        JUCE_AVX2_FUNCTION static int fill (PixelARGB* dest, const PixelARGB colour, const int num) noexcept
+        {
+            const __m256i c = _mm256_set1_epi32 ((int) colour.getARGB());
+            int i = 0;
+
+            for (; i <= num - 8; i += 8)
+                _mm256_storeu_si256 ((__m256i*) (dest + i), c);
+
+            return i;
+        }
+
+        JUCE_AVX2_FUNCTION static int blend (PixelARGB* dest, const PixelARGB colour, const int num) noexcept
+        {
+            const __m256i src = _mm256_unpacklo_epi8 (_mm256_set1_epi32 ((int) colour.getARGB()), _mm256_setzero_si256());
+            int i = 0;
+
+            for (; i <= num - 8; i += 8)
+                _mm256_storeu_si256 ((__m256i*) (dest + i), blend (_mm256_loadu_si256 ((const __m256i*) (dest + i)), src, src));
+
+            return i;
+        }
+
+        JUCE_AVX2_FUNCTION static int blend (PixelARGB* dest, const PixelARGB* src, const int num) noexcept
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            int i = 0;
+
+            for (; i <= num - 8; i += 8)
+            {
+                const __m256i s = _mm256_loadu_si256 ((const __m256i*) (src + i));
+
+                _mm256_storeu_si256 ((__m256i*) (dest + i), blend (_mm256_loadu_si256 ((const __m256i*) (dest + i)),
+                                                                   _mm256_unpacklo_epi8 (s, zero),
+                                                                   _mm256_unpackhi_epi8 (s, zero)));
+            }
+
+            return i;
+        }
+
+        JUCE_AVX2_FUNCTION static int blend (PixelARGB* dest, const PixelARGB* src, const int num, const uint32 extraAlpha) noexcept
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i multiplier = _mm256_set1_epi16 ((short) extraAlpha);
+            int i = 0;
+
+            for (; i <= num - 8; i += 8)
+            {
+                const __m256i s = _mm256_loadu_si256 ((const __m256i*) (src + i));
+
+                _mm256_storeu_si256 ((__m256i*) (dest + i), blend (_mm256_loadu_si256 ((const __m256i*) (dest + i)),
+                                                                   scale (_mm256_unpacklo_epi8 (s, zero), multiplier),
+                                                                   scale (_mm256_unpackhi_epi8 (s, zero), multiplier)));
+            }
+
+            return i;
+        }
+    }
+   #endif
+
+   #if JUCE_RENDERING_USE_NEON
+    // The NEON versions de-interleave eight pixels at a time into separate component vectors.
+    namespace NEON
+    {
+        // Returns (d * (256 - a)) >> 8, calculated as d - ceil (d * a / 256) so that it fits in 8 bits.
+        static forcedinline uint8x8_t scaleByInverseAlpha (const uint8x8_t d, const uint8x8_t a) noexcept
+        {
+            return vsub_u8 (d, vmovn_u16 (vshrq_n_u16 (vaddq_u16 (vmull_u8 (d, a), vdupq_n_u16 (255)), 8)));
+        }
+
+        static forcedinline void blend (uint8* const dest, const uint8x8x4_t& s) noexcept
+        {
+            uint8x8x4_t d = vld4_u8 (dest);
+            const uint8x8_t a = s.val [PixelARGB::indexA];
+
+            for (int c = 0; c < 4; ++c)
+                d.val[c] = vqadd_u8 (s.val[c], scaleByInverseAlpha (d.val[c], a));
+
+            vst4_u8 (dest, d);
+        }
+
+        static int fill (PixelARGB* dest, const PixelARGB colour, const int num) noexcept
+        {
+            const uint32x4_t c = vdupq_n_u32 (colour.getARGB());
+            int i = 0;
+
+            for (; i <= num - 4; i += 4)
+                vst1q_u32 (reinterpret_cast<uint32*> (dest + i), c);
+
+            return i;
+        }
+
+        static int blend (PixelARGB* dest, const PixelARGB colour, const int num) noexcept
+        {
+            const uint8* const components = reinterpret_cast<const uint8*> (&colour);
+            uint8x8x4_t s;
+
+            for (int c = 0; c < 4; ++c)
+                s.val[c] = vdup_n_u8 (components[c]);
+
+            int i = 0;
+
+            for (; i <= num - 8; i += 8)
+                blend (reinterpret_cast<uint8*> (dest + i), s);
+
+            return i;
+        }
+
+        static int blend (PixelARGB* dest, const PixelARGB* src, const int num) noexcept
+        {
+            int i = 0;
+
+            for (; i <= num - 8; i += 8)
+                blend (reinterpret_cast<uint8*> (dest + i), vld4_u8 (reinterpret_cast<const uint8*> (src + i)));
+
+            return i;
+        }
+
+        static int blend (PixelARGB* dest, const PixelARGB* src, const int num, const uint32 extraAlpha) noexcept
+        {
+            const uint16x8_t multiplier = vdupq_n_u16 ((uint16) extraAlpha);
+            int i = 0;
+
+            for (; i <= num - 8; i += 8)
+            {
+                uint8x8x4_t s = vld4_u8 (reinterpret_cast<const uint8*> (src + i));
+
+                for (int c = 0; c < 4; ++c)
+                    s.val[c] = vmovn_u16 (vshrq_n_u16 (vmulq_u16 (vmovl_u8 (s.val[c]), multiplier), 8));
+
+                blend (reinterpret_cast<uint8*> (dest + i), s);
+            }
+
+            return i;
+        }
+    }
+   #endif
+}
+
+#if JUCE_RENDERING_USE_AVX2
+ #define JUCE_PIXEL_SPAN_OP(op) (PixelSpanHelpers::isAVX2Available() ? PixelSpanHelpers::AVX2::op : PixelSpanHelpers::SSE2::op)
+#elif JUCE_RENDERING_USE_SSE2
+ #define JUCE_PIXEL_SPAN_OP(op) PixelSpanHelpers::SSE2::op
+#elif JUCE_RENDERING_USE_NEON
+ #define JUCE_PIXEL_SPAN_OP(op) PixelSpanHelpers::NEON::op
+#else
+ #define JUCE_PIXEL_SPAN_OP(op) 0
+#endif
+
+void JUCE_CALLTYPE RenderingHelpers::PixelSpans::fill (PixelARGB* dest, const PixelARGB colour, const int num) noexcept
+{
+    for (int i = JUCE_PIXEL_SPAN_OP (fill (dest, colour, num)); i < num; ++i)
+        dest[i].set (colour);
+}
+
+void JUCE_CALLTYPE RenderingHelpers::PixelSpans::blend (PixelARGB* dest, const PixelARGB colour, const int num) noexcept
+{
+    for (int i = JUCE_PIXEL_SPAN_OP (blend (dest, colour, num)); i < num; ++i)
+        dest[i].blend (colour);
+}
+
+void JUCE_CALLTYPE RenderingHelpers::PixelSpans::blend (PixelARGB* dest, const PixelARGB* src, const int num) noexcept
+{
+    for (int i = JUCE_PIXEL_SPAN_OP (blend (dest, src, num)); i < num; ++i)
+        dest[i].blend (src[i]);
+}
+
+void JUCE_CALLTYPE RenderingHelpers::PixelSpans::blend (PixelARGB* dest, const PixelARGB* src, const int num, const uint32 extraAlpha) noexcept
+{
+    jassert (extraAlpha <= 256);
+
+    for (int i = JUCE_PIXEL_SPAN_OP (blend (dest, src, num, extraAlpha)); i < num; ++i)
+        dest[i].blend (src[i], extraAlpha);
+}
+
+#undef JUCE_PIXEL_SPAN_OP
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PixelSpansTests  : public UnitTest
+{
+public:
+    PixelSpansTests() : UnitTest ("PixelSpans") {}
+
+    void runTest()
+    {
+        beginTest ("Spans match the single-pixel operations");
+
+        Random r;
+
+        for (int num = 0; num < 50; ++num)
+        {
+            HeapBlock<PixelARGB> src ((size_t) num + 1), original ((size_t) num + 1),
+                                 expected ((size_t) num + 1), actual ((size_t) num + 1);
+
+            for (int i = 0; i < num; ++i)
+            {
+                src[i] = createRandomPixel (r);
+                original[i] = createRandomPixel (r);
+            }
+
+            const PixelARGB colour (createRandomPixel (r));
+            const uint32 extraAlpha = (uint32) r.nextInt (257);
+
+            for (int op = 0; op < 4; ++op)
+            {
+                for (int i = 0; i < num; ++i)
+                {
+                    expected[i] = actual[i] = original[i];
+
+                    switch (op)
+                    {
+                        case 0:     expected[i].set (colour); break;
+                        case 1:     expected[i].blend (colour); break;
+                        case 2:     expected[i].blend (src[i]); break;
+                        default:    expected[i].blend (src[i], extraAlpha); break;
+                    }
+                }
+
+                switch (op)
+                {
+                    case 0:     RenderingHelpers::PixelSpans::fill  (actual, colour, num); break;
+                    case 1:     RenderingHelpers::PixelSpans::blend (actual, colour, num); break;
+                    case 2:     RenderingHelpers::PixelSpans::blend (actual, src, num); break;
+                    default:    RenderingHelpers::PixelSpans::blend (actual, src, num, extraAlpha); break;
+                }
+
+                expect (memcmp (expected, actual, sizeof (PixelARGB) * (size_t) num) == 0);
+            }
+        }
+    }
+
+private:
+    static PixelARGB createRandomPixel (Random& r)
+    {
+        PixelARGB p ((uint32) r.nextInt());
+
+        // (mostly premultiplied pixels, but some invalid ones to check that the saturation matches)
+        if (r.nextInt (4) != 0)
+            p.premultiply();
+
+        return p;
+    }
+};
+
+static PixelSpansTests pixelSpansTests;
+
+//==============================================================================
+class PathEdgeTableCacheTests  : public UnitTest
+{
+public:
+    PathEdgeTableCacheTests() : UnitTest ("Path edge table cache") {}
+
+    void runTest()
+    {
+        beginTest ("Cached fills match uncached ones");
+
+        LowLevelGraphicsSoftwareRenderer::setPathCacheSizeLimit (0);
+        const Image expected (drawTestScene());
+
+        LowLevelGraphicsSoftwareRenderer::setPathCacheSizeLimit (64 * 1024);
+        const Image actual (drawTestScene());
+
+        LowLevelGraphicsSoftwareRenderer::setPathCacheSizeLimit (8 * 1024 * 1024);
+
+        // (a cached table is moved into place after the path has been flattened, rather than
+        // before, so the float rounding can occasionally nudge an edge by 1/256 of a pixel)
+        int largestDifference = 0;
+
+        for (int y = 0; y < expected.getHeight(); ++y)
+        {
+            for (int x = 0; x < expected.getWidth(); ++x)
+            {
+                const Colour c1 (expected.getPixelAt (x, y));
+                const Colour c2 (actual.getPixelAt (x, y));
+
+                largestDifference = jmax (largestDifference,
+                                          jmax (std::abs (c1.getAlpha() - c2.getAlpha()), std::abs (c1.getRed()  - c2.getRed()),
+                                                std::abs (c1.getGreen() - c2.getGreen()), std::abs (c1.getBlue() - c2.getBlue())));
+            }
+        }
+
+        expect (largestDifference <= 2);
+    }
+
+private:
+    static Image drawTestScene()
+    {
+        Image image (Image::ARGB, 200, 200, true);
+        Graphics g (image);
+
+        Path star;
+        star.addStar (Point<float> (30.0f, 30.0f), 7, 10.0f, 25.0f);
+
+        for (int i = 0; i < 5; ++i)
+        {
+            g.setColour (Colours::red.withAlpha (0.5f));
+            g.fillPath (star, AffineTransform::translation (i * 30.0f, i * 7.0f));
+            g.fillPath (star, AffineTransform::translation (i * 30.0f + 0.25f, 100.0f));
+            g.fillPath (star, AffineTransform::rotation (0.2f).translated (100.0f, i * 20.0f));
+
+            Graphics::ScopedSaveState ss (g);
+            g.reduceClipRegion (i * 20, 0, 50, 200);
+            g.setColour (Colours::blue);
+            g.fillPath (star, AffineTransform::translation (50.0f, 120.0f));
+        }
+
+        return image;
+    }
+};
+
+static PathEdgeTableCacheTests pathEdgeTableCacheTests;
+
+//==============================================================================
+class GlyphCacheTests  : public UnitTest
+{
+public:
+    GlyphCacheTests() : UnitTest ("Glyph cache") {}
+
+    void runTest()
+    {
+        typedef RenderingHelpers::GlyphCache <RenderingHelpers::CachedGlyphEdgeTable <RenderingHelpers::SoftwareRendererSavedState>,
+                                              RenderingHelpers::SoftwareRendererSavedState> CacheType;
+
+        CacheType& cache = CacheType::getInstance();
+        const int originalSize = cache.getMaximumNumGlyphs();
+
+        beginTest ("Hits and misses");
+
+        Image image (Image::ARGB, 200, 50, true);
+        Graphics g (image);
+        g.setFont (Font (17.0f));
+
+        cache.resetStatistics();
+        g.drawSingleLineText ("Glyph cache", 5, 30);
+        const int64 missesAfterFirstDraw = cache.getNumMisses();
+
+        g.drawSingleLineText ("Glyph cache", 5, 30);
+        expectEquals (cache.getNumMisses(), missesAfterFirstDraw);
+        expect (cache.getNumHits() >= 9);
+
+        beginTest ("Size limit");
+
+        cache.setMaximumNumGlyphs (32);
+        expect (cache.getNumGlyphs() <= 32);
+
+        for (int i = 0; i < 20; ++i)
+            g.drawSingleLineText (String (i) + "abcdefghijklmnopqrstuvwxyz", 5, 30);
+
+        expect (cache.getNumGlyphs() <= 32);
+        cache.setMaximumNumGlyphs (originalSize);
+    }
+};
+
+static GlyphCacheTests glyphCacheTests;
+
+//==============================================================================
+class SoftwareRendererBenchmark  : public Benchmark
+{
+public:
+    enum FillType
+    {
+        solidFill,
+        translucentFill,
+        gradientFill,
+        imageFill,
+        transformedImageFill
+    };
+
+    SoftwareRendererBenchmark (const Image::PixelFormat format_, const FillType fillType_)
+        : Benchmark ("Software renderer: " + getFillTypeName (fillType_) + ", " + getFormatName (format_)),
+          format (format_), fillType (fillType_)
+    {
+    }
+
+    void initialise()
+    {
+        destImage = Image (format, imageSize, imageSize, true);
+        sourceImage = Image (Image::ARGB, imageSize, imageSize, true);
+
+        Graphics g (sourceImage);
+        g.setGradientFill (ColourGradient (Colours::red.withAlpha (0.8f), 0.0f, 0.0f,
+                                           Colours::blue.withAlpha (0.4f), (float) imageSize, (float) imageSize, false));
+        g.fillAll();
+    }
+
+    void runIteration()
+    {
+        Graphics g (destImage);
+        const Rectangle<float> area (4.0f, 4.0f, imageSize - 8.0f, imageSize - 8.0f);
+
+        switch (fillType)
+        {
+            case solidFill:         g.setColour (Colours::green); g.fillEllipse (area); break;
+            case translucentFill:   g.setColour (Colours::green.withAlpha (0.5f)); g.fillEllipse (area); break;
+
+            case gradientFill:
+                g.setGradientFill (ColourGradient (Colours::yellow, 0.0f, 0.0f,
+                                                   Colours::blue.withAlpha (0.5f), (float) imageSize, 0.0f, false));
+                g.fillEllipse (area);
+                break;
+
+            case imageFill:         g.drawImageAt (sourceImage, 0, 0); break;
+
+            default:
+                g.setImageResamplingQuality (Graphics::mediumResamplingQuality);
+                g.drawImageTransformed (sourceImage, AffineTransform::rotation (0.1f, imageSize * 0.5f, imageSize * 0.5f));
+                break;
+        }
+
+        preventOptimisation (destImage.getPixelData());
+    }
+
+    void shutdown()
+    {
+        destImage = Image::null;
+        sourceImage = Image::null;
+    }
+
+private:
+    enum { imageSize = 512 };
+
+    const Image::PixelFormat format;
+    const FillType fillType;
+    Image destImage, sourceImage;
+
+    static String getFormatName (const Image::PixelFormat format)
+    {
+        switch (format)
+        {
+            case Image::ARGB:   return "ARGB";
+            case Image::RGB:    return "RGB";
+            default:            return "single-channel";
+        }
+    }
+
+    static String getFillTypeName (const FillType fillType)
+    {
+        switch (fillType)
+        {
+            case solidFill:         return "solid colour";
+            case translucentFill:   return "translucent colour";
+            case gradientFill:      return "gradient";
+            case imageFill:         return "image";
+            default:                return "transformed image";
+        }
+    }
+};
+
+// Runs each type of fill into each of the image formats, so that their fill-rates can be compared.
+struct SoftwareRendererBenchmarks
+{
+    SoftwareRendererBenchmarks()
+    {
+        const Image::PixelFormat formats[] = { Image::ARGB, Image::RGB, Image::SingleChannel };
+
+        for (int i = 0; i < numElementsInArray (formats); ++i)
+            for (int fillType = SoftwareRendererBenchmark::solidFill; fillType <= SoftwareRendererBenchmark::transformedImageFill; ++fillType)
+                benchmarks.add (new SoftwareRendererBenchmark (formats[i], (SoftwareRendererBenchmark::FillType) fillType));
+    }
+
+    OwnedArray<SoftwareRendererBenchmark> benchmarks;
+};
+
+static SoftwareRendererBenchmarks softwareRendererBenchmarks;
+
+#endif
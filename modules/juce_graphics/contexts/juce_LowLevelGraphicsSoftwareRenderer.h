@@ -83,6 +83,23 @@ public:
     void drawGlyph (int glyphNumber, float x, float y);
     void drawGlyph (int glyphNumber, const AffineTransform&);
 
+    //==============================================================================
+    /** Sets the amount of memory that may be used for caching the rasterised shapes of
+        paths that get filled repeatedly.
+
+        When the same path is filled more than once with the same transform (apart from
+        moving it by a whole number of pixels), the renderer keeps its edge table, so that
+        later fills don't need to flatten the path again. The default limit is 8MB, and
+        setting it to zero turns the cache off.
+    */
+    static void setPathCacheSizeLimit (size_t maxNumBytes);
+
+    /** Sets the number of glyphs that the renderer can keep in its cache of rendered glyphs.
+        The default size is 2048 glyphs.
+    */
+    static void setGlyphCacheSize (int maxNumGlyphs);
+
+    //==============================================================================
     const Image& getImage() const noexcept                                          { return savedState->image; }
     const RenderingHelpers::TranslationOrTransform& getTransform() const noexcept   { return savedState->transform; }
 
@@ -0,0 +1,227 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+//==============================================================================
+class LowLevelGraphicsTiledRenderer::TileRenderer  : public ParallelTask
+{
+public:
+    TileRenderer (const LowLevelGraphicsTiledRenderer& owner_)
+        : owner (owner_)
+    {
+        const Rectangle<int> bounds (owner.initialClip.getBounds());
+
+        for (int y = bounds.getY(); y < bounds.getBottom(); y += owner.tileSize)
+        {
+            for (int x = bounds.getX(); x < bounds.getRight(); x += owner.tileSize)
+            {
+                const Rectangle<int> tile (Rectangle<int> (x, y, owner.tileSize, owner.tileSize).getIntersection (bounds));
+
+                if (owner.initialClip.intersectsRectangle (tile))
+                    tiles.add (tile);
+            }
+        }
+    }
+
+    void runChunk (int tileIndex)
+    {
+        const Rectangle<int> tile (tiles.getReference (tileIndex));
+
+        RectangleList clip (owner.initialClip);
+        clip.clipTo (tile);
+
+        LowLevelGraphicsSoftwareRenderer renderer (owner.image, owner.origin, clip);
+        owner.displayList.draw (renderer, tile - owner.origin);
+    }
+
+    const LowLevelGraphicsTiledRenderer& owner;
+    Array<Rectangle<int> > tiles;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (TileRenderer)
+};
+
+//==============================================================================
+namespace TiledRendererHelpers
+{
+    static RectangleList getUserSpaceClip (RectangleList clip, const Point<int> origin)
+    {
+        clip.offsetAll (-origin.x, -origin.y);
+        return clip;
+    }
+}
+
+LowLevelGraphicsTiledRenderer::LowLevelGraphicsTiledRenderer (const Image& image_, Point<int> origin_,
+                                                              const RectangleList& initialClip_,
+                                                              ThreadPool* poolToUse, int tileSize_)
+    : DisplayList::Recorder (displayList, TiledRendererHelpers::getUserSpaceClip (initialClip_, origin_)),
+      image (image_),
+      origin (origin_),
+      initialClip (initialClip_),
+      pool (poolToUse != nullptr ? poolToUse : RenderingHelpers::RenderingThreadPool::getInstance()),
+      tileSize (jmax (16, tileSize_))
+{
+}
+
+LowLevelGraphicsTiledRenderer::~LowLevelGraphicsTiledRenderer()
+{
+    renderTiles();
+}
+
+void LowLevelGraphicsTiledRenderer::renderTiles()
+{
+    if (! displayList.isEmpty())
+    {
+        // (the caches are created on first use, which mustn't happen on several threads at once)
+        using namespace RenderingHelpers;
+        GlyphCache <CachedGlyphEdgeTable <SoftwareRendererSavedState>, SoftwareRendererSavedState>::getInstance();
+        PathEdgeTableCache::getInstance();
+
+        TileRenderer renderer (*this);
+        renderer.run (*pool, renderer.tiles.size());
+        displayList.clear();
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LowLevelGraphicsTiledRendererTests  : public UnitTest
+{
+public:
+    LowLevelGraphicsTiledRendererTests() : UnitTest ("LowLevelGraphicsTiledRenderer") {}
+
+    void runTest()
+    {
+        beginTest ("Tiled rendering matches the software renderer");
+
+        ThreadPool pool (3);
+        const Image::PixelFormat formats[] = { Image::ARGB, Image::RGB, Image::SingleChannel };
+
+        for (int i = 0; i < numElementsInArray (formats); ++i)
+            expect (getLargestDifference (formats[i], pool, false) == 0);
+
+        beginTest ("Resampled images");
+
+        // The software renderer steps through the source image from the start of each span, so
+        // splitting the spans at the tile edges can nudge the sampling by a rounding error.
+        for (int i = 0; i < numElementsInArray (formats); ++i)
+            expect (getLargestDifference (formats[i], pool, true) <= 2);
+    }
+
+private:
+    static int getLargestDifference (const Image::PixelFormat format, ThreadPool& pool, const bool drawResampledImage)
+    {
+        RectangleList clip (Rectangle<int> (5, 3, 180, 150));
+        clip.subtract (Rectangle<int> (60, 40, 30, 20));
+
+        Image expected (format, 200, 160, true);
+        Image actual (format, 200, 160, true);
+
+        {
+            LowLevelGraphicsSoftwareRenderer context (expected, Point<int> (3, -2), clip);
+            Graphics g (&context);
+            drawTestScene (g, drawResampledImage);
+        }
+
+        {
+            // (the odd tile size is to make sure that shapes get split at awkward places)
+            LowLevelGraphicsTiledRenderer context (actual, Point<int> (3, -2), clip, &pool, 37);
+            Graphics g (&context);
+            drawTestScene (g, drawResampledImage);
+        }
+
+        int largestDifference = 0;
+
+        for (int y = 0; y < expected.getHeight(); ++y)
+        {
+            for (int x = 0; x < expected.getWidth(); ++x)
+            {
+                const Colour c1 (expected.getPixelAt (x, y));
+                const Colour c2 (actual.getPixelAt (x, y));
+
+                largestDifference = jmax (largestDifference,
+                                          jmax (std::abs (c1.getAlpha() - c2.getAlpha()), std::abs (c1.getRed()  - c2.getRed()),
+                                                std::abs (c1.getGreen() - c2.getGreen()), std::abs (c1.getBlue() - c2.getBlue())));
+            }
+        }
+
+        return largestDifference;
+    }
+
+    static void drawTestScene (Graphics& g, const bool drawResampledImage)
+    {
+        Image sourceImage (Image::ARGB, 64, 64, true);
+
+        {
+            Graphics g2 (sourceImage);
+            g2.setGradientFill (ColourGradient (Colours::red, 0.0f, 0.0f, Colours::blue.withAlpha (0.3f), 64.0f, 64.0f, false));
+            g2.fillEllipse (2.0f, 2.0f, 60.0f, 60.0f);
+        }
+
+        g.fillAll (Colours::white);
+
+        g.setGradientFill (ColourGradient (Colours::yellow, 10.0f, 10.0f, Colours::green.withAlpha (0.5f), 150.0f, 120.0f, true));
+        g.fillRoundedRectangle (8.5f, 6.25f, 160.0f, 120.0f, 12.0f);
+
+        g.setColour (Colours::black.withAlpha (0.7f));
+        g.drawLine (0.0f, 0.0f, 190.0f, 155.0f, 3.0f);
+        g.drawHorizontalLine (70, 2.0f, 180.5f);
+        g.drawVerticalLine (100, 4.5f, 140.0f);
+
+        g.setFont (14.0f);
+        g.drawText ("Tiled rendering", 10, 20, 150, 20, Justification::centredLeft, false);
+
+        {
+            Graphics::ScopedSaveState ss (g);
+            g.addTransform (AffineTransform::rotation (0.3f, 90.0f, 80.0f));
+            g.drawText ("Rotated", 60, 70, 100, 20, Justification::centred, false);
+
+            if (drawResampledImage)
+            {
+                g.setImageResamplingQuality (Graphics::mediumResamplingQuality);
+                g.drawImageAt (sourceImage, 70, 50);
+            }
+        }
+
+        {
+            Graphics::ScopedSaveState ss (g);
+            Path p;
+            p.addStar (Point<float> (120.0f, 100.0f), 7, 20.0f, 50.0f);
+            g.reduceClipRegion (p);
+            g.setTiledImageFill (sourceImage, 3, 5, 0.8f);
+            g.fillAll();
+        }
+
+        g.beginTransparencyLayer (0.6f);
+        g.setColour (Colours::purple);
+        g.fillEllipse (30.0f, 80.0f, 90.0f, 60.0f);
+        g.drawImageAt (sourceImage, 40, 90);
+        g.endTransparencyLayer();
+    }
+};
+
+static LowLevelGraphicsTiledRendererTests lowLevelGraphicsTiledRendererTests;
+
+#endif
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_LOWLEVELGRAPHICSTILEDRENDERER_JUCEHEADER__
+#define __JUCE_LOWLEVELGRAPHICSTILEDRENDERER_JUCEHEADER__
+
+#include "juce_DisplayList.h"
+
+
+//==============================================================================
+/**
+    A LowLevelGraphicsContext that renders into an image using several threads at once.
+
+    Instead of drawing straight away, this records the operations that are performed on
+    it into a DisplayList. When the renderer is deleted, the image is divided into tiles, and each tile is
+    rasterised by a separate LowLevelGraphicsSoftwareRenderer whose clip region is limited
+    to that tile. The tiles are shared out between the threads of a ThreadPool, and the
+    calling thread works on them too, so by the time the destructor returns, the image
+    contains the same picture that a LowLevelGraphicsSoftwareRenderer would have drawn
+    (apart from images drawn with a non-integer transform, whose resampling may be out
+    by a rounding error along the tile edges).
+
+    This is worth using when large areas need to be repainted, e.g. on high-resolution
+    displays. To use it for a window's repaints, you can override
+    LookAndFeel::createGraphicsContext() to return one of these.
+
+    Because the drawing happens later, any images that get drawn mustn't be modified until
+    the renderer has been deleted.
+
+    @see LowLevelGraphicsSoftwareRenderer, DisplayList
+*/
+class JUCE_API  LowLevelGraphicsTiledRenderer    : public DisplayList::Recorder
+{
+public:
+    //==============================================================================
+    /** Creates a renderer for an image.
+
+        @param imageToRenderOnto    the image to draw on
+        @param origin               the position in the image of the origin of the coordinate space
+        @param initialClip          the area of the image that may be drawn on
+        @param poolToUse            the pool whose threads should be used. If this is nullptr, a
+                                    shared pool with a thread for each extra CPU core is used. The
+                                    pool must not be deleted before the renderer.
+        @param tileSize             the width and height of the tiles that the image is split into
+    */
+    LowLevelGraphicsTiledRenderer (const Image& imageToRenderOnto, Point<int> origin,
+                                   const RectangleList& initialClip,
+                                   ThreadPool* poolToUse = nullptr,
+                                   int tileSize = 256);
+
+    /** Destructor.
+        This is where the drawing actually happens - it rasterises all the operations that
+        have been recorded, and returns when they've finished.
+    */
+    ~LowLevelGraphicsTiledRenderer();
+
+private:
+    //==============================================================================
+    class TileRenderer;
+
+    // (the base class only keeps a reference to this, so it's fine for it to be created afterwards)
+    DisplayList displayList;
+
+    const Image image;
+    const Point<int> origin;
+    const RectangleList initialClip;
+    ThreadPool* const pool;
+    const int tileSize;
+
+    void renderTiles();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsTiledRenderer)
+};
+
+
+#endif   // __JUCE_LOWLEVELGRAPHICSTILEDRENDERER_JUCEHEADER__
@@ -43,18 +43,109 @@ static inline void blurDataTriplets (uint8* d, int num, const int delta) noexcep
     d[0] = (uint8) ((last + d[0] + 1) / 3);
 }
 
+// Does the same as calling blurDataTriplets() on each of a group of neighbouring columns,
+// but works along the rows, which is much kinder to the cache.
+static void blurColumnTriplets (uint8* data, const int numColumns, const int height,
+                                const int lineStride, uint32* const last) noexcept
+{
+    uint8* next = data + lineStride;
+
+    for (int x = 0; x < numColumns; ++x)
+    {
+        last[x] = data[x];
+        data[x] = (uint8) ((data[x] + next[x] + 1) / 3);
+    }
+
+    for (int y = height - 2; --y >= 0;)
+    {
+        data = next;
+        next += lineStride;
+
+        for (int x = 0; x < numColumns; ++x)
+        {
+            const uint32 newLast = data[x];
+            data[x] = (uint8) ((last[x] + data[x] + next[x] + 1) / 3);
+            last[x] = newLast;
+        }
+    }
+
+    for (int x = 0; x < numColumns; ++x)
+        next[x] = (uint8) ((last[x] + next[x] + 1) / 3);
+}
+
+struct ShadowBlurrer
+{
+    ShadowBlurrer (uint8* const data_, const int width_, const int height_,
+                   const int lineStride_, const int repetitions_) noexcept
+        : data (data_), width (width_), height (height_),
+          lineStride (lineStride_), repetitions (repetitions_)
+    {
+    }
+
+    struct Rows
+    {
+        Rows (const ShadowBlurrer& owner_) noexcept : owner (owner_) {}
+
+        void operator() (const int startRow, const int endRow) const noexcept
+        {
+            for (int y = startRow; y < endRow; ++y)
+                for (int i = owner.repetitions; --i >= 0;)
+                    blurDataTriplets (owner.data + owner.lineStride * y, owner.width, 1);
+        }
+
+        const ShadowBlurrer& owner;
+        JUCE_DECLARE_NON_COPYABLE (Rows)
+    };
+
+    struct Columns
+    {
+        Columns (const ShadowBlurrer& owner_) noexcept : owner (owner_) {}
+
+        void operator() (const int startColumn, const int endColumn) const
+        {
+            HeapBlock<uint32> last ((size_t) (endColumn - startColumn));
+
+            for (int i = owner.repetitions; --i >= 0;)
+                blurColumnTriplets (owner.data + startColumn, endColumn - startColumn,
+                                    owner.height, owner.lineStride, last);
+        }
+
+        const ShadowBlurrer& owner;
+        JUCE_DECLARE_NON_COPYABLE (Columns)
+    };
+
+    // Large images have their rows and then their columns shared out between the rendering threads.
+    void blur()
+    {
+        Rows rows (*this);
+        Columns columns (*this);
+
+        if (width * height * repetitions < 256 * 1024)
+        {
+            rows (0, height);
+            columns (0, width);
+        }
+        else
+        {
+            ThreadPool& pool = *RenderingHelpers::RenderingThreadPool::getInstance();
+            parallelFor (pool, 0, height, rows, 8);
+            parallelFor (pool, 0, width, columns, 64);
+        }
+    }
+
+    uint8* const data;
+    const int width, height, lineStride, repetitions;
+
+    JUCE_DECLARE_NON_COPYABLE (ShadowBlurrer)
+};
+
 static void blurSingleChannelImage (uint8* const data, const int width, const int height,
-                                    const int lineStride, const int repetitions) noexcept
+                                    const int lineStride, const int repetitions)
 {
     jassert (width > 2 && height > 2);
 
-    for (int y = 0; y < height; ++y)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + lineStride * y, width, 1);
-
-    for (int x = 0; x < width; ++x)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + x, height, lineStride);
+    ShadowBlurrer blurrer (data, width, height, lineStride, repetitions);
+    blurrer.blur();
 }
 
 static void blurSingleChannelImage (Image& image, int radius)
@@ -85,10 +85,12 @@ EdgeTable::EdgeTable (const Rectangle<int>& bounds_,
                     const int step = jmin (stepSize, y2 - y1, 256 - (y1 & 255));
                     int x = roundToInt (startX + multiplier * ((y1 + (step >> 1)) - startY));
 
+                    // (edges beyond the right-hand side are put right on the boundary, so that
+                    // the last column's coverage doesn't depend on where the bounds are)
                     if (x < leftLimit)
                         x = leftLimit;
-                    else if (x >= rightLimit)
-                        x = rightLimit - 1;
+                    else if (x > rightLimit)
+                        x = rightLimit;
 
                     addEdgePoint (x, y1 >> 8, direction * step);
                     y1 += step;
@@ -346,6 +348,11 @@ void EdgeTable::optimiseTable()
     remapTableForNumEdges (maxLineElements);
 }
 
+size_t EdgeTable::getMemoryUsage() const noexcept
+{
+    return sizeof (int) * (size_t) lineStrideElements * (size_t) (bounds.getHeight() + 1);
+}
+
 void EdgeTable::addEdgePoint (const int x, const int y, const int winding)
 {
     jassert (y >= 0 && y < bounds.getHeight());
@@ -90,6 +90,9 @@ public:
     */
     void optimiseTable();
 
+    /** Returns the number of bytes that the table is using to store its data. */
+    size_t getMemoryUsage() const noexcept;
+
 
     //==============================================================================
     /** Iterates the lines in the table, for rendering.
@@ -121,7 +124,7 @@ public:
             if (--numPoints > 0)
             {
                 int x = *++line;
-                jassert ((x >> 8) >= bounds.getX() && (x >> 8) < bounds.getRight());
+                jassert ((x >> 8) >= bounds.getX() && (x >> 8) <= bounds.getRight());
                 int levelAccumulator = 0;
 
                 iterationCallback.setEdgeTableYPos (bounds.getY() + y);
@@ -191,6 +191,23 @@ bool Path::operator!= (const Path& other) const noexcept
     return false;
 }
 
+int64 Path::hashCode64() const noexcept
+{
+    int64 result = useNonZeroWinding ? 1 : 0;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        // (zero has two representations, which compare as equal, so they mustn't hash differently)
+        const float value = data.elements[i] == 0 ? 0.0f : data.elements[i];
+
+        uint32 bits;
+        memcpy (&bits, &value, sizeof (bits));
+        result = 101 * result + bits;
+    }
+
+    return result;
+}
+
 void Path::clear() noexcept
 {
     numElements = 0;
@@ -92,6 +92,11 @@ public:
     bool operator== (const Path& other) const noexcept;
     bool operator!= (const Path& other) const noexcept;
 
+    /** Generates a 64-bit hash code from the path's contents.
+        Paths that compare as equal will return the same value.
+    */
+    int64 hashCode64() const noexcept;
+
     //==============================================================================
     /** Returns true if the path doesn't contain any lines or curves. */
     bool isEmpty() const noexcept;
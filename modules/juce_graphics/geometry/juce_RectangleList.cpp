@@ -23,6 +23,268 @@
   ==============================================================================
 */
 
+namespace RectangleListHelpers
+{
+    enum Operation
+    {
+        unionOp,
+        intersectionOp,
+        differenceOp
+    };
+
+    /*  Sweeps down one of the input lists, keeping track of the rectangles that cross
+        the current y position, sorted by their left edges.
+
+        The rectangles needn't be sorted or non-overlapping, but when they're already in
+        banded order (which is what combine() produces), no sorting is needed and only one
+        band's worth of rectangles is ever active at a time.
+    */
+    class BandScanner
+    {
+    public:
+        BandScanner (const Rectangle<int>* const rects_, const int numRects_)
+            : rects (rects_), numRects (numRects_), nextIndex (0)
+        {
+            for (int i = 1; i < numRects; ++i)
+            {
+                if (rects[i].getY() < rects[i - 1].getY())
+                {
+                    sortedCopy.addArray (rects, numRects);
+                    TopEdgeComparator comparator;
+                    sortedCopy.sort (comparator, true);
+                    rects = sortedCopy.getRawDataPointer();
+                    break;
+                }
+            }
+        }
+
+        void advanceTo (const int y)
+        {
+            int numLeft = 0;
+
+            for (int i = 0; i < active.size(); ++i)
+            {
+                const Rectangle<int>* const r = active.getUnchecked (i);
+
+                if (r->getBottom() > y)
+                    active.setUnchecked (numLeft++, r);
+            }
+
+            active.removeRange (numLeft, active.size() - numLeft);
+
+            while (nextIndex < numRects && rects[nextIndex].getY() <= y)
+            {
+                const Rectangle<int>* const r = rects + nextIndex++;
+
+                if (r->getWidth() > 0 && r->getBottom() > y)
+                {
+                    int insertIndex = active.size();
+
+                    while (insertIndex > 0 && active.getUnchecked (insertIndex - 1)->getX() > r->getX())
+                        --insertIndex;
+
+                    active.insert (insertIndex, r);
+                }
+            }
+        }
+
+        bool isActive() const noexcept      { return active.size() > 0; }
+        bool isFinished() const noexcept    { return nextIndex >= numRects && active.size() == 0; }
+
+        // Returns the next y position at which a rectangle starts or ends.
+        int getNextEdge() const noexcept
+        {
+            int y = nextIndex < numRects ? rects[nextIndex].getY() : std::numeric_limits<int>::max();
+
+            for (int i = active.size(); --i >= 0;)
+            {
+                const Rectangle<int>* const r = active.getUnchecked (i);
+                y = jmin (y, r->getBottom());
+            }
+
+            return y;
+        }
+
+        // Writes the horizontal spans covered by the active rectangles as sorted,
+        // non-touching pairs of x1, x2 positions.
+        void getSpans (Array<int>& spans) const
+        {
+            spans.clearQuick();
+
+            for (int i = 0; i < active.size(); ++i)
+            {
+                const Rectangle<int>* const r = active.getUnchecked (i);
+                const int x2 = r->getRight();
+
+                if (spans.size() > 0 && r->getX() <= spans.getLast())
+                {
+                    if (x2 > spans.getLast())
+                        spans.setUnchecked (spans.size() - 1, x2);
+                }
+                else
+                {
+                    spans.add (r->getX());
+                    spans.add (x2);
+                }
+            }
+        }
+
+    private:
+        struct TopEdgeComparator
+        {
+            static int compareElements (const Rectangle<int>& r1, const Rectangle<int>& r2) noexcept
+            {
+                return r1.getY() < r2.getY() ? -1 : (r1.getY() > r2.getY() ? 1 : 0);
+            }
+        };
+
+        const Rectangle<int>* rects;
+        const int numRects;
+        int nextIndex;
+        Array<Rectangle<int> > sortedCopy;
+        Array<const Rectangle<int>*> active;
+
+        JUCE_DECLARE_NON_COPYABLE (BandScanner)
+    };
+
+    static void combineSpans (const Array<int>& a, const Array<int>& b, const Operation op, Array<int>& result)
+    {
+        result.clearQuick();
+
+        const int numA = a.size(), numB = b.size();
+        int indexA = 0, indexB = 0;
+        bool insideA = false, insideB = false, wasInside = false;
+
+        while (indexA < numA || indexB < numB)
+        {
+            const int xa = indexA < numA ? a.getUnchecked (indexA) : std::numeric_limits<int>::max();
+            const int xb = indexB < numB ? b.getUnchecked (indexB) : std::numeric_limits<int>::max();
+            const int x = jmin (xa, xb);
+
+            if (xa == x)  { insideA = ! insideA; ++indexA; }
+            if (xb == x)  { insideB = ! insideB; ++indexB; }
+
+            const bool inside = op == unionOp ? (insideA || insideB)
+                                              : (op == intersectionOp ? (insideA && insideB)
+                                                                      : (insideA && ! insideB));
+            if (inside != wasInside)
+            {
+                result.add (x);
+                wasInside = inside;
+            }
+        }
+    }
+
+    static void addBand (Array<Rectangle<int> >& result, int& lastBandStart,
+                         const int y1, const int y2, const Array<int>& spans)
+    {
+        const int numInLastBand = result.size() - lastBandStart;
+
+        // if the band above ends here and has the same horizontal spans, just extend it downwards
+        if (numInLastBand == spans.size() / 2 && numInLastBand > 0)
+        {
+            const Rectangle<int>* const last = result.getRawDataPointer() + lastBandStart;
+
+            if (last->getBottom() == y1)
+            {
+                bool identical = true;
+
+                for (int i = 0; i < numInLastBand; ++i)
+                {
+                    if (last[i].getX() != spans.getUnchecked (i * 2)
+                         || last[i].getRight() != spans.getUnchecked (i * 2 + 1))
+                    {
+                        identical = false;
+                        break;
+                    }
+                }
+
+                if (identical)
+                {
+                    for (int i = lastBandStart; i < result.size(); ++i)
+                        result.getReference (i).setBottom (y2);
+
+                    return;
+                }
+            }
+        }
+
+        lastBandStart = result.size();
+
+        for (int i = 0; i < spans.size(); i += 2)
+            result.add (Rectangle<int> (spans.getUnchecked (i), y1,
+                                        spans.getUnchecked (i + 1) - spans.getUnchecked (i), y2 - y1));
+    }
+
+    /*  Combines two sets of rectangles, producing a list of non-overlapping rectangles sorted
+        into horizontal bands. Each band is a run of rectangles with the same top and bottom,
+        sorted left-to-right, and vertically adjacent bands with identical spans are merged.
+
+        Because both inputs are swept from top to bottom together, the time taken is
+        proportional to the number of rectangles in the inputs and the result, rather than
+        the product of the input sizes.
+    */
+    static void combine (const Rectangle<int>* const a, const int numA,
+                         const Rectangle<int>* const b, const int numB,
+                         const Operation op, Array<Rectangle<int> >& result)
+    {
+        result.clearQuick();
+
+        BandScanner scannerA (a, numA), scannerB (b, numB);
+        Array<int> spansA, spansB, spans;
+        int lastBandStart = 0;
+        int y = jmin (scannerA.getNextEdge(), scannerB.getNextEdge());
+
+        while (y != std::numeric_limits<int>::max())
+        {
+            scannerA.advanceTo (y);
+            scannerB.advanceTo (y);
+
+            if (op != unionOp)
+            {
+                if (scannerA.isFinished() || (op == intersectionOp && scannerB.isFinished()))
+                    break;
+
+                // skip straight over any gaps where there can't be any output..
+                if (! scannerA.isActive())
+                {
+                    y = scannerA.getNextEdge();
+                    continue;
+                }
+
+                if (op == intersectionOp && ! scannerB.isActive())
+                {
+                    y = scannerB.getNextEdge();
+                    continue;
+                }
+            }
+
+            const int nextY = jmin (scannerA.getNextEdge(), scannerB.getNextEdge());
+
+            if (scannerA.isActive() || scannerB.isActive())
+            {
+                scannerA.getSpans (spansA);
+                scannerB.getSpans (spansB);
+                combineSpans (spansA, spansB, op, spans);
+
+                if (spans.size() > 0)
+                    addBand (result, lastBandStart, y, nextY, spans);
+            }
+
+            y = nextY;
+        }
+    }
+
+    static void combine (Array<Rectangle<int> >& rects, const Rectangle<int>* const other,
+                         const int numOther, const Operation op)
+    {
+        Array<Rectangle<int> > result;
+        combine (rects.getRawDataPointer(), rects.size(), other, numOther, op, result);
+        rects.swapWithArray (result);
+    }
+}
+
+//==============================================================================
 RectangleList::RectangleList() noexcept
 {
 }
@@ -109,50 +371,9 @@ void RectangleList::add (const Rectangle<int>& rect)
     if (! rect.isEmpty())
     {
         if (rects.size() == 0)
-        {
             rects.add (rect);
-        }
         else
-        {
-            bool anyOverlaps = false;
-
-            for (int j = rects.size(); --j >= 0;)
-            {
-                Rectangle<int>& ourRect = rects.getReference (j);
-
-                if (rect.intersects (ourRect))
-                {
-                    if (rect.contains (ourRect))
-                        rects.remove (j);
-                    else if (! ourRect.reduceIfPartlyContainedIn (rect))
-                        anyOverlaps = true;
-                }
-            }
-
-            if (anyOverlaps && rects.size() > 0)
-            {
-                RectangleList r (rect);
-
-                for (int i = rects.size(); --i >= 0;)
-                {
-                    const Rectangle<int>& ourRect = rects.getReference (i);
-
-                    if (rect.intersects (ourRect))
-                    {
-                        r.subtract (ourRect);
-
-                        if (r.rects.size() == 0)
-                            return;
-                    }
-                }
-
-                rects.addArray (r.rects);
-            }
-            else
-            {
-                rects.add (rect);
-            }
-        }
+            RectangleListHelpers::combine (rects, &rect, 1, RectangleListHelpers::unionOp);
     }
 }
 
@@ -169,97 +390,20 @@ void RectangleList::add (const int x, const int y, const int w, const int h)
 
 void RectangleList::add (const RectangleList& other)
 {
-    for (const Rectangle<int>* r = other.begin(), * const e = other.end(); r != e; ++r)
-        add (*r);
+    if (other.rects.size() > 0)
+        RectangleListHelpers::combine (rects, other.rects.begin(), other.rects.size(), RectangleListHelpers::unionOp);
 }
 
 void RectangleList::subtract (const Rectangle<int>& rect)
 {
-    const int originalNumRects = rects.size();
-
-    if (originalNumRects > 0)
-    {
-        const int x1 = rect.pos.x;
-        const int y1 = rect.pos.y;
-        const int x2 = x1 + rect.w;
-        const int y2 = y1 + rect.h;
-
-        for (int i = getNumRectangles(); --i >= 0;)
-        {
-            Rectangle<int>& r = rects.getReference (i);
-
-            const int rx1 = r.pos.x;
-            const int ry1 = r.pos.y;
-            const int rx2 = rx1 + r.w;
-            const int ry2 = ry1 + r.h;
-
-            if (! (x2 <= rx1 || x1 >= rx2 || y2 <= ry1 || y1 >= ry2))
-            {
-                if (x1 > rx1 && x1 < rx2)
-                {
-                    if (y1 <= ry1 && y2 >= ry2 && x2 >= rx2)
-                    {
-                        r.w = x1 - rx1;
-                    }
-                    else
-                    {
-                        r.pos.x = x1;
-                        r.w = rx2 - x1;
-
-                        rects.insert (++i, Rectangle<int> (rx1, ry1, x1 - rx1,  ry2 - ry1));
-                        ++i;
-                    }
-                }
-                else if (x2 > rx1 && x2 < rx2)
-                {
-                    r.pos.x = x2;
-                    r.w = rx2 - x2;
-
-                    if (y1 > ry1 || y2 < ry2 || x1 > rx1)
-                    {
-                        rects.insert (++i, Rectangle<int> (rx1, ry1, x2 - rx1,  ry2 - ry1));
-                        ++i;
-                    }
-                }
-                else if (y1 > ry1 && y1 < ry2)
-                {
-                    if (x1 <= rx1 && x2 >= rx2 && y2 >= ry2)
-                    {
-                        r.h = y1 - ry1;
-                    }
-                    else
-                    {
-                        r.pos.y = y1;
-                        r.h = ry2 - y1;
-
-                        rects.insert (++i, Rectangle<int> (rx1, ry1, rx2 - rx1, y1 - ry1));
-                        ++i;
-                    }
-                }
-                else if (y2 > ry1 && y2 < ry2)
-                {
-                    r.pos.y = y2;
-                    r.h = ry2 - y2;
-
-                    if (x1 > rx1 || x2 < rx2 || y1 > ry1)
-                    {
-                        rects.insert (++i, Rectangle<int> (rx1, ry1, rx2 - rx1, y2 - ry1));
-                        ++i;
-                    }
-                }
-                else
-                {
-                    rects.remove (i);
-                }
-            }
-        }
-    }
+    if (rects.size() > 0 && ! rect.isEmpty())
+        RectangleListHelpers::combine (rects, &rect, 1, RectangleListHelpers::differenceOp);
 }
 
 bool RectangleList::subtract (const RectangleList& otherList)
 {
-    for (int i = otherList.rects.size(); --i >= 0 && rects.size() > 0;)
-        subtract (otherList.rects.getReference (i));
+    if (rects.size() > 0 && otherList.rects.size() > 0)
+        RectangleListHelpers::combine (rects, otherList.rects.begin(), otherList.rects.size(), RectangleListHelpers::differenceOp);
 
     return rects.size() > 0;
 }
@@ -293,24 +437,8 @@ bool RectangleList::clipTo (const RectangleList& other)
     if (rects.size() == 0)
         return false;
 
-    RectangleList result;
-
-    for (int j = 0; j < rects.size(); ++j)
-    {
-        const Rectangle<int>& rect = rects.getReference (j);
-
-        for (int i = other.rects.size(); --i >= 0;)
-        {
-            Rectangle<int> r (other.rects.getReference (i));
-
-            if (rect.intersectRectangle (r.pos.x, r.pos.y, r.w, r.h))
-                result.rects.add (r);
-        }
-    }
-
-    swapWith (result);
-
-    return ! isEmpty();
+    RectangleListHelpers::combine (rects, other.rects.begin(), other.rects.size(), RectangleListHelpers::intersectionOp);
+    return rects.size() > 0;
 }
 
 bool RectangleList::getIntersectionWith (const Rectangle<int>& rect, RectangleList& destRegion) const
@@ -340,73 +468,8 @@ void RectangleList::swapWith (RectangleList& otherList) noexcept
 //==============================================================================
 void RectangleList::consolidate()
 {
-    for (int i = 0; i < getNumRectangles() - 1; ++i)
-    {
-        Rectangle<int>& r = rects.getReference (i);
-        const int rx1 = r.pos.x;
-        const int ry1 = r.pos.y;
-        const int rx2 = rx1 + r.w;
-        const int ry2 = ry1 + r.h;
-
-        for (int j = rects.size(); --j > i;)
-        {
-            Rectangle<int>& r2 = rects.getReference (j);
-            const int jrx1 = r2.pos.x;
-            const int jry1 = r2.pos.y;
-            const int jrx2 = jrx1 + r2.w;
-            const int jry2 = jry1 + r2.h;
-
-            // if the vertical edges of any blocks are touching and their horizontals don't
-            // line up, split them horizontally..
-            if (jrx1 == rx2 || jrx2 == rx1)
-            {
-                if (jry1 > ry1 && jry1 < ry2)
-                {
-                    r.h = jry1 - ry1;
-                    rects.add (Rectangle<int> (rx1, jry1, rx2 - rx1, ry2 - jry1));
-                    i = -1;
-                    break;
-                }
-
-                if (jry2 > ry1 && jry2 < ry2)
-                {
-                    r.h = jry2 - ry1;
-                    rects.add (Rectangle<int> (rx1, jry2, rx2 - rx1, ry2 - jry2));
-                    i = -1;
-                    break;
-                }
-                else if (ry1 > jry1 && ry1 < jry2)
-                {
-                    r2.h = ry1 - jry1;
-                    rects.add (Rectangle<int> (jrx1, ry1, jrx2 - jrx1, jry2 - ry1));
-                    i = -1;
-                    break;
-                }
-                else if (ry2 > jry1 && ry2 < jry2)
-                {
-                    r2.h = ry2 - jry1;
-                    rects.add (Rectangle<int> (jrx1, ry2, jrx2 - jrx1, jry2 - ry2));
-                    i = -1;
-                    break;
-                }
-            }
-        }
-    }
-
-    for (int i = 0; i < rects.size() - 1; ++i)
-    {
-        Rectangle<int>& r = rects.getReference (i);
-
-        for (int j = rects.size(); --j > i;)
-        {
-            if (r.enlargeIfAdjacent (rects.getReference (j)))
-            {
-                rects.remove (j);
-                i = -1;
-                break;
-            }
-        }
-    }
+    if (rects.size() > 1)
+        RectangleListHelpers::combine (rects, nullptr, 0, RectangleListHelpers::unionOp);
 }
 
 //==============================================================================
@@ -423,15 +486,10 @@ bool RectangleList::containsRectangle (const Rectangle<int>& rectangleToCheck) c
 {
     if (rects.size() > 1)
     {
-        RectangleList r (rectangleToCheck);
-
-        for (int i = rects.size(); --i >= 0;)
-        {
-            r.subtract (rects.getReference (i));
-
-            if (r.rects.size() == 0)
-                return true;
-        }
+        Array<Rectangle<int> > remainder;
+        RectangleListHelpers::combine (&rectangleToCheck, 1, rects.begin(), rects.size(),
+                                       RectangleListHelpers::differenceOp, remainder);
+        return remainder.size() == 0;
     }
     else if (rects.size() > 0)
     {
@@ -491,6 +549,57 @@ Rectangle<int> RectangleList::getBounds() const noexcept
     }
 }
 
+void RectangleList::simplify (const int maxNumRectangles, const int extraAreaAllowed)
+{
+    jassert (maxNumRectangles > 0);
+
+    while (rects.size() > 1)
+    {
+        int best1 = 0, best2 = 0;
+        int64 bestExtraArea = std::numeric_limits<int64>::max();
+
+        for (int i = rects.size(); --i > 0;)
+        {
+            const Rectangle<int>& r1 = rects.getReference (i);
+            const int64 area1 = r1.w * (int64) r1.h;
+
+            for (int j = i; --j >= 0;)
+            {
+                const Rectangle<int>& r2 = rects.getReference (j);
+                const Rectangle<int> merged (r1.getUnion (r2));
+                const int64 extraArea = merged.w * (int64) merged.h - area1 - r2.w * (int64) r2.h;
+
+                if (extraArea < bestExtraArea)
+                {
+                    bestExtraArea = extraArea;
+                    best1 = i;
+                    best2 = j;
+                }
+            }
+        }
+
+        if (bestExtraArea > extraAreaAllowed && rects.size() <= maxNumRectangles)
+            break;
+
+        Rectangle<int> merged (rects.getReference (best1).getUnion (rects.getReference (best2)));
+        rects.remove (best1);
+        rects.remove (best2);
+
+        // the bounding box may overlap other rectangles, which then get absorbed into it
+        for (int i = rects.size(); --i >= 0;)
+        {
+            if (rects.getReference (i).intersects (merged))
+            {
+                merged = merged.getUnion (rects.getReference (i));
+                rects.remove (i);
+                i = rects.size();
+            }
+        }
+
+        rects.add (merged);
+    }
+}
+
 void RectangleList::offsetAll (const int dx, const int dy) noexcept
 {
     for (Rectangle<int>* r = rects.begin(), * const e = rects.end(); r != e; ++r)
@@ -510,3 +619,155 @@ Path RectangleList::toPath() const
 
     return p;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class RectangleListTests  : public UnitTest
+{
+public:
+    RectangleListTests() : UnitTest ("RectangleList") {}
+
+    static int64 getArea (const RectangleList& list)
+    {
+        int64 total = 0;
+
+        for (const Rectangle<int>* r = list.begin(), * const e = list.end(); r != e; ++r)
+            total += r->getWidth() * (int64) r->getHeight();
+
+        return total;
+    }
+
+    static RectangleList createRandomList (Random& r, const int numRects)
+    {
+        RectangleList list;
+
+        for (int i = 0; i < numRects; ++i)
+            list.addWithoutMerging (Rectangle<int> (r.nextInt (40), r.nextInt (40), 1 + r.nextInt (24), 1 + r.nextInt (24)));
+
+        return list;
+    }
+
+    static bool isCoveredBy (const RectangleList& list, const int x, const int y)
+    {
+        for (const Rectangle<int>* r = list.begin(), * const e = list.end(); r != e; ++r)
+            if (r->contains (x, y))
+                return true;
+
+        return false;
+    }
+
+    void expectBanded (const RectangleList& list)
+    {
+        for (int i = 1; i < list.getNumRectangles(); ++i)
+        {
+            const Rectangle<int> r1 (list.getRectangle (i - 1)), r2 (list.getRectangle (i));
+
+            expect (r1.getY() < r2.getY() || (r1.getY() == r2.getY() && r1.getRight() < r2.getX()));
+            expect (r1.getY() == r2.getY() ? r1.getBottom() == r2.getBottom() : r1.getBottom() <= r2.getY());
+        }
+    }
+
+    void expectRegion (const RectangleList& result, const RectangleList& a, const RectangleList& b, const int op)
+    {
+        expectBanded (result);
+
+        for (int y = 0; y < 64; ++y)
+        {
+            for (int x = 0; x < 64; ++x)
+            {
+                const bool inA = isCoveredBy (a, x, y), inB = isCoveredBy (b, x, y);
+                const bool shouldBeIn = op == 0 ? (inA || inB) : (op == 1 ? (inA && inB) : (inA && ! inB));
+
+                if (result.containsPoint (x, y) != shouldBeIn)
+                {
+                    expect (false, "wrong result at " + String (x) + ", " + String (y));
+                    return;
+                }
+            }
+        }
+    }
+
+    void runTest()
+    {
+        beginTest ("Combining regions");
+
+        {
+            Random r;
+
+            for (int i = 0; i < 50; ++i)
+            {
+                const RectangleList a (createRandomList (r, 1 + r.nextInt (12)));
+                const RectangleList b (createRandomList (r, 1 + r.nextInt (12)));
+
+                RectangleList sum (a), intersection (a), difference (a), consolidated (a);
+                sum.add (b);
+                intersection.clipTo (b);
+                difference.subtract (b);
+                consolidated.consolidate();
+
+                expectRegion (sum, a, b, 0);
+                expectRegion (intersection, a, b, 1);
+                expectRegion (difference, a, b, 2);
+                expectRegion (consolidated, a, RectangleList(), 0);
+
+                for (const Rectangle<int>* rect = b.begin(), * const e = b.end(); rect != e; ++rect)
+                {
+                    expect (sum.containsRectangle (*rect));
+                    expect (difference.containsRectangle (*rect) == rect->isEmpty());
+                }
+            }
+
+            // bands with the same spans get merged vertically
+            RectangleList list;
+            list.add (Rectangle<int> (0, 0, 10, 10));
+            list.add (Rectangle<int> (0, 10, 10, 10));
+            list.add (Rectangle<int> (20, 0, 10, 20));
+
+            expectEquals (list.getNumRectangles(), 2);
+            expect (list.getRectangle (0) == Rectangle<int> (0, 0, 10, 20));
+            expect (list.getRectangle (1) == Rectangle<int> (20, 0, 10, 20));
+        }
+
+        beginTest ("Simplify");
+
+        {
+            RectangleList list;
+
+            for (int i = 0; i < 100; ++i)
+                list.add (Rectangle<int> (i * 12, (i % 7) * 30, 10, 10));
+
+            const RectangleList original (list);
+            list.simplify (8, 0);
+
+            expect (list.getNumRectangles() <= 8);
+            expect (list.getBounds() == original.getBounds());
+
+            for (const Rectangle<int>* r = original.begin(), * const e = original.end(); r != e; ++r)
+                expect (list.containsRectangle (*r));
+
+            // the merged rectangles mustn't overlap each other
+            for (int i = 0; i < list.getNumRectangles(); ++i)
+                for (int j = i + 1; j < list.getNumRectangles(); ++j)
+                    expect (! list.getRectangle (i).intersects (list.getRectangle (j)));
+        }
+
+        {
+            // nearby rectangles get merged when it's cheap, distant ones don't
+            RectangleList list;
+            list.add (Rectangle<int> (0, 0, 10, 10));
+            list.add (Rectangle<int> (11, 0, 10, 10));
+            list.add (Rectangle<int> (500, 500, 10, 10));
+
+            list.simplify (16, 20);
+
+            expectEquals (list.getNumRectangles(), 2);
+            expect (list.containsRectangle (Rectangle<int> (0, 0, 21, 10)));
+            expectEquals (getArea (list), (int64) (210 + 100));
+        }
+    }
+};
+
+static RectangleListTests rectangleListTests;
+
+#endif
@@ -38,6 +38,13 @@
     add and remove rectangular sections of it, and simplify overlapping or
     adjacent rectangles.
 
+    The operations that combine regions (add, subtract, clipTo and consolidate) leave
+    the list in a banded form: its rectangles don't overlap, and are sorted into
+    horizontal bands of rectangles that share the same top and bottom, ordered from
+    top to bottom and then left to right. Keeping them in this order lets two regions
+    be combined in a single pass over both lists, so the time taken grows linearly
+    with the number of rectangles instead of with the product of the two list sizes.
+
     @see Rectangle
 */
 class JUCE_API  RectangleList
@@ -94,14 +101,16 @@ public:
 
         The rectangle being added will first be clipped to remove any parts of it
         that overlap existing rectangles in the list, and adjacent rectangles will be
-        merged into it.
+        merged into it. The rectangles in the list may be split or re-ordered to keep
+        them in banded order.
     */
     void add (const Rectangle<int>& rect);
 
     /** Dumbly adds a rectangle to the list without checking for overlaps.
 
         This simply adds the rectangle to the end, it doesn't merge it or remove
-        any overlapping bits.
+        any overlapping bits. The next operation that combines the list with another
+        region will sort things out again.
     */
     void addWithoutMerging (const Rectangle<int>& rect);
 
@@ -205,10 +214,22 @@ public:
 
         This will try to combine any adjacent rectangles into larger ones where
         possible, to simplify lists that might have been fragmented by repeated
-        add/subtract calls.
+        add/subtract calls, removing any overlaps and leaving it in banded order.
     */
     void consolidate();
 
+    /** Reduces the number of rectangles by merging some of them into their bounding boxes.
+
+        Unlike consolidate(), this can make the region bigger, so it's intended for things
+        like repaint regions, where drawing a few extra pixels costs less than handling
+        lots of small rectangles separately.
+
+        Any two rectangles whose bounding box covers no more than extraAreaAllowed pixels
+        beyond the rectangles themselves are merged. After that, the pairs that add the
+        least area are merged until no more than maxNumRectangles are left.
+    */
+    void simplify (int maxNumRectangles, int extraAreaAllowed);
+
     /** Adds an x and y value to all the co-ordinates. */
     void offsetAll (int dx, int dy) noexcept;
 
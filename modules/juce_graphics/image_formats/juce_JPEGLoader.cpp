@@ -237,107 +237,168 @@ bool JPEGImageFormat::canUnderstand (InputStream& in)
 
 #if JUCE_USING_COREIMAGE_LOADER
  Image juce_loadWithCoreImage (InputStream& input);
-#endif
-
-Image JPEGImageFormat::decodeImage (InputStream& in)
-{
-#if JUCE_USING_COREIMAGE_LOADER
-    return juce_loadWithCoreImage (in);
 #else
-    using namespace jpeglibNamespace;
-    using namespace JPEGHelpers;
+namespace JPEGHelpers
+{
+    /*  libjpeg can do most of the work of shrinking an image while decoding it, by using
+        fewer of the DCT coefficients, so this picks the smallest of its 1/2, 1/4 and 1/8
+        scales that's still at least as big as the size needed. A preview always uses the
+        1/8 scale, and isn't worth making if the image itself would be decoded at that scale.
+    */
+    // (this rounds up, in the same way as libjpeg)
+    static int getScaledSize (const unsigned int size, const unsigned int scaleDenominator) noexcept
+    {
+        return (int) ((size + scaleDenominator - 1) / scaleDenominator);
+    }
 
-    MemoryOutputStream mb;
-    mb << in;
+    static Image decode (InputStream& in, const int maxWidth, const int maxHeight, const bool previewOnly)
+    {
+        using namespace jpeglibNamespace;
 
-    Image image;
+        MemoryOutputStream mb;
+        mb << in;
 
-    if (mb.getDataSize() > 16)
-    {
-        struct jpeg_decompress_struct jpegDecompStruct;
+        Image image;
 
-        struct jpeg_error_mgr jerr;
-        setupSilentErrorHandler (jerr);
-        jpegDecompStruct.err = &jerr;
+        if (mb.getDataSize() > 16)
+        {
+            struct jpeg_decompress_struct jpegDecompStruct;
 
-        jpeg_create_decompress (&jpegDecompStruct);
+            struct jpeg_error_mgr jerr;
+            setupSilentErrorHandler (jerr);
+            jpegDecompStruct.err = &jerr;
 
-        jpegDecompStruct.src = (jpeg_source_mgr*)(jpegDecompStruct.mem->alloc_small)
-            ((j_common_ptr)(&jpegDecompStruct), JPOOL_PERMANENT, sizeof (jpeg_source_mgr));
+            jpeg_create_decompress (&jpegDecompStruct);
 
-        jpegDecompStruct.src->init_source       = dummyCallback1;
-        jpegDecompStruct.src->fill_input_buffer = jpegFill;
-        jpegDecompStruct.src->skip_input_data   = jpegSkip;
-        jpegDecompStruct.src->resync_to_restart = jpeg_resync_to_restart;
-        jpegDecompStruct.src->term_source       = dummyCallback1;
+            jpegDecompStruct.src = (jpeg_source_mgr*)(jpegDecompStruct.mem->alloc_small)
+                ((j_common_ptr)(&jpegDecompStruct), JPOOL_PERMANENT, sizeof (jpeg_source_mgr));
 
-        jpegDecompStruct.src->next_input_byte   = static_cast <const unsigned char*> (mb.getData());
-        jpegDecompStruct.src->bytes_in_buffer   = mb.getDataSize();
+            jpegDecompStruct.src->init_source       = dummyCallback1;
+            jpegDecompStruct.src->fill_input_buffer = jpegFill;
+            jpegDecompStruct.src->skip_input_data   = jpegSkip;
+            jpegDecompStruct.src->resync_to_restart = jpeg_resync_to_restart;
+            jpegDecompStruct.src->term_source       = dummyCallback1;
 
-        try
-        {
-            jpeg_read_header (&jpegDecompStruct, TRUE);
+            jpegDecompStruct.src->next_input_byte   = static_cast <const unsigned char*> (mb.getData());
+            jpegDecompStruct.src->bytes_in_buffer   = mb.getDataSize();
 
-            jpeg_calc_output_dimensions (&jpegDecompStruct);
+            try
+            {
+                jpeg_read_header (&jpegDecompStruct, TRUE);
 
-            const int width  = (int) jpegDecompStruct.output_width;
-            const int height = (int) jpegDecompStruct.output_height;
+                const Rectangle<int> sizeNeeded (ImageRescalingHelpers::getSizeToFit ((int) jpegDecompStruct.image_width,
+                                                                                      (int) jpegDecompStruct.image_height,
+                                                                                      maxWidth, maxHeight));
+                unsigned int scaleDenominator = 1;
 
-            jpegDecompStruct.out_color_space = JCS_RGB;
+                while (scaleDenominator < 8
+                        && getScaledSize (jpegDecompStruct.image_width,  scaleDenominator * 2) >= sizeNeeded.getWidth()
+                        && getScaledSize (jpegDecompStruct.image_height, scaleDenominator * 2) >= sizeNeeded.getHeight())
+                    scaleDenominator *= 2;
 
-            JSAMPARRAY buffer
-                = (*jpegDecompStruct.mem->alloc_sarray) ((j_common_ptr) &jpegDecompStruct,
-                                                         JPOOL_IMAGE,
-                                                         (JDIMENSION) width * 3, 1);
+                if (previewOnly)
+                {
+                    if (scaleDenominator == 8)
+                    {
+                        jpeg_destroy_decompress (&jpegDecompStruct);
+                        return Image::null;
+                    }
 
-            if (jpeg_start_decompress (&jpegDecompStruct))
-            {
-                image = Image (Image::RGB, width, height, false);
-                image.getProperties()->set ("originalImageHadAlpha", false);
-                const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
+                    scaleDenominator = 8;
+                }
+
+                jpegDecompStruct.scale_num = 1;
+                jpegDecompStruct.scale_denom = scaleDenominator;
+                jpeg_calc_output_dimensions (&jpegDecompStruct);
+
+                const int width  = (int) jpegDecompStruct.output_width;
+                const int height = (int) jpegDecompStruct.output_height;
 
-                const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+                jpegDecompStruct.out_color_space = JCS_RGB;
 
-                for (int y = 0; y < height; ++y)
+                JSAMPARRAY buffer
+                    = (*jpegDecompStruct.mem->alloc_sarray) ((j_common_ptr) &jpegDecompStruct,
+                                                             JPOOL_IMAGE,
+                                                             (JDIMENSION) width * 3, 1);
+
+                if (jpeg_start_decompress (&jpegDecompStruct))
                 {
-                    jpeg_read_scanlines (&jpegDecompStruct, buffer, 1);
+                    image = Image (Image::RGB, width, height, false);
+                    image.getProperties()->set ("originalImageHadAlpha", false);
+                    const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
 
-                    const uint8* src = *buffer;
-                    uint8* dest = destData.getLinePointer (y);
+                    const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
 
-                    if (hasAlphaChan)
+                    for (int y = 0; y < height; ++y)
                     {
-                        for (int i = width; --i >= 0;)
+                        jpeg_read_scanlines (&jpegDecompStruct, buffer, 1);
+
+                        const uint8* src = *buffer;
+                        uint8* dest = destData.getLinePointer (y);
+
+                        if (hasAlphaChan)
                         {
-                            ((PixelARGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
-                            ((PixelARGB*) dest)->premultiply();
-                            dest += destData.pixelStride;
-                            src += 3;
+                            for (int i = width; --i >= 0;)
+                            {
+                                ((PixelARGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
+                                ((PixelARGB*) dest)->premultiply();
+                                dest += destData.pixelStride;
+                                src += 3;
+                            }
                         }
-                    }
-                    else
-                    {
-                        for (int i = width; --i >= 0;)
+                        else
                         {
-                            ((PixelRGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
-                            dest += destData.pixelStride;
-                            src += 3;
+                            for (int i = width; --i >= 0;)
+                            {
+                                ((PixelRGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
+                                dest += destData.pixelStride;
+                                src += 3;
+                            }
                         }
                     }
-                }
 
-                jpeg_finish_decompress (&jpegDecompStruct);
+                    jpeg_finish_decompress (&jpegDecompStruct);
 
-                in.setPosition (((char*) jpegDecompStruct.src->next_input_byte) - (char*) mb.getData());
-            }
+                    in.setPosition (((char*) jpegDecompStruct.src->next_input_byte) - (char*) mb.getData());
+                }
 
-            jpeg_destroy_decompress (&jpegDecompStruct);
+                jpeg_destroy_decompress (&jpegDecompStruct);
+            }
+            catch (...)
+            {}
         }
-        catch (...)
-        {}
+
+        return image;
     }
+}
+#endif
+
+Image JPEGImageFormat::decodeImage (InputStream& in)
+{
+#if JUCE_USING_COREIMAGE_LOADER
+    return juce_loadWithCoreImage (in);
+#else
+    return JPEGHelpers::decode (in, 0, 0, false);
+#endif
+}
 
-    return image;
+Image JPEGImageFormat::decodeImageToFit (InputStream& in, const int maxWidth, const int maxHeight)
+{
+#if JUCE_USING_COREIMAGE_LOADER
+    return ImageFileFormat::decodeImageToFit (in, maxWidth, maxHeight);
+#else
+    return ImageRescalingHelpers::rescaledToFit (JPEGHelpers::decode (in, maxWidth, maxHeight, false),
+                                                 maxWidth, maxHeight);
+#endif
+}
+
+Image JPEGImageFormat::decodePreview (InputStream& in, const int maxWidth, const int maxHeight)
+{
+#if JUCE_USING_COREIMAGE_LOADER
+    return ImageFileFormat::decodePreview (in, maxWidth, maxHeight);
+#else
+    return ImageRescalingHelpers::rescaledToFit (JPEGHelpers::decode (in, maxWidth, maxHeight, true),
+                                                 maxWidth, maxHeight);
 #endif
 }
 
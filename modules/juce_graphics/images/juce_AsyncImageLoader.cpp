@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+struct AsyncImageLoader::Result
+{
+    Result (Listener* const listener_, const File& file_, const Image& image_,
+            const int64 hashCode_, const bool isPreview_)
+        : listener (listener_), file (file_), image (image_),
+          hashCode (hashCode_), isPreview (isPreview_)
+    {
+    }
+
+    Listener* const listener;
+    const File file;
+    const Image image;
+    const int64 hashCode;
+    const bool isPreview;
+
+    JUCE_DECLARE_NON_COPYABLE (Result)
+};
+
+//==============================================================================
+class AsyncImageLoader::LoadJob  : public ThreadPoolJob
+{
+public:
+    LoadJob (AsyncImageLoader& owner_, Listener* const listener_, const File& file_,
+             const int maxWidth_, const int maxHeight_, const int64 hashCode_, const bool makePreview_)
+        : ThreadPoolJob ("Image loader"),
+          listener (listener_), owner (owner_), file (file_),
+          maxWidth (maxWidth_), maxHeight (maxHeight_),
+          hashCode (hashCode_), makePreview (makePreview_)
+    {
+    }
+
+    JobStatus runJob()
+    {
+        Image image;
+        MemoryBlock data;
+
+        if (file.loadFileAsData (data))
+        {
+            MemoryInputStream stream (data, false);
+            ImageFileFormat* const format = ImageFileFormat::findImageFormatForStream (stream);
+
+            if (format != nullptr)
+            {
+                if (makePreview)
+                {
+                    const Image preview (format->decodePreview (stream, maxWidth, maxHeight));
+                    stream.setPosition (0);
+
+                    if (preview.isValid() && ! shouldExit())
+                        owner.addResult (listener, file, preview, hashCode, true);
+                }
+
+                if (! shouldExit())
+                    image = format->decodeImageToFit (stream, maxWidth, maxHeight);
+            }
+        }
+
+        if (! shouldExit())
+            owner.addResult (listener, file, image, hashCode, false);
+
+        return jobHasFinished;
+    }
+
+    struct ListenerSelector  : public ThreadPool::JobSelector
+    {
+        ListenerSelector (Listener* const listener_) noexcept  : listener (listener_) {}
+
+        bool isJobSuitable (ThreadPoolJob* job)
+        {
+            return static_cast <LoadJob*> (job)->listener == listener;
+        }
+
+        Listener* const listener;
+    };
+
+    Listener* const listener;
+
+private:
+    AsyncImageLoader& owner;
+    const File file;
+    const int maxWidth, maxHeight;
+    const int64 hashCode;
+    const bool makePreview;
+
+    JUCE_DECLARE_NON_COPYABLE (LoadJob)
+};
+
+//==============================================================================
+void AsyncImageLoader::Listener::imagePreviewLoaded (const File&, const Image&) {}
+
+AsyncImageLoader::AsyncImageLoader (const int numThreads)
+    : pool (jmax (1, numThreads)),
+      previewsEnabled (false)
+{
+    DefaultImageFormats::get(); // (the shared formats need to be created before any of the threads try to use them)
+}
+
+AsyncImageLoader::~AsyncImageLoader()
+{
+    cancelAllRequests();
+}
+
+Image AsyncImageLoader::loadImage (const File& file, Listener* const listener,
+                                   const int maxWidth, const int maxHeight)
+{
+    jassert (listener != nullptr);
+
+    const int64 hashCode = ImageCache::getHashCodeFor (file, maxWidth, maxHeight);
+    const Image cachedImage (ImageCache::getFromHashCode (hashCode));
+
+    if (cachedImage.isNull())
+        pool.addJob (new LoadJob (*this, listener, file, maxWidth, maxHeight, hashCode, previewsEnabled), true);
+
+    return cachedImage;
+}
+
+void AsyncImageLoader::cancelRequests (Listener* const listener)
+{
+    LoadJob::ListenerSelector selector (listener);
+    pool.removeAllJobs (true, -1, &selector);
+    removeResults (listener);
+}
+
+void AsyncImageLoader::cancelAllRequests()
+{
+    pool.removeAllJobs (true, -1);
+    removeResults (nullptr);
+    cancelPendingUpdate();
+}
+
+int AsyncImageLoader::getNumPendingRequests() const
+{
+    int num = pool.getNumJobs();
+
+    const ScopedLock sl (lock);
+
+    for (int i = results.size(); --i >= 0;)
+        if (! results.getUnchecked(i)->isPreview)
+            ++num;
+
+    return num;
+}
+
+void AsyncImageLoader::setPreviewsEnabled (const bool shouldMakePreviews) noexcept
+{
+    previewsEnabled = shouldMakePreviews;
+}
+
+void AsyncImageLoader::addResult (Listener* const listener, const File& file, const Image& image,
+                                  const int64 hashCode, const bool isPreview)
+{
+    {
+        const ScopedLock sl (lock);
+        results.add (new Result (listener, file, image, hashCode, isPreview));
+    }
+
+    triggerAsyncUpdate();
+}
+
+void AsyncImageLoader::removeResults (Listener* const listener)
+{
+    const ScopedLock sl (lock);
+
+    for (int i = results.size(); --i >= 0;)
+        if (listener == nullptr || results.getUnchecked(i)->listener == listener)
+            results.remove (i);
+}
+
+void AsyncImageLoader::handleAsyncUpdate()
+{
+    // The results are taken one at a time, because a callback may cancel other requests.
+    for (;;)
+    {
+        ScopedPointer<Result> result;
+
+        {
+            const ScopedLock sl (lock);
+
+            if (results.size() == 0)
+                break;
+
+            result = results.removeAndReturn (0);
+        }
+
+        if (result->isPreview)
+        {
+            result->listener->imagePreviewLoaded (result->file, result->image);
+        }
+        else
+        {
+            ImageCache::addImageToCache (result->image, result->hashCode);
+            result->listener->imageLoaded (result->file, result->image);
+        }
+    }
+}
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ASYNCIMAGELOADER_JUCEHEADER__
+#define __JUCE_ASYNCIMAGELOADER_JUCEHEADER__
+
+#include "juce_Image.h"
+
+
+//==============================================================================
+/**
+    Loads images on background threads, and passes them back on the message thread.
+
+    This is for things like file browsers that need to show a lot of images or
+    thumbnails without holding up the UI. Each request is decoded by one of the
+    loader's threads, shrunk to the size that was asked for, and added to the
+    ImageCache, so that asking for the same file at the same size again doesn't
+    need to load it. JPEGs are decoded directly at a lower resolution when they're
+    being shrunk, which is a lot quicker than decoding them at full size.
+
+    E.g.
+    @code
+    void ThumbnailComponent::showFile (const File& file)
+    {
+        thumbnail = loader.loadImage (file, this, getWidth(), getHeight());
+        repaint();
+    }
+
+    void ThumbnailComponent::imageLoaded (const File&, const Image& image)
+    {
+        thumbnail = image;
+        repaint();
+    }
+    @endcode
+
+    @see ImageCache, ImageFileFormat::decodeImageToFit
+*/
+class JUCE_API  AsyncImageLoader  : private AsyncUpdater
+{
+public:
+    //==============================================================================
+    /** Creates a loader that uses the given number of threads. */
+    explicit AsyncImageLoader (int numThreads = 2);
+
+    /** Destructor.
+        Any requests that haven't finished are abandoned.
+    */
+    ~AsyncImageLoader();
+
+    //==============================================================================
+    /** Receives the images that an AsyncImageLoader has loaded.
+
+        The callbacks are all made on the message thread.
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called when an image that was asked for has been loaded.
+            If the file couldn't be loaded, the image will be invalid.
+        */
+        virtual void imageLoaded (const File& file, const Image& image) = 0;
+
+        /** Called with a rough, low-resolution version of an image while it's still loading.
+
+            This only happens when previews have been turned on with setPreviewsEnabled(),
+            and only for formats which can make them quickly (such as JPEG). It'll always
+            be followed by a call to imageLoaded() for the same file.
+        */
+        virtual void imagePreviewLoaded (const File& file, const Image& preview);
+    };
+
+    //==============================================================================
+    /** Asks for an image to be loaded.
+
+        If the image is already in the ImageCache, it's returned straight away and the
+        listener won't be called. Otherwise, this returns an invalid image, and the image
+        will be passed to the listener's imageLoaded() method when it has been loaded.
+
+        If maxWidth and maxHeight are greater than zero, images that are larger than this
+        are shrunk (keeping their proportions) to fit.
+
+        This must be called on the message thread.
+    */
+    Image loadImage (const File& file, Listener* listener,
+                     int maxWidth = 0, int maxHeight = 0);
+
+    /** Abandons all the requests that were made by a listener.
+
+        Once this returns, the listener won't be called again for any of them, so it must
+        be called before deleting a listener that may still have requests outstanding.
+        This must be called on the message thread.
+    */
+    void cancelRequests (Listener* listener);
+
+    /** Abandons all the requests that haven't finished yet. */
+    void cancelAllRequests();
+
+    /** Returns the number of requests whose images haven't yet been passed back. */
+    int getNumPendingRequests() const;
+
+    /** Enables or disables the Listener::imagePreviewLoaded() callbacks.
+        These are turned off by default, because they make each image take a bit
+        longer to load.
+    */
+    void setPreviewsEnabled (bool shouldMakePreviews) noexcept;
+
+private:
+    //==============================================================================
+    class LoadJob;
+    friend class LoadJob;
+    struct Result;
+
+    ThreadPool pool;
+    OwnedArray<Result> results;
+    CriticalSection lock;
+    bool previewsEnabled;
+
+    void addResult (Listener*, const File&, const Image&, int64 hashCode, bool isPreview);
+    void removeResults (Listener*);
+    void handleAsyncUpdate();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncImageLoader)
+};
+
+
+#endif   // __JUCE_ASYNCIMAGELOADER_JUCEHEADER__
@@ -34,6 +34,16 @@ ImagePixelData::~ImagePixelData()
 {
 }
 
+void ImagePixelData::markAsChanged() noexcept
+{
+    ++changeCount;
+}
+
+int ImagePixelData::getChangeCount() const noexcept
+{
+    return changeCount.get();
+}
+
 //==============================================================================
 ImageType::ImageType() {}
 ImageType::~ImageType() {}
@@ -149,6 +159,10 @@ public:
         image->initialiseBitmapData (bitmap, x + area.getX(), y + area.getY(), mode);
     }
 
+    // The pixels belong to the parent image, so its changes are our changes, and vice-versa.
+    void markAsChanged() noexcept               { image->markAsChanged(); }
+    int getChangeCount() const noexcept         { return image->getChangeCount(); }
+
     ImagePixelData* clone()
     {
         jassert (getReferenceCount() > 0); // (This method can't be used on an unowned pointer, as it will end up self-deleting)
@@ -246,7 +260,11 @@ bool Image::hasAlphaChannel() const noexcept            { return getFormat() !=
 
 LowLevelGraphicsContext* Image::createLowLevelContext() const
 {
-    return image == nullptr ? nullptr : image->createLowLevelContext();
+    if (image == nullptr)
+        return nullptr;
+
+    image->markAsChanged();
+    return image->createLowLevelContext();
 }
 
 void Image::duplicateIfShared()
@@ -260,11 +278,148 @@ Image Image::createCopy() const
     return Image (image != nullptr ? image->clone() : nullptr);
 }
 
+//==============================================================================
+namespace ImageRescalingHelpers
+{
+    // Makes each destination pixel the average of the 2x2 block of source pixels that it
+    // covers (or 2x1 or 1x2, if only one dimension is being halved). When a dimension is
+    // odd, the last row or column just gets its single source line.
+    struct Halver
+    {
+        Halver (const Image::BitmapData& srcData_, const Image::BitmapData& destData_,
+                const bool halveWidth_, const bool halveHeight_) noexcept
+            : srcData (srcData_), destData (destData_),
+              halveWidth (halveWidth_), halveHeight (halveHeight_)
+        {
+        }
+
+        void operator() (const int startRow, const int endRow) const noexcept
+        {
+            const int numChannels = destData.pixelStride;
+
+            for (int y = startRow; y < endRow; ++y)
+            {
+                const int sy1 = halveHeight ? y * 2 : y;
+                const int sy2 = halveHeight ? jmin (sy1 + 1, srcData.height - 1) : sy1;
+                uint8* dest = destData.getLinePointer (y);
+                int x = 0;
+
+               #if JUCE_RENDERING_USE_SSE2
+                if (numChannels == 4 && halveWidth)
+                {
+                    // (this does a whole 2x2 block of 32-bit pixels at once)
+                    const uint8* src1 = srcData.getLinePointer (sy1);
+                    const uint8* src2 = srcData.getLinePointer (sy2);
+                    const __m128i zero = _mm_setzero_si128();
+                    const __m128i two = _mm_set1_epi16 (2);
+
+                    for (const int numWholeBlocks = srcData.width / 2; x < numWholeBlocks; ++x)
+                    {
+                        const __m128i sum = _mm_add_epi16 (_mm_unpacklo_epi8 (_mm_loadl_epi64 ((const __m128i*) src1), zero),
+                                                           _mm_unpacklo_epi8 (_mm_loadl_epi64 ((const __m128i*) src2), zero));
+                        const __m128i average = _mm_srli_epi16 (_mm_add_epi16 (_mm_add_epi16 (sum, _mm_srli_si128 (sum, 8)), two), 2);
+
+                        *(uint32*) dest = (uint32) _mm_cvtsi128_si32 (_mm_packus_epi16 (average, zero));
+                        dest += 4;
+                        src1 += 8;
+                        src2 += 8;
+                    }
+                }
+               #endif
+
+                for (; x < destData.width; ++x)
+                {
+                    const int sx1 = halveWidth ? x * 2 : x;
+                    const int sx2 = halveWidth ? jmin (sx1 + 1, srcData.width - 1) : sx1;
+
+                    const uint8* const a = srcData.getPixelPointer (sx1, sy1);
+                    const uint8* const b = srcData.getPixelPointer (sx2, sy1);
+                    const uint8* const c = srcData.getPixelPointer (sx1, sy2);
+                    const uint8* const d = srcData.getPixelPointer (sx2, sy2);
+
+                    for (int i = 0; i < numChannels; ++i)
+                        *dest++ = (uint8) ((a[i] + b[i] + c[i] + d[i] + 2) >> 2);
+                }
+            }
+        }
+
+        const Image::BitmapData& srcData;
+        const Image::BitmapData& destData;
+        const bool halveWidth, halveHeight;
+
+        JUCE_DECLARE_NON_COPYABLE (Halver)
+    };
+
+    static Image halve (const Image& image, ImageType& type, const bool halveWidth, const bool halveHeight)
+    {
+        Image newImage (type.create (image.getFormat(),
+                                     halveWidth  ? (image.getWidth()  + 1) / 2 : image.getWidth(),
+                                     halveHeight ? (image.getHeight() + 1) / 2 : image.getHeight(),
+                                     false));
+
+        const Image::BitmapData srcData (image, Image::BitmapData::readOnly);
+        const Image::BitmapData destData (newImage, Image::BitmapData::writeOnly);
+        Halver halver (srcData, destData, halveWidth, halveHeight);
+
+        if (destData.width * destData.height < 64 * 1024)
+            halver (0, destData.height);
+        else
+            parallelFor (*RenderingHelpers::RenderingThreadPool::getInstance(), 0, destData.height, halver, 16);
+
+        return newImage;
+    }
+
+    // Returns the size that an image needs to be shrunk to, to fit inside maxWidth x maxHeight.
+    static Rectangle<int> getSizeToFit (const int width, const int height, const int maxWidth, const int maxHeight) noexcept
+    {
+        if (maxWidth <= 0 || maxHeight <= 0 || (width <= maxWidth && height <= maxHeight))
+            return Rectangle<int> (width, height);
+
+        const double scale = jmin (maxWidth / (double) width, maxHeight / (double) height);
+
+        return Rectangle<int> (jlimit (1, maxWidth,  roundToInt (width  * scale)),
+                               jlimit (1, maxHeight, roundToInt (height * scale)));
+    }
+
+    static Image rescaledToFit (const Image& image, const int maxWidth, const int maxHeight)
+    {
+        const Rectangle<int> size (getSizeToFit (image.getWidth(), image.getHeight(), maxWidth, maxHeight));
+
+        if (image.isNull() || size == image.getBounds())
+            return image;
+
+        return image.rescaled (size.getWidth(), size.getHeight(), Graphics::highResamplingQuality);
+    }
+}
+
 Image Image::rescaled (const int newWidth, const int newHeight, const Graphics::ResamplingQuality quality) const
 {
     if (image == nullptr || (image->width == newWidth && image->height == newHeight))
         return *this;
 
+    if (quality != Graphics::lowResamplingQuality && newWidth > 0 && newHeight > 0)
+    {
+        // For big reductions, the image is repeatedly halved until it's less than twice the
+        // size that's needed, because the resampling filter only looks at a few pixels around
+        // each point, and would otherwise skip most of the source image.
+        const ScopedPointer<ImageType> type (image->createType());
+        Image reduced (*this);
+
+        for (;;)
+        {
+            const bool halveWidth  = newWidth  * 2 <= reduced.getWidth();
+            const bool halveHeight = newHeight * 2 <= reduced.getHeight();
+
+            if (! (halveWidth || halveHeight))
+                break;
+
+            reduced = ImageRescalingHelpers::halve (reduced, *type, halveWidth, halveHeight);
+        }
+
+        if (reduced != *this)
+            return reduced.rescaled (newWidth, newHeight, quality);
+    }
+
     const ScopedPointer<ImageType> type (image->createType());
     Image newImage (type->create (image->pixelFormat, newWidth, newHeight, hasAlphaChannel()));
 
@@ -345,6 +500,9 @@ Image::BitmapData::BitmapData (Image& im, const int x, const int y, const int w,
     jassert (im.image != nullptr);
     jassert (x >= 0 && y >= 0 && w > 0 && h > 0 && x + w <= im.getWidth() && y + h <= im.getHeight());
 
+    if (mode != readOnly)
+        im.image->markAsChanged();
+
     im.image->initialiseBitmapData (*this, x, y, mode);
     jassert (data != nullptr && pixelStride > 0 && lineStride != 0);
 }
@@ -367,6 +525,9 @@ Image::BitmapData::BitmapData (const Image& im, BitmapData::ReadWriteMode mode)
     // The BitmapData class must be given a valid image!
     jassert (im.image != nullptr);
 
+    if (mode != readOnly)
+        im.image->markAsChanged();
+
     im.image->initialiseBitmapData (*this, 0, 0, mode);
     jassert (data != nullptr && pixelStride > 0 && lineStride != 0);
 }
@@ -642,3 +803,83 @@ void Image::moveImageSection (int dx, int dy,
         }
     }
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageRescalingTests  : public UnitTest
+{
+public:
+    ImageRescalingTests() : UnitTest ("Image rescaling") {}
+
+    void runTest()
+    {
+        beginTest ("Large reductions average all the source pixels");
+
+        // (stripes which are a pixel wide would mostly be skipped by the resampling filter alone)
+        Image stripes (Image::RGB, 512, 384, true);
+
+        for (int x = 0; x < stripes.getWidth(); x += 2)
+            stripes.clear (Rectangle<int> (x, 0, 1, stripes.getHeight()), Colours::white);
+
+        const Image small (stripes.rescaled (32, 24, Graphics::mediumResamplingQuality));
+        expectEquals (small.getWidth(), 32);
+        expectEquals (small.getHeight(), 24);
+
+        for (int y = 2; y < small.getHeight() - 2; ++y)
+            for (int x = 2; x < small.getWidth() - 2; ++x)
+                expect (std::abs ((int) small.getPixelAt (x, y).getRed() - 128) <= 2);
+
+        beginTest ("Odd sizes");
+
+        Image odd (Image::ARGB, 101, 7, true);
+        odd.clear (odd.getBounds(), Colours::red);
+
+        const Image reduced (odd.rescaled (9, 3, Graphics::highResamplingQuality));
+        expectEquals (reduced.getWidth(), 9);
+        expectEquals (reduced.getHeight(), 3);
+        expect (reduced.getPixelAt (4, 1) == Colours::red);
+    }
+};
+
+static ImageRescalingTests imageRescalingTests;
+
+//==============================================================================
+class ImageChangeCountTests  : public UnitTest
+{
+public:
+    ImageChangeCountTests() : UnitTest ("Image change counts") {}
+
+    void runTest()
+    {
+        beginTest ("Writing to an image changes its count");
+
+        Image image (Image::ARGB, 16, 16, true);
+        ImagePixelData* const pixelData = image.getPixelData();
+        int lastCount = pixelData->getChangeCount();
+
+        { Image::BitmapData data (image, Image::BitmapData::readOnly); }
+        expectEquals (pixelData->getChangeCount(), lastCount);
+
+        image.setPixelAt (1, 1, Colours::red);
+        expect (pixelData->getChangeCount() != lastCount);
+        lastCount = pixelData->getChangeCount();
+
+        { Graphics g (image); }
+        expect (pixelData->getChangeCount() != lastCount);
+
+        beginTest ("Subsections share their parent's count");
+
+        Image section (image.getClippedImage (Rectangle<int> (2, 2, 4, 4)));
+        lastCount = pixelData->getChangeCount();
+        expectEquals (section.getPixelData()->getChangeCount(), lastCount);
+
+        section.clear (section.getBounds(), Colours::blue);
+        expect (pixelData->getChangeCount() != lastCount);
+        expectEquals (section.getPixelData()->getChangeCount(), pixelData->getChangeCount());
+    }
+};
+
+static ImageChangeCountTests imageChangeCountTests;
+
+#endif
@@ -196,6 +196,10 @@ public:
 
         Note that if the new size is identical to the existing image, this will just return
         a reference to the original image, and won't actually create a duplicate.
+
+        Unless the quality is Graphics::lowResamplingQuality, an image that's being made less
+        than half its size is first reduced by averaging blocks of pixels, so that every
+        source pixel contributes to the result.
     */
     Image rescaled (int newWidth, int newHeight,
                     Graphics::ResamplingQuality quality = Graphics::mediumResamplingQuality) const;
@@ -448,6 +452,17 @@ public:
     /** Initialises a BitmapData object. */
     virtual void initialiseBitmapData (Image::BitmapData&, int x, int y, Image::BitmapData::ReadWriteMode) = 0;
 
+    /** Marks the pixels as having been changed.
+        This is called automatically whenever a writable BitmapData or a graphics context is
+        created for the image, so that anything which keeps a copy of the pixels (e.g. a GPU
+        texture) can tell that its copy needs refreshing.
+        @see getChangeCount
+    */
+    virtual void markAsChanged() noexcept;
+
+    /** Returns a number that changes each time markAsChanged() is called. */
+    virtual int getChangeCount() const noexcept;
+
     /** The pixel format of the image data. */
     const Image::PixelFormat pixelFormat;
     const int width, height;
@@ -460,6 +475,8 @@ public:
     typedef ReferenceCountedObjectPtr<ImagePixelData> Ptr;
 
 private:
+    Atomic<int> changeCount;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ImagePixelData)
 };
 
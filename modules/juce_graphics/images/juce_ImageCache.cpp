@@ -27,8 +27,9 @@ class ImageCache::Pimpl     : private Timer,
                               private DeletedAtShutdown
 {
 public:
-    Pimpl()  : cacheTimeout (5000)
+    Pimpl()  : cacheTimeout (5000), maxTotalBytes (0), totalBytes (0)
     {
+        resetStatistics();
     }
 
     ~Pimpl()
@@ -40,14 +41,14 @@ public:
     {
         const ScopedLock sl (lock);
 
-        for (int i = images.size(); --i >= 0;)
+        if (Item* const item = index [hashCode])
         {
-            const Item* const item = images.getUnchecked(i);
-
-            if (item->hashCode == hashCode)
-                return item->image;
+            ++stats.numHits;
+            item->lastUseTime = Time::getApproximateMillisecondCounter();
+            return item->image;
         }
 
+        ++stats.numMisses;
         return Image::null;
     }
 
@@ -58,13 +59,27 @@ public:
             if (! isTimerRunning())
                 startTimer (2000);
 
-            Item* const item = new Item();
-            item->hashCode = hashCode;
+            const ScopedLock sl (lock);
+            Item* item = index [hashCode];
+
+            if (item == nullptr)
+            {
+                item = new Item();
+                item->hashCode = hashCode;
+                images.add (item);
+                index.set (hashCode, item);
+            }
+            else
+            {
+                totalBytes -= item->numBytes;
+            }
+
             item->image = image;
             item->lastUseTime = Time::getApproximateMillisecondCounter();
+            item->numBytes = getSizeOf (image);
+            totalBytes += item->numBytes;
 
-            const ScopedLock sl (lock);
-            images.add (item);
+            applySizeLimit();
         }
     }
 
@@ -81,7 +96,7 @@ public:
             if (item->image.getReferenceCount() <= 1)
             {
                 if (now > item->lastUseTime + cacheTimeout || now < item->lastUseTime - 1000)
-                    images.remove (i);
+                    removeItem (i);
             }
             else
             {
@@ -89,6 +104,8 @@ public:
             }
         }
 
+        applySizeLimit();
+
         if (images.size() == 0)
             stopTimer();
     }
@@ -99,13 +116,42 @@ public:
 
         for (int i = images.size(); --i >= 0;)
             if (images.getUnchecked(i)->image.getReferenceCount() <= 1)
-                images.remove (i);
+                removeItem (i);
+    }
+
+    void setSizeLimit (const int64 maxNumBytes)
+    {
+        const ScopedLock sl (lock);
+        maxTotalBytes = maxNumBytes;
+        applySizeLimit();
+    }
+
+    Statistics getStatistics() const
+    {
+        const ScopedLock sl (lock);
+
+        Statistics s (stats);
+        s.numImages = images.size();
+        s.totalBytes = totalBytes;
+        s.unusedBytes = 0;
+
+        for (int i = images.size(); --i >= 0;)
+            if (images.getUnchecked(i)->image.getReferenceCount() <= 1)
+                s.unusedBytes += images.getUnchecked(i)->numBytes;
+
+        return s;
+    }
+
+    void resetStatistics()
+    {
+        const ScopedLock sl (lock);
+        zerostruct (stats);
     }
 
     struct Item
     {
         Image image;
-        int64 hashCode;
+        int64 hashCode, numBytes;
         uint32 lastUseTime;
     };
 
@@ -115,7 +161,49 @@ public:
 
 private:
     OwnedArray<Item> images;
+    HashMap<int64, Item*> index;
     CriticalSection lock;
+    int64 maxTotalBytes, totalBytes;
+    Statistics stats;
+
+    static int64 getSizeOf (const Image& image) noexcept
+    {
+        return image.getWidth() * (int64) image.getHeight()
+                * (image.isARGB() ? 4 : (image.isRGB() ? 3 : 1));
+    }
+
+    void removeItem (const int i)
+    {
+        const Item* const item = images.getUnchecked (i);
+        totalBytes -= item->numBytes;
+        index.remove (item->hashCode);
+        images.remove (i);
+    }
+
+    // Releases the least-recently used images that aren't in use elsewhere until the
+    // total fits inside the limit. The lock must be held when calling this.
+    void applySizeLimit()
+    {
+        while (maxTotalBytes > 0 && totalBytes > maxTotalBytes)
+        {
+            int oldest = -1;
+
+            for (int i = images.size(); --i >= 0;)
+            {
+                const Item* const item = images.getUnchecked(i);
+
+                if (item->image.getReferenceCount() <= 1
+                     && (oldest < 0 || item->lastUseTime <= images.getUnchecked (oldest)->lastUseTime))
+                    oldest = i;
+            }
+
+            if (oldest < 0)
+                break;
+
+            removeItem (oldest);
+            ++stats.numEvictions;
+        }
+    }
 
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
 };
@@ -137,9 +225,26 @@ void ImageCache::addImageToCache (const Image& image, const int64 hashCode)
     Pimpl::getInstance()->addImageToCache (image, hashCode);
 }
 
+int64 ImageCache::getHashCodeFor (const File& file, const int maxWidth, const int maxHeight)
+{
+    if (maxWidth <= 0 || maxHeight <= 0)
+        return file.hashCode64();
+
+    return (file.getFullPathName() + "@" + String (maxWidth) + "x" + String (maxHeight)).hashCode64();
+}
+
+int64 ImageCache::getHashCodeFor (const void* const imageData, const int maxWidth, const int maxHeight)
+{
+    if (maxWidth <= 0 || maxHeight <= 0)
+        return (int64) (pointer_sized_int) imageData;
+
+    return (String::toHexString ((pointer_sized_int) imageData)
+              + "@" + String (maxWidth) + "x" + String (maxHeight)).hashCode64();
+}
+
 Image ImageCache::getFromFile (const File& file)
 {
-    const int64 hashCode = file.hashCode64();
+    const int64 hashCode = getHashCodeFor (file, 0, 0);
     Image image (getFromHashCode (hashCode));
 
     if (image.isNull())
@@ -151,9 +256,26 @@ Image ImageCache::getFromFile (const File& file)
     return image;
 }
 
+Image ImageCache::getFromFile (const File& file, const int maxWidth, const int maxHeight)
+{
+    const int64 hashCode = getHashCodeFor (file, maxWidth, maxHeight);
+    Image image (getFromHashCode (hashCode));
+
+    if (image.isNull())
+    {
+        const Image fullSizeImage (getFromHashCode (getHashCodeFor (file, 0, 0)));
+
+        image = fullSizeImage.isValid() ? ImageRescalingHelpers::rescaledToFit (fullSizeImage, maxWidth, maxHeight)
+                                        : ImageFileFormat::loadFrom (file, maxWidth, maxHeight);
+        addImageToCache (image, hashCode);
+    }
+
+    return image;
+}
+
 Image ImageCache::getFromMemory (const void* imageData, const int dataSize)
 {
-    const int64 hashCode = (int64) (pointer_sized_int) imageData;
+    const int64 hashCode = getHashCodeFor (imageData, 0, 0);
     Image image (getFromHashCode (hashCode));
 
     if (image.isNull())
@@ -165,6 +287,33 @@ Image ImageCache::getFromMemory (const void* imageData, const int dataSize)
     return image;
 }
 
+Image ImageCache::getFromMemory (const void* imageData, const int dataSize, const int maxWidth, const int maxHeight)
+{
+    const int64 hashCode = getHashCodeFor (imageData, maxWidth, maxHeight);
+    Image image (getFromHashCode (hashCode));
+
+    if (image.isNull())
+    {
+        const Image fullSizeImage (getFromHashCode (getHashCodeFor (imageData, 0, 0)));
+
+        if (fullSizeImage.isValid())
+        {
+            image = ImageRescalingHelpers::rescaledToFit (fullSizeImage, maxWidth, maxHeight);
+        }
+        else if (imageData != nullptr && dataSize > 4)
+        {
+            MemoryInputStream stream (imageData, (size_t) dataSize, false);
+
+            if (ImageFileFormat* const format = ImageFileFormat::findImageFormatForStream (stream))
+                image = format->decodeImageToFit (stream, maxWidth, maxHeight);
+        }
+
+        addImageToCache (image, hashCode);
+    }
+
+    return image;
+}
+
 void ImageCache::setCacheTimeout (const int millisecs)
 {
     jassert (millisecs >= 0);
@@ -175,3 +324,93 @@ void ImageCache::releaseUnusedImages()
 {
     Pimpl::getInstance()->releaseUnusedImages();
 }
+
+void ImageCache::setCacheSizeLimit (const int64 maxNumBytes)
+{
+    Pimpl::getInstance()->setSizeLimit (maxNumBytes);
+}
+
+ImageCache::Statistics ImageCache::getStatistics()
+{
+    return Pimpl::getInstance()->getStatistics();
+}
+
+void ImageCache::resetStatistics()
+{
+    Pimpl::getInstance()->resetStatistics();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageCacheTests  : public UnitTest
+{
+public:
+    ImageCacheTests() : UnitTest ("ImageCache") {}
+
+    void runTest()
+    {
+        beginTest ("Size limit");
+
+        ImageCache::releaseUnusedImages();
+        ImageCache::setCacheSizeLimit (3 * 100 * 100 * 4);
+
+        const int64 firstHashCode = 0x7e57000000000000LL;
+
+        for (int i = 0; i < 5; ++i)
+            ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true), firstHashCode + i);
+
+        // (the last image was still in use when it was added, so the limit needs applying again)
+        ImageCache::setCacheSizeLimit (3 * 100 * 100 * 4);
+
+        expectEquals (ImageCache::getStatistics().totalBytes, (int64) (3 * 100 * 100 * 4));
+        expect (ImageCache::getFromHashCode (firstHashCode).isNull());
+        expect (ImageCache::getFromHashCode (firstHashCode + 1).isNull());
+        expect (ImageCache::getFromHashCode (firstHashCode + 4).isValid());
+
+        {
+            // images that are in use count towards the total, but can't be released
+            const Image inUse (ImageCache::getFromHashCode (firstHashCode + 2));
+            ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true), firstHashCode + 5);
+            ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true), firstHashCode + 6);
+            ImageCache::setCacheSizeLimit (3 * 100 * 100 * 4);
+
+            expect (ImageCache::getFromHashCode (firstHashCode + 2).isValid());
+            expect (ImageCache::getFromHashCode (firstHashCode + 3).isNull());
+            expect (ImageCache::getFromHashCode (firstHashCode + 4).isNull());
+            expect (ImageCache::getFromHashCode (firstHashCode + 6).isValid());
+        }
+
+        beginTest ("Replacing an image");
+
+        ImageCache::setCacheSizeLimit (0);
+        ImageCache::releaseUnusedImages();
+        ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true), firstHashCode);
+        ImageCache::addImageToCache (Image (Image::SingleChannel, 10, 10, true), firstHashCode);
+
+        expectEquals (ImageCache::getStatistics().numImages, 1);
+        expectEquals (ImageCache::getStatistics().totalBytes, (int64) 100);
+        expect (ImageCache::getFromHashCode (firstHashCode).getFormat() == Image::SingleChannel);
+
+        beginTest ("Statistics");
+
+        ImageCache::resetStatistics();
+        ImageCache::getFromHashCode (firstHashCode);
+        ImageCache::getFromHashCode (firstHashCode);
+        ImageCache::getFromHashCode (firstHashCode + 1);
+
+        {
+            const ImageCache::Statistics stats (ImageCache::getStatistics());
+            expectEquals (stats.numHits, (int64) 2);
+            expectEquals (stats.numMisses, (int64) 1);
+            expectEquals (stats.unusedBytes, (int64) 100);
+        }
+
+        ImageCache::releaseUnusedImages();
+        expectEquals (ImageCache::getStatistics().totalBytes, (int64) 0);
+    }
+};
+
+static ImageCacheTests imageCacheTests;
+
+#endif
@@ -64,6 +64,18 @@ public:
     */
     static Image getFromFile (const File& file);
 
+    /** Loads an image from a file, shrinking it to fit inside a given size, (or just returns
+        the image if it's already cached at that size).
+
+        This works like getFromFile(), but uses ImageFileFormat::decodeImageToFit(). Each size
+        that's asked for is cached separately, so this is handy for things like thumbnails.
+        If the full-sized image is already in the cache, the smaller one is made from that
+        rather than by loading the file again.
+
+        @see AsyncImageLoader
+    */
+    static Image getFromFile (const File& file, int maxWidth, int maxHeight);
+
     /** Loads an image from an in-memory image file, (or just returns the image if it's already cached).
 
         If the cache already contains an image that was loaded from this block of memory,
@@ -81,6 +93,14 @@ public:
     */
     static Image getFromMemory (const void* imageData, int dataSize);
 
+    /** Loads an image from an in-memory image file, shrinking it to fit inside a given size,
+        (or just returns the image if it's already cached at that size).
+
+        This is the equivalent of getFromFile (file, maxWidth, maxHeight) for images that are
+        held in memory.
+    */
+    static Image getFromMemory (const void* imageData, int dataSize, int maxWidth, int maxHeight);
+
     //==============================================================================
     /** Checks the cache for an image with a particular hashcode.
 
@@ -109,6 +129,41 @@ public:
     */
     static void setCacheTimeout (int millisecs);
 
+    /** Sets a limit on the total size of the pixel data of all the images in the cache.
+
+        When the limit is exceeded, the least-recently used images that aren't being used
+        anywhere else are released straight away, rather than waiting for the timeout.
+        Images that are still in use can't be released, so if they're bigger than the limit
+        on their own, the cache will go over it. The limit is checked whenever an image is
+        added, and every couple of seconds while the cache isn't empty. The default is zero,
+        which means there's no limit.
+
+        @see setCacheTimeout, getStatistics
+    */
+    static void setCacheSizeLimit (int64 maxNumBytes);
+
+    /** Some figures describing the contents and performance of the cache.
+        @see getStatistics
+    */
+    struct Statistics
+    {
+        int numImages;          /**< The number of images in the cache. */
+        int64 totalBytes;       /**< The total size of the pixel data of the images in the cache. */
+        int64 unusedBytes;      /**< The size of the images that aren't being used anywhere else. */
+        int64 numHits;          /**< The number of lookups that found their image in the cache. */
+        int64 numMisses;        /**< The number of lookups that didn't find their image. */
+        int64 numEvictions;     /**< The number of images released to keep within the size limit. */
+    };
+
+    /** Returns some figures that can be used to monitor the cache.
+        The counts are the totals since the cache was created, or since resetStatistics()
+        was last called.
+    */
+    static Statistics getStatistics();
+
+    /** Resets the hit, miss and eviction counts. */
+    static void resetStatistics();
+
     /** Releases any images in the cache that aren't being referenced by active
         Image objects.
     */
@@ -118,6 +173,10 @@ private:
     //==============================================================================
     class Pimpl;
     friend class Pimpl;
+    friend class AsyncImageLoader;
+
+    static int64 getHashCodeFor (const File&, int maxWidth, int maxHeight);
+    static int64 getHashCodeFor (const void*, int maxWidth, int maxHeight);
 
     ImageCache();
     ~ImageCache();
@@ -98,194 +98,446 @@ void ImageConvolutionKernel::createGaussianBlur (const float radius)
     setOverallSum (1.0f);
 }
 
+
+void ImageConvolutionKernel::createBoxBlur()
+{
+    for (int i = size * size; --i >= 0;)
+        values[i] = 1.0f;
+
+    setOverallSum (1.0f);
+}
+
 //==============================================================================
-void ImageConvolutionKernel::applyToImage (Image& destImage,
-                                           const Image& sourceImage,
-                                           const Rectangle<int>& destinationArea) const
+namespace ConvolutionHelpers
 {
-    if (sourceImage == destImage)
-    {
-        destImage.duplicateIfShared();
-    }
-    else
+    // Adds (src[i] * multiplier) to each dest[i].
+    static void addWithMultiply (float* dest, const float* src, const float multiplier, int num) noexcept
     {
-        if (sourceImage.getWidth() != destImage.getWidth()
-             || sourceImage.getHeight() != destImage.getHeight()
-             || sourceImage.getFormat() != destImage.getFormat())
+       #if JUCE_RENDERING_USE_SSE2
+        const __m128 mult = _mm_set1_ps (multiplier);
+
+        for (; num >= 4; num -= 4)
         {
-            jassertfalse;
-            return;
+            _mm_storeu_ps (dest, _mm_add_ps (_mm_loadu_ps (dest), _mm_mul_ps (_mm_loadu_ps (src), mult)));
+            dest += 4;
+            src += 4;
+        }
+       #elif JUCE_RENDERING_USE_NEON
+        const float32x4_t mult = vdupq_n_f32 (multiplier);
+
+        for (; num >= 4; num -= 4)
+        {
+            vst1q_f32 (dest, vmlaq_f32 (vld1q_f32 (dest), vld1q_f32 (src), mult));
+            dest += 4;
+            src += 4;
         }
+       #endif
+
+        while (--num >= 0)
+            *dest++ += *src++ * multiplier;
     }
 
-    const Rectangle<int> area (destinationArea.getIntersection (destImage.getBounds()));
+    static inline uint8 toPixelValue (const float value) noexcept
+    {
+        return (uint8) jlimit (0, 0xff, roundToInt (value));
+    }
 
-    if (area.isEmpty())
-        return;
+    /*  If the kernel is the product of a column and a row of values (which is true for
+        gaussian and box blurs), this finds them, so that the image can be convolved with
+        one and then the other, which takes (size * 2) operations per pixel rather than
+        (size * size).
+    */
+    static bool findSeparableFactors (const float* const values, const int size,
+                                      float* const rowValues, float* const columnValues) noexcept
+    {
+        if (size <= 0)
+            return false;
 
-    const int right = area.getRight();
-    const int bottom = area.getBottom();
+        int largest = 0;
 
-    const Image::BitmapData destData (destImage, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
-                                      Image::BitmapData::writeOnly);
-    uint8* line = destData.data;
+        for (int i = size * size; --i > 0;)
+            if (std::abs (values[i]) > std::abs (values[largest]))
+                largest = i;
 
-    const Image::BitmapData srcData (sourceImage, Image::BitmapData::readOnly);
+        const float largestValue = values[largest];
 
-    if (destData.pixelStride == 4)
+        if (largestValue == 0)
+            return false;
+
+        const int largestX = largest % size;
+        const int largestY = largest / size;
+
+        for (int i = 0; i < size; ++i)
+        {
+            rowValues[i]    = values [i + largestY * size];
+            columnValues[i] = values [largestX + i * size] / largestValue;
+        }
+
+        const float tolerance = std::abs (largestValue) * 1.0e-5f;
+
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+                if (std::abs (values [x + y * size] - columnValues[y] * rowValues[x]) > tolerance)
+                    return false;
+
+        return true;
+    }
+
+    //==============================================================================
+    // Convolves some rows of the destination area by applying the kernel's row values to
+    // each of the source lines that are needed, then adding those lines together using
+    // the column values. Each channel is processed in the same way, so the floats for a
+    // line just mirror the layout of the pixel data.
+    struct SeparableConvolver
     {
-        for (int y = area.getY(); y < bottom; ++y)
+        SeparableConvolver (const Image::BitmapData& srcData_, const Image::BitmapData& destData_,
+                            const Rectangle<int>& area_, const float* rowValues_,
+                            const float* columnValues_, const int size_) noexcept
+            : srcData (srcData_), destData (destData_), area (area_),
+              rowValues (rowValues_), columnValues (columnValues_), size (size_),
+              numChannels (destData_.pixelStride),
+              numValuesPerLine (area_.getWidth() * destData_.pixelStride)
         {
-            uint8* dest = line;
-            line += destData.lineStride;
+        }
+
+        void operator() (const int startRow, const int endRow) const
+        {
+            const int centre = size >> 1;
+            const int firstSourceLine = jmax (0, area.getY() + startRow - centre);
+            const int endSourceLine = jmin (srcData.height, area.getY() + endRow - centre + size);
+            const int numSourceLines = jmax (0, endSourceLine - firstSourceLine);
+            const int paddedWidth = area.getWidth() + size - 1;
 
-            for (int x = area.getX(); x < right; ++x)
+            HeapBlock<float> paddedLine ((size_t) (paddedWidth * numChannels));
+            HeapBlock<float> lines ((size_t) (jmax (1, numSourceLines) * numValuesPerLine), true);
+            HeapBlock<float> total ((size_t) numValuesPerLine);
+
+            for (int i = 0; i < numSourceLines; ++i)
             {
-                float c1 = 0;
-                float c2 = 0;
-                float c3 = 0;
-                float c4 = 0;
+                loadPaddedLine (paddedLine, firstSourceLine + i, paddedWidth);
+                float* const line = lines + i * numValuesPerLine;
+
+                for (int x = 0; x < size; ++x)
+                    if (rowValues[x] != 0)
+                        addWithMultiply (line, paddedLine + x * numChannels, rowValues[x], numValuesPerLine);
+            }
+
+            for (int y = startRow; y < endRow; ++y)
+            {
+                zeromem (total, sizeof (float) * (size_t) numValuesPerLine);
 
                 for (int yy = 0; yy < size; ++yy)
                 {
-                    const int sy = y + yy - (size >> 1);
+                    const int sourceLine = area.getY() + y + yy - centre;
 
-                    if (sy >= srcData.height)
-                        break;
+                    if (sourceLine >= firstSourceLine && sourceLine < endSourceLine && columnValues[yy] != 0)
+                        addWithMultiply (total, lines + (sourceLine - firstSourceLine) * numValuesPerLine,
+                                         columnValues[yy], numValuesPerLine);
+                }
 
-                    if (sy >= 0)
-                    {
-                        int sx = x - (size >> 1);
-                        const uint8* src = srcData.getPixelPointer (sx, sy);
+                uint8* const dest = destData.getLinePointer (y);
 
-                        for (int xx = 0; xx < size; ++xx)
-                        {
-                            if (sx >= srcData.width)
-                                break;
+                for (int i = 0; i < numValuesPerLine; ++i)
+                    dest[i] = toPixelValue (total[i]);
+            }
+        }
 
-                            if (sx >= 0)
-                            {
-                                const float kernelMult = values [xx + yy * size];
-                                c1 += kernelMult * *src++;
-                                c2 += kernelMult * *src++;
-                                c3 += kernelMult * *src++;
-                                c4 += kernelMult * *src++;
-                            }
-                            else
-                            {
-                                src += 4;
-                            }
+    private:
+        const Image::BitmapData& srcData;
+        const Image::BitmapData& destData;
+        const Rectangle<int> area;
+        const float* const rowValues;
+        const float* const columnValues;
+        const int size, numChannels, numValuesPerLine;
+
+        // Converts the source pixels that the row values will be applied to, with zeros
+        // for any that lie outside the image.
+        void loadPaddedLine (float* dest, const int sourceLine, const int paddedWidth) const noexcept
+        {
+            const uint8* const src = srcData.getLinePointer (sourceLine);
+            int sx = area.getX() - (size >> 1);
 
-                            ++sx;
-                        }
-                    }
-                }
+            for (int i = paddedWidth; --i >= 0; ++sx)
+            {
+                if (isPositiveAndBelow (sx, srcData.width))
+                {
+                    const uint8* const pixel = src + sx * srcData.pixelStride;
 
-                *dest++ = (uint8) jmin (0xff, roundToInt (c1));
-                *dest++ = (uint8) jmin (0xff, roundToInt (c2));
-                *dest++ = (uint8) jmin (0xff, roundToInt (c3));
-                *dest++ = (uint8) jmin (0xff, roundToInt (c4));
+                    for (int c = 0; c < numChannels; ++c)
+                        *dest++ = pixel[c];
+                }
+                else
+                {
+                    for (int c = 0; c < numChannels; ++c)
+                        *dest++ = 0;
+                }
             }
         }
-    }
-    else if (destData.pixelStride == 3)
+
+        JUCE_DECLARE_NON_COPYABLE (SeparableConvolver)
+    };
+
+    //==============================================================================
+    // Applies the whole kernel to each pixel, for kernels that can't be separated.
+    template <int numChannels>
+    struct DirectConvolver
     {
-        for (int y = area.getY(); y < bottom; ++y)
+        DirectConvolver (const Image::BitmapData& srcData_, const Image::BitmapData& destData_,
+                         const Rectangle<int>& area_, const float* values_, const int size_) noexcept
+            : srcData (srcData_), destData (destData_), area (area_), values (values_), size (size_)
+        {
+        }
+
+        void operator() (const int startRow, const int endRow) const
         {
-            uint8* dest = line;
-            line += destData.lineStride;
+            const int centre = size >> 1;
 
-            for (int x = area.getX(); x < right; ++x)
+            for (int y = startRow; y < endRow; ++y)
             {
-                float c1 = 0;
-                float c2 = 0;
-                float c3 = 0;
+                uint8* dest = destData.getLinePointer (y);
 
-                for (int yy = 0; yy < size; ++yy)
+                for (int x = area.getX(); x < area.getRight(); ++x)
                 {
-                    const int sy = y + yy - (size >> 1);
-
-                    if (sy >= srcData.height)
-                        break;
+                    float total [numChannels] = { 0 };
 
-                    if (sy >= 0)
+                    for (int yy = 0; yy < size; ++yy)
                     {
-                        int sx = x - (size >> 1);
-                        const uint8* src = srcData.getPixelPointer (sx, sy);
+                        const int sy = area.getY() + y + yy - centre;
+
+                        if (sy >= srcData.height)
+                            break;
+
+                        if (sy < 0)
+                            continue;
 
                         for (int xx = 0; xx < size; ++xx)
                         {
+                            const int sx = x + xx - centre;
+
                             if (sx >= srcData.width)
                                 break;
 
                             if (sx >= 0)
                             {
                                 const float kernelMult = values [xx + yy * size];
-                                c1 += kernelMult * *src++;
-                                c2 += kernelMult * *src++;
-                                c3 += kernelMult * *src++;
-                            }
-                            else
-                            {
-                                src += 3;
-                            }
+                                const uint8* const src = srcData.getPixelPointer (sx, sy);
 
-                            ++sx;
+                                for (int c = 0; c < numChannels; ++c)
+                                    total[c] += kernelMult * src[c];
+                            }
                         }
                     }
-                }
 
-                *dest++ = (uint8) roundToInt (c1);
-                *dest++ = (uint8) roundToInt (c2);
-                *dest++ = (uint8) roundToInt (c3);
+                    for (int c = 0; c < numChannels; ++c)
+                        *dest++ = toPixelValue (total[c]);
+                }
             }
         }
+
+    private:
+        const Image::BitmapData& srcData;
+        const Image::BitmapData& destData;
+        const Rectangle<int> area;
+        const float* const values;
+        const int size;
+
+        JUCE_DECLARE_NON_COPYABLE (DirectConvolver)
+    };
+
+    // Small jobs are done on the calling thread, and bigger ones are split into bands
+    // of rows that are shared out between the rendering threads. The bands are kept
+    // at least as high as the kernel, so that the separable convolver doesn't spend
+    // too long working out lines which the next band will need as well.
+    template <class ConvolverType>
+    static void convolveRows (ConvolverType& convolver, const Rectangle<int>& area, const int kernelSize)
+    {
+        const int numRows = area.getHeight();
+
+        if (area.getWidth() * numRows * kernelSize < 256 * 1024)
+            convolver (0, numRows);
+        else
+            parallelFor (*RenderingHelpers::RenderingThreadPool::getInstance(),
+                         0, numRows, convolver, jmax (16, kernelSize));
     }
-    else if (destData.pixelStride == 1)
+}
+
+void ImageConvolutionKernel::applyToImage (Image& destImage,
+                                           const Image& sourceImage,
+                                           const Rectangle<int>& destinationArea) const
+{
+    Image source (sourceImage);
+
+    if (sourceImage == destImage)
     {
-        for (int y = area.getY(); y < bottom; ++y)
+        // (the pixels are read from a copy, so that ones which have already been
+        // convolved aren't used for their neighbours)
+        source = sourceImage.createCopy();
+        destImage.duplicateIfShared();
+    }
+    else
+    {
+        if (sourceImage.getWidth() != destImage.getWidth()
+             || sourceImage.getHeight() != destImage.getHeight()
+             || sourceImage.getFormat() != destImage.getFormat())
         {
-            uint8* dest = line;
-            line += destData.lineStride;
+            jassertfalse;
+            return;
+        }
+    }
 
-            for (int x = area.getX(); x < right; ++x)
-            {
-                float c1 = 0;
+    const Rectangle<int> area (destinationArea.getIntersection (destImage.getBounds()));
 
-                for (int yy = 0; yy < size; ++yy)
-                {
-                    const int sy = y + yy - (size >> 1);
+    if (area.isEmpty())
+        return;
+
+    const Image::BitmapData destData (destImage, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
+                                      Image::BitmapData::writeOnly);
+    const Image::BitmapData srcData (source, Image::BitmapData::readOnly);
 
-                    if (sy >= srcData.height)
-                        break;
+    using namespace ConvolutionHelpers;
+    HeapBlock<float> rowValues ((size_t) jmax (1, size)), columnValues ((size_t) jmax (1, size));
 
-                    if (sy >= 0)
-                    {
-                        int sx = x - (size >> 1);
-                        const uint8* src = srcData.getPixelPointer (sx, sy);
+    if (findSeparableFactors (values, size, rowValues, columnValues))
+    {
+        SeparableConvolver convolver (srcData, destData, area, rowValues, columnValues, size);
+        convolveRows (convolver, area, size);
+    }
+    else if (destData.pixelStride == 4)
+    {
+        DirectConvolver<4> convolver (srcData, destData, area, values, size);
+        convolveRows (convolver, area, size * size);
+    }
+    else if (destData.pixelStride == 3)
+    {
+        DirectConvolver<3> convolver (srcData, destData, area, values, size);
+        convolveRows (convolver, area, size * size);
+    }
+    else if (destData.pixelStride == 1)
+    {
+        DirectConvolver<1> convolver (srcData, destData, area, values, size);
+        convolveRows (convolver, area, size * size);
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageConvolutionKernelTests  : public UnitTest
+{
+public:
+    ImageConvolutionKernelTests() : UnitTest ("ImageConvolutionKernel") {}
 
+    void runTest()
+    {
+        Random r (0x1234);
+
+        beginTest ("Separable kernels");
+
+        ImageConvolutionKernel gaussian (7);
+        gaussian.createGaussianBlur (2.5f);
+        checkAgainstReference (gaussian, Image::ARGB, 61, 47, Rectangle<int> (-3, 5, 50, 60), r);
+        checkAgainstReference (gaussian, Image::SingleChannel, 61, 47, Rectangle<int> (4, 2, 53, 40), r);
+        checkAgainstReference (gaussian, Image::ARGB, 300, 200, Rectangle<int> (0, 0, 300, 200), r);
+
+        ImageConvolutionKernel box (5);
+        box.createBoxBlur();
+        checkAgainstReference (box, Image::RGB, 40, 30, Rectangle<int> (0, 0, 40, 30), r);
+
+        beginTest ("Other kernels");
+
+        ImageConvolutionKernel sharpen (3);
+        sharpen.setKernelValue (1, 1, 5.0f);
+        sharpen.setKernelValue (0, 1, -1.0f);
+        sharpen.setKernelValue (2, 1, -1.0f);
+        sharpen.setKernelValue (1, 0, -1.0f);
+        sharpen.setKernelValue (1, 2, -1.0f);
+        checkAgainstReference (sharpen, Image::ARGB, 33, 21, Rectangle<int> (0, 0, 33, 21), r);
+        checkAgainstReference (sharpen, Image::SingleChannel, 33, 21, Rectangle<int> (1, 1, 30, 18), r);
+
+        ImageConvolutionKernel randomKernel (4);
+
+        for (int y = 0; y < 4; ++y)
+            for (int x = 0; x < 4; ++x)
+                randomKernel.setKernelValue (x, y, r.nextFloat() * 0.1f);
+
+        checkAgainstReference (randomKernel, Image::ARGB, 120, 90, Rectangle<int> (0, 0, 120, 90), r);
+
+        beginTest ("In-place convolution");
+
+        Image image (createRandomImage (Image::ARGB, 50, 40, r));
+        Image expected (Image::ARGB, 50, 40, true);
+        gaussian.applyToImage (expected, image.createCopy(), image.getBounds());
+        gaussian.applyToImage (image, image, image.getBounds());
+        expectEquals (getLargestDifference (image, expected), 0);
+    }
+
+    static Image createRandomImage (const Image::PixelFormat format, const int w, const int h, Random& r)
+    {
+        Image image (format, w, h, false);
+        const Image::BitmapData data (image, Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < h; ++y)
+            for (int i = 0; i < w * data.pixelStride; ++i)
+                data.getLinePointer (y)[i] = (uint8) r.nextInt (256);
+
+        return image;
+    }
+
+    static int getLargestDifference (const Image& image1, const Image& image2)
+    {
+        const Image::BitmapData data1 (image1, Image::BitmapData::readOnly);
+        const Image::BitmapData data2 (image2, Image::BitmapData::readOnly);
+        int largest = 0;
+
+        for (int y = 0; y < data1.height; ++y)
+            for (int i = 0; i < data1.width * data1.pixelStride; ++i)
+                largest = jmax (largest, std::abs (data1.getLinePointer (y)[i] - data2.getLinePointer (y)[i]));
+
+        return largest;
+    }
+
+    void checkAgainstReference (const ImageConvolutionKernel& kernel, const Image::PixelFormat format,
+                                const int w, const int h, const Rectangle<int>& area, Random& r)
+    {
+        const Image source (createRandomImage (format, w, h, r));
+        Image result (format, w, h, true);
+        kernel.applyToImage (result, source, area);
+
+        Image expected (format, w, h, true);
+        const Image::BitmapData srcData (source, Image::BitmapData::readOnly);
+        const Image::BitmapData destData (expected, Image::BitmapData::writeOnly);
+        const int size = kernel.getKernelSize();
+        const Rectangle<int> clippedArea (area.getIntersection (source.getBounds()));
+
+        for (int y = clippedArea.getY(); y < clippedArea.getBottom(); ++y)
+        {
+            for (int x = clippedArea.getX(); x < clippedArea.getRight(); ++x)
+            {
+                for (int c = 0; c < srcData.pixelStride; ++c)
+                {
+                    double total = 0;
+
+                    for (int yy = 0; yy < size; ++yy)
+                    {
                         for (int xx = 0; xx < size; ++xx)
                         {
-                            if (sx >= srcData.width)
-                                break;
+                            const int sx = x + xx - size / 2;
+                            const int sy = y + yy - size / 2;
 
-                            if (sx >= 0)
-                            {
-                                const float kernelMult = values [xx + yy * size];
-                                c1 += kernelMult * *src++;
-                            }
-                            else
-                            {
-                                src += 3;
-                            }
-
-                            ++sx;
+                            if (isPositiveAndBelow (sx, w) && isPositiveAndBelow (sy, h))
+                                total += kernel.getKernelValue (xx, yy) * srcData.getPixelPointer (sx, sy)[c];
                         }
                     }
-                }
 
-                *dest++ = (uint8) roundToInt (c1);
+                    destData.getPixelPointer (x, y)[c] = (uint8) jlimit (0, 255, roundToInt (total));
+                }
             }
         }
+
+        expect (getLargestDifference (result, expected) <= 1);
     }
-}
+};
+
+static ImageConvolutionKernelTests imageConvolutionKernelTests;
+
+#endif
@@ -82,6 +82,11 @@ public:
     */
     void createGaussianBlur (float blurRadius);
 
+    /** Intialises the kernel for a box blur, where every pixel in the kernel's area
+        counts equally.
+    */
+    void createBoxBlur();
+
     //==============================================================================
     /** Returns the size of the kernel.
 
@@ -97,6 +102,11 @@ public:
                                 the destination, but if different, it must be exactly the same
                                 size and format.
         @param destinationArea  the region of the image to apply the filter to
+
+        Kernels that can be separated into a row and a column of values (such as the
+        ones made by createGaussianBlur() and createBoxBlur()) are applied in two much
+        faster passes, and large areas are split into bands which are processed on
+        several threads at once.
     */
     void applyToImage (Image& destImage,
                        const Image& sourceImage,
@@ -72,6 +72,17 @@ ImageFileFormat* ImageFileFormat::findImageFormatForFileExtension (const File& f
     return nullptr;
 }
 
+//==============================================================================
+Image ImageFileFormat::decodeImageToFit (InputStream& input, const int maxWidth, const int maxHeight)
+{
+    return ImageRescalingHelpers::rescaledToFit (decodeImage (input), maxWidth, maxHeight);
+}
+
+Image ImageFileFormat::decodePreview (InputStream&, int, int)
+{
+    return Image::null;
+}
+
 //==============================================================================
 Image ImageFileFormat::loadFrom (InputStream& input)
 {
@@ -96,6 +107,22 @@ Image ImageFileFormat::loadFrom (const File& file)
     return Image::null;
 }
 
+Image ImageFileFormat::loadFrom (const File& file, const int maxWidth, const int maxHeight)
+{
+    FileInputStream stream (file);
+
+    if (stream.openedOk())
+    {
+        BufferedInputStream b (stream, 8192);
+        ImageFileFormat* const format = findImageFormatForStream (b);
+
+        if (format != nullptr)
+            return format->decodeImageToFit (b, maxWidth, maxHeight);
+    }
+
+    return Image::null;
+}
+
 Image ImageFileFormat::loadFrom (const void* rawData, const size_t numBytes)
 {
     if (rawData != nullptr && numBytes > 4)
@@ -106,3 +133,88 @@ Image ImageFileFormat::loadFrom (const void* rawData, const size_t numBytes)
 
     return Image::null;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageFileFormatTests  : public UnitTest
+{
+public:
+    ImageFileFormatTests() : UnitTest ("ImageFileFormat") {}
+
+    void runTest()
+    {
+        Image image (Image::RGB, 400, 300, true);
+
+        {
+            Graphics g (image);
+            g.setGradientFill (ColourGradient (Colours::red, 0, 0, Colours::blue, 400, 300, false));
+            g.fillAll();
+        }
+
+        beginTest ("Decoding JPEGs to fit");
+
+        JPEGImageFormat jpeg;
+        MemoryBlock jpegData (encode (jpeg, image));
+
+        checkSize (jpeg, jpegData, 0, 0, 400, 300);
+        checkSize (jpeg, jpegData, 1000, 1000, 400, 300);
+        checkSize (jpeg, jpegData, 100, 100, 100, 75);
+        checkSize (jpeg, jpegData, 200, 40, 53, 40);
+
+        {
+            MemoryInputStream in (jpegData, false);
+            const Image preview (jpeg.decodePreview (in, 0, 0));
+            expectEquals (preview.getWidth(), 50);
+            expectEquals (preview.getHeight(), 38);
+        }
+
+        {
+            // (a 50x38 image is already decoded at the smallest scale, so there's no preview)
+            MemoryInputStream in (jpegData, false);
+            expect (jpeg.decodePreview (in, 50, 50).isNull());
+        }
+
+        {
+            MemoryInputStream in (jpegData, false);
+            const Image reduced (jpeg.decodeImageToFit (in, 100, 100));
+            const Colour c (reduced.getPixelAt (50, 37));
+            expect (std::abs (c.getRed() - c.getBlue()) < 40);
+        }
+
+        beginTest ("Decoding PNGs to fit");
+
+        PNGImageFormat png;
+        MemoryBlock pngData (encode (png, image));
+
+        checkSize (png, pngData, 0, 0, 400, 300);
+        checkSize (png, pngData, 40, 60, 40, 30);
+
+        {
+            MemoryInputStream in (pngData, false);
+            expect (png.decodePreview (in, 100, 100).isNull());
+        }
+    }
+
+    static MemoryBlock encode (ImageFileFormat& format, const Image& image)
+    {
+        MemoryOutputStream out;
+        format.writeImageToStream (image, out);
+        return out.getMemoryBlock();
+    }
+
+    void checkSize (ImageFileFormat& format, const MemoryBlock& data,
+                    const int maxWidth, const int maxHeight,
+                    const int expectedWidth, const int expectedHeight)
+    {
+        MemoryInputStream in (data, false);
+        const Image image (format.decodeImageToFit (in, maxWidth, maxHeight));
+
+        expectEquals (image.getWidth(), expectedWidth);
+        expectEquals (image.getHeight(), expectedHeight);
+    }
+};
+
+static ImageFileFormatTests imageFileFormatTests;
+
+#endif
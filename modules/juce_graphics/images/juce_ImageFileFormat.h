@@ -85,6 +85,32 @@ public:
     */
     virtual Image decodeImage (InputStream& input) = 0;
 
+    /** Tries to decode an image, shrinking it if it's bigger than a given size.
+
+        If the image won't fit inside maxWidth x maxHeight, it's scaled down (keeping its
+        proportions) until it does. Smaller images are returned at their original size, as
+        is any image if either of the limits is zero or less.
+
+        The default implementation just calls decodeImage() and rescales the result, but
+        formats which can decode straight to a lower resolution override it, which can be
+        much quicker when loading things like thumbnails.
+
+        @see decodeImage, decodePreview
+    */
+    virtual Image decodeImageToFit (InputStream& input, int maxWidth, int maxHeight);
+
+    /** Tries to quickly decode a rough, low-resolution version of an image.
+
+        This is for showing something while the real image is being loaded. The preview
+        will fit inside maxWidth x maxHeight (if these are greater than zero), but may be
+        a lot smaller.
+
+        If the format can't make a preview much more quickly than it could decode the
+        image with decodeImageToFit(), this returns an invalid image, which is what the
+        default implementation does.
+    */
+    virtual Image decodePreview (InputStream& input, int maxWidth, int maxHeight);
+
     //==============================================================================
     /** Attempts to write an image to a stream.
 
@@ -129,6 +155,15 @@ public:
     */
     static Image loadFrom (const File& file);
 
+    /** Tries to load an image from a file, shrinking it to fit inside a given size.
+
+        This works like loadFrom(), but uses the format's decodeImageToFit() method.
+
+        @returns        the image that was decoded, or an invalid image if it fails.
+        @see decodeImageToFit
+    */
+    static Image loadFrom (const File& file, int maxWidth, int maxHeight);
+
     /** Tries to load an image from a block of raw image data.
 
         This will use the findImageFormatForStream() method to locate a suitable
@@ -188,6 +223,8 @@ public:
     bool usesFileExtension (const File&) override;
     bool canUnderstand (InputStream&) override;
     Image decodeImage (InputStream&) override;
+    Image decodeImageToFit (InputStream&, int maxWidth, int maxHeight) override;
+    Image decodePreview (InputStream&, int maxWidth, int maxHeight) override;
     bool writeImageToStream (const Image&, OutputStream&) override;
 
 private:
@@ -39,6 +39,26 @@
 #include "../juce_core/native/juce_BasicNativeHeaders.h"
 #include "juce_graphics.h"
 
+#ifndef JUCE_RENDERING_USE_AVX2
+ #if JUCE_RENDERING_USE_SSE2 && ((JUCE_MSVC && _MSC_VER >= 1700) \
+                                  || (JUCE_GCC && ! JUCE_CLANG && (__GNUC__ * 100 + __GNUC_MINOR__) >= 409) \
+                                  || (JUCE_CLANG && ! (JUCE_MAC || JUCE_IOS) && (__clang_major__ * 100 + __clang_minor__) >= 308))
+  #define JUCE_RENDERING_USE_AVX2 1
+ #endif
+#endif
+
+#if JUCE_RENDERING_USE_AVX2
+ #include <immintrin.h>
+
+ // The AVX2 span-blending code is compiled for that instruction set on a per-function basis,
+ // and is only called after checking SystemStats::hasAVX2().
+ #if JUCE_MSVC
+  #define JUCE_AVX2_FUNCTION
+ #else
+  #define JUCE_AVX2_FUNCTION __attribute__ ((target ("avx2")))
+ #endif
+#endif
+
 //==============================================================================
 #if JUCE_MAC
  #import <QuartzCore/QuartzCore.h>
@@ -109,13 +129,16 @@ namespace juce
 #include "geometry/juce_RectangleList.cpp"
 #include "placement/juce_Justification.cpp"
 #include "placement/juce_RectanglePlacement.cpp"
+#include "contexts/juce_DisplayList.cpp"
 #include "contexts/juce_GraphicsContext.cpp"
 #include "contexts/juce_LowLevelGraphicsPostScriptRenderer.cpp"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.cpp"
+#include "contexts/juce_LowLevelGraphicsTiledRenderer.cpp"
 #include "images/juce_Image.cpp"
 #include "images/juce_ImageCache.cpp"
 #include "images/juce_ImageConvolutionKernel.cpp"
 #include "images/juce_ImageFileFormat.cpp"
+#include "images/juce_AsyncImageLoader.cpp"
 #include "image_formats/juce_GIFLoader.cpp"
 #include "image_formats/juce_JPEGLoader.cpp"
 #include "image_formats/juce_PNGLoader.cpp"
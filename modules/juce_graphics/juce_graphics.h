@@ -61,6 +61,27 @@
  #define USE_COREGRAPHICS_RENDERING 1
 #endif
 
+//=============================================================================
+// The software renderer's inner loops use SSE2 or NEON when the compiler is allowed to
+// generate them everywhere, which is always the case for 64-bit Intel and ARM builds.
+#ifndef JUCE_RENDERING_USE_SSE2
+ #if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define JUCE_RENDERING_USE_SSE2 1
+ #endif
+#endif
+
+#ifndef JUCE_RENDERING_USE_NEON
+ #if defined (__ARM_NEON__) || defined (__ARM_NEON)
+  #define JUCE_RENDERING_USE_NEON 1
+ #endif
+#endif
+
+#if JUCE_RENDERING_USE_SSE2
+ #include <emmintrin.h>
+#elif JUCE_RENDERING_USE_NEON
+ #include <arm_neon.h>
+#endif
+
 //=============================================================================
 namespace juce
 {
@@ -118,6 +139,9 @@ namespace juce
 #ifndef __JUCE_RECTANGLEPLACEMENT_JUCEHEADER__
  #include "placement/juce_RectanglePlacement.h"
 #endif
+#ifndef __JUCE_DISPLAYLIST_JUCEHEADER__
+ #include "contexts/juce_DisplayList.h"
+#endif
 #ifndef __JUCE_GRAPHICSCONTEXT_JUCEHEADER__
  #include "contexts/juce_GraphicsContext.h"
 #endif
@@ -130,6 +154,12 @@ namespace juce
 #ifndef __JUCE_LOWLEVELGRAPHICSSOFTWARERENDERER_JUCEHEADER__
  #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.h"
 #endif
+#ifndef __JUCE_LOWLEVELGRAPHICSTILEDRENDERER_JUCEHEADER__
+ #include "contexts/juce_LowLevelGraphicsTiledRenderer.h"
+#endif
+#ifndef __JUCE_ASYNCIMAGELOADER_JUCEHEADER__
+ #include "images/juce_AsyncImageLoader.h"
+#endif
 #ifndef __JUCE_IMAGE_JUCEHEADER__
  #include "images/juce_Image.h"
 #endif
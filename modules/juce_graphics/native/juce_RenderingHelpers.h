@@ -160,14 +160,20 @@ private:
 };
 
 //==============================================================================
-/** Holds a cache of recently-used glyph objects of some type. */
+/** Holds a cache of recently-used glyph objects of some type.
+
+    The glyphs are shared out between a number of separately-locked shards according
+    to their glyph number, so that several threads can render text at the same time
+    without all waiting for the same lock. When the cache is full, the least-recently
+    used glyph in the shard is replaced.
+*/
 template <class CachedGlyphType, class RenderTargetType>
 class GlyphCache  : private DeletedAtShutdown
 {
 public:
     GlyphCache()
+        : maxGlyphsPerShard (defaultMaxNumGlyphs / numShards)
     {
-        addNewGlyphSlots (120);
     }
 
     ~GlyphCache()
@@ -188,43 +194,42 @@ public:
     //==============================================================================
     void drawGlyph (RenderTargetType& target, const Font& font, const int glyphNumber, float x, float y)
     {
+        Shard& shard = shards [((unsigned int) glyphNumber) % (unsigned int) numShards];
         ++accessCounter;
-        CachedGlyphType* glyph = nullptr;
 
-        const ScopedReadLock srl (lock);
-
-        for (int i = glyphs.size(); --i >= 0;)
         {
-            CachedGlyphType* const g = glyphs.getUnchecked (i);
+            const ScopedReadLock srl (shard.lock);
 
-            if (g->glyph == glyphNumber && g->font == font)
+            if (CachedGlyphType* const glyph = shard.findExistingGlyph (font, glyphNumber))
             {
-                glyph = g;
                 ++hits;
-                break;
+                glyph->lastAccessCount = accessCounter.value;
+                glyph->draw (target, x, y);
+                return;
             }
         }
 
+        // The read lock has to be released before taking the write lock, because if two threads
+        // tried to upgrade their read locks at the same time, they'd deadlock. That means that
+        // another thread may have generated the glyph in the meantime, so it's looked for again.
+        const ScopedWriteLock swl (shard.lock);
+
+        CachedGlyphType* glyph = shard.findExistingGlyph (font, glyphNumber);
+
         if (glyph == nullptr)
         {
             ++misses;
-            const ScopedWriteLock swl (lock);
 
-            if (hits.value + misses.value > glyphs.size() * 16)
+            if (shard.glyphs.size() < maxGlyphsPerShard.get())
             {
-                if (misses.value * 2 > hits.value)
-                    addNewGlyphSlots (32);
-
-                hits.set (0);
-                misses.set (0);
-                glyph = glyphs.getLast();
+                glyph = new CachedGlyphType();
+                shard.glyphs.add (glyph);
             }
             else
             {
-                glyph = findLeastRecentlyUsedGlyph();
+                glyph = shard.glyphs.getUnchecked (shard.findLeastRecentlyUsedGlyph());
             }
 
-            jassert (glyph != nullptr);
             glyph->generate (font, glyphNumber);
         }
 
@@ -232,36 +237,101 @@ public:
         glyph->draw (target, x, y);
     }
 
-private:
-    friend class OwnedArray <CachedGlyphType>;
-    OwnedArray <CachedGlyphType> glyphs;
-    Atomic<int> accessCounter, hits, misses;
-    ReadWriteLock lock;
+    //==============================================================================
+    /** Changes the number of glyphs that the cache can hold. */
+    void setMaximumNumGlyphs (const int newMaximum)
+    {
+        maxGlyphsPerShard = jmax (1, newMaximum / numShards);
 
-    void addNewGlyphSlots (int num)
+        for (int i = 0; i < numShards; ++i)
+        {
+            Shard& shard = shards[i];
+            const ScopedWriteLock swl (shard.lock);
+
+            while (shard.glyphs.size() > maxGlyphsPerShard.get())
+                shard.glyphs.remove (shard.findLeastRecentlyUsedGlyph());
+        }
+    }
+
+    /** Returns the number of glyphs that the cache can hold. */
+    int getMaximumNumGlyphs() const noexcept        { return maxGlyphsPerShard.get() * numShards; }
+
+    /** Returns the number of glyphs that are currently cached. */
+    int getNumGlyphs() const
+    {
+        int total = 0;
+
+        for (int i = 0; i < numShards; ++i)
+        {
+            const ScopedReadLock srl (shards[i].lock);
+            total += shards[i].glyphs.size();
+        }
+
+        return total;
+    }
+
+    /** Returns the number of glyphs that have been drawn from the cache since the
+        statistics were last reset.
+    */
+    int64 getNumHits() const noexcept               { return hits.get(); }
+
+    /** Returns the number of glyphs that had to be generated since the statistics were
+        last reset.
+    */
+    int64 getNumMisses() const noexcept             { return misses.get(); }
+
+    /** Resets the hit and miss counts. */
+    void resetStatistics() noexcept
     {
-        while (--num >= 0)
-            glyphs.add (new CachedGlyphType());
+        hits.set (0);
+        misses.set (0);
     }
 
-    CachedGlyphType* findLeastRecentlyUsedGlyph() const noexcept
+private:
+    //==============================================================================
+    enum { numShards = 16, defaultMaxNumGlyphs = 2048 };
+
+    struct Shard
     {
-        CachedGlyphType* oldest = glyphs.getLast();
-        int oldestCounter = oldest->lastAccessCount;
+        OwnedArray <CachedGlyphType> glyphs;
+        ReadWriteLock lock;
+
+        CachedGlyphType* findExistingGlyph (const Font& font, const int glyphNumber) const noexcept
+        {
+            for (int i = glyphs.size(); --i >= 0;)
+            {
+                CachedGlyphType* const g = glyphs.getUnchecked (i);
+
+                if (g->glyph == glyphNumber && g->font == font)
+                    return g;
+            }
+
+            return nullptr;
+        }
 
-        for (int i = glyphs.size() - 1; --i >= 0;)
+        int findLeastRecentlyUsedGlyph() const noexcept
         {
-            CachedGlyphType* const glyph = glyphs.getUnchecked(i);
+            int oldest = glyphs.size() - 1;
+            int oldestCounter = glyphs.getUnchecked (oldest)->lastAccessCount;
 
-            if (glyph->lastAccessCount <= oldestCounter)
+            for (int i = oldest; --i >= 0;)
             {
-                oldestCounter = glyph->lastAccessCount;
-                oldest = glyph;
+                const int counter = glyphs.getUnchecked (i)->lastAccessCount;
+
+                if (counter <= oldestCounter)
+                {
+                    oldestCounter = counter;
+                    oldest = i;
+                }
             }
+
+            return oldest;
         }
+    };
 
-        return oldest;
-    }
+    Shard shards [numShards];
+    Atomic<int> accessCounter, maxGlyphsPerShard;
+    Atomic<int64> hits, misses;
 
     static GlyphCache*& getSingletonPointer() noexcept
     {
@@ -572,6 +642,30 @@ namespace GradientPixelIterators
     do { dest->op; dest = addBytesToPointer (dest, destStride); } while (--width > 0); \
 }
 
+//==============================================================================
+/** Fills and blends runs of contiguous ARGB pixels.
+
+    The edge-table fillers use these for their spans whenever the destination is a
+    packed ARGB image. They produce exactly the same results as the equivalent
+    PixelARGB methods, but use SSE2, AVX2 or NEON instructions where the CPU has them.
+*/
+struct JUCE_API  PixelSpans
+{
+    /** Sets each pixel to the given colour. */
+    static void JUCE_CALLTYPE fill (PixelARGB* dest, PixelARGB colour, int numPixels) noexcept;
+
+    /** Does the same as PixelARGB::blend (colour) for each pixel. */
+    static void JUCE_CALLTYPE blend (PixelARGB* dest, PixelARGB colour, int numPixels) noexcept;
+
+    /** Does the same as PixelARGB::blend (src[i]) for each pixel. */
+    static void JUCE_CALLTYPE blend (PixelARGB* dest, const PixelARGB* src, int numPixels) noexcept;
+
+    /** Does the same as PixelARGB::blend (src[i], extraAlpha) for each pixel.
+        The extraAlpha value must be in the range 0 to 256.
+    */
+    static void JUCE_CALLTYPE blend (PixelARGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+};
+
 //==============================================================================
 /** Contains classes for filling edge tables with various fill types. */
 namespace EdgeTableFillers
@@ -603,9 +697,17 @@ namespace EdgeTableFillers
         forcedinline void handleEdgeTablePixel (const int x, const int alphaLevel) const noexcept
         {
             if (replaceExisting)
+            {
                 getPixel (x)->set (sourceColour);
+            }
             else
-                getPixel (x)->blend (sourceColour, (uint32) alphaLevel);
+            {
+                // (this has to round the alpha in the same way as handleEdgeTableLine(), so that
+                // a pixel comes out the same whichever of them draws it)
+                PixelARGB p (sourceColour);
+                p.multiplyAlpha (alphaLevel);
+                getPixel (x)->blend (p);
+            }
         }
 
         forcedinline void handleEdgeTablePixelFull (const int x) const noexcept
@@ -651,11 +753,20 @@ namespace EdgeTableFillers
             return addBytesToPointer (linePixels, x * destData.pixelStride);
         }
 
-        inline void blendLine (PixelType* dest, const PixelARGB colour, int width) const noexcept
+        template <class DestPixelType>
+        inline void blendLine (DestPixelType* dest, const PixelARGB colour, int width) const noexcept
         {
             JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
         }
 
+        inline void blendLine (PixelARGB* dest, const PixelARGB colour, int width) const noexcept
+        {
+            if (destData.pixelStride == sizeof (*dest))
+                PixelSpans::blend (dest, colour, width);
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
+        }
+
         forcedinline void replaceLine (PixelRGB* dest, const PixelARGB colour, int width) const noexcept
         {
             if (destData.pixelStride == sizeof (*dest))
@@ -711,7 +822,10 @@ namespace EdgeTableFillers
 
         forcedinline void replaceLine (PixelARGB* dest, const PixelARGB colour, int width) const noexcept
         {
-            JUCE_PERFORM_PIXEL_OP_LOOP (set (colour))
+            if (destData.pixelStride == sizeof (*dest))
+                PixelSpans::fill (dest, colour, width);
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (set (colour))
         }
 
         JUCE_DECLARE_NON_COPYABLE (SolidColour)
@@ -748,18 +862,12 @@ namespace EdgeTableFillers
 
         void handleEdgeTableLine (int x, int width, const int alphaLevel) const noexcept
         {
-            PixelType* dest = getPixel (x);
-
-            if (alphaLevel < 0xff)
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
-            else
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+            blendLine (getPixel (x), x, width, (uint32) alphaLevel);
         }
 
         void handleEdgeTableLineFull (int x, int width) const noexcept
         {
-            PixelType* dest = getPixel (x);
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+            blendLine (getPixel (x), x, width, 0xff);
         }
 
     private:
@@ -771,9 +879,57 @@ namespace EdgeTableFillers
             return addBytesToPointer (linePixels, x * destData.pixelStride);
         }
 
+        template <class DestPixelType>
+        void blendLine (DestPixelType* dest, int x, int width, const uint32 alphaLevel) const noexcept
+        {
+            if (alphaLevel < 0xff)
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), alphaLevel))
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+        }
+
+        void blendLine (PixelARGB* dest, int x, int width, const uint32 alphaLevel) const noexcept
+        {
+            if (destData.pixelStride != sizeof (*dest))
+            {
+                blendLine<PixelARGB> (dest, x, width, alphaLevel);
+                return;
+            }
+
+            // (the colours are looked up in small chunks, which can then be blended as a span)
+            PixelARGB colours [32];
+
+            while (width > 0)
+            {
+                const int num = jmin (width, (int) numElementsInArray (colours));
+
+                for (int i = 0; i < num; ++i)
+                    colours[i] = GradientType::getPixel (x++);
+
+                if (alphaLevel < 0xff)
+                    PixelSpans::blend (dest, colours, num, alphaLevel);
+                else
+                    PixelSpans::blend (dest, colours, num);
+
+                dest += num;
+                width -= num;
+            }
+        }
+
         JUCE_DECLARE_NON_COPYABLE (Gradient)
     };
 
+    //==============================================================================
+    /** Combines an edge-table level with an image fill's extra alpha (which is in the range 1 to 256).
+        A full level has to give the same result as handleEdgeTablePixelFull(), otherwise the pixels
+        in a run would come out differently to the same pixels drawn individually, which happens
+        when the run is split by a clip boundary.
+    */
+    static inline int getLineAlpha (const int alphaLevel, const int extraAlpha) noexcept
+    {
+        return alphaLevel >= 0xff ? extraAlpha : ((alphaLevel * extraAlpha) >> 8);
+    }
+
     //==============================================================================
     /** Fills an edge-table with a non-transformed image. */
     template <class DestPixelType, class SrcPixelType, bool repeatPattern>
@@ -819,14 +975,17 @@ namespace EdgeTableFillers
         void handleEdgeTableLine (int x, int width, int alphaLevel) const noexcept
         {
             DestPixelType* dest = getDestPixel (x);
-            alphaLevel = (alphaLevel * extraAlpha) >> 8;
+            alphaLevel = getLineAlpha (alphaLevel, extraAlpha);
             x -= xOffset;
 
             jassert (repeatPattern || (x >= 0 && x + width <= srcData.width));
 
             if (alphaLevel < 0xfe)
             {
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (repeatPattern ? (x++ % srcData.width) : x++), (uint32) alphaLevel))
+                if (repeatPattern)
+                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) alphaLevel))
+                else
+                    blendRow (dest, getSrcPixel (x), width, (uint32) alphaLevel);
             }
             else
             {
@@ -846,7 +1005,10 @@ namespace EdgeTableFillers
 
             if (extraAlpha < 0xfe)
             {
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (repeatPattern ? (x++ % srcData.width) : x++), (uint32) extraAlpha))
+                if (repeatPattern)
+                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) extraAlpha))
+                else
+                    blendRow (dest, getSrcPixel (x), width, (uint32) extraAlpha);
             }
             else
             {
@@ -886,7 +1048,8 @@ namespace EdgeTableFillers
             return addBytesToPointer (sourceLineStart, x * srcData.pixelStride);
         }
 
-        forcedinline void copyRow (DestPixelType* dest, SrcPixelType const* src, int width) const noexcept
+        template <class PixelType1, class PixelType2>
+        forcedinline void copyRow (PixelType1* dest, PixelType2 const* src, int width) const noexcept
         {
             if (srcData.pixelStride == 3 && destData.pixelStride == 3)
             {
@@ -906,6 +1069,36 @@ namespace EdgeTableFillers
             }
         }
 
+        forcedinline void copyRow (PixelARGB* dest, const PixelARGB* src, int width) const noexcept
+        {
+            if (srcData.pixelStride == sizeof (*src) && destData.pixelStride == sizeof (*dest))
+                PixelSpans::blend (dest, src, width);
+            else
+                copyRow<PixelARGB, PixelARGB> (dest, src, width);
+        }
+
+        template <class PixelType1, class PixelType2>
+        forcedinline void blendRow (PixelType1* dest, PixelType2 const* src, int width, const uint32 alpha) const noexcept
+        {
+            const int destStride = destData.pixelStride;
+            const int srcStride = srcData.pixelStride;
+
+            do
+            {
+                dest->blend (*src, alpha);
+                dest = addBytesToPointer (dest, destStride);
+                src = addBytesToPointer (src, srcStride);
+            } while (--width > 0);
+        }
+
+        forcedinline void blendRow (PixelARGB* dest, const PixelARGB* src, int width, const uint32 alpha) const noexcept
+        {
+            if (srcData.pixelStride == sizeof (*src) && destData.pixelStride == sizeof (*dest))
+                PixelSpans::blend (dest, src, width, alpha);
+            else
+                blendRow<PixelARGB, PixelARGB> (dest, src, width, alpha);
+        }
+
         JUCE_DECLARE_NON_COPYABLE (ImageFill)
     };
 
@@ -964,14 +1157,9 @@ namespace EdgeTableFillers
             SrcPixelType* span = scratchBuffer;
             generate (span, x, width);
 
-            DestPixelType* dest = getDestPixel (x);
-            alphaLevel *= extraAlpha;
-            alphaLevel >>= 8;
+            alphaLevel = getLineAlpha (alphaLevel, extraAlpha);
 
-            if (alphaLevel < 0xfe)
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++, (uint32) alphaLevel))
-            else
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++))
+            blendSpan (getDestPixel (x), span, width, (uint32) alphaLevel);
         }
 
         forcedinline void handleEdgeTableLineFull (const int x, int width) noexcept
@@ -1001,6 +1189,25 @@ namespace EdgeTableFillers
             return addBytesToPointer (linePixels, x * destData.pixelStride);
         }
 
+        template <class PixelType1, class PixelType2>
+        void blendSpan (PixelType1* dest, const PixelType2* span, int width, const uint32 alphaLevel) const noexcept
+        {
+            if (alphaLevel < 0xfe)
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++, alphaLevel))
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++))
+        }
+
+        void blendSpan (PixelARGB* dest, const PixelARGB* span, int width, const uint32 alphaLevel) const noexcept
+        {
+            if (destData.pixelStride != sizeof (*dest))
+                blendSpan<PixelARGB, PixelARGB> (dest, span, width, alphaLevel);
+            else if (alphaLevel < 0xfe)
+                PixelSpans::blend (dest, span, width, alphaLevel);
+            else
+                PixelSpans::blend (dest, span, width);
+        }
+
         //==============================================================================
         template <class PixelType>
         void generate (PixelType* dest, const int x, int numPixels) noexcept
@@ -1078,6 +1285,40 @@ namespace EdgeTableFillers
         //==============================================================================
         void render4PixelAverage (PixelARGB* const dest, const uint8* src, const int subPixelX, const int subPixelY) noexcept
         {
+           #if JUCE_RENDERING_USE_SSE2
+            // Each pair of horizontal neighbours is blended with a single madd, and the two rows
+            // are then combined as floats. All the intermediate values are integers below 2^24, so
+            // this gives exactly the same result as the scalar version.
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i xWeights = _mm_set1_epi32 ((subPixelX << 16) | (256 - subPixelX));
+            const uint8* const src2 = src + this->srcData.lineStride;
+
+            const __m128i top    = _mm_madd_epi16 (_mm_unpacklo_epi8 (_mm_unpacklo_epi8 (_mm_cvtsi32_si128 (*(const int*) src),
+                                                                                         _mm_cvtsi32_si128 (*(const int*) (src + this->srcData.pixelStride))),
+                                                                      zero), xWeights);
+            const __m128i bottom = _mm_madd_epi16 (_mm_unpacklo_epi8 (_mm_unpacklo_epi8 (_mm_cvtsi32_si128 (*(const int*) src2),
+                                                                                         _mm_cvtsi32_si128 (*(const int*) (src2 + this->srcData.pixelStride))),
+                                                                      zero), xWeights);
+
+            const __m128 sum = _mm_add_ps (_mm_add_ps (_mm_mul_ps (_mm_cvtepi32_ps (top),    _mm_set1_ps ((float) (256 - subPixelY))),
+                                                       _mm_mul_ps (_mm_cvtepi32_ps (bottom), _mm_set1_ps ((float) subPixelY))),
+                                           _mm_set1_ps (256.0f * 128.0f));
+
+            __m128i c = _mm_srli_epi32 (_mm_cvttps_epi32 (sum), 16);
+            c = _mm_packs_epi32 (c, c);
+            *(int*) dest = _mm_cvtsi128_si32 (_mm_packus_epi16 (c, c));
+           #elif JUCE_RENDERING_USE_NEON
+            const uint8* const src2 = src + this->srcData.lineStride;
+
+            uint32x4_t c = vdupq_n_u32 (256 * 128);
+            c = vmlaq_n_u32 (c, widenPixel (src),                                 (uint32) ((256 - subPixelX) * (256 - subPixelY)));
+            c = vmlaq_n_u32 (c, widenPixel (src + this->srcData.pixelStride),     (uint32) (subPixelX * (256 - subPixelY)));
+            c = vmlaq_n_u32 (c, widenPixel (src2 + this->srcData.pixelStride),    (uint32) (subPixelX * subPixelY));
+            c = vmlaq_n_u32 (c, widenPixel (src2),                                (uint32) ((256 - subPixelX) * subPixelY));
+
+            const uint16x4_t c16 = vmovn_u32 (vshrq_n_u32 (c, 16));
+            vst1_lane_u32 (reinterpret_cast<uint32*> (dest), vreinterpret_u32_u8 (vmovn_u16 (vcombine_u16 (c16, c16))), 0);
+           #else
             uint32 c[4] = { 256 * 128, 256 * 128, 256 * 128, 256 * 128 };
 
             uint32 weight = (uint32) ((256 - subPixelX) * (256 - subPixelY));
@@ -1114,8 +1355,16 @@ namespace EdgeTableFillers
                            (uint8) (c[PixelARGB::indexR] >> 16),
                            (uint8) (c[PixelARGB::indexG] >> 16),
                            (uint8) (c[PixelARGB::indexB] >> 16));
+           #endif
         }
 
+       #if JUCE_RENDERING_USE_NEON
+        static forcedinline uint32x4_t widenPixel (const uint8* const src) noexcept
+        {
+            return vmovl_u16 (vget_low_u16 (vmovl_u8 (vreinterpret_u8_u32 (vdup_n_u32 (*(const uint32*) src)))));
+        }
+       #endif
+
         void render2PixelAverageX (PixelARGB* const dest, const uint8* src, const uint32 subPixelX) noexcept
         {
             uint32 c[4] = { 128, 128, 128, 128 };
@@ -2026,6 +2275,228 @@ namespace ClipRegions
     };
 }
 
+//==============================================================================
+/** Holds a cache of edge tables for paths that are filled repeatedly.
+
+    A path's edge table is only cached when the same path is filled a second time with
+    the same transform (ignoring any whole-pixel translation), so that paths which only
+    get drawn once don't push the useful ones out. The tables are made for the entire
+    path rather than the area being drawn, so they can be shared by different clip
+    regions and positions, and the least-recently used ones are thrown away when their
+    total size goes above the memory limit.
+*/
+class PathEdgeTableCache  : private DeletedAtShutdown
+{
+public:
+    PathEdgeTableCache()
+        : memoryLimit (8 * 1024 * 1024), totalMemory (0), numRecentlySeen (0)
+    {
+        zeromem (recentlySeen, sizeof (recentlySeen));
+    }
+
+    ~PathEdgeTableCache()
+    {
+        getSingletonPointer() = nullptr;
+    }
+
+    static PathEdgeTableCache& getInstance()
+    {
+        PathEdgeTableCache*& c = getSingletonPointer();
+
+        if (c == nullptr)
+            c = new PathEdgeTableCache();
+
+        return *c;
+    }
+
+    //==============================================================================
+    /** Returns a region for a path, using a cached edge table if possible.
+        If the path isn't cached, this returns nullptr, and the caller should build its
+        edge table in the normal way.
+    */
+    ClipRegions::EdgeTableRegion* createRegionFor (const Path& path, const AffineTransform& transform)
+    {
+        if (memoryLimit == 0 || transform.isSingularity())
+            return nullptr;
+
+        // The table is built with only the fractional part of the translation, and then
+        // moved into place, so that the same one can be used wherever the path is drawn.
+        const float wholeX = std::floor (transform.mat02);
+        const float wholeY = std::floor (transform.mat12);
+
+        const Key key (path, AffineTransform (transform.mat00, transform.mat01, transform.mat02 - wholeX,
+                                              transform.mat10, transform.mat11, transform.mat12 - wholeY));
+
+        if (std::abs (wholeX) > 0x3fffff || std::abs (wholeY) > 0x3fffff)
+            return nullptr;
+
+        const int dx = (int) wholeX;
+        const int dy = (int) wholeY;
+
+        ++accessCounter;
+
+        {
+            const ScopedReadLock srl (lock);
+
+            if (Entry* const e = findEntry (key, path))
+                return e->createRegion (accessCounter.value, dx, dy);
+        }
+
+        const ScopedWriteLock swl (lock);
+
+        if (Entry* const e = findEntry (key, path))
+            return e->createRegion (accessCounter.value, dx, dy);
+
+        if (! wasRecentlySeen (key))
+            return nullptr;
+
+        const Rectangle<int> bounds (path.getBoundsTransformed (key.transform).getSmallestIntegerContainer().expanded (1, 0));
+
+        if (bounds.isEmpty())
+            return nullptr;
+
+        ScopedPointer<Entry> e (new Entry (key, path, bounds));
+
+        // (one huge path shouldn't be allowed to flush everything else out of the cache)
+        if (e->memoryUsage > memoryLimit / 8)
+            return nullptr;
+
+        Entry* const newEntry = e.release();
+        entries.add (newEntry);
+        totalMemory += newEntry->memoryUsage;
+        removeOldEntries();
+
+        return newEntry->createRegion (accessCounter.value, dx, dy);
+    }
+
+    /** Sets the maximum number of bytes that the cached edge tables may use.
+        A size of zero disables the cache.
+    */
+    void setMemoryLimit (const size_t newLimit)
+    {
+        const ScopedWriteLock swl (lock);
+        memoryLimit = newLimit;
+        removeOldEntries();
+    }
+
+private:
+    //==============================================================================
+    struct Key
+    {
+        Key (const Path& path, const AffineTransform& t) noexcept
+            : hash (101 * path.hashCode64() + roundToInt (t.mat00 * 1024.0f) + 31 * roundToInt (t.mat11 * 1024.0f)),
+              transform (t)
+        {
+        }
+
+        bool operator== (const Key& other) const noexcept   { return hash == other.hash && transform == other.transform; }
+
+        int64 hash;
+        AffineTransform transform;
+    };
+
+    struct Entry
+    {
+        Entry (const Key& key_, const Path& path_, const Rectangle<int>& bounds)
+            : key (key_), path (path_), edgeTable (bounds, path_, key_.transform), lastAccessCount (0)
+        {
+            edgeTable.optimiseTable();
+            memoryUsage = edgeTable.getMemoryUsage() + sizeof (Entry);
+        }
+
+        ClipRegions::EdgeTableRegion* createRegion (const int accessCount, const int dx, const int dy)
+        {
+            lastAccessCount = accessCount;
+
+            ClipRegions::EdgeTableRegion* const region = new ClipRegions::EdgeTableRegion (edgeTable);
+            region->edgeTable.translate ((float) dx, dy);
+            return region;
+        }
+
+        const Key key;
+        const Path path;
+        EdgeTable edgeTable;
+        size_t memoryUsage;
+        int lastAccessCount;
+
+        JUCE_DECLARE_NON_COPYABLE (Entry)
+    };
+
+    OwnedArray<Entry> entries;
+    ReadWriteLock lock;
+    Atomic<int> accessCounter;
+    size_t memoryLimit, totalMemory;
+
+    enum { maxRecentlySeen = 64 };
+    int64 recentlySeen [maxRecentlySeen]; // the keys of paths that have been drawn but not cached
+    int numRecentlySeen;
+
+    Entry* findEntry (const Key& key, const Path& path) const noexcept
+    {
+        for (int i = entries.size(); --i >= 0;)
+        {
+            Entry* const e = entries.getUnchecked (i);
+
+            if (e->key == key && e->path == path)
+                return e;
+        }
+
+        return nullptr;
+    }
+
+    bool wasRecentlySeen (const Key& key) noexcept
+    {
+        for (int i = 0; i < maxRecentlySeen; ++i)
+            if (recentlySeen[i] == key.hash)
+                return true;
+
+        recentlySeen [numRecentlySeen] = key.hash;
+        numRecentlySeen = (numRecentlySeen + 1) % maxRecentlySeen;
+        return false;
+    }
+
+    void removeOldEntries()
+    {
+        while (totalMemory > memoryLimit && entries.size() > 0)
+        {
+            int oldest = 0;
+
+            for (int i = 1; i < entries.size(); ++i)
+                if (entries.getUnchecked (i)->lastAccessCount < entries.getUnchecked (oldest)->lastAccessCount)
+                    oldest = i;
+
+            totalMemory -= entries.getUnchecked (oldest)->memoryUsage;
+            entries.remove (oldest);
+        }
+    }
+
+    static PathEdgeTableCache*& getSingletonPointer() noexcept
+    {
+        static PathEdgeTableCache* c = nullptr;
+        return c;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PathEdgeTableCache)
+};
+
+//==============================================================================
+/** The pool that's shared by the tiled renderer and the image-processing functions
+    when they split their work between threads.
+
+    The thread that starts a ParallelTask works on it too, so this has one thread
+    fewer than the number of cores. Unlike the caches above, it can be created by
+    any thread, because things like convolution kernels may be applied anywhere.
+*/
+class RenderingThreadPool  : public ThreadPool,
+                             private DeletedAtShutdown
+{
+public:
+    RenderingThreadPool()   : ThreadPool (jmax (1, SystemStats::getNumCpus() - 1)) {}
+    ~RenderingThreadPool()  { clearSingletonInstance(); }
+
+    juce_DeclareSingleton (RenderingThreadPool, false);
+};
+
 //==============================================================================
 class SoftwareRendererSavedState
 {
@@ -2285,7 +2756,12 @@ public:
     void fillPath (const Path& path, const AffineTransform& t)
     {
         if (clip != nullptr)
-            fillShape (new ClipRegions::EdgeTableRegion (clip->getClipBounds(), path, transform.getTransformWith (t)), false);
+        {
+            const AffineTransform trans (transform.getTransformWith (t));
+            ClipRegions::EdgeTableRegion* const cached = PathEdgeTableCache::getInstance().createRegionFor (path, trans);
+
+            fillShape (cached != nullptr ? cached : new ClipRegions::EdgeTableRegion (clip->getClipBounds(), path, trans), false);
+        }
     }
 
     void fillEdgeTable (const EdgeTable& edgeTable, const float x, const int y)
@@ -62,6 +62,11 @@ StringArray FTTypefaceList::getDefaultFontDirectories()
     return StringArray ("/system/fonts");
 }
 
+File FTTypefaceList::getFontIndexFile()
+{
+    return File::getSpecialLocation (File::userApplicationDataDirectory).getChildFile ("fontIndex.xml");
+}
+
 Typeface::Ptr Typeface::createSystemTypefaceFor (const Font& font)
 {
     return new FreeTypeTypeface (font);
@@ -75,13 +75,28 @@ struct FTFaceWrapper     : public ReferenceCountedObject
 class FTTypefaceList  : private DeletedAtShutdown
 {
 public:
-    FTTypefaceList()  : library (new FTLibWrapper())
+    FTTypefaceList()  : library (new FTLibWrapper()), numDefaultFaces (0), hasDefaultFaces (false)
     {
-        scanFontPaths (getDefaultFontDirectories());
+        // If an index of the system fonts was saved by a previous run, its contents are used
+        // straight away, and a background thread checks whether anything has changed since.
+        // Without one, the first caller that needs the list has to wait for the scan to finish.
+        ScopedPointer<XmlElement> index (loadFontIndex());
+
+        if (index != nullptr)
+        {
+            forEachXmlChildElementWithTagName (*index, dirXml, "DIR")
+                addFacesFromIndex (*dirXml, faces);
+
+            numDefaultFaces = faces.size();
+            hasDefaultFaces = true;
+        }
+
+        scanner = new DefaultFontScanner (*this, index.release());
     }
 
     ~FTTypefaceList()
     {
+        scanner = nullptr;
         clearSingletonInstance();
     }
 
@@ -98,6 +113,27 @@ public:
         {
         }
 
+        KnownTypeface (const File& directory, const XmlElement& xml)
+           : file (directory.getChildFile (xml.getStringAttribute ("file"))),
+             family (xml.getStringAttribute ("family")),
+             style (xml.getStringAttribute ("style")),
+             faceIndex (xml.getIntAttribute ("index")),
+             isMonospaced (xml.getBoolAttribute ("mono")),
+             isSansSerif (isFaceSansSerif (family))
+        {
+        }
+
+        XmlElement* createXml() const
+        {
+            XmlElement* const xml = new XmlElement ("FACE");
+            xml->setAttribute ("file", file.getFileName());
+            xml->setAttribute ("index", faceIndex);
+            xml->setAttribute ("family", family);
+            xml->setAttribute ("style", style);
+            xml->setAttribute ("mono", isMonospaced);
+            return xml;
+        }
+
         const File file;
         const String family, style;
         const int faceIndex;
@@ -109,14 +145,28 @@ public:
     //==============================================================================
     FTFaceWrapper::Ptr createFace (const String& fontName, const String& fontStyle)
     {
-        const KnownTypeface* ftFace = matchTypeface (fontName, fontStyle);
+        File file;
+        int faceIndex = 0;
 
-        if (ftFace == nullptr)  ftFace = matchTypeface (fontName, "Regular");
-        if (ftFace == nullptr)  ftFace = matchTypeface (fontName, String::empty);
+        {
+            waitForDefaultFaces();
+            const ScopedLock sl (lock);
+
+            const KnownTypeface* ftFace = matchTypeface (fontName, fontStyle);
+
+            if (ftFace == nullptr)  ftFace = matchTypeface (fontName, "Regular");
+            if (ftFace == nullptr)  ftFace = matchTypeface (fontName, String::empty);
+
+            if (ftFace == nullptr)
+                return nullptr;
+
+            file = ftFace->file;
+            faceIndex = ftFace->faceIndex;
+        }
 
-        if (ftFace != nullptr)
+        if (FTFaceWrapper::Ptr face = new FTFaceWrapper (library, file, faceIndex))
         {
-            if (FTFaceWrapper::Ptr face = new FTFaceWrapper (library, ftFace->file, ftFace->faceIndex))
+            if (face->face != 0)
             {
                 // If there isn't a unicode charmap then select the first one.
                 if (FT_Select_Charmap (face->face, ft_encoding_unicode) != 0)
@@ -132,6 +182,8 @@ public:
     //==============================================================================
     StringArray findAllFamilyNames() const
     {
+        waitForDefaultFaces();
+        const ScopedLock sl (lock);
         StringArray s;
 
         for (int i = 0; i < faces.size(); i++)
@@ -142,6 +194,8 @@ public:
 
     StringArray findAllTypefaceStyles (const String& family) const
     {
+        waitForDefaultFaces();
+        const ScopedLock sl (lock);
         StringArray s;
 
         for (int i = 0; i < faces.size(); i++)
@@ -157,19 +211,28 @@ public:
 
     void scanFontPaths (const StringArray& paths)
     {
+        OwnedArray<KnownTypeface> newFaces;
+
         for (int i = 0; i < paths.size(); ++i)
         {
             DirectoryIterator iter (File::getCurrentWorkingDirectory()
                                        .getChildFile (paths[i]), true);
 
             while (iter.next())
-                if (iter.getFile().hasFileExtension ("ttf;pfb;pcf;otf"))
-                    scanFont (iter.getFile());
+                if (iter.getFile().hasFileExtension (getFontFileExtensions()))
+                    scanFont (library, iter.getFile(), newFaces);
         }
+
+        const ScopedLock sl (lock);
+        faces.addArray (newFaces);
+        newFaces.clear (false);
     }
 
     void getMonospacedNames (StringArray& monoSpaced) const
     {
+        waitForDefaultFaces();
+        const ScopedLock sl (lock);
+
         for (int i = 0; i < faces.size(); i++)
             if (faces.getUnchecked(i)->isMonospaced)
                 monoSpaced.addIfNotAlreadyThere (faces.getUnchecked(i)->family);
@@ -177,6 +240,9 @@ public:
 
     void getSerifNames (StringArray& serif) const
     {
+        waitForDefaultFaces();
+        const ScopedLock sl (lock);
+
         for (int i = 0; i < faces.size(); i++)
             if (! faces.getUnchecked(i)->isSansSerif)
                 serif.addIfNotAlreadyThere (faces.getUnchecked(i)->family);
@@ -184,6 +250,9 @@ public:
 
     void getSansSerifNames (StringArray& sansSerif) const
     {
+        waitForDefaultFaces();
+        const ScopedLock sl (lock);
+
         for (int i = 0; i < faces.size(); i++)
             if (faces.getUnchecked(i)->isSansSerif)
                 sansSerif.addIfNotAlreadyThere (faces.getUnchecked(i)->family);
@@ -192,19 +261,197 @@ public:
     juce_DeclareSingleton_SingleThreaded_Minimal (FTTypefaceList);
 
 private:
+    //==============================================================================
+    /** Walks the default font directories, and re-reads the fonts in any directory that
+        has been modified since the index was last saved.
+    */
+    class DefaultFontScanner  : public Thread
+    {
+    public:
+        DefaultFontScanner (FTTypefaceList& owner_, XmlElement* oldIndex_)
+            : Thread ("JUCE font scanner"),
+              owner (owner_), oldIndex (oldIndex_), anythingChanged (oldIndex_ == nullptr)
+        {
+            if (oldIndex != nullptr)
+                forEachXmlChildElementWithTagName (*oldIndex, dirXml, "DIR")
+                    oldDirectories.set (dirXml->getStringAttribute ("path"), dirXml);
+
+            startThread (2);
+        }
+
+        ~DefaultFontScanner()
+        {
+            stopThread (10000);
+        }
+
+        void run()
+        {
+            const FTLibWrapper::Ptr scanLibrary (new FTLibWrapper()); // (FreeType libraries can't be shared between threads)
+            XmlElement newIndex ("FONTINDEX");
+            newIndex.setAttribute ("version", fontIndexVersion);
+            OwnedArray<KnownTypeface> newFaces;
+
+            const StringArray paths (getDefaultFontDirectories());
+
+            for (int i = 0; i < paths.size(); ++i)
+            {
+                const File dir (File::getCurrentWorkingDirectory().getChildFile (paths[i]));
+
+                if (dir.isDirectory()
+                     && ! scanDirectory (scanLibrary, dir, dir.getLastModificationTime(), newIndex, newFaces))
+                    return;
+            }
+
+            if (oldIndex != nullptr && newIndex.getNumChildElements() != oldIndex->getNumChildElements())
+                anythingChanged = true;  // (some directories have been removed)
+
+            if (anythingChanged)
+            {
+                const File indexFile (getFontIndexFile());
+                indexFile.getParentDirectory().createDirectory();
+                newIndex.writeToFile (indexFile, String::empty);
+
+                owner.setDefaultFaces (newFaces);
+            }
+        }
+
+    private:
+        FTTypefaceList& owner;
+        ScopedPointer<XmlElement> oldIndex;
+        HashMap<String, XmlElement*> oldDirectories;
+        bool anythingChanged;
+
+        bool scanDirectory (const FTLibWrapper::Ptr& scanLibrary, const File& dir, const Time& modTime,
+                            XmlElement& newIndex, OwnedArray<KnownTypeface>& newFaces)
+        {
+            const String modTimeString (String (modTime.toMilliseconds()));
+
+            XmlElement* const dirXml = newIndex.createNewChildElement ("DIR");
+            dirXml->setAttribute ("path", dir.getFullPathName());
+            dirXml->setAttribute ("modified", modTimeString);
+
+            // Any change to a directory's list of files updates its modification time, so if
+            // that hasn't changed, the faces recorded for it last time can be used again.
+            const XmlElement* const oldDirXml = oldDirectories [dir.getFullPathName()];
+            const bool isUpToDate = oldDirXml != nullptr
+                                     && oldDirXml->getStringAttribute ("modified") == modTimeString;
+
+            if (isUpToDate)
+            {
+                forEachXmlChildElementWithTagName (*oldDirXml, faceXml, "FACE")
+                    dirXml->addChildElement (new XmlElement (*faceXml));
+
+                addFacesFromIndex (*dirXml, newFaces);
+            }
+            else
+            {
+                anythingChanged = true;
+            }
+
+            DirectoryIterator iter (dir, false, "*", isUpToDate ? File::findDirectories
+                                                                : File::findFilesAndDirectories);
+            bool isDirectory = false;
+            Time childModTime;
+
+            while (iter.next (&isDirectory, nullptr, nullptr, &childModTime, nullptr, nullptr))
+            {
+                if (threadShouldExit())
+                    return false;
+
+                const File child (iter.getFile());
+
+                if (isDirectory)
+                {
+                    if (! scanDirectory (scanLibrary, child, childModTime, newIndex, newFaces))
+                        return false;
+                }
+                else if (child.hasFileExtension (getFontFileExtensions()))
+                {
+                    const int firstNewFace = newFaces.size();
+                    scanFont (scanLibrary, child, newFaces);
+
+                    for (int i = firstNewFace; i < newFaces.size(); ++i)
+                        dirXml->addChildElement (newFaces.getUnchecked(i)->createXml());
+                }
+            }
+
+            return true;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (DefaultFontScanner)
+    };
+
+    //==============================================================================
+    enum { fontIndexVersion = 1 };
+
     FTLibWrapper::Ptr library;
+    CriticalSection lock;
     OwnedArray<KnownTypeface> faces;
+    int numDefaultFaces;  // (the faces from the default directories come first in the array)
+    bool hasDefaultFaces;
+    ScopedPointer<DefaultFontScanner> scanner;
 
     static StringArray getDefaultFontDirectories();
+    static File getFontIndexFile();
+
+    static const char* getFontFileExtensions() noexcept     { return "ttf;pfb;pcf;otf"; }
+
+    void waitForDefaultFaces() const
+    {
+        bool needToWait;
+
+        {
+            const ScopedLock sl (lock);
+            needToWait = ! hasDefaultFaces;
+        }
+
+        if (needToWait)
+            scanner->waitForThreadToExit (-1);
+    }
+
+    void setDefaultFaces (OwnedArray<KnownTypeface>& newFaces)
+    {
+        const ScopedLock sl (lock);
+
+        faces.removeRange (0, numDefaultFaces);
+        numDefaultFaces = newFaces.size();
+
+        // keep any faces that were added by scanFolderForFonts() after the new default ones
+        newFaces.addArray (faces);
+        faces.clear (false);
+        faces.swapWithArray (newFaces);
+
+        hasDefaultFaces = true;
+    }
+
+    static XmlElement* loadFontIndex()
+    {
+        ScopedPointer<XmlElement> index (XmlDocument::parse (getFontIndexFile()));
+
+        if (index != nullptr
+             && index->hasTagName ("FONTINDEX")
+             && index->getIntAttribute ("version") == fontIndexVersion)
+            return index.release();
+
+        return nullptr;
+    }
+
+    static void addFacesFromIndex (const XmlElement& dirXml, OwnedArray<KnownTypeface>& facesToAddTo)
+    {
+        const File dir (dirXml.getStringAttribute ("path"));
+
+        forEachXmlChildElementWithTagName (dirXml, faceXml, "FACE")
+            facesToAddTo.add (new KnownTypeface (dir, *faceXml));
+    }
 
-    void scanFont (const File& file)
+    static void scanFont (const FTLibWrapper::Ptr& scanLibrary, const File& file, OwnedArray<KnownTypeface>& facesToAddTo)
     {
         int faceIndex = 0;
         int numFaces = 0;
 
         do
         {
-            FTFaceWrapper face (library, file, faceIndex);
+            FTFaceWrapper face (scanLibrary, file, faceIndex);
 
             if (face.face != 0)
             {
@@ -212,7 +459,7 @@ private:
                     numFaces = face.face->num_faces;
 
                 if ((face.face->face_flags & FT_FACE_FLAG_SCALABLE) != 0)
-                    faces.add (new KnownTypeface (file, faceIndex, face));
+                    facesToAddTo.add (new KnownTypeface (file, faceIndex, face));
             }
 
             ++faceIndex;
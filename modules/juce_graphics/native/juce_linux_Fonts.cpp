@@ -65,6 +65,16 @@ StringArray FTTypefaceList::getDefaultFontDirectories()
     return fontDirs;
 }
 
+File FTTypefaceList::getFontIndexFile()
+{
+    String cacheDir (SystemStats::getEnvironmentVariable ("XDG_CACHE_HOME", String::empty));
+
+    if (cacheDir.trimStart().isEmpty())
+        cacheDir = "~/.cache";
+
+    return File (cacheDir).getChildFile ("juce").getChildFile ("fontIndex.xml");
+}
+
 Typeface::Ptr Typeface::createSystemTypefaceFor (const Font& font)
 {
     return new FreeTypeTypeface (font);
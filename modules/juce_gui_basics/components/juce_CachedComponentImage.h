@@ -49,6 +49,10 @@ public:
     /** Called as part of the parent component's paint method, this must draw
         the given component into the target graphics context, using the cached
         version where possible.
+
+        The component's alpha level and transform aren't part of what's cached - changing
+        them doesn't invalidate the cache, so this should apply the component's current
+        alpha level when it draws.
     */
     virtual void paint (Graphics&) = 0;
 
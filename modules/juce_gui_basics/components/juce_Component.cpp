@@ -233,6 +233,22 @@ struct Component::ComponentHelpers
         return (areaInLocalSpace + comp.getPosition()).toFloat().transformed (*comp.affineTransform).getSmallestIntegerContainer();
     }
 
+    // Repaints the area that a component covers without invalidating its cached image, for
+    // changes like a new transform or alpha level which don't affect what's in the cache.
+    static void repaintWithoutInvalidatingCache (Component& comp)
+    {
+        if (comp.cachedImage != nullptr && comp.parentComponent != nullptr
+             && ! comp.flags.hasHeavyweightPeerFlag)
+        {
+            if (comp.flags.visibleFlag)
+                comp.repaintParent();
+        }
+        else
+        {
+            comp.repaint();
+        }
+    }
+
     template <typename Type>
     static Type convertFromDistantParentSpace (const Component* parent, const Component& target, const Type& coordInParent)
     {
@@ -365,6 +381,227 @@ struct Component::ComponentHelpers
     }
 };
 
+//==============================================================================
+/*  A coarse grid over a component's area, in which each cell lists (in z-order) the
+    children whose bounds overlap it. Child bounds changes are applied to it incrementally,
+    but anything that changes the child list or the parent's size just marks it as invalid,
+    and it gets rebuilt the next time it's needed.
+*/
+class Component::ChildSpatialIndex
+{
+public:
+    ChildSpatialIndex (Component& owner_)
+        : owner (owner_), cellSize (1), numColumns (0), numRows (0), isValid (false)
+    {
+    }
+
+    void invalidate() noexcept
+    {
+        isValid = false;
+    }
+
+    void childBoundsChanged (Component& child)
+    {
+        if (isValid)
+        {
+            if (Entry* const e = findEntry (&child))
+            {
+                const Rectangle<int> newArea (getAreaOf (child));
+
+                if (newArea != e->area)
+                {
+                    removeFromCells (e->zOrder, e->area);
+                    e->area = newArea;
+                    addToCells (e->zOrder, newArea);
+                }
+            }
+            else
+            {
+                jassertfalse;
+                isValid = false;
+            }
+        }
+    }
+
+    Component* getComponentAt (Point<int> position)
+    {
+        if (const Array<int>* const cell = getCellAt (position))
+        {
+            for (int i = cell->size(); --i >= 0;)
+            {
+                Component* child = owner.childComponentList.getUnchecked (cell->getUnchecked (i));
+                child = child->getComponentAt (ComponentHelpers::convertFromParentSpace (*child, position));
+
+                if (child != nullptr)
+                    return child;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool isAnyChildHitAt (Point<int> position)
+    {
+        if (const Array<int>* const cell = getCellAt (position))
+        {
+            for (int i = cell->size(); --i >= 0;)
+            {
+                Component& child = *owner.childComponentList.getUnchecked (cell->getUnchecked (i));
+
+                if (child.isVisible()
+                     && ComponentHelpers::hitTest (child, ComponentHelpers::convertFromParentSpace (child, position)))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    struct Entry
+    {
+        Component* component;
+        int zOrder;
+        Rectangle<int> area;
+    };
+
+    struct EntryComparator
+    {
+        static int compareElements (const Entry& first, const Entry& second) noexcept
+        {
+            return first.component < second.component ? -1 : (second.component < first.component ? 1 : 0);
+        }
+    };
+
+    Component& owner;
+    Array<Entry> entries;           // sorted by component pointer
+    Array<Array<int> > cells;
+    int cellSize, numColumns, numRows;
+    bool isValid;
+
+    enum { maxNumCells = 4096, minCellSize = 16 };
+
+    const Array<int>* getCellAt (Point<int> position)
+    {
+        if (! isValid)
+            rebuild();
+
+        if (isPositiveAndBelow (position.x, owner.getWidth())
+             && isPositiveAndBelow (position.y, owner.getHeight()))
+        {
+            const int column = jmin (numColumns - 1, position.x / cellSize);
+            const int row    = jmin (numRows - 1,    position.y / cellSize);
+            return &cells.getReference (row * numColumns + column);
+        }
+
+        return nullptr;
+    }
+
+    Rectangle<int> getAreaOf (const Component& child) const noexcept
+    {
+        Rectangle<int> area (child.getBoundsInParent());
+
+        if (child.isTransformed())
+            area.expand (1, 1);   // the transformed corners can be rounded either way when hit-testing
+
+        return area.getIntersection (owner.getLocalBounds());
+    }
+
+    void getCellRange (const Rectangle<int>& area, int& x1, int& y1, int& x2, int& y2) const noexcept
+    {
+        x1 = area.getX() / cellSize;
+        y1 = area.getY() / cellSize;
+        x2 = jmin (numColumns, (area.getRight()  + cellSize - 1) / cellSize);
+        y2 = jmin (numRows,    (area.getBottom() + cellSize - 1) / cellSize);
+    }
+
+    void addToCells (const int zOrder, const Rectangle<int>& area)
+    {
+        if (! area.isEmpty())
+        {
+            int x1, y1, x2, y2;
+            getCellRange (area, x1, y1, x2, y2);
+
+            for (int y = y1; y < y2; ++y)
+                for (int x = x1; x < x2; ++x)
+                    cells.getReference (y * numColumns + x).addUsingDefaultSort (zOrder);
+        }
+    }
+
+    void removeFromCells (const int zOrder, const Rectangle<int>& area)
+    {
+        if (! area.isEmpty())
+        {
+            int x1, y1, x2, y2;
+            getCellRange (area, x1, y1, x2, y2);
+            DefaultElementComparator<int> comparator;
+
+            for (int y = y1; y < y2; ++y)
+            {
+                for (int x = x1; x < x2; ++x)
+                {
+                    Array<int>& cell = cells.getReference (y * numColumns + x);
+                    cell.remove (cell.indexOfSorted (comparator, zOrder));
+                }
+            }
+        }
+    }
+
+    Entry* findEntry (const Component* const child) noexcept
+    {
+        int start = 0, end = entries.size();
+
+        while (start < end)
+        {
+            const int mid = (start + end) / 2;
+            Entry& e = entries.getReference (mid);
+
+            if (e.component == child)
+                return &e;
+
+            if (e.component < child)
+                start = mid + 1;
+            else
+                end = mid;
+        }
+
+        return nullptr;
+    }
+
+    void rebuild()
+    {
+        const int numChildren = owner.childComponentList.size();
+        const int w = owner.getWidth(), h = owner.getHeight();
+        const int targetNumCells = jlimit (1, (int) maxNumCells, numChildren / 2);
+
+        cellSize = jmax ((int) minCellSize, roundToInt (std::sqrt (w * (double) h / targetNumCells)));
+        numColumns = jmax (1, (w + cellSize - 1) / cellSize);
+        numRows    = jmax (1, (h + cellSize - 1) / cellSize);
+
+        cells.clear();
+        cells.insertMultiple (0, Array<int>(), numColumns * numRows);
+        entries.clearQuick();
+        entries.ensureStorageAllocated (numChildren);
+
+        for (int i = 0; i < numChildren; ++i)
+        {
+            Entry e;
+            e.component = owner.childComponentList.getUnchecked (i);
+            e.zOrder = i;
+            e.area = getAreaOf (*e.component);
+            entries.add (e);
+
+            addToCells (i, e.area);
+        }
+
+        EntryComparator comparator;
+        entries.sort (comparator);
+        isValid = true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ChildSpatialIndex)
+};
+
 //==============================================================================
 Component::Component()
   : parentComponent (nullptr),
@@ -741,6 +978,57 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StandardCachedComponentImage)
 };
 
+//==============================================================================
+class DisplayListCachedComponentImage  : public CachedComponentImage
+{
+public:
+    DisplayListCachedComponentImage (Component& c) noexcept : owner (c), isValid (false) {}
+
+    void paint (Graphics& g)
+    {
+        const Rectangle<int> bounds (owner.getLocalBounds());
+
+        if (! (isValid && recordedBounds == bounds))
+        {
+            displayList.clear();
+
+            {
+                DisplayList::Recorder recorder (displayList, bounds);
+                Graphics recorderG (&recorder);
+                owner.paintEntireComponent (recorderG, true);
+            }
+
+            recordedBounds = bounds;
+            isValid = true;
+        }
+
+        const float alpha = owner.getAlpha();
+
+        if (alpha < 1.0f)
+        {
+            g.beginTransparencyLayer (alpha);
+            displayList.draw (g.getInternalContext());
+            g.endTransparencyLayer();
+        }
+        else
+        {
+            displayList.draw (g.getInternalContext());
+        }
+    }
+
+    void invalidateAll()                        { isValid = false; }
+    void invalidate (const Rectangle<int>&)     { isValid = false; }
+    void releaseResources()                     { displayList.clear(); isValid = false; }
+
+private:
+    DisplayList displayList;
+    Rectangle<int> recordedBounds;
+    Component& owner;
+    bool isValid;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DisplayListCachedComponentImage)
+};
+
 void Component::setCachedComponentImage (CachedComponentImage* newCachedImage)
 {
     if (cachedImage != newCachedImage)
@@ -769,6 +1057,24 @@ void Component::setBufferedToImage (const bool shouldBeBuffered)
     }
 }
 
+void Component::setBufferedToDisplayList (const bool shouldBeBuffered)
+{
+    // This assertion means that this component is already using a different CachedComponentImage
+    // (possibly because setBufferedToImage() has been called), which would be deleted by this call.
+    // If that's what you want, call setCachedComponentImage (nullptr) first.
+    jassert (cachedImage == nullptr || dynamic_cast <DisplayListCachedComponentImage*> (cachedImage.get()) != nullptr);
+
+    if (shouldBeBuffered)
+    {
+        if (cachedImage == nullptr)
+            cachedImage = new DisplayListCachedComponentImage (*this);
+    }
+    else
+    {
+        cachedImage = nullptr;
+    }
+}
+
 //==============================================================================
 void Component::reorderChildInternal (const int sourceIndex, const int destIndex)
 {
@@ -780,6 +1086,9 @@ void Component::reorderChildInternal (const int sourceIndex, const int destIndex
 
         childComponentList.move (sourceIndex, destIndex);
 
+        if (childSpatialIndex != nullptr)
+            childSpatialIndex->invalidate();
+
         sendFakeMouseMove();
         internalChildrenChanged();
     }
@@ -1005,6 +1314,215 @@ Point<int> Component::relativePositionToOtherComponent (const Component* const t
 
 
 //==============================================================================
+//==============================================================================
+class Component::LayoutTransaction::PendingChanges
+{
+public:
+    PendingChanges() noexcept  : depth (0), needsAnotherPass (false) {}
+
+    static PendingChanges& getInstance()
+    {
+        static PendingChanges instance;
+        return instance;
+    }
+
+    // Must be called before the component's bounds are changed
+    void boundsAboutToChange (Component& comp, const bool wasMoved, const bool wasResized)
+    {
+        if (indexes.contains (&comp))
+        {
+            Item& item = items.getReference (indexes [&comp]);
+
+            // (if the component's been deleted and a new one created at the same address,
+            // the old entry is left to repaint its old area, and the new one gets its own)
+            if (item.component == &comp)
+            {
+                item.moved       = item.moved       || wasMoved;
+                item.resized     = item.resized     || wasResized;
+                item.everResized = item.everResized || wasResized;
+                needsAnotherPass = true;
+                return;
+            }
+        }
+
+        Item item;
+        item.component = &comp;
+        item.originalParent = comp.parentComponent;
+        item.originalArea = comp.getBoundsInParent();
+        item.moved = wasMoved;
+        item.resized = item.everResized = wasResized;
+
+        indexes.set (&comp, items.size());
+        items.add (item);
+        needsAnotherPass = true;
+    }
+
+    void commit()
+    {
+        // The callbacks are sent with a transaction still open, so that any layout
+        // which they do gets batched up as well..
+        ++depth;
+
+        while (needsAnotherPass)
+        {
+            needsAnotherPass = false;
+
+            for (int i = 0; i < items.size(); ++i)
+            {
+                Item& item = items.getReference (i);
+                Component* const comp = item.component;
+                const bool wasMoved = item.moved, wasResized = item.resized;
+                item.moved = item.resized = false;
+
+                if (comp != nullptr && (wasMoved || wasResized))
+                    comp->sendMovedResizedMessages (wasMoved, wasResized);
+            }
+        }
+
+        --depth;
+
+        if (items.size() > 0)
+        {
+            repaintChangedAreas();
+            items.clearQuick();
+            indexes.clear();
+
+            MouseInputSource& mainMouse = Desktop::getInstance().getMainMouseSource();
+
+            if (! mainMouse.isDragging())
+                mainMouse.triggerFakeMove();
+        }
+    }
+
+    int depth;
+
+private:
+    struct Item
+    {
+        WeakReference<Component> component, originalParent;
+        Rectangle<int> originalArea;
+        bool moved, resized, everResized;
+    };
+
+    struct RepaintArea
+    {
+        Component* parent;
+        RectangleList area;
+    };
+
+    struct ComponentHash
+    {
+        static int generateHash (Component* const comp, const int upperLimit) noexcept
+        {
+            return (int) ((((pointer_sized_uint) comp) >> 3) % (pointer_sized_uint) upperLimit);
+        }
+    };
+
+    Array<Item> items;
+    FlatHashMap<Component*, int, ComponentHash> indexes;
+    bool needsAnotherPass;
+
+    // Above this many rectangles, a parent's area is just repainted as one block (the peer
+    // merges small rectangles itself, so this only stops huge layouts building long lists)
+    enum { maxRectanglesPerParent = 32 };
+
+    static void addArea (Array<RepaintArea>& areas, FlatHashMap<Component*, int, ComponentHash>& areaIndexes,
+                         Component* const parent, const Rectangle<int>& area)
+    {
+        if (parent == nullptr || area.isEmpty())
+            return;
+
+        if (! areaIndexes.contains (parent))
+        {
+            RepaintArea newArea;
+            newArea.parent = parent;
+            areaIndexes.set (parent, areas.size());
+            areas.add (newArea);
+        }
+
+        RectangleList& list = areas.getReference (areaIndexes [parent]).area;
+
+        if (list.getNumRectangles() < maxRectanglesPerParent)
+        {
+            list.addWithoutMerging (area);
+        }
+        else
+        {
+            const Rectangle<int> total (list.getBounds().getUnion (area));
+            list.clear();
+            list.addWithoutMerging (total);
+        }
+    }
+
+    bool hasChanged (Component* const comp) const
+    {
+        return indexes.contains (comp) && items.getReference (indexes [comp]).component == comp;
+    }
+
+    void repaintChangedAreas()
+    {
+        Array<RepaintArea> areas;
+        FlatHashMap<Component*, int, ComponentHash> areaIndexes;
+
+        for (int i = 0; i < items.size(); ++i)
+        {
+            const Item& item = items.getReference (i);
+
+            addArea (areas, areaIndexes, item.originalParent, item.originalArea);
+
+            if (Component* const comp = item.component)
+            {
+                if (comp->cachedImage != nullptr && (item.everResized || ! comp->isShowing()))
+                    comp->cachedImage->invalidateAll();
+
+                addArea (areas, areaIndexes, comp->parentComponent, comp->getBoundsInParent());
+            }
+        }
+
+        for (int i = 0; i < areas.size(); ++i)
+        {
+            const RepaintArea& r = areas.getReference (i);
+
+            if (hasChanged (r.parent))
+            {
+                // This component is being repainted as a whole within its own parent, so
+                // the changes to its children only need to reach its cached image.
+                if (r.parent->cachedImage != nullptr)
+                    for (const Rectangle<int>* rect = r.area.begin(), * const e = r.area.end(); rect != e; ++rect)
+                        r.parent->cachedImage->invalidate (*rect);
+            }
+            else
+            {
+                for (const Rectangle<int>* rect = r.area.begin(), * const e = r.area.end(); rect != e; ++rect)
+                    r.parent->internalRepaint (*rect);
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (PendingChanges)
+};
+
+Component::LayoutTransaction::LayoutTransaction()
+{
+    // Layout transactions can only be used on the message thread!
+    jassert (MessageManager::getInstance()->isThisTheMessageThread());
+
+    ++PendingChanges::getInstance().depth;
+}
+
+Component::LayoutTransaction::~LayoutTransaction()
+{
+    PendingChanges& changes = PendingChanges::getInstance();
+
+    if (--changes.depth == 0)
+        changes.commit();
+}
+
+bool Component::LayoutTransaction::isActive() noexcept
+{
+    return PendingChanges::getInstance().depth > 0;
+}
+
 void Component::setBounds (const int x, const int y, int w, int h)
 {
     // if component methods are being called from threads other than the message
@@ -1024,6 +1542,14 @@ void Component::setBounds (const int x, const int y, int w, int h)
 
     if (wasMoved || wasResized)
     {
+        if (LayoutTransaction::isActive() && ! flags.hasHeavyweightPeerFlag)
+        {
+            LayoutTransaction::PendingChanges::getInstance().boundsAboutToChange (*this, wasMoved, wasResized);
+            bounds.setBounds (x, y, w, h);
+            updateSpatialIndexes (wasResized);
+            return;
+        }
+
         const bool showing = isShowing();
         if (showing)
         {
@@ -1035,6 +1561,7 @@ void Component::setBounds (const int x, const int y, int w, int h)
         }
 
         bounds.setBounds (x, y, w, h);
+        updateSpatialIndexes (wasResized);
 
         if (showing)
         {
@@ -1224,25 +1751,28 @@ void Component::setTransform (const AffineTransform& newTransform)
     {
         if (affineTransform != nullptr)
         {
-            repaint();
+            ComponentHelpers::repaintWithoutInvalidatingCache (*this);
             affineTransform = nullptr;
-            repaint();
+            updateSpatialIndexes (false);
+            ComponentHelpers::repaintWithoutInvalidatingCache (*this);
 
             sendMovedResizedMessages (false, false);
         }
     }
     else if (affineTransform == nullptr)
     {
-        repaint();
+        ComponentHelpers::repaintWithoutInvalidatingCache (*this);
         affineTransform = new AffineTransform (newTransform);
-        repaint();
+        updateSpatialIndexes (false);
+        ComponentHelpers::repaintWithoutInvalidatingCache (*this);
         sendMovedResizedMessages (false, false);
     }
     else if (*affineTransform != newTransform)
     {
-        repaint();
+        ComponentHelpers::repaintWithoutInvalidatingCache (*this);
         *affineTransform = newTransform;
-        repaint();
+        updateSpatialIndexes (false);
+        ComponentHelpers::repaintWithoutInvalidatingCache (*this);
         sendMovedResizedMessages (false, false);
     }
 }
@@ -1252,6 +1782,27 @@ AffineTransform Component::getTransform() const
     return affineTransform != nullptr ? *affineTransform : AffineTransform::identity;
 }
 
+//==============================================================================
+void Component::setUsesSpatialIndexForChildren (const bool shouldUseIndex)
+{
+    if (shouldUseIndex != usesSpatialIndexForChildren())
+        childSpatialIndex = shouldUseIndex ? new ChildSpatialIndex (*this) : nullptr;
+}
+
+bool Component::usesSpatialIndexForChildren() const noexcept
+{
+    return childSpatialIndex != nullptr;
+}
+
+void Component::updateSpatialIndexes (const bool wasResized)
+{
+    if (parentComponent != nullptr && parentComponent->childSpatialIndex != nullptr)
+        parentComponent->childSpatialIndex->childBoundsChanged (*this);
+
+    if (wasResized && childSpatialIndex != nullptr)
+        childSpatialIndex->invalidate();
+}
+
 //==============================================================================
 bool Component::hitTest (int x, int y)
 {
@@ -1260,6 +1811,10 @@ bool Component::hitTest (int x, int y)
 
     if (flags.allowChildMouseClicksFlag)
     {
+        // (the index only covers this component's own area, but children can poke out of it)
+        if (childSpatialIndex != nullptr && getLocalBounds().contains (x, y))
+            return childSpatialIndex->isAnyChildHitAt (Point<int> (x, y));
+
         for (int i = childComponentList.size(); --i >= 0;)
         {
             Component& child = *childComponentList.getUnchecked (i);
@@ -1317,6 +1872,14 @@ Component* Component::getComponentAt (Point<int> position)
 {
     if (flags.visibleFlag && ComponentHelpers::hitTest (*this, position))
     {
+        if (childSpatialIndex != nullptr)
+        {
+            if (Component* const child = childSpatialIndex->getComponentAt (position))
+                return child;
+
+            return this;
+        }
+
         for (int i = childComponentList.size(); --i >= 0;)
         {
             Component* child = childComponentList.getUnchecked(i);
@@ -1372,6 +1935,9 @@ void Component::addChildComponent (Component* const child, int zOrder)
 
         childComponentList.insert (zOrder, child);
 
+        if (childSpatialIndex != nullptr)
+            childSpatialIndex->invalidate();
+
         child->internalHierarchyChanged();
         internalChildrenChanged();
     }
@@ -1428,6 +1994,9 @@ Component* Component::removeChildComponent (const int index, bool sendParentEven
         childComponentList.remove (index);
         child->parentComponent = nullptr;
 
+        if (childSpatialIndex != nullptr)
+            childSpatialIndex->invalidate();
+
         if (child->cachedImage != nullptr)
             child->cachedImage->releaseResources();
 
@@ -1734,7 +2303,7 @@ void Component::setAlpha (const float newAlpha)
         }
         else
         {
-            repaint();
+            ComponentHelpers::repaintWithoutInvalidatingCache (*this);
         }
     }
 }
@@ -594,6 +594,54 @@ public:
     */
     void centreWithSize (int width, int height);
 
+    //==============================================================================
+    /** Holds back the callbacks and repaints caused by moving and resizing components.
+
+        While one of these objects exists, setBounds() (and all the other methods that move
+        or resize a component) still changes the component's position straight away, but
+        the repaints, the moved(), resized(), parentSizeChanged() and childBoundsChanged()
+        callbacks, and the ComponentListener notifications are deferred. When the last
+        transaction ends, each component that changed gets its callbacks once, and the areas
+        that all the components left and moved into are repainted together, instead of as
+        two separate repaints for every call.
+
+        This is useful in a resized() method that lays out a large number of children:
+        @code
+        void resized()
+        {
+            const Component::LayoutTransaction transaction;
+
+            for (int i = 0; i < items.size(); ++i)
+                items.getUnchecked (i)->setBounds (getItemArea (i));
+        }
+        @endcode
+
+        Any moving and resizing that the deferred callbacks do is batched up too. Transactions
+        can be nested, in which case only the outermost one has any effect when it ends.
+        They can only be used on the message thread, and components that are on the desktop
+        are always moved immediately.
+    */
+    class JUCE_API  LayoutTransaction
+    {
+    public:
+        /** Starts a transaction. */
+        LayoutTransaction();
+
+        /** Ends the transaction, and if it's the outermost one, sends all the pending
+            callbacks and repaints.
+        */
+        ~LayoutTransaction();
+
+        /** Returns true if a transaction is currently in progress. */
+        static bool isActive() noexcept;
+
+    private:
+        class PendingChanges;
+        friend class Component;
+
+        JUCE_DECLARE_NON_COPYABLE (LayoutTransaction)
+    };
+
     //==============================================================================
     /** Sets a transform matrix to be applied to this component.
 
@@ -932,6 +980,25 @@ public:
     */
     Component* getComponentAt (Point<int> position);
 
+    /** Makes this component keep a spatial index of its children, to speed up hit-testing.
+
+        Normally getComponentAt() has to check each child in turn to find the one under a
+        point, which gets slow when a component has thousands of children (e.g. the clips
+        in a timeline). When this is enabled, the component keeps a grid recording which
+        children overlap each part of its area, so only the ones near the point are tested.
+        The results are exactly the same, including the z-order of overlapping children.
+
+        The grid is updated as children are moved, and rebuilt lazily after children are
+        added, removed or re-ordered, or when this component is resized, so it's only worth
+        the extra bookkeeping for components with a large number of children.
+
+        @see usesSpatialIndexForChildren, getComponentAt
+    */
+    void setUsesSpatialIndexForChildren (bool shouldUseIndex);
+
+    /** Returns true if setUsesSpatialIndexForChildren() has been used to enable the index. */
+    bool usesSpatialIndexForChildren() const noexcept;
+
     //==============================================================================
     /** Marks the whole component as needing to be redrawn.
 
@@ -998,10 +1065,30 @@ public:
         method is drawn into the buffer, it's child components are not buffered, and
         nor is the paintOverChildren() method.
 
-        @see repaint, paint, createComponentSnapshot
+        For very large components, a TiledCachedComponentImage may be a better choice,
+        as it only redraws the parts of the buffer that have been repainted, and can
+        release the parts that aren't on screen.
+
+        @see repaint, paint, createComponentSnapshot, TiledCachedComponentImage
     */
     void setBufferedToImage (bool shouldBeBuffered);
 
+    /** Makes the component keep a recording of its drawing operations, to optimise its redrawing.
+
+        This is similar to setBufferedToImage(), but instead of an image, the component
+        records the operations that its painting performs into a DisplayList, and replays
+        them when it needs redrawing. This means that the paint() methods of the component
+        and its children only get called again after repaint() or resizing has invalidated
+        the recording, but because the list is drawn as vectors, it stays sharp at any scale
+        or transform, and uses much less memory than an image would.
+
+        The recording is made with the component's bounds as its clip region, so any drawing
+        that spills outside the component (see setPaintingIsUnclipped) won't be replayed.
+
+        @see setBufferedToImage, DisplayList
+    */
+    void setBufferedToDisplayList (bool shouldBeBuffered);
+
     /** Generates a snapshot of part of this component.
 
         This will return a new Image, the size of the rectangle specified,
@@ -2247,6 +2334,11 @@ private:
     friend class MouseListenerList;
     friend class ScopedPointer <MouseListenerList>;
     ScopedPointer <MouseListenerList> mouseListeners;
+    class ChildSpatialIndex;
+    friend class ChildSpatialIndex;
+    friend class ScopedPointer <ChildSpatialIndex>;
+    ScopedPointer <ChildSpatialIndex> childSpatialIndex;
+    friend class LayoutTransaction;
     ScopedPointer <Array <KeyListener*> > keyListeners;
     ListenerList <ComponentListener> componentListeners;
     NamedValueSet properties;
@@ -2308,6 +2400,7 @@ private:
     void internalRepaintUnchecked (const Rectangle<int>&, bool);
     Component* removeChildComponent (int index, bool sendParentEvents, bool sendChildEvents);
     void reorderChildInternal (int sourceIndex, int destIndex);
+    void updateSpatialIndexes (bool wasResized);
     void paintComponentAndChildren (Graphics&);
     void paintWithinParentContext (Graphics&);
     void sendMovedResizedMessages (bool wasMoved, bool wasResized);
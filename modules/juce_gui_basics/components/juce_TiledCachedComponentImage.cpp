@@ -0,0 +1,434 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+struct TiledCachedComponentImage::Tile
+{
+    Tile (const int index_, const Rectangle<int>& area_)
+        : index (index_), area (area_), dirtyArea (area_),
+          lastPaintCount (0), isRendering (false)
+    {
+    }
+
+    const int index;
+    const Rectangle<int> area;
+    Image image;
+    RectangleList dirtyArea;
+    uint32 lastPaintCount;
+    bool isRendering;
+
+    struct LeastRecentlyPaintedFirst
+    {
+        static int compareElements (const Tile* const first, const Tile* const second) noexcept
+        {
+            return first->lastPaintCount < second->lastPaintCount ? -1
+                     : (first->lastPaintCount > second->lastPaintCount ? 1 : 0);
+        }
+    };
+
+    JUCE_DECLARE_NON_COPYABLE (Tile)
+};
+
+struct TiledCachedComponentImage::RenderedTile
+{
+    RenderedTile (const uint32 generation_, const int tileIndex_, const Image& image_)
+        : generation (generation_), tileIndex (tileIndex_), image (image_)
+    {
+    }
+
+    const uint32 generation;
+    const int tileIndex;
+    const Image image;
+
+    JUCE_DECLARE_NON_COPYABLE (RenderedTile)
+};
+
+//==============================================================================
+namespace TiledCachedComponentImageHelpers
+{
+    static int64 getSizeOf (const Image& image) noexcept
+    {
+        return image.getWidth() * (int64) image.getHeight()
+                * (image.isARGB() ? 4 : (image.isRGB() ? 3 : 1));
+    }
+
+    static Graphics* createContextForArea (Image& image, const Component& component,
+                                           const Rectangle<int>& imageArea, const RectangleList& areaToPaint)
+    {
+        ScopedPointer<Graphics> g (new Graphics (image));
+        g->setOrigin (-imageArea.getX(), -imageArea.getY());
+
+        if (! g->reduceClipRegion (areaToPaint))
+            return nullptr;
+
+        if (! component.isOpaque())
+        {
+            LowLevelGraphicsContext& lg = g->getInternalContext();
+            lg.setFill (Colours::transparentBlack);
+            lg.fillRect (imageArea, true);
+            lg.setFill (Colours::black);
+        }
+
+        return g.release();
+    }
+}
+
+//==============================================================================
+class TiledCachedComponentImage::RenderJob  : public ThreadPoolJob
+{
+public:
+    RenderJob (TiledCachedComponentImage& owner_, const Tile& tile)
+        : ThreadPoolJob ("Component tile renderer"),
+          owner (owner_), generation (owner_.generation),
+          tileIndex (tile.index), area (tile.area),
+          previousImage (tile.image), areaToPaint (tile.dirtyArea)
+    {
+    }
+
+    JobStatus runJob()
+    {
+        // The old image may still be drawn by the message thread, so this paints into a copy of it.
+        Image image (previousImage.createCopy());
+        Component& component = owner.owner;
+
+        {
+            const ScopedPointer<Graphics> g (TiledCachedComponentImageHelpers::createContextForArea (image, component, area, areaToPaint));
+
+            if (g != nullptr)
+            {
+                g->saveState();
+                component.paint (*g);
+                g->restoreState();
+
+                component.paintOverChildren (*g);
+            }
+        }
+
+        if (! shouldExit())
+            owner.addRenderedTile (generation, tileIndex, image);
+
+        return jobHasFinished;
+    }
+
+    struct OwnerSelector  : public ThreadPool::JobSelector
+    {
+        OwnerSelector (const TiledCachedComponentImage& owner_) noexcept  : owner (owner_) {}
+
+        bool isJobSuitable (ThreadPoolJob* job)
+        {
+            const RenderJob* const renderJob = dynamic_cast <RenderJob*> (job);
+            return renderJob != nullptr && renderJob->isFor (owner);
+        }
+
+        const TiledCachedComponentImage& owner;
+    };
+
+    bool isFor (const TiledCachedComponentImage& image) const noexcept     { return &owner == &image; }
+
+private:
+    TiledCachedComponentImage& owner;
+    const uint32 generation;
+    const int tileIndex;
+    const Rectangle<int> area;
+    const Image previousImage;
+    const RectangleList areaToPaint;
+
+    JUCE_DECLARE_NON_COPYABLE (RenderJob)
+};
+
+//==============================================================================
+TiledCachedComponentImage::TiledCachedComponentImage (Component& owner_, const int tileSize_)
+    : owner (owner_),
+      tileSize (jmax (16, tileSize_)),
+      numColumns (0),
+      threadPool (nullptr),
+      totalBytes (0),
+      maxTotalBytes (32 * 1024 * 1024),
+      paintCount (0),
+      generation (0),
+      isRepaintingRenderedTiles (false)
+{
+}
+
+TiledCachedComponentImage::~TiledCachedComponentImage()
+{
+    cancelRenderJobs (true);
+    cancelPendingUpdate();
+}
+
+void TiledCachedComponentImage::setBackgroundThreadPool (ThreadPool* const pool)
+{
+    if (threadPool != pool)
+    {
+        cancelRenderJobs (true);
+
+        for (int i = tiles.size(); --i >= 0;)
+        {
+            Tile& tile = *tiles.getUnchecked (i);
+
+            if (tile.isRendering)
+            {
+                // the area that the cancelled job was painting isn't known any more..
+                tile.isRendering = false;
+                tile.dirtyArea = tile.area;
+            }
+        }
+
+        threadPool = pool;
+    }
+}
+
+void TiledCachedComponentImage::setMemoryLimit (const int64 maxNumBytes)
+{
+    maxTotalBytes = maxNumBytes;
+    applyMemoryLimit();
+}
+
+//==============================================================================
+void TiledCachedComponentImage::paint (Graphics& g)
+{
+    const Rectangle<int> bounds (owner.getLocalBounds());
+
+    if (bounds != tiledBounds)
+        resetTiles (bounds);
+
+    const Rectangle<int> clip (g.getClipBounds().getIntersection (bounds));
+
+    if (clip.isEmpty())
+        return;
+
+    ++paintCount;
+
+    // The component's own paint() is only called on another thread when that's all that
+    // painting it involves - its children and effects may not be safe to use there.
+    const bool canRenderInBackground = threadPool != nullptr
+                                        && owner.getNumChildComponents() == 0
+                                        && owner.getComponentEffect() == nullptr;
+
+    const int firstColumn = clip.getX() / tileSize;
+    const int lastColumn  = (clip.getRight() - 1) / tileSize;
+    const int firstRow    = clip.getY() / tileSize;
+    const int lastRow     = (clip.getBottom() - 1) / tileSize;
+
+    g.setColour (Colours::black.withAlpha (owner.getAlpha()));
+
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = firstColumn; column <= lastColumn; ++column)
+        {
+            Tile& tile = *tiles.getUnchecked (row * numColumns + column);
+            tile.lastPaintCount = paintCount;
+
+            if (! (tile.isRendering || tile.dirtyArea.isEmpty()))
+            {
+                if (canRenderInBackground && tile.image.isValid())
+                    startRenderJob (tile);
+                else
+                    renderTile (tile);
+            }
+
+            g.drawImageAt (tile.image, tile.area.getX(), tile.area.getY());
+        }
+    }
+
+    applyMemoryLimit();
+}
+
+void TiledCachedComponentImage::invalidateAll()
+{
+    if (! isRepaintingRenderedTiles)
+    {
+        for (int i = tiles.size(); --i >= 0;)
+        {
+            Tile& tile = *tiles.getUnchecked (i);
+            tile.dirtyArea = tile.area;
+        }
+    }
+}
+
+void TiledCachedComponentImage::invalidate (const Rectangle<int>& area)
+{
+    const Rectangle<int> r (area.getIntersection (tiledBounds));
+
+    if (r.isEmpty() || isRepaintingRenderedTiles)
+        return;
+
+    const int lastColumn = (r.getRight() - 1) / tileSize;
+    const int lastRow    = (r.getBottom() - 1) / tileSize;
+
+    for (int row = r.getY() / tileSize; row <= lastRow; ++row)
+    {
+        for (int column = r.getX() / tileSize; column <= lastColumn; ++column)
+        {
+            Tile& tile = *tiles.getUnchecked (row * numColumns + column);
+            tile.dirtyArea.add (r.getIntersection (tile.area));
+        }
+    }
+}
+
+void TiledCachedComponentImage::releaseResources()
+{
+    resetTiles (Rectangle<int>());
+}
+
+//==============================================================================
+void TiledCachedComponentImage::resetTiles (const Rectangle<int>& newBounds)
+{
+    cancelRenderJobs (false);
+
+    tiles.clear();
+    totalBytes = 0;
+    ++generation;
+
+    tiledBounds = newBounds;
+    numColumns = (newBounds.getWidth()  + tileSize - 1) / tileSize;
+    const int numRows = (newBounds.getHeight() + tileSize - 1) / tileSize;
+
+    for (int row = 0; row < numRows; ++row)
+        for (int column = 0; column < numColumns; ++column)
+            tiles.add (new Tile (tiles.size(), Rectangle<int> (column * tileSize, row * tileSize, tileSize, tileSize)
+                                                  .getIntersection (newBounds)));
+}
+
+void TiledCachedComponentImage::renderTile (Tile& tile)
+{
+    if (tile.image.isNull())
+    {
+        setTileImage (tile, Image (owner.isOpaque() ? Image::RGB : Image::ARGB,
+                                   tile.area.getWidth(), tile.area.getHeight(), ! owner.isOpaque()));
+        tile.dirtyArea = tile.area;
+    }
+
+    {
+        const ScopedPointer<Graphics> g (TiledCachedComponentImageHelpers::createContextForArea (tile.image, owner, tile.area, tile.dirtyArea));
+
+        if (g != nullptr)
+            owner.paintEntireComponent (*g, true);
+    }
+
+    tile.dirtyArea.clear();
+}
+
+void TiledCachedComponentImage::startRenderJob (Tile& tile)
+{
+    jassert (threadPool != nullptr && ! tile.isRendering);
+
+    threadPool->addJob (new RenderJob (*this, tile), true);
+    tile.isRendering = true;
+    tile.dirtyArea.clear();
+}
+
+void TiledCachedComponentImage::cancelRenderJobs (const bool waitForRunningJobs)
+{
+    if (threadPool != nullptr)
+    {
+        // (any jobs that are left running will have their results ignored, because
+        // they'll come from an older generation of tiles)
+        RenderJob::OwnerSelector selector (*this);
+        threadPool->removeAllJobs (true, waitForRunningJobs ? -1 : 0, &selector);
+    }
+
+    const ScopedLock sl (renderedTilesLock);
+    renderedTiles.clear();
+}
+
+void TiledCachedComponentImage::addRenderedTile (const uint32 tileGeneration, const int tileIndex, const Image& image)
+{
+    {
+        const ScopedLock sl (renderedTilesLock);
+        renderedTiles.add (new RenderedTile (tileGeneration, tileIndex, image));
+    }
+
+    triggerAsyncUpdate();
+}
+
+void TiledCachedComponentImage::setTileImage (Tile& tile, const Image& newImage)
+{
+    totalBytes += TiledCachedComponentImageHelpers::getSizeOf (newImage)
+                    - TiledCachedComponentImageHelpers::getSizeOf (tile.image);
+    tile.image = newImage;
+}
+
+void TiledCachedComponentImage::applyMemoryLimit()
+{
+    if (totalBytes <= maxTotalBytes)
+        return;
+
+    Array<Tile*> tilesToRelease;
+
+    for (int i = tiles.size(); --i >= 0;)
+    {
+        Tile* const tile = tiles.getUnchecked (i);
+
+        if (tile->image.isValid() && ! tile->isRendering && tile->lastPaintCount != paintCount)
+            tilesToRelease.add (tile);
+    }
+
+    Tile::LeastRecentlyPaintedFirst sorter;
+    tilesToRelease.sort (sorter);
+
+    for (int i = 0; i < tilesToRelease.size() && totalBytes > maxTotalBytes; ++i)
+    {
+        Tile& tile = *tilesToRelease.getUnchecked (i);
+        setTileImage (tile, Image::null);
+        tile.dirtyArea = tile.area;
+    }
+}
+
+void TiledCachedComponentImage::handleAsyncUpdate()
+{
+    OwnedArray<RenderedTile> results;
+
+    {
+        const ScopedLock sl (renderedTilesLock);
+        results.swapWithArray (renderedTiles);
+    }
+
+    RectangleList areaToRepaint;
+
+    for (int i = 0; i < results.size(); ++i)
+    {
+        const RenderedTile& result = *results.getUnchecked (i);
+
+        if (result.generation == generation)
+        {
+            if (Tile* const tile = tiles [result.tileIndex])
+            {
+                setTileImage (*tile, result.image);
+                tile->isRendering = false;
+                areaToRepaint.add (tile->area);
+            }
+        }
+    }
+
+    {
+        // (the tiles are already up to date, so these repaints mustn't invalidate them again)
+        const ScopedValueSetter<bool> setter (isRepaintingRenderedTiles, true);
+
+        for (const Rectangle<int>* r = areaToRepaint.begin(), * const e = areaToRepaint.end(); r != e; ++r)
+            owner.repaint (*r);
+    }
+
+    applyMemoryLimit();
+}
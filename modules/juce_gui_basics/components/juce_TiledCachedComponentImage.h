@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_TILEDCACHEDCOMPONENTIMAGE_JUCEHEADER__
+#define __JUCE_TILEDCACHEDCOMPONENTIMAGE_JUCEHEADER__
+
+#include "juce_CachedComponentImage.h"
+#include "juce_Component.h"
+
+
+//==============================================================================
+/**
+    A CachedComponentImage that buffers a component as a grid of separate tiles.
+
+    This is an alternative to Component::setBufferedToImage() for large components.
+    Instead of keeping one image the size of the whole component, it keeps an image
+    for each tile, so a repaint() only causes the tiles that it touches to be redrawn,
+    and tiles that haven't been on screen recently can be thrown away when the
+    cache grows beyond its memory limit.
+
+    If you give it a ThreadPool with setBackgroundThreadPool(), tiles that need
+    redrawing are rendered by the pool's threads while the old version of the tile
+    is shown. Only do this if the component's paint() method, and those of its
+    children, are safe to call on a background thread while the message thread
+    carries on with other things!
+
+    To use one, just pass it to Component::setCachedComponentImage(), e.g.
+    @code
+    MyBigComponent::MyBigComponent()
+    {
+        setCachedComponentImage (new TiledCachedComponentImage (*this));
+    }
+    @endcode
+
+    When background rendering is being used, remember to call
+    setCachedComponentImage (nullptr) in your component's destructor, so that
+    the cache has stopped using it before it's deleted.
+
+    @see Component::setCachedComponentImage, Component::setBufferedToImage
+*/
+class JUCE_API  TiledCachedComponentImage  : public CachedComponentImage,
+                                             private AsyncUpdater
+{
+public:
+    //==============================================================================
+    /** Creates a cache for the given component, using square tiles of the given size. */
+    explicit TiledCachedComponentImage (Component& owner, int tileSize = 256);
+
+    /** Destructor.
+        If any tiles are being rendered on a background thread, this waits for them to finish.
+    */
+    ~TiledCachedComponentImage();
+
+    //==============================================================================
+    /** Makes the tiles get rendered by a ThreadPool instead of on the message thread.
+
+        While a tile is being rendered, the previous version of its image is drawn in its
+        place, and the component is repainted when the new one is ready. Tiles that have
+        no image yet are still rendered immediately when they're painted.
+
+        The pool must not be deleted while this object is using it. Passing nullptr turns
+        background rendering off again.
+    */
+    void setBackgroundThreadPool (ThreadPool* pool);
+
+    /** Returns the pool that was set with setBackgroundThreadPool(), or nullptr. */
+    ThreadPool* getBackgroundThreadPool() const noexcept        { return threadPool; }
+
+    /** Sets the number of bytes of tile images that the cache should try to stay within.
+
+        When it goes over this limit, the tiles which have gone longest without being
+        painted are released. Tiles that were drawn in the most recent paint call are
+        always kept, so the cache may exceed the limit if more than this is on screen.
+        The default is 32MB.
+    */
+    void setMemoryLimit (int64 maxNumBytes);
+
+    /** Returns the number of bytes that the tiles' images are currently using. */
+    int64 getMemoryUsed() const noexcept                        { return totalBytes; }
+
+    //==============================================================================
+    /** @internal */
+    void paint (Graphics&);
+    /** @internal */
+    void invalidateAll();
+    /** @internal */
+    void invalidate (const Rectangle<int>& area);
+    /** @internal */
+    void releaseResources();
+
+private:
+    //==============================================================================
+    struct Tile;
+    class RenderJob;
+    friend class RenderJob;
+    struct RenderedTile;
+
+    Component& owner;
+    const int tileSize;
+    Rectangle<int> tiledBounds;
+    int numColumns;
+    OwnedArray<Tile> tiles;
+    ThreadPool* threadPool;
+    int64 totalBytes, maxTotalBytes;
+    uint32 paintCount, generation;
+    bool isRepaintingRenderedTiles;
+
+    OwnedArray<RenderedTile> renderedTiles;
+    CriticalSection renderedTilesLock;
+
+    void resetTiles (const Rectangle<int>& newBounds);
+    void renderTile (Tile&);
+    void startRenderJob (Tile&);
+    void cancelRenderJobs (bool waitForRunningJobs);
+    void addRenderedTile (uint32 generation, int tileIndex, const Image&);
+    void setTileImage (Tile&, const Image&);
+    void applyMemoryLimit();
+    void handleAsyncUpdate();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TiledCachedComponentImage)
+};
+
+
+#endif   // __JUCE_TILEDCACHEDCOMPONENTIMAGE_JUCEHEADER__
@@ -121,9 +121,112 @@ void Drawable::setTransformToFit (const Rectangle<float>& area, const RectangleP
 }
 
 //==============================================================================
+class SVGDrawableCache  : private DeletedAtShutdown
+{
+public:
+    SVGDrawableCache() {}
+
+    ~SVGDrawableCache()
+    {
+        clearSingletonInstance();
+    }
+
+    Drawable* createCopyOf (const void* data, const size_t numBytes)
+    {
+        const ScopedLock sl (lock);
+
+        if (Item* const item = findItem (getHashCodeFor (data, numBytes), data, numBytes))
+        {
+            item->lastUseTime = Time::getApproximateMillisecondCounter();
+            return item->drawable->createCopy();
+        }
+
+        return nullptr;
+    }
+
+    void add (const void* data, const size_t numBytes, const Drawable& drawable)
+    {
+        const int64 hashCode = getHashCodeFor (data, numBytes);
+        const ScopedLock sl (lock);
+
+        if (findItem (hashCode, data, numBytes) == nullptr)
+        {
+            if (items.size() >= maxNumItems)
+                removeLeastRecentlyUsed();
+
+            Item* const item = new Item();
+            item->hashCode = hashCode;
+            item->data = MemoryBlock (data, numBytes);
+            item->drawable = drawable.createCopy();
+            item->lastUseTime = Time::getApproximateMillisecondCounter();
+            items.add (item);
+        }
+    }
+
+    juce_DeclareSingleton_SingleThreaded_Minimal (SVGDrawableCache);
+
+private:
+    struct Item
+    {
+        int64 hashCode;
+        MemoryBlock data;   // (kept so that a hash collision can't return the wrong drawable)
+        ScopedPointer<Drawable> drawable;
+        uint32 lastUseTime;
+    };
+
+    enum { maxNumItems = 64 };
+
+    OwnedArray<Item> items;
+    CriticalSection lock;
+
+    static int64 getHashCodeFor (const void* data, const size_t numBytes) noexcept
+    {
+        const uint8* const bytes = static_cast <const uint8*> (data);
+        int64 result = (int64) numBytes;
+
+        for (size_t i = 0; i < numBytes; ++i)
+            result = 101 * result + bytes[i];
+
+        return result;
+    }
+
+    Item* findItem (const int64 hashCode, const void* data, const size_t numBytes) const noexcept
+    {
+        for (int i = items.size(); --i >= 0;)
+        {
+            Item* const item = items.getUnchecked(i);
+
+            if (item->hashCode == hashCode
+                 && item->data.getSize() == numBytes
+                 && memcmp (item->data.getData(), data, numBytes) == 0)
+                return item;
+        }
+
+        return nullptr;
+    }
+
+    void removeLeastRecentlyUsed()
+    {
+        int oldest = 0;
+
+        for (int i = items.size(); --i > 0;)
+            if (items.getUnchecked(i)->lastUseTime < items.getUnchecked (oldest)->lastUseTime)
+                oldest = i;
+
+        items.remove (oldest);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (SVGDrawableCache)
+};
+
+juce_ImplementSingleton_SingleThreaded (SVGDrawableCache)
+
 Drawable* Drawable::createFromImageData (const void* data, const size_t numBytes)
 {
-    Drawable* result = nullptr;
+    Drawable* result = SVGDrawableCache::getInstance()->createCopyOf (data, numBytes);
+
+    if (result != nullptr)
+        return result;
 
     Image image (ImageFileFormat::loadFrom (data, numBytes));
 
@@ -145,7 +248,12 @@ Drawable* Drawable::createFromImageData (const void* data, const size_t numBytes
             ScopedPointer <XmlElement> svg (doc.getDocumentElement());
 
             if (svg != nullptr)
+            {
                 result = Drawable::createFromSVG (*svg);
+
+                if (result != nullptr)
+                    SVGDrawableCache::getInstance()->add (data, numBytes, *result);
+            }
         }
     }
 
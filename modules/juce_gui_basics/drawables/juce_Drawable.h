@@ -128,6 +128,10 @@ public:
 
         The data could be an image that the ImageFileFormat class understands, or it
         could be SVG.
+
+        The drawables that are parsed from SVG data are kept in a small cache, so if
+        the same data is loaded again (e.g. for an icon that's used by lots of buttons),
+        you'll just get a copy of the one that was created before.
     */
     static Drawable* createFromImageData (const void* data, size_t numBytes);
 
@@ -32,8 +32,6 @@ DrawablePath::DrawablePath (const DrawablePath& other)
 {
     if (other.relativePath != nullptr)
         setPath (*other.relativePath);
-    else
-        setPath (other.path);
 }
 
 DrawablePath::~DrawablePath()
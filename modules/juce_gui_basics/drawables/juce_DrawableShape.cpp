@@ -33,9 +33,13 @@ DrawableShape::DrawableShape()
 DrawableShape::DrawableShape (const DrawableShape& other)
     : Drawable (other),
       strokeType (other.strokeType),
+      path (other.path),
+      strokePath (other.strokePath),
       mainFill (other.mainFill),
       strokeFill (other.strokeFill)
 {
+    // (the outline has already been stroked, so copies don't need to do that again)
+    setBoundsToEnclose (getDrawableBounds());
 }
 
 DrawableShape::~DrawableShape()
@@ -179,7 +183,9 @@ void DrawableShape::pathChanged()
 void DrawableShape::strokeChanged()
 {
     strokePath.clear();
-    strokeType.createStrokedPath (strokePath, path, AffineTransform::identity, 4.0f);
+
+    if (strokeType.getStrokeThickness() > 0.0f)
+        strokeType.createStrokedPath (strokePath, path, AffineTransform::identity, 4.0f);
 
     setBoundsToEnclose (getDrawableBounds());
     repaint();
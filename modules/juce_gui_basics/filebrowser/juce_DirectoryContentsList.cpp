@@ -23,10 +23,74 @@
   ==============================================================================
 */
 
+//==============================================================================
+/*  Reads a whole directory on a ThreadPool thread, handing the files to the list
+    in sorted batches so that it can be displayed while it's still filling up.
+*/
+class DirectoryContentsList::ReadJob  : public ThreadPoolJob
+{
+public:
+    ReadJob (DirectoryContentsList& owner_, const File& directory, const int flags)
+        : ThreadPoolJob ("DirectoryContentsList"),
+          owner (owner_), iter (directory, false, "*", flags), finished (false)
+    {
+    }
+
+    JobStatus runJob()
+    {
+        OwnedArray<FileInfo> batch;
+        uint32 lastFlushTime = Time::getMillisecondCounter();
+
+        bool fileFoundIsDir, isHidden, isReadOnly;
+        int64 fileSize;
+        Time modTime, creationTime;
+
+        while (! shouldExit())
+        {
+            const bool foundFile = iter.next (&fileFoundIsDir, &isHidden, &fileSize,
+                                              &modTime, &creationTime, &isReadOnly);
+
+            if (foundFile)
+                if (FileInfo* const info = owner.createFileInfo (iter.getFile(), fileFoundIsDir, fileSize,
+                                                                 modTime, creationTime, isReadOnly))
+                    batch.add (info);
+
+            if (! foundFile || batch.size() >= maxBatchSize
+                 || Time::getMillisecondCounter() > lastFlushTime + flushIntervalMs)
+            {
+                if (owner.addFiles (batch))
+                    owner.changed();
+
+                batch.clear();
+                lastFlushTime = Time::getMillisecondCounter();
+
+                if (! foundFile)
+                    break;
+            }
+        }
+
+        finished = true;
+        return jobHasFinished;
+    }
+
+    bool hasFinished() const noexcept       { return finished; }
+
+private:
+    DirectoryContentsList& owner;
+    DirectoryIterator iter;
+    bool volatile finished;
+
+    enum { maxBatchSize = 4096, flushIntervalMs = 50 };
+
+    JUCE_DECLARE_NON_COPYABLE (ReadJob)
+};
+
+//==============================================================================
 DirectoryContentsList::DirectoryContentsList (const FileFilter* const fileFilter_,
                                               TimeSliceThread& thread_)
    : fileFilter (fileFilter_),
      thread (thread_),
+     threadPool (nullptr),
      fileTypeFlags (File::ignoreHiddenFiles | File::findFiles),
      shouldStop (true)
 {
@@ -48,6 +112,15 @@ bool DirectoryContentsList::ignoresHiddenFiles() const
     return (fileTypeFlags & File::ignoreHiddenFiles) != 0;
 }
 
+void DirectoryContentsList::setThreadPool (ThreadPool* const poolToUse)
+{
+    if (threadPool != poolToUse)
+    {
+        stopSearching();
+        threadPool = poolToUse;
+    }
+}
+
 //==============================================================================
 const File& DirectoryContentsList::getDirectory() const
 {
@@ -90,6 +163,12 @@ void DirectoryContentsList::stopSearching()
     shouldStop = true;
     thread.removeTimeSliceClient (this);
     fileFindHandle = nullptr;
+
+    if (readJob != nullptr)
+    {
+        threadPool->removeJob (readJob, true, -1);
+        readJob = nullptr;
+    }
 }
 
 void DirectoryContentsList::clear()
@@ -109,9 +188,18 @@ void DirectoryContentsList::refresh()
 
     if (root.isDirectory())
     {
-        fileFindHandle = new DirectoryIterator (root, false, "*", fileTypeFlags);
         shouldStop = false;
-        thread.addTimeSliceClient (this);
+
+        if (threadPool != nullptr)
+        {
+            readJob = new ReadJob (*this, root, fileTypeFlags);
+            threadPool->addJob (readJob, false);
+        }
+        else
+        {
+            fileFindHandle = new DirectoryIterator (root, false, "*", fileTypeFlags);
+            thread.addTimeSliceClient (this);
+        }
     }
 }
 
@@ -158,7 +246,8 @@ bool DirectoryContentsList::contains (const File& targetFile) const
 
 bool DirectoryContentsList::isStillLoading() const
 {
-    return fileFindHandle != nullptr;
+    return fileFindHandle != nullptr
+            || (readJob != nullptr && ! readJob->hasFinished());
 }
 
 void DirectoryContentsList::changed()
@@ -170,29 +259,28 @@ void DirectoryContentsList::changed()
 int DirectoryContentsList::useTimeSlice()
 {
     const uint32 startTime = Time::getApproximateMillisecondCounter();
-    bool hasChanged = false;
+    OwnedArray<FileInfo> newFiles;
+    bool finished = false;
 
     for (int i = 100; --i >= 0;)
     {
-        if (! checkNextFile (hasChanged))
+        if (! checkNextFile (newFiles))
         {
-            if (hasChanged)
-                changed();
-
-            return 500;
+            finished = true;
+            break;
         }
 
-        if (shouldStop || (Time::getApproximateMillisecondCounter() > startTime + 150))
+        if (shouldStop || (Time::getApproximateMillisecondCounter() > startTime + 20))
             break;
     }
 
-    if (hasChanged)
+    if (addFiles (newFiles))
         changed();
 
-    return 0;
+    return finished ? 500 : 0;
 }
 
-bool DirectoryContentsList::checkNextFile (bool& hasChanged)
+bool DirectoryContentsList::checkNextFile (OwnedArray<FileInfo>& newFiles)
 {
     if (fileFindHandle != nullptr)
     {
@@ -203,11 +291,9 @@ bool DirectoryContentsList::checkNextFile (bool& hasChanged)
         if (fileFindHandle->next (&fileFoundIsDir, &isHidden, &fileSize,
                                   &modTime, &creationTime, &isReadOnly))
         {
-            if (addFile (fileFindHandle->getFile(), fileFoundIsDir,
-                         fileSize, modTime, creationTime, isReadOnly))
-            {
-                hasChanged = true;
-            }
+            if (FileInfo* const info = createFileInfo (fileFindHandle->getFile(), fileFoundIsDir,
+                                                       fileSize, modTime, creationTime, isReadOnly))
+                newFiles.add (info);
 
             return true;
         }
@@ -229,18 +315,18 @@ int DirectoryContentsList::compareElements (const DirectoryContentsList::FileInf
     return first->filename.compareIgnoreCase (second->filename);
 }
 
-bool DirectoryContentsList::addFile (const File& file,
-                                     const bool isDir,
-                                     const int64 fileSize,
-                                     const Time modTime,
-                                     const Time creationTime,
-                                     const bool isReadOnly)
+DirectoryContentsList::FileInfo* DirectoryContentsList::createFileInfo (const File& file,
+                                                                        const bool isDir,
+                                                                        const int64 fileSize,
+                                                                        const Time modTime,
+                                                                        const Time creationTime,
+                                                                        const bool isReadOnly) const
 {
     if (fileFilter == nullptr
          || ((! isDir) && fileFilter->isFileSuitable (file))
          || (isDir && fileFilter->isDirectorySuitable (file)))
     {
-        ScopedPointer <FileInfo> info (new FileInfo());
+        FileInfo* const info = new FileInfo();
 
         info->filename = file.getFileName();
         info->fileSize = fileSize;
@@ -248,16 +334,60 @@ bool DirectoryContentsList::addFile (const File& file,
         info->creationTime = creationTime;
         info->isDirectory = isDir;
         info->isReadOnly = isReadOnly;
+        return info;
+    }
+
+    return nullptr;
+}
 
-        const ScopedLock sl (fileListLock);
+bool DirectoryContentsList::addFiles (OwnedArray<FileInfo>& newFiles)
+{
+    if (newFiles.size() == 0)
+        return false;
 
-        for (int i = files.size(); --i >= 0;)
-            if (files.getUnchecked(i)->filename == info->filename)
-                return false;
+    // Sorting the batch and merging it into the list in a single pass is much cheaper
+    // than inserting the files one at a time once the list gets large.
+    newFiles.sort (*this);
 
-        files.addSorted (*this, info.release());
-        return true;
+    const ScopedLock sl (fileListLock);
+
+    Array<FileInfo*> merged;
+    merged.ensureStorageAllocated (files.size() + newFiles.size());
+    int numExisting = 0, numAdded = 0;
+
+    for (int i = 0; i < newFiles.size(); ++i)
+    {
+        FileInfo* const info = newFiles.getUnchecked (i);
+
+        while (numExisting < files.size() && compareElements (files.getUnchecked (numExisting), info) < 0)
+            merged.add (files.getUnchecked (numExisting++));
+
+        bool isDuplicate = false;
+
+        for (int j = numExisting; j < files.size() && compareElements (files.getUnchecked (j), info) == 0; ++j)
+        {
+            if (files.getUnchecked (j)->filename == info->filename)
+            {
+                isDuplicate = true;
+                break;
+            }
+        }
+
+        if (! isDuplicate)
+        {
+            merged.add (info);
+            newFiles.set (i, nullptr, false);
+            ++numAdded;
+        }
     }
 
-    return false;
+    if (numAdded == 0)
+        return false;
+
+    while (numExisting < files.size())
+        merged.add (files.getUnchecked (numExisting++));
+
+    files.clear (false);
+    files.addArray (merged);
+    return true;
 }
@@ -37,6 +37,11 @@
     thread to scan for more files. As files are found, it broadcasts change messages
     to tell any listeners.
 
+    By default the scanning is done a few files at a time by the TimeSliceThread that
+    you supply, but for very large directories you can call setThreadPool() to have the
+    whole directory read by a job running on a ThreadPool instead, which won't hold up
+    the thread's other clients.
+
     @see FileListComponent, FileBrowserComponent
 */
 class JUCE_API  DirectoryContentsList   : public ChangeBroadcaster,
@@ -103,6 +108,25 @@ public:
     */
     bool ignoresHiddenFiles() const;
 
+    /** Tells the list to read directories using a job on the given ThreadPool rather than
+        on its TimeSliceThread.
+
+        The files are read in one go by a single job, and are added to the list in sorted
+        batches, so the list still fills up progressively while it's loading. This is
+        much quicker than the time-slice approach for directories containing thousands of
+        files, and doesn't stop the TimeSliceThread from serving its other clients.
+
+        Pass nullptr to go back to using the TimeSliceThread. The pool must not be deleted
+        while this list is still using it. The change takes effect the next time the
+        directory is scanned.
+
+        @see getThreadPool
+    */
+    void setThreadPool (ThreadPool* poolToUse);
+
+    /** Returns the pool that was set with setThreadPool(), or nullptr if there isn't one. */
+    ThreadPool* getThreadPool() const noexcept              { return threadPool; }
+
     //==============================================================================
     /** Contains cached information about one of the files in a DirectoryContentsList.
     */
@@ -193,6 +217,7 @@ private:
     File root;
     const FileFilter* fileFilter;
     TimeSliceThread& thread;
+    ThreadPool* threadPool;
     int fileTypeFlags;
 
     CriticalSection fileListLock;
@@ -201,13 +226,19 @@ private:
     ScopedPointer <DirectoryIterator> fileFindHandle;
     bool volatile shouldStop;
 
+    class ReadJob;
+    friend class ReadJob;
+    friend class ScopedPointer<ReadJob>;
+    ScopedPointer<ReadJob> readJob;
+
     int useTimeSlice();
     void stopSearching();
     void changed();
-    bool checkNextFile (bool& hasChanged);
-    bool addFile (const File& file, bool isDir,
-                  const int64 fileSize, const Time modTime,
-                  const Time creationTime, bool isReadOnly);
+    bool checkNextFile (OwnedArray<FileInfo>& newFiles);
+    FileInfo* createFileInfo (const File& file, bool isDir,
+                              const int64 fileSize, const Time modTime,
+                              const Time creationTime, bool isReadOnly) const;
+    bool addFiles (OwnedArray<FileInfo>& newFiles);
     void setTypeFlags (int newFlags);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DirectoryContentsList)
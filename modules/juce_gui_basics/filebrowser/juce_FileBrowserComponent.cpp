@@ -33,7 +33,8 @@ FileBrowserComponent::FileBrowserComponent (int flags_,
      previewComp (previewComp_),
      currentPathBox ("path"),
      fileLabel ("f", TRANS ("file:")),
-     thread ("Juce FileBrowser")
+     thread ("Juce FileBrowser"),
+     listingPool (2)
 {
     // You need to specify one or other of the open/save flags..
     jassert ((flags & (saveMode | openMode)) != 0);
@@ -60,6 +61,7 @@ FileBrowserComponent::FileBrowserComponent (int flags_,
     }
 
     fileList = new DirectoryContentsList (this, thread);
+    fileList->setThreadPool (&listingPool);
 
     if ((flags & useTreeView) != 0)
     {
@@ -105,7 +107,18 @@ FileBrowserComponent::FileBrowserComponent (int flags_,
     goUpButton->setTooltip (TRANS ("Go up to parent directory"));
 
     if (previewComp != nullptr)
+    {
+        if (ImagePreviewComponent* const imagePreview = dynamic_cast <ImagePreviewComponent*> (previewComp))
+        {
+            if (imagePreview->getImageLoader() == nullptr)
+            {
+                imageLoader = new AsyncImageLoader (1);
+                imagePreview->setImageLoader (imageLoader);
+            }
+        }
+
         addAndMakeVisible (previewComp);
+    }
 
     setRoot (currentRoot);
 
@@ -114,6 +127,10 @@ FileBrowserComponent::FileBrowserComponent (int flags_,
 
 FileBrowserComponent::~FileBrowserComponent()
 {
+    if (imageLoader != nullptr)
+        if (ImagePreviewComponent* const imagePreview = dynamic_cast <ImagePreviewComponent*> (previewComp))
+            imagePreview->setImageLoader (nullptr);
+
     fileListComponent = nullptr;
     fileList = nullptr;
     thread.stopThread (10000);
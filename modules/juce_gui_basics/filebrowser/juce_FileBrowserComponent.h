@@ -241,6 +241,8 @@ private:
     ScopedPointer<Button> goUpButton;
 
     TimeSliceThread thread;
+    ThreadPool listingPool;
+    ScopedPointer<AsyncImageLoader> imageLoader;
 
     void sendListenerChangeMessage();
     bool isFileOrDirSuitable (const File& f) const;
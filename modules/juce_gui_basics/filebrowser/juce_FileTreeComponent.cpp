@@ -88,6 +88,7 @@ public:
                     jassert (parentContentsList != nullptr);
 
                     DirectoryContentsList* const l = new DirectoryContentsList (parentContentsList->getFilter(), thread);
+                    l->setThreadPool (parentContentsList->getThreadPool());
                     l->setDirectory (file, true, true);
 
                     setSubContentsList (l, true);
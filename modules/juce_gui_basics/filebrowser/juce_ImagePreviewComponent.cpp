@@ -24,11 +24,25 @@
 */
 
 ImagePreviewComponent::ImagePreviewComponent()
+    : imageLoader (nullptr)
 {
 }
 
 ImagePreviewComponent::~ImagePreviewComponent()
 {
+    if (imageLoader != nullptr)
+        imageLoader->cancelRequests (this);
+}
+
+void ImagePreviewComponent::setImageLoader (AsyncImageLoader* const loaderToUse)
+{
+    if (imageLoader != loaderToUse)
+    {
+        if (imageLoader != nullptr)
+            imageLoader->cancelRequests (this);
+
+        imageLoader = loaderToUse;
+    }
 }
 
 //==============================================================================
@@ -62,6 +76,20 @@ void ImagePreviewComponent::timerCallback()
     currentDetails = String::empty;
     repaint();
 
+    if (imageLoader != nullptr)
+    {
+        imageLoader->cancelRequests (this);
+
+        const Image image (imageLoader->loadImage (fileToLoad, this,
+                                                   jmax (1, proportionOfWidth (0.97f)),
+                                                   jmax (1, getHeight() - 13 * 4)));
+
+        if (image.isValid())
+            imageLoaded (fileToLoad, image);
+
+        return;
+    }
+
     ScopedPointer<FileInputStream> in (fileToLoad.createInputStream());
 
     if (in != nullptr)
@@ -89,6 +117,23 @@ void ImagePreviewComponent::timerCallback()
     }
 }
 
+void ImagePreviewComponent::imageLoaded (const File& file, const Image& image)
+{
+    if (file != fileToLoad || ! image.isValid())
+        return;
+
+    // The loader only hands back the shrunken thumbnail, so the original
+    // pixel dimensions aren't shown here.
+    currentThumbnail = image;
+    currentDetails = file.getFileName() + "\n";
+
+    if (ImageFileFormat* const format = ImageFileFormat::findImageFormatForFileExtension (file))
+        currentDetails << format->getFormatName();
+
+    currentDetails << "\n\n" << File::descriptionOfSizeInBytes (file.getSize());
+    repaint();
+}
+
 void ImagePreviewComponent::paint (Graphics& g)
 {
     if (currentThumbnail.isValid())
@@ -33,10 +33,14 @@
 /**
     A simple preview component that shows thumbnails of image files.
 
+    By default the images are decoded on the message thread, but if you give it an
+    AsyncImageLoader with setImageLoader(), they'll be loaded in the background instead.
+
     @see FileChooserDialogBox, FilePreviewComponent
 */
 class JUCE_API  ImagePreviewComponent  : public FilePreviewComponent,
-                                         private Timer
+                                         private Timer,
+                                         private AsyncImageLoader::Listener
 {
 public:
     //==============================================================================
@@ -46,6 +50,18 @@ public:
     /** Destructor. */
     ~ImagePreviewComponent();
 
+    //==============================================================================
+    /** Makes the component load its thumbnails using an AsyncImageLoader, so that
+        large images don't hold up the message thread while they're being decoded.
+
+        The loader must not be deleted while this component is still using it. Pass
+        nullptr to go back to loading the images synchronously.
+    */
+    void setImageLoader (AsyncImageLoader* loaderToUse);
+
+    /** Returns the loader that was set with setImageLoader(), or nullptr if there isn't one. */
+    AsyncImageLoader* getImageLoader() const noexcept       { return imageLoader; }
+
 
     //==============================================================================
     /** @internal */
@@ -59,8 +75,10 @@ private:
     File fileToLoad;
     Image currentThumbnail;
     String currentDetails;
+    AsyncImageLoader* imageLoader;
 
     void getThumbSize (int& w, int& h) const;
+    void imageLoaded (const File&, const Image&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ImagePreviewComponent)
 };
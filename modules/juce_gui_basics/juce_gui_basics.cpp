@@ -144,6 +144,7 @@ namespace juce
 #include "components/juce_ComponentListener.cpp"
 #include "components/juce_Desktop.cpp"
 #include "components/juce_ModalComponentManager.cpp"
+#include "components/juce_TiledCachedComponentImage.cpp"
 #include "mouse/juce_ComponentDragger.cpp"
 #include "mouse/juce_DragAndDropContainer.cpp"
 #include "mouse/juce_MouseCursor.cpp"
@@ -27,16 +27,27 @@ class ComponentAnimator::AnimationTask
 {
 public:
     AnimationTask (Component* const comp)
-        : component (comp)
+        : component (comp), layer (nullptr),
+          left (0), top (0), right (0), bottom (0),
+          isCompositing (false)
     {
     }
 
+    ~AnimationTask()
+    {
+        stopCompositing (getCurrentBounds());
+    }
+
     void reset (const Rectangle<int>& finalBounds,
                 float finalAlpha,
                 int millisecondsToSpendMoving,
                 bool useProxyComponent,
+                bool useCompositing,
+                const ImageType* layerImageType,
                 double startSpeed_, double endSpeed_)
     {
+        stopCompositing (getCurrentBounds());
+
         msElapsed = 0;
         msTotal = jmax (1, millisecondsToSpendMoving);
         lastProgress = 0;
@@ -63,6 +74,9 @@ public:
             proxy = nullptr;
 
         component->setVisible (! useProxyComponent);
+
+        if (useCompositing && ! useProxyComponent)
+            startCompositing (layerImageType);
     }
 
     bool useTimeslice (const int elapsed)
@@ -98,7 +112,11 @@ public:
 
                         if (newBounds != destination)
                         {
-                            c->setBounds (newBounds);
+                            if (isCompositing)
+                                c->setTransform (getCompositingTransform());
+                            else
+                                c->setBounds (newBounds);
+
                             stillBusy = true;
                         }
                     }
@@ -125,13 +143,92 @@ public:
         if (component != nullptr)
         {
             component->setAlpha ((float) destAlpha);
-            component->setBounds (destination);
+
+            if (isCompositing)
+                stopCompositing (destination);
+            else
+                component->setBounds (destination);
 
             if (proxy != nullptr)
                 component->setVisible (destAlpha > 0);
         }
     }
 
+    void setLayerImageType (const ImageType* newType)
+    {
+        if (layer != nullptr && component != nullptr && component->getCachedComponentImage() == layer)
+            layer->setImageType (newType);
+    }
+
+    //==============================================================================
+    /*  Caches the component's contents while it's being composited. This is much the same
+        as the cache that Component::setBufferedToImage() uses, but lets the animator choose
+        the type of image.
+    */
+    class LayerImage  : public CachedComponentImage
+    {
+    public:
+        LayerImage (Component& c, const ImageType* type)
+            : owner (c), imageType (type)
+        {
+        }
+
+        void setImageType (const ImageType* newType) noexcept   { imageType = newType; }
+
+        void paint (Graphics& g)
+        {
+            const Rectangle<int> bounds (owner.getLocalBounds());
+
+            if (image.isNull() || image.getBounds() != bounds)
+            {
+                const Image::PixelFormat format = owner.isOpaque() ? Image::RGB : Image::ARGB;
+                const int w = jmax (1, bounds.getWidth());
+                const int h = jmax (1, bounds.getHeight());
+
+                image = imageType != nullptr ? Image (format, w, h, ! owner.isOpaque(), *imageType)
+                                             : Image (format, w, h, ! owner.isOpaque());
+                validArea.clear();
+            }
+
+            {
+                Graphics imG (image);
+                LowLevelGraphicsContext& lg = imG.getInternalContext();
+
+                for (const Rectangle<int>* i = validArea.begin(), * const e = validArea.end(); i != e; ++i)
+                    lg.excludeClipRectangle (*i);
+
+                if (! lg.isClipEmpty())
+                {
+                    if (! owner.isOpaque())
+                    {
+                        lg.setFill (Colours::transparentBlack);
+                        lg.fillRect (bounds, true);
+                        lg.setFill (Colours::black);
+                    }
+
+                    owner.paintEntireComponent (imG, true);
+                }
+            }
+
+            validArea = bounds;
+
+            g.setColour (Colours::black.withAlpha (owner.getAlpha()));
+            g.drawImageAt (image, 0, 0);
+        }
+
+        void invalidateAll()                            { validArea.clear(); }
+        void invalidate (const Rectangle<int>& area)    { validArea.subtract (area); }
+        void releaseResources()                         { image = Image::null; }
+
+    private:
+        Component& owner;
+        const ImageType* imageType;
+        Image image;
+        RectangleList validArea;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LayerImage)
+    };
+
     //==============================================================================
     class ProxyComponent  : public Component
     {
@@ -170,6 +267,8 @@ public:
 
     WeakReference<Component> component;
     ScopedPointer<Component> proxy;
+    LayerImage* layer;  // (owned by the component once it has been attached)
+    Rectangle<int> compositedBounds;
 
     Rectangle<int> destination;
     double destAlpha;
@@ -177,9 +276,61 @@ public:
     int msElapsed, msTotal;
     double startSpeed, midSpeed, endSpeed, lastProgress;
     double left, top, right, bottom, alpha;
-    bool isMoving, isChangingAlpha;
+    bool isMoving, isChangingAlpha, isCompositing;
 
 private:
+    void startCompositing (const ImageType* layerImageType)
+    {
+        layer = nullptr;
+
+        if (component->getCachedComponentImage() == nullptr)
+        {
+            layer = new LayerImage (*component, layerImageType);
+            component->setCachedComponentImage (layer);
+        }
+
+        compositedBounds = component->getBounds();
+        isCompositing = true;
+
+        if (component->isTransformed() || compositedBounds.isEmpty() || destination.isEmpty())
+        {
+            // can't use a transform for this one, so just keep the image cache while it moves
+            isCompositing = false;
+        }
+    }
+
+    void stopCompositing (const Rectangle<int>& finalBounds)
+    {
+        if (component != nullptr)
+        {
+            if (isCompositing)
+            {
+                component->setTransform (AffineTransform::identity);
+                component->setBounds (finalBounds);
+            }
+
+            if (layer != nullptr && component->getCachedComponentImage() == layer)
+                component->setCachedComponentImage (nullptr);
+        }
+
+        layer = nullptr;
+        isCompositing = false;
+    }
+
+    Rectangle<int> getCurrentBounds() const
+    {
+        return Rectangle<int> (roundToInt (left), roundToInt (top),
+                               roundToInt (right - left), roundToInt (bottom - top));
+    }
+
+    AffineTransform getCompositingTransform() const
+    {
+        return AffineTransform::translation ((float) -compositedBounds.getX(), (float) -compositedBounds.getY())
+                               .scaled ((float) ((right - left) / compositedBounds.getWidth()),
+                                        (float) ((bottom - top) / compositedBounds.getHeight()))
+                               .translated ((float) left, (float) top);
+    }
+
     double timeToDistance (const double time) const noexcept
     {
         return (time < 0.5) ? time * (startSpeed + time * (midSpeed - startSpeed))
@@ -215,6 +366,38 @@ void ComponentAnimator::animateComponent (Component* const component,
                                           const bool useProxyComponent,
                                           const double startSpeed,
                                           const double endSpeed)
+{
+    startAnimation (component, finalBounds, finalAlpha, millisecondsToSpendMoving,
+                    useProxyComponent, false, startSpeed, endSpeed);
+}
+
+void ComponentAnimator::animateComponentComposited (Component* const component,
+                                                    const Rectangle<int>& finalBounds,
+                                                    const float finalAlpha,
+                                                    const int millisecondsToSpendMoving,
+                                                    const double startSpeed,
+                                                    const double endSpeed)
+{
+    startAnimation (component, finalBounds, finalAlpha, millisecondsToSpendMoving,
+                    false, true, startSpeed, endSpeed);
+}
+
+void ComponentAnimator::setLayerImageType (ImageType* const newImageType)
+{
+    for (int i = tasks.size(); --i >= 0;)
+        tasks.getUnchecked(i)->setLayerImageType (newImageType);
+
+    layerImageType = newImageType;
+}
+
+void ComponentAnimator::startAnimation (Component* const component,
+                                        const Rectangle<int>& finalBounds,
+                                        const float finalAlpha,
+                                        const int millisecondsToSpendMoving,
+                                        const bool useProxyComponent,
+                                        const bool useCompositing,
+                                        const double startSpeed,
+                                        const double endSpeed)
 {
     // the speeds must be 0 or greater!
     jassert (startSpeed >= 0 && endSpeed >= 0)
@@ -231,7 +414,7 @@ void ComponentAnimator::animateComponent (Component* const component,
         }
 
         at->reset (finalBounds, finalAlpha, millisecondsToSpendMoving,
-                   useProxyComponent, startSpeed, endSpeed);
+                   useProxyComponent, useCompositing, layerImageType, startSpeed, endSpeed);
 
         if (! isTimerRunning())
         {
@@ -103,6 +103,46 @@ public:
                            double startSpeed,
                            double endSpeed);
 
+    /** Starts a component moving and/or fading without making it re-layout or repaint
+        itself on each step of the animation.
+
+        This works like animateComponent(), but rather than calling setBounds() on every
+        step, it leaves the component at its original bounds and gives it a transform (see
+        Component::setTransform()) which maps it onto its current position and size. The
+        component is drawn from a cached image of its contents, so each step just composites
+        that image with a new transform and alpha level - the component only gets repainted
+        if its content actually changes while it's moving, and its resized() method is only
+        called once, when it reaches its final bounds.
+
+        If the component doesn't already have a CachedComponentImage, one is attached to it
+        for the duration of the animation, using the type of image that was set with
+        setLayerImageType().
+
+        Because the cached image is stretched while the size changes, this works best for
+        movements and fades, or for components whose contents scale nicely. If the component
+        already has a transform, or its start or end size is empty, it's moved with
+        setBounds() instead, although it'll still be drawn from its cached image.
+
+        @see animateComponent, setLayerImageType
+    */
+    void animateComponentComposited (Component* component,
+                                     const Rectangle<int>& finalBounds,
+                                     float finalAlpha,
+                                     int animationDurationMilliseconds,
+                                     double startSpeed,
+                                     double endSpeed);
+
+    /** Sets the type of image that animateComponentComposited() uses to cache the components
+        that it's animating.
+
+        By default a NativeImageType is used. If the components are being rendered by an
+        OpenGLContext, you can give it an OpenGLImageType, so that the cached images live in
+        textures and can be composited by the GPU without being uploaded again on each frame.
+
+        The animator takes ownership of the object. Passing nullptr reverts to the default.
+    */
+    void setLayerImageType (ImageType* newImageType);
+
     /** Begins a fade-out of this components alpha level.
         This is a quick way of invoking animateComponent() with a target alpha value of 0.0f, using
         a proxy. You're safe to delete the component after calling this method, and this won't
@@ -152,9 +192,11 @@ private:
     //==============================================================================
     class AnimationTask;
     OwnedArray <AnimationTask> tasks;
+    ScopedPointer <ImageType> layerImageType;
     uint32 lastTime;
 
     AnimationTask* findTaskFor (Component* component) const noexcept;
+    void startAnimation (Component*, const Rectangle<int>&, float, int, bool, bool, double, double);
     void timerCallback();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ComponentAnimator)
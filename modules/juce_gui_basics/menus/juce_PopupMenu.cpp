@@ -100,7 +100,7 @@ public:
     {}
 
     bool canBeTriggered() const noexcept    { return isActive && itemID != 0 && itemID != PopupMenuSettings::sectionHeaderID; }
-    bool hasActiveSubMenu() const noexcept  { return isActive && subMenu != nullptr && subMenu->items.size() > 0; }
+    bool hasActiveSubMenu() const           { return isActive && subMenu != nullptr && subMenu->hasItems(); }
 
     //==============================================================================
     const int itemID;
@@ -125,6 +125,7 @@ class PopupMenu::ItemComponent  : public Component
 public:
     ItemComponent (const PopupMenu::Item& info, int standardItemHeight, Component* const parent)
       : itemInfo (info),
+        rowIndex (-1),
         isHighlighted (false)
     {
         addAndMakeVisible (itemInfo.customComp);
@@ -174,7 +175,7 @@ public:
                                     itemInfo.isActive,
                                     isHighlighted,
                                     itemInfo.isTicked,
-                                    itemInfo.subMenu != nullptr && (itemInfo.itemID == 0 || itemInfo.subMenu->getNumItems() > 0),
+                                    itemInfo.subMenu != nullptr && (itemInfo.itemID == 0 || itemInfo.subMenu->hasItems()),
                                     mainText, endText,
                                     itemInfo.image.isValid() ? &itemInfo.image : nullptr,
                                     itemInfo.usesColour ? &(itemInfo.textColour) : nullptr);
@@ -203,6 +204,7 @@ public:
     }
 
     PopupMenu::Item itemInfo;
+    int rowIndex;   // (only used in a menu that has an ItemProvider)
 
 private:
     bool isHighlighted;
@@ -238,6 +240,11 @@ public:
          numColumns (0),
          contentHeight (0),
          childYOffset (0),
+         provider (menu.itemProvider),
+         numRows (0),
+         rowHeight (0),
+         rowWidth (0),
+         firstRow (0),
          menuCreationTime (Time::getMillisecondCounter()),
          lastMouseMoveTime (0),
          timeEnteredCurrentChildComp (0),
@@ -254,12 +261,19 @@ public:
         setOpaque (getLookAndFeel().findColour (PopupMenu::backgroundColourId).isOpaque()
                      || ! Desktop::canUseSemiTransparentWindows());
 
-        for (int i = 0; i < menu.items.size(); ++i)
+        if (provider != nullptr)
         {
-            PopupMenu::Item* const item = menu.items.getUnchecked(i);
+            measureRows (menu);
+        }
+        else
+        {
+            for (int i = 0; i < menu.items.size(); ++i)
+            {
+                PopupMenu::Item* const item = menu.items.getUnchecked(i);
 
-            if (i < menu.items.size() - 1 || ! item->isSeparator)
-                items.add (new PopupMenu::ItemComponent (*item, options.standardHeight, this));
+                if (i < menu.items.size() - 1 || ! item->isSeparator)
+                    items.add (new PopupMenu::ItemComponent (*item, options.standardHeight, this));
+            }
         }
 
         calculateWindowPos (options.targetArea, alignToRectangle);
@@ -542,6 +556,11 @@ private:
     bool dismissOnMouseUp, hideOnExit, disableMouseMoves, hasAnyJuceCompHadFocus;
     int numColumns, contentHeight, childYOffset;
     Array<int> columnWidths;
+
+    // When the menu has an ItemProvider, the items array only holds the components for
+    // the visible rows, starting at firstRow.
+    const ReferenceCountedObjectPtr<PopupMenu::ItemProvider> provider;
+    int numRows, rowHeight, rowWidth, firstRow;
     uint32 menuCreationTime, lastFocusedTime, lastScrollTime, lastMouseMoveTime, timeEnteredCurrentChildComp;
     double scrollAcceleration;
 
@@ -705,7 +724,12 @@ private:
 
         const int maximumNumColumns = options.maxColumns > 0 ? options.maxColumns : 7;
 
-        do
+        if (provider != nullptr)
+        {
+            numColumns = 1;
+            workOutBestSize (maxMenuW);
+        }
+        else do
         {
             ++numColumns;
             totalW = workOutBestSize (maxMenuW);
@@ -733,6 +757,13 @@ private:
 
     int workOutBestSize (const int maxMenuW)
     {
+        if (provider != nullptr)
+        {
+            contentHeight = numRows * rowHeight;
+            columnWidths.set (0, jmax (options.minWidth, jmin (maxMenuW, rowWidth + PopupMenuSettings::borderSize * 2)));
+            return columnWidths[0];
+        }
+
         int totalW = 0;
         contentHeight = 0;
         int childNum = 0;
@@ -774,6 +805,23 @@ private:
     {
         jassert (itemID != 0)
 
+        if (provider != nullptr)
+        {
+            const int row = provider->getIndexOfItemWithID (itemID);
+
+            if (isPositiveAndBelow (row, numRows))
+            {
+                if (wantedY < 0)
+                    wantedY = (windowPos.getHeight() - rowHeight) / 2;
+
+                childYOffset = jlimit (0, jmax (0, contentHeight - windowPos.getHeight() + PopupMenuSettings::borderSize * 2),
+                                       row * rowHeight + PopupMenuSettings::borderSize - wantedY);
+                updateYPositions();
+            }
+
+            return;
+        }
+
         for (int i = items.size(); --i >= 0;)
         {
             PopupMenu::ItemComponent* const m = items.getUnchecked(i);
@@ -866,6 +914,9 @@ private:
 
     int updateYPositions()
     {
+        if (provider != nullptr)
+            return updateVisibleRows();
+
         int x = 0;
         int childNum = 0;
 
@@ -892,6 +943,108 @@ private:
         return x;
     }
 
+    //==============================================================================
+    void measureRows (const PopupMenu& menu)
+    {
+        numRows = jmax (0, provider->getNumItems());
+
+        int w = 80;
+        rowHeight = 16;
+        getLookAndFeel().getIdealPopupMenuItemSize ("Ag", false, options.standardHeight, w, rowHeight);
+        rowHeight = jlimit (2, 600, rowHeight);
+
+        rowWidth = provider->getIdealItemWidth();
+
+        if (rowWidth <= 0)
+        {
+            for (int i = 0; i < jmin (numRows, 100); ++i)
+            {
+                const ScopedPointer<PopupMenu::Item> item (menu.createItemFromProvider (i));
+                const PopupMenu::ItemComponent c (*item, options.standardHeight, this);
+                rowWidth = jmax (rowWidth, c.getWidth());
+            }
+        }
+    }
+
+    // Creates the components for the rows that are on-screen, reusing the ones that were
+    // already visible, and deletes the ones that have scrolled out of view.
+    int updateVisibleRows()
+    {
+        const int colW = columnWidths [0];
+        const int row0Y = PopupMenuSettings::borderSize - (childYOffset + (getY() - windowPos.getY()));
+        const int visibleHeight = jmax (getHeight(), windowPos.getHeight());
+
+        const int newFirstRow = jlimit (0, numRows, -row0Y / rowHeight);
+        const int newLastRow  = jlimit (newFirstRow, numRows, (visibleHeight - row0Y) / rowHeight + 1);
+
+        OwnedArray<PopupMenu::ItemComponent> newItems;
+
+        for (int row = newFirstRow; row < newLastRow; ++row)
+        {
+            const int oldIndex = row - firstRow;
+            PopupMenu::ItemComponent* c = items [oldIndex];
+
+            if (c != nullptr)
+            {
+                items.set (oldIndex, nullptr, false);
+            }
+            else
+            {
+                const ScopedPointer<PopupMenu::Item> item (menuItemForRow (row));
+                c = new PopupMenu::ItemComponent (*item, options.standardHeight, this);
+                c->rowIndex = row;
+            }
+
+            newItems.add (c);
+            c->setBounds (0, row0Y + row * rowHeight, colW, rowHeight);
+        }
+
+        items.swapWithArray (newItems);
+        firstRow = newFirstRow;
+
+        return colW;
+    }
+
+    PopupMenu::Item* menuItemForRow (const int row) const
+    {
+        PopupMenu menu;
+        menu.setItemProvider (provider);
+        return menu.createItemFromProvider (row);
+    }
+
+    PopupMenu::ItemComponent* scrollToRow (const int row)
+    {
+        const int zone = canScroll() ? PopupMenuSettings::scrollZone : 0;
+        const int rowY = PopupMenuSettings::borderSize - childYOffset + row * rowHeight;
+
+        if (rowY < zone)
+            alterChildYPos (rowY - zone);
+        else if (rowY + rowHeight > getHeight() - zone)
+            alterChildYPos (rowY + rowHeight - (getHeight() - zone));
+
+        return items [row - firstRow];
+    }
+
+    void selectNextRow (const int delta)
+    {
+        int row = currentChild != nullptr ? currentChild->rowIndex
+                                          : (delta > 0 ? -1 : 0);
+
+        for (int i = numRows; --i >= 0;)
+        {
+            row = (row + delta + numRows) % numRows;
+
+            const ScopedPointer<PopupMenu::Item> item (menuItemForRow (row));
+
+            if (item->canBeTriggered() || item->hasActiveSubMenu())
+            {
+                setCurrentlyHighlightedChild (scrollToRow (row));
+                break;
+            }
+        }
+    }
+
+    //==============================================================================
     void setCurrentlyHighlightedChild (PopupMenu::ItemComponent* const child)
     {
         if (currentChild != nullptr)
@@ -1055,6 +1208,12 @@ private:
     {
         disableTimerUntilMouseMoves();
 
+        if (provider != nullptr)
+        {
+            selectNextRow (delta);
+            return;
+        }
+
         int start = jmax (0, items.indexOf (currentChild));
 
         for (int i = items.size(); --i >= 0;)
@@ -1129,7 +1288,8 @@ PopupMenu::PopupMenu()
 }
 
 PopupMenu::PopupMenu (const PopupMenu& other)
-    : lookAndFeel (other.lookAndFeel)
+    : itemProvider (other.itemProvider),
+      lookAndFeel (other.lookAndFeel)
 {
     items.addCopiesOf (other.items);
 }
@@ -1142,6 +1302,7 @@ PopupMenu& PopupMenu::operator= (const PopupMenu& other)
 
         clear();
         items.addCopiesOf (other.items);
+        itemProvider = other.itemProvider;
     }
 
     return *this;
@@ -1149,7 +1310,8 @@ PopupMenu& PopupMenu::operator= (const PopupMenu& other)
 
 #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
 PopupMenu::PopupMenu (PopupMenu&& other) noexcept
-    : lookAndFeel (other.lookAndFeel)
+    : itemProvider (static_cast <ReferenceCountedObjectPtr<ItemProvider>&&> (other.itemProvider)),
+      lookAndFeel (other.lookAndFeel)
 {
     items.swapWithArray (other.items);
 }
@@ -1159,6 +1321,7 @@ PopupMenu& PopupMenu::operator= (PopupMenu&& other) noexcept
     jassert (this != &other); // hopefully the compiler should make this situation impossible!
 
     items.swapWithArray (other.items);
+    itemProvider = static_cast <ReferenceCountedObjectPtr<ItemProvider>&&> (other.itemProvider);
     lookAndFeel = other.lookAndFeel;
     return *this;
 }
@@ -1171,6 +1334,33 @@ PopupMenu::~PopupMenu()
 void PopupMenu::clear()
 {
     items.clear();
+    itemProvider = nullptr;
+}
+
+void PopupMenu::setItemProvider (ItemProvider* const provider)
+{
+    items.clear();
+    itemProvider = provider;
+}
+
+bool PopupMenu::hasItems() const
+{
+    return items.size() > 0 || (itemProvider != nullptr && itemProvider->getNumItems() > 0);
+}
+
+PopupMenu::Item* PopupMenu::createItemFromProvider (const int index) const
+{
+    jassert (itemProvider != nullptr);
+
+    PopupMenu menu;
+    itemProvider->addItemTo (menu, index);
+
+    // The provider must add exactly one item for each index! (A separator gets
+    // ignored when it's the first item, so that's what an empty menu means here).
+    jassert (menu.items.size() <= 1 && menu.itemProvider == nullptr);
+
+    return menu.items.size() > 0 ? menu.items.removeAndReturn (0)
+                                 : new Item();
 }
 
 void PopupMenu::addItem (const int itemResultID, const String& itemText,
@@ -1390,7 +1580,7 @@ PopupMenu::Options PopupMenu::Options::withItemThatMustBeVisible (int idOfItemTo
 Component* PopupMenu::createWindow (const Options& options,
                                     ApplicationCommandManager** managerOfChosenCommand) const
 {
-    if (items.size() > 0)
+    if (hasItems())
         return new Window (*this, nullptr, options,
                            ! options.targetArea.isEmpty(),
                            ModifierKeys::getCurrentModifiers().isAnyMouseButtonDown(),
@@ -1548,6 +1738,9 @@ bool JUCE_CALLTYPE PopupMenu::dismissAllActiveMenus()
 //==============================================================================
 int PopupMenu::getNumItems() const noexcept
 {
+    if (itemProvider != nullptr)
+        return itemProvider->getNumItems();
+
     int num = 0;
 
     for (int i = items.size(); --i >= 0;)
@@ -1575,6 +1768,9 @@ bool PopupMenu::containsCommandItem (const int commandID) const
 
 bool PopupMenu::containsAnyActiveItems() const noexcept
 {
+    if (itemProvider != nullptr)
+        return itemProvider->getNumItems() > 0;
+
     for (int i = items.size(); --i >= 0;)
     {
         const Item& mi = *items.getUnchecked (i);
@@ -1658,13 +1854,19 @@ PopupMenu::MenuItemIterator::~MenuItemIterator()
 
 bool PopupMenu::MenuItemIterator::next()
 {
-    if (index >= menu.items.size())
+    const int numItems = menu.itemProvider != nullptr ? menu.itemProvider->getNumItems()
+                                                      : menu.items.size();
+    if (index >= numItems)
         return false;
 
-    const Item* const item = menu.items.getUnchecked (index);
+    if (menu.itemProvider != nullptr)
+        providerItem = menu.createItemFromProvider (index);
+
+    const Item* const item = menu.itemProvider != nullptr ? providerItem.get()
+                                                          : menu.items.getUnchecked (index);
     ++index;
 
-    if (item->isSeparator && index >= menu.items.size()) // (avoid showing a separator at the end)
+    if (item->isSeparator && index >= numItems) // (avoid showing a separator at the end)
         return false;
 
     itemName        = item->customComp != nullptr ? item->customComp->getName() : item->text;
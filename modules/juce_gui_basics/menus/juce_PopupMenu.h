@@ -79,6 +79,7 @@ class JUCE_API  PopupMenu
 {
 private:
     class Window;
+    class Item;
 
 public:
     //==============================================================================
@@ -201,7 +202,8 @@ public:
 
     /** Returns the number of items that the menu currently contains.
 
-        (This doesn't count separators).
+        (This doesn't count separators, except in a menu that uses an ItemProvider,
+        where it returns the provider's number of rows).
     */
     int getNumItems() const noexcept;
 
@@ -211,6 +213,67 @@ public:
     /** Returns true if the menu contains any items that can be used. */
     bool containsAnyActiveItems() const noexcept;
 
+    //==============================================================================
+    /** Supplies the items of a menu on demand, for menus with huge numbers of items.
+
+        A menu that's been given an ItemProvider doesn't store any items itself. When
+        it's shown, the menu window only creates components for the rows that are
+        actually visible, and asks the provider for each item as it scrolls into view.
+        If the sub-menus also have providers, they aren't built until they're opened,
+        so even a menu tree with many thousands of items can open instantly.
+
+        All the rows of a provider-based menu are given the standard item height, and
+        are laid out in a single scrolling column.
+
+        @see setItemProvider
+    */
+    class JUCE_API  ItemProvider  : public ReferenceCountedObject
+    {
+    public:
+        /** Destructor. */
+        virtual ~ItemProvider() {}
+
+        /** Returns the number of rows in the menu, including any separators. */
+        virtual int getNumItems() = 0;
+
+        /** Adds the item at the given index to a menu.
+
+            Your implementation must call exactly one of the methods that adds an item to
+            the menu that's passed in, e.g. addItem(), addSubMenu(), addCustomItem(),
+            addSectionHeader() or addSeparator(). To make a sub-menu that's only built when
+            it's opened, pass addSubMenu() a menu that has its own ItemProvider.
+
+            This is called on the message thread whenever a row becomes visible, so it
+            needs to be quick.
+        */
+        virtual void addItemTo (PopupMenu& menu, int index) = 0;
+
+        /** Returns the width that the rows should be given.
+
+            If this returns 0 (the default), the menu measures the first 100 items, and
+            uses the widest of those.
+        */
+        virtual int getIdealItemWidth()                         { return 0; }
+
+        /** Returns the index of the item with the given ID, or -1 if it isn't known.
+
+            This is used to find the item for Options::withItemThatMustBeVisible(). The
+            default implementation returns -1.
+        */
+        virtual int getIndexOfItemWithID (int /*itemID*/)       { return -1; }
+    };
+
+    /** Makes this menu get its items from an ItemProvider.
+
+        This removes any items that the menu already contains. The menu keeps a reference
+        to the provider, and copying the menu just copies that reference, so it's cheap to
+        pass a provider-based menu to addSubMenu(). Don't add any other items to a menu
+        once it has a provider.
+
+        @see ItemProvider
+    */
+    void setItemProvider (ItemProvider* provider);
+
     //==============================================================================
     /** Class used to create a set of options to pass to the show() method.
         You can chain together a series of calls to this class's methods to create
@@ -416,6 +479,7 @@ public:
         //==============================================================================
         const PopupMenu& menu;
         int index;
+        ScopedPointer<Item> providerItem;
 
         MenuItemIterator& operator= (const MenuItemIterator&);
         JUCE_LEAK_DETECTOR (MenuItemIterator)
@@ -483,7 +547,6 @@ public:
 
 private:
     //==============================================================================
-    class Item;
     class ItemComponent;
     class HeaderItemComponent;
     class NormalComponentWrapper;
@@ -496,10 +559,15 @@ private:
     friend class OwnedArray <Item>;
     friend class OwnedArray <ItemComponent>;
     friend class ScopedPointer <Window>;
+    friend class ScopedPointer <Item>;
 
     OwnedArray <Item> items;
+    ReferenceCountedObjectPtr<ItemProvider> itemProvider;
     LookAndFeel* lookAndFeel;
 
+    bool hasItems() const;
+    Item* createItemFromProvider (int index) const;
+
     Component* createWindow (const Options&, ApplicationCommandManager**) const;
     int showWithOptionalCallback (const Options&, ModalComponentManager::Callback*, bool);
 
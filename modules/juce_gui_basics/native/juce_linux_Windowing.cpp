@@ -1831,6 +1831,11 @@ private:
                 startTimer (repaintTimerPeriod);
 
             regionsNeedingRepaint.add (area);
+
+            // lots of small animated components can invalidate hundreds of areas between
+            // repaints, so keep the list short enough that adding to it stays cheap.
+            if (regionsNeedingRepaint.getNumRectangles() > maxPendingRectangles)
+                LinuxComponentPeer::simplifyRepaintRegion (regionsNeedingRepaint);
         }
 
         void performAnyPendingRepaintsNow()
@@ -1845,6 +1850,8 @@ private:
 
             peer.clearMaskedRegion();
 
+            LinuxComponentPeer::simplifyRepaintRegion (regionsNeedingRepaint);
+
             RectangleList originalRepaintRegion (regionsNeedingRepaint);
             regionsNeedingRepaint.clear();
             const Rectangle<int> totalArea (originalRepaintRegion.getBounds());
@@ -1905,7 +1912,7 @@ private:
        #endif
 
     private:
-        enum { repaintTimerPeriod = 1000 / 100 };
+        enum { repaintTimerPeriod = 1000 / 100, maxPendingRectangles = 64 };
 
         LinuxComponentPeer& peer;
         Image image;
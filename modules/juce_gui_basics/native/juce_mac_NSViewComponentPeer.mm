@@ -778,6 +778,7 @@ public:
 
             RectangleList clip;
             getClipRects (clip, offset, clipW, clipH);
+            simplifyRepaintRegion (clip);
 
             if (! clip.isEmpty())
             {
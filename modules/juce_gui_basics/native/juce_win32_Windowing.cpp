@@ -1520,6 +1520,10 @@ private:
                     contextClip.clear();
                     contextClip.addWithoutMerging (Rectangle<int> (w, h));
                 }
+                else
+                {
+                    simplifyRepaintRegion (contextClip);
+                }
 
                 if (transparent)
                 {
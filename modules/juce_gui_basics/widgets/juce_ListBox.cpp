@@ -28,7 +28,7 @@ class ListBox::RowComponent  : public Component,
 {
 public:
     RowComponent (ListBox& lb)
-        : owner (lb), row (-1),
+        : needsRefresh (false), owner (lb), row (-1),
           selected (false), isDragging (false), selectRowOnMouseUp (false)
     {
     }
@@ -47,6 +47,12 @@ public:
             row = newRow;
             selected = nowSelected;
         }
+        else if (! needsRefresh)
+        {
+            return; // (nothing's changed for this row, so there's no need to bother the model)
+        }
+
+        needsRefresh = false;
 
         if (ListBoxModel* m = owner.getModel())
         {
@@ -136,6 +142,7 @@ public:
     }
 
     ScopedPointer<Component> customComponent;
+    bool needsRefresh;
 
 private:
     ListBox& owner;
@@ -151,7 +158,8 @@ class ListBox::ListViewport  : public Viewport
 {
 public:
     ListViewport (ListBox& lb)
-        : owner (lb)
+        : owner (lb), firstIndex (0), firstWholeIndex (0), lastWholeIndex (0),
+          hasUpdated (false)
     {
         setWantsKeyboardFocus (false);
 
@@ -171,6 +179,14 @@ public:
                  ? getComponentForRow (row) : nullptr;
     }
 
+    void refreshAllRows()
+    {
+        for (int i = rows.size(); --i >= 0;)
+            rows.getUnchecked (i)->needsRefresh = true;
+
+        lastPrefetchedRows = Range<int>();
+    }
+
     int getRowNumberOfComponent (Component* const rowComponent) const noexcept
     {
         const int index = getIndexOfChildComponent (rowComponent);
@@ -229,6 +245,7 @@ public:
                 getViewedComponent()->addAndMakeVisible (newRow);
             }
 
+            const int oldFirstIndex = firstIndex;
             firstIndex = y / rowH;
             firstWholeIndex = (y + rowH - 1) / rowH;
             lastWholeIndex = (y + getMaximumVisibleHeight() - 1) / rowH;
@@ -243,6 +260,9 @@ public:
                     rowComp->update (row, owner.isRowSelected (row));
                 }
             }
+
+            prefetchRows (firstIndex < oldFirstIndex ? Range<int> (firstIndex - numNeeded, firstIndex)
+                                                     : Range<int> (firstIndex + numNeeded, firstIndex + numNeeded * 2));
         }
 
         if (owner.headerComponent != nullptr)
@@ -330,6 +350,20 @@ private:
     OwnedArray<RowComponent> rows;
     int firstIndex, firstWholeIndex, lastWholeIndex;
     bool hasUpdated;
+    Range<int> lastPrefetchedRows;
+
+    void prefetchRows (Range<int> rowsToFetch)
+    {
+        rowsToFetch = rowsToFetch.getIntersectionWith (Range<int> (0, owner.totalItems));
+
+        if (rowsToFetch != lastPrefetchedRows && ! rowsToFetch.isEmpty())
+        {
+            lastPrefetchedRows = rowsToFetch;
+
+            if (ListBoxModel* m = owner.getModel())
+                m->prefetchRows (rowsToFetch.getStart(), rowsToFetch.getLength());
+        }
+    }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ListViewport)
 };
@@ -459,6 +493,8 @@ void ListBox::updateContent()
 
     bool selectionChanged = false;
 
+    viewport->refreshAllRows();
+
     if (selected.size() > 0 && selected [selected.size() - 1] >= totalItems)
     {
         selected.removeRange (Range <int> (totalItems, std::numeric_limits<int>::max()));
@@ -879,6 +915,16 @@ void ListBox::repaintRow (const int rowNumber) noexcept
     repaint (getRowPosition (rowNumber, true));
 }
 
+void ListBox::refreshRow (const int rowNumber)
+{
+    if (RowComponent* const rowComp = viewport->getComponentForRowIfOnscreen (rowNumber))
+    {
+        rowComp->needsRefresh = true;
+        rowComp->update (rowNumber, isRowSelected (rowNumber));
+        rowComp->repaint();
+    }
+}
+
 Image ListBox::createSnapshotOfSelectedRows (int& imageX, int& imageY)
 {
     Rectangle<int> imageArea;
@@ -958,5 +1004,6 @@ void ListBoxModel::selectedRowsChanged (int) {}
 void ListBoxModel::deleteKeyPressed (int) {}
 void ListBoxModel::returnKeyPressed (int) {}
 void ListBoxModel::listWasScrolled() {}
+void ListBoxModel::prefetchRows (int, int) {}
 var ListBoxModel::getDragSourceDescription (const SparseSet<int>&)      { return var::null; }
 String ListBoxModel::getTooltipForRow (int)                             { return String::empty; }
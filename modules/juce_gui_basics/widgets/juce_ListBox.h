@@ -62,7 +62,9 @@ public:
         and handle mouse clicks with listBoxItemClicked().
 
         This method will be called whenever a custom component might need to be updated - e.g.
-        when the table is changed, or TableListBox::updateContent() is called.
+        when a different row scrolls into view, when the row is selected or deselected, or
+        when ListBox::updateContent() or ListBox::refreshRow() is called. Rows that stay on
+        screen while the list is scrolled aren't refreshed again.
 
         If you don't need a custom component for the specified row, then return nullptr.
         (Bear in mind that even if you're not creating a new component, you may still need to
@@ -142,6 +144,16 @@ public:
     */
     virtual void listWasScrolled();
 
+    /** Called when the list is scrolled, to let the model prepare the rows that are about to appear.
+
+        The range covers about a screenful of rows beyond the visible ones, in the direction
+        that the list is moving. If your row data is slow to get hold of (e.g. from a database
+        or a network), this is a good place to start loading it on a background thread, so
+        that it's ready by the time the rows are shown. If some data arrives after its row is
+        already on screen, call ListBox::refreshRow() on the message thread to show it.
+    */
+    virtual void prefetchRows (int firstRow, int numRows);
+
     /** To allow rows from your list to be dragged-and-dropped, implement this method.
 
         If this returns a non-null variant then when the user drags a row, the listbox will
@@ -205,6 +217,17 @@ public:
     */
     void updateContent();
 
+    /** Makes the list re-query the model for one of its rows.
+
+        If the row is on screen, this calls refreshComponentForRow() for it and repaints it.
+        It's a cheaper alternative to updateContent() for when the data for a single row has
+        changed, e.g. when a model that loads its rows asynchronously has some new data ready.
+
+        This must only be called from the main message thread.
+        @see ListBoxModel::prefetchRows
+    */
+    void refreshRow (int rowNumber);
+
     //==============================================================================
     /** Turns on multiple-selection of rows.
 
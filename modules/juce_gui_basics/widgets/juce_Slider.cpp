@@ -56,12 +56,20 @@ public:
         useDragEvents (false),
         scrollWheelEnabled (true),
         snapsToMousePos (true),
+        highRateUpdates (false),
+        hasPendingFrameUpdate (false),
+        pendingFrameNotification (false),
+        displayedValue (0),
         parentForPopupDisplay (nullptr)
     {
     }
 
     ~Pimpl()
     {
+        if (hasPendingFrameUpdate)
+            if (FrameUpdater* const updater = FrameUpdater::getInstanceWithoutCreating())
+                updater->remove (this);
+
         currentValue.removeListener (this);
         valueMin.removeListener (this);
         valueMax.removeListener (this);
@@ -191,6 +199,20 @@ public:
             if (currentValue != newValue)
                 currentValue = newValue;
 
+            if (highRateUpdates && sliderBeingDragged < 0)
+            {
+                if (notification != dontSendNotification)
+                    pendingFrameNotification = true;
+
+                if (! hasPendingFrameUpdate)
+                {
+                    hasPendingFrameUpdate = true;
+                    FrameUpdater::getInstance()->add (this);
+                }
+
+                return;
+            }
+
             updateText();
             owner.repaint();
 
@@ -330,6 +352,112 @@ public:
         }
     }
 
+    //==============================================================================
+    void setHighRateUpdateMode (const bool shouldCoalesceUpdates)
+    {
+        if (highRateUpdates != shouldCoalesceUpdates)
+        {
+            highRateUpdates = shouldCoalesceUpdates;
+            backgroundCache = Image::null;
+
+            if (! highRateUpdates && hasPendingFrameUpdate)
+            {
+                FrameUpdater::getInstance()->remove (this);
+                handleFrameUpdate();
+            }
+
+            owner.repaint();
+        }
+    }
+
+    void handleFrameUpdate()
+    {
+        hasPendingFrameUpdate = false;
+        const bool needsNotification = pendingFrameNotification;
+        pendingFrameNotification = false;
+
+        updateText();
+        repaintAreaAroundThumb();
+
+        if (popupDisplay != nullptr)
+            popupDisplay->updatePosition (owner.getTextFromValue (lastCurrentValue));
+
+        if (needsNotification)
+            triggerChangeMessage (sendNotificationSync);
+    }
+
+    void repaintAreaAroundThumb()
+    {
+        if (style == IncDecButtons)
+            return;
+
+        if (isRotary())
+        {
+            owner.repaint (sliderRect);
+            return;
+        }
+
+        const float oldPos = getLinearSliderPos (displayedValue);
+        const float newPos = getLinearSliderPos (lastCurrentValue);
+        const int margin = owner.getLookAndFeel().getSliderThumbRadius (owner) * 2 + 2;
+        const int start = (int) std::floor (jmin (oldPos, newPos)) - margin;
+        const int end   = (int) std::ceil  (jmax (oldPos, newPos)) + margin;
+
+        if (isHorizontal())
+            owner.repaint (start, 0, end - start, owner.getHeight());
+        else
+            owner.repaint (0, start, owner.getWidth(), end - start);
+    }
+
+    /*  Gives all the sliders that have had their values changed in high-rate mode
+        a single update on each display frame.
+    */
+    class FrameUpdater  : public Timer,
+                          private DeletedAtShutdown
+    {
+    public:
+        FrameUpdater() {}
+        ~FrameUpdater()     { clearSingletonInstance(); }
+
+        juce_DeclareSingleton_SingleThreaded_Minimal (FrameUpdater);
+
+        void add (Pimpl* const p)
+        {
+            pending.add (p);
+
+            if (! isTimerRunning())
+                startTimer (1000 / 60);
+        }
+
+        void remove (Pimpl* const p)
+        {
+            pending.removeFirstMatchingValue (p);
+            updating.removeFirstMatchingValue (p);
+        }
+
+        void timerCallback()
+        {
+            // (the sliders are taken from a separate list, so that any of them can be safely
+            // deleted or changed again by the callbacks while this is going on)
+            updating.swapWithArray (pending);
+
+            while (updating.size() > 0)
+            {
+                Pimpl* const p = updating.getLast();
+                updating.removeLast();
+                p->handleFrameUpdate();
+            }
+
+            if (pending.size() == 0)
+                stopTimer();
+        }
+
+    private:
+        Array<Pimpl*> pending, updating;
+
+        JUCE_DECLARE_NON_COPYABLE (FrameUpdater)
+    };
+
     void handleAsyncUpdate()
     {
         cancelPendingUpdate();
@@ -628,6 +756,7 @@ public:
 
         owner.setComponentEffect (lf.getSliderEffect());
 
+        backgroundCache = Image::null;
         owner.resized();
         owner.repaint();
     }
@@ -1068,9 +1197,15 @@ public:
     //==============================================================================
     void paint (Graphics& g, LookAndFeel& lf)
     {
+        displayedValue = lastCurrentValue;
+
         if (style != IncDecButtons)
         {
-            if (isRotary())
+            if (highRateUpdates && ! (isRotary() || style == LinearBar || style == LinearBarVertical))
+            {
+                paintWithCachedBackground (g, lf);
+            }
+            else if (isRotary())
             {
                 const float sliderPos = (float) owner.valueToProportionOfLength (lastCurrentValue);
                 jassert (sliderPos >= 0 && sliderPos <= 1.0f);
@@ -1099,8 +1234,36 @@ public:
         }
     }
 
+    void paintWithCachedBackground (Graphics& g, LookAndFeel& lf)
+    {
+        const float sliderPos = getLinearSliderPos (lastCurrentValue);
+        const float minSliderPos = getLinearSliderPos (lastValueMin);
+        const float maxSliderPos = getLinearSliderPos (lastValueMax);
+
+        if (backgroundCache.isNull()
+             || backgroundCache.getWidth() != owner.getWidth()
+             || backgroundCache.getHeight() != owner.getHeight())
+        {
+            backgroundCache = Image (Image::ARGB, jmax (1, owner.getWidth()), jmax (1, owner.getHeight()), true);
+
+            Graphics bg (backgroundCache);
+            bg.fillAll (owner.findColour (Slider::backgroundColourId));
+            lf.drawLinearSliderBackground (bg, sliderRect.getX(), sliderRect.getY(),
+                                           sliderRect.getWidth(), sliderRect.getHeight(),
+                                           sliderPos, minSliderPos, maxSliderPos, style, owner);
+        }
+
+        g.drawImageAt (backgroundCache, 0, 0);
+
+        lf.drawLinearSliderThumb (g, sliderRect.getX(), sliderRect.getY(),
+                                  sliderRect.getWidth(), sliderRect.getHeight(),
+                                  sliderPos, minSliderPos, maxSliderPos, style, owner);
+    }
+
     void resized (const Rectangle<int>& localBounds, LookAndFeel& lf)
     {
+        backgroundCache = Image::null;
+
         int minXSpace = 0;
         int minYSpace = 0;
 
@@ -1248,6 +1411,11 @@ public:
     bool incDecDragged;
     bool scrollWheelEnabled;
     bool snapsToMousePos;
+    bool highRateUpdates;
+    bool hasPendingFrameUpdate;
+    bool pendingFrameNotification;
+    double displayedValue;
+    Image backgroundCache;
 
     ScopedPointer<Label> valueBox;
     ScopedPointer<Button> incButton, decButton;
@@ -1309,6 +1477,8 @@ public:
     }
 };
 
+juce_ImplementSingleton_SingleThreaded (Slider::Pimpl::FrameUpdater)
+
 
 //==============================================================================
 Slider::Slider()
@@ -1410,6 +1580,9 @@ void Slider::setChangeNotificationOnlyOnRelease (bool onlyNotifyOnRelease)
     pimpl->sendChangeOnlyOnRelease = onlyNotifyOnRelease;
 }
 
+void Slider::setHighRateUpdateMode (const bool shouldCoalesceUpdates)  { pimpl->setHighRateUpdateMode (shouldCoalesceUpdates); }
+bool Slider::isInHighRateUpdateMode() const noexcept                   { return pimpl->highRateUpdates; }
+
 bool Slider::getSliderSnapsToMousePosition() const noexcept                 { return pimpl->snapsToMousePos; }
 void Slider::setSliderSnapsToMousePosition (const bool shouldSnapToMouse)   { pimpl->snapsToMousePos = shouldSnapToMouse; }
 
@@ -1424,7 +1597,7 @@ Component* Slider::getCurrentPopupDisplay() const noexcept      { return pimpl->
 //==============================================================================
 void Slider::colourChanged()        { lookAndFeelChanged(); }
 void Slider::lookAndFeelChanged()   { pimpl->lookAndFeelChanged (getLookAndFeel()); }
-void Slider::enablementChanged()    { repaint(); }
+void Slider::enablementChanged()    { pimpl->backgroundCache = Image::null; repaint(); }
 
 //==============================================================================
 double Slider::getMaximum() const noexcept      { return pimpl->maximum; }
@@ -568,6 +568,37 @@ public:
     */
     void setChangeNotificationOnlyOnRelease (bool onlyNotifyOnRelease);
 
+    /** Puts the slider into a mode that's designed for sliders and meters whose values
+        are being changed very frequently by your code, e.g. to follow an audio engine.
+
+        When this is enabled:
+        - setValue() just stores the new value, so getValue() and the Value object
+          return it immediately, but updating the text-box, repainting, and calling
+          valueChanged() and the listeners are all done at most once per display frame,
+          however many times the value was changed in between. This also applies to
+          changes made with sendNotificationSync.
+        - For the linear styles, only the strip between the old and new thumb positions
+          is repainted, rather than the whole slider.
+        - For the linear styles other than LinearBar and LinearBarVertical, the slider
+          is drawn with LookAndFeel::drawLinearSliderBackground(), whose output is cached,
+          followed by LookAndFeel::drawLinearSliderThumb(), rather than by calling
+          LookAndFeel::drawLinearSlider().
+
+        Changes made while the user is dragging the slider are still dealt with straight
+        away.
+
+        Because of the partial repaints and the cached background, this relies on the
+        LookAndFeel drawing nothing that depends on the slider's value outside the area
+        around the thumb, and on the background not depending on the value at all. This
+        is true for the standard LookAndFeel classes.
+
+        @see isInHighRateUpdateMode
+    */
+    void setHighRateUpdateMode (bool shouldCoalesceUpdates);
+
+    /** Returns true if setHighRateUpdateMode() has been enabled. */
+    bool isInHighRateUpdateMode() const noexcept;
+
     /** This lets you change whether the slider thumb jumps to the mouse position
         when you click.
 
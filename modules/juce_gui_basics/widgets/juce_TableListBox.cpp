@@ -411,10 +411,17 @@ void TableListBox::listWasScrolled()
         model->listWasScrolled();
 }
 
+void TableListBox::prefetchRows (int firstRow, int numRows)
+{
+    if (model != nullptr)
+        model->prefetchRows (firstRow, numRows);
+}
+
 void TableListBox::tableColumnsChanged (TableHeaderComponent*)
 {
     setMinimumContentWidth (header->getTotalWidth());
     repaint();
+    updateContent(); // (the rows need to create or remove their cell components)
     updateColumnComponents();
 }
 
@@ -465,6 +472,7 @@ void TableListBoxModel::selectedRowsChanged (int)                       {}
 void TableListBoxModel::deleteKeyPressed (int)                          {}
 void TableListBoxModel::returnKeyPressed (int)                          {}
 void TableListBoxModel::listWasScrolled()                               {}
+void TableListBoxModel::prefetchRows (int, int)                         {}
 
 String TableListBoxModel::getCellTooltip (int /*rowNumber*/, int /*columnId*/)    { return String::empty; }
 var TableListBoxModel::getDragSourceDescription (const SparseSet<int>&)           { return var::null; }
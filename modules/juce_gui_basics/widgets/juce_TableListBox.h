@@ -84,7 +84,9 @@ public:
         and handle mouse clicks with cellClicked().
 
         This method will be called whenever a custom component might need to be updated - e.g.
-        when the table is changed, or TableListBox::updateContent() is called.
+        when a different row scrolls into view, when the columns are changed, or when
+        TableListBox::updateContent() or TableListBox::refreshRow() is called. Rows that stay
+        on screen while the table is scrolled aren't refreshed again.
 
         If you don't need a custom component for the specified cell, then return nullptr.
         (Bear in mind that even if you're not creating a new component, you may still need to
@@ -176,6 +178,11 @@ public:
     */
     virtual void listWasScrolled();
 
+    /** Called when the table is scrolled, to let the model prepare the rows that are about to appear.
+        @see ListBoxModel::prefetchRows
+    */
+    virtual void prefetchRows (int firstRow, int numRows);
+
     /** To allow rows from your table to be dragged-and-dropped, implement this method.
 
         If this returns a non-null variant then when the user drags a row, the table will try to
@@ -311,6 +318,8 @@ public:
     /** @internal */
     void listWasScrolled();
     /** @internal */
+    void prefetchRows (int firstRow, int numRows);
+    /** @internal */
     void tableColumnsChanged (TableHeaderComponent*);
     /** @internal */
     void tableColumnsResized (TableHeaderComponent*);
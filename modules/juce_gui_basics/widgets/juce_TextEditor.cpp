@@ -62,13 +62,13 @@ class TextEditor::UniformTextSection
 {
 public:
     UniformTextSection (const String& text, const Font& f, const Colour col, const juce_wchar passwordChar)
-        : font (f), colour (col)
+        : font (f), colour (col), totalLength (0)
     {
         initialiseAtoms (text, passwordChar);
     }
 
     UniformTextSection (const UniformTextSection& other)
-        : font (other.font), colour (other.colour)
+        : font (other.font), colour (other.colour), totalLength (other.totalLength)
     {
         atoms.ensureStorageAllocated (other.atoms.size());
 
@@ -84,41 +84,61 @@ public:
             delete atoms.getUnchecked (i);
 
         atoms.clear();
+        totalLength = 0;
     }
 
-    void append (const UniformTextSection& other, const juce_wchar passwordChar)
+    void append (UniformTextSection& other, const juce_wchar passwordChar)
     {
-        if (other.atoms.size() > 0)
-        {
-            int i = 0;
+        joinSplitWord (other, passwordChar);
 
-            if (TextAtom* const lastAtom = atoms.getLast())
-            {
-                if (! CharacterFunctions::isWhitespace (lastAtom->atomText.getLastCharacter()))
-                {
-                    TextAtom* const first = other.atoms.getUnchecked(0);
+        atoms.addArray (other.atoms);
+        totalLength += other.totalLength;
 
-                    if (! CharacterFunctions::isWhitespace (first->atomText[0]))
-                    {
-                        lastAtom->atomText += first->atomText;
-                        lastAtom->numChars = (uint16) (lastAtom->numChars + first->numChars);
-                        lastAtom->width = font.getStringWidthFloat (lastAtom->getText (passwordChar));
-                        delete first;
-                        ++i;
-                    }
-                }
-            }
+        other.atoms.clear();
+        other.totalLength = 0;
+    }
 
-            atoms.ensureStorageAllocated (atoms.size() + other.atoms.size() - i);
+    // If this section ends part-way through a word which the next section carries on, this
+    // moves the rest of that word onto the end of this section.
+    void joinSplitWord (UniformTextSection& next, const juce_wchar passwordChar)
+    {
+        TextAtom* const lastAtom = atoms.getLast();
+        TextAtom* const first = next.atoms.getFirst();
 
-            while (i < other.atoms.size())
-            {
-                atoms.add (other.atoms.getUnchecked(i));
-                ++i;
-            }
+        if (lastAtom != nullptr && first != nullptr
+             && ! CharacterFunctions::isWhitespace (lastAtom->atomText.getLastCharacter())
+             && ! CharacterFunctions::isWhitespace (first->atomText[0]))
+        {
+            lastAtom->atomText += first->atomText;
+            lastAtom->numChars = (uint16) (lastAtom->numChars + first->numChars);
+            lastAtom->width = font.getStringWidthFloat (lastAtom->getText (passwordChar));
+
+            totalLength += first->numChars;
+            next.totalLength -= first->numChars;
+            next.atoms.remove (0);
+            delete first;
         }
     }
 
+    // Shares this section's atoms out between a set of new sections that each hold no more
+    // than the given number of them, leaving this section empty.
+    void splitIntoChunks (Array <UniformTextSection*>& chunks, const int maxAtomsPerChunk, const juce_wchar passwordChar)
+    {
+        for (int start = 0; start < atoms.size(); start += maxAtomsPerChunk)
+        {
+            UniformTextSection* const chunk = new UniformTextSection (String::empty, font, colour, passwordChar);
+            chunk->atoms.addArray (atoms, start, jmin (maxAtomsPerChunk, atoms.size() - start));
+
+            for (int i = chunk->atoms.size(); --i >= 0;)
+                chunk->totalLength += chunk->atoms.getUnchecked(i)->numChars;
+
+            chunks.add (chunk);
+        }
+
+        atoms.clear();
+        totalLength = 0;
+    }
+
     UniformTextSection* split (const int indexToBreakAt, const juce_wchar passwordChar)
     {
         UniformTextSection* const section2 = new UniformTextSection (String::empty, font, colour, passwordChar);
@@ -166,6 +186,12 @@ public:
             index = nextIndex;
         }
 
+        if (isPositiveAndBelow (indexToBreakAt, totalLength))
+        {
+            section2->totalLength = totalLength - indexToBreakAt;
+            totalLength = indexToBreakAt;
+        }
+
         return section2;
     }
 
@@ -200,12 +226,23 @@ public:
 
     int getTotalLength() const noexcept
     {
-        int total = 0;
+        return totalLength;
+    }
 
-        for (int i = atoms.size(); --i >= 0;)
-            total += atoms.getUnchecked(i)->numChars;
+    // returns the index of the atom that contains the given character
+    int getAtomIndexAt (const int index) const noexcept
+    {
+        int atomEnd = 0;
 
-        return total;
+        for (int i = 0; i < atoms.size(); ++i)
+        {
+            atomEnd += atoms.getUnchecked(i)->numChars;
+
+            if (index < atomEnd)
+                return i;
+        }
+
+        return atoms.size();
     }
 
     void setFont (const Font& newFont, const juce_wchar passwordChar)
@@ -228,6 +265,8 @@ public:
     Array <TextAtom*> atoms;
 
 private:
+    int totalLength;
+
     void initialiseAtoms (const String& textToParse, const juce_wchar passwordChar)
     {
         String::CharPointerType text (textToParse.getCharPointer());
@@ -281,6 +320,7 @@ private:
             atom->numChars = (uint16) numChars;
 
             atoms.add (atom);
+            totalLength += (int) numChars;
         }
     }
 
@@ -320,6 +360,32 @@ public:
         }
     }
 
+    // Creates an iterator that has just reached a new-line character whose layout is already known,
+    // so that the text can be laid out from the start of the paragraph that follows it.
+    Iterator (const Array <UniformTextSection*>& sectionList,
+              const float wrapWidth,
+              const juce_wchar passwordChar,
+              const int newLineSectionIndex,
+              const int newLineAtomIndex,
+              const ParagraphBreak& newLine)
+      : indexInText (newLine.index),
+        lineY (newLine.lineY),
+        lineHeight (newLine.lineHeight),
+        maxDescent (0),
+        atomX (0),
+        atomRight (newLine.lineRight),
+        atom (sectionList.getUnchecked (newLineSectionIndex)->atoms [newLineAtomIndex]),
+        currentSection (sectionList.getUnchecked (newLineSectionIndex)),
+        sections (sectionList),
+        sectionIndex (newLineSectionIndex),
+        atomIndex (newLineAtomIndex + 1),
+        wordWrapWidth (wrapWidth),
+        passwordCharacter (passwordChar)
+    {
+        jassert (wordWrapWidth > 0);
+        jassert (atom != nullptr && atom->isNewLine());
+    }
+
     Iterator (const Iterator& other)
       : indexInText (other.indexInText),
         lineY (other.lineY),
@@ -916,6 +982,10 @@ namespace TextEditorDefs
 
     const int maxActionsPerTransaction = 100;
 
+    // similar runs of text are only merged into sections of up to this many atoms, so that
+    // splitting and joining the section around an edit stays quick, however long the text is
+    const int maxAtomsPerSection = 256;
+
     static int getCharacterCategory (const juce_wchar character)
     {
         return CharacterFunctions::isLetterOrDigit (character)
@@ -947,6 +1017,12 @@ TextEditor::TextEditor (const String& name,
       currentFont (14.0f),
       totalNumChars (0),
       caretPosition (0),
+      numValidParagraphBreaks (0),
+      layoutResyncIndex (0),
+      layoutWrapWidth (-1.0f),
+      layoutEndY (0),
+      layoutLastParagraphWidth (0),
+      layoutIsValid (false),
       passwordCharacter (passwordChar),
       dragType (notDragging)
 {
@@ -1096,6 +1172,7 @@ void TextEditor::applyFontToAllText (const Font& newFont)
     }
 
     coalesceSimilarSections();
+    invalidateLayout();
     updateTextHolderSize();
     scrollToMakeSureCursorIsVisible();
     repaint();
@@ -1292,9 +1369,7 @@ void TextEditor::repaintText (const Range<int> range)
 
         if (wordWrapWidth > 0)
         {
-            Iterator i (sections, wordWrapWidth, passwordCharacter);
-
-            i.getCharPosition (range.getStart(), x, y, lh);
+            getCharPosition (range.getStart(), x, y, lh);
 
             const int y1 = (int) y;
             int y2;
@@ -1305,7 +1380,7 @@ void TextEditor::repaintText (const Range<int> range)
             }
             else
             {
-                i.getCharPosition (range.getEnd(), x, y, lh);
+                getCharPosition (range.getEnd(), x, y, lh);
                 y2 = (int) (y + lh * 2.0f);
             }
 
@@ -1405,16 +1480,15 @@ void TextEditor::updateTextHolderSize()
 
     if (wordWrapWidth > 0)
     {
-        float maxWidth = 0.0f;
+        updateLayout();
 
-        Iterator i (sections, wordWrapWidth, passwordCharacter);
+        float maxWidth = layoutLastParagraphWidth;
 
-        while (i.next())
-            maxWidth = jmax (maxWidth, i.atomRight);
+        for (int i = paragraphBreaks.size(); --i >= 0;)
+            maxWidth = jmax (maxWidth, paragraphBreaks.getReference (i).maxRight);
 
         const int w = leftIndent + roundToInt (maxWidth);
-        const int h = topIndent + roundToInt (jmax (i.lineY + i.lineHeight,
-                                                    currentFont.getHeight()));
+        const int h = topIndent + roundToInt (jmax (layoutEndY, currentFont.getHeight()));
 
         textHolder->setSize (w + rightEdgeSpace, h + 1); // (allows a bit of space for the cursor to be at the right-hand-edge)
     }
@@ -1611,10 +1685,10 @@ void TextEditor::drawContent (Graphics& g)
         const Rectangle<int> clip (g.getClipBounds());
         Colour selectedTextColour;
 
-        Iterator i (sections, wordWrapWidth, passwordCharacter);
-
-        while (i.lineY + 200.0 < clip.getY() && i.next())
-        {}
+        updateLayout();
+        const Iterator firstVisibleParagraph (getIteratorAtParagraph (findParagraphBreakAbove ((float) clip.getY()),
+                                                                      wordWrapWidth));
+        Iterator i (firstVisibleParagraph);
 
         if (! selection.isEmpty())
         {
@@ -1622,7 +1696,7 @@ void TextEditor::drawContent (Graphics& g)
 
             selectedTextColour = findColour (highlightedTextColourId);
 
-            Iterator i2 (i);
+            Iterator i2 (firstVisibleParagraph);
 
             while (i2.next() && i2.lineY < clip.getBottom())
             {
@@ -1656,7 +1730,7 @@ void TextEditor::drawContent (Graphics& g)
         {
             const Range<int> underlinedSection = underlinedSections.getReference (j);
 
-            Iterator i2 (sections, wordWrapWidth, passwordCharacter);
+            Iterator i2 (firstVisibleParagraph);
 
             while (i2.next() && i2.lineY < clip.getBottom())
             {
@@ -2202,34 +2276,20 @@ void TextEditor::insert (const String& text,
             repaintText (Range<int> (insertIndex, getTotalNumChars())); // must do this before and after changing the data, in case
                                                                         // a line gets moved due to word wrap
 
-            int index = 0;
-            int nextIndex = 0;
+            UniformTextSection* const newSection = new UniformTextSection (text, font, colour, passwordCharacter);
+            Array <UniformTextSection*> newSections;
 
-            for (int i = 0; i < sections.size(); ++i)
+            if (newSection->atoms.size() > TextEditorDefs::maxAtomsPerSection)
             {
-                nextIndex = index + sections.getUnchecked (i)->getTotalLength();
-
-                if (insertIndex == index)
-                {
-                    sections.insert (i, new UniformTextSection (text, font, colour, passwordCharacter));
-                    break;
-                }
-                else if (insertIndex > index && insertIndex < nextIndex)
-                {
-                    splitSection (i, insertIndex - index);
-                    sections.insert (i + 1, new UniformTextSection (text, font, colour, passwordCharacter));
-                    break;
-                }
-
-                index = nextIndex;
+                newSection->splitIntoChunks (newSections, TextEditorDefs::maxAtomsPerSection, passwordCharacter);
+                delete newSection;
+            }
+            else
+            {
+                newSections.add (newSection);
             }
 
-            if (nextIndex == insertIndex)
-                sections.add (new UniformTextSection (text, font, colour, passwordCharacter));
-
-            coalesceSimilarSections();
-            totalNumChars = -1;
-            valueTextNeedsUpdating = true;
+            insertSections (insertIndex, newSections);
 
             updateTextHolderSize();
             moveCaretTo (caretPositionToMoveTo, false);
@@ -2242,6 +2302,19 @@ void TextEditor::insert (const String& text,
 void TextEditor::reinsert (const int insertIndex,
                            const Array <UniformTextSection*>& sectionsToInsert)
 {
+    Array <UniformTextSection*> newSections;
+    newSections.ensureStorageAllocated (sectionsToInsert.size());
+
+    for (int i = 0; i < sectionsToInsert.size(); ++i)
+        newSections.add (new UniformTextSection (*sectionsToInsert.getUnchecked(i)));
+
+    insertSections (insertIndex, newSections);
+}
+
+void TextEditor::insertSections (const int insertIndex,
+                                 const Array <UniformTextSection*>& newSections)
+{
+    const int oldTotalNumChars = getTotalNumChars();
     int index = 0;
     int nextIndex = 0;
 
@@ -2251,18 +2324,13 @@ void TextEditor::reinsert (const int insertIndex,
 
         if (insertIndex == index)
         {
-            for (int j = sectionsToInsert.size(); --j >= 0;)
-                sections.insert (i, new UniformTextSection (*sectionsToInsert.getUnchecked(j)));
-
+            sections.insertArray (i, newSections.begin(), newSections.size());
             break;
         }
         else if (insertIndex > index && insertIndex < nextIndex)
         {
             splitSection (i, insertIndex - index);
-
-            for (int j = sectionsToInsert.size(); --j >= 0;)
-                sections.insert (i + 1, new UniformTextSection (*sectionsToInsert.getUnchecked(j)));
-
+            sections.insertArray (i + 1, newSections.begin(), newSections.size());
             break;
         }
 
@@ -2270,14 +2338,13 @@ void TextEditor::reinsert (const int insertIndex,
     }
 
     if (nextIndex == insertIndex)
-    {
-        for (int j = 0; j < sectionsToInsert.size(); ++j)
-            sections.add (new UniformTextSection (*sectionsToInsert.getUnchecked(j)));
-    }
+        sections.addArray (newSections);
 
     coalesceSimilarSections();
     totalNumChars = -1;
     valueTextNeedsUpdating = true;
+
+    invalidateLayout (insertIndex, 0, getTotalNumChars() - oldTotalNumChars);
 }
 
 void TextEditor::remove (Range<int> range,
@@ -2340,7 +2407,8 @@ void TextEditor::remove (Range<int> range,
         }
         else
         {
-            Range<int> remainingRange (range);
+            const int oldTotalNumChars = getTotalNumChars();
+            int firstSectionToRemove = 0, numSectionsToRemove = 0;
 
             for (int i = 0; i < sections.size(); ++i)
             {
@@ -2348,28 +2416,29 @@ void TextEditor::remove (Range<int> range,
 
                 const int nextIndex = index + section->getTotalLength();
 
-                if (remainingRange.getStart() <= index && remainingRange.getEnd() >= nextIndex)
+                if (range.getStart() <= index && range.getEnd() >= nextIndex)
                 {
-                    sections.remove(i);
+                    if (numSectionsToRemove++ == 0)
+                        firstSectionToRemove = i;
+
                     section->clear();
                     delete section;
 
-                    remainingRange.setEnd (remainingRange.getEnd() - (nextIndex - index));
-                    if (remainingRange.isEmpty())
+                    if (nextIndex >= range.getEnd())
                         break;
-
-                    --i;
-                }
-                else
-                {
-                    index = nextIndex;
                 }
+
+                index = nextIndex;
             }
 
+            sections.removeRange (firstSectionToRemove, numSectionsToRemove);
+
             coalesceSimilarSections();
             totalNumChars = -1;
             valueTextNeedsUpdating = true;
 
+            invalidateLayout (range.getStart(), oldTotalNumChars - getTotalNumChars(), 0);
+
             moveCaretTo (caretPositionToMoveTo, false);
 
             repaintText (Range<int> (range.getStart(), getTotalNumChars()));
@@ -2447,7 +2516,8 @@ void TextEditor::getCharPosition (const int index, float& cx, float& cy, float&
 
     if (wordWrapWidth > 0 && sections.size() > 0)
     {
-        Iterator i (sections, wordWrapWidth, passwordCharacter);
+        updateLayout();
+        Iterator i (getIteratorAtParagraph (findParagraphBreakBefore (index), wordWrapWidth));
 
         i.getCharPosition (index, cx, cy, lineHeight);
     }
@@ -2464,7 +2534,8 @@ int TextEditor::indexAtPosition (const float x, const float y)
 
     if (wordWrapWidth > 0)
     {
-        Iterator i (sections, wordWrapWidth, passwordCharacter);
+        updateLayout();
+        Iterator i (getIteratorAtParagraph (findParagraphBreakAbove (y), wordWrapWidth));
 
         while (i.next())
         {
@@ -2552,10 +2623,190 @@ void TextEditor::coalesceSimilarSections()
         if (s1->font == s2->font
              && s1->colour == s2->colour)
         {
-            s1->append (*s2, passwordCharacter);
+            if (s1->atoms.size() + s2->atoms.size() > TextEditorDefs::maxAtomsPerSection)
+            {
+                // too big to merge, but make sure that no word gets left split across the two..
+                s1->joinSplitWord (*s2, passwordCharacter);
+
+                if (s2->atoms.size() > 0)
+                    continue;
+            }
+            else
+            {
+                s1->append (*s2, passwordCharacter);
+            }
+
             sections.remove (i + 1);
             delete s2;
             --i;
         }
     }
 }
+
+//==============================================================================
+void TextEditor::invalidateLayout()
+{
+    layoutWrapWidth = -1.0f; // (forces everything to be laid out again)
+    layoutIsValid = false;
+}
+
+void TextEditor::invalidateLayout (const int index, const int numCharsRemoved, const int numCharsInserted)
+{
+    // The breaks from the edit onwards are kept, with their indexes moved to match the new text,
+    // so that once the new layout reaches one that hasn't changed, the rest can be re-used.
+    const int endOfRemovedRange = index + numCharsRemoved;
+    const int delta = numCharsInserted - numCharsRemoved;
+
+    numValidParagraphBreaks = jmin (numValidParagraphBreaks, findParagraphBreakBefore (index) + 1);
+
+    int firstRemoved = paragraphBreaks.size(), numRemoved = 0;
+
+    for (int i = paragraphBreaks.size(); --i >= numValidParagraphBreaks;)
+    {
+        ParagraphBreak& b = paragraphBreaks.getReference (i);
+
+        if (b.index >= endOfRemovedRange)
+        {
+            b.index += delta;
+        }
+        else
+        {
+            firstRemoved = i;
+            ++numRemoved;
+        }
+    }
+
+    paragraphBreaks.removeRange (firstRemoved, numRemoved);
+
+    layoutResyncIndex = jmax (index + numCharsInserted,
+                              layoutResyncIndex >= endOfRemovedRange ? layoutResyncIndex + delta : 0);
+    layoutIsValid = false;
+}
+
+void TextEditor::updateLayout() const
+{
+    const float wordWrapWidth = getWordWrapWidth();
+
+    if (wordWrapWidth != layoutWrapWidth)
+    {
+        layoutWrapWidth = wordWrapWidth;
+        layoutIsValid = false;
+        paragraphBreaks.clearQuick();
+        numValidParagraphBreaks = 0;
+    }
+
+    if (layoutIsValid || wordWrapWidth <= 0)
+        return;
+
+    Iterator i (getIteratorAtParagraph (numValidParagraphBreaks - 1, wordWrapWidth));
+    Array <ParagraphBreak> newBreaks;
+    int nextOldBreak = numValidParagraphBreaks;
+    float maxRight = 0;
+
+    while (i.next())
+    {
+        maxRight = jmax (maxRight, i.atomRight);
+
+        if (i.atom->isNewLine())
+        {
+            const ParagraphBreak b = { i.indexInText, i.lineY, i.lineHeight, i.atomRight, maxRight };
+            newBreaks.add (b);
+            maxRight = 0;
+
+            while (nextOldBreak < paragraphBreaks.size() && paragraphBreaks.getReference (nextOldBreak).index < b.index)
+                ++nextOldBreak;
+
+            if (b.index >= layoutResyncIndex && nextOldBreak < paragraphBreaks.size())
+            {
+                const ParagraphBreak& old = paragraphBreaks.getReference (nextOldBreak);
+
+                if (old.index == b.index && old.lineHeight == b.lineHeight && old.lineRight == b.lineRight)
+                {
+                    // Everything after this new-line is laid out exactly as it was before, just moved
+                    // up or down, so the remaining old breaks can be kept.
+                    const float deltaY = b.lineY - old.lineY;
+
+                    for (int j = nextOldBreak + 1; j < paragraphBreaks.size(); ++j)
+                        paragraphBreaks.getReference (j).lineY += deltaY;
+
+                    layoutEndY += deltaY;
+
+                    paragraphBreaks.removeRange (numValidParagraphBreaks, nextOldBreak + 1 - numValidParagraphBreaks);
+                    paragraphBreaks.insertArray (numValidParagraphBreaks, newBreaks.begin(), newBreaks.size());
+                    numValidParagraphBreaks = paragraphBreaks.size();
+                    layoutResyncIndex = 0;
+                    layoutIsValid = true;
+                    return;
+                }
+            }
+        }
+    }
+
+    paragraphBreaks.removeRange (numValidParagraphBreaks, paragraphBreaks.size() - numValidParagraphBreaks);
+    paragraphBreaks.addArray (newBreaks);
+    numValidParagraphBreaks = paragraphBreaks.size();
+    layoutEndY = i.lineY + i.lineHeight;
+    layoutLastParagraphWidth = maxRight;
+    layoutResyncIndex = 0;
+    layoutIsValid = true;
+}
+
+int TextEditor::findParagraphBreakBefore (const int index) const
+{
+    int start = 0, end = paragraphBreaks.size();
+
+    while (start < end)
+    {
+        const int mid = (start + end) / 2;
+
+        if (paragraphBreaks.getReference (mid).index < index)
+            start = mid + 1;
+        else
+            end = mid;
+    }
+
+    return start - 1;
+}
+
+int TextEditor::findParagraphBreakAbove (const float y) const
+{
+    int start = 0, end = numValidParagraphBreaks;
+
+    while (start < end)
+    {
+        const int mid = (start + end) / 2;
+        const ParagraphBreak& b = paragraphBreaks.getReference (mid);
+
+        if (b.lineY + b.lineHeight < y)
+            start = mid + 1;
+        else
+            end = mid;
+    }
+
+    return start - 1;
+}
+
+TextEditor::Iterator TextEditor::getIteratorAtParagraph (const int paragraphBreakIndex, const float wordWrapWidth) const
+{
+    if (isPositiveAndBelow (paragraphBreakIndex, numValidParagraphBreaks))
+    {
+        const ParagraphBreak& b = paragraphBreaks.getReference (paragraphBreakIndex);
+        int index = 0;
+
+        for (int i = 0; i < sections.size(); ++i)
+        {
+            const UniformTextSection* const section = sections.getUnchecked (i);
+            const int nextIndex = index + section->getTotalLength();
+
+            if (b.index < nextIndex)
+                return Iterator (sections, wordWrapWidth, passwordCharacter,
+                                 i, section->getAtomIndexAt (b.index - index), b);
+
+            index = nextIndex;
+        }
+
+        jassertfalse; // the layout must be out of date!
+    }
+
+    return Iterator (sections, wordWrapWidth, passwordCharacter);
+}
@@ -677,6 +677,18 @@ private:
     mutable int totalNumChars;
     int caretPosition;
     Array <UniformTextSection*> sections;
+
+    // the layout of each new-line character, which lets the text be laid out from any paragraph
+    struct ParagraphBreak
+    {
+        int index;
+        float lineY, lineHeight, lineRight, maxRight;
+    };
+
+    mutable Array <ParagraphBreak> paragraphBreaks;
+    mutable int numValidParagraphBreaks, layoutResyncIndex;
+    mutable float layoutWrapWidth, layoutEndY, layoutLastParagraphWidth;
+    mutable bool layoutIsValid;
     String textToShowWhenEmpty;
     Colour colourForTextWhenEmpty;
     juce_wchar passwordCharacter;
@@ -701,6 +713,7 @@ private:
     void clearInternal (UndoManager*);
     void insert (const String&, int insertIndex, const Font&, const Colour, UndoManager*, int newCaretPos);
     void reinsert (int insertIndex, const Array <UniformTextSection*>&);
+    void insertSections (int insertIndex, const Array <UniformTextSection*>&);
     void remove (Range<int> range, UndoManager*, int caretPositionToMoveTo);
     void getCharPosition (int index, float& x, float& y, float& lineHeight) const;
     void updateCaretPosition();
@@ -714,6 +727,12 @@ private:
     friend class TextEditorViewport;
     void drawContent (Graphics&);
     void updateTextHolderSize();
+    void invalidateLayout();
+    void invalidateLayout (int index, int numCharsRemoved, int numCharsInserted);
+    void updateLayout() const;
+    int findParagraphBreakBefore (int index) const;
+    int findParagraphBreakAbove (float y) const;
+    Iterator getIteratorAtParagraph (int paragraphBreakIndex, float wordWrapWidth) const;
     float getWordWrapWidth() const;
     void timerCallbackInt();
     void repaintText (Range<int>);
@@ -177,25 +177,27 @@ public:
         for (int i = items.size(); --i >= 0;)
             items.getUnchecked(i)->shouldKeep = false;
 
+        if (TreeViewItem* const rootItem = owner.rootItem)
         {
-            TreeViewItem* item = owner.rootItem;
-            int y = (item != nullptr && ! owner.rootItemVisible) ? -item->itemHeight : 0;
+            owner.updatePositionsIfNeeded();
+
+            // start at the first visible row, rather than walking down from the top of the tree
+            TreeViewItem* item = rootItem->findItemRecursively (jmax (0, visibleTop)
+                                                                  + (owner.rootItemVisible ? 0 : rootItem->itemHeight));
+            int y = item != nullptr ? item->getYInTree() : 0;
 
             while (item != nullptr && y < visibleBottom)
             {
                 y += item->itemHeight;
 
-                if (y >= visibleTop)
+                if (RowItem* const ri = findItem (item->uid))
                 {
-                    if (RowItem* const ri = findItem (item->uid))
-                    {
-                        ri->shouldKeep = true;
-                    }
-                    else if (Component* const comp = item->createItemComponent())
-                    {
-                        items.add (new RowItem (item, comp, item->uid));
-                        addAndMakeVisible (comp);
-                    }
+                    ri->shouldKeep = true;
+                }
+                else if (Component* const comp = item->createItemComponent())
+                {
+                    items.add (new RowItem (item, comp, item->uid));
+                    addAndMakeVisible (comp);
                 }
 
                 item = item->getNextVisibleItem (true);
@@ -446,7 +448,9 @@ TreeView::TreeView (const String& name)
       needsRecalculating (true),
       rootItemVisible (true),
       multiSelectEnabled (false),
-      openCloseButtonsVisible (true)
+      openCloseButtonsVisible (true),
+      positionsNeedUpdating (true),
+      allPositionsNeedUpdating (true)
 {
     addAndMakeVisible (viewport);
     viewport->setViewedComponent (new ContentComponent (*this));
@@ -479,7 +483,7 @@ void TreeView::setRootItem (TreeViewItem* const newRootItem)
         if (newRootItem != nullptr)
             newRootItem->setOwnerView (this);
 
-        needsRecalculating = true;
+        itemsChanged();
         recalculateIfNeeded();
 
         if (rootItem != nullptr && (defaultOpenness || ! rootItemVisible))
@@ -520,6 +524,7 @@ void TreeView::setIndentSize (const int newIndentSize)
     if (indentSize != newIndentSize)
     {
         indentSize = newIndentSize;
+        itemsChanged();
         resized();
     }
 }
@@ -723,7 +728,7 @@ void TreeView::scrollToKeepItemVisible (TreeViewItem* item)
 
         item = item->getDeepestOpenParentItem();
 
-        const int y = item->y;
+        const int y = item->getYInTree();
         const int viewTop = viewport->getViewPositionY();
 
         if (y < viewTop)
@@ -826,13 +831,37 @@ bool TreeView::keyPressed (const KeyPress& key)
     return false;
 }
 
-void TreeView::itemsChanged() noexcept
+void TreeView::itemsChanged (const bool allItemsChanged) noexcept
 {
     needsRecalculating = true;
+    positionsNeedUpdating = true;
+
+    if (allItemsChanged)
+        allPositionsNeedUpdating = true;
+
     repaint();
     viewport->getContentComp()->triggerAsyncUpdate();
 }
 
+void TreeView::updatePositionsIfNeeded()
+{
+    if (positionsNeedUpdating)
+    {
+        const bool updateAllItems = allPositionsNeedUpdating;
+        positionsNeedUpdating = false;
+        allPositionsNeedUpdating = false;
+
+        const ScopedLock sl (nodeAlterationLock);
+
+        if (rootItem != nullptr)
+        {
+            rootItem->updatePositions (rootItem->getIndentX(), updateAllItems);
+            rootItem->y = rootItemVisible ? 0 : -rootItem->itemHeight;
+            rootItem->row = 0;
+        }
+    }
+}
+
 void TreeView::recalculateIfNeeded()
 {
     if (needsRecalculating)
@@ -841,9 +870,7 @@ void TreeView::recalculateIfNeeded()
 
         const ScopedLock sl (nodeAlterationLock);
 
-        if (rootItem != nullptr)
-            rootItem->updatePositions (rootItemVisible ? 0 : -rootItem->itemHeight);
-
+        updatePositionsIfNeeded();
         viewport->updateComponents (false);
 
         if (rootItem != nullptr)
@@ -1123,11 +1150,16 @@ TreeViewItem::TreeViewItem()
       y (0),
       itemHeight (0),
       totalHeight (0),
+      row (0),
+      numRows (1),
+      indexInParent (-1),
       selected (false),
       redrawNeeded (true),
       drawLinesInside (true),
       drawsInLeftMargin (false),
-      openness (opennessDefault)
+      openness (opennessDefault),
+      positionNeedsUpdating (true),
+      subItemPositionsValid (false)
 {
     static int nextUID = 0;
     uid = nextUID++;
@@ -1164,7 +1196,7 @@ void TreeViewItem::clearSubItems()
         {
             const ScopedLock sl (ownerView->nodeAlterationLock);
             subItems.clear();
-            treeHasChanged();
+            positionsChanged();
         }
         else
         {
@@ -1184,12 +1216,14 @@ void TreeViewItem::addSubItem (TreeViewItem* const newItem, const int insertPosi
         newItem->totalHeight = 0;
         newItem->itemWidth = newItem->getItemWidth();
         newItem->totalWidth = 0;
+        newItem->positionNeedsUpdating = true;
+        newItem->subItemPositionsValid = false;
 
         if (ownerView != nullptr)
         {
             const ScopedLock sl (ownerView->nodeAlterationLock);
             subItems.insert (insertPosition, newItem);
-            treeHasChanged();
+            positionsChanged();
 
             if (newItem->isOpen())
                 newItem->itemOpennessChanged (true);
@@ -1213,7 +1247,7 @@ void TreeViewItem::removeSubItem (const int index, const bool deleteItem)
         if (isPositiveAndBelow (index, subItems.size()))
         {
             subItems.remove (index, deleteItem);
-            treeHasChanged();
+            positionsChanged();
         }
     }
     else
@@ -1236,7 +1270,7 @@ void TreeViewItem::setOpen (const bool shouldBeOpen)
     {
         openness = shouldBeOpen ? opennessOpen
                                 : opennessClosed;
-        treeHasChanged();
+        positionsChanged();
 
         itemOpennessChanged (isOpen());
     }
@@ -1369,7 +1403,7 @@ Rectangle<int> TreeViewItem::getItemPosition (const bool relativeToTreeViewTopLe
     if (ownerView != nullptr && width < 0)
         width = ownerView->viewport->getViewWidth() - indentX;
 
-    Rectangle<int> r (indentX, y, jmax (0, width), totalHeight);
+    Rectangle<int> r (indentX, getYInTree(), jmax (0, width), totalHeight);
 
     if (relativeToTreeViewTopLeft)
         r -= ownerView->viewport->getViewPosition();
@@ -1399,28 +1433,100 @@ bool TreeViewItem::areAllParentsOpen() const noexcept
             || (parentItem->isOpen() && parentItem->areAllParentsOpen());
 }
 
-void TreeViewItem::updatePositions (int newY)
+void TreeViewItem::positionsChanged() noexcept
 {
-    y = newY;
+    for (TreeViewItem* item = this; item != nullptr; item = item->parentItem)
+        item->positionNeedsUpdating = true;
+
+    if (ownerView != nullptr)
+        ownerView->itemsChanged (false);
+}
+
+/*  Each item's y and row are stored relative to its parent, so an item whose contents
+    haven't changed doesn't need to be revisited when things above it are opened or closed.
+*/
+void TreeViewItem::updatePositions (const int indentX, const bool updateAllItems)
+{
+    if (! (positionNeedsUpdating || updateAllItems))
+        return;
+
+    positionNeedsUpdating = false;
     itemHeight = getItemHeight();
     totalHeight = itemHeight;
     itemWidth = getItemWidth();
-    totalWidth = jmax (itemWidth, 0) + getIndentX();
+    totalWidth = jmax (itemWidth, 0) + indentX;
+    numRows = 1;
 
     if (isOpen())
     {
-        newY += totalHeight;
+        // if everything was re-measured while this item was closed, its sub-items missed out
+        const bool updateSubItems = updateAllItems || ! subItemPositionsValid;
+        const int subItemIndentX = indentX + ownerView->getIndentSize();
 
         for (int i = 0; i < subItems.size(); ++i)
         {
             TreeViewItem* const ti = subItems.getUnchecked(i);
 
-            ti->updatePositions (newY);
-            newY += ti->totalHeight;
+            ti->y = totalHeight;
+            ti->row = numRows;
+            ti->indexInParent = i;
+            ti->updatePositions (subItemIndentX, updateSubItems);
+
             totalHeight += ti->totalHeight;
+            numRows += ti->numRows;
             totalWidth = jmax (totalWidth, ti->totalWidth);
         }
+
+        subItemPositionsValid = true;
     }
+    else if (updateAllItems)
+    {
+        subItemPositionsValid = false;
+    }
+}
+
+int TreeViewItem::getYInTree() const noexcept
+{
+    int total = y;
+
+    for (const TreeViewItem* p = parentItem; p != nullptr; p = p->parentItem)
+        total += p->y;
+
+    return total;
+}
+
+int TreeViewItem::findSubItemAtY (const int targetY) const noexcept
+{
+    int start = 0, end = subItems.size();
+
+    while (end - start > 1)
+    {
+        const int mid = (start + end) / 2;
+
+        if (subItems.getUnchecked (mid)->y <= targetY)
+            start = mid;
+        else
+            end = mid;
+    }
+
+    return start;
+}
+
+int TreeViewItem::findSubItemOnRow (const int targetRow) const noexcept
+{
+    int start = 0, end = subItems.size();
+
+    while (end - start > 1)
+    {
+        const int mid = (start + end) / 2;
+
+        if (subItems.getUnchecked (mid)->row <= targetRow)
+            start = mid;
+        else
+            end = mid;
+    }
+
+    return start;
 }
 
 TreeViewItem* TreeViewItem::getDeepestOpenParentItem() noexcept
@@ -1544,11 +1650,11 @@ void TreeViewItem::paintRecursively (Graphics& g, int width)
     {
         const Rectangle<int> clip (g.getClipBounds());
 
-        for (int i = 0; i < subItems.size(); ++i)
+        for (int i = findSubItemAtY (clip.getY()); i < subItems.size(); ++i)
         {
             TreeViewItem* const ti = subItems.getUnchecked(i);
 
-            const int relY = ti->y - y;
+            const int relY = ti->y;
 
             if (relY >= clip.getBottom())
                 break;
@@ -1574,8 +1680,14 @@ bool TreeViewItem::isLastOfSiblings() const noexcept
 
 int TreeViewItem::getIndexInParent() const noexcept
 {
-    return parentItem == nullptr ? 0
-                                 : parentItem->subItems.indexOf (this);
+    if (parentItem == nullptr)
+        return 0;
+
+    // the sub-items may have been re-ordered since the index was cached
+    if (parentItem->subItems [indexInParent] != this)
+        indexInParent = parentItem->subItems.indexOf (this);
+
+    return indexInParent;
 }
 
 TreeViewItem* TreeViewItem::getTopLevelItem() noexcept
@@ -1586,6 +1698,12 @@ TreeViewItem* TreeViewItem::getTopLevelItem() noexcept
 
 int TreeViewItem::getNumRows() const noexcept
 {
+    if (ownerView != nullptr && areAllParentsOpen())
+    {
+        ownerView->updatePositionsIfNeeded();
+        return numRows;
+    }
+
     int num = 1;
 
     if (isOpen())
@@ -1599,6 +1717,22 @@ int TreeViewItem::getNumRows() const noexcept
 
 TreeViewItem* TreeViewItem::getItemOnRow (int index) noexcept
 {
+    if (ownerView != nullptr && areAllParentsOpen())
+    {
+        ownerView->updatePositionsIfNeeded();
+
+        for (TreeViewItem* item = this; isPositiveAndBelow (index, item->numRows);)
+        {
+            if (index == 0)
+                return item;
+
+            item = item->subItems.getUnchecked (item->findSubItemOnRow (index));
+            index -= item->row;
+        }
+
+        return nullptr;
+    }
+
     if (index == 0)
         return this;
 
@@ -1627,27 +1761,16 @@ TreeViewItem* TreeViewItem::getItemOnRow (int index) noexcept
 
 TreeViewItem* TreeViewItem::findItemRecursively (int targetY) noexcept
 {
-    if (isPositiveAndBelow (targetY, totalHeight))
+    for (TreeViewItem* item = this; isPositiveAndBelow (targetY, item->totalHeight);)
     {
-        const int h = itemHeight;
-
-        if (targetY < h)
-            return this;
-
-        if (isOpen())
-        {
-            targetY -= h;
+        if (targetY < item->itemHeight)
+            return item;
 
-            for (int i = 0; i < subItems.size(); ++i)
-            {
-                TreeViewItem* const ti = subItems.getUnchecked(i);
-
-                if (targetY < ti->totalHeight)
-                    return ti->findItemRecursively (targetY);
+        if (! (item->isOpen() && item->subItems.size() > 0))
+            break;
 
-                targetY -= ti->totalHeight;
-            }
-        }
+        item = item->subItems.getUnchecked (item->findSubItemAtY (targetY));
+        targetY -= item->y;
     }
 
     return nullptr;
@@ -1694,6 +1817,18 @@ int TreeViewItem::getRowNumberInTree() const noexcept
 {
     if (parentItem != nullptr && ownerView != nullptr)
     {
+        if (areAllParentsOpen())
+        {
+            ownerView->updatePositionsIfNeeded();
+
+            int n = ownerView->rootItemVisible ? 0 : -1;
+
+            for (const TreeViewItem* item = this; item->parentItem != nullptr; item = item->parentItem)
+                n += item->row;
+
+            return n;
+        }
+
         int n = 1 + parentItem->getRowNumberInTree();
 
         int ourIndex = parentItem->subItems.indexOf (this);
@@ -1726,7 +1861,7 @@ TreeViewItem* TreeViewItem::getNextVisibleItem (const bool recurse) const noexce
 
     if (parentItem != nullptr)
     {
-        const int nextIndex = parentItem->subItems.indexOf (this) + 1;
+        const int nextIndex = getIndexInParent() + 1;
 
         if (nextIndex >= parentItem->subItems.size())
             return parentItem->getNextVisibleItem (false);
@@ -160,6 +160,11 @@ public:
 
     /** Sends a signal to the treeview to make it refresh itself.
         Call this if your items have changed and you want the tree to update to reflect this.
+
+        Opening, closing, adding or removing items updates the tree automatically, and only
+        re-measures the items that were affected. Calling this method makes the tree
+        re-measure all of its open items, so use it when the heights or widths that your
+        items return have changed.
     */
     void treeHasChanged() const noexcept;
 
@@ -525,16 +530,24 @@ private:
     TreeViewItem* parentItem;
     OwnedArray <TreeViewItem> subItems;
     int y, itemHeight, totalHeight, itemWidth, totalWidth;
+    int row, numRows;
+    mutable int indexInParent;
     int uid;
-    bool selected           : 1;
-    bool redrawNeeded       : 1;
-    bool drawLinesInside    : 1;
-    bool drawsInLeftMargin  : 1;
-    unsigned int openness   : 2;
+    bool selected                : 1;
+    bool redrawNeeded            : 1;
+    bool drawLinesInside         : 1;
+    bool drawsInLeftMargin       : 1;
+    unsigned int openness        : 2;
+    bool positionNeedsUpdating   : 1;
+    bool subItemPositionsValid   : 1;
 
     friend class TreeView;
 
-    void updatePositions (int newY);
+    void updatePositions (int indentX, bool updateAllItems);
+    void positionsChanged() noexcept;
+    int getYInTree() const noexcept;
+    int findSubItemAtY (int y) const noexcept;
+    int findSubItemOnRow (int row) const noexcept;
     int getIndentX() const noexcept;
     void setOwnerView (TreeView*) noexcept;
     void paintRecursively (Graphics&, int width);
@@ -840,9 +853,12 @@ private:
     bool rootItemVisible : 1;
     bool multiSelectEnabled : 1;
     bool openCloseButtonsVisible : 1;
+    bool positionsNeedUpdating : 1;
+    bool allPositionsNeedUpdating : 1;
 
-    void itemsChanged() noexcept;
+    void itemsChanged (bool allItemsChanged = true) noexcept;
     void recalculateIfNeeded();
+    void updatePositionsIfNeeded();
     void updateButtonUnderMouse (const MouseEvent&);
     struct InsertPoint;
     void showDragHighlight (const InsertPoint&) noexcept;
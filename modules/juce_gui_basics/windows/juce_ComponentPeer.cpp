@@ -155,6 +155,15 @@ void ComponentPeer::handlePaint (LowLevelGraphicsContext& contextToPaintTo)
     jassert (roundToInt (10.1f) == 10);
 }
 
+void ComponentPeer::simplifyRepaintRegion (RectangleList& regionToRepaint)
+{
+    // Every drawing operation gets clipped against each rectangle in the region, so a
+    // separate rectangle is only worth keeping if it saves more than about this many pixels.
+    enum { maxNumRectangles = 32, extraAreaAllowed = 32 * 32 };
+
+    regionToRepaint.simplify (maxNumRectangles, extraAreaAllowed);
+}
+
 Component* ComponentPeer::getTargetForKeyPress()
 {
     Component* c = Component::getCurrentlyFocusedComponent();
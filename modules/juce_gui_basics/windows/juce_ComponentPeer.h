@@ -368,6 +368,12 @@ protected:
 
     static void updateCurrentModifiers() noexcept;
 
+    /** Merges the rectangles in a region that's about to be repainted, so that it doesn't
+        contain so many small pieces that clipping to them costs more than drawing a few
+        extra pixels would.
+    */
+    static void simplifyRepaintRegion (RectangleList& regionToRepaint);
+
 private:
     //==============================================================================
     WeakReference<Component> lastFocusedComponent, dragAndDropTargetComponent;
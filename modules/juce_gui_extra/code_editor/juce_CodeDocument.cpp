@@ -37,7 +37,7 @@ public:
     {
     }
 
-    static void createLines (Array <CodeDocumentLine*>& newLines, const String& text)
+    static void createLines (Array <CodeDocumentLine>& newLines, const String& text)
     {
         String::CharPointerType t (text.getCharPointer());
         int charNumInFile = 0;
@@ -85,8 +85,8 @@ public:
                 }
             }
 
-            newLines.add (new CodeDocumentLine (startOfLine, lineLength,
-                                                numNewLineChars, startOfLineInFile));
+            newLines.add (CodeDocumentLine (startOfLine, lineLength,
+                                            numNewLineChars, startOfLineInFile));
         }
 
         jassert (charNumInFile == text.length());
@@ -131,6 +131,17 @@ CodeDocument::Iterator::Iterator (const CodeDocument& doc) noexcept
 {
 }
 
+CodeDocument::Iterator::Iterator (const CodeDocument::Position& p) noexcept
+    : document (p.owner),
+      charPointer (nullptr),
+      line (p.getLineNumber()),
+      position (p.getPosition())
+{
+    if (p.getIndexInLine() > 0)
+        if (const CodeDocumentLine* const l = document->findLine (line))
+            charPointer = l->line.getCharPointer() + p.getIndexInLine();
+}
+
 CodeDocument::Iterator::Iterator (const CodeDocument::Iterator& other) noexcept
     : document (other.document),
       charPointer (other.charPointer),
@@ -159,7 +170,7 @@ juce_wchar CodeDocument::Iterator::nextChar() noexcept
     {
         if (charPointer.getAddress() == nullptr)
         {
-            if (const CodeDocumentLine* const l = document->lines[line])
+            if (const CodeDocumentLine* const l = document->findLine (line))
                 charPointer = l->line.getCharPointer();
             else
                 return 0;
@@ -189,7 +200,7 @@ void CodeDocument::Iterator::skipToEndOfLine() noexcept
 {
     if (charPointer.getAddress() == nullptr)
     {
-        const CodeDocumentLine* const l = document->lines[line];
+        const CodeDocumentLine* const l = document->findLine (line);
 
         if (l == nullptr)
             return;
@@ -206,7 +217,7 @@ juce_wchar CodeDocument::Iterator::peekNextChar() const noexcept
 {
     if (charPointer.getAddress() == nullptr)
     {
-        if (const CodeDocumentLine* const l = document->lines[line])
+        if (const CodeDocumentLine* const l = document->findLine (line))
             charPointer = l->line.getCharPointer();
         else
             return 0;
@@ -217,7 +228,7 @@ juce_wchar CodeDocument::Iterator::peekNextChar() const noexcept
     if (c != 0)
         return c;
 
-    if (const CodeDocumentLine* const l = document->lines [line + 1])
+    if (const CodeDocumentLine* const l = document->findLine (line + 1))
         return l->line[0];
 
     return 0;
@@ -321,7 +332,7 @@ void CodeDocument::Position::setLineAndIndex (const int newLineNum, const int ne
         {
             line = owner->lines.size() - 1;
 
-            const CodeDocumentLine& l = *owner->lines.getUnchecked (line);
+            const CodeDocumentLine& l = owner->lines.getReference (line);
             indexInLine = l.lineLengthWithoutNewLines;
             characterPos = l.lineStartInFile + indexInLine;
         }
@@ -329,7 +340,7 @@ void CodeDocument::Position::setLineAndIndex (const int newLineNum, const int ne
         {
             line = jmax (0, newLineNum);
 
-            const CodeDocumentLine& l = *owner->lines.getUnchecked (line);
+            const CodeDocumentLine& l = owner->lines.getReference (line);
 
             if (l.lineLengthWithoutNewLines > 0)
                 indexInLine = jlimit (0, l.lineLengthWithoutNewLines, newIndexInLine);
@@ -360,7 +371,7 @@ void CodeDocument::Position::setPosition (const int newPosition)
             {
                 for (int i = lineStart; i < lineEnd; ++i)
                 {
-                    const CodeDocumentLine& l = *owner->lines.getUnchecked (i);
+                    const CodeDocumentLine& l = owner->lines.getReference (i);
                     const int index = newPosition - l.lineStartInFile;
 
                     if (index >= 0 && (index < l.lineLength || i == lineEnd - 1))
@@ -377,7 +388,7 @@ void CodeDocument::Position::setPosition (const int newPosition)
             {
                 const int midIndex = (lineStart + lineEnd + 1) / 2;
 
-                if (newPosition >= owner->lines.getUnchecked (midIndex)->lineStartInFile)
+                if (newPosition >= owner->lines.getReference (midIndex).lineStartInFile)
                     lineStart = midIndex;
                 else
                     lineEnd = midIndex;
@@ -397,7 +408,7 @@ void CodeDocument::Position::moveBy (int characterDelta)
         // If moving right, make sure we don't get stuck between the \r and \n characters..
         if (line < owner->lines.size())
         {
-            const CodeDocumentLine& l = *owner->lines.getUnchecked (line);
+            const CodeDocumentLine& l = owner->lines.getReference (line);
 
             if (indexInLine + characterDelta < l.lineLength
                  && indexInLine + characterDelta >= l.lineLengthWithoutNewLines + 1)
@@ -424,7 +435,7 @@ CodeDocument::Position CodeDocument::Position::movedByLines (const int deltaLine
 
 juce_wchar CodeDocument::Position::getCharacter() const
 {
-    if (const CodeDocumentLine* const l = owner->lines [line])
+    if (const CodeDocumentLine* const l = owner->findLine (line))
         return l->line [getIndexInLine()];
 
     return 0;
@@ -432,7 +443,7 @@ juce_wchar CodeDocument::Position::getCharacter() const
 
 String CodeDocument::Position::getLineText() const
 {
-    if (const CodeDocumentLine* const l = owner->lines [line])
+    if (const CodeDocumentLine* const l = owner->findLine (line))
         return l->line;
 
     return String::empty;
@@ -491,7 +502,7 @@ String CodeDocument::getTextBetween (const Position& start, const Position& end)
 
     if (startLine == endLine)
     {
-        if (CodeDocumentLine* const line = lines [startLine])
+        if (const CodeDocumentLine* const line = findLine (startLine))
             return line->line.substring (start.getIndexInLine(), end.getIndexInLine());
 
         return String::empty;
@@ -504,7 +515,7 @@ String CodeDocument::getTextBetween (const Position& start, const Position& end)
 
     for (int i = jmax (0, startLine); i <= maxLine; ++i)
     {
-        const CodeDocumentLine& line = *lines.getUnchecked(i);
+        const CodeDocumentLine& line = lines.getReference (i);
         int len = line.lineLength;
 
         if (i == startLine)
@@ -528,15 +539,21 @@ String CodeDocument::getTextBetween (const Position& start, const Position& end)
 
 int CodeDocument::getNumCharacters() const noexcept
 {
-    if (const CodeDocumentLine* const lastLine = lines.getLast())
+    if (const CodeDocumentLine* const lastLine = findLine (lines.size() - 1))
         return lastLine->lineStartInFile + lastLine->lineLength;
 
     return 0;
 }
 
+const CodeDocumentLine* CodeDocument::findLine (const int lineIndex) const noexcept
+{
+    return isPositiveAndBelow (lineIndex, lines.size()) ? &lines.getReference (lineIndex)
+                                                         : nullptr;
+}
+
 String CodeDocument::getLine (const int lineIndex) const noexcept
 {
-    if (const CodeDocumentLine* const line = lines [lineIndex])
+    if (const CodeDocumentLine* const line = findLine (lineIndex))
         return line->line;
 
     return String::empty;
@@ -549,7 +566,7 @@ int CodeDocument::getMaximumLineLength() noexcept
         maximumLineLength = 0;
 
         for (int i = lines.size(); --i >= 0;)
-            maximumLineLength = jmax (maximumLineLength, lines.getUnchecked(i)->lineLength);
+            maximumLineLength = jmax (maximumLineLength, lines.getReference (i).lineLength);
     }
 
     return maximumLineLength;
@@ -619,7 +636,7 @@ bool CodeDocument::writeToStream (OutputStream& stream)
 {
     for (int i = 0; i < lines.size(); ++i)
     {
-        String temp (lines.getUnchecked(i)->line); // use a copy to avoid bloating the memory footprint of the stored string.
+        String temp (lines.getReference (i).line); // use a copy to avoid bloating the memory footprint of the stored string.
         const char* utf8 = temp.toUTF8();
 
         if (! stream.write (utf8, strlen (utf8)))
@@ -780,19 +797,21 @@ void CodeDocument::findLineContaining  (const Position& pos, Position& s, Positi
 void CodeDocument::checkLastLineStatus()
 {
     while (lines.size() > 0
-            && lines.getLast()->lineLength == 0
-            && (lines.size() == 1 || ! lines.getUnchecked (lines.size() - 2)->endsWithLineBreak()))
+            && lines.getReference (lines.size() - 1).lineLength == 0
+            && (lines.size() == 1 || ! lines.getReference (lines.size() - 2).endsWithLineBreak()))
     {
         // remove any empty lines at the end if the preceding line doesn't end in a newline.
         lines.removeLast();
     }
 
-    const CodeDocumentLine* const lastLine = lines.getLast();
-
-    if (lastLine != nullptr && lastLine->endsWithLineBreak())
+    if (const CodeDocumentLine* const lastLine = findLine (lines.size() - 1))
     {
-        // check that there's an empty line at the end if the preceding one ends in a newline..
-        lines.add (new CodeDocumentLine (String::empty.getCharPointer(), 0, 0, lastLine->lineStartInFile + lastLine->lineLength));
+        if (lastLine->endsWithLineBreak())
+        {
+            // check that there's an empty line at the end if the preceding one ends in a newline..
+            const int endOfFile = lastLine->lineStartInFile + lastLine->lineLength;
+            lines.add (CodeDocumentLine (String::empty.getCharPointer(), 0, 0, endOfFile));
+        }
     }
 }
 
@@ -846,8 +865,9 @@ void CodeDocument::insert (const String& text, const int insertPos, const bool u
             Position pos (*this, insertPos);
             const int firstAffectedLine = pos.getLineNumber();
 
-            CodeDocumentLine* const firstLine = lines [firstAffectedLine];
+            const CodeDocumentLine* const firstLine = findLine (firstAffectedLine);
             String textInsideOriginalLine (text);
+            int lineStart = 0;
 
             if (firstLine != nullptr)
             {
@@ -855,24 +875,22 @@ void CodeDocument::insert (const String& text, const int insertPos, const bool u
                 textInsideOriginalLine = firstLine->line.substring (0, index)
                                          + textInsideOriginalLine
                                          + firstLine->line.substring (index);
+                lineStart = firstLine->lineStartInFile;
             }
 
             maximumLineLength = -1;
-            Array <CodeDocumentLine*> newLines;
+            Array <CodeDocumentLine> newLines;
             CodeDocumentLine::createLines (newLines, textInsideOriginalLine);
             jassert (newLines.size() > 0);
 
-            CodeDocumentLine* const newFirstLine = newLines.getUnchecked (0);
-            newFirstLine->lineStartInFile = firstLine != nullptr ? firstLine->lineStartInFile : 0;
-            lines.set (firstAffectedLine, newFirstLine);
+            lines.set (firstAffectedLine, newLines.getReference (0));
 
             if (newLines.size() > 1)
                 lines.insertArray (firstAffectedLine + 1, newLines.getRawDataPointer() + 1, newLines.size() - 1);
 
-            int lineStart = newFirstLine->lineStartInFile;
             for (int i = firstAffectedLine; i < lines.size(); ++i)
             {
-                CodeDocumentLine& l = *lines.getUnchecked (i);
+                CodeDocumentLine& l = lines.getReference (i);
                 l.lineStartInFile = lineStart;
                 lineStart += l.lineLength;
             }
@@ -945,7 +963,7 @@ void CodeDocument::remove (const int startPos, const int endPos, const bool undo
         maximumLineLength = -1;
         const int firstAffectedLine = startPosition.getLineNumber();
         const int endLine = endPosition.getLineNumber();
-        CodeDocumentLine& firstLine = *lines.getUnchecked (firstAffectedLine);
+        CodeDocumentLine& firstLine = lines.getReference (firstAffectedLine);
 
         if (firstAffectedLine == endLine)
         {
@@ -955,7 +973,7 @@ void CodeDocument::remove (const int startPos, const int endPos, const bool undo
         }
         else
         {
-            CodeDocumentLine& lastLine = *lines.getUnchecked (endLine);
+            CodeDocumentLine& lastLine = lines.getReference (endLine);
 
             firstLine.line = firstLine.line.substring (0, startPosition.getIndexInLine())
                             + lastLine.line.substring (endPosition.getIndexInLine());
@@ -967,8 +985,8 @@ void CodeDocument::remove (const int startPos, const int endPos, const bool undo
 
         for (int i = firstAffectedLine + 1; i < lines.size(); ++i)
         {
-            CodeDocumentLine& l = *lines.getUnchecked (i);
-            const CodeDocumentLine& previousLine = *lines.getUnchecked (i - 1);
+            CodeDocumentLine& l = lines.getReference (i);
+            const CodeDocumentLine& previousLine = lines.getReference (i - 1);
             l.lineStartInFile = previousLine.lineStartInFile + previousLine.lineLength;
         }
 
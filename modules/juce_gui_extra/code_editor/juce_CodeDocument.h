@@ -35,8 +35,8 @@ class CodeDocumentLine;
 
     When using a CodeEditorComponent, it takes one of these as its source object.
 
-    The CodeDocument stores its content as an array of lines, which makes it
-    quick to insert and delete.
+    The CodeDocument stores its content as a contiguous array of lines, which makes it
+    quick to insert and delete, and cheap to keep the line positions up to date.
 
     @see CodeEditorComponent
 */
@@ -49,6 +49,8 @@ public:
     /** Destructor. */
     ~CodeDocument();
 
+    class Iterator;
+
     //==============================================================================
     /** A position in a code document.
 
@@ -178,6 +180,8 @@ public:
         String getLineText() const;
 
     private:
+        friend class Iterator;
+
         CodeDocument* owner;
         int characterPos, line, indexInLine;
         bool positionMaintained;
@@ -355,7 +359,15 @@ public:
     class JUCE_API  Iterator
     {
     public:
+        /** Creates an iterator that starts at the beginning of the document. */
         Iterator (const CodeDocument& document) noexcept;
+
+        /** Creates an iterator that starts at the given position.
+            This lets a tokeniser resume from a point it has previously reached, rather than
+            having to re-read the document from its start.
+        */
+        Iterator (const Position& startPosition) noexcept;
+
         Iterator (const Iterator& other) noexcept;
         Iterator& operator= (const Iterator& other) noexcept;
         ~Iterator() noexcept;
@@ -399,7 +411,7 @@ private:
     friend class Iterator;
     friend class Position;
 
-    OwnedArray <CodeDocumentLine> lines;
+    Array <CodeDocumentLine> lines;
     Array <Position*> positionsToMaintain;
     UndoManager undoManager;
     int currentActionIndex, indexOfSavedState;
@@ -410,6 +422,7 @@ private:
     void insert (const String& text, int insertPos, bool undoable);
     void remove (int startPos, int endPos, bool undoable);
     void checkLastLineStatus();
+    const CodeDocumentLine* findLine (int lineIndex) const noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CodeDocument)
 };
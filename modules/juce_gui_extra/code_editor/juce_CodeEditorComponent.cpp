@@ -261,7 +261,7 @@ namespace CodeEditorHelpers
 }
 
 //==============================================================================
-class CodeEditorComponent::Pimpl   : public Timer,
+class CodeEditorComponent::Pimpl   : public MultiTimer,
                                      public AsyncUpdater,
                                      public ScrollBar::Listener,
                                      public CodeDocument::Listener
@@ -269,10 +269,23 @@ class CodeEditorComponent::Pimpl   : public Timer,
 public:
     Pimpl (CodeEditorComponent& ed) : owner (ed) {}
 
+    enum TimerIds
+    {
+        transactionTimer = 1,
+        tokeniserTimer   = 2
+    };
+
 private:
     CodeEditorComponent& owner;
 
-    void timerCallback()        { owner.newTransaction(); }
+    void timerCallback (const int timerId)
+    {
+        if (timerId == transactionTimer)
+            owner.newTransaction();
+        else
+            owner.updateTokenStartsInBackground();
+    }
+
     void handleAsyncUpdate()    { owner.rebuildLineTokens(); }
 
     void scrollBarMoved (ScrollBar* scrollBarThatHasMoved, double newRangeStart)
@@ -285,11 +298,13 @@ private:
 
     void codeDocumentTextInserted (const String& newText, int pos)
     {
+        owner.invalidateTokenStarts (pos, pos + newText.length());
         codeDocumentChanged (pos, pos + newText.length());
     }
 
     void codeDocumentTextDeleted (int start, int end)
     {
+        owner.invalidateTokenStarts (start, start);
         codeDocumentChanged (start, end);
     }
 
@@ -369,9 +384,12 @@ CodeEditorComponent::CodeEditorComponent (CodeDocument& doc, CodeTokeniser* cons
       verticalScrollBar (true),
       horizontalScrollBar (false),
       appCommandManager (nullptr),
-      codeTokeniser (tokeniser)
+      codeTokeniser (tokeniser),
+      numValidTokenStarts (0),
+      numUnchangedCharsAtEnd (0)
 {
     pimpl = new Pimpl (*this);
+    resetTokenStarts();
 
     caretPos.setPositionMaintained (true);
     selectionStart.setPositionMaintained (true);
@@ -415,8 +433,8 @@ int CodeEditorComponent::getGutterSize() const noexcept
 
 void CodeEditorComponent::loadContent (const String& newContent)
 {
-    clearCachedIterators (0);
     document.replaceAllContent (newContent);
+    resetTokenStarts();
     document.clearUndoHistory();
     document.setSavePoint();
     caretPos.setPosition (0);
@@ -538,7 +556,7 @@ void CodeEditorComponent::rebuildLineTokens()
     jassert (numNeeded == lines.size());
 
     CodeDocument::Iterator source (document);
-    getIteratorForPosition (CodeDocument::Position (document, firstLineOnScreen, 0).getPosition(), source);
+    getIteratorForLine (firstLineOnScreen, source);
 
     for (int i = 0; i < numNeeded; ++i)
     {
@@ -563,8 +581,6 @@ void CodeEditorComponent::codeDocumentChanged (const int startIndex, const int e
     const CodeDocument::Position affectedTextStart (document, startIndex);
     const CodeDocument::Position affectedTextEnd (document, endIndex);
 
-    clearCachedIterators (affectedTextStart.getLineNumber());
-
     rebuildLineTokensAsync();
 
     updateCaretPosition();
@@ -675,7 +691,6 @@ void CodeEditorComponent::scrollToLineInternal (int newFirstLineOnScreen)
         firstLineOnScreen = newFirstLineOnScreen;
         updateCaretPosition();
 
-        updateCachedIterators (firstLineOnScreen);
         rebuildLineTokensAsync();
         pimpl->handleUpdateNowIfNeeded();
     }
@@ -1144,7 +1159,7 @@ bool CodeEditorComponent::redo()
 void CodeEditorComponent::newTransaction()
 {
     document.newTransaction();
-    pimpl->startTimer (600);
+    pimpl->startTimer (Pimpl::transactionTimer, 600);
 }
 
 void CodeEditorComponent::setCommandManager (ApplicationCommandManager* newManager) noexcept
@@ -1516,64 +1531,133 @@ Colour CodeEditorComponent::getColourForTokenType (const int tokenType) const
                 : findColour (CodeEditorComponent::defaultTextColourId);
 }
 
-void CodeEditorComponent::clearCachedIterators (const int firstLineToBeInvalid)
+//==============================================================================
+/*  For each line of the document, lineTokenStarts holds the distance back from the start
+    of the line to the start of the token that contains it, so that the tokeniser can begin
+    reading from there instead of from the top of the document. Only the first
+    numValidTokenStarts entries are known to be correct; the rest are left as they were
+    before the last edits, and are brought back up to date a slice at a time by the timer.
+*/
+void CodeEditorComponent::resetTokenStarts()
 {
-    int i;
-    for (i = cachedIterators.size(); --i >= 0;)
-        if (cachedIterators.getUnchecked (i)->getLine() < firstLineToBeInvalid)
-            break;
+    lineTokenStarts.clearQuick();
+    lineTokenStarts.insertMultiple (0, 0, document.getNumLines());
+    numValidTokenStarts = 0;
+    numUnchangedCharsAtEnd = 0;
 
-    cachedIterators.removeRange (jmax (0, i - 1), cachedIterators.size());
+    startBackgroundTokenising();
 }
 
-void CodeEditorComponent::updateCachedIterators (int maxLineNum)
+void CodeEditorComponent::invalidateTokenStarts (const int startIndex, const int endIndex)
 {
-    const int maxNumCachedPositions = 5000;
-    const int linesBetweenCachedSources = jmax (10, document.getNumLines() / maxNumCachedPositions);
+    const int numLines = document.getNumLines();
+    const int firstLine = CodeDocument::Position (document, startIndex).getLineNumber();
+    const int numLinesAdded = numLines - lineTokenStarts.size();
 
-    if (cachedIterators.size() == 0)
-        cachedIterators.add (new CodeDocument::Iterator (document));
+    // any lines that were added or removed by the edit lie just after the line it began on
+    if (numLinesAdded > 0)
+        lineTokenStarts.insertMultiple (firstLine + 1, 0, numLinesAdded);
+    else
+        lineTokenStarts.removeRange (jmin (firstLine + 1, numLines), -numLinesAdded);
 
-    if (codeTokeniser != nullptr)
+    jassert (lineTokenStarts.size() == numLines);
+
+    numValidTokenStarts = jmin (numValidTokenStarts, firstLine);
+    numUnchangedCharsAtEnd = jmin (numUnchangedCharsAtEnd, document.getNumCharacters() - endIndex);
+
+    startBackgroundTokenising();
+}
+
+bool CodeEditorComponent::updateTokenStarts (const int lineNeeded, const int maxMillisecs)
+{
+    const int numLines = lineTokenStarts.size();
+    jassert (numLines == document.getNumLines());
+
+    if (numValidTokenStarts == 0 && numLines > 0)
     {
-        for (;;)
-        {
-            CodeDocument::Iterator& last = *cachedIterators.getLast();
+        lineTokenStarts.set (0, 0);
+        numValidTokenStarts = 1;
+    }
 
-            if (last.getLine() >= maxLineNum)
-                break;
+    if (lineNeeded < numValidTokenStarts || numValidTokenStarts >= numLines)
+        return lineNeeded < numValidTokenStarts;
 
-            CodeDocument::Iterator* t = new CodeDocument::Iterator (last);
-            cachedIterators.add (t);
-            const int targetLine = last.getLine() + linesBetweenCachedSources;
+    const uint32 endTime = Time::getMillisecondCounter() + (uint32) maxMillisecs;
+    const int firstUnchangedChar = document.getNumCharacters() - numUnchangedCharsAtEnd;
 
-            for (;;)
-            {
-                codeTokeniser->readNextToken (*t);
+    const int startLine = numValidTokenStarts - 1;
+    const CodeDocument::Position startLinePos (document, startLine, 0);
+    CodeDocument::Iterator source (startLinePos.movedBy (-lineTokenStarts.getUnchecked (startLine)));
 
-                if (t->getLine() >= targetLine)
-                    break;
+    int line = startLine + 1;
+    int lineStart = CodeDocument::Position (document, line, 0).getPosition();
+
+    for (int numTokensRead = 0; line <= lineNeeded && line < numLines; ++numTokensRead)
+    {
+        if ((numTokensRead & 31) == 31 && Time::getMillisecondCounter() >= endTime)
+            break;
+
+        const int tokenStart = source.getPosition();
+        codeTokeniser->readNextToken (source);
 
-                if (t->isEOF())
-                    return;
+        const int tokenEnd = source.getPosition() > tokenStart ? source.getPosition()
+                                                               : std::numeric_limits<int>::max();
+
+        while (lineStart < tokenEnd && line < numLines)
+        {
+            const int offset = lineStart - tokenStart;
+
+            if (tokenStart > firstUnchangedChar && offset == lineTokenStarts.getUnchecked (line))
+            {
+                // the tokeniser is back in step with the text that was never edited, so
+                // all the remaining lines will start where they did before.
+                line = numLines;
+            }
+            else
+            {
+                lineTokenStarts.set (line++, offset);
+                lineStart = CodeDocument::Position (document, line, 0).getPosition();
             }
         }
+
+        numValidTokenStarts = line;
     }
+
+    if (numValidTokenStarts >= numLines)
+        numUnchangedCharsAtEnd = std::numeric_limits<int>::max();
+
+    return lineNeeded < numValidTokenStarts;
 }
 
-void CodeEditorComponent::getIteratorForPosition (int position, CodeDocument::Iterator& source)
+void CodeEditorComponent::startBackgroundTokenising()
 {
-    if (codeTokeniser != nullptr)
+    if (codeTokeniser != nullptr && numValidTokenStarts < lineTokenStarts.size())
+        pimpl->startTimer (Pimpl::tokeniserTimer, 5);
+}
+
+void CodeEditorComponent::updateTokenStartsInBackground()
+{
+    const bool firstLineWasValid = firstLineOnScreen < numValidTokenStarts;
+
+    if (codeTokeniser == nullptr
+         || updateTokenStarts (lineTokenStarts.size() - 1, 10))
+        pimpl->stopTimer (Pimpl::tokeniserTimer);
+
+    if (firstLineOnScreen < numValidTokenStarts && ! firstLineWasValid)
+        rebuildLineTokensAsync();
+}
+
+void CodeEditorComponent::getIteratorForLine (const int lineNum, CodeDocument::Iterator& source)
+{
+    if (codeTokeniser != nullptr && isPositiveAndBelow (lineNum, lineTokenStarts.size()))
     {
-        for (int i = cachedIterators.size(); --i >= 0;)
-        {
-            const CodeDocument::Iterator& t = *cachedIterators.getUnchecked (i);
-            if (t.getPosition() <= position)
-            {
-                source = t;
-                break;
-            }
-        }
+        // Bring the lines on screen up to date straight away if it won't take long. If it would,
+        // their old token starts are a good enough guess until the background update gets there.
+        updateTokenStarts (lineNum, 10);
+
+        const CodeDocument::Position lineStart (document, lineNum, 0);
+        const int position = lineStart.getPosition();
+        source = CodeDocument::Iterator (lineStart.movedBy (-lineTokenStarts.getUnchecked (lineNum)));
 
         while (source.getPosition() < position)
         {
@@ -391,10 +391,14 @@ private:
     void rebuildLineTokensAsync();
     void codeDocumentChanged (int start, int end);
 
-    OwnedArray <CodeDocument::Iterator> cachedIterators;
-    void clearCachedIterators (int firstLineToBeInvalid);
-    void updateCachedIterators (int maxLineNum);
-    void getIteratorForPosition (int position, CodeDocument::Iterator&);
+    Array <int> lineTokenStarts;
+    int numValidTokenStarts, numUnchangedCharsAtEnd;
+    void resetTokenStarts();
+    void invalidateTokenStarts (int startIndex, int endIndex);
+    bool updateTokenStarts (int lineNeeded, int maxMillisecs);
+    void startBackgroundTokenising();
+    void updateTokenStartsInBackground();
+    void getIteratorForLine (int line, CodeDocument::Iterator&);
 
     void moveLineDelta (int delta, bool selecting);
     int getGutterSize() const noexcept;
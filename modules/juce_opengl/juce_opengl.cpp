@@ -106,6 +106,13 @@ void OpenGLExtensionFunctions::initialise()
 
 #undef JUCE_GL_EXTENSION_FUNCTIONS
 
+// The calling convention for optional GL functions that get loaded with OpenGLHelpers::getExtensionFunction()
+#if JUCE_WINDOWS
+ #define JUCE_GL_CALLTYPE __stdcall
+#else
+ #define JUCE_GL_CALLTYPE
+#endif
+
 #if JUCE_OPENGL_ES
  #define JUCE_MEDIUMP "mediump"
  #define JUCE_HIGHP   "highp"
@@ -214,5 +221,6 @@ private:
 #endif
 
 #include "opengl/juce_OpenGLContext.cpp"
+#include "opengl/juce_OpenGLContextGroup.cpp"
 
 }
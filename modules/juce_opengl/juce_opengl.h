@@ -90,6 +90,9 @@ namespace juce
 #ifndef __JUCE_OPENGLCONTEXT_JUCEHEADER__
  #include "opengl/juce_OpenGLContext.h"
 #endif
+#ifndef __JUCE_OPENGLCONTEXTGROUP_JUCEHEADER__
+ #include "opengl/juce_OpenGLContextGroup.h"
+#endif
 #ifndef __JUCE_OPENGLFRAMEBUFFER_JUCEHEADER__
  #include "opengl/juce_OpenGLFrameBuffer.h"
 #endif
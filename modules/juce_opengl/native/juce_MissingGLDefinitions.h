@@ -81,6 +81,42 @@
  #define GL_STENCIL_ATTACHMENT   0x8D20
 #endif
 
+#ifndef GL_INCR_WRAP
+ #define GL_INCR_WRAP            0x8507
+#endif
+
+#ifndef GL_DECR_WRAP
+ #define GL_DECR_WRAP            0x8508
+#endif
+
+#ifndef GL_SAMPLE_BUFFERS
+ #define GL_SAMPLE_BUFFERS       0x80A8
+#endif
+
+#ifndef GL_QUERY_RESULT
+ #define GL_QUERY_RESULT         0x8866
+#endif
+
+#ifndef GL_QUERY_RESULT_AVAILABLE
+ #define GL_QUERY_RESULT_AVAILABLE   0x8867
+#endif
+
+#ifndef GL_TIME_ELAPSED
+ #define GL_TIME_ELAPSED         0x88BF
+#endif
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+ #define GL_PROGRAM_BINARY_RETRIEVABLE_HINT  0x8257
+#endif
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+ #define GL_PROGRAM_BINARY_LENGTH        0x8741
+#endif
+
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+ #define GL_NUM_PROGRAM_BINARY_FORMATS   0x87FE
+#endif
+
 #if JUCE_WINDOWS
 namespace
 {
@@ -126,6 +162,7 @@ namespace
         GL_TEXTURE0                     = 0x84C0,
         GL_TEXTURE1                     = 0x84C1,
         GL_TEXTURE2                     = 0x84C2,
+        GL_ACTIVE_TEXTURE               = 0x84E0,
         GL_COMBINE                      = 0x8570,
         GL_COMBINE_RGB                  = 0x8571,
         GL_COMBINE_ALPHA                = 0x8572,
@@ -135,8 +172,17 @@ namespace
         GL_SHADING_LANGUAGE_VERSION     = 0x8B8C,
         GL_FRAGMENT_SHADER              = 0x8B30,
         GL_VERTEX_SHADER                = 0x8B31,
+        GL_CURRENT_PROGRAM              = 0x8B8D,
         GL_ARRAY_BUFFER                 = 0x8892,
         GL_ELEMENT_ARRAY_BUFFER         = 0x8893,
+        GL_ARRAY_BUFFER_BINDING         = 0x8894,
+        GL_VERTEX_ATTRIB_ARRAY_ENABLED  = 0x8622,
+        GL_VERTEX_ATTRIB_ARRAY_SIZE     = 0x8623,
+        GL_VERTEX_ATTRIB_ARRAY_STRIDE   = 0x8624,
+        GL_VERTEX_ATTRIB_ARRAY_TYPE     = 0x8625,
+        GL_VERTEX_ATTRIB_ARRAY_POINTER  = 0x8645,
+        GL_VERTEX_ATTRIB_ARRAY_NORMALIZED = 0x886A,
+        GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING = 0x889F,
         GL_STATIC_DRAW                  = 0x88E4,
         GL_DYNAMIC_DRAW                 = 0x88E8,
         GL_STREAM_DRAW                  = 0x88E0
@@ -24,7 +24,8 @@
 */
 
 class OpenGLContext::CachedImage  : public CachedComponentImage,
-                                    public Thread
+                                    public Thread,
+                                    private AsyncUpdater
 {
 public:
     CachedImage (OpenGLContext& c, Component& comp,
@@ -38,8 +39,21 @@ public:
           shadersAvailable (false),
          #endif
           hasInitialised (false),
-          needsUpdate (1)
+          isSharingWithGroup (false),
+          needsUpdate (1),
+          lastSwapTime (0),
+          averageSwapTime (0),
+          groupContextSharedWith (nullptr),
+          groupGeneration (0)
     {
+        if (context.contextGroup != nullptr)
+        {
+            groupContextSharedWith = context.contextGroup->getNativeContextToShareWith (groupGeneration);
+
+            if (groupContextSharedWith != nullptr)
+                contextToShare = groupContextSharedWith;
+        }
+
         nativeContext = new NativeContext (component, pixFormat, contextToShare);
 
         if (nativeContext->createdOk())
@@ -63,6 +77,8 @@ public:
 
     void stop()
     {
+        cancelPendingUpdate();
+
        #if ! JUCE_ANDROID
         stopThread (10000);
        #endif
@@ -94,6 +110,14 @@ public:
     {
         needsUpdate = 1;
 
+        if (context.pipelinedPainting && context.renderComponents)
+            triggerAsyncUpdate();
+        else
+            wakeRenderThread();
+    }
+
+    void wakeRenderThread()
+    {
        #if JUCE_ANDROID
         if (nativeContext != nullptr)
             nativeContext->triggerRepaint();
@@ -103,17 +127,18 @@ public:
     }
 
     //==============================================================================
-    bool ensureFrameBufferSize()
+    bool ensureFrameBufferSize (const Rectangle<int>& area, bool& wasRecreated)
     {
         const int fbW = cachedImageFrameBuffer.getWidth();
         const int fbH = cachedImageFrameBuffer.getHeight();
+        wasRecreated = false;
 
-        if (fbW != viewportArea.getWidth() || fbH != viewportArea.getHeight() || ! cachedImageFrameBuffer.isValid())
+        if (fbW != area.getWidth() || fbH != area.getHeight() || ! cachedImageFrameBuffer.isValid())
         {
-            if (! cachedImageFrameBuffer.initialise (context, viewportArea.getWidth(), viewportArea.getHeight()))
+            if (! cachedImageFrameBuffer.initialise (context, area.getWidth(), area.getHeight()))
                 return false;
 
-            validArea.clear();
+            wasRecreated = true;
             JUCE_CHECK_OPENGL_ERROR
         }
 
@@ -146,8 +171,9 @@ public:
         ScopedPointer<MessageManagerLock> mmLock;
 
         const bool isUpdating = needsUpdate.compareAndSetBool (0, 1);
+        const bool isPipelined = context.pipelinedPainting;
 
-        if (context.renderComponents && isUpdating)
+        if (context.renderComponents && isUpdating && ! isPipelined)
         {
             mmLock = new MessageManagerLock (this);  // need to acquire this before locking the context.
             if (! mmLock->lockWasGained())
@@ -159,8 +185,20 @@ public:
 
         NativeContext::Locker locker (*nativeContext);
 
+        // The contexts in a group take turns to use their shared resources..
+        ScopedPointer<ScopedLock> groupLock;
+
+        if (isSharingWithGroup)
+        {
+            groupLock = new ScopedLock (context.contextGroup->lock);
+            context.contextGroup->runPendingLoaders (context);
+        }
+
         JUCE_CHECK_OPENGL_ERROR
 
+        const double frameStartTime = Time::getMillisecondCounterHiRes();
+        gpuTimer.begin();
+
         if (context.renderer != nullptr)
         {
             glViewport (0, 0, viewportArea.getWidth(), viewportArea.getHeight());
@@ -170,7 +208,11 @@ public:
 
         if (context.renderComponents)
         {
-            if (isUpdating)
+            if (isPipelined)
+            {
+                renderRecordedFrame();
+            }
+            else if (isUpdating)
             {
                 paintComponent();
                 mmLock = nullptr;
@@ -180,7 +222,20 @@ public:
             drawComponentBuffer();
         }
 
+        gpuTimer.end();
+
+        if (groupLock != nullptr)
+        {
+            // make sure another context can't overtake the commands that used the shared objects
+            glFlush();
+            groupLock = nullptr;
+        }
+
+        const double swapStartTime = Time::getMillisecondCounterHiRes();
+
         context.swapBuffers();
+
+        updateFrameStatistics (frameStartTime, swapStartTime, Time::getMillisecondCounterHiRes());
         return true;
     }
 
@@ -209,9 +264,13 @@ public:
 
         updateViewportSize (false);
 
-        if (! ensureFrameBufferSize())
+        bool frameBufferWasRecreated;
+        if (! ensureFrameBufferSize (viewportArea, frameBufferWasRecreated))
             return;
 
+        if (frameBufferWasRecreated)
+            validArea.clear();
+
         RectangleList invalid (viewportArea);
         invalid.subtract (validArea);
         validArea = viewportArea;
@@ -225,7 +284,9 @@ public:
                 g->addTransform (AffineTransform::scale ((float) scale));
                 g->clipToRectangleList (invalid);
 
+                const double paintStartTime = Time::getMillisecondCounterHiRes();
                 paintOwner (*g);
+                setPaintTime (Time::getMillisecondCounterHiRes() - paintStartTime);
                 JUCE_CHECK_OPENGL_ERROR
             }
 
@@ -236,6 +297,116 @@ public:
         JUCE_CHECK_OPENGL_ERROR
     }
 
+    //==============================================================================
+    /** A frame that the message thread has painted into a display list, which is
+        waiting for the render thread to draw it.
+    */
+    struct RecordedFrame
+    {
+        RecordedFrame (const Rectangle<int>& viewport, const RectangleList& invalid, double scaleFactor)
+            : viewportArea (viewport), invalidArea (invalid), scale (scaleFactor)
+        {}
+
+        DisplayList displayList;
+        Rectangle<int> viewportArea;
+        RectangleList invalidArea;
+        double scale;
+
+        JUCE_DECLARE_NON_COPYABLE (RecordedFrame)
+    };
+
+    // Called on the message thread when painting is pipelined, to record the invalid
+    // parts of the component and hand them over to the render thread.
+    void handleAsyncUpdate()
+    {
+        // you mustn't set your own cached image object when attaching a GL context!
+        jassert (get (component) == this);
+
+        updateViewportSize (false);
+
+        if (fullRepaintNeeded.compareAndSetBool (0, 1))
+            validArea.clear();
+
+        RectangleList invalid (viewportArea);
+        invalid.subtract (validArea);
+        validArea = viewportArea;
+
+        {
+            // If the render thread hasn't got round to the previous frame yet, this one replaces
+            // it, so it needs to cover the areas that the old one would have drawn as well.
+            const ScopedLock sl (frameLock);
+
+            if (pendingFrame != nullptr)
+            {
+                invalid.add (pendingFrame->invalidArea);
+                invalid.clipTo (viewportArea);
+                pendingFrame = nullptr;
+            }
+        }
+
+        if (invalid.isEmpty())
+            return;
+
+        ScopedPointer<RecordedFrame> frame (new RecordedFrame (viewportArea, invalid, scale));
+
+        {
+            const double paintStartTime = Time::getMillisecondCounterHiRes();
+
+            DisplayList::Recorder recorder (frame->displayList, RectangleList (viewportArea));
+            recorder.addTransform (AffineTransform::scale ((float) scale));
+            recorder.clipToRectangleList (invalid);
+            paintOwner (recorder);
+
+            setPaintTime (Time::getMillisecondCounterHiRes() - paintStartTime);
+        }
+
+        {
+            const ScopedLock sl (frameLock);
+            pendingFrame = frame.release();
+        }
+
+        wakeRenderThread();
+    }
+
+    void renderRecordedFrame()
+    {
+        ScopedPointer<RecordedFrame> frame;
+
+        {
+            const ScopedLock sl (frameLock);
+            frame = pendingFrame.release();
+        }
+
+        if (frame == nullptr)
+            return;
+
+        bool frameBufferWasRecreated;
+        if (! ensureFrameBufferSize (frame->viewportArea, frameBufferWasRecreated))
+            return;
+
+        // A new framebuffer starts off empty, so unless this frame covers all of it, the
+        // message thread needs to paint the whole component again.
+        if (frameBufferWasRecreated && ! frame->invalidArea.containsRectangle (frame->viewportArea))
+        {
+            fullRepaintNeeded = 1;
+            triggerAsyncUpdate();
+        }
+
+        clearRegionInFrameBuffer (frame->invalidArea, (float) frame->scale);
+
+        {
+            ScopedPointer<LowLevelGraphicsContext> g (createOpenGLGraphicsContext (context, cachedImageFrameBuffer));
+            frame->displayList.draw (*g);
+            JUCE_CHECK_OPENGL_ERROR
+        }
+
+        if (! context.isActive())
+            context.makeActive();
+
+        JUCE_CHECK_OPENGL_ERROR
+    }
+
+    //==============================================================================
     void drawComponentBuffer()
     {
        #if ! JUCE_ANDROID
@@ -285,12 +456,204 @@ public:
        #if JUCE_MAC
         if (hasInitialised)
         {
+            if (context.pipelinedPainting && context.renderComponents)
+                handleUpdateNowIfNeeded();
+
             [nativeContext->view update];
             renderFrame();
         }
        #endif
     }
 
+    //==============================================================================
+    /** Measures how long the GPU spends on each frame, using timer queries.
+
+        The results are read back a few frames later, once they're available, so
+        that the render thread never stalls waiting for the GPU to catch up.
+    */
+    struct GPUTimer
+    {
+        GPUTimer() noexcept
+            : numQueries (0), currentQuery (0), isTiming (false), lastResult (-1.0)
+        {
+            zeromem (queryIDs, sizeof (queryIDs));
+            zeromem (queryIsPending, sizeof (queryIsPending));
+           #if ! JUCE_OPENGL_ES
+            zerostruct (functions);
+           #endif
+        }
+
+        void initialise()
+        {
+            release();
+
+           #if ! JUCE_OPENGL_ES
+            // Timer queries aren't part of the core functions that the context requires, so
+            // they're loaded separately and just aren't used if the driver lacks them.
+            if (OpenGLHelpers::isExtensionSupported ("GL_ARB_timer_query")
+                 || OpenGLHelpers::isExtensionSupported ("GL_EXT_timer_query"))
+            {
+                functions.genQueries     = (GenQueriesFunction)    OpenGLHelpers::getExtensionFunction ("glGenQueries");
+                functions.deleteQueries  = (GenQueriesFunction)    OpenGLHelpers::getExtensionFunction ("glDeleteQueries");
+                functions.beginQuery     = (BeginQueryFunction)    OpenGLHelpers::getExtensionFunction ("glBeginQuery");
+                functions.endQuery       = (EndQueryFunction)      OpenGLHelpers::getExtensionFunction ("glEndQuery");
+                functions.getQueryInt    = (GetQueryIntFunction)   OpenGLHelpers::getExtensionFunction ("glGetQueryObjectiv");
+                functions.getQueryUInt64 = (GetQueryInt64Function) OpenGLHelpers::getExtensionFunction ("glGetQueryObjectui64v");
+
+                if (functions.getQueryUInt64 == nullptr)
+                    functions.getQueryUInt64 = (GetQueryInt64Function) OpenGLHelpers::getExtensionFunction ("glGetQueryObjectui64vEXT");
+
+                if (functions.genQueries != nullptr && functions.deleteQueries != nullptr
+                     && functions.beginQuery != nullptr && functions.endQuery != nullptr
+                     && functions.getQueryInt != nullptr && functions.getQueryUInt64 != nullptr)
+                {
+                    numQueries = maxQueries;
+                    functions.genQueries (numQueries, queryIDs);
+                    clearGLError();
+                }
+            }
+           #endif
+        }
+
+        void release()
+        {
+           #if ! JUCE_OPENGL_ES
+            if (numQueries > 0)
+                functions.deleteQueries (numQueries, queryIDs);
+           #endif
+
+            numQueries = 0;
+            currentQuery = 0;
+            isTiming = false;
+            zeromem (queryIsPending, sizeof (queryIsPending));
+        }
+
+        void begin()
+        {
+           #if ! JUCE_OPENGL_ES
+            if (numQueries == 0)
+                return;
+
+            const GLuint queryID = queryIDs [currentQuery];
+
+            if (queryIsPending [currentQuery])
+            {
+                GLint isAvailable = 0;
+                functions.getQueryInt (queryID, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+
+                if (isAvailable == 0)
+                    return; // the GPU is more than a few frames behind, so skip timing this one.
+
+                uint64 nanoseconds = 0;
+                functions.getQueryUInt64 (queryID, GL_QUERY_RESULT, &nanoseconds);
+                lastResult = nanoseconds / 1.0e6;
+                queryIsPending [currentQuery] = false;
+            }
+
+            functions.beginQuery (GL_TIME_ELAPSED, queryID);
+            isTiming = true;
+           #endif
+        }
+
+        void end()
+        {
+           #if ! JUCE_OPENGL_ES
+            if (isTiming)
+            {
+                functions.endQuery (GL_TIME_ELAPSED);
+                queryIsPending [currentQuery] = true;
+                currentQuery = (currentQuery + 1) % numQueries;
+                isTiming = false;
+            }
+           #endif
+        }
+
+        double getLastResult() const noexcept       { return numQueries > 0 ? lastResult : -1.0; }
+
+    private:
+        enum { maxQueries = 4 };
+
+        GLuint queryIDs [maxQueries];
+        bool queryIsPending [maxQueries];
+        int numQueries, currentQuery;
+        bool isTiming;
+        double lastResult;
+
+       #if ! JUCE_OPENGL_ES
+        typedef void (JUCE_GL_CALLTYPE *GenQueriesFunction) (GLsizei, GLuint*);
+        typedef void (JUCE_GL_CALLTYPE *BeginQueryFunction) (GLenum, GLuint);
+        typedef void (JUCE_GL_CALLTYPE *EndQueryFunction) (GLenum);
+        typedef void (JUCE_GL_CALLTYPE *GetQueryIntFunction) (GLuint, GLenum, GLint*);
+        typedef void (JUCE_GL_CALLTYPE *GetQueryInt64Function) (GLuint, GLenum, uint64*);
+
+        struct Functions
+        {
+            GenQueriesFunction genQueries, deleteQueries;
+            BeginQueryFunction beginQuery;
+            EndQueryFunction endQuery;
+            GetQueryIntFunction getQueryInt;
+            GetQueryInt64Function getQueryUInt64;
+        };
+
+        Functions functions;
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE (GPUTimer)
+    };
+
+    //==============================================================================
+    void setPaintTime (const double milliseconds)
+    {
+        const SpinLock::ScopedLockType sl (statisticsLock);
+        statistics.paintTimeMs = milliseconds;
+    }
+
+    void updateFrameStatistics (const double frameStartTime, const double swapStartTime, const double swapEndTime)
+    {
+        const double swapTime = swapEndTime - swapStartTime;
+        averageSwapTime += (swapTime - averageSwapTime) * 0.1;
+
+        const SpinLock::ScopedLockType sl (statisticsLock);
+
+        if (lastSwapTime > 0)
+            statistics.averageFrameIntervalMs += ((swapEndTime - lastSwapTime) - statistics.averageFrameIntervalMs) * 0.1;
+
+        ++statistics.numFramesRendered;
+        statistics.renderTimeMs = swapStartTime - frameStartTime;
+        statistics.gpuTimeMs = gpuTimer.getLastResult();
+        lastSwapTime = swapEndTime;
+    }
+
+    OpenGLContext::FrameStatistics getFrameStatistics() const
+    {
+        const SpinLock::ScopedLockType sl (statisticsLock);
+        return statistics;
+    }
+
+    // When the driver waits for the display's vertical sync in swapBuffers(), that already
+    // paces the frames. If it returns immediately (e.g. because vsync is forced off, or the
+    // window is hidden), the thread would otherwise spin as fast as it can, so this waits
+    // until the next frame is due at the rate that the swap interval asks for.
+    void waitUntilNextFrameIsDue()
+    {
+        const int swapInterval = nativeContext->getSwapInterval();
+
+        if (swapInterval <= 0 || averageSwapTime >= 1.0)
+            return;
+
+        const double nextFrameTime = lastSwapTime + swapInterval * (1000.0 / 60.0);
+
+        while (! threadShouldExit())
+        {
+            const double timeToWait = nextFrameTime - Time::getMillisecondCounterHiRes();
+
+            if (timeToWait < 1.0)
+                break;
+
+            wait ((int) timeToWait);
+        }
+    }
+
     //==============================================================================
     void run()
     {
@@ -307,7 +670,9 @@ public:
 
         while (! threadShouldExit())
         {
-            if (! renderFrame())
+            if (renderFrame())
+                waitUntilNextFrameIsDue();
+            else
                 wait (5); // failed to render, so avoid a tight fail-loop.
         }
 
@@ -328,11 +693,22 @@ public:
 
         context.extensions.initialise();
         nativeContext->setSwapInterval (1);
+        gpuTimer.initialise();
+
+        if (context.pipelinedPainting && context.renderComponents)
+        {
+            // the framebuffer will be empty, so the message thread needs to paint everything again..
+            fullRepaintNeeded = 1;
+            triggerAsyncUpdate();
+        }
 
        #if JUCE_USE_OPENGL_SHADERS && ! JUCE_OPENGL_ES
         shadersAvailable = OpenGLShaderProgram::getLanguageVersion() > 0;
        #endif
 
+        if (context.contextGroup != nullptr)
+            joinContextGroup();
+
         if (context.renderer != nullptr)
             context.renderer->newOpenGLContextCreated();
     }
@@ -342,13 +718,40 @@ public:
         if (context.renderer != nullptr)
             context.renderer->openGLContextClosing();
 
+        gpuTimer.release();
         cachedImageFrameBuffer.release();
+
+        if (isSharingWithGroup)
+        {
+            const ScopedLock sl (context.contextGroup->lock);
+            context.contextGroup->removeContext (context);
+            isSharingWithGroup = false;
+        }
+
         nativeContext->shutdownOnRenderThread();
 
         associatedObjectNames.clear();
         associatedObjects.clear();
     }
 
+    void joinContextGroup()
+    {
+        OpenGLContextGroup& group = *context.contextGroup;
+        const ScopedLock sl (group.lock);
+
+        if (isSharingWithGroup)
+            group.removeContext (context); // (on android, this can get initialised twice)
+
+        isSharingWithGroup = group.addContext (context, groupContextSharedWith, groupGeneration);
+
+       #if JUCE_USE_OPENGL_SHADERS
+        // Compile the painting shaders now, so that a group's first context does this
+        // before its first frame, and the others don't have to do it at all.
+        if (isSharingWithGroup && shadersAvailable && context.renderComponents)
+            OpenGLRendering::ShaderPrograms::getFor (context);
+       #endif
+    }
+
     //==============================================================================
     static CachedImage* get (Component& c) noexcept
     {
@@ -370,8 +773,19 @@ public:
     ReferenceCountedArray<ReferenceCountedObject> associatedObjects;
 
     WaitableEvent canPaintNowFlag, finishedPaintingFlag;
-    bool shadersAvailable, hasInitialised;
-    Atomic<int> needsUpdate;
+    bool shadersAvailable, hasInitialised, isSharingWithGroup;
+    Atomic<int> needsUpdate, fullRepaintNeeded;
+
+    CriticalSection frameLock;
+    ScopedPointer<RecordedFrame> pendingFrame;
+
+    GPUTimer gpuTimer;
+    OpenGLContext::FrameStatistics statistics;
+    SpinLock statisticsLock;
+    double lastSwapTime, averageSwapTime;
+
+    void* groupContextSharedWith;
+    int groupGeneration;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedImage)
 };
@@ -522,7 +936,7 @@ private:
 //==============================================================================
 OpenGLContext::OpenGLContext()
     : nativeContext (nullptr), renderer (nullptr), contextToShareWith (nullptr),
-      renderComponents (true)
+      renderComponents (true), pipelinedPainting (false)
 {
 }
 
@@ -549,6 +963,15 @@ void OpenGLContext::setComponentPaintingEnabled (bool shouldPaintComponent) noex
     renderComponents = shouldPaintComponent;
 }
 
+void OpenGLContext::setComponentPaintingPipelined (bool shouldPipelinePainting) noexcept
+{
+    // This method must not be called when the context has already been attached!
+    // Call it before attaching your context, or use detach() first, before calling this!
+    jassert (nativeContext == nullptr);
+
+    pipelinedPainting = shouldPipelinePainting;
+}
+
 void OpenGLContext::setPixelFormat (const OpenGLPixelFormat& preferredPixelFormat) noexcept
 {
     // This method must not be called when the context has already been attached!
@@ -567,6 +990,20 @@ void OpenGLContext::setNativeSharedContext (void* nativeContextToShareWith) noex
     contextToShareWith = nativeContextToShareWith;
 }
 
+void OpenGLContext::setContextGroup (OpenGLContextGroup* groupToJoin) noexcept
+{
+    // This method must not be called when the context has already been attached!
+    // Call it before attaching your context, or use detach() first, before calling this!
+    jassert (nativeContext == nullptr);
+
+    contextGroup = groupToJoin;
+}
+
+OpenGLContextGroup* OpenGLContext::getContextGroup() const noexcept
+{
+    return contextGroup;
+}
+
 void OpenGLContext::attachTo (Component& component)
 {
     component.repaint();
@@ -653,6 +1090,20 @@ int OpenGLContext::getSwapInterval() const
     return nativeContext != nullptr ? nativeContext->getSwapInterval() : 0;
 }
 
+OpenGLContext::FrameStatistics::FrameStatistics() noexcept
+    : numFramesRendered (0), paintTimeMs (0), renderTimeMs (0),
+      gpuTimeMs (-1.0), averageFrameIntervalMs (0)
+{
+}
+
+OpenGLContext::FrameStatistics OpenGLContext::getFrameStatistics() const
+{
+    if (CachedImage* const c = getCachedImage())
+        return c->getFrameStatistics();
+
+    return FrameStatistics();
+}
+
 void* OpenGLContext::getRawContext() const noexcept
 {
     return nativeContext != nullptr ? nativeContext->getRawContext() : nullptr;
@@ -709,6 +1160,50 @@ void OpenGLContext::setAssociatedObject (const char* name, ReferenceCountedObjec
     }
 }
 
+ReferenceCountedObject* OpenGLContext::getSharedObject (const char* name) const
+{
+    jassert (name != nullptr);
+
+    CachedImage* const c = getCachedImage();
+
+    if (c != nullptr && c->isSharingWithGroup)
+    {
+        // This method must only be called from an openGL rendering callback.
+        jassert (getCurrentContext() != nullptr);
+        return contextGroup->getObject (name);
+    }
+
+    return getAssociatedObject (name);
+}
+
+void OpenGLContext::setSharedObject (const char* name, ReferenceCountedObject* newObject)
+{
+    jassert (name != nullptr);
+
+    CachedImage* const c = getCachedImage();
+
+    if (c != nullptr && c->isSharingWithGroup)
+    {
+        // This method must only be called from an openGL rendering callback.
+        jassert (getCurrentContext() != nullptr);
+        contextGroup->setObject (name, newObject);
+    }
+    else
+    {
+        setAssociatedObject (name, newObject);
+    }
+}
+
+OpenGLContext& OpenGLContext::getContextForSharedObjects() noexcept
+{
+    CachedImage* const c = getCachedImage();
+
+    if (c != nullptr && c->isSharingWithGroup)
+        return contextGroup->resourceContext;
+
+    return *this;
+}
+
 void OpenGLContext::copyTexture (const Rectangle<int>& targetClipArea,
                                  const Rectangle<int>& anchorPosAndTextureSize,
                                  const int contextWidth, const int contextHeight,
@@ -733,12 +1228,12 @@ void OpenGLContext::copyTexture (const Rectangle<int>& targetClipArea,
             static const OverlayShaderProgram& select (OpenGLContext& context)
             {
                 static const char programValueID[] = "juceGLComponentOverlayShader";
-                OverlayShaderProgram* program = static_cast <OverlayShaderProgram*> (context.getAssociatedObject (programValueID));
+                OverlayShaderProgram* program = static_cast <OverlayShaderProgram*> (context.getSharedObject (programValueID));
 
                 if (program == nullptr)
                 {
-                    program = new OverlayShaderProgram (context);
-                    context.setAssociatedObject (programValueID, program);
+                    program = new OverlayShaderProgram (context.getContextForSharedObjects());
+                    context.setSharedObject (programValueID, program);
                 }
 
                 program->program.use();
@@ -30,6 +30,7 @@
 #include "../native/juce_OpenGLExtensions.h"
 #include "juce_OpenGLRenderer.h"
 
+class OpenGLContextGroup;
 
 //==============================================================================
 /**
@@ -80,6 +81,27 @@ public:
     */
     void setComponentPaintingEnabled (bool shouldPaintComponent) noexcept;
 
+    /** Lets the component's painting happen at the same time as the GL rendering.
+
+        Normally, each time the target component needs repainting, the render thread locks
+        the message thread while the component's paint() methods are called, so neither
+        thread can get on with anything else until both have finished.
+
+        When this is enabled, the component is painted on the message thread instead, into
+        a DisplayList, and the render thread replays that list into its cached image without
+        needing a MessageManagerLock. This means that the message thread can be painting the
+        next frame while the render thread is still drawing the previous one.
+
+        Because your paint() methods will no longer be called on the render thread, they
+        mustn't make any GL calls or draw any OpenGLImageType images, and any images that they
+        draw shouldn't be modified until the frame has been rendered.
+
+        By default this is false. It has no effect if component painting is disabled.
+        Note: This must be called BEFORE attaching your context to a target component!
+        @see setComponentPaintingEnabled
+    */
+    void setComponentPaintingPipelined (bool shouldPipelinePainting) noexcept;
+
     /** Sets the pixel format which you'd like to use for the target GL surface.
         Note: This must be called BEFORE attaching your context to a target component!
     */
@@ -93,6 +115,16 @@ public:
     */
     void setNativeSharedContext (void* nativeContextToShareWith) noexcept;
 
+    /** Puts this context into a group of contexts which will share their GL resources.
+        Pass a null pointer to take it out of its group.
+        Note: This must be called BEFORE attaching your context to a target component!
+        @see OpenGLContextGroup
+    */
+    void setContextGroup (OpenGLContextGroup* groupToJoin) noexcept;
+
+    /** Returns the group that this context was put into with setContextGroup(), if any. */
+    OpenGLContextGroup* getContextGroup() const noexcept;
+
     //==============================================================================
     /** Attaches the context to a target component.
 
@@ -160,6 +192,41 @@ public:
     */
     void setAssociatedObject (const char* name, ReferenceCountedObject* newObject);
 
+    /** This retrieves an object that was previously stored with setSharedObject().
+        If no object is found with the given name, this will return nullptr.
+        This method must only be called from within the GL rendering methods.
+        @see setSharedObject
+    */
+    ReferenceCountedObject* getSharedObject (const char* name) const;
+
+    /** Stores a named object that can be used by all the contexts in this context's group.
+
+        If the context is sharing its resources with an OpenGLContextGroup, the object will
+        be visible to all the other contexts in the group, and will be deleted when the last
+        of them is closed. Otherwise, this behaves just like setAssociatedObject().
+
+        Only use this for objects whose GL resources can be shared between contexts, such as
+        textures, buffers and shader programs. The object may outlive this context, so if it
+        needs to keep a reference to a context (as OpenGLShaderProgram does), it must be
+        created with the one returned by getContextForSharedObjects().
+
+        This method must only be called from within the GL rendering methods.
+        @see getSharedObject, OpenGLContextGroup
+    */
+    void setSharedObject (const char* name, ReferenceCountedObject* newObject);
+
+    /** Returns the context that any objects stored with setSharedObject() should be
+        created with.
+
+        When this context is sharing its resources with a group, this returns a context
+        object that belongs to the group, which is never attached to anything, but whose
+        extension functions can be used by objects that are shared by the whole group.
+        Otherwise, it just returns this context.
+
+        This method must only be called from within the GL rendering methods.
+    */
+    OpenGLContext& getContextForSharedObjects() noexcept;
+
     //==============================================================================
     /** Makes this context the currently active one.
         You should never need to call this in normal use - the context will already be
@@ -200,6 +267,49 @@ public:
     */
     int getSwapInterval() const;
 
+    //==============================================================================
+    /** Timing information about the frames that a context has rendered.
+        @see getFrameStatistics
+    */
+    struct FrameStatistics
+    {
+        FrameStatistics() noexcept;
+
+        /** The number of frames that have been drawn since the context was attached. */
+        int numFramesRendered;
+
+        /** The time taken by the last call to paint the target component, in milliseconds.
+            When painting is pipelined, this is the time that the message thread spent
+            recording it.
+        */
+        double paintTimeMs;
+
+        /** The CPU time that the render thread spent on its last frame, in milliseconds, not
+            including the time spent waiting for the buffers to be swapped.
+        */
+        double renderTimeMs;
+
+        /** The time that the GPU spent executing the last frame, in milliseconds.
+            This is measured with timer queries, so it lags a few frames behind the others,
+            and will be negative if the driver doesn't support them.
+        */
+        double gpuTimeMs;
+
+        /** A running average of the time between buffer swaps, in milliseconds. */
+        double averageFrameIntervalMs;
+    };
+
+    /** Returns timing information about the frames that this context has rendered.
+
+        If the swap interval is non-zero but the driver doesn't actually wait for the display
+        when the buffers are swapped, the render thread will pace itself to the rate that the
+        swap interval asks for, so the frame interval should stay close to the display's.
+
+        This can be called from any thread.
+        @see setSwapInterval
+    */
+    FrameStatistics getFrameStatistics() const;
+
     //==============================================================================
     /** Returns an OS-dependent handle to some kind of underlting OS-provided GL context.
 
@@ -243,7 +353,8 @@ private:
     ScopedPointer<Attachment> attachment;
     OpenGLPixelFormat pixelFormat;
     void* contextToShareWith;
-    bool renderComponents;
+    ReferenceCountedObjectPtr<OpenGLContextGroup> contextGroup;
+    bool renderComponents, pipelinedPainting;
 
     CachedImage* getCachedImage() const noexcept;
 
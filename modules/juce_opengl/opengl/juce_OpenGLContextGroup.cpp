@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+OpenGLContextGroup::OpenGLContextGroup()
+    : numLoadersRun (0), generation (0)
+{
+}
+
+OpenGLContextGroup::~OpenGLContextGroup()
+{
+    // All the contexts in the group should have been closed before it gets deleted!
+    jassert (nativeContexts.size() == 0 && objects.size() == 0);
+}
+
+void OpenGLContextGroup::addResourceLoader (ResourceLoader* const loaderToAdd)
+{
+    jassert (loaderToAdd != nullptr);
+
+    const ScopedLock sl (lock);
+    loaders.add (loaderToAdd);
+}
+
+int OpenGLContextGroup::getNumSharingContexts() const
+{
+    const ScopedLock sl (lock);
+    return nativeContexts.size();
+}
+
+void* OpenGLContextGroup::getNativeContextToShareWith (int& currentGeneration) const
+{
+    const ScopedLock sl (lock);
+    currentGeneration = generation;
+
+   #if JUCE_ANDROID
+    return nullptr; // (the android context can't be shared)
+   #else
+    return nativeContexts.getFirst();
+   #endif
+}
+
+bool OpenGLContextGroup::addContext (OpenGLContext& context, void* nativeContextSharedWith, int generationWhenCreated)
+{
+    // (the caller must already hold the lock)
+    void* const nativeContext = context.getRawContext();
+    jassert (nativeContext != nullptr);
+
+    if (nativeContexts.size() == 0)
+    {
+        // This is the first context to start, so it gets to create the shared resources..
+        resourceContext.extensions.initialise();
+        numLoadersRun = 0;
+    }
+    else if (nativeContextSharedWith == nullptr || generationWhenCreated != generation)
+    {
+        return false;
+    }
+
+    nativeContexts.add (nativeContext);
+    runPendingLoaders (context);
+    return true;
+}
+
+void OpenGLContextGroup::removeContext (OpenGLContext& context)
+{
+    // (the caller must already hold the lock)
+    nativeContexts.removeFirstMatchingValue (context.getRawContext());
+
+    if (nativeContexts.size() == 0)
+    {
+        // This is the last context that can see the shared objects, so they need to be
+        // deleted while it's still active.
+        objectNames.clear();
+        objects.clear();
+        ++generation;
+    }
+}
+
+void OpenGLContextGroup::runPendingLoaders (OpenGLContext& context)
+{
+    // (the caller must already hold the lock)
+    while (numLoadersRun < loaders.size())
+    {
+        loaders.getUnchecked (numLoadersRun++)->loadSharedResources (context);
+        clearGLError();
+    }
+}
+
+ReferenceCountedObject* OpenGLContextGroup::getObject (const char* name) const
+{
+    const int index = objectNames.indexOf (name);
+    return index >= 0 ? objects.getUnchecked (index) : nullptr;
+}
+
+void OpenGLContextGroup::setObject (const char* name, ReferenceCountedObject* newObject)
+{
+    const int index = objectNames.indexOf (name);
+
+    if (index >= 0)
+    {
+        objects.set (index, newObject);
+    }
+    else
+    {
+        objectNames.add (name);
+        objects.add (newObject);
+    }
+}
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_OPENGLCONTEXTGROUP_JUCEHEADER__
+#define __JUCE_OPENGLCONTEXTGROUP_JUCEHEADER__
+
+#include "juce_OpenGLContext.h"
+
+
+//==============================================================================
+/**
+    A set of OpenGLContexts which share their GL resources with each other.
+
+    Normally each OpenGLContext compiles its own shader programs and uploads its own
+    copy of every image that it draws, so an app with several GL windows does all of
+    that work once per window. If you give the contexts the same group with
+    OpenGLContext::setContextGroup() before attaching them, they'll be created as native
+    share-contexts of each other, and the shader programs and image textures that are
+    used for component painting will only be created once for the whole group.
+
+    You can also share your own textures, buffers and shader programs between the
+    contexts by storing them with OpenGLContext::setSharedObject(), and can add
+    ResourceLoader objects to the group to create them up-front, as soon as the first
+    context in the group starts up, rather than when each context first needs them.
+
+    Because the shared objects can be used by any of the contexts' render threads, the
+    contexts in a group take turns to draw their frames - only the waiting for their
+    buffers to be swapped can overlap.
+
+    Frame buffers can't be shared between GL contexts, so don't put any OpenGLFrameBuffer
+    or OpenGLImageType objects into the shared storage. On Windows, all the contexts in a
+    group must also have been given the same OpenGLPixelFormat.
+
+    A context that can't be created as a share-context of the others (e.g. on Android, or
+    if it was attached while the only other context in the group was shutting down) will
+    quietly fall back to using its own resources.
+
+    @see OpenGLContext::setContextGroup, OpenGLContext::setSharedObject
+*/
+class JUCE_API  OpenGLContextGroup  : public ReferenceCountedObject
+{
+public:
+    //==============================================================================
+    /** Creates an empty group. */
+    OpenGLContextGroup();
+
+    /** Destructor. */
+    ~OpenGLContextGroup();
+
+    /** A pointer to a group. */
+    typedef ReferenceCountedObjectPtr<OpenGLContextGroup> Ptr;
+
+    //==============================================================================
+    /**
+        Creates some GL resources that the contexts in a group will share.
+        @see OpenGLContextGroup::addResourceLoader
+    */
+    class JUCE_API  ResourceLoader
+    {
+    public:
+        /** Destructor. */
+        virtual ~ResourceLoader() {}
+
+        /** Called to create the resources.
+
+            This is called on the render thread of one of the contexts in the group, while
+            the context is active, and should store the objects that it creates using
+            OpenGLContext::setSharedObject().
+        */
+        virtual void loadSharedResources (OpenGLContext& context) = 0;
+    };
+
+    /** Adds an object that will create some of the group's shared resources.
+
+        The loader will be called as soon as the first context in the group has started,
+        or at the start of the next frame if one is already running. If all the contexts in
+        the group are closed, the shared resources are deleted, and the loaders will be
+        called again when another context starts.
+
+        The group takes ownership of the object that you pass in.
+    */
+    void addResourceLoader (ResourceLoader* loaderToAdd);
+
+    /** Returns the number of contexts that are currently running and sharing the
+        group's resources.
+    */
+    int getNumSharingContexts() const;
+
+private:
+    //==============================================================================
+    friend class OpenGLContext;
+
+    CriticalSection lock;
+    Array<void*> nativeContexts;
+    StringArray objectNames;
+    ReferenceCountedArray<ReferenceCountedObject> objects;
+    OwnedArray<ResourceLoader> loaders;
+    int numLoadersRun, generation;
+
+    // This context is never attached to anything - it's just a long-lived owner for the
+    // extension functions that any shared shader programs need to use.
+    OpenGLContext resourceContext;
+
+    void* getNativeContextToShareWith (int& currentGeneration) const;
+    bool addContext (OpenGLContext&, void* nativeContextSharedWith, int generationWhenCreated);
+    void removeContext (OpenGLContext&);
+    void runPendingLoaders (OpenGLContext&);
+    ReferenceCountedObject* getObject (const char* name) const;
+    void setObject (const char* name, ReferenceCountedObject*);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OpenGLContextGroup)
+};
+
+
+#endif   // __JUCE_OPENGLCONTEXTGROUP_JUCEHEADER__
@@ -171,6 +171,22 @@ public:
 
     typedef ReferenceCountedObjectPtr<ShaderPrograms> Ptr;
 
+    // Finds or compiles the programs for a context. These are shared by all the
+    // contexts in its OpenGLContextGroup, if it has one.
+    static ShaderPrograms* getFor (OpenGLContext& context)
+    {
+        const char programValueID[] = "GraphicsContextPrograms";
+        ShaderPrograms* programs = static_cast <ShaderPrograms*> (context.getSharedObject (programValueID));
+
+        if (programs == nullptr)
+        {
+            programs = new ShaderPrograms (context.getContextForSharedObjects());
+            context.setSharedObject (programValueID, programs);
+        }
+
+        return programs;
+    }
+
     //==============================================================================
     struct ShaderProgramHolder
     {
@@ -819,6 +835,17 @@ struct StateHelpers
             }
         }
 
+        template <class QuadQueueType>
+        void bindTexture (QuadQueueType& quadQueue, const GLuint textureID) noexcept
+        {
+            jassert (currentActiveTexture >= 0);
+
+            if (currentTextureID [currentActiveTexture] != textureID)
+                quadQueue.flush();
+
+            bindTexture (textureID);
+        }
+
         void bindTexture (const GLuint textureID) noexcept
         {
             jassert (currentActiveTexture >= 0);
@@ -915,13 +942,14 @@ struct StateHelpers
     //==============================================================================
     struct ShaderQuadQueue
     {
-        ShaderQuadQueue (const OpenGLContext& c) noexcept
-            : context (c), numVertices (0)
+        ShaderQuadQueue (const OpenGLContext& c, OpenGLRenderingStatistics& stats_) noexcept
+            : context (c), stats (stats_), numVertices (0)
         {}
 
         ~ShaderQuadQueue() noexcept
         {
             static_jassert (sizeof (VertexInfo) == 8);
+            static_jassert (numQuads * 4 <= 65536); // the indices are GLushorts
             context.extensions.glBindBuffer (GL_ARRAY_BUFFER, 0);
             context.extensions.glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, 0);
             context.extensions.glDeleteBuffers (2, buffers);
@@ -930,6 +958,8 @@ struct StateHelpers
         void initialise() noexcept
         {
             JUCE_CHECK_OPENGL_ERROR
+            HeapBlock<GLushort> indexData ((size_t) numQuads * 6);
+
             for (int i = 0, v = 0; i < numQuads * 6; i += 6, v += 4)
             {
                 indexData[i] = (GLushort) v;
@@ -940,7 +970,7 @@ struct StateHelpers
 
             context.extensions.glGenBuffers (2, buffers);
             context.extensions.glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, buffers[0]);
-            context.extensions.glBufferData (GL_ELEMENT_ARRAY_BUFFER, sizeof (indexData), indexData, GL_STATIC_DRAW);
+            context.extensions.glBufferData (GL_ELEMENT_ARRAY_BUFFER, numQuads * 6 * sizeof (GLushort), indexData, GL_STATIC_DRAW);
             context.extensions.glBindBuffer (GL_ARRAY_BUFFER, buffers[1]);
             context.extensions.glBufferData (GL_ARRAY_BUFFER, sizeof (vertexData), vertexData, GL_STREAM_DRAW);
             JUCE_CHECK_OPENGL_ERROR
@@ -1005,7 +1035,15 @@ struct StateHelpers
         void flush() noexcept
         {
             if (numVertices > 0)
+            {
+                ++stats.numFlushes;
                 draw();
+            }
+        }
+
+        void bindVertexBuffer() const noexcept
+        {
+            context.extensions.glBindBuffer (GL_ARRAY_BUFFER, buffers[1]);
         }
 
     private:
@@ -1015,20 +1053,22 @@ struct StateHelpers
             GLuint colour;
         };
 
-       #if JUCE_MAC || JUCE_ANDROID || JUCE_IOS
-        enum { numQuads = 256 };
-       #else
-        enum { numQuads = 64 }; // (had problems with my drivers segfaulting when these buffers are any larger)
-       #endif
+        enum { numQuads = 1024 };
 
         GLuint buffers[2];
         VertexInfo vertexData [numQuads * 4];
-        GLushort indexData [numQuads * 6];
         const OpenGLContext& context;
+        OpenGLRenderingStatistics& stats;
         int numVertices;
 
         void draw() noexcept
         {
+            ++stats.numDrawCalls;
+            stats.numQuads += numVertices / 4;
+
+            // Orphaning the old storage before refilling it means that the driver can hand us a
+            // fresh block rather than stalling until the GPU has finished with the previous batch.
+            context.extensions.glBufferData (GL_ARRAY_BUFFER, sizeof (vertexData), nullptr, GL_STREAM_DRAW);
             context.extensions.glBufferSubData (GL_ARRAY_BUFFER, 0, numVertices * sizeof (VertexInfo), vertexData);
             // NB: If you get a random crash in here and are running in a Parallels VM, it seems to be a bug in
             // their driver.. Can't find a workaround unfortunately.
@@ -1044,16 +1084,9 @@ struct StateHelpers
     struct CurrentShader
     {
         CurrentShader (OpenGLContext& c) noexcept
-            : context (c), activeShader (nullptr)
+            : context (c), programs (ShaderPrograms::getFor (c)),
+              activeShader (nullptr)
         {
-            const char programValueID[] = "GraphicsContextPrograms";
-            programs = static_cast <ShaderPrograms*> (context.getAssociatedObject (programValueID));
-
-            if (programs == nullptr)
-            {
-                programs = new ShaderPrograms (context);
-                context.setAssociatedObject (programValueID, programs);
-            }
         }
 
         void setShader (const Rectangle<int>& bounds, ShaderQuadQueue& quadQueue, ShaderPrograms::ShaderBase& shader)
@@ -1072,6 +1105,7 @@ struct StateHelpers
             }
             else if (bounds != currentBounds)
             {
+                quadQueue.flush();
                 currentBounds = bounds;
                 shader.set2DBounds (bounds.toFloat());
             }
@@ -1112,8 +1146,10 @@ public:
         : target (t),
           activeTextures (t.context),
           currentShader (t.context),
-          shaderQuadQueue (t.context),
-          previousFrameBufferTarget (OpenGLFrameBuffer::getCurrentFrameBufferTarget())
+          shaderQuadQueue (t.context, getOpenGLRenderingStatistics (t.context)),
+          previousFrameBufferTarget (OpenGLFrameBuffer::getCurrentFrameBufferTarget()),
+          statistics (getOpenGLRenderingStatistics (t.context)),
+          stencilCheckedTarget (0), hasCheckedStencil (false), canUseStencil (false)
     {
         // This object can only be created and used when the current thread has an active OpenGL context.
         jassert (OpenGLHelpers::isContextActive());
@@ -1150,7 +1186,7 @@ public:
                                    const int maskTextureID, const Rectangle<int>* const maskArea)
     {
         JUCE_CHECK_OPENGL_ERROR
-        activeTextures.disableTextures (shaderQuadQueue);
+        shaderQuadQueue.flush(); // the gradient texture and uniforms are about to be replaced
         blendMode.setPremultipliedBlendingMode (shaderQuadQueue);
         JUCE_CHECK_OPENGL_ERROR
 
@@ -1296,6 +1332,129 @@ public:
             maskParams->setBounds (*maskArea, target, 1);
     }
 
+    //==============================================================================
+    bool canFillPathsUsingStencil()
+    {
+        if (stencilCheckedTarget != target.frameBufferID || ! hasCheckedStencil)
+        {
+            stencilCheckedTarget = target.frameBufferID;
+            hasCheckedStencil = true;
+
+            GLint stencilBits = 0, sampleBuffers = 0;
+            glGetIntegerv (GL_STENCIL_BITS, &stencilBits);
+            glGetIntegerv (GL_SAMPLE_BUFFERS, &sampleBuffers);
+            clearGLError();
+
+            // Without multisampling, the edges of a stencilled path would be aliased, so
+            // in that case it's better to stick to EdgeTables.
+            canUseStencil = stencilBits >= 8 && sampleBuffers > 0;
+
+            if (canUseStencil)
+            {
+                glStencilMask (0xff);
+                glClearStencil (0);
+                glClear (GL_STENCIL_BUFFER_BIT);
+            }
+        }
+
+        return canUseStencil;
+    }
+
+    // Leaves the path's winding count in the stencil buffer, and sets up the stencil test so
+    // that whatever is drawn next only touches the pixels inside the path, resetting the stencil
+    // values as it goes. Call endStencilledPath() once the covering quads have been added.
+    void writePathToStencil (const Path& path, const AffineTransform& transform, const Rectangle<int>& area)
+    {
+        ShaderPrograms::ShaderBase& shader = currentShader.programs->solidColourProgram;
+        setShader (shader);
+        shaderQuadQueue.flush();
+
+        stencilVertices.clearQuick();
+        PathFlatteningIterator iter (path, transform);
+        GLfloat startX = 0, startY = 0;
+
+        while (iter.next())
+        {
+            if (iter.subPathIndex == 0)
+            {
+                startX = iter.x1;
+                startY = iter.y1;
+            }
+            else
+            {
+                // Each sub-path becomes a fan of triangles around its first point.
+                const GLfloat triangle[] = { startX, startY, iter.x1, iter.y1, iter.x2, iter.y2 };
+                stencilVertices.addArray (triangle, numElementsInArray (triangle));
+            }
+        }
+
+        glEnable (GL_SCISSOR_TEST);
+        glScissor (area.getX() - target.bounds.getX(), target.bounds.getBottom() - area.getBottom(),
+                   area.getWidth(), area.getHeight());
+        glEnable (GL_STENCIL_TEST);
+        glColorMask (GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glStencilMask (0xff);
+        glStencilFunc (GL_ALWAYS, 0, 0xff);
+
+        OpenGLContext& context = target.context;
+        const GLsizei numVertices = (GLsizei) stencilVertices.size() / 2;
+
+        context.extensions.glBindBuffer (GL_ARRAY_BUFFER, 0);
+        context.extensions.glDisableVertexAttribArray (shader.colourAttribute.attributeID);
+        context.extensions.glVertexAttribPointer (shader.positionAttribute.attributeID, 2, GL_FLOAT, GL_FALSE, 0,
+                                                  stencilVertices.getRawDataPointer());
+
+        if (path.isUsingNonZeroWinding())
+        {
+            // Counting the clockwise and anticlockwise triangles in separate passes
+            // gives the winding number of each pixel.
+            glEnable (GL_CULL_FACE);
+            glCullFace (GL_BACK);
+            glStencilOp (GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+            glDrawArrays (GL_TRIANGLES, 0, numVertices);
+            glCullFace (GL_FRONT);
+            glStencilOp (GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+            glDrawArrays (GL_TRIANGLES, 0, numVertices);
+            glDisable (GL_CULL_FACE);
+            statistics.numDrawCalls += 2;
+        }
+        else
+        {
+            glStencilOp (GL_KEEP, GL_KEEP, GL_INVERT);
+            glDrawArrays (GL_TRIANGLES, 0, numVertices);
+            ++statistics.numDrawCalls;
+        }
+
+        ++statistics.numStencilledPaths;
+
+        shaderQuadQueue.bindVertexBuffer();
+        shader.bindAttributes (context);
+        glColorMask (GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+        glStencilFunc (GL_NOTEQUAL, 0, 0xff);
+        glStencilOp (GL_ZERO, GL_ZERO, GL_ZERO);
+        JUCE_CHECK_OPENGL_ERROR
+    }
+
+    void endStencilledPath (const Rectangle<int>& area, const bool coverDidNotFillArea)
+    {
+        shaderQuadQueue.flush();
+
+        if (coverDidNotFillArea)
+        {
+            // Any parts of the area that weren't covered still need their stencil values clearing.
+            glColorMask (GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            glStencilFunc (GL_ALWAYS, 0, 0xff);
+            shaderQuadQueue.add (area, PixelARGB (0));
+            shaderQuadQueue.flush();
+            glColorMask (GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        }
+
+        glDisable (GL_STENCIL_TEST);
+        glDisable (GL_SCISSOR_TEST);
+        JUCE_CHECK_OPENGL_ERROR
+    }
+
     Target target;
 
     StateHelpers::BlendingMode blendMode;
@@ -1306,6 +1465,10 @@ public:
 
 private:
     GLuint previousFrameBufferTarget;
+    OpenGLRenderingStatistics& statistics;
+    Array<GLfloat> stencilVertices;
+    GLuint stencilCheckedTarget;
+    bool hasCheckedStencil, canUseStencil;
 };
 
 //==============================================================================
@@ -1331,6 +1494,8 @@ public:
     virtual void drawImage (const Image&, const AffineTransform&, float alpha,
                             const Rectangle<int>& clip, EdgeTable* mask) = 0;
 
+    virtual bool fillPathUsingStencil (const Path&, const AffineTransform&, const FillType&)     { return false; }
+
     GLState& state;
 
     JUCE_DECLARE_NON_COPYABLE (ClipRegionBase)
@@ -1389,6 +1554,11 @@ public:
         state.shaderQuadQueue.flush();
     }
 
+    ~ClipRegion_Mask()
+    {
+        state.shaderQuadQueue.flush();
+    }
+
     Ptr clone() const                       { return new ClipRegion_Mask (*this); }
     Rectangle<int> getClipBounds() const    { return clip; }
 
@@ -1563,15 +1733,15 @@ private:
     struct ShaderFillOperation
     {
         ShaderFillOperation (const ClipRegion_Mask& clipMask, const FillType& fill, const bool clampTiledImages)
-            : state (clipMask.state)
+            : state (clipMask.state), isColour (fill.isColour())
         {
             const GLuint maskTextureID = clipMask.mask.getTextureID();
 
-            if (fill.isColour())
+            if (isColour)
             {
                 state.blendMode.setPremultipliedBlendingMode (state.shaderQuadQueue);
                 state.activeTextures.setSingleTextureMode (state.shaderQuadQueue);
-                state.activeTextures.bindTexture (maskTextureID);
+                state.activeTextures.bindTexture (state.shaderQuadQueue, maskTextureID);
 
                 state.setShader (state.currentShader.programs->solidColourMasked);
                 state.currentShader.programs->solidColourMasked.maskParams.setBounds (clipMask.maskArea, state.target, 0);
@@ -1583,6 +1753,7 @@ private:
             else
             {
                 jassert (fill.isTiledImage());
+                state.shaderQuadQueue.flush();
                 image = new OpenGLTextureFromImage (fill.image);
                 state.setShaderForTiledImageFill (*image, fill.transform, maskTextureID, &clipMask.maskArea, clampTiledImages);
             }
@@ -1590,11 +1761,15 @@ private:
 
         ~ShaderFillOperation()
         {
-            state.shaderQuadQueue.flush();
+            // Solid colour fills can stay queued and be drawn in the same batch as any
+            // following ones that use this mask.
+            if (! isColour)
+                state.shaderQuadQueue.flush();
         }
 
         GLState& state;
         ScopedPointer<OpenGLTextureFromImage> image;
+        const bool isColour;
 
         JUCE_DECLARE_NON_COPYABLE (ShaderFillOperation)
     };
@@ -1705,6 +1880,23 @@ public:
         }
     }
 
+    bool fillPathUsingStencil (const Path& path, const AffineTransform& transform, const FillType& fill)
+    {
+        const Rectangle<int> area (path.getBoundsTransformed (transform).getSmallestIntegerContainer()
+                                       .getIntersection (clip.getBounds()));
+
+        // Small paths are quicker to rasterise on the CPU and then batch up with everything else.
+        if (area.getWidth() * area.getHeight() < minimumStencilledPathArea)
+            return false;
+
+        state.writePathToStencil (path, transform, area);
+
+        ShaderFillOperation fillOp (*this, fill, false, true);
+        state.shaderQuadQueue.add (clip, area, fill.colour.getPixelARGB());
+        state.endStencilledPath (area, clip.getNumRectangles() > 1);
+        return true;
+    }
+
     Rectangle<int> getClipBounds() const                { return clip.getBounds(); }
     Ptr clipToRectangle (const Rectangle<int>& r)       { return clip.clipTo (r) ? this : nullptr; }
     Ptr clipToRectangleList (const RectangleList& r)    { return clip.clipTo (r) ? this : nullptr; }
@@ -1713,6 +1905,8 @@ public:
 private:
     RectangleList clip;
 
+    enum { minimumStencilledPathArea = 64 * 64 };
+
     Ptr toMask() const    { return new ClipRegion_Mask (state, clip); }
 
     struct ShaderFillOperation
@@ -1977,7 +2171,13 @@ public:
     {
         if (clip != nullptr)
         {
-            EdgeTable et (clip->getClipBounds(), path, transform.getTransformWith (t));
+            const AffineTransform trans (transform.getTransformWith (t));
+
+            if (state->canFillPathsUsingStencil()
+                 && clip->fillPathUsingStencil (path, trans, getFillType()))
+                return;
+
+            EdgeTable et (clip->getClipBounds(), path, trans);
             fillEdgeTable (et);
         }
     }
@@ -2214,6 +2414,25 @@ LowLevelGraphicsContext* createOpenGLContext (const Target& target)
 }
 
 //==============================================================================
+OpenGLRenderingStatistics& getOpenGLRenderingStatistics (OpenGLContext& context)
+{
+    struct StatisticsHolder  : public ReferenceCountedObject
+    {
+        OpenGLRenderingStatistics statistics;
+    };
+
+    const char statisticsValueID[] = "GraphicsContextStatistics";
+    StatisticsHolder* holder = static_cast <StatisticsHolder*> (context.getAssociatedObject (statisticsValueID));
+
+    if (holder == nullptr)
+    {
+        holder = new StatisticsHolder();
+        context.setAssociatedObject (statisticsValueID, holder);
+    }
+
+    return holder->statistics;
+}
+
 LowLevelGraphicsContext* createOpenGLGraphicsContext (OpenGLContext& context, int width, int height)
 {
     return createOpenGLGraphicsContext (context, context.getFrameBufferID(), width, height);
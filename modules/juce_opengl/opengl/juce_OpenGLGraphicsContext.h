@@ -29,6 +29,10 @@
 
 /** Creates a graphics context object that will render into the given OpenGL target.
     The caller is responsible for deleting this object when no longer needed.
+
+    If the context's pixel format has a stencil buffer and multisampling enabled (see
+    OpenGLPixelFormat), large paths will be filled on the GPU using the stencil buffer,
+    rather than being flattened into an EdgeTable on the CPU.
 */
 LowLevelGraphicsContext* createOpenGLGraphicsContext (OpenGLContext& target,
                                                       int width, int height);
@@ -46,5 +50,34 @@ LowLevelGraphicsContext* createOpenGLGraphicsContext (OpenGLContext& context,
                                                       unsigned int frameBufferID,
                                                       int width, int height);
 
+//==============================================================================
+/** Counters that the OpenGL graphics contexts update as they render, for use when profiling.
+
+    The shader-based renderer queues up the quads for consecutive drawing operations and only
+    sends them to the GPU when its vertex buffer fills up, or when it has to change the shader,
+    blending mode or textures. These values let you see how well that batching is working.
+
+    @see getOpenGLRenderingStatistics
+*/
+struct OpenGLRenderingStatistics
+{
+    OpenGLRenderingStatistics() noexcept    { reset(); }
+
+    /** Sets all the counters back to zero. */
+    void reset() noexcept                   { numDrawCalls = numFlushes = numQuads = numStencilledPaths = 0; }
+
+    int numDrawCalls;       /**< The number of batches that have been drawn. */
+    int numFlushes;         /**< The number of batches that were drawn early because of a state change. */
+    int numQuads;           /**< The total number of quads that have been drawn. */
+    int numStencilledPaths; /**< The number of paths that were filled using the stencil buffer rather than an EdgeTable. */
+};
+
+/** Returns the rendering statistics for all the graphics contexts that draw into the given
+    OpenGL context.
+    This must only be called from within the GL rendering methods, and the counters keep
+    accumulating until you call OpenGLRenderingStatistics::reset() on the object returned.
+*/
+OpenGLRenderingStatistics& getOpenGLRenderingStatistics (OpenGLContext& context);
+
 
 #endif   // __JUCE_OPENGLGRAPHICSCONTEXT_JUCEHEADER__
@@ -255,6 +255,131 @@ void OpenGLHelpers::fillRect (const Rectangle<int>& rect)
 }
 #endif
 
+//==============================================================================
+/*  Keeps the textures for recently-drawn images alive between frames, so that they only
+    need to be uploaded again when an image's pixels have actually changed. Textures that
+    get evicted are kept in a small pool and reused for other images of the same size.
+*/
+class ImageTextureCache  : public ReferenceCountedObject
+{
+public:
+    ImageTextureCache() noexcept : totalBytes (0) {}
+
+    static ImageTextureCache& getFor (OpenGLContext& context)
+    {
+        const char cacheValueID[] = "ImageTextureCache";
+        ImageTextureCache* cache = static_cast <ImageTextureCache*> (context.getSharedObject (cacheValueID));
+
+        if (cache == nullptr)
+        {
+            cache = new ImageTextureCache();
+            context.setSharedObject (cacheValueID, cache);
+        }
+
+        return *cache;
+    }
+
+    static bool isWorthCaching (const Image& image) noexcept
+    {
+        return getTextureSizeInBytes (image.getWidth(), image.getHeight()) <= maxCacheSizeInBytes / 4;
+    }
+
+    const OpenGLTexture& getTexture (const Image& image)
+    {
+        ImagePixelData* const pixelData = image.getPixelData();
+        const int changeCount = pixelData->getChangeCount();
+
+        for (int i = entries.size(); --i >= 0;)
+        {
+            CachedTexture* const entry = entries.getUnchecked (i);
+
+            if (entry->pixelData == pixelData)
+            {
+                if (entry->changeCount != changeCount)
+                {
+                    entry->changeCount = changeCount;
+                    entry->texture->loadImage (image);
+                }
+
+                entries.move (i, -1); // the most-recently used entries are kept at the end
+                return *entry->texture;
+            }
+        }
+
+        removeUnusedEntries();
+
+        CachedTexture* const entry = new CachedTexture();
+        entry->pixelData = pixelData;
+        entry->changeCount = changeCount;
+        entry->texture = findSpareTexture (image.getWidth(), image.getHeight());
+        entry->texture->loadImage (image);
+        totalBytes += getTextureSizeInBytes (image.getWidth(), image.getHeight());
+        entries.add (entry);
+
+        while (totalBytes > maxCacheSizeInBytes && entries.size() > 1)
+            removeEntry (0);
+
+        return *entry->texture;
+    }
+
+private:
+    struct CachedTexture
+    {
+        ImagePixelData::Ptr pixelData;
+        int changeCount;
+        ScopedPointer<OpenGLTexture> texture;
+    };
+
+    enum { maxCacheSizeInBytes = 64 * 1024 * 1024, maxSpareTextures = 16 };
+
+    OwnedArray<CachedTexture> entries;
+    OwnedArray<OpenGLTexture> spareTextures;
+    size_t totalBytes;
+
+    static size_t getTextureSizeInBytes (int w, int h) noexcept
+    {
+        return (size_t) nextPowerOfTwo (w) * (size_t) nextPowerOfTwo (h) * 4;
+    }
+
+    OpenGLTexture* findSpareTexture (int w, int h)
+    {
+        w = nextPowerOfTwo (w);
+        h = nextPowerOfTwo (h);
+
+        for (int i = spareTextures.size(); --i >= 0;)
+        {
+            const OpenGLTexture* const t = spareTextures.getUnchecked (i);
+
+            if (t->getWidth() == w && t->getHeight() == h)
+                return spareTextures.removeAndReturn (i);
+        }
+
+        return new OpenGLTexture();
+    }
+
+    void removeEntry (const int index)
+    {
+        CachedTexture* const entry = entries.getUnchecked (index);
+        totalBytes -= getTextureSizeInBytes (entry->pixelData->width, entry->pixelData->height);
+
+        if (spareTextures.size() >= maxSpareTextures)
+            spareTextures.remove (0);
+
+        spareTextures.add (entry->texture.release());
+        entries.remove (index);
+    }
+
+    // Drops the entries for any images that nobody else is holding onto any more.
+    void removeUnusedEntries()
+    {
+        for (int i = entries.size(); --i >= 0;)
+            if (entries.getUnchecked (i)->pixelData->getReferenceCount() == 1)
+                removeEntry (i);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ImageTextureCache)
+};
+
 //==============================================================================
 OpenGLTextureFromImage::OpenGLTextureFromImage (const Image& image)
     : imageWidth (image.getWidth()),
@@ -269,12 +394,23 @@ OpenGLTextureFromImage::OpenGLTextureFromImage (const Image& image)
     }
     else
     {
-        texture = new OpenGLTexture();
-        texture->loadImage (image);
-        textureID = texture->getTextureID();
-
-        fullWidthProportion  = imageWidth  / (float) texture->getWidth();
-        fullHeightProportion = imageHeight / (float) texture->getHeight();
+        OpenGLContext* const context = OpenGLContext::getCurrentContext();
+        const OpenGLTexture* t;
+
+        if (context != nullptr && ImageTextureCache::isWorthCaching (image))
+        {
+            t = &ImageTextureCache::getFor (*context).getTexture (image);
+        }
+        else
+        {
+            texture = new OpenGLTexture();
+            texture->loadImage (image);
+            t = texture;
+        }
+
+        textureID = t->getTextureID();
+        fullWidthProportion  = imageWidth  / (float) t->getWidth();
+        fullHeightProportion = imageHeight / (float) t->getHeight();
     }
 
     JUCE_CHECK_OPENGL_ERROR
@@ -107,7 +107,9 @@ public:
     from an image in the quickest way possible.
 
     If the image is backed by an OpenGL framebuffer, it will use that directly; otherwise,
-    this object will create a temporary texture or framebuffer and copy the image.
+    the image is copied into a texture. The current context keeps these textures in a cache
+    between frames, and only uploads the image again when its pixels have been changed (see
+    ImagePixelData::getChangeCount()), or creates a temporary texture for very large images.
 */
 class JUCE_API  OpenGLTextureFromImage
 {
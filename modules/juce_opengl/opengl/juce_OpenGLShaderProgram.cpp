@@ -25,6 +25,172 @@
 
 #if JUCE_USE_OPENGL_SHADERS
 
+//==============================================================================
+/*  Saves and loads linked programs with glGetProgramBinary/glProgramBinary, which aren't
+    part of the core functions that a context requires, so are loaded only if they're needed.
+*/
+class ProgramBinaryCache
+{
+public:
+    ProgramBinaryCache()
+        : directory (OpenGLShaderProgram::getBinaryCacheDirectory()),
+          getProgramBinary (nullptr), programBinary (nullptr), programParameteri (nullptr)
+    {
+        if (directory == File::nonexistent)
+            return;
+
+       #if JUCE_OPENGL_ES
+        if (OpenGLHelpers::isExtensionSupported ("GL_OES_get_program_binary"))
+        {
+            getProgramBinary = (GetProgramBinaryFunction) OpenGLHelpers::getExtensionFunction ("glGetProgramBinaryOES");
+            programBinary    = (ProgramBinaryFunction)    OpenGLHelpers::getExtensionFunction ("glProgramBinaryOES");
+        }
+       #else
+        if (OpenGLHelpers::isExtensionSupported ("GL_ARB_get_program_binary"))
+        {
+            getProgramBinary  = (GetProgramBinaryFunction)  OpenGLHelpers::getExtensionFunction ("glGetProgramBinary");
+            programBinary     = (ProgramBinaryFunction)     OpenGLHelpers::getExtensionFunction ("glProgramBinary");
+            programParameteri = (ProgramParameteriFunction) OpenGLHelpers::getExtensionFunction ("glProgramParameteri");
+        }
+       #endif
+
+        GLint numBinaryFormats = 0;
+
+        if (isAvailable())
+            glGetIntegerv (GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+
+        // Some drivers have the functions but can't actually produce any binaries..
+        if (numBinaryFormats <= 0)
+            getProgramBinary = nullptr;
+
+        clearGLError();
+    }
+
+    bool isAvailable() const noexcept       { return getProgramBinary != nullptr && programBinary != nullptr; }
+
+    // The binaries are only valid for the driver that created them, so the key includes
+    // its version as well as the shader code.
+    static String createKey (const StringArray& sources, const Array<GLenum>& types)
+    {
+        String key;
+        key << (const char*) glGetString (GL_VENDOR) << '\n'
+            << (const char*) glGetString (GL_RENDERER) << '\n'
+            << (const char*) glGetString (GL_VERSION) << '\n';
+
+        for (int i = 0; i < sources.size(); ++i)
+            key << (int) types.getUnchecked (i) << '\n' << sources[i] << '\n';
+
+        return key;
+    }
+
+    bool load (const OpenGLContext& context, const GLuint programID, const String& key) const
+    {
+        MemoryBlock data;
+
+        if (! getFileFor (key).loadFileAsData (data))
+            return false;
+
+        MemoryInputStream in (data, false);
+
+        if (in.readInt() != fileMagicNumber || in.readString() != key)
+            return false;
+
+        const GLenum binaryFormat = (GLenum) in.readInt();
+        const int binarySize = in.readInt();
+
+        if (binarySize <= 0 || binarySize != in.getNumBytesRemaining())
+            return false;
+
+        programBinary (programID, binaryFormat, static_cast <const char*> (data.getData()) + in.getPosition(), binarySize);
+
+        // (if the driver has been updated, it may refuse an old binary)
+        GLint status = GL_FALSE;
+        context.extensions.glGetProgramiv (programID, GL_LINK_STATUS, &status);
+        clearGLError();
+        return status != GL_FALSE;
+    }
+
+    void prepareToLink (const GLuint programID) const
+    {
+        if (programParameteri != nullptr)
+            programParameteri (programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    void save (const OpenGLContext& context, const GLuint programID, const String& key) const
+    {
+        GLint binarySize = 0;
+        context.extensions.glGetProgramiv (programID, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+
+        if (binarySize > 0)
+        {
+            HeapBlock<char> binary ((size_t) binarySize);
+            GLsizei length = 0;
+            GLenum binaryFormat = 0;
+            getProgramBinary (programID, binarySize, &length, &binaryFormat, binary);
+
+            if (length > 0 && directory.createDirectory().wasOk())
+            {
+                MemoryOutputStream out;
+                out.writeInt (fileMagicNumber);
+                out.writeString (key);
+                out.writeInt ((int) binaryFormat);
+                out.writeInt (length);
+                out.write (binary, (size_t) length);
+
+                getFileFor (key).replaceWithData (out.getData(), out.getDataSize());
+            }
+        }
+
+        clearGLError();
+    }
+
+private:
+    typedef void (JUCE_GL_CALLTYPE *GetProgramBinaryFunction) (GLuint, GLsizei, GLsizei*, GLenum*, void*);
+    typedef void (JUCE_GL_CALLTYPE *ProgramBinaryFunction) (GLuint, GLenum, const void*, GLsizei);
+    typedef void (JUCE_GL_CALLTYPE *ProgramParameteriFunction) (GLuint, GLenum, GLint);
+
+    enum { fileMagicNumber = 0x62676a6a };
+
+    const File directory;
+    GetProgramBinaryFunction getProgramBinary;
+    ProgramBinaryFunction programBinary;
+    ProgramParameteriFunction programParameteri;
+
+    File getFileFor (const String& key) const
+    {
+        return directory.getChildFile (String::toHexString (key.hashCode64()) + ".glprogram");
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ProgramBinaryCache)
+};
+
+struct ProgramBinaryCacheDirectory
+{
+    CriticalSection lock;
+    File directory;
+
+    static ProgramBinaryCacheDirectory& getInstance()
+    {
+        static ProgramBinaryCacheDirectory instance;
+        return instance;
+    }
+};
+
+void OpenGLShaderProgram::setBinaryCacheDirectory (const File& directory)
+{
+    ProgramBinaryCacheDirectory& d = ProgramBinaryCacheDirectory::getInstance();
+    const ScopedLock sl (d.lock);
+    d.directory = directory;
+}
+
+File OpenGLShaderProgram::getBinaryCacheDirectory()
+{
+    ProgramBinaryCacheDirectory& d = ProgramBinaryCacheDirectory::getInstance();
+    const ScopedLock sl (d.lock);
+    return d.directory;
+}
+
+//==============================================================================
 OpenGLShaderProgram::OpenGLShaderProgram (const OpenGLContext& context_) noexcept
     : context (context_)
 {
@@ -32,6 +198,7 @@ OpenGLShaderProgram::OpenGLShaderProgram (const OpenGLContext& context_) noexcep
     jassert (OpenGLHelpers::isContextActive());
 
     programID = context.extensions.glCreateProgram();
+    usesBinaryCache = ProgramBinaryCache().isAvailable();
 }
 
 OpenGLShaderProgram::~OpenGLShaderProgram() noexcept
@@ -51,6 +218,18 @@ double OpenGLShaderProgram::getLanguageVersion()
 }
 
 bool OpenGLShaderProgram::addShader (const char* const code, GLenum type)
+{
+    if (usesBinaryCache)
+    {
+        pendingShaderSources.add (code);
+        pendingShaderTypes.add (type);
+        return true;
+    }
+
+    return compileShader (code, type);
+}
+
+bool OpenGLShaderProgram::compileShader (const char* const code, GLenum type)
 {
     GLuint shaderID = context.extensions.glCreateShader (type);
     context.extensions.glShaderSource (shaderID, 1, (const GLchar**) &code, nullptr);
@@ -81,6 +260,39 @@ bool OpenGLShaderProgram::addShader (const char* const code, GLenum type)
 }
 
 bool OpenGLShaderProgram::link() noexcept
+{
+    if (pendingShaderSources.size() == 0)
+        return linkProgram();
+
+    const ProgramBinaryCache cache;
+    const String key (ProgramBinaryCache::createKey (pendingShaderSources, pendingShaderTypes));
+    bool ok = cache.isAvailable() && cache.load (context, programID, key);
+
+    if (! ok)
+    {
+        ok = true;
+
+        for (int i = 0; i < pendingShaderSources.size() && ok; ++i)
+            ok = compileShader (pendingShaderSources[i].toUTF8(), pendingShaderTypes.getUnchecked (i));
+
+        if (ok)
+        {
+            if (cache.isAvailable())
+                cache.prepareToLink (programID);
+
+            ok = linkProgram();
+
+            if (ok && cache.isAvailable())
+                cache.save (context, programID, key);
+        }
+    }
+
+    pendingShaderSources.clear();
+    pendingShaderTypes.clear();
+    return ok;
+}
+
+bool OpenGLShaderProgram::linkProgram()
 {
     context.extensions.glLinkProgram (programID);
 
@@ -57,8 +57,13 @@ public:
 
         The shaderType parameter could be GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, etc.
 
+        If a binary cache directory has been set, the shader's source is just stored
+        here, and won't be compiled until link() finds that there's no cached binary
+        for the program.
+
         @returns  true if the shader compiled successfully. If not, you can call
                   getLastError() to find out what happened.
+        @see setBinaryCacheDirectory
     */
     bool addShader (const char* const shaderSourceCode, GLenum shaderType);
 
@@ -73,6 +78,24 @@ public:
     /** Get the output for the last shader compilation or link that failed. */
     const String& getLastError() const noexcept            { return errorLog; }
 
+    //==============================================================================
+    /** Sets a folder in which the binaries of linked programs will be saved, so that
+        later runs of the app can load them instead of compiling their shaders again.
+
+        When a folder has been set and the driver can supply program binaries, link()
+        will look for a binary that was saved for the same shader code by the same driver
+        version, and only compiles the shaders if there isn't one, saving the newly-linked
+        program for next time. Because of this, any compilation errors will be reported
+        by link() rather than addShader().
+
+        Pass File::nonexistent to turn this off, which is the default.
+        This can be called from any thread, and affects programs that are created after it.
+    */
+    static void setBinaryCacheDirectory (const File& directory);
+
+    /** Returns the folder that was set with setBinaryCacheDirectory(). */
+    static File getBinaryCacheDirectory();
+
     /** Selects this program into the current context. */
     void use() const noexcept;
 
@@ -148,6 +171,14 @@ private:
     const OpenGLContext& context;
     String errorLog;
 
+    // When the binary cache is in use, the shaders aren't compiled until link() is called.
+    StringArray pendingShaderSources;
+    Array<GLenum> pendingShaderTypes;
+    bool usesBinaryCache;
+
+    bool compileShader (const char*, GLenum);
+    bool linkProgram();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OpenGLShaderProgram)
 };
 
@@ -40,11 +40,14 @@ bool OpenGLTexture::isValidSize (int width, int height)
 
 void OpenGLTexture::create (const int w, const int h, const void* pixels, GLenum type, bool topLeft)
 {
-    ownerContext = OpenGLContext::getCurrentContext();
+    OpenGLContext* const currentContext = OpenGLContext::getCurrentContext();
 
     // Texture objects can only be created when the current thread has an active OpenGL
     // context. You'll need to create this object in one of the OpenGLContext's callbacks.
-    jassert (ownerContext != nullptr);
+    jassert (currentContext != nullptr);
+
+    // (if the context is in a group, any of the group's contexts may delete the texture)
+    ownerContext = currentContext != nullptr ? &(currentContext->getContextForSharedObjects()) : nullptr;
 
     if (textureID == 0)
     {
@@ -148,8 +151,10 @@ void OpenGLTexture::loadARGBFlipped (const PixelARGB* pixels, int w, int h)
 
 void OpenGLTexture::release()
 {
-    if (textureID != 0
-         && ownerContext == OpenGLContext::getCurrentContext())
+    OpenGLContext* const currentContext = OpenGLContext::getCurrentContext();
+
+    if (textureID != 0 && currentContext != nullptr
+         && ownerContext == &(currentContext->getContextForSharedObjects()))
     {
         glDeleteTextures (1, &textureID);
 
@@ -138,6 +138,43 @@ public:
     */
     void removeListener (Listener* listenerToRemove);
 
+    //==============================================================================
+    /** The frames that a FrameListener receives.
+        @see VideoFrame
+    */
+    typedef VideoFrame Frame;
+
+    //==============================================================================
+    /**
+        Receives the camera's frames without them being converted to Images.
+
+        @see CameraDevice::addFrameListener, VideoFrame
+    */
+    class JUCE_API  FrameListener
+    {
+    public:
+        FrameListener() {}
+        virtual ~FrameListener() {}
+
+        /** This method is called when a new frame arrives.
+
+            It's called on the driver's capture thread, so be careful about thread-safety
+            and return as quickly as possible. If the frame needs any lengthy processing,
+            keep a reference to it and do the work on another thread.
+        */
+        virtual void frameReceived (const Frame::Ptr& frame) = 0;
+    };
+
+    /** Adds a listener to receive the camera's frames in their native format.
+
+        Be very careful not to delete the listener without first removing it by calling
+        removeFrameListener().
+    */
+    void addFrameListener (FrameListener* listenerToAdd);
+
+    /** Removes a listener that was previously added with addFrameListener(). */
+    void removeFrameListener (FrameListener* listenerToRemove);
+
 
 protected:
    #ifndef DOXYGEN
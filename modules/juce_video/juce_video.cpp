@@ -49,6 +49,11 @@
   #undef Component
  #endif
 
+ #if JUCE_VIDEO_FRAME_PLAYER
+  #import <AVFoundation/AVFoundation.h>
+  #import <CoreMedia/CoreMedia.h>
+ #endif
+
 //==============================================================================
 #elif JUCE_WINDOWS
  #if JUCE_QUICKTIME
@@ -98,6 +103,18 @@
  #if JUCE_DIRECTSHOW && JUCE_MSVC && ! JUCE_DONT_AUTOLINK_TO_WIN32_LIBRARIES
   #pragma comment (lib, "strmiids.lib")
  #endif
+
+ #if JUCE_VIDEO_FRAME_PLAYER
+  #include <mfapi.h>
+  #include <mfidl.h>
+  #include <mfreadwrite.h>
+
+  #if JUCE_MSVC && ! JUCE_DONT_AUTOLINK_TO_WIN32_LIBRARIES
+   #pragma comment (lib, "mfplat.lib")
+   #pragma comment (lib, "mfreadwrite.lib")
+   #pragma comment (lib, "mfuuid.lib")
+  #endif
+ #endif
 #endif
 
 //==============================================================================
@@ -106,13 +123,25 @@ using namespace juce;
 namespace juce
 {
 
+#if JUCE_VIDEO_FRAME_PLAYER
+ #include "playback/juce_VideoFramePlayer.cpp"
+#endif
+
 #if JUCE_MAC || JUCE_IOS
  #include "../juce_core/native/juce_osx_ObjCHelpers.h"
 
+ #if JUCE_USE_CAMERA || JUCE_VIDEO_FRAME_PLAYER
+  #include "native/juce_mac_CVPixelBufferFrame.h"
+ #endif
+
  #if JUCE_USE_CAMERA
   #include "native/juce_mac_CameraDevice.mm"
  #endif
 
+ #if JUCE_VIDEO_FRAME_PLAYER
+  #include "native/juce_mac_VideoFramePlayer.mm"
+ #endif
+
  #if JUCE_QUICKTIME
   #include "native/juce_mac_QuickTimeMovieComponent.mm"
  #endif
@@ -128,6 +157,10 @@ namespace juce
   #include "native/juce_win32_DirectShowComponent.cpp"
  #endif
 
+ #if JUCE_VIDEO_FRAME_PLAYER
+  #include "native/juce_win32_VideoFramePlayer.cpp"
+ #endif
+
  #if JUCE_QUICKTIME
   #include "native/juce_win32_QuickTimeMovieComponent.cpp"
  #endif
@@ -44,6 +44,15 @@
  #define JUCE_MEDIAFOUNDATION 0
 #endif
 
+/** Config: JUCE_VIDEO_FRAME_PLAYER
+    Enables the VideoFramePlayer class (Mac and Windows). On Windows this uses Media
+    Foundation, so needs Windows 7 or later. On the Mac it uses AVFoundation, so needs
+    OSX 10.7 or later.
+*/
+#ifndef JUCE_VIDEO_FRAME_PLAYER
+ #define JUCE_VIDEO_FRAME_PLAYER 0
+#endif
+
 #if ! JUCE_WINDOWS
  #undef JUCE_DIRECTSHOW
  #undef JUCE_MEDIAFOUNDATION
@@ -68,6 +77,7 @@
 #if ! (JUCE_MAC || JUCE_WINDOWS)
  #undef JUCE_QUICKTIME
  #undef JUCE_USE_CAMERA
+ #undef JUCE_VIDEO_FRAME_PLAYER
 #endif
 
 //=============================================================================
@@ -81,6 +91,12 @@ namespace juce
 #ifndef __JUCE_QUICKTIMEMOVIECOMPONENT_JUCEHEADER__
  #include "playback/juce_QuickTimeMovieComponent.h"
 #endif
+#ifndef __JUCE_VIDEOFRAME_JUCEHEADER__
+ #include "playback/juce_VideoFrame.h"
+#endif
+#ifndef __JUCE_VIDEOFRAMEPLAYER_JUCEHEADER__
+ #include "playback/juce_VideoFramePlayer.h"
+#endif
 #ifndef __JUCE_CAMERADEVICE_JUCEHEADER__
  #include "capture/juce_CameraDevice.h"
 #endif
@@ -93,6 +93,16 @@ void CameraDevice::removeListener (Listener* listenerToRemove)
     // TODO
 }
 
+void CameraDevice::addFrameListener (FrameListener* listenerToAdd)
+{
+    // TODO
+}
+
+void CameraDevice::removeFrameListener (FrameListener* listenerToRemove)
+{
+    // TODO
+}
+
 StringArray CameraDevice::getAvailableDevices()
 {
     StringArray devs;
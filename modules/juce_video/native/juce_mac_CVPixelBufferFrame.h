@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_MAC_CVPIXELBUFFERFRAME_JUCEHEADER__
+#define __JUCE_MAC_CVPIXELBUFFERFRAME_JUCEHEADER__
+
+//==============================================================================
+// Keeps a pixel buffer locked and retained until the last reference to the frame has gone.
+class CVPixelBufferFrame  : public VideoFrame
+{
+public:
+    CVPixelBufferFrame (CVPixelBufferRef buffer, const double time)
+        : VideoFrame ((int) CVPixelBufferGetWidth (buffer), (int) CVPixelBufferGetHeight (buffer),
+                      getPixelFormatOf (buffer), time),
+          pixelBuffer (CVPixelBufferRetain (buffer))
+    {
+        CVPixelBufferLockBaseAddress (pixelBuffer, 0);
+
+        if (CVPixelBufferIsPlanar (pixelBuffer))
+        {
+            numPlanes = jmin (2, (int) CVPixelBufferGetPlaneCount (pixelBuffer));
+
+            for (int i = 0; i < numPlanes; ++i)
+            {
+                planeData[i]   = (const uint8*) CVPixelBufferGetBaseAddressOfPlane (pixelBuffer, (size_t) i);
+                lineStrides[i] = (int) CVPixelBufferGetBytesPerRowOfPlane (pixelBuffer, (size_t) i);
+            }
+        }
+        else
+        {
+            numPlanes = 1;
+            planeData[0]   = (const uint8*) CVPixelBufferGetBaseAddress (pixelBuffer);
+            lineStrides[0] = (int) CVPixelBufferGetBytesPerRow (pixelBuffer);
+        }
+    }
+
+    ~CVPixelBufferFrame()
+    {
+        CVPixelBufferUnlockBaseAddress (pixelBuffer, 0);
+        CVPixelBufferRelease (pixelBuffer);
+    }
+
+    void* getNativeHandle() const noexcept      { return pixelBuffer; }
+
+private:
+    CVPixelBufferRef pixelBuffer;
+
+    static PixelFormat getPixelFormatOf (CVPixelBufferRef buffer)
+    {
+        switch (CVPixelBufferGetPixelFormatType (buffer))
+        {
+            case 'BGRA':    return bgra32;
+            case '2vuy':    return uyvy422;
+            case 'yuvs':    return yuyv422;
+            case '420v':
+            case '420f':    return nv12;
+            default:        break;
+        }
+
+        return unknownFormat;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (CVPixelBufferFrame)
+};
+
+#endif   // __JUCE_MAC_CVPIXELBUFFERFRAME_JUCEHEADER__
@@ -72,6 +72,11 @@ public:
                     imageOutput = [[QTCaptureDecompressedVideoOutput alloc] init];
                     [imageOutput setDelegate: callbackDelegate];
 
+                    // Ask for the 4:2:2 YUV that most cameras produce, so that the frames don't
+                    // need converting before they're delivered.
+                    [imageOutput setPixelBufferAttributes: [NSDictionary dictionaryWithObject: [NSNumber numberWithUnsignedInt: '2vuy']
+                                                                                      forKey: (id) kCVPixelBufferPixelFormatTypeKey]];
+
                     if (err == nil)
                     {
                         [session startRunning];
@@ -137,7 +142,7 @@ public:
     {
         const ScopedLock sl (listenerLock);
 
-        if (listeners.size() == 0)
+        if (listeners.size() + frameListeners.size() == 0)
             [session addOutput: imageOutput error: nil];
 
         listeners.addIfNotAlreadyThere (listenerToAdd);
@@ -148,10 +153,38 @@ public:
         const ScopedLock sl (listenerLock);
         listeners.removeFirstMatchingValue (listenerToRemove);
 
-        if (listeners.size() == 0)
+        if (listeners.size() + frameListeners.size() == 0)
+            [session removeOutput: imageOutput];
+    }
+
+    void addFrameListener (CameraDevice::FrameListener* listenerToAdd)
+    {
+        const ScopedLock sl (listenerLock);
+
+        if (listeners.size() + frameListeners.size() == 0)
+            [session addOutput: imageOutput error: nil];
+
+        frameListeners.addIfNotAlreadyThere (listenerToAdd);
+    }
+
+    void removeFrameListener (CameraDevice::FrameListener* listenerToRemove)
+    {
+        const ScopedLock sl (listenerLock);
+        frameListeners.removeFirstMatchingValue (listenerToRemove);
+
+        if (listeners.size() + frameListeners.size() == 0)
             [session removeOutput: imageOutput];
     }
 
+    void callFrameListeners (const CameraDevice::Frame::Ptr& frame)
+    {
+        const ScopedLock sl (listenerLock);
+
+        for (int i = frameListeners.size(); --i >= 0;)
+            if (CameraDevice::FrameListener* const l = frameListeners[i])
+                l->frameReceived (frame);
+    }
+
     void callListeners (CIImage* frame, int w, int h)
     {
         Image image (juce_createImageFromCIImage (frame, w, h));
@@ -207,6 +240,7 @@ public:
     int64 averageTimeOffset;
 
     Array<CameraDevice::Listener*> listeners;
+    Array<CameraDevice::FrameListener*> frameListeners;
     CriticalSection listenerLock;
 
 private:
@@ -235,6 +269,14 @@ private:
         {
             QTCameraDeviceInternal* const internal = getOwner (self);
 
+            if (internal->frameListeners.size() > 0)
+            {
+                const QTTime time ([sampleBuffer presentationTime]);
+
+                internal->callFrameListeners (new CVPixelBufferFrame (videoFrame, time.timeScale != 0 ? time.timeValue / (double) time.timeScale
+                                                                                                      : 0.0));
+            }
+
             if (internal->listeners.size() > 0)
             {
                 JUCE_AUTORELEASEPOOL
@@ -373,6 +415,18 @@ void CameraDevice::removeListener (Listener* listenerToRemove)
         static_cast <QTCameraDeviceInternal*> (internal)->removeListener (listenerToRemove);
 }
 
+void CameraDevice::addFrameListener (FrameListener* listenerToAdd)
+{
+    if (listenerToAdd != nullptr)
+        static_cast <QTCameraDeviceInternal*> (internal)->addFrameListener (listenerToAdd);
+}
+
+void CameraDevice::removeFrameListener (FrameListener* listenerToRemove)
+{
+    if (listenerToRemove != nullptr)
+        static_cast <QTCameraDeviceInternal*> (internal)->removeFrameListener (listenerToRemove);
+}
+
 //==============================================================================
 StringArray CameraDevice::getAvailableDevices()
 {
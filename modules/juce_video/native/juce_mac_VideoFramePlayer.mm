@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+//==============================================================================
+// AVAssetReader uses VideoToolbox for its decoding, so it'll be done by the
+// graphics hardware wherever the codec allows it.
+class AVAssetReaderDecoder  : public VideoFramePlayer::Decoder
+{
+public:
+    AVAssetReaderDecoder()  : asset (nil), track (nil), reader (nil), output (nil)
+    {
+    }
+
+    ~AVAssetReaderDecoder()
+    {
+        releaseReader();
+        [track release];
+        [asset release];
+    }
+
+    bool open (const File& file)
+    {
+        JUCE_AUTORELEASEPOOL
+
+        asset = [[AVURLAsset alloc] initWithURL: [NSURL fileURLWithPath: juceStringToNS (file.getFullPathName())]
+                                        options: nil];
+
+        NSArray* tracks = [asset tracksWithMediaType: AVMediaTypeVideo];
+
+        if ([tracks count] == 0)
+            return false;
+
+        track = [[tracks objectAtIndex: 0] retain];
+
+        const CGSize size = [track naturalSize];
+        width  = (int) size.width;
+        height = (int) size.height;
+        duration = CMTimeGetSeconds ([asset duration]);
+
+        return createReader (kCMTimeZero);
+    }
+
+    VideoFrame::Ptr readNextFrame()
+    {
+        JUCE_AUTORELEASEPOOL
+
+        while (output != nil)
+        {
+            CMSampleBufferRef sample = [output copyNextSampleBuffer];
+
+            if (sample == nullptr)
+                break;
+
+            VideoFrame::Ptr frame;
+
+            if (CVImageBufferRef image = CMSampleBufferGetImageBuffer (sample))
+                frame = new CVPixelBufferFrame (image, CMTimeGetSeconds (CMSampleBufferGetPresentationTimeStamp (sample)));
+
+            CFRelease (sample);
+
+            if (frame != nullptr)
+                return frame;
+        }
+
+        return nullptr;
+    }
+
+    void seek (const double time)
+    {
+        JUCE_AUTORELEASEPOOL
+
+        // A reader can't be repositioned once it has started, so we need a new one.
+        createReader (CMTimeMakeWithSeconds (time, 600));
+    }
+
+private:
+    AVURLAsset* asset;
+    AVAssetTrack* track;
+    AVAssetReader* reader;
+    AVAssetReaderTrackOutput* output;
+
+    bool createReader (const CMTime startTime)
+    {
+        releaseReader();
+
+        reader = [[AVAssetReader alloc] initWithAsset: asset error: nil];
+
+        if (reader == nil)
+            return false;
+
+        // Ask for the decoder's native bi-planar format, so that nothing needs to be
+        // colour-converted on the way, and for buffers that can be turned into textures.
+        NSDictionary* settings = [NSDictionary dictionaryWithObjectsAndKeys:
+                                    [NSNumber numberWithUnsignedInt: kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange],
+                                    (id) kCVPixelBufferPixelFormatTypeKey,
+                                    [NSNumber numberWithBool: YES],
+                                    (id) kCVPixelBufferOpenGLCompatibilityKey,
+                                    nil];
+
+        output = [[AVAssetReaderTrackOutput alloc] initWithTrack: track outputSettings: settings];
+
+        if (! [reader canAddOutput: output])
+        {
+            releaseReader();
+            return false;
+        }
+
+        [reader addOutput: output];
+        [reader setTimeRange: CMTimeRangeMake (startTime, kCMTimePositiveInfinity)];
+
+        if (! [reader startReading])
+        {
+            releaseReader();
+            return false;
+        }
+
+        return true;
+    }
+
+    void releaseReader()
+    {
+        [reader cancelReading];
+        [output release];
+        [reader release];
+        output = nil;
+        reader = nil;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AVAssetReaderDecoder)
+};
+
+//==============================================================================
+VideoFramePlayer::Decoder* VideoFramePlayer::createDecoder (const File& file)
+{
+    ScopedPointer<AVAssetReaderDecoder> d (new AVAssetReaderDecoder());
+
+    if (d->open (file))
+        return d.release();
+
+    return nullptr;
+}
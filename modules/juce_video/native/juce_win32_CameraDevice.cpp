@@ -125,7 +125,7 @@ public:
         }
 
         callback = new GrabberCallback (*this);
-        hr = sampleGrabber->SetCallback (callback, 1);
+        hr = sampleGrabber->SetCallback (callback, 0);
 
         hr = graphBuilder->AddFilter (sampleGrabberBase, _T("Sample Grabber"));
         if (FAILED (hr))
@@ -205,6 +205,19 @@ public:
         return previewMaxFPS;
     }
 
+    void handleSample (double time, IMediaSample* sample)
+    {
+        BYTE* buffer = nullptr;
+
+        if (FAILED (sample->GetPointer (&buffer)) || buffer == nullptr)
+            return;
+
+        handleFrame (time, buffer, sample->GetActualDataLength());
+
+        if (frameListeners.size() > 0)
+            callFrameListeners (new SampleFrame (sample, buffer, width, height, time));
+    }
+
     void handleFrame (double /*time*/, BYTE* buffer, long /*bufferSize*/)
     {
         if (recordNextFrameTime)
@@ -230,6 +243,10 @@ public:
             }
         }
 
+        // (the frame only needs copying into an Image if something's going to look at it)
+        if (viewerComps.size() == 0 && listeners.size() == 0)
+            return;
+
         {
             const int lineStride = width * 3;
             const ScopedLock sl (imageSwapLock);
@@ -420,6 +437,59 @@ public:
                 l->imageReceived (image);
     }
 
+    void addFrameListener (CameraDevice::FrameListener* listenerToAdd)
+    {
+        const ScopedLock sl (listenerLock);
+
+        if (frameListeners.size() == 0)
+            addUser();
+
+        frameListeners.addIfNotAlreadyThere (listenerToAdd);
+    }
+
+    void removeFrameListener (CameraDevice::FrameListener* listenerToRemove)
+    {
+        const ScopedLock sl (listenerLock);
+        frameListeners.removeFirstMatchingValue (listenerToRemove);
+
+        if (frameListeners.size() == 0)
+            removeUser();
+    }
+
+    void callFrameListeners (const CameraDevice::Frame::Ptr& frame)
+    {
+        const ScopedLock sl (listenerLock);
+
+        for (int i = frameListeners.size(); --i >= 0;)
+            if (CameraDevice::FrameListener* const l = frameListeners[i])
+                l->frameReceived (frame);
+    }
+
+    //==============================================================================
+    // Keeps hold of the grabber's media sample, so that its buffer isn't handed back
+    // to the allocator until the last listener has finished with it.
+    class SampleFrame  : public VideoFrame
+    {
+    public:
+        SampleFrame (IMediaSample* const s, const BYTE* const data, const int w, const int h, const double time)
+            : VideoFrame (w, h, bgr24, time), sample (s)
+        {
+            // RGB24 samples are stored bottom-up, with each line padded to a multiple of 4 bytes.
+            const int stride = (w * 3 + 3) & ~3;
+
+            numPlanes = 1;
+            planeData[0] = data + stride * (h - 1);
+            lineStrides[0] = -stride;
+        }
+
+        void* getNativeHandle() const noexcept      { return (IMediaSample*) sample; }
+
+    private:
+        ComSmartPtr <IMediaSample> sample;
+
+        JUCE_DECLARE_NON_COPYABLE (SampleFrame)
+    };
+
     //==============================================================================
     class DShowCaptureViewerComp   : public Component,
                                      public ChangeListener
@@ -693,14 +763,14 @@ private:
             return ComBaseClassHelperBase<ISampleGrabberCB>::QueryInterface (refId, result);
         }
 
-        STDMETHODIMP SampleCB (double, IMediaSample*)  { return E_FAIL; }
-
-        STDMETHODIMP BufferCB (double time, BYTE* buffer, long bufferSize)
+        STDMETHODIMP SampleCB (double time, IMediaSample* sample)
         {
-            owner.handleFrame (time, buffer, bufferSize);
+            owner.handleSample (time, sample);
             return S_OK;
         }
 
+        STDMETHODIMP BufferCB (double, BYTE*, long)     { return E_FAIL; }
+
     private:
         DShowCameraDeviceInteral& owner;
 
@@ -709,6 +779,7 @@ private:
 
     ComSmartPtr <GrabberCallback> callback;
     Array <CameraDevice::Listener*> listeners;
+    Array <CameraDevice::FrameListener*> frameListeners;
     CriticalSection listenerLock;
 
     //==============================================================================
@@ -782,6 +853,22 @@ void CameraDevice::removeListener (Listener* listenerToRemove)
         d->removeListener (listenerToRemove);
 }
 
+void CameraDevice::addFrameListener (FrameListener* listenerToAdd)
+{
+    DShowCameraDeviceInteral* const d = (DShowCameraDeviceInteral*) internal;
+
+    if (listenerToAdd != nullptr)
+        d->addFrameListener (listenerToAdd);
+}
+
+void CameraDevice::removeFrameListener (FrameListener* listenerToRemove)
+{
+    DShowCameraDeviceInteral* const d = (DShowCameraDeviceInteral*) internal;
+
+    if (listenerToRemove != nullptr)
+        d->removeFrameListener (listenerToRemove);
+}
+
 
 //==============================================================================
 namespace
@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace MediaFoundationHelpers
+{
+    // Keeps a decoded sample's buffer locked until the last reference to the frame
+    // has gone, so that the decoder can't recycle it while it's being used.
+    class SampleFrame  : public VideoFrame
+    {
+    public:
+        SampleFrame (IMFSample* const s, IMFMediaBuffer* const b, const int w, const int h,
+                     const int surfaceHeight, const double time)
+            : VideoFrame (w, h, nv12, time), sample (s), buffer (b)
+        {
+            BYTE* data = nullptr;
+            LONG stride = 0;
+
+            if (FAILED (buffer.QueryInterface (buffer2D))
+                 || FAILED (buffer2D->Lock2D (&data, &stride)))
+            {
+                buffer2D = nullptr;
+                buffer->Lock (&data, nullptr, nullptr);
+                stride = w;
+            }
+
+            numPlanes = 2;
+            planeData[0] = data;
+            planeData[1] = data + stride * surfaceHeight;
+            lineStrides[0] = lineStrides[1] = (int) stride;
+        }
+
+        ~SampleFrame()
+        {
+            if (buffer2D != nullptr)
+                buffer2D->Unlock2D();
+            else
+                buffer->Unlock();
+        }
+
+        void* getNativeHandle() const noexcept      { return (IMFSample*) sample; }
+
+    private:
+        ComSmartPtr <IMFSample> sample;
+        ComSmartPtr <IMFMediaBuffer> buffer;
+        ComSmartPtr <IMF2DBuffer> buffer2D;
+
+        JUCE_DECLARE_NON_COPYABLE (SampleFrame)
+    };
+
+    //======================================================================
+    class SourceReaderDecoder  : public VideoFramePlayer::Decoder
+    {
+    public:
+        SourceReaderDecoder()  : surfaceHeight (0), isStarted (false) {}
+
+        ~SourceReaderDecoder()
+        {
+            reader = nullptr;
+
+            if (isStarted)
+                MFShutdown();
+        }
+
+        bool open (const File& file)
+        {
+            isStarted = SUCCEEDED (MFStartup (MF_VERSION, MFSTARTUP_LITE));
+
+            if (! isStarted)
+                return false;
+
+            ComSmartPtr <IMFAttributes> attributes;
+            HRESULT hr = MFCreateAttributes (attributes.resetAndGetPointerAddress(), 2);
+
+            // Lets the reader load the hardware decoders, and convert whatever they
+            // produce into nv12, which is what they'll normally output anyway.
+            if (SUCCEEDED (hr))   hr = attributes->SetUINT32 (MF_READWRITE_ENABLE_HARDWARE_TRANSFORMS, TRUE);
+            if (SUCCEEDED (hr))   hr = attributes->SetUINT32 (MF_SOURCE_READER_ENABLE_VIDEO_PROCESSING, TRUE);
+            if (SUCCEEDED (hr))   hr = MFCreateSourceReaderFromURL (file.getFullPathName().toWideCharPointer(),
+                                                                    attributes, reader.resetAndGetPointerAddress());
+
+            if (SUCCEEDED (hr))   hr = reader->SetStreamSelection ((DWORD) MF_SOURCE_READER_ALL_STREAMS, FALSE);
+            if (SUCCEEDED (hr))   hr = reader->SetStreamSelection ((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, TRUE);
+
+            ComSmartPtr <IMFMediaType> outputType;
+            if (SUCCEEDED (hr))   hr = MFCreateMediaType (outputType.resetAndGetPointerAddress());
+            if (SUCCEEDED (hr))   hr = outputType->SetGUID (MF_MT_MAJOR_TYPE, MFMediaType_Video);
+            if (SUCCEEDED (hr))   hr = outputType->SetGUID (MF_MT_SUBTYPE, MFVideoFormat_NV12);
+            if (SUCCEEDED (hr))   hr = reader->SetCurrentMediaType ((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM,
+                                                                    nullptr, outputType);
+
+            if (SUCCEEDED (hr))   hr = updateFrameSize();
+
+            if (FAILED (hr))
+                return false;
+
+            PROPVARIANT value;
+            PropVariantInit (&value);
+
+            if (SUCCEEDED (reader->GetPresentationAttribute ((DWORD) MF_SOURCE_READER_MEDIASOURCE, MF_PD_DURATION, &value)))
+                duration = value.uhVal.QuadPart / 10000000.0;
+
+            PropVariantClear (&value);
+            return true;
+        }
+
+        VideoFrame::Ptr readNextFrame()
+        {
+            for (;;)
+            {
+                ComSmartPtr <IMFSample> sample;
+                DWORD flags = 0;
+                LONGLONG time = 0;
+
+                if (FAILED (reader->ReadSample ((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, 0, nullptr,
+                                                &flags, &time, sample.resetAndGetPointerAddress()))
+                     || (flags & (MF_SOURCE_READERF_ENDOFSTREAM | MF_SOURCE_READERF_ERROR)) != 0)
+                    return nullptr;
+
+                if ((flags & MF_SOURCE_READERF_CURRENTMEDIATYPECHANGED) != 0
+                     && FAILED (updateFrameSize()))
+                    return nullptr;
+
+                ComSmartPtr <IMFMediaBuffer> buffer;
+
+                // A sample can be missing if the reader is just reporting a gap in the stream.
+                if (sample != nullptr
+                     && SUCCEEDED (sample->ConvertToContiguousBuffer (buffer.resetAndGetPointerAddress())))
+                    return new SampleFrame (sample, buffer, width, height, surfaceHeight, time / 10000000.0);
+            }
+        }
+
+        void seek (const double time)
+        {
+            PROPVARIANT position;
+            PropVariantInit (&position);
+            position.vt = VT_I8;
+            position.hVal.QuadPart = (LONGLONG) (time * 10000000.0);
+
+            reader->SetCurrentPosition (GUID_NULL, position);
+            PropVariantClear (&position);
+        }
+
+    private:
+        ComSmartPtr <IMFSourceReader> reader;
+        int surfaceHeight;
+        bool isStarted;
+
+        HRESULT updateFrameSize()
+        {
+            ComSmartPtr <IMFMediaType> type;
+            HRESULT hr = reader->GetCurrentMediaType ((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM,
+                                                      type.resetAndGetPointerAddress());
+
+            UINT32 w = 0, h = 0;
+            if (SUCCEEDED (hr))   hr = MFGetAttributeSize (type, MF_MT_FRAME_SIZE, &w, &h);
+
+            if (SUCCEEDED (hr))
+            {
+                // Decoders pad their surfaces to a whole number of macro-blocks, so the
+                // picture itself may be smaller than the frame size.
+                width = (int) w;
+                height = surfaceHeight = (int) h;
+
+                MFVideoArea aperture;
+
+                if (SUCCEEDED (type->GetBlob (MF_MT_MINIMUM_DISPLAY_APERTURE, (UINT8*) &aperture,
+                                              sizeof (aperture), nullptr)))
+                {
+                    width  = jmin (width,  (int) aperture.Area.cx);
+                    height = jmin (height, (int) aperture.Area.cy);
+                }
+            }
+
+            return hr;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SourceReaderDecoder)
+    };
+}
+
+//==============================================================================
+VideoFramePlayer::Decoder* VideoFramePlayer::createDecoder (const File& file)
+{
+    ScopedPointer<MediaFoundationHelpers::SourceReaderDecoder> d (new MediaFoundationHelpers::SourceReaderDecoder());
+
+    if (d->open (file))
+        return d.release();
+
+    return nullptr;
+}
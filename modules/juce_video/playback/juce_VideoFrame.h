@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_VIDEOFRAME_JUCEHEADER__
+#define __JUCE_VIDEOFRAME_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A frame of video, in the format that the platform's camera driver or decoder
+    produced it.
+
+    A VideoFrame gives direct access to the platform's own buffer, so nothing needs to
+    be allocated, copied or colour-converted for each frame.
+
+    Frames are reference-counted, and the platform's buffer is only handed back to it
+    when the last reference is released, so a frame can safely be passed to another
+    thread, e.g. for encoding or uploading to a texture. But drivers and decoders only
+    have a small pool of buffers, so if you hold onto too many frames at once, they'll
+    start dropping them.
+
+    @see CameraDevice::FrameListener, VideoFramePlayer
+*/
+class JUCE_API  VideoFrame  : public ReferenceCountedObject
+{
+public:
+    /** Destructor. */
+    virtual ~VideoFrame() {}
+
+    /** A pointer to a VideoFrame. */
+    typedef ReferenceCountedObjectPtr<VideoFrame> Ptr;
+
+    /** The layouts of pixel data that a frame may use. */
+    enum PixelFormat
+    {
+        bgr24,      /**< One plane with 3 bytes per pixel, in blue, green, red order. */
+        bgra32,     /**< One plane with 4 bytes per pixel, in blue, green, red, alpha order. */
+        uyvy422,    /**< One plane of 4:2:2 YUV, with each pair of pixels stored as U, Y0, V, Y1. */
+        yuyv422,    /**< One plane of 4:2:2 YUV, with each pair of pixels stored as Y0, U, Y1, V. */
+        nv12,       /**< A plane of 8-bit Y values, then a plane of interleaved U and V values at half the resolution. */
+        unknownFormat   /**< Some other format - use getNativeHandle() to find out more. */
+    };
+
+    /** Returns the frame's width in pixels. */
+    int getWidth() const noexcept                           { return width; }
+
+    /** Returns the frame's height in pixels. */
+    int getHeight() const noexcept                          { return height; }
+
+    /** Returns the layout of the frame's pixel data. */
+    PixelFormat getPixelFormat() const noexcept             { return pixelFormat; }
+
+    /** Returns the frame's time, in seconds.
+        For a camera, this comes from the driver and is measured from an arbitrary starting
+        point, so it's only useful for comparing it with the times of the camera's other
+        frames. For a movie, it's the frame's presentation time from the start of the movie.
+    */
+    double getTimeStamp() const noexcept                    { return timeStamp; }
+
+    /** Returns the number of planes that the pixel data is split into. */
+    int getNumPlanes() const noexcept                       { return numPlanes; }
+
+    /** Returns a pointer to the top line of one of the frame's planes. */
+    const uint8* getPlaneData (int plane) const noexcept    { jassert (isPositiveAndBelow (plane, numPlanes)); return planeData [plane]; }
+
+    /** Returns the number of bytes between the start of one line of a plane and the
+        start of the line below it. This will be negative if the platform stores its
+        images bottom-up.
+    */
+    int getLineStride (int plane) const noexcept            { jassert (isPositiveAndBelow (plane, numPlanes)); return lineStrides [plane]; }
+
+    /** Returns the platform's own object for the frame.
+        On Windows this is a DirectShow IMediaSample for a camera, or a Media Foundation
+        IMFSample for a movie. On the Mac it's a CVPixelBufferRef.
+    */
+    virtual void* getNativeHandle() const noexcept = 0;
+
+protected:
+   #ifndef DOXYGEN
+    VideoFrame (int w, int h, PixelFormat format, double time) noexcept
+        : numPlanes (0), width (w), height (h), pixelFormat (format), timeStamp (time)
+    {
+        zeromem (planeData, sizeof (planeData));
+        zeromem (lineStrides, sizeof (lineStrides));
+    }
+
+    const uint8* planeData [2];
+    int lineStrides [2];
+    int numPlanes;
+   #endif
+
+private:
+    const int width, height;
+    const PixelFormat pixelFormat;
+    const double timeStamp;
+
+    JUCE_DECLARE_NON_COPYABLE (VideoFrame)
+};
+
+
+#endif   // __JUCE_VIDEOFRAME_JUCEHEADER__
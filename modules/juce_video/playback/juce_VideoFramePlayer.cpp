@@ -0,0 +1,253 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+//==============================================================================
+// Each platform's decoder is only ever used by the player's thread, apart from
+// being created and deleted while the thread is stopped.
+class VideoFramePlayer::Decoder
+{
+public:
+    Decoder() noexcept  : width (0), height (0), duration (0) {}
+    virtual ~Decoder() {}
+
+    // Returns the next frame in the movie, or nullptr when it reaches the end.
+    virtual VideoFrame::Ptr readNextFrame() = 0;
+
+    // Moves to the key-frame before this time, in seconds.
+    virtual void seek (double time) = 0;
+
+    int width, height;
+    double duration;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Decoder)
+};
+
+//==============================================================================
+VideoFramePlayer::VideoFramePlayer()
+    : Thread ("Video decoder"),
+      clock (nullptr),
+      seekPosition (-1.0),
+      playStartPosition (0),
+      playStartTime (0),
+      playing (false),
+      reachedEnd (false),
+      numFramesDropped (0)
+{
+}
+
+VideoFramePlayer::~VideoFramePlayer()
+{
+    close();
+}
+
+//==============================================================================
+bool VideoFramePlayer::open (const File& movieFile)
+{
+    close();
+
+    decoder = createDecoder (movieFile);
+
+    if (decoder == nullptr)
+        return false;
+
+    startThread();
+    return true;
+}
+
+void VideoFramePlayer::close()
+{
+    stopThread (4000);
+    decoder = nullptr;
+
+    const ScopedLock sl (frameLock);
+    decodedFrames.clear();
+    currentFrame = nullptr;
+    seekPosition = -1.0;
+    playStartPosition = 0;
+    playing = false;
+    reachedEnd = false;
+    numFramesDropped = 0;
+}
+
+double VideoFramePlayer::getDuration() const noexcept    { return decoder != nullptr ? decoder->duration : 0.0; }
+int VideoFramePlayer::getVideoWidth() const noexcept     { return decoder != nullptr ? decoder->width : 0; }
+int VideoFramePlayer::getVideoHeight() const noexcept    { return decoder != nullptr ? decoder->height : 0; }
+
+//==============================================================================
+void VideoFramePlayer::setClock (Clock* const newClock)
+{
+    const ScopedLock sl (frameLock);
+    clock = newClock;
+}
+
+void VideoFramePlayer::play()
+{
+    const ScopedLock sl (frameLock);
+
+    if (! playing)
+    {
+        playStartTime = Time::getMillisecondCounterHiRes();
+        playing = true;
+    }
+}
+
+void VideoFramePlayer::stop()
+{
+    const ScopedLock sl (frameLock);
+
+    if (playing)
+    {
+        playStartPosition = getPosition();
+        playing = false;
+    }
+}
+
+void VideoFramePlayer::setPosition (const double newPositionSeconds)
+{
+    const ScopedLock sl (frameLock);
+
+    playStartPosition = jmax (0.0, newPositionSeconds);
+    playStartTime = Time::getMillisecondCounterHiRes();
+    seekPosition = playStartPosition;
+    decodedFrames.clear();
+    currentFrame = nullptr;
+    reachedEnd = false;
+
+    notify();
+}
+
+double VideoFramePlayer::getPosition() const
+{
+    const ScopedLock sl (frameLock);
+
+    if (clock != nullptr)
+        return clock->getCurrentPlaybackTime();
+
+    if (playing)
+        return playStartPosition + (Time::getMillisecondCounterHiRes() - playStartTime) * 0.001;
+
+    return playStartPosition;
+}
+
+//==============================================================================
+VideoFrame::Ptr VideoFramePlayer::getCurrentFrame()
+{
+    const ScopedLock sl (frameLock);
+    const double now = getPosition();
+
+    int numDue = 0;
+    while (numDue < decodedFrames.size() && decodedFrames.getUnchecked (numDue)->getTimeStamp() <= now)
+        ++numDue;
+
+    // After a seek, show the first frame straight away, even if the movie's first
+    // time-stamp is a little later than the position that was asked for.
+    if (numDue == 0 && currentFrame == nullptr && decodedFrames.size() > 0)
+        numDue = 1;
+
+    if (numDue > 0)
+    {
+        currentFrame = decodedFrames.getUnchecked (numDue - 1);
+        decodedFrames.removeRange (0, numDue);
+        numFramesDropped += numDue - 1;
+        notify();
+    }
+
+    return currentFrame;
+}
+
+int VideoFramePlayer::getNumFramesQueued() const
+{
+    const ScopedLock sl (frameLock);
+    return decodedFrames.size();
+}
+
+//==============================================================================
+void VideoFramePlayer::run()
+{
+    // Enough to ride out a slow frame from the decoder, without tying up too
+    // many of its buffers.
+    const int maxFramesQueued = 4;
+
+    VideoFrame::Ptr lastFrameBeforeSeek;
+    double skipFramesBefore = -1.0;
+
+    while (! threadShouldExit())
+    {
+        double newSeekPosition;
+        bool isQueueFull;
+
+        {
+            const ScopedLock sl (frameLock);
+            newSeekPosition = seekPosition;
+            seekPosition = -1.0;
+            isQueueFull = reachedEnd || decodedFrames.size() >= maxFramesQueued;
+        }
+
+        if (newSeekPosition >= 0)
+        {
+            decoder->seek (newSeekPosition);
+            skipFramesBefore = newSeekPosition;
+            lastFrameBeforeSeek = nullptr;
+            continue;
+        }
+
+        if (isQueueFull)
+        {
+            wait (-1);
+            continue;
+        }
+
+        const VideoFrame::Ptr frame (decoder->readNextFrame());
+
+        const ScopedLock sl (frameLock);
+
+        if (seekPosition >= 0)
+            continue;
+
+        if (skipFramesBefore >= 0)
+        {
+            // The decoder will have restarted from a key-frame, so skip forward to the
+            // frame that covers the position that was asked for.
+            if (frame != nullptr && frame->getTimeStamp() < skipFramesBefore)
+            {
+                lastFrameBeforeSeek = frame;
+                continue;
+            }
+
+            if (lastFrameBeforeSeek != nullptr
+                 && (frame == nullptr || frame->getTimeStamp() > skipFramesBefore))
+                decodedFrames.add (lastFrameBeforeSeek);
+
+            lastFrameBeforeSeek = nullptr;
+            skipFramesBefore = -1.0;
+        }
+
+        if (frame != nullptr)
+            decodedFrames.add (frame);
+        else
+            reachedEnd = true;
+    }
+}
@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_VIDEOFRAMEPLAYER_JUCEHEADER__
+#define __JUCE_VIDEOFRAMEPLAYER_JUCEHEADER__
+
+#if JUCE_VIDEO_FRAME_PLAYER || DOXYGEN
+
+
+//==============================================================================
+/**
+    Plays a movie file by decoding its frames on a background thread, for you to
+    draw yourself.
+
+    Unlike DirectShowComponent and QuickTimeMovieComponent, which put a native window
+    over your UI, this gives you the decoder's VideoFrames, so that they can be uploaded
+    into textures and composited with everything else, e.g. inside an OpenGL renderer.
+
+    The frames come from the platform's own decoder - Media Foundation on Windows and
+    AVFoundation on the Mac - which will use the graphics hardware where it can. They
+    arrive in nv12 format, so to draw them you'll need to upload the two planes and
+    convert them to RGB in a shader.
+
+    To keep the picture in sync with a soundtrack, give the player a Clock that
+    reports the time of the audio that's currently coming out of the speakers. Your
+    render loop should then call getCurrentFrame() each time it draws.
+
+    @see VideoFrame
+*/
+class JUCE_API  VideoFramePlayer  : private Thread
+{
+public:
+    //==============================================================================
+    /** Creates a player with no movie loaded. */
+    VideoFramePlayer();
+
+    /** Destructor. */
+    ~VideoFramePlayer();
+
+    //==============================================================================
+    /** Tries to open a movie file.
+        If it succeeds, the player is positioned at the start of the movie, and is
+        stopped. Returns false if the file couldn't be decoded.
+    */
+    bool open (const File& movieFile);
+
+    /** Closes the current movie, if one is open. */
+    void close();
+
+    /** Returns true if a movie is open. */
+    bool isOpen() const noexcept                        { return decoder != nullptr; }
+
+    /** Returns the movie's duration in seconds. */
+    double getDuration() const noexcept;
+
+    /** Returns the width of the movie's frames. */
+    int getVideoWidth() const noexcept;
+
+    /** Returns the height of the movie's frames. */
+    int getVideoHeight() const noexcept;
+
+    //==============================================================================
+    /**
+        Tells a VideoFramePlayer which part of the movie should currently be on screen.
+
+        The usual way to implement this is in an AudioIODeviceCallback that's playing the
+        soundtrack: count the samples it has played, subtract the device's output latency,
+        and divide by the sample rate. That way, the picture follows the audio hardware's
+        clock, rather than drifting away from it.
+
+        @see VideoFramePlayer::setClock
+    */
+    class JUCE_API  Clock
+    {
+    public:
+        virtual ~Clock() {}
+
+        /** Returns the time in the movie, in seconds, that the listener is hearing now.
+            This is called by whichever thread calls getCurrentFrame(), so it must be
+            thread-safe.
+        */
+        virtual double getCurrentPlaybackTime() = 0;
+    };
+
+    /** Makes the player take its position from a clock.
+
+        While a clock is set, play(), stop() and setPosition() only affect the decoding,
+        so you'll need to start, stop and reposition the clock's source yourself. Pass
+        nullptr to go back to using the system's high-resolution timer. The clock isn't
+        deleted by the player, and it mustn't be deleted while the player is using it.
+    */
+    void setClock (Clock* newClock);
+
+    //==============================================================================
+    /** Starts playing from the current position. */
+    void play();
+
+    /** Stops playing, leaving the current frame on screen. */
+    void stop();
+
+    /** Returns true if the movie is playing. */
+    bool isPlaying() const noexcept                     { return playing; }
+
+    /** Moves to a new time in the movie, in seconds.
+        The frames from the old position are discarded, and the decoder starts again
+        from the nearest key-frame, which may take a few frames to catch up.
+    */
+    void setPosition (double newPositionSeconds);
+
+    /** Returns the current time in the movie, in seconds. */
+    double getPosition() const;
+
+    //==============================================================================
+    /** Returns the frame that should be on screen at the current position.
+
+        Call this from your render callback each time you draw. It returns the most recent
+        frame whose time has arrived, skipping any that were decoded too late to be seen,
+        and returns the same frame again until the next one is due. It'll return nullptr
+        until the first frame has been decoded.
+    */
+    VideoFrame::Ptr getCurrentFrame();
+
+    /** Returns the number of frames that getCurrentFrame() has skipped because their
+        time had passed, since the movie was opened.
+    */
+    int getNumFramesDropped() const noexcept            { return numFramesDropped; }
+
+    /** Returns the number of frames that are decoded and waiting to be shown. */
+    int getNumFramesQueued() const;
+
+    //==============================================================================
+    /** @internal - the platform-specific decoder. */
+    class Decoder;
+
+private:
+    //==============================================================================
+    ScopedPointer<Decoder> decoder;
+    Clock* clock;
+    CriticalSection frameLock;
+    ReferenceCountedArray<VideoFrame> decodedFrames;
+    VideoFrame::Ptr currentFrame;
+    double seekPosition, playStartPosition, playStartTime;
+    bool playing, reachedEnd;
+    int numFramesDropped;
+
+    static Decoder* createDecoder (const File&);
+    void run();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VideoFramePlayer)
+};
+
+
+#endif
+#endif   // __JUCE_VIDEOFRAMEPLAYER_JUCEHEADER__